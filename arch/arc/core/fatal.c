@@ -16,6 +16,7 @@
 #include <offsets_short.h>
 #include <toolchain.h>
 #include <arch/cpu.h>
+#include <drivers/console/uart_console.h>
 
 #ifdef CONFIG_PRINTK
 #include <misc/printk.h>
@@ -46,6 +47,11 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 							const NANO_ESF *pEsf)
 {
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+	/* Output of the error is not left in the console buffer */
+	uart_console_panic();
+#endif
+
 	switch (reason) {
 	case _NANO_ERR_INVALID_TASK_EXIT:
 		PR_EXC("***** Invalid Exit Software Error! *****\n");
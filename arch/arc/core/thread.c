@@ -114,6 +114,9 @@ void _new_thread(char *pStackMem, size_t stackSize,
 #endif
 
 	_init_thread_base(&thread->base, priority, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	thread->stack_size = stackSize;
+#endif
 
 	/* static threads overwrite them afterwards with real values */
 	thread->init_data = NULL;
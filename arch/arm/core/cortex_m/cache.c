@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Data cache maintenance for Cortex-M7
+ *
+ * The cache is maintained by address, one cache line at a time. Ranges are
+ * extended to whole cache lines, since the CMSIS routines do not align them.
+ */
+
+#include <kernel.h>
+#include <cache.h>
+#include <misc/util.h>
+#include <arch/arm/cortex_m/cmsis.h>
+
+#define LINE_MASK (CONFIG_CACHE_LINE_SIZE - 1)
+
+void sys_cache_data_range_flush(void *addr, size_t size)
+{
+	uint32_t start = (uint32_t)addr & ~LINE_MASK;
+	uint32_t end = ROUND_UP((uint32_t)addr + size, CONFIG_CACHE_LINE_SIZE);
+
+	if (size == 0) {
+		return;
+	}
+
+	SCB_CleanDCache_by_Addr((uint32_t *)start, end - start);
+}
+
+void sys_cache_data_range_invalidate(void *addr, size_t size)
+{
+	uint32_t start = (uint32_t)addr & ~LINE_MASK;
+	uint32_t end = ROUND_UP((uint32_t)addr + size, CONFIG_CACHE_LINE_SIZE);
+
+	if (size == 0) {
+		return;
+	}
+
+	SCB_InvalidateDCache_by_Addr((uint32_t *)start, end - start);
+}
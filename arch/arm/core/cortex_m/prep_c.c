@@ -50,6 +50,15 @@ static inline void enable_floating_point(void)
 	 * Enable CP10 and CP11 coprocessors to enable floating point.
 	 */
 	SCB->CPACR |= CPACR_CP10_FULL_ACCESS | CPACR_CP11_FULL_ACCESS;
+
+#ifdef CONFIG_LAZY_FP_SHARING
+	/*
+	 * Keep both automatic and lazy state preservation: the processor
+	 * stacks the floating point context only for threads that have used
+	 * the FPU, and only writes it when the exception handler uses it too.
+	 */
+	FPU->FPCCR = FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+#else
 	/*
 	 * Upon reset, the FPU Context Control Register is 0xC0000000
 	 * (both Automatic and Lazy state preservation is enabled).
@@ -70,6 +79,7 @@ static inline void enable_floating_point(void)
 		"dsb;\n\t"
 		"isb;\n\t"
 		);
+#endif /* CONFIG_LAZY_FP_SHARING */
 }
 #else
 static inline void enable_floating_point(void)
@@ -77,6 +87,18 @@ static inline void enable_floating_point(void)
 }
 #endif
 
+#ifdef CONFIG_DCACHE
+static inline void enable_data_cache(void)
+{
+	/* the cache is invalidated first, then enabled */
+	SCB_EnableDCache();
+}
+#else
+static inline void enable_data_cache(void)
+{
+}
+#endif
+
 extern FUNC_NORETURN void _Cstart(void);
 /**
  *
@@ -91,6 +113,7 @@ void _PrepC(void)
 {
 	relocate_vector_table();
 	enable_floating_point();
+	enable_data_cache();
 	_bss_zero();
 	_data_copy();
 	_Cstart();
@@ -180,11 +180,15 @@ void _arch_isr_direct_pm(void)
 #endif
 
 #if defined(CONFIG_KERNEL_EVENT_LOGGER_SLEEP) || \
-	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT)
+	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT) || \
+	defined(CONFIG_THREAD_RUNTIME_STATS)
 void _arch_isr_direct_header(void)
 {
 	_sys_k_event_logger_interrupt();
 	_sys_k_event_logger_exit_sleep();
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	_sys_thread_runtime_isr_enter();
+#endif
 }
 #endif
 
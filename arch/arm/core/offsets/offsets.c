@@ -33,6 +33,10 @@ GEN_OFFSET_SYM(_thread_arch_t, swap_return_value);
 GEN_OFFSET_SYM(_thread_arch_t, preempt_float);
 #endif
 
+#ifdef CONFIG_LAZY_FP_SHARING
+GEN_OFFSET_SYM(_thread_arch_t, exc_return);
+#endif
+
 GEN_OFFSET_SYM(_esf_t, a1);
 GEN_OFFSET_SYM(_esf_t, a2);
 GEN_OFFSET_SYM(_esf_t, a3);
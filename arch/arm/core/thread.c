@@ -15,6 +15,7 @@
 #include <toolchain.h>
 #include <kernel_structs.h>
 #include <wait_q.h>
+#include <stddef.h>
 #ifdef CONFIG_INIT_STACKS
 #include <string.h>
 #endif /* CONFIG_INIT_STACKS */
@@ -89,8 +90,15 @@ void _new_thread(char *pStackMem, size_t stackSize,
 
 	/* carve the thread entry struct from the "base" of the stack */
 
+#ifdef CONFIG_LAZY_FP_SHARING
+	/* threads start without FP context, thus with a basic stack frame */
+	pInitCtx = (struct __esf *)(STACK_ROUND_DOWN(stackEnd) -
+				    offsetof(struct __esf, s));
+	tcs->arch.exc_return = _EXC_RETURN_THREAD_PSP;
+#else
 	pInitCtx = (struct __esf *)(STACK_ROUND_DOWN(stackEnd) -
 				    sizeof(struct __esf));
+#endif
 
 	pInitCtx->pc = ((uint32_t)_thread_entry) & 0xfffffffe;
 	pInitCtx->a1 = (uint32_t)pEntry;
@@ -101,6 +109,9 @@ void _new_thread(char *pStackMem, size_t stackSize,
 		0x01000000UL; /* clear all, thumb bit is 1, even if RO */
 
 	_init_thread_base(&tcs->base, priority, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	tcs->stack_size = stackSize;
+#endif
 
 	/* static threads overwrite it afterwards with real value */
 	tcs->init_data = NULL;
@@ -86,6 +86,13 @@ typedef struct __esf _esf_t;
 #include <cortex_m/exc.h>
 #endif
 
+#ifdef CONFIG_LAZY_FP_SHARING
+/* EXC_RETURN to thread mode, using PSP, with a basic stack frame */
+#define _EXC_RETURN_THREAD_PSP 0xfffffffd
+/* EXC_RETURN bit that is cleared when the frame holds an FP context */
+#define _EXC_RETURN_FTYPE 0x10
+#endif
+
 #ifndef _ASMLANGUAGE
 
 #ifdef CONFIG_FLOAT
@@ -125,6 +132,11 @@ struct _thread_arch {
 	 */
 	struct _preempt_float  preempt_float;
 #endif
+
+#ifdef CONFIG_LAZY_FP_SHARING
+	/* EXC_RETURN of the thread, telling if it has an FP context */
+	uint32_t exc_return;
+#endif
 };
 
 typedef struct _thread_arch _thread_arch_t;
@@ -26,6 +26,9 @@
 #define _thread_offset_to_preempt_float \
 	(___thread_t_arch_OFFSET + ___thread_arch_t_preempt_float_OFFSET)
 
+#define _thread_offset_to_exc_return \
+	(___thread_t_arch_OFFSET + ___thread_arch_t_exc_return_OFFSET)
+
 /* end - threads */
 
 #endif /* _offsets_short_arch__h_ */
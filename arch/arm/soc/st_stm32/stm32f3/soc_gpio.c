@@ -171,6 +171,28 @@ int stm32_gpio_set(uint32_t *base, int pin, int value)
 	return 0;
 }
 
+int stm32_gpio_set_masked(uint32_t *base, uint32_t mask, uint32_t value)
+{
+	volatile struct stm32f3x_gpio *gpio = (struct stm32f3x_gpio *)base;
+	uint32_t set = mask & value & 0xffff;
+	uint32_t reset = mask & ~value & 0xffff;
+
+	/* Upper half resets, lower half sets */
+	gpio->bsrr = (reset << 16) | set;
+
+	return 0;
+}
+
+int stm32_gpio_toggle(uint32_t *base, uint32_t mask)
+{
+	volatile struct stm32f3x_gpio *gpio = (struct stm32f3x_gpio *)base;
+	uint32_t odr = gpio->odr;
+
+	gpio->bsrr = ((mask & odr & 0xffff) << 16) | (mask & ~odr & 0xffff);
+
+	return 0;
+}
+
 int stm32_gpio_get(uint32_t *base, int pin)
 {
 	struct stm32f3x_gpio *gpio = (struct stm32f3x_gpio *)base;
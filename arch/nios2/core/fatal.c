@@ -8,6 +8,7 @@
 #include <arch/cpu.h>
 #include <kernel_structs.h>
 #include <misc/printk.h>
+#include <drivers/console/uart_console.h>
 #include <inttypes.h>
 
 const NANO_ESF _default_esf = {
@@ -50,6 +51,11 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *esf)
 {
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+	/* Output of the error is not left in the console buffer */
+	uart_console_panic();
+#endif
+
 #ifdef CONFIG_PRINTK
 	switch (reason) {
 	case _NANO_ERR_CPU_EXCEPTION:
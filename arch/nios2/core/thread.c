@@ -77,6 +77,9 @@ void _new_thread(char *stack_memory, size_t stack_size,
 	thread = (struct k_thread *)stack_memory;
 
 	_init_thread_base(&thread->base, priority, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	thread->stack_size = stack_size;
+#endif
 
 	/* static threads overwrite it afterwards with real value */
 	thread->init_data = NULL;
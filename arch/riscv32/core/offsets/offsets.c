@@ -19,6 +19,8 @@
 
 /* thread_arch_t member offsets */
 GEN_OFFSET_SYM(_thread_arch_t, swap_return_value);
+GEN_OFFSET_SYM(_thread_arch_t, swap_ra);
+GEN_OFFSET_SYM(_thread_arch_t, swap_key);
 
 /* struct coop member offsets */
 GEN_OFFSET_SYM(_callee_saved_t, sp);
@@ -66,8 +66,8 @@ void _new_thread(char *stack_memory, size_t stack_size,
 	 * and restored prior to returning from the interrupt/exception.
 	 * This shall allow to handle nested interrupts.
 	 *
-	 * Given that context switching is performed via a system call exception
-	 * within the RISCV32 architecture implementation, initially set:
+	 * Given that a thread not run yet is scheduled by returning from its
+	 * exception stack frame, initially set:
 	 * 1) MSTATUS to SOC_MSTATUS_DEF_RESTORE in the thread stack to enable
 	 *    interrupts when the newly created thread will be scheduled;
 	 * 2) MEPC to the address of the _thread_entry_wrapper in the thread
@@ -87,6 +87,9 @@ void _new_thread(char *stack_memory, size_t stack_size,
 	thread = (struct k_thread *)stack_memory;
 
 	_init_thread_base(&thread->base, priority, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	thread->stack_size = stack_size;
+#endif
 
 	/* static threads overwrite it afterwards with real value */
 	thread->init_data = NULL;
@@ -99,5 +102,8 @@ void _new_thread(char *stack_memory, size_t stack_size,
 
 	thread->callee_saved.sp = (uint32_t)stack_init;
 
+	/* First scheduled from the initial stack frame */
+	thread->arch.swap_ra = 0;
+
 	thread_monitor_init(thread);
 }
@@ -63,6 +63,13 @@ typedef struct _caller_saved _caller_saved_t;
 
 struct _thread_arch {
 	uint32_t swap_return_value; /* Return value of _Swap() */
+	/*
+	 * Return address of _Swap() for a thread switched out by it, 0 for
+	 * a thread switched out by an interrupt or not run yet, which
+	 * resumes from the exception stack frame instead.
+	 */
+	uint32_t swap_ra;
+	uint32_t swap_key;          /* IRQ lock key _Swap() was called with */
 };
 
 typedef struct _thread_arch _thread_arch_t;
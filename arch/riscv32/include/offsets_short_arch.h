@@ -59,6 +59,12 @@
 #define _thread_offset_to_swap_return_value \
 	(___thread_t_arch_OFFSET + ___thread_arch_t_swap_return_value_OFFSET)
 
+#define _thread_offset_to_swap_ra \
+	(___thread_t_arch_OFFSET + ___thread_arch_t_swap_ra_OFFSET)
+
+#define _thread_offset_to_swap_key \
+	(___thread_t_arch_OFFSET + ___thread_arch_t_swap_key_OFFSET)
+
 /* end - threads */
 
 #endif /* _offsets_short_arch__h_ */
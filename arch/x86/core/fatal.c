@@ -17,6 +17,7 @@
 #include <kernel.h>
 #include <kernel_structs.h>
 #include <misc/printk.h>
+#include <drivers/console/uart_console.h>
 #include <arch/x86/irq_controller.h>
 #include <arch/x86/segmentation.h>
 #include <exception.h>
@@ -61,6 +62,11 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *pEsf)
 {
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+	/* Output of the error is not left in the console buffer */
+	uart_console_panic();
+#endif
+
 	_debug_fatal_hook(pEsf);
 
 #ifdef CONFIG_PRINTK
@@ -68,6 +68,61 @@ static void _FpCtxSave(struct tcs *tcs)
 	_do_fp_regs_save(&tcs->arch.preempFloatReg);
 }
 
+#ifdef CONFIG_LAZY_FP_SHARING
+/*
+ * Restore a thread's floating point context information.
+ *
+ * This routine restores the system's "live" floating point context from the
+ * specified thread control block, where it was saved by _FpCtxSave().
+ */
+static void _FpCtxRestore(struct tcs *tcs)
+{
+#ifdef CONFIG_SSE
+	if (tcs->base.user_options & K_SSE_REGS) {
+		_do_fp_and_sse_regs_restore(&tcs->arch.preempFloatReg);
+		return;
+	}
+#endif
+	_do_fp_regs_restore(&tcs->arch.preempFloatReg);
+}
+
+/*
+ * Hand the FPU over to the current thread.
+ *
+ * With lazy FP context switching, _Swap() only sets CR0[TS] when the
+ * incoming thread does not own the FPU: the floating point registers are
+ * swapped here, on its first floating point instruction. As in _Swap()
+ * without lazy switching, the owner's context only needs saving if it was
+ * switched out preemptively, since the registers are 'volatile' otherwise.
+ */
+static void _FpCtxClaim(void)
+{
+	unsigned int imask;
+	struct tcs *fp_owner;
+
+	imask = irq_lock();
+
+	__asm__ volatile("clts\n\t");
+
+	fp_owner = _kernel.current_fp;
+	if (fp_owner && (fp_owner->base.thread_state & _INT_OR_EXC_MASK)) {
+		_FpCtxSave(fp_owner);
+		fp_owner->arch.fpSaved = 1;
+		/* 'fxsave' does NOT perform an implicit 'fninit' */
+		_do_fp_regs_init();
+	}
+
+	if (_current->arch.fpSaved) {
+		_FpCtxRestore(_current);
+		_current->arch.fpSaved = 0;
+	}
+
+	_kernel.current_fp = _current;
+
+	irq_unlock(imask);
+}
+#endif /* CONFIG_LAZY_FP_SHARING */
+
 /*
  * Initialize a thread's floating point context information.
  *
@@ -124,6 +179,9 @@ void k_float_enable(struct tcs *tcs, unsigned int options)
 	if (fp_owner) {
 		if (fp_owner->base.thread_state & _INT_OR_EXC_MASK) {
 			_FpCtxSave(fp_owner);
+#ifdef CONFIG_LAZY_FP_SHARING
+			fp_owner->arch.fpSaved = 1;
+#endif
 		}
 	}
 
@@ -177,6 +235,9 @@ void k_float_enable(struct tcs *tcs, unsigned int options)
 			 */
 
 			_FpCtxSave(tcs);
+#ifdef CONFIG_LAZY_FP_SHARING
+			tcs->arch.fpSaved = 1;
+#endif
 		}
 	}
 
@@ -223,7 +284,8 @@ void k_float_disable(struct tcs *tcs)
  *
  * The processor will generate this exception if any x87 FPU, MMX, or SSEx
  * instruction is executed while CR0[TS]=1. The handler then enables the
- * current thread to use all supported floating point registers.
+ * current thread to use all supported floating point registers, or, with
+ * lazy FP context switching, swaps them in if it can already use them.
  */
 void _FpNotAvailableExcHandler(NANO_ESF *pEsf)
 {
@@ -238,6 +300,13 @@ void _FpNotAvailableExcHandler(NANO_ESF *pEsf)
 	PRINTK("_FpNotAvailableExcHandler() exception handler has been "
 	       "invoked\n");
 
+#ifdef CONFIG_LAZY_FP_SHARING
+	if (_current->base.user_options & _FP_USER_MASK) {
+		_FpCtxClaim();
+		return;
+	}
+#endif
+
 	/* Enable highest level of FP capability configured into the kernel */
 
 	k_float_enable(_current, _FP_USER_MASK);
@@ -76,8 +76,14 @@ static void _new_thread_internal(char *pStackMem, unsigned stackSize,
 #if (defined(CONFIG_FP_SHARING) || defined(CONFIG_GDB_INFO))
 	thread->arch.excNestCount = 0;
 #endif /* CONFIG_FP_SHARING || CONFIG_GDB_INFO */
+#ifdef CONFIG_LAZY_FP_SHARING
+	thread->arch.fpSaved = 0;
+#endif
 
 	_init_thread_base(&thread->base, priority, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	thread->stack_size = stackSize;
+#endif
 
 	/* static threads overwrite it afterwards with real value */
 	thread->init_data = NULL;
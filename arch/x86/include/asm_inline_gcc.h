@@ -105,6 +105,44 @@ static inline void _do_fp_and_sse_regs_save(void *preemp_float_reg)
 }
 #endif /* CONFIG_SSE */
 
+#ifdef CONFIG_LAZY_FP_SHARING
+/**
+ *
+ * @brief Restore non-integer context information
+ *
+ * This routine restores the system's "live" x87/MMX context from the
+ * specified area, previously filled by _do_fp_regs_save().
+ *
+ * @return N/A
+ */
+static inline void _do_fp_regs_restore(void *preemp_float_reg)
+{
+	__asm__ volatile("frstor (%0);\n\t"
+			 :
+			 : "r"(preemp_float_reg)
+			 : "memory");
+}
+
+#ifdef CONFIG_SSE
+/**
+ *
+ * @brief Restore non-integer context information
+ *
+ * This routine restores the system's "live" x87/MMX/SSEx context from the
+ * specified area, previously filled by _do_fp_and_sse_regs_save().
+ *
+ * @return N/A
+ */
+static inline void _do_fp_and_sse_regs_restore(void *preemp_float_reg)
+{
+	__asm__ volatile("fxrstor (%0);\n\t"
+			 :
+			 : "r"(preemp_float_reg)
+			 : "memory");
+}
+#endif /* CONFIG_SSE */
+#endif /* CONFIG_LAZY_FP_SHARING */
+
 /**
  *
  * @brief Initialize floating point register context information.
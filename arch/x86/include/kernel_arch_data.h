@@ -608,6 +608,11 @@ struct _thread_arch {
 	unsigned excNestCount; /* nested exception count */
 #endif /* CONFIG_FP_SHARING || CONFIG_GDB_INFO */
 
+#ifdef CONFIG_LAZY_FP_SHARING
+	/* set when preempFloatReg holds the thread's live FP context */
+	unsigned fpSaved;
+#endif
+
 	/*
 	 * The location of all floating point related structures/fields MUST be
 	 * located at the end of struct tcs.  This way only the
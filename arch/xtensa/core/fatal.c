@@ -9,6 +9,7 @@
 #include <inttypes.h>
 #include <kernel_arch_data.h>
 #include <misc/printk.h>
+#include <drivers/console/uart_console.h>
 #include <xtensa/specreg.h>
 
 const NANO_ESF _default_esf = {
@@ -47,6 +48,11 @@ const NANO_ESF _default_esf = {
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *pEsf)
 {
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+	/* Output of the error is not left in the console buffer */
+	uart_console_panic();
+#endif
+
 	switch (reason) {
 	case _NANO_ERR_HW_EXCEPTION:
 	case _NANO_ERR_RESERVED_IRQ:
@@ -158,6 +158,9 @@ void _new_thread(char *pStack, size_t stackSize,
 	tcs->callee_saved.topOfStack = pInitCtx;
 	tcs->arch.flags = 0;
 	_init_thread_base(&tcs->base, prio, _THREAD_PRESTART, options);
+#ifdef CONFIG_INIT_STACKS
+	tcs->stack_size = stackSize;
+#endif
 	/* static threads overwrite it afterwards with real value */
 	tcs->init_data = NULL;
 	tcs->fn_abort = NULL;
@@ -30,6 +30,14 @@ struct adc_info  {
 	atomic_t  state;
 	struct k_sem device_sync_sem;
 	struct k_sem sem;
+#if (CONFIG_ADC_QMSI_INTERRUPT)
+	/* Continuous sampling, NULL once it has ended */
+	struct adc_stream *stream;
+	qm_adc_xfer_t stream_xfer;
+	qm_adc_channel_t stream_channel;
+	bool streaming;
+	bool stream_stop;
+#endif
 };
 
 static void adc_config_irq(void);
@@ -49,6 +57,53 @@ static void complete_callback(void *data, int error, qm_adc_status_t status,
 	}
 }
 
+static void stream_end(struct device *dev, struct adc_info *info, int error)
+{
+	struct adc_stream *stream = info->stream;
+
+	info->stream = NULL;
+	k_sem_give(&info->device_sync_sem);
+
+	if (error) {
+		stream->callback(dev, NULL, 0);
+	}
+}
+
+static void stream_callback(void *data, int error, qm_adc_status_t status,
+			    qm_adc_cb_source_t source)
+{
+	struct device *dev = data;
+	struct adc_info *info = dev->driver_data;
+	struct adc_stream *stream = info->stream;
+	qm_adc_xfer_t *xfer = &info->stream_xfer;
+	uint8_t *filled = (uint8_t *)xfer->samples;
+	uint32_t len = xfer->samples_len * sizeof(qm_adc_sample_t);
+
+	/* An overrun may be followed by a completion in the same ISR */
+	if (!stream) {
+		return;
+	}
+
+	if (error || info->stream_stop) {
+		stream_end(dev, info, error);
+		return;
+	}
+
+	/* Go on sampling into the other buffer before handing this one */
+	if (filled == stream->buffer) {
+		xfer->samples = (qm_adc_sample_t *)(stream->buffer + len);
+	} else {
+		xfer->samples = (qm_adc_sample_t *)stream->buffer;
+	}
+
+	if (qm_adc_irq_convert(QM_ADC_0, xfer) != 0) {
+		stream_end(dev, info, -EIO);
+		return;
+	}
+
+	stream->callback(dev, filled, len);
+}
+
 #endif
 
 static void adc_lock(struct adc_info *data)
@@ -213,12 +268,76 @@ static int adc_qmsi_read(struct device *dev, struct adc_seq_table *seq_tbl)
 
 	return ret;
 }
+
+static int adc_qmsi_stream_start(struct device *dev,
+				 struct adc_stream *stream)
+{
+	struct adc_info *info = dev->driver_data;
+	qm_adc_xfer_t *xfer = &info->stream_xfer;
+	uint32_t len = stream->buffer_length / 2;
+
+	if (!stream->callback || !len || len % sizeof(qm_adc_sample_t)) {
+		return -EINVAL;
+	}
+
+	/* The ADC is held until the stream is stopped */
+	adc_lock(info);
+
+	cfg.window = stream->sampling_delay;
+	if (qm_adc_set_config(QM_ADC_0, &cfg) != 0) {
+		adc_unlock(info);
+		return -EINVAL;
+	}
+
+	info->stream_channel = (qm_adc_channel_t)stream->channel_id;
+	info->stream_stop = false;
+	info->stream = stream;
+
+	xfer->ch = &info->stream_channel;
+	xfer->ch_len = 1;
+	xfer->samples = (qm_adc_sample_t *)stream->buffer;
+	xfer->samples_len = len / sizeof(qm_adc_sample_t);
+	xfer->callback = stream_callback;
+	xfer->callback_data = dev;
+
+	if (qm_adc_irq_convert(QM_ADC_0, xfer) != 0) {
+		info->stream = NULL;
+		adc_unlock(info);
+		return -EIO;
+	}
+
+	info->streaming = true;
+
+	return 0;
+}
+
+static int adc_qmsi_stream_stop(struct device *dev)
+{
+	struct adc_info *info = dev->driver_data;
+
+	if (!info->streaming) {
+		return -EINVAL;
+	}
+
+	/* Wait for the buffer being filled, unless the stream already ended */
+	info->stream_stop = true;
+	k_sem_take(&info->device_sync_sem, K_FOREVER);
+
+	info->streaming = false;
+	adc_unlock(info);
+
+	return 0;
+}
 #endif /* CONFIG_ADC_QMSI_POLL */
 
 static const struct adc_driver_api api_funcs = {
 	.enable  = adc_qmsi_enable,
 	.disable = adc_qmsi_disable,
 	.read    = adc_qmsi_read,
+#if (CONFIG_ADC_QMSI_INTERRUPT)
+	.stream_start = adc_qmsi_stream_start,
+	.stream_stop  = adc_qmsi_stream_stop,
+#endif
 };
 
 static int adc_qmsi_init(struct device *dev)
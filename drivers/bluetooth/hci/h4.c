@@ -70,10 +70,91 @@ static struct {
 
 static struct device *h4_dev;
 
+#if defined(CONFIG_BLUETOOTH_H4_ASYNC)
+#define H4_RX_BUFS 3
+
+/* The DMA receives into the buffers in turn, the packets are parsed from
+ * the data reported, as the interrupt driven API reads it from the FIFO.
+ */
+static struct {
+	uint8_t  buf[H4_RX_BUFS][CONFIG_BLUETOOTH_H4_ASYNC_RX_BUF_SIZE];
+	/* bytes received so far, in each buffer */
+	size_t   filled[H4_RX_BUFS];
+	/* buffer given to the driver and not released yet */
+	bool     in_use[H4_RX_BUFS];
+	/* next buffer to give to the driver */
+	uint8_t  next;
+	/* buffer parsed, and bytes of it parsed */
+	uint8_t  read;
+	size_t   offset;
+	bool     enabled;
+	/* no net_buf for the packet, resumed by rx_thread */
+	bool     stalled;
+} rx_dma;
+
+static struct {
+	uint8_t  buf[CONFIG_BLUETOOTH_H4_ASYNC_TX_BUF_SIZE];
+	bool     busy;
+} tx_dma;
+
+static int h4_read(uint8_t *data, int len)
+{
+	size_t avail = rx_dma.filled[rx_dma.read] - rx_dma.offset;
+
+	len = min(len, (int)avail);
+	memcpy(data, &rx_dma.buf[rx_dma.read][rx_dma.offset], len);
+	rx_dma.offset += len;
+
+	return len;
+}
+
+static size_t h4_skip(size_t len)
+{
+	len = min(len, rx_dma.filled[rx_dma.read] - rx_dma.offset);
+	rx_dma.offset += len;
+
+	return len;
+}
+
+static void rx_dma_process(void);
+
+static void rx_pause(void)
+{
+	rx_dma.stalled = true;
+}
+
+static void rx_resume(void)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	if (rx_dma.stalled) {
+		rx_dma.stalled = false;
+		rx_dma_process();
+	}
+	irq_unlock(key);
+}
+#else
+static inline int h4_read(uint8_t *data, int len)
+{
+	return uart_fifo_read(h4_dev, data, len);
+}
+
+static inline void rx_pause(void)
+{
+	uart_irq_rx_disable(h4_dev);
+}
+
+static inline void rx_resume(void)
+{
+	uart_irq_rx_enable(h4_dev);
+}
+#endif /* CONFIG_BLUETOOTH_H4_ASYNC */
+
 static inline void h4_get_type(void)
 {
 	/* Get packet type */
-	if (uart_fifo_read(h4_dev, &rx.type, 1) != 1) {
+	if (h4_read(&rx.type, 1) != 1) {
 		BT_WARN("Unable to read H:4 packet type");
 		rx.type = H4_NONE;
 		return;
@@ -99,8 +180,7 @@ static inline void get_acl_hdr(void)
 	struct bt_hci_acl_hdr *hdr = &rx.acl;
 	int to_read = sizeof(*hdr) - rx.remaining;
 
-	rx.remaining -= uart_fifo_read(h4_dev, (uint8_t *)hdr + to_read,
-				       rx.remaining);
+	rx.remaining -= h4_read((uint8_t *)hdr + to_read, rx.remaining);
 	if (!rx.remaining) {
 		rx.remaining = sys_le16_to_cpu(hdr->len);
 		BT_DBG("Got ACL header. Payload %u bytes", rx.remaining);
@@ -113,8 +193,7 @@ static inline void get_evt_hdr(void)
 	struct bt_hci_evt_hdr *hdr = &rx.evt;
 	int to_read = rx.hdr_len - rx.remaining;
 
-	rx.remaining -= uart_fifo_read(h4_dev, (uint8_t *)hdr + to_read,
-				       rx.remaining);
+	rx.remaining -= h4_read((uint8_t *)hdr + to_read, rx.remaining);
 	if (rx.hdr_len == sizeof(*hdr) && rx.remaining < sizeof(*hdr)) {
 		switch (rx.evt.evt) {
 		case BT_HCI_EVT_LE_META_EVENT:
@@ -200,11 +279,11 @@ static void rx_thread(void *p1, void *p2, void *p3)
 		}
 
 		/* Let the ISR continue receiving new packets */
-		uart_irq_rx_enable(h4_dev);
+		rx_resume();
 
 		buf = net_buf_get(&rx.fifo, K_FOREVER);
 		do {
-			uart_irq_rx_enable(h4_dev);
+			rx_resume();
 
 			BT_DBG("Calling bt_recv(%p)", buf);
 			bt_recv(buf);
@@ -215,7 +294,7 @@ static void rx_thread(void *p1, void *p2, void *p3)
 			 */
 			k_yield();
 
-			uart_irq_rx_disable(h4_dev);
+			rx_pause();
 			buf = net_buf_get(&rx.fifo, K_NO_WAIT);
 		} while (buf);
 	}
@@ -245,7 +324,7 @@ static inline void read_payload(void)
 			}
 
 			BT_WARN("Failed to allocate, deferring to rx_thread");
-			uart_irq_rx_disable(h4_dev);
+			rx_pause();
 			return;
 		}
 
@@ -261,7 +340,7 @@ static inline void read_payload(void)
 		copy_hdr(rx.buf);
 	}
 
-	read = uart_fifo_read(h4_dev, net_buf_tail(rx.buf), rx.remaining);
+	read = h4_read(net_buf_tail(rx.buf), rx.remaining);
 	net_buf_add(rx.buf, read);
 	rx.remaining -= read;
 
@@ -323,6 +402,20 @@ static inline void read_header(void)
 	}
 }
 
+static uint8_t h4_tx_type(struct net_buf *buf)
+{
+	switch (bt_buf_get_type(buf)) {
+	case BT_BUF_ACL_OUT:
+		return H4_ACL;
+	case BT_BUF_CMD:
+		return H4_CMD;
+	default:
+		BT_ERR("Unknown buffer type");
+		return H4_NONE;
+	}
+}
+
+#if !defined(CONFIG_BLUETOOTH_H4_ASYNC)
 static inline void process_tx(void)
 {
 	int bytes;
@@ -337,15 +430,8 @@ static inline void process_tx(void)
 	}
 
 	if (!tx.type) {
-		switch (bt_buf_get_type(tx.buf)) {
-		case BT_BUF_ACL_OUT:
-			tx.type = H4_ACL;
-			break;
-		case BT_BUF_CMD:
-			tx.type = H4_CMD;
-			break;
-		default:
-			BT_ERR("Unknown buffer type");
+		tx.type = h4_tx_type(tx.buf);
+		if (!tx.type) {
 			goto done;
 		}
 
@@ -364,6 +450,12 @@ static inline void process_tx(void)
 		return;
 	}
 
+	/* Continue with the next fragment of the packet */
+	if (tx.buf->frags) {
+		tx.buf = net_buf_frag_del(NULL, tx.buf);
+		return;
+	}
+
 done:
 	tx.type = H4_NONE;
 	net_buf_unref(tx.buf);
@@ -373,6 +465,8 @@ done:
 	}
 }
 
+#endif /* !CONFIG_BLUETOOTH_H4_ASYNC */
+
 static inline void process_rx(void)
 {
 	BT_DBG("remaining %u discard %u have_hdr %u rx.buf %p len %u",
@@ -380,7 +474,11 @@ static inline void process_rx(void)
 	       rx.buf ? rx.buf->len : 0);
 
 	if (rx.discard) {
+#if defined(CONFIG_BLUETOOTH_H4_ASYNC)
+		rx.discard -= h4_skip(rx.discard);
+#else
 		rx.discard -= h4_discard(h4_dev, rx.discard);
+#endif
 		return;
 	}
 
@@ -391,6 +489,186 @@ static inline void process_rx(void)
 	}
 }
 
+#if defined(CONFIG_BLUETOOTH_H4_ASYNC)
+static void rx_dma_start(void)
+{
+	uint8_t i = rx_dma.read;
+	int err;
+
+	rx_dma.filled[i] = 0;
+	rx_dma.offset = 0;
+	rx_dma.in_use[i] = true;
+	rx_dma.next = (i + 1) % H4_RX_BUFS;
+	rx_dma.enabled = true;
+
+	err = uart_rx_enable(h4_dev, rx_dma.buf[i], sizeof(rx_dma.buf[i]), 1);
+	if (err) {
+		BT_ERR("Unable to start receiving (err %d)", err);
+		rx_dma.in_use[i] = false;
+		rx_dma.enabled = false;
+	}
+}
+
+static void rx_dma_process(void)
+{
+	while (!rx_dma.stalled) {
+		uint8_t read = rx_dma.read;
+
+		if (rx_dma.offset < rx_dma.filled[read]) {
+			process_rx();
+			continue;
+		}
+
+		/* Still receiving into it, or the reception stopped with it */
+		if (rx_dma.in_use[read] ||
+		    (read + 1) % H4_RX_BUFS == rx_dma.next) {
+			break;
+		}
+
+		rx_dma.read = (read + 1) % H4_RX_BUFS;
+		rx_dma.offset = 0;
+	}
+
+	/* Stopped for lack of a free buffer, or on an error */
+	if (!rx_dma.stalled && !rx_dma.enabled) {
+		rx_dma_start();
+	}
+}
+
+static void rx_dma_buf_request(void)
+{
+	uint8_t i = rx_dma.next;
+
+	/* Not parsed yet, the reception stops once the current one is full
+	 * and starts again once parsed
+	 */
+	if (rx_dma.in_use[i] || i == rx_dma.read) {
+		BT_WARN("No free DMA buffer");
+		return;
+	}
+
+	rx_dma.filled[i] = 0;
+	rx_dma.in_use[i] = true;
+	rx_dma.next = (i + 1) % H4_RX_BUFS;
+
+	uart_rx_buf_rsp(h4_dev, rx_dma.buf[i], sizeof(rx_dma.buf[i]));
+}
+
+/* Copies as many of the queued packets as fit, in one DMA transfer */
+static void tx_dma_send(void)
+{
+	size_t len = 0;
+	int err;
+
+	while (len < sizeof(tx_dma.buf)) {
+		size_t bytes;
+
+		if (!tx.buf) {
+			tx.buf = net_buf_get(&tx.fifo, K_NO_WAIT);
+			if (!tx.buf) {
+				break;
+			}
+		}
+
+		if (!tx.type) {
+			tx.type = h4_tx_type(tx.buf);
+			if (!tx.type) {
+				net_buf_unref(tx.buf);
+				tx.buf = NULL;
+				continue;
+			}
+
+			tx_dma.buf[len++] = tx.type;
+		}
+
+		bytes = min(tx.buf->len, sizeof(tx_dma.buf) - len);
+		memcpy(&tx_dma.buf[len], tx.buf->data, bytes);
+		net_buf_pull(tx.buf, bytes);
+		len += bytes;
+
+		if (tx.buf->len) {
+			break;
+		}
+
+		/* Continue with the next fragment of the packet */
+		if (tx.buf->frags) {
+			tx.buf = net_buf_frag_del(NULL, tx.buf);
+			continue;
+		}
+
+		tx.type = H4_NONE;
+		net_buf_unref(tx.buf);
+		tx.buf = NULL;
+	}
+
+	if (!len) {
+		return;
+	}
+
+	err = uart_tx(h4_dev, tx_dma.buf, len);
+	if (err) {
+		BT_ERR("Unable to send (err %d)", err);
+		return;
+	}
+
+	tx_dma.busy = true;
+}
+
+static void bt_uart_cb(struct device *dev, struct uart_event *evt,
+		       void *user_data)
+{
+	uint8_t i;
+
+	ARG_UNUSED(dev);
+	ARG_UNUSED(user_data);
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		tx_dma.busy = false;
+		tx_dma_send();
+		break;
+	case UART_RX_RDY:
+		i = (evt->data.rx.buf - rx_dma.buf[0]) / sizeof(rx_dma.buf[0]);
+		rx_dma.filled[i] = evt->data.rx.offset + evt->data.rx.len;
+		rx_dma_process();
+		break;
+	case UART_RX_BUF_REQUEST:
+		rx_dma_buf_request();
+		break;
+	case UART_RX_BUF_RELEASED:
+		i = (evt->data.rx_buf.buf - rx_dma.buf[0]) /
+		    sizeof(rx_dma.buf[0]);
+		rx_dma.in_use[i] = false;
+		rx_dma_process();
+		break;
+	case UART_RX_STOPPED:
+		BT_ERR("Receive error 0x%02x", evt->data.rx_stop.reason);
+		break;
+	case UART_RX_DISABLED:
+		rx_dma.enabled = false;
+		rx_dma_process();
+		break;
+	}
+}
+
+static int h4_send(struct net_buf *buf)
+{
+	unsigned int key;
+
+	BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf), buf->len);
+
+	net_buf_put(&tx.fifo, buf);
+
+	key = irq_lock();
+	if (!tx_dma.busy) {
+		tx_dma_send();
+	}
+	irq_unlock(key);
+
+	return 0;
+}
+#else
 static void bt_uart_isr(struct device *unused)
 {
 	ARG_UNUSED(unused);
@@ -415,6 +693,7 @@ static int h4_send(struct net_buf *buf)
 
 	return 0;
 }
+#endif /* CONFIG_BLUETOOTH_H4_ASYNC */
 
 static int h4_open(void)
 {
@@ -431,7 +710,23 @@ static int h4_open(void)
 	h4_discard(h4_dev, 32);
 #endif
 
+#if defined(CONFIG_BLUETOOTH_H4_ASYNC)
+	if (uart_callback_set(h4_dev, bt_uart_cb, NULL)) {
+		BT_ERR("No asynchronous API on %s",
+		       CONFIG_BLUETOOTH_UART_ON_DEV_NAME);
+		return -EIO;
+	}
+
+	/* Parsing starts along with rx_thread */
+	rx_dma.stalled = true;
+	rx_dma.read = 0;
+	rx_dma_start();
+	if (!rx_dma.enabled) {
+		return -EIO;
+	}
+#else
 	uart_irq_callback_set(h4_dev, bt_uart_isr);
+#endif
 
 	k_thread_spawn(rx_thread_stack, sizeof(rx_thread_stack), rx_thread,
 		       NULL, NULL, NULL, K_PRIO_COOP(7), 0, K_NO_WAIT);
@@ -442,6 +737,7 @@ static int h4_open(void)
 static struct bt_hci_driver drv = {
 	.name		= "H:4",
 	.bus		= BT_HCI_DRIVER_BUS_UART,
+	.send_frags	= true,
 	.open		= h4_open,
 	.send		= h4_send,
 };
@@ -36,44 +36,44 @@
 #define TELNET_PORT		CONFIG_TELNET_CONSOLE_PORT
 #define TELNET_STACK_SIZE	CONFIG_TELNET_CONSOLE_THREAD_STACK
 #define TELNET_PRIORITY		CONFIG_TELNET_CONSOLE_PRIO
-#define TELNET_LINES		CONFIG_TELNET_CONSOLE_LINE_BUF_NUMBERS
-#define TELNET_LINE_SIZE	CONFIG_TELNET_CONSOLE_LINE_BUF_SIZE
+#define TELNET_OUT_SIZE		CONFIG_TELNET_CONSOLE_OUT_BUF_SIZE
 #define TELNET_TIMEOUT		K_MSEC(CONFIG_TELNET_CONSOLE_SEND_TIMEOUT)
 #define TELNET_THRESHOLD	CONFIG_TELNET_CONSOLE_SEND_THRESHOLD
 
 #define TELNET_MIN_MSG		2
 
-/* These 2 structures below are used to store the console output
- * before sending it to the client. This is done to keep some
- * reactivity: the ring buffer is non-protected, if first line has
- * not been sent yet, and if next line is reaching the same index in rb,
- * the first one will be replaced. In a perfect world, this should
- * not happen. However on a loaded system with a lot of debug output
- * this is bound to happen eventualy, moreover if it does not have
- * the luxury to bufferize as much as it wants to. Just raise
- * CONFIG_TELNET_CONSOLE_LINE_BUF_NUMBERS if possible.
+/* The console output is stored in this ring before being sent to the
+ * client, in chunks of up to one MSS, or of what is there when the send
+ * timer expires. The printk hook never waits: when the ring is full, the
+ * output is dropped and counted, and the count is reported to the client
+ * once there is room again. Only the hook writes at the head, under
+ * irq_lock(), so the telnet thread can read from the tail without it.
  */
-struct line_buf {
-	char buf[TELNET_LINE_SIZE];
+struct telnet_out_rb {
+	char buf[TELNET_OUT_SIZE];
+	uint16_t head;
+	uint16_t tail;
 	uint16_t len;
+	uint32_t dropped;
 };
 
-struct line_buf_rb {
-	struct line_buf l_bufs[TELNET_LINES];
-	uint16_t line_in;
-	uint16_t line_out;
-};
+static struct telnet_out_rb telnet_rb;
+
+/* Payload of the segments sent, set from the MTU of the client */
+static uint16_t telnet_mss;
 
-static struct line_buf_rb telnet_rb;
+/* Set by the send timer, for what is stored to be sent even if it does
+ * not fill a segment
+ */
+static bool telnet_flush;
 
 static char __noinit __stack telnet_stack[TELNET_STACK_SIZE];
 static K_SEM_DEFINE(send_lock, 0, UINT_MAX);
 
-/* The timer is used to send non-lf terminated output that has
- * been around for "tool long". This will prove to be useful
- * to send the shell prompt for instance.
- * ToDo: raise the time, incrementaly, when no output is coming
- *       so the timer will kick in less and less.
+/* The timer is started when output is stored in an empty ring, and
+ * sends whatever was stored meanwhile when it expires, so that lines
+ * printed one after the other go out in the same segment. It also sends
+ * non-lf terminated output such as the shell prompt.
  */
 static void telnet_send_prematurely(struct k_timer *timer);
 static K_TIMER_DEFINE(send_timer, telnet_send_prematurely, NULL);
@@ -96,14 +96,15 @@ extern void *__printk_get_hook(void);
 
 static void telnet_rb_init(void)
 {
-	int i;
+	int key = irq_lock();
 
-	telnet_rb.line_in = 0;
-	telnet_rb.line_out = 0;
+	telnet_rb.head = 0;
+	telnet_rb.tail = 0;
+	telnet_rb.len = 0;
+	telnet_rb.dropped = 0;
+	telnet_flush = false;
 
-	for (i = 0; i < TELNET_LINES; i++) {
-		telnet_rb.l_bufs[i].len = 0;
-	}
+	irq_unlock(key);
 }
 
 static void telnet_end_client_connection(void)
@@ -134,65 +135,40 @@ static int telnet_setup_out_buf(struct net_context *client)
 	return 0;
 }
 
-static void telnet_rb_switch(void)
+static inline void telnet_rb_put(char c)
 {
-	telnet_rb.line_in++;
-
-	if (telnet_rb.line_in == TELNET_LINES) {
-		telnet_rb.line_in = 0;
+	if (telnet_rb.len == TELNET_OUT_SIZE) {
+		telnet_rb.dropped++;
+		return;
 	}
 
-	telnet_rb.l_bufs[telnet_rb.line_in].len = 0;
-
-	/* Unfortunately, we don't have enough line buffer,
-	 * so we eat the next to be sent.
-	 */
-	if (telnet_rb.line_in == telnet_rb.line_out) {
-		telnet_rb.line_out++;
-		if (telnet_rb.line_out == TELNET_LINES) {
-			telnet_rb.line_out = 0;
-		}
+	telnet_rb.buf[telnet_rb.head++] = c;
+	if (telnet_rb.head == TELNET_OUT_SIZE) {
+		telnet_rb.head = 0;
 	}
 
-	k_timer_start(&send_timer, TELNET_TIMEOUT, TELNET_TIMEOUT);
-	k_sem_give(&send_lock);
-}
-
-static inline struct line_buf *telnet_rb_get_line_out(void)
-{
-	uint16_t out = telnet_rb.line_out;
+	telnet_rb.len++;
 
-	telnet_rb.line_out++;
-	if (telnet_rb.line_out == TELNET_LINES) {
-		telnet_rb.line_out = 0;
-	}
-
-	if (!telnet_rb.l_bufs[out].len) {
-		return NULL;
+	/* A full segment does not wait for the timer */
+	if (telnet_rb.len == telnet_mss) {
+		k_sem_give(&send_lock);
 	}
-
-	return &telnet_rb.l_bufs[out];
-}
-
-static inline struct line_buf *telnet_rb_get_line_in(void)
-{
-	return &telnet_rb.l_bufs[telnet_rb.line_in];
 }
 
 /* The actual printk hook */
 static int telnet_console_out(int c)
 {
 	int key = irq_lock();
-	struct line_buf *lb = telnet_rb_get_line_in();
-	bool yield = false;
 
-	lb->buf[lb->len++] = (char)c;
+	if (!telnet_rb.len) {
+		k_timer_start(&send_timer, TELNET_TIMEOUT, 0);
+	}
 
-	if (c == '\n' || lb->len == TELNET_LINE_SIZE - 1) {
-		lb->buf[lb->len-1] = NVT_CR;
-		lb->buf[lb->len++] = NVT_LF;
-		telnet_rb_switch();
-		yield = true;
+	if (c == '\n') {
+		telnet_rb_put(NVT_CR);
+		telnet_rb_put(NVT_LF);
+	} else {
+		telnet_rb_put((char)c);
 	}
 
 	irq_unlock(key);
@@ -204,20 +180,27 @@ static int telnet_console_out(int c)
 	orig_printk_hook(c);
 #endif
 
-	if (yield) {
-		k_yield();
-	}
-
 	return c;
 }
 
 static void telnet_send_prematurely(struct k_timer *timer)
 {
-	struct line_buf *lb = telnet_rb_get_line_in();
+	int key = irq_lock();
+	uint16_t last = telnet_rb.head ? telnet_rb.head - 1 :
+		TELNET_OUT_SIZE - 1;
 
-	if (lb->len >= TELNET_THRESHOLD) {
-		telnet_rb_switch();
+	/* Pending output not terminated by a line feed is only sent
+	 * once it is long enough, more of it is probably coming
+	 */
+	if (telnet_rb.len >= TELNET_THRESHOLD ||
+	    (telnet_rb.len && telnet_rb.buf[last] == NVT_LF)) {
+		telnet_flush = true;
+		k_sem_give(&send_lock);
+	} else if (telnet_rb.len) {
+		k_timer_start(&send_timer, TELNET_TIMEOUT, 0);
 	}
+
+	irq_unlock(key);
 }
 
 static void telnet_sent_cb(struct net_context *client,
@@ -229,23 +212,98 @@ static void telnet_sent_cb(struct net_context *client,
 	}
 }
 
+static inline bool telnet_send_out_buf(void)
+{
+	if (net_context_send(out_buf, telnet_sent_cb,
+			     K_NO_WAIT, NULL, NULL) ||
+	    telnet_setup_out_buf(client_cnx)) {
+		return false;
+	}
+
+	return true;
+}
+
+/* Tells the client how much output was lost, in its own segment as the
+ * previous one may be a full one
+ */
+static inline bool telnet_send_dropped(void)
+{
+	char msg[32];
+	uint32_t dropped;
+	int key, len;
+
+	key = irq_lock();
+	dropped = telnet_rb.dropped;
+	telnet_rb.dropped = 0;
+	irq_unlock(key);
+
+	if (!dropped) {
+		return true;
+	}
+
+	len = snprintk(msg, sizeof(msg), "\r\n[%u bytes dropped]\r\n",
+		       dropped);
+	net_nbuf_append(out_buf, len, msg, K_FOREVER);
+
+	return telnet_send_out_buf();
+}
+
+/* Sends one segment of the output stored, from the tail of the ring */
+static inline bool telnet_send_chunk(uint16_t len)
+{
+	uint16_t tail = telnet_rb.tail;
+	uint16_t part;
+	int key;
+
+	part = min(len, TELNET_OUT_SIZE - tail);
+	net_nbuf_append(out_buf, part, &telnet_rb.buf[tail], K_FOREVER);
+
+	if (part < len) {
+		net_nbuf_append(out_buf, len - part, telnet_rb.buf, K_FOREVER);
+	}
+
+	key = irq_lock();
+
+	/* Unless the ring was reset meanwhile, by an abort output command */
+	if (telnet_rb.tail == tail && telnet_rb.len >= len) {
+		telnet_rb.tail = (tail + len) % TELNET_OUT_SIZE;
+		telnet_rb.len -= len;
+	}
+
+	irq_unlock(key);
+
+	return telnet_send_out_buf() && telnet_send_dropped();
+}
+
 static inline bool telnet_send(void)
 {
-	struct line_buf *lb = telnet_rb_get_line_out();
+	uint16_t len;
+	int key;
 
-	if (lb) {
-		net_nbuf_append(out_buf, lb->len, lb->buf, K_FOREVER);
+	while (client_cnx) {
+		len = min(telnet_rb.len, telnet_mss);
 
-		/* We reinitialize the line buffer */
-		lb->len = 0;
+		/* Only full segments are sent before the timer expires, the
+		 * rest is sent along with what comes next
+		 */
+		if (!len || (len < telnet_mss && !telnet_flush)) {
+			break;
+		}
 
-		if (net_context_send(out_buf, telnet_sent_cb,
-				     K_NO_WAIT, NULL, NULL) ||
-		    telnet_setup_out_buf(client_cnx)) {
+		if (!telnet_send_chunk(len)) {
 			return false;
 		}
 	}
 
+	key = irq_lock();
+
+	telnet_flush = false;
+	if (telnet_rb.len && !k_timer_remaining_get(&send_timer)) {
+		k_timer_start(&send_timer, TELNET_TIMEOUT, 0);
+	}
+
+	irq_unlock(key);
+
 	return true;
 }
 
@@ -453,11 +511,19 @@ static void telnet_accept(struct net_context *client,
 	SYS_LOG_DBG("Telnet client connected (family AF_INET%s)",
 		    net_context_get_family(client) == AF_INET ? "" : "6");
 
+	telnet_mss = net_if_get_mtu(net_context_get_iface(client));
+	if (net_context_get_family(client) == AF_INET) {
+		telnet_mss -= NET_IPV4TCPH_LEN;
+	} else {
+		telnet_mss -= NET_IPV6TCPH_LEN;
+	}
+
+	telnet_mss = min(telnet_mss, TELNET_OUT_SIZE);
+
 	orig_printk_hook = __printk_get_hook();
 	__printk_hook_install(telnet_console_out);
 
 	client_cnx = client;
-	k_timer_start(&send_timer, TELNET_TIMEOUT, TELNET_TIMEOUT);
 
 	return;
 error:
@@ -10,7 +10,8 @@
  *
  *
  * Serial console driver.
- * Hooks into the printk and fputc (for printf) modules. Poll driven.
+ * Hooks into the printk and fputc (for printf) modules. Poll driven, or
+ * buffered and interrupt driven with CONFIG_UART_CONSOLE_BUFFERED.
  */
 
 #include <kernel.h>
@@ -79,6 +80,115 @@ static int console_in(void)
 }
 #endif
 
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+static uint8_t tx_buf[CONFIG_UART_CONSOLE_TX_BUF_SIZE];
+/* Output is added at the head and sent from the tail */
+static unsigned int tx_head;
+static unsigned int tx_tail;
+/* Set once a fatal error occurred, the output is then polled out */
+static bool tx_polled;
+
+static void console_putc(uint8_t c)
+{
+	unsigned int key;
+	unsigned int next;
+
+	if (tx_polled) {
+		uart_poll_out(uart_console_dev, c);
+		return;
+	}
+
+	key = irq_lock();
+
+	next = (tx_head + 1) % sizeof(tx_buf);
+	if (next == tx_tail) {
+#ifdef CONFIG_UART_CONSOLE_OVERFLOW_DROP
+		irq_unlock(key);
+		return;
+#else
+		/* Make room by sending the oldest character right away */
+		uart_poll_out(uart_console_dev, tx_buf[tx_tail]);
+		tx_tail = (tx_tail + 1) % sizeof(tx_buf);
+#endif
+	}
+
+	tx_buf[tx_head] = c;
+	tx_head = next;
+
+	uart_irq_tx_enable(uart_console_dev);
+
+	irq_unlock(key);
+}
+
+/* Moves the buffered output to the UART FIFO, from the ISR */
+static void console_tx_fill(void)
+{
+	unsigned int len;
+	int sent;
+
+	while (tx_tail != tx_head) {
+		if (tx_head > tx_tail) {
+			len = tx_head - tx_tail;
+		} else {
+			len = sizeof(tx_buf) - tx_tail;
+		}
+
+		sent = uart_fifo_fill(uart_console_dev, &tx_buf[tx_tail], len);
+		if (sent <= 0) {
+			return;
+		}
+
+		tx_tail = (tx_tail + sent) % sizeof(tx_buf);
+	}
+
+	uart_irq_tx_disable(uart_console_dev);
+}
+
+static void console_tx_isr(void)
+{
+	unsigned int key;
+
+	/* Higher priority ISRs may output while the FIFO is filled */
+	key = irq_lock();
+
+	if (uart_irq_tx_ready(uart_console_dev)) {
+		console_tx_fill();
+	}
+
+	irq_unlock(key);
+}
+
+#if !defined(CONFIG_CONSOLE_HANDLER)
+static void uart_console_tx_isr(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	while (uart_irq_update(uart_console_dev) &&
+	       uart_irq_is_pending(uart_console_dev)) {
+		console_tx_isr();
+	}
+}
+#endif
+
+void uart_console_panic(void)
+{
+	tx_polled = true;
+
+	if (!uart_console_dev) {
+		return;
+	}
+
+	uart_irq_tx_disable(uart_console_dev);
+
+	while (tx_tail != tx_head) {
+		uart_poll_out(uart_console_dev, tx_buf[tx_tail]);
+		tx_tail = (tx_tail + 1) % sizeof(tx_buf);
+	}
+}
+#else
+#define console_putc(c) uart_poll_out(uart_console_dev, c)
+#endif /* CONFIG_UART_CONSOLE_BUFFERED */
+
 #if defined(CONFIG_PRINTK) || defined(CONFIG_STDOUT_CONSOLE)
 /**
  *
@@ -104,9 +214,9 @@ static int console_out(int c)
 #endif /* CONFIG_UART_CONSOLE_DEBUG_SERVER_HOOKS */
 
 	if ('\n' == c) {
-		uart_poll_out(uart_console_dev, '\r');
+		console_putc('\r');
 	}
-	uart_poll_out(uart_console_dev, c);
+	console_putc(c);
 
 	return c;
 }
@@ -345,6 +455,10 @@ void uart_console_isr(struct device *unused)
 		uint8_t byte;
 		int rx;
 
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+		console_tx_isr();
+#endif
+
 		if (!uart_irq_rx_ready(uart_console_dev)) {
 			continue;
 		}
@@ -433,7 +547,10 @@ static void console_input_init(void)
 	uint8_t c;
 
 	uart_irq_rx_disable(uart_console_dev);
+	/* Buffered output may be pending, it is left to be sent */
+#ifndef CONFIG_UART_CONSOLE_BUFFERED
 	uart_irq_tx_disable(uart_console_dev);
+#endif
 
 	uart_irq_callback_set(uart_console_dev, uart_console_isr);
 
@@ -502,6 +619,10 @@ static int uart_console_init(struct device *arg)
 	k_busy_wait(1000000);
 #endif
 
+#if defined(CONFIG_UART_CONSOLE_BUFFERED) && !defined(CONFIG_CONSOLE_HANDLER)
+	uart_irq_callback_set(uart_console_dev, uart_console_tx_isr);
+#endif
+
 	uart_console_hook_install();
 
 	return 0;
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Alarm queues on top of the alarm of a counter device
+ *
+ * The alarms are kept in expiration order, each one storing the ticks
+ * after the previous one, and the first one the ticks after the device
+ * alarm was set. Only the first one is set as the device alarm, so adding
+ * an alarm expiring later is a walk of the queue, without touching the
+ * device.
+ */
+
+#include <kernel.h>
+#include <errno.h>
+#include <counter.h>
+
+static void alarm_expired(struct device *dev, void *user_data);
+
+static inline struct counter_alarm *queue_first(
+	struct counter_alarm_queue *queue)
+{
+	struct counter_alarm *first;
+
+	return SYS_DLIST_PEEK_HEAD_CONTAINER(&queue->alarms, first, node);
+}
+
+/* Ticks since the device alarm was set, the first alarm being relative to
+ * the one expired while dispatching
+ */
+static uint32_t queue_elapsed(struct counter_alarm_queue *queue)
+{
+	if (queue->dispatching || sys_dlist_is_empty(&queue->alarms)) {
+		return 0;
+	}
+
+	return counter_read(queue->dev);
+}
+
+/* Makes the first alarm relative to now, for the device alarm to be set */
+static void queue_rebase(struct counter_alarm_queue *queue, uint32_t elapsed)
+{
+	struct counter_alarm *first = queue_first(queue);
+
+	if (first) {
+		first->delta = elapsed < first->delta ?
+			       first->delta - elapsed : 0;
+	}
+}
+
+static int queue_arm(struct counter_alarm_queue *queue)
+{
+	struct counter_alarm *first = queue_first(queue);
+
+	if (!first) {
+		return counter_set_alarm(queue->dev, NULL, 0, NULL);
+	}
+
+	return counter_set_alarm(queue->dev, alarm_expired,
+				 first->delta ? first->delta : 1, queue);
+}
+
+static void queue_insert(struct counter_alarm_queue *queue,
+			 struct counter_alarm *alarm, uint32_t ticks)
+{
+	struct counter_alarm *next;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&queue->alarms, next, node) {
+		if (ticks < next->delta) {
+			next->delta -= ticks;
+			alarm->delta = ticks;
+			sys_dlist_insert_before(&queue->alarms, &next->node,
+						&alarm->node);
+			return;
+		}
+
+		ticks -= next->delta;
+	}
+
+	alarm->delta = ticks;
+	sys_dlist_append(&queue->alarms, &alarm->node);
+}
+
+/* Returns whether the alarm was queued */
+static bool queue_remove(struct counter_alarm_queue *queue,
+			 struct counter_alarm *alarm)
+{
+	struct counter_alarm *next;
+
+	if (!alarm->node.next) {
+		return false;
+	}
+
+	next = SYS_DLIST_PEEK_NEXT_CONTAINER(&queue->alarms, alarm, node);
+	if (next) {
+		next->delta += alarm->delta;
+	}
+
+	sys_dlist_remove(&alarm->node);
+	alarm->node.next = NULL;
+
+	return true;
+}
+
+static void alarm_expired(struct device *dev, void *user_data)
+{
+	struct counter_alarm_queue *queue = user_data;
+	struct counter_alarm *alarm;
+
+	queue->dispatching = true;
+
+	/* The alarms expiring along with the first one are called as well */
+	alarm = queue_first(queue);
+	while (alarm) {
+		/* Expired, the next alarm is now relative to this expiration */
+		alarm->delta = 0;
+		queue_remove(queue, alarm);
+
+		/* Relative to this expiration, not to the callback return */
+		if (alarm->period) {
+			queue_insert(queue, alarm, alarm->period);
+		}
+
+		alarm->callback(alarm);
+
+		alarm = queue_first(queue);
+		if (alarm && alarm->delta) {
+			break;
+		}
+	}
+
+	queue->dispatching = false;
+
+	/* The device counts from the expiration again, the time taken by
+	 * the callbacks is not added to the next alarm
+	 */
+	queue_rebase(queue, queue_elapsed(queue));
+	queue_arm(queue);
+}
+
+void counter_alarm_queue_init(struct counter_alarm_queue *queue,
+			      struct device *dev)
+{
+	queue->dev = dev;
+	queue->dispatching = false;
+	sys_dlist_init(&queue->alarms);
+}
+
+int counter_alarm_add(struct counter_alarm_queue *queue,
+		      struct counter_alarm *alarm, uint32_t ticks)
+{
+	struct counter_alarm *first;
+	uint32_t elapsed;
+	unsigned int key;
+	int ret = 0;
+
+	if (!alarm->callback) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	elapsed = queue_elapsed(queue);
+	first = queue_first(queue);
+
+	/* Added again, the alarm is moved */
+	queue_remove(queue, alarm);
+
+	if (ticks > UINT32_MAX - elapsed) {
+		ticks = UINT32_MAX - elapsed;
+	}
+
+	queue_insert(queue, alarm, ticks + elapsed);
+
+	/* The device alarm is only set again if the first alarm changed */
+	if ((first == alarm || queue_first(queue) == alarm) &&
+	    !queue->dispatching) {
+		queue_rebase(queue, elapsed);
+		ret = queue_arm(queue);
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+int counter_alarm_cancel(struct counter_alarm_queue *queue,
+			 struct counter_alarm *alarm)
+{
+	uint32_t elapsed;
+	unsigned int key;
+	bool first;
+	int ret = 0;
+
+	key = irq_lock();
+
+	elapsed = queue_elapsed(queue);
+	first = (queue_first(queue) == alarm);
+
+	if (queue_remove(queue, alarm) && first && !queue->dispatching) {
+		queue_rebase(queue, elapsed);
+		ret = queue_arm(queue);
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
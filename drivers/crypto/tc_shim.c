@@ -14,6 +14,7 @@
 #include <tinycrypt/constants.h>
 #include <tinycrypt/utils.h>
 #include <string.h>
+#include <kernel.h>
 #include <crypto/cipher.h>
 #include "tc_shim_priv.h"
 
@@ -25,6 +26,24 @@
 #define CRYPTO_MAX_SESSION 5
 static struct tc_shim_drv_state tc_driver_state[CRYPTO_MAX_SESSION];
 
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+/* An operation of an async session, queued for the driver thread */
+struct tc_shim_req {
+	struct cipher_ctx *ctx;
+	union {
+		struct cipher_pkt *pkt;
+		struct cipher_aead_pkt *aead_pkt;
+	};
+	uint8_t *iv;
+};
+
+K_MSGQ_DEFINE(tc_shim_queue, sizeof(struct tc_shim_req),
+	      CONFIG_CRYPTO_TINYCRYPT_SHIM_QUEUE_LEN, 4);
+
+static char __stack tc_shim_stack[CONFIG_CRYPTO_TINYCRYPT_SHIM_STACK_SIZE];
+static crypto_completion_cb tc_shim_async_cb;
+#endif /* CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC */
+
 static int do_cbc_encrypt(struct cipher_ctx *ctx, struct cipher_pkt *op,
 			  uint8_t *iv)
 {
@@ -92,6 +111,15 @@ static int do_ctr_op(struct cipher_ctx *ctx, struct cipher_pkt *op,
 	return 0;
 }
 
+/* TinyCrypt CCM can run in place, both the CTR encryption and the CBC-MAC
+ * going forward through the data.
+ */
+static inline uint8_t *ccm_out_buf(struct cipher_ctx *ctx,
+				   struct cipher_pkt *op)
+{
+	return (ctx->flags & CAP_INPLACE_OPS) ? op->in_buf : op->out_buf;
+}
+
 static int do_ccm_encrypt_mac(struct cipher_ctx *ctx,
 			     struct cipher_aead_pkt *aead_op, uint8_t *nonce)
 {
@@ -99,6 +127,7 @@ static int do_ccm_encrypt_mac(struct cipher_ctx *ctx,
 	struct tc_shim_drv_state *data =  ctx->drv_sessn_state;
 	struct ccm_params *ccm_param = &ctx->mode_params.ccm_info;
 	struct cipher_pkt *op = aead_op->pkt;
+	uint8_t *out = ccm_out_buf(ctx, op);
 
 	if (tc_ccm_config(&ccm, &data->session_key, nonce,
 			ccm_param->nonce_len,
@@ -107,7 +136,7 @@ static int do_ccm_encrypt_mac(struct cipher_ctx *ctx,
 		return -EIO;
 	}
 
-	if (tc_ccm_generation_encryption(op->out_buf, aead_op->ad,
+	if (tc_ccm_generation_encryption(out, aead_op->ad,
 					 aead_op->ad_len, op->in_buf,
 					  op->in_len, &ccm) == TC_CRYPTO_FAIL) {
 		SYS_LOG_ERR("TC internal error during CCM Encryption OP\n");
@@ -119,7 +148,7 @@ static int do_ccm_encrypt_mac(struct cipher_ctx *ctx,
 	 * of this and provide sufficient buffer space in output buffer to hold
 	 * both encrypted output and hash
 	 */
-	aead_op->tag = op->out_buf + op->in_len;
+	aead_op->tag = out + op->in_len;
 
 	return 0;
 }
@@ -131,6 +160,7 @@ static int do_ccm_decrypt_auth(struct cipher_ctx *ctx,
 	struct tc_shim_drv_state *data =  ctx->drv_sessn_state;
 	struct ccm_params *ccm_param = &ctx->mode_params.ccm_info;
 	struct cipher_pkt *op = aead_op->pkt;
+	uint8_t *out = ccm_out_buf(ctx, op);
 
 	if (tc_ccm_config(&ccm, &data->session_key, nonce,
 			  ccm_param->nonce_len,
@@ -148,7 +178,7 @@ static int do_ccm_decrypt_auth(struct cipher_ctx *ctx,
 		return -EIO;
 	}
 
-	if (tc_ccm_decryption_verification(op->out_buf, aead_op->ad,
+	if (tc_ccm_decryption_verification(out, aead_op->ad,
 					   aead_op->ad_len, op->in_buf,
 					   op->in_len + ccm_param->tag_len,
 					    &ccm) == TC_CRYPTO_FAIL) {
@@ -159,6 +189,92 @@ static int do_ccm_decrypt_auth(struct cipher_ctx *ctx,
 	return 0;
 }
 
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+static int queue_req(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
+		     struct cipher_aead_pkt *aead_pkt, uint8_t *iv)
+{
+	struct tc_shim_req req = {
+		.ctx = ctx,
+		.iv = iv,
+	};
+
+	if (aead_pkt) {
+		req.aead_pkt = aead_pkt;
+	} else {
+		req.pkt = pkt;
+	}
+
+	if (k_msgq_put(&tc_shim_queue, &req, K_NO_WAIT)) {
+		SYS_LOG_ERR("Too many async ops in flight\n");
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int queue_cbc_op(struct cipher_ctx *ctx, struct cipher_pkt *op,
+			uint8_t *iv)
+{
+	return queue_req(ctx, op, NULL, iv);
+}
+
+static int queue_ctr_op(struct cipher_ctx *ctx, struct cipher_pkt *op,
+			uint8_t *iv)
+{
+	return queue_req(ctx, op, NULL, iv);
+}
+
+static int queue_ccm_op(struct cipher_ctx *ctx,
+			struct cipher_aead_pkt *aead_op, uint8_t *nonce)
+{
+	return queue_req(ctx, NULL, aead_op, nonce);
+}
+
+/* Runs the queued ops in order, as many as were queued meanwhile */
+static void tc_shim_thread(void *p1, void *p2, void *p3)
+{
+	struct tc_shim_req req;
+	struct tc_shim_drv_state *data;
+	struct cipher_pkt *pkt;
+	int ret;
+
+	while (1) {
+		k_msgq_get(&tc_shim_queue, &req, K_FOREVER);
+
+		data = req.ctx->drv_sessn_state;
+
+		switch (req.ctx->ops.cipher_mode) {
+		case CRYPTO_CIPHER_MODE_CBC:
+			pkt = req.pkt;
+			ret = data->ops.cbc_crypt_hndlr(req.ctx, pkt, req.iv);
+			break;
+		case CRYPTO_CIPHER_MODE_CTR:
+			pkt = req.pkt;
+			ret = data->ops.ctr_crypt_hndlr(req.ctx, pkt, req.iv);
+			break;
+		default:
+			pkt = req.aead_pkt->pkt;
+			ret = data->ops.ccm_crypt_hndlr(req.ctx, req.aead_pkt,
+							req.iv);
+			break;
+		}
+
+		if (tc_shim_async_cb) {
+			tc_shim_async_cb(pkt, ret);
+		}
+	}
+}
+
+static int tc_callback_set(struct device *dev, crypto_completion_cb cb)
+{
+	ARG_UNUSED(dev);
+
+	tc_shim_async_cb = cb;
+
+	return 0;
+}
+#endif /* CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC */
+
 static int get_unused_session(void)
 {
 	int i;
@@ -198,13 +314,20 @@ int tc_session_setup(struct device *dev, struct cipher_ctx *ctx,
 		return -EINVAL;
 	}
 
-	/* TinyCrypt being a software library, only synchronous operations
-	 * make sense.
+#ifndef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	/* TinyCrypt being a software library, asynchronous operations are
+	 * only provided through the queue of the driver thread.
 	 */
 	if (!(ctx->flags & CAP_SYNC_OPS)) {
 		SYS_LOG_ERR("Async not supported by this driver.\n");
 		return -EINVAL;
 	}
+#endif
+
+	if ((ctx->flags & CAP_INPLACE_OPS) && mode != CRYPTO_CIPHER_MODE_CCM) {
+		SYS_LOG_ERR("In place ops supported only in CCM mode\n");
+		return -EINVAL;
+	}
 
 	if (ctx->keylen != TC_AES_KEY_SIZE) {
 		/* TinyCrypt supports only 128 bits */
@@ -258,6 +381,25 @@ int tc_session_setup(struct device *dev, struct cipher_ctx *ctx,
 
 	ctx->ops.cipher_mode = mode;
 
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	/* The ops of async sessions are queued, then run by the thread */
+	if (ctx->flags & CAP_ASYNC_OPS) {
+		data->ops = ctx->ops;
+
+		switch (mode) {
+		case CRYPTO_CIPHER_MODE_CBC:
+			ctx->ops.cbc_crypt_hndlr = queue_cbc_op;
+			break;
+		case CRYPTO_CIPHER_MODE_CTR:
+			ctx->ops.ctr_crypt_hndlr = queue_ctr_op;
+			break;
+		default:
+			ctx->ops.ccm_crypt_hndlr = queue_ccm_op;
+			break;
+		}
+	}
+#endif
+
 	if (tc_aes128_set_encrypt_key(&data->session_key, ctx->key.bit_stream)
 			 == TC_CRYPTO_FAIL) {
 		SYS_LOG_ERR("TC internal error in setting key\n");
@@ -269,7 +411,13 @@ int tc_session_setup(struct device *dev, struct cipher_ctx *ctx,
 
 int tc_query_caps(struct device *dev)
 {
-	return (CAP_RAW_KEY | CAP_SEPARATE_IO_BUFS | CAP_SYNC_OPS);
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	return (CAP_RAW_KEY | CAP_INPLACE_OPS | CAP_SEPARATE_IO_BUFS |
+		CAP_SYNC_OPS | CAP_ASYNC_OPS);
+#else
+	return (CAP_RAW_KEY | CAP_INPLACE_OPS | CAP_SEPARATE_IO_BUFS |
+		CAP_SYNC_OPS);
+#endif
 }
 
 
@@ -293,6 +441,13 @@ static int tc_shim_init(struct device *dev)
 	for (i = 0; i < CRYPTO_MAX_SESSION; i++) {
 		tc_driver_state[i].in_use = 0;
 	}
+
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	k_thread_spawn(tc_shim_stack, sizeof(tc_shim_stack),
+		       tc_shim_thread, NULL, NULL, NULL,
+		       K_PRIO_PREEMPT(CONFIG_CRYPTO_TINYCRYPT_SHIM_PRIORITY),
+		       0, K_NO_WAIT);
+#endif
 	return 0;
 }
 
@@ -302,7 +457,11 @@ static int tc_shim_init(struct device *dev)
 static struct crypto_driver_api crypto_enc_funcs = {
 	.begin_session = tc_session_setup,
 	.free_session = tc_session_free,
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	.crypto_async_callback_set = tc_callback_set,
+#else
 	.crypto_async_callback_set = NULL,
+#endif
 	.query_hw_caps = tc_query_caps,
 };
 
@@ -18,11 +18,16 @@
 #define __TC_SHIM_PRIV_H__
 
 #include <tinycrypt/aes.h>
+#include <crypto/cipher_structs.h>
 
 struct tc_shim_drv_state {
 	int in_use;
 //	int session_key;
 	struct tc_aes_key_sched_struct session_key;
+#ifdef CONFIG_CRYPTO_TINYCRYPT_SHIM_ASYNC
+	/* Handlers run by the driver thread for the ops of async sessions */
+	struct cipher_ops ops;
+#endif
 };
 
 #endif  /* __TC_SHIM_PRIV_H__ */
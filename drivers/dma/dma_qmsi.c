@@ -24,6 +24,11 @@ struct dma_qmsi_config_info {
 struct dma_qmsi_context {
 	uint32_t index;
 	struct device *dev;
+	/* Blocks left to be transferred, the chain completes at zero */
+	uint32_t blocks_left;
+	uint32_t block_count;
+	bool cyclic;
+	bool block_callback;
 };
 
 struct dma_qmsi_driver_data {
@@ -43,6 +48,10 @@ struct dma_qmsi_driver_data {
 static struct dma_qmsi_context dma_context[QM_DMA_CHANNEL_NUM];
 static void dma_qmsi_config(struct device *dev);
 
+/* Descriptors of the block chains, a buffer of a single block per item */
+static qm_dma_linked_list_item_t
+	dma_lli[QM_DMA_CHANNEL_NUM][CONFIG_DMA_QMSI_BLOCK_COUNT] __aligned(4);
+
 static void dma_callback(void *callback_context, uint32_t len,
 						 int error_code)
 {
@@ -71,6 +80,17 @@ static void dma_drv_callback(void *callback_context, uint32_t len,
 	channel = context->index;
 	data = context->dev->driver_data;
 
+	/* In linked list mode, the callback comes at the end of each block */
+	if (error_code == 0 && context->cyclic) {
+		error_code = DMA_STATUS_BLOCK;
+	} else if (error_code == 0 && --context->blocks_left) {
+		if (!context->block_callback) {
+			return;
+		}
+
+		error_code = DMA_STATUS_BLOCK;
+	}
+
 	data->dma_user_callback[channel](context->dev, channel, error_code);
 }
 
@@ -190,10 +210,14 @@ static int dma_qmsi_chan_config(struct device *dev, uint32_t channel,
 	struct dma_qmsi_driver_data *data = dev->driver_data;
 	qm_dma_transfer_t qmsi_transfer_cfg = { 0 };
 	qm_dma_channel_config_t qmsi_cfg = { 0 };
+	struct dma_block_config *block;
 	uint32_t temp = 0;
 	int ret = 0;
+	int i;
 
-	if (config->block_count != 1) {
+	if (config->block_count == 0 ||
+	    config->block_count > CONFIG_DMA_QMSI_BLOCK_COUNT ||
+	    config->half_callback_en) {
 		return -ENOTSUP;
 	}
 
@@ -226,13 +250,21 @@ static int dma_qmsi_chan_config(struct device *dev, uint32_t channel,
 	}
 	qmsi_cfg.source_burst_length = (qm_dma_burst_length_t) temp;
 
-	/* TODO: add support for using other DMA transfer types. */
-	qmsi_cfg.transfer_type = QM_DMA_TYPE_SINGLE;
+	if (config->cyclic) {
+		qmsi_cfg.transfer_type = QM_DMA_TYPE_MULTI_LL_CIRCULAR;
+	} else if (config->block_count > 1) {
+		qmsi_cfg.transfer_type = QM_DMA_TYPE_MULTI_LL;
+	} else {
+		qmsi_cfg.transfer_type = QM_DMA_TYPE_SINGLE;
+	}
 
 	data->dma_user_callback[channel] = config->dma_callback;
 
 	dma_context[channel].index = channel;
 	dma_context[channel].dev = dev;
+	dma_context[channel].block_count = config->block_count;
+	dma_context[channel].cyclic = config->cyclic;
+	dma_context[channel].block_callback = config->complete_callback_en;
 
 	qmsi_cfg.callback_context = &dma_context[channel];
 	qmsi_cfg.client_callback = dma_drv_callback;
@@ -242,14 +274,44 @@ static int dma_qmsi_chan_config(struct device *dev, uint32_t channel,
 		return ret;
 	}
 
-	qmsi_transfer_cfg.block_size = config->head_block->block_size;
-	qmsi_transfer_cfg.source_address = (uint32_t *)
-					   config->head_block->source_address;
-	qmsi_transfer_cfg.destination_address = (uint32_t *)
-					      config->head_block->dest_address;
+	if (qmsi_cfg.transfer_type == QM_DMA_TYPE_SINGLE) {
+		qmsi_transfer_cfg.block_size = config->head_block->block_size;
+		qmsi_transfer_cfg.source_address = (uint32_t *)
+					config->head_block->source_address;
+		qmsi_transfer_cfg.destination_address = (uint32_t *)
+					config->head_block->dest_address;
 
-	return qm_dma_transfer_set_config(info->instance, channel,
-					  &qmsi_transfer_cfg);
+		return qm_dma_transfer_set_config(info->instance, channel,
+						  &qmsi_transfer_cfg);
+	}
+
+	/* Each block is appended to the linked list as a buffer of its own */
+	block = config->head_block;
+	for (i = 0; i < config->block_count; i++) {
+		qm_dma_multi_transfer_t multi_cfg = { 0 };
+
+		if (!block || block->block_size == 0 ||
+		    block->block_size > QM_DMA_CTL_H_BLOCK_TS_MAX) {
+			return -EINVAL;
+		}
+
+		multi_cfg.block_size = block->block_size;
+		multi_cfg.num_blocks = 1;
+		multi_cfg.source_address = (uint32_t *)block->source_address;
+		multi_cfg.destination_address = (uint32_t *)
+						block->dest_address;
+		multi_cfg.linked_list_first = &dma_lli[channel][i];
+
+		ret = qm_dma_multi_transfer_set_config(info->instance, channel,
+						       &multi_cfg);
+		if (ret != 0) {
+			return ret;
+		}
+
+		block = block->next_block;
+	}
+
+	return 0;
 }
 
 static int dma_qmsi_transfer_start(struct device *dev, uint32_t channel)
@@ -263,6 +325,8 @@ static int dma_qmsi_start(struct device *dev, uint32_t channel)
 {
 	const struct dma_qmsi_config_info *info = dev->config->config_info;
 
+	dma_context[channel].blocks_left = dma_context[channel].block_count;
+
 	return qm_dma_transfer_start(info->instance, channel);
 }
 
@@ -8,6 +8,7 @@
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_DMA_LEVEL
 
 #include <board.h>
+#include <cache.h>
 #include <device.h>
 #include <dma.h>
 #include <errno.h>
@@ -51,6 +52,17 @@ struct dma_stm32_chan {
 	void (*dma_transfer)(struct device *dev, void *data);
 	void (*dma_error)(struct device *dev, void *data);
 	void *callback_data;
+
+	/* Channels configured through dma_config() */
+	void (*dma_callback)(struct device *dev, uint32_t channel,
+			     int error_code);
+	struct dma_block_config *head_block;
+	struct dma_block_config *block;	/* Block being transferred */
+	uint32_t blocks_left;
+	uint32_t block_count;
+	uint32_t data_size;		/* Size of a peripheral data item */
+	bool cyclic;
+	bool block_callback;
 };
 
 static struct dma_stm32_device {
@@ -207,6 +219,122 @@ static void dma_stm32_irq_clear(struct dma_stm32_device *ddata,
 	}
 }
 
+static void dma_stm32_stream_start(struct dma_stm32_device *ddata,
+				   uint32_t channel)
+{
+	struct dma_stm32_chan_reg *regs = &ddata->chan[channel].regs;
+	uint32_t irqstatus;
+
+	dma_stm32_write(ddata, DMA_STM32_SCR(channel),   regs->scr);
+	dma_stm32_write(ddata, DMA_STM32_SPAR(channel),  regs->spar);
+	dma_stm32_write(ddata, DMA_STM32_SM0AR(channel), regs->sm0ar);
+	dma_stm32_write(ddata, DMA_STM32_SFCR(channel),  regs->sfcr);
+	dma_stm32_write(ddata, DMA_STM32_SM1AR(channel), regs->sm1ar);
+	dma_stm32_write(ddata, DMA_STM32_SNDTR(channel), regs->sndtr);
+
+	/* Clear remanent IRQs from previous transfers */
+	irqstatus = dma_stm32_irq_status(ddata, channel);
+	if (irqstatus) {
+		dma_stm32_irq_clear(ddata, channel, irqstatus);
+	}
+
+	/* Push the start button */
+	dma_stm32_write(ddata, DMA_STM32_SCR(channel),
+			regs->scr | DMA_STM32_SCR_EN);
+}
+
+/* Peripheral side of a block, the source of memory to memory transfers */
+static uint32_t dma_stm32_block_periph(struct dma_stm32_chan *chan,
+				       struct dma_block_config *block)
+{
+	if (chan->direction == DMA_STM32_MEM_TO_DEV) {
+		return block->dest_address;
+	}
+
+	return block->source_address;
+}
+
+static uint32_t dma_stm32_block_mem(struct dma_stm32_chan *chan,
+				    struct dma_block_config *block)
+{
+	if (chan->direction == DMA_STM32_MEM_TO_DEV) {
+		return block->source_address;
+	}
+
+	return block->dest_address;
+}
+
+static void dma_stm32_block_load(struct dma_stm32_chan *chan,
+				 struct dma_block_config *block)
+{
+	struct dma_stm32_chan_reg *regs = &chan->regs;
+
+	regs->spar  = dma_stm32_block_periph(chan, block);
+	regs->sm0ar = dma_stm32_block_mem(chan, block);
+	regs->sndtr = block->block_size / chan->data_size;
+	chan->block = block;
+
+	/* As in dma_stm32_transfer_start(), for the memory buffers */
+	sys_cache_data_range_flush((void *)regs->sm0ar, block->block_size);
+	if (chan->direction == DMA_STM32_MEM_TO_MEM) {
+		sys_cache_data_range_flush((void *)regs->spar,
+					   block->block_size);
+	}
+}
+
+/* IRQ of a channel configured through dma_stm32_config() */
+static void dma_stm32_chan_irq(struct device *dev, uint32_t channel,
+			       uint32_t irqstatus, uint32_t config)
+{
+	struct dma_stm32_device *ddata = dev->driver_data;
+	struct dma_stm32_chan *chan = &ddata->chan[channel];
+	struct dma_block_config *block = chan->block;
+
+	if (!(irqstatus & DMA_STM32_TCI)) {
+		SYS_LOG_ERR("Internal error: IRQ status: 0x%x\n", irqstatus);
+		dma_stm32_irq_clear(ddata, channel, irqstatus);
+		dma_stm32_write(ddata, DMA_STM32_SCR(channel),
+				config & ~DMA_STM32_SCR_EN);
+
+		chan->busy = false;
+		chan->dma_callback(dev, channel, -EIO);
+		return;
+	}
+
+	dma_stm32_irq_clear(ddata, channel, DMA_STM32_TCI);
+
+	/* In double buffer mode, the target has moved on to the other block */
+	if ((config & DMA_STM32_SCR_DBM) && !(config & DMA_STM32_SCR_CT)) {
+		block = block->next_block;
+	}
+
+	/* Drop the stale cache lines of the destination */
+	if (chan->direction != DMA_STM32_MEM_TO_DEV) {
+		sys_cache_data_range_invalidate(
+			(void *)dma_stm32_block_mem(chan, block),
+			block->block_size);
+	}
+
+	if (chan->cyclic) {
+		chan->dma_callback(dev, channel, DMA_STATUS_BLOCK);
+		return;
+	}
+
+	if (--chan->blocks_left == 0) {
+		chan->busy = false;
+		chan->dma_callback(dev, channel, 0);
+		return;
+	}
+
+	/* The stream stops at the end of a block, restart it on the next */
+	dma_stm32_block_load(chan, block->next_block);
+	dma_stm32_stream_start(ddata, channel);
+
+	if (chan->block_callback) {
+		chan->dma_callback(dev, channel, DMA_STATUS_BLOCK);
+	}
+}
+
 static void dma_stm32_irq_handler(void *arg, uint32_t channel)
 {
 	struct device *dev = arg;
@@ -221,12 +349,26 @@ static void dma_stm32_irq_handler(void *arg, uint32_t channel)
 	/* Silently ignore spurious transfer half complete IRQ */
 	if (irqstatus & DMA_STM32_HTI) {
 		dma_stm32_irq_clear(ddata, channel, DMA_STM32_HTI);
+
+		if (chan->dma_callback && (config & DMA_STM32_SCR_HTIE)) {
+			chan->dma_callback(dev, channel, DMA_STATUS_HALF_BLOCK);
+		}
+
+		return;
+	}
+
+	if (chan->dma_callback) {
+		dma_stm32_chan_irq(dev, channel, irqstatus, config);
 		return;
 	}
 
 	if ((irqstatus & DMA_STM32_TCI) && (config & DMA_STM32_SCR_TCIE)) {
 		dma_stm32_irq_clear(ddata, channel, DMA_STM32_TCI);
 
+		/* Drop the stale cache lines of the destination */
+		sys_cache_data_range_invalidate((void *)chan->regs.sm0ar,
+						chan->regs.sndtr);
+
 		chan->dma_transfer(chan->dev, chan->callback_data);
 	} else {
 		SYS_LOG_ERR("Internal error: IRQ status: 0x%x\n", irqstatus);
@@ -310,6 +452,7 @@ static int dma_stm32_channel_config(struct device *dev, uint32_t channel,
 	}
 
 	chan->busy	    = true;
+	chan->dma_callback  = NULL;
 	chan->dma_error     = config->dma_error;
 	chan->dma_transfer  = config->dma_transfer;
 	chan->callback_data = config->callback_data;
@@ -334,7 +477,6 @@ static int dma_stm32_transfer_start(struct device *dev, uint32_t channel)
 {
 	struct dma_stm32_device *ddata = dev->driver_data;
 	struct dma_stm32_chan_reg *regs = &ddata->chan[channel].regs;
-	uint32_t irqstatus;
 	int ret;
 
 	ret = dma_stm32_disable_chan(ddata, channel);
@@ -342,22 +484,256 @@ static int dma_stm32_transfer_start(struct device *dev, uint32_t channel)
 		return ret;
 	}
 
-	dma_stm32_write(ddata, DMA_STM32_SCR(channel),   regs->scr);
-	dma_stm32_write(ddata, DMA_STM32_SPAR(channel),  regs->spar);
-	dma_stm32_write(ddata, DMA_STM32_SM0AR(channel), regs->sm0ar);
-	dma_stm32_write(ddata, DMA_STM32_SFCR(channel),  regs->sfcr);
-	dma_stm32_write(ddata, DMA_STM32_SM1AR(channel), regs->sm1ar);
-	dma_stm32_write(ddata, DMA_STM32_SNDTR(channel), regs->sndtr);
+	/*
+	 * Write the source back to memory, and the destination too so that
+	 * no dirty cache line gets evicted over the transferred data.
+	 */
+	sys_cache_data_range_flush((void *)regs->spar, regs->sndtr);
+	sys_cache_data_range_flush((void *)regs->sm0ar, regs->sndtr);
 
-	/* Clear remanent IRQs from previous transfers */
-	irqstatus = dma_stm32_irq_status(ddata, channel);
-	if (irqstatus) {
-		dma_stm32_irq_clear(ddata, channel, irqstatus);
+	dma_stm32_stream_start(ddata, channel);
+
+	return 0;
+}
+
+/* Encodes a data item size in bytes, for the PSIZE and MSIZE fields */
+static int dma_stm32_width(uint32_t size, uint32_t *width)
+{
+	switch (size) {
+	case 1:
+		*width = 0;
+		break;
+	case 2:
+		*width = 1;
+		break;
+	case 4:
+		*width = 2;
+		break;
+	default:
+		return -ENOTSUP;
 	}
 
-	/* Push the start button */
-	dma_stm32_write(ddata, DMA_STM32_SCR(channel),
-			regs->scr | DMA_STM32_SCR_EN);
+	return 0;
+}
+
+/* Encodes a burst length in data items, for the PBURST and MBURST fields */
+static int dma_stm32_burst(uint32_t len, uint32_t *burst)
+{
+	switch (len) {
+	case 1:
+		*burst = 0;
+		break;
+	case 4:
+		*burst = 1;
+		break;
+	case 8:
+		*burst = 2;
+		break;
+	case 16:
+		*burst = 3;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static int dma_stm32_config(struct device *dev, uint32_t channel,
+			    struct dma_config *config)
+{
+	struct dma_stm32_device *ddata = dev->driver_data;
+	struct dma_stm32_chan *chan = &ddata->chan[channel];
+	struct dma_stm32_chan_reg *regs = &chan->regs;
+	struct dma_block_config *block = config->head_block;
+	struct dma_block_config *next;
+	uint32_t psize, msize, pburst, mburst, periph_adj, mem_adj, prio;
+	bool to_dev;
+	uint32_t i;
+
+	if (channel >= DMA_STM32_MAX_CHANNELS || !block ||
+	    config->block_count == 0) {
+		return -EINVAL;
+	}
+
+	if (chan->busy) {
+		return -EBUSY;
+	}
+
+	switch (config->channel_direction) {
+	case MEMORY_TO_MEMORY:
+		if (!ddata->mem2mem) {
+			SYS_LOG_ERR("%s does not support mem-to-mem "
+				    "transfers\n", dev->config->name);
+			return -EINVAL;
+		}
+
+		chan->direction = DMA_STM32_MEM_TO_MEM;
+		break;
+	case MEMORY_TO_PERIPHERAL:
+		chan->direction = DMA_STM32_MEM_TO_DEV;
+		break;
+	case PERIPHERAL_TO_MEMORY:
+		chan->direction = DMA_STM32_DEV_TO_MEM;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	/*
+	 * The stream repeats a single block in circular mode and two blocks
+	 * in double buffer mode, none of which works memory to memory.
+	 */
+	if (config->cyclic && (chan->direction == DMA_STM32_MEM_TO_MEM ||
+			       config->block_count > 2)) {
+		return -ENOTSUP;
+	}
+
+	to_dev = (chan->direction == DMA_STM32_MEM_TO_DEV);
+	chan->data_size = to_dev ? config->dest_data_size :
+				   config->source_data_size;
+
+	if (dma_stm32_width(chan->data_size, &psize) ||
+	    dma_stm32_width(to_dev ? config->source_data_size :
+				     config->dest_data_size, &msize) ||
+	    dma_stm32_burst(to_dev ? config->dest_burst_length :
+				     config->source_burst_length, &pburst) ||
+	    dma_stm32_burst(to_dev ? config->source_burst_length :
+				     config->dest_burst_length, &mburst)) {
+		return -ENOTSUP;
+	}
+
+	/* Addresses are either incremented or left unchanged */
+	periph_adj = to_dev ? block->dest_addr_adj : block->source_addr_adj;
+	mem_adj = to_dev ? block->source_addr_adj : block->dest_addr_adj;
+	if ((periph_adj | mem_adj) & 0x1) {
+		return -ENOTSUP;
+	}
+
+	for (i = 0, next = block; i < config->block_count; i++) {
+		if (!next || !next->block_size ||
+		    next->block_size % chan->data_size ||
+		    next->block_size / chan->data_size >
+		    DMA_STM32_MAX_DATA_ITEMS) {
+			return -EINVAL;
+		}
+
+		next = next->next_block;
+	}
+
+	/* Both buffers share the peripheral and the data counter */
+	next = block->next_block;
+	if (config->cyclic && config->block_count == 2 &&
+	    (next->block_size != block->block_size ||
+	     dma_stm32_block_periph(chan, next) !=
+	     dma_stm32_block_periph(chan, block))) {
+		return -ENOTSUP;
+	}
+
+	prio = config->channel_priority;
+	if (prio > DMA_STM32_PRIORITY_VERY_HIGH) {
+		prio = DMA_STM32_PRIORITY_VERY_HIGH;
+	}
+
+	memset(regs, 0, sizeof(struct dma_stm32_chan_reg));
+
+	regs->scr = DMA_STM32_SCR_DIR(chan->direction) |
+		DMA_STM32_SCR_PSIZE(psize) |
+		DMA_STM32_SCR_MSIZE(msize) |
+		DMA_STM32_SCR_PBURST(pburst) |
+		DMA_STM32_SCR_MBURST(mburst) |
+		DMA_STM32_SCR_PL(prio) |
+		DMA_STM32_SCR_TCIE |	/* Transfer comp IRQ enable */
+		DMA_STM32_SCR_TEIE;	/* Transfer error IRQ enable */
+
+	if (chan->direction != DMA_STM32_MEM_TO_MEM) {
+		regs->scr |= DMA_STM32_SCR_REQ(config->dma_slot);
+	}
+
+	if (periph_adj == 0) {
+		regs->scr |= DMA_STM32_SCR_PINC;
+	}
+
+	if (mem_adj == 0) {
+		regs->scr |= DMA_STM32_SCR_MINC;
+	}
+
+	if (config->half_callback_en) {
+		regs->scr |= DMA_STM32_SCR_HTIE;
+	}
+
+	if (config->cyclic && config->block_count == 2) {
+		regs->scr |= DMA_STM32_SCR_DBM;
+		regs->sm1ar = dma_stm32_block_mem(chan, next);
+	} else if (config->cyclic) {
+		regs->scr |= DMA_STM32_SCR_CIRC;
+	}
+
+	/* The FIFO is needed for bursts and data size conversions */
+	if (chan->direction == DMA_STM32_MEM_TO_MEM || psize != msize ||
+	    pburst || mburst) {
+		regs->sfcr = DMA_STM32_SFCR_DMDIS | /* Direct mode disable */
+			DMA_STM32_SFCR_FTH(DMA_STM32_FIFO_THRESHOLD_FULL) |
+			DMA_STM32_SFCR_FEIE;	/* FIFO error IRQ enable */
+	} else {
+		regs->scr |= DMA_STM32_SCR_DMEIE;
+	}
+
+	chan->dma_callback   = config->dma_callback;
+	chan->head_block     = block;
+	chan->block_count    = config->block_count;
+	chan->cyclic	     = config->cyclic;
+	chan->block_callback = config->complete_callback_en;
+
+	return 0;
+}
+
+static int dma_stm32_start(struct device *dev, uint32_t channel)
+{
+	struct dma_stm32_device *ddata = dev->driver_data;
+	struct dma_stm32_chan *chan = &ddata->chan[channel];
+	int ret;
+
+	if (!chan->dma_callback) {
+		return -EINVAL;
+	}
+
+	if (chan->busy) {
+		return -EBUSY;
+	}
+
+	ret = dma_stm32_disable_chan(ddata, channel);
+	if (ret) {
+		return ret;
+	}
+
+	chan->busy = true;
+	chan->blocks_left = chan->block_count;
+	dma_stm32_block_load(chan, chan->head_block);
+
+	if (chan->regs.scr & DMA_STM32_SCR_DBM) {
+		sys_cache_data_range_flush((void *)chan->regs.sm1ar,
+					   chan->head_block->block_size);
+	}
+
+	dma_stm32_stream_start(ddata, channel);
+
+	return 0;
+}
+
+static int dma_stm32_stop(struct device *dev, uint32_t channel)
+{
+	struct dma_stm32_device *ddata = dev->driver_data;
+	struct dma_stm32_chan *chan = &ddata->chan[channel];
+	uint32_t config;
+
+	/* Disabling the stream completes it, keep it from raising an IRQ */
+	config = dma_stm32_read(ddata, DMA_STM32_SCR(channel));
+	config &= ~(DMA_STM32_SCR_EN | DMA_STM32_SCR_IRQ_MASK |
+		    DMA_STM32_SCR_HTIE);
+	dma_stm32_write(ddata, DMA_STM32_SCR(channel), config);
+
+	chan->busy = false;
 
 	return 0;
 }
@@ -391,6 +767,9 @@ static const struct dma_driver_api dma_funcs = {
 	.channel_config  = dma_stm32_channel_config,
 	.transfer_config = dma_stm32_transfer_config,
 	.transfer_start  = dma_stm32_transfer_start,
+	.config		 = dma_stm32_config,
+	.start		 = dma_stm32_start,
+	.stop		 = dma_stm32_stop,
 };
 
 const struct dma_stm32_config dma_stm32_1_cdata = {
@@ -36,8 +36,14 @@ static int eth_enc28j60_soft_reset(struct device *dev)
 static void eth_enc28j60_set_bank(struct device *dev, uint16_t reg_addr)
 {
 	struct eth_enc28j60_runtime *context = dev->driver_data;
+	uint8_t bank = (reg_addr >> 8) & 0x0F;
 	uint8_t tx_buf[2];
 
+	/* ECON1 is only written here as a whole, the bank stays as set */
+	if (context->bank == bank) {
+		return;
+	}
+
 	k_sem_take(&context->spi_sem, K_FOREVER);
 
 	tx_buf[0] = ENC28J60_SPI_RCR | ENC28J60_REG_ECON1;
@@ -46,10 +52,12 @@ static void eth_enc28j60_set_bank(struct device *dev, uint16_t reg_addr)
 	spi_transceive(context->spi, tx_buf, 2, tx_buf, 2);
 
 	tx_buf[0] = ENC28J60_SPI_WCR | ENC28J60_REG_ECON1;
-	tx_buf[1] = (tx_buf[1] & 0xFC) | ((reg_addr >> 8) & 0x0F);
+	tx_buf[1] = (tx_buf[1] & 0xFC) | bank;
 
 	spi_write(context->spi, tx_buf, 2);
 
+	context->bank = bank;
+
 	k_sem_give(&context->spi_sem);
 }
 
@@ -125,6 +133,65 @@ static void eth_enc28j60_clear_eth_reg(struct device *dev, uint16_t reg_addr,
 	k_sem_give(&context->spi_sem);
 }
 
+static void eth_enc28j60_spi_done(struct device *spi,
+				  struct spi_transaction *trans, int status)
+{
+	struct eth_enc28j60_runtime *context = trans->user_data;
+
+	context->spi_status = status;
+	k_sem_give(&context->spi_done_sem);
+}
+
+/*
+ * Reads or writes the buffer memory in a single transaction, the command
+ * followed by the whole data, without going through mem_buf. Returns
+ * -ENOTSUP if the SPI driver has no asynchronous transactions, the data
+ * then going through mem_buf in MAX_BUFFER_LENGTH pieces.
+ */
+static int eth_enc28j60_mem_burst(struct device *dev, uint8_t command,
+				  uint8_t *tx_data, uint8_t *rx_data,
+				  uint16_t buf_len)
+{
+	struct eth_enc28j60_runtime *context = dev->driver_data;
+	int ret;
+
+	if (!context->spi_async) {
+		return -ENOTSUP;
+	}
+
+	context->mem_buf[0] = command;
+
+	context->spi_xfers[0].tx_buf = context->mem_buf;
+	context->spi_xfers[0].tx_len = 1;
+	context->spi_xfers[0].rx_buf = NULL;
+	context->spi_xfers[0].rx_len = 0;
+
+	context->spi_xfers[1].tx_buf = tx_data;
+	context->spi_xfers[1].tx_len = tx_data ? buf_len : 0;
+	context->spi_xfers[1].rx_buf = rx_data;
+	context->spi_xfers[1].rx_len = rx_data ? buf_len : 0;
+
+	context->spi_trans.config = NULL;
+	context->spi_trans.slave = 0;
+	context->spi_trans.transfers = context->spi_xfers;
+	context->spi_trans.count = 2;
+	context->spi_trans.callback = eth_enc28j60_spi_done;
+	context->spi_trans.user_data = context;
+
+	ret = spi_transceive_async(context->spi, &context->spi_trans);
+	if (ret == -ENOTSUP) {
+		context->spi_async = false;
+	}
+
+	if (ret) {
+		return ret;
+	}
+
+	k_sem_take(&context->spi_done_sem, K_FOREVER);
+
+	return context->spi_status;
+}
+
 static void eth_enc28j60_write_mem(struct device *dev, uint8_t *data_buffer,
 				   uint16_t buf_len)
 {
@@ -132,6 +199,7 @@ static void eth_enc28j60_write_mem(struct device *dev, uint8_t *data_buffer,
 	uint8_t *index_buf;
 	uint16_t num_segments;
 	uint16_t num_remaining;
+	int ret;
 
 	index_buf = data_buffer;
 	num_segments = buf_len / MAX_BUFFER_LENGTH;
@@ -139,6 +207,17 @@ static void eth_enc28j60_write_mem(struct device *dev, uint8_t *data_buffer,
 
 	k_sem_take(&context->spi_sem, K_FOREVER);
 
+	ret = eth_enc28j60_mem_burst(dev, ENC28J60_SPI_WBM, data_buffer, NULL,
+				     buf_len);
+	if (ret != -ENOTSUP) {
+		if (ret) {
+			SYS_LOG_ERR("Buffer memory write failed");
+		}
+
+		k_sem_give(&context->spi_sem);
+		return;
+	}
+
 	for (int i = 0; i < num_segments;
 	     ++i, index_buf += MAX_BUFFER_LENGTH) {
 		context->mem_buf[0] = ENC28J60_SPI_WBM;
@@ -162,12 +241,28 @@ static void eth_enc28j60_read_mem(struct device *dev, uint8_t *data_buffer,
 	struct eth_enc28j60_runtime *context = dev->driver_data;
 	uint16_t num_segments;
 	uint16_t num_remaining;
+	int ret;
 
 	num_segments = buf_len / MAX_BUFFER_LENGTH;
 	num_remaining = buf_len - MAX_BUFFER_LENGTH * num_segments;
 
 	k_sem_take(&context->spi_sem, K_FOREVER);
 
+	/* Data skipped is received in mem_buf, past the command */
+	if (data_buffer || buf_len <= MAX_BUFFER_LENGTH) {
+		ret = eth_enc28j60_mem_burst(dev, ENC28J60_SPI_RBM, NULL,
+					     data_buffer ? data_buffer :
+					     context->mem_buf + 1, buf_len);
+		if (ret != -ENOTSUP) {
+			if (ret) {
+				SYS_LOG_ERR("Buffer memory read failed");
+			}
+
+			k_sem_give(&context->spi_sem);
+			return;
+		}
+	}
+
 	for (int i = 0; i < num_segments;
 	     ++i, data_buffer += MAX_BUFFER_LENGTH) {
 		context->mem_buf[0] = ENC28J60_SPI_RBM;
@@ -339,6 +434,9 @@ static int eth_enc28j60_init(struct device *dev)
 
 	k_sem_init(&context->spi_sem, 0, UINT_MAX);
 	k_sem_give(&context->spi_sem);
+	k_sem_init(&context->spi_done_sem, 0, 1);
+	context->spi_async = true;
+	context->bank = 0xFF;
 
 	context->gpio = device_get_binding((char *)config->gpio_port);
 	if (!context->gpio) {
@@ -505,123 +603,150 @@ static int eth_enc28j60_tx(struct device *dev, struct net_buf *buf,
 	return 0;
 }
 
-static int eth_enc28j60_rx(struct device *dev)
+/* Reads the packet at the read pointer, returns where the next one is */
+static uint16_t eth_enc28j60_rx_packet(struct device *dev)
 {
 	struct eth_enc28j60_runtime *context = dev->driver_data;
+	uint8_t header[RX_HEADER_SIZE];
+	struct net_buf *last_frag;
+	struct net_buf *pkt_buf;
+	uint16_t next_packet;
+	struct net_buf *buf;
 	uint16_t lengthfr;
-	uint8_t counter;
+	uint16_t frm_len;
 
-	/* Errata 6. The Receive Packet Pending Interrupt Flag (EIR.PKTIF)
-	 * does not reliably/accurately report the status of pending packet.
-	 * Use EPKTCNT register instead.
-	*/
+	/* Read address for next packet and reception status vector */
+	eth_enc28j60_read_mem(dev, header, RX_HEADER_SIZE);
+	next_packet = header[0] | (uint16_t)header[1] << 8;
+	memcpy(context->rx_rsv, header + 2, RSV_SIZE);
 
-	SYS_LOG_DBG("");
+	/* Get the frame length from the rx status vector,
+	 * minus CRC size at the end which is always present
+	 */
+	frm_len = ((context->rx_rsv[1] << 8) | context->rx_rsv[0]) -
+		  RX_CRC_SIZE;
+	lengthfr = frm_len;
+
+	/* Get the frame from the buffer */
+	buf = net_nbuf_get_reserve_rx(0, K_NO_WAIT);
+	if (!buf) {
+		SYS_LOG_ERR("Could not allocate rx buffer");
+		goto skip;
+	}
 
-	k_sem_take(&context->tx_rx_sem, K_FOREVER);
+	last_frag = buf;
 
 	do {
-		struct net_buf *last_frag;
-		struct net_buf *pkt_buf = NULL;
-		uint16_t frm_len = 0;
-		struct net_buf *buf;
-		uint16_t next_packet;
-		uint8_t np[2];
+		size_t frag_len;
+		uint8_t *data_ptr;
+		size_t spi_frame_len;
 
-		/* Read address for next packet */
-		eth_enc28j60_read_mem(dev, np, 2);
-		next_packet = np[0] | (uint16_t)np[1] << 8;
+		/* Reserve a data frag to receive the frame */
+		pkt_buf = net_nbuf_get_reserve_data(0, K_NO_WAIT);
+		if (!pkt_buf) {
+			SYS_LOG_ERR("Could not allocate data buffer");
+			net_buf_unref(buf);
 
-		/* Errata 14. Even values in ERXRDPT
-		 * may corrupt receive buffer.
-		 */
-		if (next_packet == 0) {
-			next_packet = ENC28J60_RXEND;
-		} else if (!(next_packet & 0x01)) {
-			next_packet--;
+			goto skip;
 		}
 
-		/* Read reception status vector */
-		eth_enc28j60_read_mem(dev, context->rx_rsv, 4);
+		net_buf_frag_insert(last_frag, pkt_buf);
+		data_ptr = pkt_buf->data;
 
-		/* Get the frame length from the rx status vector,
-		 * minus CRC size at the end which is always present
-		 */
-		frm_len = (context->rx_rsv[1] << 8) | (context->rx_rsv[0] - 4);
-		lengthfr = frm_len;
-
-		/* Get the frame from the buffer */
-		buf = net_nbuf_get_reserve_rx(0, K_NO_WAIT);
-		if (!buf) {
-			SYS_LOG_ERR("Could not allocate rx buffer");
-			goto done;
+		last_frag = pkt_buf;
+
+		/* Review the space available for the new frag */
+		frag_len = net_buf_tailroom(pkt_buf);
+
+		if (frm_len > frag_len) {
+			spi_frame_len = frag_len;
+		} else {
+			spi_frame_len = frm_len;
 		}
 
-		last_frag = buf;
+		/* The whole fragment is read in one burst */
+		eth_enc28j60_read_mem(dev, data_ptr, spi_frame_len);
 
-		do {
-			size_t frag_len;
-			uint8_t *data_ptr;
-			size_t spi_frame_len;
+		net_buf_add(pkt_buf, spi_frame_len);
 
-			/* Reserve a data frag to receive the frame */
-			pkt_buf = net_nbuf_get_reserve_data(0, K_NO_WAIT);
-			if (!pkt_buf) {
-				SYS_LOG_ERR("Could not allocate data buffer");
-				net_buf_unref(buf);
+		/* One fragment has been written via SPI */
+		frm_len -= spi_frame_len;
+	} while (frm_len > 0);
 
-				goto done;
-			}
+	/* Let's pop the useless CRC, along with the padding byte
+	 * introduced by the device when the frame length is odd
+	 */
+	eth_enc28j60_read_mem(dev, NULL, RX_CRC_SIZE + (lengthfr & 0x01));
 
-			net_buf_frag_insert(last_frag, pkt_buf);
-			data_ptr = pkt_buf->data;
+	/* Feed buffer frame to IP stack */
+	SYS_LOG_DBG("Received packet of length %u", lengthfr);
+	if (net_recv_data(context->iface, buf) < 0) {
+		net_nbuf_unref(buf);
+	}
 
-			last_frag = pkt_buf;
+	return next_packet;
 
-			/* Review the space available for the new frag */
-			frag_len = net_buf_tailroom(pkt_buf);
+skip:
+	/* The rest of the frame is left unread, the next one is read from
+	 * its own start
+	 */
+	eth_enc28j60_set_bank(dev, ENC28J60_REG_ERDPTL);
+	eth_enc28j60_write_reg(dev, ENC28J60_REG_ERDPTL, next_packet & 0xFF);
+	eth_enc28j60_write_reg(dev, ENC28J60_REG_ERDPTH, next_packet >> 8);
 
-			if (frm_len > frag_len) {
-				spi_frame_len = frag_len;
-			} else {
-				spi_frame_len = frm_len;
-			}
+	return next_packet;
+}
 
-			eth_enc28j60_read_mem(dev, data_ptr, spi_frame_len);
+static int eth_enc28j60_rx(struct device *dev)
+{
+	struct eth_enc28j60_runtime *context = dev->driver_data;
+	uint16_t next_packet = 0;
+	uint8_t counter;
+
+	/* Errata 6. The Receive Packet Pending Interrupt Flag (EIR.PKTIF)
+	 * does not reliably/accurately report the status of pending packet.
+	 * Use EPKTCNT register instead.
+	*/
+
+	SYS_LOG_DBG("");
 
-			net_buf_add(pkt_buf, spi_frame_len);
+	k_sem_take(&context->tx_rx_sem, K_FOREVER);
+
+	eth_enc28j60_set_bank(dev, ENC28J60_REG_EPKTCNT);
+	eth_enc28j60_read_reg(dev, ENC28J60_REG_EPKTCNT, &counter);
 
-			/* One fragment has been written via SPI */
-			frm_len -= spi_frame_len;
-		} while (frm_len > 0);
+	while (counter) {
+		/* Every frame pending is read before the receive buffer
+		 * memory is freed, at once
+		 */
+		for (; counter; counter--) {
+			next_packet = eth_enc28j60_rx_packet(dev);
 
-		/* Let's pop the useless CRC */
-		eth_enc28j60_read_mem(dev, NULL, 4);
+			/* Decrement rx counter */
+			eth_enc28j60_set_eth_reg(dev, ENC28J60_REG_ECON2,
+						 ENC28J60_BIT_ECON2_PKTDEC);
+		}
 
-		/* Pops one padding byte from spi circular buffer
-		 * introduced by the device when the frame length is odd
+		/* Errata 14. Even values in ERXRDPT
+		 * may corrupt receive buffer.
 		 */
-		if (lengthfr & 0x01) {
-			eth_enc28j60_read_mem(dev, NULL, 1);
+		if (next_packet == 0) {
+			next_packet = ENC28J60_RXEND;
+		} else if (!(next_packet & 0x01)) {
+			next_packet--;
 		}
 
-		/* Feed buffer frame to IP stack */
-		SYS_LOG_DBG("Received packet of length %u", lengthfr);
-		net_recv_data(context->iface, buf);
-done:
-		/* Free buffer memory and decrement rx counter */
+		/* Free buffer memory */
 		eth_enc28j60_set_bank(dev, ENC28J60_REG_ERXRDPTL);
 		eth_enc28j60_write_reg(dev, ENC28J60_REG_ERXRDPTL,
 				       next_packet & 0xFF);
 		eth_enc28j60_write_reg(dev, ENC28J60_REG_ERXRDPTH,
 				       next_packet >> 8);
-		eth_enc28j60_set_eth_reg(dev, ENC28J60_REG_ECON2,
-					 ENC28J60_BIT_ECON2_PKTDEC);
 
-		/* Check if there are frames to clean from the buffer */
+		/* Check if frames were received in the meantime */
 		eth_enc28j60_set_bank(dev, ENC28J60_REG_EPKTCNT);
 		eth_enc28j60_read_reg(dev, ENC28J60_REG_EPKTCNT, &counter);
-	} while (counter);
+	}
 
 	k_sem_give(&context->tx_rx_sem);
 
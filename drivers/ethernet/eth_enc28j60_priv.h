@@ -202,6 +202,11 @@
 /* End of TX buffer */
 #define ENC28J60_TXEND 0x11FF
 
+/* Next packet pointer and reception status vector */
+#define RX_HEADER_SIZE 6
+/* CRC at the end of the received frames */
+#define RX_CRC_SIZE 4
+
 /* Status vectors array size */
 #define TSV_SIZE 7
 #define RSV_SIZE 4
@@ -234,6 +239,16 @@ struct eth_enc28j60_runtime {
 	struct k_sem tx_rx_sem;
 	struct k_sem int_sem;
 	struct k_sem spi_sem;
+	/* Bank selected in ECON1, 0xFF until known */
+	uint8_t bank;
+	/* Buffer memory bursts, until the SPI driver turns out not to
+	 * have asynchronous transactions
+	 */
+	bool spi_async;
+	struct spi_transaction spi_trans;
+	struct spi_transfer spi_xfers[2];
+	struct k_sem spi_done_sem;
+	int spi_status;
 };
 
 #endif /*_ENC28J60_*/
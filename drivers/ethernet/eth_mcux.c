@@ -22,6 +22,7 @@
 #include <kernel.h>
 #include <net/nbuf.h>
 #include <net/net_if.h>
+#include <net/ethernet.h>
 
 #include "fsl_enet.h"
 #include "fsl_phy.h"
@@ -70,6 +71,9 @@ struct eth_context {
 	uint8_t mac_addr[6];
 	struct k_work phy_work;
 	struct k_delayed_work delayed_phy_work;
+#if defined(CONFIG_ETH_RX_POLL)
+	struct k_work rx_work;
+#endif
 	/* TODO: FIXME. This Ethernet frame sized buffer is used for
 	 * interfacing with MCUX. How it works is that hardware uses
 	 * DMA scatter buffers to receive a frame, and then public
@@ -86,6 +90,9 @@ struct eth_context {
 };
 
 static void eth_0_config_func(void);
+#if defined(CONFIG_ETH_RX_POLL)
+static void eth_mcux_rx_poll(struct k_work *item);
+#endif
 
 static enet_rx_bd_struct_t __aligned(ENET_BUFF_ALIGNMENT)
 rx_buffer_desc[CONFIG_ETH_MCUX_TX_BUFFERS];
@@ -350,7 +357,8 @@ static int eth_tx(struct net_if *iface, struct net_buf *buf)
 	return 0;
 }
 
-static void eth_rx(struct device *iface)
+/* Returns false if there was no frame to take */
+static bool eth_rx(struct device *iface)
 {
 	struct eth_context *context = iface->driver_data;
 	struct net_buf *buf, *prev_frag;
@@ -360,7 +368,9 @@ static void eth_rx(struct device *iface)
 	unsigned int imask;
 
 	status = ENET_GetRxFrameSize(&context->enet_handle, &frame_length);
-	if (status) {
+	if (status == kStatus_ENET_RxFrameEmpty) {
+		return false;
+	} else if (status) {
 		enet_data_error_stats_t error_stats;
 
 		SYS_LOG_ERR("ENET_GetRxFrameSize return: %d", status);
@@ -373,7 +383,7 @@ static void eth_rx(struct device *iface)
 		 */
 		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
 		assert(status == kStatus_Success);
-		return;
+		return true;
 	}
 
 	buf = net_nbuf_get_reserve_rx(0, K_NO_WAIT);
@@ -388,7 +398,7 @@ static void eth_rx(struct device *iface)
 		 */
 		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
 		assert(status == kStatus_Success);
-		return;
+		return true;
 	}
 
 	if (sizeof(context->frame_buf) < frame_length) {
@@ -396,7 +406,7 @@ static void eth_rx(struct device *iface)
 		net_nbuf_unref(buf);
 		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
 		assert(status == kStatus_Success);
-		return;
+		return true;
 	}
 
 	/* As context->frame_buf is shared resource used by both eth_tx
@@ -410,7 +420,7 @@ static void eth_rx(struct device *iface)
 		irq_unlock(imask);
 		SYS_LOG_ERR("ENET_ReadFrame failed: %d\n", status);
 		net_nbuf_unref(buf);
-		return;
+		return true;
 	}
 
 	src = context->frame_buf;
@@ -425,7 +435,7 @@ static void eth_rx(struct device *iface)
 			SYS_LOG_ERR("Failed to get fragment buf\n");
 			net_nbuf_unref(buf);
 			assert(status == kStatus_Success);
-			return;
+			return true;
 		}
 
 		net_buf_frag_insert(prev_frag, pkt_buf);
@@ -443,7 +453,11 @@ static void eth_rx(struct device *iface)
 
 	irq_unlock(imask);
 
-	net_recv_data(context->iface, buf);
+	if (net_recv_data(context->iface, buf) < 0) {
+		net_nbuf_unref(buf);
+	}
+
+	return true;
 }
 
 static void eth_callback(ENET_Type *base, enet_handle_t *handle,
@@ -512,6 +526,9 @@ static int eth_0_init(struct device *dev)
 	k_work_init(&context->phy_work, eth_mcux_phy_work);
 	k_delayed_work_init(&context->delayed_phy_work,
 			    eth_mcux_delayed_phy_work);
+#if defined(CONFIG_ETH_RX_POLL)
+	k_work_init(&context->rx_work, eth_mcux_rx_poll);
+#endif
 
 	sys_clock = CLOCK_GetFreq(kCLOCK_CoreSysClk);
 
@@ -519,15 +536,13 @@ static int eth_0_init(struct device *dev)
 	enet_config.interrupt |= kENET_RxFrameInterrupt;
 	enet_config.interrupt |= kENET_TxFrameInterrupt;
 	enet_config.interrupt |= kENET_MiiInterrupt;
-	/* FIXME: Workaround for lack of driver API support for multicast
-	 * management. So, instead we want to receive all multicast
-	 * frames "by default", or otherwise basic IPv6 features, like
-	 * address resolution, don't work. On Kinetis Ethernet controller,
-	 * that translates to enabling promiscuous mode. The real
-	 * fix depends on https://jira.zephyrproject.org/browse/ZEP-1673.
+	/* Insert the IP header and protocol checksums, see
+	 * eth_get_capabilities(), and drop the frames where they are wrong.
 	 */
-	enet_config.macSpecialConfig |= kENET_ControlPromiscuousEnable;
-
+	enet_config.txAccelerConfig = kENET_TxAccelIpCheckEnabled |
+				      kENET_TxAccelProtoCheckEnabled;
+	enet_config.rxAccelerConfig = kENET_RxAccelIpCheckEnabled |
+				      kENET_RxAccelProtoCheckEnabled;
 #if defined(CONFIG_ETH_MCUX_0_RANDOM_MAC)
 	generate_mac(context->mac_addr);
 #endif
@@ -565,9 +580,37 @@ static void eth_0_iface_init(struct net_if *iface)
 	context->iface = iface;
 }
 
+static void mcast_group_add(struct net_if *iface,
+			    const struct net_eth_addr *addr,
+			    void *user_data)
+{
+	ENET_AddMulticastGroup(ENET, (uint8_t *)addr->addr);
+}
+
+/* The group hash filter is set from scratch, as several groups can share
+ * a bit of it.
+ */
+static void eth_mcast_filter(struct net_if *iface)
+{
+	ENET->GAUR = 0;
+	ENET->GALR = 0;
+
+	net_eth_mcast_foreach(iface, mcast_group_add, NULL);
+}
+
+static enum net_if_caps eth_get_capabilities(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+
+	/* The received frames do not tell which checksums were checked */
+	return NET_IF_CAP_TX_CHKSUM;
+}
+
 static struct net_if_api api_funcs_0 = {
 	.init	= eth_0_iface_init,
 	.send	= eth_tx,
+	.get_capabilities = eth_get_capabilities,
+	.mcast_filter = eth_mcast_filter,
 };
 
 static void eth_mcux_rx_isr(void *p)
@@ -575,7 +618,17 @@ static void eth_mcux_rx_isr(void *p)
 	struct device *dev = p;
 	struct eth_context *context = dev->driver_data;
 
+#if defined(CONFIG_ETH_RX_POLL)
+	/* The frames are taken by eth_mcux_rx_poll(), no need to be told
+	 * about the next ones until then.
+	 */
+	ENET_DisableInterrupts(ENET, kENET_RxFrameInterrupt);
+	ENET_ClearInterruptStatus(ENET, kENET_RxFrameInterrupt |
+				  kENET_RxByteInterrupt);
+	k_work_submit(&context->rx_work);
+#else
 	ENET_ReceiveIRQHandler(ENET, &context->enet_handle);
+#endif
 }
 
 static void eth_mcux_tx_isr(void *p)
@@ -619,6 +672,28 @@ NET_DEVICE_INIT(eth_mcux_0, CONFIG_ETH_MCUX_0_NAME,
 		NULL, CONFIG_ETH_INIT_PRIORITY, &api_funcs_0,
 		ETHERNET_L2, NET_L2_GET_CTX_TYPE(ETHERNET_L2), 1500);
 
+#if defined(CONFIG_ETH_RX_POLL)
+static void eth_mcux_rx_poll(struct k_work *item)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_ETH_RX_POLL_BUDGET; i++) {
+		if (!eth_rx(DEVICE_GET(eth_mcux_0))) {
+			break;
+		}
+	}
+
+	if (i == CONFIG_ETH_RX_POLL_BUDGET) {
+		/* Let the other work items run before going on */
+		k_work_submit(item);
+		return;
+	}
+
+	/* A frame received in the meantime raises the interrupt at once */
+	ENET_EnableInterrupts(ENET, kENET_RxFrameInterrupt);
+}
+#endif /* CONFIG_ETH_RX_POLL */
+
 static void eth_0_config_func(void)
 {
 	IRQ_CONNECT(IRQ_ETH_RX, CONFIG_ETH_MCUX_0_IRQ_PRI,
@@ -13,9 +13,12 @@
  *
  * Limitations:
  * - one shot PHY setup, no support for PHY disconnect/reconnect
+ * - the priority queues are only used to send, all the frames are received
+ *   on the main queue
  * - no statistics collection
- * - no support for devices with DCache enabled due to missing non-cacheable
- *   RAM regions in Zephyr.
+ * - with DCache enabled, the frame data is kept coherent but the descriptor
+ *   lists, written by both the CPU and the GMAC within the same cache lines,
+ *   have to be placed in a non-cacheable RAM region, missing in Zephyr.
  */
 
 #define SYS_LOG_DOMAIN "dev/eth_sam"
@@ -27,9 +30,12 @@
 #include <misc/__assert.h>
 #include <misc/util.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <cache.h>
 #include <net/nbuf.h>
 #include <net/net_if.h>
+#include <net/ethernet.h>
 #include <soc.h>
 #include "phy_sam_gmac.h"
 #include "eth_sam_gmac_priv.h"
@@ -68,13 +74,24 @@ static struct gmac_desc rx_desc_que12[PRIORITY_QUEUE_DESC_COUNT]
 /* TX descriptors list */
 static struct gmac_desc tx_desc_que0[MAIN_QUEUE_TX_DESC_COUNT]
 	__aligned(GMAC_DESC_ALIGNMENT);
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+static struct gmac_desc tx_desc_que1[MAIN_QUEUE_TX_DESC_COUNT]
+	__aligned(GMAC_DESC_ALIGNMENT);
+static struct gmac_desc tx_desc_que2[MAIN_QUEUE_TX_DESC_COUNT]
+	__aligned(GMAC_DESC_ALIGNMENT);
+#else
 static struct gmac_desc tx_desc_que12[PRIORITY_QUEUE_DESC_COUNT]
 	__aligned(GMAC_DESC_ALIGNMENT);
+#endif
 
 /* RX buffer accounting list */
 static struct net_buf *rx_buf_list_que0[MAIN_QUEUE_RX_DESC_COUNT];
 /* TX frames accounting list */
 static struct net_buf *tx_frame_list_que0[CONFIG_NET_NBUF_TX_COUNT + 1];
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+static struct net_buf *tx_frame_list_que1[CONFIG_NET_NBUF_TX_COUNT + 1];
+static struct net_buf *tx_frame_list_que2[CONFIG_NET_NBUF_TX_COUNT + 1];
+#endif
 
 #define MODULO_INC(val, max) {val = (++val < max) ? val : 0; }
 
@@ -176,6 +193,9 @@ static int rx_descriptors_init(Gmac *gmac, struct gmac_queue *queue)
 			 "Misaligned RX buffer address");
 		__ASSERT(rx_buf->size == CONFIG_NET_NBUF_DATA_SIZE,
 			 "Incorrect length of RX data buffer");
+		/* No dirty cache line may be written back over the RX data */
+		sys_cache_data_range_flush(rx_buf_addr,
+					   CONFIG_NET_NBUF_DATA_SIZE);
 		/* Give ownership to GMAC and remove the wrap bit */
 		rx_desc_list->buf[i].w0 = (uint32_t)rx_buf_addr & GMAC_RXW0_ADDR;
 		rx_desc_list->buf[i].w1 = 0;
@@ -237,6 +257,34 @@ static void tx_completed(Gmac *gmac, struct gmac_queue *queue)
 	}
 }
 
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+/*
+ * Release the frames sent on a priority queue, whose interrupts are not
+ * used. The GMAC sets the used bit of the first descriptor of a frame
+ * once it is sent. Only called from the TX path, as frame_put().
+ */
+static void tx_reclaim(struct gmac_queue *queue)
+{
+	struct gmac_desc_list *tx_desc_list = &queue->tx_desc_list;
+	struct gmac_desc *tx_desc;
+	struct net_buf *buf;
+
+	while (tx_desc_list->tail != tx_desc_list->head &&
+	       (tx_desc_list->buf[tx_desc_list->tail].w1 & GMAC_TXW1_USED)) {
+		/* Skip the descriptors up to the last one of the frame */
+		do {
+			tx_desc = &tx_desc_list->buf[tx_desc_list->tail];
+			MODULO_INC(tx_desc_list->tail, tx_desc_list->len);
+		} while (!(tx_desc->w1 & GMAC_TXW1_LASTBUFFER) &&
+			 tx_desc_list->tail != tx_desc_list->head);
+
+		buf = UINT_TO_POINTER(ring_buf_get(&queue->tx_frames));
+		net_buf_unref(buf);
+		SYS_LOG_DBG("Dropping buf %p", buf);
+	}
+}
+#endif /* CONFIG_ETH_SAM_GMAC_PRIORITY_TX */
+
 /*
  * Reset TX queue when errors are detected
  */
@@ -249,6 +297,15 @@ static void tx_error_handler(Gmac *gmac, struct gmac_queue *queue)
 
 	tx_descriptors_init(gmac, queue);
 
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+	/* The transmission of the priority queues, following the main one
+	 * in the queue list, is stopped as well
+	 */
+	for (int i = GMAC_QUE_1; i < GMAC_QUEUE_NO; i++) {
+		tx_descriptors_init(gmac, &queue[i]);
+	}
+#endif
+
 	/* Restart transmission */
 	gmac->GMAC_NCR |=  GMAC_NCR_TXEN;
 }
@@ -328,7 +385,7 @@ static int gmac_init(Gmac *gmac, uint32_t gmac_ncfgr_val)
 	(void)gmac->GMAC_ISRPQ[GMAC_QUE_1 - 1];
 	(void)gmac->GMAC_ISRPQ[GMAC_QUE_2 - 1];
 	/* Setup Hash Registers - enable reception of all multicast frames when
-	 * GMAC_NCFGR_MTIHEN is set.
+	 * GMAC_NCFGR_MTIHEN is set, until eth_mcast_filter() is called.
 	 */
 	gmac->GMAC_HRB = UINT32_MAX;
 	gmac->GMAC_HRT = UINT32_MAX;
@@ -418,18 +475,29 @@ static int priority_queue_init_as_idle(Gmac *gmac, struct gmac_queue *queue)
 		 "RX descriptors have to be word aligned");
 	__ASSERT(!((uint32_t)tx_desc_list->buf & ~GMAC_TBQB_ADDR_Msk),
 		 "TX descriptors have to be word aligned");
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+	__ASSERT(rx_desc_list->len == 1,
+		 "Priority queues are currently not supported for RX, "
+		 "descriptor list has to have a single entry");
+#else
 	__ASSERT((rx_desc_list->len == 1) && (tx_desc_list->len == 1),
 		 "Priority queues are currently not supported, descriptor "
 		 "list has to have a single entry");
+#endif
 
 	/* Setup RX descriptor lists */
 	/* Take ownership from GMAC and set the wrap bit */
 	rx_desc_list->buf[0].w0 = GMAC_RXW0_WRAP;
 	rx_desc_list->buf[0].w1 = 0;
 	/* Setup TX descriptor lists */
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+	tx_descriptors_init(gmac, queue);
+	queue->err_tx_flushed_count = 0;
+#else
 	tx_desc_list->buf[0].w0 = 0;
 	/* Take ownership from GMAC and set the wrap bit */
 	tx_desc_list->buf[0].w1 = GMAC_TXW1_USED | GMAC_TXW1_WRAP;
+#endif
 
 	/* Set Receive Buffer Queue Pointer Register */
 	gmac->GMAC_RBQBAPQ[queue->que_idx - 1] = (uint32_t)rx_desc_list->buf;
@@ -452,6 +520,7 @@ static struct net_buf *frame_get(struct gmac_queue *queue)
 	uint8_t *frag_data;
 	uint32_t frag_len;
 	uint32_t frame_len = 0;
+	uint32_t chksum_status = 0;
 	uint16_t tail;
 
 	/* Check if there exists a complete frame in RX descriptor list */
@@ -497,6 +566,7 @@ static struct net_buf *frame_get(struct gmac_queue *queue)
 		frame_is_complete = (bool)(rx_desc->w1 & GMAC_RXW1_EOF);
 		if (frame_is_complete) {
 			frag_len = (rx_desc->w1 & GMAC_TXW1_LEN) - frame_len;
+			chksum_status = rx_desc->w1 & GMAC_RXW1_CHKSUM_STATUS;
 		} else {
 			frag_len = CONFIG_NET_NBUF_DATA_SIZE;
 		}
@@ -506,7 +576,7 @@ static struct net_buf *frame_get(struct gmac_queue *queue)
 		/* Link frame fragments only if RX net buffer is valid */
 		if (rx_frame != NULL) {
 			/* Assure cache coherency after DMA write operation */
-			DCACHE_INVALIDATE(frag_data, frag_len);
+			sys_cache_data_range_invalidate(frag_data, frag_len);
 
 			/* Get a new data net buffer from the buffer pool */
 			new_frag = net_nbuf_get_reserve_data(0, K_NO_WAIT);
@@ -520,6 +590,8 @@ static struct net_buf *frame_get(struct gmac_queue *queue)
 				prev_frag = frag;
 				frag = new_frag;
 				rx_nbuf_list->buf[tail] = (uint32_t)frag;
+				sys_cache_data_range_flush(frag->data,
+						CONFIG_NET_NBUF_DATA_SIZE);
 			}
 		}
 
@@ -542,35 +614,82 @@ static struct net_buf *frame_get(struct gmac_queue *queue)
 	SYS_LOG_DBG("Frame complete: rx=%p, tail=%d", rx_frame, tail);
 	__ASSERT_NO_MSG(frame_is_complete);
 
+	/* Frames with bad checksums are dropped by the GMAC */
+	if (rx_frame && (chksum_status == GMAC_RXW1_CHKSUM_TCP ||
+			 chksum_status == GMAC_RXW1_CHKSUM_UDP)) {
+		net_nbuf_set_chksum_valid(rx_frame, true);
+	}
+
 	return rx_frame;
 }
 
-static void eth_rx(struct gmac_queue *queue)
+/* Returns the number of frames taken, up to the budget */
+static int eth_rx(struct gmac_queue *queue, int budget)
 {
 	struct eth_sam_dev_data *dev_data =
 		CONTAINER_OF(queue, struct eth_sam_dev_data, queue_list);
 	struct net_buf *rx_frame;
+	int count = 0;
 
 	/* More than one frame could have been received by GMAC, get all
 	 * complete frames stored in the GMAC RX descriptor list.
 	 */
-	rx_frame = frame_get(queue);
-	while (rx_frame) {
+	while (count < budget && (rx_frame = frame_get(queue))) {
 		SYS_LOG_DBG("ETH rx");
 
-		net_recv_data(dev_data->iface, rx_frame);
+		if (net_recv_data(dev_data->iface, rx_frame) < 0) {
+			net_buf_unref(rx_frame);
+		}
 
-		rx_frame = frame_get(queue);
+		count++;
 	}
+
+	return count;
 }
 
-static int eth_tx(struct net_if *iface, struct net_buf *buf)
+#if defined(CONFIG_ETH_RX_POLL)
+#define GMAC_INT_RX_BITS (GMAC_IER_RCOMP | GMAC_INT_RX_ERR_BITS)
+
+static void rx_poll(struct k_work *work)
 {
-	struct device *const dev = net_if_get_device(iface);
-	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
-	struct eth_sam_dev_data *const dev_data = DEV_DATA(dev);
-	Gmac *gmac = cfg->regs;
+	struct eth_sam_dev_data *dev_data =
+		CONTAINER_OF(work, struct eth_sam_dev_data, rx_work);
+	const struct eth_sam_dev_cfg *const cfg =
+		DEV_CFG(net_if_get_device(dev_data->iface));
 	struct gmac_queue *queue = &dev_data->queue_list[0];
+	struct gmac_desc_list *rx_desc_list = &queue->rx_desc_list;
+	Gmac *gmac = cfg->regs;
+
+	/* The RX descriptor list is only handled here */
+	if (dev_data->rx_error) {
+		dev_data->rx_error = false;
+		rx_error_handler(gmac, queue);
+	}
+
+	if (eth_rx(queue, CONFIG_ETH_RX_POLL_BUDGET) ==
+	    CONFIG_ETH_RX_POLL_BUDGET) {
+		/* Let the other work items run before going on */
+		k_work_submit(work);
+		return;
+	}
+
+	gmac->GMAC_IER = GMAC_INT_RX_BITS;
+
+	/* The interrupt of a frame received in the meantime could have
+	 * been cleared along with the TX ones.
+	 */
+	if (rx_desc_list->buf[rx_desc_list->tail].w0 & GMAC_RXW0_OWNERSHIP) {
+		gmac->GMAC_IDR = GMAC_INT_RX_BITS;
+		k_work_submit(work);
+	}
+}
+#endif /* CONFIG_ETH_RX_POLL */
+
+/* Fill in the TX descriptors of a frame, the transmission is started
+ * separately.
+ */
+static void frame_put(struct gmac_queue *queue, struct net_buf *buf)
+{
 	struct gmac_desc_list *tx_desc_list = &queue->tx_desc_list;
 	struct gmac_desc *tx_desc;
 	struct net_buf *frag;
@@ -603,7 +722,7 @@ static int eth_tx(struct net_if *iface, struct net_buf *buf)
 
 	while (frag) {
 		/* Assure cache coherency before DMA read operation */
-		DCACHE_CLEAN(frag_data, frag_len);
+		sys_cache_data_range_flush(frag_data, frag_len);
 
 		tx_desc = &tx_desc_list->buf[tx_desc_list->head];
 
@@ -638,6 +757,37 @@ static int eth_tx(struct net_if *iface, struct net_buf *buf)
 
 	/* Account for a sent frame */
 	ring_buf_put(&queue->tx_frames, POINTER_TO_UINT(buf));
+}
+
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+/* The traffic classes are split evenly between the queues, the frames
+ * sent on a priority queue before being released first
+ */
+static struct gmac_queue *tx_queue_get(struct eth_sam_dev_data *dev_data,
+				       struct net_buf *buf)
+{
+	struct gmac_queue *queue =
+		&dev_data->queue_list[net_nbuf_priority(buf) *
+				      GMAC_QUEUE_NO / 8];
+
+	if (queue->que_idx != GMAC_QUE_0) {
+		tx_reclaim(queue);
+	}
+
+	return queue;
+}
+#else
+#define tx_queue_get(dev_data, buf) (&(dev_data)->queue_list[0])
+#endif /* CONFIG_ETH_SAM_GMAC_PRIORITY_TX */
+
+static int eth_tx(struct net_if *iface, struct net_buf *buf)
+{
+	struct device *const dev = net_if_get_device(iface);
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	struct eth_sam_dev_data *const dev_data = DEV_DATA(dev);
+	Gmac *gmac = cfg->regs;
+
+	frame_put(tx_queue_get(dev_data, buf), buf);
 
 	/* Start transmission */
 	gmac->GMAC_NCR |= GMAC_NCR_TSTART;
@@ -645,6 +795,23 @@ static int eth_tx(struct net_if *iface, struct net_buf *buf)
 	return 0;
 }
 
+static int eth_tx_bulk(struct net_if *iface, struct net_buf **bufs, int count)
+{
+	struct device *const dev = net_if_get_device(iface);
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	struct eth_sam_dev_data *const dev_data = DEV_DATA(dev);
+	Gmac *gmac = cfg->regs;
+
+	for (int i = 0; i < count; i++) {
+		frame_put(tx_queue_get(dev_data, bufs[i]), bufs[i]);
+	}
+
+	/* Start transmission of all the frames at once */
+	gmac->GMAC_NCR |= GMAC_NCR_TSTART;
+
+	return count;
+}
+
 static void queue0_isr(void *arg)
 {
 	struct device *const dev = (struct device *const)arg;
@@ -659,14 +826,28 @@ static void queue0_isr(void *arg)
 	SYS_LOG_DBG("GMAC_ISR=0x%08x", isr);
 
 	/* RX packet */
+#if defined(CONFIG_ETH_RX_POLL)
+	if (isr & GMAC_INT_RX_BITS) {
+		if (isr & GMAC_INT_RX_ERR_BITS) {
+			dev_data->rx_error = true;
+		}
+
+		/* The frames are taken by rx_poll(), no need to be told
+		 * about the next ones until then.
+		 */
+		gmac->GMAC_IDR = GMAC_INT_RX_BITS;
+		k_work_submit(&dev_data->rx_work);
+	}
+#else
 	if (isr & GMAC_INT_RX_ERR_BITS) {
 		rx_error_handler(gmac, queue);
 	} else if (isr & GMAC_ISR_RCOMP) {
 		SYS_LOG_DBG("rx.w1=0x%08x, tail=%d",
 			    queue->rx_desc_list.buf[queue->rx_desc_list.tail].w1,
 			    queue->rx_desc_list.tail);
-		eth_rx(queue);
+		eth_rx(queue, INT_MAX);
 	}
+#endif /* CONFIG_ETH_RX_POLL */
 
 	/* TX packet */
 	if (isr & GMAC_INT_TX_ERR_BITS) {
@@ -691,6 +872,10 @@ static int eth_initialize(struct device *dev)
 	uint32_t gmac_ncfgr_val;
 	int result;
 
+#if defined(CONFIG_ETH_RX_POLL)
+	k_work_init(&dev_data->rx_work, rx_poll);
+#endif
+
 	cfg->config_func();
 
 	/* Enable GMAC module's clock */
@@ -709,7 +894,10 @@ static int eth_initialize(struct device *dev)
 	}
 
 	/* Initialize GMAC queues */
-	/* Note: Queues 1 and 2 are not used, configured to stay idle */
+	/* Note: Queues 1 and 2 are not used to receive, and only used to
+	 * send with CONFIG_ETH_SAM_GMAC_PRIORITY_TX, configured to stay
+	 * idle otherwise
+	 */
 	priority_queue_init_as_idle(cfg->regs, &dev_data->queue_list[2]);
 	priority_queue_init_as_idle(cfg->regs, &dev_data->queue_list[1]);
 	result = queue_init(cfg->regs, &dev_data->queue_list[0]);
@@ -755,9 +943,60 @@ static void eth0_iface_init(struct net_if *iface)
 	dev_data->iface = iface;
 }
 
+/* The GMAC hash index of an address: bit n is the XOR of the address bits
+ * n, n + 6, ..., n + 42, the first bit being the LSB of the first byte.
+ */
+static uint8_t mcast_hash_index(const struct net_eth_addr *addr)
+{
+	uint8_t index = 0;
+	int bit;
+
+	for (bit = 0; bit < 48; bit++) {
+		if (addr->addr[bit / 8] & BIT(bit % 8)) {
+			index ^= BIT(bit % 6);
+		}
+	}
+
+	return index;
+}
+
+static void mcast_hash_add(struct net_if *iface,
+			   const struct net_eth_addr *addr,
+			   void *user_data)
+{
+	uint32_t *hash = user_data;
+	uint8_t index = mcast_hash_index(addr);
+
+	hash[index / 32] |= BIT(index % 32);
+}
+
+/* Only the multicast frames matching the hash of a group are received */
+static void eth_mcast_filter(struct net_if *iface)
+{
+	struct device *const dev = net_if_get_device(iface);
+	const struct eth_sam_dev_cfg *const cfg = DEV_CFG(dev);
+	uint32_t hash[2] = { 0, 0 };
+
+	net_eth_mcast_foreach(iface, mcast_hash_add, hash);
+
+	cfg->regs->GMAC_HRB = hash[0];
+	cfg->regs->GMAC_HRT = hash[1];
+}
+
+static enum net_if_caps eth_sam_gmac_get_capabilities(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+
+	/* GMAC_DCFGR_TXCOEN and GMAC_NCFGR_RXCOEN are set */
+	return NET_IF_CAP_TX_CHKSUM | NET_IF_CAP_RX_CHKSUM;
+}
+
 static struct net_if_api eth0_api = {
 	.init	= eth0_iface_init,
 	.send	= eth_tx,
+	.get_capabilities = eth_sam_gmac_get_capabilities,
+	.send_bulk = eth_tx_bulk,
+	.mcast_filter = eth_mcast_filter,
 };
 
 static struct device DEVICE_NAME_GET(eth0_sam_gmac);
@@ -813,20 +1052,42 @@ static struct eth_sam_dev_data eth0_data = {
 				.buf = rx_desc_que12,
 				.len = ARRAY_SIZE(rx_desc_que12),
 			},
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+			.tx_desc_list = {
+				.buf = tx_desc_que1,
+				.len = ARRAY_SIZE(tx_desc_que1),
+			},
+			.tx_frames = {
+				.buf = (uint32_t *)tx_frame_list_que1,
+				.len = ARRAY_SIZE(tx_frame_list_que1),
+			},
+#else
 			.tx_desc_list = {
 				.buf = tx_desc_que12,
 				.len = ARRAY_SIZE(tx_desc_que12),
 			},
+#endif
 		}, {
 			.que_idx = GMAC_QUE_2,
 			.rx_desc_list = {
 				.buf = rx_desc_que12,
 				.len = ARRAY_SIZE(rx_desc_que12),
 			},
+#if defined(CONFIG_ETH_SAM_GMAC_PRIORITY_TX)
+			.tx_desc_list = {
+				.buf = tx_desc_que2,
+				.len = ARRAY_SIZE(tx_desc_que2),
+			},
+			.tx_frames = {
+				.buf = (uint32_t *)tx_frame_list_que2,
+				.len = ARRAY_SIZE(tx_frame_list_que2),
+			},
+#else
 			.tx_desc_list = {
 				.buf = tx_desc_que12,
 				.len = ARRAY_SIZE(tx_desc_que12),
 			},
+#endif
 		}
 	},
 };
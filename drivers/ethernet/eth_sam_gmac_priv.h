@@ -27,20 +27,6 @@
 /** RX/TX descriptors count for priority queues */
 #define PRIORITY_QUEUE_DESC_COUNT         1
 
-/* FIXME change to
- * #if __DCACHE_PRESENT == 1
- * when cache support is added
- */
-#if 0
-#define DCACHE_INVALIDATE(addr, size) \
-		SCB_InvalidateDCache_by_Addr((uint32_t *)addr, size)
-#define DCACHE_CLEAN(addr, size) \
-		SCB_CleanDCache_by_Addr((uint32_t *)addr, size)
-#else
-#define DCACHE_INVALIDATE(addr, size) { ; }
-#define DCACHE_CLEAN(addr, size) { ; }
-#endif
-
 /*
  * Receive buffer descriptor bit field definitions
  */
@@ -70,6 +56,12 @@
 #define GMAC_RXW1_VLANDETECTED        (0x1u << 21)
 /** Type ID match */
 #define GMAC_RXW1_TYPEIDMATCH         (0x3u << 22)
+/** Checksum status, instead of type ID match with RX checksum offload */
+#define GMAC_RXW1_CHKSUM_STATUS       (0x3u << 22)
+/** IP header and TCP checksums were checked and correct */
+#define GMAC_RXW1_CHKSUM_TCP          (0x2u << 22)
+/** IP header and UDP checksums were checked and correct */
+#define GMAC_RXW1_CHKSUM_UDP          (0x3u << 22)
 /** Type ID register match found */
 #define GMAC_RXW1_TYPEIDFOUND         (0x1u << 24)
 /** Specific Address Register match */
@@ -180,6 +172,11 @@ struct eth_sam_dev_data {
 	struct net_if *iface;
 	uint8_t mac_addr[6];
 	struct gmac_queue queue_list[GMAC_QUEUE_NO];
+#if defined(CONFIG_ETH_RX_POLL)
+	struct k_work rx_work;
+	/** RX error to handle before taking the received frames */
+	volatile bool rx_error;
+#endif
 };
 
 #define DEV_CFG(dev) \
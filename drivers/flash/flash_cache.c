@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Flash device buffering the writes and erases of another flash device.
+ *
+ * The pages written are kept in RAM, small writes to the same page being
+ * combined into a single write of the underlying flash. Erases only mark
+ * the sectors as erased, the underlying flash being erased ahead of the
+ * writes by a background thread, which also flushes the pages once full
+ * or after some time. Enabling the write protection flushes everything.
+ */
+
+#include <errno.h>
+
+#include <kernel.h>
+#include <init.h>
+#include <flash.h>
+#include <string.h>
+#include <misc/util.h>
+
+#define PAGE_SIZE	CONFIG_FLASH_CACHE_PAGE_SIZE
+#define SECTOR_SIZE	CONFIG_FLASH_CACHE_SECTOR_SIZE
+#define SECTORS		(CONFIG_FLASH_CACHE_FLASH_SIZE / SECTOR_SIZE)
+
+#define ERASED_VALUE	0xff
+#define NO_PAGE		-1
+
+struct flash_cache_page {
+	off_t offset;
+	/* Range of the page written since it was last flushed */
+	uint16_t dirty_start;
+	uint16_t dirty_end;
+	uint32_t last_use;
+	uint8_t data[PAGE_SIZE];
+};
+
+struct flash_cache_data {
+	struct device *flash;
+	struct k_mutex lock;
+	struct k_sem flush_sem;
+	struct flash_cache_page pages[CONFIG_FLASH_CACHE_PAGES];
+	/* Sectors erased, but not yet on the underlying flash */
+	uint32_t erase_pending[(SECTORS + 31) / 32];
+	uint32_t use_count;
+	bool write_protected;
+	/* Error of a background flush, reported on the next flush */
+	int error;
+};
+
+static char __stack flash_cache_stack[CONFIG_FLASH_CACHE_THREAD_STACK_SIZE];
+
+static inline bool erase_pending(struct flash_cache_data *data, int sector)
+{
+	return data->erase_pending[sector / 32] & BIT(sector % 32);
+}
+
+static inline bool page_dirty(struct flash_cache_page *page)
+{
+	return page->dirty_end > page->dirty_start;
+}
+
+static inline bool page_full(struct flash_cache_page *page)
+{
+	return !page->dirty_start && page->dirty_end == PAGE_SIZE;
+}
+
+/* Erases the pending sectors, contiguous ones in a single erase */
+static int flash_cache_erase_flush(struct flash_cache_data *data)
+{
+	int sector, first;
+	int ret;
+
+	for (sector = 0; sector < SECTORS; sector++) {
+		if (!erase_pending(data, sector)) {
+			continue;
+		}
+
+		first = sector;
+
+		while (sector < SECTORS && erase_pending(data, sector)) {
+			data->erase_pending[sector / 32] &= ~BIT(sector % 32);
+			sector++;
+		}
+
+		flash_write_protection_set(data->flash, false);
+
+		ret = flash_erase(data->flash, first * SECTOR_SIZE,
+				  (sector - first) * SECTOR_SIZE);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int flash_cache_page_flush(struct flash_cache_data *data,
+				  struct flash_cache_page *page)
+{
+	int ret;
+
+	if (!page_dirty(page)) {
+		return 0;
+	}
+
+	/* The sector needs to be erased before being written */
+	if (erase_pending(data, page->offset / SECTOR_SIZE)) {
+		ret = flash_cache_erase_flush(data);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	flash_write_protection_set(data->flash, false);
+
+	ret = flash_write(data->flash, page->offset + page->dirty_start,
+			  &page->data[page->dirty_start],
+			  page->dirty_end - page->dirty_start);
+
+	page->dirty_start = PAGE_SIZE;
+	page->dirty_end = 0;
+
+	return ret;
+}
+
+static int flash_cache_flush(struct flash_cache_data *data, bool full_only)
+{
+	int ret, i;
+
+	ret = flash_cache_erase_flush(data);
+
+	for (i = 0; i < ARRAY_SIZE(data->pages) && !ret; i++) {
+		struct flash_cache_page *page = &data->pages[i];
+
+		if (full_only && !page_full(page)) {
+			continue;
+		}
+
+		ret = flash_cache_page_flush(data, page);
+	}
+
+	return ret;
+}
+
+static struct flash_cache_page *flash_cache_page_find(
+	struct flash_cache_data *data, off_t offset)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(data->pages); i++) {
+		if (data->pages[i].offset == offset) {
+			return &data->pages[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Gets the page at offset into the cache, evicting the least used one */
+static int flash_cache_page_get(struct flash_cache_data *data, off_t offset,
+				struct flash_cache_page **page)
+{
+	struct flash_cache_page *lru = &data->pages[0];
+	int ret, i;
+
+	*page = flash_cache_page_find(data, offset);
+	if (*page) {
+		return 0;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(data->pages); i++) {
+		if (data->pages[i].offset == NO_PAGE) {
+			lru = &data->pages[i];
+			break;
+		}
+
+		if (data->pages[i].last_use < lru->last_use) {
+			lru = &data->pages[i];
+		}
+	}
+
+	ret = flash_cache_page_flush(data, lru);
+	if (ret) {
+		return ret;
+	}
+
+	lru->offset = NO_PAGE;
+
+	if (erase_pending(data, offset / SECTOR_SIZE)) {
+		memset(lru->data, ERASED_VALUE, PAGE_SIZE);
+	} else {
+		ret = flash_read(data->flash, offset, lru->data, PAGE_SIZE);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	lru->offset = offset;
+	*page = lru;
+
+	return 0;
+}
+
+static inline bool flash_cache_range_valid(off_t offset, size_t len)
+{
+	return offset >= 0 && len <= CONFIG_FLASH_CACHE_FLASH_SIZE &&
+	       offset <= CONFIG_FLASH_CACHE_FLASH_SIZE - len;
+}
+
+static int flash_cache_read(struct device *dev, off_t offset, void *buf,
+			    size_t len)
+{
+	struct flash_cache_data *data = dev->driver_data;
+	struct flash_cache_page *page;
+	uint8_t *dst = buf;
+	size_t chunk, page_ofs;
+	int ret = 0;
+
+	if (!flash_cache_range_valid(offset, len)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	while (len && !ret) {
+		page_ofs = offset % PAGE_SIZE;
+		chunk = min(len, PAGE_SIZE - page_ofs);
+
+		page = flash_cache_page_find(data, offset - page_ofs);
+		if (page) {
+			memcpy(dst, &page->data[page_ofs], chunk);
+		} else if (erase_pending(data, offset / SECTOR_SIZE)) {
+			memset(dst, ERASED_VALUE, chunk);
+		} else {
+			ret = flash_read(data->flash, offset, dst, chunk);
+		}
+
+		offset += chunk;
+		dst += chunk;
+		len -= chunk;
+	}
+
+	k_mutex_unlock(&data->lock);
+
+	return ret;
+}
+
+static int flash_cache_write(struct device *dev, off_t offset,
+			     const void *buf, size_t len)
+{
+	struct flash_cache_data *data = dev->driver_data;
+	struct flash_cache_page *page;
+	const uint8_t *src = buf;
+	size_t chunk, page_ofs;
+	int ret = 0;
+
+	if (!flash_cache_range_valid(offset, len)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	if (data->write_protected) {
+		k_mutex_unlock(&data->lock);
+		return -EACCES;
+	}
+
+	while (len) {
+		page_ofs = offset % PAGE_SIZE;
+		chunk = min(len, PAGE_SIZE - page_ofs);
+
+		ret = flash_cache_page_get(data, offset - page_ofs, &page);
+		if (ret) {
+			break;
+		}
+
+		memcpy(&page->data[page_ofs], src, chunk);
+		page->dirty_start = min(page->dirty_start, page_ofs);
+		page->dirty_end = max(page->dirty_end, page_ofs + chunk);
+		page->last_use = ++data->use_count;
+
+		/* Full pages are written right away */
+		if (page_full(page)) {
+			k_sem_give(&data->flush_sem);
+		}
+
+		offset += chunk;
+		src += chunk;
+		len -= chunk;
+	}
+
+	k_mutex_unlock(&data->lock);
+
+	return ret;
+}
+
+static int flash_cache_erase(struct device *dev, off_t offset, size_t size)
+{
+	struct flash_cache_data *data = dev->driver_data;
+	int sector, i;
+
+	if (!flash_cache_range_valid(offset, size) ||
+	    offset % SECTOR_SIZE || size % SECTOR_SIZE) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	if (data->write_protected) {
+		k_mutex_unlock(&data->lock);
+		return -EACCES;
+	}
+
+	for (sector = offset / SECTOR_SIZE;
+	     sector < (offset + size) / SECTOR_SIZE; sector++) {
+		data->erase_pending[sector / 32] |= BIT(sector % 32);
+	}
+
+	/* The pages of the sectors are erased along with them */
+	for (i = 0; i < ARRAY_SIZE(data->pages); i++) {
+		struct flash_cache_page *page = &data->pages[i];
+
+		if (page->offset >= offset && page->offset < offset + size) {
+			page->offset = NO_PAGE;
+			page->dirty_start = PAGE_SIZE;
+			page->dirty_end = 0;
+		}
+	}
+
+	/* Erase ahead of the writes to come */
+	k_sem_give(&data->flush_sem);
+
+	k_mutex_unlock(&data->lock);
+
+	return 0;
+}
+
+static int flash_cache_write_protection_set(struct device *dev, bool enable)
+{
+	struct flash_cache_data *data = dev->driver_data;
+	int ret = 0;
+
+	k_mutex_lock(&data->lock, K_FOREVER);
+
+	if (enable) {
+		ret = flash_cache_flush(data, false);
+		if (!ret) {
+			ret = data->error;
+		}
+
+		data->error = 0;
+
+		flash_write_protection_set(data->flash, true);
+	}
+
+	data->write_protected = enable;
+
+	k_mutex_unlock(&data->lock);
+
+	return ret;
+}
+
+static void flash_cache_thread(void *p1, void *p2, void *p3)
+{
+	struct flash_cache_data *data = p1;
+	int32_t timeout = K_FOREVER;
+	int i, ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		bool full_only = !k_sem_take(&data->flush_sem, timeout);
+
+		k_mutex_lock(&data->lock, K_FOREVER);
+
+		/* Partially written pages wait for more writes, until the
+		 * flash is left alone for the flush timeout.
+		 */
+		ret = flash_cache_flush(data, full_only);
+		if (ret) {
+			data->error = ret;
+		}
+
+		timeout = K_FOREVER;
+
+		for (i = 0; i < ARRAY_SIZE(data->pages); i++) {
+			if (page_dirty(&data->pages[i])) {
+				timeout = CONFIG_FLASH_CACHE_FLUSH_TIMEOUT;
+			}
+		}
+
+		k_mutex_unlock(&data->lock);
+	}
+}
+
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+static const struct flash_pages_layout flash_cache_layout = {
+	.pages_count = SECTORS,
+	.pages_size = SECTOR_SIZE,
+};
+
+static void flash_cache_page_layout(struct device *dev,
+				    const struct flash_pages_layout **layout,
+				    size_t *layout_size)
+{
+	*layout = &flash_cache_layout;
+	*layout_size = 1;
+}
+#endif
+
+static const struct flash_driver_api flash_cache_api = {
+	.read = flash_cache_read,
+	.write = flash_cache_write,
+	.erase = flash_cache_erase,
+	.write_protection = flash_cache_write_protection_set,
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+	.page_layout = flash_cache_page_layout,
+#endif
+};
+
+static int flash_cache_init(struct device *dev)
+{
+	struct flash_cache_data *data = dev->driver_data;
+	int i;
+
+	data->flash = device_get_binding(CONFIG_FLASH_CACHE_DEV_NAME);
+	if (!data->flash) {
+		return -EIO;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(data->pages); i++) {
+		data->pages[i].offset = NO_PAGE;
+		data->pages[i].dirty_start = PAGE_SIZE;
+	}
+
+	data->write_protected = true;
+
+	k_mutex_init(&data->lock);
+	k_sem_init(&data->flush_sem, 0, 1);
+
+	k_thread_spawn(flash_cache_stack, sizeof(flash_cache_stack),
+		       flash_cache_thread, data, NULL, NULL,
+		       K_PRIO_PREEMPT(CONFIG_FLASH_CACHE_THREAD_PRIORITY),
+		       0, 0);
+
+	return 0;
+}
+
+static struct flash_cache_data flash_cache_data;
+
+DEVICE_AND_API_INIT(flash_cache, CONFIG_FLASH_CACHE_DRV_NAME,
+		    flash_cache_init, &flash_cache_data, NULL, POST_KERNEL,
+		    CONFIG_FLASH_CACHE_INIT_PRIORITY, &flash_cache_api);
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+
+#include <flash.h>
+
+static int flash_get_page_info(struct device *dev, off_t offset,
+			       uint32_t page_index,
+			       struct flash_pages_info *info)
+{
+	const struct flash_driver_api *api = dev->driver_api;
+	const struct flash_pages_layout *layout;
+	size_t layout_size;
+	uint32_t index_jmp;
+	int i;
+
+	if (!api->page_layout) {
+		return -ENOTSUP;
+	}
+
+	api->page_layout(dev, &layout, &layout_size);
+
+	info->start_offset = 0;
+	info->index = 0;
+
+	/* offset set means it is looked for, page_index otherwise */
+	for (i = 0; i < layout_size; i++) {
+		info->size = layout[i].pages_size;
+
+		if (offset >= 0) {
+			index_jmp = (offset - info->start_offset) /
+				    info->size;
+		} else {
+			index_jmp = page_index - info->index;
+		}
+
+		if (index_jmp < layout[i].pages_count) {
+			info->start_offset += index_jmp * info->size;
+			info->index += index_jmp;
+			return 0;
+		}
+
+		info->start_offset += layout[i].pages_count * info->size;
+		info->index += layout[i].pages_count;
+	}
+
+	return -EINVAL;
+}
+
+int flash_get_page_info_by_offs(struct device *dev, off_t offset,
+				struct flash_pages_info *info)
+{
+	if (offset < 0) {
+		return -EINVAL;
+	}
+
+	return flash_get_page_info(dev, offset, 0, info);
+}
+
+int flash_get_page_info_by_idx(struct device *dev, uint32_t page_index,
+			       struct flash_pages_info *info)
+{
+	return flash_get_page_info(dev, -1, page_index, info);
+}
+
+size_t flash_get_page_count(struct device *dev)
+{
+	const struct flash_driver_api *api = dev->driver_api;
+	const struct flash_pages_layout *layout;
+	size_t layout_size, count = 0;
+	int i;
+
+	if (!api->page_layout) {
+		return 0;
+	}
+
+	api->page_layout(dev, &layout, &layout_size);
+
+	for (i = 0; i < layout_size; i++) {
+		count += layout[i].pages_count;
+	}
+
+	return count;
+}
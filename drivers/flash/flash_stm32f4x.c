@@ -242,11 +242,30 @@ static struct flash_priv flash_data = {
 	.regs = (struct stm32f4x_flash *) FLASH_R_BASE,
 };
 
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+static const struct flash_pages_layout flash_stm32f4x_layout[] = {
+	{ .pages_count = 4, .pages_size = KB(16) },
+	{ .pages_count = 1, .pages_size = KB(64) },
+	{ .pages_count = STM32F4X_SECTORS - 5, .pages_size = KB(128) },
+};
+
+static void flash_stm32f4x_page_layout(struct device *dev,
+				       const struct flash_pages_layout **layout,
+				       size_t *layout_size)
+{
+	*layout = flash_stm32f4x_layout;
+	*layout_size = ARRAY_SIZE(flash_stm32f4x_layout);
+}
+#endif
+
 static const struct flash_driver_api flash_stm32f4x_api = {
 	.write_protection = flash_stm32f4x_write_protection,
 	.erase = flash_stm32f4x_erase,
 	.write = flash_stm32f4x_write,
 	.read = flash_stm32f4x_read,
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+	.page_layout = flash_stm32f4x_page_layout,
+#endif
 };
 
 static int stm32f4x_flash_init(struct device *dev)
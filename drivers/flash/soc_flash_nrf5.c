@@ -154,11 +154,29 @@ static int flash_nrf5_write_protection(struct device *dev, bool enable)
 	return 0;
 }
 
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+static struct flash_pages_layout flash_nrf5_layout;
+
+static void flash_nrf5_page_layout(struct device *dev,
+				   const struct flash_pages_layout **layout,
+				   size_t *layout_size)
+{
+	flash_nrf5_layout.pages_count = NRF_FICR->CODESIZE;
+	flash_nrf5_layout.pages_size = NRF_FICR->CODEPAGESIZE;
+
+	*layout = &flash_nrf5_layout;
+	*layout_size = 1;
+}
+#endif
+
 static const struct flash_driver_api flash_nrf5_api = {
 	.read = flash_nrf5_read,
 	.write = flash_nrf5_write,
 	.erase = flash_nrf5_erase,
 	.write_protection = flash_nrf5_write_protection,
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+	.page_layout = flash_nrf5_page_layout,
+#endif
 };
 
 static int nrf5_flash_init(struct device *dev)
@@ -255,6 +255,9 @@ static const struct flash_driver_api flash_qmsi_api = {
 	.write_protection = flash_qmsi_write_protection,
 };
 
+FLASH_DIRECT_API_DEFINE(flash_qmsi_api, flash_qmsi_read, flash_qmsi_write,
+			flash_qmsi_erase, flash_qmsi_write_protection);
+
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 static void flash_qmsi_set_power_state(struct device *dev, uint32_t power_state)
 {
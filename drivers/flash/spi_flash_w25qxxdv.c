@@ -10,9 +10,19 @@
 #include <spi.h>
 #include <init.h>
 #include <string.h>
+#include <misc/util.h>
 #include "spi_flash_w25qxxdv_defs.h"
 #include "spi_flash_w25qxxdv.h"
 
+#if defined(CONFIG_SPI_FLASH_W25QXXDV_FAST_READ)
+#define W25QXXDV_CMD_READ_DATA	W25QXXDV_CMD_FASTREAD
+#define W25QXXDV_LEN_READ_CMD \
+	(W25QXXDV_LEN_CMD_ADDRESS + W25QXXDV_LEN_DUMMY)
+#else
+#define W25QXXDV_CMD_READ_DATA	W25QXXDV_CMD_READ
+#define W25QXXDV_LEN_READ_CMD	W25QXXDV_LEN_CMD_ADDRESS
+#endif
+
 static inline int spi_flash_wb_id(struct device *dev)
 {
 	struct spi_flash_data *const driver_data = dev->driver_data;
@@ -106,8 +116,11 @@ static int spi_flash_wb_read(struct device *dev, off_t offset, void *data,
 {
 	struct spi_flash_data *const driver_data = dev->driver_data;
 	uint8_t *buf = driver_data->buf;
+	uint8_t *dst = data;
+	size_t chunk;
 
-	if (len > CONFIG_SPI_FLASH_W25QXXDV_MAX_DATA_LEN || offset < 0) {
+	if (offset < 0 || len > CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE ||
+	    offset > CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE - len) {
 		return -ENODEV;
 	}
 
@@ -120,21 +133,35 @@ static int spi_flash_wb_read(struct device *dev, off_t offset, void *data,
 
 	wait_for_flash_idle(dev);
 
-	buf[0] = W25QXXDV_CMD_READ;
-	buf[1] = (uint8_t) (offset >> 16);
-	buf[2] = (uint8_t) (offset >> 8);
-	buf[3] = (uint8_t) offset;
+	/* Long reads are split in bursts of the buffer size, the bus being
+	 * configured and the flash found idle once for all of them.
+	 */
+	while (len) {
+		chunk = min(len, CONFIG_SPI_FLASH_W25QXXDV_MAX_DATA_LEN);
+
+		buf[0] = W25QXXDV_CMD_READ_DATA;
+		buf[1] = (uint8_t) (offset >> 16);
+		buf[2] = (uint8_t) (offset >> 8);
+		buf[3] = (uint8_t) offset;
+
+		memset(buf + W25QXXDV_LEN_CMD_ADDRESS, 0,
+		       chunk + W25QXXDV_LEN_READ_CMD -
+		       W25QXXDV_LEN_CMD_ADDRESS);
+
+		if (spi_transceive(driver_data->spi,
+				   buf, chunk + W25QXXDV_LEN_READ_CMD,
+				   buf, chunk + W25QXXDV_LEN_READ_CMD) != 0) {
+			k_sem_give(&driver_data->sem);
+			return -EIO;
+		}
 
-	memset(buf + W25QXXDV_LEN_CMD_ADDRESS, 0, len);
+		memcpy(dst, buf + W25QXXDV_LEN_READ_CMD, chunk);
 
-	if (spi_transceive(driver_data->spi, buf, len + W25QXXDV_LEN_CMD_ADDRESS,
-			   buf, len + W25QXXDV_LEN_CMD_ADDRESS) != 0) {
-		k_sem_give(&driver_data->sem);
-		return -EIO;
+		offset += chunk;
+		dst += chunk;
+		len -= chunk;
 	}
 
-	memcpy(data, buf + W25QXXDV_LEN_CMD_ADDRESS, len);
-
 	k_sem_give(&driver_data->sem);
 
 	return 0;
@@ -309,7 +336,9 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 			break;
 		}
 
-		if (size_remaining >= W25QXXDV_BLOCK_SIZE) {
+		/* blocks are erased whole, only when aligned */
+		if (size_remaining >= W25QXXDV_BLOCK_SIZE &&
+		    !(new_offset & (W25QXXDV_BLOCK_SIZE - 1))) {
 			ret = spi_flash_wb_erase_internal(dev, new_offset,
 							  W25QXXDV_BLOCK_SIZE);
 			new_offset += W25QXXDV_BLOCK_SIZE;
@@ -317,7 +346,8 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 			continue;
 		}
 
-		if (size_remaining >= W25QXXDV_BLOCK32K_SIZE) {
+		if (size_remaining >= W25QXXDV_BLOCK32K_SIZE &&
+		    !(new_offset & (W25QXXDV_BLOCK32K_SIZE - 1))) {
 			ret = spi_flash_wb_erase_internal(dev, new_offset,
 							  W25QXXDV_BLOCK32K_SIZE);
 			new_offset += W25QXXDV_BLOCK32K_SIZE;
@@ -339,13 +369,35 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 	return ret;
 }
 
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+static const struct flash_pages_layout spi_flash_wb_layout = {
+	.pages_count = CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE /
+		       W25QXXDV_SECTOR_SIZE,
+	.pages_size = W25QXXDV_SECTOR_SIZE,
+};
+
+static void spi_flash_wb_page_layout(struct device *dev,
+				     const struct flash_pages_layout **layout,
+				     size_t *layout_size)
+{
+	*layout = &spi_flash_wb_layout;
+	*layout_size = 1;
+}
+#endif
+
 static const struct flash_driver_api spi_flash_api = {
 	.read = spi_flash_wb_read,
 	.write = spi_flash_wb_write,
 	.erase = spi_flash_wb_erase,
 	.write_protection = spi_flash_wb_write_protection_set,
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+	.page_layout = spi_flash_wb_page_layout,
+#endif
 };
 
+FLASH_DIRECT_API_DEFINE(spi_flash_api, spi_flash_wb_read, spi_flash_wb_write,
+			spi_flash_wb_erase, spi_flash_wb_write_protection_set);
+
 static int spi_flash_init(struct device *dev)
 {
 	struct device *spi_dev;
@@ -40,6 +40,7 @@
 #define W25QXXDV_ADDRESS_WIDTH        (3)
 #define W25QXXDV_LEN_CMD_ADDRESS      (4)
 #define W25QXXDV_LEN_CMD_AND_ID       (4)
+#define W25QXXDV_LEN_DUMMY            (1)
 
 /* relevant status register bits */
 #define W25QXXDV_WIP_BIT         (0x1 << 0)
@@ -422,6 +422,17 @@ static void gpio_dw_isr(void *arg)
 	_gpio_fire_callbacks(&context->callbacks, port, int_status);
 }
 
+#ifdef CONFIG_SHARED_IRQ
+/* Tells the shared IRQ driver whether the interrupt is from this port */
+static int gpio_dw_isr_pending(struct device *port)
+{
+	struct gpio_dw_runtime *context = port->driver_data;
+	uint32_t base_addr = dw_base_to_block_base(context->base_addr);
+
+	return dw_read(base_addr, INTSTATUS) != 0;
+}
+#endif
+
 static const struct gpio_driver_api api_funcs = {
 	.config = gpio_dw_config,
 	.write = gpio_dw_write,
@@ -553,6 +564,7 @@ static void gpio_config_0_irq(struct device *port)
 	__ASSERT(shared_irq_dev != NULL,
 		 "Failed to get gpio_dw_0 device binding");
 	shared_irq_isr_register(shared_irq_dev, (isr_t)gpio_dw_isr, port);
+	shared_irq_pending_register(shared_irq_dev, gpio_dw_isr_pending, port);
 	shared_irq_enable(shared_irq_dev, port);
 #endif
 	gpio_dw_unmask_int(GPIO_DW_PORT_0_INT_MASK);
@@ -621,6 +633,7 @@ static void gpio_config_1_irq(struct device *port)
 	__ASSERT(shared_irq_dev != NULL,
 		 "Failed to get gpio_dw_1 device binding");
 	shared_irq_isr_register(shared_irq_dev, (isr_t)gpio_dw_isr, port);
+	shared_irq_pending_register(shared_irq_dev, gpio_dw_isr_pending, port);
 	shared_irq_enable(shared_irq_dev, port);
 #endif
 	gpio_dw_unmask_int(GPIO_DW_PORT_1_INT_MASK);
@@ -688,6 +701,7 @@ static void gpio_config_2_irq(struct device *port)
 	__ASSERT(shared_irq_dev != NULL,
 		 "Failed to get gpio_dw_2 device binding");
 	shared_irq_isr_register(shared_irq_dev, (isr_t)gpio_dw_isr, port);
+	shared_irq_pending_register(shared_irq_dev, gpio_dw_isr_pending, port);
 	shared_irq_enable(shared_irq_dev, port);
 #endif
 	gpio_dw_unmask_int(GPIO_DW_PORT_2_INT_MASK);
@@ -755,6 +769,7 @@ static void gpio_config_3_irq(struct device *port)
 	__ASSERT(shared_irq_dev != NULL,
 			 "Failed to get gpio_dw_3 device binding");
 	shared_irq_isr_register(shared_irq_dev, (isr_t)gpio_dw_isr, port);
+	shared_irq_pending_register(shared_irq_dev, gpio_dw_isr_pending, port);
 	shared_irq_enable(shared_irq_dev, port);
 #endif
 	gpio_dw_unmask_int(GPIO_DW_PORT_3_INT_MASK);
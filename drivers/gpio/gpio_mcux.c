@@ -146,6 +146,35 @@ static int gpio_mcux_write(struct device *dev,
 	return 0;
 }
 
+static int gpio_mcux_port_set_masked(struct device *dev, uint32_t mask,
+				     uint32_t value)
+{
+	const struct gpio_mcux_config *config = dev->config->config_info;
+	GPIO_Type *gpio_base = config->gpio_base;
+
+	/* Zeros written to the set and clear registers leave the other
+	 * pins unchanged.
+	 */
+	if (mask & value) {
+		gpio_base->PSOR = mask & value;
+	}
+	if (mask & ~value) {
+		gpio_base->PCOR = mask & ~value;
+	}
+
+	return 0;
+}
+
+static int gpio_mcux_port_toggle_bits(struct device *dev, uint32_t pins)
+{
+	const struct gpio_mcux_config *config = dev->config->config_info;
+	GPIO_Type *gpio_base = config->gpio_base;
+
+	gpio_base->PTOR = pins;
+
+	return 0;
+}
+
 static int gpio_mcux_read(struct device *dev,
 			  int access_op, uint32_t pin, uint32_t *value)
 {
@@ -225,6 +254,8 @@ static const struct gpio_driver_api gpio_mcux_driver_api = {
 	.manage_callback = gpio_mcux_manage_callback,
 	.enable_callback = gpio_mcux_enable_callback,
 	.disable_callback = gpio_mcux_disable_callback,
+	.port_set_masked = gpio_mcux_port_set_masked,
+	.port_toggle_bits = gpio_mcux_port_toggle_bits,
 };
 
 #ifdef CONFIG_GPIO_MCUX_PORTA
@@ -271,6 +271,34 @@ static int gpio_nrf5_write(struct device *dev,
 	return 0;
 }
 
+static int gpio_nrf5_port_set_masked(struct device *dev, uint32_t mask,
+				     uint32_t value)
+{
+	volatile struct _gpio *gpio = GPIO_STRUCT(dev);
+
+	if (mask & value) {
+		gpio->OUTSET = mask & value;
+	}
+	if (mask & ~value) {
+		gpio->OUTCLR = mask & ~value;
+	}
+	return 0;
+}
+
+static int gpio_nrf5_port_toggle_bits(struct device *dev, uint32_t pins)
+{
+	volatile struct _gpio *gpio = GPIO_STRUCT(dev);
+	uint32_t out = gpio->OUT;
+
+	if (pins & ~out) {
+		gpio->OUTSET = pins & ~out;
+	}
+	if (pins & out) {
+		gpio->OUTCLR = pins & out;
+	}
+	return 0;
+}
+
 static int gpio_nrf5_manage_callback(struct device *dev,
 				    struct gpio_callback *callback, bool set)
 {
@@ -373,6 +401,8 @@ static const struct gpio_driver_api gpio_nrf5_drv_api_funcs = {
 	.manage_callback = gpio_nrf5_manage_callback,
 	.enable_callback = gpio_nrf5_enable_callback,
 	.disable_callback = gpio_nrf5_disable_callback,
+	.port_set_masked = gpio_nrf5_port_set_masked,
+	.port_toggle_bits = gpio_nrf5_port_toggle_bits,
 };
 
 /* Initialization for GPIO Port 0 */
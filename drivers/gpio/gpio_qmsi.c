@@ -275,6 +275,37 @@ static inline int gpio_qmsi_write(struct device *port,
 	return 0;
 }
 
+/* The controller only has the data register, which is updated with
+ * interrupts locked so that the other pins are not changed in between.
+ */
+static int gpio_qmsi_port_set_masked(struct device *port, uint32_t mask,
+				     uint32_t value)
+{
+	const struct gpio_qmsi_config *gpio_config = port->config->config_info;
+	qm_gpio_t gpio = gpio_config->gpio;
+	unsigned int key;
+
+	key = irq_lock();
+	QM_GPIO[gpio]->gpio_swporta_dr =
+		(QM_GPIO[gpio]->gpio_swporta_dr & ~mask) | (value & mask);
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int gpio_qmsi_port_toggle_bits(struct device *port, uint32_t pins)
+{
+	const struct gpio_qmsi_config *gpio_config = port->config->config_info;
+	qm_gpio_t gpio = gpio_config->gpio;
+	unsigned int key;
+
+	key = irq_lock();
+	QM_GPIO[gpio]->gpio_swporta_dr ^= pins;
+	irq_unlock(key);
+
+	return 0;
+}
+
 static inline int gpio_qmsi_read(struct device *port,
 				 int access_op, uint32_t pin, uint32_t *value)
 {
@@ -362,6 +393,8 @@ static const struct gpio_driver_api api_funcs = {
 	.enable_callback = gpio_qmsi_enable_callback,
 	.disable_callback = gpio_qmsi_disable_callback,
 	.get_pending_int = gpio_qmsi_get_pending_int,
+	.port_set_masked = gpio_qmsi_port_set_masked,
+	.port_toggle_bits = gpio_qmsi_port_toggle_bits,
 };
 
 static int gpio_qmsi_init(struct device *port)
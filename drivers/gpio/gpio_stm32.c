@@ -121,6 +121,27 @@ static int gpio_stm32_read(struct device *dev, int access_op,
 	return 0;
 }
 
+/**
+ * @brief Set several pins of the port at once
+ */
+static int gpio_stm32_port_set_masked(struct device *dev, uint32_t mask,
+				      uint32_t value)
+{
+	const struct gpio_stm32_config *cfg = dev->config->config_info;
+
+	return stm32_gpio_set_masked(cfg->base, mask, value);
+}
+
+/**
+ * @brief Toggle several pins of the port at once
+ */
+static int gpio_stm32_port_toggle_bits(struct device *dev, uint32_t pins)
+{
+	const struct gpio_stm32_config *cfg = dev->config->config_info;
+
+	return stm32_gpio_toggle(cfg->base, pins);
+}
+
 static int gpio_stm32_manage_callback(struct device *dev,
 				      struct gpio_callback *callback,
 				      bool set)
@@ -167,7 +188,8 @@ static const struct gpio_driver_api gpio_stm32_driver = {
 	.manage_callback = gpio_stm32_manage_callback,
 	.enable_callback = gpio_stm32_enable_callback,
 	.disable_callback = gpio_stm32_disable_callback,
-
+	.port_set_masked = gpio_stm32_port_set_masked,
+	.port_toggle_bits = gpio_stm32_port_toggle_bits,
 };
 
 /**
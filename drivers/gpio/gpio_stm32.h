@@ -100,6 +100,23 @@ int stm32_gpio_configure(uint32_t *base_addr, int pin, int func, int altf);
  */
 int stm32_gpio_set(uint32_t *base, int pin, int value);
 
+/**
+ * @brief helper for setting several GPIO pins at once, through BSRR
+ *
+ * @param base_addr GPIO port base address
+ * @param mask IO pins to write
+ * @param value value of the IO pins in mask
+ */
+int stm32_gpio_set_masked(uint32_t *base, uint32_t mask, uint32_t value);
+
+/**
+ * @brief helper for toggling several GPIO pins at once, through BSRR
+ *
+ * @param base_addr GPIO port base address
+ * @param mask IO pins to toggle
+ */
+int stm32_gpio_toggle(uint32_t *base, uint32_t mask);
+
 /**
  * @brief helper for reading of GPIO pin value
  *
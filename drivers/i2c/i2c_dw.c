@@ -94,6 +94,22 @@ static inline void _i2c_dw_data_ask(struct device *dev)
 	}
 }
 
+/*
+ * Raises the RX FIFO threshold for the bytes still to be read, up to the
+ * watermark, so that a multi-byte read is not an interrupt per byte.
+ */
+static inline void _i2c_dw_rx_threshold(struct device *dev)
+{
+	struct i2c_dw_dev_config * const dw = dev->driver_data;
+
+	volatile struct i2c_dw_registers * const regs =
+		(struct i2c_dw_registers *)dw->base_address;
+
+	if (dw->xfr_len) {
+		regs->ic_rx_tl = min(dw->xfr_len, I2C_DW_RX_WATERMARK + 1) - 1;
+	}
+}
+
 static void _i2c_dw_data_read(struct device *dev)
 {
 	struct i2c_dw_dev_config * const dw = dev->driver_data;
@@ -118,6 +134,8 @@ static void _i2c_dw_data_read(struct device *dev)
 		dw->state &= ~I2C_DW_CMD_RECV;
 		return;
 	}
+
+	_i2c_dw_rx_threshold(dev);
 }
 
 
@@ -166,10 +184,238 @@ static int _i2c_dw_data_send(struct device *dev)
 	return 0;
 }
 
+static int _i2c_dw_setup(struct device *dev, uint16_t slave_address)
+{
+	struct i2c_dw_dev_config * const dw = dev->driver_data;
+	uint32_t value;
+	union ic_con_register ic_con;
+	volatile struct i2c_dw_registers * const regs =
+		(struct i2c_dw_registers *)dw->base_address;
+
+	ic_con.raw = 0;
+
+	/* Disable the device controller to be able set TAR */
+	regs->ic_enable.bits.enable = 0;
+
+	/* Disable interrupts */
+	regs->ic_intr_mask.raw = 0;
+
+	/* Clear interrupts */
+	value = regs->ic_clr_intr;
+
+	/* Set master or slave mode - (initialization = slave) */
+	if (dw->app_config.bits.is_master_device) {
+		/*
+		 * Make sure to set both the master_mode and slave_disable_bit
+		 * to both 0 or both 1
+		 */
+		SYS_LOG_DBG("I2C: host configured as Master Device");
+		ic_con.bits.master_mode = 1;
+		ic_con.bits.slave_disable = 1;
+	}
+
+	ic_con.bits.restart_en = 1;
+
+	/* Set addressing mode - (initialization = 7 bit) */
+	if (dw->app_config.bits.use_10_bit_addr) {
+		SYS_LOG_DBG("I2C: using 10-bit address");
+		ic_con.bits.addr_master_10bit = 1;
+		ic_con.bits.addr_slave_10bit = 1;
+	}
+
+	/* Setup the clock frequency and speed mode */
+	switch (dw->app_config.bits.speed) {
+	case I2C_SPEED_STANDARD:
+		SYS_LOG_DBG("I2C: speed set to STANDARD");
+		regs->ic_ss_scl_lcnt = dw->lcnt;
+		regs->ic_ss_scl_hcnt = dw->hcnt;
+		ic_con.bits.speed = I2C_DW_SPEED_STANDARD;
+
+		break;
+	case I2C_SPEED_FAST:
+		/* fall through */
+	case I2C_SPEED_FAST_PLUS:
+		SYS_LOG_DBG("I2C: speed set to FAST or FAST_PLUS");
+		regs->ic_fs_scl_lcnt = dw->lcnt;
+		regs->ic_fs_scl_hcnt = dw->hcnt;
+		ic_con.bits.speed = I2C_DW_SPEED_FAST;
+
+		break;
+	case I2C_SPEED_HIGH:
+		if (!dw->support_hs_mode) {
+			return -EINVAL;
+		}
+
+		SYS_LOG_DBG("I2C: speed set to HIGH");
+		regs->ic_hs_scl_lcnt = dw->lcnt;
+		regs->ic_hs_scl_hcnt = dw->hcnt;
+		ic_con.bits.speed = I2C_DW_SPEED_HIGH;
+
+		break;
+	default:
+		SYS_LOG_DBG("I2C: invalid speed requested");
+		return -EINVAL;
+	}
+
+	SYS_LOG_DBG("I2C: lcnt = %d", dw->lcnt);
+	SYS_LOG_DBG("I2C: hcnt = %d", dw->hcnt);
+
+	/* Set the IC_CON register */
+	regs->ic_con = ic_con;
+
+	/* Set RX fifo threshold level.
+	 * Setting it to zero automatically triggers interrupt
+	 * RX_FULL whenever there is data received. It is raised
+	 * for multi-byte reads, see _i2c_dw_rx_threshold().
+	 */
+	regs->ic_rx_tl = 0;
+
+	/* Set TX fifo threshold level.
+	 * TX_EMPTY interrupt is triggered only when the
+	 * TX FIFO is truly empty. So that we can let
+	 * the controller do the transfers for longer period
+	 * before we need to fill the FIFO again. This may
+	 * cause some pauses during transfers, but this keeps
+	 * the device from interrupting often.
+	 */
+	regs->ic_tx_tl = 0;
+
+	if (regs->ic_con.bits.master_mode) {
+		/* Set address of target slave */
+		regs->ic_tar.bits.ic_tar = slave_address;
+	} else {
+		/* Set slave address for device */
+		regs->ic_sar.bits.ic_sar = slave_address;
+	}
+
+	return 0;
+}
+
+/* Starts the current message of the current transaction */
+static void _i2c_dw_msg_start(struct device *dev)
+{
+	struct i2c_dw_dev_config * const dw = dev->driver_data;
+	struct i2c_msg *cur_msg = &dw->trans->msgs[dw->msg];
+	uint8_t pflags = dw->xfr_flags;
+
+	volatile struct i2c_dw_registers * const regs =
+		(struct i2c_dw_registers *)dw->base_address;
+
+	dw->xfr_buf = cur_msg->buf;
+	dw->xfr_len = cur_msg->len;
+	dw->xfr_flags = cur_msg->flags;
+	dw->rx_pending = 0;
+
+	/* Need to RESTART if changing transfer direction */
+	if ((pflags & I2C_MSG_RW_MASK)
+	    != (dw->xfr_flags & I2C_MSG_RW_MASK)) {
+		dw->xfr_flags |= I2C_MSG_RESTART;
+	}
+
+	/* Send STOP if this is the last message */
+	if (dw->msg == dw->trans->num_msgs - 1) {
+		dw->xfr_flags |= I2C_MSG_STOP;
+	}
+
+	dw->state &= ~(I2C_DW_CMD_SEND | I2C_DW_CMD_RECV);
+
+	if ((dw->xfr_flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE) {
+		dw->state |= I2C_DW_CMD_SEND;
+		dw->request_bytes = 0;
+	} else {
+		dw->state |= I2C_DW_CMD_RECV;
+		dw->request_bytes = dw->xfr_len;
+		_i2c_dw_rx_threshold(dev);
+	}
+
+	/* Enable interrupts to trigger ISR */
+	if (regs->ic_con.bits.master_mode) {
+		/* Enable necessary interrupts */
+		regs->ic_intr_mask.raw = (DW_ENABLE_TX_INT_I2C_MASTER |
+					  DW_ENABLE_RX_INT_I2C_MASTER);
+	} else {
+		/* Enable necessary interrupts */
+		regs->ic_intr_mask.raw = DW_ENABLE_TX_INT_I2C_SLAVE;
+	}
+}
+
+/* Starts the next queued transaction, if the controller is idle */
+static void _i2c_dw_queue_next(struct device *dev)
+{
+	struct i2c_dw_dev_config * const dw = dev->driver_data;
+	struct i2c_transaction *trans;
+	sys_snode_t *node;
+	int ret;
+
+	volatile struct i2c_dw_registers * const regs =
+		(struct i2c_dw_registers *)dw->base_address;
+
+	while (!dw->trans && (node = sys_slist_get(&dw->queue))) {
+		trans = CONTAINER_OF(node, struct i2c_transaction, node);
+
+		/* First step, check if there is current activity */
+		if (regs->ic_status.bits.activity) {
+			ret = -EIO;
+		} else {
+			ret = _i2c_dw_setup(dev, trans->addr);
+		}
+
+		if (ret) {
+			trans->callback(dev, trans, ret);
+			continue;
+		}
+
+		dw->state |= I2C_DW_BUSY;
+
+		/* Enable controller */
+		regs->ic_enable.bits.enable = 1;
+
+		/*
+		 * While the transaction is in progress, kernel can switch to
+		 * idle task which in turn can call _sys_soc_suspend() hook
+		 * of Power Management App (PMA).
+		 * device_busy_set() call here, would indicate to PMA that it
+		 * should not execute PM policies that would turn off this ip
+		 * block, causing an ongoing hw transaction to be left in an
+		 * inconsistent state.
+		 * Note : This is just a sample to show a possible use of the
+		 * API, it is upto the driver expert to see, if he actually
+		 * needs it here, or somewhere else, or not needed as the
+		 * driver's suspend()/resume() can handle everything
+		 */
+		device_busy_set(dev);
+
+		dw->trans = trans;
+		dw->msg = 0;
+
+		_i2c_dw_msg_start(dev);
+	}
+}
+
+static void _i2c_dw_transaction_end(struct device *dev, int ret)
+{
+	struct i2c_dw_dev_config * const dw = dev->driver_data;
+	struct i2c_transaction *trans = dw->trans;
+
+	device_busy_clear(dev);
+
+	dw->state = I2C_DW_STATE_READY;
+	dw->trans = NULL;
+
+	trans->callback(dev, trans, ret);
+
+	_i2c_dw_queue_next(dev);
+}
+
+/*
+ * Ends the current message: the next one of the transaction is started,
+ * or the transaction is over and the next queued one is started.
+ */
 static inline void _i2c_dw_transfer_complete(struct device *dev)
 {
 	struct i2c_dw_dev_config * const dw = dev->driver_data;
 	uint32_t value;
+	int ret = 0;
 
 	volatile struct i2c_dw_registers * const regs =
 		(struct i2c_dw_registers *)dw->base_address;
@@ -177,7 +423,21 @@ static inline void _i2c_dw_transfer_complete(struct device *dev)
 	regs->ic_intr_mask.raw = DW_DISABLE_ALL_I2C_INT;
 	value = regs->ic_clr_intr;
 
-	k_sem_give(&dw->device_sync_sem);
+	if (!dw->trans) {
+		return;
+	}
+
+	if (dw->state & I2C_DW_CMD_ERROR) {
+		ret = -EIO;
+	} else if (dw->xfr_len > 0) {
+		/* Something wrong if there is something left to do */
+		ret = -EIO;
+	} else if (++dw->msg < dw->trans->num_msgs) {
+		_i2c_dw_msg_start(dev);
+		return;
+	}
+
+	_i2c_dw_transaction_end(dev, ret);
 }
 
 static void i2c_dw_isr(void *arg)
@@ -293,225 +553,67 @@ done:
 }
 
 
-static int _i2c_dw_setup(struct device *dev, uint16_t slave_address)
+static int i2c_dw_transfer_async(struct device *dev,
+				 struct i2c_transaction *trans)
 {
 	struct i2c_dw_dev_config * const dw = dev->driver_data;
-	uint32_t value;
-	union ic_con_register ic_con;
-	volatile struct i2c_dw_registers * const regs =
-		(struct i2c_dw_registers *)dw->base_address;
-
-	ic_con.raw = 0;
-
-	/* Disable the device controller to be able set TAR */
-	regs->ic_enable.bits.enable = 0;
-
-	/* Disable interrupts */
-	regs->ic_intr_mask.raw = 0;
-
-	/* Clear interrupts */
-	value = regs->ic_clr_intr;
-
-	/* Set master or slave mode - (initialization = slave) */
-	if (dw->app_config.bits.is_master_device) {
-		/*
-		 * Make sure to set both the master_mode and slave_disable_bit
-		 * to both 0 or both 1
-		 */
-		SYS_LOG_DBG("I2C: host configured as Master Device");
-		ic_con.bits.master_mode = 1;
-		ic_con.bits.slave_disable = 1;
-	}
-
-	ic_con.bits.restart_en = 1;
-
-	/* Set addressing mode - (initialization = 7 bit) */
-	if (dw->app_config.bits.use_10_bit_addr) {
-		SYS_LOG_DBG("I2C: using 10-bit address");
-		ic_con.bits.addr_master_10bit = 1;
-		ic_con.bits.addr_slave_10bit = 1;
-	}
-
-	/* Setup the clock frequency and speed mode */
-	switch (dw->app_config.bits.speed) {
-	case I2C_SPEED_STANDARD:
-		SYS_LOG_DBG("I2C: speed set to STANDARD");
-		regs->ic_ss_scl_lcnt = dw->lcnt;
-		regs->ic_ss_scl_hcnt = dw->hcnt;
-		ic_con.bits.speed = I2C_DW_SPEED_STANDARD;
-
-		break;
-	case I2C_SPEED_FAST:
-		/* fall through */
-	case I2C_SPEED_FAST_PLUS:
-		SYS_LOG_DBG("I2C: speed set to FAST or FAST_PLUS");
-		regs->ic_fs_scl_lcnt = dw->lcnt;
-		regs->ic_fs_scl_hcnt = dw->hcnt;
-		ic_con.bits.speed = I2C_DW_SPEED_FAST;
-
-		break;
-	case I2C_SPEED_HIGH:
-		if (!dw->support_hs_mode) {
-			return -EINVAL;
-		}
+	unsigned int key;
 
-		SYS_LOG_DBG("I2C: speed set to HIGH");
-		regs->ic_hs_scl_lcnt = dw->lcnt;
-		regs->ic_hs_scl_hcnt = dw->hcnt;
-		ic_con.bits.speed = I2C_DW_SPEED_HIGH;
-
-		break;
-	default:
-		SYS_LOG_DBG("I2C: invalid speed requested");
+	__ASSERT_NO_MSG(trans->msgs);
+	if (!trans->num_msgs || !trans->callback) {
 		return -EINVAL;
 	}
 
-	SYS_LOG_DBG("I2C: lcnt = %d", dw->lcnt);
-	SYS_LOG_DBG("I2C: hcnt = %d", dw->hcnt);
+	key = irq_lock();
 
-	/* Set the IC_CON register */
-	regs->ic_con = ic_con;
+	sys_slist_append(&dw->queue, &trans->node);
+	_i2c_dw_queue_next(dev);
 
-	/* Set RX fifo threshold level.
-	 * Setting it to zero automatically triggers interrupt
-	 * RX_FULL whenever there is data received.
-	 *
-	 * TODO: extend the threshold for multi-byte RX.
-	 */
-	regs->ic_rx_tl = 0;
+	irq_unlock(key);
 
-	/* Set TX fifo threshold level.
-	 * TX_EMPTY interrupt is triggered only when the
-	 * TX FIFO is truly empty. So that we can let
-	 * the controller do the transfers for longer period
-	 * before we need to fill the FIFO again. This may
-	 * cause some pauses during transfers, but this keeps
-	 * the device from interrupting often.
-	 */
-	regs->ic_tx_tl = 0;
+	return 0;
+}
 
-	if (regs->ic_con.bits.master_mode) {
-		/* Set address of target slave */
-		regs->ic_tar.bits.ic_tar = slave_address;
-	} else {
-		/* Set slave address for device */
-		regs->ic_sar.bits.ic_sar = slave_address;
-	}
+struct i2c_dw_sync {
+	struct i2c_transaction trans;
+	struct k_sem sem;
+	int status;
+};
 
-	return 0;
+static void i2c_dw_sync_done(struct device *dev,
+			     struct i2c_transaction *trans, int status)
+{
+	struct i2c_dw_sync *sync = CONTAINER_OF(trans, struct i2c_dw_sync,
+						trans);
+
+	sync->status = status;
+	k_sem_give(&sync->sem);
 }
 
 static int i2c_dw_transfer(struct device *dev,
 			   struct i2c_msg *msgs, uint8_t num_msgs,
 			   uint16_t slave_address)
 {
-	struct i2c_dw_dev_config * const dw = dev->driver_data;
-	struct i2c_msg *cur_msg = msgs;
-	uint8_t msg_left = num_msgs;
-	uint8_t pflags;
-	int ret;
-
-	volatile struct i2c_dw_registers * const regs =
-		(struct i2c_dw_registers *)dw->base_address;
+	struct i2c_dw_sync sync = {
+		.trans.msgs = msgs,
+		.trans.num_msgs = num_msgs,
+		.trans.addr = slave_address,
+		.trans.callback = i2c_dw_sync_done,
+	};
 
 	__ASSERT_NO_MSG(msgs);
 	if (!num_msgs) {
 		return 0;
 	}
 
-	/* First step, check if there is current activity */
-	if ((regs->ic_status.bits.activity) || (dw->state & I2C_DW_BUSY)) {
-		return -EIO;
-	}
-
-	dw->state |= I2C_DW_BUSY;
-
-	ret = _i2c_dw_setup(dev, slave_address);
-	if (ret) {
-		dw->state = I2C_DW_STATE_READY;
-		return ret;
-	}
-
-	/* Enable controller */
-	regs->ic_enable.bits.enable = 1;
-
-	/*
-	 * While waiting at device_sync_sem, kernel can switch to idle
-	 * task which in turn can call _sys_soc_suspend() hook of Power
-	 * Management App (PMA).
-	 * device_busy_set() call here, would indicate to PMA that it should not
-	 * execute PM policies that would turn off this ip block, causing an
-	 * ongoing hw transaction to be left in an inconsistent state.
-	 * Note : This is just a sample to show a possible use of the API, it is
-	 * upto the driver expert to see, if he actually needs it here, or
-	 * somewhere else, or not needed as the driver's suspend()/resume()
-	 * can handle everything
-	 */
-	device_busy_set(dev);
-
-		/* Process all the messages */
-	while (msg_left > 0) {
-		pflags = dw->xfr_flags;
-
-		dw->xfr_buf = cur_msg->buf;
-		dw->xfr_len = cur_msg->len;
-		dw->xfr_flags = cur_msg->flags;
-		dw->rx_pending = 0;
-
-		/* Need to RESTART if changing transfer direction */
-		if ((pflags & I2C_MSG_RW_MASK)
-		    != (dw->xfr_flags & I2C_MSG_RW_MASK)) {
-			dw->xfr_flags |= I2C_MSG_RESTART;
-		}
-
-		/* Send STOP if this is the last message */
-		if (msg_left == 1) {
-			dw->xfr_flags |= I2C_MSG_STOP;
-		}
+	k_sem_init(&sync.sem, 0, 1);
 
-		dw->state &= ~(I2C_DW_CMD_SEND | I2C_DW_CMD_RECV);
+	/* Queued behind the asynchronous transactions */
+	i2c_dw_transfer_async(dev, &sync.trans);
 
-		if ((dw->xfr_flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE) {
-			dw->state |= I2C_DW_CMD_SEND;
-			dw->request_bytes = 0;
-		} else {
-			dw->state |= I2C_DW_CMD_RECV;
-			dw->request_bytes = dw->xfr_len;
-		}
-
-		/* Enable interrupts to trigger ISR */
-		if (regs->ic_con.bits.master_mode) {
-			/* Enable necessary interrupts */
-			regs->ic_intr_mask.raw = (DW_ENABLE_TX_INT_I2C_MASTER |
-						  DW_ENABLE_RX_INT_I2C_MASTER);
-		} else {
-			/* Enable necessary interrupts */
-			regs->ic_intr_mask.raw = DW_ENABLE_TX_INT_I2C_SLAVE;
-		}
-
-		/* Wait for transfer to be done */
-		k_sem_take(&dw->device_sync_sem, K_FOREVER);
-
-		if (dw->state & I2C_DW_CMD_ERROR) {
-			ret = -EIO;
-			break;
-		}
-
-		/* Something wrong if there is something left to do */
-		if (dw->xfr_len > 0) {
-			ret = -EIO;
-			break;
-		}
-
-		cur_msg++;
-		msg_left--;
-	}
-
-	device_busy_clear(dev);
-
-	dw->state = I2C_DW_STATE_READY;
+	k_sem_take(&sync.sem, K_FOREVER);
 
-	return ret;
+	return sync.status;
 }
 
 static int i2c_dw_runtime_configure(struct device *dev, uint32_t config)
@@ -622,6 +724,7 @@ static int i2c_dw_runtime_configure(struct device *dev, uint32_t config)
 static const struct i2c_driver_api funcs = {
 	.configure = i2c_dw_runtime_configure,
 	.transfer = i2c_dw_transfer,
+	.transfer_async = i2c_dw_transfer_async,
 };
 
 
@@ -662,7 +765,7 @@ static int i2c_dw_initialize(struct device *port)
 		return -EIO;
 	}
 
-	k_sem_init(&dev->device_sync_sem, 0, UINT_MAX);
+	sys_slist_init(&dev->queue);
 
 	regs = (struct i2c_dw_registers *) dev->base_address;
 
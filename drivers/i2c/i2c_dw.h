@@ -10,6 +10,7 @@
 
 #include <i2c.h>
 #include <stdbool.h>
+#include <misc/slist.h>
 
 #ifdef CONFIG_PCI
 #include <pci/pci.h>
@@ -97,7 +98,10 @@ struct i2c_dw_rom_config {
 
 struct i2c_dw_dev_config {
 	uint32_t base_address;
-	struct k_sem		device_sync_sem;
+	/* Queued transactions, and the one in progress */
+	sys_slist_t		queue;
+	struct i2c_transaction	*trans;
+	uint8_t			msg;	/* message in progress */
 	union dev_config	app_config;
 
 
@@ -39,6 +39,9 @@ struct i2c_qmsi_driver_data {
 	uint32_t device_power_state;
 	qm_i2c_context_t i2c_ctx;
 #endif
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+	struct device_runtime_pm runtime_pm;
+#endif
 };
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
@@ -62,10 +65,14 @@ static int i2c_suspend_device(struct device *dev)
 		return -EBUSY;
 	}
 
+	const struct i2c_qmsi_config_info *config = dev->config->config_info;
 	struct i2c_qmsi_driver_data *drv_data = GET_DRIVER_DATA(dev);
 
 	qm_i2c_save_context(GET_CONTROLLER_INSTANCE(dev), &drv_data->i2c_ctx);
 
+	/* Saved, the controller is not clocked until resumed */
+	clk_periph_disable(config->clock_gate);
+
 	i2c_qmsi_set_power_state(dev, DEVICE_PM_SUSPEND_STATE);
 
 	return 0;
@@ -73,8 +80,11 @@ static int i2c_suspend_device(struct device *dev)
 
 static int i2c_resume_device_from_suspend(struct device *dev)
 {
+	const struct i2c_qmsi_config_info *config = dev->config->config_info;
 	struct i2c_qmsi_driver_data *drv_data = GET_DRIVER_DATA(dev);
 
+	clk_periph_enable(config->clock_gate);
+
 	qm_i2c_restore_context(GET_CONTROLLER_INSTANCE(dev),
 			       &drv_data->i2c_ctx);
 
@@ -303,5 +313,10 @@ static int i2c_qmsi_init(struct device *dev)
 
 	i2c_qmsi_set_power_state(dev, DEVICE_PM_ACTIVE_STATE);
 
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+	device_runtime_pm_enable(dev, &driver_data->runtime_pm,
+				 CONFIG_DEVICE_RUNTIME_PM_AUTOSUSPEND_MS);
+#endif
+
 	return 0;
 }
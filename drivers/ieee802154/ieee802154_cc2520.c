@@ -558,10 +558,13 @@ static inline bool verify_crc(struct cc2520_context *cc2520)
 	return true;
 }
 
+/* Other frames may follow the one being read, the FIFO is only required to
+ * hold it fully.
+ */
 static inline bool verify_rxfifo_validity(struct cc2520_spi *spi,
 					  uint8_t pkt_len)
 {
-	if (pkt_len < 2 || read_reg_rxfifocnt(spi) != pkt_len) {
+	if (pkt_len < 2 || read_reg_rxfifocnt(spi) < pkt_len) {
 		return false;
 	}
 
@@ -579,39 +582,51 @@ static void cc2520_rx(int arg)
 	while (1) {
 		buf = NULL;
 
-		k_sem_take(&cc2520->rx_lock, K_FOREVER);
+		/* FIFOP stays up while a complete frame is in the FIFO, the
+		 * ones received during the previous frame have no edge of
+		 * their own and are read right away.
+		 */
+		if (!get_fifop(cc2520)) {
+			k_sem_take(&cc2520->rx_lock, K_FOREVER);
+		}
 
-		if (cc2520->overflow) {
+		/* Without an edge, the overflow is seen from the pins only */
+		if (cc2520->overflow ||
+		    (get_fifop(cc2520) && !get_fifo(cc2520))) {
 			SYS_LOG_ERR("RX overflow!");
 			cc2520->overflow = false;
 
 			goto flush;
 		}
 
+		/* Frame already read along with a previous one. Note: Errata
+		 * document - 1.2
+		 */
+		if (!get_fifop(cc2520) && !get_fifop(cc2520)) {
+			continue;
+		}
+
 		pkt_len = read_rxfifo_length(&cc2520->spi) & 0x7f;
 		if (!verify_rxfifo_validity(&cc2520->spi, pkt_len)) {
 			SYS_LOG_ERR("Invalid content");
 			goto flush;
 		}
 
-		buf = net_nbuf_get_reserve_rx(0, K_NO_WAIT);
-		if (!buf) {
-			SYS_LOG_ERR("No buf available");
-			goto flush;
-		}
+		/* The frames stay in the FIFO while waiting for the stack to
+		 * free some buffers. Once it overflows, the frames are no
+		 * longer acknowledged and the senders retry later instead of
+		 * having the whole FIFO flushed here.
+		 */
+		buf = net_nbuf_get_reserve_rx(0, K_FOREVER);
 
 #if defined(CONFIG_IEEE802154_CC2520_RAW)
 		/**
 		 * Reserve 1 byte for length
 		 */
-		pkt_buf = net_nbuf_get_reserve_data(1, K_NO_WAIT);
+		pkt_buf = net_nbuf_get_reserve_data(1, K_FOREVER);
 #else
-		pkt_buf = net_nbuf_get_reserve_data(0, K_NO_WAIT);
+		pkt_buf = net_nbuf_get_reserve_data(0, K_FOREVER);
 #endif
-		if (!pkt_buf) {
-			SYS_LOG_ERR("No pkt_buf available");
-			goto flush;
-		}
 
 		net_buf_frag_insert(buf, pkt_buf);
 
@@ -916,6 +931,14 @@ static uint8_t cc2520_get_lqi(struct device *dev)
 	return cc2520->lqi;
 }
 
+static enum ieee802154_hw_caps cc2520_get_capabilities(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	/* TX is done through STXONCCA, hence only on a clear channel */
+	return IEEE802154_HW_AUTO_ACK | IEEE802154_HW_CSMA;
+}
+
 /******************
  * Initialization *
  *****************/
@@ -1079,6 +1102,7 @@ static struct ieee802154_radio_api cc2520_radio_api = {
 	.stop		= cc2520_stop,
 	.tx		= cc2520_tx,
 	.get_lqi	= cc2520_get_lqi,
+	.get_capabilities = cc2520_get_capabilities,
 };
 
 #if defined(CONFIG_IEEE802154_CC2520_RAW)
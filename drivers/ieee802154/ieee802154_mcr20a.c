@@ -1217,6 +1217,21 @@ static uint8_t mcr20a_get_lqi(struct device *dev)
 	return mcr20a->lqi;
 }
 
+static enum ieee802154_hw_caps mcr20a_get_capabilities(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	/* CCA before TX is always enabled, and the TR sequence
+	 * fails if no ACK is received in time.
+	 */
+	if (MCR20A_AUTOACK_ENABLED) {
+		return IEEE802154_HW_AUTO_ACK | IEEE802154_HW_CSMA |
+		       IEEE802154_HW_TX_RX_ACK;
+	}
+
+	return IEEE802154_HW_CSMA;
+}
+
 static int mcr20a_update_overwrites(struct mcr20a_context *dev)
 {
 	struct mcr20a_spi *spi = &dev->spi;
@@ -1448,6 +1463,7 @@ static struct ieee802154_radio_api mcr20a_radio_api = {
 	.stop		= mcr20a_stop,
 	.tx		= mcr20a_tx,
 	.get_lqi	= mcr20a_get_lqi,
+	.get_capabilities = mcr20a_get_capabilities,
 };
 
 #if defined(CONFIG_IEEE802154_MCR20A_RAW)
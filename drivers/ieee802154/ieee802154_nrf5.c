@@ -55,6 +55,7 @@ static void nrf5_rx_thread(void *arg1, void *arg2, void *arg3)
 {
 	struct device *dev = (struct device *)arg1;
 	struct nrf5_802154_data *nrf5_radio = NRF5_802154_DATA(dev);
+	struct nrf5_802154_rx_frame *frame;
 	struct net_buf *pkt_buf = NULL;
 	enum net_verdict ack_result;
 	struct net_buf *buf;
@@ -69,32 +70,35 @@ static void nrf5_rx_thread(void *arg1, void *arg2, void *arg3)
 		SYS_LOG_DBG("Waiting for frame");
 		k_sem_take(&nrf5_radio->rx_wait, K_FOREVER);
 
-		SYS_LOG_DBG("Frame received");
+		frame = &nrf5_radio->rx_frames[nrf5_radio->rx_tail];
+		nrf5_radio->rx_tail = (nrf5_radio->rx_tail + 1) %
+				      ARRAY_SIZE(nrf5_radio->rx_frames);
 
-		buf = net_nbuf_get_reserve_rx(0, K_NO_WAIT);
-		if (!buf) {
-			SYS_LOG_ERR("No buf available");
-			goto out;
-		}
+		SYS_LOG_DBG("Frame received");
 
-		pkt_buf = net_nbuf_get_reserve_data(0, K_NO_WAIT);
-		if (!pkt_buf) {
-			SYS_LOG_ERR("No pkt_buf available");
-			goto out;
-		}
+		/* The frame stays in the nRF driver buffer while waiting for
+		 * the stack to free some. Once all of them are held, the radio
+		 * stops receiving and acknowledging, and the senders retry
+		 * later instead of having their frames dropped here.
+		 */
+		buf = net_nbuf_get_reserve_rx(0, K_FOREVER);
+		pkt_buf = net_nbuf_get_reserve_data(0, K_FOREVER);
 
 		net_buf_frag_insert(buf, pkt_buf);
 
 		/* rx_mpdu contains length, psdu, [fcs], lqi
 		 * FCS filed (2 bytes) is not present if CRC is enabled
 		 */
-		pkt_len = nrf5_radio->rx_psdu[0] -  NRF5_FCS_LENGTH;
+		pkt_len = frame->psdu[0] -  NRF5_FCS_LENGTH;
 
 		/* Skip length (first byte) and copy the payload */
-		memcpy(pkt_buf->data, nrf5_radio->rx_psdu + 1, pkt_len);
+		memcpy(pkt_buf->data, frame->psdu + 1, pkt_len);
 		net_buf_add(pkt_buf, pkt_len);
 
-		nrf_drv_radio802154_buffer_free(nrf5_radio->rx_psdu);
+		nrf5_radio->lqi = frame->lqi;
+		nrf5_radio->rssi = frame->rssi;
+
+		nrf_drv_radio802154_buffer_free(frame->psdu);
 
 		ack_result = ieee802154_radio_handle_ack(nrf5_radio->iface,
 							 buf);
@@ -287,6 +291,17 @@ static uint8_t nrf5_get_lqi(struct device *dev)
 	return nrf5_radio->lqi;
 }
 
+static enum ieee802154_hw_caps nrf5_get_capabilities(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	/* The nRF driver performs CCA right before transmitting, and only
+	 * reports a frame as transmitted once its ACK has been received.
+	 */
+	return IEEE802154_HW_AUTO_ACK | IEEE802154_HW_CSMA |
+	       IEEE802154_HW_TX_RX_ACK;
+}
+
 static void nrf5_radio_irq(void *arg)
 {
 	ARG_UNUSED(arg);
@@ -308,7 +323,8 @@ static int nrf5_init(struct device *dev)
 	struct nrf5_802154_data *nrf5_radio = NRF5_802154_DATA(dev);
 	struct device *clk_m16;
 
-	k_sem_init(&nrf5_radio->rx_wait, 0, 1);
+	k_sem_init(&nrf5_radio->rx_wait, 0,
+		   ARRAY_SIZE(nrf5_radio->rx_frames));
 	k_sem_init(&nrf5_radio->tx_wait, 0, 1);
 	k_sem_init(&nrf5_radio->cca_wait, 0, 1);
 
@@ -355,9 +371,15 @@ static void nrf5_iface_init(struct net_if *iface)
 
 void nrf_drv_radio802154_received(uint8_t *p_data, int8_t power, int8_t lqi)
 {
-	nrf5_data.rx_psdu = p_data;
-	nrf5_data.rssi = power;
-	nrf5_data.lqi = lqi;
+	struct nrf5_802154_rx_frame *frame =
+		&nrf5_data.rx_frames[nrf5_data.rx_head];
+
+	frame->psdu = p_data;
+	frame->rssi = power;
+	frame->lqi = lqi;
+
+	nrf5_data.rx_head = (nrf5_data.rx_head + 1) %
+			    ARRAY_SIZE(nrf5_data.rx_frames);
 
 	k_sem_give(&nrf5_data.rx_wait);
 }
@@ -399,6 +421,7 @@ static struct ieee802154_radio_api nrf5_radio_api = {
 	.stop = nrf5_stop,
 	.tx = nrf5_tx,
 	.get_lqi = nrf5_get_lqi,
+	.get_capabilities = nrf5_get_capabilities,
 };
 
 NET_DEVICE_INIT(nrf5_154_radio, CONFIG_IEEE802154_NRF5_DRV_NAME,
@@ -14,12 +14,29 @@
 #define NRF5_FCS_LENGTH   (2)
 #define NRF5_PSDU_LENGTH  (125)
 #define NRF5_PHR_LENGTH   (1)
+#define NRF5_RX_BUFFERS   (CONFIG_IEEE802154_NRF5_RX_BUFFERS)
+
+/* Frame received by the nRF driver, its buffer is held until freed. */
+struct nrf5_802154_rx_frame {
+	/* Pointer to the received frame, in the nRF driver buffer. */
+	uint8_t *psdu;
+	/* Received frame RSSI value. */
+	int8_t rssi;
+	/* Received frame LQI value. */
+	uint8_t lqi;
+};
 
 struct nrf5_802154_data {
 	/* Pointer to the network interface. */
 	struct net_if *iface;
-	/* Pointer to a received frame. */
-	uint8_t *rx_psdu;
+	/* Received frames, in order, waiting for the RX thread. There is at
+	 * most one per buffer of the nRF driver.
+	 */
+	struct nrf5_802154_rx_frame rx_frames[NRF5_RX_BUFFERS];
+	/* Next slot of rx_frames filled by the nRF driver. */
+	uint8_t rx_head;
+	/* Next slot of rx_frames handled by the RX thread. */
+	uint8_t rx_tail;
 	/* TX buffer. First byte is PHR (length), remaining bytes are
 	 * MPDU data.
 	 */
@@ -31,8 +48,8 @@ struct nrf5_802154_data {
 
 	/* CCA complete sempahore. Unlocked when CCA is complete. */
 	struct k_sem cca_wait;
-	/* RX synchronization semaphore. Unlocked when frame has been
-	 * received.
+	/* RX synchronization semaphore. Given for each frame received,
+	 * counts the frames in rx_frames.
 	 */
 	struct k_sem rx_wait;
 	/* TX synchronization semaphore. Unlocked when frame has been
@@ -50,9 +67,9 @@ struct nrf5_802154_data {
 	/* 802.15.4 channel to be used when sending a frame. */
 	uint8_t channel;
 
-	/* Last received frame LQI value. */
+	/* Last handled frame LQI value. */
 	uint8_t lqi;
-	/* Last received frame RSSI value. */
+	/* Last handled frame RSSI value. */
 	int8_t rssi;
 };
 
@@ -18,6 +18,7 @@
 #include <init.h>
 #include <net/net_if.h>
 #include <net/nbuf.h>
+#include <misc/crc.h>
 
 #include <console/uart_pipe.h>
 #include <net/ieee802154_radio.h>
@@ -169,6 +170,7 @@ static int upipe_tx(struct device *dev,
 	uint8_t *pkt_buf = frag->data - net_nbuf_ll_reserve(buf);
 	uint8_t len = net_nbuf_ll_reserve(buf) + frag->len;
 	struct upipe_context *upipe = dev->driver_data;
+	uint16_t fcs;
 	uint8_t i, data;
 
 	SYS_LOG_DBG("%p (%u)", frag, len);
@@ -187,9 +189,11 @@ static int upipe_tx(struct device *dev,
 		uart_pipe_send(pkt_buf+i, 1);
 	}
 
-	/* The 2 dummy bytes representing FCS */
-	data = 0xFF;
+	fcs = crc16_ccitt(0, pkt_buf, len);
+
+	data = fcs & 0xFF;
 	uart_pipe_send(&data, 1);
+	data = fcs >> 8;
 	uart_pipe_send(&data, 1);
 
 	return 0;
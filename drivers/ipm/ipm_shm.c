@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+
+#include <kernel.h>
+#include <ipm.h>
+#include <ipm_shm.h>
+
+/* Busy only means the other core has not taken the previous doorbell yet,
+ * it goes through the rings once it does.
+ */
+static void ipm_shm_ring_bell(struct ipm_shm *shm)
+{
+	ipm_send(shm->ipm_tx, 0, 0, NULL, 0);
+}
+
+/* Hands the buffers given back by the other core to the user */
+static void ipm_shm_tx_done(struct ipm_shm *shm)
+{
+	uint32_t tail = atomic_get(&shm->tx->tail);
+	void *user_data;
+
+	while (shm->tx_done != tail) {
+		user_data = shm->tx_user_data[shm->tx_done & IPM_SHM_RING_MASK];
+		shm->tx_done++;
+		shm->sent(shm, user_data);
+	}
+}
+
+/* Hands the buffers posted by the other core to the user, returns true if
+ * any were given back.
+ */
+static bool ipm_shm_rx(struct ipm_shm *shm)
+{
+	struct ipm_shm_ring *rx = shm->rx;
+	uint32_t tail = atomic_get(&rx->tail);
+	struct ipm_shm_desc *desc;
+	bool done = false;
+
+	do {
+		atomic_set(&rx->notify, 0);
+
+		while (tail != atomic_get(&rx->head)) {
+			desc = &rx->desc[tail & IPM_SHM_RING_MASK];
+			shm->recv(shm, (void *)desc->data, desc->len,
+				  desc->id);
+			atomic_set(&rx->tail, ++tail);
+			done = true;
+		}
+
+		/* Buffers posted before the flag was set are not rung for */
+		atomic_set(&rx->notify, 1);
+	} while (tail != atomic_get(&rx->head));
+
+	return done;
+}
+
+static void ipm_shm_work(struct k_work *work)
+{
+	struct ipm_shm *shm = CONTAINER_OF(work, struct ipm_shm, work);
+
+	ipm_shm_tx_done(shm);
+
+	/* A doorbell per batch for the other core to reuse the buffers */
+	if (ipm_shm_rx(shm)) {
+		ipm_shm_ring_bell(shm);
+	}
+}
+
+static void ipm_shm_callback(void *context, uint32_t id, volatile void *data)
+{
+	struct ipm_shm *shm = context;
+
+	ARG_UNUSED(id);
+	ARG_UNUSED(data);
+
+	k_work_submit(&shm->work);
+}
+
+int ipm_shm_init(struct ipm_shm *shm)
+{
+	if (!shm->ipm_tx || !shm->ipm_rx || !shm->recv || !shm->sent) {
+		return -EINVAL;
+	}
+
+	atomic_set(&shm->tx->head, 0);
+	atomic_set(&shm->tx->tail, 0);
+	atomic_set(&shm->tx->notify, 1);
+	shm->tx_done = 0;
+
+	k_work_init(&shm->work, ipm_shm_work);
+
+	ipm_register_callback(shm->ipm_rx, ipm_shm_callback, shm);
+
+	return ipm_set_enabled(shm->ipm_rx, 1);
+}
+
+int ipm_shm_send(struct ipm_shm *shm, void *data, uint16_t len, uint16_t id,
+		 void *user_data)
+{
+	struct ipm_shm_ring *tx = shm->tx;
+	struct ipm_shm_desc *desc;
+	unsigned int key;
+	uint32_t head;
+
+	key = irq_lock();
+
+	head = atomic_get(&tx->head);
+	if (head - shm->tx_done == CONFIG_IPM_SHM_RING_SIZE) {
+		irq_unlock(key);
+		return -ENOMEM;
+	}
+
+	desc = &tx->desc[head & IPM_SHM_RING_MASK];
+	desc->data = (uint32_t)data;
+	desc->len = len;
+	desc->id = id;
+	shm->tx_user_data[head & IPM_SHM_RING_MASK] = user_data;
+
+	/* The descriptor is written before it is posted */
+	atomic_set(&tx->head, head + 1);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+void ipm_shm_notify(struct ipm_shm *shm)
+{
+	if (atomic_get(&shm->tx->notify)) {
+		ipm_shm_ring_bell(shm);
+	}
+}
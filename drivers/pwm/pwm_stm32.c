@@ -5,12 +5,16 @@
  */
 
 #include <errno.h>
+#include <string.h>
 
 #include <board.h>
 #include <pwm.h>
 #include <device.h>
 #include <kernel.h>
 #include <init.h>
+#ifdef CONFIG_PWM_STM32_SEQ
+#include <dma.h>
+#endif
 
 #include <clock_control/stm32_clock_control.h>
 
@@ -218,9 +222,167 @@ static int pwm_stm32_get_cycles_per_sec(struct device *dev, uint32_t pwm,
 	return 0;
 }
 
+#ifdef CONFIG_PWM_STM32_SEQ
+static void pwm_stm32_seq_end(struct device *dev)
+{
+	struct pwm_stm32_data *data = DEV_DATA(dev);
+
+	PWM_STRUCT(dev)->DIER &= ~TIM_DIER_UDE;
+	data->seq_busy = false;
+}
+
+/*
+ * Called from the DMA callback of the instance, once the last pulse width
+ * is written to the preload register.
+ */
+static void pwm_stm32_seq_done(struct device *dev, int error_code)
+{
+	struct pwm_stm32_data *data = DEV_DATA(dev);
+
+	pwm_stm32_seq_end(dev);
+
+	if (data->seq_cb) {
+		data->seq_cb(dev, data->seq_pwm, error_code);
+	}
+}
+
+/*
+ * Output a sequence of pulse widths on a PWM pin.
+ *
+ * The timer update event requests the DMA stream to write the next pulse
+ * width to the preload register of the channel, which the next update
+ * event loads. The output keeps the last pulse width once done.
+ *
+ * Parameters
+ * dev: Pointer to PWM device structure
+ * pwm: PWM channel to set
+ * period_cycles: Period (in timer count), 16 bits
+ * pulse_cycles: Pulse widths (in timer count), one per period
+ * count: Number of pulse widths
+ * cb: Called from the DMA interrupt once done
+ *
+ * return 0, or negative errno code
+ */
+static int pwm_stm32_pin_set_seq(struct device *dev, uint32_t pwm,
+				 uint32_t period_cycles,
+				 const uint16_t *pulse_cycles, size_t count,
+				 pwm_seq_callback_t cb)
+{
+	const struct pwm_stm32_config *cfg = DEV_CFG(dev);
+	struct pwm_stm32_data *data = DEV_DATA(dev);
+	TIM_TypeDef *tim = PWM_STRUCT(dev);
+	struct dma_config dma_cfg = { 0 };
+	int ret;
+
+	if (!count) {
+		return -EINVAL;
+	}
+
+	/* The pulse widths are written as half words */
+	if (period_cycles > 0xFFFF) {
+		return -ENOTSUP;
+	}
+
+	if (data->seq_busy) {
+		return -EBUSY;
+	}
+
+	if (!data->dma) {
+		data->dma = device_get_binding(cfg->dma_name);
+		if (!data->dma) {
+			return -ENODEV;
+		}
+	}
+
+	/* HAL errors are positive */
+	ret = pwm_stm32_pin_set(dev, pwm, period_cycles, pulse_cycles[0]);
+	if (ret) {
+		return ret < 0 ? ret : -EIO;
+	}
+
+	if (count == 1) {
+		if (cb) {
+			cb(dev, pwm, 0);
+		}
+
+		return 0;
+	}
+
+	/* Held until the stream is set up, the first pulse lasting exactly
+	 * one period
+	 */
+	tim->CR1 &= ~TIM_CR1_CEN;
+	tim->CNT = 0;
+
+	memset(&data->dma_block, 0, sizeof(data->dma_block));
+	data->dma_block.source_address = (uint32_t)&pulse_cycles[1];
+	data->dma_block.dest_address = (uint32_t)(&tim->CCR1 + (pwm - 1));
+	data->dma_block.block_size = (count - 1) * sizeof(uint16_t);
+	/* Left unchanged */
+	data->dma_block.dest_addr_adj = 2;
+
+	dma_cfg.dma_slot = cfg->dma_slot;
+	dma_cfg.channel_direction = MEMORY_TO_PERIPHERAL;
+	dma_cfg.channel_priority = 3;
+	dma_cfg.source_data_size = sizeof(uint16_t);
+	dma_cfg.dest_data_size = sizeof(uint16_t);
+	dma_cfg.source_burst_length = 1;
+	dma_cfg.dest_burst_length = 1;
+	dma_cfg.block_count = 1;
+	dma_cfg.head_block = &data->dma_block;
+	dma_cfg.dma_callback = cfg->dma_callback;
+
+	ret = dma_config(data->dma, cfg->dma_stream, &dma_cfg);
+	if (ret) {
+		goto restart;
+	}
+
+	data->seq_cb = cb;
+	data->seq_pwm = pwm;
+	data->seq_busy = true;
+
+	ret = dma_start(data->dma, cfg->dma_stream);
+	if (ret) {
+		data->seq_busy = false;
+		goto restart;
+	}
+
+	/* The update generated loads the first pulse width, still in the
+	 * preload register, and requests the second one
+	 */
+	tim->DIER |= TIM_DIER_UDE;
+	tim->EGR = TIM_EGR_UG;
+
+restart:
+	tim->CR1 |= TIM_CR1_CEN;
+
+	return ret;
+}
+
+static int pwm_stm32_pin_stop_seq(struct device *dev, uint32_t pwm)
+{
+	const struct pwm_stm32_config *cfg = DEV_CFG(dev);
+	struct pwm_stm32_data *data = DEV_DATA(dev);
+	int ret;
+
+	if (!data->seq_busy || data->seq_pwm != pwm) {
+		return 0;
+	}
+
+	ret = dma_stop(data->dma, cfg->dma_stream);
+	pwm_stm32_seq_end(dev);
+
+	return ret;
+}
+#endif /* CONFIG_PWM_STM32_SEQ */
+
 static const struct pwm_driver_api pwm_stm32_drv_api_funcs = {
 	.pin_set = pwm_stm32_pin_set,
 	.get_cycles_per_sec = pwm_stm32_get_cycles_per_sec,
+#ifdef CONFIG_PWM_STM32_SEQ
+	.pin_set_seq = pwm_stm32_pin_set_seq,
+	.pin_stop_seq = pwm_stm32_pin_stop_seq,
+#endif
 };
 
 
@@ -256,6 +418,16 @@ static int pwm_stm32_init(struct device *dev)
 
 
 #ifdef CONFIG_PWM_STM32_1
+#ifdef CONFIG_PWM_STM32_SEQ
+static struct device DEVICE_NAME_GET(pwm_stm32_1);
+
+static void pwm_stm32_dma_callback_1(struct device *dev, uint32_t channel,
+				      int error_code)
+{
+	pwm_stm32_seq_done(DEVICE_GET(pwm_stm32_1), error_code);
+}
+#endif /* CONFIG_PWM_STM32_SEQ */
+
 static struct pwm_stm32_data pwm_stm32_dev_data_1 = {
 	/* Default case */
 	.pwm_prescaler = 10000,
@@ -274,6 +446,12 @@ static const struct pwm_stm32_config pwm_stm32_dev_cfg_1 = {
 	.clock_subsys = UINT_TO_POINTER(CLOCK_SUBSYS_TIM1),
 #endif	/* CONFIG_SOC_SERIES_STM32F4X */
 #endif /* CONFIG_CLOCK_CONTROL_STM32_CUBE */
+#ifdef CONFIG_PWM_STM32_SEQ
+	.dma_name = CONFIG_PWM_STM32_1_DMA_NAME,
+	.dma_stream = CONFIG_PWM_STM32_1_DMA_STREAM,
+	.dma_slot = CONFIG_PWM_STM32_1_DMA_SLOT,
+	.dma_callback = pwm_stm32_dma_callback_1,
+#endif /* CONFIG_PWM_STM32_SEQ */
 };
 
 DEVICE_AND_API_INIT(pwm_stm32_1, CONFIG_PWM_STM32_1_DEV_NAME,
@@ -285,6 +463,16 @@ DEVICE_AND_API_INIT(pwm_stm32_1, CONFIG_PWM_STM32_1_DEV_NAME,
 
 
 #ifdef CONFIG_PWM_STM32_2
+#ifdef CONFIG_PWM_STM32_SEQ
+static struct device DEVICE_NAME_GET(pwm_stm32_2);
+
+static void pwm_stm32_dma_callback_2(struct device *dev, uint32_t channel,
+				      int error_code)
+{
+	pwm_stm32_seq_done(DEVICE_GET(pwm_stm32_2), error_code);
+}
+#endif /* CONFIG_PWM_STM32_SEQ */
+
 static struct pwm_stm32_data pwm_stm32_dev_data_2 = {
 	/* Default case */
 	.pwm_prescaler = 0,
@@ -303,6 +491,12 @@ static const struct pwm_stm32_config pwm_stm32_dev_cfg_2 = {
 	.clock_subsys = UINT_TO_POINTER(CLOCK_SUBSYS_TIM2),
 #endif	/* CONFIG_SOC_SERIES_STM32F4X */
 #endif /* CONFIG_CLOCK_CONTROL_STM32_CUBE */
+#ifdef CONFIG_PWM_STM32_SEQ
+	.dma_name = CONFIG_PWM_STM32_2_DMA_NAME,
+	.dma_stream = CONFIG_PWM_STM32_2_DMA_STREAM,
+	.dma_slot = CONFIG_PWM_STM32_2_DMA_SLOT,
+	.dma_callback = pwm_stm32_dma_callback_2,
+#endif /* CONFIG_PWM_STM32_SEQ */
 };
 
 DEVICE_AND_API_INIT(pwm_stm32_2, CONFIG_PWM_STM32_2_DEV_NAME,
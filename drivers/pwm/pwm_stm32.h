@@ -28,6 +28,14 @@ struct pwm_stm32_config {
 	struct stm32f4x_pclken pclken;
 #endif
 #endif /* CONFIG_CLOCK_CONTROL_STM32_CUBE */
+#ifdef CONFIG_PWM_STM32_SEQ
+	/* DMA stream triggered by the timer update event */
+	const char *dma_name;
+	uint32_t dma_stream;
+	uint32_t dma_slot;
+	void (*dma_callback)(struct device *dev, uint32_t channel,
+			     int error_code);
+#endif /* CONFIG_PWM_STM32_SEQ */
 };
 
 /** Runtime driver data */
@@ -41,6 +49,14 @@ struct pwm_stm32_data {
 	uint32_t pwm_prescaler;
 	/* clock device */
 	struct device *clock;
+#ifdef CONFIG_PWM_STM32_SEQ
+	/* DMA device, bound by the first sequence */
+	struct device *dma;
+	struct dma_block_config dma_block;
+	pwm_seq_callback_t seq_cb;
+	uint32_t seq_pwm;
+	bool seq_busy;
+#endif /* CONFIG_PWM_STM32_SEQ */
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Random numbers from a CSPRNG seeded by the random driver
+ *
+ * sys_rand32_get() is served from a buffer of AES-CTR DRBG output, refilled
+ * a buffer at a time, so it never waits for the random driver and can be
+ * called from ISRs. The driver only provides the entropy to seed the DRBG,
+ * at boot then periodically from a work item, out of the way of the callers.
+ */
+
+#include <kernel.h>
+#include <device.h>
+#include <init.h>
+#include <string.h>
+#include <random.h>
+#include <drivers/rand32.h>
+#include <tinycrypt/ctr_prng.h>
+#include <tinycrypt/constants.h>
+
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_RANDOM_LEVEL
+#include <logging/sys_log.h>
+
+/* Entropy used by each seeding, the seed length of the DRBG */
+#define RAND_POOL_SEED_LEN	(TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE)
+
+static TCCtrPrng_t rand_pool_prng;
+static uint8_t rand_pool_buf[CONFIG_RANDOM_POOL_BUF_LEN];
+/* Bytes of rand_pool_buf not handed out yet */
+static size_t rand_pool_len;
+
+static struct device *rand_pool_dev;
+static struct k_delayed_work rand_pool_work;
+
+static void rand_pool_refill(void)
+{
+	int32_t ret;
+
+	ret = tc_ctr_prng_generate(&rand_pool_prng, NULL, 0, rand_pool_buf,
+				   sizeof(rand_pool_buf));
+	__ASSERT(ret == TC_CRYPTO_SUCCESS, "DRBG generate failed (%d)", ret);
+
+	rand_pool_len = sizeof(rand_pool_buf);
+}
+
+uint32_t sys_rand32_get(void)
+{
+	unsigned int key;
+	uint32_t val;
+
+	key = irq_lock();
+
+	if (rand_pool_len < sizeof(val)) {
+		rand_pool_refill();
+	}
+
+	/* Values handed out are not kept around */
+	rand_pool_len -= sizeof(val);
+	memcpy(&val, rand_pool_buf + rand_pool_len, sizeof(val));
+	memset(rand_pool_buf + rand_pool_len, 0, sizeof(val));
+
+	irq_unlock(key);
+
+	return val;
+}
+
+static void rand_pool_reseed(struct k_work *work)
+{
+	uint8_t seed[RAND_POOL_SEED_LEN];
+	unsigned int key;
+
+	ARG_UNUSED(work);
+
+	/* Slow back ends are only waited for here, with interrupts enabled */
+	if (random_get_entropy(rand_pool_dev, seed, sizeof(seed))) {
+		SYS_LOG_ERR("Failed to get entropy");
+	} else {
+		key = irq_lock();
+		tc_ctr_prng_reseed(&rand_pool_prng, seed, sizeof(seed),
+				   NULL, 0);
+		/* Nothing generated before the reseed is handed out */
+		rand_pool_len = 0;
+		irq_unlock(key);
+	}
+
+	memset(seed, 0, sizeof(seed));
+
+	k_delayed_work_submit(&rand_pool_work,
+			      CONFIG_RANDOM_POOL_RESEED_INTERVAL);
+}
+
+static int rand_pool_init(struct device *dev)
+{
+	uint8_t seed[RAND_POOL_SEED_LEN];
+	int ret;
+
+	ARG_UNUSED(dev);
+
+	rand_pool_dev = device_get_binding(CONFIG_RANDOM_NAME);
+	if (!rand_pool_dev) {
+		return -ENODEV;
+	}
+
+	ret = random_get_entropy(rand_pool_dev, seed, sizeof(seed));
+	if (ret) {
+		return ret;
+	}
+
+	if (tc_ctr_prng_init(&rand_pool_prng, seed, sizeof(seed), NULL,
+			     0) != TC_CRYPTO_SUCCESS) {
+		return -EIO;
+	}
+
+	memset(seed, 0, sizeof(seed));
+
+	return 0;
+}
+
+/* Seeded before the stack canaries are set up */
+SYS_INIT(rand_pool_init, PRE_KERNEL_2, CONFIG_RANDOM_POOL_INIT_PRIORITY);
+
+static int rand_pool_reseed_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_delayed_work_init(&rand_pool_work, rand_pool_reseed);
+	k_delayed_work_submit(&rand_pool_work,
+			      CONFIG_RANDOM_POOL_RESEED_INTERVAL);
+
+	return 0;
+}
+
+SYS_INIT(rand_pool_reseed_init, APPLICATION,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
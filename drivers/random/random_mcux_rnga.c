@@ -80,6 +80,7 @@ static int random_mcux_rnga_init(struct device *dev)
 	return 0;
 }
 
+#ifndef CONFIG_RANDOM_POOL
 uint32_t sys_rand32_get(void)
 {
 	uint32_t output;
@@ -91,3 +92,4 @@ uint32_t sys_rand32_get(void)
 
 	return output;
 }
+#endif /* CONFIG_RANDOM_POOL */
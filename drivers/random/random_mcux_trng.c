@@ -51,6 +51,7 @@ static int random_mcux_trng_init(struct device *dev)
 	return 0;
 }
 
+#ifndef CONFIG_RANDOM_POOL
 uint32_t sys_rand32_get(void)
 {
 	uint32_t output;
@@ -62,3 +63,4 @@ uint32_t sys_rand32_get(void)
 
 	return output;
 }
+#endif /* CONFIG_RANDOM_POOL */
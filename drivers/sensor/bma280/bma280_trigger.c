@@ -63,7 +63,7 @@ static void bma280_gpio_callback(struct device *dev,
 #if defined(CONFIG_BMA280_TRIGGER_OWN_THREAD)
 	k_sem_give(&drv_data->gpio_sem);
 #elif defined(CONFIG_BMA280_TRIGGER_GLOBAL_THREAD)
-	k_work_submit(&drv_data->work);
+	sensor_work_submit(&drv_data->work);
 #endif
 }
 
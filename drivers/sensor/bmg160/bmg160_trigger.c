@@ -27,7 +27,7 @@ static void bmg160_gpio_callback(struct device *port, struct gpio_callback *cb,
 #if defined(CONFIG_BMG160_TRIGGER_OWN_THREAD)
 	k_sem_give(&bmg160->trig_sem);
 #elif defined(CONFIG_BMG160_TRIGGER_GLOBAL_THREAD)
-	k_work_submit(&bmg160->work);
+	sensor_work_submit(&bmg160->work);
 #endif
 }
 
@@ -20,8 +20,8 @@
 struct bmi160_device_data bmi160_data;
 
 static int bmi160_transceive(struct device *dev, uint8_t *tx_buf,
-			     uint8_t tx_buf_len, uint8_t *rx_buf,
-			     uint8_t rx_buf_len)
+			     uint32_t tx_buf_len, uint8_t *rx_buf,
+			     uint32_t rx_buf_len)
 {
 	const struct bmi160_device_config *dev_cfg = dev->config->config_info;
 	struct bmi160_device_data *bmi160 = dev->driver_data;
@@ -609,10 +609,73 @@ static int bmi160_gyr_config(struct device *dev, enum sensor_channel chan,
 }
 #endif /* !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND) */
 
+#ifdef CONFIG_BMI160_FIFO
+/* hardware cycles between two samples, for an ODR of 100 * 2^(odr - 8) Hz */
+static uint32_t bmi160_odr_to_period(uint8_t odr)
+{
+	if (odr >= BMI160_ODR_100) {
+		return sys_clock_hw_cycles_per_sec /
+		       (100U << (odr - BMI160_ODR_100));
+	}
+
+	return (sys_clock_hw_cycles_per_sec / 100U) << (BMI160_ODR_100 - odr);
+}
+
+static int bmi160_fifo_watermark_set(struct device *dev,
+				     const struct sensor_value *val)
+{
+	struct bmi160_device_data *bmi160 = dev->driver_data;
+	uint8_t conf, fifo_en = 0;
+
+	if (val->val1 < 0 ||
+	    val->val1 > BMI160_FIFO_SIZE / BMI160_FIFO_FRAME_SIZE) {
+		return -EINVAL;
+	}
+
+	if (val->val1) {
+		fifo_en = BMI160_FIFO_FRAME_EN;
+	}
+
+#if !defined(CONFIG_BMI160_ACCEL_PMU_SUSPEND)
+	if (bmi160_byte_read(dev, BMI160_REG_ACC_CONF, &conf) < 0) {
+		return -EIO;
+	}
+#else
+	if (bmi160_byte_read(dev, BMI160_REG_GYR_CONF, &conf) < 0) {
+		return -EIO;
+	}
+#endif
+
+	bmi160->fifo_period = bmi160_odr_to_period(conf &
+						   BMI160_ACC_CONF_ODR_MASK);
+
+	if (bmi160_byte_write(dev, BMI160_REG_FIFO_CONFIG0,
+			      val->val1 * BMI160_FIFO_FRAME_SIZE /
+			      BMI160_FIFO_WM_UNIT) < 0 ||
+	    bmi160_byte_write(dev, BMI160_REG_FIFO_CONFIG1, fifo_en) < 0 ||
+	    bmi160_byte_write(dev, BMI160_REG_CMD,
+			      BMI160_CMD_FIFO_FLUSH) < 0) {
+		SYS_LOG_DBG("Failed to configure FIFO.");
+		return -EIO;
+	}
+
+	return 0;
+}
+#endif
+
 static int bmi160_attr_set(struct device *dev, enum sensor_channel chan,
 		    enum sensor_attribute attr, const struct sensor_value *val)
 {
 	switch (chan) {
+#ifdef CONFIG_BMI160_FIFO
+	case SENSOR_CHAN_ALL:
+		if (attr == SENSOR_ATTR_FIFO_WATERMARK) {
+			return bmi160_fifo_watermark_set(dev, val);
+		}
+
+		SYS_LOG_DBG("attr_set() not supported on this channel.");
+		return -ENOTSUP;
+#endif
 #if !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND)
 	case SENSOR_CHAN_GYRO_X:
 	case SENSOR_CHAN_GYRO_Y:
@@ -803,6 +866,180 @@ static int bmi160_channel_get(struct device *dev,
 	return 0;
 }
 
+static void bmi160_channel_raw(enum sensor_channel chan, uint16_t *raw_xyz,
+			       int32_t *raw)
+{
+	switch (chan) {
+	case SENSOR_CHAN_ACCEL_X:
+	case SENSOR_CHAN_GYRO_X:
+		*raw = (int16_t)raw_xyz[0];
+		break;
+	case SENSOR_CHAN_ACCEL_Y:
+	case SENSOR_CHAN_GYRO_Y:
+		*raw = (int16_t)raw_xyz[1];
+		break;
+	case SENSOR_CHAN_ACCEL_Z:
+	case SENSOR_CHAN_GYRO_Z:
+		*raw = (int16_t)raw_xyz[2];
+		break;
+	default:
+		raw[0] = (int16_t)raw_xyz[0];
+		raw[1] = (int16_t)raw_xyz[1];
+		raw[2] = (int16_t)raw_xyz[2];
+		break;
+	}
+}
+
+static int bmi160_channel_get_raw(struct device *dev,
+				  enum sensor_channel chan,
+				  int32_t *raw, struct sensor_scale *scale)
+{
+	struct bmi160_device_data *bmi160 = dev->driver_data;
+	struct sensor_scale chan_scale = { 0 };
+	uint16_t temp_raw;
+
+	switch (chan) {
+#if !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND)
+	case SENSOR_CHAN_GYRO_X:
+	case SENSOR_CHAN_GYRO_Y:
+	case SENSOR_CHAN_GYRO_Z:
+	case SENSOR_CHAN_GYRO_XYZ:
+		bmi160_channel_raw(chan, bmi160->sample.gyr, raw);
+		chan_scale.mult = bmi160->scale.gyr;
+		break;
+#endif
+#if !defined(CONFIG_BMI160_ACCEL_PMU_SUSPEND)
+	case SENSOR_CHAN_ACCEL_X:
+	case SENSOR_CHAN_ACCEL_Y:
+	case SENSOR_CHAN_ACCEL_Z:
+	case SENSOR_CHAN_ACCEL_XYZ:
+		bmi160_channel_raw(chan, bmi160->sample.acc, raw);
+		chan_scale.mult = bmi160->scale.acc;
+		break;
+#endif
+	case SENSOR_CHAN_TEMP:
+		if (bmi160->pmu_sts.raw == 0) {
+			return -EINVAL;
+		}
+
+		if (bmi160_word_read(dev, BMI160_REG_TEMPERATURE0,
+				     &temp_raw) < 0) {
+			return -EIO;
+		}
+
+		/* the scale is 1/2^9/LSB */
+		*raw = (int16_t)temp_raw;
+		chan_scale.mult = 1000000;
+		chan_scale.shift = 9;
+		chan_scale.offset = BMI160_TEMP_OFFSET * 1000000;
+		break;
+	default:
+		SYS_LOG_DBG("Channel not supported.");
+		return -ENOTSUP;
+	}
+
+	if (scale) {
+		*scale = chan_scale;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_BMI160_FIFO
+static int bmi160_fifo_read(struct device *dev, struct sensor_fifo_data *data)
+{
+	struct bmi160_device_data *bmi160 = dev->driver_data;
+	uint8_t tx = BMI160_REG_FIFO_DATA | (1 << 7);
+	uint16_t fifo_len;
+	size_t len = 0;
+
+	if (bmi160_word_read(dev, BMI160_REG_FIFO_LENGTH0, &fifo_len) < 0) {
+		return -EIO;
+	}
+
+	/* the last frame read is the last one in the FIFO at that time */
+	data->timestamp = k_cycle_get_32();
+	data->period = bmi160->fifo_period;
+	data->info = bmi160->scale.acc | (uint32_t)bmi160->scale.gyr << 16;
+	data->len = 0;
+
+	/* only complete frames, after the dummy byte needed by SPI */
+	if (data->size > BMI160_DATA_OFS) {
+		len = min(fifo_len & BMI160_FIFO_LENGTH_MASK,
+			  data->size - BMI160_DATA_OFS);
+		len -= len % BMI160_FIFO_FRAME_SIZE;
+	}
+
+	if (!len) {
+		return 0;
+	}
+
+	if (bmi160_transceive(dev, &tx, 1, data->buf,
+			      len + BMI160_DATA_OFS) < 0) {
+		return -EIO;
+	}
+
+	data->len = len + BMI160_DATA_OFS;
+
+	return 0;
+}
+
+static int bmi160_fifo_decode(struct device *dev,
+			      const struct sensor_fifo_data *data,
+			      enum sensor_channel chan,
+			      struct sensor_sample *samples, size_t count)
+{
+	const uint8_t *frame = data->buf + BMI160_DATA_OFS;
+	size_t frames, ofs, i, j;
+	uint16_t raw_xyz[3], scale;
+
+	ARG_UNUSED(dev);
+
+	switch (chan) {
+#if !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND)
+	case SENSOR_CHAN_GYRO_X:
+	case SENSOR_CHAN_GYRO_Y:
+	case SENSOR_CHAN_GYRO_Z:
+	case SENSOR_CHAN_GYRO_XYZ:
+		ofs = offsetof(union bmi160_sample, gyr) - BMI160_DATA_OFS;
+		scale = data->info >> 16;
+		break;
+#endif
+#if !defined(CONFIG_BMI160_ACCEL_PMU_SUSPEND)
+	case SENSOR_CHAN_ACCEL_X:
+	case SENSOR_CHAN_ACCEL_Y:
+	case SENSOR_CHAN_ACCEL_Z:
+	case SENSOR_CHAN_ACCEL_XYZ:
+		ofs = offsetof(union bmi160_sample, acc) - BMI160_DATA_OFS;
+		scale = data->info & 0xffff;
+		break;
+#endif
+	default:
+		SYS_LOG_DBG("Channel not supported.");
+		return -ENOTSUP;
+	}
+
+	if (data->len <= BMI160_DATA_OFS) {
+		return 0;
+	}
+
+	frames = (data->len - BMI160_DATA_OFS) / BMI160_FIFO_FRAME_SIZE;
+	count = min(count, frames);
+
+	for (i = 0; i < count; i++, frame += BMI160_FIFO_FRAME_SIZE) {
+		for (j = 0; j < 3; j++) {
+			raw_xyz[j] = sys_get_le16(&frame[ofs + 2 * j]);
+		}
+
+		samples[i].timestamp = data->timestamp -
+				       (frames - 1 - i) * data->period;
+		bmi160_channel_convert(chan, scale, raw_xyz, samples[i].val);
+	}
+
+	return count;
+}
+#endif /* CONFIG_BMI160_FIFO */
+
 static const struct sensor_driver_api bmi160_api = {
 	.attr_set = bmi160_attr_set,
 #ifdef CONFIG_BMI160_TRIGGER
@@ -810,6 +1047,11 @@ static const struct sensor_driver_api bmi160_api = {
 #endif
 	.sample_fetch = bmi160_sample_fetch,
 	.channel_get = bmi160_channel_get,
+	.channel_get_raw = bmi160_channel_get_raw,
+#ifdef CONFIG_BMI160_FIFO
+	.fifo_read = bmi160_fifo_read,
+	.fifo_decode = bmi160_fifo_decode,
+#endif
 };
 
 int bmi160_init(struct device *dev)
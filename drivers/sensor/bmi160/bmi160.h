@@ -164,6 +164,15 @@
 #define BMI160_INT_STATUS3_ORIENT_2	BIT(6)
 #define BMI160_INT_STATUS3_FLAT		BIT(7)
 
+/* BMI160_REG_FIFO_LENGTH0 */
+#define BMI160_FIFO_LENGTH_MASK		0x7FF
+
+/* BMI160_REG_FIFO_CONFIG1 */
+#define BMI160_FIFO_GYR_EN		BIT(7)
+#define BMI160_FIFO_ACC_EN		BIT(6)
+#define BMI160_FIFO_MAG_EN		BIT(5)
+#define BMI160_FIFO_HEADER_EN		BIT(4)
+
 /* BMI160_REG_ACC_CONF */
 #define BMI160_ACC_CONF_ODR_POS		0
 #define BMI160_ACC_CONF_ODR_MASK	0xF
@@ -192,6 +201,7 @@
 #define BMI160_CMD_PMU_ACC		0x10
 #define BMI160_CMD_PMU_GYR		0x14
 #define BMI160_CMD_PMU_MAG		0x18
+#define BMI160_CMD_FIFO_FLUSH		0xB0
 #define BMI160_CMD_SOFT_RESET		0xB6
 
 /* BMI160_REG_FOC_CONF */
@@ -244,6 +254,8 @@
 /* other */
 #define BMI160_CHIP_ID			0xD1
 #define BMI160_TEMP_OFFSET		23
+#define BMI160_FIFO_SIZE		1024
+#define BMI160_FIFO_WM_UNIT		4	/* bytes */
 
 /* allowed ODR values */
 enum bmi160_odr {
@@ -425,6 +437,18 @@ union bmi160_sample {
 	} __packed;
 };
 
+/* FIFO frames, without header, hold the data of the active sensors */
+#if !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND) && \
+		!defined(CONFIG_BMI160_ACCEL_PMU_SUSPEND)
+#	define BMI160_FIFO_FRAME_EN	(BMI160_FIFO_GYR_EN |\
+					 BMI160_FIFO_ACC_EN)
+#elif !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND)
+#	define BMI160_FIFO_FRAME_EN	BMI160_FIFO_GYR_EN
+#else
+#	define BMI160_FIFO_FRAME_EN	BMI160_FIFO_ACC_EN
+#endif
+#define BMI160_FIFO_FRAME_SIZE		BMI160_SAMPLE_SIZE
+
 struct bmi160_scale {
 	uint16_t acc; /* micro m/s^2/lsb */
 	uint16_t gyr; /* micro radians/s/lsb */
@@ -439,6 +463,9 @@ struct bmi160_device_data {
 	union bmi160_pmu_status pmu_sts;
 	union bmi160_sample sample;
 	struct bmi160_scale scale;
+#ifdef CONFIG_BMI160_FIFO
+	uint32_t fifo_period; /* hw cycles between two FIFO frames */
+#endif
 
 #ifdef CONFIG_BMI160_TRIGGER_OWN_THREAD
 	struct k_sem sem;
@@ -457,6 +484,9 @@ struct bmi160_device_data {
 #if !defined(CONFIG_BMI160_GYRO_PMU_SUSPEND)
 	sensor_trigger_handler_t handler_drdy_gyr;
 #endif
+#ifdef CONFIG_BMI160_FIFO
+	sensor_trigger_handler_t handler_fifo;
+#endif
 #endif /* CONFIG_BMI160_TRIGGER */
 };
 
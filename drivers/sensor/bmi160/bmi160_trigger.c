@@ -46,6 +46,21 @@ static void bmi160_handle_drdy(struct device *dev, uint8_t status)
 #endif
 }
 
+#ifdef CONFIG_BMI160_FIFO
+static void bmi160_handle_fifo(struct device *dev)
+{
+	struct bmi160_device_data *bmi160 = dev->driver_data;
+	struct sensor_trigger fifo_trigger = {
+		.type = SENSOR_TRIG_FIFO_WATERMARK,
+		.chan = SENSOR_CHAN_ALL,
+	};
+
+	if (bmi160->handler_fifo) {
+		bmi160->handler_fifo(dev, &fifo_trigger);
+	}
+}
+#endif
+
 static void bmi160_handle_interrupts(void *arg)
 {
 	struct device *dev = (struct device *)arg;
@@ -74,6 +89,11 @@ static void bmi160_handle_interrupts(void *arg)
 		bmi160_handle_drdy(dev, buf.status);
 	}
 
+#ifdef CONFIG_BMI160_FIFO
+	if (buf.int_status[1] & BMI160_INT_STATUS1_FWM) {
+		bmi160_handle_fifo(dev);
+	}
+#endif
 }
 
 #ifdef CONFIG_BMI160_TRIGGER_OWN_THREAD
@@ -117,7 +137,7 @@ static void bmi160_gpio_callback(struct device *port,
 #if defined(CONFIG_BMI160_TRIGGER_OWN_THREAD)
 	k_sem_give(&bmi160->sem);
 #elif defined(CONFIG_BMI160_TRIGGER_GLOBAL_THREAD)
-	k_work_submit(&bmi160->work);
+	sensor_work_submit(&bmi160->work);
 #endif
 }
 
@@ -249,10 +269,37 @@ static int bmi160_trigger_set_gyr(struct device *dev,
 }
 #endif
 
+#ifdef CONFIG_BMI160_FIFO
+static int bmi160_trigger_fifo_set(struct device *dev,
+				   sensor_trigger_handler_t handler)
+{
+	struct bmi160_device_data *bmi160 = dev->driver_data;
+	uint8_t fwm_en = 0;
+
+	bmi160->handler_fifo = handler;
+
+	if (handler) {
+		fwm_en = BMI160_INT_FWM_EN;
+	}
+
+	if (bmi160_reg_update(dev, BMI160_REG_INT_EN1,
+			      BMI160_INT_FWM_EN, fwm_en) < 0) {
+		return -EIO;
+	}
+
+	return 0;
+}
+#endif
+
 int bmi160_trigger_set(struct device *dev,
 		       const struct sensor_trigger *trig,
 		       sensor_trigger_handler_t handler)
 {
+#ifdef CONFIG_BMI160_FIFO
+	if (trig->type == SENSOR_TRIG_FIFO_WATERMARK) {
+		return bmi160_trigger_fifo_set(dev, handler);
+	}
+#endif
 #if !defined(CONFIG_BMI160_ACCEL_PMU_SUSPEND)
 	if (trig->chan == SENSOR_CHAN_ACCEL_XYZ) {
 		return bmi160_trigger_set_acc(dev, trig, handler);
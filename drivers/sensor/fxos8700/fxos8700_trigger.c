@@ -22,7 +22,7 @@ static void fxos8700_gpio_callback(struct device *dev,
 #if defined(CONFIG_FXOS8700_TRIGGER_OWN_THREAD)
 	k_sem_give(&data->trig_sem);
 #elif defined(CONFIG_FXOS8700_TRIGGER_GLOBAL_THREAD)
-	k_work_submit(&data->work);
+	sensor_work_submit(&data->work);
 #endif
 }
 
@@ -48,7 +48,7 @@ static void hmc5883l_gpio_callback(struct device *dev,
 #if defined(CONFIG_HMC5883L_TRIGGER_OWN_THREAD)
 	k_sem_give(&drv_data->gpio_sem);
 #elif defined(CONFIG_HMC5883L_TRIGGER_GLOBAL_THREAD)
-	k_work_submit(&drv_data->work);
+	sensor_work_submit(&drv_data->work);
 #endif
 }
 
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Work queue handling the sensor triggers
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <sensor.h>
+
+static char __stack sensor_work_stack[CONFIG_SENSOR_WORK_QUEUE_STACK_SIZE];
+struct k_work_q sensor_work_q;
+
+static int sensor_work_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&sensor_work_q, sensor_work_stack,
+		       sizeof(sensor_work_stack),
+		       CONFIG_SENSOR_WORK_QUEUE_PRIORITY);
+
+	return 0;
+}
+
+/* Before the sensors, which may submit work as soon as initialized */
+SYS_INIT(sensor_work_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
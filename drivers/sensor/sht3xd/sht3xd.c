@@ -9,6 +9,7 @@
 #include <kernel.h>
 #include <sensor.h>
 #include <misc/__assert.h>
+#include <misc/crc.h>
 
 #include "sht3xd.h"
 
@@ -19,22 +20,8 @@
 static uint8_t sht3xd_compute_crc(uint16_t value)
 {
 	uint8_t buf[2] = {value >> 8, value & 0xFF};
-	uint8_t crc = 0xFF;
-	uint8_t polynom = 0x31;
-	int i, j;
-
-	for (i = 0; i < 2; ++i) {
-		crc  = crc ^ buf[i];
-		for (j = 0; j < 8; ++j) {
-			if (crc & 0x80) {
-				crc = (crc << 1) ^ polynom;
-			} else {
-				crc = crc << 1;
-			}
-		}
-	}
 
-	return crc;
+	return crc8(buf, sizeof(buf), 0x31, 0xFF);
 }
 
 int sht3xd_write_command(struct sht3xd_data *drv_data, uint16_t cmd)
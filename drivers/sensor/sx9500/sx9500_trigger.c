@@ -105,7 +105,7 @@ static void sx9500_gpio_cb(struct device *port,
 
 	ARG_UNUSED(pins);
 
-	k_work_submit(&data->work);
+	sensor_work_submit(&data->work);
 }
 
 static void sx9500_gpio_thread_cb(void *arg)
@@ -8,6 +8,9 @@
 #include <device.h>
 #include <uart.h>
 #include <fsl_lpuart.h>
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+#include <fsl_lpuart_edma.h>
+#endif
 #include <fsl_clock.h>
 #include <soc.h>
 
@@ -18,14 +21,42 @@ struct mcux_lpuart_config {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	void (*irq_config_func)(struct device *dev);
 #endif
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	uint32_t tx_dma_channel;
+	uint32_t rx_dma_channel;
+	uint8_t tx_dma_request;
+	uint8_t rx_dma_request;
+	void (*dma_config_func)(struct device *dev);
+#endif
 };
 
 struct mcux_lpuart_data {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	uart_irq_callback_t callback;
 #endif
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	uart_callback_t async_cb;
+	void *async_user_data;
+	edma_handle_t tx_dma;
+	edma_handle_t rx_dma;
+	lpuart_edma_handle_t edma;
+	const uint8_t *tx_buf;
+	size_t tx_len;
+	uint8_t *rx_buf;
+	size_t rx_len;
+	size_t rx_offset;
+	uint8_t *rx_next_buf;
+	size_t rx_next_len;
+#endif
 };
 
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+#define MCUX_LPUART_ASYNC_RX_IRQS (kLPUART_IdleLineInterruptEnable | \
+				   kLPUART_RxOverrunInterruptEnable | \
+				   kLPUART_FramingErrorInterruptEnable | \
+				   kLPUART_ParityErrorInterruptEnable)
+#endif
+
 static int mcux_lpuart_poll_in(struct device *dev, unsigned char *c)
 {
 	const struct mcux_lpuart_config *config = dev->config->config_info;
@@ -78,6 +109,374 @@ static int mcux_lpuart_err_check(struct device *dev)
 	return err;
 }
 
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+static void mcux_lpuart_notify(struct device *dev, struct uart_event *evt)
+{
+	struct mcux_lpuart_data *data = dev->driver_data;
+
+	if (data->async_cb) {
+		data->async_cb(dev, evt, data->async_user_data);
+	}
+}
+
+static int mcux_lpuart_callback_set(struct device *dev, uart_callback_t cb,
+				    void *user_data)
+{
+	struct mcux_lpuart_data *data = dev->driver_data;
+
+	data->async_user_data = user_data;
+	data->async_cb = cb;
+
+	return 0;
+}
+
+static int mcux_lpuart_tx(struct device *dev, const uint8_t *buf, size_t len)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	lpuart_transfer_t xfer = {
+		.data = (uint8_t *)buf,
+		.dataSize = len,
+	};
+	unsigned int key;
+
+	if (!data->async_cb) {
+		return -EACCES;
+	}
+
+	key = irq_lock();
+
+	if (data->tx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	data->tx_buf = buf;
+	data->tx_len = len;
+
+	irq_unlock(key);
+
+	if (LPUART_SendEDMA(config->base, &data->edma, &xfer) !=
+	    kStatus_Success) {
+		data->tx_buf = NULL;
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int mcux_lpuart_tx_abort(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	struct uart_event evt;
+	uint32_t count = 0;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (!data->tx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	LPUART_TransferGetSendCountEDMA(config->base, &data->edma, &count);
+	LPUART_TransferAbortSendEDMA(config->base, &data->edma);
+
+	evt.type = UART_TX_ABORTED;
+	evt.data.tx.buf = data->tx_buf;
+	evt.data.tx.len = count;
+
+	data->tx_buf = NULL;
+
+	irq_unlock(key);
+
+	mcux_lpuart_notify(dev, &evt);
+
+	return 0;
+}
+
+/* Reports the data received since the last report */
+static void mcux_lpuart_rx_rdy(struct device *dev, size_t count)
+{
+	struct mcux_lpuart_data *data = dev->driver_data;
+	struct uart_event evt;
+
+	if (count <= data->rx_offset) {
+		return;
+	}
+
+	evt.type = UART_RX_RDY;
+	evt.data.rx.buf = data->rx_buf;
+	evt.data.rx.offset = data->rx_offset;
+	evt.data.rx.len = count - data->rx_offset;
+
+	data->rx_offset = count;
+
+	mcux_lpuart_notify(dev, &evt);
+}
+
+static void mcux_lpuart_rx_release(struct device *dev, uint8_t *buf)
+{
+	struct uart_event evt;
+
+	evt.type = UART_RX_BUF_RELEASED;
+	evt.data.rx_buf.buf = buf;
+
+	mcux_lpuart_notify(dev, &evt);
+}
+
+static int mcux_lpuart_rx_start(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	lpuart_transfer_t xfer = {
+		.data = data->rx_buf,
+		.dataSize = data->rx_len,
+	};
+	struct uart_event evt;
+
+	data->rx_offset = 0;
+
+	if (LPUART_ReceiveEDMA(config->base, &data->edma, &xfer) !=
+	    kStatus_Success) {
+		return -EBUSY;
+	}
+
+	evt.type = UART_RX_BUF_REQUEST;
+	mcux_lpuart_notify(dev, &evt);
+
+	return 0;
+}
+
+static void mcux_lpuart_rx_end(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	struct uart_event evt;
+
+	LPUART_DisableInterrupts(config->base, MCUX_LPUART_ASYNC_RX_IRQS);
+
+	data->rx_buf = NULL;
+
+	evt.type = UART_RX_DISABLED;
+	mcux_lpuart_notify(dev, &evt);
+}
+
+static int mcux_lpuart_rx_enable(struct device *dev, uint8_t *buf, size_t len,
+				 uint32_t timeout)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	uint32_t mask = MCUX_LPUART_ASYNC_RX_IRQS;
+	int err;
+
+	if (!data->async_cb) {
+		return -EACCES;
+	}
+
+	if (data->rx_buf) {
+		return -EBUSY;
+	}
+
+	data->rx_buf = buf;
+	data->rx_len = len;
+	data->rx_next_buf = NULL;
+
+	/* The idle line is detected by the LPUART, after a character time */
+	if (!timeout) {
+		mask &= ~kLPUART_IdleLineInterruptEnable;
+	}
+
+	LPUART_ClearStatusFlags(config->base, kLPUART_IdleLineFlag |
+					      kLPUART_RxOverrunFlag |
+					      kLPUART_ParityErrorFlag |
+					      kLPUART_FramingErrorFlag);
+	LPUART_EnableInterrupts(config->base, mask);
+
+	err = mcux_lpuart_rx_start(dev);
+	if (err) {
+		LPUART_DisableInterrupts(config->base, mask);
+		data->rx_buf = NULL;
+	}
+
+	return err;
+}
+
+static int mcux_lpuart_rx_buf_rsp(struct device *dev, uint8_t *buf,
+				  size_t len)
+{
+	struct mcux_lpuart_data *data = dev->driver_data;
+	unsigned int key;
+	int err = 0;
+
+	key = irq_lock();
+
+	if (!data->rx_buf) {
+		err = -EACCES;
+	} else if (data->rx_next_buf) {
+		err = -EBUSY;
+	} else {
+		data->rx_next_buf = buf;
+		data->rx_next_len = len;
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+static int mcux_lpuart_rx_disable(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	uint32_t count = 0;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (!data->rx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	LPUART_TransferGetReceiveCountEDMA(config->base, &data->edma, &count);
+	LPUART_TransferAbortReceiveEDMA(config->base, &data->edma);
+
+	mcux_lpuart_rx_rdy(dev, count);
+	mcux_lpuart_rx_release(dev, data->rx_buf);
+
+	if (data->rx_next_buf) {
+		mcux_lpuart_rx_release(dev, data->rx_next_buf);
+		data->rx_next_buf = NULL;
+	}
+
+	mcux_lpuart_rx_end(dev);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static void mcux_lpuart_edma_callback(LPUART_Type *base,
+				      lpuart_edma_handle_t *handle,
+				      status_t status, void *user_data)
+{
+	struct device *dev = user_data;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	struct uart_event evt;
+
+	if (status == kStatus_LPUART_TxIdle) {
+		evt.type = UART_TX_DONE;
+		evt.data.tx.buf = data->tx_buf;
+		evt.data.tx.len = data->tx_len;
+
+		data->tx_buf = NULL;
+
+		mcux_lpuart_notify(dev, &evt);
+		return;
+	}
+
+	if (status != kStatus_LPUART_RxIdle) {
+		return;
+	}
+
+	/* The buffer is full, go on with the next one */
+	mcux_lpuart_rx_rdy(dev, data->rx_len);
+	mcux_lpuart_rx_release(dev, data->rx_buf);
+
+	if (data->rx_next_buf) {
+		data->rx_buf = data->rx_next_buf;
+		data->rx_len = data->rx_next_len;
+		data->rx_next_buf = NULL;
+
+		if (!mcux_lpuart_rx_start(dev)) {
+			return;
+		}
+
+		mcux_lpuart_rx_release(dev, data->rx_buf);
+	}
+
+	mcux_lpuart_rx_end(dev);
+}
+
+static void mcux_lpuart_isr_async(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	struct uart_event evt;
+	uint32_t count;
+	int err;
+
+	if (!data->rx_buf) {
+		return;
+	}
+
+	err = mcux_lpuart_err_check(dev);
+	if (err) {
+		evt.type = UART_RX_STOPPED;
+		evt.data.rx_stop.reason = err;
+		mcux_lpuart_notify(dev, &evt);
+
+		mcux_lpuart_rx_disable(dev);
+		return;
+	}
+
+	if (LPUART_GetStatusFlags(config->base) & kLPUART_IdleLineFlag) {
+		LPUART_ClearStatusFlags(config->base, kLPUART_IdleLineFlag);
+
+		if (LPUART_TransferGetReceiveCountEDMA(config->base,
+						       &data->edma, &count) ==
+		    kStatus_Success) {
+			mcux_lpuart_rx_rdy(dev, count);
+		}
+	}
+}
+
+static void mcux_lpuart_tx_dma_isr(void *arg)
+{
+	struct device *dev = arg;
+	struct mcux_lpuart_data *data = dev->driver_data;
+
+	EDMA_HandleIRQ(&data->tx_dma);
+}
+
+static void mcux_lpuart_rx_dma_isr(void *arg)
+{
+	struct device *dev = arg;
+	struct mcux_lpuart_data *data = dev->driver_data;
+
+	EDMA_HandleIRQ(&data->rx_dma);
+}
+
+static void mcux_lpuart_dma_init(struct device *dev)
+{
+	const struct mcux_lpuart_config *config = dev->config->config_info;
+	struct mcux_lpuart_data *data = dev->driver_data;
+	edma_config_t dma_config;
+
+	EDMA_GetDefaultConfig(&dma_config);
+	EDMA_Init(DMA0, &dma_config);
+	DMAMUX_Init(DMAMUX0);
+
+	DMAMUX_SetSource(DMAMUX0, config->tx_dma_channel,
+			 config->tx_dma_request);
+	DMAMUX_EnableChannel(DMAMUX0, config->tx_dma_channel);
+	DMAMUX_SetSource(DMAMUX0, config->rx_dma_channel,
+			 config->rx_dma_request);
+	DMAMUX_EnableChannel(DMAMUX0, config->rx_dma_channel);
+
+	EDMA_CreateHandle(&data->tx_dma, DMA0, config->tx_dma_channel);
+	EDMA_CreateHandle(&data->rx_dma, DMA0, config->rx_dma_channel);
+
+	LPUART_TransferCreateHandleEDMA(config->base, &data->edma,
+					mcux_lpuart_edma_callback, dev,
+					&data->tx_dma, &data->rx_dma);
+
+	config->dma_config_func(dev);
+}
+#endif /* CONFIG_UART_MCUX_LPUART_ASYNC */
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 static int mcux_lpuart_fifo_fill(struct device *dev, const uint8_t *tx_data,
 			       int len)
@@ -221,6 +620,13 @@ static void mcux_lpuart_isr(void *arg)
 	struct device *dev = arg;
 	struct mcux_lpuart_data *data = dev->driver_data;
 
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	if (data->async_cb) {
+		mcux_lpuart_isr_async(dev);
+		return;
+	}
+#endif
+
 	if (data->callback) {
 		data->callback(dev);
 	}
@@ -242,6 +648,10 @@ static int mcux_lpuart_init(struct device *dev)
 
 	LPUART_Init(config->base, &uart_config, clock_freq);
 
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	mcux_lpuart_dma_init(dev);
+#endif
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	config->irq_config_func(dev);
 #endif
@@ -269,6 +679,14 @@ static const struct uart_driver_api mcux_lpuart_driver_api = {
 	.irq_update = mcux_lpuart_irq_update,
 	.irq_callback_set = mcux_lpuart_irq_callback_set,
 #endif
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	.callback_set = mcux_lpuart_callback_set,
+	.tx = mcux_lpuart_tx,
+	.tx_abort = mcux_lpuart_tx_abort,
+	.rx_enable = mcux_lpuart_rx_enable,
+	.rx_buf_rsp = mcux_lpuart_rx_buf_rsp,
+	.rx_disable = mcux_lpuart_rx_disable,
+#endif
 };
 
 #ifdef CONFIG_UART_MCUX_LPUART_0
@@ -276,6 +694,9 @@ static const struct uart_driver_api mcux_lpuart_driver_api = {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 static void mcux_lpuart_config_func_0(struct device *dev);
 #endif
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+static void mcux_lpuart_dma_config_func_0(struct device *dev);
+#endif
 
 static const struct mcux_lpuart_config mcux_lpuart_0_config = {
 	.base = LPUART0,
@@ -284,6 +705,13 @@ static const struct mcux_lpuart_config mcux_lpuart_0_config = {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	.irq_config_func = mcux_lpuart_config_func_0,
 #endif
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+	.tx_dma_channel = CONFIG_UART_MCUX_LPUART_0_DMA_TX_CHANNEL,
+	.rx_dma_channel = CONFIG_UART_MCUX_LPUART_0_DMA_RX_CHANNEL,
+	.tx_dma_request = kDmaRequestMux0LPUART0Tx,
+	.rx_dma_request = kDmaRequestMux0LPUART0Rx,
+	.dma_config_func = mcux_lpuart_dma_config_func_0,
+#endif
 };
 
 static struct mcux_lpuart_data mcux_lpuart_0_data;
@@ -304,4 +732,19 @@ static void mcux_lpuart_config_func_0(struct device *dev)
 }
 #endif
 
+#ifdef CONFIG_UART_MCUX_LPUART_ASYNC
+static void mcux_lpuart_dma_config_func_0(struct device *dev)
+{
+	IRQ_CONNECT(IRQ_DMA_CHAN0 + CONFIG_UART_MCUX_LPUART_0_DMA_TX_CHANNEL,
+		    CONFIG_UART_MCUX_LPUART_0_IRQ_PRI,
+		    mcux_lpuart_tx_dma_isr, DEVICE_GET(uart_0), 0);
+	irq_enable(IRQ_DMA_CHAN0 + CONFIG_UART_MCUX_LPUART_0_DMA_TX_CHANNEL);
+
+	IRQ_CONNECT(IRQ_DMA_CHAN0 + CONFIG_UART_MCUX_LPUART_0_DMA_RX_CHANNEL,
+		    CONFIG_UART_MCUX_LPUART_0_IRQ_PRI,
+		    mcux_lpuart_rx_dma_isr, DEVICE_GET(uart_0), 0);
+	irq_enable(IRQ_DMA_CHAN0 + CONFIG_UART_MCUX_LPUART_0_DMA_RX_CHANNEL);
+}
+#endif
+
 #endif /* CONFIG_UART_MCUX_LPUART_0 */
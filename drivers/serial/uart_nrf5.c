@@ -84,6 +84,24 @@ struct uart_nrf5_dev_data_t {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	uart_irq_callback_t     cb;     /**< Callback function pointer */
 #endif /* CONFIG_UART_INTERRUPT_DRIVEN */
+
+#ifdef CONFIG_UART_NRF5_ASYNC
+	bool uarte;                     /**< Running as UARTE */
+	uart_callback_t async_cb;       /**< Asynchronous API callback */
+	void *async_user_data;          /**< Asynchronous API callback data */
+
+	const uint8_t *tx_buf;          /**< Buffer being sent */
+	size_t tx_len;                  /**< Length of the buffer being sent */
+
+	uint8_t *rx_buf;                /**< Buffer being received into */
+	uint8_t *rx_next_buf;           /**< Next buffer, set in RXD.PTR */
+	bool rx_buf_requested;          /**< Next buffer can be set */
+	bool rx_disabling;              /**< Reception being stopped */
+	bool rx_active;                 /**< Data since the last idle check */
+	struct k_timer rx_timer;        /**< Idle line detection */
+
+	uint8_t poll_out_byte;          /**< EasyDMA only reads from RAM */
+#endif /* CONFIG_UART_NRF5_ASYNC */
 };
 
 /* convenience defines */
@@ -93,6 +111,8 @@ struct uart_nrf5_dev_data_t {
 	((struct uart_nrf5_dev_data_t * const)(dev)->driver_data)
 #define UART_STRUCT(dev) \
 	((volatile struct _uart *)(DEV_CFG(dev))->base)
+#define UARTE_STRUCT(dev) \
+	((volatile NRF_UARTE_Type *)(DEV_CFG(dev))->base)
 
 #define UART_IRQ_MASK_RX	(1 << 2)
 #define UART_IRQ_MASK_TX	(1 << 3)
@@ -178,6 +198,372 @@ static int baudrate_set(struct device *dev,
 	return 0;
 }
 
+#ifdef CONFIG_UART_NRF5_ASYNC
+
+/* EasyDMA can only access the data RAM */
+static bool uarte_nrf5_is_in_ram(const void *buf)
+{
+	return ((uint32_t)buf & 0xE0000000) == 0x20000000;
+}
+
+static void uarte_nrf5_notify(struct device *dev, struct uart_event *evt)
+{
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (dev_data->async_cb) {
+		dev_data->async_cb(dev, evt, dev_data->async_user_data);
+	}
+}
+
+/** Asynchronous API callback setting function */
+static int uarte_nrf5_callback_set(struct device *dev, uart_callback_t cb,
+				   void *user_data)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (!dev_data->uarte) {
+		/* The pins, baud rate and configuration registers are the
+		 * same for UART and UARTE, only the mode is switched.
+		 */
+		uarte->INTENCLR = 0xFFFFFFFF;
+		uarte->TASKS_STOPTX = 1;
+		uarte->TASKS_STOPRX = 1;
+		uarte->ENABLE = (UARTE_ENABLE_ENABLE_Disabled <<
+				 UARTE_ENABLE_ENABLE_Pos);
+		uarte->ENABLE = (UARTE_ENABLE_ENABLE_Enabled <<
+				 UARTE_ENABLE_ENABLE_Pos);
+
+		dev_data->uarte = true;
+	}
+
+	dev_data->async_user_data = user_data;
+	dev_data->async_cb = cb;
+
+	return 0;
+}
+
+/** Asynchronous transmission function */
+static int uarte_nrf5_tx(struct device *dev, const uint8_t *buf, size_t len)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+	unsigned int key;
+
+	if (!dev_data->uarte) {
+		return -EACCES;
+	}
+
+	if (!uarte_nrf5_is_in_ram(buf) || len > UARTE_TXD_MAXCNT_MAXCNT_Msk) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (dev_data->tx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	dev_data->tx_buf = buf;
+	dev_data->tx_len = len;
+
+	irq_unlock(key);
+
+	uarte->TXD.PTR = (uint32_t)buf;
+	uarte->TXD.MAXCNT = len;
+
+	uarte->EVENTS_ENDTX = 0;
+	uarte->EVENTS_TXSTOPPED = 0;
+	uarte->INTENSET = UARTE_INTENSET_ENDTX_Msk |
+			  UARTE_INTENSET_TXSTOPPED_Msk;
+
+	uarte->TASKS_STARTTX = 1;
+
+	return 0;
+}
+
+/** Asynchronous transmission aborting function */
+static int uarte_nrf5_tx_abort(struct device *dev)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (!dev_data->tx_buf) {
+		return -EFAULT;
+	}
+
+	/* Reported from the ISR, by TXSTOPPED */
+	uarte->TASKS_STOPTX = 1;
+
+	return 0;
+}
+
+/** Asynchronous reception enabling function */
+static int uarte_nrf5_rx_enable(struct device *dev, uint8_t *buf, size_t len,
+				uint32_t timeout)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (!dev_data->uarte) {
+		return -EACCES;
+	}
+
+	if (dev_data->rx_buf) {
+		return -EBUSY;
+	}
+
+	if (!uarte_nrf5_is_in_ram(buf) || len > UARTE_RXD_MAXCNT_MAXCNT_Msk) {
+		return -EINVAL;
+	}
+
+	dev_data->rx_buf = buf;
+	dev_data->rx_next_buf = NULL;
+	dev_data->rx_buf_requested = false;
+	dev_data->rx_disabling = false;
+	dev_data->rx_active = false;
+
+	uarte->RXD.PTR = (uint32_t)buf;
+	uarte->RXD.MAXCNT = len;
+
+	uarte->EVENTS_RXDRDY = 0;
+	uarte->EVENTS_ENDRX = 0;
+	uarte->EVENTS_RXSTARTED = 0;
+	uarte->EVENTS_RXTO = 0;
+	uarte->EVENTS_ERROR = 0;
+	uarte->INTENSET = UARTE_INTENSET_ENDRX_Msk |
+			  UARTE_INTENSET_RXSTARTED_Msk |
+			  UARTE_INTENSET_RXTO_Msk |
+			  UARTE_INTENSET_ERROR_Msk;
+
+	uarte->TASKS_STARTRX = 1;
+
+	if (timeout) {
+		k_timer_start(&dev_data->rx_timer, timeout, timeout);
+	}
+
+	return 0;
+}
+
+/** Asynchronous reception next buffer function */
+static int uarte_nrf5_rx_buf_rsp(struct device *dev, uint8_t *buf, size_t len)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+	unsigned int key;
+	int err = 0;
+
+	if (!uarte_nrf5_is_in_ram(buf) || len > UARTE_RXD_MAXCNT_MAXCNT_Msk) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (!dev_data->rx_buf || dev_data->rx_disabling) {
+		err = -EACCES;
+	} else if (!dev_data->rx_buf_requested) {
+		/* RXD.PTR is only free for the next buffer once RX started */
+		err = -EBUSY;
+	} else {
+		dev_data->rx_next_buf = buf;
+		dev_data->rx_buf_requested = false;
+
+		/* Double buffered, taken at the next STARTRX */
+		uarte->RXD.PTR = (uint32_t)buf;
+		uarte->RXD.MAXCNT = len;
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+/** Asynchronous reception disabling function */
+static int uarte_nrf5_rx_disable(struct device *dev)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (!dev_data->rx_buf) {
+		return -EFAULT;
+	}
+
+	k_timer_stop(&dev_data->rx_timer);
+
+	/* The data is reported on ENDRX, the end on RXTO */
+	dev_data->rx_disabling = true;
+	uarte->TASKS_STOPRX = 1;
+
+	return 0;
+}
+
+/*
+ * There is no idle line detection, nor a count of the bytes received before
+ * ENDRX. The timer checks RXDRDY, and stops RX once the line was idle for a
+ * period, ENDRX then reports the data and RX goes on with the next buffer.
+ */
+static void uarte_nrf5_rx_timeout(struct k_timer *timer)
+{
+	struct device *dev = k_timer_user_data_get(timer);
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+
+	if (uarte->EVENTS_RXDRDY) {
+		uarte->EVENTS_RXDRDY = 0;
+		dev_data->rx_active = true;
+	} else if (dev_data->rx_active && dev_data->rx_next_buf) {
+		dev_data->rx_active = false;
+		uarte->TASKS_STOPRX = 1;
+	}
+}
+
+static void uarte_nrf5_isr_rx(struct device *dev)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+	struct uart_event evt;
+
+	if (uarte->EVENTS_ERROR) {
+		uarte->EVENTS_ERROR = 0;
+
+		/* register bitfields maps to the defines in uart.h */
+		evt.type = UART_RX_STOPPED;
+		evt.data.rx_stop.reason = uarte->ERRORSRC & 0x0F;
+		uarte->ERRORSRC = evt.data.rx_stop.reason;
+		uarte_nrf5_notify(dev, &evt);
+
+		uarte_nrf5_rx_disable(dev);
+	}
+
+	if (uarte->EVENTS_RXSTARTED) {
+		uarte->EVENTS_RXSTARTED = 0;
+
+		if (!dev_data->rx_disabling) {
+			dev_data->rx_buf_requested = true;
+
+			evt.type = UART_RX_BUF_REQUEST;
+			uarte_nrf5_notify(dev, &evt);
+		}
+	}
+
+	if (uarte->EVENTS_ENDRX) {
+		uarte->EVENTS_ENDRX = 0;
+
+		evt.data.rx.len = uarte->RXD.AMOUNT;
+		if (evt.data.rx.len) {
+			evt.type = UART_RX_RDY;
+			evt.data.rx.buf = dev_data->rx_buf;
+			evt.data.rx.offset = 0;
+			uarte_nrf5_notify(dev, &evt);
+		}
+
+		evt.type = UART_RX_BUF_RELEASED;
+		evt.data.rx_buf.buf = dev_data->rx_buf;
+		uarte_nrf5_notify(dev, &evt);
+
+		dev_data->rx_buf = dev_data->rx_next_buf;
+		dev_data->rx_next_buf = NULL;
+		dev_data->rx_buf_requested = false;
+
+		if (dev_data->rx_buf && dev_data->rx_disabling) {
+			evt.type = UART_RX_BUF_RELEASED;
+			evt.data.rx_buf.buf = dev_data->rx_buf;
+			uarte_nrf5_notify(dev, &evt);
+
+			dev_data->rx_buf = NULL;
+		}
+
+		if (dev_data->rx_buf) {
+			uarte->TASKS_STARTRX = 1;
+		} else {
+			/* Out of buffers, ends with RXTO */
+			uarte->TASKS_STOPRX = 1;
+		}
+	}
+
+	if (uarte->EVENTS_RXTO) {
+		uarte->EVENTS_RXTO = 0;
+
+		/* Otherwise RX was restarted with the next buffer */
+		if (!dev_data->rx_buf) {
+			k_timer_stop(&dev_data->rx_timer);
+			uarte->INTENCLR = UARTE_INTENCLR_ENDRX_Msk |
+					  UARTE_INTENCLR_RXSTARTED_Msk |
+					  UARTE_INTENCLR_RXTO_Msk |
+					  UARTE_INTENCLR_ERROR_Msk;
+
+			evt.type = UART_RX_DISABLED;
+			uarte_nrf5_notify(dev, &evt);
+		}
+	}
+}
+
+static void uarte_nrf5_isr_tx(struct device *dev)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+	struct uart_event evt;
+
+	if (!dev_data->tx_buf ||
+	    (!uarte->EVENTS_ENDTX && !uarte->EVENTS_TXSTOPPED)) {
+		return;
+	}
+
+	uarte->EVENTS_ENDTX = 0;
+	uarte->EVENTS_TXSTOPPED = 0;
+	uarte->INTENCLR = UARTE_INTENCLR_ENDTX_Msk |
+			  UARTE_INTENCLR_TXSTOPPED_Msk;
+
+	/* Keeps the transmitter off until the next buffer */
+	uarte->TASKS_STOPTX = 1;
+
+	evt.data.tx.buf = dev_data->tx_buf;
+	evt.data.tx.len = uarte->TXD.AMOUNT;
+	if (evt.data.tx.len == dev_data->tx_len) {
+		evt.type = UART_TX_DONE;
+	} else {
+		evt.type = UART_TX_ABORTED;
+	}
+
+	dev_data->tx_buf = NULL;
+
+	uarte_nrf5_notify(dev, &evt);
+}
+
+/* Sends a byte by EasyDMA, once the ongoing transmission is over */
+static void uarte_nrf5_poll_out(struct device *dev, unsigned char c)
+{
+	volatile NRF_UARTE_Type *uarte = UARTE_STRUCT(dev);
+	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
+	unsigned int key;
+
+	while (1) {
+		key = irq_lock();
+		if (!dev_data->tx_buf) {
+			break;
+		}
+		irq_unlock(key);
+	}
+
+	dev_data->poll_out_byte = c;
+
+	uarte->TXD.PTR = (uint32_t)&dev_data->poll_out_byte;
+	uarte->TXD.MAXCNT = 1;
+	uarte->EVENTS_ENDTX = 0;
+	uarte->TASKS_STARTTX = 1;
+
+	while (!uarte->EVENTS_ENDTX) {
+	}
+
+	uarte->EVENTS_ENDTX = 0;
+	uarte->TASKS_STOPTX = 1;
+
+	irq_unlock(key);
+}
+
+#endif /* CONFIG_UART_NRF5_ASYNC */
+
 /**
  * @brief Initialize UART channel
  *
@@ -241,6 +627,11 @@ static int uart_nrf5_init(struct device *dev)
 
 	dev->driver_api = &uart_nrf5_driver_api;
 
+#ifdef CONFIG_UART_NRF5_ASYNC
+	k_timer_init(&DEV_DATA(dev)->rx_timer, uarte_nrf5_rx_timeout, NULL);
+	k_timer_user_data_set(&DEV_DATA(dev)->rx_timer, dev);
+#endif /* CONFIG_UART_NRF5_ASYNC */
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	DEV_CFG(dev)->irq_config_func(dev);
 #endif
@@ -261,6 +652,13 @@ static int uart_nrf5_poll_in(struct device *dev, unsigned char *c)
 {
 	volatile struct _uart *uart = UART_STRUCT(dev);
 
+#ifdef CONFIG_UART_NRF5_ASYNC
+	/* There is no RXD register in UARTE mode */
+	if (DEV_DATA(dev)->uarte) {
+		return -1;
+	}
+#endif /* CONFIG_UART_NRF5_ASYNC */
+
 	if (!uart->EVENTS_RXDRDY) {
 		return -1;
 	}
@@ -290,6 +688,13 @@ static unsigned char uart_nrf5_poll_out(struct device *dev,
 {
 	volatile struct _uart *uart = UART_STRUCT(dev);
 
+#ifdef CONFIG_UART_NRF5_ASYNC
+	if (DEV_DATA(dev)->uarte) {
+		uarte_nrf5_poll_out(dev, c);
+		return c;
+	}
+#endif /* CONFIG_UART_NRF5_ASYNC */
+
 	/* send a character */
 	uart->TXD = (uint8_t)c;
 
@@ -463,6 +868,14 @@ void uart_nrf5_isr(void *arg)
 	struct device *dev = arg;
 	struct uart_nrf5_dev_data_t * const dev_data = DEV_DATA(dev);
 
+#ifdef CONFIG_UART_NRF5_ASYNC
+	if (dev_data->uarte) {
+		uarte_nrf5_isr_rx(dev);
+		uarte_nrf5_isr_tx(dev);
+		return;
+	}
+#endif /* CONFIG_UART_NRF5_ASYNC */
+
 	if (dev_data->cb) {
 		dev_data->cb(dev);
 	}
@@ -489,6 +902,14 @@ static const struct uart_driver_api uart_nrf5_driver_api = {
 	.irq_update       = uart_nrf5_irq_update,       /** IRQ interrupt update function */
 	.irq_callback_set = uart_nrf5_irq_callback_set, /** Set the callback function */
 #endif /* CONFIG_UART_INTERRUPT_DRIVEN */
+#ifdef CONFIG_UART_NRF5_ASYNC
+	.callback_set     = uarte_nrf5_callback_set,    /** Asynchronous API callback setting function */
+	.tx               = uarte_nrf5_tx,              /** Asynchronous transmission function */
+	.tx_abort         = uarte_nrf5_tx_abort,        /** Asynchronous transmission aborting function */
+	.rx_enable        = uarte_nrf5_rx_enable,       /** Asynchronous reception enabling function */
+	.rx_buf_rsp       = uarte_nrf5_rx_buf_rsp,      /** Asynchronous reception next buffer function */
+	.rx_disable       = uarte_nrf5_rx_disable,      /** Asynchronous reception disabling function */
+#endif /* CONFIG_UART_NRF5_ASYNC */
 };
 
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
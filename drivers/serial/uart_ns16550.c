@@ -32,6 +32,11 @@
 #include <sections.h>
 #include <uart.h>
 #include <sys_io.h>
+#include <misc/util.h>
+
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+#include <misc/ring_buffer.h>
+#endif
 
 #ifdef CONFIG_PCI
 #include <pci/pci.h>
@@ -121,6 +126,17 @@
  */
 #define FCR_FIFO_64 0x20 /* Enable 64 bytes FIFO */
 
+/* RCVR FIFO interrupt level, scaled to the FIFO size by the hardware */
+#if defined(CONFIG_UART_NS16550_RX_TRIGGER_1)
+#define FCR_RX_TRIGGER FCR_FIFO_1
+#elif defined(CONFIG_UART_NS16550_RX_TRIGGER_QUARTER)
+#define FCR_RX_TRIGGER FCR_FIFO_4
+#elif defined(CONFIG_UART_NS16550_RX_TRIGGER_NEARLY_FULL)
+#define FCR_RX_TRIGGER FCR_FIFO_14
+#else
+#define FCR_RX_TRIGGER FCR_FIFO_8
+#endif
+
 /* constants for line control register */
 
 #define LCR_CS5 0x00   /* 5 bits data size */
@@ -224,6 +240,12 @@ struct uart_ns16550_dev_data_t {
 	uart_irq_callback_t	cb;	/**< Callback function pointer */
 #endif
 
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	struct byte_ring_buf rx_ring;	/**< Bytes drained from RX FIFO */
+	uint8_t rx_buf[CONFIG_UART_NS16550_RX_BUF_SIZE];
+	uint8_t rx_errors;	/**< LSR errors seen while draining */
+#endif
+
 #ifdef CONFIG_UART_NS16550_DLF
 	uint8_t dlf;		/**< DLF value */
 #endif
@@ -320,6 +342,12 @@ static int uart_ns16550_init(struct device *dev)
 	dev_data->iir_cache = 0;
 #endif
 
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	sys_byte_ring_buf_init(&dev_data->rx_ring, sizeof(dev_data->rx_buf),
+			       dev_data->rx_buf);
+	dev_data->rx_errors = 0;
+#endif
+
 	old_level = irq_lock();
 
 	set_baud_rate(dev, dev_data->baud_rate);
@@ -339,11 +367,12 @@ static int uart_ns16550_init(struct device *dev)
 
 	/*
 	 * Program FIFO: enabled, mode 0 (set for compatibility with quark),
-	 * generate the interrupt at 8th byte
+	 * generate the interrupt at the configured trigger level
 	 * Clear TX and RX FIFO
 	 */
 	OUTBYTE(FCR(dev),
-		FCR_FIFO | FCR_MODE0 | FCR_FIFO_8 | FCR_RCVRCLR | FCR_XMITCLR
+		FCR_FIFO | FCR_MODE0 | FCR_RX_TRIGGER | FCR_RCVRCLR
+		| FCR_XMITCLR
 #ifdef CONFIG_UART_NS16750
 		| FCR_FIFO_64
 #endif
@@ -419,11 +448,79 @@ static unsigned char uart_ns16550_poll_out(struct device *dev,
  */
 static int uart_ns16550_err_check(struct device *dev)
 {
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	struct uart_ns16550_dev_data_t * const dev_data = DEV_DATA(dev);
+	unsigned int key;
+	uint8_t lsr;
+
+	key = irq_lock();
+
+	lsr = INBYTE(LSR(dev)) | dev_data->rx_errors;
+	dev_data->rx_errors = 0;
+
+	irq_unlock(key);
+
+	return (lsr & LSR_EOB_MASK) >> 1;
+#else
 	return (INBYTE(LSR(dev)) & LSR_EOB_MASK) >> 1;
+#endif
 }
 
 #if CONFIG_UART_INTERRUPT_DRIVEN
 
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+
+/**
+ * @brief Drain the RX FIFO into the receive buffer
+ *
+ * The bytes are read in place into the ring buffer. Those not fitting
+ * are dropped, so that the RX interrupt does not fire again, and reported
+ * as an overrun by err_check.
+ *
+ * @param dev UART device struct
+ *
+ * @return N/A
+ */
+static void rx_drain(struct device *dev)
+{
+	struct uart_ns16550_dev_data_t * const dev_data = DEV_DATA(dev);
+	unsigned int key;
+	uint32_t len, i;
+	uint8_t *data;
+	uint8_t lsr;
+
+	key = irq_lock();
+
+	do {
+		len = sys_byte_ring_buf_put_claim(&dev_data->rx_ring, &data,
+						  UINT32_MAX);
+
+		for (i = 0; i < len; i++) {
+			lsr = INBYTE(LSR(dev));
+			dev_data->rx_errors |= lsr & LSR_EOB_MASK;
+
+			if (!(lsr & LSR_RXRDY)) {
+				break;
+			}
+
+			data[i] = INBYTE(RDR(dev));
+		}
+
+		sys_byte_ring_buf_put_finish(&dev_data->rx_ring, i);
+	} while (len && i == len);
+
+	if (!len) {
+		while (INBYTE(LSR(dev)) & LSR_RXRDY) {
+			INBYTE(RDR(dev));
+			dev_data->rx_errors |= LSR_OE;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+#endif /* CONFIG_UART_NS16550_RX_BUFFERED */
+
 /**
  * @brief Fill FIFO with data
  *
@@ -438,7 +535,17 @@ static int uart_ns16550_fifo_fill(struct device *dev, const uint8_t *tx_data,
 {
 	int i;
 
-	for (i = 0; i < size && (INBYTE(LSR(dev)) & LSR_THRE) != 0; i++) {
+	/*
+	 * THRE is only set once the whole XMIT FIFO is empty, it is then
+	 * filled in one pass
+	 */
+	if ((INBYTE(LSR(dev)) & LSR_THRE) == 0) {
+		return 0;
+	}
+
+	size = min(size, CONFIG_UART_NS16550_FIFO_SIZE);
+
+	for (i = 0; i < size; i++) {
 		OUTBYTE(THR(dev), tx_data[i]);
 	}
 	return i;
@@ -456,6 +563,11 @@ static int uart_ns16550_fifo_fill(struct device *dev, const uint8_t *tx_data,
 static int uart_ns16550_fifo_read(struct device *dev, uint8_t *rx_data,
 				  const int size)
 {
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	rx_drain(dev);
+
+	return sys_byte_ring_buf_get(&DEV_DATA(dev)->rx_ring, rx_data, size);
+#else
 	int i;
 
 	for (i = 0; i < size && (INBYTE(LSR(dev)) & LSR_RXRDY) != 0; i++) {
@@ -463,6 +575,7 @@ static int uart_ns16550_fifo_read(struct device *dev, uint8_t *rx_data,
 	}
 
 	return i;
+#endif
 }
 
 /**
@@ -546,7 +659,11 @@ static void uart_ns16550_irq_rx_disable(struct device *dev)
  */
 static int uart_ns16550_irq_rx_ready(struct device *dev)
 {
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	return !sys_byte_ring_buf_is_empty(&DEV_DATA(dev)->rx_ring);
+#else
 	return ((IIRC(dev) & IIR_ID) == IIR_RBRF);
+#endif
 }
 
 /**
@@ -582,6 +699,12 @@ static void uart_ns16550_irq_err_disable(struct device *dev)
  */
 static int uart_ns16550_irq_is_pending(struct device *dev)
 {
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	if (!sys_byte_ring_buf_is_empty(&DEV_DATA(dev)->rx_ring)) {
+		return 1;
+	}
+#endif
+
 	return (!(IIRC(dev) & IIR_NIP));
 }
 
@@ -594,6 +717,11 @@ static int uart_ns16550_irq_is_pending(struct device *dev)
  */
 static int uart_ns16550_irq_update(struct device *dev)
 {
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	/* Bytes received since the ISR was entered clear the RX interrupt */
+	rx_drain(dev);
+#endif
+
 	IIRC(dev) = INBYTE(IIR(dev));
 
 	return 1;
@@ -618,7 +746,8 @@ static void uart_ns16550_irq_callback_set(struct device *dev,
 /**
  * @brief Interrupt service routine.
  *
- * This simply calls the callback function, if one exists.
+ * This simply calls the callback function, if one exists. In buffered
+ * mode, the RX FIFO is first drained into the receive buffer.
  *
  * @param arg Argument to ISR.
  *
@@ -629,6 +758,10 @@ static void uart_ns16550_isr(void *arg)
 	struct device *dev = arg;
 	struct uart_ns16550_dev_data_t * const dev_data = DEV_DATA(dev);
 
+#ifdef CONFIG_UART_NS16550_RX_BUFFERED
+	rx_drain(dev);
+#endif
+
 	if (dev_data->cb) {
 		dev_data->cb(dev);
 	}
@@ -742,6 +875,9 @@ static const struct uart_driver_api uart_ns16550_driver_api = {
 #endif
 };
 
+UART_DIRECT_API_DEFINE(uart_ns16550_driver_api, uart_ns16550_poll_in,
+		       uart_ns16550_poll_out);
+
 #ifdef CONFIG_UART_NS16550_PORT_0
 
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
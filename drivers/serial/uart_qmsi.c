@@ -453,6 +453,8 @@ static const struct uart_driver_api api = {
 #endif /* CONFIG_UART_DRV_CMD */
 };
 
+UART_DIRECT_API_DEFINE(api, uart_qmsi_poll_in, uart_qmsi_poll_out);
+
 static int uart_qmsi_init(struct device *dev)
 {
 	const struct uart_qmsi_config_info *config = dev->config->config_info;
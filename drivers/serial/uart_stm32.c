@@ -23,6 +23,7 @@
 #include <init.h>
 #include <uart.h>
 #include <clock_control.h>
+#include <power.h>
 
 #include <sections.h>
 #include <clock_control/stm32_clock_control.h>
@@ -78,6 +79,387 @@ static inline void __uart_stm32_get_clock(struct device *dev)
 	data->clock = clk;
 }
 
+#ifdef CONFIG_UART_STM32_ASYNC
+
+static void uart_stm32_notify(struct uart_stm32_data *data,
+			      struct uart_event *evt)
+{
+	if (data->async_cb) {
+		data->async_cb(data->dev, evt, data->async_user_data);
+	}
+}
+
+static int uart_stm32_callback_set(struct device *dev, uart_callback_t cb,
+				   void *user_data)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+
+	data->async_user_data = user_data;
+	data->async_cb = cb;
+
+	return 0;
+}
+
+static int uart_stm32_tx(struct device *dev, const uint8_t *buf, size_t len)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	UART_HandleTypeDef *UartHandle = &data->huart;
+	unsigned int key;
+
+	if (!data->async_cb) {
+		return -EACCES;
+	}
+
+	/* Counted by the 16 bit NDTR of the stream */
+	if (len > 0xFFFF) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (data->tx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	data->tx_buf = buf;
+	data->tx_len = len;
+
+	irq_unlock(key);
+
+	if (HAL_UART_Transmit_DMA(UartHandle, (uint8_t *)buf, len) != HAL_OK) {
+		data->tx_buf = NULL;
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int uart_stm32_tx_abort(struct device *dev)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	struct uart_event evt;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (!data->tx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	evt.type = UART_TX_ABORTED;
+	evt.data.tx.buf = data->tx_buf;
+	evt.data.tx.len = data->tx_len -
+			  __HAL_DMA_GET_COUNTER(&data->hdma_tx);
+
+	HAL_UART_AbortTransmit(&data->huart);
+	data->tx_buf = NULL;
+
+	irq_unlock(key);
+
+	uart_stm32_notify(data, &evt);
+
+	return 0;
+}
+
+/* Reports the data received since the last report */
+static void uart_stm32_rx_rdy(struct uart_stm32_data *data, size_t count)
+{
+	struct uart_event evt;
+
+	if (count <= data->rx_offset) {
+		return;
+	}
+
+	evt.type = UART_RX_RDY;
+	evt.data.rx.buf = data->rx_buf;
+	evt.data.rx.offset = data->rx_offset;
+	evt.data.rx.len = count - data->rx_offset;
+
+	data->rx_offset = count;
+
+	uart_stm32_notify(data, &evt);
+}
+
+static void uart_stm32_rx_release(struct uart_stm32_data *data, uint8_t *buf)
+{
+	struct uart_event evt;
+
+	evt.type = UART_RX_BUF_RELEASED;
+	evt.data.rx_buf.buf = buf;
+
+	uart_stm32_notify(data, &evt);
+}
+
+static int uart_stm32_rx_start(struct uart_stm32_data *data)
+{
+	struct uart_event evt;
+
+	data->rx_offset = 0;
+
+	if (HAL_UART_Receive_DMA(&data->huart, data->rx_buf,
+				 data->rx_len) != HAL_OK) {
+		return -EBUSY;
+	}
+
+	evt.type = UART_RX_BUF_REQUEST;
+	uart_stm32_notify(data, &evt);
+
+	return 0;
+}
+
+static void uart_stm32_rx_end(struct uart_stm32_data *data)
+{
+	struct uart_event evt;
+
+	__HAL_UART_DISABLE_IT(&data->huart, UART_IT_IDLE);
+
+	data->rx_buf = NULL;
+
+	evt.type = UART_RX_DISABLED;
+	uart_stm32_notify(data, &evt);
+}
+
+static int uart_stm32_rx_enable(struct device *dev, uint8_t *buf, size_t len,
+				uint32_t timeout)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	UART_HandleTypeDef *UartHandle = &data->huart;
+	int err;
+
+	if (!data->async_cb) {
+		return -EACCES;
+	}
+
+	if (data->rx_buf) {
+		return -EBUSY;
+	}
+
+	if (len > 0xFFFF) {
+		return -EINVAL;
+	}
+
+	data->rx_buf = buf;
+	data->rx_len = len;
+	data->rx_next_buf = NULL;
+
+	/* The idle line is detected by the USART, after a character time */
+	if (timeout) {
+		__HAL_UART_CLEAR_IDLEFLAG(UartHandle);
+		__HAL_UART_ENABLE_IT(UartHandle, UART_IT_IDLE);
+	}
+
+	err = uart_stm32_rx_start(data);
+	if (err) {
+		__HAL_UART_DISABLE_IT(UartHandle, UART_IT_IDLE);
+		data->rx_buf = NULL;
+	}
+
+	return err;
+}
+
+static int uart_stm32_rx_buf_rsp(struct device *dev, uint8_t *buf, size_t len)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	unsigned int key;
+	int err = 0;
+
+	if (len > 0xFFFF) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (!data->rx_buf) {
+		err = -EACCES;
+	} else if (data->rx_next_buf) {
+		err = -EBUSY;
+	} else {
+		data->rx_next_buf = buf;
+		data->rx_next_len = len;
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+static int uart_stm32_rx_disable(struct device *dev)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (!data->rx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	uart_stm32_rx_rdy(data, data->rx_len -
+			  __HAL_DMA_GET_COUNTER(&data->hdma_rx));
+	HAL_UART_AbortReceive(&data->huart);
+
+	uart_stm32_rx_release(data, data->rx_buf);
+
+	if (data->rx_next_buf) {
+		uart_stm32_rx_release(data, data->rx_next_buf);
+		data->rx_next_buf = NULL;
+	}
+
+	uart_stm32_rx_end(data);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+/* Completion callbacks of the HAL, called from its IRQ handlers */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+	struct uart_stm32_data *data = CONTAINER_OF(huart,
+						    struct uart_stm32_data,
+						    huart);
+	struct uart_event evt;
+
+	evt.type = UART_TX_DONE;
+	evt.data.tx.buf = data->tx_buf;
+	evt.data.tx.len = data->tx_len;
+
+	data->tx_buf = NULL;
+
+	uart_stm32_notify(data, &evt);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	struct uart_stm32_data *data = CONTAINER_OF(huart,
+						    struct uart_stm32_data,
+						    huart);
+
+	/* The buffer is full, go on with the next one */
+	uart_stm32_rx_rdy(data, data->rx_len);
+	uart_stm32_rx_release(data, data->rx_buf);
+
+	if (data->rx_next_buf) {
+		data->rx_buf = data->rx_next_buf;
+		data->rx_len = data->rx_next_len;
+		data->rx_next_buf = NULL;
+
+		if (!uart_stm32_rx_start(data)) {
+			return;
+		}
+
+		uart_stm32_rx_release(data, data->rx_buf);
+	}
+
+	uart_stm32_rx_end(data);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	struct uart_stm32_data *data = CONTAINER_OF(huart,
+						    struct uart_stm32_data,
+						    huart);
+	struct uart_event evt;
+
+	if (!data->rx_buf) {
+		return;
+	}
+
+	evt.type = UART_RX_STOPPED;
+	evt.data.rx_stop.reason = 0;
+
+	if (huart->ErrorCode & HAL_UART_ERROR_ORE) {
+		evt.data.rx_stop.reason |= UART_ERROR_OVERRUN;
+	}
+
+	if (huart->ErrorCode & HAL_UART_ERROR_PE) {
+		evt.data.rx_stop.reason |= UART_ERROR_PARITY;
+	}
+
+	if (huart->ErrorCode & HAL_UART_ERROR_FE) {
+		evt.data.rx_stop.reason |= UART_ERROR_FRAMING;
+	}
+
+	uart_stm32_notify(data, &evt);
+
+	uart_stm32_rx_disable(data->dev);
+}
+
+static void uart_stm32_isr_async(struct uart_stm32_data *data)
+{
+	UART_HandleTypeDef *UartHandle = &data->huart;
+
+	if (__HAL_UART_GET_FLAG(UartHandle, UART_FLAG_IDLE) &&
+	    __HAL_UART_GET_IT_SOURCE(UartHandle, UART_IT_IDLE)) {
+		__HAL_UART_CLEAR_IDLEFLAG(UartHandle);
+
+		if (data->rx_buf) {
+			size_t count = data->rx_len -
+				       __HAL_DMA_GET_COUNTER(&data->hdma_rx);
+
+			uart_stm32_rx_rdy(data, count);
+		}
+	}
+
+	HAL_UART_IRQHandler(UartHandle);
+}
+
+static void uart_stm32_dma_tx_isr(void *arg)
+{
+	struct device *dev = arg;
+
+	HAL_DMA_IRQHandler(&DEV_DATA(dev)->hdma_tx);
+}
+
+static void uart_stm32_dma_rx_isr(void *arg)
+{
+	struct device *dev = arg;
+
+	HAL_DMA_IRQHandler(&DEV_DATA(dev)->hdma_rx);
+}
+
+static void uart_stm32_dma_setup(DMA_HandleTypeDef *hdma,
+				 DMA_Stream_TypeDef *stream, uint32_t channel,
+				 uint32_t direction)
+{
+	hdma->Instance = stream;
+	hdma->Init.Channel = channel;
+	hdma->Init.Direction = direction;
+	hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma->Init.MemInc = DMA_MINC_ENABLE;
+	hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma->Init.Mode = DMA_NORMAL;
+	hdma->Init.Priority = DMA_PRIORITY_HIGH;
+	hdma->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+	HAL_DMA_Init(hdma);
+}
+
+static void uart_stm32_dma_init(struct device *dev)
+{
+	const struct uart_stm32_config *config = DEV_CFG(dev);
+	struct uart_stm32_data *data = DEV_DATA(dev);
+
+	data->dev = dev;
+
+	__HAL_RCC_DMA1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	uart_stm32_dma_setup(&data->hdma_tx, config->dma_tx_stream,
+			     config->dma_channel, DMA_MEMORY_TO_PERIPH);
+	__HAL_LINKDMA(&data->huart, hdmatx, data->hdma_tx);
+
+	uart_stm32_dma_setup(&data->hdma_rx, config->dma_rx_stream,
+			     config->dma_channel, DMA_PERIPH_TO_MEMORY);
+	__HAL_LINKDMA(&data->huart, hdmarx, data->hdma_rx);
+}
+
+#endif /* CONFIG_UART_STM32_ASYNC */
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 
 static int uart_stm32_fifo_fill(struct device *dev, const uint8_t *tx_data,
@@ -245,6 +627,13 @@ static void uart_stm32_isr(void *arg)
 	struct device *dev = arg;
 	struct uart_stm32_data *data = DEV_DATA(dev);
 
+#ifdef CONFIG_UART_STM32_ASYNC
+	if (data->async_cb) {
+		uart_stm32_isr_async(data);
+		return;
+	}
+#endif
+
 	if (data->user_cb) {
 		data->user_cb(dev);
 	}
@@ -271,6 +660,14 @@ static const struct uart_driver_api uart_stm32_driver_api = {
 	.irq_update = uart_stm32_irq_update,
 	.irq_callback_set = uart_stm32_irq_callback_set,
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
+#ifdef CONFIG_UART_STM32_ASYNC
+	.callback_set = uart_stm32_callback_set,
+	.tx = uart_stm32_tx,
+	.tx_abort = uart_stm32_tx_abort,
+	.rx_enable = uart_stm32_rx_enable,
+	.rx_buf_rsp = uart_stm32_rx_buf_rsp,
+	.rx_disable = uart_stm32_rx_disable,
+#endif	/* CONFIG_UART_STM32_ASYNC */
 };
 
 /**
@@ -283,6 +680,32 @@ static const struct uart_driver_api uart_stm32_driver_api = {
  *
  * @return 0
  */
+#ifdef CONFIG_SYS_DVFS
+/* The bus clocks are divided down from the CPU clock. The HAL computes the
+ * baud rate divider from SystemCoreClock, which the clock controller keeps
+ * up to date.
+ */
+static void uart_stm32_dvfs_notify(struct sys_dvfs_notifier *notifier,
+				   enum sys_dvfs_event event, uint32_t rate)
+{
+	struct uart_stm32_data *data = CONTAINER_OF(notifier,
+						    struct uart_stm32_data,
+						    dvfs_notifier);
+	UART_HandleTypeDef *UartHandle = &data->huart;
+
+	ARG_UNUSED(rate);
+
+	if (event == SYS_DVFS_PRE_CHANGE) {
+		/* finish sending the character going out at the old rate */
+		while (!__HAL_UART_GET_FLAG(UartHandle, UART_FLAG_TC)) {
+		}
+		return;
+	}
+
+	HAL_UART_Init(UartHandle);
+}
+#endif
+
 static int uart_stm32_init(struct device *dev)
 {
 	const struct uart_stm32_config *config = DEV_CFG(dev);
@@ -309,6 +732,15 @@ static int uart_stm32_init(struct device *dev)
 
 	HAL_UART_Init(UartHandle);
 
+#ifdef CONFIG_SYS_DVFS
+	data->dvfs_notifier.cb = uart_stm32_dvfs_notify;
+	sys_dvfs_notifier_register(&data->dvfs_notifier);
+#endif
+
+#ifdef CONFIG_UART_STM32_ASYNC
+	uart_stm32_dma_init(dev);
+#endif
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	config->uconf.irq_config_func(dev);
 #endif
@@ -329,6 +761,11 @@ static const struct uart_stm32_config uart_stm32_dev_cfg_1 = {
 		.irq_config_func = uart_stm32_irq_config_func_1,
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 	},
+#ifdef CONFIG_UART_STM32_ASYNC
+	.dma_tx_stream = DMA2_Stream7,
+	.dma_rx_stream = DMA2_Stream5,
+	.dma_channel = DMA_CHANNEL_4,
+#endif	/* CONFIG_UART_STM32_ASYNC */
 #ifdef CONFIG_CLOCK_CONTROL_STM32_CUBE
 	.pclken = { .bus = STM32_CLOCK_BUS_APB2,
 		    .enr = LL_APB2_GRP1_PERIPH_USART1 },
@@ -374,6 +811,20 @@ static void uart_stm32_irq_config_func_1(struct device *dev)
 		uart_stm32_isr, DEVICE_GET(uart_stm32_1),
 		0);
 	irq_enable(PORT_1_IRQ);
+
+#ifdef CONFIG_UART_STM32_ASYNC
+	IRQ_CONNECT(STM32F4_IRQ_DMA2_STREAM7,
+		CONFIG_UART_STM32_PORT_1_IRQ_PRI,
+		uart_stm32_dma_tx_isr, DEVICE_GET(uart_stm32_1),
+		0);
+	irq_enable(STM32F4_IRQ_DMA2_STREAM7);
+
+	IRQ_CONNECT(STM32F4_IRQ_DMA2_STREAM5,
+		CONFIG_UART_STM32_PORT_1_IRQ_PRI,
+		uart_stm32_dma_rx_isr, DEVICE_GET(uart_stm32_1),
+		0);
+	irq_enable(STM32F4_IRQ_DMA2_STREAM5);
+#endif	/* CONFIG_UART_STM32_ASYNC */
 }
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 
@@ -393,6 +844,11 @@ static const struct uart_stm32_config uart_stm32_dev_cfg_2 = {
 		.irq_config_func = uart_stm32_irq_config_func_2,
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 	},
+#ifdef CONFIG_UART_STM32_ASYNC
+	.dma_tx_stream = DMA1_Stream6,
+	.dma_rx_stream = DMA1_Stream5,
+	.dma_channel = DMA_CHANNEL_4,
+#endif	/* CONFIG_UART_STM32_ASYNC */
 #ifdef CONFIG_CLOCK_CONTROL_STM32_CUBE
 	.pclken = { .bus = STM32_CLOCK_BUS_APB1,
 		    .enr = LL_APB1_GRP1_PERIPH_USART2 },
@@ -438,6 +894,20 @@ static void uart_stm32_irq_config_func_2(struct device *dev)
 		uart_stm32_isr, DEVICE_GET(uart_stm32_2),
 		0);
 	irq_enable(PORT_2_IRQ);
+
+#ifdef CONFIG_UART_STM32_ASYNC
+	IRQ_CONNECT(STM32F4_IRQ_DMA1_STREAM6,
+		CONFIG_UART_STM32_PORT_2_IRQ_PRI,
+		uart_stm32_dma_tx_isr, DEVICE_GET(uart_stm32_2),
+		0);
+	irq_enable(STM32F4_IRQ_DMA1_STREAM6);
+
+	IRQ_CONNECT(STM32F4_IRQ_DMA1_STREAM5,
+		CONFIG_UART_STM32_PORT_2_IRQ_PRI,
+		uart_stm32_dma_rx_isr, DEVICE_GET(uart_stm32_2),
+		0);
+	irq_enable(STM32F4_IRQ_DMA1_STREAM5);
+#endif	/* CONFIG_UART_STM32_ASYNC */
 }
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 
@@ -457,6 +927,11 @@ static const struct uart_stm32_config uart_stm32_dev_cfg_3 = {
 		.irq_config_func = uart_stm32_irq_config_func_3,
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 	},
+#ifdef CONFIG_UART_STM32_ASYNC
+	.dma_tx_stream = DMA1_Stream3,
+	.dma_rx_stream = DMA1_Stream1,
+	.dma_channel = DMA_CHANNEL_4,
+#endif	/* CONFIG_UART_STM32_ASYNC */
 #ifdef CONFIG_CLOCK_CONTROL_STM32_CUBE
 	.pclken = { .bus = STM32_CLOCK_BUS_APB1,
 		    .enr = LL_APB1_GRP1_PERIPH_USART3 },
@@ -500,6 +975,20 @@ static void uart_stm32_irq_config_func_3(struct device *dev)
 		uart_stm32_isr, DEVICE_GET(uart_stm32_3),
 		0);
 	irq_enable(PORT_3_IRQ);
+
+#ifdef CONFIG_UART_STM32_ASYNC
+	IRQ_CONNECT(STM32F4_IRQ_DMA1_STREAM3,
+		CONFIG_UART_STM32_PORT_3_IRQ_PRI,
+		uart_stm32_dma_tx_isr, DEVICE_GET(uart_stm32_3),
+		0);
+	irq_enable(STM32F4_IRQ_DMA1_STREAM3);
+
+	IRQ_CONNECT(STM32F4_IRQ_DMA1_STREAM1,
+		CONFIG_UART_STM32_PORT_3_IRQ_PRI,
+		uart_stm32_dma_rx_isr, DEVICE_GET(uart_stm32_3),
+		0);
+	irq_enable(STM32F4_IRQ_DMA1_STREAM1);
+#endif	/* CONFIG_UART_STM32_ASYNC */
 }
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 
@@ -25,6 +25,12 @@ struct uart_stm32_config {
 	struct stm32f4x_pclken pclken;
 #endif
 #endif /* CONFIG_CLOCK_CONTROL_STM32_CUBE */
+#ifdef CONFIG_UART_STM32_ASYNC
+	/* DMA streams of the port, and their channel */
+	DMA_Stream_TypeDef *dma_tx_stream;
+	DMA_Stream_TypeDef *dma_rx_stream;
+	uint32_t dma_channel;
+#endif
 };
 
 /* driver data */
@@ -36,6 +42,25 @@ struct uart_stm32_data {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	uart_irq_callback_t user_cb;
 #endif
+#ifdef CONFIG_UART_STM32_ASYNC
+	/* device, for the HAL callbacks */
+	struct device *dev;
+	DMA_HandleTypeDef hdma_tx;
+	DMA_HandleTypeDef hdma_rx;
+	uart_callback_t async_cb;
+	void *async_user_data;
+	const uint8_t *tx_buf;
+	size_t tx_len;
+	uint8_t *rx_buf;
+	size_t rx_len;
+	size_t rx_offset;
+	uint8_t *rx_next_buf;
+	size_t rx_next_len;
+#endif
+#ifdef CONFIG_SYS_DVFS
+	/* baud rate recomputed on CPU clock changes */
+	struct sys_dvfs_notifier dvfs_notifier;
+#endif
 };
 
 #endif	/* _STM32_UART_H_ */
@@ -40,6 +40,28 @@ static int isr_register(struct device *dev, isr_t isr_func,
 	return -EIO;
 }
 
+/**
+ *  @brief Register a status query for a device ISR
+ *  @param dev Pointer to device structure for SHARED_IRQ driver instance.
+ *  @param pending_func Pointer to the status query for the device.
+ *  @param isr_dev Pointer to the device that will service the interrupt.
+ */
+static int pending_register(struct device *dev, isr_pending_t pending_func,
+			    struct device *isr_dev)
+{
+	struct shared_irq_runtime *clients = dev->driver_data;
+	const struct shared_irq_config *config = dev->config->config_info;
+	uint32_t i;
+
+	for (i = 0; i < config->client_count; i++) {
+		if (clients->client[i].isr_dev == isr_dev) {
+			clients->client[i].pending_func = pending_func;
+			return 0;
+		}
+	}
+	return -EIO;
+}
+
 /**
  *  @brief Enable ISR for device
  *  @param dev Pointer to device structure for SHARED_IRQ driver instance.
@@ -95,16 +117,78 @@ static inline int disable(struct device *dev, struct device *isr_dev)
 	return -EIO;
 }
 
+#ifdef CONFIG_SHARED_IRQ_STATS
+static int stats_get(struct device *dev, struct device *isr_dev,
+		     struct shared_irq_stats *stats)
+{
+	struct shared_irq_runtime *clients = dev->driver_data;
+	const struct shared_irq_config *config = dev->config->config_info;
+	unsigned int key;
+	uint32_t i;
+
+	for (i = 0; i < config->client_count; i++) {
+		if (clients->client[i].isr_dev == isr_dev) {
+			key = irq_lock();
+			*stats = clients->client[i].stats;
+			irq_unlock(key);
+			return 0;
+		}
+	}
+	return -EIO;
+}
+
+static inline void client_call(struct shared_irq_client *client,
+			       uint32_t start)
+{
+	struct shared_irq_stats *stats = &client->stats;
+	uint32_t entry, cycles;
+
+	entry = k_cycle_get_32();
+	client->isr_func(client->isr_dev);
+	cycles = k_cycle_get_32() - entry;
+
+	stats->calls++;
+	stats->cycles_total += cycles;
+	if (cycles > stats->cycles_max) {
+		stats->cycles_max = cycles;
+	}
+	if (entry - start > stats->latency_max) {
+		stats->latency_max = entry - start;
+	}
+}
+#endif /* CONFIG_SHARED_IRQ_STATS */
+
 void shared_irq_isr(struct device *dev)
 {
 	struct shared_irq_runtime *clients = dev->driver_data;
 	const struct shared_irq_config *config = dev->config->config_info;
+	struct shared_irq_client *client;
 	uint32_t i;
+#ifdef CONFIG_SHARED_IRQ_STATS
+	uint32_t start = k_cycle_get_32();
+#endif
 
 	for (i = 0; i < config->client_count; i++) {
-		if (clients->client[i].isr_dev) {
-			clients->client[i].isr_func(clients->client[i].isr_dev);
+		client = &clients->client[i];
+
+		if (!client->isr_dev || !client->enabled) {
+			continue;
 		}
+
+		/* Clients able to tell are only called if they are pending */
+		if (client->pending_func &&
+		    !client->pending_func(client->isr_dev)) {
+#ifdef CONFIG_SHARED_IRQ_STATS
+			client->stats.skipped++;
+#endif
+			continue;
+		}
+
+#ifdef CONFIG_SHARED_IRQ_STATS
+		client_call(client, start);
+#else
+		client->isr_func(client->isr_dev);
+#endif
 	}
 }
 
@@ -112,6 +196,10 @@ static const struct shared_irq_driver_api api_funcs = {
 	.isr_register = isr_register,
 	.enable = enable,
 	.disable = disable,
+	.pending_register = pending_register,
+#ifdef CONFIG_SHARED_IRQ_STATS
+	.stats_get = stats_get,
+#endif
 };
 
 
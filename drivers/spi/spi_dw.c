@@ -53,52 +53,6 @@
 		((CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / ssi_clk_hz) & 0xFFFF)
 #endif
 
-static void completed(struct device *dev, int error)
-{
-	const struct spi_dw_config *info = dev->config->config_info;
-	struct spi_dw_data *spi = dev->driver_data;
-
-	if (error) {
-		goto out;
-	}
-
-	/*
-	* There are several situations here.
-	* 1. spi_write w rx_buf - need last_tx && rx_buf_len zero to be done.
-	* 2. spi_write w/o rx_buf - only need to determine when write is done.
-	* 3. spi_read - need rx_buf_len zero.
-	*/
-	if (spi->tx_buf && spi->rx_buf) {
-		if (!spi->last_tx || spi->rx_buf_len)
-			return;
-	} else if (spi->tx_buf) {
-		if (!spi->last_tx)
-			return;
-	} else { /* or, spi->rx_buf!=0 */
-		if (spi->rx_buf_len)
-			return;
-	}
-
-out:
-	/* need to give time for FIFOs to drain before issuing more commands */
-	while (test_bit_sr_busy(info->regs)) {
-	}
-
-	spi->error = error;
-
-	/* Disabling interrupts */
-	write_imr(DW_SPI_IMR_MASK, info->regs);
-	/* Disabling the controller */
-	clear_bit_ssienr(info->regs);
-
-	_spi_control_cs(dev, 0);
-
-	SYS_LOG_DBG("SPI transaction completed %s error",
-	    error ? "with" : "without");
-
-	k_sem_give(&spi->device_sync_sem);
-}
-
 static void push_data(struct device *dev)
 {
 	const struct spi_dw_config *info = dev->config->config_info;
@@ -217,8 +171,8 @@ static inline bool _spi_dw_is_controller_ready(struct device *dev)
 	return true;
 }
 
-static int spi_dw_configure(struct device *dev,
-				struct spi_config *config)
+/* Installs a configuration, the controller being disabled */
+static void _spi_dw_config_set(struct device *dev, struct spi_config *config)
 {
 	const struct spi_dw_config *info = dev->config->config_info;
 	struct spi_dw_data *spi = dev->driver_data;
@@ -226,14 +180,6 @@ static int spi_dw_configure(struct device *dev,
 	uint32_t ctrlr0 = 0;
 	uint32_t mode;
 
-	SYS_LOG_DBG("%s: %p (0x%x), %p", __func__, dev, info->regs, config);
-
-	/* Check status */
-	if (!_spi_dw_is_controller_ready(dev)) {
-		SYS_LOG_DBG("%s: Controller is busy", __func__);
-		return -EBUSY;
-	}
-
 	/* Word size */
 	ctrlr0 |= DW_SPI_CTRLR0_DFS(SPI_WORD_SIZE_GET(flags));
 
@@ -272,49 +218,114 @@ static int spi_dw_configure(struct device *dev,
 	} else {
 		write_baudr(config->max_sys_freq, info->regs);
 	}
-
-	return 0;
 }
 
-static int spi_dw_slave_select(struct device *dev, uint32_t slave)
+#ifdef CONFIG_SPI_DW_DMA
+/*
+ * Moves the frames of a transfer by DMA, the controller raising only
+ * error interrupts. Only transfers done with a single block per channel
+ * are taken: writes, and reads of the length of the write. The others
+ * are left to the ISR.
+ */
+static bool _spi_dw_dma_start(struct device *dev,
+			      const struct spi_transfer *xfer)
 {
+	const struct spi_dw_config *info = dev->config->config_info;
 	struct spi_dw_data *spi = dev->driver_data;
+	struct dma_block_config rx_block = { 0 };
+	struct dma_block_config tx_block = { 0 };
+	struct dma_config cfg = { 0 };
+	uint32_t imask = DW_SPI_IMR_TXOIM;
 
-	SYS_LOG_DBG("%s: %p %d", __func__, dev, slave);
+	if (!spi->dma || !xfer->tx_len ||
+	    (xfer->rx_buf && xfer->rx_len != xfer->tx_len)) {
+		return false;
+	}
 
-	if (slave == 0 || slave > 16) {
-		return -EINVAL;
+	cfg.source_data_size = spi->dfs;
+	cfg.dest_data_size = spi->dfs;
+	cfg.source_burst_length = 1;
+	cfg.dest_burst_length = 1;
+	cfg.block_count = 1;
+	cfg.dma_callback = info->dma_callback;
+
+	spi->dma_pending = 1;
+
+	if (xfer->rx_buf) {
+		rx_block.source_address = info->regs + DW_SPI_REG_DR;
+		rx_block.source_addr_adj = DW_SPI_DMA_ADDR_FIXED;
+		rx_block.dest_address = POINTER_TO_UINT(xfer->rx_buf);
+		rx_block.block_size = xfer->rx_len;
+
+		cfg.dma_slot = info->dma_rx_slot;
+		cfg.channel_direction = PERIPHERAL_TO_MEMORY;
+		cfg.head_block = &rx_block;
+
+		if (dma_config(spi->dma, info->dma_rx_channel, &cfg)) {
+			return false;
+		}
+
+		imask |= DW_SPI_IMR_RXUIM | DW_SPI_IMR_RXOIM;
+		spi->dma_pending++;
 	}
 
-	spi->slave = 1 << (slave - 1);
+	tx_block.source_address = POINTER_TO_UINT(xfer->tx_buf);
+	tx_block.dest_address = info->regs + DW_SPI_REG_DR;
+	tx_block.dest_addr_adj = DW_SPI_DMA_ADDR_FIXED;
+	tx_block.block_size = xfer->tx_len;
 
-	return 0;
+	cfg.dma_slot = info->dma_tx_slot;
+	cfg.channel_direction = MEMORY_TO_PERIPHERAL;
+	cfg.head_block = &tx_block;
+
+	if (dma_config(spi->dma, info->dma_tx_channel, &cfg)) {
+		spi->dma_pending = 0;
+		return false;
+	}
+
+	/* Requests for each frame received, or room for half the FIFO */
+	write_dmardlr(0, info->regs);
+	write_dmatdlr(DW_SPI_TXFTLR_DFLT, info->regs);
+	write_dmacr(xfer->rx_buf ? DW_SPI_DMACR_RDMAE | DW_SPI_DMACR_TDMAE :
+		    DW_SPI_DMACR_TDMAE, info->regs);
+
+	write_imr(imask, info->regs);
+	set_bit_ssienr(info->regs);
+
+	if (xfer->rx_buf) {
+		dma_start(spi->dma, info->dma_rx_channel);
+	}
+
+	dma_start(spi->dma, info->dma_tx_channel);
+
+	return true;
 }
+#endif /* CONFIG_SPI_DW_DMA */
 
-static int spi_dw_transceive(struct device *dev,
-			     const void *tx_buf, uint32_t tx_buf_len,
-			     void *rx_buf, uint32_t rx_buf_len)
+/* Starts the current transfer of the current transaction */
+static void _spi_dw_transfer_start(struct device *dev)
 {
 	const struct spi_dw_config *info = dev->config->config_info;
 	struct spi_dw_data *spi = dev->driver_data;
+	const struct spi_transfer *xfer = &spi->trans->transfers[spi->transfer];
 	uint32_t rx_thsld = DW_SPI_RXFTLR_DFLT;
 	uint32_t imask;
 
-	SYS_LOG_DBG("%s: %p, %p, %u, %p, %u",
-	    __func__, dev, tx_buf, tx_buf_len, rx_buf, rx_buf_len);
+	SYS_LOG_DBG("%s: %p, %p, %u, %p, %u", __func__, dev,
+		    xfer->tx_buf, xfer->tx_len, xfer->rx_buf, xfer->rx_len);
 
-	/* Check status */
-	if (!_spi_dw_is_controller_ready(dev)) {
-		SYS_LOG_DBG("%s: Controller is busy", __func__);
-		return -EBUSY;
+#ifdef CONFIG_SPI_DW_DMA
+	if (_spi_dw_dma_start(dev, xfer)) {
+		return;
 	}
+#endif
 
 	/* Set buffers info */
-	spi->tx_buf = tx_buf;
-	spi->tx_buf_len = tx_buf_len/spi->dfs;
-	spi->rx_buf = rx_buf;
-	if (rx_buf) {
-		spi->rx_buf_len = rx_buf_len/spi->dfs;
+	spi->tx_buf = xfer->tx_buf;
+	spi->tx_buf_len = xfer->tx_len/spi->dfs;
+	spi->rx_buf = xfer->rx_buf;
+	if (xfer->rx_buf) {
+		spi->rx_buf_len = xfer->rx_len/spi->dfs;
 	} else {
 		spi->rx_buf_len = 0; /* must be zero if no buffer */
 	}
@@ -334,14 +345,9 @@ static int spi_dw_transceive(struct device *dev,
 
 	write_rxftlr(rx_thsld, info->regs);
 
-	/* Slave select */
-	write_ser(spi->slave, info->regs);
-
-	_spi_control_cs(dev, 1);
-
 	/* Enable interrupts */
 	imask = DW_SPI_IMR_UNMASK;
-	if (!rx_buf) {
+	if (!xfer->rx_buf) {
 		/* if there is no rx buffer, keep all rx interrupts masked */
 		imask &= DW_SPI_IMR_MASK_RX;
 	}
@@ -350,17 +356,251 @@ static int spi_dw_transceive(struct device *dev,
 
 	/* Enable the controller */
 	set_bit_ssienr(info->regs);
+}
+
+/* Starts the next queued transaction, if the controller is idle */
+static void _spi_dw_queue_next(struct device *dev)
+{
+	const struct spi_dw_config *info = dev->config->config_info;
+	struct spi_dw_data *spi = dev->driver_data;
+	struct spi_transaction *trans;
+	sys_snode_t *node;
+
+	if (spi->trans) {
+		return;
+	}
+
+	node = sys_slist_get(&spi->queue);
+	if (!node) {
+		return;
+	}
+
+	trans = CONTAINER_OF(node, struct spi_transaction, node);
+
+	/* The configuration of spi_configure() is back once it is over */
+	if (trans->config) {
+		_spi_dw_config_set(dev, trans->config);
+		spi->reconfigured = 1;
+	} else if (spi->reconfigured) {
+		_spi_dw_config_set(dev, &spi->config);
+		spi->reconfigured = 0;
+	}
+
+	/* Slave select */
+	if (trans->slave) {
+		write_ser(1 << (trans->slave - 1), info->regs);
+	} else {
+		write_ser(spi->slave, info->regs);
+	}
+
+	_spi_control_cs(dev, 1);
+
+	spi->trans = trans;
+	spi->transfer = 0;
+
+	_spi_dw_transfer_start(dev);
+}
+
+/*
+ * Ends the current transfer: the next one of the transaction is started,
+ * the slave staying selected, or the transaction is over and the next
+ * queued one is started.
+ */
+static void _spi_dw_transfer_done(struct device *dev, int error)
+{
+	const struct spi_dw_config *info = dev->config->config_info;
+	struct spi_dw_data *spi = dev->driver_data;
+	struct spi_transaction *trans = spi->trans;
+
+	/* need to give time for FIFOs to drain before issuing more commands */
+	while (test_bit_sr_busy(info->regs)) {
+	}
+
+	/* Disabling interrupts */
+	write_imr(DW_SPI_IMR_MASK, info->regs);
+	/* Disabling the controller */
+	clear_bit_ssienr(info->regs);
 
-	k_sem_take(&spi->device_sync_sem, K_FOREVER);
+	if (!error && ++spi->transfer < trans->count) {
+		_spi_dw_transfer_start(dev);
+		return;
+	}
 
-	if (spi->error) {
-		spi->error = 0;
-		return -EIO;
+	_spi_control_cs(dev, 0);
+
+	SYS_LOG_DBG("SPI transaction completed %s error",
+	    error ? "with" : "without");
+
+	spi->trans = NULL;
+	trans->callback(dev, trans, error ? -EIO : 0);
+
+	_spi_dw_queue_next(dev);
+}
+
+static void completed(struct device *dev, int error)
+{
+	struct spi_dw_data *spi = dev->driver_data;
+
+	if (error) {
+		goto out;
+	}
+
+	/*
+	* There are several situations here.
+	* 1. spi_write w rx_buf - need last_tx && rx_buf_len zero to be done.
+	* 2. spi_write w/o rx_buf - only need to determine when write is done.
+	* 3. spi_read - need rx_buf_len zero.
+	*/
+	if (spi->tx_buf && spi->rx_buf) {
+		if (!spi->last_tx || spi->rx_buf_len)
+			return;
+	} else if (spi->tx_buf) {
+		if (!spi->last_tx)
+			return;
+	} else { /* or, spi->rx_buf!=0 */
+		if (spi->rx_buf_len)
+			return;
 	}
 
+out:
+	_spi_dw_transfer_done(dev, error);
+}
+
+#ifdef CONFIG_SPI_DW_DMA
+static void _spi_dw_dma_stop(struct device *dev)
+{
+	const struct spi_dw_config *info = dev->config->config_info;
+	struct spi_dw_data *spi = dev->driver_data;
+
+	dma_stop(spi->dma, info->dma_tx_channel);
+	dma_stop(spi->dma, info->dma_rx_channel);
+
+	write_dmacr(0, info->regs);
+	spi->dma_pending = 0;
+}
+
+/* Called by the DMA callback of the port, for each of both channels */
+static void spi_dw_dma_done(struct device *dev, int error_code)
+{
+	const struct spi_dw_config *info = dev->config->config_info;
+	struct spi_dw_data *spi = dev->driver_data;
+
+	if (!spi->dma_pending) {
+		return;
+	}
+
+	if (error_code) {
+		_spi_dw_dma_stop(dev);
+		_spi_dw_transfer_done(dev, 1);
+		return;
+	}
+
+	if (--spi->dma_pending) {
+		return;
+	}
+
+	write_dmacr(0, info->regs);
+	_spi_dw_transfer_done(dev, 0);
+}
+#endif /* CONFIG_SPI_DW_DMA */
+
+static int spi_dw_configure(struct device *dev,
+				struct spi_config *config)
+{
+	struct spi_dw_data *spi = dev->driver_data;
+
+	SYS_LOG_DBG("%s: %p, %p", __func__, dev, config);
+
+	/* Check status */
+	if (spi->trans || !_spi_dw_is_controller_ready(dev)) {
+		SYS_LOG_DBG("%s: Controller is busy", __func__);
+		return -EBUSY;
+	}
+
+	spi->config = *config;
+	spi->reconfigured = 0;
+	_spi_dw_config_set(dev, config);
+
+	return 0;
+}
+
+static int spi_dw_slave_select(struct device *dev, uint32_t slave)
+{
+	struct spi_dw_data *spi = dev->driver_data;
+
+	SYS_LOG_DBG("%s: %p %d", __func__, dev, slave);
+
+	if (slave == 0 || slave > 16) {
+		return -EINVAL;
+	}
+
+	spi->slave = 1 << (slave - 1);
+
+	return 0;
+}
+
+static int spi_dw_transceive_async(struct device *dev,
+				   struct spi_transaction *trans)
+{
+	struct spi_dw_data *spi = dev->driver_data;
+	unsigned int key;
+
+	if (!trans->count || !trans->callback || trans->slave > 16) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	sys_slist_append(&spi->queue, &trans->node);
+	_spi_dw_queue_next(dev);
+
+	irq_unlock(key);
+
 	return 0;
 }
 
+struct spi_dw_sync {
+	struct spi_transaction trans;
+	struct k_sem sem;
+	int status;
+};
+
+static void spi_dw_sync_done(struct device *dev,
+			     struct spi_transaction *trans, int status)
+{
+	struct spi_dw_sync *sync = CONTAINER_OF(trans, struct spi_dw_sync,
+						trans);
+
+	sync->status = status;
+	k_sem_give(&sync->sem);
+}
+
+static int spi_dw_transceive(struct device *dev,
+			     const void *tx_buf, uint32_t tx_buf_len,
+			     void *rx_buf, uint32_t rx_buf_len)
+{
+	struct spi_transfer xfer = {
+		.tx_buf = tx_buf,
+		.tx_len = tx_buf_len,
+		.rx_buf = rx_buf,
+		.rx_len = rx_buf_len,
+	};
+	struct spi_dw_sync sync = {
+		.trans.transfers = &xfer,
+		.trans.count = 1,
+		.trans.callback = spi_dw_sync_done,
+	};
+
+	k_sem_init(&sync.sem, 0, 1);
+
+	/* Queued behind the asynchronous transactions */
+	spi_dw_transceive_async(dev, &sync.trans);
+
+	k_sem_take(&sync.sem, K_FOREVER);
+
+	return sync.status;
+}
+
 void spi_dw_isr(void *arg)
 {
 	struct device *dev = (struct device *)arg;
@@ -373,6 +613,20 @@ void spi_dw_isr(void *arg)
 	SYS_LOG_DBG("SPI int_status 0x%x - (tx: %d, rx: %d)",
 	    int_status, read_txflr(info->regs), read_rxflr(info->regs));
 
+#ifdef CONFIG_SPI_DW_DMA
+	/* Only errors are raised while the DMA moves the frames */
+	if (((struct spi_dw_data *)dev->driver_data)->dma_pending) {
+		clear_interrupts(info->regs);
+
+		if (int_status & DW_SPI_ISR_ERRORS_MASK) {
+			_spi_dw_dma_stop(dev);
+			_spi_dw_transfer_done(dev, 1);
+		}
+
+		return;
+	}
+#endif
+
 	if (int_status & DW_SPI_ISR_ERRORS_MASK) {
 		error = 1;
 		goto out;
@@ -395,6 +649,7 @@ static const struct spi_driver_api dw_spi_api = {
 	.configure = spi_dw_configure,
 	.slave_select = spi_dw_slave_select,
 	.transceive = spi_dw_transceive,
+	.transceive_async = spi_dw_transceive_async,
 };
 
 int spi_dw_init(struct device *dev)
@@ -417,7 +672,12 @@ int spi_dw_init(struct device *dev)
 
 	info->config_func();
 
-	k_sem_init(&spi->device_sync_sem, 0, UINT_MAX);
+	sys_slist_init(&spi->queue);
+
+#ifdef CONFIG_SPI_DW_DMA
+	/* Without the DMA controller, the ISR moves the frames */
+	spi->dma = device_get_binding(CONFIG_SPI_DW_DMA_DRV_NAME);
+#endif
 
 	_spi_config_cs(dev);
 
@@ -430,9 +690,12 @@ int spi_dw_init(struct device *dev)
 	return 0;
 }
 
-
 #ifdef CONFIG_SPI_0
 void spi_config_0_irq(void);
+#ifdef CONFIG_SPI_DW_DMA
+static void spi_dw_dma_callback_0(struct device *dev, uint32_t channel,
+				  int error_code);
+#endif
 
 struct spi_dw_data spi_dw_data_port_0;
 
@@ -444,6 +707,13 @@ const struct spi_dw_config spi_dw_config_0 = {
 #ifdef CONFIG_SPI_DW_CS_GPIO
 	.cs_gpio_name = CONFIG_SPI_0_CS_GPIO_PORT,
 	.cs_gpio_pin = CONFIG_SPI_0_CS_GPIO_PIN,
+#endif
+#ifdef CONFIG_SPI_DW_DMA
+	.dma_tx_channel = CONFIG_SPI_DW_PORT_0_DMA_TX_CHANNEL,
+	.dma_rx_channel = CONFIG_SPI_DW_PORT_0_DMA_RX_CHANNEL,
+	.dma_tx_slot = CONFIG_SPI_DW_PORT_0_DMA_TX_SLOT,
+	.dma_rx_slot = CONFIG_SPI_DW_PORT_0_DMA_RX_SLOT,
+	.dma_callback = spi_dw_dma_callback_0,
 #endif
 	.config_func = spi_config_0_irq
 };
@@ -477,9 +747,24 @@ void spi_config_0_irq(void)
 	_spi_int_unmask(SPI_DW_PORT_0_ERROR_INT_MASK);
 #endif
 }
+
+#ifdef CONFIG_SPI_DW_DMA
+static void spi_dw_dma_callback_0(struct device *dev, uint32_t channel,
+				  int error_code)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(channel);
+
+	spi_dw_dma_done(DEVICE_GET(spi_dw_port_0), error_code);
+}
+#endif
 #endif /* CONFIG_SPI_0 */
 #ifdef CONFIG_SPI_1
 void spi_config_1_irq(void);
+#ifdef CONFIG_SPI_DW_DMA
+static void spi_dw_dma_callback_1(struct device *dev, uint32_t channel,
+				  int error_code);
+#endif
 
 struct spi_dw_data spi_dw_data_port_1;
 
@@ -491,6 +776,13 @@ static const struct spi_dw_config spi_dw_config_1 = {
 #ifdef CONFIG_SPI_DW_CS_GPIO
 	.cs_gpio_name = CONFIG_SPI_1_CS_GPIO_PORT,
 	.cs_gpio_pin = CONFIG_SPI_1_CS_GPIO_PIN,
+#endif
+#ifdef CONFIG_SPI_DW_DMA
+	.dma_tx_channel = CONFIG_SPI_DW_PORT_1_DMA_TX_CHANNEL,
+	.dma_rx_channel = CONFIG_SPI_DW_PORT_1_DMA_RX_CHANNEL,
+	.dma_tx_slot = CONFIG_SPI_DW_PORT_1_DMA_TX_SLOT,
+	.dma_rx_slot = CONFIG_SPI_DW_PORT_1_DMA_RX_SLOT,
+	.dma_callback = spi_dw_dma_callback_1,
 #endif
 	.config_func = spi_config_1_irq
 };
@@ -524,4 +816,15 @@ void spi_config_1_irq(void)
 	_spi_int_unmask(SPI_DW_PORT_1_ERROR_INT_MASK);
 #endif
 }
+
+#ifdef CONFIG_SPI_DW_DMA
+static void spi_dw_dma_callback_1(struct device *dev, uint32_t channel,
+				  int error_code)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(channel);
+
+	spi_dw_dma_done(DEVICE_GET(spi_dw_port_1), error_code);
+}
+#endif
 #endif /* CONFIG_SPI_1 */
@@ -10,6 +10,11 @@
 #define __SPI_DW_H__
 
 #include <spi.h>
+#include <misc/slist.h>
+
+#ifdef CONFIG_SPI_DW_DMA
+#include <dma.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,17 +32,34 @@ struct spi_dw_config {
 	char *cs_gpio_name;
 	uint32_t cs_gpio_pin;
 #endif /* CONFIG_SPI_DW_CS_GPIO */
+#ifdef CONFIG_SPI_DW_DMA
+	uint32_t dma_tx_channel;
+	uint32_t dma_rx_channel;
+	uint8_t dma_tx_slot;
+	uint8_t dma_rx_slot;
+	void (*dma_callback)(struct device *dev, uint32_t channel,
+			     int error_code);
+#endif /* CONFIG_SPI_DW_DMA */
 	spi_dw_config_t config_func;
 };
 
 struct spi_dw_data {
-	struct k_sem device_sync_sem;
+	/* Configuration of spi_configure() */
+	struct spi_config config;
+	/* Queued transactions, and the one in progress */
+	sys_slist_t queue;
+	struct spi_transaction *trans;
+	uint8_t transfer; /* transfer in progress in the transaction */
+#ifdef CONFIG_SPI_DW_DMA
+	struct device *dma;
+	uint8_t dma_pending; /* channels the transfer waits for */
+#endif /* CONFIG_SPI_DW_DMA */
 	uint32_t error:1;
 	uint32_t dfs:3; /* dfs in bytes: 1,2 or 4 */
 	uint32_t slave:17; /* up 16 slaves */
 	uint32_t fifo_diff:9; /* cannot be bigger than FIFO depth */
 	uint32_t last_tx:1;
-	uint32_t _unused:1;
+	uint32_t reconfigured:1; /* a transaction has its configuration */
 #ifdef CONFIG_SPI_DW_CLOCK_GATE
 	struct device *clock;
 #endif /* CONFIG_SPI_DW_CLOCK_GATE */
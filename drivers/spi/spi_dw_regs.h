@@ -38,6 +38,13 @@
 
 #define DW_SSI_COMP_VERSION		(0x3332332a)
 
+/* DMACR bits */
+#define DW_SPI_DMACR_RDMAE		BIT(0)
+#define DW_SPI_DMACR_TDMAE		BIT(1)
+
+/* Address adjustment of a dma_block_config: no change */
+#define DW_SPI_DMA_ADDR_FIXED		(2)
+
 /* Register helpers */
 DEFINE_MM_REG_WRITE(ctrlr0, DW_SPI_REG_CTRLR0, 32)
 DEFINE_MM_REG_WRITE(ser, DW_SPI_REG_SER, 8)
@@ -48,6 +55,9 @@ DEFINE_MM_REG_READ(txftlr, DW_SPI_REG_TXFTLR, 32)
 DEFINE_MM_REG_WRITE(dr, DW_SPI_REG_DR, 32)
 DEFINE_MM_REG_READ(dr, DW_SPI_REG_DR, 32)
 DEFINE_MM_REG_READ(ssi_comp_version, DW_SPI_REG_SSI_COMP_VERSION, 32)
+DEFINE_MM_REG_WRITE(dmacr, DW_SPI_REG_DMACR, 32)
+DEFINE_MM_REG_WRITE(dmatdlr, DW_SPI_REG_DMATDLR, 32)
+DEFINE_MM_REG_WRITE(dmardlr, DW_SPI_REG_DMARDLR, 32)
 
 /* ICR is on a unique bit */
 DEFINE_TEST_BIT_OP(icr, DW_SPI_REG_ICR, DW_SPI_SR_ICR_BIT)
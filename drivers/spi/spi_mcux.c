@@ -10,6 +10,7 @@
 #include <soc.h>
 #include <fsl_dspi.h>
 #include <fsl_clock.h>
+#include <power.h>
 
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_SPI_LEVEL
 #include <logging/sys_log.h>
@@ -26,6 +27,12 @@ struct spi_mcux_data {
 	struct k_sem sync;
 	status_t callback_status;
 	uint32_t slave;
+#ifdef CONFIG_SYS_DVFS
+	/* configuration applied again on CPU clock changes */
+	struct device *dev;
+	struct spi_config spi_config;
+	struct sys_dvfs_notifier dvfs_notifier;
+#endif
 };
 
 static void spi_mcux_master_transfer_callback(SPI_Type *base,
@@ -79,6 +86,10 @@ static int spi_mcux_configure(struct device *dev, struct spi_config *spi_config)
 	clock_freq = CLOCK_GetFreq(config->clock_source);
 	DSPI_MasterInit(base, &master_config, clock_freq);
 
+#ifdef CONFIG_SYS_DVFS
+	data->spi_config = *spi_config;
+#endif
+
 	DSPI_MasterTransferCreateHandle(base, &data->handle,
 			spi_mcux_master_transfer_callback, dev);
 
@@ -206,6 +217,25 @@ static void spi_mcux_isr(void *arg)
 	DSPI_MasterTransferHandleIRQ(base, &data->handle);
 }
 
+#ifdef CONFIG_SYS_DVFS
+/* The DSPI clock is divided down from the CPU clock, the baud rate divider
+ * is computed again from the clock frequency as reported after the change
+ */
+static void spi_mcux_dvfs_notify(struct sys_dvfs_notifier *notifier,
+				 enum sys_dvfs_event event, uint32_t rate)
+{
+	struct spi_mcux_data *data = CONTAINER_OF(notifier,
+						  struct spi_mcux_data,
+						  dvfs_notifier);
+
+	ARG_UNUSED(rate);
+
+	if (event == SYS_DVFS_POST_CHANGE) {
+		spi_mcux_configure(data->dev, &data->spi_config);
+	}
+}
+#endif
+
 static int spi_mcux_init(struct device *dev)
 {
 	const struct spi_mcux_config *config = dev->config->config_info;
@@ -224,6 +254,12 @@ static int spi_mcux_init(struct device *dev)
 
 	config->irq_config_func(dev);
 
+#ifdef CONFIG_SYS_DVFS
+	data->dev = dev;
+	data->dvfs_notifier.cb = spi_mcux_dvfs_notify;
+	sys_dvfs_notifier_register(&data->dvfs_notifier);
+#endif
+
 	return 0;
 }
 
@@ -43,6 +43,9 @@ struct spi_qmsi_runtime {
 	uint32_t device_power_state;
 	qm_spi_context_t spi_ctx;
 #endif
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+	struct device_runtime_pm runtime_pm;
+#endif
 };
 
 static inline qm_spi_bmode_t config_to_bmode(uint8_t mode)
@@ -287,6 +290,12 @@ static int spi_qmsi_init(struct device *dev)
 	spi_master_set_power_state(dev, DEVICE_PM_ACTIVE_STATE);
 
 	dev->driver_api = &spi_qmsi_api;
+
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+	device_runtime_pm_enable(dev, &context->runtime_pm,
+				 CONFIG_DEVICE_RUNTIME_PM_AUTOSUSPEND_MS);
+#endif
+
 	return 0;
 }
 
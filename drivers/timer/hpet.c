@@ -39,6 +39,12 @@
  * it expires on the next tick, and announces the number of elapsed ticks (if
  * any) to the kernel.
  *
+ * When configured for a tickless kernel timer0 is also programmed in one-shot
+ * mode, but never to expire on the next tick unless that is when the next
+ * kernel deadline is: the timer interrupt handler announces the ticks elapsed
+ * since the previous deadline, and the kernel reprograms the timer for the
+ * following one.
+ *
  */
 
 #include <kernel.h>
@@ -108,6 +114,11 @@
 #define _HPET_TIMER0_FSB_INT_ROUTE ((volatile uint64_t *) \
 		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER0_FSB_INT_ROUTE_REG))
 
+#define _HPET_TIMER1_CONFIG_CAPS ((volatile uint64_t *) \
+		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER1_CONFIG_CAP_REG))
+#define _HPET_TIMER1_COMPARATOR ((volatile uint64_t *) \
+		(CONFIG_HPET_TIMER_BASE_ADDRESS + TIMER1_COMPARATOR_REG))
+
 /* general capabilities register macros */
 
 #define HPET_COUNTER_CLK_PERIOD(caps) (caps >> 32)
@@ -173,21 +184,29 @@ extern uint32_t _hw_irq_to_c_handler_latency;
 #define DBG(...)
 #endif
 
-#ifdef CONFIG_TICKLESS_IDLE
+#if defined(CONFIG_TICKLESS_IDLE) || defined(CONFIG_TICKLESS_KERNEL)
 
 /* additional globals, locals, and forward declarations */
 
+#ifdef CONFIG_TICKLESS_IDLE
 extern int32_t _sys_idle_elapsed_ticks;
+#endif
 
 /* main counter units per system tick */
 static uint32_t __noinit counter_load_value;
 /* counter value for most recent tick */
 static uint64_t counter_last_value;
+#ifdef CONFIG_TICKLESS_IDLE
 /* # ticks timer is programmed for */
 static int32_t programmed_ticks = 1;
+#endif
 /* is stale interrupt possible? */
 static int stale_irq_check;
 
+#endif /* CONFIG_TICKLESS_IDLE || CONFIG_TICKLESS_KERNEL */
+
+#if defined(CONFIG_TICKLESS_IDLE) || defined(CONFIG_TICKLESS_KERNEL) || \
+	defined(CONFIG_SYS_CLOCK_HIRES)
 /**
  *
  * @brief Safely read the main HPET up counter
@@ -212,7 +231,7 @@ static uint64_t _hpetMainCounterAtomic(void)
 	return ((uint64_t)highBits << 32) | lowBits;
 }
 
-#endif /* CONFIG_TICKLESS_IDLE */
+#endif /* CONFIG_TICKLESS_IDLE || CONFIG_TICKLESS_KERNEL || ... */
 
 /**
  *
@@ -244,7 +263,28 @@ void _timer_int_handler(void *unused)
 #endif
 
 
-#ifndef CONFIG_TICKLESS_IDLE
+#if defined(CONFIG_TICKLESS_KERNEL)
+
+	/* see if interrupt was triggered while timer was being reprogrammed */
+
+	if (stale_irq_check) {
+		stale_irq_check = 0;
+		if (_hpetMainCounterAtomic() < *_HPET_TIMER0_COMPARATOR) {
+			return; /* ignore "stale" interrupt */
+		}
+	}
+
+	/*
+	 * Announce the ticks elapsed since the previous deadline: the kernel
+	 * reprograms the timer for the next one via _timer_deadline_set().
+	 */
+
+	int32_t elapsed_ticks = _timer_elapsed_get();
+
+	counter_last_value += (uint64_t)elapsed_ticks * counter_load_value;
+	_nano_sys_clock_tick_announce(elapsed_ticks);
+
+#elif !defined(CONFIG_TICKLESS_IDLE)
 
 	/*
 	 * one more tick has occurred -- don't need to do anything special since
@@ -421,6 +461,132 @@ void _timer_idle_exit(void)
 
 #endif /* CONFIG_TICKLESS_IDLE */
 
+#ifdef CONFIG_TICKLESS_KERNEL
+
+/**
+ *
+ * @brief Program the timer for the next kernel deadline
+ *
+ * Re-program the timer to expire the given number of ticks after the last
+ * announced tick (-1 means infinite number of ticks). A deadline that is
+ * already due, or too close for HPET not to miss it, is moved just far
+ * enough in the future for the interrupt to be generated.
+ *
+ * @return N/A
+ *
+ * \INTERNAL IMPLEMENTATION DETAILS
+ * Called while interrupts are locked.
+ */
+
+void _timer_deadline_set(int32_t ticks)
+{
+	uint64_t comparator = ~(uint64_t)0;
+
+	if (ticks >= 0) {
+		uint64_t earliest = _hpetMainCounterAtomic() + HPET_COMP_DELAY;
+
+		comparator = counter_last_value +
+			     (uint64_t)ticks * counter_load_value;
+		if (comparator < earliest) {
+			comparator = earliest;
+		}
+	}
+
+	*_HPET_TIMER0_CONFIG_CAPS |= HPET_Tn_VAL_SET_CNF;
+	*_HPET_TIMER0_COMPARATOR = comparator;
+	stale_irq_check = 1;
+}
+
+/**
+ *
+ * @brief Get the number of ticks elapsed since the last announced tick
+ *
+ * @return number of whole ticks
+ */
+
+uint32_t _timer_elapsed_get(void)
+{
+	return (uint32_t)((_hpetMainCounterAtomic() - counter_last_value) /
+			  counter_load_value);
+}
+
+#endif /* CONFIG_TICKLESS_KERNEL */
+
+#ifdef CONFIG_SYS_CLOCK_HIRES
+
+/*
+ * High-resolution timeouts use timer1 in one-shot mode, its interrupt
+ * enabled only while a deadline is programmed.
+ */
+
+static void _hires_int_handler(void *unused)
+{
+	ARG_UNUSED(unused);
+
+#if defined(CONFIG_HPET_TIMER_LEVEL_LOW) || defined(CONFIG_HPET_TIMER_LEVEL_HIGH)
+	/* Acknowledge interrupt */
+	*_HPET_GENERAL_INT_STATUS = 2;
+#endif
+
+	_sys_clock_hires_announce();
+}
+
+static void _hires_init(void)
+{
+	/* one-shot, 64-bit if the comparator is, disabled until programmed */
+	*_HPET_TIMER1_CONFIG_CAPS &= ~(HPET_Tn_TYPE_CNF | HPET_Tn_32MODE_CNF |
+				       HPET_Tn_INT_ENB_CNF);
+
+	*_HPET_TIMER1_CONFIG_CAPS =
+#if CONFIG_HPET_TIMER_HIRES_IRQ < 32 && \
+	!defined(CONFIG_HPET_TIMER_LEGACY_EMULATION)
+		(*_HPET_TIMER1_CONFIG_CAPS & ~HPET_Tn_INT_ROUTE_CNF_MASK) |
+		(CONFIG_HPET_TIMER_HIRES_IRQ << HPET_Tn_INT_ROUTE_CNF_SHIFT)
+#else
+		(*_HPET_TIMER1_CONFIG_CAPS & ~HPET_Tn_INT_ROUTE_CNF_MASK)
+#endif
+
+#if defined(CONFIG_HPET_TIMER_LEVEL_LOW) || defined(CONFIG_HPET_TIMER_LEVEL_HIGH)
+		| HPET_Tn_INT_TYPE_CNF;
+#else
+		;
+#endif
+
+	IRQ_CONNECT(CONFIG_HPET_TIMER_HIRES_IRQ, CONFIG_HPET_TIMER_IRQ_PRIORITY,
+		   _hires_int_handler, 0, HPET_IOAPIC_FLAGS);
+	irq_enable(CONFIG_HPET_TIMER_HIRES_IRQ);
+}
+
+uint64_t _timer_cycle_get_64(void)
+{
+	return _hpetMainCounterAtomic();
+}
+
+void _timer_hires_deadline_set(uint64_t deadline)
+{
+	uint64_t earliest;
+
+	if (deadline == UINT64_MAX) {
+		*_HPET_TIMER1_CONFIG_CAPS &= ~HPET_Tn_INT_ENB_CNF;
+		return;
+	}
+
+	/*
+	 * The comparator only matches a counter value yet to come, so a
+	 * deadline passed or too close is pushed back for the interrupt
+	 * to happen
+	 */
+	earliest = _hpetMainCounterAtomic() + HPET_COMP_DELAY;
+	if (deadline < earliest) {
+		deadline = earliest;
+	}
+
+	*_HPET_TIMER1_COMPARATOR = deadline;
+	*_HPET_TIMER1_CONFIG_CAPS |= HPET_Tn_INT_ENB_CNF;
+}
+
+#endif /* CONFIG_SYS_CLOCK_HIRES */
+
 /**
  *
  * @brief Initialize and enable the system clock
@@ -435,7 +601,7 @@ int _sys_clock_driver_init(struct device *device)
 {
 	uint64_t hpetClockPeriod;
 	uint64_t tickFempto;
-#ifndef CONFIG_TICKLESS_IDLE
+#if !defined(CONFIG_TICKLESS_IDLE) && !defined(CONFIG_TICKLESS_KERNEL)
 	uint32_t counter_load_value;
 #endif
 
@@ -507,7 +673,7 @@ int _sys_clock_driver_init(struct device *device)
 	*_HPET_GENERAL_CONFIG |= HPET_LEGACY_RT_CNF;
 #endif /* CONFIG_HPET_TIMER_LEGACY_EMULATION */
 
-#ifndef CONFIG_TICKLESS_IDLE
+#if !defined(CONFIG_TICKLESS_IDLE) && !defined(CONFIG_TICKLESS_KERNEL)
 	/*
 	 * Set timer0 to periodic mode, ready to expire every tick
 	 * Setting 32-bit mode during the first load of the comparator
@@ -520,7 +686,7 @@ int _sys_clock_driver_init(struct device *device)
 	/* set timer0 to one-shot mode, ready to expire on the first tick */
 
 	*_HPET_TIMER0_CONFIG_CAPS &= ~HPET_Tn_TYPE_CNF;
-#endif /* !CONFIG_TICKLESS_IDLE */
+#endif /* !CONFIG_TICKLESS_IDLE && !CONFIG_TICKLESS_KERNEL */
 
 	/*
 	 * Set the comparator register for timer0.  The write to the comparator
@@ -573,6 +739,10 @@ int _sys_clock_driver_init(struct device *device)
 
 	/* enable the HPET generally, and timer0 specifically */
 
+#ifdef CONFIG_SYS_CLOCK_HIRES
+	_hires_init();
+#endif
+
 	*_HPET_GENERAL_CONFIG |= HPET_ENABLE_CNF;
 	*_HPET_TIMER0_CONFIG_CAPS |= HPET_Tn_INT_ENB_CNF;
 
@@ -50,6 +50,17 @@ static uint32_t rtc_past;
 static uint32_t expected_sys_ticks;
 #endif /* CONFIG_TICKLESS_IDLE */
 
+#ifdef CONFIG_TICKLESS_KERNEL
+/*
+ * Holds the sys ticks, counted from rtc_past, the RTC is programmed to fire
+ * at.
+ */
+static uint32_t programmed_sys_ticks;
+
+/* Maximum sys ticks the RTC can be programmed for without risking overflow */
+#define RTC_MAX_SYS_TICKS (RTC_HALF / RTC_TICKS_PER_SYS_TICK)
+#endif /* CONFIG_TICKLESS_KERNEL */
+
 /*
  * Set RTC Counter Compare (CC) register to a given value in RTC ticks.
  */
@@ -107,6 +118,26 @@ static void rtc_announce_set_next(void)
 	/* Calculate how many RTC ticks elapsed since the last sys tick. */
 	rtc_elapsed = (rtc_now - rtc_past) & RTC_MASK;
 
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* Announce all the sys ticks that elapsed since the last deadline.
+	 * The kernel programs the next deadline, counted from the new value
+	 * of rtc_past, via _timer_deadline_set(). If no sys tick elapsed, the
+	 * RTC fired early: set it again for the deadline it was programmed
+	 * for.
+	 */
+	if (rtc_elapsed >= RTC_TICKS_PER_SYS_TICK) {
+		sys_elapsed = rtc_elapsed / RTC_TICKS_PER_SYS_TICK;
+
+		rtc_past = (rtc_past +
+				(sys_elapsed * RTC_TICKS_PER_SYS_TICK)
+			   ) & RTC_MASK;
+
+		_nano_sys_clock_tick_announce(sys_elapsed);
+	} else {
+		rtc_compare_set(rtc_past +
+				(programmed_sys_ticks * RTC_TICKS_PER_SYS_TICK));
+	}
+#else
 	/* If no sys ticks have elapsed, there is no point in incrementing the
 	 * counters or announcing it.
 	 */
@@ -146,8 +177,46 @@ static void rtc_announce_set_next(void)
 
 	/* Set the RTC to the next sys tick */
 	rtc_compare_set(rtc_past + RTC_TICKS_PER_SYS_TICK);
+#endif /* CONFIG_TICKLESS_KERNEL */
+}
+
+#ifdef CONFIG_TICKLESS_KERNEL
+/**
+ * @brief Program the RTC for the next kernel deadline.
+ *
+ * Re-program the RTC to fire the given number of sys ticks after the last
+ * announced sys tick, or the maximum number of sys ticks that can be
+ * programmed into the hardware. A deadline already due triggers the
+ * interrupt right away, see rtc_compare_set().
+ *
+ * A value of -1 will result in the maximum number of sys ticks.
+ *
+ * Called with IRQs disabled.
+ *
+ * @return N/A
+ */
+void _timer_deadline_set(int32_t sys_ticks)
+{
+	if ((sys_ticks < 0) || (sys_ticks > RTC_MAX_SYS_TICKS)) {
+		sys_ticks = RTC_MAX_SYS_TICKS;
+	}
+
+	programmed_sys_ticks = sys_ticks;
+
+	rtc_compare_set(rtc_past + (sys_ticks * RTC_TICKS_PER_SYS_TICK));
 }
 
+/**
+ * @brief Get the number of sys ticks elapsed since the last announced one.
+ *
+ * @return number of whole sys ticks
+ */
+uint32_t _timer_elapsed_get(void)
+{
+	return ((RTC_COUNTER - rtc_past) & RTC_MASK) / RTC_TICKS_PER_SYS_TICK;
+}
+#endif /* CONFIG_TICKLESS_KERNEL */
+
 #ifdef CONFIG_TICKLESS_IDLE
 /**
  * @brief Place system timer into idle state.
@@ -286,6 +355,11 @@ int _sys_clock_driver_init(struct device *device)
 	expected_sys_ticks = 1;
 #endif /* CONFIG_TICKLESS_IDLE */
 
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* The first deadline is the first sys tick, as programmed below */
+	programmed_sys_ticks = 1;
+#endif /* CONFIG_TICKLESS_KERNEL */
+
 	/* TODO: replace with counter driver to access RTC */
 	SYS_CLOCK_RTC->PRESCALER = 0;
 	SYS_CLOCK_RTC->CC[0] = RTC_TICKS_PER_SYS_TICK;
@@ -0,0 +1,962 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Driver of a Wi-Fi module attached to an UART, and running the IP stack
+ * itself: the network contexts of its interface are sockets of the module.
+ *
+ * The messages exchanged with the module are batched in frames:
+ *
+ *   | 0x7e | length (2) | messages (length bytes) | CRC-16/CCITT (2) |
+ *
+ * the CRC covering the length and the messages, each message being:
+ *
+ *   | type (1) | socket (1) | length (2) | payload (length bytes) |
+ *
+ * The 16 bits values are little endian, and the addresses are given as:
+ *
+ *   | version (1) | port (2, network order) | IPv4 or IPv6 address |
+ *
+ * The requests of the host are answered by a REPLY message, with a status
+ * and the data asked for. The data sent by the contexts is not answered,
+ * and is held back for up to CONFIG_WIFI_OFFLOAD_UART_BATCH_TIME ms, for
+ * more messages to fill its frame before it is written.
+ */
+
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_WIFI_LEVEL
+#define SYS_LOG_DOMAIN "dev/wifi_offload"
+#include <logging/sys_log.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <kernel.h>
+#include <device.h>
+#include <init.h>
+#include <uart.h>
+#include <misc/byteorder.h>
+#include <misc/util.h>
+#include <misc/crc.h>
+
+#include <net/buf.h>
+#include <net/nbuf.h>
+#include <net/net_if.h>
+#include <net/net_l2.h>
+#include <net/net_context.h>
+#include <net/offload_ip.h>
+
+#define FRAME_SYNC 0x7e
+#define FRAME_HDR_LEN 3
+#define FRAME_CRC_LEN 2
+#define FRAME_SIZE CONFIG_WIFI_OFFLOAD_UART_FRAME_SIZE
+
+#define MSG_HDR_LEN 4
+
+/* Version, port and IPv6 address */
+#define ADDR_MAX_LEN 19
+
+#define OFFLOAD_UART_MTU (FRAME_SIZE - MSG_HDR_LEN - ADDR_MAX_LEN)
+
+#define SOCKET_NONE 0xff
+
+#define REPLY_TIMEOUT CONFIG_WIFI_OFFLOAD_UART_REPLY_TIMEOUT
+#define RX_BUF_TIMEOUT 100
+
+enum msg_type {
+	/* From the host */
+	MSG_SOCKET = 0x01,	/* version, IP protocol, answered by socket */
+	MSG_BIND = 0x02,	/* address */
+	MSG_LISTEN = 0x03,	/* backlog */
+	MSG_CONNECT = 0x04,	/* address */
+	MSG_SEND = 0x05,	/* data, not answered */
+	MSG_SENDTO = 0x06,	/* address and data, not answered */
+	MSG_CLOSE = 0x07,	/* not answered */
+	MSG_DNS = 0x08,		/* version and name, answered by addrs */
+
+	/* From the module */
+	MSG_REPLY = 0x81,	/* status (2) and data */
+	MSG_DATA = 0x82,	/* data, none at the end of the stream */
+	MSG_ACCEPTED = 0x83,	/* new socket and address of the peer */
+	MSG_ADDR = 0x84,	/* address of the interface */
+};
+
+enum rx_state {
+	RX_SYNC,
+	RX_LEN_LO,
+	RX_LEN_HI,
+	RX_DATA,
+	RX_CRC_LO,
+	RX_CRC_HI,
+};
+
+struct offload_socket {
+	struct net_context *context;
+	net_tcp_accept_cb_t accept_cb;
+	void *accept_user_data;
+
+	/* Socket of the module, created when first needed */
+	uint8_t id;
+};
+
+struct offload_uart_context {
+	struct device *uart;
+	struct net_if *iface;
+
+	struct offload_socket sockets[CONFIG_WIFI_OFFLOAD_UART_SOCKETS];
+
+	/* Frame being batched */
+	struct k_sem tx_lock;
+	struct k_delayed_work tx_flush;
+	uint8_t tx_frame[FRAME_HDR_LEN + FRAME_SIZE + FRAME_CRC_LEN];
+	uint16_t tx_len;
+
+	/* Request waiting for its reply, one at a time */
+	struct k_sem req_lock;
+	struct k_sem reply_sem;
+	uint8_t *reply_data;
+	uint16_t reply_max;
+	uint16_t reply_len;
+	int reply_status;
+	bool req_pending;
+
+	/* Frame being received by the UART */
+	struct net_buf *rx_frame;
+	uint16_t rx_len;
+	uint16_t rx_pos;
+	uint16_t rx_crc;
+	uint16_t rx_frame_crc;
+	enum rx_state rx_state;
+
+	/* Frames received, handled by the RX thread */
+	struct k_fifo rx_queue;
+	char __stack rx_stack[CONFIG_WIFI_OFFLOAD_UART_RX_STACK_SIZE];
+};
+
+/* The offload hooks are not given the device, there is one of them */
+static struct offload_uart_context offload_uart_data;
+
+NET_BUF_POOL_DEFINE(offload_uart_rx_pool, CONFIG_WIFI_OFFLOAD_UART_RX_FRAMES,
+		    FRAME_SIZE, 0, NULL);
+
+static int addr_put(uint8_t *data, const struct sockaddr *addr)
+{
+	if (addr->family == AF_INET) {
+		data[0] = 4;
+		memcpy(&data[1], &net_sin(addr)->sin_port, 2);
+		memcpy(&data[3], &net_sin(addr)->sin_addr, 4);
+
+		return 7;
+	}
+
+	if (addr->family == AF_INET6) {
+		data[0] = 6;
+		memcpy(&data[1], &net_sin6(addr)->sin6_port, 2);
+		memcpy(&data[3], &net_sin6(addr)->sin6_addr, 16);
+
+		return ADDR_MAX_LEN;
+	}
+
+	return -EAFNOSUPPORT;
+}
+
+static int addr_get(const uint8_t *data, uint16_t len,
+		    struct sockaddr *addr, socklen_t *addrlen)
+{
+	memset(addr, 0, sizeof(*addr));
+
+	if (len >= 7 && data[0] == 4) {
+		addr->family = AF_INET;
+		memcpy(&net_sin(addr)->sin_port, &data[1], 2);
+		memcpy(&net_sin(addr)->sin_addr, &data[3], 4);
+		*addrlen = sizeof(struct sockaddr_in);
+
+		return 7;
+	}
+
+	if (len >= ADDR_MAX_LEN && data[0] == 6) {
+		addr->family = AF_INET6;
+		memcpy(&net_sin6(addr)->sin6_port, &data[1], 2);
+		memcpy(&net_sin6(addr)->sin6_addr, &data[3], 16);
+		*addrlen = sizeof(struct sockaddr_in6);
+
+		return ADDR_MAX_LEN;
+	}
+
+	return -EINVAL;
+}
+
+/* Called with tx_lock held. A transport able to do DMA, or an SPI one,
+ * would only need to change how the frame is written.
+ */
+static void frame_write(struct offload_uart_context *ctx)
+{
+	uint16_t crc, len;
+	int i;
+
+	if (!ctx->tx_len) {
+		return;
+	}
+
+	ctx->tx_frame[0] = FRAME_SYNC;
+	sys_put_le16(ctx->tx_len, &ctx->tx_frame[1]);
+
+	crc = crc16_itu_t(0xffff, &ctx->tx_frame[1], 2 + ctx->tx_len);
+	sys_put_le16(crc, &ctx->tx_frame[FRAME_HDR_LEN + ctx->tx_len]);
+
+	len = FRAME_HDR_LEN + ctx->tx_len + FRAME_CRC_LEN;
+
+	for (i = 0; i < len; i++) {
+		uart_poll_out(ctx->uart, ctx->tx_frame[i]);
+	}
+
+	ctx->tx_len = 0;
+}
+
+static void tx_flush(struct k_work *work)
+{
+	struct offload_uart_context *ctx =
+		CONTAINER_OF(work, struct offload_uart_context, tx_flush);
+
+	k_sem_take(&ctx->tx_lock, K_FOREVER);
+	frame_write(ctx);
+	k_sem_give(&ctx->tx_lock);
+}
+
+/* Adds a message to the frame being batched, whose payload is data
+ * followed by the fragments frags, either being optional. The frame is
+ * written first if the message does not fit in it, and after it if
+ * flush is set.
+ */
+static int msg_queue(struct offload_uart_context *ctx, uint8_t type,
+		     uint8_t id, const uint8_t *data, uint16_t len,
+		     struct net_buf *frags, bool flush)
+{
+	size_t total = len + net_buf_frags_len(frags);
+	uint8_t *msg;
+
+	if (MSG_HDR_LEN + total > FRAME_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	k_sem_take(&ctx->tx_lock, K_FOREVER);
+
+	if (ctx->tx_len + MSG_HDR_LEN + total > FRAME_SIZE) {
+		frame_write(ctx);
+	}
+
+	msg = &ctx->tx_frame[FRAME_HDR_LEN + ctx->tx_len];
+	msg[0] = type;
+	msg[1] = id;
+	sys_put_le16(total, &msg[2]);
+	msg += MSG_HDR_LEN;
+
+	if (len) {
+		memcpy(msg, data, len);
+		msg += len;
+	}
+
+	for (; frags; frags = frags->frags) {
+		memcpy(msg, frags->data, frags->len);
+		msg += frags->len;
+	}
+
+	if (flush) {
+		ctx->tx_len += MSG_HDR_LEN + total;
+		frame_write(ctx);
+	} else if (!ctx->tx_len) {
+		/* The first message of the frame sets when it is written */
+		ctx->tx_len += MSG_HDR_LEN + total;
+		k_delayed_work_submit(&ctx->tx_flush,
+				      CONFIG_WIFI_OFFLOAD_UART_BATCH_TIME);
+	} else {
+		ctx->tx_len += MSG_HDR_LEN + total;
+	}
+
+	k_sem_give(&ctx->tx_lock);
+
+	return 0;
+}
+
+/* Sends a request and waits for its reply, whose data is copied into
+ * reply. Returns the length of that data, or the status of the reply if
+ * it is an error.
+ */
+static int request(struct offload_uart_context *ctx, uint8_t type,
+		   uint8_t id, const uint8_t *data, uint16_t len,
+		   void *reply, uint16_t reply_max, int32_t timeout)
+{
+	unsigned int key;
+	int ret;
+
+	k_sem_take(&ctx->req_lock, K_FOREVER);
+
+	k_sem_reset(&ctx->reply_sem);
+
+	key = irq_lock();
+	ctx->reply_data = reply;
+	ctx->reply_max = reply_max;
+	ctx->reply_len = 0;
+	ctx->req_pending = true;
+	irq_unlock(key);
+
+	ret = msg_queue(ctx, type, id, data, len, NULL, true);
+	if (!ret) {
+		if (k_sem_take(&ctx->reply_sem, timeout)) {
+			ret = -ETIMEDOUT;
+		} else if (ctx->reply_status < 0) {
+			ret = ctx->reply_status;
+		} else {
+			ret = ctx->reply_len;
+		}
+	}
+
+	/* A late reply must not be copied anymore */
+	key = irq_lock();
+	ctx->req_pending = false;
+	irq_unlock(key);
+
+	k_sem_give(&ctx->req_lock);
+
+	return ret;
+}
+
+static inline struct offload_socket *get_socket(struct net_context *context)
+{
+	return context->offload_context;
+}
+
+static struct offload_socket *find_socket(struct offload_uart_context *ctx,
+					  uint8_t id)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->sockets); i++) {
+		if (ctx->sockets[i].context && ctx->sockets[i].id == id) {
+			return &ctx->sockets[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int socket_create(struct offload_uart_context *ctx,
+			 struct offload_socket *sock)
+{
+	uint8_t req[2];
+	uint8_t id;
+	int ret;
+
+	if (sock->id != SOCKET_NONE) {
+		return 0;
+	}
+
+	req[0] = net_context_get_family(sock->context) == AF_INET6 ? 6 : 4;
+	req[1] = net_context_get_ip_proto(sock->context);
+
+	ret = request(ctx, MSG_SOCKET, SOCKET_NONE, req, sizeof(req),
+		      &id, sizeof(id), REPLY_TIMEOUT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (ret < sizeof(id) || id == SOCKET_NONE) {
+		return -EIO;
+	}
+
+	sock->id = id;
+
+	return 0;
+}
+
+static int offload_get(sa_family_t family,
+		       enum net_sock_type type,
+		       enum net_ip_protocol ip_proto,
+		       struct net_context **context)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct offload_socket *sock = NULL;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < ARRAY_SIZE(ctx->sockets); i++) {
+		if (!ctx->sockets[i].context) {
+			/* The socket of the module is created by the first
+			 * call needing it, the one of an accepted connection
+			 * being already there.
+			 */
+			sock = &ctx->sockets[i];
+			sock->context = *context;
+			sock->accept_cb = NULL;
+			sock->id = SOCKET_NONE;
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (!sock) {
+		return -ENOMEM;
+	}
+
+	(*context)->offload_context = sock;
+
+	return 0;
+}
+
+static int offload_bind(struct net_context *context,
+			const struct sockaddr *addr,
+			socklen_t addrlen)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct offload_socket *sock = get_socket(context);
+	uint8_t req[ADDR_MAX_LEN];
+	int ret, len;
+
+	len = addr_put(req, addr);
+	if (len < 0) {
+		return len;
+	}
+
+	ret = socket_create(ctx, sock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = request(ctx, MSG_BIND, sock->id, req, len, NULL, 0,
+		      REPLY_TIMEOUT);
+
+	return ret < 0 ? ret : 0;
+}
+
+static int offload_listen(struct net_context *context, int backlog)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct offload_socket *sock = get_socket(context);
+	uint8_t req = min(backlog, UINT8_MAX);
+	int ret;
+
+	ret = socket_create(ctx, sock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = request(ctx, MSG_LISTEN, sock->id, &req, sizeof(req), NULL, 0,
+		      REPLY_TIMEOUT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	net_context_set_state(context, NET_CONTEXT_LISTENING);
+
+	return 0;
+}
+
+/* The connection is waited for, whatever the timeout, the module having
+ * the reply timeout to establish it.
+ */
+static int offload_connect(struct net_context *context,
+			   const struct sockaddr *addr,
+			   socklen_t addrlen,
+			   net_context_connect_cb_t cb,
+			   int32_t timeout,
+			   void *user_data)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct offload_socket *sock = get_socket(context);
+	uint8_t req[ADDR_MAX_LEN];
+	int ret, len;
+
+	len = addr_put(req, addr);
+	if (len < 0) {
+		return len;
+	}
+
+	ret = socket_create(ctx, sock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = request(ctx, MSG_CONNECT, sock->id, req, len, NULL, 0,
+		      REPLY_TIMEOUT);
+	if (ret < 0) {
+		return ret;
+	}
+
+	memcpy(&context->remote, addr, min(addrlen, sizeof(context->remote)));
+	context->flags |= NET_CONTEXT_REMOTE_ADDR_SET;
+	net_context_set_state(context, NET_CONTEXT_CONNECTED);
+
+	if (cb) {
+		cb(context, 0, user_data);
+	}
+
+	return 0;
+}
+
+/* The connections are accepted as the module tells about them */
+static int offload_accept(struct net_context *context,
+			  net_tcp_accept_cb_t cb,
+			  int32_t timeout,
+			  void *user_data)
+{
+	struct offload_socket *sock = get_socket(context);
+
+	ARG_UNUSED(timeout);
+
+	if (sock->id == SOCKET_NONE) {
+		return -EINVAL;
+	}
+
+	sock->accept_user_data = user_data;
+	sock->accept_cb = cb;
+
+	return 0;
+}
+
+static int offload_send(struct net_buf *buf,
+			net_context_send_cb_t cb,
+			int32_t timeout,
+			void *token,
+			void *user_data)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct net_context *context = net_nbuf_context(buf);
+	struct offload_socket *sock = get_socket(context);
+	int ret;
+
+	if (sock->id == SOCKET_NONE) {
+		return -ENOTCONN;
+	}
+
+	ret = msg_queue(ctx, MSG_SEND, sock->id, NULL, 0, buf->frags, false);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* The data is copied in the frame, which is as good as sent here */
+	if (cb) {
+		cb(context, 0, token, user_data);
+	}
+
+	net_nbuf_unref(buf);
+
+	return 0;
+}
+
+static int offload_sendto(struct net_buf *buf,
+			  const struct sockaddr *dst_addr,
+			  socklen_t addrlen,
+			  net_context_send_cb_t cb,
+			  int32_t timeout,
+			  void *token,
+			  void *user_data)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct net_context *context = net_nbuf_context(buf);
+	struct offload_socket *sock = get_socket(context);
+	uint8_t addr[ADDR_MAX_LEN];
+	int ret, len;
+
+	len = addr_put(addr, dst_addr);
+	if (len < 0) {
+		return len;
+	}
+
+	ret = socket_create(ctx, sock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = msg_queue(ctx, MSG_SENDTO, sock->id, addr, len, buf->frags,
+			false);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (cb) {
+		cb(context, 0, token, user_data);
+	}
+
+	net_nbuf_unref(buf);
+
+	return 0;
+}
+
+static int offload_put(struct net_context *context)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	struct offload_socket *sock = get_socket(context);
+
+	if (sock->id != SOCKET_NONE) {
+		msg_queue(ctx, MSG_CLOSE, sock->id, NULL, 0, NULL, false);
+	}
+
+	sock->accept_cb = NULL;
+	sock->context = NULL;
+
+	return 0;
+}
+
+static int offload_dns_resolve(const char *name,
+			       sa_family_t family,
+			       void *addrs,
+			       int max,
+			       int32_t timeout)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	size_t addr_len = family == AF_INET6 ? 16 : 4;
+	size_t name_len = strlen(name);
+	uint8_t req[1 + 255];
+	int ret;
+
+	if (name_len > sizeof(req) - 1) {
+		return -EINVAL;
+	}
+
+	req[0] = family == AF_INET6 ? 6 : 4;
+	memcpy(&req[1], name, name_len);
+
+	ret = request(ctx, MSG_DNS, SOCKET_NONE, req, 1 + name_len,
+		      addrs, min(max * addr_len, UINT16_MAX), timeout);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret / addr_len;
+}
+
+static struct net_l2_offload_ip offload_uart_ops = {
+	.get = offload_get,
+	.bind = offload_bind,
+	.listen = offload_listen,
+	.connect = offload_connect,
+	.accept = offload_accept,
+	.send = offload_send,
+	.sendto = offload_sendto,
+	.put = offload_put,
+	.dns_resolve = offload_dns_resolve,
+};
+
+static void rx_reply(struct offload_uart_context *ctx,
+		     const uint8_t *data, uint16_t len)
+{
+	unsigned int key;
+
+	if (len < 2) {
+		return;
+	}
+
+	/* Not to race with the requester giving up */
+	key = irq_lock();
+
+	if (ctx->req_pending) {
+		ctx->reply_status = (int16_t)sys_get_le16(data);
+		ctx->reply_len = min(len - 2, ctx->reply_max);
+		memcpy(ctx->reply_data, &data[2], ctx->reply_len);
+		ctx->req_pending = false;
+
+		k_sem_give(&ctx->reply_sem);
+	}
+
+	irq_unlock(key);
+}
+
+static void rx_data(struct offload_socket *sock,
+		    const uint8_t *data, uint16_t len)
+{
+	struct net_buf *buf;
+
+	if (!len) {
+		net_l2_offload_ip_recv_data(sock->context, NULL, 0);
+		return;
+	}
+
+	buf = net_nbuf_get_rx(sock->context, RX_BUF_TIMEOUT);
+	if (!buf || !net_nbuf_append(buf, len, data, RX_BUF_TIMEOUT)) {
+		SYS_LOG_ERR("Dropped %u bytes of socket %u", len, sock->id);
+		net_nbuf_unref(buf);
+		return;
+	}
+
+	net_l2_offload_ip_recv_data(sock->context, buf, 0);
+}
+
+static void rx_accepted(struct offload_uart_context *ctx,
+			struct offload_socket *sock,
+			const uint8_t *data, uint16_t len)
+{
+	struct net_context *context;
+	struct sockaddr addr;
+	socklen_t addrlen;
+
+	if (len < 1 || addr_get(&data[1], len - 1, &addr, &addrlen) < 0) {
+		return;
+	}
+
+	if (!sock->accept_cb ||
+	    net_context_get(addr.family, SOCK_STREAM, IPPROTO_TCP,
+			    &context) < 0) {
+		SYS_LOG_WRN("Connection %u refused", data[0]);
+		msg_queue(ctx, MSG_CLOSE, data[0], NULL, 0, NULL, false);
+		return;
+	}
+
+	get_socket(context)->id = data[0];
+
+	memcpy(&context->remote, &addr, sizeof(context->remote));
+	context->flags |= NET_CONTEXT_REMOTE_ADDR_SET;
+	net_context_set_state(context, NET_CONTEXT_CONNECTED);
+
+	sock->accept_cb(context, &addr, addrlen, 0, sock->accept_user_data);
+}
+
+static void rx_addr(struct offload_uart_context *ctx,
+		    const uint8_t *data, uint16_t len)
+{
+	struct sockaddr addr;
+	socklen_t addrlen;
+
+	if (addr_get(data, len, &addr, &addrlen) < 0) {
+		return;
+	}
+
+#if defined(CONFIG_NET_IPV4)
+	if (addr.family == AF_INET) {
+		net_if_ipv4_addr_add(ctx->iface, &net_sin(&addr)->sin_addr,
+				     NET_ADDR_MANUAL, 0);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV6)
+	if (addr.family == AF_INET6) {
+		net_if_ipv6_addr_add(ctx->iface, &net_sin6(&addr)->sin6_addr,
+				     NET_ADDR_MANUAL, 0);
+	}
+#endif
+}
+
+static void rx_msg(struct offload_uart_context *ctx, uint8_t type,
+		   uint8_t id, const uint8_t *data, uint16_t len)
+{
+	struct offload_socket *sock;
+
+	SYS_LOG_DBG("Message 0x%02x socket %u length %u", type, id, len);
+
+	switch (type) {
+	case MSG_REPLY:
+		rx_reply(ctx, data, len);
+		return;
+	case MSG_ADDR:
+		rx_addr(ctx, data, len);
+		return;
+	case MSG_DATA:
+	case MSG_ACCEPTED:
+		break;
+	default:
+		SYS_LOG_WRN("Unknown message 0x%02x", type);
+		return;
+	}
+
+	sock = find_socket(ctx, id);
+	if (!sock) {
+		SYS_LOG_DBG("No socket %u", id);
+		return;
+	}
+
+	if (type == MSG_DATA) {
+		rx_data(sock, data, len);
+	} else {
+		rx_accepted(ctx, sock, data, len);
+	}
+}
+
+static void offload_uart_rx_thread(struct offload_uart_context *ctx)
+{
+	while (1) {
+		struct net_buf *frame;
+		const uint8_t *msg;
+		uint16_t left, len;
+
+		frame = net_buf_get(&ctx->rx_queue, K_FOREVER);
+
+		msg = frame->data;
+		left = frame->len;
+
+		while (left >= MSG_HDR_LEN) {
+			len = sys_get_le16(&msg[2]);
+			if (len > left - MSG_HDR_LEN) {
+				SYS_LOG_ERR("Truncated message 0x%02x",
+					    msg[0]);
+				break;
+			}
+
+			rx_msg(ctx, msg[0], msg[1], &msg[MSG_HDR_LEN], len);
+
+			msg += MSG_HDR_LEN + len;
+			left -= MSG_HDR_LEN + len;
+		}
+
+		net_buf_unref(frame);
+	}
+}
+
+static void rx_byte(struct offload_uart_context *ctx, uint8_t byte)
+{
+	switch (ctx->rx_state) {
+	case RX_SYNC:
+		if (byte == FRAME_SYNC) {
+			ctx->rx_crc = 0xffff;
+			ctx->rx_state = RX_LEN_LO;
+		}
+
+		return;
+	case RX_LEN_LO:
+		ctx->rx_len = byte;
+		ctx->rx_state = RX_LEN_HI;
+		break;
+	case RX_LEN_HI:
+		ctx->rx_len |= byte << 8;
+
+		if (!ctx->rx_len || ctx->rx_len > FRAME_SIZE) {
+			ctx->rx_state = RX_SYNC;
+			return;
+		}
+
+		/* Without a frame to fill, this one is dropped */
+		ctx->rx_frame = net_buf_alloc(&offload_uart_rx_pool,
+					      K_NO_WAIT);
+		ctx->rx_pos = 0;
+		ctx->rx_state = RX_DATA;
+		break;
+	case RX_DATA:
+		if (ctx->rx_frame) {
+			net_buf_add_u8(ctx->rx_frame, byte);
+		}
+
+		if (++ctx->rx_pos == ctx->rx_len) {
+			ctx->rx_state = RX_CRC_LO;
+		}
+
+		break;
+	case RX_CRC_LO:
+		ctx->rx_frame_crc = byte;
+		ctx->rx_state = RX_CRC_HI;
+		return;
+	case RX_CRC_HI:
+		ctx->rx_frame_crc |= byte << 8;
+		ctx->rx_state = RX_SYNC;
+
+		if (!ctx->rx_frame) {
+			return;
+		}
+
+		if (ctx->rx_frame_crc == ctx->rx_crc) {
+			net_buf_put(&ctx->rx_queue, ctx->rx_frame);
+		} else {
+			net_buf_unref(ctx->rx_frame);
+		}
+
+		ctx->rx_frame = NULL;
+		return;
+	}
+
+	ctx->rx_crc = crc16_itu_t(ctx->rx_crc, &byte, 1);
+}
+
+static void offload_uart_isr(struct device *uart)
+{
+	struct offload_uart_context *ctx = &offload_uart_data;
+	uint8_t byte;
+
+	while (uart_irq_update(uart) && uart_irq_is_pending(uart)) {
+		if (!uart_irq_rx_ready(uart)) {
+			continue;
+		}
+
+		while (uart_fifo_read(uart, &byte, 1)) {
+			rx_byte(ctx, byte);
+		}
+	}
+}
+
+static enum net_verdict offload_uart_l2_recv(struct net_if *iface,
+					     struct net_buf *buf)
+{
+	return NET_DROP;
+}
+
+/* Only the packets built by the core outside of the contexts get here */
+static enum net_verdict offload_uart_l2_send(struct net_if *iface,
+					     struct net_buf *buf)
+{
+	return NET_DROP;
+}
+
+static uint16_t offload_uart_l2_reserve(struct net_if *iface, void *unused)
+{
+	return 0;
+}
+
+NET_L2_OFFLOAD_IP_INIT(OFFLOAD_IP_L2, offload_uart_l2_recv,
+		       offload_uart_l2_send, offload_uart_l2_reserve, NULL,
+		       &offload_uart_ops);
+
+static void offload_uart_iface_init(struct net_if *iface)
+{
+	struct device *dev = net_if_get_device(iface);
+	struct offload_uart_context *ctx = dev->driver_data;
+
+	ctx->iface = iface;
+}
+
+static int offload_uart_iface_send(struct net_if *iface, struct net_buf *buf)
+{
+	return -ENOTSUP;
+}
+
+static int offload_uart_init(struct device *dev)
+{
+	struct offload_uart_context *ctx = dev->driver_data;
+
+	ctx->uart = device_get_binding(CONFIG_WIFI_OFFLOAD_UART_ON_DEV_NAME);
+	if (!ctx->uart) {
+		SYS_LOG_ERR("Cannot get %s",
+			    CONFIG_WIFI_OFFLOAD_UART_ON_DEV_NAME);
+		return -EINVAL;
+	}
+
+	k_sem_init(&ctx->tx_lock, 1, 1);
+	k_sem_init(&ctx->req_lock, 1, 1);
+	k_sem_init(&ctx->reply_sem, 0, 1);
+	k_delayed_work_init(&ctx->tx_flush, tx_flush);
+	k_fifo_init(&ctx->rx_queue);
+
+	k_thread_spawn(ctx->rx_stack, sizeof(ctx->rx_stack),
+		       (k_thread_entry_t)offload_uart_rx_thread,
+		       ctx, NULL, NULL, K_PRIO_COOP(7), 0, K_NO_WAIT);
+
+	uart_irq_rx_disable(ctx->uart);
+	uart_irq_tx_disable(ctx->uart);
+	uart_irq_callback_set(ctx->uart, offload_uart_isr);
+	uart_irq_rx_enable(ctx->uart);
+
+	SYS_LOG_INF("Wi-Fi module on %s",
+		    CONFIG_WIFI_OFFLOAD_UART_ON_DEV_NAME);
+
+	return 0;
+}
+
+static const struct net_if_api offload_uart_api = {
+	.init = offload_uart_iface_init,
+	.send = offload_uart_iface_send,
+};
+
+NET_DEVICE_INIT(wifi_offload_uart, CONFIG_WIFI_OFFLOAD_UART_DRV_NAME,
+		offload_uart_init, &offload_uart_data, NULL,
+		CONFIG_WIFI_OFFLOAD_UART_INIT_PRIO, &offload_uart_api,
+		OFFLOAD_IP_L2, NET_L2_GET_CTX_TYPE(OFFLOAD_IP_L2),
+		OFFLOAD_UART_MTU);
@@ -43,11 +43,19 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+#define	_USE_FASTSEEK	1
+#else
 #define	_USE_FASTSEEK	0
+#endif
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+#define	_USE_EXPAND		1
+#else
 #define	_USE_EXPAND		0
+#endif
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
@@ -86,6 +86,12 @@
 
 #define MBEDTLS_SSL_MAX_CONTENT_LEN             1024
 
+/* Let clients resume their sessions instead of doing a full handshake */
+#if defined(CONFIG_MBEDTLS_SSL_CACHE)
+#define MBEDTLS_SSL_CACHE_C
+#define MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES   CONFIG_MBEDTLS_SSL_CACHE_MAX_ENTRIES
+#endif
+
 #include "mbedtls/check_config.h"
 
 #endif /* MBEDTLS_CONFIG_H */
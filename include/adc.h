@@ -13,6 +13,7 @@
 #define __INCLUDE_ADC_H__
 
 #include <stdint.h>
+#include <errno.h>
 #include <device.h>
 
 #ifdef __cplusplus
@@ -63,6 +64,46 @@ struct adc_seq_table {
 	uint8_t stride[3];
 };
 
+/**
+ * @brief ADC continuous sampling callback
+ *
+ * Invoked from the ISR once a buffer of the stream has been filled, while
+ * the other buffer is being filled. The samples thus have to be consumed
+ * before the next callback.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param buffer Buffer filled with samples, NULL if the sampling stopped
+ * on an error.
+ * @param buffer_length Length of the samples in the buffer, in bytes.
+ */
+typedef void (*adc_stream_callback_t)(struct device *dev, uint8_t *buffer,
+				      uint32_t buffer_length);
+
+/**
+ * @brief ADC driver continuous sampling
+ *
+ * This structure defines the continuous sampling of a channel, into a ring
+ * made of two buffers filled one after the other.
+ */
+struct adc_stream {
+	/** Clock ticks delay between samples. */
+	int32_t sampling_delay;
+
+	/** Ring where the samples are written, a half at a time. */
+	uint8_t *buffer;
+
+	/** Length of the ring, twice the length of a buffer. */
+	uint32_t buffer_length;
+
+	/** Channel ID that should be sampled from the ADC */
+	uint8_t channel_id;
+
+	uint8_t stride[3];
+
+	/** Callback invoked for each filled buffer. */
+	adc_stream_callback_t callback;
+};
+
 /**
  * @brief ADC driver API
  *
@@ -77,6 +118,12 @@ struct adc_driver_api {
 
 	/** Pointer to the read routine. */
 	int (*read)(struct device *dev, struct adc_seq_table *seq_table);
+
+	/** Pointer to the continuous sampling start routine. */
+	int (*stream_start)(struct device *dev, struct adc_stream *stream);
+
+	/** Pointer to the continuous sampling stop routine. */
+	int (*stream_stop)(struct device *dev);
 };
 
 /**
@@ -135,6 +182,56 @@ static inline int adc_read(struct device *dev, struct adc_seq_table *seq_table)
 	return api->read(dev, seq_table);
 }
 
+/**
+ * @brief Start continuous sampling.
+ *
+ * This routine starts sampling a channel until adc_stream_stop() is called,
+ * the callback of the stream being invoked each time one of its two buffers
+ * is filled. The ADC is not available for reads meanwhile.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param stream Pointer to the stream, which must stay valid until it is
+ * stopped.
+ *
+ * @retval 0 On success
+ * @retval -ENOTSUP If continuous sampling is not supported by the driver.
+ * @retval else Otherwise.
+ */
+static inline int adc_stream_start(struct device *dev,
+				   struct adc_stream *stream)
+{
+	const struct adc_driver_api *api = dev->driver_api;
+
+	if (!api->stream_start) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_start(dev, stream);
+}
+
+/**
+ * @brief Stop continuous sampling.
+ *
+ * This routine returns once the buffer being filled is completed and its
+ * callback invoked, or at once if the sampling stopped on an error.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ *
+ * @retval 0 On success
+ * @retval -ENOTSUP If continuous sampling is not supported by the driver.
+ * @retval else Otherwise.
+ */
+static inline int adc_stream_stop(struct device *dev)
+{
+	const struct adc_driver_api *api = dev->driver_api;
+
+	if (!api->stream_stop) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_stop(dev);
+}
+
 /**
  * @}
  */
@@ -108,7 +108,8 @@ extern void _arch_isr_direct_pm(void);
 #endif
 
 #if defined(CONFIG_KERNEL_EVENT_LOGGER_SLEEP) || \
-	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT)
+	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT) || \
+	defined(CONFIG_THREAD_RUNTIME_STATS)
 #define _ARCH_ISR_DIRECT_HEADER() _arch_isr_direct_header()
 extern void _arch_isr_direct_header(void);
 #else
@@ -120,8 +121,17 @@ extern void _arch_isr_direct_header(void);
 /* arch/arm/core/exc_exit.S */
 extern void _IntExit(void);
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/* kernel/thread_runtime.c */
+extern void _sys_thread_runtime_isr_enter(void);
+extern void _sys_thread_runtime_isr_exit(void);
+#endif
+
 static inline void _arch_isr_direct_footer(int maybe_swap)
 {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	_sys_thread_runtime_isr_exit();
+#endif
 	if (maybe_swap) {
 		_IntExit();
 	}
@@ -14,11 +14,13 @@
 extern "C" {
 #endif
 
+#include <bluetooth/buf.h>
 #include <bluetooth/avdtp.h>
 
 /** @brief Stream Structure */
 struct bt_a2dp_stream {
-	/* TODO */
+	/** AVDTP stream, its transport channel carrying the media */
+	struct bt_avdtp_stream stream;
 };
 
 /** @brief Codec ID */
@@ -104,6 +106,36 @@ struct bt_a2dp *bt_a2dp_connect(struct bt_conn *conn);
 int bt_a2dp_register_endpoint(struct bt_a2dp_endpoint *endpoint,
 			      uint8_t media_type, uint8_t role);
 
+/** @brief Allocate a buffer for media packets.
+ *
+ *  The buffer has head room for the L2CAP, media and SBC headers, added when
+ *  the buffer is sent by bt_a2dp_stream_send_sbc().
+ *
+ *  @param pool Which pool to take the buffer from.
+ *
+ *  @return New buffer.
+ */
+struct net_buf *bt_a2dp_create_pdu(struct net_buf_pool *pool);
+
+/** @brief Send SBC frames.
+ *
+ *  The encoded frames are sent as they are in the buffer and its fragments,
+ *  the headers being added in the head room of the buffer. The packet is
+ *  queued for the controller, which takes it as it gives back ACL buffers.
+ *
+ *  @param stream Pointer to the streaming bt_a2dp_stream.
+ *  @param buf Buffer from bt_a2dp_create_pdu(), holding the frames.
+ *  @param frames Number of frames in the buffer, from 1 to 15.
+ *  @param timestamp Timestamp of the first sample of the frames, counted in
+ *  samples.
+ *
+ *  @return 0 in case of success and error code in case of error, the buffer
+ *  being left to the caller.
+ */
+int bt_a2dp_stream_send_sbc(struct bt_a2dp_stream *stream,
+			    struct net_buf *buf, uint8_t frames,
+			    uint32_t timestamp);
+
 #ifdef __cplusplus
 }
 #endif
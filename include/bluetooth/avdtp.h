@@ -44,6 +44,7 @@ struct bt_avdtp_stream {
 	struct bt_avdtp_seid_info lsep; /* Configured Local SEP */
 	struct bt_avdtp_seid_info rsep; /* Configured Remote SEP*/
 	uint8_t state; /* current state of the stream */
+	uint16_t seq; /* Sequence number of the next media packet */
 	struct bt_avdtp_stream *next;
 };
 
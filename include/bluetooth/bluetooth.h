@@ -22,6 +22,7 @@
 #include <misc/util.h>
 #include <net/buf.h>
 #include <bluetooth/hci.h>
+#include <bluetooth/uuid.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -252,6 +253,47 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb);
  */
 int bt_le_scan_stop(void);
 
+/** LE scan report filter, a field left to 0 matching any report */
+struct bt_le_scan_filter {
+	/** Advertiser addresses, identity ones for the resolved RPAs */
+	const bt_addr_le_t *addrs;
+
+	/** Number of addresses in @a addrs */
+	size_t addr_count;
+
+	/** UUID to be listed in the service UUIDs of the advertising data */
+	const struct bt_uuid *uuid;
+
+	/** Start of the manufacturer specific data, company identifier
+	 *  first, little endian.
+	 */
+	const uint8_t *mfg_prefix;
+
+	/** Length of @a mfg_prefix */
+	uint8_t mfg_prefix_len;
+
+	/** Time in milliseconds during which only the first report of each
+	 *  type of an advertiser is passed.
+	 */
+	uint32_t dup_window;
+};
+
+/** @brief Filter the LE scan reports.
+ *
+ *  The reports not matching the filter are dropped by the host before
+ *  reaching the scan callback, each advertising or scan response report
+ *  being matched on its own data. The duplicate filtering does not depend
+ *  on the limited controller tables, and forgets an advertiser once the
+ *  window has elapsed, so that the ones still around are reported again.
+ *  This requires CONFIG_BLUETOOTH_SCAN_FILTER.
+ *
+ *  @param filter Filter, the data of which must stay valid, or NULL to
+ *  report all the devices.
+ *
+ *  @return Zero on success or (negative) error code otherwise.
+ */
+int bt_le_scan_filter_set(const struct bt_le_scan_filter *filter);
+
 struct bt_le_oob {
 	/** LE address. If local privacy is enabled this is Resolvable Private
 	 *  Address.
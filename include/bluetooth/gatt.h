@@ -551,6 +551,64 @@ ssize_t bt_gatt_attr_write_ccc(struct bt_conn *conn,
 					       .cfg_changed = _cfg_changed, }),\
 }
 
+/** Client Supported Features bit of Multiple Handle Value Notifications */
+#define BT_GATT_CLIENT_FEAT_MULT_NOTIFY		BIT(2)
+
+/** @brief Read Client Supported Features Attribute helper.
+ *
+ *  Read the features the peer enabled by writing the Client Supported
+ *  Features characteristic, declared with BT_GATT_CLIENT_FEATURES.
+ *
+ *  @param conn Connection object.
+ *  @param attr Attribute to read.
+ *  @param buf Buffer to store the value read.
+ *  @param len Buffer length.
+ *  @param offset Start offset.
+ *
+ *  @return number of bytes read in case of success or negative values in
+ *  case of error.
+ */
+ssize_t bt_gatt_attr_read_client_features(struct bt_conn *conn,
+					  const struct bt_gatt_attr *attr,
+					  void *buf, uint16_t len,
+					  uint16_t offset);
+
+/** @brief Write Client Supported Features Attribute helper.
+ *
+ *  Enable the features set by the peer, for the time of the connection.
+ *  Only BT_GATT_CLIENT_FEAT_MULT_NOTIFY is supported, and the features
+ *  cannot be disabled once enabled.
+ *
+ *  @param conn Connection object.
+ *  @param attr Attribute to write.
+ *  @param buf Buffer with the value to write.
+ *  @param len Buffer length.
+ *  @param offset Start offset.
+ *  @param flags Write flags.
+ *
+ *  @return number of bytes written in case of success or negative values in
+ *  case of error.
+ */
+ssize_t bt_gatt_attr_write_client_features(struct bt_conn *conn,
+					   const struct bt_gatt_attr *attr,
+					   const void *buf, uint16_t len,
+					   uint16_t offset, uint8_t flags);
+
+/** @def BT_GATT_CLIENT_FEATURES
+ *  @brief Client Supported Features Value Declaration Macro.
+ *
+ *  Helper macro to declare the value of the Client Supported Features
+ *  characteristic of the GATT service, which has to follow its declaration
+ *  with BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE properties.
+ */
+#define BT_GATT_CLIENT_FEATURES						\
+{									\
+	.uuid = BT_UUID_GATT_CLIENT_FEATURES,				\
+	.perm = BT_GATT_PERM_READ | BT_GATT_PERM_WRITE,			\
+	.read = bt_gatt_attr_read_client_features,			\
+	.write = bt_gatt_attr_write_client_features,			\
+}
+
 /** @brief Read Characteristic Extended Properties Attribute helper
  *
  *  Read CEP attribute value storing the result into buffer after
@@ -688,6 +746,36 @@ ssize_t bt_gatt_attr_read_cpf(struct bt_conn *conn,
 int bt_gatt_notify(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 		   const void *data, uint16_t len);
 
+/** @brief Attribute value change, for bt_gatt_notify_multiple(). */
+struct bt_gatt_notify_value {
+	/** Attribute object. */
+	const struct bt_gatt_attr *attr;
+	/** Pointer to Attribute data. */
+	const void *data;
+	/** Attribute value length. */
+	uint16_t len;
+};
+
+/** @brief Notify several attribute value changes.
+ *
+ *  Same as bt_gatt_notify(), for several attributes at once. The values
+ *  are packed into Multiple Handle Value Notifications for the peers which
+ *  enabled them with the Client Supported Features characteristic (see
+ *  BT_GATT_CLIENT_FEATURES), and sent in separate notifications to the
+ *  others. If connection is NULL, the CCC configuration found for each
+ *  peer and attribute is cached, and the database is not searched again
+ *  until a CCC is written.
+ *
+ *  @param conn Connection object, or NULL for all peers.
+ *  @param values Attribute value changes.
+ *  @param count Number of values.
+ *
+ *  @return 0 in case of success or negative value in case of error.
+ */
+int bt_gatt_notify_multiple(struct bt_conn *conn,
+			    const struct bt_gatt_notify_value *values,
+			    size_t count);
+
 /** @typedef bt_gatt_indicate_func_t
  *  @brief Indication complete result callback.
  *
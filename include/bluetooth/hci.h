@@ -185,6 +185,7 @@ struct bt_hci_cmd_hdr {
 #define BT_LE_FEAT_BIT_DLE                      5
 #define BT_LE_FEAT_BIT_PRIVACY                  6
 #define BT_LE_FEAT_BIT_EXT_SCAN                 7
+#define BT_LE_FEAT_BIT_PHY_2M                   8
 
 #define BT_FEAT_LE_ENCR(feat)                   BT_FEAT_TEST(feat, 0, 0, \
 						BT_LE_FEAT_BIT_ENC)
@@ -194,6 +195,8 @@ struct bt_hci_cmd_hdr {
 						BT_LE_FEAT_BIT_SLAVE_FEAT_REQ)
 #define BT_FEAT_LE_DLE(feat)                    BT_FEAT_TEST(feat, 0, 0, \
 						BT_LE_FEAT_BIT_DLE)
+#define BT_FEAT_LE_PHY_2M(feat)                 BT_FEAT_TEST(feat, 0, 1, \
+						BT_LE_FEAT_BIT_PHY_2M - 8)
 
 /* LE States */
 #define BT_LE_STATES_SLAVE_CONN_ADV(states)     (states & 0x0000004000000000)
@@ -929,6 +932,94 @@ struct bt_hci_rp_le_read_max_data_len {
 	uint16_t max_rx_time;
 } __packed;
 
+#define BT_HCI_LE_PHY_1M                        0x01
+#define BT_HCI_LE_PHY_2M                        0x02
+
+#define BT_HCI_LE_PHY_PREFER_1M                 BIT(0)
+#define BT_HCI_LE_PHY_PREFER_2M                 BIT(1)
+
+#define BT_HCI_OP_LE_READ_PHY                   BT_OP(BT_OGF_LE, 0x0030)
+struct bt_hci_cp_le_read_phy {
+	uint16_t handle;
+} __packed;
+struct bt_hci_rp_le_read_phy {
+	uint8_t  status;
+	uint16_t handle;
+	uint8_t  tx_phy;
+	uint8_t  rx_phy;
+} __packed;
+
+#define BT_HCI_LE_PHY_TX_ANY                    BIT(0)
+#define BT_HCI_LE_PHY_RX_ANY                    BIT(1)
+
+#define BT_HCI_OP_LE_SET_DEFAULT_PHY            BT_OP(BT_OGF_LE, 0x0031)
+struct bt_hci_cp_le_set_default_phy {
+	uint8_t all_phys;
+	uint8_t tx_phys;
+	uint8_t rx_phys;
+} __packed;
+
+#define BT_HCI_OP_LE_SET_PHY                    BT_OP(BT_OGF_LE, 0x0032)
+struct bt_hci_cp_le_set_phy {
+	uint16_t handle;
+	uint8_t  all_phys;
+	uint8_t  tx_phys;
+	uint8_t  rx_phys;
+	uint16_t phy_opts;
+} __packed;
+
+/* Vendor specific commands of the Zephyr controller */
+
+#define BT_HCI_VS_PROFILE_ADV                   0x00
+#define BT_HCI_VS_PROFILE_OBS                   0x01
+#define BT_HCI_VS_PROFILE_SLAVE                 0x02
+#define BT_HCI_VS_PROFILE_MASTER                0x03
+#define BT_HCI_VS_PROFILE_TICKER_JOB            0x04
+
+/* bin 0 counts 0 us, bin n from 2^(n - 1) to 2^n - 1 us, the last bin
+ * the longer times too.
+ */
+#define BT_HCI_VS_PROFILE_BINS                  12
+
+#define BT_HCI_OP_VS_READ_PROFILE_HIST          BT_OP(BT_OGF_VS, 0x0100)
+struct bt_hci_cp_vs_read_profile_hist {
+	uint8_t  type;
+} __packed;
+struct bt_hci_rp_vs_read_profile_hist {
+	uint8_t  status;
+	uint8_t  type;
+	uint16_t latency_max;
+	uint16_t duration_max;
+	uint16_t latency[BT_HCI_VS_PROFILE_BINS];
+	uint16_t duration[BT_HCI_VS_PROFILE_BINS];
+} __packed;
+
+#define BT_HCI_OP_VS_CLEAR_PROFILE_HIST         BT_OP(BT_OGF_VS, 0x0101)
+
+/* Non-connectable advertising sets, advertised along with the one of the
+ * LE advertising commands, handles from 0.
+ */
+#define BT_HCI_OP_VS_SET_ADV_SET_PARAM          BT_OP(BT_OGF_VS, 0x0102)
+struct bt_hci_cp_vs_set_adv_set_param {
+	uint8_t  handle;
+	uint16_t interval;
+	uint8_t  own_addr_type;
+	uint8_t  channel_map;
+} __packed;
+
+#define BT_HCI_OP_VS_SET_ADV_SET_DATA           BT_OP(BT_OGF_VS, 0x0103)
+struct bt_hci_cp_vs_set_adv_set_data {
+	uint8_t  handle;
+	uint8_t  len;
+	uint8_t  data[31];
+} __packed;
+
+#define BT_HCI_OP_VS_SET_ADV_SET_ENABLE         BT_OP(BT_OGF_VS, 0x0104)
+struct bt_hci_cp_vs_set_adv_set_enable {
+	uint8_t  handle;
+	uint8_t  enable;
+} __packed;
+
 /* Event definitions */
 
 #define BT_HCI_EVT_VENDOR                       0xff
@@ -1244,6 +1335,14 @@ struct bt_hci_ev_le_direct_adv_report {
 	struct bt_hci_ev_le_direct_adv_info direct_adv_info[0];
 } __packed;
 
+#define BT_HCI_EVT_LE_PHY_UPDATE_COMPLETE       0x0c
+struct bt_hci_evt_le_phy_update_complete {
+	uint8_t  status;
+	uint16_t handle;
+	uint8_t  tx_phy;
+	uint8_t  rx_phy;
+} __packed;
+
 #ifdef __cplusplus
 }
 #endif
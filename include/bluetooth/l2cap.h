@@ -205,6 +205,18 @@ struct bt_l2cap_chan_ops {
 	 *  @param buf Buffer containing incoming data.
 	 */
 	void (*recv)(struct bt_l2cap_chan *chan, struct net_buf *buf);
+
+	/** Channel sent callback
+	 *
+	 *  If this callback is provided it will be called whenever an SDU
+	 *  given to bt_l2cap_chan_send() has been fully queued for the
+	 *  controller, including the ones waiting for credits, so that the
+	 *  next one can be given without blocking. It may be called from
+	 *  bt_l2cap_chan_send() itself. Only LE channels support it.
+	 *
+	 *  @param chan The channel which has sent data.
+	 */
+	void (*sent)(struct bt_l2cap_chan *chan);
 };
 
 /** @def BT_L2CAP_CHAN_SEND_RESERVE
@@ -298,6 +310,11 @@ int bt_l2cap_chan_disconnect(struct bt_l2cap_chan *chan);
  *  Send data from buffer to the channel. This procedure may block waiting for
  *  credits to send data therefore it shall be used from a fiber to be able to
  *  receive credits when necessary.
+ *  On LE channels, the segments refer to the data of the buffer instead of
+ *  copying it, so the buffer is only released once all of them are sent. Up
+ *  to CONFIG_BLUETOOTH_L2CAP_TX_FRAG_COUNT segments are queued at once.
+ *  Buffers given while there are no credits are queued, and the sent()
+ *  callback tells when each one is queued for the controller.
  *  Regarding to first input parameter, to get details see reference description
  *  to bt_l2cap_chan_connect() API above.
  *
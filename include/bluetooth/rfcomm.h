@@ -80,6 +80,9 @@ struct bt_rfcomm_dlc {
 	/* Queue for outgoing data */
 	struct k_fifo              tx_queue;
 
+	/* Node in the list of dlcs served by the TX thread */
+	sys_snode_t                _tx_node;
+
 	/* TX credits, Reuse as a binary sem for MSC FC if CFC is not enabled */
 	struct k_sem               tx_credits;
 
@@ -94,9 +97,6 @@ struct bt_rfcomm_dlc {
 	uint8_t                    dlci;
 	uint8_t                    state;
 	uint8_t                    rx_credit;
-
-	/* Stack for TX fiber */
-	BT_STACK(stack, 256);
 };
 
 struct bt_rfcomm_server {
@@ -148,7 +148,9 @@ int bt_rfcomm_dlc_connect(struct bt_conn *conn, struct bt_rfcomm_dlc *dlc,
 /** @brief Send data to RFCOMM
  *
  *  Send data from buffer to the dlc. Length should be less than or equal to
- *  mtu.
+ *  mtu. The data can be a chain of fragments, the first one having the head
+ *  room of bt_rfcomm_create_pdu() and the last one a byte of tail room for
+ *  the FCS, it is sent as a single frame without being copied.
  *
  *  @param dlc Dlc object.
  *  @param buf Data buffer.
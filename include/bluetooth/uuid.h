@@ -429,6 +429,11 @@ struct bt_uuid_128 {
  */
 #define BT_UUID_BAR_PRESSURE_TREND        BT_UUID_DECLARE_16(0x2aa3)
 #define BT_UUID_BAR_PRESSURE_TREND_VAL    0x2aa3
+/** @def BT_UUID_GATT_CLIENT_FEATURES
+ *  @brief GATT Client Supported Features Characteristic
+ */
+#define BT_UUID_GATT_CLIENT_FEATURES      BT_UUID_DECLARE_16(0x2b29)
+#define BT_UUID_GATT_CLIENT_FEATURES_VAL  0x2b29
 
 /*
  * Protocol UUIDs
@@ -53,6 +53,84 @@ static inline _sys_cache_flush_sig(sys_cache_flush)
 	#define sys_cache_line_size 0
 #endif
 
+/**
+ * @brief Write a range of the data cache back to memory
+ *
+ * This must be called on a buffer written by the CPU before a device reads
+ * it by DMA. The cache lines holding any of its bytes are written back.
+ *
+ * @param addr Start address of the buffer
+ * @param size Size of the buffer in bytes
+ *
+ * @return N/A
+ */
+#if defined(CONFIG_DCACHE)
+extern void sys_cache_data_range_flush(void *addr, size_t size);
+#else
+static inline void sys_cache_data_range_flush(void *addr, size_t size)
+{
+	sys_cache_flush((vaddr_t)addr, size);
+}
+#endif
+
+/**
+ * @brief Invalidate a range of the data cache
+ *
+ * This must be called on a buffer written by a device by DMA before the CPU
+ * reads it. The cache lines holding any of its bytes are discarded, so the
+ * buffer should not share them with other data: define it with
+ * K_DMA_BUFFER_DEFINE().
+ *
+ * Where sys_cache_flush() both writes back and invalidates the lines, it is
+ * used in turn.
+ *
+ * @param addr Start address of the buffer
+ * @param size Size of the buffer in bytes
+ *
+ * @return N/A
+ */
+#if defined(CONFIG_DCACHE)
+extern void sys_cache_data_range_invalidate(void *addr, size_t size);
+#else
+static inline void sys_cache_data_range_invalidate(void *addr, size_t size)
+{
+	sys_cache_flush((vaddr_t)addr, size);
+}
+#endif
+
+/*
+ * Cache lines whose size is detected at runtime are assumed to be at most
+ * 64 bytes wide.
+ */
+#if defined(CONFIG_CACHE_LINE_SIZE_DETECT)
+#define DMA_BUFFER_ALIGN 64
+#elif defined(CONFIG_CACHE_LINE_SIZE) && (CONFIG_CACHE_LINE_SIZE > 0)
+#define DMA_BUFFER_ALIGN CONFIG_CACHE_LINE_SIZE
+#else
+#define DMA_BUFFER_ALIGN 4
+#endif
+
+/**
+ * @brief Size of a buffer accessed by DMA
+ *
+ * @param size Size needed, in bytes
+ *
+ * @return Size rounded up to whole cache lines
+ */
+#define DMA_BUFFER_SIZE(size) ROUND_UP(size, DMA_BUFFER_ALIGN)
+
+/**
+ * @brief Statically define a buffer accessed by DMA
+ *
+ * The buffer starts on a cache line and spans whole cache lines, so that
+ * the cache can be maintained over it without affecting other data.
+ *
+ * @param name Name of the buffer, an array of bytes
+ * @param size Size needed, in bytes
+ */
+#define K_DMA_BUFFER_DEFINE(name, size) \
+	uint8_t __aligned(DMA_BUFFER_ALIGN) name[DMA_BUFFER_SIZE(size)]
+
 #ifdef __cplusplus
 }
 #endif
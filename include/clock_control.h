@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <errno.h>
 #include <device.h>
 #include <misc/__assert.h>
 
@@ -36,10 +37,15 @@ typedef int (*clock_control_get)(struct device *dev,
 				 clock_control_subsys_t sys,
 				 uint32_t *rate);
 
+typedef int (*clock_control_set)(struct device *dev,
+				 clock_control_subsys_t sys,
+				 uint32_t rate);
+
 struct clock_control_driver_api {
 	clock_control		on;
 	clock_control		off;
 	clock_control_get	get_rate;
+	clock_control_set	set_rate;
 };
 
 /**
@@ -89,6 +95,36 @@ static inline int clock_control_get_rate(struct device *dev,
 	return api->get_rate(dev, sys, rate);
 }
 
+/**
+ * @brief Change the clock rate of given sub-system
+ *
+ * The controller is left to scale the supply voltage along, before raising
+ * the rate and after lowering it. Drivers whose timings derive from the
+ * clock are not told, the rate of the CPU clock is changed through
+ * sys_dvfs_opp_set() instead of calling this directly.
+ *
+ * @param dev Pointer to the device structure for the clock controller driver
+ *        instance
+ * @param sys A pointer to an opaque data representing the sub-system
+ * @param rate New subsystem clock rate
+ *
+ * @retval 0 Rate changed.
+ * @retval -ENOTSUP The controller cannot change the rate of the sub-system.
+ * @retval -EINVAL The rate is not supported.
+ */
+static inline int clock_control_set_rate(struct device *dev,
+					 clock_control_subsys_t sys,
+					 uint32_t rate)
+{
+	const struct clock_control_driver_api *api = dev->driver_api;
+
+	if (!api->set_rate) {
+		return -ENOTSUP;
+	}
+
+	return api->set_rate(dev, sys, rate);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <device.h>
+#include <misc/dlist.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -136,6 +137,95 @@ static inline int counter_get_pending_int(struct device *dev)
 	return api->get_pending_int(dev);
 }
 
+#ifdef CONFIG_COUNTER_ALARM_QUEUE
+struct counter_alarm;
+
+/**
+ * @typedef counter_alarm_callback_t
+ * @brief Callback for an expired alarm, called in interrupt context.
+ *
+ * @param alarm The alarm expired, which can be added again.
+ */
+typedef void (*counter_alarm_callback_t)(struct counter_alarm *alarm);
+
+/**
+ * @brief Alarm of an alarm queue.
+ *
+ * Must be zeroed before its first use. The @a callback, @a period and
+ * @a user_data members are set by the caller of counter_alarm_add().
+ */
+struct counter_alarm {
+	/* Internal */
+	sys_dnode_t node;
+	/* Internal: ticks after the previous alarm of the queue */
+	uint32_t delta;
+
+	counter_alarm_callback_t callback;
+	/** Ticks between expirations of a periodic alarm, 0 if one-shot */
+	uint32_t period;
+	void *user_data;
+};
+
+/**
+ * @brief Queue of alarms sharing the alarm of a counter device.
+ *
+ * Any number of alarms are kept in expiration order, the alarm of the
+ * device being set for the first one only. Expired alarms are called
+ * from the interrupt of the device, without going through the kernel
+ * system clock.
+ */
+struct counter_alarm_queue {
+	/* Internal */
+	struct device *dev;
+	sys_dlist_t alarms;
+	bool dispatching;
+};
+
+/**
+ * @brief Initialize an alarm queue.
+ *
+ * The counter device must be started, its alarm counting @a count ticks
+ * from the time it is set and its value being the ticks elapsed since
+ * then, as the timer drivers do. The device alarm is then owned by the
+ * queue.
+ *
+ * @param queue Alarm queue to initialize.
+ * @param dev Pointer to the device structure for the counter instance.
+ */
+void counter_alarm_queue_init(struct counter_alarm_queue *queue,
+			      struct device *dev);
+
+/**
+ * @brief Add an alarm to an alarm queue.
+ *
+ * Can be called from interrupt context, including from the callback of
+ * an alarm of the queue. Periodic alarms are added back on their own
+ * after each expiration, in step with the previous one.
+ *
+ * @param queue Alarm queue to add the alarm to.
+ * @param alarm Alarm to add, not in any queue.
+ * @param ticks Counter ticks from now until the alarm expires.
+ *
+ * @retval 0 If successful.
+ * @retval -EINVAL If the alarm has no callback.
+ * @retval Negative errno code if the device alarm can not be set.
+ */
+int counter_alarm_add(struct counter_alarm_queue *queue,
+		      struct counter_alarm *alarm, uint32_t ticks);
+
+/**
+ * @brief Cancel an alarm of an alarm queue.
+ *
+ * @param queue Alarm queue the alarm was added to.
+ * @param alarm Alarm to cancel, nothing is done if it already expired.
+ *
+ * @retval 0 If successful.
+ * @retval Negative errno code if the device alarm can not be set.
+ */
+int counter_alarm_cancel(struct counter_alarm_queue *queue,
+			 struct counter_alarm *alarm);
+#endif /* CONFIG_COUNTER_ALARM_QUEUE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -158,6 +158,10 @@ static inline int cipher_free_session(struct device *dev,
  * crypto_do_op(). Based on crypto device hardware semantics, this is likely to
  * be invoked from an ISR context.
  *
+ * The ops of a session set up with CAP_ASYNC_OPS return once the request is
+ * queued, several requests may then be in flight. The packet buffers, and the
+ * iv or nonce, must stay valid until the callback reports their completion.
+ *
  * @param[in]  dev   Pointer to the device structure for the driver instance.
  * @param[in]  cb    Pointer to application callback to be called by the driver.
  *
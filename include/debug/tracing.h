@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Static tracepoints
+ *
+ * The tracepoints are placed at the hot points of the kernel, the network
+ * stack and the Bluetooth host. They compile to nothing unless enabled with
+ * CONFIG_TRACING and the option of their group, and are otherwise a call to
+ * sys_trace_event(), implemented by the backend selected.
+ */
+
+#ifndef _TRACING_H_
+#define _TRACING_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event IDs, also used by the CTF metadata in subsys/debug/tracing */
+#define SYS_TRACE_ID_THREAD_SWITCH	0x01
+#define SYS_TRACE_ID_SEM_GIVE		0x02
+#define SYS_TRACE_ID_SEM_TAKE		0x03
+#define SYS_TRACE_ID_MUTEX_LOCK		0x04
+#define SYS_TRACE_ID_MUTEX_UNLOCK	0x05
+#define SYS_TRACE_ID_QUEUE_PUT		0x06
+#define SYS_TRACE_ID_QUEUE_GET		0x07
+#define SYS_TRACE_ID_NET_RECV_DATA	0x20
+#define SYS_TRACE_ID_NET_SEND_DATA	0x21
+#define SYS_TRACE_ID_BT_RECV		0x30
+#define SYS_TRACE_ID_BT_SEND		0x31
+
+#ifdef CONFIG_TRACING
+/**
+ * @brief Record an event
+ *
+ * Implemented by the tracing backend. Called with interrupts locked or not,
+ * from threads and ISRs, it must not call back into the kernel objects
+ * traced.
+ *
+ * @param id Event ID.
+ * @param arg0 First argument of the event.
+ * @param arg1 Second argument of the event.
+ */
+void sys_trace_event(uint8_t id, uint32_t arg0, uint32_t arg1);
+
+#define _SYS_TRACE(id, arg0, arg1) \
+	sys_trace_event(id, (uint32_t)(arg0), (uint32_t)(arg1))
+#endif
+
+#ifdef CONFIG_TRACING_KERNEL
+#define sys_trace_sem_give(sem) _SYS_TRACE(SYS_TRACE_ID_SEM_GIVE, sem, 0)
+#define sys_trace_sem_take(sem, timeout) \
+	_SYS_TRACE(SYS_TRACE_ID_SEM_TAKE, sem, timeout)
+#define sys_trace_mutex_lock(mutex, timeout) \
+	_SYS_TRACE(SYS_TRACE_ID_MUTEX_LOCK, mutex, timeout)
+#define sys_trace_mutex_unlock(mutex) \
+	_SYS_TRACE(SYS_TRACE_ID_MUTEX_UNLOCK, mutex, 0)
+#define sys_trace_queue_put(queue, data) \
+	_SYS_TRACE(SYS_TRACE_ID_QUEUE_PUT, queue, data)
+#define sys_trace_queue_get(queue, timeout) \
+	_SYS_TRACE(SYS_TRACE_ID_QUEUE_GET, queue, timeout)
+#else
+#define sys_trace_sem_give(sem) do { } while (0)
+#define sys_trace_sem_take(sem, timeout) do { } while (0)
+#define sys_trace_mutex_lock(mutex, timeout) do { } while (0)
+#define sys_trace_mutex_unlock(mutex) do { } while (0)
+#define sys_trace_queue_put(queue, data) do { } while (0)
+#define sys_trace_queue_get(queue, timeout) do { } while (0)
+#endif /* CONFIG_TRACING_KERNEL */
+
+#ifdef CONFIG_TRACING_NET
+#define sys_trace_net_recv_data(iface, buf) \
+	_SYS_TRACE(SYS_TRACE_ID_NET_RECV_DATA, iface, buf)
+#define sys_trace_net_send_data(buf) \
+	_SYS_TRACE(SYS_TRACE_ID_NET_SEND_DATA, buf, 0)
+#else
+#define sys_trace_net_recv_data(iface, buf) do { } while (0)
+#define sys_trace_net_send_data(buf) do { } while (0)
+#endif /* CONFIG_TRACING_NET */
+
+/* The second argument is the buffer type in the upper 16 bits and the
+ * length in the lower ones
+ */
+#ifdef CONFIG_TRACING_BLUETOOTH
+#define sys_trace_bt_recv(buf, type) \
+	_SYS_TRACE(SYS_TRACE_ID_BT_RECV, buf, ((type) << 16) | (buf)->len)
+#define sys_trace_bt_send(buf, type) \
+	_SYS_TRACE(SYS_TRACE_ID_BT_SEND, buf, ((type) << 16) | (buf)->len)
+#else
+#define sys_trace_bt_recv(buf, type) do { } while (0)
+#define sys_trace_bt_send(buf, type) do { } while (0)
+#endif /* CONFIG_TRACING_BLUETOOTH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACING_H_ */
@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <atomic.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -283,6 +284,76 @@ extern struct device_pm_ops device_pm_ops_nop;
   */
 #define DEVICE_DECLARE(name) extern struct device DEVICE_NAME_GET(name)
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/**
+ * @brief Flag for DEVICE_INIT_ASYNC(): do not initialize the device at boot
+ *
+ * The device gets initialized the first time it is looked up by name, or
+ * named as the dependency of another asynchronous device being initialized.
+ */
+#define DEVICE_INIT_DEFERRED (1 << 0)
+
+/**
+ * @brief Asynchronous initialization of a device
+ *
+ * @param device the device
+ * @param deps names of the devices to initialize before this one
+ * @param num_deps number of names in deps
+ * @param flags DEVICE_INIT_DEFERRED, or 0
+ * @param state initialization state, for kernel use only
+ */
+struct device_async {
+	struct device *device;
+	const char * const *deps;
+	uint8_t num_deps;
+	uint8_t flags;
+	atomic_t state;
+};
+#endif
+
+/**
+ * @def DEVICE_INIT_ASYNC
+ *
+ * @brief Initialize a device asynchronously
+ *
+ * @details Lets the kernel run the init function of a device created by
+ * DEVICE_INIT() and the like on a worker thread, concurrently with the
+ * initialization of the other devices of the same level, or defer it until
+ * the device is first used if @a flags contains DEVICE_INIT_DEFERRED.
+ *
+ * An asynchronous device is only initialized once all the devices of the
+ * same level with a lower priority have been, and the devices named in the
+ * variable arguments have been, which must be devices of an earlier level or
+ * priority, or asynchronous devices. Dependencies must not be circular. Each
+ * level is still complete before the next one starts, and device_get_binding()
+ * waits for the initialization of an asynchronous device to complete before
+ * returning it.
+ *
+ * Only the devices of the POST_KERNEL and APPLICATION levels are initialized
+ * concurrently, and only if CONFIG_DEVICE_INIT_ASYNC is enabled: otherwise
+ * the macro has no effect and the device is initialized as usual.
+ *
+ * @param dev_name The dev_name provided to DEVICE_INIT(), in the same file.
+ * @param flags DEVICE_INIT_DEFERRED, or 0.
+ * @param ... Names of the devices the device depends on, if any.
+ */
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+#define DEVICE_INIT_ASYNC(dev_name, flags_, ...) \
+	static const char * const _CONCAT(__device_deps_, dev_name)[] = { \
+		__VA_ARGS__ \
+	}; \
+	static struct device_async _CONCAT(__device_async_, dev_name) __used \
+	__attribute__((__section__(".device_async.init"))) = { \
+		.device = DEVICE_GET(dev_name), \
+		.deps = _CONCAT(__device_deps_, dev_name), \
+		.num_deps = sizeof(_CONCAT(__device_deps_, dev_name)) / \
+			    sizeof(char *), \
+		.flags = (flags_), \
+	}
+#else
+#define DEVICE_INIT_ASYNC(dev_name, flags_, ...)
+#endif
+
 struct device;
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
@@ -406,11 +477,16 @@ struct device_config {
  * @param driver_api pointer to structure containing the API functions for
  * the device type. This pointer is filled in by the driver at init time.
  * @param driver_data driver instance data. For driver use only
+ * @param pm runtime power management state, NULL if the driver does not
+ * use it
  */
 struct device {
 	struct device_config *config;
 	const void *driver_api;
 	void *driver_data;
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+	struct device_runtime_pm *pm;
+#endif
 };
 
 void _sys_device_do_config_level(int level);
@@ -429,6 +505,31 @@ void _sys_device_do_config_level(int level);
  */
 struct device *device_get_binding(const char *name);
 
+/**
+ * @brief Retrieve the device structure for a driver by name, once
+ *
+ * @details Same as device_get_binding(), but the device structure is
+ * remembered in @a cache, so that only the first successful call looks the
+ * name up: the following ones cost neither a lookup nor a string compare.
+ * This is meant for code retrieving the same device over and over, e.g.
+ * with a static cache variable next to the name.
+ *
+ * @param cache address of the cached device structure pointer, which must
+ * be NULL before the first call.
+ * @param name device name to search for.
+ *
+ * @return pointer to device structure; NULL if not found or cannot be used.
+ */
+static inline struct device *device_get_binding_cached(struct device **cache,
+						       const char *name)
+{
+	if (!*cache) {
+		*cache = device_get_binding(name);
+	}
+
+	return *cache;
+}
+
 /**
  * @brief Device Power Management APIs
  * @defgroup device_power_management_api Device Power Management APIs
@@ -665,6 +766,111 @@ static inline void __deprecated
 	k_sem_give(&sync->f_sem);
 }
 
+/**
+ * @addtogroup device_power_management_api
+ * @{
+ */
+
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+/**
+ * @brief Runtime power management state of a device
+ *
+ * Kept by the driver, usually in its driver data, and handed over with
+ * device_runtime_pm_enable().
+ */
+struct device_runtime_pm {
+	struct device *dev;
+	/* users of the device, suspended after the last one is gone */
+	int usage;
+	int32_t autosuspend_ms;
+	bool suspended;
+	struct k_delayed_work work;
+};
+
+/**
+ * @brief Enable runtime power management of a device
+ *
+ * Called by the driver, usually from its init function, with the device
+ * active. From then on, the device is resumed on the first
+ * device_runtime_pm_get() and suspended @a autosuspend_ms after the last
+ * device_runtime_pm_put(), through its device_pm_control function.
+ *
+ * The suspend and resume operations are run with interrupts locked: they
+ * must not sleep.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ * @param pm Runtime power management state, owned by the driver.
+ * @param autosuspend_ms Delay before suspending the device once unused,
+ * in milliseconds. 0 suspends it right away, K_FOREVER never does.
+ */
+void device_runtime_pm_enable(struct device *dev,
+			      struct device_runtime_pm *pm,
+			      int32_t autosuspend_ms);
+
+/**
+ * @brief Change the delay before suspending an unused device
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ * @param autosuspend_ms Delay in milliseconds, as for
+ * device_runtime_pm_enable().
+ */
+void device_runtime_pm_autosuspend_set(struct device *dev,
+				       int32_t autosuspend_ms);
+
+int _device_runtime_pm_get(struct device *dev);
+void _device_runtime_pm_put(struct device *dev);
+
+/**
+ * @brief Take a reference on a device, resuming it if suspended
+ *
+ * Called by the device APIs around each operation, and by applications
+ * keeping a device active across several of them. Can be called from an
+ * ISR.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ *
+ * @retval 0 If the device is active, or does not use runtime power
+ * management.
+ * @retval Errno Negative errno code if the device could not be resumed.
+ */
+static inline int device_runtime_pm_get(struct device *dev)
+{
+	if (!dev->pm) {
+		return 0;
+	}
+
+	return _device_runtime_pm_get(dev);
+}
+
+/**
+ * @brief Release a reference taken by device_runtime_pm_get()
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ */
+static inline void device_runtime_pm_put(struct device *dev)
+{
+	if (dev->pm) {
+		_device_runtime_pm_put(dev);
+	}
+}
+#else
+static inline int device_runtime_pm_get(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static inline void device_runtime_pm_put(struct device *dev)
+{
+	ARG_UNUSED(dev);
+}
+#endif /* CONFIG_DEVICE_RUNTIME_PM */
+
+/**
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif
@@ -100,6 +100,27 @@ int disk_access_write(const uint8_t *data_buf, uint32_t start_sector,
  */
 int disk_access_ioctl(uint8_t cmd, void *buff);
 
+#ifdef CONFIG_DISK_CACHE
+/* Sector cache statistics */
+struct disk_cache_stats {
+	/* Sectors read from the cache */
+	uint32_t hits;
+	/* Sectors read from the backend for a read */
+	uint32_t misses;
+	/* Sectors read from the backend ahead of a read */
+	uint32_t read_ahead;
+	/* Dirty sectors written to the backend */
+	uint32_t write_backs;
+};
+
+/*
+ * @brief Get the sector cache statistics
+ *
+ * @param[out] stats Statistics since the disk was initialized
+ */
+void disk_cache_stats_get(struct disk_cache_stats *stats);
+#endif /* CONFIG_DISK_CACHE */
+
 
 #ifdef __cplusplus
 }
@@ -156,6 +156,12 @@ struct dma_block_config {
 	uint16_t  reserved :          3;
 };
 
+/** dma_callback status: a block of the chain has been transferred */
+#define DMA_STATUS_BLOCK	1
+
+/** dma_callback status: half of the current block has been transferred */
+#define DMA_STATUS_HALF_BLOCK	2
+
 /**
  * @brief DMA configuration structure.
  *
@@ -167,7 +173,8 @@ struct dma_block_config {
  *                                        ...
  *     complete_callback_en [ 9 ]       - 0-callback invoked at completion only
  *                                        1-callback invoked at completion of
- *                                          each block
+ *                                          each block, with DMA_STATUS_BLOCK
+ *                                          but for the last one
  *     error_callback_en    [ 10 ]      - 0-error callback enabled
  *                                        1-error callback disabled
  *     source_handshake     [ 11 ]      - 0-HW, 1-SW
@@ -178,7 +185,15 @@ struct dma_block_config {
  *     dest_chaining_en     [ 18 ]      - enable/disable destination block
  *                                        chaining.
  *                                        0-disable, 1-enable
- *     reserved             [ 19 : 31 ]
+ *     cyclic               [ 19 ]      - 0-transfer stops after the last block
+ *                                        1-transfer goes on from the head
+ *                                          block after the last one, until
+ *                                          dma_stop() is called, invoking the
+ *                                          callback at the end of each block
+ *     half_callback_en     [ 20 ]      - 0-no callback within a block
+ *                                        1-callback also invoked once half
+ *                                          of each block is transferred
+ *     reserved             [ 21 : 31 ]
  *
  * config_size is a bit field with the following parts:
  *     source_data_size    [ 0 : 15 ]    - number of bytes
@@ -187,11 +202,14 @@ struct dma_block_config {
  *     dest_burst_length   [ 16 : 31 ]  - number of destination data units
  *
  *     block_count  is the number of blocks used for block chaining, this
- *     depends on availability of the DMA controller.
+ *     depends on availability of the DMA controller. The blocks are linked
+ *     through next_block, starting with head_block, and are used by the
+ *     driver until the transfer completes or is stopped.
  *
  * dma_callback is the callback function pointer. If enabled, callback function
  *              will be invoked at transfer completion or when error happens
- *              (error_code: zero-transfer success, non zero-error happens).
+ *              (error_code: zero-transfer success, negative-error happens,
+ *              DMA_STATUS_BLOCK or DMA_STATUS_HALF_BLOCK-transfer going on).
  */
 struct dma_config {
 	uint32_t  dma_slot :             6;
@@ -203,7 +221,9 @@ struct dma_config {
 	uint32_t  channel_priority :     4;
 	uint32_t  source_chaining_en :   1;
 	uint32_t  dest_chaining_en :     1;
-	uint32_t  reserved :            13;
+	uint32_t  cyclic :               1;
+	uint32_t  half_callback_en :     1;
+	uint32_t  reserved :            11;
 	uint32_t  source_data_size :    16;
 	uint32_t  dest_data_size :      16;
 	uint32_t  source_burst_length : 16;
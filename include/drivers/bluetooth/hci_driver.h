@@ -113,6 +113,14 @@ struct bt_hci_driver {
 	/** Bus of the transport (BT_HCI_DRIVER_BUS_*) */
 	enum bt_hci_driver_bus bus;
 
+	/**
+	 * The send() handler takes ACL buffers with fragments, and sends
+	 * the data of all the fragments as one packet. The host then puts
+	 * the data of the L2CAP segments it sends in fragments instead of
+	 * copying it.
+	 */
+	bool send_frags;
+
 	/**
 	 * @brief Open the HCI transport.
 	 *
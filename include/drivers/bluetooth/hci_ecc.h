@@ -0,0 +1,77 @@
+/** @file
+ *  @brief Bluetooth HCI ECC emulation backends.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef __BT_HCI_ECC_H
+#define __BT_HCI_ECC_H
+
+/**
+ * @brief HCI ECC emulation backends
+ * @defgroup bt_hci_ecc HCI ECC emulation backends
+ * @ingroup bluetooth
+ * @{
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief P-256 operations used to emulate the LE Read Local P-256 Public
+ * Key and LE Generate DHKey HCI commands.
+ *
+ * The operations are called from the ECC thread, one at a time, and may
+ * block until a crypto accelerator completes them. The keys are in the
+ * HCI format, X then Y coordinates, little endian.
+ */
+struct bt_hci_ecc_backend {
+	/**
+	 * @brief Generate a new key pair.
+	 *
+	 * The private key is kept by the backend, and replaces the one
+	 * used to calculate the DH keys.
+	 *
+	 * @param public_key Filled with the public key.
+	 *
+	 * @return 0 on success or negative error number on failure.
+	 */
+	int (*gen_key)(uint8_t public_key[64]);
+
+	/**
+	 * @brief Calculate a DH key.
+	 *
+	 * @param remote_pk Remote public key.
+	 * @param dhkey Filled with the DH key.
+	 *
+	 * @return 0 on success, -EINVAL if the remote public key is not
+	 *         valid, or another negative error number on failure.
+	 */
+	int (*dh_key)(const uint8_t remote_pk[64], uint8_t dhkey[32]);
+};
+
+/**
+ * @brief Replace the TinyCrypt ECC emulation backend.
+ *
+ * This is to be called before bt_enable(), e.g. by the driver of a crypto
+ * accelerator.
+ *
+ * @param backend Backend, which must stay valid.
+ */
+void bt_hci_ecc_backend_register(const struct bt_hci_ecc_backend *backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* __BT_HCI_ECC_H */
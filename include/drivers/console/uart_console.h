@@ -50,6 +50,18 @@ void uart_console_in_debug_hook_install(uart_console_in_debug_hook_t hook);
 
 #endif
 
+#ifdef CONFIG_UART_CONSOLE_BUFFERED
+/** @brief Flush the console output for a fatal error
+ *
+ *  Sends the output buffered so far, and makes the console send the
+ *  output to come right away, by polling. Called with interrupts locked
+ *  by the fatal error handlers.
+ *
+ *  @return N/A
+ */
+void uart_console_panic(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
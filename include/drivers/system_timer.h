@@ -40,6 +40,19 @@ extern void _timer_idle_enter(int32_t ticks);
 extern void _timer_idle_exit(void);
 #endif /* CONFIG_TICKLESS_IDLE */
 
+#ifdef CONFIG_TICKLESS_KERNEL
+extern void _timer_deadline_set(int32_t ticks);
+extern uint32_t _timer_elapsed_get(void);
+extern void _sys_clock_deadline_update(void);
+#endif /* CONFIG_TICKLESS_KERNEL */
+
+#ifdef CONFIG_SYS_CLOCK_HIRES
+extern uint64_t _timer_cycle_get_64(void);
+/* UINT64_MAX cancels, a deadline passed expires as soon as possible */
+extern void _timer_hires_deadline_set(uint64_t deadline);
+extern void _sys_clock_hires_announce(void);
+#endif /* CONFIG_SYS_CLOCK_HIRES */
+
 extern void _nano_sys_clock_tick_announce(int32_t ticks);
 
 extern int sys_clock_device_ctrl(struct device *device,
@@ -23,6 +23,7 @@
 #include <stddef.h>
 #include <sys/types.h>
 #include <device.h>
+#include <misc/__assert.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,13 +36,89 @@ typedef int (*flash_api_write)(struct device *dev, off_t offset,
 typedef int (*flash_api_erase)(struct device *dev, off_t offset, size_t size);
 typedef int (*flash_api_write_protection)(struct device *dev, bool enable);
 
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+/**
+ * @brief Sequence of erase pages of the same size
+ */
+struct flash_pages_layout {
+	size_t pages_count;	/* count of pages in the sequence */
+	size_t pages_size;	/* size of a page, in bytes */
+};
+
+/**
+ *  @brief Retrieve the page layout of a flash memory
+ *
+ *  The layout is an array of sequences of pages, covering the whole memory
+ *  in offset order.
+ *
+ *  @param  dev             : flash device
+ *  @param  layout          : set to the array of sequences
+ *  @param  layout_size     : set to the number of sequences of the array
+ */
+typedef void (*flash_api_pages_layout)(struct device *dev,
+				       const struct flash_pages_layout **layout,
+				       size_t *layout_size);
+#endif /* CONFIG_FLASH_PAGE_LAYOUT */
+
 struct flash_driver_api {
 	flash_api_read read;
 	flash_api_write write;
 	flash_api_erase erase;
 	flash_api_write_protection write_protection;
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+	flash_api_pages_layout page_layout;
+#endif
 };
 
+#ifdef CONFIG_FLASH_DIRECT_API
+/* The only flash driver of the build, defined by FLASH_DIRECT_API_DEFINE() */
+extern const struct flash_driver_api _flash_direct_api;
+int _flash_direct_read(struct device *dev, off_t offset, void *data,
+		       size_t len);
+int _flash_direct_write(struct device *dev, off_t offset, const void *data,
+			size_t len);
+int _flash_direct_erase(struct device *dev, off_t offset, size_t size);
+int _flash_direct_write_protection(struct device *dev, bool enable);
+
+/**
+ * @brief Make a driver the one called directly by the flash API
+ *
+ * Placed after the API structure of the driver, the flash API then calls
+ * the driver functions instead of going through the API structure. A
+ * second driver doing the same fails the link.
+ *
+ * @param api API structure of the driver.
+ * @param read_fn Read function of the driver.
+ * @param write_fn Write function of the driver.
+ * @param erase_fn Erase function of the driver.
+ * @param write_protection_fn Write protection function of the driver.
+ */
+#define FLASH_DIRECT_API_DEFINE(api, read_fn, write_fn, erase_fn,	\
+				write_protection_fn)			\
+	extern const struct flash_driver_api _flash_direct_api		\
+		ALIAS_OF(api);						\
+	int _flash_direct_read(struct device *dev, off_t offset,	\
+			       void *data, size_t len)			\
+		ALIAS_OF(read_fn);					\
+	int _flash_direct_write(struct device *dev, off_t offset,	\
+				const void *data, size_t len)		\
+		ALIAS_OF(write_fn);					\
+	int _flash_direct_erase(struct device *dev, off_t offset,	\
+				size_t size)				\
+		ALIAS_OF(erase_fn);					\
+	int _flash_direct_write_protection(struct device *dev,		\
+					   bool enable)			\
+		ALIAS_OF(write_protection_fn)
+
+#define _FLASH_DIRECT_CHECK(dev)					\
+	__ASSERT((dev)->driver_api == &_flash_direct_api,		\
+		 "%s is not handled by the direct flash driver",	\
+		 (dev)->config->name)
+#else
+#define FLASH_DIRECT_API_DEFINE(api, read_fn, write_fn, erase_fn,	\
+				write_protection_fn)
+#endif /* CONFIG_FLASH_DIRECT_API */
+
 /**
  *  @brief  Read data from flash
  *
@@ -55,9 +132,15 @@ struct flash_driver_api {
 static inline int flash_read(struct device *dev, off_t offset, void *data,
 			     size_t len)
 {
+#ifdef CONFIG_FLASH_DIRECT_API
+	_FLASH_DIRECT_CHECK(dev);
+
+	return _flash_direct_read(dev, offset, data, len);
+#else
 	const struct flash_driver_api *api = dev->driver_api;
 
 	return api->read(dev, offset, data, len);
+#endif
 }
 
 /**
@@ -76,9 +159,15 @@ static inline int flash_read(struct device *dev, off_t offset, void *data,
 static inline int flash_write(struct device *dev, off_t offset,
 			      const void *data, size_t len)
 {
+#ifdef CONFIG_FLASH_DIRECT_API
+	_FLASH_DIRECT_CHECK(dev);
+
+	return _flash_direct_write(dev, offset, data, len);
+#else
 	const struct flash_driver_api *api = dev->driver_api;
 
 	return api->write(dev, offset, data, len);
+#endif
 }
 
 /**
@@ -99,9 +188,15 @@ static inline int flash_write(struct device *dev, off_t offset,
  */
 static inline int flash_erase(struct device *dev, off_t offset, size_t size)
 {
+#ifdef CONFIG_FLASH_DIRECT_API
+	_FLASH_DIRECT_CHECK(dev);
+
+	return _flash_direct_erase(dev, offset, size);
+#else
 	const struct flash_driver_api *api = dev->driver_api;
 
 	return api->erase(dev, offset, size);
+#endif
 }
 
 /**
@@ -122,11 +217,68 @@ static inline int flash_erase(struct device *dev, off_t offset, size_t size)
  */
 static inline int flash_write_protection_set(struct device *dev, bool enable)
 {
+#ifdef CONFIG_FLASH_DIRECT_API
+	_FLASH_DIRECT_CHECK(dev);
+
+	return _flash_direct_write_protection(dev, enable);
+#else
 	const struct flash_driver_api *api = dev->driver_api;
 
 	return api->write_protection(dev, enable);
+#endif
 }
 
+#ifdef CONFIG_FLASH_PAGE_LAYOUT
+/**
+ * @brief Erase page of a flash memory
+ */
+struct flash_pages_info {
+	off_t start_offset;	/* offset of the page */
+	size_t size;		/* size of the page, in bytes */
+	uint32_t index;		/* index of the page, from 0 */
+};
+
+/**
+ *  @brief  Get the erase page containing an offset
+ *
+ *  Along with flash_get_page_info_by_idx(), this is how upper layers find
+ *  out the erase boundaries, so that a range is erased in a single
+ *  flash_erase() call, which lets the driver use the largest erase
+ *  operations the memory supports.
+ *
+ *  @param  dev             : flash device
+ *  @param  offset          : offset within the page
+ *  @param  info            : page information to fill
+ *
+ *  @return  0 on success, -ENOTSUP if the driver does not provide its page
+ *           layout, -EINVAL if the offset is out of the memory.
+ */
+int flash_get_page_info_by_offs(struct device *dev, off_t offset,
+				struct flash_pages_info *info);
+
+/**
+ *  @brief  Get the erase page of an index
+ *
+ *  @param  dev             : flash device
+ *  @param  page_index      : index of the page, from 0
+ *  @param  info            : page information to fill
+ *
+ *  @return  0 on success, -ENOTSUP if the driver does not provide its page
+ *           layout, -EINVAL if the index is out of the memory.
+ */
+int flash_get_page_info_by_idx(struct device *dev, uint32_t page_index,
+			       struct flash_pages_info *info);
+
+/**
+ *  @brief  Get the number of erase pages of a flash memory
+ *
+ *  @param  dev             : flash device
+ *
+ *  @return  Number of pages, 0 if the driver does not provide its layout.
+ */
+size_t flash_get_page_count(struct device *dev);
+#endif /* CONFIG_FLASH_PAGE_LAYOUT */
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,10 @@
 #define _FS_H_
 
 #include <sys/types.h>
+#include <misc/dlist.h>
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+#include <kernel.h>
+#endif
 #include <fs/fs_interface.h>
 
 #ifdef __cplusplus
@@ -76,6 +80,108 @@ struct fs_statvfs {
 	unsigned long f_bfree;
 };
 
+/**
+ * @brief Buffer of a vectored read or write
+ *
+ * @param iov_base Start of the buffer
+ * @param iov_len Length of the buffer
+ */
+struct fs_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+struct fs_async;
+
+/**
+ * @typedef fs_async_cb_t
+ * @brief Callback for a completed asynchronous operation
+ *
+ * Called from the file system worker thread.
+ *
+ * @param async The operation completed
+ * @param result What the synchronous call would have returned
+ */
+typedef void (*fs_async_cb_t)(struct fs_async *async, ssize_t result);
+
+/**
+ * @brief Asynchronous file operation
+ *
+ * Given to the fs_*_async() calls, and left alone until the operation
+ * completes. It is completed by calling @a cb and raising @a signal with
+ * the result, the ones that are set. It must be zeroed before its first
+ * use, and can be reused from the callback.
+ *
+ * @param cb Callback called on completion, or NULL
+ * @param signal Signal raised on completion, or NULL
+ * @param result Result of the operation, once completed
+ */
+struct fs_async {
+	fs_async_cb_t cb;
+#ifdef CONFIG_POLL
+	struct k_poll_signal *signal;
+#endif
+	ssize_t result;
+
+	/* Internal */
+	struct k_work work;
+	fs_file_t *zfp;
+	uint8_t op;
+	const struct fs_iovec *iov;
+	int iovcnt;
+	struct fs_iovec vec;
+};
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
+/**
+ * @brief File system operations
+ *
+ * Implemented by each file system type, called on the files and
+ * directories of the mount points of that type. The paths passed are
+ * relative to the mount point.
+ */
+struct fs_file_system_t {
+	int (*open)(const struct fs_mount_t *mp, fs_file_t *zfp,
+		    const char *path);
+	ssize_t (*read)(fs_file_t *zfp, void *ptr, size_t size);
+	ssize_t (*write)(fs_file_t *zfp, const void *ptr, size_t size);
+	int (*lseek)(fs_file_t *zfp, off_t offset, int whence);
+	off_t (*tell)(fs_file_t *zfp);
+	int (*truncate)(fs_file_t *zfp, off_t length);
+	int (*sync)(fs_file_t *zfp);
+	int (*close)(fs_file_t *zfp);
+	int (*opendir)(const struct fs_mount_t *mp, fs_dir_t *zdp,
+		       const char *path);
+	int (*readdir)(fs_dir_t *zdp, struct fs_dirent *entry);
+	int (*closedir)(fs_dir_t *zdp);
+	int (*mount)(struct fs_mount_t *mp);
+	int (*unmount)(struct fs_mount_t *mp);
+	int (*unlink)(const struct fs_mount_t *mp, const char *path);
+	int (*mkdir)(const struct fs_mount_t *mp, const char *path);
+	int (*stat)(const struct fs_mount_t *mp, const char *path,
+		    struct fs_dirent *entry);
+	int (*statvfs)(const struct fs_mount_t *mp, struct fs_statvfs *stat);
+};
+
+/**
+ * @brief File system mount point
+ *
+ * @param node Entry in the list of mount points, internal
+ * @param mnt_point Absolute path the file system is mounted on, "/" for
+ * the root
+ * @param mountp_len Length of the mount point, internal
+ * @param fs Operations of the file system type
+ * @param fs_data Data of the file system instance, for its operations
+ */
+struct fs_mount_t {
+	sys_dnode_t node;
+	const char *mnt_point;
+	size_t mountp_len;
+	const struct fs_file_system_t *fs;
+	void *fs_data;
+};
+
 /**
  * @}
  */
@@ -101,7 +207,8 @@ struct fs_statvfs {
  * @brief File open
  *
  * Opens an existing file or create a new one and associates
- * a stream with it.
+ * a stream with it. The file is on the file system whose mount point is
+ * the longest one the name starts with.
  *
  * @param zfp Pointer to file object
  * @param file_name The name of file to open
@@ -173,6 +280,36 @@ ssize_t fs_read(fs_file_t *zfp, void *ptr, size_t size);
  */
 ssize_t fs_write(fs_file_t *zfp, const void *ptr, size_t size);
 
+/**
+ * @brief File vectored read
+ *
+ * Reads into each buffer in turn, as fs_read() would, stopping at the end
+ * of the file.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers to read into
+ * @param iovcnt Number of buffers
+ *
+ * @return Number of bytes read, less than the buffers hold at the end of
+ * the file. Will return -ERRNO code on error, if nothing was read.
+ */
+ssize_t fs_readv(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt);
+
+/**
+ * @brief File vectored write
+ *
+ * Writes each buffer in turn, as fs_write() would, stopping when the disk
+ * is full.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers to write
+ * @param iovcnt Number of buffers
+ *
+ * @return Number of bytes written, less than the buffers hold if the disk
+ * got full. Will return -ERRNO code on error, if nothing was written.
+ */
+ssize_t fs_writev(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt);
+
 /**
  * @brief File seek
  *
@@ -310,12 +447,144 @@ int fs_stat(const char *path, struct fs_dirent *entry);
  *
  * Returns the total and available space in the file system volume.
  *
+ * @param path Path to any file or directory of the volume, or its mount
+ * point
  * @param stat Pointer to zfs_statvfs structure to receive the fs statistics
  *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
  */
-int fs_statvfs(struct fs_statvfs *stat);
+int fs_statvfs(const char *path, struct fs_statvfs *stat);
+
+/**
+ * @brief Set the write buffer of an open file
+ *
+ * Writes smaller than the buffer are gathered in it, and passed to the
+ * file system at once when it is full, before the file is read, seeked,
+ * truncated or synced, and when it is closed. Writes of a buffer size or
+ * more go straight to the file system. The buffer must be left alone
+ * until the file is closed or another buffer is set.
+ *
+ * @param zfp Pointer to the file object
+ * @param buf Buffer to use, NULL to stop buffering
+ * @param size Size of the buffer
+ *
+ * @retval 0 Success
+ * @retval -ERRNO errno code if the data of the previous buffer could not
+ * be written
+ */
+int fs_setbuf(fs_file_t *zfp, void *buf, size_t size);
+
+/**
+ * @brief Mount a file system
+ *
+ * Mounts the file system instance of @a mp on its mount point, making its
+ * files available under that path. Application mounts need the @a
+ * mnt_point, @a fs and @a fs_data members of @a mp set, the other ones are
+ * used by the file system layer.
+ *
+ * @param mp Pointer to the mount point
+ *
+ * @retval 0 Success
+ * @retval -EINVAL If the mount point is not an absolute path
+ * @retval -EBUSY If a file system is already mounted on it
+ * @retval -ERRNO errno code if the file system could not be mounted
+ */
+int fs_mount(struct fs_mount_t *mp);
+
+/**
+ * @brief Unmount a file system
+ *
+ * The files and directories of the file system must be closed.
+ *
+ * @param mp Pointer to the mount point given to fs_mount()
+ *
+ * @retval 0 Success
+ * @retval -EINVAL If the file system is not mounted
+ * @retval -ERRNO errno code if the file system could not be unmounted
+ */
+int fs_unmount(struct fs_mount_t *mp);
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+/**
+ * @brief Asynchronous file read
+ *
+ * Queues a fs_read() for the file system worker thread, and returns
+ * without waiting for it. The operations queued are done in order, the
+ * file must not be used otherwise until they complete.
+ *
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the data buffer
+ * @param size Number of bytes to be read
+ * @param async Operation, with its completion set
+ *
+ * @retval 0 Operation queued
+ * @retval -EBUSY If @a async is already queued
+ */
+int fs_read_async(fs_file_t *zfp, void *ptr, size_t size,
+		  struct fs_async *async);
+
+/**
+ * @brief Asynchronous file write
+ *
+ * Queues a fs_write(), see fs_read_async().
+ *
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the data buffer, left alone until completion
+ * @param size Number of bytes to be written
+ * @param async Operation, with its completion set
+ *
+ * @retval 0 Operation queued
+ * @retval -EBUSY If @a async is already queued
+ */
+int fs_write_async(fs_file_t *zfp, const void *ptr, size_t size,
+		   struct fs_async *async);
+
+/**
+ * @brief Asynchronous file vectored read
+ *
+ * Queues a fs_readv(), see fs_read_async().
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers to read into, left alone until completion
+ * @param iovcnt Number of buffers
+ * @param async Operation, with its completion set
+ *
+ * @retval 0 Operation queued
+ * @retval -EBUSY If @a async is already queued
+ */
+int fs_readv_async(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt,
+		   struct fs_async *async);
+
+/**
+ * @brief Asynchronous file vectored write
+ *
+ * Queues a fs_writev(), see fs_read_async().
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers to write, left alone until completion
+ * @param iovcnt Number of buffers
+ * @param async Operation, with its completion set
+ *
+ * @retval 0 Operation queued
+ * @retval -EBUSY If @a async is already queued
+ */
+int fs_writev_async(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt,
+		    struct fs_async *async);
+
+/**
+ * @brief Asynchronous file sync
+ *
+ * Queues a fs_sync(), see fs_read_async().
+ *
+ * @param zfp Pointer to the file object
+ * @param async Operation, with its completion set
+ *
+ * @retval 0 Operation queued
+ * @retval -EBUSY If @a async is already queued
+ */
+int fs_sync_async(fs_file_t *zfp, struct fs_async *async);
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
 
 /**
  * @}
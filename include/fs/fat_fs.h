@@ -14,15 +14,22 @@
 extern "C" {
 #endif
 
-FS_FILE_DEFINE(FIL fp);
-FS_DIR_DEFINE(DIR dp);
+#define FAT_FS_MAX_FILE_NAME 12 /* Uses 8.3 SFN */
 
-#define MAX_FILE_NAME 12 /* Uses 8.3 SFN */
+/* Cluster link map holding a single fragment */
+#define FAT_FS_CLTBL_SIZE 4
 
-static inline off_t fs_tell(struct _fs_file_object *zfp)
-{
-	return f_tell(&zfp->fp);
-}
+/* Open file */
+struct fat_fs_file {
+	FIL fp;
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+	/* Clusters of the file, set while they are contiguous */
+	DWORD cltbl[FAT_FS_CLTBL_SIZE];
+#endif
+};
+
+/* FAT file system, for fs_mount(). Only one volume can be mounted. */
+extern const struct fs_file_system_t fat_fs_ops;
 
 #ifdef __cplusplus
 }
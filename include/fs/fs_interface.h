@@ -7,43 +7,75 @@
 #ifndef _FS_INTERFACE_H_
 #define _FS_INTERFACE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FILE_SYSTEM_FAT
+#include <fs/fat_fs.h>
+#endif
+
+#ifdef CONFIG_FILE_SYSTEM_LOG
+#include <fs/log_fs.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Longest directory entry name of the file systems enabled */
+#ifdef CONFIG_FILE_SYSTEM_LOG
+#define MAX_FILE_NAME LOG_FS_MAX_FILE_NAME
+#else
+#define MAX_FILE_NAME FAT_FS_MAX_FILE_NAME
+#endif
+
+struct fs_mount_t;
+
 /*
- * @brief Macro to define _zfile_object structure
+ * @brief Open file
  *
  * This structure contains information about the open files. This
  * structure will be passed to the api functions as an opaque
  * pointer.
- *
- * @param _file_object File structure used by underlying file system
  */
-
-#define FS_FILE_DEFINE(_file_object) \
-	struct _fs_file_object { \
-		_file_object; \
-	}
+struct _fs_file_object {
+	/* Mount the file is on */
+	const struct fs_mount_t *mp;
+	/* File structure used by underlying file system */
+	union {
+#ifdef CONFIG_FILE_SYSTEM_FAT
+		struct fat_fs_file ff;
+#endif
+#ifdef CONFIG_FILE_SYSTEM_LOG
+		struct log_fs_file lf;
+#endif
+	};
+	/* Writes not passed to the file system yet, see fs_setbuf() */
+	uint8_t *buf;
+	size_t buf_size;
+	size_t buf_len;
+};
 
 /*
- * @brief Macro to define _zdir_object structure
+ * @brief Open directory
  *
  * This structure contains information about the open directories. This
  * structure will be passed to the directory api functions as an opaque
  * pointer.
- *
- * @param _dir_object Directory structure used by underlying file system
  */
-
-#define FS_DIR_DEFINE(_dir_object) \
-	struct _fs_dir_object { \
-		_dir_object; \
-	}
-
+struct _fs_dir_object {
+	/* Mount the directory is on */
+	const struct fs_mount_t *mp;
+	/* Directory structure used by underlying file system */
+	union {
 #ifdef CONFIG_FILE_SYSTEM_FAT
-#include <fs/fat_fs.h>
+		DIR dp;
+#endif
+#ifdef CONFIG_FILE_SYSTEM_LOG
+		struct log_fs_dir ld;
 #endif
+	};
+};
 
 #ifdef __cplusplus
 }
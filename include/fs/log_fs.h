@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _LOG_FS_H_
+#define _LOG_FS_H_
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Open file, the file itself is kept in the file table of the mount */
+struct log_fs_file {
+	uint32_t id;
+	off_t pos;
+};
+
+/* Open directory, listed by going over the file table */
+struct log_fs_dir {
+	char path[CONFIG_FILE_SYSTEM_LOG_NAME_MAX + 1];
+	int index;
+};
+
+/* Full path, without the leading '/' */
+#define LOG_FS_MAX_FILE_NAME CONFIG_FILE_SYSTEM_LOG_NAME_MAX
+
+/* Log-structured file system, for fs_mount(). Only one instance can be
+ * mounted.
+ */
+extern const struct fs_file_system_t log_fs_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOG_FS_H_ */
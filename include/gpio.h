@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <errno.h>
 #include <device.h>
 
 /**
@@ -259,6 +260,9 @@ typedef int (*gpio_disable_callback_t)(struct device *port,
 				       int access_op,
 				       uint32_t pin);
 typedef uint32_t (*gpio_api_get_pending_int)(struct device *dev);
+typedef int (*gpio_port_set_masked_t)(struct device *port, uint32_t mask,
+				      uint32_t value);
+typedef int (*gpio_port_toggle_bits_t)(struct device *port, uint32_t pins);
 
 struct gpio_driver_api {
 	gpio_config_t config;
@@ -268,6 +272,8 @@ struct gpio_driver_api {
 	gpio_enable_callback_t enable_callback;
 	gpio_disable_callback_t disable_callback;
 	gpio_api_get_pending_int get_pending_int;
+	gpio_port_set_masked_t port_set_masked;
+	gpio_port_toggle_bits_t port_toggle_bits;
 };
 /**
  * @endcond
@@ -460,6 +466,78 @@ static inline int gpio_port_read(struct device *port, uint32_t *value)
 	return api->read(port, GPIO_ACCESS_BY_PORT, 0, value);
 }
 
+/**
+ * @brief Write some of the pins of the port.
+ *
+ * The pins set in @a mask get the state of the corresponding bit of
+ * @a value, the other pins are left unchanged. Done with a single
+ * register write on controllers having set and clear registers, without
+ * any read-modify-write of the output register the other pins could be
+ * changed in between.
+ *
+ * @param port Pointer to the device structure for the driver instance.
+ * @param mask Pins to write.
+ * @param value Value to set on the pins in @a mask.
+ * @return 0 if successful, -ENOTSUP if the driver does not support it,
+ * negative errno code on other failure.
+ */
+static inline int gpio_port_set_masked(struct device *port, uint32_t mask,
+				       uint32_t value)
+{
+	const struct gpio_driver_api *api = port->driver_api;
+
+	if (!api->port_set_masked) {
+		return -ENOTSUP;
+	}
+
+	return api->port_set_masked(port, mask, value);
+}
+
+/**
+ * @brief Set some of the pins of the port to 1.
+ *
+ * @param port Pointer to the device structure for the driver instance.
+ * @param pins Pins to set, the other pins are left unchanged.
+ * @return 0 if successful, -ENOTSUP if the driver does not support it,
+ * negative errno code on other failure.
+ */
+static inline int gpio_port_set_bits(struct device *port, uint32_t pins)
+{
+	return gpio_port_set_masked(port, pins, pins);
+}
+
+/**
+ * @brief Set some of the pins of the port to 0.
+ *
+ * @param port Pointer to the device structure for the driver instance.
+ * @param pins Pins to clear, the other pins are left unchanged.
+ * @return 0 if successful, -ENOTSUP if the driver does not support it,
+ * negative errno code on other failure.
+ */
+static inline int gpio_port_clear_bits(struct device *port, uint32_t pins)
+{
+	return gpio_port_set_masked(port, pins, 0);
+}
+
+/**
+ * @brief Invert the output state of some of the pins of the port.
+ *
+ * @param port Pointer to the device structure for the driver instance.
+ * @param pins Pins to toggle, the other pins are left unchanged.
+ * @return 0 if successful, -ENOTSUP if the driver does not support it,
+ * negative errno code on other failure.
+ */
+static inline int gpio_port_toggle_bits(struct device *port, uint32_t pins)
+{
+	const struct gpio_driver_api *api = port->driver_api;
+
+	if (!api->port_toggle_bits) {
+		return -ENOTSUP;
+	}
+
+	return api->port_toggle_bits(port, pins);
+}
+
 /**
  * @brief Enable callback(s) for the port.
  * @param port Pointer to the device structure for the driver instance.
@@ -23,8 +23,10 @@
 extern "C" {
 #endif
 
+#include <errno.h>
 #include <stdint.h>
 #include <device.h>
+#include <misc/slist.h>
 
 /*
  * The following #defines are used to configure the I2C controller.
@@ -95,6 +97,44 @@ struct i2c_msg {
 	uint8_t		flags;
 };
 
+struct i2c_transaction;
+
+/**
+ * @typedef i2c_callback_t
+ * @brief Completion callback of an asynchronous transaction.
+ *
+ * Called from the interrupt context of the controller. The transaction
+ * belongs to the caller again, and it can be queued anew from here.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param trans Transaction done.
+ * @param status 0 if successful, negative errno code if failure.
+ */
+typedef void (*i2c_callback_t)(struct device *dev,
+			       struct i2c_transaction *trans, int status);
+
+/**
+ * @brief I2C asynchronous transaction.
+ *
+ * The messages of a transaction are transferred as by i2c_transfer().
+ * The transaction and its messages belong to the driver from
+ * i2c_transfer_async() until the callback is called.
+ */
+struct i2c_transaction {
+	/** Used by the driver, to queue the transaction */
+	sys_snode_t node;
+	/** Messages to transfer */
+	struct i2c_msg *msgs;
+	/** Number of messages */
+	uint8_t num_msgs;
+	/** Address of the I2C target device */
+	uint16_t addr;
+	/** Called once the transaction is done */
+	i2c_callback_t callback;
+	/** Left to the user of the transaction */
+	void *user_data;
+};
+
 union dev_config {
 	uint32_t raw;
 	struct __bits {
@@ -118,11 +158,33 @@ typedef int (*i2c_api_full_io_t)(struct device *dev,
 				 struct i2c_msg *msgs,
 				 uint8_t num_msgs,
 				 uint16_t addr);
+typedef int (*i2c_api_full_io_async_t)(struct device *dev,
+				       struct i2c_transaction *trans);
 
 struct i2c_driver_api {
 	i2c_api_configure_t configure;
 	i2c_api_full_io_t transfer;
+	i2c_api_full_io_async_t transfer_async;
 };
+
+/* Keeps a device using runtime power management active for the transfer */
+static inline int _i2c_transfer(struct device *dev, struct i2c_msg *msgs,
+				uint8_t num_msgs, uint16_t addr)
+{
+	const struct i2c_driver_api *api = dev->driver_api;
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
+
+	ret = api->transfer(dev, msgs, num_msgs, addr);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
+}
 /**
  * @endcond
  */
@@ -140,8 +202,18 @@ struct i2c_driver_api {
 static inline int i2c_configure(struct device *dev, uint32_t dev_config)
 {
 	const struct i2c_driver_api *api = dev->driver_api;
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
 
-	return api->configure(dev, dev_config);
+	ret = api->configure(dev, dev_config);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
 }
 
 /**
@@ -160,14 +232,13 @@ static inline int i2c_configure(struct device *dev, uint32_t dev_config)
 static inline int i2c_write(struct device *dev, uint8_t *buf,
 			    uint32_t num_bytes, uint16_t addr)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg;
 
 	msg.buf = buf;
 	msg.len = num_bytes;
 	msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
 
-	return api->transfer(dev, &msg, 1, addr);
+	return _i2c_transfer(dev, &msg, 1, addr);
 }
 
 /**
@@ -186,14 +257,13 @@ static inline int i2c_write(struct device *dev, uint8_t *buf,
 static inline int i2c_read(struct device *dev, uint8_t *buf,
 			   uint32_t num_bytes, uint16_t addr)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg;
 
 	msg.buf = buf;
 	msg.len = num_bytes;
 	msg.flags = I2C_MSG_READ | I2C_MSG_STOP;
 
-	return api->transfer(dev, &msg, 1, addr);
+	return _i2c_transfer(dev, &msg, 1, addr);
 }
 
 /**
@@ -217,10 +287,36 @@ static inline int i2c_read(struct device *dev, uint8_t *buf,
 static inline int i2c_transfer(struct device *dev,
 			       struct i2c_msg *msgs, uint8_t num_msgs,
 			       uint16_t addr)
+{
+	return _i2c_transfer(dev, msgs, num_msgs, addr);
+}
+
+/**
+ * @brief Queue an asynchronous data transfer to another I2C device.
+ *
+ * The transaction is done once those queued before it are, and its
+ * callback is then called. The driver goes from one queued transaction to
+ * the next by itself: a batch of transactions, e.g. the register reads of
+ * a sensor readout, can be queued at once and waited for only at its
+ * last callback.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param trans Transaction to be done.
+ *
+ * @retval 0 If the transaction is queued.
+ * @retval -ENOTSUP If the driver has no asynchronous support.
+ * @retval Negative errno code if failure.
+ */
+static inline int i2c_transfer_async(struct device *dev,
+				     struct i2c_transaction *trans)
 {
 	const struct i2c_driver_api *api = dev->driver_api;
 
-	return api->transfer(dev, msgs, num_msgs, addr);
+	if (!api->transfer_async) {
+		return -ENOTSUP;
+	}
+
+	return api->transfer_async(dev, trans);
 }
 
 /**
@@ -242,7 +338,6 @@ static inline int i2c_burst_read(struct device *dev, uint16_t dev_addr,
 				 uint8_t start_addr, uint8_t *buf,
 				 uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg[2];
 
 	msg[0].buf = &start_addr;
@@ -253,7 +348,7 @@ static inline int i2c_burst_read(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -275,7 +370,6 @@ static inline int i2c_burst_write(struct device *dev, uint16_t dev_addr,
 				  uint8_t start_addr, uint8_t *buf,
 				  uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg[2];
 
 	msg[0].buf = &start_addr;
@@ -286,7 +380,7 @@ static inline int i2c_burst_write(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -385,7 +479,6 @@ static inline int i2c_burst_read16(struct device *dev, uint16_t dev_addr,
 				   uint16_t start_addr, uint8_t *buf,
 				   uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	uint8_t addr_buffer[2];
 	struct i2c_msg msg[2];
 
@@ -399,7 +492,7 @@ static inline int i2c_burst_read16(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -421,7 +514,6 @@ static inline int i2c_burst_write16(struct device *dev, uint16_t dev_addr,
 				    uint16_t start_addr, uint8_t *buf,
 				    uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	uint8_t addr_buffer[2];
 	struct i2c_msg msg[2];
 
@@ -435,7 +527,7 @@ static inline int i2c_burst_write16(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -536,7 +628,6 @@ static inline int i2c_burst_read_addr(struct device *dev, uint16_t dev_addr,
 				      const uint8_t addr_size,
 				      uint8_t *buf, uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg[2];
 
 	msg[0].buf = start_addr;
@@ -547,7 +638,7 @@ static inline int i2c_burst_read_addr(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -572,7 +663,6 @@ static inline int i2c_burst_write_addr(struct device *dev, uint16_t dev_addr,
 				       const uint8_t addr_size,
 				       uint8_t *buf, uint8_t num_bytes)
 {
-	const struct i2c_driver_api *api = dev->driver_api;
 	struct i2c_msg msg[2];
 
 	msg[0].buf = start_addr;
@@ -583,7 +673,7 @@ static inline int i2c_burst_write_addr(struct device *dev, uint16_t dev_addr,
 	msg[1].len = num_bytes;
 	msg[1].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
 
-	return api->transfer(dev, msg, 2, dev_addr);
+	return _i2c_transfer(dev, msg, 2, dev_addr);
 }
 
 /**
@@ -0,0 +1,197 @@
+/**
+ * @file
+ *
+ * @brief Shared memory transport over IPM doorbells.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __INCipm_shmh
+#define __INCipm_shmh
+
+/**
+ * @brief Shared memory IPM transport
+ * @defgroup ipm_shm_interface Shared memory IPM transport
+ * @ingroup io_interfaces
+ * @{
+ */
+
+#include <kernel.h>
+#include <device.h>
+#include <atomic.h>
+#include <net/buf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Buffers are passed between the cores by reference, through rings of
+ * descriptors in memory both of them can access. Each ring has a producer,
+ * which posts buffers at its head, and a consumer, which gives them back
+ * in order once done with them. The IPM channels only carry doorbells,
+ * rung once per batch and only when the other side is waiting for one.
+ */
+
+#define IPM_SHM_RING_MASK	(CONFIG_IPM_SHM_RING_SIZE - 1)
+
+/** Descriptor of a buffer posted to a ring */
+struct ipm_shm_desc {
+	/** Address of the data, as seen by both cores */
+	uint32_t data;
+	/** Length of the data */
+	uint16_t len;
+	/** Identifier of the data, opaque to the transport */
+	uint16_t id;
+};
+
+/**
+ * @brief Ring of buffers going one way, located in shared memory.
+ *
+ * The producer initializes it, the consumer needs it to be initialized
+ * before it is rung. The memory must not be cached by either core.
+ */
+struct ipm_shm_ring {
+	/** Descriptors posted, written by the producer */
+	atomic_t head;
+	/** Descriptors given back, written by the consumer */
+	atomic_t tail;
+	/** Set by the consumer when it needs a doorbell for new descriptors */
+	atomic_t notify;
+	struct ipm_shm_desc desc[CONFIG_IPM_SHM_RING_SIZE];
+};
+
+struct ipm_shm;
+
+/**
+ * @typedef ipm_shm_recv_t
+ * @brief Callback for a buffer received from the other core.
+ *
+ * Called from the system workqueue. The buffer is given back to the other
+ * core once the callback returns, its data is only valid until then.
+ *
+ * @param shm Transport the buffer was received on.
+ * @param data Data of the buffer, in shared memory.
+ * @param len Length of the data.
+ * @param id Identifier given by the other core.
+ */
+typedef void (*ipm_shm_recv_t)(struct ipm_shm *shm, void *data, uint16_t len,
+			       uint16_t id);
+
+/**
+ * @typedef ipm_shm_sent_t
+ * @brief Callback for a buffer given back by the other core.
+ *
+ * Called from the system workqueue, once the other core is done with the
+ * buffer and it can be reused or freed.
+ *
+ * @param shm Transport the buffer was sent on.
+ * @param user_data User data given to ipm_shm_send() for the buffer.
+ */
+typedef void (*ipm_shm_sent_t)(struct ipm_shm *shm, void *user_data);
+
+/** Shared memory transport, local to a core */
+struct ipm_shm {
+	/** Ring of buffers sent to the other core */
+	struct ipm_shm_ring *tx;
+	/** Ring of buffers received from the other core */
+	struct ipm_shm_ring *rx;
+	/** Outbound IPM channel, doorbell of the other core */
+	struct device *ipm_tx;
+	/** Inbound IPM channel, doorbell of this core */
+	struct device *ipm_rx;
+	ipm_shm_recv_t recv;
+	ipm_shm_sent_t sent;
+
+	/* Internal */
+	struct k_work work;
+	/* Descriptors of the tx ring given back and handled */
+	uint32_t tx_done;
+	void *tx_user_data[CONFIG_IPM_SHM_RING_SIZE];
+};
+
+/**
+ * @brief Initialize a shared memory transport.
+ *
+ * The @a tx, @a rx, @a ipm_tx, @a ipm_rx, @a recv and @a sent members of
+ * @a shm must be set, the other core using @a tx as its @a rx and the
+ * other way around. The tx ring is initialized, so this must be done by
+ * both cores before any buffer is sent.
+ *
+ * @param shm Transport to initialize.
+ *
+ * @retval 0 On success.
+ * @retval -EINVAL If the IPM channels can not be used as doorbells.
+ */
+int ipm_shm_init(struct ipm_shm *shm);
+
+/**
+ * @brief Post a buffer to the other core.
+ *
+ * The buffer is not copied, it must be in shared memory and left untouched
+ * until the sent callback is called for it. The other core is not rung,
+ * ipm_shm_notify() needs to be called once a batch of buffers is posted.
+ *
+ * @param shm Transport to send the buffer on.
+ * @param data Data of the buffer.
+ * @param len Length of the data.
+ * @param id Identifier passed along with the buffer.
+ * @param user_data Given back to the sent callback.
+ *
+ * @retval 0 On success.
+ * @retval -ENOMEM If the ring is full.
+ */
+int ipm_shm_send(struct ipm_shm *shm, void *data, uint16_t len, uint16_t id,
+		 void *user_data);
+
+/**
+ * @brief Ring the other core for the buffers posted.
+ *
+ * Does nothing if the other core is still going through the ring and will
+ * find the buffers on its own.
+ *
+ * @param shm Transport the buffers were posted on.
+ */
+void ipm_shm_notify(struct ipm_shm *shm);
+
+/**
+ * @brief Post a network buffer to the other core.
+ *
+ * A reference to the buffer is passed as user data, the sent callback
+ * needs to give it back with net_buf_unref(). Only the data of the first
+ * fragment is sent, the buffer must be allocated from a pool in shared
+ * memory.
+ *
+ * @param shm Transport to send the buffer on.
+ * @param buf Buffer to send.
+ * @param id Identifier passed along with the buffer.
+ *
+ * @retval 0 On success.
+ * @retval -ENOMEM If the ring is full.
+ */
+static inline int ipm_shm_send_buf(struct ipm_shm *shm, struct net_buf *buf,
+				   uint16_t id)
+{
+	int err;
+
+	err = ipm_shm_send(shm, buf->data, buf->len, id, net_buf_ref(buf));
+	if (err) {
+		net_buf_unref(buf);
+	}
+
+	return err;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* __INCipm_shmh */
@@ -184,13 +184,21 @@ extern "C" {
  * interrupt lock; this ensures the thread won't be interrupted until it has
  * explicitly released the interrupt lock it established.
  *
+ * On SMP systems, the interrupt lock also excludes the other CPUs: it is a
+ * global lock, which they wait for when calling irq_lock().
+ *
  * @warning
  * The lock-out key should never be used to manually re-enable interrupts
  * or to inspect or manipulate the contents of the CPU's interrupt bits.
  *
  * @return Lock-out key.
  */
+#ifdef CONFIG_SMP
+extern unsigned int _smp_global_lock(void);
+#define irq_lock() _smp_global_lock()
+#else
 #define irq_lock() _arch_irq_lock()
+#endif
 
 /**
  * @brief Unlock interrupts.
@@ -206,7 +214,12 @@ extern "C" {
  *
  * @return N/A
  */
+#ifdef CONFIG_SMP
+extern void _smp_global_unlock(unsigned int key);
+#define irq_unlock(key) _smp_global_unlock(key)
+#else
 #define irq_unlock(key) _arch_irq_unlock(key)
+#endif
 
 /**
  * @brief Enable an IRQ.
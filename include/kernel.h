@@ -86,7 +86,27 @@ extern "C" {
 #define K_HIGHEST_APPLICATION_THREAD_PRIO (K_HIGHEST_THREAD_PRIO)
 #define K_LOWEST_APPLICATION_THREAD_PRIO (K_LOWEST_THREAD_PRIO - 1)
 
-typedef sys_dlist_t _wait_q_t;
+#ifdef CONFIG_WAITQ_BUCKETS
+#define _WAIT_Q_NUM_PRIO \
+	(CONFIG_NUM_COOP_PRIORITIES + CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+
+typedef struct {
+	/* pending threads, sorted by priority */
+	sys_dlist_t waitq;
+
+	/* priorities with pending threads, and the last thread of each */
+	uint32_t prio_bmap[(_WAIT_Q_NUM_PRIO + 31) >> 5];
+	sys_dnode_t *last[_WAIT_Q_NUM_PRIO];
+} _wait_q_t;
+#else
+typedef struct {
+	/* pending threads, sorted by priority */
+	sys_dlist_t waitq;
+} _wait_q_t;
+#endif
+
+#define _WAIT_Q_INIT(wait_q) \
+	{ .waitq = SYS_DLIST_STATIC_INIT(&(wait_q)->waitq) }
 
 #ifdef CONFIG_OBJECT_TRACING
 #define _OBJECT_TRACING_NEXT_PTR(type) struct type *__next
@@ -148,6 +168,15 @@ enum execution_context_types {
  * CONFIG_ISR_STACK_SIZE
  * CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE
  *
+ * If CONFIG_THREAD_MONITOR is set, it then reports the peak stack usage of
+ * every thread, one line per thread, in the layout of the output of
+ * scripts/checkstack.pl so that both can be sorted and compared:
+ *
+ * <entry point> <thread> [<stack size>]:	<peak usage>
+ *
+ * The entry point address can be resolved to the thread's function with
+ * addr2line.
+ *
  * @note CONFIG_INIT_STACKS and CONFIG_PRINTK must be set for this function to
  * produce output.
  *
@@ -155,6 +184,79 @@ enum execution_context_types {
  */
 extern void k_call_stacks_analyze(void);
 
+#ifdef CONFIG_INIT_STACKS
+/**
+ * @brief Get the unused stack space of a thread
+ *
+ * This routine determines how much of the stack area of @a thread has not
+ * been used since the thread was created, by counting the bytes that still
+ * hold the value the area was initialized with. This is the margin by
+ * which the stack size could be reduced for the run observed so far.
+ *
+ * @param thread ID of thread.
+ * @param unused_ptr Unused stack space, in bytes.
+ *
+ * @retval 0 Unused stack space determined.
+ * @retval -EINVAL Invalid parameter.
+ */
+extern int k_thread_stack_space_get(const struct k_thread *thread,
+				    size_t *unused_ptr);
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Run-time statistics
+ */
+struct k_thread_runtime_stats {
+	/** Hardware cycles spent running */
+	uint64_t execution_cycles;
+};
+
+/**
+ * @brief Get the run-time statistics of a thread
+ *
+ * This routine retrieves the number of hardware cycles @a thread has been
+ * running since it was created, excluding interrupt handlers. The cycles
+ * are counted on each context switch and interrupt entry and exit, so the
+ * hardware cycle counter must not wrap around between two of them.
+ *
+ * @param thread ID of thread.
+ * @param stats Statistics of @a thread.
+ *
+ * @retval 0 Statistics retrieved.
+ * @retval -EINVAL Invalid parameter.
+ */
+extern int k_thread_runtime_stats_get(k_tid_t thread,
+				      struct k_thread_runtime_stats *stats);
+
+/**
+ * @brief Get the run-time statistics of interrupt handlers
+ *
+ * This routine retrieves the number of hardware cycles spent in interrupt
+ * handlers since the system started.
+ *
+ * @param stats Statistics of interrupt handlers.
+ *
+ * @retval 0 Statistics retrieved.
+ * @retval -EINVAL Invalid parameter.
+ */
+extern int k_isr_runtime_stats_get(struct k_thread_runtime_stats *stats);
+
+/**
+ * @brief Get the run-time statistics of the whole system
+ *
+ * This routine retrieves the number of hardware cycles accounted to all the
+ * threads and interrupt handlers since the system started, against which
+ * the statistics of each of them can be compared.
+ *
+ * @param stats Statistics of the system.
+ *
+ * @retval 0 Statistics retrieved.
+ * @retval -EINVAL Invalid parameter.
+ */
+extern int k_thread_runtime_stats_all_get(struct k_thread_runtime_stats *stats);
+#endif
+
 /**
  * @} end defgroup profiling_apis
  */
@@ -431,6 +533,77 @@ struct _static_thread_data {
 				NULL, 0); \
 	const k_tid_t name = (k_tid_t)_k_thread_obj_##name
 
+#ifdef CONFIG_SCHED_CPU_MASK
+/**
+ * @brief Prevent a thread from running on any CPU.
+ *
+ * The CPU mask of a thread can only be changed while the thread is not
+ * ready to run, for example before it is started.
+ *
+ * @param thread ID of thread whose CPU mask is to be changed.
+ *
+ * @retval 0 Mask changed.
+ * @retval -EINVAL Thread is ready to run.
+ */
+extern int k_thread_cpu_mask_clear(k_tid_t thread);
+
+/**
+ * @brief Let a thread run on all CPUs.
+ *
+ * @param thread ID of thread whose CPU mask is to be changed.
+ *
+ * @retval 0 Mask changed.
+ * @retval -EINVAL Thread is ready to run.
+ */
+extern int k_thread_cpu_mask_enable_all(k_tid_t thread);
+
+/**
+ * @brief Let a thread run on a CPU.
+ *
+ * @param thread ID of thread whose CPU mask is to be changed.
+ * @param cpu Index of the CPU.
+ *
+ * @retval 0 Mask changed.
+ * @retval -EINVAL Thread is ready to run.
+ */
+extern int k_thread_cpu_mask_enable(k_tid_t thread, int cpu);
+
+/**
+ * @brief Prevent a thread from running on a CPU.
+ *
+ * @param thread ID of thread whose CPU mask is to be changed.
+ * @param cpu Index of the CPU.
+ *
+ * @retval 0 Mask changed.
+ * @retval -EINVAL Thread is ready to run.
+ */
+extern int k_thread_cpu_mask_disable(k_tid_t thread, int cpu);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+/**
+ * @brief Set a thread's deadline.
+ *
+ * This routine gives @a thread a deadline @a deadline milliseconds from now.
+ * Ready threads of the same priority are scheduled in order of their
+ * deadlines, earliest first, ahead of the threads that have none. The
+ * priority of a thread still prevails over its deadline.
+ *
+ * Periodic threads typically set their next deadline at the start of each
+ * period. The deadline is kept when it passes, until set again.
+ *
+ * Deadlines are tracked with the hardware cycle counter: they must remain
+ * within half of its wrap-around period.
+ *
+ * @param thread ID of thread whose deadline is to be set.
+ * @param deadline Deadline relative to now (in milliseconds), or K_FOREVER
+ *                 to remove the thread's deadline.
+ *
+ * @return N/A
+ */
+extern void k_thread_deadline_set(k_tid_t thread, int32_t deadline);
+#endif
+
 /**
  * @brief Get a thread's priority.
  *
@@ -465,7 +638,8 @@ extern int  k_thread_priority_get(k_tid_t thread);
  * @param prio New priority.
  *
  * @warning Changing the priority of a thread currently involved in mutex
- * priority inheritance may result in undefined behavior.
+ * priority inheritance may result in undefined behavior, unless
+ * CONFIG_MUTEX_PI_CHAIN is enabled.
  *
  * @return N/A
  */
@@ -780,6 +954,10 @@ struct _timeout {
 	sys_dlist_t *wait_q;
 	int32_t delta_ticks_from_prev;
 	_timeout_func_t func;
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	/* absolute tick at which the timeout expires */
+	uint32_t expiry_tick;
+#endif
 };
 
 extern int32_t _timeout_remaining_get(struct _timeout *timeout);
@@ -827,7 +1005,7 @@ struct k_timer {
 	.timeout.wait_q = NULL, \
 	.timeout.thread = NULL, \
 	.timeout.func = _timer_expiration_handler, \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.expiry_fn = expiry, \
 	.stop_fn = stop, \
 	.status = 0, \
@@ -1097,6 +1275,112 @@ extern uint32_t k_uptime_delta_32(int64_t *reftime);
  */
 #define k_cycle_get_32()	_arch_k_cycle_get_32()
 
+#ifdef CONFIG_SYS_CLOCK_HIRES
+
+struct k_hires_timeout;
+
+typedef void (*k_hires_timeout_handler_t)(struct k_hires_timeout *timeout);
+
+/**
+ * @brief High-resolution timeout
+ *
+ * Expires at an absolute deadline in hardware clock cycles, independently
+ * of the system clock ticks, the system timer driver being programmed for
+ * the closest deadline.
+ */
+struct k_hires_timeout {
+	sys_dnode_t node;
+	uint64_t deadline;
+	k_hires_timeout_handler_t handler;
+};
+
+/**
+ * @brief Read the 64-bit hardware clock.
+ *
+ * @return Current hardware clock up-counter (in cycles), which does not
+ * roll over.
+ */
+extern uint64_t k_cycle_get_64(void);
+
+/**
+ * @brief Convert microseconds to hardware clock cycles, rounding up.
+ *
+ * @param us Duration in microseconds.
+ *
+ * @return Duration in cycles.
+ */
+static inline uint64_t k_us_to_cycles_ceil64(uint32_t us)
+{
+	uint64_t cycles = (uint64_t)us * sys_clock_hw_cycles_per_sec;
+
+	return (cycles + USEC_PER_SEC - 1) / USEC_PER_SEC;
+}
+
+/**
+ * @brief Initialize a high-resolution timeout.
+ *
+ * @param timeout Address of the timeout.
+ * @param handler Function called from an ISR when the timeout expires.
+ *
+ * @return N/A
+ */
+extern void k_hires_timeout_init(struct k_hires_timeout *timeout,
+				 k_hires_timeout_handler_t handler);
+
+/**
+ * @brief Start a high-resolution timeout.
+ *
+ * A timeout already started is restarted with the new deadline. The
+ * handler may start the timeout again, for a periodic one.
+ *
+ * @param timeout Address of the timeout.
+ * @param deadline Absolute deadline, as returned by k_cycle_get_64(). A
+ *                 deadline already passed expires as soon as possible.
+ *
+ * @return N/A
+ */
+extern void k_hires_timeout_start(struct k_hires_timeout *timeout,
+				  uint64_t deadline);
+
+/**
+ * @brief Abort a high-resolution timeout.
+ *
+ * @param timeout Address of the timeout.
+ *
+ * @retval 0 Timeout aborted.
+ * @retval -EINVAL Timeout not started, or already expired.
+ */
+extern int k_hires_timeout_abort(struct k_hires_timeout *timeout);
+
+/**
+ * @brief Put the current thread to sleep until a deadline.
+ *
+ * Unlike k_sleep(), the deadline is not rounded up to a system clock tick.
+ *
+ * @param deadline Absolute deadline, as returned by k_cycle_get_64().
+ *
+ * @return N/A
+ */
+extern void k_sleep_until(uint64_t deadline);
+
+/**
+ * @brief Put the current thread to sleep.
+ *
+ * Unlike k_sleep(), the duration is not rounded up to a system clock tick,
+ * for delays too short to be slept in ticks and too long to be spent in
+ * k_busy_wait().
+ *
+ * @param us Duration in microseconds.
+ *
+ * @return N/A
+ */
+static inline void k_usleep(uint32_t us)
+{
+	k_sleep_until(k_cycle_get_64() + k_us_to_cycles_ceil64(us));
+}
+
+#endif /* CONFIG_SYS_CLOCK_HIRES */
+
 /**
  * @} end addtogroup clock_apis
  */
@@ -1115,7 +1399,7 @@ struct k_queue {
 
 #define K_QUEUE_INITIALIZER(obj) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.data_q = SYS_SLIST_STATIC_INIT(&obj.data_q), \
 	_POLL_EVENT_OBJ_INIT \
 	_OBJECT_TRACING_INIT \
@@ -1242,6 +1526,58 @@ extern void k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list);
  */
 extern void *k_queue_get(struct k_queue *queue, int32_t timeout);
 
+/**
+ * @brief Get all elements from a queue.
+ *
+ * This routine removes every data item from @a queue in a single operation
+ * and appends them, in queue order, to @a list. The whole queue is detached
+ * in constant time, regardless of how many data items it holds.
+ *
+ * If the queue is empty, the calling thread waits for a data item; once
+ * woken up, it also takes any item added to the queue in the meantime.
+ *
+ * This is meant for draining a queue signalled through k_poll(): after a
+ * K_POLL_STATE_FIFO_DATA_AVAILABLE event, call it with K_NO_WAIT.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param queue Address of the queue.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least one data item was moved to @a list.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_queue_get_all(struct k_queue *queue, sys_slist_t *list,
+			   int32_t timeout);
+
+/**
+ * @brief Get a batch of elements from a queue.
+ *
+ * This routine removes up to @a max data items from the head of @a queue in
+ * a single operation and appends them, in queue order, to @a list.
+ *
+ * If the queue is empty, the calling thread waits for a data item; once
+ * woken up, it also takes items added to the queue in the meantime, up to
+ * @a max.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param queue Address of the queue.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param max Maximum number of data items to get (greater than 0).
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items moved to @a list if successful.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_queue_get_batch(struct k_queue *queue, sys_slist_t *list,
+			     int max, int32_t timeout);
+
 /**
  * @brief Query a queue to see if it has data available.
  *
@@ -1260,6 +1596,20 @@ static inline int k_queue_is_empty(struct k_queue *queue)
 	return (int)sys_slist_is_empty(&queue->data_q);
 }
 
+/**
+ * @brief Peek element at the head of queue.
+ *
+ * Return element from the head of queue without removing it.
+ *
+ * @param queue Address of the queue.
+ *
+ * @return Head element, or NULL if queue is empty.
+ */
+static inline void *k_queue_peek_head(struct k_queue *queue)
+{
+	return sys_slist_peek_head(&queue->data_q);
+}
+
 /**
  * @brief Statically define and initialize a queue.
  *
@@ -1385,6 +1735,49 @@ struct k_fifo {
 #define k_fifo_get(fifo, timeout) \
 	k_queue_get((struct k_queue *) fifo, timeout)
 
+/**
+ * @brief Get all elements from a fifo.
+ *
+ * This routine removes every data item from @a fifo in a single operation
+ * and appends them to @a list, in the order k_fifo_get() would have
+ * returned them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param fifo Address of the fifo.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least one data item was moved to @a list.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+#define k_fifo_get_all(fifo, list, timeout) \
+	k_queue_get_all((struct k_queue *) fifo, list, timeout)
+
+/**
+ * @brief Get a batch of elements from a fifo.
+ *
+ * This routine removes up to @a max data items from @a fifo in a single
+ * operation and appends them to @a list, in the order k_fifo_get() would
+ * have returned them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param fifo Address of the fifo.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param max Maximum number of data items to get (greater than 0).
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items moved to @a list if successful.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+#define k_fifo_get_batch(fifo, list, max, timeout) \
+	k_queue_get_batch((struct k_queue *) fifo, list, max, timeout)
+
 /**
  * @brief Query a fifo to see if it has data available.
  *
@@ -1401,6 +1794,22 @@ struct k_fifo {
 #define k_fifo_is_empty(fifo) \
 	k_queue_is_empty((struct k_queue *) fifo)
 
+/**
+ * @brief Peek element at the head of fifo.
+ *
+ * Return element from the head of fifo without removing it. A usecase
+ * for this is if elements of the fifo are themselves containers. Then
+ * on each iteration of processing, a head container will be peeked,
+ * and some data processed out of it, and only if the container is empty,
+ * it will be completely remove from the fifo.
+ *
+ * @param fifo Address of the fifo.
+ *
+ * @return Head element, or NULL if the fifo is empty.
+ */
+#define k_fifo_peek_head(fifo) \
+	k_queue_peek_head((struct k_queue *) fifo)
+
 /**
  * @brief Statically define and initialize a fifo.
  *
@@ -1489,6 +1898,49 @@ struct k_lifo {
 #define k_lifo_get(lifo, timeout) \
 	k_queue_get((struct k_queue *) lifo, timeout)
 
+/**
+ * @brief Get all elements from a lifo.
+ *
+ * This routine removes every data item from @a lifo in a single operation
+ * and appends them to @a list, in the order k_lifo_get() would have
+ * returned them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param lifo Address of the lifo.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least one data item was moved to @a list.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+#define k_lifo_get_all(lifo, list, timeout) \
+	k_queue_get_all((struct k_queue *) lifo, list, timeout)
+
+/**
+ * @brief Get a batch of elements from a lifo.
+ *
+ * This routine removes up to @a max data items from @a lifo in a single
+ * operation and appends them to @a list, in the order k_lifo_get() would
+ * have returned them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param lifo Address of the lifo.
+ * @param list Pointer to sys_slist_t object receiving the data items.
+ * @param max Maximum number of data items to get (greater than 0).
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items moved to @a list if successful.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+#define k_lifo_get_batch(lifo, list, max, timeout) \
+	k_queue_get_batch((struct k_queue *) lifo, list, max, timeout)
+
 /**
  * @brief Statically define and initialize a lifo.
  *
@@ -1520,7 +1972,7 @@ struct k_stack {
 
 #define K_STACK_INITIALIZER(obj, stack_buffer, stack_num_entries) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.base = stack_buffer, \
 	.next = stack_buffer, \
 	.top = stack_buffer + stack_num_entries, \
@@ -1631,8 +2083,23 @@ typedef void (*k_work_handler_t)(struct k_work *work);
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_WORKQUEUE_POOL
+struct k_work_q_worker {
+	sys_slist_t lane;
+	struct k_work_q *work_q;
+	struct k_thread *thread;
+};
+#endif
+
 struct k_work_q {
 	struct k_fifo fifo;
+#ifdef CONFIG_WORKQUEUE_POOL
+	_wait_q_t idle_q;
+	sys_slist_t shared_q;
+	struct k_work_q_worker *workers;
+	uint32_t lanes_busy;
+	uint8_t num_workers;
+#endif
 };
 
 enum {
@@ -1653,6 +2120,11 @@ struct k_delayed_work {
 
 extern struct k_work_q k_sys_work_q;
 
+#ifdef CONFIG_WORKQUEUE_POOL
+extern void _work_q_pool_submit(struct k_work_q *work_q,
+				struct k_work *work);
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -1715,6 +2187,12 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORKQUEUE_POOL
+		if (work_q->num_workers) {
+			_work_q_pool_submit(work_q, work);
+			return;
+		}
+#endif
 		k_fifo_put(&work_q->fifo, work);
 	}
 }
@@ -1752,6 +2230,44 @@ static inline int k_work_pending(struct k_work *work)
 extern void k_work_q_start(struct k_work_q *work_q, char *stack,
 			   size_t stack_size, int prio);
 
+#ifdef CONFIG_WORKQUEUE_POOL
+/**
+ * @brief Start a multi-worker workqueue.
+ *
+ * This routine starts workqueue @a work_q, served by a pool of
+ * @a num_workers threads, which run forever. A handler blocking or running
+ * for a long time thus only holds one of the workers, leaving the others
+ * processing the rest of the work items.
+ *
+ * Each worker owns a lane. Work items submitted by a thread go to the lane
+ * of that thread, which is the worker's own lane when the submitter is one
+ * of the workers: the work items of a lane are processed one at a time, in
+ * submission order, so work items submitted by the same thread keep their
+ * ordering. A worker runs the work items of its own lane first, then those
+ * of the shared queue, then steals from the lane of another worker that is
+ * not currently processing one of them.
+ *
+ * Work items submitted by ISRs, such as delayed work items whose delay has
+ * expired, go to the queue shared by all workers: they are handed out in
+ * submission order, but may be processed concurrently.
+ *
+ * @param work_q Address of workqueue.
+ * @param workers Array of @a num_workers worker objects.
+ * @param num_workers Number of worker threads (1 to 32).
+ * @param stacks Pointer to the stack space of the worker threads, made of
+ *               @a num_workers consecutive stacks.
+ * @param stack_size Size of each worker thread's stack (in bytes), which
+ *                   must keep the next stack properly aligned.
+ * @param prio Priority of the worker threads.
+ *
+ * @return N/A
+ */
+extern void k_work_q_pool_start(struct k_work_q *work_q,
+				struct k_work_q_worker *workers,
+				int num_workers, char *stacks,
+				size_t stack_size, int prio);
+#endif
+
 /**
  * @brief Initialize a delayed work item.
  *
@@ -1912,6 +2428,12 @@ struct k_mutex {
 	struct k_thread *owner;
 	uint32_t lock_count;
 	int owner_orig_prio;
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	/* node in the list of mutexes of the owner, while having waiters */
+	sys_dnode_t owner_node;
+	/* priority of the first waiter, when the node was placed */
+	int waiter_prio;
+#endif
 #ifdef CONFIG_OBJECT_MONITOR
 	int num_lock_state_changes;
 	int num_conflicts;
@@ -1929,7 +2451,7 @@ struct k_mutex {
 
 #define K_MUTEX_INITIALIZER(obj) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.owner = NULL, \
 	.lock_count = 0, \
 	.owner_orig_prio = K_LOWEST_THREAD_PRIO, \
@@ -2029,7 +2551,7 @@ struct k_sem {
 
 #define K_SEM_INITIALIZER(obj, initial_count, count_limit) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.count = initial_count, \
 	.limit = count_limit, \
 	_POLL_EVENT_OBJ_INIT \
@@ -2292,13 +2814,18 @@ struct k_msgq {
 	char *read_ptr;
 	char *write_ptr;
 	uint32_t used_msgs;
+	_wait_q_t put_wait_q;
+	char *put_claim;
+	uint32_t unseen_msgs;
+	char *get_claim;
+	uint32_t held_msgs;
 
 	_OBJECT_TRACING_NEXT_PTR(k_msgq);
 };
 
 #define K_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.max_msgs = q_max_msgs, \
 	.msg_size = q_msg_size, \
 	.buffer_start = q_buffer, \
@@ -2306,6 +2833,11 @@ struct k_msgq {
 	.read_ptr = q_buffer, \
 	.write_ptr = q_buffer, \
 	.used_msgs = 0, \
+	.put_wait_q = _WAIT_Q_INIT(&obj.put_wait_q), \
+	.put_claim = NULL, \
+	.unseen_msgs = 0, \
+	.get_claim = NULL, \
+	.held_msgs = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -2404,6 +2936,80 @@ extern int k_msgq_put(struct k_msgq *q, void *data, int32_t timeout);
  */
 extern int k_msgq_get(struct k_msgq *q, void *data, int32_t timeout);
 
+/**
+ * @brief Claim a message slot of a message queue for writing.
+ *
+ * This routine reserves the next free slot of message queue @a q, so that
+ * the message can be built in place rather than copied by k_msgq_put().
+ * The message is sent by k_msgq_commit(). Only one message of a queue can
+ * be claimed for writing at a time; messages sent by k_msgq_put() meanwhile
+ * are received after the claimed one.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param msg Area to store the address of the message slot.
+ * @param timeout Waiting period for a slot to be free (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message slot claimed.
+ * @retval -EBUSY Another message is claimed for writing.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_msgq_alloc_claim(struct k_msgq *q, void **msg, int32_t timeout);
+
+/**
+ * @brief Send the message claimed for writing in a message queue.
+ *
+ * This routine makes the message written in the slot claimed with
+ * k_msgq_alloc_claim() available for receiving.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return N/A
+ */
+extern void k_msgq_commit(struct k_msgq *q);
+
+/**
+ * @brief Claim a message of a message queue for reading.
+ *
+ * This routine receives the next message of message queue @a q like
+ * k_msgq_get(), but leaves it in place rather than copying it out. Its slot
+ * cannot be reused until it is given back by k_msgq_release(), nor can the
+ * slots of the messages received meanwhile. Only one message of a queue can
+ * be claimed for reading at a time.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param msg Area to store the address of the message.
+ * @param timeout Waiting period to receive the message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message claimed.
+ * @retval -EBUSY Another message is claimed for reading.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_msgq_peek_claim(struct k_msgq *q, void **msg, int32_t timeout);
+
+/**
+ * @brief Give back the message claimed for reading in a message queue.
+ *
+ * This routine frees the slot of the message claimed with
+ * k_msgq_peek_claim(), which must not be accessed afterwards.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return N/A
+ */
+extern void k_msgq_release(struct k_msgq *q);
+
 /**
  * @brief Purge a message queue.
  *
@@ -2429,7 +3035,13 @@ extern void k_msgq_purge(struct k_msgq *q);
  */
 static inline uint32_t k_msgq_num_free_get(struct k_msgq *q)
 {
-	return q->max_msgs - q->used_msgs;
+	uint32_t busy = q->held_msgs + q->used_msgs;
+
+	if (q->put_claim) {
+		busy += 1 + q->unseen_msgs;
+	}
+
+	return q->max_msgs - busy;
 }
 
 /**
@@ -2502,17 +3114,46 @@ struct k_mbox_msg {
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MBOX_MATCH_INDEX
+/* number of hash buckets of a mailbox index, as initialized below */
+#define _MBOX_INDEX_BITS 2
+#define _MBOX_INDEX_SIZE (1 << _MBOX_INDEX_BITS)
+
+#define _MBOX_INDEX_INIT(index) \
+	{ \
+	_WAIT_Q_INIT(&index[0]), _WAIT_Q_INIT(&index[1]), \
+	_WAIT_Q_INIT(&index[2]), _WAIT_Q_INIT(&index[3]), \
+	}
+#endif
+
 struct k_mbox {
+	/* senders to any receiver, or all senders without an index */
 	_wait_q_t tx_msg_queue;
+	/* receivers from any sender, or all receivers without an index */
 	_wait_q_t rx_msg_queue;
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	/* senders to a given receiver, hashed by receiver */
+	_wait_q_t tx_target_index[_MBOX_INDEX_SIZE];
+	/* receivers from a given sender, hashed by sender */
+	_wait_q_t rx_source_index[_MBOX_INDEX_SIZE];
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mbox);
 };
 
+#ifdef CONFIG_MBOX_MATCH_INDEX
+#define _MBOX_INDEXES_INIT(obj) \
+	.tx_target_index = _MBOX_INDEX_INIT(obj.tx_target_index), \
+	.rx_source_index = _MBOX_INDEX_INIT(obj.rx_source_index),
+#else
+#define _MBOX_INDEXES_INIT(obj)
+#endif
+
 #define K_MBOX_INITIALIZER(obj) \
 	{ \
-	.tx_msg_queue = SYS_DLIST_STATIC_INIT(&obj.tx_msg_queue), \
-	.rx_msg_queue = SYS_DLIST_STATIC_INIT(&obj.rx_msg_queue), \
+	.tx_msg_queue = _WAIT_Q_INIT(&obj.tx_msg_queue), \
+	.rx_msg_queue = _WAIT_Q_INIT(&obj.rx_msg_queue), \
+	_MBOX_INDEXES_INIT(obj) \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -2657,6 +3298,35 @@ extern int k_mbox_data_block_get(struct k_mbox_msg *rx_msg,
 				 struct k_mem_pool *pool,
 				 struct k_mem_block *block, int32_t timeout);
 
+/**
+ * @brief Access mailbox message data in place.
+ *
+ * This routine gives the receiver of a message direct access to the data
+ * of the sender, be it in a buffer or in a memory pool block, instead of
+ * copying it. The message must have been received with no buffer, and
+ * must be released by k_mbox_data_release() once the data has been
+ * processed: a synchronous sender waits until then, while an asynchronous
+ * sender gets its semaphore given and can reuse its buffer.
+ *
+ * @param rx_msg Address of a receive message descriptor.
+ *
+ * @return Address of the message data, or NULL if there is none.
+ */
+extern void *k_mbox_data_ptr_get(struct k_mbox_msg *rx_msg);
+
+/**
+ * @brief Release mailbox message data accessed in place.
+ *
+ * This routine disposes of a message whose data was accessed through
+ * k_mbox_data_ptr_get(), reporting all of it as received to the sender.
+ * A memory pool block holding the data is returned to its pool.
+ *
+ * @param rx_msg Address of a receive message descriptor.
+ *
+ * @return N/A
+ */
+extern void k_mbox_data_release(struct k_mbox_msg *rx_msg);
+
 /**
  * @} end defgroup mailbox_apis
  */
@@ -2677,6 +3347,15 @@ struct k_pipe {
 		_wait_q_t      writers; /* Writer wait queue */
 	} wait_q;
 
+#ifdef CONFIG_PIPE_DMA
+	struct {
+		struct device *dev;     /* DMA controller, or NULL */
+		uint32_t       channel; /* Memory to memory channel */
+		size_t         min_xfer; /* Smallest transfer offloaded */
+		int            busy;    /* Channel in use by a writer */
+	} dma;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_pipe);
 };
 
@@ -2687,8 +3366,8 @@ struct k_pipe {
 	.bytes_used = 0,                                              \
 	.read_index = 0,                                              \
 	.write_index = 0,                                             \
-	.wait_q.writers = SYS_DLIST_STATIC_INIT(&obj.wait_q.writers), \
-	.wait_q.readers = SYS_DLIST_STATIC_INIT(&obj.wait_q.readers), \
+	.wait_q.writers = _WAIT_Q_INIT(&obj.wait_q.writers), \
+	.wait_q.readers = _WAIT_Q_INIT(&obj.wait_q.readers), \
 	_OBJECT_TRACING_INIT                            \
 	}
 
@@ -2800,6 +3479,28 @@ extern int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+#ifdef CONFIG_PIPE_DMA
+/**
+ * @brief Offload the large transfers of a pipe to a DMA channel.
+ *
+ * This routine makes @a pipe use memory to memory channel @a channel of
+ * DMA controller @a dev to hand data over from a writer to a waiting reader,
+ * when at least @a min_xfer bytes go to the reader. The writer then sleeps
+ * until the DMA transfer completes, which wakes up the reader. Smaller
+ * transfers, and those that cannot wait for the channel, are copied by the
+ * CPU. The channel must not be used by anything else meanwhile.
+ *
+ * @param pipe Address of the pipe.
+ * @param dev DMA controller, or NULL to stop offloading transfers.
+ * @param channel DMA channel.
+ * @param min_xfer Minimum number of bytes of an offloaded transfer.
+ *
+ * @return N/A
+ */
+extern void k_pipe_dma_set(struct k_pipe *pipe, struct device *dev,
+			   uint32_t channel, size_t min_xfer);
+#endif
+
 /**
  * @} end defgroup pipe_apis
  */
@@ -2815,6 +3516,11 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	uint32_t num_used;
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	/* generation tag in the upper half, block index + 1 in the lower */
+	atomic_t free_head;
+	atomic_t num_waiters;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab);
 };
@@ -2822,7 +3528,7 @@ struct k_mem_slab {
 #define K_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
 			       slab_num_blocks) \
 	{ \
-	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.num_blocks = slab_num_blocks, \
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
@@ -2959,6 +3665,62 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_POOL_TLSF
+
+/*
+ * Two-level segregated fit (TLSF) memory pool
+ *
+ * Free blocks are kept in segregated lists indexed by a first level, the
+ * power of two of their size, and a second level, which linearly splits each
+ * power of two range in _TLSF_SL_INDEX_COUNT. One bitmap per level tells
+ * which lists are not empty, which allows finding a suitable free block, and
+ * thus allocating and freeing, in constant time. Blocks are coalesced with
+ * their free physical neighbours as soon as they are freed.
+ */
+
+#define _TLSF_ALIGN sizeof(void *)
+#define _TLSF_SL_INDEX_LOG2 3
+#define _TLSF_SL_INDEX_COUNT (1 << _TLSF_SL_INDEX_LOG2)
+#define _TLSF_FL_INDEX_SHIFT (_TLSF_SL_INDEX_LOG2 + 2)
+#define _TLSF_FL_INDEX_COUNT \
+	(CONFIG_MEM_POOL_TLSF_FL_INDEX_MAX - _TLSF_FL_INDEX_SHIFT + 2)
+
+struct _tlsf_block {
+	/* block physically before this one, NULL for the first block */
+	struct _tlsf_block *prev_phys;
+
+	/* size of the block, including this header; bit 0 is set if free */
+	size_t size;
+
+	/* free list links, overlap the user data when the block is in use */
+	struct _tlsf_block *next_free;
+	struct _tlsf_block *prev_free;
+};
+
+/* bytes of header in front of the user data of each block */
+#define _TLSF_BLOCK_OVERHEAD (2 * sizeof(void *))
+
+/* Memory pool descriptor */
+struct k_mem_pool {
+	char *bufblock;
+	size_t buf_size;
+	uint32_t fl_bmap;
+	uint32_t sl_bmap[_TLSF_FL_INDEX_COUNT];
+	struct _tlsf_block *free_q[_TLSF_FL_INDEX_COUNT][_TLSF_SL_INDEX_COUNT];
+	_wait_q_t wait_q;
+	_OBJECT_TRACING_NEXT_PTR(k_mem_pool);
+};
+
+/*
+ * Make room for n_max blocks of max_size bytes, each with its header, plus a
+ * header-only sentinel block marking the end of the buffer.
+ */
+#define _TLSF_BUF_SIZE(max_size, n_max) \
+	((n_max) * (ROUND_UP(max_size, _TLSF_ALIGN) + _TLSF_BLOCK_OVERHEAD) + \
+	 _TLSF_BLOCK_OVERHEAD)
+
+#else /* !CONFIG_MEM_POOL_TLSF */
+
 /*
  * Memory pool requires a buffer and two arrays of structures for the
  * memory block accounting:
@@ -3153,6 +3915,8 @@ static void __attribute__ ((used)) __k_mem_pool_quad_block_size_define(void)
 	    : "n"(sizeof(struct k_mem_pool_quad_block)));
 }
 
+#endif /* CONFIG_MEM_POOL_TLSF */
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -3172,6 +3936,11 @@ static void __attribute__ ((used)) __k_mem_pool_quad_block_size_define(void)
  * similarly aligned to this boundary, @a min_size must also be a multiple of
  * @a align.
  *
+ * When CONFIG_MEM_POOL_TLSF is enabled, the pool is a two-level segregated
+ * fit heap instead, sized to hold @a n_max blocks of @a max_size bytes plus
+ * their headers. Blocks of any size can then be allocated from it, and
+ * @a min_size is ignored.
+ *
  * If the pool is to be accessed outside the module where it is defined, it
  * can be declared via
  *
@@ -3183,6 +3952,18 @@ static void __attribute__ ((used)) __k_mem_pool_quad_block_size_define(void)
  * @param n_max Number of maximum sized blocks in the pool.
  * @param align Alignment of the pool's buffer (power of 2).
  */
+#ifdef CONFIG_MEM_POOL_TLSF
+#define K_MEM_POOL_DEFINE(name, min_size, max_size, n_max, align)     \
+	static char __noinit __aligned(max(align, _TLSF_ALIGN))          \
+		_mem_pool_buffer_##name[_TLSF_BUF_SIZE(max_size, n_max)]; \
+	struct k_mem_pool name                                           \
+		__in_section(_k_mem_pool, static, name) = {              \
+		.bufblock = _mem_pool_buffer_##name,                     \
+		.buf_size = _TLSF_BUF_SIZE(max_size, n_max),             \
+		.wait_q = _WAIT_Q_INIT(&name.wait_q),                    \
+		_OBJECT_TRACING_INIT                                     \
+	}
+#else
 #define K_MEM_POOL_DEFINE(name, min_size, max_size, n_max, align)     \
 	_MEMORY_POOL_QUAD_BLOCK_DEFINE(name, min_size, max_size, n_max); \
 	_MEMORY_POOL_BLOCK_SETS_DEFINE(name, min_size, max_size, n_max); \
@@ -3190,6 +3971,7 @@ static void __attribute__ ((used)) __k_mem_pool_quad_block_size_define(void)
 	__asm__("_build_mem_pool " STRINGIFY(name) " " STRINGIFY(min_size) " " \
 	       STRINGIFY(max_size) " " STRINGIFY(n_max) "\n\t");	\
 	extern struct k_mem_pool name
+#endif
 
 /**
  * @brief Allocate memory from a memory pool.
@@ -3231,6 +4013,9 @@ extern void k_mem_pool_free(struct k_mem_block *block);
  * pool may speed up future allocations of memory blocks by eliminating the
  * need for the memory pool to perform an automatic partial defragmentation.
  *
+ * When CONFIG_MEM_POOL_TLSF is enabled, unused memory blocks are concatenated
+ * as soon as they are freed and this routine does nothing.
+ *
  * @param pool Address of the memory pool.
  *
  * @return N/A
@@ -3337,6 +4122,7 @@ enum _poll_states_bits {
 	       + _POLL_NUM_TYPES \
 	       + _POLL_NUM_STATES \
 	       + 1 /* modes */ \
+	       + 1 /* in a poll set ready list */ \
 	      ))
 
 #if _POLL_EVENT_NUM_UNUSED_BITS < 0
@@ -3415,6 +4201,9 @@ struct k_poll_event {
 	/* mode of operation, from enum k_poll_modes */
 	uint32_t mode:1;
 
+	/* PRIVATE - set while queued in a poll set ready list */
+	uint32_t ready_queued:1;
+
 	/* unused bits in 32-bit word */
 	uint32_t unused:_POLL_EVENT_NUM_UNUSED_BITS;
 
@@ -3426,8 +4215,29 @@ struct k_poll_event {
 		struct k_fifo *fifo;
 		struct k_queue *queue;
 	};
+
+#ifdef CONFIG_POLL_SET
+	/* PRIVATE - DO NOT TOUCH */
+	sys_snode_t ready_node;
+#endif
 };
 
+#ifdef CONFIG_POLL_SET
+/* public - persistent poll event set */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+
+	/* poller of all the events in the set; it has no thread */
+	struct _poller poller;
+
+	/* events signaled since being taken by k_poll_set_wait() */
+	sys_slist_t ready_q;
+
+	/* threads waiting for an event of the set to be ready */
+	_wait_q_t wait_q;
+};
+#endif
+
 #define K_POLL_EVENT_INITIALIZER(event_type, event_mode, event_obj) \
 	{ \
 	.poller = NULL, \
@@ -3546,6 +4356,88 @@ extern void k_poll_signal_init(struct k_poll_signal *signal);
 
 extern int k_poll_signal(struct k_poll_signal *signal, int result);
 
+#ifdef CONFIG_POLL_SET
+/**
+ * @brief Initialize a poll set.
+ *
+ * This routine initializes an empty persistent poll event set, prior to its
+ * first use.
+ *
+ * @param set Address of the poll set.
+ *
+ * @return N/A
+ */
+
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add an event to a poll set.
+ *
+ * This routine registers @a event, initialized with k_poll_event_init(), to
+ * the object it is about, once and for all: from then on, the object pushes
+ * the event to the ready list of @a set each time it becomes available,
+ * until the event is removed from the set. If the object is already
+ * available, the event is made ready right away.
+ *
+ * As with k_poll(), only one event can be registered to an object at a
+ * given time, and threads pending on the object have precedence over the
+ * poll set.
+ *
+ * @param set Address of the poll set.
+ * @param event Address of the event, which must not be part of a set or
+ *              passed to k_poll() while it is part of @a set.
+ *
+ * @retval 0 The event was added to the set.
+ * @retval -EADDRINUSE The object already had a poller.
+ */
+
+extern int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event);
+
+/**
+ * @brief Remove an event from a poll set.
+ *
+ * This routine unregisters @a event from its object and drops it from the
+ * ready list of @a set if it was queued there.
+ *
+ * @param set Address of the poll set.
+ * @param event Address of an event previously added to @a set.
+ *
+ * @return N/A
+ */
+
+extern void k_poll_set_remove(struct k_poll_set *set,
+			      struct k_poll_event *event);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * This routine takes up to @a max events from the ready list of @a set,
+ * waiting for one to be signaled if the list is empty. Its cost depends on
+ * the number of ready events only, not on the number of events in the set.
+ *
+ * Readiness is edge-triggered: an event is queued to the ready list when its
+ * object signals it, e.g. when data is put in a fifo, and not again until
+ * taken by this routine. The caller should thus fully consume the object of
+ * each returned event, e.g. drain the fifo, check the state field of the
+ * event for the values that were expected, then reset it to
+ * K_POLL_STATE_NOT_READY.
+ *
+ * @param set Address of the poll set.
+ * @param events Array receiving the addresses of the ready events.
+ * @param max Size of the @a events array (greater than 0).
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of ready events stored in @a events if successful.
+ * @retval -EAGAIN Waiting period timed out, or the ready events were taken
+ *                 by another thread waiting on the set.
+ */
+
+extern int k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_event **events, int max,
+			   int32_t timeout);
+#endif /* CONFIG_POLL_SET */
+
 /* private internal function */
 extern int _handle_obj_poll_event(struct k_poll_event **obj_poll_event,
 				  uint32_t state);
@@ -3554,6 +4446,203 @@ extern int _handle_obj_poll_event(struct k_poll_event **obj_poll_event,
  * @} end defgroup poll_apis
  */
 
+#ifdef CONFIG_TASK_EXECUTOR
+/**
+ * @defgroup task_executor_apis Task Executor APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/*
+ * Stackless tasks, run to completion one after the other by the thread of
+ * an executor. A task is a handler resumed at the yield point it returned
+ * from, which makes it a state machine written as sequential code:
+ *
+ *	static int handler(struct k_task *task)
+ *	{
+ *		struct flow *flow = CONTAINER_OF(task, struct flow, task);
+ *
+ *		K_TASK_BEGIN(task);
+ *		while (1) {
+ *			K_TASK_FIFO_GET(task, &flow->rx, flow->buf);
+ *			process(flow->buf);
+ *			K_TASK_SEM_TAKE(task, &flow->tx_credits);
+ *			send(flow->buf);
+ *		}
+ *		K_TASK_END(task);
+ *	}
+ *
+ * Local variables are lost at yield points: the state of the task is kept
+ * in the structure embedding it. Only one yield point can be on a line,
+ * and none in a switch statement of the handler.
+ */
+
+/* public - values returned by a task handler, through the K_TASK_xxx macros */
+#define K_TASK_DONE 0
+#define K_TASK_PENDING 1
+#define K_TASK_YIELDED 2
+
+struct k_task;
+struct k_task_executor;
+
+typedef int (*k_task_handler_t)(struct k_task *task);
+
+struct k_task {
+	/* PRIVATE - DO NOT TOUCH */
+
+	/* event awaited, part of the poll set of the executor while pending */
+	struct k_poll_event event;
+
+	/* node in the list of the tasks ready to run */
+	sys_snode_t node;
+
+	k_task_handler_t handler;
+	struct k_task_executor *executor;
+
+	/* yield point to resume from, the line it is on */
+	uint16_t resume;
+};
+
+struct k_task_executor {
+	/* PRIVATE - DO NOT TOUCH */
+
+	/* events awaited by the pending tasks */
+	struct k_poll_set set;
+
+	/* tasks spawned or yielded, to run */
+	sys_slist_t ready;
+
+	/* signaled when a task is made ready by another thread */
+	struct k_poll_signal wakeup;
+	struct k_poll_event wakeup_event;
+
+	k_tid_t thread;
+};
+
+/**
+ * @brief Start a task executor.
+ *
+ * This routine starts @a executor, which spawns the thread running its
+ * tasks. The thread runs forever.
+ *
+ * @param executor Address of the task executor.
+ * @param stack Pointer to the executor thread's stack space.
+ * @param stack_size Size of the executor thread's stack (in bytes).
+ * @param prio Priority of the executor thread.
+ *
+ * @return N/A
+ */
+extern void k_task_executor_start(struct k_task_executor *executor,
+				  char *stack, size_t stack_size, int prio);
+
+/**
+ * @brief Spawn a task.
+ *
+ * This routine makes @a task ready to run on @a executor, starting from the
+ * beginning of @a handler. The task must not be running already, and
+ * @a executor must have been started.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param executor Address of the task executor.
+ * @param task Address of the task.
+ * @param handler Handler of the task.
+ *
+ * @return N/A
+ */
+extern void k_task_spawn(struct k_task_executor *executor,
+			 struct k_task *task, k_task_handler_t handler);
+
+/* private internal function */
+extern void _k_task_await(struct k_task *task, uint32_t type, void *obj);
+
+/**
+ * @brief Start the body of a task handler.
+ *
+ * @param task Address of the task.
+ */
+#define K_TASK_BEGIN(task) switch ((task)->resume) { case 0:
+
+/**
+ * @brief End the body of a task handler, the task being done.
+ *
+ * @param task Address of the task.
+ */
+#define K_TASK_END(task) } (task)->resume = 0; return K_TASK_DONE
+
+/**
+ * @brief Yield to the other tasks of the executor.
+ *
+ * The task is resumed after the tasks ready to run, and the events signaled,
+ * were handled.
+ *
+ * @param task Address of the task.
+ */
+#define K_TASK_YIELD(task) \
+	do { \
+		(task)->resume = __LINE__; \
+		return K_TASK_YIELDED; \
+	case __LINE__: ; \
+	} while ((0))
+
+/**
+ * @brief Wait for a condition to be true.
+ *
+ * The condition is evaluated when reaching this yield point, then each time
+ * a k_poll() event of type @a type is signaled for @a obj, until true.
+ *
+ * @param task Address of the task.
+ * @param type Type of the event, from the K_POLL_TYPE_xxx values.
+ * @param obj Object signaling the event.
+ * @param cond Condition to wait for, taking the object if available.
+ */
+#define K_TASK_AWAIT(task, type, obj, cond) \
+	do { \
+		(task)->resume = __LINE__; \
+	case __LINE__: \
+		if (!(cond)) { \
+			_k_task_await(task, type, obj); \
+			return K_TASK_PENDING; \
+		} \
+	} while ((0))
+
+/**
+ * @brief Take a semaphore, waiting for it to be available.
+ *
+ * @param task Address of the task.
+ * @param sem Address of the semaphore.
+ */
+#define K_TASK_SEM_TAKE(task, sem) \
+	K_TASK_AWAIT(task, K_POLL_TYPE_SEM_AVAILABLE, sem, \
+		     k_sem_take(sem, K_NO_WAIT) == 0)
+
+/**
+ * @brief Get a data item from a fifo, waiting for one to be available.
+ *
+ * @param task Address of the task.
+ * @param fifo Address of the fifo.
+ * @param data Lvalue receiving the address of the data item.
+ */
+#define K_TASK_FIFO_GET(task, fifo, data) \
+	K_TASK_AWAIT(task, K_POLL_TYPE_FIFO_DATA_AVAILABLE, fifo, \
+		     ((data) = k_fifo_get(fifo, K_NO_WAIT)) != NULL)
+
+/**
+ * @brief Wait for a poll signal to be signaled.
+ *
+ * The signal is left signaled, for the task to reset it.
+ *
+ * @param task Address of the task.
+ * @param signal Address of the poll signal.
+ */
+#define K_TASK_SIGNAL_WAIT(task, signal) \
+	K_TASK_AWAIT(task, K_POLL_TYPE_SIGNAL, signal, (signal)->signaled)
+
+/**
+ * @} end defgroup task_executor_apis
+ */
+#endif /* CONFIG_TASK_EXECUTOR */
+
 /**
  * @brief Make the CPU idle.
  *
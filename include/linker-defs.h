@@ -148,6 +148,12 @@ extern char __data_ram_start[];
 extern char __data_ram_end[];
 #endif
 
+#ifdef CONFIG_ARCH_HAS_RAMFUNC_SUPPORT
+extern char _ramfunc_ram_start[];
+extern char _ramfunc_ram_end[];
+extern char _ramfunc_rom_start[];
+#endif
+
 extern char _image_rom_start[];
 extern char _image_rom_end[];
 extern char _image_ram_start[];
@@ -24,6 +24,51 @@ extern "C" {
 #define KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID                  0x0002
 #define KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID                      0x0003
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_COMPACT
+/*
+ * Compact event encoding. Each event starts with a header word:
+ *
+ *   31     28 27    25 24          17 16               0
+ *  +---------+--------+--------------+------------------+
+ *  | type    | words  | argument     | timestamp bits   |
+ *  +---------+--------+--------------+------------------+
+ *
+ * followed by the given number of data words. The timestamp bits are the
+ * low bits of the event timestamp: the full timestamp is the one of the
+ * previous event plus the difference of their low bits, and the first event
+ * is relative to a timestamp of 0. Events too far apart are preceded by a
+ * sync event holding the full timestamp.
+ */
+#define KERNEL_EVENT_LOGGER_COMPACT_TYPE(header)     ((header) >> 28)
+#define KERNEL_EVENT_LOGGER_COMPACT_WORDS(header)    (((header) >> 25) & 0x7)
+#define KERNEL_EVENT_LOGGER_COMPACT_ARG(header)      (((header) >> 17) & 0xff)
+#define KERNEL_EVENT_LOGGER_COMPACT_STAMP_BITS       17
+#define KERNEL_EVENT_LOGGER_COMPACT_STAMP_MASK       0x1ffff
+
+#define KERNEL_EVENT_LOGGER_COMPACT_HEADER(type, words, arg, stamp) \
+	(((type) << 28) | ((words) << 25) | ((arg) << 17) | \
+	 ((stamp) & KERNEL_EVENT_LOGGER_COMPACT_STAMP_MASK))
+
+/* control event, the argument tells which */
+#define KERNEL_EVENT_LOGGER_COMPACT_CONTROL_TYPE                0x0
+/* data: the full timestamp */
+#define KERNEL_EVENT_LOGGER_COMPACT_CONTROL_SYNC                0x00
+/* data: number of dropped events, only found in event streams */
+#define KERNEL_EVENT_LOGGER_COMPACT_CONTROL_DROPPED             0x01
+/* data: CPU of the following events, only found in streams of SMP systems */
+#define KERNEL_EVENT_LOGGER_COMPACT_CONTROL_CPU                 0x02
+
+/* argument: compact ID assigned to the thread, data: thread pointer */
+#define KERNEL_EVENT_LOGGER_COMPACT_THREAD_ID_TYPE              0xf
+
+/* argument of context switches to threads without a compact ID */
+#define KERNEL_EVENT_LOGGER_COMPACT_NO_THREAD_ID                0x00
+/* argument of interrupts whose number does not fit, data: the number */
+#define KERNEL_EVENT_LOGGER_COMPACT_NO_IRQ                      0xff
+/* argument of other events written with sys_k_event_logger_put() */
+#define KERNEL_EVENT_LOGGER_COMPACT_RAW                         0x01
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_COMPACT */
+
 #ifndef _ASMLANGUAGE
 
 extern struct event_logger sys_k_event_logger;
@@ -173,6 +218,10 @@ static inline int sys_k_must_log_event(int event_type)
  *
  * @return N/A
  */
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_COMPACT
+extern void sys_k_event_logger_put(uint16_t event_id, uint32_t *event_data,
+				   uint8_t data_size);
+#else
 static inline void sys_k_event_logger_put(uint16_t event_id,
 					  uint32_t *event_data,
 					  uint8_t data_size)
@@ -186,6 +235,7 @@ static inline void sys_k_event_logger_put(uint16_t event_id,
 	ARG_UNUSED(data_size);
 #endif /* CONFIG_KERNEL_EVENT_LOGGER */
 };
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_COMPACT */
 
 /**
  * @brief Write an event to the kernel event logger (with timestamp only).
@@ -224,7 +274,12 @@ static inline void sys_k_event_logger_put_timed(uint16_t event_id)
  * @retval -EMSGSIZE Buffer too small; @a data_size now indicates
  *         the size of the event to be retrieved.
  */
-#ifdef CONFIG_KERNEL_EVENT_LOGGER
+#if defined(CONFIG_KERNEL_EVENT_LOGGER_COMPACT)
+#if !defined(CONFIG_KERNEL_EVENT_LOGGER_STREAM)
+extern int sys_k_event_logger_get(uint16_t *event_id, uint8_t *dropped,
+				  uint32_t *event_data, uint8_t *data_size);
+#endif
+#elif defined(CONFIG_KERNEL_EVENT_LOGGER)
 static inline int sys_k_event_logger_get(uint16_t *event_id, uint8_t *dropped,
 				     uint32_t *event_data, uint8_t *data_size)
 {
@@ -250,7 +305,13 @@ static inline int sys_k_event_logger_get(uint16_t *event_id, uint8_t *dropped,
  * @retval -EMSGSIZE Buffer too small; @a data_size now indicates
  *         the size of the event to be retrieved.
  */
-#ifdef CONFIG_KERNEL_EVENT_LOGGER
+#if defined(CONFIG_KERNEL_EVENT_LOGGER_COMPACT)
+#if !defined(CONFIG_KERNEL_EVENT_LOGGER_STREAM)
+extern int sys_k_event_logger_get_wait(uint16_t *event_id, uint8_t *dropped,
+				       uint32_t *event_data,
+				       uint8_t *data_size);
+#endif
+#elif defined(CONFIG_KERNEL_EVENT_LOGGER)
 static inline int sys_k_event_logger_get_wait(uint16_t *event_id,
 		uint8_t *dropped, uint32_t *event_data, uint8_t *data_size)
 {
@@ -280,7 +341,15 @@ static inline int sys_k_event_logger_get_wait(uint16_t *event_id,
  * @retval -EMSGSIZE Buffer too small; @a data_size now indicates
  *         the size of the event to be retrieved.
  */
-#if defined(CONFIG_KERNEL_EVENT_LOGGER) && defined(CONFIG_NANO_TIMEOUTS)
+#if defined(CONFIG_KERNEL_EVENT_LOGGER_COMPACT)
+#if !defined(CONFIG_KERNEL_EVENT_LOGGER_STREAM)
+extern int sys_k_event_logger_get_wait_timeout(uint16_t *event_id,
+					       uint8_t *dropped,
+					       uint32_t *event_data,
+					       uint8_t *data_size,
+					       uint32_t timeout);
+#endif
+#elif defined(CONFIG_KERNEL_EVENT_LOGGER) && defined(CONFIG_NANO_TIMEOUTS)
 static inline int sys_k_event_logger_get_wait_timeout(uint16_t *event_id,
 			uint8_t *dropped, uint32_t *event_data,
 			uint8_t *data_size, uint32_t timeout)
@@ -35,6 +35,67 @@ extern "C" {
  * @defgroup system_log System Log
  * @{
  */
+
+#if defined(CONFIG_SYS_LOG_DEFERRED)
+#include <stddef.h>
+#include <stdint.h>
+#include <toolchain.h>
+#include <misc/util.h>
+
+/**
+ * @brief Log module
+ *
+ * Each compile unit logging messages has a module, named after its log
+ * domain, whose level can be changed at runtime.
+ */
+struct sys_log_module {
+	const char *name;
+	uint8_t level;
+	uint8_t newline;
+};
+
+/**
+ * @brief Log backend
+ *
+ * Backends are given each message formatted as a whole line.
+ */
+struct sys_log_backend {
+	/** Output a line of @a len characters, null-terminated. */
+	void (*put)(const struct sys_log_backend *backend, int level,
+		    const char *line, size_t len);
+	struct sys_log_backend *next;
+};
+
+/**
+ * @brief Register a log backend.
+ *
+ * @param backend Backend to register, which must stay valid.
+ */
+void sys_log_backend_register(struct sys_log_backend *backend);
+
+/**
+ * @brief Set the runtime log level of a log domain.
+ *
+ * Messages above the level the modules were built with can't be enabled
+ * back at runtime.
+ *
+ * @param domain Log domain name.
+ * @param level New log level, e.g. SYS_LOG_LEVEL_WARNING.
+ *
+ * @return Number of modules of that domain, 0 if there is none.
+ */
+int sys_log_level_set(const char *domain, int level);
+
+/**
+ * @brief Output the pending log messages in the caller's context.
+ */
+void sys_log_flush(void);
+
+extern __printf_like(5, 6) void _sys_log_put(struct sys_log_module *module,
+					     int level, const char *func,
+					     int nargs, const char *fmt, ...);
+#endif /* CONFIG_SYS_LOG_DEFERRED */
+
 #if defined(CONFIG_SYS_LOG) && (SYS_LOG_LEVEL > SYS_LOG_LEVEL_OFF)
 
 #define IS_SYS_LOG_ACTIVE 1
@@ -94,6 +155,39 @@ void syslog_hook_install(void (*hook)(const char *, ...));
 #define SYS_LOG_NL ""
 #endif
 
+#if defined(CONFIG_SYS_LOG_DEFERRED)
+static struct sys_log_module _sys_log_module __used
+	__in_section(_sys_log_module, static, module) = {
+	.name = SYS_LOG_DOMAIN,
+	.level = SYS_LOG_LEVEL,
+	.newline = (SYS_LOG_NL[0] != '\0'),
+};
+
+/* messages are only recorded, the format is applied by the log thread */
+#define LOG_DEFERRED(log_lv, ...)					\
+	do {								\
+		if ((log_lv) <= _sys_log_module.level) {		\
+			_sys_log_put(&_sys_log_module, log_lv, __func__,\
+				     NUM_VA_ARGS_LESS_1(__VA_ARGS__),	\
+				     __VA_ARGS__);			\
+		}							\
+	} while (0)
+
+#define SYS_LOG_ERR(...) LOG_DEFERRED(SYS_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#if (SYS_LOG_LEVEL >= SYS_LOG_LEVEL_WARNING)
+#define SYS_LOG_WRN(...) LOG_DEFERRED(SYS_LOG_LEVEL_WARNING, __VA_ARGS__)
+#endif
+
+#if (SYS_LOG_LEVEL >= SYS_LOG_LEVEL_INFO)
+#define SYS_LOG_INF(...) LOG_DEFERRED(SYS_LOG_LEVEL_INFO, __VA_ARGS__)
+#endif
+
+#if (SYS_LOG_LEVEL == SYS_LOG_LEVEL_DEBUG)
+#define SYS_LOG_DBG(...) LOG_DEFERRED(SYS_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
+#else
 /* [domain] [level] function: */
 #define LOG_LAYOUT "[%s]%s %s: %s"
 #define LOG_BACKEND_CALL(log_lv, log_color, log_format, color_off, ...)	\
@@ -121,6 +215,7 @@ void syslog_hook_install(void (*hook)(const char *, ...));
 #if (SYS_LOG_LEVEL == SYS_LOG_LEVEL_DEBUG)
 #define SYS_LOG_DBG(...) LOG_NO_COLOR(SYS_LOG_TAG_DBG, ##__VA_ARGS__)
 #endif
+#endif /* CONFIG_SYS_LOG_DEFERRED */
 
 #else
 /**
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Boot time profile
+ *
+ * With CONFIG_BOOT_TIME_PROFILE, the kernel records the time taken by the
+ * phases of its initialization and by the init function of each device and
+ * SYS_INIT() entry, in CPU clock cycles like CONFIG_BOOT_TIME_MEASUREMENT.
+ */
+
+#ifndef _BOOT_PROFILE_H_
+#define _BOOT_PROFILE_H_
+
+#include <stdint.h>
+#include <device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct boot_profile_entry {
+	/** Kernel phase, NULL for a device */
+	const char *phase;
+	/** Device initialized, NULL for a kernel phase */
+	struct device *dev;
+	/** Init level of the device, -1 for a kernel phase */
+	int level;
+	/** Cycles since reset when the phase or the init function began */
+	uint64_t start;
+	/** Cycles taken */
+	uint32_t cycles;
+};
+
+/**
+ * @brief Get the entries of the boot profile
+ *
+ * The entries are in the order they were recorded, until
+ * boot_profile_report() sorts them.
+ *
+ * @param entries Set to the array of entries.
+ *
+ * @return Number of entries.
+ */
+int boot_profile_get(struct boot_profile_entry **entries);
+
+/**
+ * @brief Print the boot profile
+ *
+ * The entries are printed from the slowest to the fastest, along with the
+ * share of the time from the kernel start to the report they account for.
+ * SYS_INIT() entries, which have no name, are printed by the address of
+ * their init function.
+ */
+void boot_profile_report(void);
+
+void _boot_profile_record(const char *phase, struct device *dev, int level,
+			  uint64_t start, uint64_t end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BOOT_PROFILE_H_ */
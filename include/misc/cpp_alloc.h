@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief C++ object allocator
+ *
+ * @details See misc/Kconfig and the CPLUSPLUS_SLAB_ALLOCATOR help for details.
+ */
+
+#ifndef _misc_cpp_alloc__h_
+#define _misc_cpp_alloc__h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of size classes allocated from memory slabs */
+#define CPP_ALLOC_NUM_CLASSES 4
+
+/** @brief Statistics of a size class */
+struct cpp_alloc_class_stats {
+	/** Size of the blocks of the class */
+	size_t block_size;
+	/** Number of blocks of the class */
+	uint32_t num_blocks;
+	/** Number of blocks currently allocated */
+	uint32_t used;
+	/** Highest number of blocks allocated at once */
+	uint32_t max_used;
+	/** Number of allocations served by the class */
+	uint32_t allocs;
+	/** Number of allocations of the class size served by the heap,
+	 * because the class was exhausted
+	 */
+	uint32_t exhausted;
+};
+
+/** @brief Statistics of the C++ object allocator */
+struct cpp_alloc_stats {
+	struct cpp_alloc_class_stats classes[CPP_ALLOC_NUM_CLASSES];
+	/** Number of allocations served by the heap memory pool */
+	uint32_t heap_allocs;
+	/** Number of allocations that failed */
+	uint32_t failures;
+};
+
+/**
+ * @brief Allocate memory for a C++ object
+ *
+ * Used by operator new. The memory is taken from the smallest memory slab
+ * whose blocks can hold @a size bytes, and otherwise from the heap memory
+ * pool.
+ *
+ * @param size Size of the object, in bytes.
+ *
+ * @return Address of the memory, or NULL.
+ */
+extern void *cpp_alloc(size_t size);
+
+/**
+ * @brief Free memory allocated with cpp_alloc()
+ *
+ * Used by operator delete. Does nothing if @a ptr is NULL.
+ *
+ * @param ptr Address of the memory.
+ *
+ * @return N/A
+ */
+extern void cpp_free(void *ptr);
+
+/**
+ * @brief Get the statistics of the C++ object allocator
+ *
+ * @param stats Filled with the statistics.
+ *
+ * @return N/A
+ */
+extern void cpp_alloc_stats_get(struct cpp_alloc_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _misc_cpp_alloc__h_ */
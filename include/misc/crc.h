@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief CRC computation
+ *
+ * @details The 16 and 32 bit CRCs are table driven, with one table per CRC,
+ * or four with CONFIG_CRC_SLICE_BY_4 to process four bytes at once. None of
+ * them applies a final XOR, so a CRC can be computed in several calls, each
+ * one given the result of the previous one as its seed.
+ */
+
+#ifndef _misc_crc__h_
+#define _misc_crc__h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Compute a CRC-8, most significant bit first
+ *
+ * Bitwise, meant for the few bytes protected by the CRCs of sensors and
+ * similar devices.
+ *
+ * @param src Data.
+ * @param len Length of the data, in bytes.
+ * @param polynomial Polynomial, without its x^8 term.
+ * @param seed Initial value of the CRC.
+ *
+ * @return CRC of the data.
+ */
+uint8_t crc8(const uint8_t *src, size_t len, uint8_t polynomial,
+	     uint8_t seed);
+
+/**
+ * @brief Compute a CRC-16/ITU-T, most significant bit first
+ *
+ * Polynomial 0x1021 (x^16 + x^12 + x^5 + 1), as used by XMODEM (seed 0)
+ * or CCITT-FALSE (seed 0xffff).
+ *
+ * @param seed Initial value of the CRC, or CRC of the preceding data.
+ * @param src Data.
+ * @param len Length of the data, in bytes.
+ *
+ * @return CRC of the data.
+ */
+uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len);
+
+/**
+ * @brief Compute a CRC-16/CCITT, least significant bit first
+ *
+ * Polynomial 0x1021 reflected, as used by KERMIT and, with a seed of 0,
+ * the IEEE 802.15.4 FCS, to be sent least significant byte first.
+ *
+ * @param seed Initial value of the CRC, or CRC of the preceding data.
+ * @param src Data.
+ * @param len Length of the data, in bytes.
+ *
+ * @return CRC of the data.
+ */
+uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len);
+
+/**
+ * @brief Update a CRC-32/IEEE, least significant bit first
+ *
+ * Polynomial 0x04c11db7 reflected, as used by Ethernet and zlib. Start
+ * with a seed of 0xffffffff and invert the result, or use crc32_ieee().
+ *
+ * @param seed Initial value of the CRC, or CRC of the preceding data.
+ * @param src Data.
+ * @param len Length of the data, in bytes.
+ *
+ * @return CRC of the data, not inverted.
+ */
+uint32_t crc32_ieee_update(uint32_t seed, const uint8_t *src, size_t len);
+
+/**
+ * @brief Compute a CRC-32/IEEE
+ *
+ * @param src Data.
+ * @param len Length of the data, in bytes.
+ *
+ * @return CRC of the data, inverted.
+ */
+static inline uint32_t crc32_ieee(const uint8_t *src, size_t len)
+{
+	return ~crc32_ieee_update(0xffffffff, src, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _misc_crc__h_ */
@@ -35,6 +35,9 @@ extern "C" {
  * No other conversion specification capabilities are supported, such as flags,
  * field width, precision, or length attributes.
  *
+ * With CONFIG_PRINTK_DEFERRED, the message is only recorded and is formatted
+ * and output later by a low priority thread, or by printk_flush().
+ *
  * @param fmt Format string.
  * @param ... Optional list of format arguments.
  *
@@ -47,6 +50,37 @@ extern __printf_like(3, 4) int snprintk(char *str, size_t size,
 extern int vsnprintk(char *str, size_t size, const char *fmt, va_list ap);
 
 void _vprintk(int (*out)(int, void *), void *ctx, const char *fmt, va_list ap);
+
+#ifdef CONFIG_PRINTK_DEFERRED
+#include <misc/util.h>
+
+extern __printf_like(2, 3) int _printk_deferred(int nargs, const char *fmt,
+						...);
+
+/**
+ * @brief Output the deferred printk() messages.
+ *
+ * This routine formats and outputs the messages recorded by printk() in the
+ * caller's context, without waiting for the deferred printk() thread. It is
+ * meant to be called before the system halts, e.g. from a fatal error
+ * handler.
+ *
+ * @return N/A
+ */
+extern void printk_flush(void);
+
+/*
+ * Counting the arguments at build time lets printk() store them without
+ * parsing the format string. Taking the address of printk still gives the
+ * immediate version.
+ */
+#define printk(...) \
+	_printk_deferred(NUM_VA_ARGS_LESS_1(__VA_ARGS__), __VA_ARGS__)
+#else
+static inline void printk_flush(void)
+{
+}
+#endif /* CONFIG_PRINTK_DEFERRED */
 #else
 static inline __printf_like(1, 2) int printk(const char *fmt, ...)
 {
@@ -73,6 +107,10 @@ static inline int vsnprintk(char *str, size_t size, const char *fmt,
 
 	return 0;
 }
+
+static inline void printk_flush(void)
+{
+}
 #endif
 
 #ifdef __cplusplus
@@ -205,6 +205,200 @@ int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 		     uint32_t *data, uint8_t *size32);
 
+/**
+ * @brief A structure to represent a byte ring buffer
+ *
+ * A byte ring buffer stores a stream of bytes rather than data items, and
+ * can be written to by one producer and read from by one consumer at the
+ * same time without locking, e.g. by an ISR and a thread.
+ */
+struct byte_ring_buf {
+	atomic_t head;	 /**< Free running read index, moved by the consumer */
+	atomic_t tail;	 /**< Free running write index, moved by the producer */
+	uint32_t size;   /**< Size of buf in bytes, a power of 2 */
+	uint8_t *buf;	 /**< Memory region for stored bytes */
+};
+
+/**
+ * @brief Statically define and initialize a byte ring buffer.
+ *
+ * This macro establishes a byte ring buffer of 2^pow bytes, where @a pow is
+ * the specified ring buffer size exponent.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct byte_ring_buf <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define SYS_BYTE_RING_BUF_DECLARE_POW2(name, pow) \
+	static uint8_t _byte_ring_buffer_data_##name[1 << (pow)]; \
+	struct byte_ring_buf name = { \
+		.size = (1 << (pow)), \
+		.buf = _byte_ring_buffer_data_##name \
+	};
+
+/**
+ * @brief Initialize a byte ring buffer.
+ *
+ * This routine initializes a byte ring buffer, prior to its first use. It is
+ * only used for ring buffers not defined using
+ * SYS_BYTE_RING_BUF_DECLARE_POW2.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Ring buffer size in bytes, a power of 2.
+ * @param data Ring buffer data area (typically uint8_t data[size]).
+ */
+static inline void sys_byte_ring_buf_init(struct byte_ring_buf *buf,
+					  uint32_t size, uint8_t *data)
+{
+	__ASSERT(is_power_of_two(size), "size is not a power of 2");
+
+	buf->head = 0;
+	buf->tail = 0;
+	buf->size = size;
+	buf->buf = data;
+}
+
+/**
+ * @brief Determine the number of bytes stored in a byte ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes that can be read.
+ */
+static inline uint32_t sys_byte_ring_buf_used_get(struct byte_ring_buf *buf)
+{
+	return (uint32_t)atomic_get(&buf->tail) -
+	       (uint32_t)atomic_get(&buf->head);
+}
+
+/**
+ * @brief Determine if a byte ring buffer is empty.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int sys_byte_ring_buf_is_empty(struct byte_ring_buf *buf)
+{
+	return sys_byte_ring_buf_used_get(buf) == 0;
+}
+
+/**
+ * @brief Determine free space in a byte ring buffer.
+ *
+ * Unlike a ring buffer of data items, a byte ring buffer can be filled
+ * completely.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes that can be written.
+ */
+static inline uint32_t sys_byte_ring_buf_space_get(struct byte_ring_buf *buf)
+{
+	return buf->size - sys_byte_ring_buf_used_get(buf);
+}
+
+/**
+ * @brief Claim space to write to in a byte ring buffer.
+ *
+ * This routine gives the producer direct access to the free space of ring
+ * buffer @a buf, so that data can be written in place rather than copied.
+ * The area is contiguous, hence can be smaller than the free space when the
+ * end of the buffer is reached: claim again after
+ * sys_byte_ring_buf_put_finish() to get the rest. Claiming again before
+ * finishing gives the same area.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Area to store the address of the claimed space.
+ * @param size Number of bytes wanted.
+ *
+ * @return Number of bytes claimed, up to @a size; 0 if the ring buffer is
+ *         full.
+ */
+uint32_t sys_byte_ring_buf_put_claim(struct byte_ring_buf *buf,
+				     uint8_t **data, uint32_t size);
+
+/**
+ * @brief Make written bytes available to the consumer of a byte ring buffer.
+ *
+ * This routine commits the first @a size bytes of the space claimed with
+ * sys_byte_ring_buf_put_claim(). Committing less than claimed is allowed.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Number of bytes written.
+ *
+ * @retval 0 Bytes were committed.
+ * @retval -EINVAL @a size exceeds the free space.
+ */
+int sys_byte_ring_buf_put_finish(struct byte_ring_buf *buf, uint32_t size);
+
+/**
+ * @brief Claim data to read from a byte ring buffer.
+ *
+ * This routine gives the consumer direct access to the data of ring buffer
+ * @a buf, so that it can be read in place rather than copied. The area is
+ * contiguous, hence can hold less than what is stored when the end of the
+ * buffer is reached: claim again after sys_byte_ring_buf_get_finish() to get
+ * the rest. Claiming again before finishing gives the same area.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Area to store the address of the claimed data.
+ * @param size Number of bytes wanted.
+ *
+ * @return Number of bytes claimed, up to @a size; 0 if the ring buffer is
+ *         empty.
+ */
+uint32_t sys_byte_ring_buf_get_claim(struct byte_ring_buf *buf,
+				     uint8_t **data, uint32_t size);
+
+/**
+ * @brief Release read bytes to the producer of a byte ring buffer.
+ *
+ * This routine frees the first @a size bytes of the data claimed with
+ * sys_byte_ring_buf_get_claim(). Freeing less than claimed is allowed.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Number of bytes read.
+ *
+ * @retval 0 Bytes were freed.
+ * @retval -EINVAL @a size exceeds the data stored.
+ */
+int sys_byte_ring_buf_get_finish(struct byte_ring_buf *buf, uint32_t size);
+
+/**
+ * @brief Write bytes to a byte ring buffer.
+ *
+ * This routine copies as many bytes from @a data as fit in ring buffer
+ * @a buf.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of the bytes to write.
+ * @param size Number of bytes to write.
+ *
+ * @return Number of bytes written.
+ */
+uint32_t sys_byte_ring_buf_put(struct byte_ring_buf *buf, const uint8_t *data,
+			       uint32_t size);
+
+/**
+ * @brief Read bytes from a byte ring buffer.
+ *
+ * This routine copies up to @a size bytes from ring buffer @a buf to
+ * @a data.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Area to store the bytes read.
+ * @param size Size of the area.
+ *
+ * @return Number of bytes read.
+ */
+uint32_t sys_byte_ring_buf_get(struct byte_ring_buf *buf, uint8_t *data,
+			       uint32_t size);
+
 /**
  * @}
  */
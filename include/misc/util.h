@@ -172,6 +172,18 @@ static inline int64_t arithmetic_shift_right(int64_t value, uint8_t shift)
  */
 #define _IS_ENABLED3(ignore_this, val, ...) val
 
+/**
+ * @brief Number of arguments in a variable argument list, minus one
+ *
+ * Expands to the number of arguments following the first one, e.g. the
+ * number of arguments following a format string, up to 15.
+ */
+#define NUM_VA_ARGS_LESS_1(...) \
+	_NUM_VA_ARGS_LESS_1(__VA_ARGS__, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, \
+			    5, 4, 3, 2, 1, 0)
+#define _NUM_VA_ARGS_LESS_1(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, \
+			    _11, _12, _13, _14, _15, n, ...) n
+
 #ifdef __cplusplus
 }
 #endif
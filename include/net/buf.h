@@ -386,6 +386,12 @@ static inline void net_buf_simple_restore(struct net_buf_simple *buf,
   */
 #define NET_BUF_FRAGS        BIT(0)
 
+/** Flag indicating that the buffer data is not stored in the buffer but
+  * refers to external memory, which must not be written to. Such a buffer
+  * has neither headroom nor tailroom.
+  */
+#define NET_BUF_EXTERNAL_DATA BIT(1)
+
 /** @brief Network buffer representation.
   *
   * This struct is used to represent network buffers. Such buffers are
@@ -402,7 +408,7 @@ struct net_buf {
 	};
 
 #if defined(CONFIG_NET_TCP)
-	/** List pointer used for TCP retransmit buffering */
+	/** List pointer used for TCP retransmit and receive buffering */
 	sys_snode_t sent_list;
 #endif /* CONFIG_NET_TCP */
 
@@ -412,6 +418,9 @@ struct net_buf {
 	/** Bit-field of buffer flags. */
 	uint8_t flags;
 
+	/** Index of the buffer in its pool. */
+	uint16_t index;
+
 	/** Where the buffer should go when freed up. */
 	struct net_buf_pool *pool;
 
@@ -441,9 +450,18 @@ struct net_buf {
 };
 
 struct net_buf_pool {
-	/** LIFO to place the buffer into when free */
+	/** LIFO to hand free buffers over to the threads waiting for one */
 	struct k_lifo free;
 
+	/** Lock-free stack of the other free buffers: a tag, changed by
+	 *  every push and pop, in the upper 16 bits, and the index + 1 of
+	 *  the top buffer, 0 if none, in the lower ones.
+	 */
+	atomic_t stack;
+
+	/** Number of threads waiting on the LIFO */
+	atomic_t waiters;
+
 	/** Number of buffers in pool */
 	const uint16_t buf_count;
 
@@ -558,10 +576,16 @@ struct net_buf *net_buf_get(struct k_fifo *fifo, int32_t timeout);
  *
  *  @param buf Buffer to destroy.
  */
-static inline void net_buf_destroy(struct net_buf *buf)
-{
-	k_lifo_put(&buf->pool->free, buf);
-}
+void net_buf_destroy(struct net_buf *buf);
+
+/**
+ *  @brief Get the number of free buffers in a pool.
+ *
+ *  @param pool Which pool to count the free buffers of.
+ *
+ *  @return Number of buffers that can be allocated without waiting.
+ */
+int net_buf_pool_free_count(struct net_buf_pool *pool);
 
 /**
  *  @brief Initialize buffer with the given headroom.
@@ -863,7 +887,6 @@ static inline void *net_buf_user_data(struct net_buf *buf)
 #define net_buf_pull_be32(buf) net_buf_simple_pull_be32(&(buf)->b)
 
 /**
- *  @def net_buf_tailroom
  *  @brief Check buffer tailroom.
  *
  *  Check how much free space there is at the end of the buffer.
@@ -872,10 +895,16 @@ static inline void *net_buf_user_data(struct net_buf *buf)
  *
  *  @return Number of bytes available at the end of the buffer.
  */
-#define net_buf_tailroom(buf) net_buf_simple_tailroom(&(buf)->b)
+static inline size_t net_buf_tailroom(struct net_buf *buf)
+{
+	if (buf->flags & NET_BUF_EXTERNAL_DATA) {
+		return 0;
+	}
+
+	return net_buf_simple_tailroom(&buf->b);
+}
 
 /**
- *  @def net_buf_headroom
  *  @brief Check buffer headroom.
  *
  *  Check how much free space there is in the beginning of the buffer.
@@ -884,7 +913,14 @@ static inline void *net_buf_user_data(struct net_buf *buf)
  *
  *  @return Number of bytes available in the beginning of the buffer.
  */
-#define net_buf_headroom(buf) net_buf_simple_headroom(&(buf)->b)
+static inline size_t net_buf_headroom(struct net_buf *buf)
+{
+	if (buf->flags & NET_BUF_EXTERNAL_DATA) {
+		return 0;
+	}
+
+	return net_buf_simple_headroom(&buf->b);
+}
 
 /**
  *  @def net_buf_tail
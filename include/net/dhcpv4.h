@@ -19,6 +19,7 @@
 
 #include <misc/slist.h>
 #include <stdint.h>
+#include <net/net_ip.h>
 
 /** Current state of DHCPv4 client address negotiation.
  *
@@ -27,6 +28,7 @@
  */
 enum net_dhcpv4_state {
 	NET_DHCPV4_INIT,
+	NET_DHCPV4_INIT_REBOOT,
 	NET_DHCPV4_DISCOVER,
 	NET_DHCPV4_REQUEST,
 	NET_DHCPV4_RENEWAL,
@@ -44,6 +46,52 @@ enum net_dhcpv4_state {
  */
 void net_dhcpv4_start(struct net_if *iface);
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+/** DHCPv4 lease kept across reboots */
+struct net_dhcpv4_lease {
+	/** Leased address */
+	struct in_addr addr;
+
+	/** Server which granted the lease */
+	struct in_addr server_id;
+};
+
+/** DHCPv4 lease storage. */
+struct net_dhcpv4_lease_storage {
+	/** Load the last lease of an interface.
+	 *
+	 *  @param iface Network interface
+	 *  @param lease Lease to fill
+	 *
+	 *  @return 0 if a lease was loaded, negative error value otherwise.
+	 */
+	int (*load)(struct net_if *iface, struct net_dhcpv4_lease *lease);
+
+	/** Store the lease just granted to an interface.
+	 *
+	 *  @param iface Network interface
+	 *  @param lease Lease granted
+	 *
+	 *  @return 0 on success or negative error value on failure.
+	 */
+	int (*store)(struct net_if *iface,
+		     const struct net_dhcpv4_lease *lease);
+};
+
+/**
+ *  @brief Register DHCPv4 lease storage
+ *
+ *  @details Register the callbacks loading the last lease of an
+ *  interface when net_dhcpv4_start() is called, for it to be requested
+ *  again, and storing the leases granted. To be called before
+ *  net_dhcpv4_start().
+ *
+ *  @param storage Storage callbacks, kept until the next call
+ */
+void net_dhcpv4_lease_storage_register(
+	const struct net_dhcpv4_lease_storage *storage);
+#endif /* CONFIG_NET_DHCPV4_LEASE_REUSE */
+
 /**
  * @}
  */
@@ -24,10 +24,27 @@ enum dns_query_type {
 	DNS_QUERY_TYPE_AAAA = 28 /* IPv6 */
 };
 
+struct dns_context;
+
+/**
+ * @brief Callback of an asynchronous resolution
+ *
+ * @param ctx DNS Client structure passed to dns_resolve_async
+ * @param status What dns_resolve would have returned
+ * @param user_data User data passed to dns_resolve_async
+ */
+typedef void (*dns_resolve_cb_t)(struct dns_context *ctx, int status,
+				 void *user_data);
+
 /**
  * DNS client context structure
  */
 struct dns_context {
+	/* fifo reserved word and async callback, for internal use only */
+	void *fifo_reserved;
+	dns_resolve_cb_t cb;
+	void *user_data;
+
 	/* rx_sem and rx buffer, for internal use only */
 	struct k_sem rx_sem;
 	struct net_buf *rx_buf;
@@ -41,7 +58,9 @@ struct dns_context {
 		struct in6_addr *ipv6;
 	} address;
 
-	/** IP address and port number of the DNS server. */
+	/** IP address and port number of the DNS server, or an array of
+	 *  'servers' of them. They must be of the same family as net_ctx.
+	 */
 	struct sockaddr *dns_server;
 
 	/** RX/TX timeout.
@@ -63,6 +82,11 @@ struct dns_context {
 
 	/** Number of IPv4 addresses stored in 'address'. */
 	uint8_t items;
+
+	/** Number of DNS servers in 'dns_server', all queried at once.
+	 *  dns_init sets it to 1.
+	 */
+	uint8_t servers;
 };
 
 /**
@@ -87,6 +111,11 @@ int dns_init(struct dns_context *ctx);
  * an IPv4 server to look-up for IPv6 address. Domain name services are not
  * tied to any specific routing or transport technology.
  *
+ * If CONFIG_DNS_RESOLVER_CACHE_ENTRIES is not 0, answers are cached for
+ * their TTL, and names without address for
+ * CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL seconds. Cached names are not
+ * queried again.
+ *
  * @param ctx DNS Client structure
  * @retval 0 on success. The number of returned addresses (client->items)
  * may be less than the one reported by the DNS server. However, this situation
@@ -100,6 +129,24 @@ int dns_init(struct dns_context *ctx);
  */
 int dns_resolve(struct dns_context *ctx);
 
+#if defined(CONFIG_DNS_RESOLVER_ASYNC)
+/**
+ * Resolves 'ctx->name' like dns_resolve, without blocking.
+ *
+ * The query is run by the DNS resolver thread, then 'cb' is called from
+ * it. Cached names are answered by calling 'cb' before returning. 'ctx'
+ * and all the memory it points to must be kept until 'cb' is called.
+ *
+ * @param ctx DNS Client structure
+ * @param cb Callback called with the status of the resolution
+ * @param user_data User data passed to 'cb'
+ * @retval 0 on success, 'cb' will be called.
+ * @retval -EINVAL if an invalid parameter was passed.
+ */
+int dns_resolve_async(struct dns_context *ctx, dns_resolve_cb_t cb,
+		      void *user_data);
+#endif
+
 /**
  * @}
  */
@@ -25,6 +25,7 @@
 #define NET_ETH_PTYPE_ARP		0x0806
 #define NET_ETH_PTYPE_IP		0x0800
 #define NET_ETH_PTYPE_IPV6		0x86dd
+#define NET_ETH_PTYPE_VLAN		0x8100
 
 #define NET_ETH_MINIMAL_FRAME_SIZE	60
 
@@ -38,6 +39,20 @@ struct net_eth_hdr {
 	uint16_t type;
 } __packed;
 
+/* IEEE 802.1Q tag control information: priority (PCP), drop eligible
+ * indicator and VLAN ID
+ */
+#define NET_ETH_VLAN_PCP_SHIFT		13
+#define NET_ETH_VLAN_VID_MASK		0x0fff
+
+struct net_eth_vlan_hdr {
+	struct net_eth_addr dst;
+	struct net_eth_addr src;
+	uint16_t tpid;	/* NET_ETH_PTYPE_VLAN */
+	uint16_t tci;
+	uint16_t type;
+} __packed;
+
 static inline bool net_eth_is_addr_broadcast(struct net_eth_addr *addr)
 {
 	if (addr->addr[0] == 0xff &&
@@ -64,4 +79,25 @@ static inline bool net_eth_is_addr_multicast(struct net_eth_addr *addr)
 
 const struct net_eth_addr *net_eth_broadcast_addr(void);
 
+struct net_if;
+
+typedef void (*net_eth_mcast_cb_t)(struct net_if *iface,
+				   const struct net_eth_addr *addr,
+				   void *user_data);
+
+/**
+ * @brief Go through the multicast MAC addresses of an interface
+ *
+ * @details These are the addresses of the multicast groups the interface
+ * is in, including the IPv6 all-nodes group and the solicited-node groups
+ * of its addresses. The drivers program their multicast filters with
+ * them. A MAC address can be given more than once.
+ *
+ * @param iface Network interface
+ * @param cb Called for each address
+ * @param user_data Passed to @a cb
+ */
+void net_eth_mcast_foreach(struct net_if *iface, net_eth_mcast_cb_t cb,
+			   void *user_data);
+
 #endif /* __ETHERNET_H */
@@ -14,10 +14,52 @@
 
 #include <net/net_mgmt.h>
 
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+#include <crypto/cipher.h>
+#endif
+
 #define IEEE802154_MAX_ADDR_LENGTH	8
+#define IEEE802154_SECURITY_KEY_LENGTH	16
+
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+/* Key of the key table, and its crypto sessions */
+struct ieee802154_security_key_entry {
+	struct cipher_ctx enc;
+	struct cipher_ctx dec;
+	uint8_t key[IEEE802154_SECURITY_KEY_LENGTH];
+	uint8_t index;
+	uint8_t in_use		: 1;
+	uint8_t ready		: 1;
+	uint8_t _unused		: 6;
+};
+
+/* Next frame counter expected from a device, for a given key */
+struct ieee802154_security_device {
+	uint32_t frame_counter;
+	uint8_t ext_addr[IEEE802154_MAX_ADDR_LENGTH];
+	uint8_t key_index;
+	uint8_t in_use;
+};
+
+struct ieee802154_security_ctx {
+	struct ieee802154_security_key_entry
+		keys[CONFIG_NET_L2_IEEE802154_SECURITY_KEYS];
+	struct ieee802154_security_device
+		devices[CONFIG_NET_L2_IEEE802154_SECURITY_DEVICES];
+	uint32_t frame_counter;
+	uint8_t level;
+	/* Key used to secure the frames sent */
+	uint8_t key_index;
+	/* Device entry replaced when a new device is seen */
+	uint8_t next_device;
+};
+#endif /* CONFIG_NET_L2_IEEE802154_SECURITY */
 
 /* This not meant to be used by any code but 802.15.4 L2 stack */
 struct ieee802154_context {
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+	struct ieee802154_security_ctx sec_ctx;
+#endif
 	uint16_t pan_id;
 	uint16_t channel;
 	struct k_sem ack_lock;
@@ -68,6 +110,8 @@ enum net_request_ieee802154_cmd {
 	NET_REQUEST_IEEE802154_CMD_GET_EXT_ADDR,
 	NET_REQUEST_IEEE802154_CMD_SET_SHORT_ADDR,
 	NET_REQUEST_IEEE802154_CMD_GET_SHORT_ADDR,
+	NET_REQUEST_IEEE802154_CMD_SET_SECURITY_KEY,
+	NET_REQUEST_IEEE802154_CMD_SET_SECURITY_LEVEL,
 };
 
 
@@ -146,6 +190,16 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_IEEE802154_SET_SHORT_ADDR);
 
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_IEEE802154_GET_SHORT_ADDR);
 
+#define NET_REQUEST_IEEE802154_SET_SECURITY_KEY				\
+	(_NET_IEEE802154_BASE | NET_REQUEST_IEEE802154_CMD_SET_SECURITY_KEY)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_IEEE802154_SET_SECURITY_KEY);
+
+#define NET_REQUEST_IEEE802154_SET_SECURITY_LEVEL			\
+	(_NET_IEEE802154_BASE | NET_REQUEST_IEEE802154_CMD_SET_SECURITY_LEVEL)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_IEEE802154_SET_SECURITY_LEVEL);
+
 enum net_event_ieee802154_cmd {
 	NET_EVENT_IEEE802154_CMD_SCAN_RESULT = 1,
 };
@@ -193,4 +247,35 @@ struct ieee802154_req_params {
 	uint8_t lqi;
 } __packed;
 
+/**
+ * @brief Security levels, see Section 7.4.1.1
+ *
+ * Given to NET_REQUEST_IEEE802154_SET_SECURITY_LEVEL as an uint8_t. The
+ * frames sent are secured at this level, and only the frames received
+ * at this level are accepted. Encryption without MIC is not supported.
+ */
+enum ieee802154_security_level {
+	IEEE802154_SECURITY_LEVEL_NONE		= 0x0,
+	IEEE802154_SECURITY_LEVEL_MIC_32	= 0x1,
+	IEEE802154_SECURITY_LEVEL_MIC_64	= 0x2,
+	IEEE802154_SECURITY_LEVEL_MIC_128	= 0x3,
+	IEEE802154_SECURITY_LEVEL_ENC		= 0x4,
+	IEEE802154_SECURITY_LEVEL_ENC_MIC_32	= 0x5,
+	IEEE802154_SECURITY_LEVEL_ENC_MIC_64	= 0x6,
+	IEEE802154_SECURITY_LEVEL_ENC_MIC_128	= 0x7,
+};
+
+/**
+ * @brief Security key
+ *
+ * Used to add or replace a key of the key table. The key becomes the one
+ * used to secure the frames sent, identified by its index.
+ */
+struct ieee802154_security_key {
+	/** AES-128 key */
+	uint8_t key[IEEE802154_SECURITY_KEY_LENGTH];
+	/** Key index, sent in the auxiliary security header */
+	uint8_t key_index;
+} __packed;
+
 #endif /* __IEEE802154_H__ */
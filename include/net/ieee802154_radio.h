@@ -15,6 +15,18 @@
 #include <device.h>
 #include <net/net_if.h>
 
+/**
+ * @brief What the radio hardware handles on its own
+ */
+enum ieee802154_hw_caps {
+	/** ACK frames are sent back on reception */
+	IEEE802154_HW_AUTO_ACK	= BIT(0),
+	/** Channel is assessed, and busy channel reported, by tx */
+	IEEE802154_HW_CSMA	= BIT(1),
+	/** ACK is awaited by tx, which fails if none is received */
+	IEEE802154_HW_TX_RX_ACK	= BIT(2),
+};
+
 struct ieee802154_radio_api {
 	/**
 	 * Mandatory to get in first position.
@@ -55,6 +67,9 @@ struct ieee802154_radio_api {
 
 	/** Get latest Link Quality Information */
 	uint8_t (*get_lqi)(struct device *dev);
+
+	/** Get the hardware capabilities, none if not provided */
+	enum ieee802154_hw_caps (*get_capabilities)(struct device *dev);
 } __packed;
 
 /**
@@ -9,6 +9,7 @@
 
 #include <net/mqtt_types.h>
 #include <net/net_context.h>
+#include <misc/slist.h>
 
 /**
  * @brief MQTT library
@@ -30,6 +31,18 @@ enum mqtt_app {
 	MQTT_APP_SERVER
 };
 
+/**
+ * QoS 1 or 2 message waiting for its acknowledgment, for internal use only
+ */
+struct mqtt_inflight {
+	/** Copy of the sent message, to send again */
+	struct mqtt_publish_msg msg;
+	/** Time to send again, in ms */
+	uint32_t deadline;
+	/** MQTT_PUBLISH or MQTT_PUBREL, or MQTT_INVALID if the slot is free */
+	uint8_t state;
+};
+
 /**
  * MQTT context structure
  *
@@ -147,9 +160,28 @@ struct mqtt_ctx {
 	 */
 	void (*malformed)(struct mqtt_ctx *ctx, uint16_t pkt_type);
 
+	/** Callback executed when the payload of a message sent by
+	 * mqtt_tx_publish is released by the IP stack. This callback may be
+	 * NULL, then the payload is copied into the network buffers.
+	 * Otherwise it is sent without any copy, so it must not be modified
+	 * until this callback is called. It may be called from an ISR.
+	 *
+	 * @param [in] ctx	MQTT context
+	 * @param [in] payload	The 'msg' field of the published message
+	 */
+	void (*publish_sent)(struct mqtt_ctx *ctx, const uint8_t *payload);
+
 	/* Internal use only */
 	int (*rcv)(struct mqtt_ctx *ctx, struct net_buf *);
 
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+	/* In-flight window and node in the retransmission list, internal
+	 * use only
+	 */
+	struct mqtt_inflight inflight[CONFIG_MQTT_INFLIGHT_WINDOW];
+	sys_snode_t node;
+#endif
+
 	/** Application type, see: enum mqtt_app */
 	uint8_t app_type;
 
@@ -251,6 +283,12 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, uint16_t id);
 /**
  * Sends the MQTT PUBLISH message
  *
+ * @details If CONFIG_MQTT_INFLIGHT_WINDOW is not 0, up to that many QoS 1
+ * and 2 messages can wait for their acknowledgment. They are sent again,
+ * with the DUP flag, every CONFIG_MQTT_RETRANSMIT_TIMEOUT ms until they
+ * are acknowledged, so their topic and payload must be kept until then.
+ * The msg struct itself is copied.
+ *
  * @param [in] ctx MQTT context structure
  * @param [in] msg MQTT PUBLISH msg
  *
@@ -258,6 +296,7 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, uint16_t id);
  * @retval -EINVAL
  * @retval -ENOMEM
  * @retval -EIO
+ * @retval -EAGAIN if the in-flight window is full
  */
 int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg);
 
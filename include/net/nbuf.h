@@ -49,6 +49,10 @@ struct net_nbuf {
 	uint8_t *appdata;	/* application data starts here */
 	uint8_t *next_hdr;	/* where is the next header */
 
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+	struct net_if *quota_iface; /* RX buffer counted in its quota */
+#endif
+
 	/* Filled by layer 2 when network packet is received. */
 	struct net_linkaddr lladdr_src;
 	struct net_linkaddr lladdr_dst;
@@ -68,6 +72,11 @@ struct net_nbuf {
 #if defined(CONFIG_NET_TCP)
 	bool buf_sent; /* Is this net_buf sent or not */
 #endif
+#if defined(CONFIG_NET_TCP_SACK)
+	bool sacked; /* Selectively acknowledged by the peer */
+#endif
+	bool chksum_valid; /* Checksums already checked by the hardware */
+	uint8_t priority; /* Traffic class, the IEEE 802.1Q priority (0-7) */
 	/* @endcond */
 };
 
@@ -200,6 +209,39 @@ static inline void net_nbuf_set_buf_sent(struct net_buf *buf, bool sent)
 }
 #endif
 
+#if defined(CONFIG_NET_TCP_SACK)
+static inline bool net_nbuf_sacked(struct net_buf *buf)
+{
+	return ((struct net_nbuf *)net_buf_user_data(buf))->sacked;
+}
+
+static inline void net_nbuf_set_sacked(struct net_buf *buf, bool sacked)
+{
+	((struct net_nbuf *)net_buf_user_data(buf))->sacked = sacked;
+}
+#endif
+
+static inline bool net_nbuf_chksum_valid(struct net_buf *buf)
+{
+	return ((struct net_nbuf *)net_buf_user_data(buf))->chksum_valid;
+}
+
+static inline void net_nbuf_set_chksum_valid(struct net_buf *buf, bool valid)
+{
+	((struct net_nbuf *)net_buf_user_data(buf))->chksum_valid = valid;
+}
+
+static inline uint8_t net_nbuf_priority(struct net_buf *buf)
+{
+	return ((struct net_nbuf *)net_buf_user_data(buf))->priority;
+}
+
+static inline void net_nbuf_set_priority(struct net_buf *buf,
+					 uint8_t priority)
+{
+	((struct net_nbuf *)net_buf_user_data(buf))->priority = priority;
+}
+
 static inline uint16_t net_nbuf_get_len(struct net_buf *buf)
 {
 	return buf->len;
@@ -509,6 +551,44 @@ struct net_buf *net_nbuf_ref(struct net_buf *buf);
 
 #endif /* CONFIG_NET_DEBUG_NET_BUF */
 
+/**
+ * @typedef net_nbuf_ext_cb_t
+ * @brief Callback called when an external data fragment is released.
+ *
+ * @details It can be called from an ISR, when a driver releases the
+ * buffer after its transmission, so it must not block.
+ *
+ * @param data Start of the external data.
+ * @param user_data User data given to net_nbuf_get_ext_data().
+ */
+typedef void (*net_nbuf_ext_cb_t)(const void *data, void *user_data);
+
+/**
+ * @brief Get a data fragment referring to external data.
+ *
+ * @details The fragment points at the data instead of holding a copy of it,
+ * so a large payload can go from application or flash memory up to the
+ * driver without being copied. Add it to a TX buffer with
+ * net_buf_frag_add(), after any data appended with net_nbuf_append(),
+ * then send it with net_context_send(). The stack never writes to the
+ * data, which must stay valid until the callback is called: for TCP, it
+ * is only called once the data is acknowledged.
+ *
+ * @param data Data the fragment refers to.
+ * @param len Length of the data.
+ * @param cb Callback called when the fragment is released, can be NULL.
+ * @param user_data User data passed to the callback.
+ * @param timeout Affects the action taken should the net buf pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait up to the specified
+ *        number of milliseconds before timing out.
+ *
+ * @return Network buffer fragment if successful, NULL otherwise.
+ */
+struct net_buf *net_nbuf_get_ext_data(const void *data, uint16_t len,
+				      net_nbuf_ext_cb_t cb, void *user_data,
+				      int32_t timeout);
+
 /**
  * @brief Copy a buffer with fragments while reserving some extra space
  * in destination buffer before a copy.
@@ -583,6 +663,21 @@ int net_nbuf_linear_copy(struct net_buf *dst, struct net_buf *src,
  */
 bool net_nbuf_compact(struct net_buf *buf);
 
+/**
+ * @brief Merge small fragments into the free space of the previous ones.
+ *
+ * @details Unlike net_nbuf_compact(), only whole fragments are copied, and
+ * no more than a given number of bytes in total, so that the cost stays
+ * bounded. Empty fragments are released without copying anything.
+ * External data fragments are left where they are.
+ *
+ * @param buf Network buffer. This should be the Tx/Rx buffer.
+ * @param budget How many bytes can be copied at most.
+ *
+ * @return Number of fragments released.
+ */
+int net_nbuf_coalesce(struct net_buf *buf, size_t budget);
+
 /**
  * @brief Check if the buffer chain is compact or not.
  *
@@ -793,6 +888,145 @@ struct net_buf *net_nbuf_read_be16(struct net_buf *buf, uint16_t offset,
 struct net_buf *net_nbuf_read_be32(struct net_buf *buf, uint16_t offset,
 				   uint16_t *pos, uint32_t *value);
 
+/**
+ * @brief Position in the data of a series of fragments.
+ *
+ * @details A cursor keeps the fragment it is in, and only ever moves
+ * forward, so that parsing a message walks its fragments once. It is at
+ * the end of the data once its fragment is NULL. Empty fragments are
+ * skipped over.
+ */
+struct net_nbuf_cursor {
+	/** Fragment the cursor is in, NULL at the end of the data */
+	struct net_buf *frag;
+
+	/** Offset of the cursor in the fragment */
+	uint16_t pos;
+};
+
+/**
+ * @brief Place a cursor in a series of fragments.
+ *
+ * @param cursor Cursor to initialize.
+ * @param frag Network buffer fragment.
+ * @param offset Offset of the cursor, from the start of the fragment.
+ *
+ * @return True if the offset is within the data of the fragments, or
+ *         right at its end, false otherwise.
+ */
+bool net_nbuf_cursor_init(struct net_nbuf_cursor *cursor,
+			  struct net_buf *frag, uint16_t offset);
+
+/**
+ * @brief Get the data at a cursor, up to the end of its fragment.
+ *
+ * @details This data can be parsed in place. The cursor does not move:
+ * use net_nbuf_cursor_skip() to move it past what was used.
+ *
+ * @param cursor Cursor to get the data of.
+ * @param len Length of the contiguous data. Value is returned.
+ *
+ * @return Pointer to the data, NULL at the end of the data.
+ */
+static inline uint8_t *net_nbuf_cursor_data(struct net_nbuf_cursor *cursor,
+					    uint16_t *len)
+{
+	if (!cursor->frag) {
+		*len = 0;
+		return NULL;
+	}
+
+	*len = cursor->frag->len - cursor->pos;
+
+	return cursor->frag->data + cursor->pos;
+}
+
+/**
+ * @brief Read data at a cursor, and move it past that data.
+ *
+ * @details The data is copied one contiguous part at a time.
+ *
+ * @param cursor Cursor to read at.
+ * @param data Data will be copied here, NULL to skip it.
+ * @param len Length of the data to read.
+ *
+ * @return True if ok, false if there was not enough data. The cursor is
+ *         then at the end of the data.
+ */
+bool net_nbuf_cursor_read(struct net_nbuf_cursor *cursor, void *data,
+			  uint16_t len);
+
+/**
+ * @brief Move a cursor past some data.
+ *
+ * @param cursor Cursor to move.
+ * @param len Length of the data to skip.
+ *
+ * @return True if ok, false if there was not enough data.
+ */
+static inline bool net_nbuf_cursor_skip(struct net_nbuf_cursor *cursor,
+					uint16_t len)
+{
+	return net_nbuf_cursor_read(cursor, NULL, len);
+}
+
+/**
+ * @brief Get a pointer to some data at a cursor, and move it past that
+ * data.
+ *
+ * @details This is meant for headers and other structures: these are
+ * parsed in place when they are contiguous in a fragment, as they are
+ * most of the time, and only copied when they span several fragments.
+ *
+ * @param cursor Cursor to read at.
+ * @param len Length of the data.
+ * @param buf Where the data is copied to if it is not contiguous, of at
+ *        least len bytes.
+ *
+ * @return Pointer to the data, either in the fragment or buf, NULL if
+ *         there was not enough data.
+ */
+void *net_nbuf_cursor_pull(struct net_nbuf_cursor *cursor, uint16_t len,
+			   void *buf);
+
+/**
+ * @brief Read a byte at a cursor, and move it past that byte.
+ *
+ * @param cursor Cursor to read at.
+ * @param value Value is returned.
+ *
+ * @return True if ok, false if at the end of the data.
+ */
+static inline bool net_nbuf_cursor_read_u8(struct net_nbuf_cursor *cursor,
+					   uint8_t *value)
+{
+	return net_nbuf_cursor_read(cursor, value, sizeof(uint8_t));
+}
+
+/**
+ * @brief Read a 16 bit big endian value at a cursor, and move it past
+ * that value.
+ *
+ * @param cursor Cursor to read at.
+ * @param value Value is returned.
+ *
+ * @return True if ok, false if there was not enough data.
+ */
+bool net_nbuf_cursor_read_be16(struct net_nbuf_cursor *cursor,
+			       uint16_t *value);
+
+/**
+ * @brief Read a 32 bit big endian value at a cursor, and move it past
+ * that value.
+ *
+ * @param cursor Cursor to read at.
+ * @param value Value is returned.
+ *
+ * @return True if ok, false if there was not enough data.
+ */
+bool net_nbuf_cursor_read_be32(struct net_nbuf_cursor *cursor,
+			       uint32_t *value);
+
 /**
  * @brief Write data to an arbitrary offset in a series of fragments.
  *
@@ -963,8 +1197,7 @@ static inline bool net_nbuf_insert_be32(struct net_buf *buf,
 
 /**
  * @brief Get information about available free buffer count in
- * various network buffer pools. The amount of free buffers is
- * only returned if network buffer debugging is enabled.
+ * various network buffer pools.
  *
  * @param tx_size Size of TX pool. Value is returned.
  * @param rx_size Size of RX pool. Value is returned.
@@ -976,6 +1209,38 @@ static inline bool net_nbuf_insert_be32(struct net_buf *buf,
 void net_nbuf_get_info(size_t *tx_size, size_t *rx_size, size_t *data_size,
 		       int *tx, int *rx, int *data);
 
+/**
+ * @brief Get information about available free buffer count in a
+ * buffer pool, such as the pools of a network context.
+ *
+ * @param pool Buffer pool.
+ * @param count Amount of buffers in the pool. Value is returned.
+ * @param avail Amount of free buffers in the pool. Value is returned.
+ */
+void net_nbuf_get_pool_info(struct net_buf_pool *pool, int *count,
+			    int *avail);
+
+/**
+ * @brief Define a pool of TX buffers, to be given to a network context
+ * with net_context_setup_pools().
+ *
+ * @param name Name of the pool variable.
+ * @param count Number of buffers in the pool.
+ */
+#define NET_NBUF_TX_POOL_DEFINE(name, count)				\
+	NET_BUF_POOL_DEFINE(name, count, 0, sizeof(struct net_nbuf), NULL)
+
+/**
+ * @brief Define a pool of data fragments, to be given to a network
+ * context with net_context_setup_pools().
+ *
+ * @param name Name of the pool variable.
+ * @param count Number of fragments in the pool.
+ */
+#define NET_NBUF_DATA_POOL_DEFINE(name, count)				\
+	NET_BUF_POOL_DEFINE(name, count, CONFIG_NET_NBUF_DATA_SIZE,	\
+			    CONFIG_NET_NBUF_USER_DATA_SIZE, NULL)
+
 #if defined(CONFIG_NET_DEBUG_NET_BUF)
 /**
  * @brief Debug helper to print out the buffer allocations
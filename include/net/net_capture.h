@@ -0,0 +1,91 @@
+/** @file
+ * @brief Network packet capture
+ *
+ * The start of the packets received and sent by the interfaces is copied
+ * into a ring, and streamed out in the pcapng format.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __NET_CAPTURE_H
+#define __NET_CAPTURE_H
+
+#include <net/net_ip.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Network packet capture
+ * @defgroup net_capture Network packet capture
+ * @{
+ */
+
+/** Capture the packets received by the interfaces */
+#define NET_CAPTURE_RX BIT(0)
+
+/** Capture the packets sent by the interfaces */
+#define NET_CAPTURE_TX BIT(1)
+
+struct net_if;
+
+/** Which packets are captured, a zero field matching any packet */
+struct net_capture_filter {
+	/** Network interface */
+	struct net_if *iface;
+
+	/** Port of UDP or TCP packets, source or destination */
+	uint16_t port;
+
+	/** AF_INET6 or AF_INET */
+	sa_family_t family;
+
+	/** IP protocol, as given by the IP header */
+	uint8_t proto;
+
+	/** NET_CAPTURE_RX and/or NET_CAPTURE_TX, 0 being both */
+	uint8_t dir;
+};
+
+/**
+ * @brief Start capturing packets
+ *
+ * @details The stream restarts with a new pcapng section, and the packets
+ * of a capture already running are not captured anymore.
+ *
+ * @param filter Packets to capture, NULL for all of them
+ */
+void net_capture_start(const struct net_capture_filter *filter);
+
+/**
+ * @brief Stop capturing packets
+ *
+ * @details The packets already captured are still streamed out.
+ */
+void net_capture_stop(void);
+
+/**
+ * @brief Get the state of the capture
+ *
+ * @param filter Filled with the filter of the capture, or NULL
+ * @param lost Filled with the number of captured packets overwritten
+ * before they could be streamed out, or NULL
+ *
+ * @return True if packets are being captured, false otherwise.
+ */
+bool net_capture_get(struct net_capture_filter *filter, uint32_t *lost);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NET_CAPTURE_H */
@@ -191,12 +191,41 @@ struct net_context {
 	struct k_sem recv_data_wait;
 #endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
 
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+	/** User data of the receive callback, for an offloaded IP stack */
+	void *recv_user_data;
+
+	/** Private data of the driver of an offloaded IP stack */
+	void *offload_context;
+#endif /* CONFIG_NET_L2_OFFLOAD_IP */
+
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+	/** TX buffer pool of this context, NULL for the global one */
+	struct net_buf_pool *tx_pool;
+
+	/** Data fragment pool of this context, NULL for the global one */
+	struct net_buf_pool *data_pool;
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
+#if defined(CONFIG_NET_CONTEXT_HDR_CACHE)
+	/** IP and UDP headers of the packets sent to the connected peer */
+	struct {
+		uint8_t data[NET_IPV6UDPH_LEN];
+		uint8_t len;
+		uint8_t ip_hdr_len;
+		uint32_t gen;
+	} hdr_cache;
+#endif /* CONFIG_NET_CONTEXT_HDR_CACHE */
+
 	/** Network interface assigned to this context */
 	uint8_t iface;
 
 	/** Flags for the context */
 	uint8_t flags;
 
+	/** Traffic class of the packets sent, see net_context_set_priority */
+	uint8_t priority;
+
 #if defined(CONFIG_NET_TCP)
 	/** TCP connection information */
 	struct net_tcp *tcp;
@@ -500,7 +529,9 @@ int net_context_bind(struct net_context *context,
  * @details This is similar as BSD listen() function.
  *
  * @param context The context to use.
- * @param backlog The size of the pending connections backlog.
+ * @param backlog The size of the pending connections backlog: the number
+ * of TCP connections being established at once, at least 1 and at most
+ * CONFIG_NET_TCP_SYN_CACHE_SIZE.
  *
  * @return 0 if ok, < 0 if error
  */
@@ -586,6 +617,11 @@ int net_context_accept(struct net_context *context,
  * called if the timeout expires. For context of type SOCK_DGRAM,
  * the destination address must have been set by the call to
  * net_context_connect().
+ * The data can also be sent without copying it into the buffer, by
+ * adding fragments from net_nbuf_get_ext_data().
+ * For TCP, small writes can be appended to the previous one still waiting
+ * to be sent, which then goes out as a single segment, see
+ * net_context_set_nodelay().
  * This is similar as BSD send() function.
  *
  * @param buf The network buffer to send.
@@ -638,6 +674,36 @@ int net_context_sendto(struct net_buf *buf,
 		       void *token,
 		       void *user_data);
 
+/**
+ * @brief Send several network buffers to the same peer.
+ *
+ * @details This is similar to calling net_context_sendto() for each of
+ * the buffers, which must all belong to the same UDP context. The
+ * destination is checked and the source address selected once, and the
+ * route and neighbor of the first datagram are reused for the others.
+ * The token of each buffer, set with net_nbuf_set_token(), is passed to
+ * the callback. This is similar to the BSD sendmmsg() function.
+ *
+ * @param bufs The network buffers to send.
+ * @param count Number of buffers in @a bufs.
+ * @param dst_addr Destination address.
+ * @param addrlen Length of the address.
+ * @param cb Caller supplied callback function.
+ * @param timeout Timeout for the connection. Possible values
+ * are K_FOREVER, K_NO_WAIT, >0.
+ * @param user_data Caller supplied user data.
+ *
+ * @return Number of buffers sent, from the start of @a bufs, the others
+ * are still owned by the caller. < 0 if error, and none was sent.
+ */
+int net_context_sendto_batch(struct net_buf **bufs,
+			     int count,
+			     const struct sockaddr *dst_addr,
+			     socklen_t addrlen,
+			     net_context_send_cb_t cb,
+			     int32_t timeout,
+			     void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
@@ -665,6 +731,8 @@ int net_context_sendto(struct net_buf *buf,
  * updates connection information from context. If recv() is called before
  * bind() call, it may refuse to bind to a context which already has
  * a connection associated.
+ * For TCP, the data received before the callback is registered is queued,
+ * up to CONFIG_NET_TCP_RECV_WND bytes, and passed to it at once.
  *
  * @param context The network context to use.
  * @param cb Caller supplied callback function.
@@ -679,6 +747,76 @@ int net_context_recv(struct net_context *context,
 		     int32_t timeout,
 		     void *user_data);
 
+/**
+ * @brief Update the TCP receive window of a context.
+ *
+ * @details Received data is considered consumed once the receive callback
+ * returns. A callback keeping the buffers to process them later can shrink
+ * the window by their size, and grow it back once they are consumed, so
+ * that the peer does not send more than the application can take.
+ *
+ * @param context The network context to use.
+ * @param delta Bytes by which to grow the window, negative to shrink it.
+ *
+ * @return 0 if ok, < 0 if error
+ */
+int net_context_update_recv_wnd(struct net_context *context,
+				int32_t delta);
+
+/**
+ * @brief Disable or enable the coalescing of small TCP writes.
+ *
+ * @details While sent data is not acknowledged, a segment smaller than
+ * the maximum segment size is held back until more data is written, as
+ * the Nagle algorithm goes. Interactive applications sending small
+ * requests can send them at once instead. This is similar as the
+ * TCP_NODELAY socket option.
+ *
+ * @param context The network context to use.
+ * @param nodelay True to send small segments at once.
+ *
+ * @return 0 if ok, < 0 if error
+ */
+int net_context_set_nodelay(struct net_context *context, bool nodelay);
+
+/**
+ * @brief Set the traffic class of the packets sent by a context.
+ *
+ * @details The packets of a higher class are queued ahead of the others
+ * on their interface, see CONFIG_NET_TX_QUEUES, and carry it as the
+ * priority of their IEEE 802.1Q tag on Ethernet. The classes go from 0,
+ * the default, to 7, as the 802.1Q priorities. This is similar as the
+ * SO_PRIORITY socket option.
+ *
+ * @param context The network context to use.
+ * @param priority Traffic class, 0 to 7.
+ *
+ * @return 0 if ok, < 0 if error
+ */
+int net_context_set_priority(struct net_context *context, uint8_t priority);
+
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+/**
+ * @brief Give a context its own buffer pools.
+ *
+ * @details The buffers sent by the context, and the data fragments
+ * appended to them, are then allocated from these pools instead of from
+ * the global ones, see NET_NBUF_TX_POOL_DEFINE() and
+ * NET_NBUF_DATA_POOL_DEFINE(). This reserves buffers for the context, and
+ * bounds how many of them it can use. The pools are used until the
+ * context is released.
+ *
+ * @param context The network context to use.
+ * @param tx_pool TX buffer pool, NULL for the global one.
+ * @param data_pool Data fragment pool, NULL for the global one.
+ */
+void net_context_setup_pools(struct net_context *context,
+			     struct net_buf_pool *tx_pool,
+			     struct net_buf_pool *data_pool);
+#else
+#define net_context_setup_pools(context, tx_pool, data_pool)
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
 /**
  * @typedef net_context_cb_t
  * @brief Callback used while iterating over network contexts
@@ -195,14 +195,39 @@ struct net_if {
 	 */
 	bool offload_ip;
 
-	/** Queue for outgoing packets from apps */
-	struct k_fifo tx_queue;
+	/** Queues for outgoing packets from apps, by priority */
+#if defined(CONFIG_NET_TX_QUEUES)
+#define NET_TX_QUEUES CONFIG_NET_TX_QUEUES
+#else
+#define NET_TX_QUEUES 1
+#endif
+	struct k_fifo tx_queue[NET_TX_QUEUES];
 
-	/** Stack for the TX thread tied to this interface */
+	/** Stacks for the TX threads tied to this interface, one per queue */
 #ifndef CONFIG_NET_TX_STACK_SIZE
 #define CONFIG_NET_TX_STACK_SIZE 1024
 #endif
-	NET_STACK_DEFINE_EMBEDDED(tx_stack, CONFIG_NET_TX_STACK_SIZE);
+	NET_STACK_DEFINE_EMBEDDED(tx_stack[NET_TX_QUEUES],
+				  CONFIG_NET_TX_STACK_SIZE);
+
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+	/** Number of RX buffers held by the packets received on this
+	 * interface, up to CONFIG_NET_NBUF_RX_IFACE_QUOTA
+	 */
+	atomic_t rx_bufs;
+#endif
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	/** Traffic counters, read with net_stats_if_get() */
+	struct {
+		atomic_t rx_pkts;
+		atomic_t rx_bytes;
+		atomic_t rx_drop;
+		atomic_t tx_pkts;
+		atomic_t tx_bytes;
+		atomic_t tx_drop;
+	} stats;
+#endif
 
 #if defined(CONFIG_NET_IPV6)
 #define NET_IF_MAX_IPV6_ADDR CONFIG_NET_IF_UNICAST_IPV6_ADDR_COUNT
@@ -217,6 +242,11 @@ struct net_if {
 
 		/** Prefixes */
 		struct net_if_ipv6_prefix prefix[NET_IF_MAX_IPV6_PREFIX];
+
+		/** A bit for the hash of each multicast address, so that
+		 * the lookups skip quickly the interfaces not in a group.
+		 */
+		uint32_t mcast_hash;
 	} ipv6;
 
 	/** IPv6 hop limit */
@@ -363,13 +393,13 @@ static inline struct device *net_if_get_device(struct net_if *iface)
 /**
  * @brief Queue a packet into net if's TX queue
  *
+ * @details The packet goes to the queue of its priority, the traffic
+ * classes being split evenly between the queues.
+ *
  * @param iface Pointer to a network interface structure
  * @param buf Pointer on a net buffer to queue
  */
-static inline void net_if_queue_tx(struct net_if *iface, struct net_buf *buf)
-{
-	net_buf_put(&iface->tx_queue, buf);
-}
+void net_if_queue_tx(struct net_if *iface, struct net_buf *buf);
 
 /**
  * @brief Return the IP offload status.
@@ -1126,11 +1156,73 @@ int net_if_up(struct net_if *iface);
  */
 int net_if_down(struct net_if *iface);
 
+/** Network interface hardware capabilities */
+enum net_if_caps {
+	/** IPv4 header, UDP and TCP checksums are inserted on TX. The
+	 * stack leaves them zeroed.
+	 */
+	NET_IF_CAP_TX_CHKSUM	= BIT(0),
+
+	/** IPv4 header, UDP and TCP checksums can be checked on RX, the
+	 * driver marks the buffers where they were, see
+	 * net_nbuf_set_chksum_valid().
+	 */
+	NET_IF_CAP_RX_CHKSUM	= BIT(1),
+};
+
 struct net_if_api {
 	void (*init)(struct net_if *iface);
 	int (*send)(struct net_if *iface, struct net_buf *buf);
+
+	/** Get the enum net_if_caps supported by the device, optional */
+	enum net_if_caps (*get_capabilities)(struct net_if *iface);
+
+	/** Send several packets at once, optional. Returns how many of
+	 * them were sent, starting from the first one, the others being
+	 * then given to send() one by one.
+	 */
+	int (*send_bulk)(struct net_if *iface, struct net_buf **bufs,
+			 int count);
+
+	/** Program the multicast filter of the device, optional. This is
+	 * called when the interface joins or leaves a group, and the
+	 * filter is expected to be set from the whole list again, see
+	 * net_eth_mcast_foreach().
+	 */
+	void (*mcast_filter)(struct net_if *iface);
 };
 
+/**
+ * @brief Get the hardware capabilities of an interface
+ *
+ * @param iface Pointer to network interface
+ *
+ * @return Capabilities, as a set of enum net_if_caps
+ */
+static inline enum net_if_caps net_if_get_capabilities(struct net_if *iface)
+{
+	const struct net_if_api *api = iface->dev->driver_api;
+
+	if (!api->get_capabilities) {
+		return 0;
+	}
+
+	return api->get_capabilities(iface);
+}
+
+/**
+ * @brief Check if the checksums of a packet to send are left to the
+ * interface
+ *
+ * @param iface Pointer to network interface, can be NULL
+ *
+ * @return True if the interface inserts the checksums
+ */
+static inline bool net_if_tx_chksum_offloaded(struct net_if *iface)
+{
+	return iface && (net_if_get_capabilities(iface) & NET_IF_CAP_TX_CHKSUM);
+}
+
 #define NET_IF_GET_NAME(dev_name, sfx) (__net_if_##dev_name##_##sfx)
 #define NET_IF_GET(dev_name, sfx)					\
 	((struct net_if *)&NET_IF_GET_NAME(dev_name, sfx))
@@ -1147,7 +1239,7 @@ struct net_if_api {
 			    dev_name,					\
 			    CONFIG_NET_TX_STACK_SIZE,			\
 			    CONFIG_NET_TX_STACK_SIZE,			\
-			    NET_IF_GET(dev_name, sfx)->tx_stack,	\
+			    NET_IF_GET(dev_name, sfx)->tx_stack[0],	\
 			    sfx)
 
 
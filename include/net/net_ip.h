@@ -231,6 +231,8 @@ enum net_addr_state {
 	NET_ADDR_TENTATIVE = 0,
 	NET_ADDR_PREFERRED,
 	NET_ADDR_DEPRECATED,
+	/** Tentative, but usable while DAD runs, RFC 4429 */
+	NET_ADDR_OPTIMISTIC,
 };
 
 struct net_ipv6_hdr {
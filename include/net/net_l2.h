@@ -90,6 +90,7 @@ NET_L2_DECLARE_PUBLIC(IEEE802154_L2);
 #ifdef CONFIG_NET_L2_OFFLOAD_IP
 #define OFFLOAD_IP_L2		OFFLOAD_IP
 #define OFFLOAD_IP_L2_CTX_TYPE	void*
+NET_L2_DECLARE_PUBLIC(OFFLOAD_IP_L2);
 #endif /* CONFIG_NET_L2_OFFLOAD_IP */
 
 extern struct net_l2 __net_l2_end[];
@@ -103,6 +104,23 @@ extern struct net_l2 __net_l2_end[];
 		.enable = (_enable_fn),					\
 	}
 
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+/* The L2 of a device running the IP stack itself, as used by the driver
+ * of the device. Its recv and send functions only see the packets that
+ * the core builds outside of the network contexts, which can be dropped.
+ */
+#define NET_L2_OFFLOAD_IP_INIT(_name, _recv_fn, _send_fn, _reserve_fn,	\
+			       _enable_fn, _offload_ip)			\
+	const struct net_l2 (NET_L2_GET_NAME(_name)) __used		\
+	__attribute__((__section__(".net_l2.init"))) = {		\
+		.recv = (_recv_fn),					\
+		.send = (_send_fn),					\
+		.reserve = (_reserve_fn),				\
+		.enable = (_enable_fn),					\
+		.offload_ip = (_offload_ip),				\
+	}
+#endif /* CONFIG_NET_L2_OFFLOAD_IP */
+
 #define NET_L2_GET_DATA(name, sfx) (__net_l2_data_##name##sfx)
 
 #define NET_L2_DATA_INIT(name, sfx, ctx_type)				\
@@ -106,6 +106,15 @@ struct net_stats_tcp {
 
 	/** Number of SYNs for closed ports, triggering a RST. */
 	net_stats_t synrst;
+
+	/** Number of retransmission timeouts. */
+	net_stats_t rto;
+
+	/** Number of fast retransmits, after three duplicate ACKs. */
+	net_stats_t fast_rexmit;
+
+	/** Number of duplicate ACKs received. */
+	net_stats_t dup_ack;
 };
 
 struct net_stats_udp {
@@ -201,6 +210,36 @@ struct net_stats_bytes {
 	uint32_t received;
 };
 
+struct net_stats_frags {
+	/** Number of received packets by the depth of their fragment
+	 * chain: 1, 2, 3 to 4, 5 to 8 and more than 8 fragments.
+	 */
+	net_stats_t depth[5];
+
+	/** Deepest fragment chain received. */
+	net_stats_t max_depth;
+
+	/** Number of fragments released by coalescing. */
+	net_stats_t coalesced;
+};
+
+/** Traffic of a network interface, see net_stats_if_get() */
+struct net_stats_if {
+	/** Packets given by the driver, and their bytes */
+	net_stats_t rx_pkts;
+	net_stats_t rx_bytes;
+
+	/** Received packets dropped by the stack */
+	net_stats_t rx_drop;
+
+	/** Packets taken by the driver, and their bytes */
+	net_stats_t tx_pkts;
+	net_stats_t tx_bytes;
+
+	/** Packets to send dropped by the stack or the driver */
+	net_stats_t tx_drop;
+};
+
 struct net_stats {
 	net_stats_t processing_error;
 
@@ -210,6 +249,9 @@ struct net_stats {
 	 */
 	struct net_stats_bytes bytes;
 
+	/* Depth of the fragment chains of the received packets */
+	struct net_stats_frags frags;
+
 	struct net_stats_ip_errors ip_errors;
 
 #if defined(CONFIG_NET_STATISTICS_IPV6)
@@ -241,6 +283,22 @@ struct net_stats {
 #endif
 };
 
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+struct net_if;
+
+/**
+ * @brief Get a snapshot of the traffic counters of an interface
+ *
+ * @details Each counter is read atomically, but they are not read all
+ * at once, so traffic going on meanwhile can be counted in some of them
+ * only.
+ *
+ * @param iface Network interface
+ * @param stats Filled with the counters
+ */
+void net_stats_if_get(struct net_if *iface, struct net_stats_if *stats);
+#endif /* CONFIG_NET_STATISTICS_PER_INTERFACE */
+
 #if defined(CONFIG_NET_STATISTICS_USER_API)
 /* Management part definitions */
 
@@ -263,6 +321,7 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_UDP,
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_RPL,
+	NET_REQUEST_STATS_CMD_GET_IFACE,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -334,6 +393,16 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TCP);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_RPL);
 #endif /* CONFIG_NET_STATISTICS_RPL */
 
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+/* The counters of the interface given to net_mgmt(), in a
+ * struct net_stats_if
+ */
+#define NET_REQUEST_STATS_GET_IFACE				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_IFACE)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_IFACE);
+#endif /* CONFIG_NET_STATISTICS_PER_INTERFACE */
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 #ifdef __cplusplus
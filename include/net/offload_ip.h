@@ -14,6 +14,8 @@
 
 #if defined(CONFIG_NET_L2_OFFLOAD_IP)
 
+#include <errno.h>
+
 #include <net/buf.h>
 #include <net/net_ip.h>
 #include <net/net_context.h>
@@ -89,7 +91,8 @@ struct net_l2_offload_ip {
 
 	/**
 	 * This function is called when user wants to receive data from peer
-	 * host.
+	 * host. It can be NULL, as the callback is kept by the core, which
+	 * calls it for the data handed with net_l2_offload_ip_recv_data().
 	 */
 	int (*recv)(struct net_context *context,
 		    net_context_recv_cb_t cb,
@@ -100,6 +103,19 @@ struct net_l2_offload_ip {
 	 * This function is called when user wants to close the socket.
 	 */
 	int (*put)(struct net_context *context);
+
+	/**
+	 * This function is called when user wants to resolve a host name.
+	 * It can be NULL, and return -ENOTSUP, in which case the DNS queries
+	 * are sent over the offloaded UDP. It fills @a addrs with up to
+	 * @a max in_addr or in6_addr, depending on @a family, and returns
+	 * how many it got.
+	 */
+	int (*dns_resolve)(const char *name,
+			   sa_family_t family,
+			   void *addrs,
+			   int max,
+			   int32_t timeout);
 };
 
 /**
@@ -401,11 +417,31 @@ static inline int net_l2_offload_ip_recv(struct net_if *iface,
 	NET_ASSERT(iface);
 	NET_ASSERT(iface->l2);
 	NET_ASSERT(iface->l2->offload_ip);
-	NET_ASSERT(iface->l2->offload_ip->recv);
+
+	if (!iface->l2->offload_ip->recv) {
+		return 0;
+	}
 
 	return iface->l2->offload_ip->recv(context, cb, timeout, user_data);
 }
 
+/**
+ * @brief Hand data received by the offloaded IP stack to a context.
+ *
+ * @details This is called by the driver, from a thread, for the data
+ * received on a context. The receive callback of the context is called
+ * with the buffer, and takes its ownership. A NULL buffer tells that the
+ * peer closed the connection, or with a negative status, that it failed.
+ *
+ * @param context The context the data was received on.
+ * @param buf RX buffer from net_nbuf_get_rx(), its fragments holding the
+ * application data only, or NULL.
+ * @param status 0 if ok, < 0 if error
+ */
+void net_l2_offload_ip_recv_data(struct net_context *context,
+				 struct net_buf *buf,
+				 int status);
+
 /**
  * @brief Free/close a network context.
  *
@@ -430,6 +466,39 @@ static inline int net_l2_offload_ip_put(struct net_if *iface,
 	return iface->l2->offload_ip->put(context);
 }
 
+/**
+ * @brief Resolve a host name with the offloaded IP stack.
+ *
+ * @param iface Network interface where the offloaded IP stack can be
+ * reached.
+ * @param name Host name to resolve.
+ * @param family AF_INET or AF_INET6, the family of the addresses.
+ * @param addrs Array of struct in_addr or struct in6_addr to fill.
+ * @param max Number of elements of @a addrs.
+ * @param timeout Timeout in ms, K_FOREVER or K_NO_WAIT.
+ *
+ * @return Number of addresses, -ENOTSUP if the offloaded IP stack
+ * cannot resolve names, < 0 if other error.
+ */
+static inline int net_l2_offload_ip_dns_resolve(struct net_if *iface,
+						const char *name,
+						sa_family_t family,
+						void *addrs,
+						int max,
+						int32_t timeout)
+{
+	NET_ASSERT(iface);
+	NET_ASSERT(iface->l2);
+	NET_ASSERT(iface->l2->offload_ip);
+
+	if (!iface->l2->offload_ip->dns_resolve) {
+		return -ENOTSUP;
+	}
+
+	return iface->l2->offload_ip->dns_resolve(name, family, addrs, max,
+						  timeout);
+}
+
 #ifdef __cplusplus
 }
 #endif
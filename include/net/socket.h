@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include <sys/types.h>
+
+#include <net/net_context.h>
+#include <net/net_ip.h>
+
+/**
+ * @brief BSD sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @{
+ */
+
+/**
+ * Received data is queued for each socket, and read by the application
+ * threads, instead of being handled by net_context callbacks in the RX
+ * thread. The functions return -1 and set errno on error, as their BSD
+ * counterparts do. Each socket is supposed to be read by one thread at a
+ * time.
+ */
+
+/** Do not wait for data, or buffers (see zsock_recv() and zsock_send()) */
+#define ZSOCK_MSG_DONTWAIT 0x40
+
+#define ZSOCK_POLLIN 1
+#define ZSOCK_POLLOUT 4
+#define ZSOCK_POLLERR 8
+#define ZSOCK_POLLHUP 0x10
+#define ZSOCK_POLLNVAL 0x20
+
+#define ZSOCK_SOL_SOCKET 1
+
+/** Receive timeout, an int32_t in milliseconds, K_FOREVER by default */
+#define ZSOCK_SO_RCVTIMEO 20
+
+struct zsock_pollfd {
+	int fd;
+	short events;
+	short revents;
+};
+
+/**
+ * @brief Create a socket
+ *
+ * @param family AF_INET or AF_INET6
+ * @param type SOCK_STREAM or SOCK_DGRAM
+ * @param proto IPPROTO_TCP, IPPROTO_UDP, or 0 for the one of @a type
+ *
+ * @return Socket descriptor, -1 on error.
+ */
+int zsock_socket(int family, int type, int proto);
+
+/**
+ * @brief Close a socket, and free the data it did not read
+ *
+ * @param sock Socket descriptor
+ *
+ * @return 0 if ok, -1 on error.
+ */
+int zsock_close(int sock);
+
+int zsock_bind(int sock, const struct sockaddr *addr, socklen_t addrlen);
+
+/**
+ * @brief Connect a socket
+ *
+ * @details For SOCK_STREAM, this waits for the connection to be
+ * established, for up to CONFIG_NET_SOCKETS_CONNECT_TIMEOUT ms.
+ */
+int zsock_connect(int sock, const struct sockaddr *addr, socklen_t addrlen);
+
+int zsock_listen(int sock, int backlog);
+
+/**
+ * @brief Accept a connection on a listening socket
+ *
+ * @details The connections are queued as they are established, and given
+ * their own socket, until it is accepted or the listening socket closed.
+ *
+ * @return Socket descriptor of the connection, -1 on error.
+ */
+int zsock_accept(int sock, struct sockaddr *addr, socklen_t *addrlen);
+
+/**
+ * @brief Send data
+ *
+ * @details This waits for a network buffer, unless flags has
+ * ZSOCK_MSG_DONTWAIT. For SOCK_STREAM, fewer bytes than @a len can be
+ * sent, as with BSD sockets.
+ *
+ * @return Number of bytes sent, -1 on error.
+ */
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags);
+
+ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
+		     const struct sockaddr *dest_addr, socklen_t addrlen);
+
+/**
+ * @brief Receive data
+ *
+ * @details This waits for data for the receive timeout of the socket,
+ * unless flags has ZSOCK_MSG_DONTWAIT. For SOCK_DGRAM, the part of the
+ * datagram not fitting in @a buf is discarded.
+ *
+ * @return Number of bytes received, 0 at the end of a stream, -1 on error
+ * with errno set to EAGAIN if there was no data in time.
+ */
+ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags);
+
+ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Receive a network buffer, without copying it
+ *
+ * @details As zsock_recv(), but the next received buffer is handed out as
+ * it is. Its fragments hold the application data only, and the caller owns
+ * the reference, released with net_nbuf_unref().
+ *
+ * @return 0 if ok, with *buf set to NULL at the end of a stream, -1 on error.
+ */
+int zsock_recv_nbuf(int sock, struct net_buf **buf, int flags);
+
+/**
+ * @brief Receive several network buffers, without copying them
+ *
+ * @details As zsock_recv_nbuf(), but once the first buffer is received,
+ * the ones already queued are taken too, up to @a max, without waiting.
+ * This is similar to the BSD recvmmsg() function.
+ *
+ * @param sock Socket descriptor
+ * @param bufs Received buffers, owned by the caller
+ * @param src_addrs Source address of each buffer, or NULL
+ * @param max Size of @a bufs, and of @a src_addrs
+ * @param flags ZSOCK_MSG_DONTWAIT, or 0
+ *
+ * @return Number of buffers received, 0 at the end of a stream, -1 on
+ * error.
+ */
+int zsock_recv_nbufs(int sock, struct net_buf **bufs,
+		     struct sockaddr *src_addrs, int max, int flags);
+
+int zsock_setsockopt(int sock, int level, int optname,
+		     const void *optval, socklen_t optlen);
+
+/**
+ * @brief Wait for some sockets to be ready
+ *
+ * @details Sockets are ready for ZSOCK_POLLIN when they have data to read,
+ * are at the end of the stream, or have connections to accept. They are
+ * always ready for ZSOCK_POLLOUT, as sending only waits for buffers. The
+ * waiting is done with k_poll(), on the receive queues of the sockets.
+ *
+ * @param fds Sockets, up to CONFIG_NET_SOCKETS_POLL_MAX
+ * @param nfds Number of sockets
+ * @param timeout Timeout in ms, K_FOREVER or K_NO_WAIT
+ *
+ * @return Number of ready sockets, 0 on timeout, -1 on error.
+ */
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
+
+#if defined(CONFIG_NET_SOCKETS_POSIX_NAMES)
+#define socket zsock_socket
+#define close zsock_close
+#define bind zsock_bind
+#define connect zsock_connect
+#define listen zsock_listen
+#define accept zsock_accept
+#define send zsock_send
+#define sendto zsock_sendto
+#define recv zsock_recv
+#define recvfrom zsock_recvfrom
+#define setsockopt zsock_setsockopt
+#define poll zsock_poll
+#define pollfd zsock_pollfd
+
+#define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
+#define POLLIN ZSOCK_POLLIN
+#define POLLOUT ZSOCK_POLLOUT
+#define POLLERR ZSOCK_POLLERR
+#define POLLHUP ZSOCK_POLLHUP
+#define POLLNVAL ZSOCK_POLLNVAL
+#define SOL_SOCKET ZSOCK_SOL_SOCKET
+#define SO_RCVTIMEO ZSOCK_SO_RCVTIMEO
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+/**
+ * @}
+ */
+
+#endif /* _SOCKET_H_ */
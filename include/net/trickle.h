@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <kernel.h>
+#include <misc/slist.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,7 +45,10 @@ struct net_trickle {
 	uint32_t Imax_abs;	/* Max interval size in ms (not doublings)
 				 */
 
-	struct k_delayed_work timer;
+	sys_snode_t node;	/* Link in the running instances */
+	uint32_t due;		/* Time of the next event in ms */
+	bool fired;		/* Callback called in this interval */
+
 	net_trickle_cb_t cb;	/* Callback to be called when timer expires */
 	void *user_data;
 };
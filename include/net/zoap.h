@@ -140,6 +140,7 @@ enum zoap_response_code {
 
 #define ZOAP_CODE_EMPTY (0)
 
+struct zoap_notification;
 struct zoap_observer;
 struct zoap_packet;
 struct zoap_pending;
@@ -163,6 +164,16 @@ typedef int (*zoap_method_t)(struct zoap_resource *resource,
 typedef void (*zoap_notify_t)(struct zoap_resource *resource,
 			      struct zoap_observer *observer);
 
+/**
+ * @typedef zoap_notify_send_t
+ * @brief Type of the callback being called by
+ * zoap_resource_notify_shared() to send a notification to an observer.
+ */
+typedef int (*zoap_notify_send_t)(struct zoap_resource *resource,
+				  struct zoap_observer *observer,
+				  const struct zoap_notification *notification,
+				  void *user_data);
+
 /**
  * @brief Description of CoAP resource.
  *
@@ -177,6 +188,8 @@ struct zoap_resource {
 	void *user_data;
 	sys_slist_t observers;
 	int age;
+	/* Hash of the path, computed on the first request, internal use */
+	uint32_t path_hash;
 };
 
 /**
@@ -189,6 +202,26 @@ struct zoap_observer {
 	uint8_t tkl;
 };
 
+/**
+ * @brief Notification shared by all the observers of a resource.
+ */
+struct zoap_notification {
+	/* Options and payload, referenced by each notification sent */
+	struct net_buf *frag;
+	uint8_t ver_t;
+	uint8_t code;
+};
+
+/**
+ * @brief Option of a parsed CoAP packet, for internal use.
+ */
+struct zoap_option_index {
+	uint16_t code;
+	/* Offset of the value in the packet */
+	uint16_t offset;
+	uint16_t len;
+};
+
 /**
  * @brief Representation of a CoAP packet.
  */
@@ -196,6 +229,10 @@ struct zoap_packet {
 	struct net_buf *buf;
 	uint8_t *start; /* Start of the payload */
 	uint16_t total_size;
+	/* Options found by zoap_packet_parse(), valid if 'indexed' is set */
+	struct zoap_option_index options[CONFIG_ZOAP_PACKET_OPTIONS];
+	uint8_t options_count;
+	bool indexed;
 };
 
 /**
@@ -471,6 +508,66 @@ int zoap_handle_request(struct zoap_packet *pkt,
  */
 int zoap_resource_notify(struct zoap_resource *resource);
 
+/**
+ * @brief Starts building a notification of an update of @a resource,
+ * to be sent to all its observers by zoap_resource_notify_shared().
+ *
+ * The packet is a confirmable 2.05 (Content) response, without token,
+ * with an Observe option for the new age of the resource. The other
+ * options and the payload can then be added as usual.
+ *
+ * @param pkt Packet representation of the notification
+ * @param buf Buffer holding the notification, it must have one fragment
+ * @param resource Resource that was updated
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int zoap_notification_init(struct zoap_packet *pkt, struct net_buf *buf,
+			   struct zoap_resource *resource);
+
+/**
+ * @brief Calls @a send for every registered observer of @a resource,
+ * with a notification sharing the options and payload of @a pkt.
+ *
+ * Unlike zoap_resource_notify(), the payload is only serialized once:
+ * each observer gets the same reference-counted fragment, after its own
+ * header. The caller still releases its reference to the buffer of
+ * @a pkt, which cannot be used as a packet anymore.
+ *
+ * @param resource Resource that was updated
+ * @param pkt Notification, built with zoap_notification_init()
+ * @param send Callback sending the notification to an observer
+ * @param user_data User data passed to @a send
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int zoap_resource_notify_shared(struct zoap_resource *resource,
+				struct zoap_packet *pkt,
+				zoap_notify_send_t send, void *user_data);
+
+/**
+ * @brief Builds the notification to send to @a observer: its header and
+ * token are written to the first fragment of @a buf, which is then
+ * followed by the fragment of @a notification.
+ *
+ * The resulting packet can be sent and retransmitted, its payload is not
+ * supposed to be modified.
+ *
+ * @param pkt Packet representation of the notification
+ * @param buf Buffer for the notification, with an empty fragment
+ * @param notification Notification given to the zoap_notify_send_t
+ * callback
+ * @param observer Observer to send the notification to
+ * @param id Message id of the notification
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int zoap_notification_packet_init(struct zoap_packet *pkt,
+				  struct net_buf *buf,
+				  const struct zoap_notification *notification,
+				  const struct zoap_observer *observer,
+				  uint16_t id);
+
 /**
  * @brief Returns if this request is enabling observing a resource.
  *
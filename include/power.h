@@ -7,6 +7,12 @@
 #ifndef __INCpower
 #define __INCpower
 
+#include <stdint.h>
+#include <misc/dlist.h>
+#include <misc/slist.h>
+#include <device.h>
+#include <clock_control.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -115,6 +121,234 @@ extern int _sys_soc_suspend(int32_t ticks);
  * @}
  */
 
+#ifdef CONFIG_SYS_POWER_GOVERNOR
+
+/**
+ * @brief Idle Governor Interface
+ *
+ * @defgroup power_management_governor_interface Idle Governor Interface
+ * @ingroup power_management_api
+ * @{
+ */
+
+/** @brief Sleep state offered to the idle governor */
+struct sys_pm_state {
+	/** State identifier, left to the SoC */
+	int state;
+	/** Time to wake up from the state, in microseconds */
+	uint32_t exit_latency_us;
+	/** Shortest sleep the state saves power for, in microseconds */
+	uint32_t min_residency_us;
+};
+
+/** @brief Wake latency constraint, set by a driver */
+struct sys_pm_qos_request {
+	sys_dnode_t node;
+	uint32_t latency_us;
+};
+
+/**
+ * @brief Set the sleep states the idle governor picks from
+ *
+ * Called by the SoC before the kernel first idles.
+ *
+ * @param states Sleep states, ordered from the shallowest to the deepest.
+ * @param count Number of sleep states.
+ */
+void sys_pm_governor_states_set(const struct sys_pm_state *states,
+				int count);
+
+/**
+ * @brief Pick the sleep state for the upcoming idle period
+ *
+ * Called from _sys_soc_suspend(). The deepest state whose minimum
+ * residency fits in the predicted idle time, and whose exit latency meets
+ * the latency constraints, is picked. The prediction is the time to the
+ * next timeout, shortened by how early the recent sleeps of the CPU were
+ * ended by interrupts.
+ *
+ * @param ticks The upcoming kernel idle time, as passed to
+ * _sys_soc_suspend().
+ *
+ * @return The sleep state to enter, NULL if none is worth it.
+ */
+const struct sys_pm_state *sys_pm_governor_select(int32_t ticks);
+
+/**
+ * @brief Add a wake latency constraint
+ *
+ * No sleep state waking up slower than @a latency_us is picked until the
+ * request is removed.
+ *
+ * @param req Request, owned by the caller until removed.
+ * @param latency_us Longest acceptable wake latency, in microseconds.
+ */
+void sys_pm_qos_request_add(struct sys_pm_qos_request *req,
+			    uint32_t latency_us);
+
+/**
+ * @brief Change the latency of a wake latency constraint
+ *
+ * @param req Request added with sys_pm_qos_request_add().
+ * @param latency_us Longest acceptable wake latency, in microseconds.
+ */
+void sys_pm_qos_request_update(struct sys_pm_qos_request *req,
+			       uint32_t latency_us);
+
+/**
+ * @brief Remove a wake latency constraint
+ *
+ * @param req Request added with sys_pm_qos_request_add().
+ */
+void sys_pm_qos_request_remove(struct sys_pm_qos_request *req);
+
+/**
+ * @brief Get the wake latency all the constraints accept
+ *
+ * @return Latency in microseconds, UINT32_MAX without any constraint.
+ */
+uint32_t sys_pm_qos_latency_get(void);
+
+/**
+ * @}
+ */
+
+#endif /* CONFIG_SYS_POWER_GOVERNOR */
+
+#ifdef CONFIG_SYS_DVFS
+
+/**
+ * @brief Dynamic Voltage and Frequency Scaling Interface
+ *
+ * @defgroup power_management_dvfs_interface DVFS Interface
+ * @ingroup power_management_api
+ * @{
+ */
+
+/** @brief Operating point of the CPU clock */
+struct sys_dvfs_opp {
+	/** Rate passed to clock_control_set_rate(), in Hz */
+	uint32_t rate;
+};
+
+/** @brief Stage of an operating point change */
+enum sys_dvfs_event {
+	/** The rate is about to change, the clock still runs at the old one */
+	SYS_DVFS_PRE_CHANGE,
+	/** The rate changed, timings derived from the clock are to be set
+	 * again
+	 */
+	SYS_DVFS_POST_CHANGE,
+};
+
+struct sys_dvfs_notifier;
+
+/**
+ * @brief Operating point change callback
+ *
+ * Called from the thread changing the operating point, which may sleep.
+ *
+ * @param notifier Notifier registered.
+ * @param event Stage of the change.
+ * @param rate New rate of the CPU clock, in Hz.
+ */
+typedef void (*sys_dvfs_notifier_cb_t)(struct sys_dvfs_notifier *notifier,
+				       enum sys_dvfs_event event,
+				       uint32_t rate);
+
+/** @brief Operating point change notifier, set by a driver */
+struct sys_dvfs_notifier {
+	sys_snode_t node;
+	sys_dvfs_notifier_cb_t cb;
+};
+
+/** @brief Minimum operating point, set by a driver or an application */
+struct sys_dvfs_request {
+	sys_dnode_t node;
+	int min_opp;
+};
+
+/**
+ * @brief Set the operating points of the CPU clock
+ *
+ * Called by the SoC, the CPU clock is expected to run at the highest
+ * operating point then.
+ *
+ * @param clock Clock controller of the CPU clock.
+ * @param sys Sub-system of the CPU clock.
+ * @param opps Operating points, ordered from the slowest to the fastest.
+ * @param count Number of operating points.
+ */
+void sys_dvfs_opps_set(struct device *clock, clock_control_subsys_t sys,
+		       const struct sys_dvfs_opp *opps, int count);
+
+/**
+ * @brief Change the operating point of the CPU clock
+ *
+ * The notifiers are called before and after the rate is changed. The
+ * operating point is raised to the highest minimum requested, if below.
+ *
+ * @param opp Index of the operating point.
+ *
+ * @retval 0 Operating point changed, or already the one running.
+ * @retval -EINVAL No such operating point.
+ * @retval -ENOTSUP The clock controller cannot change the rate.
+ */
+int sys_dvfs_opp_set(int opp);
+
+/**
+ * @brief Get the operating point of the CPU clock
+ *
+ * @return Index of the operating point.
+ */
+int sys_dvfs_opp_get(void);
+
+/**
+ * @brief Register an operating point change notifier
+ *
+ * @param notifier Notifier, owned by the caller until unregistered.
+ */
+void sys_dvfs_notifier_register(struct sys_dvfs_notifier *notifier);
+
+/**
+ * @brief Unregister an operating point change notifier
+ *
+ * @param notifier Notifier registered with sys_dvfs_notifier_register().
+ */
+void sys_dvfs_notifier_unregister(struct sys_dvfs_notifier *notifier);
+
+/**
+ * @brief Add a minimum operating point
+ *
+ * The CPU clock is raised to @a min_opp at once if slower, and not lowered
+ * below it until the request is removed.
+ *
+ * @param req Request, owned by the caller until removed.
+ * @param min_opp Index of the slowest acceptable operating point.
+ */
+void sys_dvfs_request_add(struct sys_dvfs_request *req, int min_opp);
+
+/**
+ * @brief Change the operating point of a minimum operating point request
+ *
+ * @param req Request added with sys_dvfs_request_add().
+ * @param min_opp Index of the slowest acceptable operating point.
+ */
+void sys_dvfs_request_update(struct sys_dvfs_request *req, int min_opp);
+
+/**
+ * @brief Remove a minimum operating point
+ *
+ * @param req Request added with sys_dvfs_request_add().
+ */
+void sys_dvfs_request_remove(struct sys_dvfs_request *req);
+
+/**
+ * @}
+ */
+
+#endif /* CONFIG_SYS_DVFS */
+
 #endif /* CONFIG_SYS_POWER_MANAGEMENT */
 
 #ifdef __cplusplus
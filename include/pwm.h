@@ -87,6 +87,38 @@ typedef int (*pwm_pin_set_t)(struct device *dev, uint32_t pwm,
 typedef int (*pwm_get_cycles_per_sec_t)(struct device *dev, uint32_t pwm,
 					uint64_t *cycles);
 
+/**
+ * @typedef pwm_seq_callback_t
+ * @brief Callback for the end of a pulse width sequence.
+ *
+ * Called from interrupt context, once the last pulse width of the sequence
+ * is loaded, or when the sequence can not go on.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param pwm PWM pin the sequence was set on.
+ * @param status 0 if the whole sequence was loaded, negative errno code
+ *		 otherwise.
+ */
+typedef void (*pwm_seq_callback_t)(struct device *dev, uint32_t pwm,
+				   int status);
+
+/**
+ * @typedef pwm_pin_set_seq_t
+ * @brief Callback API upon setting a pulse width sequence
+ * See @a pwm_pin_set_seq_cycles() for argument description
+ */
+typedef int (*pwm_pin_set_seq_t)(struct device *dev, uint32_t pwm,
+				 uint32_t period_cycles,
+				 const uint16_t *pulse_cycles, size_t count,
+				 pwm_seq_callback_t cb);
+
+/**
+ * @typedef pwm_pin_stop_seq_t
+ * @brief Callback API upon stopping a pulse width sequence
+ * See @a pwm_pin_stop_seq() for argument description
+ */
+typedef int (*pwm_pin_stop_seq_t)(struct device *dev, uint32_t pwm);
+
 /** @brief PWM driver API definition. */
 struct pwm_driver_api {
 	pwm_config_t config;
@@ -96,6 +128,8 @@ struct pwm_driver_api {
 	pwm_set_phase_t set_phase;
 	pwm_pin_set_t pin_set;
 	pwm_get_cycles_per_sec_t get_cycles_per_sec;
+	pwm_pin_set_seq_t pin_set_seq;
+	pwm_pin_stop_seq_t pin_stop_seq;
 };
 
 /**
@@ -155,6 +189,67 @@ static inline int pwm_pin_set_usec(struct device *dev, uint32_t pwm,
 			    (uint32_t)pulse_cycles);
 }
 
+/**
+ * @brief Output a sequence of pulse widths on a single PWM output.
+ *
+ * Each period gets the next pulse width of the array, loaded by the
+ * hardware without the CPU being involved, which makes it possible to
+ * generate long waveforms such as LED strip or IR remote frames. The
+ * output keeps the last pulse width once the sequence is done, which is
+ * usually the idle level the sequence should end with.
+ *
+ * The array must be left untouched until the callback is called.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param pwm PWM pin.
+ * @param period Period (in clock cycle) of each pulse. HW specific.
+ * @param pulses Pulse widths (in clock cycle), one per period.
+ * @param count Number of pulse widths in the array.
+ * @param cb Called once the sequence is done, can be NULL.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If the driver does not support sequences.
+ * @retval -EBUSY If a sequence is already going on for the pin.
+ * @retval Negative errno code if failure.
+ */
+static inline int pwm_pin_set_seq_cycles(struct device *dev, uint32_t pwm,
+					 uint32_t period,
+					 const uint16_t *pulses, size_t count,
+					 pwm_seq_callback_t cb)
+{
+	const struct pwm_driver_api *api = dev->driver_api;
+
+	if (!api->pin_set_seq) {
+		return -ENOTSUP;
+	}
+
+	return api->pin_set_seq(dev, pwm, period, pulses, count, cb);
+}
+
+/**
+ * @brief Stop the sequence of pulse widths of a single PWM output.
+ *
+ * The output keeps the pulse width loaded last, the callback of the
+ * sequence is not called.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param pwm PWM pin.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If the driver does not support sequences.
+ * @retval Negative errno code if failure.
+ */
+static inline int pwm_pin_stop_seq(struct device *dev, uint32_t pwm)
+{
+	const struct pwm_driver_api *api = dev->driver_api;
+
+	if (!api->pin_stop_seq) {
+		return -ENOTSUP;
+	}
+
+	return api->pin_stop_seq(dev, pwm);
+}
+
 /**
  * @brief Get the clock rate (cycles per second) for a single PWM output.
  *
@@ -17,6 +17,19 @@
 #define __irq_vector_table	_GENERIC_SECTION(IRQ_VECTOR_TABLE)
 #define __sw_isr_table		_GENERIC_SECTION(SW_ISR_TABLE)
 
+#if defined(CONFIG_ARCH_HAS_RAMFUNC_SUPPORT)
+#define __ramfunc	__attribute__((noinline))			\
+			__attribute__((long_call, section(".ramfunc")))
+#else
+#define __ramfunc
+#endif /* CONFIG_ARCH_HAS_RAMFUNC_SUPPORT */
+
+#if defined(CONFIG_HOT_TEXT_IN_RAM)
+#define __hot_text	__ramfunc
+#else
+#define __hot_text
+#endif /* CONFIG_HOT_TEXT_IN_RAM */
+
 #if defined(CONFIG_ARM)
 #define __scp_section		__in_section_unique(SCP_SECTION)
 #define __kinetis_flash_config_section __in_section_unique(KINETIS_FLASH_CONFIG)
@@ -39,6 +39,14 @@
 #define DATA data
 #define NOINIT noinit
 
+/* Functions run from RAM, and the hot paths moved there on request */
+#define RAMFUNC ramfunc
+#if defined(CONFIG_HOT_TEXT_IN_RAM)
+#define HOT_TEXT ramfunc
+#else
+#define HOT_TEXT text
+#endif
+
 /* Interrupts */
 #define IRQ_VECTOR_TABLE	.gnu.linkonce.irq_vector_table
 #define SW_ISR_TABLE		.gnu.linkonce.sw_isr_table
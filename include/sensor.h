@@ -24,6 +24,8 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stddef.h>
+#include <kernel.h>
 #include <device.h>
 #include <errno.h>
 
@@ -110,6 +112,24 @@ enum sensor_channel {
 	SENSOR_CHAN_ALL,
 };
 
+/**
+ * @brief Scale of the raw readings of a channel.
+ *
+ * A raw reading converts to micro units of the channel as
+ * (raw * mult) / 2^shift + offset, see @ref sensor_raw_to_value. The
+ * scale only changes along with the configuration of the sensor, e.g.
+ * its range, so a consumer can derive its own fixed-point factor once
+ * instead of converting every sample.
+ */
+struct sensor_scale {
+	/** Micro units per LSB, times 2^shift. */
+	int32_t mult;
+	/** Number of fractional bits of mult. */
+	uint8_t shift;
+	/** Offset of the converted value, in micro units. */
+	int32_t offset;
+};
+
 /**
  * @brief Sensor trigger types.
  */
@@ -145,6 +165,13 @@ enum sensor_trigger_type {
 
 	/** Trigger fires when a double tap is detected. */
 	SENSOR_TRIG_DOUBLE_TAP,
+
+	/**
+	 * Trigger fires when the hardware FIFO holds the number of samples
+	 * configured via the @ref SENSOR_ATTR_FIFO_WATERMARK attribute.
+	 * The samples are then read with @ref sensor_fifo_read.
+	 */
+	SENSOR_TRIG_FIFO_WATERMARK,
 };
 
 /**
@@ -191,6 +218,44 @@ enum sensor_attribute {
 	 * algorithms to calibrate itself on a certain axis, or all of them.
 	 */
 	SENSOR_ATTR_CALIB_TARGET,
+	/**
+	 * Number of samples buffered in the hardware FIFO before the
+	 * @ref SENSOR_TRIG_FIFO_WATERMARK trigger fires. Zero disables the
+	 * FIFO.
+	 */
+	SENSOR_ATTR_FIFO_WATERMARK,
+};
+
+/**
+ * @brief Contents of a sensor's hardware FIFO.
+ *
+ * Filled by @ref sensor_fifo_read in a single bus transfer, the samples
+ * being converted later on by @ref sensor_fifo_decode. The layout of the
+ * buffer is driver specific.
+ */
+struct sensor_fifo_data {
+	/** Buffer for the FIFO contents, provided by the caller. */
+	uint8_t *buf;
+	/** Size of the buffer. */
+	size_t size;
+	/** Number of bytes read into the buffer. */
+	size_t len;
+	/** Time the last sample was read at, in hardware clock cycles. */
+	uint32_t timestamp;
+	/** Time between two samples, in hardware clock cycles. */
+	uint32_t period;
+	/** Driver specific information needed to decode the samples. */
+	uint32_t info;
+};
+
+/**
+ * @brief Sample decoded from the contents of a sensor's FIFO.
+ */
+struct sensor_sample {
+	/** Time of the sample, in hardware clock cycles. */
+	uint32_t timestamp;
+	/** Value of the channel, X, Y and Z for vectorial channels. */
+	struct sensor_value val[3];
 };
 
 /**
@@ -239,14 +304,66 @@ typedef int (*sensor_sample_fetch_t)(struct device *dev,
 typedef int (*sensor_channel_get_t)(struct device *dev,
 				    enum sensor_channel chan,
 				    struct sensor_value *val);
+/**
+ * @typedef sensor_fifo_read_t
+ * @brief Callback API for reading the FIFO of a sensor
+ *
+ * See sensor_fifo_read() for argument description
+ */
+typedef int (*sensor_fifo_read_t)(struct device *dev,
+				  struct sensor_fifo_data *data);
+/**
+ * @typedef sensor_fifo_decode_t
+ * @brief Callback API for decoding the samples read from a FIFO
+ *
+ * See sensor_fifo_decode() for argument description
+ */
+typedef int (*sensor_fifo_decode_t)(struct device *dev,
+				    const struct sensor_fifo_data *data,
+				    enum sensor_channel chan,
+				    struct sensor_sample *samples,
+				    size_t count);
+
+/**
+ * @typedef sensor_channel_get_raw_t
+ * @brief Callback API for getting a raw reading from a sensor
+ *
+ * See sensor_channel_get_raw() for argument description
+ */
+typedef int (*sensor_channel_get_raw_t)(struct device *dev,
+					enum sensor_channel chan,
+					int32_t *raw,
+					struct sensor_scale *scale);
 
 struct sensor_driver_api {
 	sensor_attr_set_t attr_set;
 	sensor_trigger_set_t trigger_set;
 	sensor_sample_fetch_t sample_fetch;
 	sensor_channel_get_t channel_get;
+	sensor_fifo_read_t fifo_read;
+	sensor_fifo_decode_t fifo_decode;
+	sensor_channel_get_raw_t channel_get_raw;
 };
 
+/* Keeps a device using runtime power management active for the fetch */
+static inline int _sensor_sample_fetch(struct device *dev,
+				       enum sensor_channel chan)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
+
+	ret = api->sample_fetch(dev, chan);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
+}
+
 /**
  * @brief Set an attribute for a sensor
  *
@@ -266,11 +383,22 @@ static inline int sensor_attr_set(struct device *dev,
 {
 	const struct sensor_driver_api *api = dev->driver_api;
 
+	int ret;
+
 	if (!api->attr_set) {
 		return -ENOTSUP;
 	}
 
-	return api->attr_set(dev, chan, attr, val);
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
+
+	ret = api->attr_set(dev, chan, attr, val);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
 }
 
 /**
@@ -319,9 +447,7 @@ static inline int sensor_trigger_set(struct device *dev,
  */
 static inline int sensor_sample_fetch(struct device *dev)
 {
-	const struct sensor_driver_api *api = dev->driver_api;
-
-	return api->sample_fetch(dev, SENSOR_CHAN_ALL);
+	return _sensor_sample_fetch(dev, SENSOR_CHAN_ALL);
 }
 
 /**
@@ -346,9 +472,7 @@ static inline int sensor_sample_fetch(struct device *dev)
 static inline int sensor_sample_fetch_chan(struct device *dev,
 					   enum sensor_channel type)
 {
-	const struct sensor_driver_api *api = dev->driver_api;
-
-	return api->sample_fetch(dev, type);
+	return _sensor_sample_fetch(dev, type);
 }
 
 /**
@@ -381,6 +505,112 @@ static inline int sensor_channel_get(struct device *dev,
 	return api->channel_get(dev, chan, val);
 }
 
+/**
+ * @brief Get a raw reading from a sensor device, along with its scale
+ *
+ * Same as @ref sensor_channel_get, without the conversion of the reading
+ * to a @ref sensor_value: the readings are returned as the device
+ * provides them, sign extended. Vectorial channels return X, Y and Z at
+ * raw[0], raw[1] and raw[2], all of them sharing the same scale.
+ *
+ * @param dev Pointer to the sensor device
+ * @param chan The channel to read
+ * @param raw Where to store the raw readings
+ * @param scale Where to store the scale of the channel, may be NULL
+ *
+ * @return 0 if successful, negative errno code if failure.
+ */
+static inline int sensor_channel_get_raw(struct device *dev,
+					 enum sensor_channel chan,
+					 int32_t *raw,
+					 struct sensor_scale *scale)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->channel_get_raw) {
+		return -ENOTSUP;
+	}
+
+	return api->channel_get_raw(dev, chan, raw, scale);
+}
+
+/**
+ * @brief Helper function to convert a raw reading to a sensor_value
+ *
+ * @param raw The raw reading, from @ref sensor_channel_get_raw
+ * @param scale The scale of the channel the reading belongs to
+ * @param val Where to store the converted value
+ */
+static inline void sensor_raw_to_value(int32_t raw,
+				       const struct sensor_scale *scale,
+				       struct sensor_value *val)
+{
+	int64_t micro = (((int64_t)raw * scale->mult) >> scale->shift) +
+			scale->offset;
+
+	val->val1 = micro / 1000000LL;
+	val->val2 = micro % 1000000LL;
+}
+
+/**
+ * @brief Read the samples buffered in the sensor's hardware FIFO
+ *
+ * All the complete samples of the FIFO fitting in the buffer are read in a
+ * single bus transfer, and are timestamped. They are left in the format of
+ * the device, for @ref sensor_fifo_decode to convert them later on.
+ *
+ * The FIFO is enabled by setting the @ref SENSOR_ATTR_FIFO_WATERMARK
+ * attribute, and is usually read upon @ref SENSOR_TRIG_FIFO_WATERMARK.
+ *
+ * Since the function communicates with the sensor device, it is unsafe
+ * to call it in an ISR if the device is connected via I2C or SPI.
+ *
+ * @param dev Pointer to the sensor device
+ * @param data FIFO data, its buf and size fields set by the caller
+ *
+ * @return 0 if successful, negative errno code if failure.
+ */
+static inline int sensor_fifo_read(struct device *dev,
+				   struct sensor_fifo_data *data)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->fifo_read) {
+		return -ENOTSUP;
+	}
+
+	return api->fifo_read(dev, data);
+}
+
+/**
+ * @brief Decode a channel from the samples read from a sensor's FIFO
+ *
+ * Does not communicate with the device, the samples can be decoded from
+ * any context once read by @ref sensor_fifo_read.
+ *
+ * @param dev Pointer to the sensor device
+ * @param data FIFO data previously read
+ * @param chan The channel to decode
+ * @param samples Where to store the decoded samples
+ * @param count Number of samples the array can hold
+ *
+ * @return Number of samples decoded, negative errno code if failure.
+ */
+static inline int sensor_fifo_decode(struct device *dev,
+				     const struct sensor_fifo_data *data,
+				     enum sensor_channel chan,
+				     struct sensor_sample *samples,
+				     size_t count)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->fifo_decode) {
+		return -ENOTSUP;
+	}
+
+	return api->fifo_decode(dev, data, chan, samples, count);
+}
+
 /**
  * @brief The value of gravitational constant in micro m/s^2.
  */
@@ -463,6 +693,30 @@ static inline double sensor_value_to_double(struct sensor_value *val)
 	return (double)val->val1 + (double)val->val2 / 1000000;
 }
 
+#ifdef CONFIG_SENSOR_WORK_QUEUE
+extern struct k_work_q sensor_work_q;
+#endif
+
+/**
+ * @brief Submit the trigger work of a sensor driver.
+ *
+ * For drivers handling their triggers in the global thread: queues the
+ * work in the sensor work queue, or in the system work queue without
+ * CONFIG_SENSOR_WORK_QUEUE. Submitting a work still pending does nothing,
+ * so the interrupts received before the trigger is handled are handled
+ * once. May be called from ISRs.
+ *
+ * @param work Trigger work of the driver.
+ */
+static inline void sensor_work_submit(struct k_work *work)
+{
+#ifdef CONFIG_SENSOR_WORK_QUEUE
+	k_work_submit_to_queue(&sensor_work_q, work);
+#else
+	k_work_submit(work);
+#endif
+}
+
 
 #ifdef __cplusplus
 }
@@ -17,17 +17,33 @@ extern "C" {
 
 typedef int (*isr_t)(struct device *dev);
 
+/* Returns 1 if the device asserted the interrupt, 0 otherwise */
+typedef int (*isr_pending_t)(struct device *dev);
+
 /* driver API definition */
 typedef int (*shared_irq_register_t)(struct device *dev,
 				isr_t isr_func,
 				struct device *isr_dev);
 typedef int (*shared_irq_enable_t)(struct device *dev, struct device *isr_dev);
 typedef int (*shared_irq_disable_t)(struct device *dev, struct device *isr_dev);
+typedef int (*shared_irq_pending_register_t)(struct device *dev,
+				isr_pending_t pending_func,
+				struct device *isr_dev);
+#ifdef CONFIG_SHARED_IRQ_STATS
+struct shared_irq_stats;
+typedef int (*shared_irq_stats_get_t)(struct device *dev,
+				struct device *isr_dev,
+				struct shared_irq_stats *stats);
+#endif
 
 struct shared_irq_driver_api {
 	shared_irq_register_t isr_register;
 	shared_irq_enable_t enable;
 	shared_irq_disable_t disable;
+	shared_irq_pending_register_t pending_register;
+#ifdef CONFIG_SHARED_IRQ_STATS
+	shared_irq_stats_get_t stats_get;
+#endif
 };
 
 extern int shared_irq_initialize(struct device *port);
@@ -40,10 +56,29 @@ struct shared_irq_config {
 	uint32_t client_count;
 };
 
+#ifdef CONFIG_SHARED_IRQ_STATS
+/* Per client statistics, in hardware cycles */
+struct shared_irq_stats {
+	/* Interrupts serviced by the client */
+	uint32_t calls;
+	/* Interrupts the client was not called for, not being pending */
+	uint32_t skipped;
+	/* Longest time from the interrupt dispatch to the client ISR */
+	uint32_t latency_max;
+	/* Time spent in the client ISR */
+	uint64_t cycles_total;
+	uint32_t cycles_max;
+};
+#endif
+
 struct shared_irq_client {
 	struct device *isr_dev;
 	isr_t isr_func;
+	isr_pending_t pending_func;
 	uint32_t enabled;
+#ifdef CONFIG_SHARED_IRQ_STATS
+	struct shared_irq_stats stats;
+#endif
 };
 
 struct shared_irq_runtime {
@@ -64,6 +99,27 @@ static inline int shared_irq_isr_register(struct device *dev, isr_t isr_func,
 	return api->isr_register(dev, isr_func, isr_dev);
 }
 
+/**
+ *  @brief Register a status query for a device ISR
+ *
+ *  Once registered, the ISR of the device is only called when the query
+ *  reports the device as having asserted the interrupt, instead of for
+ *  every interrupt of the line. Called from the interrupt context, it
+ *  should only read a status register.
+ *
+ *  @param dev Pointer to device structure for SHARED_IRQ driver instance.
+ *  @param pending_func Pointer to the status query for the device.
+ *  @param isr_dev Pointer to the device that will service the interrupt.
+ */
+static inline int shared_irq_pending_register(struct device *dev,
+					      isr_pending_t pending_func,
+					      struct device *isr_dev)
+{
+	const struct shared_irq_driver_api *api = dev->driver_api;
+
+	return api->pending_register(dev, pending_func, isr_dev);
+}
+
 /**
  *  @brief Enable ISR for device
  *  @param dev Pointer to device structure for SHARED_IRQ driver instance.
@@ -88,6 +144,23 @@ static inline int shared_irq_disable(struct device *dev, struct device *isr_dev)
 	return api->disable(dev, isr_dev);
 }
 
+#ifdef CONFIG_SHARED_IRQ_STATS
+/**
+ *  @brief Get the statistics of a device ISR
+ *  @param dev Pointer to device structure for SHARED_IRQ driver instance.
+ *  @param isr_dev Pointer to the device that services the interrupt.
+ *  @param stats Filled with the statistics of the device ISR.
+ */
+static inline int shared_irq_stats_get(struct device *dev,
+				       struct device *isr_dev,
+				       struct shared_irq_stats *stats)
+{
+	const struct shared_irq_driver_api *api = dev->driver_api;
+
+	return api->stats_get(dev, isr_dev, stats);
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,9 +19,11 @@
  * @{
  */
 
+#include <errno.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <device.h>
+#include <misc/slist.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -66,6 +68,61 @@ struct spi_config {
 	uint32_t	max_sys_freq;
 };
 
+/**
+ * @brief SPI transfer, a part of an asynchronous transaction.
+ *
+ * Lengths are in bytes, as for spi_transceive(). The frames received are
+ * stored in rx_buf up to rx_len, those sent are taken from tx_buf up to
+ * tx_len, and zeros after it: the transfer lasts for the longest of both.
+ */
+struct spi_transfer {
+	const void *tx_buf;
+	uint32_t tx_len;
+	void *rx_buf;
+	uint32_t rx_len;
+};
+
+struct spi_transaction;
+
+/**
+ * @typedef spi_callback_t
+ * @brief Completion callback of an asynchronous transaction.
+ *
+ * Called from the interrupt context of the controller. The transaction
+ * belongs to the caller again, and it can be queued anew from here.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param trans Transaction done.
+ * @param status 0 if successful, negative errno code if failure.
+ */
+typedef void (*spi_callback_t)(struct device *dev,
+			       struct spi_transaction *trans, int status);
+
+/**
+ * @brief SPI asynchronous transaction.
+ *
+ * The transfers of a transaction are done in order, with the slave
+ * selected for all of them. The transaction, its transfers and their
+ * buffers belong to the driver from spi_transceive_async() until the
+ * callback is called.
+ */
+struct spi_transaction {
+	/** Used by the driver, to queue the transaction */
+	sys_snode_t node;
+	/** Configuration of the slave, NULL for the one of spi_configure() */
+	struct spi_config *config;
+	/** Slave as for spi_slave_select(), 0 for the one selected */
+	uint32_t slave;
+	/** Transfers of the transaction */
+	const struct spi_transfer *transfers;
+	/** Number of transfers */
+	uint8_t count;
+	/** Called once the transaction is done */
+	spi_callback_t callback;
+	/** Left to the user of the transaction */
+	void *user_data;
+};
+
 /**
  * @typedef spi_api_configure
  * @brief Callback API upon configuring the const controller
@@ -87,13 +144,41 @@ typedef int (*spi_api_slave_select)(struct device *dev, uint32_t slave);
 typedef int (*spi_api_io)(struct device *dev,
 			  const void *tx_buf, uint32_t tx_buf_len,
 			  void *rx_buf, uint32_t rx_buf_len);
+/**
+ * @typedef spi_api_io_async
+ * @brief Callback API for asynchronous I/O
+ * See spi_transceive_async() for argument descriptions
+ */
+typedef int (*spi_api_io_async)(struct device *dev,
+				struct spi_transaction *trans);
 
 struct spi_driver_api {
 	spi_api_configure configure;
 	spi_api_slave_select slave_select;
 	spi_api_io transceive;
+	spi_api_io_async transceive_async;
 };
 
+/* Keeps a device using runtime power management active for the transfer */
+static inline int _spi_transceive(struct device *dev,
+				  const void *tx_buf, uint32_t tx_buf_len,
+				  void *rx_buf, uint32_t rx_buf_len)
+{
+	const struct spi_driver_api *api = dev->driver_api;
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
+
+	ret = api->transceive(dev, tx_buf, tx_buf_len, rx_buf, rx_buf_len);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
+}
+
 /**
  * @brief Configure a host controller for operating against slaves.
  * @param dev Pointer to the device structure for the driver instance.
@@ -106,8 +191,18 @@ static inline int spi_configure(struct device *dev,
 				struct spi_config *config)
 {
 	const struct spi_driver_api *api = dev->driver_api;
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
 
-	return api->configure(dev, config);
+	ret = api->configure(dev, config);
+
+	device_runtime_pm_put(dev);
+
+	return ret;
 }
 
 /**
@@ -147,9 +242,7 @@ static inline int spi_slave_select(struct device *dev, uint32_t slave)
  */
 static inline int spi_read(struct device *dev, void *buf, uint32_t len)
 {
-	const struct spi_driver_api *api = dev->driver_api;
-
-	return api->transceive(dev, NULL, 0, buf, len);
+	return _spi_transceive(dev, NULL, 0, buf, len);
 }
 
 /**
@@ -163,9 +256,7 @@ static inline int spi_read(struct device *dev, void *buf, uint32_t len)
  */
 static inline int spi_write(struct device *dev, const void *buf, uint32_t len)
 {
-	const struct spi_driver_api *api = dev->driver_api;
-
-	return api->transceive(dev, buf, len, NULL, 0);
+	return _spi_transceive(dev, buf, len, NULL, 0);
 }
 
 /**
@@ -186,10 +277,36 @@ static inline int spi_write(struct device *dev, const void *buf, uint32_t len)
 static inline int spi_transceive(struct device *dev,
 			  const void *tx_buf, uint32_t tx_buf_len,
 			  void *rx_buf, uint32_t rx_buf_len)
+{
+	return _spi_transceive(dev, tx_buf, tx_buf_len, rx_buf, rx_buf_len);
+}
+
+/**
+ * @brief Queue an asynchronous transaction.
+ *
+ * The transaction is done once those queued before it are, and its
+ * callback is then called. The driver goes from one queued transaction to
+ * the next by itself: back to back transactions do not need the caller to
+ * run in between. This is how devices sharing a bus, each with its own
+ * configuration and slave, can queue their transactions on it.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param trans Transaction to be done.
+ *
+ * @retval 0 If the transaction is queued.
+ * @retval -ENOTSUP If the driver has no asynchronous support.
+ * @retval Negative errno code if failure.
+ */
+static inline int spi_transceive_async(struct device *dev,
+				       struct spi_transaction *trans)
 {
 	const struct spi_driver_api *api = dev->driver_api;
 
-	return api->transceive(dev, tx_buf, tx_buf_len, rx_buf, rx_buf_len);
+	if (!api->transceive_async) {
+		return -ENOTSUP;
+	}
+
+	return api->transceive_async(dev, trans);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SPINLOCK_H__
+#define __SPINLOCK_H__
+
+#include <atomic.h>
+#include <irq.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup spinlock_apis Spinlock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Spinlock.
+ *
+ * A spinlock protects data shared between threads and ISRs of all CPUs. It
+ * locks interrupts on the local CPU and, on SMP systems, busy-waits until no
+ * other CPU holds it. Unlike irq_lock(), which is a single global lock on
+ * SMP systems, it only excludes the contexts using the same spinlock. On
+ * single-CPU systems, it boils down to irq_lock().
+ *
+ * Spinlocks can not be taken recursively, and must not be held across
+ * operations that can make the current thread wait.
+ */
+struct k_spinlock {
+#ifdef CONFIG_SMP
+	atomic_t locked;
+#endif
+};
+
+/**
+ * @brief Spinlock key, returned when taking a spinlock.
+ */
+typedef struct {
+	unsigned int key;
+} k_spinlock_key_t;
+
+/**
+ * @brief Take a spinlock.
+ *
+ * @param lock Address of the spinlock, initially zeroed.
+ *
+ * @return Key to give back to k_spin_unlock().
+ */
+static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *lock)
+{
+	k_spinlock_key_t key;
+
+	key.key = _arch_irq_lock();
+
+#ifdef CONFIG_SMP
+	while (!atomic_cas(&lock->locked, 0, 1)) {
+		/* spin */
+	}
+#else
+	ARG_UNUSED(lock);
+#endif
+
+	return key;
+}
+
+/**
+ * @brief Release a spinlock.
+ *
+ * @param lock Address of the spinlock.
+ * @param key Key returned when taking the spinlock.
+ *
+ * @return N/A
+ */
+static ALWAYS_INLINE void k_spin_unlock(struct k_spinlock *lock,
+					k_spinlock_key_t key)
+{
+#ifdef CONFIG_SMP
+	atomic_clear(&lock->locked);
+#else
+	ARG_UNUSED(lock);
+#endif
+
+	_arch_irq_unlock(key.key);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPINLOCK_H__ */
@@ -27,6 +27,7 @@ extern "C" {
 #include <stddef.h>
 
 #include <device.h>
+#include <misc/__assert.h>
 
 #ifdef CONFIG_PCI
 #include <drivers/pci/pci.h>
@@ -80,6 +81,96 @@ typedef void (*uart_irq_callback_t)(struct device *port);
  */
 typedef void (*uart_irq_config_func_t)(struct device *port);
 
+#ifdef CONFIG_UART_ASYNC_API
+
+/** @brief Types of the events reported by the asynchronous API. */
+enum uart_event_type {
+	/** @brief The whole buffer was transmitted. */
+	UART_TX_DONE,
+	/**
+	 * @brief The transmission was aborted by uart_tx_abort(), the @a len
+	 * of the event tells how much of the buffer was transmitted.
+	 */
+	UART_TX_ABORTED,
+	/**
+	 * @brief Data was received, from @a offset in the buffer for @a len
+	 * bytes.
+	 *
+	 * Reported when the buffer is full, or when the line went idle for
+	 * the timeout given to uart_rx_enable().
+	 */
+	UART_RX_RDY,
+	/**
+	 * @brief The driver needs the next buffer, to switch to it once the
+	 * current one is full. The buffer is given with uart_rx_buf_rsp().
+	 */
+	UART_RX_BUF_REQUEST,
+	/** @brief The driver no longer uses the buffer. */
+	UART_RX_BUF_RELEASED,
+	/**
+	 * @brief The reception stopped, on uart_rx_disable() or because no
+	 * buffer was given before the last one got full. All the buffers were
+	 * released.
+	 */
+	UART_RX_DISABLED,
+	/**
+	 * @brief The reception stopped on a receive error, UART_ERROR_* bits
+	 * in @a reason. UART_RX_DISABLED follows once the buffers are
+	 * released.
+	 */
+	UART_RX_STOPPED,
+};
+
+/** @brief Data of the UART_TX_DONE and UART_TX_ABORTED events. */
+struct uart_event_tx {
+	const uint8_t *buf;
+	size_t len;
+};
+
+/** @brief Data of the UART_RX_RDY event. */
+struct uart_event_rx {
+	uint8_t *buf;
+	size_t offset;
+	size_t len;
+};
+
+/** @brief Data of the UART_RX_BUF_RELEASED event. */
+struct uart_event_rx_buf {
+	uint8_t *buf;
+};
+
+/** @brief Data of the UART_RX_STOPPED event. */
+struct uart_event_rx_stop {
+	int reason;
+};
+
+/** @brief Event reported by the asynchronous API. */
+struct uart_event {
+	enum uart_event_type type;
+	union {
+		struct uart_event_tx tx;
+		struct uart_event_rx rx;
+		struct uart_event_rx_buf rx_buf;
+		struct uart_event_rx_stop rx_stop;
+	} data;
+};
+
+/**
+ * @typedef uart_callback_t
+ * @brief Define the application callback function signature for the
+ * asynchronous API.
+ *
+ * It is called from the interrupt context of the driver.
+ *
+ * @param dev Device struct for the UART device.
+ * @param evt Event being reported.
+ * @param user_data Pointer given to uart_callback_set().
+ */
+typedef void (*uart_callback_t)(struct device *dev, struct uart_event *evt,
+				void *user_data);
+
+#endif /* CONFIG_UART_ASYNC_API */
+
 /**
  * @brief UART device configuration.
  *
@@ -161,6 +252,28 @@ struct uart_driver_api {
 
 #endif
 
+#ifdef CONFIG_UART_ASYNC_API
+	/** Asynchronous API callback setting function */
+	int (*callback_set)(struct device *dev, uart_callback_t cb,
+			    void *user_data);
+
+	/** Asynchronous transmission function */
+	int (*tx)(struct device *dev, const uint8_t *buf, size_t len);
+
+	/** Asynchronous transmission aborting function */
+	int (*tx_abort)(struct device *dev);
+
+	/** Asynchronous reception enabling function */
+	int (*rx_enable)(struct device *dev, uint8_t *buf, size_t len,
+			 uint32_t timeout);
+
+	/** Asynchronous reception next buffer function */
+	int (*rx_buf_rsp)(struct device *dev, uint8_t *buf, size_t len);
+
+	/** Asynchronous reception disabling function */
+	int (*rx_disable)(struct device *dev);
+#endif
+
 #ifdef CONFIG_UART_LINE_CTRL
 	int (*line_ctrl_set)(struct device *dev, uint32_t ctrl, uint32_t val);
 	int (*line_ctrl_get)(struct device *dev, uint32_t ctrl, uint32_t *val);
@@ -172,6 +285,40 @@ struct uart_driver_api {
 
 };
 
+#ifdef CONFIG_UART_DIRECT_API
+/* The only UART driver of the build, defined by UART_DIRECT_API_DEFINE() */
+extern const struct uart_driver_api _uart_direct_api;
+int _uart_direct_poll_in(struct device *dev, unsigned char *p_char);
+unsigned char _uart_direct_poll_out(struct device *dev,
+				    unsigned char out_char);
+
+/**
+ * @brief Make a driver the one called directly by the UART API
+ *
+ * Placed after the API structure of the driver, the polled I/O functions
+ * of the UART API then call the driver functions instead of going through
+ * the API structure. A second driver doing the same fails the link.
+ *
+ * @param api API structure of the driver.
+ * @param poll_in_fn Polled input function of the driver.
+ * @param poll_out_fn Polled output function of the driver.
+ */
+#define UART_DIRECT_API_DEFINE(api, poll_in_fn, poll_out_fn)		\
+	extern const struct uart_driver_api _uart_direct_api ALIAS_OF(api); \
+	int _uart_direct_poll_in(struct device *dev, unsigned char *p_char) \
+		ALIAS_OF(poll_in_fn);					\
+	unsigned char _uart_direct_poll_out(struct device *dev,		\
+					    unsigned char out_char)	\
+		ALIAS_OF(poll_out_fn)
+
+#define _UART_DIRECT_CHECK(dev)						\
+	__ASSERT((dev)->driver_api == &_uart_direct_api,		\
+		 "%s is not handled by the direct UART driver",		\
+		 (dev)->config->name)
+#else
+#define UART_DIRECT_API_DEFINE(api, poll_in_fn, poll_out_fn)
+#endif /* CONFIG_UART_DIRECT_API */
+
 /**
  * @brief Check whether an error was detected.
  *
@@ -207,9 +354,26 @@ static inline int uart_err_check(struct device *dev)
  */
 static inline int uart_poll_in(struct device *dev, unsigned char *p_char)
 {
+#ifndef CONFIG_UART_DIRECT_API
 	const struct uart_driver_api *api = dev->driver_api;
+#endif
+	int ret;
+
+	ret = device_runtime_pm_get(dev);
+	if (ret) {
+		return ret;
+	}
+
+#ifdef CONFIG_UART_DIRECT_API
+	_UART_DIRECT_CHECK(dev);
+	ret = _uart_direct_poll_in(dev, p_char);
+#else
+	ret = api->poll_in(dev, p_char);
+#endif
 
-	return api->poll_in(dev, p_char);
+	device_runtime_pm_put(dev);
+
+	return ret;
 }
 
 /**
@@ -230,9 +394,25 @@ static inline int uart_poll_in(struct device *dev, unsigned char *p_char)
 static inline unsigned char uart_poll_out(struct device *dev,
 					  unsigned char out_char)
 {
+#ifndef CONFIG_UART_DIRECT_API
 	const struct uart_driver_api *api = dev->driver_api;
+#endif
+
+	/* Not sent, there is no way to report it */
+	if (device_runtime_pm_get(dev)) {
+		return out_char;
+	}
+
+#ifdef CONFIG_UART_DIRECT_API
+	_UART_DIRECT_CHECK(dev);
+	out_char = _uart_direct_poll_out(dev, out_char);
+#else
+	out_char = api->poll_out(dev, out_char);
+#endif
 
-	return api->poll_out(dev, out_char);
+	device_runtime_pm_put(dev);
+
+	return out_char;
 }
 
 
@@ -493,6 +673,162 @@ static inline void uart_irq_callback_set(struct device *dev,
 
 #endif
 
+#ifdef CONFIG_UART_ASYNC_API
+
+/**
+ * @brief Set the callback of the asynchronous API.
+ *
+ * The first call switches the device to the asynchronous API, it cannot be
+ * used through the interrupt driven API afterwards.
+ *
+ * @param dev UART device structure.
+ * @param cb Callback the events are reported to.
+ * @param user_data Pointer passed to the callback.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_callback_set(struct device *dev, uart_callback_t cb,
+				    void *user_data)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->callback_set) {
+		return api->callback_set(dev, cb, user_data);
+	}
+
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Send a buffer asynchronously.
+ *
+ * The buffer is sent by DMA, UART_TX_DONE is reported once it is. It must
+ * stay valid until then.
+ *
+ * @param dev UART device structure.
+ * @param buf Data to transmit.
+ * @param len Number of bytes to send.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If a transmission is ongoing.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_tx(struct device *dev, const uint8_t *buf, size_t len)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->tx) {
+		return api->tx(dev, buf, len);
+	}
+
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Abort the ongoing transmission.
+ *
+ * UART_TX_ABORTED is reported with the number of bytes sent.
+ *
+ * @param dev UART device structure.
+ *
+ * @retval 0 If successful.
+ * @retval -EFAULT If there is no transmission ongoing.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_tx_abort(struct device *dev)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->tx_abort) {
+		return api->tx_abort(dev);
+	}
+
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Start receiving asynchronously.
+ *
+ * The data is received by DMA into the buffer. UART_RX_BUF_REQUEST asks for
+ * the next buffer right away, for the reception to go on without a gap once
+ * the first one is full.
+ *
+ * @param dev UART device structure.
+ * @param buf First buffer to receive into.
+ * @param len Size of the buffer.
+ * @param timeout Time in milliseconds the line has to be idle for the data
+ *  received to be reported before the buffer is full, 0 to only report full
+ *  buffers. Drivers detecting idle lines in hardware report them after a
+ *  character time whatever the value.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If the reception is already enabled.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_rx_enable(struct device *dev, uint8_t *buf, size_t len,
+				 uint32_t timeout)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->rx_enable) {
+		return api->rx_enable(dev, buf, len, timeout);
+	}
+
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Give the buffer asked for by UART_RX_BUF_REQUEST.
+ *
+ * Meant to be called from the callback.
+ *
+ * @param dev UART device structure.
+ * @param buf Next buffer to receive into.
+ * @param len Size of the buffer.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If the next buffer is already set.
+ * @retval -EACCES If the reception is not enabled.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_rx_buf_rsp(struct device *dev, uint8_t *buf,
+				  size_t len)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->rx_buf_rsp) {
+		return api->rx_buf_rsp(dev, buf, len);
+	}
+
+	return -ENOTSUP;
+}
+
+/**
+ * @brief Stop receiving asynchronously.
+ *
+ * The data received so far is reported, then the buffers are released and
+ * UART_RX_DISABLED is reported.
+ *
+ * @param dev UART device structure.
+ *
+ * @retval 0 If successful.
+ * @retval -EFAULT If the reception is not enabled.
+ * @retval -ENOTSUP If the asynchronous API is not supported by the device.
+ */
+static inline int uart_rx_disable(struct device *dev)
+{
+	const struct uart_driver_api *api = dev->driver_api;
+
+	if (api->rx_disable) {
+		return api->rx_disable(dev);
+	}
+
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_UART_ASYNC_API */
+
 #ifdef CONFIG_UART_LINE_CTRL
 
 /**
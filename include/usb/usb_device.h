@@ -297,4 +297,68 @@ int usb_ep_read_wait(uint8_t ep, uint8_t *data, uint32_t max_data_len,
  */
 int usb_ep_read_continue(uint8_t ep);
 
+#ifdef CONFIG_USB_TRANSFER_QUEUE
+#include <net/buf.h>
+
+/**
+ * Callback function signature for the completion of a queued transfer
+ *
+ * The callback gets the reference to the buffer given to
+ * usb_transfer_queue(). It is called from the endpoint interrupt, or from
+ * usb_transfer_cancel().
+ *
+ * @param ep     Endpoint address of the transfer
+ * @param buf    Buffer of the transfer, holding the data received for an
+ *               OUT endpoint
+ * @param status 0 on success, -ECANCELED if the transfer was cancelled,
+ *               other negative errno code on fail
+ */
+typedef void (*usb_transfer_callback)(uint8_t ep, struct net_buf *buf,
+				      int status);
+
+/**
+ * @brief Queue a transfer on the specified endpoint
+ *
+ * For an IN endpoint the data of the buffer is sent, a buffer with no
+ * data sending a zero length packet. For an OUT endpoint data is received
+ * at the tail of the buffer, until a short packet is received or there is
+ * no room left for a max packet size one. Transfers complete in the order
+ * they were queued, the next one being started right away so that the
+ * controller does not idle between them.
+ *
+ * The endpoint must have usb_transfer_ep_callback() as callback in the
+ * device configuration. The pool of the buffer must have room for a
+ * usb_transfer_callback in its user data.
+ *
+ * @param[in]  ep   Endpoint address corresponding to the one listed in the
+ *                  device configuration table
+ * @param[in]  buf  Buffer of the transfer. The reference is given to the
+ *                  callback once the transfer is complete.
+ * @param[in]  cb   Completion callback, NULL to just unref the buffer
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int usb_transfer_queue(uint8_t ep, struct net_buf *buf,
+		       usb_transfer_callback cb);
+
+/**
+ * @brief Cancel the transfers queued on the specified endpoint
+ *
+ * The callbacks of the transfers are called with -ECANCELED.
+ *
+ * @param[in]  ep   Endpoint address corresponding to the one listed in the
+ *                  device configuration table
+ */
+void usb_transfer_cancel(uint8_t ep);
+
+/**
+ * @brief Endpoint callback for endpoints with queued transfers
+ *
+ * To be used as usb_ep_callback of the endpoints usb_transfer_queue()
+ * is used on.
+ */
+void usb_transfer_ep_callback(uint8_t ep,
+			      enum usb_dc_ep_cb_status_code cb_status);
+#endif /* CONFIG_USB_TRANSFER_QUEUE */
+
 #endif /* USB_DEVICE_H_ */
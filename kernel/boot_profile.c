@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <misc/printk.h>
+#include <misc/boot_profile.h>
+
+extern uint64_t __start_tsc;
+
+static struct boot_profile_entry entries[CONFIG_BOOT_TIME_PROFILE_ENTRIES];
+static int num_entries;
+static int num_dropped;
+
+static const char * const level_names[] = {
+	[_SYS_INIT_LEVEL_PRE_KERNEL_1] = "PRE_KERNEL_1",
+	[_SYS_INIT_LEVEL_PRE_KERNEL_2] = "PRE_KERNEL_2",
+	[_SYS_INIT_LEVEL_POST_KERNEL] = "POST_KERNEL",
+	[_SYS_INIT_LEVEL_APPLICATION] = "APPLICATION",
+	[_SYS_INIT_LEVEL_PRIMARY] = "PRIMARY",
+	[_SYS_INIT_LEVEL_SECONDARY] = "SECONDARY",
+	[_SYS_INIT_LEVEL_NANOKERNEL] = "NANOKERNEL",
+	[_SYS_INIT_LEVEL_MICROKERNEL] = "MICROKERNEL",
+};
+
+void _boot_profile_record(const char *phase, struct device *dev, int level,
+			  uint64_t start, uint64_t end)
+{
+	struct boot_profile_entry *entry;
+	unsigned int key;
+
+	/* devices initialized asynchronously are recorded concurrently */
+	key = irq_lock();
+
+	if (num_entries == CONFIG_BOOT_TIME_PROFILE_ENTRIES) {
+		num_dropped++;
+		irq_unlock(key);
+		return;
+	}
+
+	entry = &entries[num_entries++];
+
+	irq_unlock(key);
+
+	entry->phase = phase;
+	entry->dev = dev;
+	entry->level = level;
+	entry->start = start;
+	entry->cycles = (uint32_t)(end - start);
+}
+
+int boot_profile_get(struct boot_profile_entry **list)
+{
+	*list = entries;
+
+	return num_entries;
+}
+
+/* Slowest first, the entries are a few dozens at most */
+static void sort_entries(void)
+{
+	struct boot_profile_entry entry;
+	int i, j;
+
+	for (i = 1; i < num_entries; i++) {
+		entry = entries[i];
+		for (j = i; j > 0 && entries[j - 1].cycles < entry.cycles;
+		     j--) {
+			entries[j] = entries[j - 1];
+		}
+		entries[j] = entry;
+	}
+}
+
+static void print_entry(struct boot_profile_entry *entry, uint32_t total)
+{
+	uint32_t us = entry->cycles / CONFIG_CPU_CLOCK_FREQ_MHZ;
+	uint32_t permille = 0;
+
+	if (total) {
+		permille = (uint32_t)(((uint64_t)entry->cycles * 1000) / total);
+	}
+
+	printk("%10u %8u %3u.%u%%  ", entry->cycles, us, permille / 10,
+	       permille % 10);
+
+	if (entry->phase) {
+		printk("kernel: %s\n", entry->phase);
+	} else if (entry->dev->config->name[0]) {
+		printk("%s: %s\n", level_names[entry->level],
+		       entry->dev->config->name);
+	} else {
+		printk("%s: SYS_INIT %p\n", level_names[entry->level],
+		       entry->dev->config->init);
+	}
+}
+
+void boot_profile_report(void)
+{
+	uint32_t total = (uint32_t)(_tsc_read() - __start_tsc);
+	int i;
+
+	sort_entries();
+
+	printk("Boot profile, %u cycles since the kernel start:\n", total);
+	printk("    cycles       us   share  level: name\n");
+
+	for (i = 0; i < num_entries; i++) {
+		print_entry(&entries[i], total);
+	}
+
+	if (num_dropped) {
+		printk("%d entries dropped, CONFIG_BOOT_TIME_PROFILE_ENTRIES "
+		       "is too small\n", num_dropped);
+	}
+}
@@ -7,8 +7,24 @@
 #include <errno.h>
 #include <string.h>
 #include <device.h>
+#include <init.h>
 #include <misc/util.h>
 #include <atomic.h>
+#include <toolchain.h>
+
+#if defined(CONFIG_DEVICE_INIT_ASYNC) || defined(CONFIG_DEVICE_RUNTIME_PM) || \
+	defined(CONFIG_BOOT_TIME_PROFILE)
+#include <kernel.h>
+#endif
+
+#ifdef CONFIG_BOOT_TIME_PROFILE
+#include <misc/boot_profile.h>
+#endif
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+#include <ksched.h>
+#include <wait_q.h>
+#endif
 
 extern struct device __device_init_start[];
 extern struct device __device_PRE_KERNEL_1_start[];
@@ -40,6 +56,32 @@ static struct device *config_levels[] = {
 	__device_init_end,
 };
 
+#ifdef CONFIG_BOOT_TIME_PROFILE
+static int device_level(struct device *dev)
+{
+	int level = 0;
+
+	while (dev >= config_levels[level + 1]) {
+		level++;
+	}
+
+	return level;
+}
+
+static void device_do_init(struct device *dev)
+{
+	uint64_t start = _tsc_read();
+
+	dev->config->init(dev);
+	_boot_profile_record(NULL, dev, device_level(dev), start, _tsc_read());
+}
+#else
+static inline void device_do_init(struct device *dev)
+{
+	dev->config->init(dev);
+}
+#endif /* CONFIG_BOOT_TIME_PROFILE */
+
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 struct device_pm_ops device_pm_ops_nop = {device_pm_nop, device_pm_nop};
 extern uint32_t __device_busy_start[];
@@ -47,6 +89,352 @@ extern uint32_t __device_busy_end[];
 #define DEVICE_BUSY_SIZE (__device_busy_end - __device_busy_start)
 #endif
 
+#ifdef CONFIG_DEVICE_NAME_HASH
+
+#define NAME_HASH_MASK (CONFIG_DEVICE_NAME_HASH_SIZE - 1)
+
+BUILD_ASSERT((CONFIG_DEVICE_NAME_HASH_SIZE & NAME_HASH_MASK) == 0);
+
+/*
+ * Open addressing hash table of the devices, indexed by the hash of their
+ * name, with linear probing. The hash of the name is kept along with the
+ * device so that probing only compares the names that are likely to match.
+ */
+static struct {
+	struct device *device;
+	uint32_t hash;
+} name_hash[CONFIG_DEVICE_NAME_HASH_SIZE];
+
+static int name_hash_ready;
+static int name_hash_overflow;
+
+/* FNV-1a */
+static uint32_t name_hash_get(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name) {
+		hash = (hash ^ (uint8_t)*name++) * 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Devices are inserted in the order device_get_binding() used to look them
+ * up in, so that the first usable device of a given name is still the one
+ * found if names are duplicated.
+ */
+static void name_hash_build(void)
+{
+	struct device *info;
+	int used = 0;
+
+	for (info = __device_init_start; info != __device_init_end; info++) {
+		uint32_t hash = name_hash_get(info->config->name);
+		int slot = hash & NAME_HASH_MASK;
+
+		if (used == CONFIG_DEVICE_NAME_HASH_SIZE) {
+			name_hash_overflow = 1;
+			break;
+		}
+
+		while (name_hash[slot].device) {
+			slot = (slot + 1) & NAME_HASH_MASK;
+		}
+
+		name_hash[slot].device = info;
+		name_hash[slot].hash = hash;
+		used++;
+	}
+
+	name_hash_ready = 1;
+}
+
+static struct device *name_hash_lookup(const char *name, int *found_all)
+{
+	uint32_t hash = name_hash_get(name);
+	int slot = hash & NAME_HASH_MASK;
+	int probes;
+
+	for (probes = 0; probes < CONFIG_DEVICE_NAME_HASH_SIZE; probes++) {
+		struct device *info = name_hash[slot].device;
+
+		if (!info) {
+			break;
+		}
+
+		if (name_hash[slot].hash == hash && info->driver_api &&
+		    !strcmp(name, info->config->name)) {
+			return info;
+		}
+
+		slot = (slot + 1) & NAME_HASH_MASK;
+	}
+
+	*found_all = !name_hash_overflow;
+	return NULL;
+}
+#endif /* CONFIG_DEVICE_NAME_HASH */
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+
+extern struct device_async __device_async_start[];
+extern struct device_async __device_async_end[];
+
+#define ASYNC_PENDING 0
+#define ASYNC_RUNNING 1
+#define ASYNC_DONE 2
+
+static char __noinit __stack
+	async_stacks[CONFIG_DEVICE_INIT_ASYNC_THREADS]
+		    [CONFIG_DEVICE_INIT_ASYNC_STACK_SIZE];
+static k_tid_t async_threads[CONFIG_DEVICE_INIT_ASYNC_THREADS];
+
+/* asynchronous devices that can be picked up by the threads */
+static struct k_sem async_work;
+static struct device *async_level_start;
+static struct device *async_level_cursor;
+
+/* threads waiting for the initialization of a device to complete */
+static _wait_q_t async_wait_q = _WAIT_Q_INIT(&async_wait_q);
+
+static int async_multithreaded;
+static atomic_t async_done;
+
+static struct device_async *async_get(struct device *dev)
+{
+	struct device_async *async;
+
+	for (async = __device_async_start; async != __device_async_end;
+	     async++) {
+		if (async->device == dev) {
+			return async;
+		}
+	}
+
+	return NULL;
+}
+
+static struct device *device_find(const char *name)
+{
+	struct device *info;
+
+	for (info = __device_init_start; info != __device_init_end; info++) {
+		if (!strcmp(name, info->config->name)) {
+			return info;
+		}
+	}
+
+	return NULL;
+}
+
+static int async_wait(struct device *dev);
+
+/* must be called by the one thread that moved async to ASYNC_RUNNING */
+static void async_run(struct device_async *async)
+{
+	struct k_thread *thread;
+	int key;
+	int i;
+
+	for (i = 0; i < async->num_deps; i++) {
+		struct device *dep = device_find(async->deps[i]);
+
+		__ASSERT(dep, "%s depends on unknown device %s",
+			 async->device->config->name, async->deps[i]);
+
+		if (dep) {
+			async_wait(dep);
+		}
+	}
+
+	device_do_init(async->device);
+
+	key = irq_lock();
+
+	atomic_set(&async->state, ASYNC_DONE);
+	atomic_inc(&async_done);
+
+	while ((thread = _unpend_first_thread(&async_wait_q)) != NULL) {
+		_ready_thread(thread);
+	}
+
+	if (async_multithreaded && !_is_in_isr()) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
+/*
+ * Make sure a device is initialized, initializing it in the caller's context
+ * if nobody has started to, or waiting for it to be otherwise.
+ *
+ * Returns 0 if the device is still being initialized and the caller cannot
+ * wait, 1 otherwise.
+ */
+static int async_wait(struct device *dev)
+{
+	struct device_async *async = async_get(dev);
+	int key;
+
+	if (!async) {
+		/* initialized in order */
+		return 1;
+	}
+
+	if (atomic_cas(&async->state, ASYNC_PENDING, ASYNC_RUNNING)) {
+		async_run(async);
+		return 1;
+	}
+
+	if (!async_multithreaded || _is_in_isr()) {
+		return atomic_get(&async->state) == ASYNC_DONE;
+	}
+
+	key = irq_lock();
+
+	while (atomic_get(&async->state) != ASYNC_DONE) {
+		_pend_current_thread(&async_wait_q, K_FOREVER);
+		_Swap(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	return 1;
+}
+
+static int async_wait_name(const char *name)
+{
+	struct device_async *async;
+
+	if (atomic_get(&async_done) == __device_async_end - __device_async_start) {
+		return 1;
+	}
+
+	for (async = __device_async_start; async != __device_async_end;
+	     async++) {
+		if (!strcmp(name, async->device->config->name) &&
+		    !async_wait(async->device)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void async_thread_main(void *unused1, void *unused2, void *unused3)
+{
+	struct device_async *async;
+
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+	ARG_UNUSED(unused3);
+
+	while (1) {
+		k_sem_take(&async_work, K_FOREVER);
+
+		for (async = __device_async_start;
+		     async != __device_async_end; async++) {
+			if (async->device < async_level_start ||
+			    async->device >= async_level_cursor ||
+			    (async->flags & DEVICE_INIT_DEFERRED)) {
+				continue;
+			}
+
+			if (atomic_cas(&async->state, ASYNC_PENDING,
+				       ASYNC_RUNNING)) {
+				async_run(async);
+				break;
+			}
+		}
+	}
+}
+
+static void async_level_begin(int level)
+{
+	int i;
+
+	async_level_start = config_levels[level];
+	async_level_cursor = config_levels[level];
+
+	if (level == _SYS_INIT_LEVEL_PRE_KERNEL_1 ||
+	    level == _SYS_INIT_LEVEL_PRE_KERNEL_2 ||
+	    level == _SYS_INIT_LEVEL_PRIMARY || async_multithreaded) {
+		return;
+	}
+
+	async_multithreaded = 1;
+	k_sem_init(&async_work, 0, UINT_MAX);
+
+	for (i = 0; i < CONFIG_DEVICE_INIT_ASYNC_THREADS; i++) {
+		async_threads[i] =
+			k_thread_spawn(async_stacks[i],
+				       CONFIG_DEVICE_INIT_ASYNC_STACK_SIZE,
+				       async_thread_main, NULL, NULL, NULL,
+				       CONFIG_MAIN_THREAD_PRIORITY, 0, 0);
+	}
+}
+
+/*
+ * Hand an asynchronous device over to the threads, or initialize it right
+ * away before the kernel is up. Returns 0 if the device is not asynchronous.
+ */
+static int async_dispatch(struct device *info)
+{
+	struct device_async *async = async_get(info);
+
+	if (!async) {
+		return 0;
+	}
+
+	if (async->flags & DEVICE_INIT_DEFERRED) {
+		return 1;
+	}
+
+	if (!async_multithreaded) {
+		async_wait(info);
+		return 1;
+	}
+
+	async_level_cursor = info + 1;
+	k_sem_give(&async_work);
+
+	return 1;
+}
+
+static void async_level_end(int level)
+{
+	struct device *info;
+	int i;
+
+	if (!async_multithreaded) {
+		return;
+	}
+
+	/* help with, then wait for, the devices of the level not done yet */
+	for (info = config_levels[level]; info < config_levels[level+1];
+	     info++) {
+		struct device_async *async = async_get(info);
+
+		if (async && !(async->flags & DEVICE_INIT_DEFERRED)) {
+			async_wait(info);
+		}
+	}
+
+	if (level != _SYS_INIT_LEVEL_APPLICATION) {
+		return;
+	}
+
+	/* last level: no more use for the threads */
+	for (i = 0; i < CONFIG_DEVICE_INIT_ASYNC_THREADS; i++) {
+		k_thread_abort(async_threads[i]);
+	}
+}
+#endif /* CONFIG_DEVICE_INIT_ASYNC */
+
 /**
  * @brief Execute all the device initialization functions at a given level
  *
@@ -62,17 +450,52 @@ void _sys_device_do_config_level(int level)
 {
 	struct device *info;
 
-	for (info = config_levels[level]; info < config_levels[level+1]; info++) {
-		struct device_config *device = info->config;
+#ifdef CONFIG_DEVICE_NAME_HASH
+	if (!name_hash_ready) {
+		/* before any device gets initialized and looks another up */
+		name_hash_build();
+	}
+#endif
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	async_level_begin(level);
+#endif
 
-		device->init(info);
+	for (info = config_levels[level]; info < config_levels[level+1]; info++) {
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+		if (async_dispatch(info)) {
+			continue;
+		}
+#endif
+		device_do_init(info);
 	}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	async_level_end(level);
+#endif
 }
 
 struct device *device_get_binding(const char *name)
 {
 	struct device *info;
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	if (!async_wait_name(name)) {
+		return NULL;
+	}
+#endif
+
+#ifdef CONFIG_DEVICE_NAME_HASH
+	if (name_hash_ready) {
+		int found_all = 0;
+
+		info = name_hash_lookup(name, &found_all);
+		if (info || found_all) {
+			return info;
+		}
+	}
+#endif
+
 	for (info = __device_init_start; info != __device_init_end; info++) {
 		if (info->driver_api && !strcmp(name, info->config->name)) {
 			return info;
@@ -125,6 +548,106 @@ int device_busy_check(struct device *chk_dev)
 
 #endif
 
+#ifdef CONFIG_DEVICE_RUNTIME_PM
+/* Called with interrupts locked */
+static void runtime_pm_suspend(struct device *dev)
+{
+	struct device_runtime_pm *pm = dev->pm;
+
+	if (pm->usage || pm->suspended) {
+		return;
+	}
+
+	if (!device_set_power_state(dev, DEVICE_PM_SUSPEND_STATE)) {
+		pm->suspended = true;
+	}
+}
+
+static void runtime_pm_work(struct k_work *work)
+{
+	struct device_runtime_pm *pm =
+		CONTAINER_OF(work, struct device_runtime_pm, work);
+	unsigned int key = irq_lock();
+
+	/* used again since the work was submitted, if so left active */
+	runtime_pm_suspend(pm->dev);
+
+	irq_unlock(key);
+}
+
+void device_runtime_pm_enable(struct device *dev,
+			      struct device_runtime_pm *pm,
+			      int32_t autosuspend_ms)
+{
+	pm->dev = dev;
+	pm->usage = 0;
+	pm->autosuspend_ms = autosuspend_ms;
+	pm->suspended = false;
+	k_delayed_work_init(&pm->work, runtime_pm_work);
+
+	dev->pm = pm;
+}
+
+void device_runtime_pm_autosuspend_set(struct device *dev,
+				       int32_t autosuspend_ms)
+{
+	dev->pm->autosuspend_ms = autosuspend_ms;
+}
+
+int _device_runtime_pm_get(struct device *dev)
+{
+	struct device_runtime_pm *pm = dev->pm;
+	unsigned int key = irq_lock();
+	int ret = 0;
+
+	if (pm->usage++) {
+		goto out;
+	}
+
+	k_delayed_work_cancel(&pm->work);
+	device_busy_set(dev);
+
+	if (pm->suspended) {
+		ret = device_set_power_state(dev, DEVICE_PM_ACTIVE_STATE);
+		if (ret) {
+			pm->usage--;
+			device_busy_clear(dev);
+			goto out;
+		}
+
+		pm->suspended = false;
+	}
+
+out:
+	irq_unlock(key);
+
+	return ret;
+}
+
+void _device_runtime_pm_put(struct device *dev)
+{
+	struct device_runtime_pm *pm = dev->pm;
+	unsigned int key = irq_lock();
+
+	__ASSERT(pm->usage > 0, "unbalanced put of %s", dev->config->name);
+
+	if (--pm->usage) {
+		goto out;
+	}
+
+	device_busy_clear(dev);
+
+	if (pm->autosuspend_ms == 0) {
+		runtime_pm_suspend(dev);
+	} else if (pm->autosuspend_ms != K_FOREVER) {
+		k_delayed_work_submit(&pm->work, pm->autosuspend_ms);
+	}
+
+out:
+	irq_unlock(key);
+}
+#endif /* CONFIG_DEVICE_RUNTIME_PM */
+
 void device_busy_set(struct device *busy_dev)
 {
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
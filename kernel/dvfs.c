@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Dynamic voltage and frequency scaling
+ *
+ * The SoC offers the rates the CPU clock can run at, the operating points,
+ * and the clock controller changes the rate, scaling the supply voltage
+ * along. The drivers whose timings derive from the clock are notified
+ * before and after each change. Without requests holding it up, the
+ * governor lowers the operating point one step at a time while the CPU is
+ * mostly idle, and jumps to the fastest one once it is loaded.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <init.h>
+#include <errno.h>
+#include <misc/dlist.h>
+#include <misc/slist.h>
+#include <clock_control.h>
+#include <power.h>
+
+/* Changes are made from threads only, the notifiers may sleep */
+static K_MUTEX_DEFINE(dvfs_mutex);
+
+static struct device *dvfs_clock;
+static clock_control_subsys_t dvfs_sys;
+static const struct sys_dvfs_opp *dvfs_opps;
+static int dvfs_opp_count;
+static int dvfs_opp;
+
+static sys_slist_t dvfs_notifiers;
+static sys_dlist_t dvfs_requests = SYS_DLIST_STATIC_INIT(&dvfs_requests);
+static int dvfs_min_opp;
+
+static void notify(enum sys_dvfs_event event, uint32_t rate)
+{
+	struct sys_dvfs_notifier *notifier;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&dvfs_notifiers, notifier, node) {
+		notifier->cb(notifier, event, rate);
+	}
+}
+
+/* Called with the mutex held */
+static int opp_change(int opp)
+{
+	uint32_t rate;
+	int ret;
+
+	if (opp < dvfs_min_opp) {
+		opp = dvfs_min_opp;
+	}
+
+	if (opp == dvfs_opp) {
+		return 0;
+	}
+
+	rate = dvfs_opps[opp].rate;
+
+	notify(SYS_DVFS_PRE_CHANGE, rate);
+
+	ret = clock_control_set_rate(dvfs_clock, dvfs_sys, rate);
+	if (ret) {
+		/* Still running at the old rate, for the drivers to restore */
+		notify(SYS_DVFS_POST_CHANGE, dvfs_opps[dvfs_opp].rate);
+		return ret;
+	}
+
+	dvfs_opp = opp;
+	notify(SYS_DVFS_POST_CHANGE, rate);
+
+	return 0;
+}
+
+void sys_dvfs_opps_set(struct device *clock, clock_control_subsys_t sys,
+		       const struct sys_dvfs_opp *opps, int count)
+{
+	/* Called from the SoC init, before the kernel runs threads */
+	unsigned int key = irq_lock();
+
+	dvfs_clock = clock;
+	dvfs_sys = sys;
+	dvfs_opps = opps;
+	dvfs_opp_count = count;
+	dvfs_opp = count - 1;
+
+	irq_unlock(key);
+}
+
+int sys_dvfs_opp_set(int opp)
+{
+	int ret;
+
+	k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+	if (opp < 0 || opp >= dvfs_opp_count) {
+		ret = -EINVAL;
+	} else {
+		ret = opp_change(opp);
+	}
+
+	k_mutex_unlock(&dvfs_mutex);
+
+	return ret;
+}
+
+int sys_dvfs_opp_get(void)
+{
+	return dvfs_opp;
+}
+
+void sys_dvfs_notifier_register(struct sys_dvfs_notifier *notifier)
+{
+	/* Allowed before the kernel runs threads, for the drivers to
+	 * register from their init function
+	 */
+	unsigned int key = irq_lock();
+
+	sys_slist_append(&dvfs_notifiers, &notifier->node);
+
+	irq_unlock(key);
+}
+
+void sys_dvfs_notifier_unregister(struct sys_dvfs_notifier *notifier)
+{
+	unsigned int key;
+
+	k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+	key = irq_lock();
+	sys_slist_find_and_remove(&dvfs_notifiers, &notifier->node);
+	irq_unlock(key);
+
+	k_mutex_unlock(&dvfs_mutex);
+}
+
+/* Called with the mutex held */
+static void requests_update(void)
+{
+	struct sys_dvfs_request *req;
+	int min_opp = 0;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&dvfs_requests, req, node) {
+		if (req->min_opp > min_opp) {
+			min_opp = req->min_opp;
+		}
+	}
+
+	dvfs_min_opp = min_opp < dvfs_opp_count ? min_opp :
+		       dvfs_opp_count - 1;
+
+	if (dvfs_opp_count && dvfs_opp < dvfs_min_opp) {
+		opp_change(dvfs_min_opp);
+	}
+}
+
+void sys_dvfs_request_add(struct sys_dvfs_request *req, int min_opp)
+{
+	k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+	req->min_opp = min_opp;
+	sys_dlist_append(&dvfs_requests, &req->node);
+	requests_update();
+
+	k_mutex_unlock(&dvfs_mutex);
+}
+
+void sys_dvfs_request_update(struct sys_dvfs_request *req, int min_opp)
+{
+	k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+	req->min_opp = min_opp;
+	requests_update();
+
+	k_mutex_unlock(&dvfs_mutex);
+}
+
+void sys_dvfs_request_remove(struct sys_dvfs_request *req)
+{
+	k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+	sys_dlist_remove(&req->node);
+	requests_update();
+
+	k_mutex_unlock(&dvfs_mutex);
+}
+
+#ifdef CONFIG_SYS_DVFS_GOVERNOR
+
+static struct k_delayed_work governor_work;
+
+/* Cycles of the whole system and of the idle threads at the last sample */
+static uint64_t governor_total;
+static uint64_t governor_idle;
+
+static uint64_t idle_cycles(void)
+{
+	struct k_thread_runtime_stats stats;
+	uint64_t cycles = 0;
+#ifdef CONFIG_SMP
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(_kernel.cpus); i++) {
+		if (_kernel.cpus[i].idle_thread &&
+		    !k_thread_runtime_stats_get(_kernel.cpus[i].idle_thread,
+						&stats)) {
+			cycles += stats.execution_cycles;
+		}
+	}
+#else
+	if (!k_thread_runtime_stats_get(_idle_thread, &stats)) {
+		cycles = stats.execution_cycles;
+	}
+#endif
+
+	return cycles;
+}
+
+static void governor_sample(struct k_work *work)
+{
+	struct k_thread_runtime_stats stats;
+	uint64_t total, idle;
+	uint32_t load;
+
+	k_thread_runtime_stats_all_get(&stats);
+	total = stats.execution_cycles - governor_total;
+	idle = idle_cycles() - governor_idle;
+
+	governor_total += total;
+	governor_idle += idle;
+
+	/* The cycle counter may run off the CPU clock, its rate changing
+	 * along, the load is taken relative to the cycles of the period
+	 */
+	if (dvfs_opp_count > 1 && total && idle <= total) {
+		load = (total - idle) * 100 / total;
+
+		k_mutex_lock(&dvfs_mutex, K_FOREVER);
+
+		if (load >= CONFIG_SYS_DVFS_GOVERNOR_UP_THRESHOLD) {
+			opp_change(dvfs_opp_count - 1);
+		} else if (load <= CONFIG_SYS_DVFS_GOVERNOR_DOWN_THRESHOLD &&
+			   dvfs_opp > 0) {
+			opp_change(dvfs_opp - 1);
+		}
+
+		k_mutex_unlock(&dvfs_mutex);
+	}
+
+	k_delayed_work_submit(&governor_work,
+			      CONFIG_SYS_DVFS_GOVERNOR_PERIOD_MS);
+}
+
+static int dvfs_governor_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_delayed_work_init(&governor_work, governor_sample);
+	k_delayed_work_submit(&governor_work,
+			      CONFIG_SYS_DVFS_GOVERNOR_PERIOD_MS);
+
+	return 0;
+}
+
+SYS_INIT(dvfs_governor_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif /* CONFIG_SYS_DVFS_GOVERNOR */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief High-resolution timeouts
+ *
+ * The timeouts are kept in deadline order, the system timer driver being
+ * programmed for the first one. Its interrupt expires every timeout whose
+ * deadline passed, and programs the driver for the next one.
+ */
+
+#include <kernel.h>
+#include <errno.h>
+#include <misc/dlist.h>
+#include <drivers/system_timer.h>
+
+static sys_dlist_t hires_q = SYS_DLIST_STATIC_INIT(&hires_q);
+
+static inline struct k_hires_timeout *hires_first(void)
+{
+	struct k_hires_timeout *first;
+
+	return SYS_DLIST_PEEK_HEAD_CONTAINER(&hires_q, first, node);
+}
+
+static void hires_program(void)
+{
+	struct k_hires_timeout *first = hires_first();
+
+	_timer_hires_deadline_set(first ? first->deadline : UINT64_MAX);
+}
+
+uint64_t k_cycle_get_64(void)
+{
+	return _timer_cycle_get_64();
+}
+
+void k_hires_timeout_init(struct k_hires_timeout *timeout,
+			  k_hires_timeout_handler_t handler)
+{
+	timeout->node.next = NULL;
+	timeout->handler = handler;
+}
+
+void k_hires_timeout_start(struct k_hires_timeout *timeout,
+			   uint64_t deadline)
+{
+	struct k_hires_timeout *next;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (timeout->node.next) {
+		sys_dlist_remove(&timeout->node);
+	}
+
+	timeout->deadline = deadline;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&hires_q, next, node) {
+		if (deadline < next->deadline) {
+			sys_dlist_insert_before(&hires_q, &next->node,
+						&timeout->node);
+			break;
+		}
+	}
+
+	if (!next) {
+		sys_dlist_append(&hires_q, &timeout->node);
+	}
+
+	if (hires_first() == timeout) {
+		hires_program();
+	}
+
+	irq_unlock(key);
+}
+
+int k_hires_timeout_abort(struct k_hires_timeout *timeout)
+{
+	unsigned int key;
+	bool first;
+
+	key = irq_lock();
+
+	if (!timeout->node.next) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	first = (hires_first() == timeout);
+	sys_dlist_remove(&timeout->node);
+	timeout->node.next = NULL;
+
+	/* not to wake the CPU up for nothing */
+	if (first) {
+		hires_program();
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+void _sys_clock_hires_announce(void)
+{
+	struct k_hires_timeout *timeout;
+	unsigned int key;
+
+	key = irq_lock();
+
+	/* The deadline may be matched early by a comparator narrower than 64
+	 * bits, the first timeout is then still pending and programmed again
+	 */
+	while ((timeout = hires_first()) &&
+	       timeout->deadline <= _timer_cycle_get_64()) {
+		sys_dlist_remove(&timeout->node);
+		timeout->node.next = NULL;
+
+		/* the handler may start the timeout again */
+		irq_unlock(key);
+		timeout->handler(timeout);
+		key = irq_lock();
+	}
+
+	hires_program();
+
+	irq_unlock(key);
+}
+
+struct hires_sleep {
+	struct k_hires_timeout timeout;
+	struct k_sem sem;
+};
+
+static void hires_sleep_expired(struct k_hires_timeout *timeout)
+{
+	struct hires_sleep *sleep = CONTAINER_OF(timeout, struct hires_sleep,
+						 timeout);
+
+	k_sem_give(&sleep->sem);
+}
+
+void k_sleep_until(uint64_t deadline)
+{
+	struct hires_sleep sleep;
+
+	k_sem_init(&sleep.sem, 0, 1);
+	k_hires_timeout_init(&sleep.timeout, hires_sleep_expired);
+	k_hires_timeout_start(&sleep.timeout, deadline);
+
+	k_sem_take(&sleep.sem, K_FOREVER);
+}
@@ -72,6 +72,7 @@ static void _sys_power_save_idle(int32_t ticks __unused)
 	defined(CONFIG_SYS_POWER_DEEP_SLEEP))
 
 	_sys_pm_idle_exit_notify = 1;
+	_sys_pm_governor_idle_enter(ticks);
 
 	/*
 	 * Call the suspend hook function of the soc interface to allow
@@ -90,6 +91,9 @@ static void _sys_power_save_idle(int32_t ticks __unused)
 		_sys_pm_idle_exit_notify = 0;
 		k_cpu_idle();
 	}
+
+	/* In case the wake up was not reported by the interrupt */
+	_sys_pm_governor_idle_exit();
 #else
 	k_cpu_idle();
 #endif
@@ -97,6 +101,8 @@ static void _sys_power_save_idle(int32_t ticks __unused)
 
 void _sys_power_save_idle_exit(int32_t ticks)
 {
+	_sys_pm_governor_idle_exit();
+
 #if defined(CONFIG_SYS_POWER_LOW_POWER_STATE)
 	/* Some CPU low power states require notification at the ISR
 	 * to allow any operations that needs to be done before kernel
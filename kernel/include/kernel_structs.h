@@ -106,6 +106,48 @@ struct _thread_base {
 	/* data returned by APIs */
 	void *swap_data;
 
+#if defined(CONFIG_WAITQ_BUCKETS) || defined(CONFIG_MBOX_MATCH_INDEX)
+	/* wait queue the thread is pending on */
+	_wait_q_t *pended_on;
+#endif
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	/* priority set for the thread, before inheritance */
+	int8_t pi_base_prio;
+
+	/* mutex the thread pends on */
+	struct k_mutex *pi_blocked_on;
+
+	/* owned mutexes with waiters, by priority of their first waiter */
+	sys_dlist_t pi_mutexes;
+#endif
+
+#ifdef CONFIG_SMP
+	/* nesting count of the global interrupt lock held by the thread */
+	uint8_t global_lock_count;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	/* CPUs the thread can run on, one bit per CPU */
+	uint8_t cpu_mask;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* hw cycles spent running the thread */
+	uint64_t runtime_cycles;
+#endif
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_COMPACT
+	/* compact ID in kernel events, 0 until the thread is first switched in */
+	uint8_t event_logger_id;
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+	/* absolute deadline in hw cycles, only valid if has_deadline is set */
+	uint32_t deadline;
+	uint8_t has_deadline;
+#endif
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 	/* this thread's entry in a timeout queue */
 	struct _timeout timeout;
@@ -115,6 +157,21 @@ struct _thread_base {
 
 typedef struct _thread_base _thread_base_t;
 
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+/* heap block size classes cached by magazines: 32, 64 and 128 bytes */
+#define _HEAP_MAGAZINE_NUM_CLASSES 3
+#define _HEAP_MAGAZINE_SIZE_MIN 32
+
+struct _heap_magazine {
+	/* number of cached blocks in each size class */
+	uint8_t count[_HEAP_MAGAZINE_NUM_CLASSES];
+
+	/* cached blocks, pointing to their hidden block descriptor */
+	struct k_mem_block *blocks[_HEAP_MAGAZINE_NUM_CLASSES]
+				  [CONFIG_HEAP_MEM_POOL_MAGAZINE_DEPTH];
+};
+#endif
+
 struct k_thread {
 
 	struct _thread_base base;
@@ -147,6 +204,16 @@ struct k_thread {
 	int errno_var;
 #endif
 
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+	/* recently freed heap blocks, for k_malloc() */
+	struct _heap_magazine heap_magazine;
+#endif
+
+#ifdef CONFIG_INIT_STACKS
+	/* size of the stack area, thread struct included, for usage analysis */
+	size_t stack_size;
+#endif
+
 	/* arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -167,7 +234,33 @@ struct _ready_q {
 
 typedef struct _ready_q _ready_q_t;
 
-struct _kernel {
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+#define _TIMEOUT_WHEEL_MASK (CONFIG_TIMEOUT_WHEEL_SLOTS - 1)
+#define _TIMEOUT_WHEEL_BMAP_WORDS ((CONFIG_TIMEOUT_WHEEL_SLOTS + 31) / 32)
+
+struct _timeout_wheel {
+
+	/* tick up to which the wheel has been advanced */
+	uint32_t curr_tick;
+
+	/* earliest expiry tick, only meaningful if next_expiry_valid */
+	uint32_t next_expiry;
+
+	/* number of timeouts currently in the wheel */
+	uint32_t num_active;
+
+	/* cleared when next_expiry has to be recomputed from the slots */
+	uint8_t next_expiry_valid;
+
+	/* bitmap of slots that contain at least one timeout */
+	uint32_t slot_bmap[_TIMEOUT_WHEEL_BMAP_WORDS];
+
+	/* timeouts, hashed by their expiry tick */
+	sys_dlist_t slots[CONFIG_TIMEOUT_WHEEL_SLOTS];
+};
+#endif
+
+struct _cpu {
 
 	/* nested interrupt count */
 	uint32_t nested;
@@ -178,7 +271,38 @@ struct _kernel {
 	/* currently scheduled thread */
 	struct k_thread *current;
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#ifdef CONFIG_SMP
+	/* idle thread of this CPU */
+	struct k_thread *idle_thread;
+
+	/* index of this CPU in _kernel.cpus[] */
+	uint8_t id;
+#endif
+};
+
+typedef struct _cpu _cpu_t;
+
+struct _kernel {
+
+#ifdef CONFIG_SMP
+	/* per-CPU state */
+	struct _cpu cpus[CONFIG_MP_NUM_CPUS];
+#else
+	/*
+	 * state of the only CPU, whose fields are also accessed directly in
+	 * _kernel by architecture code
+	 */
+	union {
+		struct _cpu cpus[1];
+		struct {
+			uint32_t nested;
+			char *irq_stack;
+			struct k_thread *current;
+		};
+	};
+#endif
+
+#if defined(CONFIG_SYS_CLOCK_EXISTS) && !defined(CONFIG_TIMEOUT_QUEUE_WHEEL)
 	/* queue of timeouts */
 	sys_dlist_t timeout_q;
 #endif
@@ -213,15 +337,31 @@ struct _kernel {
 
 	/* arch-specific part of _kernel */
 	struct _kernel_arch arch;
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	/*
+	 * wheel of timeouts: big, keep it last, so that it does not push
+	 * fields accessed from assembly beyond their offset encoding limits
+	 */
+	struct _timeout_wheel timeout_wheel;
+#endif
 };
 
 typedef struct _kernel _kernel_t;
 
 extern struct _kernel _kernel;
 
+#ifdef CONFIG_SMP
+/* _arch_curr_cpu() is provided by the architecture in kernel_arch_func.h */
+#define _current_cpu (_arch_curr_cpu())
+#define _current (_current_cpu->current)
+#else
+#define _current_cpu (&_kernel.cpus[0])
 #define _current _kernel.current
+#endif
 #define _ready_q _kernel.ready_q
 #define _timeout_q _kernel.timeout_q
+#define _timeout_wheel _kernel.timeout_wheel
 #define _threads _kernel.threads
 
 #include <kernel_arch_func.h>
@@ -239,6 +379,11 @@ extern void _init_thread_base(struct _thread_base *thread_base,
 			      int priority, uint32_t initial_state,
 			      unsigned int options);
 
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+extern void _heap_magazine_init(struct k_thread *thread);
+extern void _heap_magazine_abort(struct k_thread *thread);
+#endif
+
 #endif /* _ASMLANGUAGE */
 
 #endif /* _kernel_structs__h_ */
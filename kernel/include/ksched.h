@@ -26,11 +26,24 @@ extern int32_t _ms_to_ticks(int32_t ms);
 #endif
 extern void idle(void *, void *, void *);
 
+#ifdef CONFIG_SMP
+extern struct k_thread *_smp_next_ready_thread(void);
+#endif
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+extern void _mutex_pi_prio_set(struct k_thread *thread, int prio);
+#endif
+
 /* find which one is the next thread to run */
 /* must be called with interrupts locked */
 static ALWAYS_INLINE struct k_thread *_get_next_ready_thread(void)
 {
+#ifdef CONFIG_SMP
+	/* the cached thread may be running on another CPU */
+	return _smp_next_ready_thread();
+#else
 	return _ready_q.cache;
+#endif
 }
 
 static inline int _is_idle_thread(void *entry_point)
@@ -113,6 +126,27 @@ static inline int _is_t1_higher_prio_than_t2(struct k_thread *t1,
 	return _is_prio1_higher_than_prio2(t1->base.prio, t2->base.prio);
 }
 
+#ifdef CONFIG_SCHED_DEADLINE
+/*
+ * Is t1's deadline earlier than t2's ? Threads without a deadline come after
+ * those with one. Deadlines are compared on the difference of their cycle
+ * counts, which copes with the counter wrapping around.
+ */
+static inline int _is_t1_deadline_earlier_than_t2(struct k_thread *t1,
+						  struct k_thread *t2)
+{
+	if (!t1->base.has_deadline) {
+		return 0;
+	}
+
+	if (!t2->base.has_deadline) {
+		return 1;
+	}
+
+	return (int32_t)(t1->base.deadline - t2->base.deadline) < 0;
+}
+#endif
+
 static inline int _is_higher_prio_than_current(struct k_thread *thread)
 {
 	return _is_t1_higher_prio_than_t2(thread, _current);
@@ -418,6 +452,62 @@ static inline void _mark_thread_as_dead(struct k_thread *thread)
 	thread->base.thread_state |= _THREAD_DEAD;
 }
 
+#ifdef CONFIG_WAITQ_BUCKETS
+/*
+ * Insert a thread in a wait queue after the last thread of the same or the
+ * closest higher priority, found through the priority bitmap.
+ */
+static inline void _waitq_insert(_wait_q_t *wait_q, struct k_thread *thread)
+{
+	int q_index = _get_ready_q_q_index(thread->base.prio);
+	int bmap_index = q_index >> 5;
+	uint32_t prio_bit = _get_ready_q_prio_bit(thread->base.prio);
+	uint32_t bmap = wait_q->prio_bmap[bmap_index] & ((prio_bit << 1) - 1);
+	sys_dnode_t *insert_point = NULL;
+
+	for (;;) {
+		if (bmap) {
+			int prev = (find_msb_set(bmap) - 1) + (bmap_index << 5);
+
+			insert_point = wait_q->last[prev];
+			break;
+		}
+		if (--bmap_index < 0) {
+			break;
+		}
+		bmap = wait_q->prio_bmap[bmap_index];
+	}
+
+	sys_dlist_insert_after(&wait_q->waitq, insert_point,
+			       &thread->base.k_q_node);
+
+	wait_q->last[q_index] = &thread->base.k_q_node;
+	wait_q->prio_bmap[q_index >> 5] |= prio_bit;
+	thread->base.pended_on = wait_q;
+}
+
+static inline void _waitq_remove(struct k_thread *thread)
+{
+	_wait_q_t *wait_q = thread->base.pended_on;
+	int q_index = _get_ready_q_q_index(thread->base.prio);
+	sys_dnode_t *node = &thread->base.k_q_node;
+
+	if (wait_q->last[q_index] == node) {
+		struct k_thread *prev = (struct k_thread *)node->prev;
+
+		if (node->prev != &wait_q->waitq &&
+		    prev->base.prio == thread->base.prio) {
+			wait_q->last[q_index] = node->prev;
+		} else {
+			wait_q->prio_bmap[q_index >> 5] &=
+				~_get_ready_q_prio_bit(thread->base.prio);
+		}
+	}
+
+	sys_dlist_remove(node);
+}
+#endif
+
 /*
  * Set a thread's priority. If the thread is ready, place it in the correct
  * queue.
@@ -429,6 +519,13 @@ static inline void _thread_priority_set(struct k_thread *thread, int prio)
 		_remove_thread_from_ready_q(thread);
 		thread->base.prio = prio;
 		_add_thread_to_ready_q(thread);
+#ifdef CONFIG_WAITQ_BUCKETS
+	} else if (_is_thread_pending(thread)) {
+		/* keep the buckets of the wait queue consistent */
+		_waitq_remove(thread);
+		thread->base.prio = prio;
+		_waitq_insert(thread->base.pended_on, thread);
+#endif
 	} else {
 		thread->base.prio = prio;
 	}
@@ -437,7 +534,7 @@ static inline void _thread_priority_set(struct k_thread *thread, int prio)
 /* check if thread is a thread pending on a particular wait queue */
 static inline struct k_thread *_peek_first_pending_thread(_wait_q_t *wait_q)
 {
-	return (struct k_thread *)sys_dlist_peek_head(wait_q);
+	return (struct k_thread *)sys_dlist_peek_head(&wait_q->waitq);
 }
 
 static inline struct k_thread *
@@ -447,7 +544,7 @@ _find_first_thread_to_unpend(_wait_q_t *wait_q, struct k_thread *from)
 	extern volatile int _handling_timeouts;
 
 	if (_handling_timeouts) {
-		sys_dlist_t *q = (sys_dlist_t *)wait_q;
+		sys_dlist_t *q = &wait_q->waitq;
 		sys_dnode_t *cur = from ? &from->base.k_q_node : NULL;
 
 		/* skip threads that have an expired timeout */
@@ -466,7 +563,7 @@ _find_first_thread_to_unpend(_wait_q_t *wait_q, struct k_thread *from)
 	ARG_UNUSED(from);
 #endif
 
-	return (struct k_thread *)sys_dlist_peek_head(wait_q);
+	return (struct k_thread *)sys_dlist_peek_head(&wait_q->waitq);
 
 }
 
@@ -476,7 +573,11 @@ static inline void _unpend_thread(struct k_thread *thread)
 {
 	__ASSERT(thread->base.thread_state & _THREAD_PENDING, "");
 
+#ifdef CONFIG_WAITQ_BUCKETS
+	_waitq_remove(thread);
+#else
 	sys_dlist_remove(&thread->base.k_q_node);
+#endif
 	_mark_thread_as_not_pending(thread);
 }
 
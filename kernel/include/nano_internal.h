@@ -27,6 +27,11 @@ extern "C" {
 
 /* Early boot functions */
 
+#ifdef CONFIG_ARCH_HAS_EARLY_MEM_INIT
+extern void _arch_early_mem_zero(void *dst, size_t size);
+extern void _arch_early_mem_copy(void *dst, const void *src, size_t size);
+#endif
+
 void _bss_zero(void);
 #ifdef CONFIG_XIP
 void _data_copy(void);
@@ -52,7 +57,28 @@ extern void _new_thread(char *pStack, size_t stackSize,
 
 /* context switching and scheduling-related routines */
 
+#ifdef CONFIG_SMP
+/*
+ * Architectures supporting SMP implement _arch_swap(), with the semantics of
+ * _Swap(), which the kernel wraps to hand the global interrupt lock over to
+ * the incoming thread.
+ */
+extern unsigned int _arch_swap(unsigned int key);
+extern unsigned int _smp_swap(unsigned int key);
+#define _Swap(key) _smp_swap(key)
+
+/* start a secondary CPU, running fn on the given stack with interrupts off */
+extern void _arch_start_cpu(int cpu, char *stack, size_t sz,
+			    void (*fn)(int cpu, void *arg), void *arg);
+
+/* interrupt the other CPUs, to make them reschedule on interrupt exit */
+extern void _arch_sched_ipi(void);
+
+extern void _smp_init(void);
+extern void _smp_reacquire_global_lock(struct k_thread *thread);
+#else
 extern unsigned int _Swap(unsigned int);
+#endif
 
 /* set and clear essential fiber/task flag */
 
@@ -69,6 +95,16 @@ extern void _thread_monitor_exit(struct k_thread *thread);
 	} while (0)
 #endif /* CONFIG_THREAD_MONITOR */
 
+/* idle governor accounting, around each idle period of the current CPU */
+
+#ifdef CONFIG_SYS_POWER_GOVERNOR
+extern void _sys_pm_governor_idle_enter(int32_t ticks);
+extern void _sys_pm_governor_idle_exit(void);
+#else
+#define _sys_pm_governor_idle_enter(ticks) do { } while (0)
+#define _sys_pm_governor_idle_exit() do { } while (0)
+#endif /* CONFIG_SYS_POWER_GOVERNOR */
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,9 @@
  */
 
 #include <misc/dlist.h>
+#ifdef CONFIG_TICKLESS_KERNEL
+#include <drivers/system_timer.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -115,6 +118,73 @@ static inline void _handle_expired_timeouts(sys_dlist_t *expired)
 	}
 }
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+/*
+ * Timing wheel backend
+ *
+ * Timeouts are hashed in one of CONFIG_TIMEOUT_WHEEL_SLOTS slots based on
+ * their absolute expiry tick. Adding and aborting a timeout is O(1). The
+ * delta_ticks_from_prev field keeps the _INACTIVE and _EXPIRED semantics and
+ * holds the number of ticks requested when the timeout was added otherwise.
+ */
+
+static inline void _timeout_wheel_slot_set(int slot)
+{
+	_timeout_wheel.slot_bmap[slot >> 5] |= (1 << (slot & 0x1f));
+}
+
+static inline void _timeout_wheel_slot_clear(int slot)
+{
+	_timeout_wheel.slot_bmap[slot >> 5] &= ~(1 << (slot & 0x1f));
+}
+
+static inline int _timeout_wheel_slot_is_set(int slot)
+{
+	return _timeout_wheel.slot_bmap[slot >> 5] & (1 << (slot & 0x1f));
+}
+
+/*
+ * Remove a timeout from its slot, keeping the bookkeeping of the wheel up to
+ * date. Must be called with interrupts locked.
+ */
+static inline void _timeout_wheel_remove(struct _timeout *timeout)
+{
+	int slot = timeout->expiry_tick & _TIMEOUT_WHEEL_MASK;
+
+	sys_dlist_remove(&timeout->node);
+
+	if (sys_dlist_is_empty(&_timeout_wheel.slots[slot])) {
+		_timeout_wheel_slot_clear(slot);
+	}
+
+	--_timeout_wheel.num_active;
+
+	if (timeout->expiry_tick == _timeout_wheel.next_expiry) {
+		_timeout_wheel.next_expiry_valid = 0;
+	}
+}
+
+/* returns _INACTIVE if the timer is not active */
+static inline int _abort_timeout(struct _timeout *timeout)
+{
+	if (timeout->delta_ticks_from_prev == _INACTIVE) {
+		return _INACTIVE;
+	}
+
+	if (timeout->delta_ticks_from_prev == _EXPIRED) {
+		/* already moved out of the wheel, onto an expired list */
+		sys_dlist_remove(&timeout->node);
+	} else {
+		_timeout_wheel_remove(timeout);
+	}
+
+	timeout->delta_ticks_from_prev = _INACTIVE;
+
+	return 0;
+}
+
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 /* returns _INACTIVE if the timer is not active */
 static inline int _abort_timeout(struct _timeout *timeout)
 {
@@ -135,6 +205,8 @@ static inline int _abort_timeout(struct _timeout *timeout)
 	return 0;
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 /* returns _INACTIVE if the timer has already expired */
 static inline int _abort_thread_timeout(struct k_thread *thread)
 {
@@ -160,6 +232,19 @@ static inline void _dump_timeout(struct _timeout *timeout, int extra_tab)
 static inline void _dump_timeout_q(void)
 {
 #ifdef CONFIG_KERNEL_DEBUG
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	sys_dnode_t *node;
+
+	K_DEBUG("_timeout_wheel: %p, tick: %u, active: %u\n",
+		&_timeout_wheel, _timeout_wheel.curr_tick,
+		_timeout_wheel.num_active);
+
+	for (int i = 0; i < CONFIG_TIMEOUT_WHEEL_SLOTS; i++) {
+		SYS_DLIST_FOR_EACH_NODE(&_timeout_wheel.slots[i], node) {
+			_dump_timeout((struct _timeout *)node, 1);
+		}
+	}
+#else
 	sys_dnode_t *node;
 
 	K_DEBUG("_timeout_q: %p, head: %p, tail: %p\n",
@@ -169,8 +254,65 @@ static inline void _dump_timeout_q(void)
 		_dump_timeout((struct _timeout *)node, 1);
 	}
 #endif
+#endif
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+/*
+ * Add timeout to the timing wheel. Record waiting thread and wait queue if
+ * any.
+ *
+ * Cannot handle timeout == 0 and timeout == K_FOREVER.
+ *
+ * The timeout is _prepended_ to its slot, so that timeouts expiring on the
+ * same system clock tick are found in the reverse order they were added to
+ * the wheel, the same way they are in the delta-list timeout queue. See the
+ * description of the delta-list version of _add_timeout() for details.
+ *
+ * Must be called with interrupts locked.
+ */
+
+static inline void _add_timeout(struct k_thread *thread,
+				struct _timeout *timeout,
+				_wait_q_t *wait_q,
+				int32_t timeout_in_ticks)
+{
+	__ASSERT(timeout_in_ticks > 0, "");
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* the wheel is only advanced when ticks are announced */
+	timeout_in_ticks += _timer_elapsed_get();
+#endif
+
+	uint32_t expiry = _timeout_wheel.curr_tick + timeout_in_ticks;
+	int slot = expiry & _TIMEOUT_WHEEL_MASK;
+
+	timeout->delta_ticks_from_prev = timeout_in_ticks;
+	timeout->expiry_tick = expiry;
+	timeout->thread = thread;
+	timeout->wait_q = (sys_dlist_t *)wait_q;
+
+	K_DEBUG("adding timeout %p\n", timeout);
+	_dump_timeout(timeout, 0);
+
+	sys_dlist_prepend(&_timeout_wheel.slots[slot], &timeout->node);
+	_timeout_wheel_slot_set(slot);
+
+	if (_timeout_wheel.num_active++ == 0) {
+		_timeout_wheel.next_expiry = expiry;
+		_timeout_wheel.next_expiry_valid = 1;
+	} else if (_timeout_wheel.next_expiry_valid &&
+		   (int32_t)(expiry - _timeout_wheel.next_expiry) < 0) {
+		_timeout_wheel.next_expiry = expiry;
+	}
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	_sys_clock_deadline_update();
+#endif
 }
 
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 /*
  * Add timeout to timeout queue. Record waiting thread and wait queue if any.
  *
@@ -201,6 +343,14 @@ static inline void _add_timeout(struct k_thread *thread,
 {
 	__ASSERT(timeout_in_ticks > 0, "");
 
+#ifdef CONFIG_TICKLESS_KERNEL
+	/*
+	 * The head of the queue is relative to the last announced tick, not to
+	 * the current time, since ticks are only announced at deadlines.
+	 */
+	timeout_in_ticks += _timer_elapsed_get();
+#endif
+
 	timeout->delta_ticks_from_prev = timeout_in_ticks;
 	timeout->thread = thread;
 	timeout->wait_q = (sys_dlist_t *)wait_q;
@@ -229,8 +379,14 @@ inserted:
 	K_DEBUG("after adding timeout %p\n", timeout);
 	_dump_timeout(timeout, 0);
 	_dump_timeout_q();
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	_sys_clock_deadline_update();
+#endif
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 /*
  * Put thread on timeout queue. Record wait queue if any.
  *
@@ -248,6 +404,9 @@ static inline void _add_thread_timeout(struct k_thread *thread,
 
 /* find the closest deadline in the timeout queue */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+extern int32_t _get_next_timeout_expiry(void);
+#else
 static inline int32_t _get_next_timeout_expiry(void)
 {
 	struct _timeout *t = (struct _timeout *)
@@ -255,6 +414,7 @@ static inline int32_t _get_next_timeout_expiry(void)
 
 	return t ? t->delta_ticks_from_prev : K_FOREVER;
 }
+#endif
 
 #ifdef __cplusplus
 }
@@ -42,7 +42,15 @@ static ALWAYS_INLINE int _abort_thread_timeout(struct k_thread *thread)
 #define _get_next_timeout_expiry() (K_FOREVER)
 #endif
 
-#define _WAIT_Q_INIT(wait_q) SYS_DLIST_STATIC_INIT(wait_q)
+static inline void _waitq_init(_wait_q_t *wait_q)
+{
+	sys_dlist_init(&wait_q->waitq);
+#ifdef CONFIG_WAITQ_BUCKETS
+	for (int i = 0; i < ARRAY_SIZE(wait_q->prio_bmap); i++) {
+		wait_q->prio_bmap[i] = 0;
+	}
+#endif
+}
 
 #ifdef __cplusplus
 }
@@ -56,6 +56,15 @@ uint64_t __noinit __main_tsc;  /* timestamp when main task starts */
 uint64_t __noinit __idle_tsc;  /* timestamp when CPU goes idle */
 #endif
 
+#ifdef CONFIG_BOOT_TIME_PROFILE
+#include <misc/boot_profile.h>
+
+/* set by the architecture startup code, before BSS is cleared */
+uint64_t __noinit __data_copy_tsc; /* timestamp when data copy starts */
+uint64_t __noinit __bss_zero_tsc;  /* timestamp when BSS clearing starts */
+uint64_t __noinit __cstart_tsc;    /* timestamp when _Cstart() starts */
+#endif
+
 /* init/main and idle threads */
 
 #define IDLE_STACK_SIZE CONFIG_IDLE_STACK_SIZE
@@ -98,7 +107,14 @@ k_tid_t const _idle_thread = (k_tid_t)_idle_stack;
 #endif
 char __noinit __stack _interrupt_stack[CONFIG_ISR_STACK_SIZE];
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#if defined(CONFIG_TIMEOUT_QUEUE_WHEEL)
+	#include <misc/dlist.h>
+	#define initialize_timeouts() do { \
+		for (int i = 0; i < CONFIG_TIMEOUT_WHEEL_SLOTS; i++) { \
+			sys_dlist_init(&_timeout_wheel.slots[i]); \
+		} \
+	} while ((0))
+#elif defined(CONFIG_SYS_CLOCK_EXISTS)
 	#include <misc/dlist.h>
 	#define initialize_timeouts() do { \
 		sys_dlist_init(&_timeout_q); \
@@ -112,7 +128,8 @@ extern void idle(void *unused1, void *unused2, void *unused3);
 void k_call_stacks_analyze(void)
 {
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_PRINTK)
-	extern char sys_work_q_stack[CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE];
+	extern char sys_work_q_stack[CONFIG_SYSTEM_WORKQUEUE_WORKERS *
+				     CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE];
 #if defined(CONFIG_ARC)
 	extern char _firq_stack[CONFIG_FIRQ_STACK_SIZE];
 #endif /* CONFIG_ARC */
@@ -128,6 +145,19 @@ void k_call_stacks_analyze(void)
 	stack_analyze("workqueue", sys_work_q_stack,
 		      sizeof(sys_work_q_stack));
 
+#if defined(CONFIG_THREAD_MONITOR)
+	struct k_thread *thread;
+	size_t unused;
+
+	/* same layout as scripts/checkstack.pl, entry point as function */
+	printk("Thread stacks:\n");
+	for (thread = _kernel.threads; thread; thread = thread->next_thread) {
+		k_thread_stack_space_get(thread, &unused);
+		printk("%p %p [%u]:\t%u\n", thread->entry->pEntry, thread,
+		       (unsigned)thread->stack_size,
+		       (unsigned)(thread->stack_size - sizeof(*thread) - unused));
+	}
+#endif /* CONFIG_THREAD_MONITOR */
 #endif /* CONFIG_INIT_STACKS && CONFIG_PRINTK */
 }
 
@@ -141,8 +171,13 @@ void k_call_stacks_analyze(void)
  */
 void _bss_zero(void)
 {
+#ifdef CONFIG_ARCH_HAS_EARLY_MEM_INIT
+	_arch_early_mem_zero(&__bss_start,
+			     ((uint32_t) &__bss_end - (uint32_t) &__bss_start));
+#else
 	memset(&__bss_start, 0,
 		 ((uint32_t) &__bss_end - (uint32_t) &__bss_start));
+#endif
 }
 
 
@@ -151,14 +186,35 @@ void _bss_zero(void)
  *
  * @brief Copy the data section from ROM to RAM
  *
- * This routine copies the data section from ROM to RAM.
+ * This routine copies the data section, and the functions run from RAM,
+ * from ROM to RAM.
  *
  * @return N/A
  */
 void _data_copy(void)
 {
+#ifdef CONFIG_ARCH_HAS_EARLY_MEM_INIT
+#ifdef CONFIG_ARCH_HAS_RAMFUNC_SUPPORT
+	_arch_early_mem_copy(&_ramfunc_ram_start, &_ramfunc_rom_start,
+			     ((uint32_t) &_ramfunc_ram_end -
+			      (uint32_t) &_ramfunc_ram_start));
+#endif
+	_arch_early_mem_copy(&__data_ram_start, &__data_rom_start,
+			     ((uint32_t) &__data_ram_end -
+			      (uint32_t) &__data_ram_start));
+#else
+#ifdef CONFIG_ARCH_HAS_RAMFUNC_SUPPORT
+	uint32_t *ramfunc_src = (uint32_t *)&_ramfunc_rom_start;
+	uint32_t *ramfunc_dst = (uint32_t *)&_ramfunc_ram_start;
+
+	/* Word by word, memcpy() itself may be one of the functions copied */
+	while (ramfunc_dst < (uint32_t *)&_ramfunc_ram_end) {
+		*ramfunc_dst++ = *ramfunc_src++;
+	}
+#endif
 	memcpy(&__data_ram_start, &__data_rom_start,
 		 ((uint32_t) &__data_ram_end - (uint32_t) &__data_ram_start));
+#endif /* CONFIG_ARCH_HAS_EARLY_MEM_INIT */
 }
 #endif
 
@@ -179,6 +235,10 @@ static void _main(void *unused1, void *unused2, void *unused3)
 
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_POST_KERNEL);
 
+#ifdef CONFIG_SMP
+	_smp_init();
+#endif
+
 	/* These 3 are deprecated */
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_SECONDARY);
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_NANOKERNEL);
@@ -252,6 +312,7 @@ static void prepare_multithreading(struct k_thread *dummy_thread)
 	_current = dummy_thread;
 
 	dummy_thread->base.user_options = K_ESSENTIAL;
+	dummy_thread->base.thread_state = _THREAD_DUMMY;
 #endif
 
 	/* _kernel.ready_q is all zeroes */
@@ -298,6 +359,13 @@ static void prepare_multithreading(struct k_thread *dummy_thread)
 	_add_thread_to_ready_q(_idle_thread);
 #endif
 
+#ifdef CONFIG_SMP
+	_kernel.cpus[0].idle_thread = _idle_thread;
+#ifdef CONFIG_SCHED_CPU_MASK
+	_idle_thread->base.cpu_mask = 1 << 0;
+#endif
+#endif
+
 	initialize_timeouts();
 
 	/* perform any architecture-specific initialization */
@@ -344,6 +412,19 @@ FUNC_NORETURN void _Cstart(void)
 	char __stack dummy_stack[_K_THREAD_NO_FLOAT_SIZEOF];
 	void *dummy_thread = dummy_stack;
 #endif
+#ifdef CONFIG_BOOT_TIME_PROFILE
+	uint64_t start;
+
+	/* the startup code phases, now that BSS is clear for the profile */
+#ifdef CONFIG_XIP
+	_boot_profile_record("data copy", NULL, -1, __data_copy_tsc,
+			     __bss_zero_tsc);
+#endif
+	_boot_profile_record("BSS clear", NULL, -1, __bss_zero_tsc,
+			     __cstart_tsc);
+
+	start = _tsc_read();
+#endif
 
 	/*
 	 * Initialize kernel data structures. This step includes
@@ -353,6 +434,11 @@ FUNC_NORETURN void _Cstart(void)
 
 	prepare_multithreading(dummy_thread);
 
+#ifdef CONFIG_BOOT_TIME_PROFILE
+	_boot_profile_record("prepare_multithreading", NULL, -1, start,
+			     _tsc_read());
+#endif
+
 	/* Deprecated */
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_PRIMARY);
 
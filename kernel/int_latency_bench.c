@@ -40,6 +40,10 @@ static uint32_t int_latency_bench_ready;
 /* min amount of time it takes from HW interrupt generation to 'C' handler */
 uint32_t _hw_irq_to_c_handler_latency = ULONG_MAX;
 
+/* stats tracking the time from interrupt trigger to ISR, wrapped and direct */
+static uint32_t isr_latency_min[2] = { ULONG_MAX, ULONG_MAX };
+static uint32_t isr_latency_max[2];
+
 /**
  *
  * @brief Start tracking time spent with interrupts locked
@@ -112,6 +116,41 @@ void _int_latency_stop(void)
 	}
 }
 
+/**
+ *
+ * @brief Account for the latency of an interrupt service routine
+ *
+ * This is called first thing by an ISR whose interrupt was triggered from
+ * software at a known time, to track how long the interrupt takes to reach
+ * it. Regular ISRs go through the common interrupt wrapper while direct
+ * ISRs, installed with IRQ_DIRECT_CONNECT(), are reached straight from the
+ * vector table, so both are tracked separately to compare them.
+ *
+ * @param trigger_time Value of k_cycle_get_32() when the interrupt was
+ *                     triggered.
+ * @param direct Non-zero if called from a direct ISR.
+ *
+ * @return N/A
+ *
+ */
+void _int_latency_isr_record(uint32_t trigger_time, int direct)
+{
+	uint32_t delta = k_cycle_get_32() - trigger_time;
+
+	direct = !!direct;
+
+	if (delta < isr_latency_min[direct]) {
+		isr_latency_min[direct] = delta;
+	}
+	if (delta > isr_latency_max[direct]) {
+		isr_latency_max[direct] = delta;
+	}
+
+	if (!direct && delta < _hw_irq_to_c_handler_latency) {
+		_hw_irq_to_c_handler_latency = delta;
+	}
+}
+
 /**
  *
  * @brief Initialize interrupt latency benchmark
@@ -215,6 +254,24 @@ void int_latency_show(void)
 	} else {
 		printk("interrupts were not locked and unlocked yet\n");
 	}
+
+	for (int direct = 0; direct < 2; direct++) {
+		if (isr_latency_min[direct] == ULONG_MAX) {
+			continue;
+		}
+
+		printk(" Latency from int. trigger up to %s ISR:\n"
+		       "  min: %d tcs = %d nsec\n"
+		       "  max: %d tcs = %d nsec\n",
+		       direct ? "direct" : "wrapped",
+		       isr_latency_min[direct],
+		       SYS_CLOCK_HW_CYCLES_TO_NS(isr_latency_min[direct]),
+		       isr_latency_max[direct],
+		       SYS_CLOCK_HW_CYCLES_TO_NS(isr_latency_max[direct]));
+
+		isr_latency_min[direct] = ULONG_MAX;
+		isr_latency_max[direct] = 0;
+	}
 	/*
 	 * Lets start with new values so that one extra long path executed
 	 * with interrupt disabled hide smaller paths with interrupt
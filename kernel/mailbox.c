@@ -102,11 +102,34 @@ SYS_INIT(init_mbox_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
 void k_mbox_init(struct k_mbox *mbox_ptr)
 {
-	sys_dlist_init(&mbox_ptr->tx_msg_queue);
-	sys_dlist_init(&mbox_ptr->rx_msg_queue);
+	_waitq_init(&mbox_ptr->tx_msg_queue);
+	_waitq_init(&mbox_ptr->rx_msg_queue);
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	for (int i = 0; i < _MBOX_INDEX_SIZE; i++) {
+		_waitq_init(&mbox_ptr->tx_target_index[i]);
+		_waitq_init(&mbox_ptr->rx_source_index[i]);
+	}
+#endif
 	SYS_TRACING_OBJ_INIT(k_mbox, mbox_ptr);
 }
 
+/**
+ * @brief Check compatibility of sender's and receiver's message descriptors.
+ *
+ * @param tx_msg Pointer to transmit message descriptor.
+ * @param rx_msg Pointer to receive message descriptor.
+ *
+ * @return 1 if the descriptors can be matched, otherwise 0.
+ */
+static inline int _mbox_message_compatible(struct k_mbox_msg *tx_msg,
+					   struct k_mbox_msg *rx_msg)
+{
+	return ((tx_msg->tx_target_thread == (k_tid_t)K_ANY) ||
+		(tx_msg->tx_target_thread == rx_msg->tx_target_thread)) &&
+	       ((rx_msg->rx_source_thread == (k_tid_t)K_ANY) ||
+		(rx_msg->rx_source_thread == tx_msg->rx_source_thread));
+}
+
 /**
  * @brief Check compatibility of sender's and receiver's message descriptors.
  *
@@ -124,10 +147,7 @@ static int _mbox_message_match(struct k_mbox_msg *tx_msg,
 {
 	uint32_t temp_info;
 
-	if (((tx_msg->tx_target_thread == (k_tid_t)K_ANY) ||
-	     (tx_msg->tx_target_thread == rx_msg->tx_target_thread)) &&
-	    ((rx_msg->rx_source_thread == (k_tid_t)K_ANY) ||
-	     (rx_msg->rx_source_thread == tx_msg->rx_source_thread))) {
+	if (_mbox_message_compatible(tx_msg, rx_msg)) {
 
 		/* update thread identifier fields for both descriptors */
 		rx_msg->rx_source_thread = tx_msg->rx_source_thread;
@@ -161,6 +181,168 @@ static int _mbox_message_match(struct k_mbox_msg *tx_msg,
 	return -1;
 }
 
+/* first receiver of a wait queue compatible with a sender */
+static struct k_thread *_mbox_find_receiver(_wait_q_t *wait_q,
+					    struct k_mbox_msg *tx_msg)
+{
+	sys_dnode_t *node;
+
+	SYS_DLIST_FOR_EACH_NODE(&wait_q->waitq, node) {
+		struct k_thread *thread = (struct k_thread *)node;
+
+		if (_mbox_message_compatible(tx_msg, thread->base.swap_data)) {
+			return thread;
+		}
+	}
+
+	return NULL;
+}
+
+/* first sender of a wait queue compatible with a receiver */
+static struct k_thread *_mbox_find_sender(_wait_q_t *wait_q,
+					  struct k_mbox_msg *rx_msg)
+{
+	sys_dnode_t *node;
+
+	SYS_DLIST_FOR_EACH_NODE(&wait_q->waitq, node) {
+		struct k_thread *thread = (struct k_thread *)node;
+
+		if (_mbox_message_compatible(thread->base.swap_data, rx_msg)) {
+			return thread;
+		}
+	}
+
+	return NULL;
+}
+
+#ifdef CONFIG_MBOX_MATCH_INDEX
+/* index bucket of a thread, from a multiplicative hash of its address */
+static inline int _mbox_index(k_tid_t thread)
+{
+	return ((uint32_t)thread * 2654435761u) >> (32 - _MBOX_INDEX_BITS);
+}
+
+static inline int _mbox_is_rx_queue(struct k_mbox *mbox, _wait_q_t *wait_q)
+{
+	return (wait_q == &mbox->rx_msg_queue) ||
+	       ((wait_q >= &mbox->rx_source_index[0]) &&
+		(wait_q < &mbox->rx_source_index[_MBOX_INDEX_SIZE]));
+}
+
+/*
+ * Pick the higher priority of two candidates, either of them possibly
+ * missing. The one expecting a given thread wins a tie.
+ */
+static inline struct k_thread *_mbox_first_of(struct k_thread *any,
+					      struct k_thread *given)
+{
+	if ((any == NULL) ||
+	    ((given != NULL) && !_is_t1_higher_prio_than_t2(any, given))) {
+		return given;
+	}
+
+	return any;
+}
+#endif
+
+/* wait queue a sender waits on for a receiver */
+static inline _wait_q_t *_mbox_tx_queue(struct k_mbox *mbox,
+					struct k_mbox_msg *tx_msg)
+{
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	if (tx_msg->tx_target_thread != (k_tid_t)K_ANY) {
+		return &mbox->tx_target_index[
+			_mbox_index(tx_msg->tx_target_thread)];
+	}
+#endif
+	return &mbox->tx_msg_queue;
+}
+
+/* wait queue a receiver waits on for a sender */
+static inline _wait_q_t *_mbox_rx_queue(struct k_mbox *mbox,
+					struct k_mbox_msg *rx_msg)
+{
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	if (rx_msg->rx_source_thread != (k_tid_t)K_ANY) {
+		return &mbox->rx_source_index[
+			_mbox_index(rx_msg->rx_source_thread)];
+	}
+#endif
+	return &mbox->rx_msg_queue;
+}
+
+/**
+ * @brief Find the receiver of a message.
+ *
+ * Without an index, every waiting receiver is checked in turn. With one,
+ * a message to a given thread can only be received by that thread, and a
+ * message to any thread by the first receiver from any sender or the
+ * first waiting for its sender, whichever has the higher priority.
+ *
+ * @param mbox Pointer to the mailbox object.
+ * @param tx_msg Pointer to transmit message descriptor.
+ *
+ * @return Highest priority compatible receiver, or NULL if there is none.
+ */
+static struct k_thread *_mbox_receiver_find(struct k_mbox *mbox,
+					    struct k_mbox_msg *tx_msg)
+{
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	struct k_thread *target = tx_msg->tx_target_thread;
+
+	if (target != (k_tid_t)K_ANY) {
+		if (!_is_thread_pending(target) ||
+		    !_mbox_is_rx_queue(mbox, target->base.pended_on) ||
+		    !_mbox_message_compatible(tx_msg,
+					      target->base.swap_data)) {
+			return NULL;
+		}
+		return target;
+	}
+
+	return _mbox_first_of(_peek_first_pending_thread(&mbox->rx_msg_queue),
+			      _mbox_find_receiver(_mbox_rx_queue(mbox, tx_msg),
+						  tx_msg));
+#else
+	return _mbox_find_receiver(&mbox->rx_msg_queue, tx_msg);
+#endif
+}
+
+/**
+ * @brief Find the sender of a message.
+ *
+ * Without an index, every waiting sender is checked in turn. With one, the
+ * message is the first one to any thread or the first one to the receiver,
+ * whichever has the higher priority. Receivers expecting a given sender
+ * have to search the messages to any thread for one of that sender.
+ *
+ * @param mbox Pointer to the mailbox object.
+ * @param rx_msg Pointer to receive message descriptor.
+ *
+ * @return Highest priority compatible sender, or NULL if there is none.
+ */
+static struct k_thread *_mbox_sender_find(struct k_mbox *mbox,
+					  struct k_mbox_msg *rx_msg)
+{
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	struct k_thread *any;
+
+	if (rx_msg->rx_source_thread == (k_tid_t)K_ANY) {
+		any = _peek_first_pending_thread(&mbox->tx_msg_queue);
+	} else {
+		any = _mbox_find_sender(&mbox->tx_msg_queue, rx_msg);
+	}
+
+	return _mbox_first_of(any,
+			      _mbox_find_sender(
+				      &mbox->tx_target_index[
+					      _mbox_index(_current)],
+				      rx_msg));
+#else
+	return _mbox_find_sender(&mbox->tx_msg_queue, rx_msg);
+#endif
+}
+
 /**
  * @brief Dispose of received message.
  *
@@ -239,8 +421,6 @@ static int _mbox_message_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 {
 	struct k_thread *sending_thread;
 	struct k_thread *receiving_thread;
-	struct k_mbox_msg *rx_msg;
-	sys_dnode_t *wait_q_item, *next_wait_q_item;
 	unsigned int key;
 
 	/* save sender id so it can be used during message matching */
@@ -253,43 +433,43 @@ static int _mbox_message_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 	/* search mailbox's rx queue for a compatible receiver */
 	key = irq_lock();
 
-	SYS_DLIST_FOR_EACH_NODE_SAFE(&mbox->rx_msg_queue, wait_q_item,
-				     next_wait_q_item) {
+	receiving_thread = _mbox_receiver_find(mbox, tx_msg);
+	if (receiving_thread != NULL) {
+		_mbox_message_match(tx_msg, receiving_thread->base.swap_data);
 
-		receiving_thread = (struct k_thread *)wait_q_item;
-		rx_msg = (struct k_mbox_msg *)receiving_thread->base.swap_data;
+		/* take receiver out of rx queue */
+		_unpend_thread(receiving_thread);
+		_abort_thread_timeout(receiving_thread);
 
-		if (_mbox_message_match(tx_msg, rx_msg) == 0) {
-			/* take receiver out of rx queue */
-			_unpend_thread(receiving_thread);
-			_abort_thread_timeout(receiving_thread);
-
-			/* ready receiver for execution */
-			_set_thread_return_value(receiving_thread, 0);
-			_ready_thread(receiving_thread);
+		/* ready receiver for execution */
+		_set_thread_return_value(receiving_thread, 0);
+		_ready_thread(receiving_thread);
 
 #if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0)
-			/*
-			 * asynchronous send: swap out current thread
-			 * if receiver has priority, otherwise let it continue
-			 *
-			 * note: dummy sending thread sits (unqueued)
-			 * until the receiver consumes the message
-			 */
-			if (sending_thread->base.thread_state & _THREAD_DUMMY) {
-				_reschedule_threads(key);
-				return 0;
-			}
+		/*
+		 * asynchronous send: swap out current thread
+		 * if receiver has priority, otherwise let it continue
+		 *
+		 * note: dummy sending thread sits (unqueued)
+		 * until the receiver consumes the message
+		 */
+		if (sending_thread->base.thread_state & _THREAD_DUMMY) {
+			_reschedule_threads(key);
+			return 0;
+		}
 #endif
 
-			/*
-			 * synchronous send: pend current thread (unqueued)
-			 * until the receiver consumes the message
-			 */
-			_remove_thread_from_ready_q(_current);
-			_mark_thread_as_pending(_current);
-			return _Swap(key);
-		}
+		/*
+		 * synchronous send: pend current thread (unqueued)
+		 * until the receiver consumes the message
+		 */
+		_remove_thread_from_ready_q(_current);
+		_mark_thread_as_pending(_current);
+#ifdef CONFIG_MBOX_MATCH_INDEX
+		/* not pending on a wait queue, in particular not as receiver */
+		_current->base.pended_on = NULL;
+#endif
+		return _Swap(key);
 	}
 
 	/* didn't find a matching receiver: don't wait for one */
@@ -301,14 +481,15 @@ static int _mbox_message_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 #if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0)
 	/* asynchronous send: dummy thread waits on tx queue for receiver */
 	if (sending_thread->base.thread_state & _THREAD_DUMMY) {
-		_pend_thread(sending_thread, &mbox->tx_msg_queue, K_FOREVER);
+		_pend_thread(sending_thread, _mbox_tx_queue(mbox, tx_msg),
+			     K_FOREVER);
 		irq_unlock(key);
 		return 0;
 	}
 #endif
 
 	/* synchronous send: sender waits on tx queue for receiver or timeout */
-	_pend_current_thread(&mbox->tx_msg_queue, timeout);
+	_pend_current_thread(_mbox_tx_queue(mbox, tx_msg), timeout);
 	return _Swap(key);
 }
 
@@ -392,6 +573,17 @@ int k_mbox_data_block_get(struct k_mbox_msg *rx_msg, struct k_mem_pool *pool,
 	return 0;
 }
 
+void *k_mbox_data_ptr_get(struct k_mbox_msg *rx_msg)
+{
+	return (rx_msg->size > 0) ? rx_msg->tx_data : NULL;
+}
+
+void k_mbox_data_release(struct k_mbox_msg *rx_msg)
+{
+	/* the sender learns that all of the data was received */
+	_mbox_message_dispose(rx_msg);
+}
+
 /**
  * @brief Handle immediate consumption of received mailbox message data.
  *
@@ -427,8 +619,6 @@ int k_mbox_get(struct k_mbox *mbox, struct k_mbox_msg *rx_msg, void *buffer,
 	       int32_t timeout)
 {
 	struct k_thread *sending_thread;
-	struct k_mbox_msg *tx_msg;
-	sys_dnode_t *wait_q_item, *next_wait_q_item;
 	unsigned int key;
 	int result;
 
@@ -438,22 +628,18 @@ int k_mbox_get(struct k_mbox *mbox, struct k_mbox_msg *rx_msg, void *buffer,
 	/* search mailbox's tx queue for a compatible sender */
 	key = irq_lock();
 
-	SYS_DLIST_FOR_EACH_NODE_SAFE(&mbox->tx_msg_queue, wait_q_item,
-				     next_wait_q_item) {
+	sending_thread = _mbox_sender_find(mbox, rx_msg);
+	if (sending_thread != NULL) {
+		_mbox_message_match(sending_thread->base.swap_data, rx_msg);
 
-		sending_thread = (struct k_thread *)wait_q_item;
-		tx_msg = (struct k_mbox_msg *)sending_thread->base.swap_data;
+		/* take sender out of mailbox's tx queue */
+		_unpend_thread(sending_thread);
+		_abort_thread_timeout(sending_thread);
 
-		if (_mbox_message_match(tx_msg, rx_msg) == 0) {
-			/* take sender out of mailbox's tx queue */
-			_unpend_thread(sending_thread);
-			_abort_thread_timeout(sending_thread);
-
-			irq_unlock(key);
+		irq_unlock(key);
 
-			/* consume message data immediately, if needed */
-			return _mbox_message_data_check(rx_msg, buffer);
-		}
+		/* consume message data immediately, if needed */
+		return _mbox_message_data_check(rx_msg, buffer);
 	}
 
 	/* didn't find a matching sender */
@@ -465,7 +651,7 @@ int k_mbox_get(struct k_mbox *mbox, struct k_mbox_msg *rx_msg, void *buffer,
 	}
 
 	/* wait until a matching sender appears or a timeout occurs */
-	_pend_current_thread(&mbox->rx_msg_queue, timeout);
+	_pend_current_thread(_mbox_rx_queue(mbox, rx_msg), timeout);
 	_current->base.swap_data = rx_msg;
 	result = _Swap(key);
 
@@ -17,6 +17,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef CONFIG_MEM_POOL_TLSF
+
 #define _QUAD_BLOCK_AVAILABLE 0x0F
 #define _QUAD_BLOCK_ALLOCATED 0x0
 
@@ -95,7 +97,7 @@ static void init_one_memory_pool(struct k_mem_pool *pool)
 	 * note: all other block sets own no blocks, since their
 	 * first quad-block has a NULL memory pointer
 	 */
-	sys_dlist_init(&pool->wait_q);
+	_waitq_init(&pool->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_pool, pool);
 }
 
@@ -422,7 +424,7 @@ static void block_waiters_check(struct k_mem_pool *pool)
 	int offset;
 
 	unsigned int key = irq_lock();
-	waiter = (struct k_thread *)sys_dlist_peek_head(&pool->wait_q);
+	waiter = (struct k_thread *)sys_dlist_peek_head(&pool->wait_q.waitq);
 
 	/* loop all waiters */
 	while (waiter != NULL) {
@@ -435,7 +437,7 @@ static void block_waiters_check(struct k_mem_pool *pool)
 		found_block = get_block_recursive(pool, offset, offset);
 
 		next_waiter = (struct k_thread *)sys_dlist_peek_next(
-			&pool->wait_q, &waiter->base.k_q_node);
+			&pool->wait_q.waitq, &waiter->base.k_q_node);
 
 		/* if success : remove task from list and reschedule */
 		if (found_block != NULL) {
@@ -533,6 +535,7 @@ void k_mem_pool_free(struct k_mem_block *block)
 	k_sched_unlock();
 }
 
+#endif /* !CONFIG_MEM_POOL_TLSF */
 
 /*
  * Heap memory pool support
@@ -569,14 +572,16 @@ extern struct k_mem_pool * const _heap_mem_pool_ptr;
 #endif /* CONFIG_HEAP_MEM_POOL_SIZE */
 
 
-void *k_malloc(size_t size)
+/*
+ * Allocate a heap block able to hold its (hidden) block descriptor followed
+ * by size bytes, and save the descriptor at the start of the block.
+ *
+ * Returns the address of the descriptor, or NULL.
+ */
+static struct k_mem_block *heap_block_alloc(size_t size)
 {
 	struct k_mem_block block;
 
-	/*
-	 * get a block large enough to hold an initial (hidden) block
-	 * descriptor, as well as the space the caller requested
-	 */
 	size += sizeof(struct k_mem_block);
 	if (k_mem_pool_alloc(_HEAP_MEM_POOL, &block, size, K_NO_WAIT) != 0) {
 		return NULL;
@@ -585,8 +590,186 @@ void *k_malloc(size_t size)
 	/* save the block descriptor info at the start of the actual block */
 	memcpy(block.data, &block, sizeof(struct k_mem_block));
 
+	return block.data;
+}
+
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+
+/*
+ * Per-thread magazines
+ *
+ * Each thread caches up to CONFIG_HEAP_MEM_POOL_MAGAZINE_DEPTH recently freed
+ * heap blocks per size class. Only the thread owning a magazine ever touches
+ * it, so taking a block from it or putting one back needs no locking at all.
+ * When a magazine is empty or full, half of it is refilled from or flushed to
+ * the heap memory pool in one go, with the scheduler locked once.
+ *
+ * Blocks in a size class all have the same size, the largest of the class,
+ * and are not used for ISRs, which always go to the heap memory pool.
+ */
+
+#define MAGAZINE_BATCH (CONFIG_HEAP_MEM_POOL_MAGAZINE_DEPTH / 2)
+
+static sys_slist_t magazine_orphans = SYS_SLIST_STATIC_INIT(&magazine_orphans);
+
+static inline size_t magazine_class_size(int class)
+{
+	return _HEAP_MAGAZINE_SIZE_MIN << class;
+}
+
+static inline int magazine_class(size_t size)
+{
+	for (int class = 0; class < _HEAP_MAGAZINE_NUM_CLASSES; class++) {
+		if (size <= magazine_class_size(class)) {
+			return class;
+		}
+	}
+
+	return -1;
+}
+
+static inline struct _heap_magazine *current_magazine(void)
+{
+	if (_is_in_isr() || !_current ||
+	    (_current->base.thread_state & _THREAD_DUMMY)) {
+		return NULL;
+	}
+
+	return &_current->heap_magazine;
+}
+
+/*
+ * Give back to the heap memory pool the blocks of the magazines of aborted
+ * threads.
+ */
+static void magazine_orphans_free(void)
+{
+	sys_snode_t *node;
+	unsigned int key;
+
+	while (!sys_slist_is_empty(&magazine_orphans)) {
+		key = irq_lock();
+		node = sys_slist_get(&magazine_orphans);
+		irq_unlock(key);
+
+		if (node) {
+			k_mem_pool_free((struct k_mem_block *)node - 1);
+		}
+	}
+}
+
+static void *magazine_alloc(struct _heap_magazine *magazine, int class)
+{
+	struct k_mem_block *block;
+
+	if (magazine->count[class] == 0) {
+		_sched_lock();
+
+		magazine_orphans_free();
+
+		while (magazine->count[class] < MAGAZINE_BATCH) {
+			block = heap_block_alloc(magazine_class_size(class));
+			if (!block) {
+				break;
+			}
+			magazine->blocks[class][magazine->count[class]] = block;
+			magazine->count[class]++;
+		}
+
+		k_sched_unlock();
+
+		if (magazine->count[class] == 0) {
+			return NULL;
+		}
+	}
+
+	block = magazine->blocks[class][--magazine->count[class]];
+
+	return block + 1;
+}
+
+static void magazine_free(struct _heap_magazine *magazine, int class,
+			  struct k_mem_block *block)
+{
+	if (magazine->count[class] == CONFIG_HEAP_MEM_POOL_MAGAZINE_DEPTH) {
+		_sched_lock();
+
+		magazine_orphans_free();
+
+		while (magazine->count[class] >
+		       CONFIG_HEAP_MEM_POOL_MAGAZINE_DEPTH - MAGAZINE_BATCH) {
+			magazine->count[class]--;
+			k_mem_pool_free(
+				magazine->blocks[class][magazine->count[class]]);
+		}
+
+		k_sched_unlock();
+	}
+
+	magazine->blocks[class][magazine->count[class]] = block;
+	compiler_barrier();
+	magazine->count[class]++;
+}
+
+void _heap_magazine_init(struct k_thread *thread)
+{
+	for (int class = 0; class < _HEAP_MAGAZINE_NUM_CLASSES; class++) {
+		thread->heap_magazine.count[class] = 0;
+	}
+}
+
+/*
+ * Move the blocks cached by an aborted thread to the list of orphans, to be
+ * given back to the heap memory pool by the next thread that refills or
+ * flushes its magazine. The user data area of each block holds its link.
+ *
+ * Must be called with interrupts locked.
+ */
+void _heap_magazine_abort(struct k_thread *thread)
+{
+	struct _heap_magazine *magazine = &thread->heap_magazine;
+
+	for (int class = 0; class < _HEAP_MAGAZINE_NUM_CLASSES; class++) {
+		while (magazine->count[class] > 0) {
+			struct k_mem_block *block =
+				magazine->blocks[class][--magazine->count[class]];
+
+			sys_slist_append(&magazine_orphans,
+					 (sys_snode_t *)(block + 1));
+		}
+	}
+}
+
+#endif /* CONFIG_HEAP_MEM_POOL_MAGAZINE */
+
+void *k_malloc(size_t size)
+{
+	struct k_mem_block *block;
+
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+	struct _heap_magazine *magazine = current_magazine();
+	int class = magazine_class(size);
+
+	if (magazine && class >= 0) {
+		return magazine_alloc(magazine, class);
+	}
+
+	if (magazine) {
+		magazine_orphans_free();
+	}
+#endif
+
+	/*
+	 * get a block large enough to hold an initial (hidden) block
+	 * descriptor, as well as the space the caller requested
+	 */
+	block = heap_block_alloc(size);
+	if (!block) {
+		return NULL;
+	}
+
 	/* return address of the user area part of the block to the caller */
-	return (char *)block.data + sizeof(struct k_mem_block);
+	return block + 1;
 }
 
 
@@ -596,6 +779,20 @@ void k_free(void *ptr)
 		/* point to hidden block descriptor at start of block */
 		ptr = (char *)ptr - sizeof(struct k_mem_block);
 
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+		struct _heap_magazine *magazine = current_magazine();
+		struct k_mem_block *block = ptr;
+		int class = magazine_class(block->req_size -
+					   sizeof(struct k_mem_block));
+
+		if (magazine && class >= 0 &&
+		    block->req_size == magazine_class_size(class) +
+				       sizeof(struct k_mem_block)) {
+			magazine_free(magazine, class, block);
+			return;
+		}
+#endif
+
 		/* return block to the heap memory pool */
 		k_mem_pool_free(ptr);
 	}
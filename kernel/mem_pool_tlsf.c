@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Two-level segregated fit memory pools.
+ *
+ * Every block starts with a struct _tlsf_block header, of which only the
+ * physical neighbour pointer and the size are kept while the block is in use.
+ * Its size includes the header and is a multiple of _TLSF_ALIGN, which leaves
+ * its low bit free to flag free blocks. The buffer of each pool ends with a
+ * header-only sentinel block that is never free, so that a block always has a
+ * physical successor.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <debug/object_tracing_common.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <init.h>
+#include <misc/util.h>
+
+#define BLOCK_FREE 0x1
+
+#define BLOCK_SIZE_MIN sizeof(struct _tlsf_block)
+#define BLOCK_SIZE_SMALL (1 << _TLSF_FL_INDEX_SHIFT)
+#define BLOCK_SIZE_MAX \
+	((1 << (CONFIG_MEM_POOL_TLSF_FL_INDEX_MAX + 1)) - _TLSF_ALIGN)
+
+extern struct k_mem_pool _k_mem_pool_list_start[];
+extern struct k_mem_pool _k_mem_pool_list_end[];
+
+struct k_mem_pool *_trace_list_k_mem_pool;
+
+static inline size_t block_size(struct _tlsf_block *block)
+{
+	return block->size & ~BLOCK_FREE;
+}
+
+static inline int block_is_free(struct _tlsf_block *block)
+{
+	return block->size & BLOCK_FREE;
+}
+
+static inline struct _tlsf_block *block_next(struct _tlsf_block *block)
+{
+	return (struct _tlsf_block *)((char *)block + block_size(block));
+}
+
+static inline void *block_to_ptr(struct _tlsf_block *block)
+{
+	return (char *)block + _TLSF_BLOCK_OVERHEAD;
+}
+
+static inline struct _tlsf_block *block_from_ptr(void *ptr)
+{
+	return (struct _tlsf_block *)((char *)ptr - _TLSF_BLOCK_OVERHEAD);
+}
+
+/**
+ *
+ * @brief Compute the free lists a block of the specified size belongs to
+ *
+ * Blocks smaller than BLOCK_SIZE_SMALL all go in the first first-level list,
+ * linearly split by _TLSF_ALIGN.
+ *
+ * @return N/A
+ */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+	if (size < BLOCK_SIZE_SMALL) {
+		*fl = 0;
+		*sl = size / (BLOCK_SIZE_SMALL / _TLSF_SL_INDEX_COUNT);
+	} else {
+		int msb = find_msb_set(size) - 1;
+
+		*sl = (size >> (msb - _TLSF_SL_INDEX_LOG2)) ^
+		      _TLSF_SL_INDEX_COUNT;
+		*fl = msb - _TLSF_FL_INDEX_SHIFT + 1;
+	}
+}
+
+/**
+ *
+ * @brief Compute the first free lists in which all blocks fit a size
+ *
+ * The size is rounded up to the next list boundary, so that any block of the
+ * lists found can be used without having to search through them.
+ *
+ * @return 0 on success, -ENOMEM if no list can hold such a block
+ */
+static int mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= BLOCK_SIZE_SMALL) {
+		int msb = find_msb_set(size) - 1;
+
+		size += (1 << (msb - _TLSF_SL_INDEX_LOG2)) - 1;
+	}
+
+	if (size > BLOCK_SIZE_MAX) {
+		return -ENOMEM;
+	}
+
+	mapping_insert(size, fl, sl);
+
+	return 0;
+}
+
+static void insert_free_block(struct k_mem_pool *pool,
+			      struct _tlsf_block *block)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+
+	block->size |= BLOCK_FREE;
+	block->prev_free = NULL;
+	block->next_free = pool->free_q[fl][sl];
+	if (block->next_free) {
+		block->next_free->prev_free = block;
+	}
+	pool->free_q[fl][sl] = block;
+
+	pool->fl_bmap |= (1 << fl);
+	pool->sl_bmap[fl] |= (1 << sl);
+}
+
+static void remove_free_block(struct k_mem_pool *pool,
+			      struct _tlsf_block *block)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(block), &fl, &sl);
+
+	if (block->next_free) {
+		block->next_free->prev_free = block->prev_free;
+	}
+
+	if (block->prev_free) {
+		block->prev_free->next_free = block->next_free;
+	} else {
+		pool->free_q[fl][sl] = block->next_free;
+		if (!pool->free_q[fl][sl]) {
+			pool->sl_bmap[fl] &= ~(1 << sl);
+			if (!pool->sl_bmap[fl]) {
+				pool->fl_bmap &= ~(1 << fl);
+			}
+		}
+	}
+
+	block->size &= ~BLOCK_FREE;
+}
+
+/**
+ *
+ * @brief Find a free block in the first non-empty list at or above (fl, sl)
+ *
+ * @return pointer to the free block, or NULL if none available
+ */
+static struct _tlsf_block *find_suitable_block(struct k_mem_pool *pool,
+					      int fl, int sl)
+{
+	uint32_t sl_map = pool->sl_bmap[fl] & (~0U << sl);
+
+	if (!sl_map) {
+		uint32_t fl_map = pool->fl_bmap & (~0U << (fl + 1));
+
+		if (!fl_map) {
+			return NULL;
+		}
+
+		fl = find_lsb_set(fl_map) - 1;
+		sl_map = pool->sl_bmap[fl];
+	}
+
+	sl = find_lsb_set(sl_map) - 1;
+
+	return pool->free_q[fl][sl];
+}
+
+/**
+ *
+ * @brief Give back the tail of a block beyond the specified size
+ *
+ * The tail is only split off if it is big enough to be a block of its own.
+ *
+ * @return N/A
+ */
+static void trim_block(struct k_mem_pool *pool, struct _tlsf_block *block,
+		       size_t size)
+{
+	struct _tlsf_block *remainder;
+
+	if (block_size(block) - size < BLOCK_SIZE_MIN) {
+		return;
+	}
+
+	remainder = (struct _tlsf_block *)((char *)block + size);
+	remainder->size = block_size(block) - size;
+	remainder->prev_phys = block;
+	block_next(remainder)->prev_phys = remainder;
+	block->size = size | (block->size & BLOCK_FREE);
+
+	insert_free_block(pool, remainder);
+}
+
+/**
+ *
+ * @brief Merge a block with its free physical neighbours
+ *
+ * Neighbours are not merged if the resulting block would be too big for the
+ * free lists, which can only happen in pools bigger than BLOCK_SIZE_MAX.
+ *
+ * @return the resulting block, not on any free list
+ */
+static struct _tlsf_block *merge_block(struct k_mem_pool *pool,
+				       struct _tlsf_block *block)
+{
+	struct _tlsf_block *next = block_next(block);
+	struct _tlsf_block *prev = block->prev_phys;
+
+	if (block_is_free(next) &&
+	    block_size(block) + block_size(next) <= BLOCK_SIZE_MAX) {
+		remove_free_block(pool, next);
+		block->size += next->size;
+		block_next(block)->prev_phys = block;
+	}
+
+	if (prev && block_is_free(prev) &&
+	    block_size(prev) + block_size(block) <= BLOCK_SIZE_MAX) {
+		remove_free_block(pool, prev);
+		prev->size += block->size;
+		block_next(prev)->prev_phys = prev;
+		block = prev;
+	}
+
+	return block;
+}
+
+/**
+ *
+ * @brief Allocate a block from a pool
+ *
+ * Must be called with interrupts locked.
+ *
+ * @return pointer to the user data of the block, or NULL if none available
+ */
+static void *get_block(struct k_mem_pool *pool, size_t data_size)
+{
+	struct _tlsf_block *block;
+	size_t size;
+	int fl, sl;
+
+	size = max(ROUND_UP(data_size, _TLSF_ALIGN) + _TLSF_BLOCK_OVERHEAD,
+		   BLOCK_SIZE_MIN);
+
+	if (size > BLOCK_SIZE_MAX) {
+		return NULL;
+	}
+
+	block = NULL;
+	if (mapping_search(size, &fl, &sl) == 0) {
+		block = find_suitable_block(pool, fl, sl);
+	}
+
+	if (!block) {
+		/*
+		 * The blocks of the list the size falls in are not all big
+		 * enough, but its first one might be: this allows, e.g.,
+		 * allocating the very last max_size block of a pool.
+		 */
+		mapping_insert(size, &fl, &sl);
+		block = pool->free_q[fl][sl];
+		if (!block || block_size(block) < size) {
+			return NULL;
+		}
+	}
+
+	remove_free_block(pool, block);
+	trim_block(pool, block, size);
+
+	return block_to_ptr(block);
+}
+
+/**
+ *
+ * @brief Initialize the memory pool
+ *
+ * Carve the buffer in free blocks no bigger than what the free lists can
+ * hold, followed by the sentinel block.
+ *
+ * @param pool memory pool descriptor
+ *
+ * @return N/A
+ */
+static void init_one_memory_pool(struct k_mem_pool *pool)
+{
+	struct _tlsf_block *prev = NULL;
+	struct _tlsf_block *block = (struct _tlsf_block *)pool->bufblock;
+	size_t remaining = pool->buf_size - _TLSF_BLOCK_OVERHEAD;
+
+	while (remaining >= BLOCK_SIZE_MIN) {
+		size_t size = min(remaining, BLOCK_SIZE_MAX);
+
+		/* do not leave a tail too small to be a block */
+		if (remaining - size != 0 &&
+		    remaining - size < BLOCK_SIZE_MIN) {
+			size -= BLOCK_SIZE_MIN;
+		}
+
+		block->prev_phys = prev;
+		block->size = size;
+		insert_free_block(pool, block);
+
+		remaining -= size;
+		prev = block;
+		block = block_next(block);
+	}
+
+	/* the sentinel absorbs any leftover bytes and is never free */
+	block->prev_phys = prev;
+	block->size = remaining + _TLSF_BLOCK_OVERHEAD;
+
+	_waitq_init(&pool->wait_q);
+	SYS_TRACING_OBJ_INIT(k_mem_pool, pool);
+}
+
+/**
+ *
+ * @brief Initialize kernel memory pool subsystem
+ *
+ * Perform any initialization of memory pool that wasn't done at build time.
+ *
+ * @return N/A
+ */
+static int init_static_pools(struct device *unused)
+{
+	ARG_UNUSED(unused);
+	struct k_mem_pool *pool;
+
+	/* perform initialization for each memory pool */
+
+	for (pool = _k_mem_pool_list_start;
+	     pool < _k_mem_pool_list_end;
+	     pool++) {
+		init_one_memory_pool(pool);
+	}
+	return 0;
+}
+
+SYS_INIT(init_static_pools, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+/**
+ *
+ * @brief Examine threads that are waiting for memory pool blocks.
+ *
+ * This routine attempts to satisfy any incomplete block allocation requests for
+ * the specified memory pool. It is invoked by the explicit freeing of a used
+ * block.
+ *
+ * @return N/A
+ */
+static void block_waiters_check(struct k_mem_pool *pool)
+{
+	void *found_block;
+	struct k_thread *waiter;
+	struct k_thread *next_waiter;
+
+	unsigned int key = irq_lock();
+
+	waiter = (struct k_thread *)sys_dlist_peek_head(&pool->wait_q.waitq);
+
+	/* loop all waiters */
+	while (waiter != NULL) {
+		uint32_t req_size = (uint32_t)(waiter->base.swap_data);
+
+		found_block = get_block(pool, req_size);
+
+		next_waiter = (struct k_thread *)sys_dlist_peek_next(
+			&pool->wait_q.waitq, &waiter->base.k_q_node);
+
+		/* if success : remove task from list and reschedule */
+		if (found_block != NULL) {
+			/* return found block */
+			_set_thread_return_value_with_data(waiter, 0,
+							   found_block);
+
+			/*
+			 * Schedule the thread. Threads will be rescheduled
+			 * outside the function by k_sched_unlock()
+			 */
+			_unpend_thread(waiter);
+			_abort_thread_timeout(waiter);
+			_ready_thread(waiter);
+		}
+		waiter = next_waiter;
+	}
+	irq_unlock(key);
+}
+
+void k_mem_pool_defrag(struct k_mem_pool *pool)
+{
+	/* blocks are merged as soon as they are freed: nothing to do */
+	ARG_UNUSED(pool);
+}
+
+int k_mem_pool_alloc(struct k_mem_pool *pool, struct k_mem_block *block,
+		     size_t size, int32_t timeout)
+{
+	void *found_block;
+	unsigned int key = irq_lock();
+
+	found_block = get_block(pool, size);
+
+	if (found_block != NULL) {
+		irq_unlock(key);
+		block->pool_id = pool;
+		block->addr_in_pool = found_block;
+		block->data = found_block;
+		block->req_size = size;
+		return 0;
+	}
+
+	/*
+	 * no suitable block is currently available,
+	 * so either wait for one to appear or indicate failure
+	 */
+	if (likely(timeout != K_NO_WAIT)) {
+		int result;
+
+		_current->base.swap_data = (void *)size;
+		_pend_current_thread(&pool->wait_q, timeout);
+		result = _Swap(key);
+		if (result == 0) {
+			block->pool_id = pool;
+			block->addr_in_pool = _current->base.swap_data;
+			block->data = _current->base.swap_data;
+			block->req_size = size;
+		}
+		return result;
+	}
+
+	irq_unlock(key);
+	return -ENOMEM;
+}
+
+void k_mem_pool_free(struct k_mem_block *block)
+{
+	struct k_mem_pool *pool = block->pool_id;
+	struct _tlsf_block *tlsf_block = block_from_ptr(block->addr_in_pool);
+	unsigned int key;
+
+	__ASSERT(!block_is_free(tlsf_block),
+		 "Attempt to free unallocated memory pool block\n");
+
+	_sched_lock();
+
+	key = irq_lock();
+	insert_free_block(pool, merge_block(pool, tlsf_block));
+	irq_unlock(key);
+
+	/* reschedule anybody waiting for a block */
+	if (!sys_dlist_is_empty(&pool->wait_q.waitq)) {
+		block_waiters_check(pool);
+	}
+	k_sched_unlock();
+}
@@ -19,6 +19,91 @@ extern struct k_mem_slab _k_mem_slab_list_end[];
 
 struct k_mem_slab *_trace_list_k_mem_slab;
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+/*
+ * The free blocks form a Treiber stack. Its head packs the index of the top
+ * block (plus one, so that zero means empty) with a tag bumped by every
+ * update, which makes a compare-and-swap fail if the stack was popped and
+ * pushed back to the same block in the meantime (ABA). Each free block
+ * holds the index of the next one in its first word.
+ */
+#define FREE_INDEX_MASK 0xffff
+#define FREE_TAG_INC 0x10000
+
+static inline char *free_block(struct k_mem_slab *slab, uint32_t index)
+{
+	return slab->buffer + (index - 1) * slab->block_size;
+}
+
+static char *free_pop(struct k_mem_slab *slab)
+{
+	uint32_t head, index, next;
+
+	do {
+		head = (uint32_t)atomic_get(&slab->free_head);
+		index = head & FREE_INDEX_MASK;
+		if (index == 0) {
+			return NULL;
+		}
+		/*
+		 * The block may be allocated and overwritten by a preempting
+		 * context before the swap, in which case the tag changed and
+		 * the link read here is discarded.
+		 */
+		next = *(volatile uint32_t *)free_block(slab, index);
+		next = ((head & ~FREE_INDEX_MASK) + FREE_TAG_INC) |
+		       (next & FREE_INDEX_MASK);
+	} while (!atomic_cas(&slab->free_head, head, next));
+
+	atomic_inc((atomic_t *)&slab->num_used);
+
+	return free_block(slab, index);
+}
+
+static void free_push(struct k_mem_slab *slab, char *block)
+{
+	uint32_t index = (block - slab->buffer) / slab->block_size + 1;
+	uint32_t head;
+
+	atomic_dec((atomic_t *)&slab->num_used);
+
+	do {
+		head = (uint32_t)atomic_get(&slab->free_head);
+		*(volatile uint32_t *)block = head & FREE_INDEX_MASK;
+	} while (!atomic_cas(&slab->free_head, head,
+			     ((head & ~FREE_INDEX_MASK) + FREE_TAG_INC) |
+			     index));
+}
+
+/**
+ * @brief Initialize kernel memory slab subsystem.
+ *
+ * Perform any initialization of memory slabs that wasn't done at build time.
+ * Currently this just involves creating the list of free blocks for each slab.
+ *
+ * @return N/A
+ */
+static void create_free_list(struct k_mem_slab *slab)
+{
+	uint32_t j;
+	char *p;
+
+	__ASSERT(slab->num_blocks <= FREE_INDEX_MASK,
+		 "too many blocks for a lock-free slab");
+
+	slab->free_list = NULL;
+	atomic_set(&slab->free_head, 0);
+	atomic_set(&slab->num_waiters, 0);
+	p = slab->buffer;
+
+	for (j = 0; j < slab->num_blocks; j++) {
+		*(uint32_t *)p = j;
+		p += slab->block_size;
+	}
+
+	atomic_set(&slab->free_head, slab->num_blocks);
+}
+#else
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -41,6 +126,7 @@ static void create_free_list(struct k_mem_slab *slab)
 		p += slab->block_size;
 	}
 }
+#endif /* CONFIG_MEM_SLAB_LOCKLESS */
 
 /**
  * @brief Complete initialization of statically defined memory slabs.
@@ -75,10 +161,87 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->buffer = buffer;
 	slab->num_used = 0;
 	create_free_list(slab);
-	sys_dlist_init(&slab->wait_q);
+	_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, int32_t timeout)
+{
+	unsigned int key;
+	int result;
+
+	*mem = free_pop(slab);
+	if (*mem != NULL) {
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		/* don't wait for a free block to become available */
+		return -ENOMEM;
+	}
+
+	/*
+	 * Announce the waiter before looking at the stack one last time:
+	 * a block pushed after that is seen by the freeing context, which
+	 * then hands it over through the slow path.
+	 */
+	key = irq_lock();
+	atomic_inc(&slab->num_waiters);
+
+	*mem = free_pop(slab);
+	if (*mem != NULL) {
+		atomic_dec(&slab->num_waiters);
+		irq_unlock(key);
+		return 0;
+	}
+
+	/* wait for a free block or timeout */
+	_pend_current_thread(&slab->wait_q, timeout);
+	result = _Swap(key);
+	atomic_dec(&slab->num_waiters);
+	if (result == 0) {
+		*mem = _current->base.swap_data;
+	}
+
+	return result;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	struct k_thread *pending_thread;
+	unsigned int key;
+	char *block;
+
+	free_push(slab, *mem);
+
+	if (atomic_get(&slab->num_waiters) == 0) {
+		return;
+	}
+
+	/* hand free blocks over to the threads waiting for one */
+	key = irq_lock();
+
+	while ((pending_thread = _find_first_thread_to_unpend(&slab->wait_q,
+							      NULL))) {
+		block = free_pop(slab);
+		if (block == NULL) {
+			break;
+		}
+		_unpend_thread(pending_thread);
+		_set_thread_return_value_with_data(pending_thread, 0, block);
+		_abort_thread_timeout(pending_thread);
+		_ready_thread(pending_thread);
+	}
+
+	if (!_is_in_isr() && _must_switch_threads()) {
+		_Swap(key);
+		return;
+	}
+
+	irq_unlock(key);
+}
+#else
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, int32_t timeout)
 {
 	unsigned int key = irq_lock();
@@ -130,3 +293,4 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 
 	irq_unlock(key);
 }
+#endif /* CONFIG_MEM_SLAB_LOCKLESS */
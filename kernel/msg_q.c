@@ -56,126 +56,352 @@ void k_msgq_init(struct k_msgq *q, char *buffer,
 	q->read_ptr = buffer;
 	q->write_ptr = buffer;
 	q->used_msgs = 0;
-	sys_dlist_init(&q->wait_q);
+	q->put_claim = NULL;
+	q->unseen_msgs = 0;
+	q->get_claim = NULL;
+	q->held_msgs = 0;
+	_waitq_init(&q->wait_q);
+	_waitq_init(&q->put_wait_q);
 	SYS_TRACING_OBJ_INIT(k_msgq, q);
 }
 
+/*
+ * In ring buffer order, starting from the oldest slot in use, the slots of a
+ * message queue hold:
+ *
+ * - the message claimed by the consumer, and the ones received after it,
+ *   which cannot be reused until the claimed message is released
+ *   (held_msgs slots, starting at get_claim);
+ * - the messages that can be received (used_msgs slots, from read_ptr);
+ * - the message claimed by a producer, and the ones sent after it, which
+ *   can only be received once the claimed message is committed
+ *   (1 + unseen_msgs slots, starting at put_claim);
+ * - free space, starting at write_ptr.
+ *
+ * All the routines below must be called with interrupts locked.
+ */
+
+static char *msgq_next(struct k_msgq *q, char *slot)
+{
+	slot += q->msg_size;
+	if (slot == q->buffer_end) {
+		slot = q->buffer_start;
+	}
+
+	return slot;
+}
+
+static uint32_t msgq_free(struct k_msgq *q)
+{
+	uint32_t busy = q->held_msgs + q->used_msgs;
+
+	if (q->put_claim) {
+		busy += 1 + q->unseen_msgs;
+	}
+
+	return q->max_msgs - busy;
+}
+
+/* take the free slot at write_ptr, for a message sent or claimed */
+static char *msgq_push(struct k_msgq *q, int claim)
+{
+	char *slot = q->write_ptr;
+
+	q->write_ptr = msgq_next(q, slot);
+
+	if (claim) {
+		q->put_claim = slot;
+	} else if (q->put_claim) {
+		q->unseen_msgs++;
+	} else {
+		q->used_msgs++;
+	}
+
+	return slot;
+}
+
+/* take the message at read_ptr, for it to be received or claimed */
+static char *msgq_pop(struct k_msgq *q, int claim)
+{
+	char *slot = q->read_ptr;
+
+	q->read_ptr = msgq_next(q, slot);
+	q->used_msgs--;
+
+	if (claim) {
+		q->get_claim = slot;
+	}
+
+	if (q->get_claim) {
+		q->held_msgs++;
+	}
+
+	return slot;
+}
+
+static void msgq_wake(struct k_thread *thread)
+{
+	_set_thread_return_value(thread, 0);
+	_abort_thread_timeout(thread);
+	_ready_thread(thread);
+}
+
+/*
+ * Give the messages that can be received to the threads waiting for them.
+ * A thread waiting to claim a message has no swap_data, and is given the
+ * address of the message instead.
+ */
+static void msgq_serve_readers(struct k_msgq *q)
+{
+	struct k_thread *thread;
+
+	while (q->used_msgs) {
+		thread = _find_first_thread_to_unpend(&q->wait_q, NULL);
+		if (!thread || (!thread->base.swap_data && q->get_claim)) {
+			/* keep the order of the waiting threads */
+			break;
+		}
+
+		_unpend_thread(thread);
+
+		if (thread->base.swap_data) {
+			memcpy(thread->base.swap_data, msgq_pop(q, 0),
+			       q->msg_size);
+		} else {
+			thread->base.swap_data = msgq_pop(q, 1);
+		}
+
+		msgq_wake(thread);
+	}
+}
+
+/* give the free slots to the threads waiting to send or claim a message */
+static void msgq_serve_writers(struct k_msgq *q)
+{
+	struct k_thread *thread;
+
+	while (msgq_free(q)) {
+		thread = _find_first_thread_to_unpend(&q->put_wait_q, NULL);
+		if (!thread || (!thread->base.swap_data && q->put_claim)) {
+			break;
+		}
+
+		_unpend_thread(thread);
+
+		if (thread->base.swap_data) {
+			memcpy(msgq_push(q, 0), thread->base.swap_data,
+			       q->msg_size);
+		} else {
+			thread->base.swap_data = msgq_push(q, 1);
+		}
+
+		msgq_wake(thread);
+	}
+}
+
+static void msgq_reschedule(unsigned int key)
+{
+	if (!_is_in_isr() && _must_switch_threads()) {
+		_Swap(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
 int k_msgq_put(struct k_msgq *q, void *data, int32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
 	unsigned int key = irq_lock();
 	struct k_thread *pending_thread;
-	int result;
 
-	if (q->used_msgs < q->max_msgs) {
+	if (msgq_free(q)) {
 		/* message queue isn't full */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread) {
+		pending_thread = _find_first_thread_to_unpend(&q->wait_q,
+							      NULL);
+		if (pending_thread && pending_thread->base.swap_data &&
+		    !q->put_claim) {
 			/* give message to waiting thread */
+			_unpend_thread(pending_thread);
 			memcpy(pending_thread->base.swap_data, data,
 			       q->msg_size);
 			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_abort_thread_timeout(pending_thread);
-			_ready_thread(pending_thread);
-			if (!_is_in_isr() && _must_switch_threads()) {
-				_Swap(key);
-				return 0;
-			}
+			msgq_wake(pending_thread);
 		} else {
 			/* put message in queue */
-			memcpy(q->write_ptr, data, q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
+			memcpy(msgq_push(q, 0), data, q->msg_size);
+			msgq_serve_readers(q);
 		}
-		result = 0;
+		msgq_reschedule(key);
+		return 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for message space to become available */
-		result = -ENOMSG;
-	} else {
-		/* wait for put message success, failure, or timeout */
-		_pend_current_thread(&q->wait_q, timeout);
-		_current->base.swap_data = data;
-		return _Swap(key);
+		irq_unlock(key);
+		return -ENOMSG;
+	}
+
+	/* wait for put message success, failure, or timeout */
+	_pend_current_thread(&q->put_wait_q, timeout);
+	_current->base.swap_data = data;
+	return _Swap(key);
+}
+
+int k_msgq_alloc_claim(struct k_msgq *q, void **msg, int32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	int result;
+
+	if (q->put_claim) {
+		/* a message is already being written */
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (msgq_free(q)) {
+		*msg = msgq_push(q, 1);
+		irq_unlock(key);
+		return 0;
+	} else if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -ENOMSG;
 	}
 
-	irq_unlock(key);
+	/* wait for a slot to be given, failure, or timeout */
+	_pend_current_thread(&q->put_wait_q, timeout);
+	_current->base.swap_data = NULL;
+	result = _Swap(key);
+	if (result == 0) {
+		*msg = _current->base.swap_data;
+	}
 
 	return result;
 }
 
+void k_msgq_commit(struct k_msgq *q)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(q->put_claim, "no message claimed by the producer");
+
+	q->used_msgs += 1 + q->unseen_msgs;
+	q->unseen_msgs = 0;
+	q->put_claim = NULL;
+
+	msgq_serve_readers(q);
+	/* threads may wait to claim the next message */
+	msgq_serve_writers(q);
+	msgq_reschedule(key);
+}
+
 int k_msgq_get(struct k_msgq *q, void *data, int32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
 	unsigned int key = irq_lock();
-	struct k_thread *pending_thread;
-	int result;
 
 	if (q->used_msgs > 0) {
 		/* take first available message from queue */
-		memcpy(data, q->read_ptr, q->msg_size);
-		q->read_ptr += q->msg_size;
-		if (q->read_ptr == q->buffer_end) {
-			q->read_ptr = q->buffer_start;
-		}
-		q->used_msgs--;
+		memcpy(data, msgq_pop(q, 0), q->msg_size);
 
 		/* handle first thread waiting to write (if any) */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread) {
-			/* add thread's message to queue */
-			memcpy(q->write_ptr, pending_thread->base.swap_data,
-			       q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
-
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_abort_thread_timeout(pending_thread);
-			_ready_thread(pending_thread);
-			if (!_is_in_isr() && _must_switch_threads()) {
-				_Swap(key);
-				return 0;
-			}
-		}
-		result = 0;
+		msgq_serve_writers(q);
+		msgq_reschedule(key);
+		return 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a message to become available */
-		result = -ENOMSG;
-	} else {
-		/* wait for get message success or timeout */
-		_pend_current_thread(&q->wait_q, timeout);
-		_current->base.swap_data = data;
-		return _Swap(key);
+		irq_unlock(key);
+		return -ENOMSG;
+	}
+
+	/* wait for get message success or timeout */
+	_pend_current_thread(&q->wait_q, timeout);
+	_current->base.swap_data = data;
+	return _Swap(key);
+}
+
+int k_msgq_peek_claim(struct k_msgq *q, void **msg, int32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	int result;
+
+	if (q->get_claim) {
+		/* a message is already being read */
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (q->used_msgs > 0) {
+		*msg = msgq_pop(q, 1);
+		irq_unlock(key);
+		return 0;
+	} else if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -ENOMSG;
 	}
 
-	irq_unlock(key);
+	/* wait for a message to be given, or timeout */
+	_pend_current_thread(&q->wait_q, timeout);
+	_current->base.swap_data = NULL;
+	result = _Swap(key);
+	if (result == 0) {
+		*msg = _current->base.swap_data;
+	}
 
 	return result;
 }
 
+void k_msgq_release(struct k_msgq *q)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(q->get_claim, "no message claimed by the consumer");
+
+	q->get_claim = NULL;
+	q->held_msgs = 0;
+
+	msgq_serve_writers(q);
+	/* threads may wait to claim the next message */
+	msgq_serve_readers(q);
+	msgq_reschedule(key);
+}
+
 void k_msgq_purge(struct k_msgq *q)
 {
 	unsigned int key = irq_lock();
 	struct k_thread *pending_thread;
 
 	/* wake up any threads that are waiting to write */
+	while ((pending_thread = _unpend_first_thread(&q->put_wait_q)) !=
+	       NULL) {
+		_set_thread_return_value(pending_thread, -ENOMSG);
+		_abort_thread_timeout(pending_thread);
+		_ready_thread(pending_thread);
+	}
+
 	while ((pending_thread = _unpend_first_thread(&q->wait_q)) != NULL) {
 		_set_thread_return_value(pending_thread, -ENOMSG);
 		_abort_thread_timeout(pending_thread);
 		_ready_thread(pending_thread);
 	}
 
+	if (q->get_claim) {
+		/* the slots stay behind the claimed message until released */
+		q->held_msgs += q->used_msgs;
+	}
 	q->used_msgs = 0;
-	q->read_ptr = q->write_ptr;
+
+	if (q->put_claim) {
+		/* the claimed message is kept, the ones sent after it are not */
+		q->unseen_msgs = 0;
+		q->read_ptr = q->put_claim;
+		q->write_ptr = msgq_next(q, q->put_claim);
+	} else {
+		q->read_ptr = q->write_ptr;
+	}
 
 	_reschedule_threads(key);
 }
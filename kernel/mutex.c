@@ -24,15 +24,22 @@
  * When releasing the mutex, thread A must release M2 before it releases M1.
  * Failure to follow this nested model may result in threads running at
  * unexpected priority levels (too high, or too low).
+ *
+ * With CONFIG_MUTEX_PI_CHAIN, each thread instead keeps the mutexes it owns
+ * that have waiters, sorted by the priority of their first waiter, which
+ * lifts these restrictions. The priority of a thread pending on a mutex is
+ * also carried to the owner of that mutex, along the chain of owners.
  */
 
 #include <kernel.h>
 #include <kernel_structs.h>
+#include <ksched.h>
 #include <toolchain.h>
 #include <sections.h>
 #include <wait_q.h>
 #include <misc/dlist.h>
 #include <debug/object_tracing_common.h>
+#include <debug/tracing.h>
 #include <errno.h>
 #include <init.h>
 
@@ -89,7 +96,11 @@ void k_mutex_init(struct k_mutex *mutex)
 	/* initialized upon first use */
 	/* mutex->owner_orig_prio = 0; */
 
-	sys_dlist_init(&mutex->wait_q);
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	mutex->owner_node.next = NULL;
+#endif
+
+	_waitq_init(&mutex->wait_q);
 
 	SYS_TRACING_OBJ_INIT(k_mutex, mutex);
 	INIT_OBJECT_MONITOR(mutex);
@@ -104,6 +115,122 @@ static int new_prio_for_inheritance(int target, int limit)
 	return new_prio;
 }
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+/* Takes the mutex out of the list of its owner */
+static void pi_mutex_unlink(struct k_mutex *mutex)
+{
+	if (mutex->owner_node.next) {
+		sys_dlist_remove(&mutex->owner_node);
+		mutex->owner_node.next = NULL;
+	}
+}
+
+/* Places the mutex in the list of its owner by priority of its first
+ * waiter, the waiters pending on it being sorted by priority already
+ */
+static void pi_mutex_requeue(struct k_mutex *mutex)
+{
+	struct k_thread *waiter = _peek_first_pending_thread(&mutex->wait_q);
+	sys_dlist_t *owned = &mutex->owner->base.pi_mutexes;
+	struct k_mutex *next;
+
+	pi_mutex_unlink(mutex);
+
+	if (!waiter) {
+		return;
+	}
+
+	mutex->waiter_prio = waiter->base.prio;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(owned, next, owner_node) {
+		if (_is_prio_higher(mutex->waiter_prio, next->waiter_prio)) {
+			sys_dlist_insert_before(owned, &next->owner_node,
+						&mutex->owner_node);
+			return;
+		}
+	}
+
+	sys_dlist_append(owned, &mutex->owner_node);
+}
+
+/* Moves a waiter whose priority changed to its place in the wait queue */
+static void pi_waiter_requeue(struct k_mutex *mutex, struct k_thread *thread)
+{
+#ifdef CONFIG_WAITQ_BUCKETS
+	/* done by _thread_priority_set() */
+	ARG_UNUSED(mutex);
+	ARG_UNUSED(thread);
+#else
+	sys_dlist_t *wait_q_list = &mutex->wait_q.waitq;
+	sys_dnode_t *node;
+
+	sys_dlist_remove(&thread->base.k_q_node);
+
+	SYS_DLIST_FOR_EACH_NODE(wait_q_list, node) {
+		struct k_thread *pending = (struct k_thread *)node;
+
+		if (_is_t1_higher_prio_than_t2(thread, pending)) {
+			sys_dlist_insert_before(wait_q_list, node,
+						&thread->base.k_q_node);
+			return;
+		}
+	}
+
+	sys_dlist_append(wait_q_list, &thread->base.k_q_node);
+#endif
+}
+
+/*
+ * Sets the priority of a thread to the highest of its own one and of the
+ * first waiter of the mutexes it owns, then carries the change to the owner
+ * of the mutex the thread pends on, and so on, until a priority does not
+ * change or CONFIG_MUTEX_PI_CHAIN_DEPTH owners have been updated.
+ */
+/* must be called with interrupts locked */
+static void pi_chain_update(struct k_thread *thread)
+{
+	int depth = CONFIG_MUTEX_PI_CHAIN_DEPTH;
+	struct k_mutex *first, *mutex;
+	int new_prio;
+
+	while (thread && depth--) {
+		first = SYS_DLIST_PEEK_HEAD_CONTAINER(&thread->base.pi_mutexes,
+						      first, owner_node);
+		new_prio = thread->base.pi_base_prio;
+
+		if (first && _is_prio_higher(first->waiter_prio, new_prio)) {
+			new_prio = new_prio_for_inheritance(first->waiter_prio,
+							    new_prio);
+		}
+
+		if (new_prio == thread->base.prio) {
+			return;
+		}
+
+		K_DEBUG("%p prio changed to %d (was %d)\n",
+			thread, new_prio, thread->base.prio);
+
+		_thread_priority_set(thread, new_prio);
+
+		/* a thread that timed out is not pending anymore */
+		mutex = thread->base.pi_blocked_on;
+		if (!mutex || !_is_thread_pending(thread)) {
+			return;
+		}
+
+		pi_waiter_requeue(mutex, thread);
+		pi_mutex_requeue(mutex);
+
+		thread = mutex->owner;
+	}
+}
+
+void _mutex_pi_prio_set(struct k_thread *thread, int prio)
+{
+	thread->base.pi_base_prio = prio;
+	pi_chain_update(thread);
+}
+#else
 static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
 {
 	if (mutex->owner->base.prio != new_prio) {
@@ -116,10 +243,16 @@ static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
 		_thread_priority_set(mutex->owner, new_prio);
 	}
 }
+#endif /* CONFIG_MUTEX_PI_CHAIN */
 
 int k_mutex_lock(struct k_mutex *mutex, int32_t timeout)
 {
-	int new_prio, key;
+	int key;
+#ifndef CONFIG_MUTEX_PI_CHAIN
+	int new_prio;
+#endif
+
+	sys_trace_mutex_lock(mutex, timeout);
 
 	_sched_lock();
 
@@ -156,6 +289,16 @@ int k_mutex_lock(struct k_mutex *mutex, int32_t timeout)
 	}
 	new_prio = _get_new_prio_with_ceiling(new_prio);
 #endif
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	key = irq_lock();
+
+	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
+
+	_pend_current_thread(&mutex->wait_q, timeout);
+	_current->base.pi_blocked_on = mutex;
+	pi_mutex_requeue(mutex);
+	pi_chain_update(mutex->owner);
+#else
 	new_prio = new_prio_for_inheritance(_current->base.prio,
 					    mutex->owner->base.prio);
 
@@ -168,6 +311,7 @@ int k_mutex_lock(struct k_mutex *mutex, int32_t timeout)
 	}
 
 	_pend_current_thread(&mutex->wait_q, timeout);
+#endif
 
 	int got_mutex = _Swap(key);
 
@@ -185,8 +329,19 @@ int k_mutex_lock(struct k_mutex *mutex, int32_t timeout)
 
 	K_DEBUG("%p timeout on mutex %p\n", _current, mutex);
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
+
+	key = irq_lock();
+	_current->base.pi_blocked_on = NULL;
+	if (mutex->owner) {
+		pi_mutex_requeue(mutex);
+		pi_chain_update(mutex->owner);
+	}
+	irq_unlock(key);
+#else
 	struct k_thread *waiter =
-		(struct k_thread *)sys_dlist_peek_head(&mutex->wait_q);
+		(struct k_thread *)sys_dlist_peek_head(&mutex->wait_q.waitq);
 
 	new_prio = mutex->owner_orig_prio;
 	new_prio = waiter ? new_prio_for_inheritance(waiter->base.prio,
@@ -197,6 +352,7 @@ int k_mutex_lock(struct k_mutex *mutex, int32_t timeout)
 	key = irq_lock();
 	adjust_owner_prio(mutex, new_prio);
 	irq_unlock(key);
+#endif
 
 	k_sched_unlock();
 
@@ -210,6 +366,8 @@ void k_mutex_unlock(struct k_mutex *mutex)
 	__ASSERT(mutex->lock_count > 0, "");
 	__ASSERT(mutex->owner == _current, "");
 
+	sys_trace_mutex_unlock(mutex);
+
 	_sched_lock();
 
 	RECORD_STATE_CHANGE();
@@ -225,7 +383,12 @@ void k_mutex_unlock(struct k_mutex *mutex)
 
 	key = irq_lock();
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	pi_mutex_unlink(mutex);
+	pi_chain_update(_current);
+#else
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
+#endif
 
 	struct k_thread *new_owner = _unpend_first_thread(&mutex->wait_q);
 
@@ -236,6 +399,14 @@ void k_mutex_unlock(struct k_mutex *mutex)
 		_abort_thread_timeout(new_owner);
 		_ready_thread(new_owner);
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+		/* inherits from the waiters left */
+		new_owner->base.pi_blocked_on = NULL;
+		mutex->owner = new_owner;
+		pi_mutex_requeue(mutex);
+		pi_chain_update(new_owner);
+#endif
+
 		irq_unlock(key);
 
 		_set_thread_return_value(new_owner, 0);
@@ -18,6 +18,10 @@
 #include <wait_q.h>
 #include <misc/dlist.h>
 #include <init.h>
+#include <string.h>
+#ifdef CONFIG_PIPE_DMA
+#include <dma.h>
+#endif
 
 struct k_pipe_desc {
 	unsigned char *buffer;           /* Position in src/dest buffer */
@@ -131,8 +135,12 @@ void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->bytes_used = 0;
 	pipe->read_index = 0;
 	pipe->write_index = 0;
-	sys_dlist_init(&pipe->wait_q.writers);
-	sys_dlist_init(&pipe->wait_q.readers);
+	_waitq_init(&pipe->wait_q.writers);
+	_waitq_init(&pipe->wait_q.readers);
+#ifdef CONFIG_PIPE_DMA
+	pipe->dma.dev = NULL;
+	pipe->dma.busy = 0;
+#endif
 	SYS_TRACING_OBJ_INIT(k_pipe, pipe);
 }
 
@@ -145,17 +153,140 @@ static size_t _pipe_xfer(unsigned char *dest, size_t dest_size,
 			 const unsigned char *src, size_t src_size)
 {
 	size_t num_bytes = min(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
-	}
+	memcpy(dest, src, num_bytes);
 
 	return num_bytes;
 }
 
+#ifdef CONFIG_PIPE_DMA
+
+/* A copy from a writer to a reader offloaded to the DMA channel of a pipe */
+struct k_pipe_dma_xfer {
+	sys_snode_t       node;     /* In the list of running transfers */
+	struct k_pipe    *pipe;
+	struct k_thread  *reader;   /* Reader to wake up once done */
+	unsigned char    *dest;
+	const unsigned char *src;
+	size_t            size;
+	int               error;
+	struct k_sem      done;
+};
+
+/* transfers in progress, for the DMA callback to find them by channel */
+static sys_slist_t pipe_dma_xfers;
+
+void k_pipe_dma_set(struct k_pipe *pipe, struct device *dev,
+		    uint32_t channel, size_t min_xfer)
+{
+	unsigned int key = irq_lock();
+
+	pipe->dma.dev = dev;
+	pipe->dma.channel = channel;
+	pipe->dma.min_xfer = min_xfer;
+
+	irq_unlock(key);
+}
+
+/**
+ * @brief Try to reserve the DMA channel of a pipe for a transfer
+ *
+ * Must be called with the scheduler locked.
+ *
+ * @return true if the transfer is to be offloaded, otherwise false
+ */
+static bool _pipe_dma_claim(struct k_pipe *pipe, size_t size)
+{
+	if (!pipe->dma.dev || pipe->dma.busy || size < pipe->dma.min_xfer) {
+		return false;
+	}
+
+	pipe->dma.busy = 1;
+
+	return true;
+}
+
+static void _pipe_dma_done(struct device *dev, uint32_t channel,
+			   int error_code)
+{
+	struct k_pipe_dma_xfer *xfer;
+	unsigned int key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&pipe_dma_xfers, xfer, node) {
+		if (xfer->pipe->dma.dev == dev &&
+		    xfer->pipe->dma.channel == channel) {
+			sys_slist_find_and_remove(&pipe_dma_xfers,
+						  &xfer->node);
+			xfer->error = error_code;
+			k_sem_give(&xfer->done);
+			break;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+/**
+ * @brief Copy data to a reader with the DMA channel of a pipe
+ *
+ * The copy is done by the CPU instead if the writer must not sleep, or if
+ * the DMA transfer fails. The reader is then readied and the channel
+ * released.
+ *
+ * @return N/A
+ */
+static void _pipe_dma_xfer(struct k_pipe_dma_xfer *xfer, bool can_sleep)
+{
+	struct k_pipe *pipe = xfer->pipe;
+	struct dma_block_config block = {
+		.source_address = (uint32_t)xfer->src,
+		.dest_address = (uint32_t)xfer->dest,
+		.block_size = xfer->size,
+	};
+	struct dma_config config = {
+		.channel_direction = MEMORY_TO_MEMORY,
+		.source_data_size = 1,
+		.dest_data_size = 1,
+		.source_burst_length = 1,
+		.dest_burst_length = 1,
+		.block_count = 1,
+		.head_block = &block,
+		.dma_callback = _pipe_dma_done,
+	};
+	unsigned int key;
+
+	xfer->error = -EIO;
+
+	if (can_sleep &&
+	    dma_config(pipe->dma.dev, pipe->dma.channel, &config) == 0) {
+		k_sem_init(&xfer->done, 0, 1);
+
+		key = irq_lock();
+		sys_slist_append(&pipe_dma_xfers, &xfer->node);
+		irq_unlock(key);
+
+		if (dma_start(pipe->dma.dev, pipe->dma.channel) == 0) {
+			k_sem_take(&xfer->done, K_FOREVER);
+		} else {
+			key = irq_lock();
+			sys_slist_find_and_remove(&pipe_dma_xfers,
+						  &xfer->node);
+			irq_unlock(key);
+		}
+	}
+
+	if (xfer->error) {
+		memcpy(xfer->dest, xfer->src, xfer->size);
+	}
+
+	pipe->dma.busy = 0;
+
+	key = irq_lock();
+	_ready_thread(xfer->reader);
+	irq_unlock(key);
+}
+#endif /* CONFIG_PIPE_DMA */
+
 /**
  * @brief Put data from @a src into the pipe's circular buffer
  *
@@ -273,8 +404,8 @@ static bool _pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 	size_t num_bytes = 0;
 
 	if (timeout == K_NO_WAIT) {
-		for (node = sys_dlist_peek_head(wait_q); node != NULL;
-		     node = sys_dlist_peek_next(wait_q, node)) {
+		for (node = sys_dlist_peek_head(&wait_q->waitq); node != NULL;
+		     node = sys_dlist_peek_next(&wait_q->waitq, node)) {
 			thread = (struct k_thread *)node;
 			desc = (struct k_pipe_desc *)thread->base.swap_data;
 
@@ -298,7 +429,8 @@ static bool _pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 	sys_dlist_init(xfer_list);
 	num_bytes = 0;
 
-	while ((thread = (struct k_thread *) sys_dlist_peek_head(wait_q))) {
+	while ((thread = (struct k_thread *)
+			 sys_dlist_peek_head(&wait_q->waitq))) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
 		num_bytes += desc->bytes_to_xfer;
 
@@ -392,6 +524,9 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	unsigned int   key;
 	size_t         num_bytes_written = 0;
 	size_t         bytes_copied;
+#ifdef CONFIG_PIPE_DMA
+	struct k_pipe_dma_xfer dma_xfer = { .reader = NULL };
+#endif
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS == 0)
 	ARG_UNUSED(async_desc);
@@ -431,6 +566,29 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 				  sys_dlist_get(&xfer_list);
 	while (thread) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
+
+#ifdef CONFIG_PIPE_DMA
+		/*
+		 * The reader's request is satisfied from the data that follows
+		 * in any case: postpone the copy to when the bookkeeping is
+		 * done, and keep the reader from running until then.
+		 */
+		if (!dma_xfer.reader &&
+		    _pipe_dma_claim(pipe, desc->bytes_to_xfer)) {
+			dma_xfer.pipe   = pipe;
+			dma_xfer.reader = thread;
+			dma_xfer.dest   = desc->buffer;
+			dma_xfer.src    = data + num_bytes_written;
+			dma_xfer.size   = desc->bytes_to_xfer;
+
+			num_bytes_written   += desc->bytes_to_xfer;
+			desc->buffer        += desc->bytes_to_xfer;
+			desc->bytes_to_xfer  = 0;
+
+			thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+			continue;
+		}
+#endif
 		bytes_copied = _pipe_xfer(desc->buffer, desc->bytes_to_xfer,
 					  data + num_bytes_written,
 					  bytes_to_write - num_bytes_written);
@@ -471,6 +629,17 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		_pipe_buffer_put(pipe, data + num_bytes_written,
 				 bytes_to_write - num_bytes_written);
 
+#ifdef CONFIG_PIPE_DMA
+	/*
+	 * Only sleep on the transfer when nothing is left to write, as
+	 * other threads may then use the pipe without getting out of order.
+	 */
+	if (dma_xfer.reader) {
+		_pipe_dma_xfer(&dma_xfer,
+			       num_bytes_written == bytes_to_write);
+	}
+#endif
+
 	if (num_bytes_written == bytes_to_write) {
 		*bytes_written = num_bytes_written;
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Idle governor
+ *
+ * The time to the next timeout only bounds an idle period, interrupts end
+ * most of them earlier. For each CPU, the governor keeps an average of how
+ * early its sleeps ended, relative to that bound, and an average of the
+ * sleeps without any timeout. The upcoming idle period is predicted from
+ * them, and the deepest sleep state worth entering for it is picked among
+ * the ones waking up fast enough for the drivers.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <misc/dlist.h>
+#include <sys_clock.h>
+#include <power.h>
+
+/* Fixed point unit of the early wake up ratio */
+#define EARLY_ONE 1024
+
+/* The last sleep weighs 1 / (1 << AVG_SHIFT) in the averages */
+#define AVG_SHIFT 3
+
+/* No timeout bounding the idle period */
+#define UNBOUNDED UINT32_MAX
+
+struct governor_cpu {
+	/* Cycle count when the CPU went idle */
+	uint32_t start;
+	/* Time to the next timeout when the CPU went idle, in us */
+	uint32_t bound_us;
+	/* Average share of the bound the sleeps ended early by */
+	uint32_t early;
+	/* Average length of the unbounded sleeps, in us, 0 before any */
+	uint32_t unbounded_us;
+	bool idle;
+};
+
+static struct governor_cpu governor_cpus[ARRAY_SIZE(_kernel.cpus)];
+
+static const struct sys_pm_state *pm_states;
+static int pm_state_count;
+
+static sys_dlist_t qos_requests = SYS_DLIST_STATIC_INIT(&qos_requests);
+static uint32_t qos_latency_us = UINT32_MAX;
+
+static inline struct governor_cpu *governor_cpu(void)
+{
+	return &governor_cpus[_current_cpu - _kernel.cpus];
+}
+
+static uint32_t ticks_to_us(int32_t ticks)
+{
+	uint64_t us;
+
+	if (ticks == K_FOREVER) {
+		return UNBOUNDED;
+	}
+
+	us = (uint64_t)ticks * USEC_PER_SEC / sys_clock_ticks_per_sec;
+
+	return us < UNBOUNDED ? us : UNBOUNDED - 1;
+}
+
+static uint32_t average(uint32_t avg, uint32_t sample)
+{
+	return (((uint64_t)avg << AVG_SHIFT) - avg + sample) >> AVG_SHIFT;
+}
+
+void _sys_pm_governor_idle_enter(int32_t ticks)
+{
+	struct governor_cpu *cpu = governor_cpu();
+
+	cpu->bound_us = ticks_to_us(ticks);
+	cpu->start = k_cycle_get_32();
+	cpu->idle = true;
+}
+
+void _sys_pm_governor_idle_exit(void)
+{
+	struct governor_cpu *cpu = governor_cpu();
+	uint32_t slept_us;
+	uint32_t early = 0;
+
+	/* Reported by the interrupt waking the CPU up already */
+	if (!cpu->idle) {
+		return;
+	}
+
+	cpu->idle = false;
+
+	slept_us = SYS_CLOCK_HW_CYCLES_TO_NS64(k_cycle_get_32() - cpu->start) /
+		   NSEC_PER_USEC;
+
+	if (cpu->bound_us == UNBOUNDED) {
+		cpu->unbounded_us = cpu->unbounded_us ?
+				    average(cpu->unbounded_us, slept_us) :
+				    slept_us;
+		return;
+	}
+
+	if (slept_us < cpu->bound_us) {
+		early = (uint64_t)(cpu->bound_us - slept_us) * EARLY_ONE /
+			cpu->bound_us;
+	}
+
+	cpu->early = average(cpu->early, early);
+}
+
+const struct sys_pm_state *sys_pm_governor_select(int32_t ticks)
+{
+	struct governor_cpu *cpu = governor_cpu();
+	const struct sys_pm_state *state = NULL;
+	uint32_t bound_us = ticks_to_us(ticks);
+	uint32_t predicted_us;
+	int i;
+
+	if (bound_us == UNBOUNDED) {
+		predicted_us = cpu->unbounded_us ? cpu->unbounded_us :
+			       UNBOUNDED;
+	} else {
+		predicted_us = bound_us -
+			       (uint64_t)bound_us * cpu->early / EARLY_ONE;
+	}
+
+	/* Deeper states save power for longer sleeps and wake up slower */
+	for (i = 0; i < pm_state_count; i++) {
+		if (pm_states[i].min_residency_us > predicted_us ||
+		    pm_states[i].exit_latency_us > qos_latency_us) {
+			break;
+		}
+
+		state = &pm_states[i];
+	}
+
+	return state;
+}
+
+void sys_pm_governor_states_set(const struct sys_pm_state *states,
+				int count)
+{
+	unsigned int key = irq_lock();
+
+	pm_states = states;
+	pm_state_count = count;
+
+	irq_unlock(key);
+}
+
+static void qos_update(void)
+{
+	struct sys_pm_qos_request *req;
+	uint32_t latency_us = UINT32_MAX;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&qos_requests, req, node) {
+		if (req->latency_us < latency_us) {
+			latency_us = req->latency_us;
+		}
+	}
+
+	qos_latency_us = latency_us;
+}
+
+void sys_pm_qos_request_add(struct sys_pm_qos_request *req,
+			    uint32_t latency_us)
+{
+	unsigned int key = irq_lock();
+
+	req->latency_us = latency_us;
+	sys_dlist_append(&qos_requests, &req->node);
+	qos_update();
+
+	irq_unlock(key);
+}
+
+void sys_pm_qos_request_update(struct sys_pm_qos_request *req,
+			       uint32_t latency_us)
+{
+	unsigned int key = irq_lock();
+
+	req->latency_us = latency_us;
+	qos_update();
+
+	irq_unlock(key);
+}
+
+void sys_pm_qos_request_remove(struct sys_pm_qos_request *req)
+{
+	unsigned int key = irq_lock();
+
+	sys_dlist_remove(&req->node);
+	qos_update();
+
+	irq_unlock(key);
+}
+
+uint32_t sys_pm_qos_latency_get(void)
+{
+	return qos_latency_us;
+}
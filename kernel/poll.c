@@ -35,6 +35,7 @@ void k_poll_event_init(struct k_poll_event *event, uint32_t type,
 	event->type = type;
 	event->state = K_POLL_STATE_NOT_READY;
 	event->mode = mode;
+	event->ready_queued = 0;
 	event->unused = 0;
 	event->obj = obj;
 }
@@ -265,12 +266,157 @@ int k_poll(struct k_poll_event *events, int num_events, int32_t timeout)
 	return swap_rc;
 }
 
+#ifdef CONFIG_POLL_SET
+/* events of a poll set have the set's poller, the only one without a thread */
+static inline int is_set_event(struct k_poll_event *event)
+{
+	return event->poller && !event->poller->thread;
+}
+
+/* must be called with interrupts locked */
+static int signal_set_event(struct k_poll_event *event, uint32_t state,
+			    int *must_reschedule)
+{
+	struct k_poll_set *set = CONTAINER_OF(event->poller,
+					      struct k_poll_set, poller);
+	struct k_thread *thread;
+
+	event->state |= state;
+
+	if (event->ready_queued) {
+		/* already signaled, its waiter has been woken up already */
+		return 0;
+	}
+
+	event->ready_queued = 1;
+	sys_slist_append(&set->ready_q, &event->ready_node);
+
+	thread = _unpend_first_thread(&set->wait_q);
+	if (thread) {
+		_abort_thread_timeout(thread);
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+		*must_reschedule = !_is_in_isr() && _must_switch_threads();
+	}
+
+	return 0;
+}
+
+void k_poll_set_init(struct k_poll_set *set)
+{
+	set->poller.thread = NULL;
+	sys_slist_init(&set->ready_q);
+	_waitq_init(&set->wait_q);
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event)
+{
+	__ASSERT(!event->poller, "event already in use\n");
+
+	unsigned int key = irq_lock();
+	int must_reschedule = 0;
+	uint32_t state;
+	int rc;
+
+	rc = register_event(event);
+	if (rc != 0) {
+		irq_unlock(key);
+		return rc;
+	}
+
+	event->poller = &set->poller;
+	event->state = K_POLL_STATE_NOT_READY;
+	event->ready_queued = 0;
+
+	if (is_condition_met(event, &state)) {
+		(void)signal_set_event(event, state, &must_reschedule);
+	}
+
+	if (must_reschedule) {
+		(void)_Swap(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return 0;
+}
+
+void k_poll_set_remove(struct k_poll_set *set, struct k_poll_event *event)
+{
+	__ASSERT(event->poller == &set->poller, "event not in set\n");
+
+	unsigned int key = irq_lock();
+
+	clear_event_registration(event);
+
+	if (event->ready_queued) {
+		sys_slist_find_and_remove(&set->ready_q, &event->ready_node);
+		event->ready_queued = 0;
+	}
+
+	irq_unlock(key);
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **events,
+		    int max, int32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(events, "NULL events\n");
+	__ASSERT(max > 0, "zero events\n");
+
+	unsigned int key = irq_lock();
+	sys_snode_t *node;
+	int num_ready = 0;
+
+	if (sys_slist_is_empty(&set->ready_q)) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EAGAIN;
+		}
+
+		_pend_current_thread(&set->wait_q, timeout);
+
+		int swap_rc = _Swap(key);
+
+		if (swap_rc != 0) {
+			return swap_rc;
+		}
+
+		key = irq_lock();
+	}
+
+	while (num_ready < max && (node = sys_slist_get(&set->ready_q))) {
+		struct k_poll_event *event = CONTAINER_OF(node,
+							  struct k_poll_event,
+							  ready_node);
+
+		event->ready_queued = 0;
+		events[num_ready++] = event;
+
+		/* keep interrupt latency low while handing events out */
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	return num_ready ? num_ready : -EAGAIN;
+}
+#else
+#define is_set_event(event) 0
+#define signal_set_event(event, state, must_reschedule) 0
+#endif /* CONFIG_POLL_SET */
+
 /* must be called with interrupts locked */
 static int _signal_poll_event(struct k_poll_event *event, uint32_t state,
 			      int *must_reschedule)
 {
 	*must_reschedule = 0;
 
+	if (is_set_event(event)) {
+		return signal_set_event(event, state, must_reschedule);
+	}
+
 	if (!event->poller) {
 		goto ready_event;
 	}
@@ -312,7 +458,10 @@ int _handle_obj_poll_event(struct k_poll_event **obj_poll_event, uint32_t state)
 	struct k_poll_event *poll_event = *obj_poll_event;
 	int must_reschedule;
 
-	*obj_poll_event = NULL;
+	/* poll set events stay registered until removed from their set */
+	if (!is_set_event(poll_event)) {
+		*obj_poll_event = NULL;
+	}
 	(void)_signal_poll_event(poll_event, state, &must_reschedule);
 	return must_reschedule;
 }
@@ -14,6 +14,7 @@
 #include <kernel.h>
 #include <kernel_structs.h>
 #include <debug/object_tracing_common.h>
+#include <debug/tracing.h>
 #include <toolchain.h>
 #include <sections.h>
 #include <wait_q.h>
@@ -50,7 +51,7 @@ SYS_INIT(init_queue_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 void k_queue_init(struct k_queue *queue)
 {
 	sys_slist_init(&queue->data_q);
-	sys_dlist_init(&queue->wait_q);
+	_waitq_init(&queue->wait_q);
 
 	_INIT_OBJ_POLL_EVENT(queue);
 
@@ -82,6 +83,8 @@ void k_queue_insert(struct k_queue *queue, void *prev, void *data)
 	struct k_thread *first_pending_thread;
 	unsigned int key;
 
+	sys_trace_queue_put(queue, data);
+
 	key = irq_lock();
 
 	first_pending_thread = _unpend_first_thread(&queue->wait_q);
@@ -166,6 +169,8 @@ void *k_queue_get(struct k_queue *queue, int32_t timeout)
 	unsigned int key;
 	void *data;
 
+	sys_trace_queue_get(queue, timeout);
+
 	key = irq_lock();
 
 	if (likely(!sys_slist_is_empty(&queue->data_q))) {
@@ -183,3 +188,96 @@ void *k_queue_get(struct k_queue *queue, int32_t timeout)
 
 	return _Swap(key) ? NULL : _current->base.swap_data;
 }
+
+/*
+ * Move up to max data items from the head of a non-empty queue to the tail
+ * of a list. A max of 0 detaches the whole queue in O(1), without counting
+ * the items, and returns 0; otherwise the number of items moved is returned.
+ *
+ * Must be called with interrupts locked.
+ */
+static int queue_detach(struct k_queue *queue, sys_slist_t *list, int max)
+{
+	sys_snode_t *head = sys_slist_peek_head(&queue->data_q);
+	sys_snode_t *tail = head;
+	sys_snode_t *next;
+	int count = 1;
+
+	if (max == 0) {
+		sys_slist_append_list(list, head, queue->data_q.tail);
+		sys_slist_init(&queue->data_q);
+		return 0;
+	}
+
+	while (count < max && (next = sys_slist_peek_next_no_check(tail))) {
+		tail = next;
+		count++;
+	}
+
+	queue->data_q.head = sys_slist_peek_next_no_check(tail);
+	if (!queue->data_q.head) {
+		queue->data_q.tail = NULL;
+	}
+
+	tail->next = NULL;
+	sys_slist_append_list(list, head, tail);
+
+	return count;
+}
+
+static int queue_get_list(struct k_queue *queue, sys_slist_t *list, int max,
+			  int32_t timeout)
+{
+	unsigned int key;
+	int count;
+
+	key = irq_lock();
+
+	if (likely(!sys_slist_is_empty(&queue->data_q))) {
+		count = queue_detach(queue, list, max);
+		irq_unlock(key);
+		return count;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	_pend_current_thread(&queue->wait_q, timeout);
+
+	if (_Swap(key)) {
+		return -EAGAIN;
+	}
+
+	/*
+	 * The data item that woke us up was handed over directly: pick up
+	 * whatever else got queued behind it since, in the same operation.
+	 */
+	sys_slist_append(list, _current->base.swap_data);
+	count = 1;
+
+	if (max != 1) {
+		key = irq_lock();
+		if (!sys_slist_is_empty(&queue->data_q)) {
+			count += queue_detach(queue, list,
+					      max ? max - 1 : 0);
+		}
+		irq_unlock(key);
+	}
+
+	return max ? count : 0;
+}
+
+int k_queue_get_all(struct k_queue *queue, sys_slist_t *list, int32_t timeout)
+{
+	return queue_get_list(queue, list, 0, timeout);
+}
+
+int k_queue_get_batch(struct k_queue *queue, sys_slist_t *list, int max,
+		      int32_t timeout)
+{
+	__ASSERT(max > 0, "invalid max");
+
+	return queue_get_list(queue, list, max, timeout);
+}
@@ -58,6 +58,86 @@ static struct k_thread *_get_ready_q_head(void)
 }
 #endif
 
+#ifdef CONFIG_SMP
+/* can the thread be scheduled on the current CPU ? */
+static int _is_thread_runnable_here(struct k_thread *thread)
+{
+	struct _cpu *cpu = _current_cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (!(thread->base.cpu_mask & (1 << cpu->id))) {
+		return 0;
+	}
+#endif
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == cpu->id) {
+			continue;
+		}
+
+		if (_kernel.cpus[i].current == thread ||
+		    _kernel.cpus[i].idle_thread == thread) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Find the highest priority ready thread that the current CPU can run: the
+ * first one of the ready queue that is not running on another CPU or bound
+ * to other CPUs.
+ */
+struct k_thread *_smp_next_ready_thread(void)
+{
+	sys_dnode_t *node;
+
+	for (int prio = 0; prio < K_NUM_PRIORITIES; prio++) {
+		if (!(_ready_q.prio_bmap[prio >> 5] & (1 << (prio & 0x1f)))) {
+			continue;
+		}
+
+		SYS_DLIST_FOR_EACH_NODE(&_ready_q.q[prio], node) {
+			struct k_thread *thread = (struct k_thread *)node;
+
+			if (_is_thread_runnable_here(thread)) {
+				return thread;
+			}
+		}
+	}
+
+	return _current_cpu->idle_thread;
+}
+#endif
+
+#ifdef CONFIG_MULTITHREADING
+/*
+ * Queue a thread in the list of its priority: at the end of it, or when the
+ * thread has a deadline, after the threads whose deadline is not later.
+ */
+static void _append_to_prio_q(sys_dlist_t *q, struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_DEADLINE
+	sys_dnode_t *node;
+
+	if (thread->base.has_deadline) {
+		SYS_DLIST_FOR_EACH_NODE(q, node) {
+			struct k_thread *queued = (struct k_thread *)node;
+
+			if (_is_t1_deadline_earlier_than_t2(thread, queued)) {
+				sys_dlist_insert_before(q, node,
+							&thread->base.k_q_node);
+				return;
+			}
+		}
+	}
+#endif
+
+	sys_dlist_append(q, &thread->base.k_q_node);
+}
+#endif
+
 /*
  * Add thread to the ready queue, in the slot for its priority; the thread
  * must not be on a wait queue.
@@ -75,11 +155,21 @@ void _add_thread_to_ready_q(struct k_thread *thread)
 	sys_dlist_t *q = &_ready_q.q[q_index];
 
 	_set_ready_q_prio_bit(thread->base.prio);
-	sys_dlist_append(q, &thread->base.k_q_node);
+	_append_to_prio_q(q, thread);
 
 	struct k_thread **cache = &_ready_q.cache;
 
+#ifdef CONFIG_SCHED_DEADLINE
+	/* the thread can be ahead of others of the same priority */
+	*cache = _get_ready_q_head();
+#else
 	*cache = _is_t1_higher_prio_than_t2(thread, *cache) ? thread : *cache;
+#endif
+
+#ifdef CONFIG_SMP
+	/* let the other CPUs check whether they should run the thread */
+	_arch_sched_ipi();
+#endif
 #else
 	sys_dlist_append(&_ready_q.q[0], &thread->base.k_q_node);
 	_ready_q.prio_bmap[0] = 1;
@@ -187,7 +277,10 @@ int32_t _ms_to_ticks(int32_t ms)
 void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, int32_t timeout)
 {
 #ifdef CONFIG_MULTITHREADING
-	sys_dlist_t *wait_q_list = (sys_dlist_t *)wait_q;
+#ifdef CONFIG_WAITQ_BUCKETS
+	_waitq_insert(wait_q, thread);
+#else
+	sys_dlist_t *wait_q_list = &wait_q->waitq;
 	sys_dnode_t *node;
 
 	SYS_DLIST_FOR_EACH_NODE(wait_q_list, node) {
@@ -203,6 +296,10 @@ void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, int32_t timeout)
 	sys_dlist_append(wait_q_list, &thread->base.k_q_node);
 
 inserted:
+#ifdef CONFIG_MBOX_MATCH_INDEX
+	thread->base.pended_on = wait_q;
+#endif
+#endif
 	_mark_thread_as_pending(thread);
 
 	if (timeout != K_FOREVER) {
@@ -234,7 +331,20 @@ int __must_switch_threads(void)
 	extern void _dump_ready_q(void);
 	_dump_ready_q();
 
+#ifdef CONFIG_SMP
+	/* the next thread depends on what the other CPUs run */
+	return _get_next_ready_thread() != _current;
+#else
+#ifdef CONFIG_SCHED_DEADLINE
+	if (_get_highest_ready_prio() == _current->base.prio) {
+		return _get_next_ready_thread() != _current &&
+		       _is_t1_deadline_earlier_than_t2(_get_next_ready_thread(),
+						       _current);
+	}
+#endif
+
 	return _is_prio_higher(_get_highest_ready_prio(), _current->base.prio);
+#endif
 #else
 	return 0;
 #endif
@@ -257,10 +367,94 @@ void k_thread_priority_set(k_tid_t tid, int prio)
 	struct k_thread *thread = (struct k_thread *)tid;
 	int key = irq_lock();
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	_mutex_pi_prio_set(thread, prio);
+#else
 	_thread_priority_set(thread, prio);
+#endif
 	_reschedule_threads(key);
 }
 
+#ifdef CONFIG_SCHED_CPU_MASK
+static int cpu_mask_mod(k_tid_t tid, uint8_t enable, uint8_t disable)
+{
+	struct k_thread *thread = (struct k_thread *)tid;
+	int key = irq_lock();
+	int result = 0;
+
+	/* the mask is only looked at when a thread gets scheduled */
+	if (_is_thread_ready(thread)) {
+		result = -EINVAL;
+	} else {
+		thread->base.cpu_mask |= enable;
+		thread->base.cpu_mask &= ~disable;
+	}
+
+	irq_unlock(key);
+
+	return result;
+}
+
+int k_thread_cpu_mask_clear(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, 0, 0xff);
+}
+
+int k_thread_cpu_mask_enable_all(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, 0xff, 0);
+}
+
+int k_thread_cpu_mask_enable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "");
+
+	return cpu_mask_mod(thread, 1 << cpu, 0);
+}
+
+int k_thread_cpu_mask_disable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "");
+
+	return cpu_mask_mod(thread, 0, 1 << cpu);
+}
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+void k_thread_deadline_set(k_tid_t tid, int32_t deadline)
+{
+	__ASSERT(deadline == K_FOREVER || deadline >= 0, "");
+
+	struct k_thread *thread = (struct k_thread *)tid;
+	int key = irq_lock();
+	int ready = _is_thread_ready(thread);
+
+	/* the thread moves within the queue of its priority */
+	if (ready) {
+		_remove_thread_from_ready_q(thread);
+	}
+
+	if (deadline == K_FOREVER) {
+		thread->base.has_deadline = 0;
+	} else {
+		thread->base.deadline = k_cycle_get_32() +
+			(uint32_t)((uint64_t)deadline *
+				   sys_clock_hw_cycles_per_sec / MSEC_PER_SEC);
+		thread->base.has_deadline = 1;
+	}
+
+	if (ready) {
+		_add_thread_to_ready_q(thread);
+	}
+
+	if (_is_in_isr()) {
+		irq_unlock(key);
+	} else {
+		_reschedule_threads(key);
+	}
+}
+#endif
+
 /*
  * Interrupts must be locked when calling this function.
  *
@@ -279,7 +473,7 @@ void _move_thread_to_end_of_prio_q(struct k_thread *thread)
 	}
 
 	sys_dlist_remove(&thread->base.k_q_node);
-	sys_dlist_append(q, &thread->base.k_q_node);
+	_append_to_prio_q(q, thread);
 
 	struct k_thread **cache = &_ready_q.cache;
 
@@ -386,9 +580,19 @@ void k_sched_time_slice_set(int32_t duration_in_ms, int prio)
 	__ASSERT(duration_in_ms >= 0, "");
 	__ASSERT((prio >= 0) && (prio < CONFIG_NUM_PREEMPT_PRIORITIES), "");
 
+#ifdef CONFIG_TICKLESS_KERNEL
+	unsigned int key = irq_lock();
+#endif
+
 	_time_slice_duration = duration_in_ms;
 	_time_slice_elapsed = 0;
 	_time_slice_prio_ceiling = prio;
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* the end of the slice may be the next deadline now */
+	_sys_clock_deadline_update();
+	irq_unlock(key);
+#endif
 }
 #endif /* CONFIG_TIMESLICING */
 
@@ -19,6 +19,7 @@
 #include <kernel.h>
 #include <kernel_structs.h>
 #include <debug/object_tracing_common.h>
+#include <debug/tracing.h>
 #include <toolchain.h>
 #include <sections.h>
 #include <wait_q.h>
@@ -82,7 +83,7 @@ void k_sem_init(struct k_sem *sem, unsigned int initial_count,
 
 	sem->count = initial_count;
 	sem->limit = limit;
-	sys_dlist_init(&sem->wait_q);
+	_waitq_init(&sem->wait_q);
 
 	_INIT_OBJ_POLL_EVENT(sem);
 
@@ -147,7 +148,7 @@ int k_sem_group_take(struct k_sem *sem_array[], struct k_sem **sem,
 
 	_wait_q_t wait_q;
 
-	sys_dlist_init(&wait_q);
+	_waitq_init(&wait_q);
 	_pend_current_thread(&wait_q, timeout);
 
 	if (_Swap(key) != 0) {
@@ -384,6 +385,8 @@ void k_sem_give(struct k_sem *sem)
 {
 	unsigned int key;
 
+	sys_trace_sem_give(sem);
+
 	key = irq_lock();
 
 	if (do_sem_give(sem)) {
@@ -397,6 +400,8 @@ int k_sem_take(struct k_sem *sem, int32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
+	sys_trace_sem_take(sem, timeout);
+
 	unsigned int key = irq_lock();
 
 	if (likely(sem->count > 0)) {
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Symmetric multiprocessing support
+ *
+ * The kernel objects are protected by irq_lock(), which becomes a global
+ * lock shared by all CPUs. It belongs to threads rather than to CPUs: a
+ * thread that swaps out while holding it gets it back when it is switched
+ * in again, as it gets its interrupt lock back on a single CPU.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <atomic.h>
+#include <ksched.h>
+#include <nano_internal.h>
+
+#define IDLE_STACK_SIZE CONFIG_IDLE_STACK_SIZE
+
+static atomic_t global_lock;
+
+static char __noinit __stack
+	smp_idle_stacks[CONFIG_MP_NUM_CPUS - 1][IDLE_STACK_SIZE];
+static char __noinit __stack
+	smp_irq_stacks[CONFIG_MP_NUM_CPUS - 1][CONFIG_ISR_STACK_SIZE];
+
+static void global_lock_take(void)
+{
+	while (!atomic_cas(&global_lock, 0, 1)) {
+		/* spin */
+	}
+}
+
+unsigned int _smp_global_lock(void)
+{
+	unsigned int key = _arch_irq_lock();
+
+	/* only the boot CPU runs before the first thread is set up */
+	if (!_current) {
+		return key;
+	}
+
+	if (!_current->base.global_lock_count) {
+		global_lock_take();
+	}
+
+	_current->base.global_lock_count++;
+
+	return key;
+}
+
+void _smp_global_unlock(unsigned int key)
+{
+	if (_current && _current->base.global_lock_count) {
+		if (!--_current->base.global_lock_count) {
+			atomic_clear(&global_lock);
+		}
+	}
+
+	_arch_irq_unlock(key);
+}
+
+/*
+ * Take the global lock back for a thread that held it when it was preempted
+ * from an ISR. Called by the architecture code on interrupt exit, before
+ * switching to such a thread.
+ */
+void _smp_reacquire_global_lock(struct k_thread *thread)
+{
+	if (thread->base.global_lock_count) {
+		global_lock_take();
+	}
+}
+
+unsigned int _smp_swap(unsigned int key)
+{
+	struct k_thread *next = _get_next_ready_thread();
+	unsigned int result;
+
+	/*
+	 * The lock stays held if the incoming thread holds it, otherwise it
+	 * would start running without it.
+	 */
+	if (!next->base.global_lock_count) {
+		atomic_clear(&global_lock);
+	}
+
+	result = _arch_swap(key);
+
+	/* _Swap() releases the lock of the caller, as it unlocks interrupts */
+	if (!--_current->base.global_lock_count) {
+		atomic_clear(&global_lock);
+	}
+
+	return result;
+}
+
+static void smp_cpu_main(int cpu, void *arg)
+{
+	struct k_thread dummy_thread;
+
+	ARG_UNUSED(arg);
+
+	/* switch out of a dummy thread, as the boot CPU does */
+	dummy_thread.base.user_options = K_ESSENTIAL;
+	dummy_thread.base.thread_state = _THREAD_DUMMY;
+	dummy_thread.base.global_lock_count = 0;
+	_current = &dummy_thread;
+
+	_Swap(irq_lock());
+
+	CODE_UNREACHABLE;
+}
+
+/**
+ * @brief Start the secondary CPUs
+ *
+ * Give each CPU its idle thread and interrupt stack, and let it schedule
+ * threads.
+ *
+ * @return N/A
+ */
+void _smp_init(void)
+{
+	for (int i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+		char *idle_stack = smp_idle_stacks[i - 1];
+		struct k_thread *idle_thread = (struct k_thread *)idle_stack;
+		unsigned int key;
+
+		_new_thread(idle_stack, IDLE_STACK_SIZE,
+			    idle, NULL, NULL, NULL,
+			    K_LOWEST_THREAD_PRIO, K_ESSENTIAL);
+#ifdef CONFIG_SCHED_CPU_MASK
+		idle_thread->base.cpu_mask = 1 << i;
+#endif
+		_mark_thread_as_started(idle_thread);
+
+		cpu->id = i;
+		cpu->idle_thread = idle_thread;
+		cpu->irq_stack = smp_irq_stacks[i - 1] + CONFIG_ISR_STACK_SIZE;
+
+		key = irq_lock();
+		_add_thread_to_ready_q(idle_thread);
+		irq_unlock(key);
+
+		_arch_start_cpu(i, smp_irq_stacks[i - 1], CONFIG_ISR_STACK_SIZE,
+				smp_cpu_main, NULL);
+	}
+}
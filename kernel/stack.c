@@ -46,7 +46,7 @@ SYS_INIT(init_stack_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
 void k_stack_init(struct k_stack *stack, uint32_t *buffer, int num_entries)
 {
-	sys_dlist_init(&stack->wait_q);
+	_waitq_init(&stack->wait_q);
 	stack->next = stack->base = buffer;
 	stack->top = stack->base + num_entries;
 
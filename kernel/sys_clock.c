@@ -49,7 +49,12 @@ int64_t _sys_clock_tick_count;
  */
 uint32_t _tick_get_32(void)
 {
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* ticks are only announced at deadlines, add those elapsed since */
+	return (uint32_t)_sys_clock_tick_count + _timer_elapsed_get();
+#else
 	return (uint32_t)_sys_clock_tick_count;
+#endif
 }
 FUNC_ALIAS(_tick_get_32, sys_tick_get_32, uint32_t);
 
@@ -77,6 +82,9 @@ int64_t _tick_get(void)
 	unsigned int imask = irq_lock();
 
 	tmp_sys_clock_tick_count = _sys_clock_tick_count;
+#ifdef CONFIG_TICKLESS_KERNEL
+	tmp_sys_clock_tick_count += _timer_elapsed_get();
+#endif
 	irq_unlock(imask);
 	return tmp_sys_clock_tick_count;
 }
@@ -129,6 +137,9 @@ static ALWAYS_INLINE int64_t _nano_tick_delta(int64_t *reftime)
 	unsigned int imask = irq_lock();
 
 	saved = _sys_clock_tick_count;
+#ifdef CONFIG_TICKLESS_KERNEL
+	saved += _timer_elapsed_get();
+#endif
 	irq_unlock(imask);
 	delta = saved - (*reftime);
 	*reftime = saved;
@@ -188,6 +199,137 @@ uint32_t k_uptime_delta_32(int64_t *reftime)
 
 volatile int _handling_timeouts;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+BUILD_ASSERT((CONFIG_TIMEOUT_WHEEL_SLOTS & _TIMEOUT_WHEEL_MASK) == 0);
+
+/*
+ * Timing wheel version: only the slots hashing the ticks that elapsed are
+ * visited. If more ticks than there are slots elapsed, every slot is visited
+ * exactly once. Interrupts are unlocked between each slot rather than between
+ * each timeout, since an ISR could abort the timeout next in the slot.
+ */
+static inline void handle_timeouts(int32_t ticks)
+{
+	sys_dlist_t expired;
+	unsigned int key;
+	uint32_t now, tick;
+	int32_t num_slots;
+
+	/* init before locking interrupts */
+	sys_dlist_init(&expired);
+
+	key = irq_lock();
+
+	_timeout_wheel.curr_tick += ticks;
+	now = _timeout_wheel.curr_tick;
+
+	K_DEBUG("tick: %u, active: %u\n", now, _timeout_wheel.num_active);
+
+	if (_timeout_wheel.num_active == 0) {
+		irq_unlock(key);
+		return;
+	}
+
+	num_slots = min(ticks, CONFIG_TIMEOUT_WHEEL_SLOTS);
+	tick = now - num_slots + 1;
+
+	_handling_timeouts = 1;
+
+	for (; num_slots > 0; num_slots--, tick++) {
+		int slot = tick & _TIMEOUT_WHEEL_MASK;
+		struct _timeout *timeout, *next;
+
+		if (!_timeout_wheel_slot_is_set(slot)) {
+			continue;
+		}
+
+		SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&_timeout_wheel.slots[slot],
+						  timeout, next, node) {
+
+			if ((int32_t)(timeout->expiry_tick - now) > 0) {
+				/* not due yet, another turn of the wheel */
+				continue;
+			}
+
+			_timeout_wheel_remove(timeout);
+
+			/*
+			 * Same-tick timeouts are in reverse order of addition
+			 * in their slot: reversing the order again when
+			 * building the expired queue processes them in the
+			 * order they were added, like the delta-list version.
+			 */
+			sys_dlist_prepend(&expired, &timeout->node);
+
+			timeout->delta_ticks_from_prev = _EXPIRED;
+		}
+
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	_handle_expired_timeouts(&expired);
+
+	_handling_timeouts = 0;
+}
+
+/*
+ * Find the closest deadline in the timing wheel. The earliest expiry tick is
+ * cached, and recomputed here only if the timeout it belonged to has been
+ * aborted or has expired. The slots are scanned in their order of expiry
+ * from the current tick, so that the first timeout found due within one turn
+ * of the wheel is the closest one; only if there is none is every timeout
+ * looked at.
+ *
+ * Must be called with interrupts locked.
+ */
+int32_t _get_next_timeout_expiry(void)
+{
+	uint32_t now = _timeout_wheel.curr_tick;
+
+	if (_timeout_wheel.num_active == 0) {
+		return K_FOREVER;
+	}
+
+	if (!_timeout_wheel.next_expiry_valid) {
+		uint32_t min_delta = UINT32_MAX;
+
+		for (uint32_t delta = 1;
+		     delta <= CONFIG_TIMEOUT_WHEEL_SLOTS; delta++) {
+			int slot = (now + delta) & _TIMEOUT_WHEEL_MASK;
+			struct _timeout *timeout;
+
+			if (!_timeout_wheel_slot_is_set(slot)) {
+				continue;
+			}
+
+			SYS_DLIST_FOR_EACH_CONTAINER(
+				&_timeout_wheel.slots[slot], timeout, node) {
+
+				uint32_t d = timeout->expiry_tick - now;
+
+				if (d < min_delta) {
+					min_delta = d;
+				}
+			}
+
+			if (min_delta == delta) {
+				break;
+			}
+		}
+
+		_timeout_wheel.next_expiry = now + min_delta;
+		_timeout_wheel.next_expiry_valid = 1;
+	}
+
+	return (int32_t)(_timeout_wheel.next_expiry - now);
+}
+
+#else /* !CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static inline void handle_timeouts(int32_t ticks)
 {
 	sys_dlist_t expired;
@@ -217,13 +359,18 @@ static inline void handle_timeouts(int32_t ticks)
 	 * interrupts. We know that no new timeout will be prepended in front
 	 * of a timeout which delta is 0, since timeouts of 0 ticks are
 	 * prohibited.
+	 *
+	 * More ticks than the head's delta can be announced at once, e.g. by
+	 * a tickless kernel timer interrupt serviced late: the surplus is
+	 * carried over to the next timeout, which can expire as well.
 	 */
 	sys_dnode_t *next = &head->node;
 	struct _timeout *timeout = (struct _timeout *)next;
 
 	_handling_timeouts = 1;
 
-	while (timeout && timeout->delta_ticks_from_prev == 0) {
+	while (timeout && timeout->delta_ticks_from_prev <= 0) {
+		int32_t surplus = timeout->delta_ticks_from_prev;
 
 		sys_dlist_remove(next);
 
@@ -240,6 +387,13 @@ static inline void handle_timeouts(int32_t ticks)
 
 		timeout->delta_ticks_from_prev = _EXPIRED;
 
+		/* keep the queue consistent before unlocking interrupts */
+		next = sys_dlist_peek_head(&_timeout_q);
+		if (next) {
+			((struct _timeout *)next)->delta_ticks_from_prev +=
+				surplus;
+		}
+
 		irq_unlock(key);
 		key = irq_lock();
 
@@ -253,6 +407,7 @@ static inline void handle_timeouts(int32_t ticks)
 
 	_handling_timeouts = 0;
 }
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
 #else
 	#define handle_timeouts(ticks) do { } while ((0))
 #endif
@@ -297,6 +452,80 @@ static void handle_time_slicing(int32_t ticks)
 #else
 #define handle_time_slicing(ticks) do { } while (0)
 #endif
+
+#ifdef CONFIG_TICKLESS_KERNEL
+/*
+ * Deadline the system timer is programmed for, in ticks from the last
+ * announced tick, or K_FOREVER if it is not programmed to expire.
+ */
+static int32_t programmed_deadline = K_FOREVER;
+
+/*
+ * The next deadline is the closest timeout or the end of the current time
+ * slice, whichever comes first: time slicing is handled like yet another
+ * timeout. The slice is accounted for whenever time slicing is enabled, even
+ * if the current thread cannot be sliced, since the next thread to run could.
+ *
+ * Must be called with interrupts locked.
+ */
+static int32_t next_deadline(void)
+{
+	int32_t ticks = _get_next_timeout_expiry();
+
+#ifdef CONFIG_TIMESLICING
+	if (_time_slice_duration != 0) {
+		int32_t slice = _ms_to_ticks(_time_slice_duration -
+					     _time_slice_elapsed);
+
+		if (slice < 1) {
+			slice = 1;
+		}
+
+		if ((ticks == K_FOREVER) || (slice < ticks)) {
+			ticks = slice;
+		}
+	}
+#endif
+
+	return ticks;
+}
+
+/*
+ * Reprogram the system timer if the next deadline is now closer than the one
+ * it is programmed for, e.g. after adding a timeout. A deadline that moved
+ * further away is left alone: the timer expiring early only leads to
+ * reprogramming it, since no tick will have been announced.
+ *
+ * Must be called with interrupts locked.
+ */
+void _sys_clock_deadline_update(void)
+{
+	int32_t ticks = next_deadline();
+
+	if ((ticks != K_FOREVER) &&
+	    ((programmed_deadline == K_FOREVER) ||
+	     (ticks < programmed_deadline))) {
+		programmed_deadline = ticks;
+		_timer_deadline_set(ticks);
+	}
+}
+
+/*
+ * Program the system timer for the next deadline after ticks have been
+ * announced, which is the new reference for deadlines.
+ */
+static void program_next_deadline(void)
+{
+	unsigned int key = irq_lock();
+
+	programmed_deadline = next_deadline();
+	_timer_deadline_set(programmed_deadline);
+
+	irq_unlock(key);
+}
+#else
+#define program_next_deadline() do { } while (0)
+#endif /* CONFIG_TICKLESS_KERNEL */
 /**
  *
  * @brief Announce a tick to the kernel
@@ -305,6 +534,11 @@ static void handle_time_slicing(int32_t ticks)
  * tick is to be announced to the kernel. It takes care of dequeuing the
  * timers that have expired and wake up the threads pending on them.
  *
+ * With a tickless kernel, the driver calls it when the deadline it was
+ * programmed for is reached, announcing all the ticks elapsed since the
+ * previous call, and the timer is then reprogrammed for the next deadline
+ * via _timer_deadline_set().
+ *
  * @return N/A
  */
 void _nano_sys_clock_tick_announce(int32_t ticks)
@@ -322,4 +556,6 @@ void _nano_sys_clock_tick_announce(int32_t ticks)
 
 	/* time slicing is basically handled like just yet another timeout */
 	handle_time_slicing(ticks);
+
+	program_next_deadline();
 }
@@ -14,7 +14,14 @@
 #include <kernel.h>
 #include <init.h>
 
-char __noinit __stack sys_work_q_stack[CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE];
+/* one stack per worker, back to back */
+char __noinit __stack sys_work_q_stack[CONFIG_SYSTEM_WORKQUEUE_WORKERS *
+				       CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE];
+
+#if CONFIG_SYSTEM_WORKQUEUE_WORKERS > 1
+static struct k_work_q_worker
+	sys_work_q_workers[CONFIG_SYSTEM_WORKQUEUE_WORKERS];
+#endif
 
 struct k_work_q k_sys_work_q;
 
@@ -22,10 +29,19 @@ static int k_sys_work_q_init(struct device *dev)
 {
 	ARG_UNUSED(dev);
 
+#if CONFIG_SYSTEM_WORKQUEUE_WORKERS > 1
+	k_work_q_pool_start(&k_sys_work_q,
+			    sys_work_q_workers,
+			    CONFIG_SYSTEM_WORKQUEUE_WORKERS,
+			    sys_work_q_stack,
+			    CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE,
+			    CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
+#else
 	k_work_q_start(&k_sys_work_q,
 		       sys_work_q_stack,
 		       sizeof(sys_work_q_stack),
 		       CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
+#endif
 
 	return 0;
 }
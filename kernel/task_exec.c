@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Stackless task executor
+ *
+ * The tasks pending on an event are in the poll set of the executor, so
+ * waiting for the next one to run costs in proportion to the number of
+ * signaled events, not of pending tasks. The tasks spawned or yielded are
+ * in a list, run before waiting on the set again.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <misc/util.h>
+
+static void task_ready(struct k_task_executor *executor, struct k_task *task)
+{
+	unsigned int key = irq_lock();
+
+	sys_slist_append(&executor->ready, &task->node);
+
+	irq_unlock(key);
+
+	/* an ISR may have interrupted the executor about to wait */
+	if (k_is_in_isr() || k_current_get() != executor->thread) {
+		k_poll_signal(&executor->wakeup, 0);
+	}
+}
+
+static void task_run(struct k_task *task)
+{
+	if (task->handler(task) == K_TASK_YIELDED) {
+		task_ready(task->executor, task);
+	}
+
+	/* a pending task is in the poll set, or made ready if it could not
+	 * be added to it, and a task done is forgotten
+	 */
+}
+
+static void executor_main(void *executor_ptr, void *p2, void *p3)
+{
+	struct k_task_executor *executor = executor_ptr;
+	struct k_poll_event *events[CONFIG_TASK_EXECUTOR_EVENTS];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		unsigned int key;
+		sys_slist_t ready;
+		sys_snode_t *node;
+		int32_t timeout;
+		int i, num;
+
+		/* the tasks yielding now run after the signaled events */
+		key = irq_lock();
+		ready = executor->ready;
+		sys_slist_init(&executor->ready);
+		irq_unlock(key);
+
+		while ((node = sys_slist_get(&ready))) {
+			task_run(CONTAINER_OF(node, struct k_task, node));
+		}
+
+		timeout = sys_slist_is_empty(&executor->ready) ?
+			  K_FOREVER : K_NO_WAIT;
+
+		num = k_poll_set_wait(&executor->set, events,
+				      ARRAY_SIZE(events), timeout);
+
+		for (i = 0; i < num; i++) {
+			struct k_poll_event *event = events[i];
+			struct k_task *task;
+
+			if (event == &executor->wakeup_event) {
+				executor->wakeup.signaled = 0;
+				event->state = K_POLL_STATE_NOT_READY;
+				continue;
+			}
+
+			task = CONTAINER_OF(event, struct k_task, event);
+			k_poll_set_remove(&executor->set, event);
+			task_run(task);
+		}
+	}
+}
+
+void k_task_executor_start(struct k_task_executor *executor,
+			   char *stack, size_t stack_size, int prio)
+{
+	k_poll_set_init(&executor->set);
+	sys_slist_init(&executor->ready);
+
+	k_poll_signal_init(&executor->wakeup);
+	k_poll_event_init(&executor->wakeup_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &executor->wakeup);
+	k_poll_set_add(&executor->set, &executor->wakeup_event);
+
+	executor->thread = k_thread_spawn(stack, stack_size,
+					  executor_main, executor, 0, 0,
+					  prio, 0, 0);
+}
+
+void k_task_spawn(struct k_task_executor *executor,
+		  struct k_task *task, k_task_handler_t handler)
+{
+	task->handler = handler;
+	task->executor = executor;
+	task->resume = 0;
+
+	task_ready(executor, task);
+}
+
+void _k_task_await(struct k_task *task, uint32_t type, void *obj)
+{
+	k_poll_event_init(&task->event, type, K_POLL_MODE_NOTIFY_ONLY, obj);
+
+	/* the object has another poller: try again after the other tasks */
+	if (k_poll_set_add(&task->executor->set, &task->event) != 0) {
+		task_ready(task->executor, task);
+	}
+}
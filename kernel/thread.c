@@ -134,6 +134,40 @@ void *k_thread_custom_data_get(void)
 
 #endif /* CONFIG_THREAD_CUSTOM_DATA */
 
+#ifdef CONFIG_INIT_STACKS
+
+int k_thread_stack_space_get(const struct k_thread *thread,
+			     size_t *unused_ptr)
+{
+	const unsigned char *start;
+	size_t size;
+	size_t unused = 0;
+
+	if (!thread || !unused_ptr) {
+		return -EINVAL;
+	}
+
+	/* the thread struct is carved from the start of the stack area */
+	start = (const unsigned char *)(thread + 1);
+	size = thread->stack_size - sizeof(*thread);
+
+#if defined(CONFIG_STACK_GROWS_UP)
+	for (size_t i = size; i > 0 && start[i - 1] == 0xaa; i--) {
+		unused++;
+	}
+#else
+	for (size_t i = 0; i < size && start[i] == 0xaa; i++) {
+		unused++;
+	}
+#endif
+
+	*unused_ptr = unused;
+
+	return 0;
+}
+
+#endif /* CONFIG_INIT_STACKS */
+
 #if defined(CONFIG_THREAD_MONITOR)
 /*
  * Remove a thread from the kernel's list of active threads.
@@ -376,6 +410,10 @@ void _k_thread_single_abort(struct k_thread *thread)
 		}
 	}
 	_mark_thread_as_dead(thread);
+
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+	_heap_magazine_abort(thread);
+#endif
 }
 
 #ifdef CONFIG_MULTITHREADING
@@ -437,9 +475,43 @@ void _init_thread_base(struct _thread_base *thread_base, int priority,
 
 	thread_base->sched_locked = 0;
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	thread_base->pi_base_prio = priority;
+	thread_base->pi_blocked_on = NULL;
+	sys_dlist_init(&thread_base->pi_mutexes);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+	thread_base->has_deadline = 0;
+#endif
+
+#ifdef CONFIG_SMP
+	thread_base->global_lock_count = 0;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	thread_base->cpu_mask = (1 << CONFIG_MP_NUM_CPUS) - 1;
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	thread_base->runtime_cycles = 0;
+#endif
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_COMPACT
+	thread_base->event_logger_id = 0;
+#endif
+
 	/* swap_data does not need to be initialized */
 
 	_init_thread_timeout(thread_base);
+
+#ifdef CONFIG_HEAP_MEM_POOL_MAGAZINE
+	/* only real threads, that are backed by a struct k_thread */
+	if (initial_state & _THREAD_PRESTART) {
+		_heap_magazine_init(CONTAINER_OF(thread_base, struct k_thread,
+						 base));
+	}
+#endif
 }
 
 uint32_t _k_thread_group_mask_get(struct k_thread *thread)
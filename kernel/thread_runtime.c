@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Thread run-time statistics
+ *
+ * The hardware cycles elapsed since the last checkpoint are charged to the
+ * current thread when it is switched out or interrupted, and to interrupt
+ * handlers when they return or are interrupted by a nested interrupt. The
+ * architecture code calls the hooks below at these points.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+
+static uint32_t checkpoint;
+static uint32_t isr_depth;
+static uint64_t isr_cycles;
+static uint64_t total_cycles;
+
+static uint32_t cycles_since_checkpoint(void)
+{
+	uint32_t now = k_cycle_get_32();
+	uint32_t cycles = now - checkpoint;
+
+	checkpoint = now;
+	total_cycles += cycles;
+
+	return cycles;
+}
+
+/* called on context switches, while the outgoing thread is still current */
+void _sys_thread_runtime_switch(void)
+{
+	unsigned int key = irq_lock();
+	uint32_t cycles = cycles_since_checkpoint();
+
+	if (_current) {
+		_current->base.runtime_cycles += cycles;
+	}
+
+	irq_unlock(key);
+}
+
+void _sys_thread_runtime_isr_enter(void)
+{
+	unsigned int key = irq_lock();
+	uint32_t cycles = cycles_since_checkpoint();
+
+	if (isr_depth++) {
+		isr_cycles += cycles;
+	} else if (_current) {
+		_current->base.runtime_cycles += cycles;
+	}
+
+	irq_unlock(key);
+}
+
+void _sys_thread_runtime_isr_exit(void)
+{
+	unsigned int key = irq_lock();
+
+	isr_cycles += cycles_since_checkpoint();
+	isr_depth--;
+
+	irq_unlock(key);
+}
+
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       struct k_thread_runtime_stats *stats)
+{
+	unsigned int key;
+
+	if (!thread || !stats) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	stats->execution_cycles = thread->base.runtime_cycles;
+	if (thread == _current && !isr_depth) {
+		stats->execution_cycles += k_cycle_get_32() - checkpoint;
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int k_isr_runtime_stats_get(struct k_thread_runtime_stats *stats)
+{
+	unsigned int key;
+
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	stats->execution_cycles = isr_cycles;
+	if (isr_depth) {
+		stats->execution_cycles += k_cycle_get_32() - checkpoint;
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int k_thread_runtime_stats_all_get(struct k_thread_runtime_stats *stats)
+{
+	unsigned int key;
+
+	if (!stats) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	stats->execution_cycles = total_cycles + (k_cycle_get_32() - checkpoint);
+	irq_unlock(key);
+
+	return 0;
+}
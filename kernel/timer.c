@@ -67,7 +67,7 @@ void _timer_expiration_handler(struct _timeout *t)
 		timer->expiry_fn(timer);
 	}
 
-	thread = (struct k_thread *)sys_dlist_peek_head(&timer->wait_q);
+	thread = (struct k_thread *)sys_dlist_peek_head(&timer->wait_q.waitq);
 
 	if (!thread) {
 		return;
@@ -98,7 +98,7 @@ void k_timer_init(struct k_timer *timer,
 	timer->stop_fn = stop_fn;
 	timer->status = 0;
 
-	sys_dlist_init(&timer->wait_q);
+	_waitq_init(&timer->wait_q);
 	_init_timeout(&timer->timeout, _timer_expiration_handler);
 	SYS_TRACING_OBJ_INIT(k_timer, timer);
 
@@ -208,6 +208,10 @@ int32_t _timeout_remaining_get(struct _timeout *timeout)
 	if (timeout->delta_ticks_from_prev == _INACTIVE) {
 		remaining_ticks = 0;
 	} else {
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+		remaining_ticks = (int32_t)(timeout->expiry_tick -
+					    _timeout_wheel.curr_tick);
+#else
 		/*
 		 * compute remaining ticks by walking the timeout list
 		 * and summing up the various tick deltas involved
@@ -221,6 +225,15 @@ int32_t _timeout_remaining_get(struct _timeout *timeout)
 								   &t->node);
 			remaining_ticks += t->delta_ticks_from_prev;
 		}
+#endif
+
+#ifdef CONFIG_TICKLESS_KERNEL
+		/* timeouts are relative to the last announced tick */
+		remaining_ticks -= _timer_elapsed_get();
+#endif
+		if (remaining_ticks < 0) {
+			remaining_ticks = 0;
+		}
 	}
 
 	irq_unlock(key);
@@ -13,6 +13,7 @@
 
 #include <kernel_structs.h>
 #include <wait_q.h>
+#include <ksched.h>
 #include <errno.h>
 
 static void work_q_main(void *work_q_ptr, void *p2, void *p3)
@@ -47,12 +48,197 @@ void k_work_q_start(struct k_work_q *work_q, char *stack,
 		    size_t stack_size, int prio)
 {
 	k_fifo_init(&work_q->fifo);
+#ifdef CONFIG_WORKQUEUE_POOL
+	work_q->num_workers = 0;
+#endif
 
 	k_thread_spawn(stack, stack_size,
 		       work_q_main, work_q, 0, 0,
 		       prio, 0, 0);
 }
 
+#ifdef CONFIG_WORKQUEUE_POOL
+/*
+ * Get the next work item a worker can process, in order: from its own lane,
+ * from the shared queue, then stolen from another lane. A lane is only
+ * picked from when none of its work items is being processed.
+ *
+ * Returns the work item and sets *lane to the index of the lane it came
+ * from, or -1 for the shared queue; returns NULL if there is nothing to do.
+ *
+ * Must be called with interrupts locked.
+ */
+static struct k_work *pool_next_work(struct k_work_q *work_q, int self,
+				     int *lane)
+{
+	int i;
+
+	if (!(work_q->lanes_busy & BIT(self)) &&
+	    !sys_slist_is_empty(&work_q->workers[self].lane)) {
+		i = self;
+		goto lane;
+	}
+
+	if (!sys_slist_is_empty(&work_q->shared_q)) {
+		*lane = -1;
+		return (struct k_work *)
+			sys_slist_get_not_empty(&work_q->shared_q);
+	}
+
+	for (i = 0; i < work_q->num_workers; i++) {
+		if (!(work_q->lanes_busy & BIT(i)) &&
+		    !sys_slist_is_empty(&work_q->workers[i].lane)) {
+			goto lane;
+		}
+	}
+
+	return NULL;
+
+lane:
+	work_q->lanes_busy |= BIT(i);
+	*lane = i;
+	return (struct k_work *)
+		sys_slist_get_not_empty(&work_q->workers[i].lane);
+}
+
+static void work_q_pool_main(void *worker_ptr, void *self_ptr, void *p3)
+{
+	struct k_work_q_worker *worker = worker_ptr;
+	struct k_work_q *work_q = worker->work_q;
+	int self = (int)self_ptr;
+
+	ARG_UNUSED(p3);
+
+	while (1) {
+		struct k_work *work;
+		k_work_handler_t handler;
+		unsigned int key;
+		int lane;
+
+		key = irq_lock();
+
+		work = pool_next_work(work_q, self, &lane);
+		if (!work) {
+			_pend_current_thread(&work_q->idle_q, K_FOREVER);
+			_Swap(key);
+			continue;
+		}
+
+		irq_unlock(key);
+
+		handler = work->handler;
+
+		/* Reset pending state so it can be resubmitted by handler */
+		if (atomic_test_and_clear_bit(work->flags,
+					       K_WORK_STATE_PENDING)) {
+			handler(work);
+		}
+
+		/*
+		 * Release the lane: if more work items are queued in it, this
+		 * worker picks them up next, there is no one to wake up.
+		 */
+		if (lane >= 0) {
+			key = irq_lock();
+			work_q->lanes_busy &= ~BIT(lane);
+			irq_unlock(key);
+		}
+
+		/* Make sure we don't hog up the CPU if the queues never (or
+		 * very rarely) get empty.
+		 */
+		k_yield();
+	}
+}
+
+static int pool_submit_lane(struct k_work_q *work_q)
+{
+	int i;
+
+	if (_is_in_isr()) {
+		return -1;
+	}
+
+	for (i = 0; i < work_q->num_workers; i++) {
+		if (work_q->workers[i].thread == _current) {
+			return i;
+		}
+	}
+
+	return ((uintptr_t)_current / sizeof(struct k_thread)) %
+	       work_q->num_workers;
+}
+
+void _work_q_pool_submit(struct k_work_q *work_q, struct k_work *work)
+{
+	struct k_thread *thread;
+	unsigned int key;
+	int lane;
+
+	key = irq_lock();
+
+	lane = pool_submit_lane(work_q);
+	if (lane < 0) {
+		sys_slist_append(&work_q->shared_q, (sys_snode_t *)work);
+	} else {
+		sys_slist_append(&work_q->workers[lane].lane,
+				 (sys_snode_t *)work);
+
+		/* whoever processes the lane will get to it */
+		if (work_q->lanes_busy & BIT(lane)) {
+			irq_unlock(key);
+			return;
+		}
+	}
+
+	thread = _unpend_first_thread(&work_q->idle_q);
+	if (thread) {
+		_abort_thread_timeout(thread);
+		_ready_thread(thread);
+		if (!_is_in_isr() && _must_switch_threads()) {
+			_Swap(key);
+			return;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+void k_work_q_pool_start(struct k_work_q *work_q,
+			 struct k_work_q_worker *workers,
+			 int num_workers, char *stacks,
+			 size_t stack_size, int prio)
+{
+	int i;
+
+	__ASSERT(num_workers > 0 && num_workers <= 32,
+		 "invalid number of workers");
+
+	k_fifo_init(&work_q->fifo);
+	_waitq_init(&work_q->idle_q);
+	sys_slist_init(&work_q->shared_q);
+	work_q->workers = workers;
+	work_q->lanes_busy = 0;
+
+	/* workers must all be known before any of them runs */
+	k_sched_lock();
+
+	for (i = 0; i < num_workers; i++) {
+		sys_slist_init(&workers[i].lane);
+		workers[i].work_q = work_q;
+		workers[i].thread = k_thread_spawn(stacks + i * stack_size,
+						   stack_size,
+						   work_q_pool_main,
+						   &workers[i], (void *)i, 0,
+						   prio, 0, 0);
+	}
+
+	work_q->num_workers = num_workers;
+
+	k_sched_unlock();
+}
+#endif /* CONFIG_WORKQUEUE_POOL */
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
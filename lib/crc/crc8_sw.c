@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <misc/crc.h>
+
+uint8_t crc8(const uint8_t *src, size_t len, uint8_t polynomial,
+	     uint8_t seed)
+{
+	uint8_t crc = seed;
+	int i;
+
+	while (len--) {
+		crc ^= *src++;
+
+		for (i = 0; i < 8; i++) {
+			crc = (crc & 0x80) ? (crc << 1) ^ polynomial : crc << 1;
+		}
+	}
+
+	return crc;
+}
@@ -21,70 +21,61 @@
 #define EOF  -1
 #endif
 
-static void _uc(char *buf)
-{
-	for (/**/; *buf; buf++) {
-		if (*buf >= 'a' && *buf <= 'z') {
-			*buf += 'A' - 'a';
-		}
-	}
-}
-
-/* Convention note: "end" as passed in is the standard "byte after
- * last character" style, but...
+static const char _lc_digits[] = "0123456789abcdef";
+static const char _uc_digits[] = "0123456789ABCDEF";
+
+/* "00" to "99": one division by 100 yields two decimal digits */
+static const char _dec_pairs[200] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/* Copies the <len> digits ending at <end> into the buffer, after as many
+ * zeros as needed to have at least <minlen> digits, and null-terminates it.
  */
-static int _reverse_and_pad(char *start, char *end, int minlen)
+static int _copy_and_pad(char *buf, const char *end, int len, int minlen)
 {
-	int len;
+	int pad = (minlen > len) ? minlen - len : 0;
 
-	while (end - start < minlen) {
-		*end++ = '0';
-	}
-
-	*end = 0;
-	len = end - start;
-	for (end--; end > start; end--, start++) {
-		char tmp = *end;
-		*end = *start;
-		*start = tmp;
-	}
-	return len;
+	memset(buf, '0', pad);
+	memcpy(buf + pad, end - len, len);
+	buf[pad + len] = 0;
+	return pad + len;
 }
 
-/* Writes the specified number into the buffer in the given base,
- * using the digit characters 0-9a-z (i.e. base>36 will start writing
- * odd bytes), padding with leading zeros up to the minimum length.
+/* Writes the specified number into the buffer in base 2^shift, using
+ * the given digit characters, padding with leading zeros up to the
+ * minimum length.
  */
-static int _to_x(char *buf, uint32_t n, int base, int minlen)
+static int _to_x(char *buf, uint32_t n, int shift, const char *digits,
+		 int minlen)
 {
-	char *buf0 = buf;
+	char tmp[11]; /* 32 bits in octal */
+	char *end = tmp + sizeof(tmp);
+	char *p = end;
+	uint32_t mask = (1 << shift) - 1;
 
 	do {
-		int d = n % base;
-
-		n /= base;
-		*buf++ = '0' + d + (d > 9 ? ('a' - '0' - 10) : 0);
+		*--p = digits[n & mask];
+		n >>= shift;
 	} while (n);
-	return _reverse_and_pad(buf0, buf, minlen);
+	return _copy_and_pad(buf, end, end - p, minlen);
 }
 
 static int _to_hex(char *buf, uint32_t value,
 		   int alt_form, int precision, int prefix)
 {
-	int len;
+	const char *digits = (prefix == 'X') ? _uc_digits : _lc_digits;
 	char *buf0 = buf;
 
 	if (alt_form) {
 		*buf++ = '0';
-		*buf++ = 'x';
+		*buf++ = (prefix == 'X') ? 'X' : 'x';
 	}
 
-	len = _to_x(buf, value, 16, precision);
-	if (prefix == 'X') {
-		_uc(buf0);
-	}
-
-	return len + (buf - buf0);
+	return (buf - buf0) + _to_x(buf, value, 4, digits, precision);
 }
 
 static int _to_octal(char *buf, uint32_t value, int alt_form, int precision)
@@ -99,12 +90,31 @@ static int _to_octal(char *buf, uint32_t value, int alt_form, int precision)
 			return 1;
 		}
 	}
-	return (buf - buf0) + _to_x(buf, value, 8, precision);
+	return (buf - buf0) + _to_x(buf, value, 3, _lc_digits, precision);
 }
 
 static int _to_udec(char *buf, uint32_t value, int precision)
 {
-	return _to_x(buf, value, 10, precision);
+	char tmp[10];
+	char *end = tmp + sizeof(tmp);
+	char *p = end;
+
+	while (value >= 100) {
+		const char *pair = &_dec_pairs[2 * (value % 100)];
+
+		*--p = pair[1];
+		*--p = pair[0];
+		value /= 100;
+	}
+
+	if (value >= 10) {
+		*--p = _dec_pairs[2 * value + 1];
+		*--p = _dec_pairs[2 * value];
+	} else {
+		*--p = '0' + value;
+	}
+
+	return _copy_and_pad(buf, end, end - p, precision);
 }
 
 static int _to_dec(char *buf, int32_t value, int fplus, int fspace, int precision)
@@ -389,7 +399,24 @@ static int _atoi(char **sptr)
 	return i;
 }
 
-int _prf(int (*func)(), void *dest, char *format, va_list vargs)
+/* Outputs <len> characters, in one go if a bulk output routine is given */
+static int _emit(int (*func)(), int (*write)(), void *dest,
+		 const char *buf, int len)
+{
+	if (write) {
+		return (*write)(buf, len, dest);
+	}
+
+	for (; len > 0; len--, buf++) {
+		if ((*func)(*buf, dest) == EOF) {
+			return EOF;
+		}
+	}
+	return 0;
+}
+
+static int _prf_common(int (*func)(), int (*write)(), void *dest,
+		       char *format, va_list vargs)
 {
 	/*
 	 * Due the fact that buffer is passed to functions in this file,
@@ -421,11 +448,18 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 
 	while ((c = *format++)) {
 		if (c != '%') {
-			if ((*func) (c, dest) == EOF) {
+			/* output the whole run of literal characters */
+			cptr = format - 1;
+			while (*format != '\0' && *format != '%') {
+				format++;
+			}
+
+			if (_emit(func, write, dest, cptr,
+				  format - cptr) == EOF) {
 				return EOF;
 			}
 
-			count++;
+			count += format - cptr;
 
 		} else {
 			fminus = fplus = fspace = falt = false;
@@ -622,7 +656,7 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 				break;
 
 			case '%':
-				if ((*func)('%', dest) == EOF) {
+				if (_emit(func, write, dest, "%", 1) == EOF) {
 					return EOF;
 				}
 
@@ -655,12 +689,25 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 					c = width;
 				}
 
-				for (cptr = buf; c > 0; c--, cptr++, count++) {
-					if ((*func)(*cptr, dest) == EOF)
-						return EOF;
-				}
+				if (_emit(func, write, dest, buf, c) == EOF)
+					return EOF;
+				count += c;
 			}
 		}
 	}
 	return count;
 }
+
+int _prf(int (*func)(), void *dest, char *format, va_list vargs)
+{
+	return _prf_common(func, NULL, dest, format, vargs);
+}
+
+/*
+ * Same as _prf(), but the output routine is given whole strings:
+ * write(const char *buf, int len, void *dest).
+ */
+int _prf_write(int (*write)(), void *dest, char *format, va_list vargs)
+{
+	return _prf_common(NULL, write, dest, format, vargs);
+}
@@ -0,0 +1,199 @@
+/* memops_arm.c - memory copy routines for ARM Cortex-M */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Buffers shorter than this are copied byte by byte: aligning them and
+ * setting up the block transfers would cost more than it saves.
+ */
+#define MEMOPS_MIN_BLOCK 16
+
+/* copy 32-byte blocks between word-aligned buffers with multiple transfers */
+static inline size_t copy_blocks(uint32_t **d, const uint32_t **s, size_t n)
+{
+	while (n >= 32) {
+		__asm__ volatile("ldmia %[s]!, {r3, r4, r5, r12}\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 "ldmia %[s]!, {r3, r4, r5, r12}\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 : [d] "+r"(*d), [s] "+r"(*s)
+				 :
+				 : "r3", "r4", "r5", "r12", "memory");
+		n -= 32;
+	}
+
+	return n;
+}
+
+/**
+ *
+ * @brief Copy bytes in memory
+ *
+ * @return pointer to start of destination buffer
+ */
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	unsigned char *d_byte = (unsigned char *)d;
+	const unsigned char *s_byte = (const unsigned char *)s;
+
+	if (n >= MEMOPS_MIN_BLOCK) {
+		/* do byte-sized copying until the destination is aligned */
+
+		while ((uintptr_t)d_byte & 0x3) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		uint32_t *d_word = (uint32_t *)d_byte;
+		unsigned int shift = ((uintptr_t)s_byte & 0x3) * 8;
+
+		if (!shift) {
+			const uint32_t *s_word = (const uint32_t *)s_byte;
+
+			n = copy_blocks(&d_word, &s_word, n);
+			while (n >= sizeof(uint32_t)) {
+				*(d_word++) = *(s_word++);
+				n -= sizeof(uint32_t);
+			}
+			s_byte = (const unsigned char *)s_word;
+		} else {
+			/*
+			 * Only aligned words are read from the source, each
+			 * destination word being merged from two of them. The
+			 * words read never extend past those holding the bytes
+			 * to copy.
+			 */
+			const uint32_t *s_word =
+				(const uint32_t *)((uintptr_t)s_byte & ~0x3);
+			uint32_t prev = *(s_word++);
+
+			while (n >= sizeof(uint32_t)) {
+				uint32_t next = *(s_word++);
+
+				*(d_word++) = (prev >> shift) |
+					      (next << (32 - shift));
+				prev = next;
+				n -= sizeof(uint32_t);
+			}
+			s_byte = (const unsigned char *)s_word - 4 + shift / 8;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	/* do byte-sized copying until finished */
+
+	while (n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+
+	return d;
+}
+
+/**
+ *
+ * @brief Copy bytes in memory with overlapping areas
+ *
+ * @return pointer to destination buffer <d>
+ */
+
+void *memmove(void *d, const void *s, size_t n)
+{
+	unsigned char *dest = d;
+	const unsigned char *src = s;
+
+	if ((size_t)(dest - src) >= n) {
+		/* It is safe to perform a forward-copy */
+		return memcpy(d, s, n);
+	}
+
+	/*
+	 * The <src> buffer overlaps with the start of the <dest> buffer.
+	 * Copy backwards to prevent the premature corruption of <src>, a
+	 * word at a time if both buffers have the same alignment.
+	 */
+	if ((((uintptr_t)dest ^ (uintptr_t)src) & 0x3) == 0) {
+		while (n > 0 && ((uintptr_t)(dest + n) & 0x3)) {
+			n--;
+			dest[n] = src[n];
+		}
+
+		while (n >= sizeof(uint32_t)) {
+			n -= sizeof(uint32_t);
+			*(uint32_t *)(dest + n) = *(const uint32_t *)(src + n);
+		}
+	}
+
+	while (n > 0) {
+		n--;
+		dest[n] = src[n];
+	}
+
+	return d;
+}
+
+/**
+ *
+ * @brief Set bytes in memory
+ *
+ * @return pointer to start of buffer
+ */
+
+void *memset(void *buf, int c, size_t n)
+{
+	unsigned char *d_byte = (unsigned char *)buf;
+	unsigned char c_byte = (unsigned char)c;
+
+	if (n >= MEMOPS_MIN_BLOCK) {
+		/* do byte-sized initialization until word-aligned */
+
+		while ((uintptr_t)d_byte & 0x3) {
+			*(d_byte++) = c_byte;
+			n--;
+		}
+
+		uint32_t *d_word = (uint32_t *)d_byte;
+		uint32_t c_word = (uint32_t)c_byte * 0x01010101;
+
+		/* do 32-byte multiple stores as long as possible */
+
+		register uint32_t w0 __asm__("r3") = c_word;
+		register uint32_t w1 __asm__("r4") = c_word;
+		register uint32_t w2 __asm__("r5") = c_word;
+		register uint32_t w3 __asm__("r12") = c_word;
+
+		while (n >= 32) {
+			__asm__ volatile("stmia %[d]!, {r3, r4, r5, r12}\n\t"
+					 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+					 : [d] "+r"(d_word)
+					 : "r"(w0), "r"(w1), "r"(w2), "r"(w3)
+					 : "memory");
+			n -= 32;
+		}
+
+		while (n >= sizeof(uint32_t)) {
+			*(d_word++) = c_word;
+			n -= sizeof(uint32_t);
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	/* do byte-sized initialization until finished */
+
+	while (n > 0) {
+		*(d_byte++) = c_byte;
+		n--;
+	}
+
+	return buf;
+}
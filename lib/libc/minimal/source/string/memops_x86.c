@@ -0,0 +1,101 @@
+/* memops_x86.c - memory copy routines using x86 string instructions */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * The string instructions handle misaligned buffers in hardware: the bulk
+ * of the buffers is moved a word at a time, whatever their alignment, and
+ * the remaining bytes one at a time.
+ */
+
+/**
+ *
+ * @brief Copy bytes in memory
+ *
+ * @return pointer to start of destination buffer
+ */
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	void *dest = d;
+	size_t words = n >> 2;
+
+	__asm__ volatile("rep movsl\n\t"
+			 "movl %[bytes], %%ecx\n\t"
+			 "rep movsb\n\t"
+			 : "+D"(dest), "+S"(s), "+c"(words)
+			 : [bytes] "g"(n & 3)
+			 : "memory");
+
+	return d;
+}
+
+/**
+ *
+ * @brief Copy bytes in memory with overlapping areas
+ *
+ * @return pointer to destination buffer <d>
+ */
+
+void *memmove(void *d, const void *s, size_t n)
+{
+	void *dest;
+	size_t words = n >> 2;
+	size_t bytes = n & 3;
+
+	if ((size_t)((char *)d - (char *)s) >= n) {
+		/* It is safe to perform a forward-copy */
+		return memcpy(d, s, n);
+	}
+
+	/*
+	 * The <src> buffer overlaps with the start of the <dest> buffer.
+	 * Copy backwards to prevent the premature corruption of <src>: the
+	 * trailing bytes first, then the words.
+	 */
+	dest = (char *)d + n - 1;
+	s = (const char *)s + n - 1;
+
+	__asm__ volatile("std\n\t"
+			 "rep movsb\n\t"
+			 "movl %[words], %%ecx\n\t"
+			 "subl $3, %%esi\n\t"
+			 "subl $3, %%edi\n\t"
+			 "rep movsl\n\t"
+			 "cld\n\t"
+			 : "+D"(dest), "+S"(s), "+c"(bytes)
+			 : [words] "g"(words)
+			 : "memory");
+
+	return d;
+}
+
+/**
+ *
+ * @brief Set bytes in memory
+ *
+ * @return pointer to start of buffer
+ */
+
+void *memset(void *buf, int c, size_t n)
+{
+	void *dest = buf;
+	size_t words = n >> 2;
+	uint32_t c_word = (uint32_t)(unsigned char)c * 0x01010101;
+
+	__asm__ volatile("rep stosl\n\t"
+			 "movl %[bytes], %%ecx\n\t"
+			 "rep stosb\n\t"
+			 : "+D"(dest), "+c"(words)
+			 : "a"(c_word), [bytes] "g"(n & 3)
+			 : "memory");
+
+	return buf;
+}
@@ -7,6 +7,23 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+#include <section_tags.h>
+
+/*
+ * The scanning routines below test a whole word at a time for a null byte,
+ * or for a given byte after XOR-ing the word with that byte repeated. Only
+ * aligned words are ever read, so reading past the end of a string never
+ * crosses into the next page or memory protection region.
+ */
+
+typedef unsigned long __attribute__((__may_alias__)) mem_word_t;
+
+#define WORD_SIZE sizeof(mem_word_t)
+#define WORD_ALIGNED(p) (((uintptr_t)(p) & (WORD_SIZE - 1)) == 0)
+#define WORD_ONES ((mem_word_t)-1 / 0xff)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+#define WORD_HAS_ZERO(w) (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
 
 /**
  *
@@ -67,7 +84,23 @@ char *strncpy(char *_MLIBC_RESTRICT d, const char *_MLIBC_RESTRICT s, size_t n)
 char *strchr(const char *s, int c)
 {
 	char tmp = (char) c;
+	mem_word_t c_word = WORD_ONES * (unsigned char)c;
+	const mem_word_t *w;
+
+	while (!WORD_ALIGNED(s)) {
+		if ((*s == tmp) || (*s == '\0')) {
+			return (*s == tmp) ? (char *) s : NULL;
+		}
+		s++;
+	}
+
+	/* skip the words holding neither the byte nor the terminator */
+
+	for (w = (const mem_word_t *)s; !WORD_HAS_ZERO(*w) &&
+	     !WORD_HAS_ZERO(*w ^ c_word); w++) {
+	}
 
+	s = (const char *)w;
 	while ((*s != tmp) && (*s != '\0'))
 		s++;
 
@@ -103,14 +136,25 @@ char *strrchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
-	size_t n = 0;
+	const char *p = s;
+	const mem_word_t *w;
 
-	while (*s != '\0') {
-		s++;
-		n++;
+	while (!WORD_ALIGNED(p)) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
+	}
+
+	for (w = (const mem_word_t *)p; !WORD_HAS_ZERO(*w); w++) {
+	}
+
+	p = (const char *)w;
+	while (*p != '\0') {
+		p++;
 	}
 
-	return n;
+	return p - s;
 }
 
 /**
@@ -122,6 +166,30 @@ size_t strlen(const char *s)
 
 int strcmp(const char *s1, const char *s2)
 {
+	/* attempt word-sized comparison only if strings have same alignment */
+
+	if ((((uintptr_t)s1 ^ (uintptr_t)s2) & (WORD_SIZE - 1)) == 0) {
+		const mem_word_t *w1, *w2;
+
+		while (!WORD_ALIGNED(s1)) {
+			if ((*s1 != *s2) || (*s1 == '\0')) {
+				return *s1 - *s2;
+			}
+			s1++;
+			s2++;
+		}
+
+		w1 = (const mem_word_t *)s1;
+		w2 = (const mem_word_t *)s2;
+		while ((*w1 == *w2) && !WORD_HAS_ZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
 	while ((*s1 == *s2) && (*s1 != '\0')) {
 		s1++;
 		s2++;
@@ -183,6 +251,29 @@ int memcmp(const void *m1, const void *m2, size_t n)
 	if (!n)
 		return 0;
 
+	/* skip equal words only if buffers have identical alignment */
+
+	if ((((uintptr_t)c1 ^ (uintptr_t)c2) & (WORD_SIZE - 1)) == 0) {
+		const mem_word_t *w1, *w2;
+
+		while (!WORD_ALIGNED(c1) && (n > 1) && (*c1 == *c2)) {
+			c1++;
+			c2++;
+			n--;
+		}
+
+		w1 = (const mem_word_t *)c1;
+		w2 = (const mem_word_t *)c2;
+		while (WORD_ALIGNED(w1) && (n > WORD_SIZE) && (*w1 == *w2)) {
+			w1++;
+			w2++;
+			n -= WORD_SIZE;
+		}
+
+		c1 = (const char *)w1;
+		c2 = (const char *)w2;
+	}
+
 	while ((--n > 0) && (*c1 == *c2)) {
 		c1++;
 		c2++;
@@ -191,6 +282,8 @@ int memcmp(const void *m1, const void *m2, size_t n)
 	return *c1 - *c2;
 }
 
+#ifndef CONFIG_MINIMAL_LIBC_OPTIMIZED_MEMOPS
+
 /**
  *
  * @brief Copy bytes in memory with overlapping areas
@@ -233,7 +326,8 @@ void *memmove(void *d, const void *s, size_t n)
  * @return pointer to start of destination buffer
  */
 
-void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+__hot_text void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s,
+		       size_t n)
 {
 	/* attempt word-sized copying only if buffers have identical alignment */
 
@@ -323,6 +417,8 @@ void *memset(void *buf, int c, size_t n)
 	return buf;
 }
 
+#endif /* !CONFIG_MINIMAL_LIBC_OPTIMIZED_MEMOPS */
+
 /**
  *
  * @brief Scan byte in memory
@@ -332,9 +428,27 @@ void *memset(void *buf, int c, size_t n)
 
 void *memchr(const void *s, unsigned char c, size_t n)
 {
-	if (n != 0) {
-		const unsigned char *p = s;
+	const unsigned char *p = s;
+	mem_word_t c_word = WORD_ONES * c;
+	const mem_word_t *w;
+
+	while (!WORD_ALIGNED(p) && (n != 0)) {
+		if (*p == c) {
+			return (void *)p;
+		}
+		p++;
+		n--;
+	}
+
+	/* whole words lying in the buffer can be read without checking */
 
+	for (w = (const mem_word_t *)p; (n >= WORD_SIZE) &&
+	     !WORD_HAS_ZERO(*w ^ c_word); w++) {
+		n -= WORD_SIZE;
+	}
+
+	p = (const unsigned char *)w;
+	if (n != 0) {
 		do {
 			if (*p++ == c) {
 				return ((void *)(p - 1));
@@ -42,18 +42,17 @@
 char *
 strstr(const char *s, const char *find)
 {
-	char c, sc;
+	char c;
 	size_t len;
 
 	c = *find++;
 	if (c != 0) {
 		len = strlen(find);
 		do {
-			do {
-				sc = *s++;
-				if (sc == 0)
+			s = strchr(s, c);
+			if (s == NULL)
 				return NULL;
-			} while (sc != c);
+			s++;
 		} while (strncmp(s, find, len) != 0);
 	s--;
 	}
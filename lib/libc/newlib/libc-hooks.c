@@ -4,9 +4,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <kernel.h>
 #include <arch/cpu.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <reent.h>
 #include <sys/stat.h>
 #include <linker-defs.h>
 #include <misc/util.h>
@@ -157,3 +161,111 @@ void *_sbrk(int count)
 	}
 }
 FUNC_ALIAS(_sbrk, sbrk, void *);
+
+/*
+ * The newlib allocator calls these around every operation on its heap,
+ * possibly nested, e.g. when realloc() allocates a new block. Mutexes are
+ * recursive, so a thread may take the lock again. Like the rest of the
+ * allocator, they must not be used from ISRs.
+ */
+static K_MUTEX_DEFINE(malloc_mutex);
+
+void __malloc_lock(struct _reent *reent)
+{
+	k_mutex_lock(&malloc_mutex, K_FOREVER);
+}
+
+void __malloc_unlock(struct _reent *reent)
+{
+	k_mutex_unlock(&malloc_mutex);
+}
+
+#ifdef CONFIG_NEWLIB_LIBC_HEAP_MEM_POOL
+/*
+ * Defining the reentrant allocation routines, which newlib calls internally,
+ * as well as the standard ones keeps the newlib allocator out of the image.
+ */
+void *_malloc_r(struct _reent *reent, size_t size)
+{
+	void *ptr = k_malloc(size);
+
+	if (!ptr) {
+		reent->_errno = ENOMEM;
+	}
+
+	return ptr;
+}
+
+void _free_r(struct _reent *reent, void *ptr)
+{
+	k_free(ptr);
+}
+
+void *_calloc_r(struct _reent *reent, size_t nmemb, size_t size)
+{
+	void *ptr;
+
+	if (size && nmemb > SIZE_MAX / size) {
+		reent->_errno = ENOMEM;
+		return NULL;
+	}
+
+	ptr = _malloc_r(reent, nmemb * size);
+	if (ptr) {
+		memset(ptr, 0, nmemb * size);
+	}
+
+	return ptr;
+}
+
+void *_realloc_r(struct _reent *reent, void *ptr, size_t size)
+{
+	struct k_mem_block *block;
+	size_t old_size;
+	void *new_ptr;
+
+	if (!ptr) {
+		return _malloc_r(reent, size);
+	}
+
+	if (!size) {
+		k_free(ptr);
+		return NULL;
+	}
+
+	/* k_malloc() keeps the block descriptor just before the memory */
+	block = (struct k_mem_block *)ptr - 1;
+	old_size = block->req_size - sizeof(struct k_mem_block);
+	if (size <= old_size) {
+		return ptr;
+	}
+
+	new_ptr = _malloc_r(reent, size);
+	if (new_ptr) {
+		memcpy(new_ptr, ptr, old_size);
+		k_free(ptr);
+	}
+
+	return new_ptr;
+}
+
+void *malloc(size_t size)
+{
+	return _malloc_r(_REENT, size);
+}
+
+void free(void *ptr)
+{
+	k_free(ptr);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	return _calloc_r(_REENT, nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	return _realloc_r(_REENT, ptr, size);
+}
+#endif /* CONFIG_NEWLIB_LIBC_HEAP_MEM_POOL */
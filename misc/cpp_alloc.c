@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief C++ object allocator
+ *
+ * Small objects are allocated from one memory slab per size class, in
+ * constant time, larger ones from the heap memory pool. A block is given
+ * back to the memory slab whose buffer holds it.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <misc/cpp_alloc.h>
+
+/* Suits the alignment of all the fundamental types */
+#define CPP_ALLOC_ALIGN 8
+
+K_MEM_SLAB_DEFINE(cpp_slab_16, 16, CONFIG_CPLUSPLUS_SLAB_16_BLOCKS,
+		  CPP_ALLOC_ALIGN);
+K_MEM_SLAB_DEFINE(cpp_slab_32, 32, CONFIG_CPLUSPLUS_SLAB_32_BLOCKS,
+		  CPP_ALLOC_ALIGN);
+K_MEM_SLAB_DEFINE(cpp_slab_64, 64, CONFIG_CPLUSPLUS_SLAB_64_BLOCKS,
+		  CPP_ALLOC_ALIGN);
+K_MEM_SLAB_DEFINE(cpp_slab_128, 128, CONFIG_CPLUSPLUS_SLAB_128_BLOCKS,
+		  CPP_ALLOC_ALIGN);
+
+static struct k_mem_slab * const slabs[CPP_ALLOC_NUM_CLASSES] = {
+	&cpp_slab_16, &cpp_slab_32, &cpp_slab_64, &cpp_slab_128,
+};
+
+/* Updated with interrupts locked */
+static struct cpp_alloc_stats stats;
+
+static inline bool slab_holds(struct k_mem_slab *slab, void *ptr)
+{
+	return (char *)ptr >= slab->buffer &&
+	       (char *)ptr < slab->buffer + slab->num_blocks * slab->block_size;
+}
+
+static void *heap_alloc(size_t size)
+{
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0
+	return k_malloc(size);
+#else
+	return NULL;
+#endif
+}
+
+static void heap_free(void *ptr)
+{
+#if CONFIG_HEAP_MEM_POOL_SIZE > 0
+	k_free(ptr);
+#endif
+}
+
+void *cpp_alloc(size_t size)
+{
+	unsigned int key;
+	void *ptr;
+	int class;
+
+	for (class = 0; class < CPP_ALLOC_NUM_CLASSES; class++) {
+		if (size <= slabs[class]->block_size) {
+			break;
+		}
+	}
+
+	if (class < CPP_ALLOC_NUM_CLASSES &&
+	    k_mem_slab_alloc(slabs[class], &ptr, K_NO_WAIT) == 0) {
+		struct cpp_alloc_class_stats *class_stats =
+			&stats.classes[class];
+
+		key = irq_lock();
+		class_stats->allocs++;
+		if (k_mem_slab_num_used_get(slabs[class]) >
+		    class_stats->max_used) {
+			class_stats->max_used =
+				k_mem_slab_num_used_get(slabs[class]);
+		}
+		irq_unlock(key);
+
+		return ptr;
+	}
+
+	ptr = heap_alloc(size);
+
+	key = irq_lock();
+	if (class < CPP_ALLOC_NUM_CLASSES) {
+		stats.classes[class].exhausted++;
+	}
+
+	if (ptr) {
+		stats.heap_allocs++;
+	} else {
+		stats.failures++;
+	}
+	irq_unlock(key);
+
+	return ptr;
+}
+
+void cpp_free(void *ptr)
+{
+	if (!ptr) {
+		return;
+	}
+
+	for (int class = 0; class < CPP_ALLOC_NUM_CLASSES; class++) {
+		if (slab_holds(slabs[class], ptr)) {
+			k_mem_slab_free(slabs[class], &ptr);
+			return;
+		}
+	}
+
+	heap_free(ptr);
+}
+
+void cpp_alloc_stats_get(struct cpp_alloc_stats *result)
+{
+	unsigned int key = irq_lock();
+
+	memcpy(result, &stats, sizeof(stats));
+
+	for (int class = 0; class < CPP_ALLOC_NUM_CLASSES; class++) {
+		result->classes[class].block_size = slabs[class]->block_size;
+		result->classes[class].num_blocks = slabs[class]->num_blocks;
+		result->classes[class].used =
+			k_mem_slab_num_used_get(slabs[class]);
+	}
+
+	irq_unlock(key);
+}
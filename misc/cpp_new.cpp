@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * @brief C++ operator new and operator delete
+ *
+ * Objects are allocated with cpp_alloc(). Built with -fcheck-new, so a
+ * failed allocation returns NULL instead of throwing.
+ */
+
+#include <stddef.h>
+#include <misc/cpp_alloc.h>
+
+void *operator new(size_t size)
+{
+	return cpp_alloc(size);
+}
+
+void *operator new[](size_t size)
+{
+	return cpp_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	cpp_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	cpp_free(ptr);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void *ptr, size_t size) noexcept
+{
+	cpp_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t size) noexcept
+{
+	cpp_free(ptr);
+}
+#endif
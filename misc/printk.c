@@ -207,7 +207,7 @@ static int char_out(int c, struct out_context *ctx)
  *
  * @return Number of characters printed
  */
-int printk(const char *fmt, ...)
+int (printk)(const char *fmt, ...) /* not the deferred printk() macro */
 {
 	struct out_context ctx = { 0 };
 	va_list ap;
@@ -219,6 +219,31 @@ int printk(const char *fmt, ...)
 	return ctx.count;
 }
 
+/**
+ * @brief Output digits, padded up to a minimum width
+ *
+ * @param digits Digits to output, most significant first
+ * @param len Number of digits
+ * @param max_width Maximum width the padding can extend the number to
+ *
+ * @return N/A
+ */
+static void _printk_digits(out_func_t out, void *ctx, const char *digits,
+			   int len, int pad_zero, int min_width, int max_width)
+{
+	if (min_width > max_width) {
+		min_width = max_width;
+	}
+
+	for (; min_width > len; min_width--) {
+		out((int)(pad_zero ? '0' : ' '), ctx);
+	}
+
+	while (len--) {
+		out((int)*digits++, ctx);
+	}
+}
+
 /**
  * @brief Output an unsigned long in hex format
  *
@@ -232,31 +257,26 @@ static void _printk_hex_ulong(out_func_t out, void *ctx,
 			      const unsigned long num, int pad_zero,
 			      int min_width)
 {
-	int size = sizeof(num) * 2;
-	int found_largest_digit = 0;
-	int remaining = 8; /* 8 digits max */
-
-	for (; size; size--) {
-		char nibble = (num >> ((size - 1) << 2) & 0xf);
-
-		if (nibble || found_largest_digit || size == 1) {
-			found_largest_digit = 1;
-			nibble += nibble > 9 ? 87 : 48;
-			out((int)nibble, ctx);
-			continue;
-		}
+	char buf[sizeof(num) * 2];
+	char *end = buf + sizeof(buf);
+	char *p = end;
+	unsigned long remainder = num;
 
-		if (remaining-- <= min_width) {
-			out((int)(pad_zero ? '0' : ' '), ctx);
-		}
-	}
+	/* digits are produced least significant first, from the end */
+	do {
+		*--p = "0123456789abcdef"[remainder & 0xf];
+		remainder >>= 4;
+	} while (remainder);
+
+	_printk_digits(out, ctx, p, end - p, pad_zero, min_width,
+		       8 /* 8 digits max */);
 }
 
 /**
- * @brief Output an unsigned long (32-bit) in decimal format
+ * @brief Output an unsigned long in decimal format
  *
- * Output an unsigned long on output installed by platform at init time. Only
- * works with 32-bit values.
+ * Output an unsigned long on output installed by platform at init time. Should
+ * be able to handle an unsigned long of any size, 32 or 64 bit.
  * @param num Number to output
  *
  * @return N/A
@@ -265,28 +285,19 @@ static void _printk_dec_ulong(out_func_t out, void *ctx,
 			      const unsigned long num, int pad_zero,
 			      int min_width)
 {
-	unsigned long pos = 999999999;
+	char buf[sizeof(num) * 3];
+	char *end = buf + sizeof(buf);
+	char *p = end;
 	unsigned long remainder = num;
-	int found_largest_digit = 0;
-	int remaining = 10; /* 10 digits max */
 
-	/* make sure we don't skip if value is zero */
-	if (min_width <= 0) {
-		min_width = 1;
-	}
+	/* division by a constant: no actual division is performed */
+	do {
+		*--p = '0' + remainder % 10;
+		remainder /= 10;
+	} while (remainder);
 
-	while (pos >= 9) {
-		if (found_largest_digit || remainder > pos) {
-			found_largest_digit = 1;
-			out((int)((remainder / (pos + 1)) + 48), ctx);
-		} else if (remaining <= min_width) {
-			out((int)(pad_zero ? '0' : ' '), ctx);
-		}
-		remaining--;
-		remainder %= (pos + 1);
-		pos /= 10;
-	}
-	out((int)(remainder + 48), ctx);
+	_printk_digits(out, ctx, p, end - p, pad_zero, min_width,
+		       10 /* 10 digits max */);
 }
 
 struct str_context {
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Deferred printk() formatting
+ *
+ * printk() records the format string pointer and the arguments of each
+ * message in a ring buffer of words, and a low priority thread formats and
+ * outputs them later.
+ *
+ * Each message takes a header word, holding its number of arguments plus
+ * one, followed by the format string pointer and the arguments. Producers
+ * reserve room for a message by advancing the head index with a
+ * compare-and-swap, fill it in, then publish it by writing its header last:
+ * the consumer stops at the first header still null, and nulls the words of
+ * each message once it is done with it. No lock is ever taken, so printk()
+ * can be called from any context.
+ */
+
+#include <kernel.h>
+#include <atomic.h>
+#include <misc/printk.h>
+
+#define BUF_WORDS CONFIG_PRINTK_DEFERRED_BUF_WORDS
+#define BUF_MASK (BUF_WORDS - 1)
+#define MAX_ARGS 15
+
+BUILD_ASSERT((BUF_WORDS & BUF_MASK) == 0);
+
+static atomic_t buf[BUF_WORDS];
+
+/* free-running indexes, in words */
+static atomic_t head;
+static atomic_t tail;
+
+static atomic_t dropped;
+static atomic_t wakeup_pending;
+static atomic_t flushing;
+
+static K_SEM_DEFINE(printk_deferred_sem, 0, 1);
+
+int _printk_deferred(int nargs, const char *fmt, ...)
+{
+	uint32_t len = nargs + 2;
+	uint32_t start;
+	va_list ap;
+
+	if (nargs > MAX_ARGS) {
+		atomic_inc(&dropped);
+		return 0;
+	}
+
+	do {
+		start = atomic_get(&head);
+		if (start + len - (uint32_t)atomic_get(&tail) > BUF_WORDS) {
+			atomic_inc(&dropped);
+			return 0;
+		}
+	} while (!atomic_cas(&head, start, start + len));
+
+	buf[(start + 1) & BUF_MASK] = (atomic_val_t)fmt;
+
+	va_start(ap, fmt);
+	for (int i = 0; i < nargs; i++) {
+		buf[(start + 2 + i) & BUF_MASK] = va_arg(ap, atomic_val_t);
+	}
+	va_end(ap);
+
+	/* publish the message */
+	atomic_set(&buf[start & BUF_MASK], nargs + 1);
+
+	if (!atomic_set(&wakeup_pending, 1)) {
+		k_sem_give(&printk_deferred_sem);
+	}
+
+	return 0;
+}
+
+void printk_flush(void)
+{
+	uint32_t rd;
+
+	/* the thread and a fatal error handler could both be flushing */
+	if (!atomic_cas(&flushing, 0, 1)) {
+		return;
+	}
+
+	rd = atomic_get(&tail);
+
+	for (;;) {
+		atomic_val_t args[MAX_ARGS] = { 0 };
+		atomic_val_t header = atomic_get(&buf[rd & BUF_MASK]);
+		atomic_val_t num_dropped;
+		const char *fmt;
+		int nargs;
+
+		if (header == 0) {
+			break;
+		}
+
+		nargs = header - 1;
+		fmt = (const char *)buf[(rd + 1) & BUF_MASK];
+		for (int i = 0; i < nargs; i++) {
+			args[i] = buf[(rd + 2 + i) & BUF_MASK];
+		}
+
+		/* the words must be null before they can be reserved again */
+		for (int i = 0; i < nargs + 2; i++) {
+			buf[(rd + i) & BUF_MASK] = 0;
+		}
+		rd += nargs + 2;
+		atomic_set(&tail, rd);
+
+		num_dropped = atomic_clear(&dropped);
+		if (num_dropped) {
+			(printk)("--- %d messages dropped ---\n", num_dropped);
+		}
+
+		/* extra arguments are ignored by the format string */
+		(printk)(fmt, args[0], args[1], args[2], args[3], args[4],
+			 args[5], args[6], args[7], args[8], args[9], args[10],
+			 args[11], args[12], args[13], args[14]);
+	}
+
+	atomic_clear(&flushing);
+}
+
+static void printk_deferred_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_sem_take(&printk_deferred_sem, K_FOREVER);
+		atomic_clear(&wakeup_pending);
+		printk_flush();
+	}
+}
+
+K_THREAD_DEFINE(_printk_deferred_tid, CONFIG_PRINTK_DEFERRED_STACK_SIZE,
+		printk_deferred_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <misc/ring_buffer.h>
 
 /**
@@ -92,3 +93,107 @@ int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 
 	return 0;
 }
+
+/*
+ * The head is only moved by the consumer and the tail by the producer. Each
+ * side reads the index of the other with atomic_get() before accessing the
+ * buffer, and moves its own with atomic_set() after, which orders the
+ * accesses to the buffer with the moves of the indexes.
+ */
+
+uint32_t sys_byte_ring_buf_put_claim(struct byte_ring_buf *buf,
+				     uint8_t **data, uint32_t size)
+{
+	uint32_t tail = buf->tail;
+	uint32_t space = buf->size - (tail - (uint32_t)atomic_get(&buf->head));
+	uint32_t offset = tail & (buf->size - 1);
+
+	space = min(space, buf->size - offset);
+
+	*data = &buf->buf[offset];
+
+	return min(size, space);
+}
+
+int sys_byte_ring_buf_put_finish(struct byte_ring_buf *buf, uint32_t size)
+{
+	uint32_t tail = buf->tail;
+
+	if (size > buf->size - (tail - (uint32_t)atomic_get(&buf->head))) {
+		return -EINVAL;
+	}
+
+	atomic_set(&buf->tail, tail + size);
+
+	return 0;
+}
+
+uint32_t sys_byte_ring_buf_get_claim(struct byte_ring_buf *buf,
+				     uint8_t **data, uint32_t size)
+{
+	uint32_t head = buf->head;
+	uint32_t used = (uint32_t)atomic_get(&buf->tail) - head;
+	uint32_t offset = head & (buf->size - 1);
+
+	used = min(used, buf->size - offset);
+
+	*data = &buf->buf[offset];
+
+	return min(size, used);
+}
+
+int sys_byte_ring_buf_get_finish(struct byte_ring_buf *buf, uint32_t size)
+{
+	uint32_t head = buf->head;
+
+	if (size > (uint32_t)atomic_get(&buf->tail) - head) {
+		return -EINVAL;
+	}
+
+	atomic_set(&buf->head, head + size);
+
+	return 0;
+}
+
+uint32_t sys_byte_ring_buf_put(struct byte_ring_buf *buf, const uint8_t *data,
+			       uint32_t size)
+{
+	uint32_t total = 0;
+	uint32_t claimed;
+	uint8_t *dst;
+
+	/* at most twice, when the end of the buffer is reached */
+	while (total < size) {
+		claimed = sys_byte_ring_buf_put_claim(buf, &dst, size - total);
+		if (!claimed) {
+			break;
+		}
+
+		memcpy(dst, data + total, claimed);
+		sys_byte_ring_buf_put_finish(buf, claimed);
+		total += claimed;
+	}
+
+	return total;
+}
+
+uint32_t sys_byte_ring_buf_get(struct byte_ring_buf *buf, uint8_t *data,
+			       uint32_t size)
+{
+	uint32_t total = 0;
+	uint32_t claimed;
+	uint8_t *src;
+
+	while (total < size) {
+		claimed = sys_byte_ring_buf_get_claim(buf, &src, size - total);
+		if (!claimed) {
+			break;
+		}
+
+		memcpy(data + total, src, claimed);
+		sys_byte_ring_buf_get_finish(buf, claimed);
+		total += claimed;
+	}
+
+	return total;
+}
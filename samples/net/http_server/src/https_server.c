@@ -44,6 +44,10 @@
 #include "mbedtls/error.h"
 #include "mbedtls/debug.h"
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include "mbedtls/ssl_cache.h"
+#endif
+
 #if defined(MBEDTLS_DEBUG_C)
 #include "mbedtls/debug.h"
 #define DEBUG_THRESHOLD 0
@@ -143,6 +147,9 @@ void https_server(void)
 	mbedtls_ssl_config conf;
 	mbedtls_x509_crt srvcert;
 	mbedtls_pk_context pkey;
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_context cache;
+#endif
 
 	mbedtls_platform_set_printf(printk);
 
@@ -160,6 +167,9 @@ void https_server(void)
 	mbedtls_ssl_config_init(&conf);
 	mbedtls_entropy_init(&entropy);
 	mbedtls_ctr_drbg_init(&ctr_drbg);
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&cache);
+#endif
 
 	/*
 	 * 1. Load the certificates and private RSA key
@@ -214,6 +224,12 @@ void https_server(void)
 	mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
 	mbedtls_ssl_conf_dbg(&conf, my_debug, NULL);
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+	/* Reconnecting clients resume their session, skipping the RSA ops */
+	mbedtls_ssl_conf_session_cache(&conf, &cache, mbedtls_ssl_cache_get,
+				       mbedtls_ssl_cache_set);
+#endif
+
 	mbedtls_ssl_conf_ca_chain(&conf, srvcert.next, NULL);
 	ret = mbedtls_ssl_conf_own_cert(&conf, &srvcert, &pkey);
 	if (ret != 0) {
@@ -361,6 +377,9 @@ exit:
 
 	mbedtls_ssl_free(&ssl);
 	mbedtls_ssl_config_free(&conf);
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_free(&cache);
+#endif
 	mbedtls_ctr_drbg_free(&ctr_drbg);
 	mbedtls_entropy_free(&entropy);
 }
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if 1
+#define SYS_LOG_DOMAIN "sockets-echo"
+#define NET_SYS_LOG_LEVEL SYS_LOG_LEVEL_DEBUG
+#define NET_LOG_ENABLED 1
+#endif
+
+#include <zephyr.h>
+#include <errno.h>
+#include <string.h>
+
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/socket.h>
+
+#define PORT 4242
+
+/* The UDP socket, the listening TCP socket, and the connections */
+#define MAX_FDS CONFIG_NET_SOCKETS_POLL_MAX
+
+static struct pollfd fds[MAX_FDS];
+static int nfds;
+
+static char buf[256];
+
+static void add_fd(int fd)
+{
+	fds[nfds].fd = fd;
+	fds[nfds].events = POLLIN;
+	nfds++;
+}
+
+static void remove_fd(int i)
+{
+	close(fds[i].fd);
+	fds[i] = fds[--nfds];
+}
+
+static int setup(int type)
+{
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(PORT),
+	};
+	int fd;
+
+	fd = socket(AF_INET6, type, 0);
+	if (fd < 0) {
+		NET_ERR("Cannot create socket (%d)", errno);
+		return -1;
+	}
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		NET_ERR("Cannot bind socket (%d)", errno);
+		return -1;
+	}
+
+	if (type == SOCK_STREAM && listen(fd, 1) < 0) {
+		NET_ERR("Cannot listen (%d)", errno);
+		return -1;
+	}
+
+	add_fd(fd);
+
+	return fd;
+}
+
+static void serve(int i, int udp, int tcp)
+{
+	struct sockaddr_in6 addr;
+	socklen_t addrlen = sizeof(addr);
+	ssize_t len;
+	int fd = fds[i].fd;
+
+	if (fd == tcp) {
+		fd = accept(tcp, (struct sockaddr *)&addr, &addrlen);
+		if (fd < 0) {
+			return;
+		}
+
+		if (nfds == MAX_FDS) {
+			NET_INFO("Too many connections");
+			close(fd);
+			return;
+		}
+
+		add_fd(fd);
+		return;
+	}
+
+	len = recvfrom(fd, buf, sizeof(buf), MSG_DONTWAIT,
+		       (struct sockaddr *)&addr, &addrlen);
+	if (len < 0 && errno == EAGAIN) {
+		return;
+	}
+
+	if (len <= 0) {
+		remove_fd(i);
+		return;
+	}
+
+	if (fd == udp) {
+		sendto(fd, buf, len, 0, (struct sockaddr *)&addr, addrlen);
+		return;
+	}
+
+	while (len > 0) {
+		ssize_t sent = send(fd, buf, len, 0);
+
+		if (sent < 0) {
+			remove_fd(i);
+			return;
+		}
+
+		memmove(buf, buf + sent, len - sent);
+		len -= sent;
+	}
+}
+
+void main(void)
+{
+	struct in6_addr my_addr;
+	int udp, tcp;
+	int i;
+
+	if (net_addr_pton(AF_INET6, CONFIG_NET_SAMPLES_MY_IPV6_ADDR,
+			  &my_addr) < 0) {
+		NET_ERR("Invalid IPv6 address %s",
+			CONFIG_NET_SAMPLES_MY_IPV6_ADDR);
+		return;
+	}
+
+	net_if_ipv6_addr_add(net_if_get_default(), &my_addr,
+			     NET_ADDR_MANUAL, 0);
+
+	udp = setup(SOCK_DGRAM);
+	tcp = setup(SOCK_STREAM);
+	if (udp < 0 || tcp < 0) {
+		return;
+	}
+
+	NET_INFO("Echoing on port %d", PORT);
+
+	while (1) {
+		if (poll(fds, nfds, K_FOREVER) < 0) {
+			NET_ERR("Cannot poll (%d)", errno);
+			return;
+		}
+
+		/* Backwards, as serving can replace the socket by the last */
+		for (i = nfds - 1; i >= 0; i--) {
+			if (fds[i].revents) {
+				serve(i, udp, tcp);
+			}
+		}
+	}
+}
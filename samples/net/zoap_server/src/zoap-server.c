@@ -802,15 +802,27 @@ static int large_create_post(struct zoap_resource *resource,
 				  NULL, 0, NULL, NULL);
 }
 
-static void update_counter(struct k_work *work)
+static int add_pending(struct zoap_packet *pkt, const struct sockaddr *addr)
 {
-	obs_counter++;
+	struct zoap_pending *pending;
+	int r;
 
-	if (resource_to_notify) {
-		zoap_resource_notify(resource_to_notify);
+	pending = zoap_pending_next_unused(pendings, NUM_PENDINGS);
+	if (!pending) {
+		return -EINVAL;
 	}
 
-	k_delayed_work_submit(&observer_work, 5 * MSEC_PER_SEC);
+	r = zoap_pending_init(pending, pkt, addr);
+	if (r) {
+		return -EINVAL;
+	}
+
+	zoap_pending_cycle(pending);
+	pending = zoap_pending_next_to_expire(pendings, NUM_PENDINGS);
+
+	k_delayed_work_submit(&retransmit_work, pending->timeout);
+
+	return 0;
 }
 
 static int send_notification_packet(const struct sockaddr *addr, uint16_t age,
@@ -819,7 +831,6 @@ static int send_notification_packet(const struct sockaddr *addr, uint16_t age,
 				    bool is_response)
 {
 	struct zoap_packet response;
-	struct zoap_pending *pending;
 	struct net_buf *buf, *frag;
 	uint8_t *payload, type = ZOAP_TYPE_CON;
 	uint16_t len;
@@ -879,20 +890,10 @@ static int send_notification_packet(const struct sockaddr *addr, uint16_t age,
 	}
 
 	if (type == ZOAP_TYPE_CON) {
-		pending = zoap_pending_next_unused(pendings, NUM_PENDINGS);
-		if (!pending) {
-			return -EINVAL;
-		}
-
-		r = zoap_pending_init(pending, &response, addr);
+		r = add_pending(&response, addr);
 		if (r) {
-			return -EINVAL;
+			return r;
 		}
-
-		zoap_pending_cycle(pending);
-		pending = zoap_pending_next_to_expire(pendings, NUM_PENDINGS);
-
-		k_delayed_work_submit(&retransmit_work, pending->timeout);
 	}
 
 	return net_context_sendto(buf, addr, addrlen, NULL, 0, NULL, NULL);
@@ -940,12 +941,97 @@ done:
 					token, tkl, true);
 }
 
-static void obs_notify(struct zoap_resource *resource,
-		       struct zoap_observer *observer)
+static int obs_send(struct zoap_resource *resource,
+		    struct zoap_observer *observer,
+		    const struct zoap_notification *notification,
+		    void *user_data)
+{
+	struct zoap_packet pkt;
+	struct net_buf *buf, *frag;
+	int r;
+
+	buf = net_nbuf_get_tx(context, K_FOREVER);
+	frag = net_nbuf_get_data(context, K_FOREVER);
+
+	net_buf_frag_add(buf, frag);
+
+	r = zoap_notification_packet_init(&pkt, buf, notification, observer,
+					  zoap_next_id());
+	if (r < 0) {
+		net_nbuf_unref(buf);
+		return r;
+	}
+
+	r = add_pending(&pkt, &observer->addr);
+	if (r) {
+		net_nbuf_unref(buf);
+		return r;
+	}
+
+	return net_context_sendto(buf, &observer->addr,
+				  sizeof(observer->addr), NULL, 0, NULL, NULL);
+}
+
+/* The notification is built once, for all the observers */
+static int obs_notify_all(struct zoap_resource *resource)
+{
+	struct zoap_packet notification;
+	struct net_buf *buf, *frag;
+	uint8_t *payload;
+	uint16_t len;
+	int r;
+
+	buf = net_nbuf_get_tx(context, K_FOREVER);
+	frag = net_nbuf_get_data(context, K_FOREVER);
+
+	net_buf_frag_add(buf, frag);
+
+	r = zoap_notification_init(&notification, buf, resource);
+	if (r < 0) {
+		goto done;
+	}
+
+	r = zoap_add_option(&notification, ZOAP_OPTION_CONTENT_FORMAT,
+			    &plain_text_format, sizeof(plain_text_format));
+	if (r < 0) {
+		goto done;
+	}
+
+	payload = zoap_packet_get_payload(&notification, &len);
+	if (!payload) {
+		r = -EINVAL;
+		goto done;
+	}
+
+	r = snprintk((char *) payload, len, "Counter: %d\n", obs_counter);
+	if (r < 0 || r > len) {
+		r = -EINVAL;
+		goto done;
+	}
+
+	r = zoap_packet_set_used(&notification, r);
+	if (r) {
+		goto done;
+	}
+
+	r = zoap_resource_notify_shared(resource, &notification, obs_send,
+					NULL);
+
+done:
+	net_nbuf_unref(buf);
+
+	return r;
+}
+
+static void update_counter(struct k_work *work)
 {
-	send_notification_packet(&observer->addr, resource->age,
-				 sizeof(observer->addr), 0,
-				 observer->token, observer->tkl, false);
+	obs_counter++;
+
+	if (resource_to_notify) {
+		obs_notify_all(resource_to_notify);
+	}
+
+	k_delayed_work_submit(&observer_work, 5 * MSEC_PER_SEC);
 }
 
 static int core_get(struct zoap_resource *resource,
@@ -1055,7 +1141,6 @@ static struct zoap_resource resources[] = {
 	},
 	{ .path = obs_path,
 	  .get = obs_get,
-	  .notify = obs_notify,
 	},
 	ZOAP_WELL_KNOWN_CORE_RESOURCE,
 	{ .get = core_get,
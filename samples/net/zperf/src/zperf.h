@@ -15,6 +15,7 @@
 #define CMD_STR_UDP_UPLOAD "udp.upload"
 #define CMD_STR_UDP_UPLOAD2 "udp.upload2"
 #define CMD_STR_UDP_DOWNLOAD "udp.download"
+#define CMD_STR_UDP_LATENCY "udp.latency"
 #define CMD_STR_TCP_UPLOAD "tcp.upload"
 #define CMD_STR_TCP_UPLOAD2 "tcp.upload2"
 #define CMD_STR_TCP_DOWNLOAD "tcp.download"
@@ -30,6 +31,7 @@ struct zperf_results {
 	uint32_t client_time_in_us;
 	uint32_t packet_size;
 	uint32_t nb_packets_errors;
+	uint32_t cpu_load;
 };
 
 typedef void (*zperf_callback)(int status, struct zperf_results *);
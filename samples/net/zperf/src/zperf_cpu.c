@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#include <net/net_context.h>
+
+#include "zperf.h"
+#include "zperf_internal.h"
+
+#define SPIN_STACK_SIZE 256
+#define CALIBRATION_MS 100
+
+/* The CPU load is measured by counting how often a thread of the lowest
+ * priority gets to spin during a test, against how often it spins when
+ * nothing else runs.
+ */
+static char __noinit __stack zperf_spin_stack[SPIN_STACK_SIZE];
+static K_SEM_DEFINE(spin_sem, 0, 1);
+static volatile bool spinning;
+static volatile uint32_t spin_count;
+static uint32_t idle_per_ms;
+static uint32_t start_time;
+
+static void zperf_spin_thread(void)
+{
+	while (1) {
+		if (!spinning) {
+			k_sem_take(&spin_sem, K_FOREVER);
+			continue;
+		}
+
+		spin_count++;
+	}
+}
+
+void zperf_cpu_start(void)
+{
+	spin_count = 0;
+	start_time = k_uptime_get_32();
+	spinning = true;
+
+	k_sem_give(&spin_sem);
+}
+
+unsigned int zperf_cpu_stop(void)
+{
+	uint32_t idle_count, elapsed;
+
+	spinning = false;
+
+	elapsed = k_uptime_get_32() - start_time;
+	idle_count = idle_per_ms * elapsed;
+
+	if (!idle_count || spin_count >= idle_count) {
+		return 0;
+	}
+
+	return 100 - (uint32_t)((uint64_t)spin_count * 100 / idle_count);
+}
+
+void zperf_cpu_init(void)
+{
+	k_thread_spawn(zperf_spin_stack, sizeof(zperf_spin_stack),
+		       (k_thread_entry_t)zperf_spin_thread, NULL, NULL, NULL,
+		       K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	/* Nothing else is supposed to run yet */
+	zperf_cpu_start();
+	k_sleep(CALIBRATION_MS);
+	spinning = false;
+
+	idle_per_ms = spin_count / CALIBRATION_MS;
+
+	printk("[%s] %u idle spins per ms\n", __func__, idle_per_ms);
+}
@@ -106,6 +106,14 @@ extern void zperf_tcp_upload(struct net_context *net_context,
 			     struct zperf_results *results);
 #endif
 
+extern void zperf_udp_latency(struct net_context *net_context,
+			      unsigned int count,
+			      unsigned int packet_size);
+
+extern void zperf_cpu_init(void);
+extern void zperf_cpu_start(void);
+extern unsigned int zperf_cpu_stop(void);
+
 extern void connect_ap(char *ssid);
 
 #endif /* __ZPERF_INTERNAL_H */
@@ -430,6 +430,15 @@ static void shell_tcp_upload2_usage(void)
 }
 #endif
 
+static inline uint32_t packets_per_sec(uint32_t packets, uint32_t time_in_us)
+{
+	if (!time_in_us) {
+		return 0;
+	}
+
+	return (uint32_t)(((uint64_t)packets * USEC_PER_SEC) / time_in_us);
+}
+
 #if defined(CONFIG_NET_UDP)
 static void shell_udp_upload_print_stats(struct zperf_results *results)
 {
@@ -486,6 +495,12 @@ static void shell_udp_upload_print_stats(struct zperf_results *results)
 	printk("\t(");
 	print_number(client_rate_in_kbps, KBPS, KBPS_UNIT);
 	printk(")\n");
+
+	printk("[%s] packets/s:\t\t(%u)\n", CMD_STR_UDP_UPLOAD,
+	       packets_per_sec(results->nb_packets_sent,
+			       results->client_time_in_us));
+	printk("[%s] CPU load:\t\t(%u %%)\n", CMD_STR_UDP_UPLOAD,
+	       results->cpu_load);
 }
 #endif
 
@@ -516,6 +531,11 @@ static void shell_tcp_upload_print_stats(struct zperf_results *results)
 	printk("[%s] rate:\t", CMD_STR_TCP_UPLOAD);
 	print_number(client_rate_in_kbps, KBPS, KBPS_UNIT);
 	printk("\n");
+	printk("[%s] packets/s:\t%u\n", CMD_STR_TCP_UPLOAD,
+	       packets_per_sec(results->nb_packets_sent,
+			       results->client_time_in_us));
+	printk("[%s] CPU load:\t%u %%\n", CMD_STR_TCP_UPLOAD,
+	       results->cpu_load);
 }
 #endif
 
@@ -591,6 +611,59 @@ static int setup_contexts(struct net_context **context6,
 	return 0;
 }
 
+/* Parse the address of the remote server, returning its family */
+static sa_family_t parse_dst_addr(char *host, char *port,
+				  struct sockaddr_in6 *ipv6,
+				  struct sockaddr_in *ipv4,
+				  char *argv0)
+{
+#if defined(CONFIG_NET_IPV6) && !defined(CONFIG_NET_IPV4)
+	if (parse_ipv6_addr(host, port, ipv6, argv0) < 0) {
+		printk("[%s] ERROR! Please specify the IP address of the "
+			"remote server\n",  argv0);
+		return AF_UNSPEC;
+	}
+
+	printk("[%s] Connecting to %s\n", argv0,
+	       net_sprint_ipv6_addr(&ipv6->sin6_addr));
+
+	return AF_INET6;
+#endif
+
+#if defined(CONFIG_NET_IPV4) && !defined(CONFIG_NET_IPV6)
+	if (parse_ipv4_addr(host, port, ipv4, argv0) < 0) {
+		printk("[%s] ERROR! Please specify the IP address of the "
+		       "remote server\n",  argv0);
+		return AF_UNSPEC;
+	}
+
+	printk("[%s] Connecting to %s\n", argv0,
+	       net_sprint_ipv4_addr(&ipv4->sin_addr));
+
+	return AF_INET;
+#endif
+
+#if defined(CONFIG_NET_IPV6) && defined(CONFIG_NET_IPV4)
+	if (parse_ipv6_addr(host, port, ipv6, argv0) < 0) {
+		if (parse_ipv4_addr(host, port, ipv4, argv0) < 0) {
+			printk("[%s] ERROR! Please specify the IP address "
+			       "of the remote server\n",  argv0);
+			return AF_UNSPEC;
+		}
+
+		printk("[%s] Connecting to %s\n", argv0,
+		       net_sprint_ipv4_addr(&ipv4->sin_addr));
+
+		return AF_INET;
+	} else {
+		printk("[%s] Connecting to %s\n", argv0,
+		       net_sprint_ipv6_addr(&ipv6->sin6_addr));
+
+		return AF_INET6;
+	}
+#endif
+}
+
 static int execute_upload(struct net_context *context6,
 			  struct net_context *context4,
 			  sa_family_t family,
@@ -762,56 +835,12 @@ static int shell_cmd_upload(int argc, char *argv[])
 		return -1;
 	}
 
-#if defined(CONFIG_NET_IPV6) && !defined(CONFIG_NET_IPV4)
-	if (parse_ipv6_addr(argv[start + 1], argv[start + 2],
-			    &ipv6, argv[start]) < 0) {
-		printk("[%s] ERROR! Please specify the IP address of the "
-			"remote server\n",  argv[start]);
+	family = parse_dst_addr(argv[start + 1], argv[start + 2],
+				 &ipv6, &ipv4, argv[start]);
+	if (family == AF_UNSPEC) {
 		return -1;
 	}
 
-	printk("[%s] Connecting to %s\n", argv[start],
-	       net_sprint_ipv6_addr(&ipv6.sin6_addr));
-
-	family = AF_INET6;
-#endif
-
-#if defined(CONFIG_NET_IPV4) && !defined(CONFIG_NET_IPV6)
-	if (parse_ipv4_addr(argv[start + 1], argv[start + 2],
-			    &ipv4, argv[start]) < 0) {
-		printk("[%s] ERROR! Please specify the IP address of the "
-		       "remote server\n",  argv[start]);
-		return -1;
-	}
-
-	printk("[%s] Connecting to %s\n", argv[start],
-	       net_sprint_ipv4_addr(&ipv4.sin_addr));
-
-	family = AF_INET;
-#endif
-
-#if defined(CONFIG_NET_IPV6) && defined(CONFIG_NET_IPV4)
-	if (parse_ipv6_addr(argv[start + 1], argv[start + 2],
-			    &ipv6, argv[start]) < 0) {
-		if (parse_ipv4_addr(argv[start + 1], argv[start + 2],
-				    &ipv4, argv[start]) < 0) {
-			printk("[%s] ERROR! Please specify the IP address "
-			       "of the remote server\n",  argv[start]);
-			return -1;
-		}
-
-		printk("[%s] Connecting to %s\n", argv[start],
-		       net_sprint_ipv4_addr(&ipv4.sin_addr));
-
-		family = AF_INET;
-	} else {
-		printk("[%s] Connecting to %s\n", argv[start],
-		       net_sprint_ipv6_addr(&ipv6.sin6_addr));
-
-		family = AF_INET6;
-	}
-#endif
-
 	if (argc > 2) {
 		port = strtoul(argv[start + 2], NULL, 10);
 		printk("[%s] Remote port is %u\n", argv[start], port);
@@ -953,6 +982,101 @@ static int shell_cmd_upload2(int argc, char *argv[])
 			      duration_in_ms, packet_size, rate_in_kbps);
 }
 
+#if defined(CONFIG_NET_UDP)
+static void shell_udp_latency_usage(void)
+{
+	/* Print usage */
+	printk("\n%s:\n", CMD_STR_UDP_LATENCY);
+	printk("Usage:\t%s <dest ip> <dest port> <count> <packet size>[K]\n",
+	       CMD_STR_UDP_LATENCY);
+	printk("\t<dest ip>:\tIP of an UDP echo server, or our own IP\n");
+	printk("\t<dest port>:\tUDP destination port\n");
+	printk("\t<count>:\tNumber of requests sent\n");
+	printk("\t<packet size>:\tSize of the packet in byte or kilobyte "
+	       "(with suffix K)\n");
+	printk("\nExample %s 10.237.164.178 4242 100 64\n",
+	       CMD_STR_UDP_LATENCY);
+}
+
+static int shell_cmd_udp_latency(int argc, char *argv[])
+{
+	struct sockaddr_in6 ipv6 = { .sin6_family = AF_INET6 };
+	struct sockaddr_in ipv4 = { .sin_family = AF_INET };
+	struct net_context *context6 = NULL, *context4 = NULL;
+	struct net_context *context;
+	struct sockaddr *addr;
+	socklen_t addrlen;
+	sa_family_t family;
+	unsigned int count, packet_size;
+	uint16_t port;
+	int start = 0, ret;
+
+	if (!strcmp(argv[0], "zperf")) {
+		start++;
+		argc--;
+	}
+
+	if (argc < 3) {
+		shell_udp_latency_usage();
+		return -1;
+	}
+
+	family = parse_dst_addr(argv[start + 1], argv[start + 2],
+				&ipv6, &ipv4, argv[start]);
+	if (family == AF_UNSPEC) {
+		return -1;
+	}
+
+	/* Binding to the destination port lets the requests sent to our
+	 * own address come back to us, measuring the stack alone.
+	 */
+	port = strtoul(argv[start + 2], NULL, 10);
+
+	if (setup_contexts(&context6, &context4, family, &in6_addr_my,
+			   &in4_addr_my, port, true, argv[start]) < 0) {
+		ret = -1;
+		goto out;
+	}
+
+	count = argc > 3 ? strtoul(argv[start + 3], NULL, 10) : 10;
+	packet_size = argc > 4 ?
+		parse_number(argv[start + 4], K, K_UNIT) : 64;
+
+	if (family == AF_INET6) {
+		context = context6;
+		addr = (struct sockaddr *)&ipv6;
+		addrlen = sizeof(ipv6);
+	} else {
+		context = context4;
+		addr = (struct sockaddr *)&ipv4;
+		addrlen = sizeof(ipv4);
+	}
+
+	ret = net_context_connect(context, addr, addrlen, NULL, K_NO_WAIT,
+				  NULL);
+	if (ret < 0) {
+		printk("[%s] connect failed (%d)\n", argv[start], ret);
+		goto out;
+	}
+
+	printk("[%s] %u requests of %u bytes\n", argv[start], count,
+	       packet_size);
+
+	zperf_udp_latency(context, count, packet_size);
+
+out:
+	if (context6) {
+		net_context_put(context6);
+	}
+
+	if (context4) {
+		net_context_put(context4);
+	}
+
+	return ret;
+}
+#endif
+
 static int shell_cmd_connectap(int argc, char *argv[])
 {
 	printk("[%s] Zephyr has not been built with Wi-Fi support.\n",
@@ -1058,6 +1182,7 @@ static void zperf_init(void)
 #endif
 
 	zperf_session_init();
+	zperf_cpu_init();
 }
 
 #define MY_SHELL_MODULE "zperf"
@@ -1070,6 +1195,7 @@ struct shell_cmd commands[] = {
 	/* Same as upload command but no need to specify the addresses */
 	{ CMD_STR_UDP_UPLOAD2, shell_cmd_upload2 },
 	{ CMD_STR_UDP_DOWNLOAD, shell_cmd_udp_download },
+	{ CMD_STR_UDP_LATENCY, shell_cmd_udp_latency },
 #endif
 #if defined(CONFIG_NET_TCP)
 	{ CMD_STR_TCP_UPLOAD, shell_cmd_upload },
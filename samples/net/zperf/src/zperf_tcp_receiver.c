@@ -64,6 +64,7 @@ static void tcp_received(struct net_context *context,
 		zperf_reset_session_stats(session);
 		session->start_time =  sys_cycle_get_32();
 		session->state = STATE_ONGOING;
+		zperf_cpu_start();
 		/* fall through */
 	case STATE_ONGOING:
 		session->counter++;
@@ -73,11 +74,12 @@ static void tcp_received(struct net_context *context,
 		}
 
 		if (!buf && status == 0) { /* EOF */
-			uint32_t rate_in_kbps;
+			uint32_t rate_in_kbps, cpu_load;
 			uint32_t duration = HW_CYCLES_TO_USEC(
 				time_delta(session->start_time, time));
 
 			session->state = STATE_COMPLETED;
+			cpu_load = zperf_cpu_stop();
 
 			/* Compute baud rate */
 			if (duration != 0) {
@@ -99,6 +101,8 @@ static void tcp_received(struct net_context *context,
 			printk(TAG " rate:\t\t\t");
 			print_number(rate_in_kbps, KBPS, KBPS_UNIT);
 			printk("\n");
+
+			printk(TAG " CPU load:\t\t%u %%\n", cpu_load);
 		}
 		break;
 	case STATE_LAST_PACKET_RECEIVED:
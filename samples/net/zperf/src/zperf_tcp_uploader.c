@@ -37,6 +37,7 @@ void zperf_tcp_upload(struct net_context *ctx,
 	}
 
 	/* Start the loop */
+	zperf_cpu_start();
 	start_time = k_cycle_get_32();
 	last_print_time = start_time;
 	last_loop_time = start_time;
@@ -106,6 +107,7 @@ void zperf_tcp_upload(struct net_context *ctx,
 	} while (!finished);
 
 	end_time = k_cycle_get_32();
+	results->cpu_load = zperf_cpu_stop();
 
 	/* Add result coming from the client */
 	results->nb_packets_sent = nb_packets;
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include <misc/printk.h>
+
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/nbuf.h>
+
+#include "zperf.h"
+#include "zperf_internal.h"
+#include "shell_utils.h"
+
+#define TAG CMD_STR_UDP_LATENCY" "
+
+#define REPLY_TIMEOUT (1 * MSEC_PER_SEC)
+
+static char sample_packet[PACKET_SIZE_MAX];
+
+/* Set by the receive callback, which can still run for a late reply once
+ * the sender gave up waiting
+ */
+static volatile uint32_t rx_time;
+static volatile int32_t rx_id;
+
+static void reply_received(struct net_context *context,
+			   struct net_buf *buf,
+			   int status,
+			   void *user_data)
+{
+	uint16_t offset, pos;
+	uint32_t id;
+
+	if (!buf) {
+		return;
+	}
+
+	if (net_nbuf_appdatalen(buf) >= sizeof(struct zperf_udp_datagram)) {
+		offset = net_nbuf_appdata(buf) - net_nbuf_ip_data(buf);
+
+		net_nbuf_read_be32(buf->frags, offset, &pos, &id);
+
+		rx_time = k_cycle_get_32();
+		rx_id = id;
+	}
+
+	net_nbuf_unref(buf);
+}
+
+static struct net_buf *build_request(struct net_context *context,
+				     uint32_t id, uint32_t time,
+				     unsigned int packet_size)
+{
+	struct zperf_udp_datagram datagram;
+	struct net_buf *buf;
+
+	buf = net_nbuf_get_tx(context, K_FOREVER);
+	if (!buf) {
+		return NULL;
+	}
+
+	datagram.id = htonl(id);
+	datagram.tv_sec = htonl(HW_CYCLES_TO_SEC(time));
+	datagram.tv_usec = htonl(HW_CYCLES_TO_USEC(time) % USEC_PER_SEC);
+
+	if (!net_nbuf_append(buf, sizeof(datagram), (uint8_t *)&datagram,
+			     K_FOREVER) ||
+	    !net_nbuf_append(buf, packet_size - sizeof(datagram),
+			     sample_packet, K_FOREVER)) {
+		net_nbuf_unref(buf);
+		return NULL;
+	}
+
+	return buf;
+}
+
+/* Each request waits for its reply, so the round trip time is measured
+ * from the send call to the receive callback of the application.
+ */
+void zperf_udp_latency(struct net_context *context,
+		       unsigned int count,
+		       unsigned int packet_size)
+{
+	uint32_t min = UINT32_MAX, max = 0, rtt;
+	uint64_t total = 0;
+	unsigned int i, rcvd = 0, cpu_load;
+
+	if (packet_size > PACKET_SIZE_MAX) {
+		printk(TAG "WARNING! packet size too large! max size: %u\n",
+		       PACKET_SIZE_MAX);
+		packet_size = PACKET_SIZE_MAX;
+	} else if (packet_size < sizeof(struct zperf_udp_datagram)) {
+		printk(TAG "WARNING! packet size set to the min size: %zu\n",
+		       sizeof(struct zperf_udp_datagram));
+		packet_size = sizeof(struct zperf_udp_datagram);
+	}
+
+	memset(sample_packet, 'z', sizeof(sample_packet));
+
+	zperf_cpu_start();
+
+	for (i = 0; i < count; i++) {
+		struct net_buf *buf;
+		uint32_t tx_time;
+		int ret;
+
+		rx_id = -1;
+		tx_time = k_cycle_get_32();
+
+		buf = build_request(context, i, tx_time, packet_size);
+		if (!buf) {
+			printk(TAG "ERROR! Failed to build a request\n");
+			break;
+		}
+
+		ret = net_context_send(buf, NULL, K_NO_WAIT, NULL, NULL);
+		if (ret < 0) {
+			printk(TAG "ERROR! Failed to send the buffer (%d)\n",
+			       ret);
+			net_nbuf_unref(buf);
+			break;
+		}
+
+		/* Whatever it returns, the callback tells about the reply */
+		net_context_recv(context, reply_received, REPLY_TIMEOUT, NULL);
+
+		if (rx_id != i) {
+			continue;
+		}
+
+		rtt = HW_CYCLES_TO_USEC(time_delta(tx_time, rx_time));
+
+		min = min(min, rtt);
+		max = max(max, rtt);
+		total += rtt;
+		rcvd++;
+	}
+
+	cpu_load = zperf_cpu_stop();
+
+	/* Late replies are not waited for */
+	net_context_recv(context, NULL, K_NO_WAIT, NULL);
+
+	printk(TAG "requests:\t%u\n", i);
+	printk(TAG "replies:\t%u\n", rcvd);
+
+	if (rcvd) {
+		printk(TAG "rtt min:\t");
+		print_number(min, TIME_US, TIME_US_UNIT);
+		printk("\n");
+
+		printk(TAG "rtt avg:\t");
+		print_number(total / rcvd, TIME_US, TIME_US_UNIT);
+		printk("\n");
+
+		printk(TAG "rtt max:\t");
+		print_number(max, TIME_US, TIME_US_UNIT);
+		printk("\n");
+	}
+
+	printk(TAG "CPU load:\t%u %%\n", cpu_load);
+}
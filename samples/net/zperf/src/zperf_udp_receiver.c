@@ -96,18 +96,19 @@ static int zperf_receiver_send_stat(struct net_context *context,
 				    struct zperf_udp_datagram *hdr,
 				    struct zperf_server_hdr *stat)
 {
+	sa_family_t family = net_nbuf_family(buf);
 	struct net_buf *reply_buf;
 	struct sockaddr dst_addr;
 	int ret;
 
-	set_dst_addr(net_nbuf_family(buf), buf, &dst_addr);
+	set_dst_addr(family, buf, &dst_addr);
 
 	reply_buf = build_reply_buf(context, buf, hdr, stat);
 
 	net_nbuf_unref(buf);
 
 	ret = net_context_sendto(reply_buf, &dst_addr,
-				 net_nbuf_family(buf) == AF_INET6 ?
+				 family == AF_INET6 ?
 				 sizeof(struct sockaddr_in6) :
 				 sizeof(struct sockaddr_in),
 				 NULL, 0, NULL, NULL);
@@ -162,16 +163,16 @@ static void udp_received(struct net_context *context,
 		printk(TAG "End of session!\n");
 
 		if (session->state == STATE_COMPLETED) {
-			/* Session is already completed: Resend the stat buffer
-			 * and continue
+			/* Session is already completed: Resend the stat buffer,
+			 * which releases the received one in any case
 			 */
 			if (zperf_receiver_send_stat(context, buf, &hdr,
 						     &session->stat) < 0) {
 				printk(TAG "ERROR! Failed to send the "
 				       "buffer\n");
-
-				net_nbuf_unref(buf);
 			}
+
+			return;
 		} else {
 			session->state = STATE_LAST_PACKET_RECEIVED;
 			id = -id;
@@ -184,6 +185,7 @@ static void udp_received(struct net_context *context,
 		zperf_reset_session_stats(session);
 		session->state = STATE_ONGOING;
 		session->start_time = time;
+		zperf_cpu_start();
 	}
 
 	/* Check header id */
@@ -220,12 +222,13 @@ static void udp_received(struct net_context *context,
 
 	/* If necessary send statistics */
 	if (session->state == STATE_LAST_PACKET_RECEIVED) {
-		uint32_t rate_in_kbps;
+		uint32_t rate_in_kbps, pps, cpu_load;
 		uint32_t duration = HW_CYCLES_TO_USEC(
 			time_delta(session->start_time, time));
 
 		/* Update state machine */
 		session->state = STATE_COMPLETED;
+		cpu_load = zperf_cpu_stop();
 
 		/* Compute baud rate */
 		if (duration != 0) {
@@ -233,49 +236,48 @@ static void udp_received(struct net_context *context,
 				(((uint64_t)session->length * (uint64_t)8 *
 				  (uint64_t)USEC_PER_SEC) /
 				 ((uint64_t)duration * 1024));
+			pps = (uint32_t)(((uint64_t)session->counter *
+					  USEC_PER_SEC) / duration);
 		} else {
 			rate_in_kbps = 0;
+			pps = 0;
+		}
 
-			/* Fill statistics */
-			session->stat.flags = 0x80000000;
-			session->stat.total_len1 = session->length >> 32;
-			session->stat.total_len2 =
-				session->length % 0xFFFFFFFF;
-			session->stat.stop_sec = duration / USEC_PER_SEC;
-			session->stat.stop_usec = duration % USEC_PER_SEC;
-			session->stat.error_cnt = session->error;
-			session->stat.outorder_cnt = session->outorder;
-			session->stat.datagrams = session->counter;
-			session->stat.jitter1 = 0;
-			session->stat.jitter2 = session->jitter;
-
-			if (zperf_receiver_send_stat(context, buf, &hdr,
-						     &session->stat) < 0) {
-				printk(TAG "ERROR! Failed to send the "
-				       "buffer\n");
+		/* Fill statistics */
+		session->stat.flags = 0x80000000;
+		session->stat.total_len1 = session->length >> 32;
+		session->stat.total_len2 = session->length % 0xFFFFFFFF;
+		session->stat.stop_sec = duration / USEC_PER_SEC;
+		session->stat.stop_usec = duration % USEC_PER_SEC;
+		session->stat.error_cnt = session->error;
+		session->stat.outorder_cnt = session->outorder;
+		session->stat.datagrams = session->counter;
+		session->stat.jitter1 = 0;
+		session->stat.jitter2 = session->jitter;
+
+		if (zperf_receiver_send_stat(context, buf, &hdr,
+					     &session->stat) < 0) {
+			printk(TAG "ERROR! Failed to send the buffer\n");
+		}
 
-				net_nbuf_unref(buf);
-			}
+		printk(TAG " duration:\t\t");
+		print_number(duration, TIME_US, TIME_US_UNIT);
+		printk("\n");
 
-			printk(TAG " duration:\t\t");
-			print_number(duration, TIME_US, TIME_US_UNIT);
-			printk("\n");
+		printk(TAG " received packets:\t%u\n", session->counter);
+		printk(TAG " nb packets lost:\t%u\n", session->error);
+		printk(TAG " nb packets outorder:\t%u\n", session->outorder);
 
-			printk(TAG " received packets:\t%u\n",
-			       session->counter);
-			printk(TAG " nb packets lost:\t%u\n",
-			       session->outorder);
-			printk(TAG " nb packets outorder:\t%u\n",
-			       session->error);
+		printk(TAG " jitter:\t\t\t");
+		print_number(session->jitter, TIME_US, TIME_US_UNIT);
+		printk("\n");
 
-			printk(TAG " jitter:\t\t\t");
-			print_number(session->jitter, TIME_US, TIME_US_UNIT);
-			printk("\n");
+		printk(TAG " rate:\t\t\t");
+		print_number(rate_in_kbps, KBPS, KBPS_UNIT);
+		printk("\n");
 
-			printk(TAG " rate:\t\t\t");
-			print_number(rate_in_kbps, KBPS, KBPS_UNIT);
-			printk("\n");
-		}
+		printk(TAG " packets/s:\t\t%u\n", pps);
+		printk(TAG " CPU load:\t\t%u %%\n", cpu_load);
 	} else {
 		net_nbuf_unref(buf);
 	}
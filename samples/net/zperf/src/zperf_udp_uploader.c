@@ -195,6 +195,7 @@ void zperf_udp_upload(struct net_context *context,
 	}
 
 	/* Start the loop */
+	zperf_cpu_start();
 	start_time = k_cycle_get_32();
 	last_print_time = start_time;
 	last_loop_time = start_time;
@@ -296,6 +297,7 @@ void zperf_udp_upload(struct net_context *context,
 	} while (time_delta(start_time, last_loop_time) < duration);
 
 	end_time = k_cycle_get_32();
+	results->cpu_load = zperf_cpu_stop();
 
 	zperf_upload_fin(context, nb_packets, end_time, packet_size, results);
 
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <soc.h>
+#include <section_tags.h>
 #include <arch/arm/cortex_m/cmsis.h>
 
 #include "util.h"
@@ -23,7 +24,7 @@
 
 static radio_isr_fp sfp_radio_isr;
 
-void isr_radio(void)
+__hot_text void isr_radio(void)
 {
 	if (sfp_radio_isr) {
 		sfp_radio_isr();
@@ -63,9 +64,26 @@ void radio_reset(void)
 
 void radio_phy_set(uint8_t phy)
 {
-	NRF_RADIO->MODE =
-	    (((phy) ? (uint32_t)phy : RADIO_MODE_MODE_Ble_1Mbit) <<
-	     RADIO_MODE_MODE_Pos) & RADIO_MODE_MODE_Msk;
+	uint32_t mode;
+
+	switch (phy) {
+	case BIT(0):
+	default:
+		mode = RADIO_MODE_MODE_Ble_1Mbit;
+		break;
+
+#if defined(CONFIG_SOC_SERIES_NRF52X)
+	case BIT(1):
+#if defined(RADIO_MODE_MODE_Ble_2Mbit)
+		mode = RADIO_MODE_MODE_Ble_2Mbit;
+#else
+		mode = RADIO_MODE_MODE_Nrf_2Mbit;
+#endif
+		break;
+#endif /* CONFIG_SOC_SERIES_NRF52X */
+	}
+
+	NRF_RADIO->MODE = (mode << RADIO_MODE_MODE_Pos) & RADIO_MODE_MODE_Msk;
 }
 
 void radio_tx_power_set(uint32_t power)
@@ -95,10 +113,10 @@ void radio_aa_set(uint8_t *aa)
 	NRF_RADIO->BASE0 = (aa[2] << 24) | (aa[1] << 16) | (aa[0] << 8);
 }
 
-void radio_pkt_configure(uint8_t preamble16, uint8_t bits_len, uint8_t max_len)
+void radio_pkt_configure(uint8_t phy, uint8_t bits_len, uint8_t max_len)
 {
 #if defined(CONFIG_SOC_SERIES_NRF51X)
-	ARG_UNUSED(preamble16);
+	ARG_UNUSED(phy);
 
 	if (bits_len == 8) {
 		bits_len = 5;
@@ -113,7 +131,7 @@ void radio_pkt_configure(uint8_t preamble16, uint8_t bits_len, uint8_t max_len)
 			     (((RADIO_PCNF0_S1INCL_Include) <<
 			       RADIO_PCNF0_S1INCL_Pos) &
 			       RADIO_PCNF0_S1INCL_Msk) |
-			     ((((preamble16) ? RADIO_PCNF0_PLEN_16bit :
+			     ((((phy & BIT(1)) ? RADIO_PCNF0_PLEN_16bit :
 			       RADIO_PCNF0_PLEN_8bit) << RADIO_PCNF0_PLEN_Pos) &
 			       RADIO_PCNF0_PLEN_Msk) |
 #endif
@@ -423,17 +441,29 @@ uint32_t radio_tmr_sample_get(void)
 
 static uint8_t MALIGN(4) _ccm_scratch[(RADIO_PDU_LEN_MAX - 4) + 16];
 
-void *radio_ccm_rx_pkt_set(struct ccm *ccm, void *pkt)
+void *radio_ccm_rx_pkt_set(struct ccm *ccm, uint8_t phy, void *pkt)
 {
+	uint32_t mode;
+
 	NRF_CCM->ENABLE = CCM_ENABLE_ENABLE_Disabled;
 	NRF_CCM->ENABLE = CCM_ENABLE_ENABLE_Enabled;
-	NRF_CCM->MODE =
+	mode = (CCM_MODE_MODE_Decryption << CCM_MODE_MODE_Pos) &
+	       CCM_MODE_MODE_Msk;
 #if !defined(CONFIG_SOC_SERIES_NRF51X)
-	    ((CCM_MODE_LENGTH_Extended << CCM_MODE_LENGTH_Pos) &
-	       CCM_MODE_LENGTH_Msk) |
-#endif
-	    ((CCM_MODE_MODE_Decryption << CCM_MODE_MODE_Pos) &
-	     CCM_MODE_MODE_Msk);
+	mode |= (CCM_MODE_LENGTH_Extended << CCM_MODE_LENGTH_Pos) &
+		CCM_MODE_LENGTH_Msk;
+
+	/* decrypt on-the-fly in synch with the PHY, not to be left behind
+	 * the radio at 2M.
+	 */
+	if (phy & BIT(1)) {
+		mode |= (CCM_MODE_DATARATE_2Mbit << CCM_MODE_DATARATE_Pos) &
+			CCM_MODE_DATARATE_Msk;
+	}
+#else /* CONFIG_SOC_SERIES_NRF51X */
+	ARG_UNUSED(phy);
+#endif /* CONFIG_SOC_SERIES_NRF51X */
+	NRF_CCM->MODE = mode;
 	NRF_CCM->CNFPTR = (uint32_t)ccm;
 	NRF_CCM->INPTR = (uint32_t)_pkt_scratch;
 	NRF_CCM->OUTPTR = (uint32_t)pkt;
@@ -31,12 +31,13 @@ void isr_radio(void);
 void radio_isr_set(radio_isr_fp fp_radio_isr);
 
 void radio_reset(void);
+/* phy is BIT(0) for LE 1M, BIT(1) for LE 2M, as in the LL PHY PDUs. */
 void radio_phy_set(uint8_t phy);
 void radio_tx_power_set(uint32_t power);
 void radio_freq_chnl_set(uint32_t chnl);
 void radio_whiten_iv_set(uint32_t iv);
 void radio_aa_set(uint8_t *aa);
-void radio_pkt_configure(uint8_t preamble16, uint8_t bits_len, uint8_t max_len);
+void radio_pkt_configure(uint8_t phy, uint8_t bits_len, uint8_t max_len);
 void radio_pkt_rx_set(void *rx_packet);
 void radio_pkt_tx_set(void *tx_packet);
 void radio_rx_enable(void);
@@ -87,7 +88,7 @@ uint32_t radio_tmr_end_get(void);
 void radio_tmr_sample(void);
 uint32_t radio_tmr_sample_get(void);
 
-void *radio_ccm_rx_pkt_set(struct ccm *ccm, void *pkt);
+void *radio_ccm_rx_pkt_set(struct ccm *ccm, uint8_t phy, void *pkt);
 void *radio_ccm_tx_pkt_set(struct ccm *ccm, void *pkt);
 uint32_t radio_ccm_is_done(void);
 uint32_t radio_ccm_mic_is_valid(void);
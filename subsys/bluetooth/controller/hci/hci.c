@@ -116,7 +116,7 @@ static void read_remote_ver_info(struct net_buf *buf, struct net_buf **evt)
 	*evt = cmd_status((!status) ? 0x00 : BT_HCI_ERR_CMD_DISALLOWED);
 }
 
-static int link_control_cmd_handle(uint8_t ocf, struct net_buf *cmd,
+static int link_control_cmd_handle(uint16_t ocf, struct net_buf *cmd,
 				   struct net_buf **evt)
 {
 	switch (ocf) {
@@ -153,7 +153,7 @@ static void reset(struct net_buf *buf, struct net_buf **evt)
 	ccst->status = 0x00;
 }
 
-static int ctrl_bb_cmd_handle(uint8_t ocf, struct net_buf *cmd,
+static int ctrl_bb_cmd_handle(uint16_t ocf, struct net_buf *cmd,
 			      struct net_buf **evt)
 {
 	switch (ocf) {
@@ -233,6 +233,11 @@ static void read_supported_commands(struct net_buf *buf, struct net_buf **evt)
 	/* LE Read Maximum Data Length. */
 	rp->commands[35] = (1 << 3);
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	/* LE Read PHY, LE Set Default PHY and LE Set PHY. */
+	rp->commands[35] |= (1 << 4) | (1 << 5) | (1 << 6);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 }
 
 static void read_local_features(struct net_buf *buf, struct net_buf **evt)
@@ -257,7 +262,7 @@ static void read_bd_addr(struct net_buf *buf, struct net_buf **evt)
 	ll_address_get(0, &rp->bdaddr.val[0]);
 }
 
-static int info_cmd_handle(uint8_t ocf, struct net_buf *cmd,
+static int info_cmd_handle(uint16_t ocf, struct net_buf *cmd,
 			   struct net_buf **evt)
 {
 	switch (ocf) {
@@ -315,7 +320,8 @@ static void le_read_local_features(struct net_buf *buf, struct net_buf **evt)
 	rp->status = 0x00;
 
 	memset(&rp->features[0], 0x00, sizeof(rp->features));
-	rp->features[0] = RADIO_BLE_FEATURES;
+	rp->features[0] = RADIO_BLE_FEATURES & 0xFF;
+	rp->features[1] = (RADIO_BLE_FEATURES >> 8) & 0xFF;
 }
 
 static void le_set_random_address(struct net_buf *buf, struct net_buf **evt)
@@ -725,7 +731,82 @@ static void le_read_max_data_len(struct net_buf *buf, struct net_buf **evt)
 }
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
-static int controller_cmd_handle(uint8_t ocf, struct net_buf *cmd,
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static void le_read_phy(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_le_read_phy *cmd = (void *)buf->data;
+	struct bt_hci_rp_le_read_phy *rp;
+	uint8_t tx = 0;
+	uint8_t rx = 0;
+	uint32_t status;
+	uint16_t handle;
+
+	handle = sys_le16_to_cpu(cmd->handle);
+	status = radio_phy_get(handle, &tx, &rx);
+
+	rp = cmd_complete(evt, sizeof(*rp));
+
+	rp->status = (!status) ? 0x00 : BT_HCI_ERR_UNKNOWN_CONN_ID;
+	rp->handle = sys_cpu_to_le16(handle);
+	/* the LL phy bits to the HCI phy values */
+	rp->tx_phy = find_lsb_set(tx);
+	rp->rx_phy = find_lsb_set(rx);
+}
+
+static void le_set_default_phy(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_le_set_default_phy *cmd = (void *)buf->data;
+	struct bt_hci_evt_cc_status *ccst;
+	uint8_t tx;
+	uint8_t rx;
+
+	/* no preference is any phy */
+	tx = (cmd->all_phys & BT_HCI_LE_PHY_TX_ANY) ? 0x03 :
+	     (cmd->tx_phys & 0x03);
+	rx = (cmd->all_phys & BT_HCI_LE_PHY_RX_ANY) ? 0x03 :
+	     (cmd->rx_phys & 0x03);
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+
+	if (!tx || !rx) {
+		ccst->status = BT_HCI_ERR_UNSUPP_FEATURE_PARAMS_VAL;
+
+		return;
+	}
+
+	radio_phy_default_set(tx, rx);
+
+	ccst->status = 0x00;
+}
+
+static void le_set_phy(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_le_set_phy *cmd = (void *)buf->data;
+	uint32_t status;
+	uint16_t handle;
+	uint8_t tx;
+	uint8_t rx;
+
+	handle = sys_le16_to_cpu(cmd->handle);
+
+	tx = (cmd->all_phys & BT_HCI_LE_PHY_TX_ANY) ? 0x03 :
+	     (cmd->tx_phys & 0x03);
+	rx = (cmd->all_phys & BT_HCI_LE_PHY_RX_ANY) ? 0x03 :
+	     (cmd->rx_phys & 0x03);
+
+	if (!tx || !rx) {
+		*evt = cmd_status(BT_HCI_ERR_UNSUPP_FEATURE_PARAMS_VAL);
+
+		return;
+	}
+
+	status = radio_phy_req_send(handle, tx, rx);
+
+	*evt = cmd_status((!status) ? 0x00 : BT_HCI_ERR_CMD_DISALLOWED);
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+static int controller_cmd_handle(uint16_t ocf, struct net_buf *cmd,
 				 struct net_buf **evt)
 {
 	switch (ocf) {
@@ -859,6 +940,156 @@ static int controller_cmd_handle(uint8_t ocf, struct net_buf *cmd,
 		break;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	case BT_OCF(BT_HCI_OP_LE_READ_PHY):
+		le_read_phy(cmd, evt);
+		break;
+
+	case BT_OCF(BT_HCI_OP_LE_SET_DEFAULT_PHY):
+		le_set_default_phy(cmd, evt);
+		break;
+
+	case BT_OCF(BT_HCI_OP_LE_SET_PHY):
+		le_set_phy(cmd, evt);
+		break;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+#if (UTIL_HIST_BINS != BT_HCI_VS_PROFILE_BINS)
+#error "Profile histogram bins differ from the HCI ones"
+#endif
+
+static void vs_read_profile_hist(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_vs_read_profile_hist *cmd = (void *)buf->data;
+	struct bt_hci_rp_vs_read_profile_hist *rp;
+	struct radio_profile profile;
+	uint32_t status;
+	uint8_t i;
+
+	/* the HCI types are the radio profile ones */
+	status = radio_profile_get(cmd->type, &profile);
+
+	rp = cmd_complete(evt, sizeof(*rp));
+	memset(rp, 0x00, sizeof(*rp));
+
+	rp->type = cmd->type;
+	if (status) {
+		rp->status = BT_HCI_ERR_INVALID_PARAMS;
+
+		return;
+	}
+
+	rp->status = 0x00;
+	rp->latency_max = sys_cpu_to_le16(profile.latency.max);
+	rp->duration_max = sys_cpu_to_le16(profile.duration.max);
+	for (i = 0; i < BT_HCI_VS_PROFILE_BINS; i++) {
+		rp->latency[i] = sys_cpu_to_le16(profile.latency.bin[i]);
+		rp->duration[i] = sys_cpu_to_le16(profile.duration.bin[i]);
+	}
+}
+
+static void vs_clear_profile_hist(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_evt_cc_status *ccst;
+
+	radio_profile_clear();
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+	ccst->status = 0x00;
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
+#if (RADIO_ADV_SETS > 0)
+static void vs_set_adv_set_param(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_vs_set_adv_set_param *cmd = (void *)buf->data;
+	struct bt_hci_evt_cc_status *ccst;
+	uint16_t interval;
+	uint32_t status;
+
+	interval = sys_le16_to_cpu(cmd->interval);
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+
+	/* non-connectable interval range, at least one channel */
+	if ((interval < 0x00A0) || (interval > 0x4000) ||
+	    !(cmd->channel_map & 0x07)) {
+		ccst->status = BT_HCI_ERR_INVALID_PARAMS;
+
+		return;
+	}
+
+	status = ll_adv_set_params_set(cmd->handle, interval,
+				       cmd->own_addr_type,
+				       cmd->channel_map & 0x07);
+
+	ccst->status = (!status) ? 0x00 : BT_HCI_ERR_INVALID_PARAMS;
+}
+
+static void vs_set_adv_set_data(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_vs_set_adv_set_data *cmd = (void *)buf->data;
+	struct bt_hci_evt_cc_status *ccst;
+	uint32_t status = 1;
+
+	if (cmd->len <= sizeof(cmd->data)) {
+		status = ll_adv_set_data_set(cmd->handle, cmd->len,
+					     &cmd->data[0]);
+	}
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+	ccst->status = (!status) ? 0x00 : BT_HCI_ERR_INVALID_PARAMS;
+}
+
+static void vs_set_adv_set_enable(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_vs_set_adv_set_enable *cmd = (void *)buf->data;
+	struct bt_hci_evt_cc_status *ccst;
+	uint32_t status;
+
+	status = ll_adv_set_enable(cmd->handle, cmd->enable);
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+	ccst->status = (!status) ? 0x00 : BT_HCI_ERR_CMD_DISALLOWED;
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
+static int vendor_cmd_handle(uint16_t ocf, struct net_buf *cmd,
+			     struct net_buf **evt)
+{
+	switch (ocf) {
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	case BT_OCF(BT_HCI_OP_VS_READ_PROFILE_HIST):
+		vs_read_profile_hist(cmd, evt);
+		break;
+
+	case BT_OCF(BT_HCI_OP_VS_CLEAR_PROFILE_HIST):
+		vs_clear_profile_hist(cmd, evt);
+		break;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
+#if (RADIO_ADV_SETS > 0)
+	case BT_OCF(BT_HCI_OP_VS_SET_ADV_SET_PARAM):
+		vs_set_adv_set_param(cmd, evt);
+		break;
+
+	case BT_OCF(BT_HCI_OP_VS_SET_ADV_SET_DATA):
+		vs_set_adv_set_data(cmd, evt);
+		break;
+
+	case BT_OCF(BT_HCI_OP_VS_SET_ADV_SET_ENABLE):
+		vs_set_adv_set_enable(cmd, evt);
+		break;
+#endif /* RADIO_ADV_SETS > 0 */
+
 	default:
 		return -EINVAL;
 	}
@@ -871,7 +1102,7 @@ struct net_buf *hci_cmd_handle(struct net_buf *cmd)
 	struct bt_hci_evt_cc_status *ccst;
 	struct bt_hci_cmd_hdr *chdr;
 	struct net_buf *evt = NULL;
-	uint8_t ocf;
+	uint16_t ocf;
 	int err;
 
 	if (cmd->len < sizeof(*chdr)) {
@@ -906,7 +1137,7 @@ struct net_buf *hci_cmd_handle(struct net_buf *cmd)
 		err = controller_cmd_handle(ocf, cmd, &evt);
 		break;
 	case BT_OGF_VS:
-		err = -EINVAL;
+		err = vendor_cmd_handle(ocf, cmd, &evt);
 		break;
 	default:
 		err = -EINVAL;
@@ -1085,6 +1316,25 @@ static void auth_payload_timeout_exp(struct pdu_data *pdu_data, uint16_t handle,
 }
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static void le_phy_update_complete(struct pdu_data *pdu_data, uint16_t handle,
+				   struct net_buf *buf)
+{
+	struct bt_hci_evt_le_phy_update_complete *sep;
+	struct radio_le_phy_upd_cmplt *radio_le_phy_upd_cmplt;
+
+	radio_le_phy_upd_cmplt = (struct radio_le_phy_upd_cmplt *)
+					pdu_data->payload.lldata;
+
+	sep = meta_evt(buf, BT_HCI_EVT_LE_PHY_UPDATE_COMPLETE, sizeof(*sep));
+
+	sep->status = radio_le_phy_upd_cmplt->status;
+	sep->handle = sys_cpu_to_le16(handle);
+	sep->tx_phy = find_lsb_set(radio_le_phy_upd_cmplt->tx);
+	sep->rx_phy = find_lsb_set(radio_le_phy_upd_cmplt->rx);
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 static void encode_control(struct radio_pdu_node_rx *node_rx,
 			   struct pdu_data *pdu_data, struct net_buf *buf)
 {
@@ -1120,6 +1370,12 @@ static void encode_control(struct radio_pdu_node_rx *node_rx,
 		break;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	case NODE_RX_TYPE_PHY_UPDATE:
+		le_phy_update_complete(pdu_data, handle, buf);
+		break;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 #if defined(CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI)
 	case NODE_RX_TYPE_RSSI:
 		BT_INFO("handle: 0x%04x, rssi: -%d dB.", handle,
@@ -1312,7 +1568,6 @@ void hci_acl_encode(struct radio_pdu_node_rx *node_rx, struct net_buf *buf)
 	struct pdu_data *pdu_data;
 	uint16_t handle_flags;
 	uint16_t handle;
-	uint8_t *data;
 
 	pdu_data = (struct pdu_data *)node_rx->pdu_data;
 	handle = node_rx->hdr.handle;
@@ -1328,8 +1583,8 @@ void hci_acl_encode(struct radio_pdu_node_rx *node_rx, struct net_buf *buf)
 		}
 		acl->handle = sys_cpu_to_le16(handle_flags);
 		acl->len = sys_cpu_to_le16(pdu_data->len);
-		data = (void *)net_buf_add(buf, pdu_data->len);
-		memcpy(data, &pdu_data->payload.lldata[0], pdu_data->len);
+		net_buf_add_mem(buf, &pdu_data->payload.lldata[0],
+				pdu_data->len);
 		break;
 
 	default:
@@ -232,54 +232,70 @@ static void prio_recv_thread(void *p1, void *p2, void *p3)
 	}
 }
 
+static void recv_node(struct radio_pdu_node_rx *node_rx)
+{
+	struct pdu_data *pdu_data;
+	struct net_buf *buf;
+
+	pdu_data = (void *)node_rx->pdu_data;
+	/* Check if we need to generate an HCI event or ACL
+	 * data
+	 */
+	if (node_rx->hdr.type != NODE_RX_TYPE_DC_PDU ||
+	    pdu_data->ll_id == PDU_DATA_LLID_CTRL) {
+		/* generate a (non-priority) HCI event */
+		if (hci_evt_is_discardable(node_rx)) {
+			buf = bt_buf_get_rx(K_NO_WAIT);
+		} else {
+			buf = bt_buf_get_rx(K_FOREVER);
+		}
+
+		if (buf) {
+			bt_buf_set_type(buf, BT_BUF_EVT);
+			hci_evt_encode(node_rx, buf);
+		}
+	} else {
+		/* generate ACL data */
+		buf = bt_buf_get_rx(K_FOREVER);
+		bt_buf_set_type(buf, BT_BUF_ACL_IN);
+		hci_acl_encode(node_rx, buf);
+	}
+
+	/* the PDU is copied, give the node back to the controller before
+	 * the host processes the buffer.
+	 */
+	radio_rx_fc_set(node_rx->hdr.handle, 0);
+	node_rx->hdr.onion.next = 0;
+	radio_rx_mem_release(&node_rx);
+
+	if (buf) {
+		if (buf->len) {
+			BT_DBG("Packet in: type:%u len:%u",
+				bt_buf_get_type(buf), buf->len);
+			bt_recv(buf);
+		} else {
+			net_buf_unref(buf);
+		}
+	}
+}
+
 static void recv_thread(void *p1, void *p2, void *p3)
 {
 	while (1) {
 		struct radio_pdu_node_rx *node_rx;
-		struct pdu_data *pdu_data;
-		struct net_buf *buf;
 
 		BT_DBG("RX node get");
 		node_rx = k_fifo_get(&recv_fifo, K_FOREVER);
 		BT_DBG("RX node dequeued");
 
-		pdu_data = (void *)node_rx->pdu_data;
-		/* Check if we need to generate an HCI event or ACL
-		 * data
+		/* hand over the nodes already queued as a batch, yielding
+		 * only once the fifo is drained.
 		 */
-		if (node_rx->hdr.type != NODE_RX_TYPE_DC_PDU ||
-		    pdu_data->ll_id == PDU_DATA_LLID_CTRL) {
-			/* generate a (non-priority) HCI event */
-			if (hci_evt_is_discardable(node_rx)) {
-				buf = bt_buf_get_rx(K_NO_WAIT);
-			} else {
-				buf = bt_buf_get_rx(K_FOREVER);
-			}
-
-			if (buf) {
-				bt_buf_set_type(buf, BT_BUF_EVT);
-				hci_evt_encode(node_rx, buf);
-			}
-		} else {
-			/* generate ACL data */
-			buf = bt_buf_get_rx(K_FOREVER);
-			bt_buf_set_type(buf, BT_BUF_ACL_IN);
-			hci_acl_encode(node_rx, buf);
-		}
-
-		radio_rx_fc_set(node_rx->hdr.handle, 0);
-		node_rx->hdr.onion.next = 0;
-		radio_rx_mem_release(&node_rx);
+		do {
+			recv_node(node_rx);
 
-		if (buf) {
-			if (buf->len) {
-				BT_DBG("Packet in: type:%u len:%u",
-					bt_buf_get_type(buf), buf->len);
-				bt_recv(buf);
-			} else {
-				net_buf_unref(buf);
-			}
-		}
+			node_rx = k_fifo_get(&recv_fifo, K_NO_WAIT);
+		} while (node_rx);
 
 		k_yield();
 
@@ -14,6 +14,7 @@
 #include <clock_control.h>
 #include <bluetooth/hci.h>
 #include <misc/util.h>
+#include <misc/byteorder.h>
 
 #include "cpu.h"
 #include "rand.h"
@@ -38,6 +39,7 @@
 #include "debug.h"
 
 #define RADIO_PREAMBLE_TO_ADDRESS_US	40
+#define RADIO_PREAMBLE_TO_ADDRESS_2M_US	24
 #define RADIO_HCTO_US			(150 + 2 + 2 + \
 					 RADIO_PREAMBLE_TO_ADDRESS_US)
 #define RADIO_CONN_EVENTS(x, y)		((uint16_t)((x) / (y)))
@@ -60,8 +62,8 @@
 #define SCHED_ADVANCED		1
 #define SILENT_CONNECTION	0
 
-#define RADIO_PHY_ADV		0
-#define RADIO_PHY_CONN		0
+#define RADIO_PHY_ADV		BIT(0)
+#define RADIO_PHY_CONN		BIT(0)
 
 enum role {
 	ROLE_NONE,
@@ -69,6 +71,10 @@ enum role {
 	ROLE_OBS,
 	ROLE_SLAVE,
 	ROLE_MASTER,
+
+#if (RADIO_ADV_SETS > 0)
+	ROLE_ADV_SET,
+#endif /* RADIO_ADV_SETS > 0 */
 };
 
 enum state {
@@ -124,6 +130,20 @@ struct observer {
 	uint32_t win_offset_us;
 };
 
+#if (RADIO_ADV_SETS > 0)
+/* Non-connectable advertising set, advertised along with the advertiser on
+ * its own ticker
+ */
+struct adv_set {
+	struct shdr hdr;
+
+	uint8_t chl_map:3;
+	uint8_t chl_map_current:3;
+
+	struct radio_adv_data adv_data;
+};
+#endif /* RADIO_ADV_SETS > 0 */
+
 static struct {
 	struct device *hf_clock;
 
@@ -147,6 +167,10 @@ static struct {
 	struct advertiser advertiser;
 	struct observer observer;
 
+#if (RADIO_ADV_SETS > 0)
+	struct adv_set adv_set[RADIO_ADV_SETS];
+#endif /* RADIO_ADV_SETS > 0 */
+
 	void *conn_pool;
 	void *conn_free;
 	uint8_t connection_count;
@@ -165,6 +189,17 @@ static struct {
 	uint16_t default_tx_time;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	/* PHY preferences of new connections */
+	uint8_t default_phy_tx;
+	uint8_t default_phy_rx;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	/* radio ISR timings, by role */
+	struct radio_profile profile[RADIO_PROFILE_TICKER_JOB];
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 	/** @todo below members to be made role specific and quota managed for
 	 * Rx-es.
 	 */
@@ -230,6 +265,12 @@ static void event_adv(uint32_t ticks_at_expire, uint32_t remainder,
 		      uint16_t lazy, void *context);
 static void event_obs(uint32_t ticks_at_expire, uint32_t remainder,
 		      uint16_t lazy, void *context);
+
+#if (RADIO_ADV_SETS > 0)
+static void ticker_update_adv_set_assert(uint32_t status, void *params);
+static void adv_set_setup(struct adv_set *adv_set);
+#endif /* RADIO_ADV_SETS > 0 */
+
 static void event_slave_prepare(uint32_t ticks_at_expire,
 				uint32_t remainder, uint16_t lazy,
 				void *context);
@@ -292,6 +333,12 @@ static void length_resp_send(struct connection *conn,
 				uint16_t eff_tx_octets);
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static void phy_rsp_send(struct connection *conn);
+static void phy_upd_cmplt_enqueue(struct connection *conn, uint8_t status);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+static uint32_t conn_ticks_slot_get(struct connection *conn);
 static uint32_t role_disable(uint8_t ticker_id_primary,
 			     uint8_t ticker_id_stop);
 static void rx_fc_lock(uint16_t handle);
@@ -413,6 +460,9 @@ uint32_t radio_init(void *hf_clock, uint8_t sca, uint8_t connection_count_max,
 void ctrl_reset(void)
 {
 	uint16_t conn_handle;
+#if (RADIO_ADV_SETS > 0)
+	uint8_t adv_set_handle;
+#endif /* RADIO_ADV_SETS > 0 */
 
 	/* disable advertiser events */
 	role_disable(RADIO_TICKER_ID_ADV, RADIO_TICKER_ID_ADV_STOP);
@@ -420,6 +470,15 @@ void ctrl_reset(void)
 	/* disable oberver events */
 	role_disable(RADIO_TICKER_ID_OBS, RADIO_TICKER_ID_OBS_STOP);
 
+#if (RADIO_ADV_SETS > 0)
+	/* disable advertising set events */
+	for (adv_set_handle = 0; adv_set_handle < RADIO_ADV_SETS;
+	     adv_set_handle++) {
+		role_disable(RADIO_TICKER_ID_ADV_SET + adv_set_handle,
+			     TICKER_NULL);
+	}
+#endif /* RADIO_ADV_SETS > 0 */
+
 	/* disable connection events */
 	for (conn_handle = 0; conn_handle < _radio.connection_count;
 	     conn_handle++) {
@@ -501,6 +560,12 @@ static void common_init(void)
 	_radio.default_tx_time = RADIO_LL_LENGTH_TIME_RX_MIN;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	/* Initialize the PHY defaults, no preference */
+	_radio.default_phy_tx = BIT(0) | BIT(1);
+	_radio.default_phy_rx = BIT(0) | BIT(1);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	/* allocate the rx queue */
 	packet_rx_allocate(0xFF);
 }
@@ -1393,6 +1458,162 @@ static inline uint8_t isr_rx_conn_pkt_ctrl_dle(struct pdu_data *pdu_data_rx,
 }
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static inline uint8_t phy_select(uint8_t phys)
+{
+	/* prefer the faster PHY */
+	if (phys & BIT(1)) {
+		return BIT(1);
+	}
+
+	return phys & BIT(0);
+}
+
+static void phy_upd_cmplt_fill(struct connection *conn,
+			       struct radio_pdu_node_rx *radio_pdu_node_rx,
+			       uint8_t status)
+{
+	struct radio_le_phy_upd_cmplt *radio_le_phy_upd_cmplt;
+	struct pdu_data *pdu_data_rx;
+
+	radio_pdu_node_rx->hdr.type = NODE_RX_TYPE_PHY_UPDATE;
+
+	/* prepare phy update complete structure */
+	pdu_data_rx = (struct pdu_data *)radio_pdu_node_rx->pdu_data;
+	radio_le_phy_upd_cmplt =
+		(struct radio_le_phy_upd_cmplt *)&pdu_data_rx->payload;
+	radio_le_phy_upd_cmplt->status = status;
+	radio_le_phy_upd_cmplt->tx = conn->phy_tx;
+	radio_le_phy_upd_cmplt->rx = conn->phy_rx;
+}
+
+static inline void
+isr_rx_conn_pkt_ctrl_phy_sel(struct pdu_data_llctrl_phy_req_rsp *phys)
+{
+	struct connection *conn = _radio.conn_curr;
+	uint8_t tx;
+	uint8_t rx;
+
+	/* master selects among the PHYs both sides prefer */
+	tx = phy_select(conn->llcp_phy.tx & phys->rx_phys);
+	rx = phy_select(conn->llcp_phy.rx & phys->tx_phys);
+
+	/* zero is no change in the PHY_UPDATE_IND */
+	conn->llcp_phy.tx = (tx != conn->phy_tx) ? tx : 0;
+	conn->llcp_phy.rx = (rx != conn->phy_rx) ? rx : 0;
+
+	/* send the PHY_UPDATE_IND in the next prepare */
+	conn->llcp_phy.state = LLCP_PHY_STATE_UPD;
+}
+
+static inline void isr_rx_conn_pkt_ctrl_phy_req(struct pdu_data *pdu_data_rx)
+{
+	struct connection *conn = _radio.conn_curr;
+
+	/* master procedure already under way takes precedence */
+	if ((_radio.role == ROLE_MASTER) &&
+	    (conn->llcp_phy.ack != conn->llcp_phy.req) &&
+	    (conn->llcp_phy.state != LLCP_PHY_STATE_REQ)) {
+		reject_ind_ext_send(conn, PDU_DATA_LLCTRL_TYPE_PHY_REQ,
+				    0x23);
+
+		return;
+	}
+
+	/* peer initiated, negotiate with the connection preferences */
+	if (conn->llcp_phy.ack == conn->llcp_phy.req) {
+		conn->llcp_phy.ack--;
+		conn->llcp_phy.cmd = 0;
+		conn->llcp_phy.tx = conn->phy_pref_tx;
+		conn->llcp_phy.rx = conn->phy_pref_rx;
+	}
+
+	if (_radio.role == ROLE_MASTER) {
+		isr_rx_conn_pkt_ctrl_phy_sel(
+			&pdu_data_rx->payload.llctrl.ctrldata.phy_req);
+	} else {
+		/* a local request not sent yet is completed by the master's
+		 * PHY_UPDATE_IND too.
+		 */
+		conn->llcp_phy.state = LLCP_PHY_STATE_RSP_WAIT;
+
+		phy_rsp_send(conn);
+	}
+
+	/* Start Procedure Timeout (@todo this shall not replace
+	 * terminate procedure).
+	 */
+	conn->procedure_expire = conn->procedure_reload;
+}
+
+static inline uint32_t
+isr_rx_conn_pkt_ctrl_phy_upd(struct radio_pdu_node_rx *radio_pdu_node_rx,
+			     uint8_t *rx_enqueue)
+{
+	struct pdu_data_llctrl_phy_update_ind *ind;
+	struct connection *conn = _radio.conn_curr;
+	struct pdu_data *pdu_data_rx;
+	uint8_t cmd;
+
+	pdu_data_rx = (struct pdu_data *)radio_pdu_node_rx->pdu_data;
+	ind = &pdu_data_rx->payload.llctrl.ctrldata.phy_update_ind;
+
+	/* local procedure, if any, completes with the master's */
+	cmd = ((conn->llcp_phy.ack != conn->llcp_phy.req) &&
+	       conn->llcp_phy.cmd);
+	conn->llcp_phy.ack = conn->llcp_phy.req;
+
+	if (!ind->m_to_s_phy && !ind->s_to_m_phy) {
+		/* Procedure complete, no instant */
+		conn->procedure_expire = 0;
+
+		if (cmd) {
+			phy_upd_cmplt_fill(conn, radio_pdu_node_rx, 0x00);
+			*rx_enqueue = 1;
+		}
+
+		return 0;
+	}
+
+	if (((ind->instant - conn->event_counter) & 0xffff) > 0x7fff) {
+		return 1;
+	}
+
+	LL_ASSERT(conn->llcp_req == conn->llcp_ack);
+
+	conn->llcp.phy_update.initiate = 0;
+	conn->llcp.phy_update.cmd = cmd;
+	conn->llcp.phy_update.tx = ind->s_to_m_phy;
+	conn->llcp.phy_update.rx = ind->m_to_s_phy;
+	conn->llcp.phy_update.instant = ind->instant;
+
+	conn->llcp_type = LLCP_PHY_UPDATE;
+	conn->llcp_ack--;
+
+	return 0;
+}
+
+static inline void
+isr_rx_conn_pkt_ctrl_phy_rej(struct radio_pdu_node_rx *radio_pdu_node_rx,
+			     uint8_t status, uint8_t *rx_enqueue)
+{
+	struct connection *conn = _radio.conn_curr;
+
+	if (conn->llcp_phy.ack == conn->llcp_phy.req) {
+		return;
+	}
+
+	/* Procedure complete */
+	conn->llcp_phy.ack = conn->llcp_phy.req;
+	conn->procedure_expire = 0;
+
+	if (conn->llcp_phy.cmd) {
+		phy_upd_cmplt_fill(conn, radio_pdu_node_rx, status);
+		*rx_enqueue = 1;
+	}
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 static inline uint8_t
 isr_rx_conn_pkt_ctrl(struct radio_pdu_node_rx *radio_pdu_node_rx,
 		     uint8_t *rx_enqueue)
@@ -1528,16 +1749,16 @@ isr_rx_conn_pkt_ctrl(struct radio_pdu_node_rx *radio_pdu_node_rx,
 	case PDU_DATA_LLCTRL_TYPE_FEATURE_REQ:
 	case PDU_DATA_LLCTRL_TYPE_SLAVE_FEATURE_REQ:
 		/* AND the feature set to get Feature USED */
-		_radio.conn_curr->llcp_features &=
-			pdu_data_rx->payload.llctrl.ctrldata.feature_req.features[0];
+		_radio.conn_curr->llcp_features &= sys_get_le16(&pdu_data_rx->
+			payload.llctrl.ctrldata.feature_req.features[0]);
 
 		feature_rsp_send(_radio.conn_curr);
 		break;
 
 	case PDU_DATA_LLCTRL_TYPE_FEATURE_RSP:
 		/* AND the feature set to get Feature USED */
-		_radio.conn_curr->llcp_features &=
-			pdu_data_rx->payload.llctrl.ctrldata.feature_rsp.features[0];
+		_radio.conn_curr->llcp_features &= sys_get_le16(&pdu_data_rx->
+			payload.llctrl.ctrldata.feature_rsp.features[0]);
 
 		/* enqueue the feature resp */
 		*rx_enqueue = 1;
@@ -1738,6 +1959,27 @@ isr_rx_conn_pkt_ctrl(struct radio_pdu_node_rx *radio_pdu_node_rx,
 		break;
 
 	case PDU_DATA_LLCTRL_TYPE_REJECT_IND_EXT:
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		if (pdu_data_rx->payload.llctrl.ctrldata.reject_ind_ext.
+		    reject_opcode == PDU_DATA_LLCTRL_TYPE_PHY_REQ) {
+			uint8_t error_code;
+
+			error_code = pdu_data_rx->payload.llctrl.ctrldata.
+				     reject_ind_ext.error_code;
+
+			/* on a collision, the master's procedure completes
+			 * the slave's.
+			 */
+			if ((_radio.role == ROLE_MASTER) ||
+			    (error_code != 0x23)) {
+				isr_rx_conn_pkt_ctrl_phy_rej(radio_pdu_node_rx,
+							     error_code,
+							     rx_enqueue);
+			}
+			break;
+		}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 		if (_radio.conn_curr->llcp_req != _radio.conn_curr->llcp_ack) {
 			isr_rx_conn_pkt_ctrl_rej(radio_pdu_node_rx, rx_enqueue);
 
@@ -1761,6 +2003,16 @@ isr_rx_conn_pkt_ctrl(struct radio_pdu_node_rx *radio_pdu_node_rx,
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
 	case PDU_DATA_LLCTRL_TYPE_UNKNOWN_RSP:
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		if (pdu_data_rx->payload.llctrl.ctrldata.unknown_rsp.type ==
+		    PDU_DATA_LLCTRL_TYPE_PHY_REQ) {
+			/* Unsupported Remote Feature */
+			isr_rx_conn_pkt_ctrl_phy_rej(radio_pdu_node_rx, 0x1a,
+						     rx_enqueue);
+			break;
+		}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 		if (_radio.conn_curr->llcp_req != _radio.conn_curr->llcp_ack) {
 			/* reset ctrl procedure */
 			_radio.conn_curr->llcp_ack = _radio.conn_curr->llcp_req;
@@ -1821,6 +2073,32 @@ isr_rx_conn_pkt_ctrl(struct radio_pdu_node_rx *radio_pdu_node_rx,
 		break;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	case PDU_DATA_LLCTRL_TYPE_PHY_REQ:
+		isr_rx_conn_pkt_ctrl_phy_req(pdu_data_rx);
+		break;
+
+	case PDU_DATA_LLCTRL_TYPE_PHY_RSP:
+		if ((_radio.role == ROLE_MASTER) &&
+		    (_radio.conn_curr->llcp_phy.ack !=
+		     _radio.conn_curr->llcp_phy.req) &&
+		    (_radio.conn_curr->llcp_phy.state ==
+		     LLCP_PHY_STATE_RSP_WAIT)) {
+			isr_rx_conn_pkt_ctrl_phy_sel(
+				&pdu_data_rx->payload.llctrl.ctrldata.phy_rsp);
+		}
+		break;
+
+	case PDU_DATA_LLCTRL_TYPE_PHY_UPDATE_IND:
+		if ((_radio.role == ROLE_SLAVE) &&
+		    isr_rx_conn_pkt_ctrl_phy_upd(radio_pdu_node_rx,
+						 rx_enqueue)) {
+			/* Instant Passed */
+			_radio.conn_curr->llcp_terminate.reason_peer = 0x28;
+		}
+		break;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	default:
 		unknown_rsp_send(_radio.conn_curr,
 				 pdu_data_rx->payload.llctrl.opcode);
@@ -2337,6 +2615,51 @@ static inline uint32_t isr_close_adv(void)
 	return dont_close;
 }
 
+#if (RADIO_ADV_SETS > 0)
+static inline uint32_t isr_close_adv_set(void)
+{
+	uint8_t ticker_id = _radio.ticker_id_event;
+	struct adv_set *adv_set;
+	uint32_t dont_close = 0;
+
+	adv_set = &_radio.adv_set[ticker_id - RADIO_TICKER_ID_ADV_SET];
+	if (_radio.state != STATE_CLOSE) {
+		return 0;
+	}
+
+	if (adv_set->chl_map_current != 0) {
+		dont_close = 1;
+
+		/* nothing to receive, the next channel right away */
+		adv_set_setup(adv_set);
+
+		radio_tx_enable();
+
+		radio_tmr_end_capture();
+	} else {
+		uint32_t ticker_status;
+		uint8_t random_delay;
+
+		/** @todo use random 0-10 */
+		random_delay = 10;
+
+		/* Fails if the set is being stopped, as for the advertiser */
+		ticker_status =
+			ticker_update(RADIO_TICKER_INSTANCE_ID_RADIO,
+				      RADIO_TICKER_USER_ID_WORKER, ticker_id,
+				      TICKER_US_TO_TICKS(random_delay * 1000),
+				      0, 0, 0, 0, 0,
+				      ticker_update_adv_set_assert,
+				      (void *)(uint32_t)ticker_id);
+		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
+			  (ticker_status == TICKER_STATUS_BUSY) ||
+			  (_radio.ticker_id_stop == ticker_id));
+	}
+
+	return dont_close;
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 static inline uint32_t isr_close_obs(void)
 {
 	uint32_t dont_close = 0;
@@ -2378,6 +2701,9 @@ static inline void isr_close_conn(void)
 {
 	uint16_t ticks_drift_plus;
 	uint16_t ticks_drift_minus;
+	uint16_t ticks_slot_plus;
+	uint16_t ticks_slot_minus;
+	uint32_t ticks_slot;
 	uint16_t latency_event;
 	uint16_t elapsed_event;
 	uint16_t lazy;
@@ -2412,6 +2738,18 @@ static inline void isr_close_conn(void)
 			uint32_t start_to_address_actual_us;
 			uint32_t start_to_address_expected_us;
 			uint32_t window_widening_event_us;
+			uint32_t preamble_to_address_us;
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+			if (_radio.conn_curr->phy_rx & BIT(1)) {
+				preamble_to_address_us =
+					RADIO_PREAMBLE_TO_ADDRESS_2M_US;
+			} else
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+			{
+				preamble_to_address_us =
+					RADIO_PREAMBLE_TO_ADDRESS_US;
+			}
 
 			/* calculate the drift in ticks */
 			start_to_address_actual_us = radio_tmr_aa_get();
@@ -2419,7 +2757,7 @@ static inline void isr_close_conn(void)
 				_radio.conn_curr->role.slave.window_widening_event_us;
 			start_to_address_expected_us =
 				(RADIO_TICKER_JITTER_US << 1) +
-				RADIO_PREAMBLE_TO_ADDRESS_US +
+				preamble_to_address_us +
 				window_widening_event_us;
 			if (start_to_address_actual_us <=
 			    start_to_address_expected_us) {
@@ -2433,7 +2771,7 @@ static inline void isr_close_conn(void)
 					TICKER_US_TO_TICKS(start_to_address_actual_us);
 				ticks_drift_minus =
 					TICKER_US_TO_TICKS((RADIO_TICKER_JITTER_US << 1) +
-							   RADIO_PREAMBLE_TO_ADDRESS_US);
+							   preamble_to_address_us);
 			}
 
 
@@ -2629,10 +2967,26 @@ static inline void isr_close_conn(void)
 	/* break latency based on ctrl procedure pending */
 	if ((_radio.conn_curr->llcp_ack != _radio.conn_curr->llcp_req) &&
 	    ((_radio.conn_curr->llcp_type == LLCP_CONNECTION_UPDATE) ||
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	     (_radio.conn_curr->llcp_type == LLCP_PHY_UPDATE) ||
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 	     (_radio.conn_curr->llcp_type == LLCP_CHANNEL_MAP))) {
 		_radio.conn_curr->latency_event = 0;
 	}
 
+	/* resize the slot to a changed PDU length or PHY */
+	ticks_slot_plus = 0;
+	ticks_slot_minus = 0;
+	ticks_slot = conn_ticks_slot_get(_radio.conn_curr);
+	if (ticks_slot > _radio.conn_curr->hdr.ticks_slot) {
+		ticks_slot_plus = ticks_slot -
+				  _radio.conn_curr->hdr.ticks_slot;
+	} else {
+		ticks_slot_minus = _radio.conn_curr->hdr.ticks_slot -
+				   ticks_slot;
+	}
+	_radio.conn_curr->hdr.ticks_slot = ticks_slot;
+
 	/* check if latency needs update */
 	lazy = 0;
 	if ((force) || (latency_event != _radio.conn_curr->latency_event)) {
@@ -2640,6 +2994,7 @@ static inline void isr_close_conn(void)
 	}
 
 	if ((ticks_drift_plus != 0) || (ticks_drift_minus != 0) ||
+	    (ticks_slot_plus != 0) || (ticks_slot_minus != 0) ||
 	    (lazy != 0) || (force != 0)) {
 		uint32_t ticker_status;
 		uint8_t ticker_id = RADIO_TICKER_ID_FIRST_CONNECTION +
@@ -2655,7 +3010,8 @@ static inline void isr_close_conn(void)
 			ticker_update(RADIO_TICKER_INSTANCE_ID_RADIO,
 				      RADIO_TICKER_USER_ID_WORKER,
 				      ticker_id,
-				      ticks_drift_plus, ticks_drift_minus, 0, 0,
+				      ticks_drift_plus, ticks_drift_minus,
+				      ticks_slot_plus, ticks_slot_minus,
 				      lazy, force, ticker_update_slave_assert,
 				      (void *)(uint32_t)ticker_id);
 		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
@@ -2677,6 +3033,12 @@ static inline void isr_radio_state_close(void)
 		dont_close = isr_close_obs();
 		break;
 
+#if (RADIO_ADV_SETS > 0)
+	case ROLE_ADV_SET:
+		dont_close = isr_close_adv_set();
+		break;
+#endif /* RADIO_ADV_SETS > 0 */
+
 	case ROLE_SLAVE:
 	case ROLE_MASTER:
 		isr_close_conn();
@@ -2721,7 +3083,30 @@ static inline void isr_radio_state_close(void)
 	DEBUG_RADIO_CLOSE(0);
 }
 
-static void isr(void)
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+static void isr_profile(enum role role, uint32_t sample)
+{
+	struct radio_profile *profile;
+
+#if (RADIO_ADV_SETS > 0)
+	/* the advertising sets are profiled along with the advertiser */
+	if (role == ROLE_ADV_SET) {
+		role = ROLE_ADV;
+	}
+#endif /* RADIO_ADV_SETS > 0 */
+
+	/* one histogram per role, in the role enum order */
+	profile = &_radio.profile[role - ROLE_ADV];
+
+	/* sample again for the ISR execution time */
+	radio_tmr_sample();
+
+	util_hist_add(&profile->latency, sample - radio_tmr_end_get());
+	util_hist_add(&profile->duration, radio_tmr_sample_get() - sample);
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
+static __hot_text void isr(void)
 {
 	uint8_t trx_done;
 	uint8_t crc_ok;
@@ -2729,6 +3114,11 @@ static void isr(void)
 	uint8_t irkmatch_ok;
 	uint8_t irkmatch_id;
 	uint8_t rssi_ready;
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	/* role of the event, it can change in the ISR */
+	enum role role = _radio.role;
+	uint32_t sample = 0;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
 
 	DEBUG_RADIO_ISR(1);
 
@@ -2736,12 +3126,18 @@ static void isr(void)
 	trx_done = radio_is_done();
 	if (trx_done) {
 
-#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_ISR)
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_ISR) || \
+	defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
 		/* sample the packet timer here, use it to calculate ISR latency
 		 * and generate the profiling event at the end of the ISR.
 		 */
 		radio_tmr_sample();
-#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_ISR */
+#endif
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+		/* kept, as the conn ISR profiling samples again */
+		sample = radio_tmr_sample_get();
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
 
 		crc_ok = radio_crc_is_valid();
 		devmatch_ok = radio_filter_has_match();
@@ -2787,6 +3183,12 @@ static void isr(void)
 		break;
 	}
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	if (trx_done && (role != ROLE_NONE)) {
+		isr_profile(role, sample);
+	}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 	DEBUG_RADIO_ISR(0);
 }
 
@@ -2861,6 +3263,16 @@ static void ticker_update_adv_assert(uint32_t status, void *params)
 		  (_radio.ticker_id_stop == RADIO_TICKER_ID_ADV));
 }
 
+#if (RADIO_ADV_SETS > 0)
+static void ticker_update_adv_set_assert(uint32_t status, void *params)
+{
+	uint8_t ticker_id = (uint32_t)params & 0xFF;
+
+	LL_ASSERT((status == TICKER_STATUS_SUCCESS) ||
+		  (_radio.ticker_id_stop == ticker_id));
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 static void ticker_update_slave_assert(uint32_t status, void *params)
 {
 	uint8_t ticker_id = (uint32_t)params & 0xFF;
@@ -3144,6 +3556,11 @@ static void mayfly_xtal_stop_calc(void *params)
 				hdr = &_radio.advertiser.hdr;
 			} else if (ticker_id == RADIO_TICKER_ID_OBS) {
 				hdr = &_radio.observer.hdr;
+#if (RADIO_ADV_SETS > 0)
+			} else if (ticker_id >= RADIO_TICKER_ID_ADV_SET) {
+				hdr = &_radio.adv_set[ticker_id -
+						      RADIO_TICKER_ID_ADV_SET].hdr;
+#endif /* RADIO_ADV_SETS > 0 */
 			} else {
 				LL_ASSERT(0);
 			}
@@ -3278,6 +3695,11 @@ static void mayfly_xtal_stop_calc(void *params)
 				hdr = &_radio.advertiser.hdr;
 			} else if (ticker_id == RADIO_TICKER_ID_OBS) {
 				hdr = &_radio.observer.hdr;
+#if (RADIO_ADV_SETS > 0)
+			} else if (ticker_id >= RADIO_TICKER_ID_ADV_SET) {
+				hdr = &_radio.adv_set[ticker_id -
+						      RADIO_TICKER_ID_ADV_SET].hdr;
+#endif /* RADIO_ADV_SETS > 0 */
 			} else {
 				LL_ASSERT(0);
 			}
@@ -3885,8 +4307,9 @@ static void event_common_prepare(uint32_t ticks_at_expire,
 #if XTAL_ADVANCED
 	{
 		static void *s_link[2];
+		/* housekeeping, not to delay the scheduling in the job */
 		static struct mayfly s_mfy_xtal_stop_calc = {0, 0, s_link, 0,
-			mayfly_xtal_stop_calc};
+			mayfly_xtal_stop_calc, MAYFLY_PRIO_LOW};
 		uint32_t retval;
 
 		s_mfy_xtal_stop_calc.param = (void *)(uint32_t)ticker_id;
@@ -4124,6 +4547,38 @@ static void adv_setup(void)
 	channel_set(37 + channel);
 }
 
+#if (RADIO_ADV_SETS > 0)
+static void adv_set_setup(struct adv_set *adv_set)
+{
+	uint8_t bitmap;
+	uint8_t channel;
+
+	/* Use latest adv packet */
+	if (adv_set->adv_data.first != adv_set->adv_data.last) {
+		uint8_t first;
+
+		first = adv_set->adv_data.first + 1;
+		if (first == DOUBLE_BUFFER_SIZE) {
+			first = 0;
+		}
+		adv_set->adv_data.first = first;
+	}
+
+	radio_pkt_tx_set(&adv_set->adv_data.data[adv_set->adv_data.first][0]);
+	radio_switch_complete_and_disable();
+
+	bitmap = adv_set->chl_map_current;
+	channel = 0;
+	while ((bitmap & 0x01) == 0) {
+		channel++;
+		bitmap >>= 1;
+	}
+	adv_set->chl_map_current &= (adv_set->chl_map_current - 1);
+
+	channel_set(37 + channel);
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 static void event_adv(uint32_t ticks_at_expire, uint32_t remainder,
 		      uint16_t lazy, void *context)
 {
@@ -4192,6 +4647,93 @@ static void event_adv(uint32_t ticks_at_expire, uint32_t remainder,
 	DEBUG_RADIO_START_A(0);
 }
 
+#if (RADIO_ADV_SETS > 0)
+static void event_adv_set(uint32_t ticks_at_expire, uint32_t remainder,
+			  uint16_t lazy, void *context)
+{
+	struct adv_set *adv_set = context;
+	uint8_t ticker_id;
+
+	ARG_UNUSED(remainder);
+	ARG_UNUSED(lazy);
+
+	DEBUG_RADIO_START_A(1);
+
+	ticker_id = RADIO_TICKER_ID_ADV_SET + (adv_set - &_radio.adv_set[0]);
+
+	LL_ASSERT(_radio.role == ROLE_NONE);
+	LL_ASSERT(_radio.ticker_id_prepare == ticker_id);
+
+	/* Tx only, the radio is disabled after each PDU and the next channel
+	 * is set up in the close state.
+	 */
+	_radio.role = ROLE_ADV_SET;
+	_radio.state = STATE_CLOSE;
+	_radio.ticker_id_prepare = 0;
+	_radio.ticker_id_event = ticker_id;
+	_radio.ticks_anchor = ticks_at_expire;
+
+	adv_obs_configure(RADIO_PHY_ADV);
+
+	adv_set->chl_map_current = adv_set->chl_map;
+	adv_set_setup(adv_set);
+
+	radio_tmr_start(1,
+			ticks_at_expire +
+			TICKER_US_TO_TICKS(RADIO_TICKER_START_PART_US),
+			_radio.remainder_anchor);
+	radio_tmr_end_capture();
+
+#if (XTAL_ADVANCED && (RADIO_TICKER_PREEMPT_PART_US \
+			<= RADIO_TICKER_PREEMPT_PART_MIN_US))
+	/* check if preempt to start has changed */
+	if (preempt_calc(&adv_set->hdr, ticker_id, ticks_at_expire) != 0) {
+		_radio.state = STATE_STOP;
+		radio_disable();
+	} else
+#endif
+
+	/* Ticker Job Silence */
+#if (RADIO_TICKER_USER_ID_WORKER_PRIO == RADIO_TICKER_USER_ID_JOB_PRIO)
+	{
+		uint32_t ticker_status;
+
+		ticker_status =
+		    ticker_job_idle_get(RADIO_TICKER_INSTANCE_ID_RADIO,
+					RADIO_TICKER_USER_ID_WORKER,
+					ticker_job_disable, 0);
+		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
+			  (ticker_status == TICKER_STATUS_BUSY));
+	}
+#endif
+
+	DEBUG_RADIO_START_A(0);
+}
+
+static void event_adv_set_prepare(uint32_t ticks_at_expire,
+				  uint32_t remainder, uint16_t lazy,
+				  void *context)
+{
+	struct adv_set *adv_set = context;
+	uint8_t ticker_id;
+
+	ARG_UNUSED(lazy);
+
+	DEBUG_RADIO_PREPARE_A(1);
+
+	ticker_id = RADIO_TICKER_ID_ADV_SET + (adv_set - &_radio.adv_set[0]);
+	_radio.ticker_id_prepare = ticker_id;
+
+	event_common_prepare(ticks_at_expire, remainder,
+			     &adv_set->hdr.ticks_xtal_to_start,
+			     &adv_set->hdr.ticks_active_to_start,
+			     adv_set->hdr.ticks_preempt_to_start,
+			     ticker_id, event_adv_set, adv_set);
+
+	DEBUG_RADIO_PREPARE_A(0);
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 void event_adv_stop(uint32_t ticks_at_expire, uint32_t remainder,
 		    uint16_t lazy, void *context)
 {
@@ -5110,8 +5652,8 @@ static inline void event_fex_prep(struct connection *conn)
 		       0x00,
 		       sizeof(pdu_ctrl_tx->payload.llctrl.ctrldata.feature_req.features));
 
-		pdu_ctrl_tx->payload.llctrl.ctrldata.feature_req.features[0] =
-			conn->llcp_features;
+		sys_put_le16(conn->llcp_features, &pdu_ctrl_tx->payload.llctrl.
+			     ctrldata.feature_req.features[0]);
 
 		ctrl_tx_enqueue(conn, node_tx);
 
@@ -5437,6 +5979,141 @@ static inline void event_len_prep(struct connection *conn)
 }
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static inline void event_phy_req_prep(struct connection *conn)
+{
+	switch (conn->llcp_phy.state) {
+	case LLCP_PHY_STATE_REQ:
+	{
+		struct pdu_data_llctrl_phy_req_rsp *pr;
+		struct radio_pdu_node_tx *node_tx;
+		struct pdu_data *pdu_ctrl_tx;
+
+		node_tx = mem_acquire(&_radio.pkt_tx_ctrl_free);
+		if (!node_tx) {
+			break;
+		}
+
+		/* wait for the rsp, or the update ind on the slave */
+		conn->llcp_phy.state = LLCP_PHY_STATE_RSP_WAIT;
+
+		/* place the phy req packet as next in tx queue */
+		pdu_ctrl_tx = (struct pdu_data *) node_tx->pdu_data;
+		pdu_ctrl_tx->ll_id = PDU_DATA_LLID_CTRL;
+		pdu_ctrl_tx->len = offsetof(struct pdu_data_llctrl, ctrldata) +
+			sizeof(struct pdu_data_llctrl_phy_req_rsp);
+		pdu_ctrl_tx->payload.llctrl.opcode =
+			PDU_DATA_LLCTRL_TYPE_PHY_REQ;
+
+		pr = &pdu_ctrl_tx->payload.llctrl.ctrldata.phy_req;
+		pr->tx_phys = conn->llcp_phy.tx;
+		pr->rx_phys = conn->llcp_phy.rx;
+
+		ctrl_tx_enqueue(conn, node_tx);
+
+		/* Start Procedure Timeout (@todo this shall not replace
+		 * terminate procedure).
+		 */
+		conn->procedure_expire = conn->procedure_reload;
+	}
+	break;
+
+	case LLCP_PHY_STATE_UPD:
+		/* the update ind has an instant, wait for the other
+		 * procedures with one.
+		 */
+		if (conn->llcp_req != conn->llcp_ack) {
+			break;
+		}
+
+		/* phy negotiated, the update ind is sent at the prepare */
+		conn->llcp_phy.ack = conn->llcp_phy.req;
+
+		conn->llcp.phy_update.initiate = 1;
+		conn->llcp.phy_update.cmd = conn->llcp_phy.cmd;
+		conn->llcp.phy_update.tx = conn->llcp_phy.tx;
+		conn->llcp.phy_update.rx = conn->llcp_phy.rx;
+
+		conn->llcp_type = LLCP_PHY_UPDATE;
+		conn->llcp_ack--;
+		break;
+
+	case LLCP_PHY_STATE_RSP_WAIT:
+		/* no nothing */
+		break;
+
+	default:
+		LL_ASSERT(0);
+		break;
+	}
+}
+
+static inline void event_phy_upd_ind_prep(struct connection *conn,
+					  uint16_t event_counter)
+{
+	if (conn->llcp.phy_update.initiate) {
+		struct pdu_data_llctrl_phy_update_ind *ind;
+		struct radio_pdu_node_tx *node_tx;
+		struct pdu_data *pdu_ctrl_tx;
+
+		node_tx = mem_acquire(&_radio.pkt_tx_ctrl_free);
+		if (!node_tx) {
+			return;
+		}
+
+		/* reset initiate flag */
+		conn->llcp.phy_update.initiate = 0;
+
+		/* place the phy update ind packet as next in tx queue */
+		pdu_ctrl_tx = (struct pdu_data *) node_tx->pdu_data;
+		pdu_ctrl_tx->ll_id = PDU_DATA_LLID_CTRL;
+		pdu_ctrl_tx->len = offsetof(struct pdu_data_llctrl, ctrldata) +
+			sizeof(struct pdu_data_llctrl_phy_update_ind);
+		pdu_ctrl_tx->payload.llctrl.opcode =
+			PDU_DATA_LLCTRL_TYPE_PHY_UPDATE_IND;
+
+		ind = &pdu_ctrl_tx->payload.llctrl.ctrldata.phy_update_ind;
+		ind->m_to_s_phy = conn->llcp.phy_update.tx;
+		ind->s_to_m_phy = conn->llcp.phy_update.rx;
+
+		if (!conn->llcp.phy_update.tx && !conn->llcp.phy_update.rx) {
+			/* no change, procedure complete without instant */
+			ind->instant = 0;
+
+			conn->llcp_ack = conn->llcp_req;
+			conn->procedure_expire = 0;
+
+			if (conn->llcp.phy_update.cmd) {
+				phy_upd_cmplt_enqueue(conn, 0x00);
+			}
+		} else {
+			/* set instant */
+			conn->llcp.phy_update.instant =
+				event_counter + conn->latency + 6;
+			ind->instant = conn->llcp.phy_update.instant;
+		}
+
+		ctrl_tx_enqueue(conn, node_tx);
+	} else if (((event_counter - conn->llcp.phy_update.instant) &
+		    0xFFFF) <= 0x7FFF) {
+		/* procedure request acked */
+		conn->llcp_ack = conn->llcp_req;
+		conn->procedure_expire = 0;
+
+		/* apply the new phys from this event on */
+		if (conn->llcp.phy_update.tx) {
+			conn->phy_tx = conn->llcp.phy_update.tx;
+		}
+		if (conn->llcp.phy_update.rx) {
+			conn->phy_rx = conn->llcp.phy_update.rx;
+		}
+
+		/* the host is told of a phy change, even if unrequested */
+		phy_upd_cmplt_enqueue(conn, 0x00);
+	}
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 static void event_connection_prepare(uint32_t ticks_at_expire,
 				     uint32_t remainder, uint16_t lazy,
 				     struct connection *conn)
@@ -5499,6 +6176,12 @@ static void event_connection_prepare(uint32_t ticks_at_expire,
 			break;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		case LLCP_PHY_UPDATE:
+			event_phy_upd_ind_prep(conn, event_counter);
+			break;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 		default:
 			LL_ASSERT(0);
 			break;
@@ -5554,6 +6237,19 @@ static void event_connection_prepare(uint32_t ticks_at_expire,
 	}
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	/* check if procedure is requested */
+	if (conn->llcp_phy.ack != conn->llcp_phy.req) {
+		/* Stop previous event, to avoid Radio DMA corrupting the
+		 * rx queue
+		 */
+		event_stop(0, 0, 0, (void *)STATE_ABORT);
+
+		/* handle PHY update state machine */
+		event_phy_req_prep(conn);
+	}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	/* Setup XTAL startup and radio active events */
 	event_common_prepare(ticks_at_expire, remainder,
 			     &conn->hdr.ticks_xtal_to_start,
@@ -5833,6 +6529,60 @@ static void event_master(uint32_t ticks_at_expire, uint32_t remainder,
 	DEBUG_RADIO_START_M(0);
 }
 
+static uint32_t pkt_time_us(uint16_t octets, uint8_t phy)
+{
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	/* 2 octets preamble, access address, header, MIC and CRC */
+	if (phy & BIT(1)) {
+		return (octets + 15) << 2;
+	}
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+	ARG_UNUSED(phy);
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+	/* 1 octet preamble, access address, header, MIC and CRC */
+	return (octets + 14) << 3;
+}
+
+/* Slot reserved for a connection event, wide enough for one exchange of the
+ * largest PDUs the connection currently uses, on its current PHYs.
+ */
+static uint32_t conn_ticks_slot_get(struct connection *conn)
+{
+	uint16_t max_tx_octets;
+	uint16_t max_rx_octets;
+	uint32_t ready_delay_us;
+	uint8_t phy_tx;
+	uint8_t phy_rx;
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH)
+	max_tx_octets = conn->max_tx_octets;
+	max_rx_octets = conn->max_rx_octets;
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
+	max_tx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
+	max_rx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	phy_tx = conn->phy_tx;
+	phy_rx = conn->phy_rx;
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+	phy_tx = RADIO_PHY_CONN;
+	phy_rx = RADIO_PHY_CONN;
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+	if (conn->role.master.role == 0) {
+		ready_delay_us = RADIO_TX_READY_DELAY_US;
+	} else {
+		ready_delay_us = RADIO_RX_READY_DELAY_US;
+	}
+
+	return TICKER_US_TO_TICKS(RADIO_TICKER_START_PART_US +
+				  ready_delay_us +
+				  pkt_time_us(max_tx_octets, phy_tx) +
+				  pkt_time_us(max_rx_octets, phy_rx) + 150);
+}
+
 static void rx_packet_set(struct connection *conn, struct pdu_data *pdu_data_rx)
 {
 	uint8_t phy;
@@ -5844,11 +6594,17 @@ static void rx_packet_set(struct connection *conn, struct pdu_data *pdu_data_rx)
 	max_rx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
 #endif /* !CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	phy = conn->phy_rx;
+	radio_phy_set(phy);
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 	phy = RADIO_PHY_CONN;
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	if (conn->enc_rx) {
 		radio_pkt_configure(phy, 8, (max_rx_octets + 4));
 
-		radio_pkt_rx_set(radio_ccm_rx_pkt_set(&conn->ccm_rx,
+		radio_pkt_rx_set(radio_ccm_rx_pkt_set(&conn->ccm_rx, phy,
 						      pdu_data_rx));
 	} else {
 		radio_pkt_configure(phy, 8, max_rx_octets);
@@ -5869,7 +6625,13 @@ static void tx_packet_set(struct connection *conn,
 	max_tx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
 #endif /* !CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	phy = conn->phy_tx;
+	radio_phy_set(phy);
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 	phy = RADIO_PHY_CONN;
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	if (conn->enc_tx) {
 		radio_pkt_configure(phy, 8, (max_tx_octets + 4));
 
@@ -6601,12 +7363,52 @@ static void feature_rsp_send(struct connection *conn)
 	memset(&pdu_ctrl_tx->payload.llctrl.ctrldata.feature_rsp.features[0],
 		0x00,
 		sizeof(pdu_ctrl_tx->payload.llctrl.ctrldata.feature_rsp.features));
-	pdu_ctrl_tx->payload.llctrl.ctrldata.feature_rsp.features[0] =
-		conn->llcp_features;
+	sys_put_le16(conn->llcp_features,
+		     &pdu_ctrl_tx->payload.llctrl.ctrldata.feature_rsp.
+		     features[0]);
 
 	ctrl_tx_enqueue(conn, node_tx);
 }
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+static void phy_rsp_send(struct connection *conn)
+{
+	struct pdu_data_llctrl_phy_req_rsp *pr;
+	struct radio_pdu_node_tx *node_tx;
+	struct pdu_data *pdu_ctrl_tx;
+
+	/* acquire tx mem */
+	node_tx = mem_acquire(&_radio.pkt_tx_ctrl_free);
+	LL_ASSERT(node_tx);
+
+	pdu_ctrl_tx = (struct pdu_data *)node_tx->pdu_data;
+	pdu_ctrl_tx->ll_id = PDU_DATA_LLID_CTRL;
+	pdu_ctrl_tx->len = offsetof(struct pdu_data_llctrl, ctrldata) +
+		sizeof(struct pdu_data_llctrl_phy_req_rsp);
+	pdu_ctrl_tx->payload.llctrl.opcode = PDU_DATA_LLCTRL_TYPE_PHY_RSP;
+
+	pr = &pdu_ctrl_tx->payload.llctrl.ctrldata.phy_rsp;
+	pr->tx_phys = conn->llcp_phy.tx;
+	pr->rx_phys = conn->llcp_phy.rx;
+
+	ctrl_tx_enqueue(conn, node_tx);
+}
+
+static void phy_upd_cmplt_enqueue(struct connection *conn, uint8_t status)
+{
+	struct radio_pdu_node_rx *radio_pdu_node_rx;
+
+	radio_pdu_node_rx = packet_rx_reserve_get(2);
+	LL_ASSERT(radio_pdu_node_rx);
+
+	radio_pdu_node_rx->hdr.handle = conn->handle;
+	phy_upd_cmplt_fill(conn, radio_pdu_node_rx, status);
+
+	/* enqueue phy update complete structure into rx queue */
+	packet_rx_enqueue();
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 static void pause_enc_rsp_send(struct connection *conn)
 {
 	struct radio_pdu_node_tx *node_tx;
@@ -6739,6 +7541,17 @@ struct radio_adv_data *radio_scan_data_get(void)
 	return &_radio.advertiser.scan_data;
 }
 
+#if (RADIO_ADV_SETS > 0)
+struct radio_adv_data *radio_adv_set_data_get(uint8_t handle)
+{
+	if (handle >= RADIO_ADV_SETS) {
+		return NULL;
+	}
+
+	return &_radio.adv_set[handle].adv_data;
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 void radio_filter_clear(void)
 {
 	_radio.filter_enable_bitmask = 0;
@@ -6997,6 +7810,18 @@ static uint32_t role_disable(uint8_t ticker_id_primary,
 				conn->hdr.ticks_xtal_to_start;
 			ticks_active_to_start =
 				conn->hdr.ticks_active_to_start;
+#if (RADIO_ADV_SETS > 0)
+		} else if (ticker_id_primary >= RADIO_TICKER_ID_ADV_SET) {
+			struct adv_set *adv_set;
+
+			adv_set = &_radio.adv_set[ticker_id_primary -
+						  RADIO_TICKER_ID_ADV_SET];
+
+			ticks_xtal_to_start =
+				adv_set->hdr.ticks_xtal_to_start;
+			ticks_active_to_start =
+				adv_set->hdr.ticks_active_to_start;
+#endif /* RADIO_ADV_SETS > 0 */
 		} else {
 			LL_ASSERT(0);
 		}
@@ -7093,6 +7918,13 @@ uint32_t radio_adv_enable(uint16_t interval, uint8_t chl_map,
 		conn->max_rx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		conn->phy_pref_tx = _radio.default_phy_tx;
+		conn->phy_pref_rx = _radio.default_phy_rx;
+		conn->phy_tx = BIT(0);
+		conn->phy_rx = BIT(0);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 		conn->role.slave.role = 1;
 		conn->role.slave.latency_cancel = 0;
 		conn->role.slave.window_widening_prepare_us = 0;
@@ -7120,6 +7952,11 @@ uint32_t radio_adv_enable(uint16_t interval, uint8_t chl_map,
 		conn->llcp_length.ack = 0;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		conn->llcp_phy.req = 0;
+		conn->llcp_phy.ack = 0;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 		conn->sn = 0;
 		conn->nesn = 0;
 		conn->pause_rx = 0;
@@ -7265,6 +8102,69 @@ uint32_t radio_adv_disable(void)
 	return status;
 }
 
+#if (RADIO_ADV_SETS > 0)
+uint32_t radio_adv_set_enable(uint8_t handle, uint16_t interval,
+			      uint8_t chl_map)
+{
+	uint32_t volatile ticker_status;
+	uint32_t ticks_slot_offset;
+	struct adv_set *adv_set;
+
+	if (handle >= RADIO_ADV_SETS) {
+		return 1;
+	}
+
+	adv_set = &_radio.adv_set[handle];
+	adv_set->chl_map = chl_map;
+
+	adv_set->hdr.ticks_active_to_start = _radio.ticks_active_to_start;
+	adv_set->hdr.ticks_xtal_to_start =
+		TICKER_US_TO_TICKS(RADIO_TICKER_XTAL_OFFSET_US);
+	adv_set->hdr.ticks_preempt_to_start =
+		TICKER_US_TO_TICKS(RADIO_TICKER_PREEMPT_PART_MIN_US);
+	adv_set->hdr.ticks_slot =
+		TICKER_US_TO_TICKS(RADIO_TICKER_START_PART_US +
+		/* Max. chain is ADV_NONCONN_IND on each channel */
+		((376 + 150) * 3));
+
+	ticks_slot_offset =
+		(adv_set->hdr.ticks_active_to_start <
+		 adv_set->hdr.ticks_xtal_to_start) ?
+		adv_set->hdr.ticks_xtal_to_start :
+		adv_set->hdr.ticks_active_to_start;
+
+	/* With the slot reserved, the ticker skips an event overlapping the
+	 * one of another set or role instead of both starting on air.
+	 */
+	ticker_status =
+		ticker_start(RADIO_TICKER_INSTANCE_ID_RADIO,
+			     RADIO_TICKER_USER_ID_APP,
+			     RADIO_TICKER_ID_ADV_SET + handle,
+			     ticker_ticks_now_get(), 0,
+			     TICKER_US_TO_TICKS((uint64_t) interval * 625),
+			     TICKER_NULL_REMAINDER, TICKER_NULL_LAZY,
+			     (ticks_slot_offset + adv_set->hdr.ticks_slot),
+			     event_adv_set_prepare, adv_set, ticker_if_done,
+			     (void *)&ticker_status);
+
+	/** @todo design to avoid this wait */
+	while (ticker_status == TICKER_STATUS_BUSY) {
+		cpu_sleep();
+	}
+
+	return (ticker_status == TICKER_STATUS_SUCCESS) ? 0 : 1;
+}
+
+uint32_t radio_adv_set_disable(uint8_t handle)
+{
+	if (handle >= RADIO_ADV_SETS) {
+		return 1;
+	}
+
+	return role_disable(RADIO_TICKER_ID_ADV_SET + handle, TICKER_NULL);
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 uint32_t radio_scan_enable(uint8_t scan_type, uint8_t init_addr_type,
 			   uint8_t *init_addr, uint16_t interval,
 			   uint16_t window, uint8_t filter_policy)
@@ -7429,6 +8329,13 @@ uint32_t radio_connect_enable(uint8_t adv_addr_type, uint8_t *adv_addr,
 	conn->max_rx_octets = RADIO_LL_LENGTH_OCTETS_RX_MIN;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	conn->phy_pref_tx = _radio.default_phy_tx;
+	conn->phy_pref_rx = _radio.default_phy_rx;
+	conn->phy_tx = BIT(0);
+	conn->phy_rx = BIT(0);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	conn->role.master.role = 0;
 	conn->role.master.connect_expire = 6;
 	conn_interval_us =
@@ -7470,6 +8377,11 @@ uint32_t radio_connect_enable(uint8_t adv_addr_type, uint8_t *adv_addr,
 	conn->llcp_length.ack = 0;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	conn->llcp_phy.req = 0;
+	conn->llcp_phy.ack = 0;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	conn->sn = 0;
 	conn->nesn = 0;
 	conn->pause_rx = 0;
@@ -7810,6 +8722,75 @@ void radio_length_max_get(uint16_t *max_tx_octets, uint16_t *max_tx_time,
 }
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+uint32_t radio_phy_get(uint16_t handle, uint8_t *tx, uint8_t *rx)
+{
+	struct connection *conn;
+
+	conn = connection_get(handle);
+	if (!conn) {
+		return 1;
+	}
+
+	*tx = conn->phy_tx;
+	*rx = conn->phy_rx;
+
+	return 0;
+}
+
+void radio_phy_default_set(uint8_t tx, uint8_t rx)
+{
+	_radio.default_phy_tx = tx;
+	_radio.default_phy_rx = rx;
+}
+
+uint32_t radio_phy_req_send(uint16_t handle, uint8_t tx, uint8_t rx)
+{
+	struct connection *conn;
+
+	conn = connection_get(handle);
+	if (!conn || (conn->llcp_phy.req != conn->llcp_phy.ack)) {
+		return 1;
+	}
+
+	conn->llcp_phy.state = LLCP_PHY_STATE_REQ;
+	conn->llcp_phy.cmd = 1;
+	conn->llcp_phy.tx = tx;
+	conn->llcp_phy.rx = rx;
+	conn->llcp_phy.req++;
+
+	return 0;
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+uint32_t radio_profile_get(uint8_t type, struct radio_profile *profile)
+{
+	if (type == RADIO_PROFILE_TICKER_JOB) {
+		memset(&profile->latency, 0, sizeof(profile->latency));
+		ticker_job_profile_get(RADIO_TICKER_INSTANCE_ID_RADIO,
+				       &profile->duration);
+
+		return 0;
+	}
+
+	if (type >= RADIO_PROFILE_COUNT) {
+		return 1;
+	}
+
+	/* NOTE: the ISR can update it while copied, this is a snapshot */
+	memcpy(profile, &_radio.profile[type], sizeof(*profile));
+
+	return 0;
+}
+
+void radio_profile_clear(void)
+{
+	memset(&_radio.profile[0], 0, sizeof(_radio.profile));
+	ticker_job_profile_clear(RADIO_TICKER_INSTANCE_ID_RADIO);
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 static uint8_t tx_cmplt_get(uint16_t *handle, uint8_t *first, uint8_t last)
 {
 	uint8_t _first;
@@ -7930,6 +8911,10 @@ void radio_rx_dequeue(void)
 	case NODE_RX_TYPE_APTO:
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	case NODE_RX_TYPE_PHY_UPDATE:
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 #if defined(CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI)
 	case NODE_RX_TYPE_RSSI:
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI */
@@ -7978,6 +8963,10 @@ void radio_rx_mem_release(struct radio_pdu_node_rx **radio_pdu_node_rx)
 		case NODE_RX_TYPE_APTO:
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		case NODE_RX_TYPE_PHY_UPDATE:
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 #if defined(CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI)
 		case NODE_RX_TYPE_RSSI:
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI */
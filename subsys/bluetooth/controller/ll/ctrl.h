@@ -17,6 +17,12 @@
 #define RADIO_CONNECTION_CONTEXT_MAX 0
 #endif
 
+#ifdef CONFIG_BLUETOOTH_CONTROLLER_ADV_SETS
+#define RADIO_ADV_SETS CONFIG_BLUETOOTH_CONTROLLER_ADV_SETS
+#else
+#define RADIO_ADV_SETS 0
+#endif
+
 #ifdef CONFIG_BLUETOOTH_CONTROLLER_RX_BUFFERS
 #define RADIO_PACKET_COUNT_RX_MAX \
 		CONFIG_BLUETOOTH_CONTROLLER_RX_BUFFERS
@@ -47,6 +53,12 @@
 #define RADIO_LL_LENGTH_OCTETS_RX_MAX 27
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH_MAX */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+#define RADIO_BLE_FEATURES_BIT_PHY_2M BIT(BT_LE_FEAT_BIT_PHY_2M)
+#else /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+#define RADIO_BLE_FEATURES_BIT_PHY_2M 0
+#endif /* !CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 /*****************************************************************************
  * Timer Resources (Controller defined)
  ****************************************************************************/
@@ -57,7 +69,9 @@
 #define RADIO_TICKER_ID_OBS_STOP	 4
 #define RADIO_TICKER_ID_ADV		 5
 #define RADIO_TICKER_ID_OBS		 6
-#define RADIO_TICKER_ID_FIRST_CONNECTION 7
+#define RADIO_TICKER_ID_ADV_SET		 7
+#define RADIO_TICKER_ID_FIRST_CONNECTION (RADIO_TICKER_ID_ADV_SET + \
+					  RADIO_ADV_SETS)
 
 #define RADIO_TICKER_INSTANCE_ID_RADIO	 0
 #define RADIO_TICKER_INSTANCE_ID_APP	 1
@@ -95,7 +109,8 @@
 					 BIT(BT_LE_FEAT_BIT_EXT_REJ_IND) | \
 					 BIT(BT_LE_FEAT_BIT_SLAVE_FEAT_REQ) | \
 					 RADIO_BLE_FEATURES_BIT_PING | \
-					 RADIO_BLE_FEATURES_BIT_DLE)
+					 RADIO_BLE_FEATURES_BIT_DLE | \
+					 RADIO_BLE_FEATURES_BIT_PHY_2M)
 
 /*****************************************************************************
  * Controller Reference Defines (compile time override-able)
@@ -184,6 +199,12 @@ struct radio_le_conn_update_cmplt {
 	uint16_t timeout;
 } __packed;
 
+struct radio_le_phy_upd_cmplt {
+	uint8_t status;
+	uint8_t tx;
+	uint8_t rx;
+} __packed;
+
 struct radio_pdu_node_tx {
 	void *next;
 	uint8_t pdu_data[1];
@@ -202,6 +223,10 @@ enum radio_pdu_node_rx_type {
 	NODE_RX_TYPE_APTO,
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	NODE_RX_TYPE_PHY_UPDATE,
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 #if defined(CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI)
 	NODE_RX_TYPE_RSSI,
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_CONN_RSSI */
@@ -227,6 +252,24 @@ struct radio_pdu_node_rx {
 	uint8_t pdu_data[1];
 };
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+enum radio_profile_type {
+	RADIO_PROFILE_ADV,
+	RADIO_PROFILE_OBS,
+	RADIO_PROFILE_SLAVE,
+	RADIO_PROFILE_MASTER,
+	RADIO_PROFILE_TICKER_JOB,
+	RADIO_PROFILE_COUNT,
+};
+
+struct radio_profile {
+	/* radio end to ISR entry, none for the ticker job */
+	struct util_hist latency;
+	/* ISR or ticker job execution */
+	struct util_hist duration;
+};
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 /*****************************************************************************
  * Controller Interface Functions
  ****************************************************************************/
@@ -247,6 +290,14 @@ uint32_t radio_irk_add(uint8_t *irk);
 uint32_t radio_adv_enable(uint16_t interval, uint8_t chl_map,
 		uint8_t filter_policy);
 uint32_t radio_adv_disable(void);
+
+#if (RADIO_ADV_SETS > 0)
+struct radio_adv_data *radio_adv_set_data_get(uint8_t handle);
+uint32_t radio_adv_set_enable(uint8_t handle, uint16_t interval,
+			      uint8_t chl_map);
+uint32_t radio_adv_set_disable(uint8_t handle);
+#endif /* RADIO_ADV_SETS > 0 */
+
 uint32_t radio_scan_enable(uint8_t scan_type, uint8_t init_addr_type,
 		uint8_t *init_addr, uint16_t interval,
 		uint16_t window, uint8_t filter_policy);
@@ -276,6 +327,17 @@ void radio_length_max_get(uint16_t *max_tx_octets, uint16_t *max_tx_time,
 			  uint16_t *max_rx_octets, uint16_t *max_rx_time);
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+uint32_t radio_phy_get(uint16_t handle, uint8_t *tx, uint8_t *rx);
+void radio_phy_default_set(uint8_t tx, uint8_t rx);
+uint32_t radio_phy_req_send(uint16_t handle, uint8_t tx, uint8_t rx);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+uint32_t radio_profile_get(uint8_t type, struct radio_profile *profile);
+void radio_profile_clear(void);
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 uint8_t radio_rx_get(struct radio_pdu_node_rx **radio_pdu_node_rx,
 		uint16_t *handle);
 void radio_rx_dequeue(void);
@@ -17,6 +17,10 @@ enum llcp {
 #if defined(CONFIG_BLUETOOTH_CONTROLLER_LE_PING)
 	LLCP_PING,
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_LE_PING */
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	LLCP_PHY_UPDATE,
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 };
 
 
@@ -127,9 +131,19 @@ struct connection {
 			uint8_t ltk[16];
 			uint8_t skd[16];
 		} encryption;
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+		struct {
+			uint8_t initiate:1;
+			uint8_t cmd:1;
+			uint8_t tx:2;
+			uint8_t rx:2;
+			uint16_t instant;
+		} phy_update;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
 	} llcp;
 
-	uint8_t llcp_features;
+	uint16_t llcp_features;
 
 	struct {
 		uint8_t tx:1;
@@ -164,6 +178,25 @@ struct connection {
 	} llcp_length;
 #endif /* CONFIG_BLUETOOTH_CONTROLLER_DATA_LENGTH */
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PHY_2M)
+	struct {
+		uint8_t req;
+		uint8_t ack;
+		uint8_t state:2;
+#define LLCP_PHY_STATE_REQ      0
+#define LLCP_PHY_STATE_RSP_WAIT 1
+#define LLCP_PHY_STATE_UPD      2
+		uint8_t tx:2;
+		uint8_t rx:2;
+		uint8_t cmd:1;
+	} llcp_phy;
+
+	uint8_t phy_pref_tx:2;
+	uint8_t phy_pref_rx:2;
+	uint8_t phy_tx:2;
+	uint8_t phy_rx:2;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PHY_2M */
+
 	uint8_t sn:1;
 	uint8_t nesn:1;
 	uint8_t pause_rx:1;
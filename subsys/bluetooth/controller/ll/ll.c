@@ -47,6 +47,15 @@ static struct {
 	uint8_t filter_policy:1;
 } _ll_scan_params;
 
+#if (RADIO_ADV_SETS > 0)
+static struct {
+	uint16_t interval;
+	uint8_t tx_addr:1;
+	uint8_t chl_map:3;
+	uint8_t adv_addr[BDADDR_SIZE];
+} _ll_adv_set_params[RADIO_ADV_SETS];
+#endif /* RADIO_ADV_SETS > 0 */
+
 void ll_address_get(uint8_t addr_type, uint8_t *bdaddr)
 {
 	if (addr_type) {
@@ -237,6 +246,104 @@ uint32_t ll_adv_enable(uint8_t enable)
 	return status;
 }
 
+#if (RADIO_ADV_SETS > 0)
+uint32_t ll_adv_set_params_set(uint8_t handle, uint16_t interval,
+			       uint8_t own_addr_type, uint8_t chl_map)
+{
+	struct radio_adv_data *radio_adv_data;
+	struct pdu_adv *pdu;
+
+	radio_adv_data = radio_adv_set_data_get(handle);
+	if (!radio_adv_data) {
+		return 1;
+	}
+
+	_ll_adv_set_params[handle].interval = interval;
+	_ll_adv_set_params[handle].chl_map = chl_map;
+	_ll_adv_set_params[handle].tx_addr = own_addr_type;
+
+	/* update the current adv data, sets are non-connectable */
+	pdu = (struct pdu_adv *)&radio_adv_data->data[radio_adv_data->last][0];
+	pdu->type = PDU_ADV_TYPE_NONCONN_IND;
+	pdu->tx_addr = own_addr_type;
+	pdu->rx_addr = 0;
+	if (pdu->len == 0) {
+		pdu->len = BDADDR_SIZE;
+	}
+
+	return 0;
+}
+
+uint32_t ll_adv_set_data_set(uint8_t handle, uint8_t len,
+			     uint8_t const *const data)
+{
+	struct radio_adv_data *radio_adv_data;
+	struct pdu_adv *pdu;
+	uint8_t last;
+
+	radio_adv_data = radio_adv_set_data_get(handle);
+	if (!radio_adv_data) {
+		return 1;
+	}
+
+	/* use the last index in double buffer, */
+	if (radio_adv_data->first == radio_adv_data->last) {
+		last = radio_adv_data->last + 1;
+		if (last == DOUBLE_BUFFER_SIZE) {
+			last = 0;
+		}
+	} else {
+		last = radio_adv_data->last;
+	}
+
+	/* update adv pdu fields. */
+	pdu = (struct pdu_adv *)&radio_adv_data->data[last][0];
+	pdu->type = PDU_ADV_TYPE_NONCONN_IND;
+	pdu->tx_addr = _ll_adv_set_params[handle].tx_addr;
+	pdu->rx_addr = 0;
+	memcpy(&pdu->payload.adv_ind.addr[0],
+	       &_ll_adv_set_params[handle].adv_addr[0], BDADDR_SIZE);
+	memcpy(&pdu->payload.adv_ind.data[0], data, len);
+	pdu->len = BDADDR_SIZE + len;
+
+	/* commit the update so controller picks it. */
+	radio_adv_data->last = last;
+
+	return 0;
+}
+
+uint32_t ll_adv_set_enable(uint8_t handle, uint8_t enable)
+{
+	struct radio_adv_data *radio_adv_data;
+	uint8_t const *adv_addr;
+	struct pdu_adv *pdu;
+
+	radio_adv_data = radio_adv_set_data_get(handle);
+	if (!radio_adv_data) {
+		return 1;
+	}
+
+	if (!enable) {
+		return radio_adv_set_disable(handle);
+	}
+
+	/* remember addr to use and also update the addr in the adv PDU */
+	if (_ll_adv_set_params[handle].tx_addr) {
+		adv_addr = &_ll_context.rnd_addr[0];
+	} else {
+		adv_addr = &_ll_context.pub_addr[0];
+	}
+
+	pdu = (struct pdu_adv *)&radio_adv_data->data[radio_adv_data->last][0];
+	memcpy(&_ll_adv_set_params[handle].adv_addr[0], adv_addr,
+	       BDADDR_SIZE);
+	memcpy(&pdu->payload.adv_ind.addr[0], adv_addr, BDADDR_SIZE);
+
+	return radio_adv_set_enable(handle, _ll_adv_set_params[handle].interval,
+				    _ll_adv_set_params[handle].chl_map);
+}
+#endif /* RADIO_ADV_SETS > 0 */
+
 void ll_scan_params_set(uint8_t scan_type, uint16_t interval, uint16_t window,
 			uint8_t own_addr_type, uint8_t filter_policy)
 {
@@ -17,6 +17,11 @@ void ll_adv_params_set(uint16_t interval, uint8_t adv_type,
 void ll_adv_data_set(uint8_t len, uint8_t const *const p_data);
 void ll_scan_data_set(uint8_t len, uint8_t const *const p_data);
 uint32_t ll_adv_enable(uint8_t enable);
+uint32_t ll_adv_set_params_set(uint8_t handle, uint16_t interval,
+			       uint8_t own_addr_type, uint8_t chl_map);
+uint32_t ll_adv_set_data_set(uint8_t handle, uint8_t len,
+			     uint8_t const *const p_data);
+uint32_t ll_adv_set_enable(uint8_t handle, uint8_t enable);
 void ll_scan_params_set(uint8_t scan_type, uint16_t interval, uint16_t window,
 			uint8_t own_addr_type, uint8_t filter_policy);
 uint32_t ll_scan_enable(uint8_t enable);
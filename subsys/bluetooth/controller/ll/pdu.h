@@ -104,6 +104,9 @@ enum pdu_data_llctrl_type {
 	PDU_DATA_LLCTRL_TYPE_PING_RSP = 0x13,
 	PDU_DATA_LLCTRL_TYPE_LENGTH_REQ = 0x14,
 	PDU_DATA_LLCTRL_TYPE_LENGTH_RSP = 0x15,
+	PDU_DATA_LLCTRL_TYPE_PHY_REQ = 0x16,
+	PDU_DATA_LLCTRL_TYPE_PHY_RSP = 0x17,
+	PDU_DATA_LLCTRL_TYPE_PHY_UPDATE_IND = 0x18,
 };
 
 struct pdu_data_llctrl_conn_update_req {
@@ -200,6 +203,17 @@ struct pdu_data_llctrl_length_req_rsp {
 	uint16_t max_tx_time;
 } __packed;
 
+struct pdu_data_llctrl_phy_req_rsp {
+	uint8_t tx_phys;
+	uint8_t rx_phys;
+} __packed;
+
+struct pdu_data_llctrl_phy_update_ind {
+	uint8_t m_to_s_phy;
+	uint8_t s_to_m_phy;
+	uint16_t instant;
+} __packed;
+
 struct pdu_data_llctrl {
 	uint8_t opcode;
 	union {
@@ -219,6 +233,9 @@ struct pdu_data_llctrl {
 		struct pdu_data_llctrl_reject_ind_ext reject_ind_ext;
 		struct pdu_data_llctrl_length_req_rsp length_req;
 		struct pdu_data_llctrl_length_req_rsp length_rsp;
+		struct pdu_data_llctrl_phy_req_rsp phy_req;
+		struct pdu_data_llctrl_phy_req_rsp phy_rsp;
+		struct pdu_data_llctrl_phy_update_ind phy_update_ind;
 	} __packed ctrldata;
 } __packed;
 
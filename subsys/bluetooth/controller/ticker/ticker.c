@@ -6,7 +6,9 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
+#include "util.h"
 #include "cntr.h"
 #include "ticker.h"
 
@@ -105,6 +107,17 @@ struct ticker_user {
 	struct ticker_user_op *user_op;
 };
 
+/* Where an enqueue stopped walking the list, for the retry of a ticker
+ * colliding, later in time, to continue from there instead of the head.
+ */
+struct ticker_walk {
+	uint8_t previous;
+	uint8_t current;
+	uint8_t ticker_id_slot_previous;
+	uint32_t ticks_slot_previous;
+	uint32_t ticks_walked;
+};
+
 struct ticker_instance {
 	struct ticker_node *node;
 	struct ticker_user *user;
@@ -122,6 +135,11 @@ struct ticker_instance {
 	uint8_t (*fp_caller_id_get)(uint8_t user_id);
 	void (*fp_sched)(uint8_t caller_id, uint8_t callee_id, uint8_t chain);
 	void (*fp_cmp_set)(uint32_t value);
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	/* job runs, in us, at the counter resolution */
+	struct util_hist job_hist;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
 };
 
 /*****************************************************************************
@@ -197,8 +215,18 @@ static void ticker_by_next_slot_get(struct ticker_instance *instance,
 	*ticks_to_expire = _ticks_to_expire;
 }
 
+static void ticker_walk_init(struct ticker_instance *instance,
+			     struct ticker_walk *walk)
+{
+	walk->previous = instance->ticker_id_head;
+	walk->current = instance->ticker_id_head;
+	walk->ticker_id_slot_previous = TICKER_NULL;
+	walk->ticks_slot_previous = instance->ticks_slot_previous;
+	walk->ticks_walked = 0;
+}
+
 static uint8_t ticker_enqueue(struct ticker_instance *instance,
-				    uint8_t id)
+				    uint8_t id, struct ticker_walk *walk)
 {
 	struct ticker_node *node;
 	struct ticker_node *ticker_new;
@@ -213,12 +241,15 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance,
 
 	node = &instance->node[0];
 	ticker_new = &node[id];
-	ticks_to_expire = ticker_new->ticks_to_expire;
 
-	collide = ticker_id_slot_previous = TICKER_NULL;
-	current = instance->ticker_id_head;
-	previous = current;
-	ticks_slot_previous = instance->ticks_slot_previous;
+	/* The tickers walked by a previous attempt expire before this one,
+	 * which can only have moved later in time since.
+	 */
+	ticks_to_expire = ticker_new->ticks_to_expire - walk->ticks_walked;
+	current = walk->current;
+	previous = walk->previous;
+	ticker_id_slot_previous = walk->ticker_id_slot_previous;
+	ticks_slot_previous = walk->ticks_slot_previous;
 	while ((current != TICKER_NULL)
 	       &&
 	       (ticks_to_expire >
@@ -241,6 +272,12 @@ static uint8_t ticker_enqueue(struct ticker_instance *instance,
 		current = ticker_current->next;
 	}
 
+	walk->previous = previous;
+	walk->current = current;
+	walk->ticker_id_slot_previous = ticker_id_slot_previous;
+	walk->ticks_slot_previous = ticks_slot_previous;
+	walk->ticks_walked = ticker_new->ticks_to_expire - ticks_to_expire;
+
 	collide = ticker_by_slot_get(&node[0], current, ticks_to_expire +
 				ticker_new->ticks_slot);
 
@@ -805,6 +842,7 @@ static inline void ticker_job_list_insert(
 			struct ticker_user_op *user_op;
 			enum ticker_user_op_type _user_op;
 			struct ticker_node *ticker;
+			struct ticker_walk walk;
 			uint32_t status;
 
 			if (insert_head != TICKER_NULL) {
@@ -877,11 +915,12 @@ static inline void ticker_job_list_insert(
 
 			/* Prepare to insert */
 			ticker->next = TICKER_NULL;
+			ticker_walk_init(instance, &walk);
 
 			/* If insert collides advance to next interval */
 			while (id_insert !=
 			       (id_collide =
-				ticker_enqueue(instance, id_insert))) {
+				ticker_enqueue(instance, id_insert, &walk))) {
 				struct ticker_node *ticker_preempt;
 
 				ticker_preempt = (id_collide != TICKER_NULL) ?
@@ -897,6 +936,9 @@ static inline void ticker_job_list_insert(
 					    ticker_dequeue(instance,
 							      id_collide);
 
+					/* the walked list has changed */
+					ticker_walk_init(instance, &walk);
+
 					/* unschedule node */
 					ticker_preempt->req =
 					    ticker_preempt->ack;
@@ -1074,6 +1116,9 @@ static inline void ticker_job(struct ticker_instance *instance)
 	uint8_t flag_elapsed;
 	uint8_t pending;
 	uint8_t flag_compare_update;
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	uint32_t ticks_job;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
 
 	DEBUG_TICKER_JOB(1);
 
@@ -1085,6 +1130,10 @@ static inline void ticker_job(struct ticker_instance *instance)
 	}
 	instance->job_guard = 1;
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	ticks_job = cntr_cnt_get();
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 	/* Back up the previous known tick */
 	ticks_previous = instance->ticks_current;
 
@@ -1169,6 +1218,11 @@ static inline void ticker_job(struct ticker_instance *instance)
 		instance->fp_sched(CALL_ID_JOB, CALL_ID_WORKER, 1);
 	}
 
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+	ticks_job = ticker_ticks_diff_get(cntr_cnt_get(), ticks_job);
+	util_hist_add(&instance->job_hist, TICKER_TICKS_TO_US(ticks_job));
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
+
 	DEBUG_TICKER_JOB(0);
 }
 
@@ -1790,3 +1844,16 @@ uint32_t ticker_ticks_diff_get(uint32_t ticks_now, uint32_t ticks_old)
 {
 	return ((ticks_now - ticks_old) & 0x00FFFFFF);
 }
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST)
+void ticker_job_profile_get(uint8_t instance_index, struct util_hist *hist)
+{
+	memcpy(hist, &_instance[instance_index].job_hist, sizeof(*hist));
+}
+
+void ticker_job_profile_clear(uint8_t instance_index)
+{
+	memset(&_instance[instance_index].job_hist, 0,
+	       sizeof(_instance[instance_index].job_hist));
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_HIST */
@@ -125,4 +125,8 @@ void ticker_job_sched(uint8_t instance_index, uint8_t user_id);
 uint32_t ticker_ticks_now_get(void);
 uint32_t ticker_ticks_diff_get(uint32_t ticks_now, uint32_t ticks_old);
 
+struct util_hist;
+void ticker_job_profile_get(uint8_t instance_index, struct util_hist *hist);
+void ticker_job_profile_clear(uint8_t instance_index);
+
 #endif
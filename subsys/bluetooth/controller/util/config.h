@@ -14,6 +14,8 @@
 #define MAYFLY_CALL_ID_PROGRAM 3
 #define MAYFLY_CALLER_COUNT    4
 #define MAYFLY_CALLEE_COUNT    4
+#define MAYFLY_PRIO_COUNT      2
+#define MAYFLY_RUN_BATCH       4
 
 #define TICKER_MAYFLY_CALL_ID_TRIGGER MAYFLY_CALL_ID_0
 #define TICKER_MAYFLY_CALL_ID_WORKER0 MAYFLY_CALL_ID_0
@@ -8,6 +8,9 @@
 #include <stdint.h>
 #include "memq.h"
 #include "mayfly.h"
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+#include "cntr.h"
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
 
 #include "config.h"
 
@@ -20,7 +23,23 @@ static struct {
 	uint8_t disable_ack;
 } mft[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
 
-static void *mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT][2];
+/* Queues of each caller to each callee, one per mayfly priority */
+static struct mayfly_queue {
+	void *head;
+	void *tail;
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+	/* incremented by the caller and the callee respectively */
+	uint8_t enqueued;
+	uint8_t dequeued;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
+} mfq[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT][MAYFLY_PRIO_COUNT];
+
+static void *mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT][MAYFLY_PRIO_COUNT]
+		[2];
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+static struct mayfly_profile mfp[MAYFLY_CALLEE_COUNT];
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
 
 void mayfly_init(void)
 {
@@ -32,9 +51,16 @@ void mayfly_init(void)
 
 		caller_id = MAYFLY_CALLER_COUNT;
 		while (caller_id--) {
-			memq_init(mfl[callee_id][caller_id],
-				  &mft[callee_id][caller_id].head,
-				  &mft[callee_id][caller_id].tail);
+			uint8_t prio;
+
+			prio = MAYFLY_PRIO_COUNT;
+			while (prio--) {
+				struct mayfly_queue *q;
+
+				q = &mfq[callee_id][caller_id][prio];
+				memq_init(mfl[callee_id][caller_id][prio],
+					  &q->head, &q->tail);
+			}
 		}
 	}
 }
@@ -104,7 +130,11 @@ uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 
 	/* new, add as ready in the queue */
 	m->_req = ack + 1;
-	memq_enqueue(m, m->_link, &mft[callee_id][caller_id].tail);
+	memq_enqueue(m, m->_link, &mfq[callee_id][caller_id][m->prio].tail);
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+	mfq[callee_id][caller_id][m->prio].enqueued++;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
 
 	/* pend the callee for execution */
 	mayfly_pend(caller_id, callee_id);
@@ -112,72 +142,129 @@ uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 	return 0;
 }
 
-void mayfly_run(uint8_t callee_id)
+/* Run the first ready mayfly of a queue, if any, dequeuing the ones done */
+static uint8_t mayfly_run_queue(uint8_t callee_id, uint8_t caller_id,
+				uint8_t prio)
 {
-	uint8_t disable = 0;
-	uint8_t enable = 0;
-	uint8_t caller_id;
+	void *link;
+	struct mayfly *m = 0;
+
+	/* fetch mayfly in callee queue, if any */
+	link = memq_peek(mfq[callee_id][caller_id][prio].tail,
+			 mfq[callee_id][caller_id][prio].head,
+			 (void **)&m);
+	while (link) {
+		uint8_t state;
+		uint8_t req;
+
+		/* execute work if ready */
+		req = m->_req;
+		state = (req - m->_ack) & 0x03;
+		if (state == 1) {
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+			struct mayfly_profile *profile = &mfp[callee_id];
+			uint8_t depth;
+			uint32_t ticks;
+
+			depth = mfq[callee_id][caller_id][prio].enqueued -
+				mfq[callee_id][caller_id][prio].dequeued;
+			if (depth > profile->depth_max) {
+				profile->depth_max = depth;
+			}
 
-	/* iterate through each caller queue to this callee_id */
-	caller_id = MAYFLY_CALLER_COUNT;
-	while (caller_id--) {
-		void *link;
-		struct mayfly *m = 0;
+			ticks = cntr_cnt_get();
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
 
-		/* fetch mayfly in callee queue, if any */
-		link = memq_peek(mft[callee_id][caller_id].tail,
-				 mft[callee_id][caller_id].head,
-				 (void **)&m);
-		while (link) {
-			uint8_t state;
-			uint8_t req;
-
-			/* execute work if ready */
-			req = m->_req;
-			state = (req - m->_ack) & 0x03;
-			if (state == 1) {
-				/* mark mayfly as ran */
-				m->_ack--;
-
-				/* call the mayfly function */
-				m->fp(m->param);
+			/* mark mayfly as ran */
+			m->_ack--;
+
+			/* call the mayfly function */
+			m->fp(m->param);
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+			ticks = (cntr_cnt_get() - ticks) & 0x00FFFFFF;
+			if (ticks > profile->ticks_max) {
+				profile->ticks_max = ticks;
 			}
 
-			/* dequeue if not re-pended */
-			req = m->_req;
-			if (((req - m->_ack) & 0x03) != 1) {
-				memq_dequeue(mft[callee_id][caller_id].tail,
-					     &mft[callee_id][caller_id].head,
-					     0);
+			profile->run_count++;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
+		}
 
-				/* release link into dequeued mayfly struct */
-				m->_link = link;
+		/* dequeue if not re-pended */
+		req = m->_req;
+		if (((req - m->_ack) & 0x03) != 1) {
+			memq_dequeue(mfq[callee_id][caller_id][prio].tail,
+				     &mfq[callee_id][caller_id][prio].head,
+				     0);
 
-				/* reset mayfly state to idle */
-				m->_ack = req;
-			}
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+			mfq[callee_id][caller_id][prio].dequeued++;
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
+
+			/* release link into dequeued mayfly struct */
+			m->_link = link;
 
-			/* fetch next mayfly in callee queue, if any */
-			link = memq_peek(mft[callee_id][caller_id].tail,
-					 mft[callee_id][caller_id].head,
-					 (void **)&m);
-
-			/* yield out of mayfly_run if a mayfly function was
-			 * called.
-			 */
-			if (state == 1) {
-				/* pend callee (tailchain) if mayfly queue is
-				 * not empty or all caller queues are not
-				 * processed.
-				 */
-				if (caller_id || link) {
-					mayfly_pend(callee_id, callee_id);
-
-					return;
-				}
+			/* reset mayfly state to idle */
+			m->_ack = req;
+		}
+
+		if (state == 1) {
+			return 1;
+		}
+
+		/* fetch next mayfly in callee queue, if any */
+		link = memq_peek(mfq[callee_id][caller_id][prio].tail,
+				 mfq[callee_id][caller_id][prio].head,
+				 (void **)&m);
+	}
+
+	return 0;
+}
+
+/* Run the ready mayfly of highest priority, if any */
+static uint8_t mayfly_run_next(uint8_t callee_id)
+{
+	uint8_t prio;
+
+	for (prio = 0; prio < MAYFLY_PRIO_COUNT; prio++) {
+		uint8_t caller_id;
+
+		caller_id = MAYFLY_CALLER_COUNT;
+		while (caller_id--) {
+			if (mayfly_run_queue(callee_id, caller_id, prio)) {
+				return 1;
 			}
 		}
+	}
+
+	return 0;
+}
 
+void mayfly_run(uint8_t callee_id)
+{
+	uint8_t disable = 0;
+	uint8_t enable = 0;
+	uint8_t caller_id;
+	uint8_t batch;
+
+	/* the queues are searched again from the highest priority after
+	 * each mayfly, so that one enqueued meanwhile is not delayed by
+	 * the ones already there. Yield out of mayfly_run after a batch,
+	 * pending the callee (tailchain) to continue.
+	 */
+	batch = MAYFLY_RUN_BATCH;
+	while (mayfly_run_next(callee_id)) {
+		if (!--batch) {
+			mayfly_pend(callee_id, callee_id);
+
+			return;
+		}
+	}
+
+	/* all the queues to this callee are processed */
+	caller_id = MAYFLY_CALLER_COUNT;
+	while (caller_id--) {
 		if (mft[callee_id][caller_id].disable_req !=
 		    mft[callee_id][caller_id].disable_ack) {
 			disable = 1;
@@ -199,3 +286,10 @@ void mayfly_run(uint8_t callee_id)
 		mayfly_enable_cb(callee_id, callee_id, 0);
 	}
 }
+
+#if defined(CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY)
+void mayfly_profile_get(uint8_t callee_id, struct mayfly_profile *profile)
+{
+	*profile = mfp[callee_id];
+}
+#endif /* CONFIG_BLUETOOTH_CONTROLLER_PROFILE_MAYFLY */
@@ -8,12 +8,28 @@
 #ifndef _MAYFLY_H_
 #define _MAYFLY_H_
 
+/* Mayfly priorities, the default one being the highest */
+#define MAYFLY_PRIO_HIGH 0
+#define MAYFLY_PRIO_LOW  1
+
 struct mayfly {
 	uint8_t volatile _req;
 	uint8_t _ack;
 	void *_link;
 	void *param;
 	void (*fp)(void *);
+	/* run after the ready mayflies of higher priority to the callee,
+	 * not to be changed while enqueued.
+	 */
+	uint8_t prio;
+};
+
+struct mayfly_profile {
+	/* most mayflies found in a queue when running one */
+	uint8_t depth_max;
+	/* longest mayfly function run, in counter ticks */
+	uint32_t ticks_max;
+	uint32_t run_count;
 };
 
 void mayfly_init(void);
@@ -21,6 +37,7 @@ void mayfly_enable(uint8_t caller_id, uint8_t callee_id, uint8_t enable);
 uint32_t mayfly_enqueue(uint8_t caller_id, uint8_t callee_id, uint8_t chain,
 			struct mayfly *m);
 void mayfly_run(uint8_t callee_id);
+void mayfly_profile_get(uint8_t callee_id, struct mayfly_profile *profile);
 
 extern void mayfly_enable_cb(uint8_t caller_id, uint8_t callee_id,
 			     uint8_t enable);
@@ -12,58 +12,56 @@
 
 #include "mem.h"
 
+/* Blocks are word aligned, the next pointer of the free list is stored in
+ * the first word of each block, and the free count in the word following
+ * the one of the head block.
+ */
+#define MEM_NEXT(mem) (*((void **)(mem)))
+#define MEM_FREE_COUNT(mem) (*((uint16_t *)((void **)(mem) + 1)))
+
 void mem_init(void *mem_pool, uint16_t mem_size, uint16_t mem_count,
 	      void **mem_head)
 {
+	uint8_t *mem;
+
 	*mem_head = mem_pool;
 
 	/* Store free mem_count after the list's next pointer at an aligned
 	 * memory location to ensure atomic read/write (in ARM for now).
 	 */
-	*((uint16_t *)MROUND((uint8_t *)mem_pool + sizeof(mem_pool))) =
-		mem_count;
+	MEM_FREE_COUNT(mem_pool) = mem_count;
 
-	/* Initialize next pointers to form a free list,
-	 * next pointer is stored in the first 32-bit of each block
-	 */
-	memset(((uint8_t *)mem_pool + (mem_size * (--mem_count))), 0,
-	       sizeof(mem_pool));
-	while (mem_count--) {
-		uint32_t next;
-
-		next = (uint32_t)((uint8_t *) mem_pool +
-				(mem_size * (mem_count + 1)));
-		memcpy(((uint8_t *)mem_pool + (mem_size * mem_count)),
-			 (void *)&next, sizeof(next));
+	/* Initialize next pointers to form a free list */
+	mem = mem_pool;
+	while (--mem_count) {
+		MEM_NEXT(mem) = mem + mem_size;
+		mem += mem_size;
 	}
+	MEM_NEXT(mem) = NULL;
 }
 
 void *mem_acquire(void **mem_head)
 {
-	if (*mem_head) {
+	void *mem = *mem_head;
+
+	if (mem) {
 		uint16_t free_count;
 		void *head;
-		void *mem;
 
 		/* Get the free count from the list and decrement it */
-		free_count = *((uint16_t *)MROUND((uint8_t *)*mem_head +
-						  sizeof(mem_head)));
-		free_count--;
+		free_count = MEM_FREE_COUNT(mem) - 1;
 
-		mem = *mem_head;
-		memcpy(&head, mem, sizeof(head));
+		head = MEM_NEXT(mem);
 
 		/* Store free mem_count after the list's next pointer */
 		if (head) {
-			*((uint16_t *)MROUND((uint8_t *)head + sizeof(head))) =
-				free_count;
+			MEM_FREE_COUNT(head) = free_count;
 		}
 
 		*mem_head = head;
-		return mem;
 	}
 
-	return NULL;
+	return mem;
 }
 
 void mem_release(void *mem, void **mem_head)
@@ -72,15 +70,14 @@ void mem_release(void *mem, void **mem_head)
 
 	/* Get the free count from the list and increment it */
 	if (*mem_head) {
-		free_count = *((uint16_t *)MROUND((uint8_t *)*mem_head +
-						  sizeof(mem_head)));
+		free_count = MEM_FREE_COUNT(*mem_head);
 	}
 	free_count++;
 
-	memcpy(mem, mem_head, sizeof(mem));
+	MEM_NEXT(mem) = *mem_head;
 
 	/* Store free mem_count after the list's next pointer */
-	*((uint16_t *)MROUND((uint8_t *)mem + sizeof(mem))) = free_count;
+	MEM_FREE_COUNT(mem) = free_count;
 
 	*mem_head = mem;
 }
@@ -91,8 +88,7 @@ uint16_t mem_free_count_get(void *mem_head)
 
 	/* Get the free count from the list */
 	if (mem_head) {
-		free_count = *((uint16_t *)MROUND((uint8_t *)mem_head +
-						  sizeof(mem_head)));
+		free_count = MEM_FREE_COUNT(mem_head);
 	}
 
 	return free_count;
@@ -187,3 +183,30 @@ uint32_t mem_ut(void)
 
 	return 0;
 }
+
+uint32_t mem_ut_cycles(uint32_t (*cycles_get)(void))
+{
+	uint8_t MALIGN(4) pool[BLOCK_COUNT][BLOCK_SIZE];
+	void *mem[BLOCK_COUNT];
+	uint32_t cycles;
+	void *mem_free;
+	uint8_t loop;
+	uint8_t i;
+
+	mem_init(pool, BLOCK_SIZE, BLOCK_COUNT, &mem_free);
+
+	cycles = cycles_get();
+	for (loop = 0; loop < 16; loop++) {
+		for (i = 0; i < BLOCK_COUNT; i++) {
+			mem[i] = mem_acquire(&mem_free);
+		}
+
+		for (i = 0; i < BLOCK_COUNT; i++) {
+			mem_release(mem[i], &mem_free);
+		}
+	}
+	cycles = cycles_get() - cycles;
+
+	/* average cycles of an acquire and release pair */
+	return cycles / (16 * BLOCK_COUNT);
+}
@@ -29,5 +29,6 @@ void mem_rcopy(uint8_t *dst, uint8_t const *src, uint16_t len);
 uint8_t mem_is_zero(uint8_t *src, uint16_t len);
 
 uint32_t mem_ut(void);
+uint32_t mem_ut_cycles(uint32_t (*cycles_get)(void));
 
 #endif /* _MEM_H_ */
@@ -7,7 +7,7 @@
 
 #include <stdint.h>
 
-inline void *memq_peek(void *tail, void *head, void **mem);
+#include "memq.h"
 
 void *memq_init(void *link, void **head, void **tail)
 {
@@ -17,53 +17,6 @@ void *memq_init(void *link, void **head, void **tail)
 	return link;
 }
 
-void *memq_enqueue(void *mem, void *link, void **tail)
-{
-	/* make the current tail link node point to new link node */
-	*((void **)*tail) = link;
-
-	/* assign mem to current tail link node */
-	*((void **)*tail + 1) = mem;
-
-	/* increment the tail! */
-	*tail = link;
-
-	return link;
-}
-
-void *memq_peek(void *tail, void *head, void **mem)
-{
-	void *link;
-
-	/* if head and tail are equal, then queue empty */
-	if (head == tail) {
-		return 0;
-	}
-
-	/* pick the head link node */
-	link = head;
-
-	/* extract the element node */
-	if (mem) {
-		*mem = *((void **)link + 1);
-	}
-
-	return link;
-}
-
-void *memq_dequeue(void *tail, void **head, void **mem)
-{
-	void *link;
-
-	/* use memq peek to get the link and mem */
-	link = memq_peek(tail, *head, mem);
-
-	/* increment the head to next link node */
-	*head = *((void **)link);
-
-	return link;
-}
-
 uint32_t memq_ut(void)
 {
 	void *head;
@@ -96,3 +49,36 @@ uint32_t memq_ut(void)
 
 	return 0;
 }
+
+uint32_t memq_ut_cycles(uint32_t (*cycles_get)(void))
+{
+#define LINK_COUNT 8
+	void *links[LINK_COUNT][2];
+	void *free[LINK_COUNT - 1];
+	uint32_t cycles;
+	void *head;
+	void *tail;
+	uint8_t loop;
+	uint8_t i;
+
+	memq_init(&links[0][0], &head, &tail);
+	for (i = 0; i < (LINK_COUNT - 1); i++) {
+		free[i] = &links[i + 1][0];
+	}
+
+	cycles = cycles_get();
+	for (loop = 0; loop < 16; loop++) {
+		for (i = 0; i < (LINK_COUNT - 1); i++) {
+			memq_enqueue(0, free[i], &tail);
+		}
+
+		/* dequeued links are reused for the next enqueues */
+		for (i = 0; i < (LINK_COUNT - 1); i++) {
+			free[i] = memq_dequeue(tail, &head, 0);
+		}
+	}
+	cycles = cycles_get() - cycles;
+
+	/* average cycles of an enqueue and dequeue pair */
+	return cycles / (16 * (LINK_COUNT - 1));
+}
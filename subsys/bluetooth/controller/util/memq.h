@@ -8,9 +8,58 @@
 #ifndef _MEMQ_H_
 #define _MEMQ_H_
 
+/* The queue operations are inline, as they are used for every PDU in the
+ * radio ISR. A link node is two words, the next link and the mem element.
+ */
+
 void *memq_init(void *link, void **head, void **tail);
-void *memq_enqueue(void *mem, void *link, void **tail);
-void *memq_peek(void *tail, void *head, void **mem);
-void *memq_dequeue(void *tail, void **head, void **mem);
+
+static inline void *memq_enqueue(void *mem, void *link, void **tail)
+{
+	/* make the current tail link node point to new link node */
+	*((void **)*tail) = link;
+
+	/* assign mem to current tail link node */
+	*((void **)*tail + 1) = mem;
+
+	/* increment the tail! */
+	*tail = link;
+
+	return link;
+}
+
+static inline void *memq_peek(void *tail, void *head, void **mem)
+{
+	/* if head and tail are equal, then queue empty */
+	if (head == tail) {
+		return 0;
+	}
+
+	/* extract the element node */
+	if (mem) {
+		*mem = *((void **)head + 1);
+	}
+
+	/* the head link node */
+	return head;
+}
+
+static inline void *memq_dequeue(void *tail, void **head, void **mem)
+{
+	void *link;
+
+	/* use memq peek to get the link and mem */
+	link = memq_peek(tail, *head, mem);
+
+	/* increment the head to next link node */
+	if (link) {
+		*head = *((void **)link);
+	}
+
+	return link;
+}
+
+uint32_t memq_ut(void);
+uint32_t memq_ut_cycles(uint32_t (*cycles_get)(void));
 
 #endif
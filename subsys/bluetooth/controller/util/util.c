@@ -25,3 +25,21 @@ uint8_t util_ones_count_get(uint8_t *octets, uint8_t octets_len)
 
 	return one_count;
 }
+
+void util_hist_add(struct util_hist *hist, uint32_t us)
+{
+	uint8_t bin = 0;
+
+	if (us > hist->max) {
+		hist->max = (us < 0xFFFF) ? us : 0xFFFF;
+	}
+
+	while (us && (bin < (UTIL_HIST_BINS - 1))) {
+		us >>= 1;
+		bin++;
+	}
+
+	if (hist->bin[bin] != 0xFFFF) {
+		hist->bin[bin]++;
+	}
+}
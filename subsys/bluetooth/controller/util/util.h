@@ -16,6 +16,20 @@
 #define TRIPLE_BUFFER_SIZE 3
 #endif
 
+#ifndef UTIL_HIST_BINS
+#define UTIL_HIST_BINS 12
+#endif
+
+/* Histogram of durations in us: bin 0 counts 0 us, bin n counts from
+ * 2^(n - 1) to 2^n - 1 us, and the last bin all the longer ones too, the
+ * counts saturating.
+ */
+struct util_hist {
+	uint16_t bin[UTIL_HIST_BINS];
+	uint16_t max;
+};
+
 uint8_t util_ones_count_get(uint8_t *octets, uint8_t octets_len);
+void util_hist_add(struct util_hist *hist, uint32_t us);
 
 #endif
@@ -31,6 +31,10 @@
 
 #define A2DP_NO_SPACE (-1)
 
+/* SBC payload header, not fragmented, followed by the frames */
+#define A2DP_SBC_HDR_LEN 1
+#define A2DP_SBC_FRAMES_MAX 0x0f
+
 struct bt_a2dp {
 	struct bt_avdtp session;
 };
@@ -158,3 +162,32 @@ int bt_a2dp_register_endpoint(struct bt_a2dp_endpoint *endpoint,
 
 	return 0;
 }
+
+struct net_buf *bt_a2dp_create_pdu(struct net_buf_pool *pool)
+{
+	return bt_avdtp_create_media_pdu(pool, A2DP_SBC_HDR_LEN);
+}
+
+int bt_a2dp_stream_send_sbc(struct bt_a2dp_stream *stream,
+			    struct net_buf *buf, uint8_t frames,
+			    uint32_t timestamp)
+{
+	int err;
+
+	if (!stream || !buf || !frames || frames > A2DP_SBC_FRAMES_MAX) {
+		return -EINVAL;
+	}
+
+	if (net_buf_headroom(buf) < A2DP_SBC_HDR_LEN) {
+		return -EINVAL;
+	}
+
+	net_buf_push_u8(buf, frames);
+
+	err = bt_avdtp_send_media(&stream->stream, buf, timestamp);
+	if (err < 0) {
+		net_buf_pull(buf, A2DP_SBC_HDR_LEN);
+	}
+
+	return err;
+}
@@ -71,6 +71,31 @@ struct bt_att {
 
 static struct bt_att bt_req_pool[CONFIG_BLUETOOTH_MAX_CONN];
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+#define ATT_EATT_BEARERS	CONFIG_BLUETOOTH_ATT_ENHANCED_BEARERS
+
+/* Enhanced bearers, LE connection oriented channels. The requests are
+ * queued on the fixed bearer of the connection, and sent on whichever
+ * bearer is idle first.
+ */
+static struct bt_att eatt_pool[CONFIG_BLUETOOTH_MAX_CONN * ATT_EATT_BEARERS];
+
+/* Pool for the PDUs received on the enhanced bearers, one per bearer so
+ * that reassembling on one never has to wait for another
+ */
+NET_BUF_POOL_DEFINE(eatt_rx_pool, CONFIG_BLUETOOTH_MAX_CONN * ATT_EATT_BEARERS,
+		    BT_ATT_MTU, BT_BUF_USER_DATA_MIN, NULL);
+
+static inline bool att_is_eatt(struct bt_att *att)
+{
+	return att->chan.rx.cid != BT_L2CAP_CID_ATT;
+}
+#else
+#define att_is_eatt(att) false
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
+static struct bt_att *att_chan_get(struct bt_conn *conn);
+
 static void att_req_destroy(struct bt_att_req *req)
 {
 	if (req->buf) {
@@ -84,9 +109,25 @@ static void att_req_destroy(struct bt_att_req *req)
 	memset(req, 0, sizeof(*req));
 }
 
-static void send_err_rsp(struct bt_conn *conn, uint8_t req, uint16_t handle,
+static void att_chan_send(struct bt_att *att, struct net_buf *buf)
+{
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	if (att_is_eatt(att)) {
+		if (bt_l2cap_chan_send(&att->chan.chan, buf) < 0) {
+			net_buf_unref(buf);
+		}
+
+		return;
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
+	bt_l2cap_send(att->chan.chan.conn, BT_L2CAP_CID_ATT, buf);
+}
+
+static void send_err_rsp(struct bt_att *att, uint8_t req, uint16_t handle,
 			 uint8_t err)
 {
+	struct bt_conn *conn = att->chan.chan.conn;
 	struct bt_att_error_rsp *rsp;
 	struct net_buf *buf;
 
@@ -105,7 +146,7 @@ static void send_err_rsp(struct bt_conn *conn, uint8_t req, uint16_t handle,
 	rsp->handle = sys_cpu_to_le16(handle);
 	rsp->error = err;
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, buf);
+	att_chan_send(att, buf);
 }
 
 static uint8_t att_mtu_req(struct bt_att *att, struct net_buf *buf)
@@ -116,6 +157,11 @@ static uint8_t att_mtu_req(struct bt_att *att, struct net_buf *buf)
 	struct net_buf *pdu;
 	uint16_t mtu_client, mtu_server;
 
+	/* The MTU of the enhanced bearers is the one of their channel */
+	if (att_is_eatt(att)) {
+		return BT_ATT_ERR_NOT_SUPPORTED;
+	}
+
 	req = (void *)buf->data;
 
 	mtu_client = sys_le16_to_cpu(req->mtu);
@@ -139,7 +185,7 @@ static uint8_t att_mtu_req(struct bt_att *att, struct net_buf *buf)
 	rsp = net_buf_add(pdu, sizeof(*rsp));
 	rsp->mtu = sys_cpu_to_le16(mtu_server);
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, pdu);
+	att_chan_send(att, pdu);
 
 	/* BLUETOOTH SPECIFICATION Version 4.2 [Vol 3, Part F] page 484:
 	 *
@@ -166,18 +212,97 @@ static int att_send_req(struct bt_att *att, struct bt_att_req *req)
 	k_delayed_work_submit(&att->timeout_work, ATT_TIMEOUT);
 
 	/* Keep a reference for resending in case of an error */
-	bt_l2cap_send(att->chan.chan.conn, BT_L2CAP_CID_ATT,
-		      net_buf_ref(req->buf));
+	att_chan_send(att, net_buf_ref(req->buf));
 
 	return 0;
 }
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+/* Only the requests which can be reordered with the others are sent on
+ * the enhanced bearers: reads and discovery. Writes, and the MTU exchange
+ * which is only allowed on the fixed bearer, keep their order there.
+ */
+static bool att_req_is_eatt(struct bt_att_req *req)
+{
+	struct bt_att_hdr *hdr = (void *)req->buf->data;
+
+	switch (hdr->code) {
+	case BT_ATT_OP_FIND_INFO_REQ:
+	case BT_ATT_OP_FIND_TYPE_REQ:
+	case BT_ATT_OP_READ_TYPE_REQ:
+	case BT_ATT_OP_READ_REQ:
+	case BT_ATT_OP_READ_BLOB_REQ:
+	case BT_ATT_OP_READ_MULT_REQ:
+	case BT_ATT_OP_READ_GROUP_REQ:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* The GATT client tells the end of long reads from responses shorter than
+ * the MTU of the fixed bearer, so the bearers with a smaller one are not
+ * used.
+ */
+static bool eatt_is_usable(struct bt_att *att, struct bt_att *fixed)
+{
+	return att->chan.chan.state == BT_L2CAP_CONNECTED &&
+	       att->chan.tx.mtu >= fixed->chan.tx.mtu;
+}
+
+static struct bt_att *eatt_idle_get(struct bt_att *fixed)
+{
+	struct bt_conn *conn = fixed->chan.chan.conn;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(eatt_pool); i++) {
+		struct bt_att *att = &eatt_pool[i];
+
+		if (att->chan.chan.conn == conn && !att->req &&
+		    eatt_is_usable(att, fixed)) {
+			return att;
+		}
+	}
+
+	return NULL;
+}
+
+static void eatt_process(struct bt_att *att)
+{
+	struct bt_att *fixed = att_chan_get(att->chan.chan.conn);
+	struct bt_att_req *req;
+	sys_snode_t *prev = NULL;
+
+	if (!fixed || !eatt_is_usable(att, fixed)) {
+		return;
+	}
+
+	/* Pull the first request which can go on this bearer */
+	SYS_SLIST_FOR_EACH_CONTAINER(&fixed->reqs, req, node) {
+		if (att_req_is_eatt(req)) {
+			sys_slist_remove(&fixed->reqs, prev, &req->node);
+			att_send_req(att, req);
+			return;
+		}
+
+		prev = &req->node;
+	}
+}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 static void att_process(struct bt_att *att)
 {
 	sys_snode_t *node;
 
 	BT_DBG("");
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	if (att_is_eatt(att)) {
+		eatt_process(att);
+		return;
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 	/* Pull next request from the list */
 	node = sys_slist_get(&att->reqs);
 	if (!node) {
@@ -360,19 +485,18 @@ static uint8_t att_find_info_rsp(struct bt_att *att, uint16_t start_handle,
 	if (!data.rsp) {
 		net_buf_unref(data.buf);
 		/* Respond since handle is set */
-		send_err_rsp(conn, BT_ATT_OP_FIND_INFO_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_FIND_INFO_REQ, start_handle,
 			     BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
 
 static uint8_t att_find_info_req(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	struct bt_att_find_info_req *req;
 	uint16_t start_handle, end_handle, err_handle;
 
@@ -385,7 +509,7 @@ static uint8_t att_find_info_req(struct bt_att *att, struct net_buf *buf)
 	       end_handle);
 
 	if (!range_is_valid(start_handle, end_handle, &err_handle)) {
-		send_err_rsp(conn, BT_ATT_OP_FIND_INFO_REQ, err_handle,
+		send_err_rsp(att, BT_ATT_OP_FIND_INFO_REQ, err_handle,
 			     BT_ATT_ERR_INVALID_HANDLE);
 		return 0;
 	}
@@ -488,19 +612,18 @@ static uint8_t att_find_type_rsp(struct bt_att *att, uint16_t start_handle,
 	if (data.err) {
 		net_buf_unref(data.buf);
 		/* Respond since handle is set */
-		send_err_rsp(conn, BT_ATT_OP_FIND_TYPE_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_FIND_TYPE_REQ, start_handle,
 			     data.err);
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
 
 static uint8_t att_find_type_req(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	struct bt_att_find_type_req *req;
 	uint16_t start_handle, end_handle, err_handle, type;
 	uint8_t *value;
@@ -516,7 +639,7 @@ static uint8_t att_find_type_req(struct bt_att *att, struct net_buf *buf)
 	       end_handle, type);
 
 	if (!range_is_valid(start_handle, end_handle, &err_handle)) {
-		send_err_rsp(conn, BT_ATT_OP_FIND_TYPE_REQ, err_handle,
+		send_err_rsp(att, BT_ATT_OP_FIND_TYPE_REQ, err_handle,
 			     BT_ATT_ERR_INVALID_HANDLE);
 		return 0;
 	}
@@ -527,7 +650,7 @@ static uint8_t att_find_type_req(struct bt_att *att, struct net_buf *buf)
 	 * UUID for the specific primary service.
 	 */
 	if (type != BT_UUID_GATT_PRIMARY_VAL) {
-		send_err_rsp(conn, BT_ATT_OP_FIND_TYPE_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_FIND_TYPE_REQ, start_handle,
 			     BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
 		return 0;
 	}
@@ -702,19 +825,18 @@ static uint8_t att_read_type_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	if (data.err) {
 		net_buf_unref(data.buf);
 		/* Response here since handle is set */
-		send_err_rsp(conn, BT_ATT_OP_READ_TYPE_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_READ_TYPE_REQ, start_handle,
 			     data.err);
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
 
 static uint8_t att_read_type_req(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	struct bt_att_read_type_req *req;
 	uint16_t start_handle, end_handle, err_handle;
 	union {
@@ -742,7 +864,7 @@ static uint8_t att_read_type_req(struct bt_att *att, struct net_buf *buf)
 	       start_handle, end_handle, bt_uuid_str(&u.uuid));
 
 	if (!range_is_valid(start_handle, end_handle, &err_handle)) {
-		send_err_rsp(conn, BT_ATT_OP_READ_TYPE_REQ, err_handle,
+		send_err_rsp(att, BT_ATT_OP_READ_TYPE_REQ, err_handle,
 			     BT_ATT_ERR_INVALID_HANDLE);
 		return 0;
 	}
@@ -823,11 +945,11 @@ static uint8_t att_read_rsp(struct bt_att *att, uint8_t op, uint8_t rsp,
 	if (data.err) {
 		net_buf_unref(data.buf);
 		/* Respond here since handle is set */
-		send_err_rsp(conn, op, handle, data.err);
+		send_err_rsp(att, op, handle, data.err);
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
@@ -898,13 +1020,13 @@ static uint8_t att_read_mult_req(struct bt_att *att, struct net_buf *buf)
 		if (data.err) {
 			net_buf_unref(data.buf);
 			/* Respond here since handle is set */
-			send_err_rsp(conn, BT_ATT_OP_READ_MULT_REQ, handle,
+			send_err_rsp(att, BT_ATT_OP_READ_MULT_REQ, handle,
 				     data.err);
 			return 0;
 		}
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
@@ -1002,19 +1124,18 @@ static uint8_t att_read_group_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	if (!data.rsp->len) {
 		net_buf_unref(data.buf);
 		/* Respond here since handle is set */
-		send_err_rsp(conn, BT_ATT_OP_READ_GROUP_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_READ_GROUP_REQ, start_handle,
 			     BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
 
 static uint8_t att_read_group_req(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	struct bt_att_read_group_req *req;
 	uint16_t start_handle, end_handle, err_handle;
 	union {
@@ -1042,7 +1163,7 @@ static uint8_t att_read_group_req(struct bt_att *att, struct net_buf *buf)
 	       start_handle, end_handle, bt_uuid_str(&u.uuid));
 
 	if (!range_is_valid(start_handle, end_handle, &err_handle)) {
-		send_err_rsp(conn, BT_ATT_OP_READ_GROUP_REQ, err_handle,
+		send_err_rsp(att, BT_ATT_OP_READ_GROUP_REQ, err_handle,
 			     BT_ATT_ERR_INVALID_HANDLE);
 		return 0;
 	}
@@ -1056,7 +1177,7 @@ static uint8_t att_read_group_req(struct bt_att *att, struct net_buf *buf)
 	 */
 	if (bt_uuid_cmp(&u.uuid, BT_UUID_GATT_PRIMARY) &&
 	    bt_uuid_cmp(&u.uuid, BT_UUID_GATT_SECONDARY)) {
-		send_err_rsp(conn, BT_ATT_OP_READ_GROUP_REQ, start_handle,
+		send_err_rsp(att, BT_ATT_OP_READ_GROUP_REQ, start_handle,
 			     BT_ATT_ERR_UNSUPPORTED_GROUP_TYPE);
 		return 0;
 	}
@@ -1100,10 +1221,11 @@ static uint8_t write_cb(const struct bt_gatt_attr *attr, void *user_data)
 	return BT_GATT_ITER_CONTINUE;
 }
 
-static uint8_t att_write_rsp(struct bt_conn *conn, uint8_t op, uint8_t rsp,
+static uint8_t att_write_rsp(struct bt_att *att, uint8_t op, uint8_t rsp,
 			     uint16_t handle, uint16_t offset,
 			     const void *value, uint8_t len)
 {
+	struct bt_conn *conn = att->chan.chan.conn;
 	struct write_data data;
 
 	if (!handle) {
@@ -1134,13 +1256,13 @@ static uint8_t att_write_rsp(struct bt_conn *conn, uint8_t op, uint8_t rsp,
 		if (rsp) {
 			net_buf_unref(data.buf);
 			/* Respond here since handle is set */
-			send_err_rsp(conn, op, handle, data.err);
+			send_err_rsp(att, op, handle, data.err);
 		}
 		return op == BT_ATT_OP_EXEC_WRITE_REQ ? data.err : 0;
 	}
 
 	if (data.buf) {
-		bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+		att_chan_send(att, data.buf);
 	}
 
 	return 0;
@@ -1148,14 +1270,13 @@ static uint8_t att_write_rsp(struct bt_conn *conn, uint8_t op, uint8_t rsp,
 
 static uint8_t att_write_req(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	uint16_t handle;
 
 	handle = net_buf_pull_le16(buf);
 
 	BT_DBG("handle 0x%04x", handle);
 
-	return att_write_rsp(conn, BT_ATT_OP_WRITE_REQ, BT_ATT_OP_WRITE_RSP,
+	return att_write_rsp(att, BT_ATT_OP_WRITE_REQ, BT_ATT_OP_WRITE_RSP,
 			     handle, 0, buf->data, buf->len);
 }
 
@@ -1238,7 +1359,7 @@ static uint8_t att_prep_write_rsp(struct bt_att *att, uint16_t handle,
 
 	if (data.err) {
 		/* Respond here since handle is set */
-		send_err_rsp(conn, BT_ATT_OP_PREPARE_WRITE_REQ, handle,
+		send_err_rsp(att, BT_ATT_OP_PREPARE_WRITE_REQ, handle,
 			     data.err);
 		return 0;
 	}
@@ -1260,7 +1381,7 @@ static uint8_t att_prep_write_rsp(struct bt_att *att, uint16_t handle,
 	net_buf_add(data.buf, len);
 	memcpy(rsp->value, value, len);
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, data.buf);
+	att_chan_send(att, data.buf);
 
 	return 0;
 }
@@ -1301,12 +1422,12 @@ static uint8_t att_exec_write_rsp(struct bt_att *att, uint8_t flags)
 
 		/* Just discard the data if an error was set */
 		if (!err && flags == BT_ATT_FLAG_EXEC) {
-			err = att_write_rsp(conn, BT_ATT_OP_EXEC_WRITE_REQ, 0,
+			err = att_write_rsp(att, BT_ATT_OP_EXEC_WRITE_REQ, 0,
 					    data->handle, data->offset,
 					    buf->data, buf->len);
 			if (err) {
 				/* Respond here since handle is set */
-				send_err_rsp(conn, BT_ATT_OP_EXEC_WRITE_REQ,
+				send_err_rsp(att, BT_ATT_OP_EXEC_WRITE_REQ,
 					     data->handle, err);
 			}
 		}
@@ -1324,7 +1445,7 @@ static uint8_t att_exec_write_rsp(struct bt_att *att, uint8_t flags)
 		return BT_ATT_ERR_UNLIKELY;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, buf);
+	att_chan_send(att, buf);
 
 	return 0;
 }
@@ -1348,14 +1469,13 @@ static uint8_t att_exec_write_req(struct bt_att *att, struct net_buf *buf)
 
 static uint8_t att_write_cmd(struct bt_att *att, struct net_buf *buf)
 {
-	struct bt_conn *conn = att->chan.chan.conn;
 	uint16_t handle;
 
 	handle = net_buf_pull_le16(buf);
 
 	BT_DBG("handle 0x%04x", handle);
 
-	return att_write_rsp(conn, 0, 0, handle, 0, buf->data, buf->len);
+	return att_write_rsp(att, 0, 0, handle, 0, buf->data, buf->len);
 }
 
 static uint8_t att_signed_write_cmd(struct bt_att *att, struct net_buf *buf)
@@ -1383,7 +1503,7 @@ static uint8_t att_signed_write_cmd(struct bt_att *att, struct net_buf *buf)
 	net_buf_pull(buf, sizeof(struct bt_att_hdr));
 	net_buf_pull(buf, sizeof(*req));
 
-	return att_write_rsp(conn, 0, 0, handle, 0, buf->data,
+	return att_write_rsp(att, 0, 0, handle, 0, buf->data,
 			     buf->len - sizeof(struct bt_att_signature));
 }
 
@@ -1589,7 +1709,7 @@ static uint8_t att_indicate(struct bt_att *att, struct net_buf *buf)
 		return 0;
 	}
 
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, buf);
+	att_chan_send(att, buf);
 
 	return 0;
 }
@@ -1698,7 +1818,7 @@ static void bt_att_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 
 	if (err) {
 		BT_DBG("ATT error 0x%02x", err);
-		send_err_rsp(chan->conn, hdr->code, 0, err);
+		send_err_rsp(att, hdr->code, 0, err);
 	}
 }
 
@@ -1790,6 +1910,14 @@ static void att_timeout(struct k_work *work)
 	 */
 	att_reset(att);
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	/* Only this bearer is no longer used */
+	if (att_is_eatt(att)) {
+		bt_l2cap_chan_disconnect(&ch->chan);
+		return;
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 	/* Consider the channel disconnected */
 	bt_gatt_disconnected(ch->chan.conn);
 	ch->chan.conn = NULL;
@@ -1828,6 +1956,159 @@ static void bt_att_disconnected(struct bt_l2cap_chan *chan)
 	memset(att, 0, sizeof(*att));
 }
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+static void eatt_connected(struct bt_l2cap_chan *chan)
+{
+	struct bt_att *att = ATT_CHAN(chan);
+	struct bt_l2cap_le_chan *ch = BT_L2CAP_LE_CHAN(chan);
+
+	BT_DBG("chan %p cid 0x%04x mtu %u", ch, ch->tx.cid, ch->tx.mtu);
+
+#if CONFIG_BLUETOOTH_ATT_PREPARE_COUNT > 0
+	k_fifo_init(&att->prep_queue);
+#endif
+
+	/* The MTU is the one of the channel, there is no MTU exchange on
+	 * enhanced bearers, and the PDUs are in both directions as long as
+	 * the smallest of the two.
+	 */
+	ch->tx.mtu = min(ch->tx.mtu, ch->rx.mtu);
+
+	/* Nothing is sent from here, before the credits of the peer, the
+	 * bearer is used from the next request on.
+	 */
+	k_delayed_work_init(&att->timeout_work, att_timeout);
+	sys_slist_init(&att->reqs);
+}
+
+static void eatt_disconnected(struct bt_l2cap_chan *chan)
+{
+	struct bt_att *att = ATT_CHAN(chan);
+	struct bt_l2cap_le_chan *ch = BT_L2CAP_LE_CHAN(chan);
+	struct bt_att *fixed = att_chan_get(ch->chan.conn);
+	struct bt_att_req *req = att->req;
+
+	BT_DBG("chan %p cid 0x%04x", ch, ch->tx.cid);
+
+	if (req) {
+		k_delayed_work_cancel(&att->timeout_work);
+		att->req = NULL;
+	}
+
+	/* Only reads are sent on the enhanced bearers, so the outstanding
+	 * one is sent again on the fixed bearer rather than failed, unless
+	 * the whole connection is going away.
+	 */
+	if (req && fixed && ch->chan.conn->state == BT_CONN_CONNECTED) {
+		net_buf_simple_restore(&req->buf->b, &req->state);
+
+		if (fixed->req) {
+			sys_slist_prepend(&fixed->reqs, &req->node);
+		} else {
+			att_send_req(fixed, req);
+		}
+	} else if (req) {
+		if (req->func) {
+			req->func(NULL, BT_ATT_ERR_UNLIKELY, NULL, 0, req);
+		}
+
+		att_req_destroy(req);
+	}
+
+	att_reset(att);
+
+	memset(att, 0, sizeof(*att));
+}
+
+static struct net_buf *eatt_alloc_buf(struct bt_l2cap_chan *chan)
+{
+	return net_buf_alloc(&eatt_rx_pool, K_NO_WAIT);
+}
+
+static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
+				  uint8_t hci_status);
+
+static struct bt_att *eatt_alloc(void)
+{
+	static struct bt_l2cap_chan_ops ops = {
+		.connected = eatt_connected,
+		.disconnected = eatt_disconnected,
+		.alloc_buf = eatt_alloc_buf,
+		.recv = bt_att_recv,
+		.encrypt_change = bt_att_encrypt_change,
+	};
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(eatt_pool); i++) {
+		struct bt_att *att = &eatt_pool[i];
+
+		if (att->chan.chan.conn) {
+			continue;
+		}
+
+		memset(att, 0, sizeof(*att));
+		att->chan.chan.ops = &ops;
+		att->chan.rx.mtu = BT_ATT_MTU;
+
+		return att;
+	}
+
+	return NULL;
+}
+
+static int eatt_accept(struct bt_conn *conn, struct bt_l2cap_chan **chan)
+{
+	struct bt_att *att;
+
+	BT_DBG("conn %p handle %u", conn, conn->handle);
+
+	att = eatt_alloc();
+	if (!att) {
+		BT_ERR("No available enhanced ATT bearer for conn %p", conn);
+		return -ENOMEM;
+	}
+
+	*chan = &att->chan.chan;
+
+	return 0;
+}
+
+/* Connects the enhanced bearers once the link is encrypted, which they
+ * require. Only the master connects them, the bearers being usable by
+ * both sides.
+ */
+static void eatt_connect(struct bt_conn *conn)
+{
+	struct bt_att *att;
+	int i, count = 0;
+
+	if (conn->role != BT_HCI_ROLE_MASTER) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(eatt_pool); i++) {
+		if (eatt_pool[i].chan.chan.conn == conn) {
+			count++;
+		}
+	}
+
+	for (; count < ATT_EATT_BEARERS; count++) {
+		att = eatt_alloc();
+		if (!att) {
+			return;
+		}
+
+		att->chan.chan.required_sec_level = BT_SECURITY_MEDIUM;
+
+		if (bt_l2cap_chan_connect(conn, &att->chan.chan,
+					  BT_L2CAP_PSM_EATT)) {
+			BT_WARN("Unable to connect enhanced ATT bearer");
+			return;
+		}
+	}
+}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 #if defined(CONFIG_BLUETOOTH_SMP)
 static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
 				  uint8_t hci_status)
@@ -1852,6 +2133,12 @@ static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
 		return;
 	}
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	if (!att_is_eatt(att)) {
+		eatt_connect(conn);
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 	if (!att->req || !att->req->retrying) {
 		return;
 	}
@@ -1859,7 +2146,7 @@ static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
 	BT_DBG("Retrying");
 
 	/* Resend buffer */
-	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, att->req->buf);
+	att_chan_send(att, att->req->buf);
 	att->req->buf = NULL;
 }
 #endif /* CONFIG_BLUETOOTH_SMP */
@@ -1903,6 +2190,15 @@ void bt_att_init(void)
 		.cid		= BT_L2CAP_CID_ATT,
 		.accept		= bt_att_accept,
 	};
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	static struct bt_l2cap_server eatt_server = {
+		.psm		= BT_L2CAP_PSM_EATT,
+		.sec_level	= BT_SECURITY_MEDIUM,
+		.accept		= eatt_accept,
+	};
+
+	bt_l2cap_server_register(&eatt_server);
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
 
 	bt_l2cap_le_fixed_chan_register(&chan);
 }
@@ -1966,6 +2262,19 @@ int bt_att_req_send(struct bt_conn *conn, struct bt_att_req *req)
 		return -ENOTCONN;
 	}
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	/* Keep the fixed bearer for the requests which cannot go on the
+	 * enhanced ones
+	 */
+	if (att_req_is_eatt(req)) {
+		struct bt_att *eatt = eatt_idle_get(att);
+
+		if (eatt) {
+			return att_send_req(eatt, req);
+		}
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 	/* Check if there is a request outstanding */
 	if (att->req) {
 		/* Queue the request to be send later */
@@ -1979,6 +2288,9 @@ int bt_att_req_send(struct bt_conn *conn, struct bt_att_req *req)
 void bt_att_req_cancel(struct bt_conn *conn, struct bt_att_req *req)
 {
 	struct bt_att *att;
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	int i;
+#endif
 
 	if (!conn || !req) {
 		return;
@@ -1989,6 +2301,16 @@ void bt_att_req_cancel(struct bt_conn *conn, struct bt_att_req *req)
 		return;
 	}
 
+#if defined(CONFIG_BLUETOOTH_ATT_ENHANCED)
+	for (i = 0; i < ARRAY_SIZE(eatt_pool); i++) {
+		if (eatt_pool[i].chan.chan.conn == conn &&
+		    eatt_pool[i].req == req) {
+			att = &eatt_pool[i];
+			break;
+		}
+	}
+#endif /* CONFIG_BLUETOOTH_ATT_ENHANCED */
+
 	/* Check if request is outstanding */
 	if (att->req == req) {
 		att->req = NULL;
@@ -218,6 +218,14 @@ struct bt_att_indicate {
 /* Handle Value Confirm */
 #define BT_ATT_OP_CONFIRM			0x1e
 
+/* Handle Multiple Value Notification */
+#define BT_ATT_OP_MULT_NOTIFY			0x23
+struct bt_att_mult_notify {
+	uint16_t handle;
+	uint16_t len;
+	uint8_t  value[0];
+} __packed;
+
 struct bt_att_signature {
 	uint8_t  value[12];
 } __packed;
@@ -330,3 +330,51 @@ int bt_avdtp_discover(struct bt_avdtp *session,
 
 	return avdtp_send(session, buf, &param->req);
 }
+
+struct net_buf *bt_avdtp_create_media_pdu(struct net_buf_pool *pool,
+					  size_t reserve)
+{
+	return bt_conn_create_pdu(pool, sizeof(struct bt_l2cap_hdr) +
+				  sizeof(struct bt_avdtp_media_hdr) + reserve);
+}
+
+int bt_avdtp_send_media(struct bt_avdtp_stream *stream, struct net_buf *buf,
+			uint32_t timestamp)
+{
+	struct bt_avdtp_media_hdr *hdr;
+	int err;
+
+	if (!stream || !buf) {
+		return -EINVAL;
+	}
+
+	if (!stream->chan.chan.conn) {
+		return -ENOTCONN;
+	}
+
+	if (net_buf_headroom(buf) <
+	    sizeof(*hdr) + sizeof(struct bt_l2cap_hdr)) {
+		return -EINVAL;
+	}
+
+	hdr = net_buf_push(buf, sizeof(*hdr));
+	hdr->vpxcc = BT_AVDTP_RTP_VERSION << 6;
+	hdr->mpt = BT_AVDTP_RTP_PT_DYNAMIC;
+	hdr->seq = sys_cpu_to_be16(stream->seq);
+	hdr->timestamp = sys_cpu_to_be32(timestamp);
+	hdr->ssrc = sys_cpu_to_be32(stream->lsep.id);
+
+	/* The packet is queued for the controller as it is, being sent as the
+	 * controller gives back ACL buffers.
+	 */
+	err = bt_l2cap_chan_send(&stream->chan.chan, buf);
+	if (err < 0) {
+		BT_ERR("Error:L2CAP send fail - result = %d", err);
+		net_buf_pull(buf, sizeof(*hdr));
+		return err;
+	}
+
+	stream->seq++;
+
+	return 0;
+}
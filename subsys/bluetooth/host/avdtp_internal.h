@@ -107,6 +107,20 @@ struct bt_avdtp_single_sig_hdr {
 
 #define BT_AVDTP_SIG_HDR_LEN sizeof(struct bt_avdtp_single_sig_hdr)
 
+/* Media packet header, RTP without CSRC, sent on the transport channel */
+struct bt_avdtp_media_hdr {
+	uint8_t vpxcc; /* Version, padding, extension and CSRC count */
+	uint8_t mpt; /* Marker and payload type */
+	uint16_t seq;
+	uint32_t timestamp;
+	uint32_t ssrc;
+} __packed;
+
+#define BT_AVDTP_MEDIA_HDR_LEN sizeof(struct bt_avdtp_media_hdr)
+
+#define BT_AVDTP_RTP_VERSION 2
+#define BT_AVDTP_RTP_PT_DYNAMIC 96
+
 struct bt_avdtp_ind_cb {
 	/*
 	 * discovery_ind;
@@ -168,3 +182,16 @@ int bt_avdtp_register_sep(uint8_t media_type, uint8_t role,
 /* AVDTP Discover Request */
 int bt_avdtp_discover(struct bt_avdtp *session,
 		      struct bt_avdtp_discover_params *param);
+
+/* Allocate a media packet, with head room for the L2CAP and AVDTP headers
+ * and reserve bytes for the payload header of the codec
+ */
+struct net_buf *bt_avdtp_create_media_pdu(struct net_buf_pool *pool,
+					  size_t reserve);
+
+/* Send a media packet on the transport channel of the stream, the media
+ * header being added in the head room of the buffer. The buffer can be a
+ * chain of fragments, and is left to the caller in case of error.
+ */
+int bt_avdtp_send_media(struct bt_avdtp_stream *stream, struct net_buf *buf,
+			uint32_t timestamp);
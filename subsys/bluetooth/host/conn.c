@@ -978,7 +978,7 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, uint8_t flags,
 
 	hdr = net_buf_push(buf, sizeof(*hdr));
 	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle, flags));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+	hdr->len = sys_cpu_to_le16(net_buf_frags_len(buf) - sizeof(*hdr));
 
 	bt_buf_set_type(buf, BT_BUF_ACL_OUT);
 
@@ -1010,6 +1010,15 @@ static inline uint16_t conn_mtu(struct bt_conn *conn)
 	return bt_dev.le.mtu;
 }
 
+uint16_t bt_conn_get_frags_mtu(struct bt_conn *conn)
+{
+	if (!bt_dev.drv->send_frags) {
+		return 0;
+	}
+
+	return conn_mtu(conn);
+}
+
 static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct net_buf *frag;
@@ -1024,53 +1033,81 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 
 	frag_len = min(conn_mtu(conn), net_buf_tailroom(frag));
 
-	net_buf_add_mem(frag, buf->data, frag_len);
-	net_buf_pull(buf, frag_len);
+	/* Copy from the fragments of the buffer too, removing them once
+	 * they are empty.
+	 */
+	while (frag_len) {
+		struct net_buf *src = buf->len ? buf : buf->frags;
+		uint16_t len;
+
+		if (!src) {
+			break;
+		}
+
+		len = min(frag_len, src->len);
+		net_buf_add_mem(frag, src->data, len);
+		net_buf_pull(src, len);
+		frag_len -= len;
+
+		if (src != buf && !src->len) {
+			net_buf_frag_del(buf, src);
+		}
+	}
 
 	return frag;
 }
 
-static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
+/* Whether the buffer has to be copied into ACL fragments to be sent */
+static bool needs_frag(struct bt_conn *conn, struct net_buf *buf)
 {
-	struct net_buf *frag;
-
-	BT_DBG("conn %p buf %p len %u", conn, buf, buf->len);
-
-	/* Send directly if the packet fits the ACL MTU */
-	if (buf->len <= conn_mtu(conn)) {
-		return send_frag(conn, buf, BT_ACL_START_NO_FLUSH, false);
+	if (buf->frags && !bt_dev.drv->send_frags) {
+		return true;
 	}
 
-	/* Create & enqueue first fragment */
-	frag = create_frag(conn, buf);
-	if (!frag) {
-		return false;
-	}
+	return net_buf_frags_len(buf) > conn_mtu(conn);
+}
 
-	if (!send_frag(conn, frag, BT_ACL_START_NO_FLUSH, true)) {
-		return false;
-	}
+static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
+{
+	uint8_t flags = BT_ACL_START_NO_FLUSH;
+	struct net_buf *frag;
+
+	BT_DBG("conn %p buf %p len %u", conn, buf, net_buf_frags_len(buf));
 
 	/*
 	 * Send the fragments. For the last one simply use the original
-	 * buffer (which works since we've used net_buf_pull on it.
+	 * buffer (which works since we've used net_buf_pull on it), or
+	 * release it if all its data got copied.
 	 */
-	while (buf->len > conn_mtu(conn)) {
+	while (needs_frag(conn, buf)) {
 		frag = create_frag(conn, buf);
 		if (!frag) {
 			return false;
 		}
 
-		if (!send_frag(conn, frag, BT_ACL_CONT, true)) {
+		if (!send_frag(conn, frag, flags, true)) {
 			return false;
 		}
+
+		flags = BT_ACL_CONT;
+
+		if (!net_buf_frags_len(buf)) {
+			net_buf_unref(buf);
+			return true;
+		}
 	}
 
-	return send_frag(conn, buf, BT_ACL_CONT, false);
+	return send_frag(conn, buf, flags, false);
 }
 
 static struct k_poll_signal conn_change = K_POLL_SIGNAL_INITIALIZER();
 
+/* Connection the next TX round starts with */
+static uint8_t tx_next;
+
+/* Set while connections wait for their controller buffers to complete */
+static atomic_t tx_quota_wait;
+
 static void conn_cleanup(struct bt_conn *conn)
 {
 	struct net_buf *buf;
@@ -1090,8 +1127,65 @@ static void conn_cleanup(struct bt_conn *conn)
 	bt_conn_unref(conn);
 }
 
+/* Number of controller buffers needed to send the buffer */
+static unsigned int conn_tx_pkts(struct bt_conn *conn, struct net_buf *buf)
+{
+	unsigned int limit = bt_conn_get_pkts(conn)->limit;
+	uint16_t mtu = conn_mtu(conn);
+	unsigned int pkts;
+
+	pkts = (net_buf_frags_len(buf) + mtu - 1) / mtu;
+
+	/* Larger packets have to wait for buffers while being sent */
+	return max(1, min(pkts, limit));
+}
+
+/* Fair share of the controller buffers of the connection, between the
+ * connections using the same buffers.
+ */
+static unsigned int conn_tx_quota(struct bt_conn *conn)
+{
+	struct k_sem *pkts = bt_conn_get_pkts(conn);
+	unsigned int users = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		struct bt_conn *c = &conns[i];
+
+		if (!atomic_get(&c->ref) || c->state != BT_CONN_CONNECTED ||
+		    bt_conn_get_pkts(c) != pkts) {
+			continue;
+		}
+
+		if (c->pending_pkts || !k_fifo_is_empty(&c->tx_queue)) {
+			users++;
+		}
+	}
+
+	return max(1, pkts->limit / max(1, users));
+}
+
+static bool conn_tx_has_pkts(struct bt_conn *conn, struct net_buf *buf)
+{
+	return k_sem_count_get(bt_conn_get_pkts(conn)) >=
+	       conn_tx_pkts(conn, buf);
+}
+
+static bool conn_tx_has_quota(struct bt_conn *conn)
+{
+	return conn->pending_pkts < conn_tx_quota(conn);
+}
+
+void bt_conn_pkts_completed(void)
+{
+	if (atomic_cas(&tx_quota_wait, 1, 0)) {
+		k_poll_signal(&conn_change, 0);
+	}
+}
+
 int bt_conn_prepare_events(struct k_poll_event events[])
 {
+	struct k_sem *pkts_wait[2] = { NULL, NULL };
 	int i, ev_count = 0;
 
 	BT_DBG("");
@@ -1100,8 +1194,18 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 	k_poll_event_init(&events[ev_count++], K_POLL_TYPE_SIGNAL,
 			  K_POLL_MODE_NOTIFY_ONLY, &conn_change);
 
+	atomic_set(&tx_quota_wait, 0);
+
+	/* Start each round with the next connection, for the processing
+	 * order of the events to be fair.
+	 */
+	tx_next = (tx_next + 1) % ARRAY_SIZE(conns);
+
 	for (i = 0; i < ARRAY_SIZE(conns); i++) {
-		struct bt_conn *conn = &conns[i];
+		struct bt_conn *conn;
+		struct net_buf *buf;
+
+		conn = &conns[(tx_next + i) % ARRAY_SIZE(conns)];
 
 		if (!atomic_get(&conn->ref)) {
 			continue;
@@ -1117,6 +1221,28 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 			continue;
 		}
 
+		/* Wait for controller buffers rather than for data, if the
+		 * connection cannot send the data already queued.
+		 */
+		buf = k_fifo_peek_head(&conn->tx_queue);
+		if (buf && !conn_tx_has_pkts(conn, buf)) {
+			struct k_sem *pkts = bt_conn_get_pkts(conn);
+
+			if (pkts_wait[0] != pkts && pkts_wait[1] != pkts) {
+				pkts_wait[pkts_wait[0] ? 1 : 0] = pkts;
+				k_poll_event_init(&events[ev_count++],
+						  K_POLL_TYPE_SEM_AVAILABLE,
+						  K_POLL_MODE_NOTIFY_ONLY,
+						  pkts);
+			}
+			continue;
+		}
+
+		if (buf && !conn_tx_has_quota(conn)) {
+			atomic_set(&tx_quota_wait, 1);
+			continue;
+		}
+
 		BT_DBG("Adding conn %p to poll list", conn);
 
 		k_poll_event_init(&events[ev_count],
@@ -1142,11 +1268,35 @@ void bt_conn_process_tx(struct bt_conn *conn)
 		return;
 	}
 
-	/* Get next ACL packet for connection */
-	buf = net_buf_get(&conn->tx_queue, K_NO_WAIT);
-	BT_ASSERT(buf);
-	if (!send_buf(conn, buf)) {
-		net_buf_unref(buf);
+	buf = k_fifo_peek_head(&conn->tx_queue);
+	if (!buf || !conn_tx_has_pkts(conn, buf)) {
+		return;
+	}
+
+	/* Deficit round robin: the connection gets a quantum of bytes for
+	 * the round, on top of what it could not use before, and sends as
+	 * many packets as the controller buffers and its quota allow.
+	 */
+	conn->tx_deficit += CONFIG_BLUETOOTH_CONN_TX_QUANTUM;
+
+	while (buf && net_buf_frags_len(buf) <= conn->tx_deficit &&
+	       conn_tx_has_pkts(conn, buf) && conn_tx_has_quota(conn)) {
+		/* Get next ACL packet for connection */
+		buf = net_buf_get(&conn->tx_queue, K_NO_WAIT);
+		BT_ASSERT(buf);
+
+		conn->tx_deficit -= net_buf_frags_len(buf);
+
+		if (!send_buf(conn, buf)) {
+			net_buf_unref(buf);
+		}
+
+		buf = k_fifo_peek_head(&conn->tx_queue);
+	}
+
+	/* Idle connections do not keep what they did not use */
+	if (!buf) {
+		conn->tx_deficit = 0;
 	}
 }
 
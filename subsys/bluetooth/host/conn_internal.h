@@ -87,6 +87,9 @@ struct bt_conn {
 
 	uint8_t			pending_pkts;
 
+	/* Bytes the connection may still send in the current TX round */
+	uint32_t		tx_deficit;
+
 	uint16_t		rx_len;
 	struct net_buf		*rx;
 
@@ -176,6 +179,11 @@ void bt_conn_security_changed(struct bt_conn *conn);
 /* Prepare a PDU to be sent over a connection */
 struct net_buf *bt_conn_create_pdu(struct net_buf_pool *pool, size_t reserve);
 
+/* Largest packet that is sent with its fragments as they are, instead of
+ * being copied into ACL fragments, 0 if fragments are always copied.
+ */
+uint16_t bt_conn_get_frags_mtu(struct bt_conn *conn);
+
 /* Initialize connection management */
 int bt_conn_init(void);
 
@@ -193,4 +201,5 @@ static inline struct k_sem *bt_conn_get_pkts(struct bt_conn *conn)
 
 /* k_poll related helpers for the TX thread */
 int bt_conn_prepare_events(struct k_poll_event events[]);
+void bt_conn_pkts_completed(void);
 void bt_conn_process_tx(struct bt_conn *conn);
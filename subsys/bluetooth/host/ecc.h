@@ -42,22 +42,40 @@ int bt_pub_key_gen(struct bt_pub_key_cb *cb);
  */
 const uint8_t *bt_pub_key_get(void);
 
-/*  @typedef bt_dh_key_cb_t
- *  @brief Callback type for DH Key calculation.
- *
- *  Used to notify of the calculated DH Key.
- *
- *  @param key The DH Key, or NULL in case of failure.
- */
-typedef void (*bt_dh_key_cb_t)(const uint8_t key[32]);
+/*  @brief Container for DH Key calculation request */
+struct bt_dh_key_req {
+	/** @brief Callback type for DH Key calculation.
+	 *
+	 *  Used to notify of the calculated DH Key.
+	 *
+	 *  @param req The request.
+	 *  @param key The DH Key, or NULL in case of failure.
+	 */
+	void (*func)(struct bt_dh_key_req *req, const uint8_t key[32]);
+
+	/** Remote Public Key, which must stay valid until notified */
+	const uint8_t *remote_pk;
+
+	sys_snode_t _node;
+};
 
 /*  @brief Calculate a DH Key from a remote Public Key.
  *
- *  Calculate a DH Key from the remote Public Key.
+ *  Calculate a DH Key from the remote Public Key. The requests are queued,
+ *  and given to the controller one at a time.
  *
- *  @param remote_pk Remote Public Key.
- *  @param cb Callback to notify the calculated key.
+ *  @param req Request, with the callback to notify the calculated key and
+ *             the remote Public Key.
  *
  *  @return Zero on success or negative error code otherwise
  */
-int bt_dh_key_gen(const uint8_t remote_pk[64], bt_dh_key_cb_t cb);
+int bt_dh_key_gen(struct bt_dh_key_req *req);
+
+/*  @brief Cancel a DH Key calculation.
+ *
+ *  The callback of the request is not called anymore, and the request can
+ *  be reused. Cancelling a request not queued has no effect.
+ *
+ *  @param req Request.
+ */
+void bt_dh_key_cancel(struct bt_dh_key_req *req);
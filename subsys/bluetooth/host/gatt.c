@@ -38,8 +38,55 @@ static sys_slist_t subscriptions;
 
 #if !defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
 static size_t attr_count;
+#else
+/* Attribute arrays registered, in handle order since the handles of each
+ * array have to be greater than the ones of the arrays before it.
+ */
+static struct {
+	struct bt_gatt_attr *attrs;
+	size_t count;
+} db_ranges[CONFIG_BLUETOOTH_GATT_DB_RANGES];
+static size_t db_range_count;
 #endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
 
+struct gatt_ccc_cache {
+	const struct bt_gatt_attr *attr;
+	/* CCC configuration of the peer for attr, NULL if there is none */
+	struct bt_gatt_ccc_cfg *cfg;
+};
+
+/* GATT server state of each connection */
+static struct gatt_conn {
+	struct bt_conn *conn;
+	/* Client Supported Features enabled by the peer */
+	uint8_t features;
+	uint8_t cache_next;
+	struct gatt_ccc_cache cache[CONFIG_BLUETOOTH_GATT_CCC_CACHE];
+} gatt_conns[CONFIG_BLUETOOTH_MAX_CONN];
+
+static struct gatt_conn *gatt_conn_lookup(struct bt_conn *conn)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(gatt_conns); i++) {
+		if (gatt_conns[i].conn == conn) {
+			return &gatt_conns[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void gatt_ccc_cache_clear(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(gatt_conns); i++) {
+		memset(gatt_conns[i].cache, 0, sizeof(gatt_conns[i].cache));
+		gatt_conns[i].cache_next = 0;
+	}
+}
+
 int bt_gatt_register(struct bt_gatt_attr *attrs, size_t count)
 {
 #if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
@@ -55,6 +102,14 @@ int bt_gatt_register(struct bt_gatt_attr *attrs, size_t count)
 	db = attrs;
 	attr_count = count;
 #else
+	if (db_range_count == ARRAY_SIZE(db_ranges)) {
+		BT_ERR("Too many attribute arrays registered");
+		return -ENOMEM;
+	}
+
+	db_ranges[db_range_count].attrs = attrs;
+	db_ranges[db_range_count].count = count;
+
 	if (!db) {
 		db = attrs;
 		last = NULL;
@@ -83,7 +138,11 @@ populate:
 		} else {
 			/* Service has conflicting handles */
 #if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
-			last->_next = NULL;
+			if (last) {
+				last->_next = NULL;
+			} else {
+				db = NULL;
+			}
 #endif
 			BT_ERR("Unable to register handle 0x%04x",
 			       attrs->handle);
@@ -101,6 +160,10 @@ populate:
 		       bt_uuid_str(attrs->uuid), attrs->perm);
 	}
 
+#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
+	db_range_count++;
+#endif
+
 	return 0;
 }
 
@@ -239,15 +302,80 @@ ssize_t bt_gatt_attr_read_chrc(struct bt_conn *conn,
 	return bt_gatt_attr_read(conn, attr, buf, len, offset, &pdu, value_len);
 }
 
+/* Binary search of the first attribute of the array with a handle not
+ * lower than the given one, count if there is none.
+ */
+static size_t attr_lower_bound(const struct bt_gatt_attr *attrs, size_t count,
+			       uint16_t handle)
+{
+	size_t lo = 0, hi = count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (attrs[mid].handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* First attribute with a handle not lower than the given one */
+static struct bt_gatt_attr *attr_find(uint16_t handle)
+{
+#if defined(CONFIG_BLUETOOTH_GATT_DYNAMIC_DB)
+	size_t lo = 0, hi = db_range_count, i;
+
+	/* Last range starting at or before the handle */
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (db_ranges[mid].attrs[0].handle <= handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (!lo) {
+		return db_range_count ? db_ranges[0].attrs : NULL;
+	}
+
+	lo--;
+	i = attr_lower_bound(db_ranges[lo].attrs, db_ranges[lo].count, handle);
+	if (i < db_ranges[lo].count) {
+		return &db_ranges[lo].attrs[i];
+	}
+
+	return lo + 1 < db_range_count ? db_ranges[lo + 1].attrs : NULL;
+#else
+	size_t i;
+
+	if (!db) {
+		return NULL;
+	}
+
+	i = attr_lower_bound(db, attr_count, handle);
+
+	return i < attr_count ? &db[i] : NULL;
+#endif /* CONFIG_BLUETOOTH_GATT_DYNAMIC_DB */
+}
+
 void bt_gatt_foreach_attr(uint16_t start_handle, uint16_t end_handle,
 			  bt_gatt_attr_func_t func, void *user_data)
 {
 	const struct bt_gatt_attr *attr;
 
-	for (attr = db; attr; attr = bt_gatt_attr_next(attr)) {
-		/* Check if attribute handle is within range */
-		if (attr->handle < start_handle || attr->handle > end_handle) {
-			continue;
+	/* The handles are in increasing order, so the iteration can start
+	 * at the first attribute in range and stop after the last one.
+	 */
+	for (attr = attr_find(start_handle); attr;
+	     attr = bt_gatt_attr_next(attr)) {
+		if (attr->handle > end_handle) {
+			break;
 		}
 
 		if (func(attr, user_data) == BT_GATT_ITER_STOP) {
@@ -364,6 +492,9 @@ ssize_t bt_gatt_attr_write_ccc(struct bt_conn *conn,
 
 	ccc->cfg[i].value = value;
 
+	/* The configuration may have been given to another peer */
+	gatt_ccc_cache_clear();
+
 	BT_DBG("handle 0x%04x value %u", attr->handle, ccc->cfg[i].value);
 
 	/* Update cfg if don't match */
@@ -374,6 +505,50 @@ ssize_t bt_gatt_attr_write_ccc(struct bt_conn *conn,
 	return len;
 }
 
+ssize_t bt_gatt_attr_read_client_features(struct bt_conn *conn,
+					  const struct bt_gatt_attr *attr,
+					  void *buf, uint16_t len,
+					  uint16_t offset)
+{
+	struct gatt_conn *gc = gatt_conn_lookup(conn);
+	uint8_t features = gc ? gc->features : 0;
+
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, &features,
+				 sizeof(features));
+}
+
+ssize_t bt_gatt_attr_write_client_features(struct bt_conn *conn,
+					   const struct bt_gatt_attr *attr,
+					   const void *buf, uint16_t len,
+					   uint16_t offset, uint8_t flags)
+{
+	struct gatt_conn *gc = gatt_conn_lookup(conn);
+	const uint8_t *value = buf;
+
+	if (offset) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+
+	if (!len) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	if (!gc) {
+		return BT_GATT_ERR(BT_ATT_ERR_UNLIKELY);
+	}
+
+	/* Features cannot be disabled, and the unknown ones are ignored */
+	if ((gc->features & value[0]) != gc->features) {
+		return BT_GATT_ERR(BT_ATT_ERR_NOT_SUPPORTED);
+	}
+
+	gc->features |= value[0] & BT_GATT_CLIENT_FEAT_MULT_NOTIFY;
+
+	BT_DBG("conn %p features 0x%02x", conn, gc->features);
+
+	return len;
+}
+
 ssize_t bt_gatt_attr_read_cep(struct bt_conn *conn,
 			      const struct bt_gatt_attr *attr, void *buf,
 			      uint16_t len, uint16_t offset)
@@ -407,9 +582,6 @@ ssize_t bt_gatt_attr_read_cpf(struct bt_conn *conn,
 
 struct notify_data {
 	uint16_t type;
-	const struct bt_gatt_attr *attr;
-	const void *data;
-	uint16_t len;
 	struct bt_gatt_indicate_params *params;
 };
 
@@ -536,12 +708,7 @@ static uint8_t notify_cb(const struct bt_gatt_attr *attr, void *user_data)
 			continue;
 		}
 
-		if (data->type == BT_GATT_CCC_INDICATE) {
-			err = gatt_indicate(conn, data->params);
-		} else {
-			err = gatt_notify(conn, data->attr->handle, data->data,
-					 data->len);
-		}
+		err = gatt_indicate(conn, data->params);
 
 		bt_conn_unref(conn);
 
@@ -556,20 +723,199 @@ static uint8_t notify_cb(const struct bt_gatt_attr *attr, void *user_data)
 int bt_gatt_notify(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 		   const void *data, uint16_t len)
 {
-	struct notify_data nfy;
+	struct bt_gatt_notify_value value;
 
-	__ASSERT(attr && attr->handler, "invalid parameters\n");
+	__ASSERT(attr && attr->handle, "invalid parameters\n");
 
 	if (conn) {
 		return gatt_notify(conn, attr->handle, data, len);
 	}
 
-	nfy.attr = attr;
-	nfy.type = BT_GATT_CCC_NOTIFY;
-	nfy.data = data;
-	nfy.len = len;
+	value.attr = attr;
+	value.data = data;
+	value.len = len;
+
+	return bt_gatt_notify_multiple(NULL, &value, 1);
+}
+
+static uint8_t find_ccc_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct _bt_gatt_ccc **ccc = user_data;
+
+	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CCC)) {
+		/* Stop if we reach the next characteristic */
+		if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_CHRC)) {
+			return BT_GATT_ITER_STOP;
+		}
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	/* Check attribute user_data must be of type struct _bt_gatt_ccc */
+	if (attr->write != bt_gatt_attr_write_ccc) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	*ccc = attr->user_data;
+
+	return BT_GATT_ITER_STOP;
+}
+
+static bool gatt_notify_enabled(struct gatt_conn *gc,
+				const struct bt_gatt_attr *attr)
+{
+	struct gatt_ccc_cache *entry = NULL;
+	struct _bt_gatt_ccc *ccc = NULL;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(gc->cache); i++) {
+		if (gc->cache[i].attr == attr) {
+			entry = &gc->cache[i];
+			goto done;
+		}
+	}
+
+	/* Replace the oldest entry */
+	entry = &gc->cache[gc->cache_next];
+	gc->cache_next = (gc->cache_next + 1) % ARRAY_SIZE(gc->cache);
+
+	entry->attr = attr;
+	entry->cfg = NULL;
+
+	bt_gatt_foreach_attr(attr->handle, 0xffff, find_ccc_cb, &ccc);
+	if (!ccc) {
+		goto done;
+	}
+
+	for (i = 0; i < ccc->cfg_len; i++) {
+		if (!bt_conn_addr_le_cmp(gc->conn, &ccc->cfg[i].peer)) {
+			entry->cfg = &ccc->cfg[i];
+			break;
+		}
+	}
+
+done:
+	return entry->cfg && (entry->cfg->value & BT_GATT_CCC_NOTIFY);
+}
 
-	bt_gatt_foreach_attr(attr->handle, 0xffff, notify_cb, &nfy);
+static int gatt_mult_notify_send(struct bt_conn *conn, struct net_buf *buf,
+				 const struct bt_gatt_notify_value *first,
+				 size_t count)
+{
+	/* A Multiple Handle Value Notification has at least two values */
+	if (count == 1) {
+		net_buf_unref(buf);
+		return gatt_notify(conn, first->attr->handle, first->data,
+				   first->len);
+	}
+
+	BT_DBG("conn %p %zu values", conn, count);
+
+	bt_l2cap_send(conn, BT_L2CAP_CID_ATT, buf);
+
+	return 0;
+}
+
+static int gatt_notify_values(struct bt_conn *conn, struct gatt_conn *gc,
+			      bool enabled_only,
+			      const struct bt_gatt_notify_value *values,
+			      size_t count)
+{
+	const struct bt_gatt_notify_value *first = NULL;
+	uint16_t mtu = bt_att_get_mtu(conn);
+	struct net_buf *buf = NULL;
+	size_t packed = 0;
+	bool mult;
+	int err;
+
+	mult = gc && (gc->features & BT_GATT_CLIENT_FEAT_MULT_NOTIFY);
+
+	for (; count; values++, count--) {
+		struct bt_att_mult_notify *nfy;
+
+		if (enabled_only && !gatt_notify_enabled(gc, values->attr)) {
+			continue;
+		}
+
+		/* Send the values too large to be packed on their own */
+		if (!mult || sizeof(*nfy) + values->len + 1 > mtu) {
+			err = gatt_notify(conn, values->attr->handle,
+					  values->data, values->len);
+			if (err) {
+				goto fail;
+			}
+
+			continue;
+		}
+
+		if (buf && buf->len + sizeof(*nfy) + values->len > mtu) {
+			err = gatt_mult_notify_send(conn, buf, first, packed);
+			buf = NULL;
+			if (err) {
+				return err;
+			}
+		}
+
+		if (!buf) {
+			buf = bt_att_create_pdu(conn, BT_ATT_OP_MULT_NOTIFY,
+						sizeof(*nfy) + values->len);
+			if (!buf) {
+				BT_WARN("No buffer available to send "
+					"notification");
+				return -ENOMEM;
+			}
+
+			first = values;
+			packed = 0;
+		}
+
+		nfy = net_buf_add(buf, sizeof(*nfy));
+		nfy->handle = sys_cpu_to_le16(values->attr->handle);
+		nfy->len = sys_cpu_to_le16(values->len);
+
+		net_buf_add_mem(buf, values->data, values->len);
+		packed++;
+	}
+
+	if (buf) {
+		return gatt_mult_notify_send(conn, buf, first, packed);
+	}
+
+	return 0;
+
+fail:
+	if (buf) {
+		net_buf_unref(buf);
+	}
+
+	return err;
+}
+
+int bt_gatt_notify_multiple(struct bt_conn *conn,
+			    const struct bt_gatt_notify_value *values,
+			    size_t count)
+{
+	size_t i;
+	int err;
+
+	__ASSERT(values && count, "invalid parameters\n");
+
+	if (conn) {
+		return gatt_notify_values(conn, gatt_conn_lookup(conn), false,
+					  values, count);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(gatt_conns); i++) {
+		struct gatt_conn *gc = &gatt_conns[i];
+
+		if (!gc->conn || gc->conn->state != BT_CONN_CONNECTED) {
+			continue;
+		}
+
+		err = gatt_notify_values(gc->conn, gc, true, values, count);
+		if (err < 0) {
+			return err;
+		}
+	}
 
 	return 0;
 }
@@ -963,7 +1309,10 @@ static void read_included_uuid_cb(struct bt_conn *conn, uint8_t err,
 		return;
 	}
 next:
-	gatt_discover_next(conn, params->start_handle, params);
+	/* Continue after the include, not after the start of the range the
+	 * include was found in, which would find it again.
+	 */
+	gatt_discover_next(conn, params->_included.attr_handle, params);
 
 	return;
 }
@@ -1809,7 +2158,16 @@ static void add_subscriptions(struct bt_conn *conn)
 
 void bt_gatt_connected(struct bt_conn *conn)
 {
+	struct gatt_conn *gc;
+
 	BT_DBG("conn %p", conn);
+
+	gc = gatt_conn_lookup(NULL);
+	if (gc) {
+		memset(gc, 0, sizeof(*gc));
+		gc->conn = conn;
+	}
+
 	bt_gatt_foreach_attr(0x0001, 0xffff, connected_cb, conn);
 #if defined(CONFIG_BLUETOOTH_GATT_CLIENT)
 	add_subscriptions(conn);
@@ -1818,9 +2176,16 @@ void bt_gatt_connected(struct bt_conn *conn)
 
 void bt_gatt_disconnected(struct bt_conn *conn)
 {
+	struct gatt_conn *gc;
+
 	BT_DBG("conn %p", conn);
 	bt_gatt_foreach_attr(0x0001, 0xffff, disconnected_cb, conn);
 
+	gc = gatt_conn_lookup(conn);
+	if (gc) {
+		gc->conn = NULL;
+	}
+
 #if defined(CONFIG_BLUETOOTH_GATT_CLIENT)
 	remove_subscriptions(conn);
 #endif /* CONFIG_BLUETOOTH_GATT_CLIENT */
@@ -15,6 +15,7 @@
 #include <misc/byteorder.h>
 #include <misc/stack.h>
 #include <misc/__assert.h>
+#include <debug/tracing.h>
 #include <soc.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BLUETOOTH_DEBUG_HCI_CORE)
@@ -24,6 +25,7 @@
 #include <bluetooth/hci.h>
 #include <bluetooth/hci_driver.h>
 #include <bluetooth/storage.h>
+#include <bluetooth/uuid.h>
 
 #include "keys.h"
 #include "monitor.h"
@@ -43,6 +45,10 @@
 #if !defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
 static BT_STACK_NOINIT(rx_thread_stack, CONFIG_BLUETOOTH_RX_STACK_SIZE);
 #endif
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+static BT_STACK_NOINIT(rx_acl_thread_stack,
+		       CONFIG_BLUETOOTH_RX_ACL_STACK_SIZE);
+#endif
 static BT_STACK_NOINIT(tx_thread_stack, CONFIG_BLUETOOTH_HCI_TX_STACK_SIZE);
 
 static void init_work(struct k_work *work);
@@ -62,6 +68,9 @@ struct bt_dev bt_dev = {
 #if !defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
 	.rx_queue      = K_FIFO_INITIALIZER(bt_dev.rx_queue),
 #endif
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+	.rx_acl_queue  = K_FIFO_INITIALIZER(bt_dev.rx_acl_queue),
+#endif
 };
 
 static bt_ready_cb_t ready_cb;
@@ -72,7 +81,9 @@ static bt_le_scan_cb_t *scan_dev_found_cb;
 
 static uint8_t pub_key[64];
 static struct bt_pub_key_cb *pub_key_cb;
-static bt_dh_key_cb_t dh_key_cb;
+/* DH Key requests, the one given to the controller and the queued ones */
+static struct bt_dh_key_req *dh_key_req;
+static sys_slist_t dh_key_reqs;
 
 #if defined(CONFIG_BLUETOOTH_BREDR)
 static bt_br_discovery_cb_t *discovery_cb;
@@ -500,6 +511,8 @@ static void hci_num_completed_packets(struct net_buf *buf)
 
 		bt_conn_unref(conn);
 	}
+
+	bt_conn_pkts_completed();
 }
 
 static int hci_le_create_conn(const struct bt_conn *conn)
@@ -553,6 +566,10 @@ static void hci_disconn_complete(struct net_buf *buf)
 	/* Check stacks usage (no-ops if not enabled) */
 #if !defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
 	stack_analyze("rx stack", rx_thread_stack, sizeof(rx_thread_stack));
+#endif
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+	stack_analyze("rx acl stack", rx_acl_thread_stack,
+		      sizeof(rx_acl_thread_stack));
 #endif
 	stack_analyze("tx stack", tx_thread_stack,
 		      sizeof(tx_thread_stack));
@@ -2213,6 +2230,47 @@ done:
 }
 #endif /* CONFIG_BLUETOOTH_SMP */
 
+static int dh_key_send(struct bt_dh_key_req *req)
+{
+	struct bt_hci_cp_le_generate_dhkey *cp;
+	struct net_buf *buf;
+	int err;
+
+	buf = bt_hci_cmd_create(BT_HCI_OP_LE_GENERATE_DHKEY, sizeof(*cp));
+	if (!buf) {
+		return -ENOBUFS;
+	}
+
+	cp = net_buf_add(buf, sizeof(*cp));
+	memcpy(cp->key, req->remote_pk, sizeof(cp->key));
+
+	/* Set before sending, the command may complete meanwhile */
+	dh_key_req = req;
+
+	err = bt_hci_cmd_send_sync(BT_HCI_OP_LE_GENERATE_DHKEY, buf, NULL);
+	if (err) {
+		dh_key_req = NULL;
+	}
+
+	return err;
+}
+
+static void dh_key_send_next(void)
+{
+	struct bt_dh_key_req *req;
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&dh_key_reqs))) {
+		req = CONTAINER_OF(node, struct bt_dh_key_req, _node);
+
+		if (!dh_key_send(req)) {
+			return;
+		}
+
+		req->func(req, NULL);
+	}
+}
+
 static void le_pkey_complete(struct net_buf *buf)
 {
 	struct bt_hci_evt_le_p256_public_key_complete *evt = (void *)buf->data;
@@ -2235,12 +2293,16 @@ static void le_pkey_complete(struct net_buf *buf)
 static void le_dhkey_complete(struct net_buf *buf)
 {
 	struct bt_hci_evt_le_generate_dhkey_complete *evt = (void *)buf->data;
+	struct bt_dh_key_req *req = dh_key_req;
 
 	BT_DBG("status: 0x%x", evt->status);
 
-	if (dh_key_cb) {
-		dh_key_cb(evt->status ? NULL : evt->dhkey);
-		dh_key_cb = NULL;
+	dh_key_req = NULL;
+	dh_key_send_next();
+
+	/* NULL if the request was cancelled */
+	if (req) {
+		req->func(req, evt->status ? NULL : evt->dhkey);
 	}
 }
 
@@ -2536,6 +2598,190 @@ int bt_le_scan_update(bool fast_scan)
 	return 0;
 }
 
+#if defined(CONFIG_BLUETOOTH_SCAN_FILTER)
+/* Entries tried for an advertiser, starting from its hash */
+#if CONFIG_BLUETOOTH_SCAN_DUP_COUNT < 4
+#define SCAN_DUP_PROBES CONFIG_BLUETOOTH_SCAN_DUP_COUNT
+#else
+#define SCAN_DUP_PROBES 4
+#endif
+
+struct scan_dup {
+	bt_addr_le_t addr;
+	uint8_t evt_type;
+	bool used;
+	/* Uptime of the report last passed */
+	uint32_t time;
+};
+
+static struct bt_le_scan_filter scan_filter;
+static struct scan_dup scan_dups[CONFIG_BLUETOOTH_SCAN_DUP_COUNT];
+
+static bool scan_dup_check(const bt_addr_le_t *addr, uint8_t evt_type)
+{
+	uint32_t now = k_uptime_get_32();
+	struct scan_dup *dup, *victim = NULL;
+	uint32_t hash = evt_type;
+	int i;
+
+	for (i = 0; i < sizeof(addr->a.val); i++) {
+		hash = hash * 31 + addr->a.val[i];
+	}
+
+	for (i = 0; i < SCAN_DUP_PROBES; i++) {
+		dup = &scan_dups[(hash + i) % ARRAY_SIZE(scan_dups)];
+
+		if (dup->used && dup->evt_type == evt_type &&
+		    !bt_addr_le_cmp(&dup->addr, addr)) {
+			if (now - dup->time < scan_filter.dup_window) {
+				return true;
+			}
+
+			dup->time = now;
+			return false;
+		}
+
+		/* Replace an unused entry, or else the oldest one */
+		if (!victim || !dup->used ||
+		    (victim->used && now - dup->time > now - victim->time)) {
+			victim = dup;
+		}
+	}
+
+	bt_addr_le_copy(&victim->addr, addr);
+	victim->evt_type = evt_type;
+	victim->used = true;
+	victim->time = now;
+
+	return false;
+}
+
+static bool scan_uuid_listed(const uint8_t *data, uint8_t len,
+			     uint8_t uuid_len)
+{
+	union {
+		struct bt_uuid uuid;
+		struct bt_uuid_16 u16;
+		struct bt_uuid_32 u32;
+		struct bt_uuid_128 u128;
+	} u;
+
+	for (; len >= uuid_len; data += uuid_len, len -= uuid_len) {
+		switch (uuid_len) {
+		case 2:
+			u.uuid.type = BT_UUID_TYPE_16;
+			u.u16.val = sys_get_le16(data);
+			break;
+		case 4:
+			u.uuid.type = BT_UUID_TYPE_32;
+			u.u32.val = sys_get_le32(data);
+			break;
+		default:
+			u.uuid.type = BT_UUID_TYPE_128;
+			memcpy(u.u128.val, data, 16);
+			break;
+		}
+
+		if (!bt_uuid_cmp(&u.uuid, scan_filter.uuid)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool scan_filter_data(const uint8_t *data, uint8_t len)
+{
+	bool uuid_found = !scan_filter.uuid;
+	bool mfg_found = !scan_filter.mfg_prefix;
+
+	while (len > 1 && (!uuid_found || !mfg_found)) {
+		uint8_t field_len = data[0];
+		const uint8_t *value = &data[2];
+		uint8_t value_len = field_len - 1;
+
+		if (!field_len || field_len >= len) {
+			break;
+		}
+
+		switch (data[1]) {
+		case BT_DATA_UUID16_SOME:
+		case BT_DATA_UUID16_ALL:
+			uuid_found |= scan_filter.uuid &&
+				      scan_uuid_listed(value, value_len, 2);
+			break;
+		case BT_DATA_UUID32_SOME:
+		case BT_DATA_UUID32_ALL:
+			uuid_found |= scan_filter.uuid &&
+				      scan_uuid_listed(value, value_len, 4);
+			break;
+		case BT_DATA_UUID128_SOME:
+		case BT_DATA_UUID128_ALL:
+			uuid_found |= scan_filter.uuid &&
+				      scan_uuid_listed(value, value_len, 16);
+			break;
+		case BT_DATA_MANUFACTURER_DATA:
+			mfg_found |= scan_filter.mfg_prefix &&
+				     value_len >= scan_filter.mfg_prefix_len &&
+				     !memcmp(value, scan_filter.mfg_prefix,
+					     scan_filter.mfg_prefix_len);
+			break;
+		default:
+			break;
+		}
+
+		data += field_len + 1;
+		len -= field_len + 1;
+	}
+
+	return uuid_found && mfg_found;
+}
+
+static bool scan_filter_match(const bt_addr_le_t *addr, uint8_t evt_type,
+			      const uint8_t *data, uint8_t len)
+{
+	if (scan_filter.addrs) {
+		size_t i;
+
+		for (i = 0; i < scan_filter.addr_count; i++) {
+			if (!bt_addr_le_cmp(&scan_filter.addrs[i], addr)) {
+				break;
+			}
+		}
+
+		if (i == scan_filter.addr_count) {
+			return false;
+		}
+	}
+
+	if (!scan_filter_data(data, len)) {
+		return false;
+	}
+
+	/* Last, so that only the reports passed are remembered */
+	if (scan_filter.dup_window && scan_dup_check(addr, evt_type)) {
+		return false;
+	}
+
+	return true;
+}
+
+int bt_le_scan_filter_set(const struct bt_le_scan_filter *filter)
+{
+	if (filter) {
+		scan_filter = *filter;
+	} else {
+		memset(&scan_filter, 0, sizeof(scan_filter));
+	}
+
+	memset(scan_dups, 0, sizeof(scan_dups));
+
+	return 0;
+}
+#else
+#define scan_filter_match(addr, evt_type, data, len) true
+#endif /* CONFIG_BLUETOOTH_SCAN_FILTER */
+
 static void le_adv_report(struct net_buf *buf)
 {
 	uint8_t num_reports = net_buf_pull_u8(buf);
@@ -2558,7 +2804,9 @@ static void le_adv_report(struct net_buf *buf)
 
 		addr = find_id_addr(&info->addr);
 
-		if (scan_dev_found_cb) {
+		if (scan_dev_found_cb &&
+		    scan_filter_match(addr, info->evt_type, info->data,
+				      info->length)) {
 			struct net_buf_simple_state state;
 
 			net_buf_simple_save(&buf->b, &state);
@@ -2766,6 +3014,11 @@ static void process_events(struct k_poll_event *ev, int count)
 		switch (ev->state) {
 		case K_POLL_STATE_SIGNALED:
 			break;
+		case K_POLL_STATE_SEM_AVAILABLE:
+			/* Controller buffers freed, schedule the connections
+			 * again.
+			 */
+			break;
 		case K_POLL_STATE_FIFO_DATA_AVAILABLE:
 			if (ev->tag == BT_EVENT_CMD_TX) {
 				send_cmd();
@@ -2788,8 +3041,8 @@ static void process_events(struct k_poll_event *ev, int count)
 }
 
 #if defined(CONFIG_BLUETOOTH_CONN)
-/* command FIFO + conn_change signal + MAX_CONN */
-#define EV_COUNT (2 + CONFIG_BLUETOOTH_MAX_CONN)
+/* command FIFO + conn_change signal + MAX_CONN + LE and BR/EDR ACL buffers */
+#define EV_COUNT (4 + CONFIG_BLUETOOTH_MAX_CONN)
 #else
 /* command FIFO */
 #define EV_COUNT 1
@@ -3572,13 +3825,36 @@ int bt_send(struct net_buf *buf)
 {
 	BT_DBG("buf %p len %u type %u", buf, buf->len, bt_buf_get_type(buf));
 
+	sys_trace_bt_send(buf, bt_buf_get_type(buf));
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	return bt_dev.drv->send(buf);
 }
 
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+/* The data received before a disconnection is to be processed while the
+ * connection still exists, so the event is queued behind it.
+ */
+static bool rx_acl_queue_evt(struct net_buf *buf)
+{
+	struct bt_hci_evt_hdr *hdr = (void *)buf->data;
+
+	if (hdr->evt != BT_HCI_EVT_DISCONN_COMPLETE ||
+	    k_fifo_is_empty(&bt_dev.rx_acl_queue)) {
+		return false;
+	}
+
+	net_buf_put(&bt_dev.rx_acl_queue, buf);
+
+	return true;
+}
+#endif /* CONFIG_BLUETOOTH_RX_ACL_THREAD */
+
 int bt_recv(struct net_buf *buf)
 {
+	sys_trace_bt_recv(buf, bt_buf_get_type(buf));
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	BT_DBG("buf %p len %u", buf, buf->len);
@@ -3592,7 +3868,9 @@ int bt_recv(struct net_buf *buf)
 	switch (bt_buf_get_type(buf)) {
 #if defined(CONFIG_BLUETOOTH_CONN)
 	case BT_BUF_ACL_IN:
-#if defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+		net_buf_put(&bt_dev.rx_acl_queue, buf);
+#elif defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
 		hci_acl(buf);
 #else
 		net_buf_put(&bt_dev.rx_queue, buf);
@@ -3600,6 +3878,11 @@ int bt_recv(struct net_buf *buf)
 		return 0;
 #endif /* BLUETOOTH_CONN */
 	case BT_BUF_EVT:
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+		if (rx_acl_queue_evt(buf)) {
+			return 0;
+		}
+#endif
 #if defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
 		hci_event(buf);
 #else
@@ -3617,6 +3900,8 @@ int bt_recv_prio(struct net_buf *buf)
 {
 	struct bt_hci_evt_hdr *hdr = (void *)buf->data;
 
+	sys_trace_bt_recv(buf, bt_buf_get_type(buf));
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	BT_ASSERT(bt_buf_get_type(buf) == BT_BUF_EVT);
@@ -3781,6 +4066,32 @@ static void hci_rx_thread(void)
 }
 #endif /* !CONFIG_BLUETOOTH_RECV_IS_RX_THREAD */
 
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+static void hci_rx_acl_thread(void)
+{
+	struct net_buf *buf;
+
+	BT_DBG("started");
+
+	while (1) {
+		buf = net_buf_get(&bt_dev.rx_acl_queue, K_FOREVER);
+
+		BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
+		       buf->len);
+
+		/* Disconnection events are queued behind the data */
+		if (bt_buf_get_type(buf) == BT_BUF_EVT) {
+			hci_event(buf);
+		} else {
+			hci_acl(buf);
+		}
+
+		/* Let the events queued meanwhile be processed first */
+		k_yield();
+	}
+}
+#endif /* CONFIG_BLUETOOTH_RX_ACL_THREAD */
+
 int bt_enable(bt_ready_cb_t cb)
 {
 	int err;
@@ -3808,6 +4119,13 @@ int bt_enable(bt_ready_cb_t cb)
 		       K_PRIO_COOP(7), 0, K_NO_WAIT);
 #endif
 
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+	/* ACL data RX thread, of lower priority than the events one */
+	k_thread_spawn(rx_acl_thread_stack, sizeof(rx_acl_thread_stack),
+		       (k_thread_entry_t)hci_rx_acl_thread, NULL, NULL, NULL,
+		       K_PRIO_COOP(8), 0, K_NO_WAIT);
+#endif
+
 	bt_hci_ecc_init();
 
 	err = bt_dev.drv->open();
@@ -4098,6 +4416,10 @@ int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
 
 	scan_dev_found_cb = cb;
 
+#if defined(CONFIG_BLUETOOTH_SCAN_FILTER)
+	memset(scan_dups, 0, sizeof(scan_dups));
+#endif
+
 	return 0;
 }
 
@@ -4466,13 +4788,9 @@ const uint8_t *bt_pub_key_get(void)
 	return NULL;
 }
 
-int bt_dh_key_gen(const uint8_t remote_pk[64], bt_dh_key_cb_t cb)
+int bt_dh_key_gen(struct bt_dh_key_req *req)
 {
-	struct bt_hci_cp_le_generate_dhkey *cp;
-	struct net_buf *buf;
-	int err;
-
-	if (dh_key_cb || atomic_test_bit(bt_dev.flags, BT_DEV_PUB_KEY_BUSY)) {
+	if (atomic_test_bit(bt_dev.flags, BT_DEV_PUB_KEY_BUSY)) {
 		return -EBUSY;
 	}
 
@@ -4480,24 +4798,22 @@ int bt_dh_key_gen(const uint8_t remote_pk[64], bt_dh_key_cb_t cb)
 		return -EADDRNOTAVAIL;
 	}
 
-	dh_key_cb = cb;
-
-	buf = bt_hci_cmd_create(BT_HCI_OP_LE_GENERATE_DHKEY, sizeof(*cp));
-	if (!buf) {
-		dh_key_cb = NULL;
-		return -ENOBUFS;
+	if (dh_key_req || !sys_slist_is_empty(&dh_key_reqs)) {
+		sys_slist_append(&dh_key_reqs, &req->_node);
+		return 0;
 	}
 
-	cp = net_buf_add(buf, sizeof(*cp));
-	memcpy(cp->key, remote_pk, sizeof(cp->key));
+	return dh_key_send(req);
+}
 
-	err = bt_hci_cmd_send_sync(BT_HCI_OP_LE_GENERATE_DHKEY, buf, NULL);
-	if (err) {
-		dh_key_cb = NULL;
-		return err;
+void bt_dh_key_cancel(struct bt_dh_key_req *req)
+{
+	if (dh_key_req == req) {
+		dh_key_req = NULL;
+		return;
 	}
 
-	return 0;
+	sys_slist_find_and_remove(&dh_key_reqs, &req->_node);
 }
 
 #if defined(CONFIG_BLUETOOTH_BREDR)
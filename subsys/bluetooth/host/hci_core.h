@@ -115,10 +115,17 @@ struct bt_dev {
 	struct net_buf		*sent_cmd;
 
 #if !defined(CONFIG_BLUETOOTH_RECV_IS_RX_THREAD)
-	/* Queue for incoming HCI events & ACL data */
+	/* Queue for incoming HCI events, and ACL data unless it has
+	 * its own thread.
+	 */
 	struct k_fifo		rx_queue;
 #endif
 
+#if defined(CONFIG_BLUETOOTH_RX_ACL_THREAD)
+	/* Queue for incoming ACL data, served after the HCI events */
+	struct k_fifo		rx_acl_queue;
+#endif
+
 	/* Queue for high priority HCI events which may unlock waiters
 	 * in other threads. Such events include Number of Completed
 	 * Packets, as well as the Command Complete/Status events.
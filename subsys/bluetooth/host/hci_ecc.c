@@ -24,6 +24,7 @@
 #include <bluetooth/conn.h>
 #include <bluetooth/hci.h>
 #include <bluetooth/hci_driver.h>
+#include <bluetooth/hci_ecc.h>
 
 #include "hci_ecc.h"
 #ifdef CONFIG_BLUETOOTH_HCI_RAW
@@ -56,6 +57,72 @@ static K_FIFO_DEFINE(ecc_queue);
 static int (*drv_send)(struct net_buf *buf);
 static uint32_t private_key[8];
 
+static int tc_gen_key(uint8_t public_key[64])
+{
+#if !defined(CONFIG_BLUETOOTH_USE_DEBUG_KEYS)
+	EccPoint pkey;
+
+	do {
+		uint32_t random[8];
+		int rc;
+
+		if (bt_rand((uint8_t *)random, sizeof(random))) {
+			BT_ERR("Failed to get random bytes for ECC keys");
+			return -EIO;
+		}
+
+		rc = ecc_make_key(&pkey, private_key, random);
+		if (rc == TC_CRYPTO_FAIL) {
+			BT_ERR("Failed to create ECC public/private pair");
+			return -EIO;
+		}
+
+	/* make sure generated key isn't debug key */
+	} while (memcmp(private_key, debug_private_key, 32) == 0);
+
+	memcpy(public_key, pkey.x, 32);
+	memcpy(&public_key[32], pkey.y, 32);
+#else
+	memcpy(public_key, debug_public_key, 64);
+	memcpy(private_key, debug_private_key, 32);
+#endif
+	return 0;
+}
+
+static int tc_dh_key(const uint8_t remote_pk[64], uint8_t dhkey[32])
+{
+	/* The following large stack variables are never needed at the same
+	 * time, so we save some stack space by putting them in a union.
+	 */
+	union {
+		EccPoint pk;
+		uint32_t dhkey[8];
+	} ecc;
+
+	memcpy(ecc.pk.x, remote_pk, 32);
+	memcpy(ecc.pk.y, &remote_pk[32], 32);
+
+	if (ecc_valid_public_key(&ecc.pk) < 0) {
+		return -EINVAL;
+	}
+
+	if (ecdh_shared_secret(ecc.dhkey, &ecc.pk, private_key) ==
+	    TC_CRYPTO_FAIL) {
+		return -EIO;
+	}
+
+	memcpy(dhkey, ecc.dhkey, sizeof(ecc.dhkey));
+
+	return 0;
+}
+
+static const struct bt_hci_ecc_backend tc_backend = {
+	.gen_key = tc_gen_key,
+	.dh_key = tc_dh_key,
+};
+
+static const struct bt_hci_ecc_backend *backend = &tc_backend;
+
 static void send_cmd_status(uint16_t opcode, uint8_t status)
 {
 	struct bt_hci_evt_cmd_status *evt;
@@ -79,40 +146,13 @@ static void send_cmd_status(uint16_t opcode, uint8_t status)
 	bt_recv_prio(buf);
 }
 
-static uint8_t generate_keys(EccPoint *pkey, uint32_t private_key[8])
-{
-#if !defined(CONFIG_BLUETOOTH_USE_DEBUG_KEYS)
-	do {
-		uint32_t random[8];
-		int rc;
-
-		if (bt_rand((uint8_t *)random, sizeof(random))) {
-			BT_ERR("Failed to get random bytes for ECC keys");
-			return BT_HCI_ERR_UNSPECIFIED;
-		}
-
-		rc = ecc_make_key(pkey, private_key, random);
-		if (rc == TC_CRYPTO_FAIL) {
-			BT_ERR("Failed to create ECC public/private pair");
-			return BT_HCI_ERR_UNSPECIFIED;
-		}
-
-	/* make sure generated key isn't debug key */
-	} while (memcmp(private_key, debug_private_key, 32) == 0);
-#else
-	memcpy(pkey, debug_public_key, 64);
-	memcpy(private_key, debug_private_key, 32);
-#endif
-	return 0;
-}
-
 static void emulate_le_p256_public_key_cmd(struct net_buf *buf)
 {
 	struct bt_hci_evt_le_p256_public_key_complete *evt;
 	struct bt_hci_evt_le_meta_event *meta;
 	struct bt_hci_evt_hdr *hdr;
-	uint8_t status;
-	EccPoint pkey;
+	uint8_t key[64];
+	int err;
 
 	BT_DBG("");
 
@@ -120,7 +160,7 @@ static void emulate_le_p256_public_key_cmd(struct net_buf *buf)
 
 	send_cmd_status(BT_HCI_OP_LE_P256_PUBLIC_KEY, 0);
 
-	status = generate_keys(&pkey, private_key);
+	err = backend->gen_key(key);
 
 	buf = bt_buf_get_rx(K_FOREVER);
 	bt_buf_set_type(buf, BT_BUF_EVT);
@@ -133,13 +173,13 @@ static void emulate_le_p256_public_key_cmd(struct net_buf *buf)
 	meta->subevent = BT_HCI_EVT_LE_P256_PUBLIC_KEY_COMPLETE;
 
 	evt = net_buf_add(buf, sizeof(*evt));
-	evt->status = status;
 
-	if (status) {
+	if (err) {
+		evt->status = BT_HCI_ERR_UNSPECIFIED;
 		memset(evt->key, 0, sizeof(evt->key));
 	} else {
-		memcpy(evt->key, pkey.x, 32);
-		memcpy(&evt->key[32], pkey.y, 32);
+		evt->status = 0;
+		memcpy(evt->key, key, sizeof(evt->key));
 	}
 
 	bt_recv(buf);
@@ -151,35 +191,25 @@ static void emulate_le_generate_dhkey(struct net_buf *buf)
 	struct bt_hci_cp_le_generate_dhkey *cmd;
 	struct bt_hci_evt_le_meta_event *meta;
 	struct bt_hci_evt_hdr *hdr;
-	int32_t ret;
-	/* The following large stack variables are never needed at the same
-	 * time, so we save some stack space by putting them in a union.
-	 */
-	union {
-		EccPoint pk;
-		uint32_t dhkey[8];
-	} ecc;
+	uint8_t remote_pk[64];
+	uint8_t dhkey[32];
+	int err;
 
-	if (buf->len < sizeof(*cmd)) {
+	if (buf->len < sizeof(struct bt_hci_cmd_hdr) + sizeof(*cmd)) {
 		send_cmd_status(BT_HCI_OP_LE_GENERATE_DHKEY,
 				BT_HCI_ERR_INVALID_PARAMS);
+		net_buf_unref(buf);
 		return;
 	}
 
 	cmd = (void *)buf->data  + sizeof(struct bt_hci_cmd_hdr);
-
-	memcpy(ecc.pk.x, cmd->key, 32);
-	memcpy(ecc.pk.y, &cmd->key[32], 32);
+	memcpy(remote_pk, cmd->key, sizeof(remote_pk));
 
 	send_cmd_status(BT_HCI_OP_LE_GENERATE_DHKEY, 0);
 
 	net_buf_unref(buf);
 
-	if (ecc_valid_public_key(&ecc.pk) < 0) {
-		ret = TC_CRYPTO_FAIL;
-	} else {
-		ret = ecdh_shared_secret(ecc.dhkey, &ecc.pk, private_key);
-	}
+	err = backend->dh_key(remote_pk, dhkey);
 
 	buf = bt_buf_get_rx(K_FOREVER);
 	bt_buf_set_type(buf, BT_BUF_EVT);
@@ -193,12 +223,12 @@ static void emulate_le_generate_dhkey(struct net_buf *buf)
 
 	evt = net_buf_add(buf, sizeof(*evt));
 
-	if (ret == TC_CRYPTO_FAIL) {
+	if (err) {
 		evt->status = BT_HCI_ERR_UNSPECIFIED;
 		memset(evt->dhkey, 0, sizeof(evt->dhkey));
 	} else {
 		evt->status = 0;
-		memcpy(evt->dhkey, ecc.dhkey, sizeof(ecc.dhkey));
+		memcpy(evt->dhkey, dhkey, sizeof(evt->dhkey));
 	}
 
 	bt_recv(buf);
@@ -269,6 +299,11 @@ static int ecc_send(struct net_buf *buf)
 	return drv_send(buf);
 }
 
+void bt_hci_ecc_backend_register(const struct bt_hci_ecc_backend *ecc)
+{
+	backend = ecc;
+}
+
 void bt_hci_ecc_init(void)
 {
 	k_thread_spawn(ecc_thread_stack, sizeof(ecc_thread_stack),
@@ -23,6 +23,49 @@
 
 static struct bt_keys key_pool[CONFIG_BLUETOOTH_MAX_PAIRED];
 
+#if CONFIG_BLUETOOTH_RPA_MISS_CACHE > 0
+/* RPAs recently found to match none of the IRKs, oldest replaced first.
+ * Resolving one takes an AES encryption per IRK, which is too much for
+ * every advertising report of the devices not bonded.
+ */
+static bt_addr_t rpa_miss[CONFIG_BLUETOOTH_RPA_MISS_CACHE];
+static uint8_t rpa_miss_count;
+static uint8_t rpa_miss_next;
+
+static bool rpa_miss_find(const bt_addr_t *rpa)
+{
+	int i;
+
+	for (i = 0; i < rpa_miss_count; i++) {
+		if (!bt_addr_cmp(&rpa_miss[i], rpa)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void rpa_miss_add(const bt_addr_t *rpa)
+{
+	bt_addr_copy(&rpa_miss[rpa_miss_next], rpa);
+
+	rpa_miss_next = (rpa_miss_next + 1) % ARRAY_SIZE(rpa_miss);
+	if (rpa_miss_count < ARRAY_SIZE(rpa_miss)) {
+		rpa_miss_count++;
+	}
+}
+
+static void rpa_miss_clear(void)
+{
+	rpa_miss_count = 0;
+	rpa_miss_next = 0;
+}
+#else
+#define rpa_miss_find(rpa) false
+#define rpa_miss_add(rpa)
+#define rpa_miss_clear()
+#endif /* CONFIG_BLUETOOTH_RPA_MISS_CACHE > 0 */
+
 struct bt_keys *bt_keys_get_addr(const bt_addr_le_t *addr)
 {
 	struct bt_keys *keys;
@@ -70,6 +113,11 @@ struct bt_keys *bt_keys_get_type(int type, const bt_addr_le_t *addr)
 
 	BT_DBG("type %d %s", type, bt_addr_le_str(addr));
 
+	/* The new IRK may resolve the RPAs matching none so far */
+	if (type & BT_KEYS_IRK) {
+		rpa_miss_clear();
+	}
+
 	keys = bt_keys_find(type, addr);
 	if (keys) {
 		return keys;
@@ -108,6 +156,11 @@ struct bt_keys *bt_keys_find_irk(const bt_addr_le_t *addr)
 		}
 	}
 
+	if (rpa_miss_find(&addr->a)) {
+		BT_DBG("No IRK for %s (cached)", bt_addr_le_str(addr));
+		return NULL;
+	}
+
 	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
 		if (!(key_pool[i].keys & BT_KEYS_IRK)) {
 			continue;
@@ -126,6 +179,8 @@ struct bt_keys *bt_keys_find_irk(const bt_addr_le_t *addr)
 
 	BT_DBG("No IRK for %s", bt_addr_le_str(addr));
 
+	rpa_miss_add(&addr->a);
+
 	return NULL;
 }
 
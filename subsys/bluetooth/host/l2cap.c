@@ -65,10 +65,18 @@ static struct bt_l2cap_server *servers;
 #endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
 
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
-/* Pool for outgoing LE data packets, MTU is 23 */
-NET_BUF_POOL_DEFINE(le_data_pool, CONFIG_BLUETOOTH_MAX_CONN,
-		    BT_L2CAP_BUF_SIZE(BT_L2CAP_MAX_LE_MPS),
+static void le_frag_destroy(struct net_buf *frag);
+
+/* Pool for the headers of outgoing LE data segments */
+NET_BUF_POOL_DEFINE(le_seg_pool, CONFIG_BLUETOOTH_L2CAP_TX_FRAG_COUNT,
+		    BT_L2CAP_BUF_SIZE(BT_L2CAP_SDU_HDR_LEN),
 		    BT_BUF_USER_DATA_MIN, NULL);
+
+/* Pool for the fragments referring to the data of the SDUs segmented, each
+ * one holding a reference to the SDU buffer the data belongs to.
+ */
+NET_BUF_POOL_DEFINE(le_frag_pool, CONFIG_BLUETOOTH_L2CAP_TX_FRAG_COUNT, 0,
+		    sizeof(struct net_buf *), le_frag_destroy);
 #endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
 
 /* L2CAP signalling channel specific context */
@@ -489,7 +497,7 @@ void bt_l2cap_send(struct bt_conn *conn, uint16_t cid, struct net_buf *buf)
 	struct bt_l2cap_hdr *hdr;
 
 	hdr = net_buf_push(buf, sizeof(*hdr));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+	hdr->len = sys_cpu_to_le16(net_buf_frags_len(buf) - sizeof(*hdr));
 	hdr->cid = sys_cpu_to_le16(cid);
 
 	bt_conn_send(conn, buf);
@@ -630,8 +638,12 @@ static void l2cap_chan_rx_init(struct bt_l2cap_le_chan *chan)
 	/* Use existing credits if defined */
 	if (!chan->rx.init_credits) {
 		if (chan->chan.ops->alloc_buf) {
-			/* Auto tune credits to receive a full packet */
-			chan->rx.init_credits = chan->rx.mtu /
+			/* Auto tune credits to receive a full packet, SDU
+			 * length included.
+			 */
+			chan->rx.init_credits = (chan->rx.mtu +
+						 BT_L2CAP_SDU_HDR_LEN +
+						 BT_L2CAP_MAX_LE_MPS - 1) /
 						BT_L2CAP_MAX_LE_MPS;
 		} else {
 			chan->rx.init_credits = L2CAP_LE_MAX_CREDITS;
@@ -1000,13 +1012,21 @@ static void le_disconn_rsp(struct bt_l2cap *l2cap, uint8_t ident,
 	bt_l2cap_chan_del(&chan->chan);
 }
 
+static void le_frag_destroy(struct net_buf *frag)
+{
+	struct net_buf *parent = *(struct net_buf **)net_buf_user_data(frag);
+
+	net_buf_destroy(frag);
+	net_buf_unref(parent);
+}
+
 static struct net_buf *l2cap_chan_create_seg(struct bt_l2cap_le_chan *ch,
 					     struct net_buf *buf,
 					     size_t sdu_hdr_len)
 {
-	struct net_buf *seg;
+	struct net_buf *seg, *frag;
 	uint16_t headroom;
-	uint16_t len;
+	uint16_t len, mtu;
 
 	/* Segment if data (+ data headroom) is bigger than MPS */
 	if (buf->len + sdu_hdr_len > ch->tx.mps) {
@@ -1035,20 +1055,36 @@ static struct net_buf *l2cap_chan_create_seg(struct bt_l2cap_le_chan *ch,
 	}
 
 segment:
-	seg = bt_l2cap_create_pdu(&le_data_pool, 0);
+	seg = bt_l2cap_create_pdu(&le_seg_pool, 0);
 
 	if (sdu_hdr_len) {
 		net_buf_add_le16(seg, net_buf_frags_len(buf));
 	}
 
 	/* Don't send more that TX MPS including SDU length */
-	len = min(net_buf_tailroom(seg), ch->tx.mps - sdu_hdr_len);
-	/* Limit if original buffer is smaller than the segment */
-	len = min(buf->len, len);
-	net_buf_add_mem(seg, buf->data, len);
+	len = min(buf->len, ch->tx.mps - sdu_hdr_len);
+
+	/* Fit in one ACL packet if the driver sends the fragments, so that
+	 * the data is not copied into ACL fragments either.
+	 */
+	mtu = ch->chan.conn ? bt_conn_get_frags_mtu(ch->chan.conn) : 0;
+	if (mtu > BT_L2CAP_HDR_SIZE + sdu_hdr_len) {
+		len = min(len, mtu - BT_L2CAP_HDR_SIZE - sdu_hdr_len);
+	}
+
+	/* Refer to the data of the SDU instead of copying it, which also
+	 * holds the SDU buffer until the segment is sent.
+	 */
+	frag = net_buf_alloc(&le_frag_pool, K_FOREVER);
+	*(struct net_buf **)net_buf_user_data(frag) = net_buf_ref(buf);
+	frag->flags |= NET_BUF_EXTERNAL_DATA;
+	frag->data = buf->data;
+	frag->len = len;
 	net_buf_pull(buf, len);
 
-	BT_DBG("ch %p seg %p len %u", ch, seg, seg->len);
+	net_buf_frag_add(seg, frag);
+
+	BT_DBG("ch %p seg %p len %u", ch, seg, seg->len + len);
 
 	return seg;
 }
@@ -1075,10 +1111,10 @@ static int l2cap_chan_le_send(struct bt_l2cap_le_chan *ch, struct net_buf *buf,
 		return -ECONNRESET;
 	}
 
-	BT_DBG("ch %p cid 0x%04x len %u credits %u", ch, ch->tx.cid,
-	       buf->len, k_sem_count_get(&ch->tx.credits));
+	len = net_buf_frags_len(buf);
 
-	len = buf->len;
+	BT_DBG("ch %p cid 0x%04x len %u credits %u", ch, ch->tx.cid,
+	       len, k_sem_count_get(&ch->tx.credits));
 
 	bt_l2cap_send(ch->chan.conn, ch->tx.cid, buf);
 
@@ -1138,6 +1174,10 @@ static int l2cap_chan_le_send_sdu(struct bt_l2cap_le_chan *ch,
 
 	net_buf_unref(buf);
 
+	if (ch->chan.ops->sent) {
+		ch->chan.ops->sent(&ch->chan);
+	}
+
 	return ret;
 }
 
@@ -1301,20 +1341,27 @@ static void l2cap_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 }
 
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
-static void l2cap_chan_update_credits(struct bt_l2cap_le_chan *chan)
+static void l2cap_chan_update_credits(struct bt_l2cap_le_chan *chan,
+				      bool sdu_done)
 {
 	struct net_buf *buf;
 	struct bt_l2cap_le_credits *ev;
 	uint16_t credits;
 
-	/* Only give more credits if it went bellow the defined threshold */
-	if (k_sem_count_get(&chan->rx.credits) >
+	/* Only give more credits if it went bellow the defined threshold, or
+	 * once a whole SDU is consumed, so that the peer does not wait for
+	 * them to send the next one.
+	 */
+	if (!sdu_done && k_sem_count_get(&chan->rx.credits) >
 	    L2CAP_LE_CREDITS_THRESHOLD(chan->rx.init_credits)) {
 		goto done;
 	}
 
 	/* Restore credits */
 	credits = chan->rx.init_credits - k_sem_count_get(&chan->rx.credits);
+	if (!credits) {
+		goto done;
+	}
 	l2cap_chan_rx_give_credits(chan, credits);
 
 	buf = l2cap_create_le_sig_pdu(BT_L2CAP_LE_CREDITS, get_ident(),
@@ -1388,9 +1435,12 @@ static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 		net_buf_unref(chan->_sdu);
 		chan->_sdu = NULL;
 		chan->_sdu_len = 0;
+
+		l2cap_chan_update_credits(chan, true);
+		return;
 	}
 
-	l2cap_chan_update_credits(chan);
+	l2cap_chan_update_credits(chan, false);
 }
 
 static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
@@ -1435,7 +1485,7 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 
 	chan->chan.ops->recv(&chan->chan, buf);
 
-	l2cap_chan_update_credits(chan);
+	l2cap_chan_update_credits(chan, false);
 }
 #endif /* CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL */
 
@@ -1382,14 +1382,15 @@ static void l2cap_br_conn_rsp(struct bt_l2cap_br *l2cap, uint8_t ident,
 int bt_l2cap_br_chan_send(struct bt_l2cap_chan *chan, struct net_buf *buf)
 {
 	struct bt_l2cap_br_chan *ch = BR_CHAN(chan);
+	uint16_t len = net_buf_frags_len(buf);
 
-	if (buf->len > ch->tx.mtu) {
+	if (len > ch->tx.mtu) {
 		return -EMSGSIZE;
 	}
 
 	bt_l2cap_send(ch->chan.conn, ch->tx.cid, buf);
 
-	return buf->len;
+	return len;
 }
 
 static void l2cap_br_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
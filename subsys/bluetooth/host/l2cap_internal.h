@@ -22,6 +22,7 @@ enum l2cap_conn_list_action {
 #define BT_L2CAP_CID_BR_SMP		0x0007
 
 #define BT_L2CAP_PSM_RFCOMM		0x0003
+#define BT_L2CAP_PSM_EATT		0x0027
 
 struct bt_l2cap_hdr {
 	uint16_t len;
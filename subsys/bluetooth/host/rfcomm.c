@@ -48,8 +48,12 @@
 
 static struct bt_rfcomm_server *servers;
 
-/* Pool for dummy buffers to wake up the tx threads */
-NET_BUF_POOL_DEFINE(dummy_pool, CONFIG_BLUETOOTH_MAX_CONN, 0, 0, NULL);
+/* Connected dlcs, their frames being sent by a single TX thread. The list
+ * is only changed by cooperative threads.
+ */
+static sys_slist_t tx_dlcs;
+static K_SEM_DEFINE(tx_sem, 0, 1);
+static BT_STACK_NOINIT(tx_stack, 256);
 
 #define RFCOMM_SESSION(_ch) CONTAINER_OF(_ch, \
 					 struct bt_rfcomm_session, br_chan.chan)
@@ -226,6 +230,8 @@ static void rfcomm_dlc_tx_give_credits(struct bt_rfcomm_dlc *dlc,
 
 	BT_DBG("dlc %p updated credits %u", dlc,
 	       k_sem_count_get(&dlc->tx_credits));
+
+	k_sem_give(&tx_sem);
 }
 
 static void rfcomm_dlc_destroy(struct bt_rfcomm_dlc *dlc)
@@ -236,7 +242,7 @@ static void rfcomm_dlc_destroy(struct bt_rfcomm_dlc *dlc)
 	dlc->state = BT_RFCOMM_STATE_IDLE;
 	dlc->session = NULL;
 
-	stack_analyze("dlc stack", dlc->stack, sizeof(dlc->stack));
+	stack_analyze("rfcomm tx stack", tx_stack, sizeof(tx_stack));
 
 	if (dlc->ops && dlc->ops->disconnected) {
 		dlc->ops->disconnected(dlc);
@@ -257,17 +263,8 @@ static void rfcomm_dlc_disconnect(struct bt_rfcomm_dlc *dlc)
 
 	switch (old_state) {
 	case BT_RFCOMM_STATE_CONNECTED:
-		/* Queue a dummy buffer to wake up and stop the
-		 * tx thread for states where it was running.
-		 */
-		net_buf_put(&dlc->tx_queue,
-			    net_buf_alloc(&dummy_pool, K_NO_WAIT));
-
-		/* There could be a writer waiting for credits so return a
-		 * dummy credit to wake it up.
-		 */
-		rfcomm_dlc_tx_give_credits(dlc, 1);
-		k_sem_give(&dlc->session->fc);
+		/* Wake up the TX thread to stop sending for the dlc */
+		k_sem_give(&tx_sem);
 		break;
 	default:
 		rfcomm_dlc_destroy(dlc);
@@ -304,11 +301,11 @@ static void rfcomm_session_disconnected(struct bt_rfcomm_session *session)
 struct net_buf *bt_rfcomm_create_pdu(struct net_buf_pool *pool)
 {
 	/* Length in RFCOMM header can be 2 bytes depending on length of user
-	 * data
+	 * data, and followed by the credits given back to the peer
 	 */
 	return bt_conn_create_pdu(pool,
 				  sizeof(struct bt_l2cap_hdr) +
-				  sizeof(struct bt_rfcomm_hdr) + 1);
+				  sizeof(struct bt_rfcomm_hdr) + 2);
 }
 
 static int rfcomm_send_sabm(struct bt_rfcomm_session *session, uint8_t dlci)
@@ -499,73 +496,94 @@ static int rfcomm_send_dm(struct bt_rfcomm_session *session, uint8_t dlci)
 	return bt_l2cap_chan_send(&session->br_chan.chan, buf);
 }
 
-static void rfcomm_check_fc(struct bt_rfcomm_dlc *dlc)
+static int rfcomm_send_credit(struct bt_rfcomm_dlc *dlc, uint8_t credits)
 {
-	BT_DBG("%p", dlc);
+	struct bt_rfcomm_hdr *hdr;
+	struct net_buf *buf;
+	uint8_t fcs, cr;
 
-	BT_DBG("Wait for credits or MSC FC %p", dlc);
-	/* Wait for credits or MSC FC */
-	k_sem_take(&dlc->tx_credits, K_FOREVER);
+	BT_DBG("Dlc %p credits %d", dlc, credits);
 
-	if (dlc->session->cfc == BT_RFCOMM_CFC_SUPPORTED) {
-		return;
+	buf = bt_l2cap_create_pdu(NULL, 0);
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	cr = BT_RFCOMM_UIH_CR(dlc->session->role);
+	hdr->address = BT_RFCOMM_SET_ADDR(dlc->dlci, cr);
+	hdr->control = BT_RFCOMM_SET_CTRL(BT_RFCOMM_UIH,
+					  BT_RFCOMM_PF_UIH_CREDIT);
+	hdr->length = BT_RFCOMM_SET_LEN_8(0);
+	net_buf_add_u8(buf, credits);
+	fcs = rfcomm_calc_fcs(BT_RFCOMM_FCS_LEN_UIH, buf->data);
+	net_buf_add_u8(buf, fcs);
+
+	return bt_l2cap_chan_send(&dlc->session->br_chan.chan, buf);
+}
+
+static bool rfcomm_dlc_rx_credits_low(struct bt_rfcomm_dlc *dlc)
+{
+	if (dlc->session->cfc == BT_RFCOMM_CFC_NOT_SUPPORTED) {
+		return false;
 	}
 
-	k_sem_take(&dlc->session->fc, K_FOREVER);
+	/* Only give more credits if it went below the defined threshold */
+	return dlc->rx_credit <= RFCOMM_CREDITS_THRESHOLD;
+}
 
-	/* Give the sems immediately so that sem will be available for all
-	 * the bufs in the queue. It will be blocked only once all the bufs
-	 * are sent (which will preempt this thread) and FCOFF / FC bit
-	 * with 1, is received.
+static bool rfcomm_dlc_tx_allowed(struct bt_rfcomm_dlc *dlc)
+{
+	if (dlc->session->cfc == BT_RFCOMM_CFC_SUPPORTED) {
+		return !k_sem_take(&dlc->tx_credits, K_NO_WAIT);
+	}
+
+	/* The sems are taken by the RX thread when MSC FC or FCOFF is
+	 * received, and given back when the peer accepts frames again.
 	 */
-	k_sem_give(&dlc->session->fc);
-	k_sem_give(&dlc->tx_credits);
+	return k_sem_count_get(&dlc->tx_credits) &&
+	       k_sem_count_get(&dlc->session->fc);
 }
 
-static void rfcomm_dlc_tx_thread(void *p1, void *p2, void *p3)
+static void rfcomm_dlc_frame_push(struct bt_rfcomm_dlc *dlc,
+				  struct net_buf *buf, uint8_t credits)
 {
-	struct bt_rfcomm_dlc *dlc = p1;
-	int32_t timeout = K_FOREVER;
-	struct net_buf *buf;
-
-	BT_DBG("Started for dlc %p", dlc);
-
-	while (dlc->state == BT_RFCOMM_STATE_CONNECTED ||
-	       dlc->state == BT_RFCOMM_STATE_USER_DISCONNECT) {
-		/* Get next packet for dlc */
-		BT_DBG("Wait for buf %p", dlc);
-		buf = net_buf_get(&dlc->tx_queue, timeout);
-		/* If its dummy buffer or non user disconnect then break */
-		if ((dlc->state != BT_RFCOMM_STATE_CONNECTED &&
-		     dlc->state != BT_RFCOMM_STATE_USER_DISCONNECT) ||
-		    !buf || !buf->len) {
-			if (buf) {
-				net_buf_unref(buf);
-			}
-			break;
-		}
+	struct bt_rfcomm_hdr *hdr;
+	uint16_t len = net_buf_frags_len(buf);
+	uint8_t fcs, cr;
 
-		rfcomm_check_fc(dlc);
-		if (dlc->state != BT_RFCOMM_STATE_CONNECTED &&
-		    dlc->state != BT_RFCOMM_STATE_USER_DISCONNECT) {
-			net_buf_unref(buf);
-			break;
-		}
+	/* The credits are not part of the length */
+	if (credits) {
+		net_buf_push_u8(buf, credits);
+	}
 
-		if (bt_l2cap_chan_send(&dlc->session->br_chan.chan, buf) < 0) {
-			/* This fails only if channel is disconnected */
-			dlc->state = BT_RFCOMM_STATE_DISCONNECTED;
-			net_buf_unref(buf);
-			break;
-		}
+	if (len > BT_RFCOMM_MAX_LEN_8) {
+		uint16_t *len_16;
 
-		if (dlc->state == BT_RFCOMM_STATE_USER_DISCONNECT) {
-			timeout = K_NO_WAIT;
-		}
+		/* Length is 2 byte */
+		hdr = net_buf_push(buf, sizeof(*hdr) + 1);
+		len_16 = (uint16_t *)&hdr->length;
+		*len_16 = BT_RFCOMM_SET_LEN_16(sys_cpu_to_le16(len));
+	} else {
+		hdr = net_buf_push(buf, sizeof(*hdr));
+		hdr->length = BT_RFCOMM_SET_LEN_8(len);
 	}
 
+	cr = BT_RFCOMM_UIH_CR(dlc->session->role);
+	hdr->address = BT_RFCOMM_SET_ADDR(dlc->dlci, cr);
+	hdr->control = BT_RFCOMM_SET_CTRL(BT_RFCOMM_UIH, credits ?
+					  BT_RFCOMM_PF_UIH_CREDIT :
+					  BT_RFCOMM_PF_UIH_NO_CREDIT);
+
+	fcs = rfcomm_calc_fcs(BT_RFCOMM_FCS_LEN_UIH, buf->data);
+	net_buf_add_u8(net_buf_frag_last(buf), fcs);
+}
+
+static void rfcomm_dlc_tx_stop(struct bt_rfcomm_dlc *dlc)
+{
+	struct net_buf *buf;
+
 	BT_DBG("dlc %p disconnected - cleaning up", dlc);
 
+	sys_slist_find_and_remove(&tx_dlcs, &dlc->_tx_node);
+
 	/* Give back any allocated buffers */
 	while ((buf = net_buf_get(&dlc->tx_queue, K_NO_WAIT))) {
 		net_buf_unref(buf);
@@ -581,8 +599,74 @@ static void rfcomm_dlc_tx_thread(void *p1, void *p2, void *p3)
 	} else {
 		rfcomm_dlc_destroy(dlc);
 	}
+}
+
+/* Send the next frame of the dlc, returns true if one was sent */
+static bool rfcomm_dlc_tx(struct bt_rfcomm_dlc *dlc)
+{
+	struct net_buf *buf;
+	uint8_t credits = 0;
+
+	if (dlc->state != BT_RFCOMM_STATE_CONNECTED &&
+	    dlc->state != BT_RFCOMM_STATE_USER_DISCONNECT) {
+		rfcomm_dlc_tx_stop(dlc);
+		return false;
+	}
+
+	/* The credits are given back along with the next frame if there is
+	 * one, in a frame of their own otherwise.
+	 */
+	if (rfcomm_dlc_rx_credits_low(dlc)) {
+		credits = RFCOMM_MAX_CREDITS - dlc->rx_credit;
+		dlc->rx_credit += credits;
+	}
+
+	if (k_fifo_is_empty(&dlc->tx_queue) || !rfcomm_dlc_tx_allowed(dlc)) {
+		if (credits) {
+			rfcomm_send_credit(dlc, credits);
+		}
+
+		/* User initiated disconnect once the queue is sent */
+		if (dlc->state == BT_RFCOMM_STATE_USER_DISCONNECT &&
+		    k_fifo_is_empty(&dlc->tx_queue)) {
+			rfcomm_dlc_tx_stop(dlc);
+		}
+
+		return false;
+	}
+
+	buf = net_buf_get(&dlc->tx_queue, K_NO_WAIT);
+	rfcomm_dlc_frame_push(dlc, buf, credits);
+
+	if (bt_l2cap_chan_send(&dlc->session->br_chan.chan, buf) < 0) {
+		/* This fails only if channel is disconnected */
+		dlc->state = BT_RFCOMM_STATE_DISCONNECTED;
+		net_buf_unref(buf);
+		rfcomm_dlc_tx_stop(dlc);
+		return false;
+	}
 
-	BT_DBG("dlc %p exiting", dlc);
+	return true;
+}
+
+static void rfcomm_tx_thread(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		struct bt_rfcomm_dlc *dlc, *next;
+		bool sent;
+
+		k_sem_take(&tx_sem, K_FOREVER);
+
+		/* A frame per dlc at a time, until none can be sent */
+		do {
+			sent = false;
+
+			SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tx_dlcs, dlc, next,
+							  _tx_node) {
+				sent |= rfcomm_dlc_tx(dlc);
+			}
+		} while (sent);
+	}
 }
 
 static int rfcomm_send_ua(struct bt_rfcomm_session *session, uint8_t dlci)
@@ -745,8 +829,7 @@ static void rfcomm_dlc_connected(struct bt_rfcomm_dlc *dlc)
 	k_delayed_work_cancel(&dlc->rtx_work);
 
 	k_fifo_init(&dlc->tx_queue);
-	k_thread_spawn(dlc->stack, sizeof(dlc->stack), rfcomm_dlc_tx_thread,
-		       dlc, NULL, NULL, K_PRIO_COOP(7), 0, K_NO_WAIT);
+	sys_slist_append(&tx_dlcs, &dlc->_tx_node);
 
 	if (dlc->ops && dlc->ops->connected) {
 		dlc->ops->connected(dlc);
@@ -813,16 +896,8 @@ static int rfcomm_dlc_close(struct bt_rfcomm_dlc *dlc)
 	case BT_RFCOMM_STATE_CONNECTED:
 		dlc->state = BT_RFCOMM_STATE_DISCONNECTING;
 
-		/* Queue a dummy buffer to wake up and stop the
-		 * tx thread.
-		 */
-		net_buf_put(&dlc->tx_queue,
-			    net_buf_alloc(&dummy_pool, K_NO_WAIT));
-
-		/* There could be a writer waiting for credits so return a
-		 * dummy credit to wake it up.
-		 */
-		rfcomm_dlc_tx_give_credits(dlc, 1);
+		/* Wake up the TX thread to stop sending for the dlc */
+		k_sem_give(&tx_sem);
 		break;
 	case BT_RFCOMM_STATE_DISCONNECTING:
 	case BT_RFCOMM_STATE_DISCONNECTED:
@@ -920,29 +995,6 @@ static int rfcomm_send_pn(struct bt_rfcomm_dlc *dlc, uint8_t cr)
 	return bt_l2cap_chan_send(&dlc->session->br_chan.chan, buf);
 }
 
-static int rfcomm_send_credit(struct bt_rfcomm_dlc *dlc, uint8_t credits)
-{
-	struct bt_rfcomm_hdr *hdr;
-	struct net_buf *buf;
-	uint8_t fcs, cr;
-
-	BT_DBG("Dlc %p credits %d", dlc, credits);
-
-	buf = bt_l2cap_create_pdu(NULL, 0);
-
-	hdr = net_buf_add(buf, sizeof(*hdr));
-	cr = BT_RFCOMM_UIH_CR(dlc->session->role);
-	hdr->address = BT_RFCOMM_SET_ADDR(dlc->dlci, cr);
-	hdr->control = BT_RFCOMM_SET_CTRL(BT_RFCOMM_UIH,
-					  BT_RFCOMM_PF_UIH_CREDIT);
-	hdr->length = BT_RFCOMM_SET_LEN_8(0);
-	net_buf_add_u8(buf, credits);
-	fcs = rfcomm_calc_fcs(BT_RFCOMM_FCS_LEN_UIH, buf->data);
-	net_buf_add_u8(buf, fcs);
-
-	return bt_l2cap_chan_send(&dlc->session->br_chan.chan, buf);
-}
-
 static int rfcomm_dlc_start(struct bt_rfcomm_dlc *dlc)
 {
 	enum security_result result;
@@ -1065,10 +1117,11 @@ static void rfcomm_handle_msc(struct bt_rfcomm_session *session,
 			 */
 			k_sem_take(&dlc->tx_credits, K_NO_WAIT);
 		} else {
-			/* Give the sem so that it will unblock the waiting dlc
-			 * thread in sem_take().
+			/* Give the sem so that the TX thread sends the frames
+			 * of the dlc again.
 			 */
 			k_sem_give(&dlc->tx_credits);
+			k_sem_give(&tx_sem);
 		}
 	}
 
@@ -1292,10 +1345,11 @@ static void rfcomm_handle_msg(struct bt_rfcomm_session *session,
 			break;
 		}
 
-		/* Give the sem so that it will unblock the waiting dlc threads
-		 * of this session in sem_take().
+		/* Give the sem so that the TX thread sends the frames of the
+		 * dlcs of this session again.
 		 */
 		k_sem_give(&session->fc);
+		k_sem_give(&tx_sem);
 		rfcomm_send_fcon(session, BT_RFCOMM_MSG_RESP_CR);
 		break;
 	case BT_RFCOMM_FCOFF:
@@ -1326,24 +1380,12 @@ static void rfcomm_handle_msg(struct bt_rfcomm_session *session,
 
 static void rfcomm_dlc_update_credits(struct bt_rfcomm_dlc *dlc)
 {
-	uint8_t credits;
-
-	if (dlc->session->cfc == BT_RFCOMM_CFC_NOT_SUPPORTED) {
-		return;
-	}
-
 	BT_DBG("dlc %p credits %u", dlc, dlc->rx_credit);
 
-	/* Only give more credits if it went below the defined threshold */
-	if (dlc->rx_credit > RFCOMM_CREDITS_THRESHOLD) {
-		return;
+	/* Credits are restored by the TX thread, with the next frame sent */
+	if (rfcomm_dlc_rx_credits_low(dlc)) {
+		k_sem_give(&tx_sem);
 	}
-
-	/* Restore credits */
-	credits = RFCOMM_MAX_CREDITS - dlc->rx_credit;
-	dlc->rx_credit += credits;
-
-	rfcomm_send_credit(dlc, credits);
 }
 
 static void rfcomm_handle_data(struct bt_rfcomm_session *session,
@@ -1392,8 +1434,7 @@ static void rfcomm_handle_data(struct bt_rfcomm_session *session,
 
 int bt_rfcomm_dlc_send(struct bt_rfcomm_dlc *dlc, struct net_buf *buf)
 {
-	struct bt_rfcomm_hdr *hdr;
-	uint8_t fcs, cr;
+	size_t len;
 
 	if (!buf) {
 		return -EINVAL;
@@ -1405,34 +1446,21 @@ int bt_rfcomm_dlc_send(struct bt_rfcomm_dlc *dlc, struct net_buf *buf)
 		return -ENOTCONN;
 	}
 
-	if (buf->len > dlc->mtu) {
+	len = net_buf_frags_len(buf);
+	if (len > dlc->mtu) {
 		return -EMSGSIZE;
 	}
 
-	if (buf->len > BT_RFCOMM_MAX_LEN_8) {
-		uint16_t *len;
-
-		/* Length is 2 byte */
-		hdr = net_buf_push(buf, sizeof(*hdr) + 1);
-		len = (uint16_t *)&hdr->length;
-		*len = BT_RFCOMM_SET_LEN_16(sys_cpu_to_le16(buf->len -
-							    sizeof(*hdr) + 1));
-	} else {
-		hdr = net_buf_push(buf, sizeof(*hdr));
-		hdr->length = BT_RFCOMM_SET_LEN_8(buf->len - sizeof(*hdr));
+	/* Room for the header, and the FCS added by the TX thread */
+	if (net_buf_headroom(buf) < sizeof(struct bt_rfcomm_hdr) + 2 ||
+	    !net_buf_tailroom(net_buf_frag_last(buf))) {
+		return -EMSGSIZE;
 	}
 
-	cr = BT_RFCOMM_UIH_CR(dlc->session->role);
-	hdr->address = BT_RFCOMM_SET_ADDR(dlc->dlci, cr);
-	hdr->control = BT_RFCOMM_SET_CTRL(BT_RFCOMM_UIH,
-					  BT_RFCOMM_PF_UIH_NO_CREDIT);
-
-	fcs = rfcomm_calc_fcs(BT_RFCOMM_FCS_LEN_UIH, buf->data);
-	net_buf_add_u8(buf, fcs);
-
 	net_buf_put(&dlc->tx_queue, buf);
+	k_sem_give(&tx_sem);
 
-	return buf->len;
+	return len;
 }
 
 static void rfcomm_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
@@ -1674,12 +1702,11 @@ int bt_rfcomm_dlc_disconnect(struct bt_rfcomm_dlc *dlc)
 	if (dlc->state == BT_RFCOMM_STATE_CONNECTED) {
 		/* This is to handle user initiated disconnect to send pending
 		 * bufs in the queue before disconnecting
-		 * Queue a dummy buffer (in case if queue is empty) to wake up
-		 * and stop the tx thread.
+		 * Wake up the TX thread (in case if queue is empty) to stop
+		 * sending for the dlc.
 		 */
 		dlc->state = BT_RFCOMM_STATE_USER_DISCONNECT;
-		net_buf_put(&dlc->tx_queue,
-			    net_buf_alloc(&dummy_pool, K_NO_WAIT));
+		k_sem_give(&tx_sem);
 
 		k_delayed_work_submit(&dlc->rtx_work, RFCOMM_DISC_TIMEOUT);
 
@@ -1715,4 +1742,7 @@ void bt_rfcomm_init(void)
 	};
 
 	bt_l2cap_br_server_register(&server);
+
+	k_thread_spawn(tx_stack, sizeof(tx_stack), rfcomm_tx_thread,
+		       NULL, NULL, NULL, K_PRIO_COOP(7), 0, K_NO_WAIT);
 }
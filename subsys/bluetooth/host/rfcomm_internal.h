@@ -129,12 +129,13 @@ struct bt_rfcomm_rpn {
 				     (mtu) <= BT_RFCOMM_SIG_MAX_MTU))
 
 /* Helper to calculate needed outgoing buffer size.
- * Length in rfcomm header can be two bytes depending on user data length.
+ * Length in rfcomm header can be two bytes depending on user data length,
+ * and followed by the credits given back to the peer.
  * One byte in the tail should be reserved for FCS.
  */
 #define BT_RFCOMM_BUF_SIZE(mtu) (CONFIG_BLUETOOTH_HCI_RESERVE + \
 				 BT_HCI_ACL_HDR_SIZE + BT_L2CAP_HDR_SIZE + \
-				 sizeof(struct bt_rfcomm_hdr) + 1 + (mtu) + \
+				 sizeof(struct bt_rfcomm_hdr) + 2 + (mtu) + \
 				 BT_RFCOMM_FCS_SIZE)
 
 #define BT_RFCOMM_GET_DLCI(addr)           (((addr) & 0xfc) >> 2)
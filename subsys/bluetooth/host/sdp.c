@@ -17,6 +17,9 @@
 #include <bluetooth/log.h>
 #include <bluetooth/sdp.h>
 
+#include "hci_core.h"
+#include "conn_internal.h"
+#include "keys.h"
 #include "l2cap_internal.h"
 #include "sdp_internal.h"
 
@@ -45,6 +48,31 @@ struct bt_sdp {
 static struct bt_sdp_record *db;
 static uint8_t num_services;
 
+/* Storage for any type of UUID */
+union sdp_uuid {
+	struct bt_uuid uuid;
+	struct bt_uuid_16 u16;
+	struct bt_uuid_32 u32;
+	struct bt_uuid_128 u128;
+};
+
+/* Number of UUIDs indexed, the records being searched one by one for the
+ * UUIDs of the requests if their UUIDs do not fit.
+ */
+#define SDP_UUID_INDEX_MAX (BT_SDP_MAX_SERVICES * 4)
+
+/* UUID of the registered records, with the bits of the records having it */
+struct sdp_uuid_index {
+	union sdp_uuid u;
+	uint16_t       recs;
+};
+
+BUILD_ASSERT(BT_SDP_MAX_SERVICES <= 16);
+
+static struct sdp_uuid_index uuid_index[SDP_UUID_INDEX_MAX];
+static uint8_t uuid_index_count;
+static bool uuid_index_full;
+
 static struct bt_sdp bt_sdp_pool[CONFIG_BLUETOOTH_MAX_CONN];
 
 /* Pool for outgoing SDP packets */
@@ -345,6 +373,128 @@ static uint32_t search_uuid(struct bt_sdp_data_elem *elem, struct bt_uuid *uuid,
 	return elem->total_size;
 }
 
+static void sdp_uuid_copy(union sdp_uuid *dst, const struct bt_uuid *src)
+{
+	switch (src->type) {
+	case BT_UUID_TYPE_16:
+		memcpy(&dst->u16, BT_UUID_16(src), sizeof(dst->u16));
+		break;
+	case BT_UUID_TYPE_32:
+		memcpy(&dst->u32, BT_UUID_32(src), sizeof(dst->u32));
+		break;
+	case BT_UUID_TYPE_128:
+		memcpy(&dst->u128, BT_UUID_128(src), sizeof(dst->u128));
+		break;
+	}
+}
+
+/* @brief Adds an UUID of a record to the UUID index
+ *
+ * @param uuid UUID found in the record
+ * @param rec_idx Index of the record
+ */
+static void uuid_index_add(const struct bt_uuid *uuid, uint8_t rec_idx)
+{
+	int i;
+
+	for (i = 0; i < uuid_index_count; i++) {
+		if (!bt_uuid_cmp(&uuid_index[i].u.uuid, uuid)) {
+			uuid_index[i].recs |= BIT(rec_idx);
+			return;
+		}
+	}
+
+	if (uuid_index_count == ARRAY_SIZE(uuid_index)) {
+		if (!uuid_index_full) {
+			BT_WARN("UUID index full, searching the records");
+			uuid_index_full = true;
+		}
+
+		return;
+	}
+
+	sdp_uuid_copy(&uuid_index[i].u, uuid);
+	uuid_index[i].recs = BIT(rec_idx);
+	uuid_index_count++;
+}
+
+/* @brief Adds the UUIDs of an attribute of a record to the UUID index
+ *
+ * Goes over the attribute as search_uuid() does, for the UUID index to have
+ * the records the search would have found.
+ *
+ * @param elem Attribute, or data element of a sequence within it
+ * @param rec_idx Index of the record
+ * @param nest_level Used to limit the extent of recursion into nested data
+ *  elements, to avoid potential stack overflows
+ */
+static void uuid_index_add_elem(struct bt_sdp_data_elem *elem, uint8_t rec_idx,
+				uint8_t nest_level)
+{
+	const uint8_t *cur_elem = elem->data;
+	uint32_t seq_size = elem->data_size;
+	union sdp_uuid u;
+
+	/* Limit recursion depth to avoid stack overflows */
+	if (nest_level == SDP_DATA_ELEM_NEST_LEVEL_MAX) {
+		return;
+	}
+
+	switch (elem->type & BT_SDP_TYPE_DESC_MASK) {
+	case BT_SDP_UUID_UNSPEC:
+		if (seq_size == 2) {
+			u.uuid.type = BT_UUID_TYPE_16;
+			u.u16.val = *((uint16_t *)cur_elem);
+		} else if (seq_size == 4) {
+			u.uuid.type = BT_UUID_TYPE_32;
+			u.u32.val = *((uint32_t *)cur_elem);
+		} else if (seq_size == 16) {
+			u.uuid.type = BT_UUID_TYPE_128;
+			memcpy(u.u128.val, cur_elem, seq_size);
+		} else {
+			BT_WARN("Invalid UUID size in local database");
+			return;
+		}
+
+		uuid_index_add(&u.uuid, rec_idx);
+		break;
+	case BT_SDP_SEQ_UNSPEC:
+	case BT_SDP_ALT_UNSPEC:
+		while (seq_size) {
+			struct bt_sdp_data_elem *seq_elem = (void *)cur_elem;
+
+			uuid_index_add_elem(seq_elem, rec_idx, nest_level + 1);
+
+			if (seq_elem->total_size > seq_size) {
+				break;
+			}
+
+			seq_size -= seq_elem->total_size;
+			cur_elem += sizeof(struct bt_sdp_data_elem);
+		}
+		break;
+	}
+}
+
+/* @brief Looks for an UUID in the UUID index
+ *
+ * @param uuid UUID to be looked for
+ *
+ * @return Bits of the records having the UUID
+ */
+static uint16_t uuid_index_lookup(const struct bt_uuid *uuid)
+{
+	int i;
+
+	for (i = 0; i < uuid_index_count; i++) {
+		if (!bt_uuid_cmp(&uuid_index[i].u.uuid, uuid)) {
+			return uuid_index[i].recs;
+		}
+	}
+
+	return 0;
+}
+
 /* @brief SDP service record iterator.
  *
  * Iterate over service records from a starting point.
@@ -407,7 +557,7 @@ static uint16_t find_services(struct net_buf *buf,
 	struct bt_sdp_data_elem data_elem;
 	struct bt_sdp_record *record;
 	uint32_t uuid_list_size;
-	uint16_t res;
+	uint16_t res, recs = BIT_MASK(num_services);
 	uint8_t att_idx, rec_idx = 0;
 	bool found;
 	union {
@@ -471,6 +621,12 @@ static uint16_t find_services(struct net_buf *buf,
 
 		uuid_list_size -= data_elem.total_size;
 
+		/* Keep the records having the UUID in the index */
+		if (!uuid_index_full) {
+			recs &= uuid_index_lookup(&u.uuid);
+			continue;
+		}
+
 		/* Go over the list of services, and look for a service which
 		 * doesn't have this UUID
 		 */
@@ -502,6 +658,12 @@ static uint16_t find_services(struct net_buf *buf,
 		}
 	}
 
+	for (rec_idx = 0; rec_idx < num_services; rec_idx++) {
+		if (!(recs & BIT(rec_idx))) {
+			matching_recs[rec_idx] = NULL;
+		}
+	}
+
 	return 0;
 }
 
@@ -648,6 +810,7 @@ void bt_sdp_init(void)
 int bt_sdp_register_service(struct bt_sdp_record *service)
 {
 	uint32_t handle = SDP_SERVICE_HANDLE_BASE;
+	int i;
 
 	if (!service) {
 		BT_ERR("No service record specified");
@@ -669,6 +832,10 @@ int bt_sdp_register_service(struct bt_sdp_record *service)
 	*((uint32_t *)(service->attrs[0].val.data)) = handle;
 	db = service;
 
+	for (i = 0; i < service->attr_count; i++) {
+		uuid_index_add_elem(&service->attrs[i].val, service->index, 1);
+	}
+
 	BT_DBG("Service registered at %u", handle);
 
 	return 0;
@@ -874,38 +1041,38 @@ enum uuid_state {
 	UUID_RESOLVED,
 };
 
-static void sdp_client_notify_result(struct bt_sdp_client *session,
-				     enum uuid_state state)
+static void sdp_notify_result(struct bt_conn *conn,
+			      const struct bt_sdp_discover_params *param,
+			      struct net_buf *rec_buf, enum uuid_state state)
 {
-	struct bt_conn *conn = session->chan.chan.conn;
 	struct bt_sdp_client_result result;
 	uint16_t rec_len;
 	uint8_t user_ret;
 
-	result.uuid = session->param->uuid;
+	result.uuid = param->uuid;
 
 	if (state == UUID_NOT_RESOLVED) {
 		result.resp_buf = NULL;
 		result.next_record_hint = false;
-		session->param->func(conn, &result);
+		param->func(conn, &result);
 		return;
 	}
 
-	while (session->rec_buf->len) {
+	while (rec_buf->len) {
 		struct net_buf_simple_state buf_state;
 
-		rec_len = get_record_len(session->rec_buf);
+		rec_len = get_record_len(rec_buf);
 		/* tell the user about multi record resolution */
-		if (session->rec_buf->len > rec_len) {
+		if (rec_buf->len > rec_len) {
 			result.next_record_hint = true;
 		} else {
 			result.next_record_hint = false;
 		}
 
 		/* save the original session buffer */
-		net_buf_simple_save(&session->rec_buf->b, &buf_state);
+		net_buf_simple_save(&rec_buf->b, &buf_state);
 		/* initialize internal result buffer instead of memcpy */
-		result.resp_buf = session->rec_buf;
+		result.resp_buf = rec_buf;
 		/*
 		 * Set user internal result buffer length as same as record
 		 * length to fake user. User will see the individual record
@@ -913,21 +1080,143 @@ static void sdp_client_notify_result(struct bt_sdp_client *session,
 		 */
 		result.resp_buf->len = rec_len;
 
-		user_ret = session->param->func(conn, &result);
+		user_ret = param->func(conn, &result);
 
 		/* restore original session buffer */
-		net_buf_simple_restore(&session->rec_buf->b, &buf_state);
+		net_buf_simple_restore(&rec_buf->b, &buf_state);
 		/*
 		 * sync session buffer data length with next record chunk not
 		 * send to user so far
 		 */
-		net_buf_pull(session->rec_buf, rec_len);
+		net_buf_pull(rec_buf, rec_len);
 		if (user_ret == BT_SDP_DISCOVER_UUID_STOP) {
 			break;
 		}
 	}
 }
 
+#if CONFIG_BLUETOOTH_SDP_CLIENT_CACHE > 0
+/* Records of an UUID cached for a device, bigger ones are not cached */
+#define SDP_CLIENT_CACHE_DATA_MAX 256
+
+struct sdp_client_cache {
+	bt_addr_t      addr;
+	union sdp_uuid u;
+	bool           valid;
+	/* Records of the UUID, none if it is not found on the device */
+	uint16_t       len;
+	uint8_t        data[SDP_CLIENT_CACHE_DATA_MAX];
+};
+
+static struct sdp_client_cache client_cache[CONFIG_BLUETOOTH_SDP_CLIENT_CACHE];
+static uint8_t client_cache_next;
+
+static struct sdp_client_cache *client_cache_find(const bt_addr_t *addr,
+						  const struct bt_uuid *uuid)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		struct sdp_client_cache *entry = &client_cache[i];
+
+		if (!entry->valid || bt_addr_cmp(&entry->addr, addr) ||
+		    bt_uuid_cmp(&entry->u.uuid, uuid)) {
+			continue;
+		}
+
+		/* The results are only kept while the device is bonded */
+		if (!bt_keys_find_link_key(addr)) {
+			entry->valid = false;
+			return NULL;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+/* Keeps the results of the UUID being resolved, for a bonded device */
+static void sdp_client_cache_store(struct bt_sdp_client *session,
+				   enum uuid_state state)
+{
+	const bt_addr_t *addr = &session->chan.chan.conn->br.dst;
+	const struct bt_uuid *uuid = session->param->uuid;
+	struct sdp_client_cache *entry;
+	uint16_t len = 0;
+
+	if (state == UUID_RESOLVED) {
+		len = session->rec_buf->len;
+	}
+
+	if (len > SDP_CLIENT_CACHE_DATA_MAX || !bt_keys_find_link_key(addr)) {
+		return;
+	}
+
+	entry = client_cache_find(addr, uuid);
+	if (!entry) {
+		entry = &client_cache[client_cache_next];
+		client_cache_next = (client_cache_next + 1) %
+				    ARRAY_SIZE(client_cache);
+	}
+
+	bt_addr_copy(&entry->addr, addr);
+	sdp_uuid_copy(&entry->u, uuid);
+	entry->len = len;
+	memcpy(entry->data, session->rec_buf->data, len);
+	entry->valid = true;
+}
+
+/* Gives the user the cached results of the UUID, returns false if there
+ * are none and the UUID needs to be discovered.
+ */
+static bool sdp_client_cache_notify(struct bt_conn *conn,
+				    const struct bt_sdp_discover_params *param)
+{
+	struct sdp_client_cache *entry;
+	struct net_buf *buf;
+
+	entry = client_cache_find(&conn->br.dst, param->uuid);
+	if (!entry) {
+		return false;
+	}
+
+	BT_DBG("UUID 0x%s cached", bt_uuid_str(param->uuid));
+
+	if (!entry->len) {
+		sdp_notify_result(conn, param, NULL, UUID_NOT_RESOLVED);
+		return true;
+	}
+
+	buf = net_buf_alloc(param->pool, K_NO_WAIT);
+	if (!buf) {
+		return false;
+	}
+
+	if (net_buf_tailroom(buf) < entry->len) {
+		net_buf_unref(buf);
+		return false;
+	}
+
+	net_buf_add_mem(buf, entry->data, entry->len);
+	sdp_notify_result(conn, param, buf, UUID_RESOLVED);
+	net_buf_unref(buf);
+
+	return true;
+}
+#endif /* CONFIG_BLUETOOTH_SDP_CLIENT_CACHE > 0 */
+
+static void sdp_client_notify_result(struct bt_sdp_client *session,
+				     enum uuid_state state)
+{
+#if CONFIG_BLUETOOTH_SDP_CLIENT_CACHE > 0
+	sdp_client_cache_store(session, state);
+#endif
+
+	sdp_notify_result(session->chan.chan.conn, session->param,
+			  session->rec_buf, state);
+}
+
 static void sdp_client_receive(struct bt_l2cap_chan *chan, struct net_buf *buf)
 {
 	struct bt_sdp_client *session = SDP_CLIENT_CHAN(chan);
@@ -1159,6 +1448,12 @@ int bt_sdp_discover(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
+#if CONFIG_BLUETOOTH_SDP_CLIENT_CACHE > 0
+	if (sdp_client_cache_notify(conn, params)) {
+		return 0;
+	}
+#endif
+
 	session = sdp_client_get_session(conn);
 	if (!session) {
 		return -ENOMEM;
@@ -167,6 +167,9 @@ struct bt_smp {
 	/* Remote key distribution */
 	uint8_t			remote_dist;
 
+	/* Local DHKey calculation */
+	struct bt_dh_key_req	dhkey_req;
+
 	/* Delayed work for timeout handling */
 	struct k_delayed_work work;
 };
@@ -1433,6 +1436,7 @@ static void smp_reset(struct bt_smp *smp)
 	struct bt_conn *conn = smp->chan.chan.conn;
 
 	k_delayed_work_cancel(&smp->work);
+	bt_dh_key_cancel(&smp->dhkey_req);
 
 	smp->method = JUST_WORKS;
 	atomic_set(&smp->allowed_cmds, 0);
@@ -2701,22 +2705,14 @@ static uint8_t compute_and_check_and_send_slave_dhcheck(struct bt_smp *smp)
 }
 #endif /* CONFIG_BLUETOOTH_PERIPHERAL */
 
-static void bt_smp_dhkey_ready(const uint8_t *dhkey)
+static void bt_smp_dhkey_ready(struct bt_dh_key_req *req,
+			       const uint8_t *dhkey)
 {
-	struct bt_smp *smp = NULL;
-	int i;
+	struct bt_smp *smp = CONTAINER_OF(req, struct bt_smp, dhkey_req);
 
 	BT_DBG("%p", dhkey);
 
-	for (i = 0; i < ARRAY_SIZE(bt_smp_pool); i++) {
-		if (atomic_test_and_clear_bit(bt_smp_pool[i].flags,
-					      SMP_FLAG_DHKEY_PENDING)) {
-			smp = &bt_smp_pool[i];
-			break;
-		}
-	}
-
-	if (!smp) {
+	if (!atomic_test_and_clear_bit(smp->flags, SMP_FLAG_DHKEY_PENDING)) {
 		return;
 	}
 
@@ -3170,11 +3166,17 @@ static uint8_t smp_security_request(struct bt_smp *smp, struct net_buf *buf)
 
 static uint8_t generate_dhkey(struct bt_smp *smp)
 {
-	if (bt_dh_key_gen(smp->pkey, bt_smp_dhkey_ready)) {
+	smp->dhkey_req.func = bt_smp_dhkey_ready;
+	smp->dhkey_req.remote_pk = smp->pkey;
+
+	/* Set before, the DHKey may be ready before bt_dh_key_gen() returns */
+	atomic_set_bit(smp->flags, SMP_FLAG_DHKEY_PENDING);
+
+	if (bt_dh_key_gen(&smp->dhkey_req)) {
+		atomic_clear_bit(smp->flags, SMP_FLAG_DHKEY_PENDING);
 		return BT_SMP_ERR_UNSPECIFIED;
 	}
 
-	atomic_set_bit(smp->flags, SMP_FLAG_DHKEY_PENDING);
 	return 0;
 }
 
@@ -3502,6 +3504,7 @@ static void bt_smp_disconnected(struct bt_l2cap_chan *chan)
 	       CONTAINER_OF(chan, struct bt_l2cap_le_chan, chan)->tx.cid);
 
 	k_delayed_work_cancel(&smp->work);
+	bt_dh_key_cancel(&smp->dhkey_req);
 
 	if (keys) {
 		/*
@@ -78,8 +78,8 @@ static int storage_open(const bt_addr_le_t *addr, uint16_t key,
 	return fs_open(file, path);
 }
 
-static ssize_t storage_read(const bt_addr_le_t *addr, uint16_t key, void *data,
-			    size_t length)
+static ssize_t file_read(const bt_addr_le_t *addr, uint16_t key, void *data,
+			 size_t length)
 {
 	fs_file_t file;
 	ssize_t ret;
@@ -95,8 +95,8 @@ static ssize_t storage_read(const bt_addr_le_t *addr, uint16_t key, void *data,
 	return ret;
 }
 
-static ssize_t storage_write(const bt_addr_le_t *addr, uint16_t key,
-			     const void *data, size_t length)
+static ssize_t file_write(const bt_addr_le_t *addr, uint16_t key,
+			  const void *data, size_t length)
 {
 	fs_file_t file;
 	ssize_t ret;
@@ -112,6 +112,166 @@ static ssize_t storage_write(const bt_addr_le_t *addr, uint16_t key,
 	return ret;
 }
 
+#if CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE > 0
+/* Largest value kept in the cache, bigger ones are written at once */
+#define CACHE_VALUE_MAX        32
+
+/* Time the first cached write waits for the ones following it */
+#define CACHE_FLUSH_TIMEOUT    K_SECONDS(1)
+
+struct cache_entry {
+	bt_addr_le_t addr;
+	uint16_t key;
+	uint8_t pending:1;
+	uint8_t local:1;
+	uint8_t len;
+	uint8_t data[CACHE_VALUE_MAX];
+};
+
+static struct cache_entry cache[CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE];
+static bool cache_flush_scheduled;
+static struct k_delayed_work cache_work;
+static K_MUTEX_DEFINE(cache_lock);
+
+static bool cache_addr_match(struct cache_entry *entry,
+			     const bt_addr_le_t *addr)
+{
+	if (!addr) {
+		return entry->local;
+	}
+
+	return !entry->local && !bt_addr_le_cmp(&entry->addr, addr);
+}
+
+static struct cache_entry *cache_find(const bt_addr_le_t *addr, uint16_t key)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].pending && cache[i].key == key &&
+		    cache_addr_match(&cache[i], addr)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Called with cache_lock held */
+static void cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		struct cache_entry *entry = &cache[i];
+
+		if (!entry->pending) {
+			continue;
+		}
+
+		if (file_write(entry->local ? NULL : &entry->addr, entry->key,
+			       entry->data, entry->len) < 0) {
+			BT_ERR("Unable to write key 0x%04x", entry->key);
+		}
+
+		entry->pending = 0;
+	}
+}
+
+static void cache_flush_work(struct k_work *work)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	cache_flush_scheduled = false;
+	cache_flush();
+
+	k_mutex_unlock(&cache_lock);
+}
+
+static ssize_t storage_read(const bt_addr_le_t *addr, uint16_t key, void *data,
+			    size_t length)
+{
+	struct cache_entry *entry;
+	ssize_t ret;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	entry = cache_find(addr, key);
+	if (entry) {
+		ret = min(length, entry->len);
+		memcpy(data, entry->data, ret);
+	} else {
+		ret = file_read(addr, key, data, length);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return ret;
+}
+
+static ssize_t storage_write(const bt_addr_le_t *addr, uint16_t key,
+			     const void *data, size_t length)
+{
+	struct cache_entry *entry;
+	int i;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	entry = cache_find(addr, key);
+
+	if (length > CACHE_VALUE_MAX) {
+		ssize_t ret;
+
+		/* The older value must not be flushed over this one */
+		if (entry) {
+			entry->pending = 0;
+		}
+
+		ret = file_write(addr, key, data, length);
+
+		k_mutex_unlock(&cache_lock);
+
+		return ret;
+	}
+
+	/* Coalesce with the value not flushed yet, or take a free entry,
+	 * flushing the cache if there is no free one.
+	 */
+	for (i = 0; !entry && i < ARRAY_SIZE(cache); i++) {
+		if (!cache[i].pending) {
+			entry = &cache[i];
+		}
+	}
+
+	if (!entry) {
+		cache_flush();
+		entry = &cache[0];
+	}
+
+	if (addr) {
+		bt_addr_le_copy(&entry->addr, addr);
+	}
+
+	entry->local = !addr;
+	entry->key = key;
+	entry->len = length;
+	memcpy(entry->data, data, length);
+	entry->pending = 1;
+
+	if (!cache_flush_scheduled) {
+		cache_flush_scheduled = true;
+		k_delayed_work_submit(&cache_work, CACHE_FLUSH_TIMEOUT);
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return length;
+}
+#else
+#define storage_read file_read
+#define storage_write file_write
+#endif /* CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE > 0 */
+
 static int unlink_recursive(char path[STORAGE_PATH_MAX])
 {
 	size_t path_len;
@@ -169,6 +329,21 @@ static int storage_clear(const bt_addr_le_t *addr)
 	char path[STORAGE_PATH_MAX];
 	int err;
 
+#if CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE > 0
+	int i;
+
+	/* Cached values of the cleared keys are not written anymore */
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!addr || cache_addr_match(&cache[i], addr)) {
+			cache[i].pending = 0;
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+#endif /* CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE > 0 */
+
 	if (addr) {
 #if MAX_FILE_NAME >= STORAGE_FILE_NAME_LEN
 		snprintk(path, STORAGE_PATH_MAX,
@@ -207,6 +382,10 @@ static int storage_init(struct device *unused)
 	struct fs_dirent entry;
 	int err;
 
+#if CONFIG_BLUETOOTH_INTERNAL_STORAGE_CACHE > 0
+	k_delayed_work_init(&cache_work, cache_flush_work);
+#endif
+
 	err = fs_stat(STORAGE_ROOT, &entry);
 	if (err) {
 		BT_WARN("%s doesn't seem to exist (err %d). Creating it.",
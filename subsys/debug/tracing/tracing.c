@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <debug/tracing.h>
+
+/* Called by the architecture context switch code, with interrupts locked,
+ * before the thread switched in becomes the current one
+ */
+void _sys_trace_thread_switch(void)
+{
+	sys_trace_event(SYS_TRACE_ID_THREAD_SWITCH, (uint32_t)_kernel.current,
+			(uint32_t)_kernel.ready_q.cache);
+}
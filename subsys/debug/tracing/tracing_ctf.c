@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Tracing backend streaming CTF events
+ *
+ * The events are streamed in the Common Trace Format described by the
+ * metadata file next to this one, for babeltrace or Trace Compass. Each
+ * event is its ID byte followed by the 32-bit timestamp and arguments,
+ * little endian.
+ *
+ * Over RTT, the events are written right away to their own up buffer,
+ * skipped when it is full. Over UART, they are queued and sent by a
+ * thread of the lowest priority, the events lost while the queue was full
+ * being counted by a SYS_TRACE_ID_DROPPED event.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <misc/byteorder.h>
+#include <debug/tracing.h>
+
+#define CTF_EVENT_SIZE 13
+
+/* arg0: number of events lost */
+#define SYS_TRACE_ID_DROPPED 0xff
+
+static inline void ctf_encode(uint8_t *event, uint8_t id, uint32_t timestamp,
+			      uint32_t arg0, uint32_t arg1)
+{
+	event[0] = id;
+	sys_put_le32(timestamp, &event[1]);
+	sys_put_le32(arg0, &event[5]);
+	sys_put_le32(arg1, &event[9]);
+}
+
+#ifdef CONFIG_TRACING_BACKEND_CTF_RTT
+#include <rtt/SEGGER_RTT.h>
+
+static uint8_t rtt_buf[CONFIG_TRACING_CTF_BUF_SIZE];
+static bool rtt_ready;
+
+void sys_trace_event(uint8_t id, uint32_t arg0, uint32_t arg1)
+{
+	uint8_t event[CTF_EVENT_SIZE];
+	unsigned int key;
+
+	if (!rtt_ready) {
+		return;
+	}
+
+	key = irq_lock();
+	ctf_encode(event, id, k_cycle_get_32(), arg0, arg1);
+	SEGGER_RTT_WriteNoLock(CONFIG_TRACING_CTF_RTT_CHANNEL, event,
+			       sizeof(event));
+	irq_unlock(key);
+}
+
+static int tracing_ctf_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	SEGGER_RTT_ConfigUpBuffer(CONFIG_TRACING_CTF_RTT_CHANNEL, "CTF",
+				  rtt_buf, sizeof(rtt_buf),
+				  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	rtt_ready = true;
+
+	return 0;
+}
+
+SYS_INIT(tracing_ctf_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_TRACING_BACKEND_CTF_RTT */
+
+#ifdef CONFIG_TRACING_BACKEND_CTF_UART
+#include <uart.h>
+#include <misc/ring_buffer.h>
+
+SYS_RING_BUF_DECLARE_SIZE(ctf_queue, CONFIG_TRACING_CTF_BUF_SIZE / 4);
+static uint32_t dropped;
+
+void sys_trace_event(uint8_t id, uint32_t arg0, uint32_t arg1)
+{
+	uint32_t data[3];
+	unsigned int key;
+
+	key = irq_lock();
+
+	data[0] = k_cycle_get_32();
+	data[1] = arg0;
+	data[2] = arg1;
+
+	if (sys_ring_buf_put(&ctf_queue, id, 0, data, ARRAY_SIZE(data))) {
+		dropped++;
+	}
+
+	irq_unlock(key);
+}
+
+static void ctf_uart_send(struct device *dev, const uint8_t *event)
+{
+	int i;
+
+	for (i = 0; i < CTF_EVENT_SIZE; i++) {
+		uart_poll_out(dev, event[i]);
+	}
+}
+
+static void ctf_uart_thread(void *p1, void *p2, void *p3)
+{
+	struct device *dev;
+	uint8_t event[CTF_EVENT_SIZE];
+	uint32_t data[3];
+	uint32_t lost;
+	uint16_t id;
+	uint8_t size, value;
+	unsigned int key;
+	int ret;
+
+	dev = device_get_binding(CONFIG_TRACING_CTF_UART_DEV_NAME);
+	if (!dev) {
+		return;
+	}
+
+	while (1) {
+		size = ARRAY_SIZE(data);
+
+		key = irq_lock();
+		ret = sys_ring_buf_get(&ctf_queue, &id, &value, data, &size);
+		lost = dropped;
+		dropped = 0;
+		irq_unlock(key);
+
+		if (lost) {
+			ctf_encode(event, SYS_TRACE_ID_DROPPED,
+				   k_cycle_get_32(), lost, 0);
+			ctf_uart_send(dev, event);
+		}
+
+		if (ret) {
+			k_sleep(CONFIG_TRACING_CTF_UART_FLUSH_MS);
+			continue;
+		}
+
+		ctf_encode(event, id, data[0], data[1], data[2]);
+		ctf_uart_send(dev, event);
+	}
+}
+
+K_THREAD_DEFINE(ctf_uart, CONFIG_TRACING_CTF_UART_STACK_SIZE,
+		ctf_uart_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+#endif /* CONFIG_TRACING_BACKEND_CTF_UART */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Tracing backend writing to the kernel event logger
+ *
+ * The events are logged with the ID SYS_TRACE_EVENT_LOGGER_ID(), and the
+ * timestamp and the two arguments as data.
+ */
+
+#include <kernel.h>
+#include <logging/kernel_event_logger.h>
+#include <debug/tracing.h>
+
+#define SYS_TRACE_EVENT_LOGGER_ID(id) (0x0100 | (id))
+
+extern void _sys_event_logger_put_non_preemptible(struct event_logger *logger,
+						  uint16_t event_id,
+						  uint32_t *event_data,
+						  uint8_t data_size);
+
+void sys_trace_event(uint8_t id, uint32_t arg0, uint32_t arg1)
+{
+	uint32_t data[3];
+	unsigned int key;
+
+	/* the event logger is not initialized yet */
+	if (!sys_k_event_logger.ring_buf.buf) {
+		return;
+	}
+
+	data[0] = _sys_k_get_time();
+	data[1] = arg0;
+	data[2] = arg1;
+
+	/* does not give the semaphore of the logger with k_sem_give(), which
+	 * is traced, and can be used from the context switch
+	 */
+	key = irq_lock();
+	_sys_event_logger_put_non_preemptible(&sys_k_event_logger,
+					      SYS_TRACE_EVENT_LOGGER_ID(id),
+					      data, ARRAY_SIZE(data));
+	irq_unlock(key);
+}
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <misc/__assert.h>
 #include <misc/util.h>
+#include "disk_cache.h"
 #include <disk_access.h>
 #include <errno.h>
 #include <device.h>
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <misc/__assert.h>
+#include "disk_cache.h"
 #include <disk_access.h>
 #include <errno.h>
 
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Sector cache in front of the disk access backend
+ *
+ * The file systems keep going back to the same few sectors, the FAT and
+ * the directory entries, and write them one small update at a time. These
+ * are kept in RAM, least recently used ones going out first, and written
+ * back to the backend only when evicted or when the disk is synced. Reads
+ * following the previous one read the next sectors ahead.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <disk_access.h>
+
+int disk_backend_status(void);
+int disk_backend_init(void);
+int disk_backend_read(uint8_t *data_buf, uint32_t start_sector,
+		      uint32_t num_sector);
+int disk_backend_write(const uint8_t *data_buf, uint32_t start_sector,
+		       uint32_t num_sector);
+int disk_backend_ioctl(uint8_t cmd, void *buff);
+
+struct disk_cache_entry {
+	uint32_t sector;
+	/* Last use, the smallest is evicted first */
+	uint32_t used;
+	bool valid;
+	/* Newer than the backend copy */
+	bool dirty;
+	uint8_t data[CONFIG_DISK_CACHE_SECTOR_SIZE];
+};
+
+static struct disk_cache_entry cache[CONFIG_DISK_CACHE_SECTORS];
+static K_MUTEX_DEFINE(cache_mutex);
+static uint32_t cache_used;
+static uint32_t sector_size;
+static uint32_t sector_count;
+/* Sector following the last one read, for read-ahead */
+static uint32_t read_next;
+static struct disk_cache_stats stats;
+
+static struct disk_cache_entry *cache_find(uint32_t sector)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].valid && cache[i].sector == sector) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int cache_write_back(struct disk_cache_entry *entry)
+{
+	int ret;
+
+	if (!entry->dirty) {
+		return 0;
+	}
+
+	ret = disk_backend_write(entry->data, entry->sector, 1);
+	if (ret) {
+		return ret;
+	}
+
+	entry->dirty = false;
+	stats.write_backs++;
+
+	return 0;
+}
+
+/* Gets an entry for a sector not cached, writing back the one evicted */
+static struct disk_cache_entry *cache_evict(void)
+{
+	struct disk_cache_entry *entry = &cache[0];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!cache[i].valid) {
+			return &cache[i];
+		}
+
+		if (cache[i].used < entry->used) {
+			entry = &cache[i];
+		}
+	}
+
+	if (cache_write_back(entry)) {
+		return NULL;
+	}
+
+	entry->valid = false;
+
+	return entry;
+}
+
+static void cache_touch(struct disk_cache_entry *entry)
+{
+	entry->used = ++cache_used;
+}
+
+static int cache_flush(void)
+{
+	int i, ret;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		ret = cache_write_back(&cache[i]);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Caches sectors read from the backend, the ones cached already are newer */
+static void cache_fill(const uint8_t *buff, uint32_t sector, uint32_t count)
+{
+	struct disk_cache_entry *entry;
+
+	for (; count; count--, sector++, buff += sector_size) {
+		if (cache_find(sector)) {
+			continue;
+		}
+
+		entry = cache_evict();
+		if (!entry) {
+			return;
+		}
+
+		memcpy(entry->data, buff, sector_size);
+		entry->sector = sector;
+		entry->valid = true;
+		cache_touch(entry);
+	}
+}
+
+static void cache_read_ahead(uint32_t sector)
+{
+	struct disk_cache_entry *entry;
+	int i;
+
+	for (i = 0; i < CONFIG_DISK_CACHE_READ_AHEAD; i++, sector++) {
+		if (sector >= sector_count) {
+			return;
+		}
+
+		if (cache_find(sector)) {
+			continue;
+		}
+
+		entry = cache_evict();
+		if (!entry || disk_backend_read(entry->data, sector, 1)) {
+			return;
+		}
+
+		entry->sector = sector;
+		entry->valid = true;
+		cache_touch(entry);
+		stats.read_ahead++;
+	}
+}
+
+int disk_access_status(void)
+{
+	return disk_backend_status();
+}
+
+int disk_access_init(void)
+{
+	int ret;
+
+	ret = disk_backend_init();
+	if (ret) {
+		return ret;
+	}
+
+	if (disk_backend_ioctl(DISK_IOCTL_GET_SECTOR_SIZE, &sector_size) ||
+	    disk_backend_ioctl(DISK_IOCTL_GET_SECTOR_COUNT, &sector_count)) {
+		return -EIO;
+	}
+
+	if (sector_size > CONFIG_DISK_CACHE_SECTOR_SIZE) {
+		return -ENOTSUP;
+	}
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	memset(cache, 0, sizeof(cache));
+	memset(&stats, 0, sizeof(stats));
+	cache_used = 0;
+	read_next = 0;
+	k_mutex_unlock(&cache_mutex);
+
+	return 0;
+}
+
+int disk_access_read(uint8_t *buff, uint32_t start_sector,
+		     uint32_t num_sector)
+{
+	struct disk_cache_entry *entry;
+	uint32_t end = start_sector + num_sector;
+	uint32_t sector, miss;
+	bool sequential;
+	int ret = 0;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	sequential = (start_sector == read_next);
+
+	for (sector = start_sector; sector < end; ) {
+		entry = cache_find(sector);
+		if (entry) {
+			memcpy(buff, entry->data, sector_size);
+			cache_touch(entry);
+			stats.hits++;
+			sector++;
+			buff += sector_size;
+			continue;
+		}
+
+		/* Sectors missed in a row are read at once */
+		for (miss = 1; sector + miss < end; miss++) {
+			if (cache_find(sector + miss)) {
+				break;
+			}
+		}
+
+		ret = disk_backend_read(buff, sector, miss);
+		if (ret) {
+			goto out;
+		}
+
+		stats.misses += miss;
+
+		/* Large reads would only flush the cache */
+		if (miss < ARRAY_SIZE(cache)) {
+			cache_fill(buff, sector, miss);
+		}
+
+		sector += miss;
+		buff += miss * sector_size;
+	}
+
+	if (sequential) {
+		cache_read_ahead(end);
+	}
+
+	read_next = end;
+
+out:
+	k_mutex_unlock(&cache_mutex);
+
+	return ret;
+}
+
+int disk_access_write(const uint8_t *buff, uint32_t start_sector,
+		      uint32_t num_sector)
+{
+	struct disk_cache_entry *entry;
+	uint32_t i;
+	int ret = 0;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	/* Large writes go through, updating the sectors cached */
+	if (num_sector >= ARRAY_SIZE(cache)) {
+		ret = disk_backend_write(buff, start_sector, num_sector);
+		if (ret) {
+			goto out;
+		}
+
+		for (i = 0; i < num_sector; i++) {
+			entry = cache_find(start_sector + i);
+			if (entry) {
+				memcpy(entry->data, buff + i * sector_size,
+				       sector_size);
+				entry->dirty = false;
+			}
+		}
+
+		goto out;
+	}
+
+	for (i = 0; i < num_sector; i++, buff += sector_size) {
+		entry = cache_find(start_sector + i);
+		if (!entry) {
+			entry = cache_evict();
+			if (!entry) {
+				ret = -EIO;
+				goto out;
+			}
+
+			entry->sector = start_sector + i;
+			entry->valid = true;
+		}
+
+		memcpy(entry->data, buff, sector_size);
+		entry->dirty = true;
+		cache_touch(entry);
+	}
+
+out:
+	k_mutex_unlock(&cache_mutex);
+
+	return ret;
+}
+
+int disk_access_ioctl(uint8_t cmd, void *buff)
+{
+	int ret;
+
+	if (cmd == DISK_IOCTL_CTRL_SYNC) {
+		k_mutex_lock(&cache_mutex, K_FOREVER);
+		ret = cache_flush();
+		k_mutex_unlock(&cache_mutex);
+
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return disk_backend_ioctl(cmd, buff);
+}
+
+void disk_cache_stats_get(struct disk_cache_stats *cache_stats)
+{
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	*cache_stats = stats;
+	k_mutex_unlock(&cache_mutex);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Included by the storage backends before disk_access.h. With the sector
+ * cache enabled, the disk_access_*() calls go to the cache, which calls
+ * the backend through these names.
+ */
+
+#ifndef _DISK_CACHE_H_
+#define _DISK_CACHE_H_
+
+#ifdef CONFIG_DISK_CACHE
+#define disk_access_init	disk_backend_init
+#define disk_access_status	disk_backend_status
+#define disk_access_read	disk_backend_read
+#define disk_access_write	disk_backend_write
+#define disk_access_ioctl	disk_backend_ioctl
+#endif /* CONFIG_DISK_CACHE */
+
+#endif /* _DISK_CACHE_H_ */
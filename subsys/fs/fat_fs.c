@@ -13,7 +13,8 @@
 #include <fs.h>
 #include <misc/__assert.h>
 
-static FATFS fat_fs;	/* FatFs work area */
+/* Mount of the only volume */
+static struct fs_mount_t *fat_fs_mnt;
 
 static int translate_error(int error)
 {
@@ -54,28 +55,87 @@ static int translate_error(int error)
 	return -EIO;
 }
 
-int fs_open(fs_file_t *zfp, const char *file_name)
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+/* Written over the clusters allocated by f_expand() */
+static const uint8_t fat_zeros[_MIN_SS];
+
+/* Maps the clusters of the file while they are contiguous, for FatFs to
+ * find them without going through the FAT.
+ */
+static void fat_contig_map(fs_file_t *zfp)
+{
+	FIL *fp = &zfp->ff.fp;
+
+	zfp->ff.cltbl[0] = ARRAY_SIZE(zfp->ff.cltbl);
+	fp->cltbl = zfp->ff.cltbl;
+
+	if (f_lseek(fp, CREATE_LINKMAP) != FR_OK) {
+		fp->cltbl = NULL;
+	}
+}
+
+/* Allocates the clusters of an empty file in one run */
+static FRESULT fat_contig_expand(fs_file_t *zfp, off_t length)
+{
+	FIL *fp = &zfp->ff.fp;
+	unsigned int bw;
+	FRESULT res;
+	UINT len;
+
+	res = f_expand(fp, length, 1);
+	if (res != FR_OK) {
+		return res;
+	}
+
+	fat_contig_map(zfp);
+
+	/* Whole sectors at a time, written straight to the disk */
+	while (f_tell(fp) < length) {
+		len = min(length - f_tell(fp), sizeof(fat_zeros));
+
+		res = f_write(fp, fat_zeros, len, &bw);
+		if (res != FR_OK) {
+			return res;
+		}
+
+		if (bw < len) {
+			return FR_DISK_ERR;
+		}
+	}
+
+	return FR_OK;
+}
+#endif /* CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS */
+
+static int fatfs_open(const struct fs_mount_t *mp, fs_file_t *zfp,
+		      const char *file_name)
 {
 	FRESULT res;
 	uint8_t fs_mode;
 
 	fs_mode = FA_READ | FA_WRITE | FA_OPEN_ALWAYS;
 
-	res = f_open(&zfp->fp, file_name, fs_mode);
+	res = f_open(&zfp->ff.fp, file_name, fs_mode);
+
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+	if (res == FR_OK && f_size(&zfp->ff.fp)) {
+		fat_contig_map(zfp);
+	}
+#endif
 
 	return translate_error(res);
 }
 
-int fs_close(fs_file_t *zfp)
+static int fatfs_close(fs_file_t *zfp)
 {
 	FRESULT res;
 
-	res = f_close(&zfp->fp);
+	res = f_close(&zfp->ff.fp);
 
 	return translate_error(res);
 }
 
-int fs_unlink(const char *path)
+static int fatfs_unlink(const struct fs_mount_t *mp, const char *path)
 {
 	FRESULT res;
 
@@ -84,12 +144,12 @@ int fs_unlink(const char *path)
 	return translate_error(res);
 }
 
-ssize_t fs_read(fs_file_t *zfp, void *ptr, size_t size)
+static ssize_t fatfs_read(fs_file_t *zfp, void *ptr, size_t size)
 {
 	FRESULT res;
 	unsigned int br;
 
-	res = f_read(&zfp->fp, ptr, size, &br);
+	res = f_read(&zfp->ff.fp, ptr, size, &br);
 	if (res != FR_OK) {
 		return translate_error(res);
 	}
@@ -97,12 +157,19 @@ ssize_t fs_read(fs_file_t *zfp, void *ptr, size_t size)
 	return br;
 }
 
-ssize_t fs_write(fs_file_t *zfp, const void *ptr, size_t size)
+static ssize_t fatfs_write(fs_file_t *zfp, const void *ptr, size_t size)
 {
 	FRESULT res;
 	unsigned int bw;
 
-	res = f_write(&zfp->fp, ptr, size, &bw);
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+	/* The clusters appended are not in the map */
+	if (f_tell(&zfp->ff.fp) + size > f_size(&zfp->ff.fp)) {
+		zfp->ff.fp.cltbl = NULL;
+	}
+#endif
+
+	res = f_write(&zfp->ff.fp, ptr, size, &bw);
 	if (res != FR_OK) {
 		return translate_error(res);
 	}
@@ -110,7 +177,7 @@ ssize_t fs_write(fs_file_t *zfp, const void *ptr, size_t size)
 	return bw;
 }
 
-int fs_seek(fs_file_t *zfp, off_t offset, int whence)
+static int fatfs_seek(fs_file_t *zfp, off_t offset, int whence)
 {
 	FRESULT res = FR_OK;
 	off_t pos;
@@ -120,46 +187,65 @@ int fs_seek(fs_file_t *zfp, off_t offset, int whence)
 		pos = offset;
 		break;
 	case FS_SEEK_CUR:
-		pos = f_tell(&zfp->fp) + offset;
+		pos = f_tell(&zfp->ff.fp) + offset;
 		break;
 	case FS_SEEK_END:
-		pos = f_size(&zfp->fp) + offset;
+		pos = f_size(&zfp->ff.fp) + offset;
 		break;
 	default:
 		return -EINVAL;
 	}
 
-	if ((pos < 0) || (pos > f_size(&zfp->fp))) {
+	if ((pos < 0) || (pos > f_size(&zfp->ff.fp))) {
 		return -EINVAL;
 	}
 
-	res = f_lseek(&zfp->fp, pos);
+	res = f_lseek(&zfp->ff.fp, pos);
 
 	return translate_error(res);
 }
 
-int fs_truncate(fs_file_t *zfp, off_t length)
+static off_t fatfs_tell(fs_file_t *zfp)
+{
+	return f_tell(&zfp->ff.fp);
+}
+
+static int fatfs_truncate(fs_file_t *zfp, off_t length)
 {
 	FRESULT res = FR_OK;
-	off_t cur_length = f_size(&zfp->fp);
+	off_t cur_length = f_size(&zfp->ff.fp);
+
+#ifdef CONFIG_FILE_SYSTEM_FAT_CONTIGUOUS
+	/* The map would not follow the clusters freed or appended */
+	zfp->ff.fp.cltbl = NULL;
+
+	if (!cur_length && length > 0) {
+		res = fat_contig_expand(zfp, length);
+
+		/* Allocated the usual way if no run of clusters is free */
+		if (res != FR_DENIED) {
+			return translate_error(res);
+		}
+	}
+#endif
 
 	/* f_lseek expands file if new position is larger than file size */
-	res = f_lseek(&zfp->fp, length);
+	res = f_lseek(&zfp->ff.fp, length);
 	if (res != FR_OK) {
 		return translate_error(res);
 	}
 
 	if (length < cur_length) {
-		res = f_truncate(&zfp->fp);
+		res = f_truncate(&zfp->ff.fp);
 	} else {
 		/*
 		 * Get actual length after expansion. This could be
 		 * less if there was not enough space in the volume
 		 * to expand to the requested length
 		 */
-		length = f_tell(&zfp->fp);
+		length = f_tell(&zfp->ff.fp);
 
-		res = f_lseek(&zfp->fp, cur_length);
+		res = f_lseek(&zfp->ff.fp, cur_length);
 		if (res != FR_OK) {
 			return translate_error(res);
 		}
@@ -174,7 +260,7 @@ int fs_truncate(fs_file_t *zfp, off_t length)
 		uint8_t c = 0;
 
 		for (int i = cur_length; i < length; i++) {
-			res = f_write(&zfp->fp, &c, 1, &bw);
+			res = f_write(&zfp->ff.fp, &c, 1, &bw);
 			if (res != FR_OK) {
 				break;
 			}
@@ -184,16 +270,16 @@ int fs_truncate(fs_file_t *zfp, off_t length)
 	return translate_error(res);
 }
 
-int fs_sync(fs_file_t *zfp)
+static int fatfs_sync(fs_file_t *zfp)
 {
 	FRESULT res = FR_OK;
 
-	res = f_sync(&zfp->fp);
+	res = f_sync(&zfp->ff.fp);
 
 	return translate_error(res);
 }
 
-int fs_mkdir(const char *path)
+static int fatfs_mkdir(const struct fs_mount_t *mp, const char *path)
 {
 	FRESULT res;
 
@@ -202,7 +288,8 @@ int fs_mkdir(const char *path)
 	return translate_error(res);
 }
 
-int fs_opendir(fs_dir_t *zdp, const char *path)
+static int fatfs_opendir(const struct fs_mount_t *mp, fs_dir_t *zdp,
+			 const char *path)
 {
 	FRESULT res;
 
@@ -211,7 +298,7 @@ int fs_opendir(fs_dir_t *zdp, const char *path)
 	return translate_error(res);
 }
 
-int fs_readdir(fs_dir_t *zdp, struct fs_dirent *entry)
+static int fatfs_readdir(fs_dir_t *zdp, struct fs_dirent *entry)
 {
 	FRESULT res;
 	FILINFO fno;
@@ -227,7 +314,7 @@ int fs_readdir(fs_dir_t *zdp, struct fs_dirent *entry)
 	return translate_error(res);
 }
 
-int fs_closedir(fs_dir_t *zdp)
+static int fatfs_closedir(fs_dir_t *zdp)
 {
 	FRESULT res;
 
@@ -236,7 +323,8 @@ int fs_closedir(fs_dir_t *zdp)
 	return translate_error(res);
 }
 
-int fs_stat(const char *path, struct fs_dirent *entry)
+static int fatfs_stat(const struct fs_mount_t *mp, const char *path,
+		      struct fs_dirent *entry)
 {
 	FRESULT res;
 	FILINFO fno;
@@ -252,7 +340,8 @@ int fs_stat(const char *path, struct fs_dirent *entry)
 	return translate_error(res);
 }
 
-int fs_statvfs(struct fs_statvfs *stat)
+static int fatfs_statvfs(const struct fs_mount_t *mp,
+			 struct fs_statvfs *stat)
 {
 	FATFS *fs;
 	FRESULT res;
@@ -273,13 +362,15 @@ int fs_statvfs(struct fs_statvfs *stat)
 	return translate_error(res);
 }
 
-static int fs_init(struct device *dev)
+static int fatfs_mount(struct fs_mount_t *mp)
 {
 	FRESULT res;
 
-	ARG_UNUSED(dev);
+	if (fat_fs_mnt) {
+		return -EBUSY;
+	}
 
-	res = f_mount(&fat_fs, "", 1);
+	res = f_mount(mp->fs_data, "", 1);
 
 	/* If no file system found then create one */
 	if (res == FR_NO_FILESYSTEM) {
@@ -287,13 +378,77 @@ static int fs_init(struct device *dev)
 
 		res = f_mkfs("", (FM_FAT | FM_SFD), 0, work, sizeof(work));
 		if (res == FR_OK) {
-			res = f_mount(&fat_fs, "", 1);
+			res = f_mount(mp->fs_data, "", 1);
 		}
 	}
 
-	__ASSERT((res == FR_OK), "FS init failed (%d)", translate_error(res));
+	if (res == FR_OK) {
+		fat_fs_mnt = mp;
+	}
+
+	return translate_error(res);
+}
+
+static int fatfs_unmount(struct fs_mount_t *mp)
+{
+	FRESULT res;
+
+	if (fat_fs_mnt != mp) {
+		return -EINVAL;
+	}
+
+	res = f_mount(NULL, "", 0);
+	if (res == FR_OK) {
+		fat_fs_mnt = NULL;
+	}
 
 	return translate_error(res);
 }
 
+const struct fs_file_system_t fat_fs_ops = {
+	.open = fatfs_open,
+	.read = fatfs_read,
+	.write = fatfs_write,
+	.lseek = fatfs_seek,
+	.tell = fatfs_tell,
+	.truncate = fatfs_truncate,
+	.sync = fatfs_sync,
+	.close = fatfs_close,
+	.opendir = fatfs_opendir,
+	.readdir = fatfs_readdir,
+	.closedir = fatfs_closedir,
+	.mount = fatfs_mount,
+	.unmount = fatfs_unmount,
+	.unlink = fatfs_unlink,
+	.mkdir = fatfs_mkdir,
+	.stat = fatfs_stat,
+	.statvfs = fatfs_statvfs,
+};
+
+static FATFS fat_fs;	/* FatFs work area */
+
+static struct fs_mount_t fat_fs_mnt_default = {
+	.mnt_point = CONFIG_FILE_SYSTEM_FAT_MOUNT_POINT,
+	.fs = &fat_fs_ops,
+	.fs_data = &fat_fs,
+};
+
+static int fs_init(struct device *dev)
+{
+	int ret;
+
+	ARG_UNUSED(dev);
+
+	/* Left to the application */
+	if (!fat_fs_mnt_default.mnt_point[0]) {
+		return 0;
+	}
+
+	ret = fs_mount(&fat_fs_mnt_default);
+
+	__ASSERT(!ret, "FS init failed (%d)", ret);
+
+	return ret;
+}
+
 SYS_INIT(fs_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
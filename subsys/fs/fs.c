@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Virtual file system
+ *
+ * The fs_* calls are passed to the file system mounted on the longest
+ * mount point the path starts with, along with the rest of the path. The
+ * open files and directories remember their mount, so the calls using them
+ * go straight to its file system. Small writes to the files can be
+ * gathered in a buffer of the application, see fs_setbuf(). The file
+ * operations can also be queued for a worker thread to do, completing
+ * with a callback or a poll signal.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <string.h>
+#include <errno.h>
+#include <fs.h>
+
+static sys_dlist_t fs_mnt_list = SYS_DLIST_STATIC_INIT(&fs_mnt_list);
+static K_MUTEX_DEFINE(fs_mnt_lock);
+
+/* Finds the mount of a path, and where the path goes on in it */
+static struct fs_mount_t *fs_mnt_find(const char *path, const char **rel)
+{
+	struct fs_mount_t *mp, *found = NULL;
+	size_t len;
+
+	if (!path) {
+		return NULL;
+	}
+
+	k_mutex_lock(&fs_mnt_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&fs_mnt_list, mp, node) {
+		len = mp->mountp_len;
+
+		if (found && len <= found->mountp_len) {
+			continue;
+		}
+
+		/* The root has the relative paths as well */
+		if (len == 1) {
+			found = mp;
+			continue;
+		}
+
+		if (!strncmp(path, mp->mnt_point, len) &&
+		    (path[len] == '/' || path[len] == '\0')) {
+			found = mp;
+		}
+	}
+
+	k_mutex_unlock(&fs_mnt_lock);
+
+	if (found && found->mountp_len > 1) {
+		path += found->mountp_len;
+		if (*path == '\0') {
+			path = "/";
+		}
+	}
+
+	*rel = path;
+
+	return found;
+}
+
+/* Passes the buffered writes to the file system */
+static int fs_flush(fs_file_t *zfp)
+{
+	ssize_t ret;
+
+	if (!zfp->buf_len) {
+		return 0;
+	}
+
+	ret = zfp->mp->fs->write(zfp, zfp->buf, zfp->buf_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* What did not fit is kept for the next try */
+	if (ret < zfp->buf_len) {
+		memmove(zfp->buf, zfp->buf + ret, zfp->buf_len - ret);
+		zfp->buf_len -= ret;
+		return -ENOSPC;
+	}
+
+	zfp->buf_len = 0;
+
+	return 0;
+}
+
+int fs_open(fs_file_t *zfp, const char *file_name)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(file_name, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	zfp->mp = mp;
+	zfp->buf = NULL;
+	zfp->buf_size = 0;
+	zfp->buf_len = 0;
+
+	return mp->fs->open(mp, zfp, rel);
+}
+
+int fs_close(fs_file_t *zfp)
+{
+	int ret, err;
+
+	err = fs_flush(zfp);
+
+	ret = zfp->mp->fs->close(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	zfp->mp = NULL;
+
+	return err;
+}
+
+ssize_t fs_read(fs_file_t *zfp, void *ptr, size_t size)
+{
+	int ret;
+
+	ret = fs_flush(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	return zfp->mp->fs->read(zfp, ptr, size);
+}
+
+ssize_t fs_write(fs_file_t *zfp, const void *ptr, size_t size)
+{
+	int ret;
+
+	if (!zfp->buf) {
+		return zfp->mp->fs->write(zfp, ptr, size);
+	}
+
+	if (zfp->buf_len + size > zfp->buf_size) {
+		ret = fs_flush(zfp);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	if (size >= zfp->buf_size) {
+		return zfp->mp->fs->write(zfp, ptr, size);
+	}
+
+	memcpy(zfp->buf + zfp->buf_len, ptr, size);
+	zfp->buf_len += size;
+
+	return size;
+}
+
+ssize_t fs_readv(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt)
+{
+	ssize_t ret, done = 0;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		ret = fs_read(zfp, iov[i].iov_base, iov[i].iov_len);
+		if (ret < 0) {
+			return done ? done : ret;
+		}
+
+		done += ret;
+
+		/* End of the file */
+		if (ret < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return done;
+}
+
+ssize_t fs_writev(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt)
+{
+	ssize_t ret, done = 0;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		ret = fs_write(zfp, iov[i].iov_base, iov[i].iov_len);
+		if (ret < 0) {
+			return done ? done : ret;
+		}
+
+		done += ret;
+
+		/* Disk full */
+		if (ret < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return done;
+}
+
+int fs_seek(fs_file_t *zfp, off_t offset, int whence)
+{
+	int ret;
+
+	ret = fs_flush(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	return zfp->mp->fs->lseek(zfp, offset, whence);
+}
+
+off_t fs_tell(fs_file_t *zfp)
+{
+	return zfp->mp->fs->tell(zfp) + zfp->buf_len;
+}
+
+int fs_truncate(fs_file_t *zfp, off_t length)
+{
+	int ret;
+
+	ret = fs_flush(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	return zfp->mp->fs->truncate(zfp, length);
+}
+
+int fs_sync(fs_file_t *zfp)
+{
+	int ret;
+
+	ret = fs_flush(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	return zfp->mp->fs->sync(zfp);
+}
+
+int fs_setbuf(fs_file_t *zfp, void *buf, size_t size)
+{
+	int ret;
+
+	ret = fs_flush(zfp);
+	if (ret) {
+		return ret;
+	}
+
+	zfp->buf = size ? buf : NULL;
+	zfp->buf_size = zfp->buf ? size : 0;
+
+	return 0;
+}
+
+int fs_opendir(fs_dir_t *zdp, const char *path)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(path, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	zdp->mp = mp;
+
+	return mp->fs->opendir(mp, zdp, rel);
+}
+
+int fs_readdir(fs_dir_t *zdp, struct fs_dirent *entry)
+{
+	return zdp->mp->fs->readdir(zdp, entry);
+}
+
+int fs_closedir(fs_dir_t *zdp)
+{
+	int ret;
+
+	ret = zdp->mp->fs->closedir(zdp);
+	if (ret) {
+		return ret;
+	}
+
+	zdp->mp = NULL;
+
+	return 0;
+}
+
+int fs_unlink(const char *path)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(path, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	return mp->fs->unlink(mp, rel);
+}
+
+int fs_mkdir(const char *path)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(path, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	return mp->fs->mkdir(mp, rel);
+}
+
+int fs_stat(const char *path, struct fs_dirent *entry)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(path, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	return mp->fs->stat(mp, rel, entry);
+}
+
+int fs_statvfs(const char *path, struct fs_statvfs *stat)
+{
+	const char *rel;
+	struct fs_mount_t *mp;
+
+	mp = fs_mnt_find(path, &rel);
+	if (!mp) {
+		return -ENOENT;
+	}
+
+	return mp->fs->statvfs(mp, stat);
+}
+
+int fs_mount(struct fs_mount_t *mp)
+{
+	struct fs_mount_t *itr;
+	size_t len;
+	int ret = 0;
+
+	if (!mp || !mp->fs || !mp->mnt_point || mp->mnt_point[0] != '/') {
+		return -EINVAL;
+	}
+
+	len = strlen(mp->mnt_point);
+
+	/* Only the root ends with a '/' */
+	if (len > 1 && mp->mnt_point[len - 1] == '/') {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&fs_mnt_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&fs_mnt_list, itr, node) {
+		if (itr == mp || (itr->mountp_len == len &&
+				  !strcmp(itr->mnt_point, mp->mnt_point))) {
+			ret = -EBUSY;
+			goto out;
+		}
+	}
+
+	ret = mp->fs->mount(mp);
+	if (ret) {
+		goto out;
+	}
+
+	mp->mountp_len = len;
+	sys_dlist_append(&fs_mnt_list, &mp->node);
+
+out:
+	k_mutex_unlock(&fs_mnt_lock);
+
+	return ret;
+}
+
+int fs_unmount(struct fs_mount_t *mp)
+{
+	struct fs_mount_t *itr;
+	int ret = -EINVAL;
+
+	if (!mp) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&fs_mnt_lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&fs_mnt_list, itr, node) {
+		if (itr == mp) {
+			ret = mp->fs->unmount(mp);
+			break;
+		}
+	}
+
+	if (!ret) {
+		sys_dlist_remove(&mp->node);
+	}
+
+	k_mutex_unlock(&fs_mnt_lock);
+
+	return ret;
+}
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+enum {
+	FS_ASYNC_READ,
+	FS_ASYNC_WRITE,
+	FS_ASYNC_SYNC,
+};
+
+static char __noinit __stack
+	fs_async_stack[CONFIG_FILE_SYSTEM_ASYNC_STACK_SIZE];
+static struct k_work_q fs_async_q;
+
+static void fs_async_handler(struct k_work *work)
+{
+	struct fs_async *async = CONTAINER_OF(work, struct fs_async, work);
+
+	switch (async->op) {
+	case FS_ASYNC_READ:
+		async->result = fs_readv(async->zfp, async->iov, async->iovcnt);
+		break;
+	case FS_ASYNC_WRITE:
+		async->result = fs_writev(async->zfp, async->iov,
+					  async->iovcnt);
+		break;
+	case FS_ASYNC_SYNC:
+		async->result = fs_sync(async->zfp);
+		break;
+	}
+
+	if (async->cb) {
+		async->cb(async, async->result);
+	}
+
+#ifdef CONFIG_POLL
+	if (async->signal) {
+		k_poll_signal(async->signal, async->result);
+	}
+#endif
+}
+
+static int fs_async_submit(fs_file_t *zfp, uint8_t op,
+			   const struct fs_iovec *iov, int iovcnt,
+			   struct fs_async *async)
+{
+	if (k_work_pending(&async->work)) {
+		return -EBUSY;
+	}
+
+	k_work_init(&async->work, fs_async_handler);
+	async->zfp = zfp;
+	async->op = op;
+	async->iov = iov;
+	async->iovcnt = iovcnt;
+
+	k_work_submit_to_queue(&fs_async_q, &async->work);
+
+	return 0;
+}
+
+int fs_read_async(fs_file_t *zfp, void *ptr, size_t size,
+		  struct fs_async *async)
+{
+	if (k_work_pending(&async->work)) {
+		return -EBUSY;
+	}
+
+	async->vec.iov_base = ptr;
+	async->vec.iov_len = size;
+
+	return fs_async_submit(zfp, FS_ASYNC_READ, &async->vec, 1, async);
+}
+
+int fs_write_async(fs_file_t *zfp, const void *ptr, size_t size,
+		   struct fs_async *async)
+{
+	if (k_work_pending(&async->work)) {
+		return -EBUSY;
+	}
+
+	async->vec.iov_base = (void *)ptr;
+	async->vec.iov_len = size;
+
+	return fs_async_submit(zfp, FS_ASYNC_WRITE, &async->vec, 1, async);
+}
+
+int fs_readv_async(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt,
+		   struct fs_async *async)
+{
+	return fs_async_submit(zfp, FS_ASYNC_READ, iov, iovcnt, async);
+}
+
+int fs_writev_async(fs_file_t *zfp, const struct fs_iovec *iov, int iovcnt,
+		    struct fs_async *async)
+{
+	return fs_async_submit(zfp, FS_ASYNC_WRITE, iov, iovcnt, async);
+}
+
+int fs_sync_async(fs_file_t *zfp, struct fs_async *async)
+{
+	return fs_async_submit(zfp, FS_ASYNC_SYNC, NULL, 0, async);
+}
+
+static int fs_async_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	/* A single thread, for the operations on a file to stay in order */
+	k_work_q_start(&fs_async_q, fs_async_stack, sizeof(fs_async_stack),
+		       CONFIG_FILE_SYSTEM_ASYNC_PRIORITY);
+
+	return 0;
+}
+
+SYS_INIT(fs_async_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
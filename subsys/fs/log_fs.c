@@ -0,0 +1,1566 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Log-structured file system on a flash device
+ *
+ * Everything is appended to a log of records going around the flash
+ * sectors: entries created, data written at an offset, files truncated and
+ * entries deleted. Writing to a file costs the flash writes of the data
+ * and of a record header, nothing is erased or written again in place.
+ * The file table is rebuilt from the log at boot, the records torn by a
+ * power failure failing their CRC.
+ *
+ * Once the sectors are used up, the oldest one has what it holds that is
+ * still current appended again to the log, then it is erased. The sectors
+ * are erased in turn whatever the files written, spreading the wear
+ * evenly. An erased sector is kept for this to always be possible.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <string.h>
+#include <errno.h>
+#include <flash.h>
+#include <fs.h>
+#include <misc/util.h>
+#include <misc/crc.h>
+#include <misc/__assert.h>
+
+#define SECTOR_SIZE	CONFIG_FILE_SYSTEM_LOG_SECTOR_SIZE
+#define SECTOR_COUNT	CONFIG_FILE_SYSTEM_LOG_SECTOR_COUNT
+#define SECTOR_MAGIC	0x474f4c5a
+
+/* Records are written in words, some flash can not write single bytes */
+#define WRITE_ALIGN	4
+
+enum {
+	/* off: type of the entry, data: name */
+	REC_INODE = 0x01,
+	/* off: offset in the file, data: data written there */
+	REC_DATA = 0x02,
+	/* off: new length of the file */
+	REC_TRUNC = 0x03,
+	REC_DELETE = 0x04,
+	/* off: position in the log of the sector collected */
+	REC_COLLECTED = 0x05,
+	REC_ERASED = 0xff,
+};
+
+struct sector_hdr {
+	uint32_t magic;
+	/* Position of the sector in the log */
+	uint32_t seq;
+	uint16_t crc;
+	uint16_t pad;
+} __packed;
+
+struct rec_hdr {
+	uint8_t type;
+	uint8_t pad;
+	uint16_t len;
+	uint32_t id;
+	uint32_t off;
+	/* Of the header fields above and of the data */
+	uint16_t crc;
+	uint16_t pad2;
+} __packed;
+
+#define REC_SIZE(len) \
+	(sizeof(struct rec_hdr) + ROUND_UP(len, WRITE_ALIGN))
+
+struct log_sector {
+	uint32_t seq;
+	/* End of the records */
+	uint32_t end;
+	bool used;
+	/* Only the head of the log takes more records */
+	bool full;
+};
+
+struct log_entry {
+	/* 0 if the entry is not used */
+	uint32_t id;
+	uint32_t size;
+	enum fs_dir_entry_type type;
+	char name[LOG_FS_MAX_FILE_NAME + 1];
+};
+
+static struct device *flash_dev;
+static struct log_sector sectors[SECTOR_COUNT];
+static struct log_entry entries[CONFIG_FILE_SYSTEM_LOG_MAX_FILES];
+static int head = -1;
+static uint32_t next_seq;
+static uint32_t next_id = 1;
+/* Set once the garbage collection went around the log without freeing
+ * a sector, until something is deleted or written over.
+ */
+static bool log_full;
+/* Entries truncated in the sector being collected */
+static bool gc_trunc[CONFIG_FILE_SYSTEM_LOG_MAX_FILES];
+/* Bytes of the data record being collected later records replaced */
+static uint8_t gc_covered[SECTOR_SIZE / 8];
+static uint8_t copy_buf[64];
+static K_MUTEX_DEFINE(log_lock);
+
+typedef int (*rec_cb_t)(off_t addr, struct rec_hdr *hdr, void *arg);
+
+static inline uint16_t crc16(uint16_t crc, const void *data, size_t len)
+{
+	return crc16_itu_t(crc, data, len);
+}
+
+static inline off_t sector_addr(int sector)
+{
+	return CONFIG_FILE_SYSTEM_LOG_FLASH_START + sector * SECTOR_SIZE;
+}
+
+static int flash_append(off_t addr, const void *data, size_t len)
+{
+	size_t aligned = ROUND_DOWN(len, WRITE_ALIGN);
+	uint8_t tail[WRITE_ALIGN];
+
+	if (aligned) {
+		flash_write_protection_set(flash_dev, false);
+		if (flash_write(flash_dev, addr, data, aligned)) {
+			return -EIO;
+		}
+	}
+
+	if (len > aligned) {
+		memset(tail, 0xff, sizeof(tail));
+		memcpy(tail, (const uint8_t *)data + aligned, len - aligned);
+
+		flash_write_protection_set(flash_dev, false);
+		if (flash_write(flash_dev, addr + aligned, tail,
+				sizeof(tail))) {
+			return -EIO;
+		}
+	}
+
+	return 0;
+}
+
+/* Checks the flash data against a CRC, or that it is erased if crc is
+ * NULL.
+ */
+static bool flash_check(off_t addr, size_t len, uint16_t *crc)
+{
+	size_t chunk;
+	int i;
+
+	for (; len; len -= chunk, addr += chunk) {
+		chunk = min(len, sizeof(copy_buf));
+		if (flash_read(flash_dev, addr, copy_buf, chunk)) {
+			return false;
+		}
+
+		if (crc) {
+			*crc = crc16(*crc, copy_buf, chunk);
+			continue;
+		}
+
+		for (i = 0; i < chunk; i++) {
+			if (copy_buf[i] != 0xff) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static uint16_t rec_hdr_crc(const struct rec_hdr *hdr)
+{
+	return crc16(0xffff, hdr, offsetof(struct rec_hdr, crc));
+}
+
+/* Gets the sector following prev in the log, the oldest one for -1 */
+static int sector_next(int prev)
+{
+	int i, next = -1;
+
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		if (!sectors[i].used ||
+		    (prev >= 0 && sectors[i].seq <= sectors[prev].seq)) {
+			continue;
+		}
+
+		if (next < 0 || sectors[i].seq < sectors[next].seq) {
+			next = i;
+		}
+	}
+
+	return next;
+}
+
+/* Goes over the records from off in sector to the head of the log, until
+ * the callback returns non-zero.
+ */
+static int log_walk(int sector, uint32_t off, rec_cb_t cb, void *arg)
+{
+	struct rec_hdr hdr;
+	off_t addr;
+	int ret;
+
+	for (; sector >= 0; sector = sector_next(sector)) {
+		for (; off < sectors[sector].end; off += REC_SIZE(hdr.len)) {
+			addr = sector_addr(sector) + off;
+			if (flash_read(flash_dev, addr, &hdr, sizeof(hdr))) {
+				return -EIO;
+			}
+
+			ret = cb(addr, &hdr, arg);
+			if (ret) {
+				return ret;
+			}
+		}
+
+		off = sizeof(struct sector_hdr);
+	}
+
+	return 0;
+}
+
+static int free_count(void)
+{
+	int i, count = 0;
+
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		if (!sectors[i].used) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/* Room left at the head, less the end of the sector kept for gc_done() */
+static uint32_t head_space(void)
+{
+	if (head < 0 || sectors[head].full ||
+	    SECTOR_SIZE - sectors[head].end < 2 * REC_SIZE(0)) {
+		return 0;
+	}
+
+	return SECTOR_SIZE - sectors[head].end - REC_SIZE(0);
+}
+
+static int sector_open(void)
+{
+	struct sector_hdr hdr;
+	int i, sector;
+
+	/* Taken in turn, for the spare sector not to stay the same */
+	for (i = 1; i <= SECTOR_COUNT; i++) {
+		sector = (head + i) % SECTOR_COUNT;
+		if (!sectors[sector].used) {
+			break;
+		}
+	}
+
+	if (i > SECTOR_COUNT) {
+		return -ENOSPC;
+	}
+
+	hdr.magic = SECTOR_MAGIC;
+	hdr.seq = next_seq;
+	hdr.crc = crc16(0xffff, &hdr, offsetof(struct sector_hdr, crc));
+	hdr.pad = 0xffff;
+
+	if (flash_append(sector_addr(sector), &hdr, sizeof(hdr))) {
+		return -EIO;
+	}
+
+	if (head >= 0) {
+		sectors[head].full = true;
+	}
+
+	sectors[sector].seq = next_seq++;
+	sectors[sector].end = sizeof(hdr);
+	sectors[sector].used = true;
+	sectors[sector].full = false;
+	head = sector;
+
+	return 0;
+}
+
+static int log_gc(void);
+
+/* Makes room for a record at the head of the log, the last erased sector
+ * being left to the garbage collection.
+ */
+static int log_reserve(size_t size, bool gc)
+{
+	int i, ret;
+
+	if (!flash_dev) {
+		return -ENODEV;
+	}
+
+	if (head_space() >= size) {
+		return 0;
+	}
+
+	for (i = 0; !gc && free_count() < 2; i++) {
+		if (log_full || i == SECTOR_COUNT) {
+			log_full = true;
+			return -ENOSPC;
+		}
+
+		ret = log_gc();
+		if (ret) {
+			return ret;
+		}
+
+		if (head_space() >= size) {
+			return 0;
+		}
+	}
+
+	return sector_open();
+}
+
+/* Accounts for a record written at the head, or for a failed write if
+ * ret is set, the space it took being lost until the sector is erased.
+ */
+static int log_commit(uint32_t len, int ret)
+{
+	if (ret) {
+		sectors[head].full = true;
+		return ret;
+	}
+
+	sectors[head].end += REC_SIZE(len);
+
+	return 0;
+}
+
+static int log_append(struct rec_hdr *hdr, const void *data, bool gc)
+{
+	off_t addr;
+	int ret;
+
+	ret = log_reserve(REC_SIZE(hdr->len), gc);
+	if (ret) {
+		return ret;
+	}
+
+	hdr->pad = 0xff;
+	hdr->crc = crc16(rec_hdr_crc(hdr), data, hdr->len);
+	hdr->pad2 = 0xffff;
+
+	addr = sector_addr(head) + sectors[head].end;
+
+	ret = flash_append(addr, hdr, sizeof(*hdr));
+	if (!ret && hdr->len) {
+		ret = flash_append(addr + sizeof(*hdr), data, hdr->len);
+	}
+
+	return log_commit(hdr->len, ret);
+}
+
+static int log_append_inode(struct log_entry *entry, bool gc)
+{
+	struct rec_hdr hdr = {
+		.type = REC_INODE,
+		.len = strlen(entry->name),
+		.id = entry->id,
+		.off = entry->type,
+	};
+
+	return log_append(&hdr, entry->name, gc);
+}
+
+static int log_append_trunc(struct log_entry *entry, bool gc)
+{
+	struct rec_hdr hdr = {
+		.type = REC_TRUNC,
+		.id = entry->id,
+		.off = entry->size,
+	};
+
+	return log_append(&hdr, NULL, gc);
+}
+
+struct read_ctx {
+	uint32_t id;
+	uint32_t pos;
+	uint32_t len;
+	uint8_t *buf;
+};
+
+static int read_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct read_ctx *ctx = arg;
+	uint32_t start, end;
+
+	if (hdr->id != ctx->id) {
+		return 0;
+	}
+
+	end = ctx->pos + ctx->len;
+
+	if (hdr->type == REC_TRUNC) {
+		if (hdr->off < end) {
+			start = max(hdr->off, ctx->pos);
+			memset(ctx->buf + start - ctx->pos, 0, end - start);
+		}
+
+		return 0;
+	}
+
+	if (hdr->type != REC_DATA) {
+		return 0;
+	}
+
+	start = max(hdr->off, ctx->pos);
+	end = min(hdr->off + hdr->len, end);
+	if (start >= end) {
+		return 0;
+	}
+
+	if (flash_read(flash_dev, addr + sizeof(*hdr) + start - hdr->off,
+		       ctx->buf + start - ctx->pos, end - start)) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Reads file data as the records leave it, later ones taking precedence */
+static int read_data(uint32_t id, uint32_t pos, void *buf, uint32_t len)
+{
+	struct read_ctx ctx = {
+		.id = id,
+		.pos = pos,
+		.len = len,
+		.buf = buf,
+	};
+
+	if (!len) {
+		return 0;
+	}
+
+	memset(buf, 0, len);
+
+	return log_walk(sector_next(-1), sizeof(struct sector_hdr), read_cb,
+			&ctx);
+}
+
+/* Appends the current data of a part of a file, for the garbage
+ * collection.
+ */
+static int log_append_current(struct log_entry *entry, uint32_t pos,
+			      uint32_t len)
+{
+	struct rec_hdr hdr = {
+		.type = REC_DATA,
+		.pad = 0xff,
+		.len = len,
+		.id = entry->id,
+		.off = pos,
+		.pad2 = 0xffff,
+	};
+	uint32_t done, chunk;
+	off_t addr;
+	int ret;
+
+	ret = log_reserve(REC_SIZE(len), true);
+	if (ret) {
+		return ret;
+	}
+
+	/* The header goes first, the data is read twice */
+	hdr.crc = rec_hdr_crc(&hdr);
+	for (done = 0; done < len; done += chunk) {
+		chunk = min(len - done, sizeof(copy_buf));
+		ret = read_data(entry->id, pos + done, copy_buf, chunk);
+		if (ret) {
+			return ret;
+		}
+
+		hdr.crc = crc16(hdr.crc, copy_buf, chunk);
+	}
+
+	addr = sector_addr(head) + sectors[head].end;
+
+	ret = flash_append(addr, &hdr, sizeof(hdr));
+	for (done = 0; !ret && done < len; done += chunk) {
+		chunk = min(len - done, sizeof(copy_buf));
+		ret = read_data(entry->id, pos + done, copy_buf, chunk);
+		if (!ret) {
+			ret = flash_append(addr + sizeof(hdr) + done, copy_buf,
+					   chunk);
+		}
+	}
+
+	return log_commit(len, ret);
+}
+
+static struct log_entry *entry_get(uint32_t id)
+{
+	int i;
+
+	for (i = 0; id && i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].id == id) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct log_entry *entry_alloc(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!entries[i].id) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+struct cover_ctx {
+	uint32_t id;
+	uint32_t start;
+	uint32_t len;
+	/* Bytes not replaced yet */
+	uint32_t left;
+};
+
+static void cover_mark(struct cover_ctx *ctx, uint32_t start, uint32_t end)
+{
+	uint32_t i;
+
+	start = max(start, ctx->start);
+	end = min(end, ctx->start + ctx->len);
+
+	for (i = start - ctx->start; start < end; start++, i++) {
+		if (!(gc_covered[i / 8] & BIT(i % 8))) {
+			gc_covered[i / 8] |= BIT(i % 8);
+			ctx->left--;
+		}
+	}
+}
+
+static inline bool cover_test(uint32_t i)
+{
+	return gc_covered[i / 8] & BIT(i % 8);
+}
+
+/* Marks the bytes of the record being collected a later record replaces,
+ * the ones past a truncation being either zeros or written again.
+ */
+static int cover_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct cover_ctx *ctx = arg;
+
+	if (hdr->id != ctx->id) {
+		return 0;
+	}
+
+	if (hdr->type == REC_TRUNC) {
+		cover_mark(ctx, hdr->off, ctx->start + ctx->len);
+	} else if (hdr->type == REC_DATA) {
+		cover_mark(ctx, hdr->off, hdr->off + hdr->len);
+	}
+
+	return !ctx->left;
+}
+
+/* Appends again the parts of a data record no later record replaced, the
+ * ones close to each other being merged for the copies not to take more
+ * space than the record.
+ */
+static int gc_data(struct log_entry *entry, struct rec_hdr *hdr, int sector,
+		   uint32_t off)
+{
+	struct cover_ctx cover = {
+		.id = hdr->id,
+		.start = hdr->off,
+		.len = hdr->len,
+		.left = hdr->len,
+	};
+	uint32_t i, j, end;
+	int ret;
+
+	memset(gc_covered, 0, sizeof(gc_covered));
+
+	/* Past the end of the file */
+	cover_mark(&cover, entry->size, hdr->off + hdr->len);
+
+	if (cover.left) {
+		ret = log_walk(sector, off + REC_SIZE(hdr->len), cover_cb,
+			       &cover);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0; cover.left && i < hdr->len; i = end) {
+		if (cover_test(i)) {
+			end = i + 1;
+			continue;
+		}
+
+		for (j = end = i + 1; j < hdr->len &&
+		     j - end < REC_SIZE(2 * WRITE_ALIGN); j++) {
+			if (!cover_test(j)) {
+				end = j + 1;
+			}
+		}
+
+		ret = log_append_current(entry, hdr->off + i, end - i);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+struct find_ctx {
+	uint32_t id;
+	uint8_t type;
+};
+
+static int find_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct find_ctx *ctx = arg;
+
+	return hdr->id == ctx->id && hdr->type == ctx->type;
+}
+
+struct size_ctx {
+	uint32_t id;
+	uint32_t size;
+};
+
+static int size_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct size_ctx *ctx = arg;
+
+	if (hdr->id != ctx->id) {
+		return 0;
+	}
+
+	if (hdr->type == REC_DATA) {
+		ctx->size = max(ctx->size, hdr->off + hdr->len);
+	} else if (hdr->type == REC_TRUNC) {
+		ctx->size = hdr->off;
+	}
+
+	return 0;
+}
+
+static int sector_erase(int sector)
+{
+	flash_write_protection_set(flash_dev, false);
+	if (flash_erase(flash_dev, sector_addr(sector), SECTOR_SIZE)) {
+		return -EIO;
+	}
+
+	sectors[sector].used = false;
+
+	return 0;
+}
+
+/* Tells the sector is collected before erasing it, for an erase cut short
+ * not to leave it looking valid. The end of the sectors is kept for this.
+ */
+static int gc_done(int victim)
+{
+	struct rec_hdr hdr = {
+		.type = REC_COLLECTED,
+		.pad = 0xff,
+		.off = sectors[victim].seq,
+		.pad2 = 0xffff,
+	};
+	off_t addr;
+	int ret;
+
+	if (head < 0 || sectors[head].full ||
+	    SECTOR_SIZE - sectors[head].end < REC_SIZE(0)) {
+		ret = sector_open();
+		if (ret) {
+			return ret;
+		}
+	}
+
+	hdr.crc = rec_hdr_crc(&hdr);
+	addr = sector_addr(head) + sectors[head].end;
+
+	ret = log_commit(0, flash_append(addr, &hdr, sizeof(hdr)));
+	if (ret) {
+		return ret;
+	}
+
+	return sector_erase(victim);
+}
+
+/* Moves what the oldest sector holds that is still current to the head of
+ * the log and erases it.
+ */
+static int log_gc(void)
+{
+	struct find_ctx find;
+	struct size_ctx size;
+	struct log_entry *entry;
+	struct rec_hdr hdr;
+	uint32_t off;
+	int i, victim, ret;
+
+	victim = sector_next(-1);
+	if (victim < 0 || victim == head) {
+		return -ENOSPC;
+	}
+
+	memset(gc_trunc, 0, sizeof(gc_trunc));
+
+	/* Deleted entries only have records before their deletion, which
+	 * go with it.
+	 */
+	for (off = sizeof(struct sector_hdr); off < sectors[victim].end;
+	     off += REC_SIZE(hdr.len)) {
+		if (flash_read(flash_dev, sector_addr(victim) + off, &hdr,
+			       sizeof(hdr))) {
+			return -EIO;
+		}
+
+		entry = entry_get(hdr.id);
+		if (!entry) {
+			continue;
+		}
+
+		switch (hdr.type) {
+		case REC_INODE:
+			/* Copied already if a collection was interrupted */
+			find.id = hdr.id;
+			find.type = REC_INODE;
+			ret = log_walk(victim, off + REC_SIZE(hdr.len), find_cb,
+				       &find);
+			if (!ret) {
+				ret = log_append_inode(entry, true);
+			} else if (ret > 0) {
+				ret = 0;
+			}
+			break;
+		case REC_TRUNC:
+			/* The data before is collected without what it cut
+			 * off, only the size might need to be kept.
+			 */
+			gc_trunc[entry - entries] = true;
+			ret = 0;
+			break;
+		case REC_DATA:
+			ret = gc_data(entry, &hdr, victim, off);
+			break;
+		default:
+			ret = 0;
+			break;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (!gc_trunc[i] || !entries[i].id) {
+			continue;
+		}
+
+		size.id = entries[i].id;
+		size.size = 0;
+		ret = log_walk(sector_next(victim), sizeof(struct sector_hdr),
+			       size_cb, &size);
+		if (!ret && size.size != entries[i].size) {
+			ret = log_append_trunc(&entries[i], true);
+		}
+
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return gc_done(victim);
+}
+
+/* Gets the name of an entry from its path, without the leading and
+ * trailing '/'.
+ */
+static int path_to_name(const char *path, char *name)
+{
+	size_t len;
+
+	while (*path == '/') {
+		path++;
+	}
+
+	len = strlen(path);
+	while (len && path[len - 1] == '/') {
+		len--;
+	}
+
+	if (len > LOG_FS_MAX_FILE_NAME) {
+		return -ENAMETOOLONG;
+	}
+
+	memcpy(name, path, len);
+	name[len] = '\0';
+
+	return 0;
+}
+
+static struct log_entry *entry_find(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].id && !strcmp(entries[i].name, name)) {
+			return &entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Checks if a name is the one of an entry of a directory */
+static bool in_dir(const char *name, const char *dir)
+{
+	size_t len = strlen(dir);
+
+	if (len) {
+		if (strncmp(name, dir, len) || name[len] != '/') {
+			return false;
+		}
+
+		name += len + 1;
+	}
+
+	return *name && !strchr(name, '/');
+}
+
+static bool parent_exists(const char *name)
+{
+	const char *sep = strrchr(name, '/');
+	char parent[LOG_FS_MAX_FILE_NAME + 1];
+	struct log_entry *entry;
+
+	if (!sep) {
+		return true;
+	}
+
+	memcpy(parent, name, sep - name);
+	parent[sep - name] = '\0';
+
+	entry = entry_find(parent);
+
+	return entry && entry->type == FS_DIR_ENTRY_DIR;
+}
+
+static int entry_create(const char *name, enum fs_dir_entry_type type,
+			struct log_entry **created)
+{
+	struct log_entry *entry;
+	int ret;
+
+	if (!parent_exists(name)) {
+		return -ENOENT;
+	}
+
+	entry = entry_alloc();
+	if (!entry) {
+		return -ENOSPC;
+	}
+
+	entry->id = next_id;
+	entry->size = 0;
+	entry->type = type;
+	strcpy(entry->name, name);
+
+	ret = log_append_inode(entry, false);
+	if (ret) {
+		entry->id = 0;
+		return ret;
+	}
+
+	next_id++;
+	*created = entry;
+
+	return 0;
+}
+
+static void entry_to_dirent(struct log_entry *entry, struct fs_dirent *dirent)
+{
+	const char *sep = strrchr(entry->name, '/');
+
+	dirent->type = entry->type;
+	strcpy(dirent->name, sep ? sep + 1 : entry->name);
+	dirent->size = entry->size;
+}
+
+static int log_fs_open(const struct fs_mount_t *mp, fs_file_t *zfp,
+		       const char *file_name)
+{
+	char name[LOG_FS_MAX_FILE_NAME + 1];
+	struct log_entry *entry;
+	int ret;
+
+	ret = path_to_name(file_name, name);
+	if (ret) {
+		return ret;
+	}
+
+	if (!name[0]) {
+		return -EISDIR;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_find(name);
+	if (!entry) {
+		ret = entry_create(name, FS_DIR_ENTRY_FILE, &entry);
+	} else if (entry->type == FS_DIR_ENTRY_DIR) {
+		ret = -EISDIR;
+	}
+
+	if (!ret) {
+		zfp->lf.id = entry->id;
+		zfp->lf.pos = 0;
+	}
+
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_close(fs_file_t *zfp)
+{
+	zfp->lf.id = 0;
+
+	return 0;
+}
+
+static int log_fs_unlink(const struct fs_mount_t *mp, const char *path)
+{
+	char name[LOG_FS_MAX_FILE_NAME + 1];
+	struct log_entry *entry;
+	struct rec_hdr hdr = {
+		.type = REC_DELETE,
+	};
+	int i, ret;
+
+	ret = path_to_name(path, name);
+	if (ret) {
+		return ret;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_find(name);
+	if (!entry) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].id && in_dir(entries[i].name, name)) {
+			ret = -ENOTEMPTY;
+			goto out;
+		}
+	}
+
+	hdr.id = entry->id;
+	ret = log_append(&hdr, NULL, false);
+	if (!ret) {
+		entry->id = 0;
+		log_full = false;
+	}
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static ssize_t log_fs_read(fs_file_t *zfp, void *ptr, size_t size)
+{
+	struct log_entry *entry;
+	ssize_t ret;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_get(zfp->lf.id);
+	if (!entry) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	if (zfp->lf.pos >= entry->size) {
+		size = 0;
+	} else {
+		size = min(size, entry->size - zfp->lf.pos);
+	}
+
+	ret = read_data(entry->id, zfp->lf.pos, ptr, size);
+	if (!ret) {
+		zfp->lf.pos += size;
+		ret = size;
+	}
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static ssize_t log_fs_write(fs_file_t *zfp, const void *ptr, size_t size)
+{
+	struct log_entry *entry;
+	struct rec_hdr hdr;
+	size_t done = 0;
+	ssize_t ret = 0;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_get(zfp->lf.id);
+	if (!entry) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	if (zfp->lf.pos < entry->size) {
+		log_full = false;
+	}
+
+	/* Split in as many records as the sectors need */
+	while (done < size) {
+		ret = log_reserve(sizeof(hdr) + WRITE_ALIGN, false);
+		if (ret) {
+			break;
+		}
+
+		hdr.type = REC_DATA;
+		hdr.len = min(size - done,
+			      ROUND_DOWN(head_space() - sizeof(hdr),
+					 WRITE_ALIGN));
+		hdr.id = entry->id;
+		hdr.off = zfp->lf.pos;
+
+		ret = log_append(&hdr, (const uint8_t *)ptr + done, false);
+		if (ret) {
+			break;
+		}
+
+		done += hdr.len;
+		zfp->lf.pos += hdr.len;
+		entry->size = max(entry->size, zfp->lf.pos);
+	}
+
+	if (done) {
+		ret = done;
+	}
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_seek(fs_file_t *zfp, off_t offset, int whence)
+{
+	struct log_entry *entry;
+	int ret = 0;
+	off_t pos;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_get(zfp->lf.id);
+	if (!entry) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	switch (whence) {
+	case FS_SEEK_SET:
+		pos = offset;
+		break;
+	case FS_SEEK_CUR:
+		pos = zfp->lf.pos + offset;
+		break;
+	case FS_SEEK_END:
+		pos = entry->size + offset;
+		break;
+	default:
+		ret = -EINVAL;
+		goto out;
+	}
+
+	if ((pos < 0) || (pos > entry->size)) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	zfp->lf.pos = pos;
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static off_t log_fs_tell(fs_file_t *zfp)
+{
+	return zfp->lf.pos;
+}
+
+static int log_fs_truncate(fs_file_t *zfp, off_t length)
+{
+	struct log_entry *entry;
+	uint32_t size;
+	int ret;
+
+	if (length < 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	entry = entry_get(zfp->lf.id);
+	if (!entry) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	/* Extending reads back zeros, nothing is written for them */
+	size = entry->size;
+	entry->size = length;
+
+	ret = log_append_trunc(entry, false);
+	if (ret) {
+		entry->size = size;
+		goto out;
+	}
+
+	if (length < size) {
+		log_full = false;
+	}
+
+	zfp->lf.pos = length;
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_sync(fs_file_t *zfp)
+{
+	/* Records are written to the flash as they are appended */
+	return entry_get(zfp->lf.id) ? 0 : -EBADF;
+}
+
+static int log_fs_mkdir(const struct fs_mount_t *mp, const char *path)
+{
+	char name[LOG_FS_MAX_FILE_NAME + 1];
+	struct log_entry *entry;
+	int ret;
+
+	ret = path_to_name(path, name);
+	if (ret) {
+		return ret;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	if (!name[0] || entry_find(name)) {
+		ret = -EEXIST;
+	} else {
+		ret = entry_create(name, FS_DIR_ENTRY_DIR, &entry);
+	}
+
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_opendir(const struct fs_mount_t *mp, fs_dir_t *zdp,
+			  const char *path)
+{
+	struct log_entry *entry;
+	int ret;
+
+	ret = path_to_name(path, zdp->ld.path);
+	if (ret) {
+		return ret;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	if (zdp->ld.path[0]) {
+		entry = entry_find(zdp->ld.path);
+		if (!entry) {
+			ret = -ENOENT;
+		} else if (entry->type != FS_DIR_ENTRY_DIR) {
+			ret = -ENOTDIR;
+		}
+	}
+
+	zdp->ld.index = 0;
+
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_readdir(fs_dir_t *zdp, struct fs_dirent *entry)
+{
+	struct log_entry *found;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	/* An empty name tells the end of the directory */
+	entry->name[0] = '\0';
+
+	while (zdp->ld.index < ARRAY_SIZE(entries)) {
+		found = &entries[zdp->ld.index++];
+		if (found->id && in_dir(found->name, zdp->ld.path)) {
+			entry_to_dirent(found, entry);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&log_lock);
+
+	return 0;
+}
+
+static int log_fs_closedir(fs_dir_t *zdp)
+{
+	ARG_UNUSED(zdp);
+
+	return 0;
+}
+
+static int log_fs_stat(const struct fs_mount_t *mp, const char *path,
+		       struct fs_dirent *entry)
+{
+	char name[LOG_FS_MAX_FILE_NAME + 1];
+	struct log_entry *found;
+	int ret;
+
+	ret = path_to_name(path, name);
+	if (ret) {
+		return ret;
+	}
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	found = entry_find(name);
+	if (found) {
+		entry_to_dirent(found, entry);
+	} else {
+		ret = -ENOENT;
+	}
+
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_statvfs(const struct fs_mount_t *mp,
+			  struct fs_statvfs *stat)
+{
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	/* Erased sectors, less the one kept for the garbage collection */
+	stat->f_bsize = SECTOR_SIZE;
+	stat->f_frsize = SECTOR_SIZE;
+	stat->f_blocks = SECTOR_COUNT - 1;
+	stat->f_bfree = max(free_count() - 1, 0);
+
+	k_mutex_unlock(&log_lock);
+
+	return 0;
+}
+
+/* Finds the end of the records of a sector, closing it for appends from
+ * the first one not passing its CRC or not followed by erased flash.
+ */
+static void sector_scan(int sector)
+{
+	struct log_sector *s = &sectors[sector];
+	off_t addr = sector_addr(sector);
+	struct sector_hdr sector_hdr;
+	struct rec_hdr hdr;
+	uint16_t crc;
+
+	if (flash_read(flash_dev, addr, &sector_hdr, sizeof(sector_hdr)) ||
+	    sector_hdr.magic != SECTOR_MAGIC ||
+	    sector_hdr.crc != crc16(0xffff, &sector_hdr,
+				    offsetof(struct sector_hdr, crc))) {
+		/* Not written yet, or erasing it was interrupted */
+		s->used = false;
+		if (!flash_check(addr, SECTOR_SIZE, NULL)) {
+			sector_erase(sector);
+		}
+
+		return;
+	}
+
+	s->used = true;
+	s->seq = sector_hdr.seq;
+	s->full = true;
+
+	for (s->end = sizeof(sector_hdr);
+	     s->end + sizeof(hdr) <= SECTOR_SIZE; s->end += REC_SIZE(hdr.len)) {
+		if (flash_read(flash_dev, addr + s->end, &hdr, sizeof(hdr))) {
+			return;
+		}
+
+		if (hdr.type == REC_ERASED) {
+			s->full = !flash_check(addr + s->end,
+					       SECTOR_SIZE - s->end, NULL);
+			return;
+		}
+
+		if (hdr.type < REC_INODE || hdr.type > REC_COLLECTED ||
+		    REC_SIZE(hdr.len) > SECTOR_SIZE - s->end) {
+			return;
+		}
+
+		crc = rec_hdr_crc(&hdr);
+		if (!flash_check(addr + s->end + sizeof(hdr), hdr.len, &crc) ||
+		    crc != hdr.crc) {
+			return;
+		}
+	}
+}
+
+static int mount_entry_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct log_entry *entry;
+
+	next_id = max(next_id, hdr->id + 1);
+
+	if (hdr->type == REC_DELETE) {
+		entry = entry_get(hdr->id);
+		if (entry) {
+			entry->id = 0;
+		}
+
+		return 0;
+	}
+
+	/* Entries copied by the garbage collection are there twice if it
+	 * was interrupted.
+	 */
+	if (hdr->type != REC_INODE || hdr->len > LOG_FS_MAX_FILE_NAME ||
+	    entry_get(hdr->id)) {
+		return 0;
+	}
+
+	entry = entry_alloc();
+	if (!entry) {
+		return 0;
+	}
+
+	if (flash_read(flash_dev, addr + sizeof(*hdr), entry->name,
+		       hdr->len)) {
+		return -EIO;
+	}
+
+	entry->name[hdr->len] = '\0';
+	entry->id = hdr->id;
+	entry->type = hdr->off;
+	entry->size = 0;
+
+	return 0;
+}
+
+static int mount_size_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	struct log_entry *entry = entry_get(hdr->id);
+
+	if (!entry) {
+		return 0;
+	}
+
+	if (hdr->type == REC_DATA) {
+		entry->size = max(entry->size, hdr->off + hdr->len);
+	} else if (hdr->type == REC_TRUNC) {
+		entry->size = hdr->off;
+	}
+
+	return 0;
+}
+
+static int mount_collected_cb(off_t addr, struct rec_hdr *hdr, void *arg)
+{
+	int i;
+
+	if (hdr->type != REC_COLLECTED) {
+		return 0;
+	}
+
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		if (sectors[i].used && sectors[i].seq == hdr->off) {
+			return sector_erase(i);
+		}
+	}
+
+	return 0;
+}
+
+static int sector_newest(void)
+{
+	int i, newest = -1;
+
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		if (sectors[i].used &&
+		    (newest < 0 || sectors[i].seq > sectors[newest].seq)) {
+			newest = i;
+		}
+	}
+
+	return newest;
+}
+
+static int log_fs_mount(struct fs_mount_t *mp)
+{
+	int i, ret;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	if (flash_dev) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	flash_dev = device_get_binding(CONFIG_FILE_SYSTEM_LOG_FLASH_DEV_NAME);
+	if (!flash_dev) {
+		ret = -ENODEV;
+		goto out;
+	}
+
+	/* Nothing is left from a previous mount */
+	memset(sectors, 0, sizeof(sectors));
+	memset(entries, 0, sizeof(entries));
+	head = -1;
+	next_seq = 0;
+	next_id = 1;
+	log_full = false;
+
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		sector_scan(i);
+	}
+
+	head = sector_newest();
+	if (head >= 0) {
+		next_seq = sectors[head].seq + 1;
+	}
+
+	/* Sectors collected, but which erase was cut short */
+	ret = log_walk(sector_next(-1), sizeof(struct sector_hdr),
+		       mount_collected_cb, NULL);
+
+	/* Only the garbage collection takes the last erased sector, what it
+	 * copied there before being interrupted is still where it was.
+	 */
+	if (!ret && head >= 0 && !free_count()) {
+		ret = sector_erase(head);
+		head = sector_newest();
+	}
+
+	/* Records are only appended to the head */
+	for (i = 0; i < SECTOR_COUNT; i++) {
+		if (i != head) {
+			sectors[i].full = true;
+		}
+	}
+
+	/* Entries are found first, their records can come before them once
+	 * moved by the garbage collection.
+	 */
+	if (!ret) {
+		ret = log_walk(sector_next(-1), sizeof(struct sector_hdr),
+			       mount_entry_cb, NULL);
+	}
+
+	if (!ret) {
+		ret = log_walk(sector_next(-1), sizeof(struct sector_hdr),
+			       mount_size_cb, NULL);
+	}
+
+	if (ret) {
+		flash_dev = NULL;
+	}
+
+out:
+	k_mutex_unlock(&log_lock);
+
+	return ret;
+}
+
+static int log_fs_unmount(struct fs_mount_t *mp)
+{
+	k_mutex_lock(&log_lock, K_FOREVER);
+	flash_dev = NULL;
+	k_mutex_unlock(&log_lock);
+
+	return 0;
+}
+
+const struct fs_file_system_t log_fs_ops = {
+	.open = log_fs_open,
+	.read = log_fs_read,
+	.write = log_fs_write,
+	.lseek = log_fs_seek,
+	.tell = log_fs_tell,
+	.truncate = log_fs_truncate,
+	.sync = log_fs_sync,
+	.close = log_fs_close,
+	.opendir = log_fs_opendir,
+	.readdir = log_fs_readdir,
+	.closedir = log_fs_closedir,
+	.mount = log_fs_mount,
+	.unmount = log_fs_unmount,
+	.unlink = log_fs_unlink,
+	.mkdir = log_fs_mkdir,
+	.stat = log_fs_stat,
+	.statvfs = log_fs_statvfs,
+};
+
+static struct fs_mount_t log_fs_mnt = {
+	.mnt_point = CONFIG_FILE_SYSTEM_LOG_MOUNT_POINT,
+	.fs = &log_fs_ops,
+};
+
+static int fs_init(struct device *dev)
+{
+	int ret;
+
+	ARG_UNUSED(dev);
+
+	/* Left to the application */
+	if (!log_fs_mnt.mnt_point[0]) {
+		return 0;
+	}
+
+	ret = fs_mount(&log_fs_mnt);
+
+	__ASSERT(!ret, "FS init failed (%d)", ret);
+
+	return ret;
+}
+
+SYS_INIT(fs_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,613 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Compact, lock-free kernel event recording
+ *
+ * Kernel events are recorded in a ring of 32-bit words per CPU, using the
+ * compact encoding described in kernel_event_logger.h.
+ *
+ * Producers reserve room for their events by advancing the head index with
+ * a compare-and-swap, fill them in, then publish them by writing the first
+ * header last: the consumer stops at the first header still null, and nulls
+ * the words of each event once it is done with it. No lock is ever taken.
+ *
+ * The timestamp is read after the head index, so a successful reservation
+ * means that no other event was reserved in between: events are ordered by
+ * timestamp within a ring. The last recorded timestamp is only a hint used
+ * to decide if a sync event is needed: it can only be older than the one of
+ * the previous event, which errs on the side of emitting a sync event.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <atomic.h>
+#include <device.h>
+#include <uart.h>
+#include <string.h>
+#include <logging/kernel_event_logger.h>
+#include <kernel_structs.h>
+#include <kernel_event_logger_arch.h>
+#include <misc/__assert.h>
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM_RTT
+#include <rtt/SEGGER_RTT.h>
+#endif
+
+#define RING_WORDS CONFIG_KERNEL_EVENT_LOGGER_BUFFER_SIZE
+#define RING_MASK (RING_WORDS - 1)
+#define MAX_DATA_WORDS 7
+#define MAX_THREAD_ID CONFIG_KERNEL_EVENT_LOGGER_COMPACT_THREADS
+
+#ifdef CONFIG_SMP
+#define NUM_RINGS CONFIG_MP_NUM_CPUS
+#else
+#define NUM_RINGS 1
+#endif
+
+#define HEADER(type, words, arg, stamp) \
+	KERNEL_EVENT_LOGGER_COMPACT_HEADER(type, words, arg, stamp)
+#define TYPE(header) KERNEL_EVENT_LOGGER_COMPACT_TYPE(header)
+#define WORDS(header) KERNEL_EVENT_LOGGER_COMPACT_WORDS(header)
+#define ARG(header) KERNEL_EVENT_LOGGER_COMPACT_ARG(header)
+#define STAMP_MASK KERNEL_EVENT_LOGGER_COMPACT_STAMP_MASK
+
+#define CONTROL_TYPE KERNEL_EVENT_LOGGER_COMPACT_CONTROL_TYPE
+#define THREAD_ID_TYPE KERNEL_EVENT_LOGGER_COMPACT_THREAD_ID_TYPE
+
+BUILD_ASSERT((RING_WORDS & RING_MASK) == 0);
+
+struct ring {
+	atomic_t buf[RING_WORDS];
+
+	/* free-running indexes, in words */
+	atomic_t head;
+	atomic_t tail;
+
+	/* timestamp of the latest recorded event, a hint only */
+	atomic_t last_stamp;
+
+	atomic_t dropped;
+
+	/* consumer side: full timestamp of the previous event */
+	uint32_t stamp;
+};
+
+struct event {
+	uint32_t type;
+	uint32_t arg;
+	int words;
+	const uint32_t *data;
+};
+
+static struct ring rings[NUM_RINGS];
+
+/* threads by compact ID, written once when the ID is assigned */
+static struct k_thread *threads[MAX_THREAD_ID + 1];
+static atomic_t last_thread_id;
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
+void *_collector_coop_thread;
+#endif
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_SLEEP
+uint32_t _sys_k_event_logger_sleep_start_time;
+#endif
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_DYNAMIC
+int _sys_k_event_logger_mask;
+#endif
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_CUSTOM_TIMESTAMP
+/* k_cycle_get_32() can be a macro */
+static uint32_t cycle_get_32(void)
+{
+	return k_cycle_get_32();
+}
+
+sys_k_timer_func_t _sys_k_get_time = cycle_get_32;
+#endif
+
+static inline struct ring *current_ring(void)
+{
+#ifdef CONFIG_SMP
+	return &rings[_current_cpu->id];
+#else
+	return &rings[0];
+#endif
+}
+
+/*
+ * Record events, preceded by a sync event if needed, in a single
+ * reservation: they all share the same timestamp.
+ */
+static void record(const struct event *events, int count)
+{
+	struct ring *ring = current_ring();
+	uint32_t start, now, len, pos, first;
+	uint32_t words = 0;
+	int sync;
+
+	for (int i = 0; i < count; i++) {
+		words += 1 + events[i].words;
+	}
+
+	do {
+		start = atomic_get(&ring->head);
+		now = _sys_k_get_time();
+		sync = now - (uint32_t)atomic_get(&ring->last_stamp) >
+		       STAMP_MASK;
+		len = words + (sync ? 2 : 0);
+		if (start + len - (uint32_t)atomic_get(&ring->tail) >
+		    RING_WORDS) {
+			atomic_inc(&ring->dropped);
+			return;
+		}
+	} while (!atomic_cas(&ring->head, start, start + len));
+
+	pos = start;
+	if (sync) {
+		first = HEADER(CONTROL_TYPE, 1,
+			       KERNEL_EVENT_LOGGER_COMPACT_CONTROL_SYNC, now);
+		ring->buf[(pos + 1) & RING_MASK] = now;
+		pos += 2;
+	} else {
+		first = HEADER(events[0].type, events[0].words, events[0].arg,
+			       now);
+	}
+
+	for (int i = 0; i < count; i++) {
+		/* the first header is written last, to publish the events */
+		if (pos != start) {
+			ring->buf[pos & RING_MASK] =
+				HEADER(events[i].type, events[i].words,
+				       events[i].arg, now);
+		}
+		for (int j = 0; j < events[i].words; j++) {
+			ring->buf[(pos + 1 + j) & RING_MASK] =
+				events[i].data[j];
+		}
+		pos += 1 + events[i].words;
+	}
+
+	atomic_set(&ring->buf[start & RING_MASK], first);
+
+	atomic_set(&ring->last_stamp, now);
+}
+
+static inline int valid_event_id(uint16_t event_id, uint8_t data_size)
+{
+	return event_id > CONTROL_TYPE && event_id < THREAD_ID_TYPE &&
+	       data_size <= MAX_DATA_WORDS;
+}
+
+void sys_k_event_logger_put(uint16_t event_id, uint32_t *event_data,
+			    uint8_t data_size)
+{
+	struct event event = {
+		.type = event_id,
+		.arg = KERNEL_EVENT_LOGGER_COMPACT_RAW,
+		.words = data_size,
+		.data = event_data,
+	};
+
+	__ASSERT(valid_event_id(event_id, data_size), "invalid event");
+	if (!valid_event_id(event_id, data_size)) {
+		return;
+	}
+
+	record(&event, 1);
+}
+
+void sys_k_event_logger_put_timed(uint16_t event_id)
+{
+	struct event event = {
+		.type = event_id,
+	};
+
+	__ASSERT(valid_event_id(event_id, 0), "invalid event");
+	if (!valid_event_id(event_id, 0)) {
+		return;
+	}
+
+	record(&event, 1);
+}
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
+void _sys_k_event_logger_context_switch(void)
+{
+	struct k_thread *thread = _current;
+	uint32_t id = thread->base.event_logger_id;
+	uint32_t pointer = (uint32_t)thread;
+	struct event events[2];
+	int count = 0;
+
+	if (!sys_k_must_log_event(KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID)) {
+		return;
+	}
+
+	if (_collector_coop_thread == thread) {
+		return;
+	}
+
+	/* a thread is only switched in on one CPU at a time */
+	if (id == 0 && atomic_get(&last_thread_id) < MAX_THREAD_ID) {
+		id = atomic_inc(&last_thread_id) + 1;
+		if (id <= MAX_THREAD_ID) {
+			threads[id] = thread;
+			thread->base.event_logger_id = id;
+
+			events[count].type = THREAD_ID_TYPE;
+			events[count].arg = id;
+			events[count].words = 1;
+			events[count].data = &pointer;
+			count++;
+		} else {
+			id = 0;
+		}
+	}
+
+	events[count].type = KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID;
+	events[count].arg = id;
+	events[count].words = id ? 0 : 1;
+	events[count].data = &pointer;
+	count++;
+
+	record(events, count);
+}
+
+#define ASSERT_CURRENT_IS_COOP_THREAD() \
+	__ASSERT(_current->base.prio < 0, "must be a coop thread")
+
+void sys_k_event_logger_register_as_collector(void)
+{
+	ASSERT_CURRENT_IS_COOP_THREAD();
+
+	_collector_coop_thread = _current;
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH */
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT
+void _sys_k_event_logger_interrupt(void)
+{
+	uint32_t irq;
+	struct event event = {
+		.type = KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID,
+		.data = &irq,
+	};
+
+	if (!sys_k_must_log_event(KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID)) {
+		return;
+	}
+
+	irq = _sys_current_irq_key_get();
+	if (irq < KERNEL_EVENT_LOGGER_COMPACT_NO_IRQ) {
+		event.arg = irq;
+	} else {
+		event.arg = KERNEL_EVENT_LOGGER_COMPACT_NO_IRQ;
+		event.words = 1;
+	}
+
+	record(&event, 1);
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT */
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_SLEEP
+void _sys_k_event_logger_enter_sleep(void)
+{
+	if (!sys_k_must_log_event(KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID)) {
+		return;
+	}
+
+	_sys_k_event_logger_sleep_start_time = k_cycle_get_32();
+}
+
+void _sys_k_event_logger_exit_sleep(void)
+{
+	uint32_t data[2];
+	struct event event = {
+		.type = KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID,
+		.words = ARRAY_SIZE(data),
+		.data = data,
+	};
+
+	if (!sys_k_must_log_event(KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID)) {
+		return;
+	}
+
+	if (_sys_k_event_logger_sleep_start_time != 0) {
+		data[0] = (k_cycle_get_32() -
+			   _sys_k_event_logger_sleep_start_time)
+			  / sys_clock_hw_cycles_per_tick;
+		/* register the cause of exiting sleep mode */
+		data[1] = _sys_current_irq_key_get();
+
+		/* the next interrupt is not waking the CPU up */
+		_sys_k_event_logger_sleep_start_time = 0;
+
+		record(&event, 1);
+	}
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_SLEEP */
+
+/*
+ * Consumer side. There is a single consumer: either the streaming thread,
+ * or the thread retrieving events.
+ */
+
+/* return the header of the next event of a ring, and compute its timestamp */
+static uint32_t peek(struct ring *ring, uint32_t *stamp)
+{
+	uint32_t rd = atomic_get(&ring->tail);
+	uint32_t header = atomic_get(&ring->buf[rd & RING_MASK]);
+
+	if (header == 0) {
+		return 0;
+	}
+
+	if (TYPE(header) == CONTROL_TYPE &&
+	    ARG(header) == KERNEL_EVENT_LOGGER_COMPACT_CONTROL_SYNC) {
+		*stamp = ring->buf[(rd + 1) & RING_MASK];
+	} else {
+		*stamp = ring->stamp + ((header - ring->stamp) & STAMP_MASK);
+	}
+
+	return header;
+}
+
+/* copy the data words of the next event of a ring, then release it */
+static void consume(struct ring *ring, uint32_t header, uint32_t stamp,
+		    uint32_t *data)
+{
+	uint32_t rd = atomic_get(&ring->tail);
+
+	for (int i = 0; i < WORDS(header); i++) {
+		data[i] = ring->buf[(rd + 1 + i) & RING_MASK];
+	}
+
+	/* the words must be null before they can be reserved again */
+	for (int i = 0; i <= WORDS(header); i++) {
+		ring->buf[(rd + i) & RING_MASK] = 0;
+	}
+	atomic_set(&ring->tail, rd + 1 + WORDS(header));
+
+	ring->stamp = stamp;
+}
+
+#ifndef CONFIG_KERNEL_EVENT_LOGGER_STREAM
+
+/* decode an event to its usual format, return its number of words */
+static int decode(uint32_t header, uint32_t stamp, const atomic_t *buf,
+		  uint32_t rd, uint32_t *out)
+{
+	uint32_t arg = ARG(header);
+	int words = WORDS(header);
+	int i = 0;
+
+#define DATA_WORD(n) ((uint32_t)buf[(rd + 1 + (n)) & RING_MASK])
+
+	switch (TYPE(header)) {
+	case KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID:
+		out[i++] = stamp;
+		out[i++] = arg ? (uint32_t)threads[arg] : DATA_WORD(0);
+		break;
+	case KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID:
+		out[i++] = stamp;
+		out[i++] = arg == KERNEL_EVENT_LOGGER_COMPACT_NO_IRQ ?
+			   DATA_WORD(0) : arg;
+		break;
+	case KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID:
+		out[i++] = stamp;
+		out[i++] = DATA_WORD(0);
+		out[i++] = DATA_WORD(1);
+		break;
+	default:
+		if (arg != KERNEL_EVENT_LOGGER_COMPACT_RAW) {
+			/* sys_k_event_logger_put_timed() */
+			out[i++] = stamp;
+		}
+		while (i < words) {
+			out[i] = DATA_WORD(i);
+			i++;
+		}
+		break;
+	}
+
+#undef DATA_WORD
+
+	return i;
+}
+
+int sys_k_event_logger_get(uint16_t *event_id, uint8_t *dropped,
+			   uint32_t *event_data, uint8_t *data_size)
+{
+	uint32_t data[MAX_DATA_WORDS];
+	uint32_t out[MAX_DATA_WORDS + 1];
+
+	for (;;) {
+		struct ring *ring = NULL;
+		uint32_t header = 0, stamp = 0;
+		atomic_val_t num_dropped;
+		int len;
+
+		/* oldest event of all CPUs */
+		for (int i = 0; i < NUM_RINGS; i++) {
+			uint32_t h, s;
+
+			h = peek(&rings[i], &s);
+			if (h && (!ring || (int32_t)(s - stamp) < 0)) {
+				ring = &rings[i];
+				header = h;
+				stamp = s;
+			}
+		}
+
+		if (!ring) {
+			return 0;
+		}
+
+		if (TYPE(header) == CONTROL_TYPE ||
+		    TYPE(header) == THREAD_ID_TYPE) {
+			consume(ring, header, stamp, data);
+			continue;
+		}
+
+		len = decode(header, stamp, ring->buf,
+			     atomic_get(&ring->tail), out);
+		if (len > *data_size) {
+			*data_size = len;
+			return -EMSGSIZE;
+		}
+
+		consume(ring, header, stamp, data);
+
+		memcpy(event_data, out, len * sizeof(uint32_t));
+		*event_id = TYPE(header);
+		num_dropped = atomic_clear(&ring->dropped);
+		*dropped = min(num_dropped, 0xff);
+
+		return len;
+	}
+}
+
+int sys_k_event_logger_get_wait(uint16_t *event_id, uint8_t *dropped,
+				uint32_t *event_data, uint8_t *data_size)
+{
+	int ret;
+
+	while ((ret = sys_k_event_logger_get(event_id, dropped, event_data,
+					     data_size)) == 0) {
+		k_sleep(CONFIG_KERNEL_EVENT_LOGGER_COMPACT_PERIOD);
+	}
+
+	return ret;
+}
+
+int sys_k_event_logger_get_wait_timeout(uint16_t *event_id, uint8_t *dropped,
+					uint32_t *event_data,
+					uint8_t *data_size, uint32_t timeout)
+{
+	uint32_t start = k_uptime_get_32();
+	int32_t remaining = __ticks_to_ms(timeout);
+	int ret;
+
+	while ((ret = sys_k_event_logger_get(event_id, dropped, event_data,
+					     data_size)) == 0) {
+		if (remaining <= 0) {
+			break;
+		}
+		k_sleep(min(remaining, CONFIG_KERNEL_EVENT_LOGGER_COMPACT_PERIOD));
+		remaining = __ticks_to_ms(timeout) -
+			    (int32_t)(k_uptime_get_32() - start);
+	}
+
+	return ret;
+}
+
+#else /* CONFIG_KERNEL_EVENT_LOGGER_STREAM */
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART
+static struct device *stream_dev;
+
+static void stream_init(void)
+{
+	stream_dev =
+	    device_get_binding(CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART_ON_DEV_NAME);
+	__ASSERT(stream_dev, "no kernel event stream UART");
+}
+
+static void stream_out(const uint32_t *words, int count)
+{
+	const uint8_t *p = (const uint8_t *)words;
+
+	for (int i = 0; i < count * sizeof(uint32_t); i++) {
+		uart_poll_out(stream_dev, p[i]);
+	}
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_STREAM_UART */
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_STREAM_RTT
+#define STREAM_RTT_CHANNEL 1
+
+static uint8_t stream_rtt_buf[RING_WORDS * sizeof(uint32_t)];
+
+static void stream_init(void)
+{
+	/* block rather than lose part of the stream: the rings drop events */
+	SEGGER_RTT_ConfigUpBuffer(STREAM_RTT_CHANNEL, "KernelEvents",
+				  stream_rtt_buf, sizeof(stream_rtt_buf),
+				  SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+}
+
+static void stream_out(const uint32_t *words, int count)
+{
+	SEGGER_RTT_Write(STREAM_RTT_CHANNEL, words, count * sizeof(uint32_t));
+}
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_STREAM_RTT */
+
+static void stream_control(struct ring *ring, uint32_t arg, uint32_t value)
+{
+	/* same timestamp as the previous event of the ring */
+	uint32_t words[2] = {
+		HEADER(CONTROL_TYPE, 1, arg, ring->stamp),
+		value,
+	};
+
+	stream_out(words, ARRAY_SIZE(words));
+}
+
+static void stream_thread(void *p1, void *p2, void *p3)
+{
+	uint32_t words[1 + MAX_DATA_WORDS];
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	stream_init();
+
+	for (;;) {
+		for (int i = 0; i < NUM_RINGS; i++) {
+			struct ring *ring = &rings[i];
+			uint32_t header, stamp;
+			atomic_val_t num_dropped;
+
+			header = peek(ring, &stamp);
+			if (!header) {
+				continue;
+			}
+
+#ifdef CONFIG_SMP
+			/* the following events are the ones of that CPU */
+			stream_control(ring,
+				       KERNEL_EVENT_LOGGER_COMPACT_CONTROL_CPU,
+				       i);
+#endif
+
+			do {
+				num_dropped = atomic_clear(&ring->dropped);
+				if (num_dropped) {
+					stream_control(ring,
+					KERNEL_EVENT_LOGGER_COMPACT_CONTROL_DROPPED,
+					num_dropped);
+				}
+
+				words[0] = header;
+				consume(ring, header, stamp, &words[1]);
+				stream_out(words, 1 + WORDS(header));
+			} while ((header = peek(ring, &stamp)) != 0);
+		}
+
+		k_sleep(CONFIG_KERNEL_EVENT_LOGGER_COMPACT_PERIOD);
+	}
+}
+
+K_THREAD_DEFINE(_sys_k_event_logger_stream_tid,
+		CONFIG_KERNEL_EVENT_LOGGER_STREAM_STACK_SIZE,
+		stream_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_STREAM */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief RTT backend of the deferred logging core
+ *
+ * Log lines are written to RTT channel 0 a whole line at a time, to be read
+ * by the Segger J-Link debugger.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <logging/sys_log.h>
+#include <rtt/SEGGER_RTT.h>
+
+static void rtt_put(const struct sys_log_backend *backend, int level,
+		    const char *line, size_t len)
+{
+	unsigned int key;
+
+	ARG_UNUSED(backend);
+	ARG_UNUSED(level);
+
+	/* the console may be writing to the same channel from an ISR */
+	key = irq_lock();
+	SEGGER_RTT_WriteNoLock(0, line, len);
+	irq_unlock(key);
+}
+
+static struct sys_log_backend rtt_backend = {
+	.put = rtt_put,
+};
+
+static int sys_log_backend_rtt_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+#if !defined(CONFIG_RTT_CONSOLE)
+	SEGGER_RTT_Init();
+#endif
+	sys_log_backend_register(&rtt_backend);
+
+	return 0;
+}
+
+SYS_INIT(sys_log_backend_rtt_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
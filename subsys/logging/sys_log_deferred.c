@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Deferred logging core
+ *
+ * The SYS_LOG macros only record the module, level, function name, format
+ * string pointer and arguments of each message, in a lock-free ring buffer of
+ * words. A thread running at the lowest application priority formats them
+ * as whole lines and hands them to every registered backend.
+ *
+ * Each message takes a header word, holding its level and its number of
+ * arguments, followed by the module, function name and format string
+ * pointers and the arguments. Producers reserve room for a message by
+ * advancing the head index with a compare-and-swap, fill it in, then
+ * publish it by writing its header last: the log thread stops at the first
+ * header still null, and nulls the words of each message once it is done
+ * with it.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <atomic.h>
+#include <string.h>
+#include <misc/printk.h>
+#include <logging/sys_log.h>
+
+#define BUF_WORDS CONFIG_SYS_LOG_DEFERRED_BUF_WORDS
+#define BUF_MASK (BUF_WORDS - 1)
+#define MAX_ARGS 15
+#define MSG_WORDS(nargs) ((nargs) + 4)
+
+#define HEADER(level, nargs) (((level) << 8) | ((nargs) + 1))
+#define HEADER_LEVEL(header) ((header) >> 8)
+#define HEADER_NARGS(header) (((header) & 0xff) - 1)
+
+BUILD_ASSERT((BUF_WORDS & BUF_MASK) == 0);
+
+extern struct sys_log_module _sys_log_module_list_start[];
+extern struct sys_log_module _sys_log_module_list_end[];
+
+static atomic_t buf[BUF_WORDS];
+
+/* free-running indexes, in words */
+static atomic_t head;
+static atomic_t tail;
+
+static atomic_t dropped;
+static atomic_t wakeup_pending;
+static atomic_t flushing;
+
+static struct sys_log_backend *backends;
+
+static K_SEM_DEFINE(sys_log_sem, 0, 1);
+
+static const char * const level_tags[] = {
+#if defined(CONFIG_SYS_LOG_SHOW_TAGS)
+	"", " [ERR]", " [WRN]", " [INF]", " [DBG]",
+#else
+	"", "", "", "", "",
+#endif
+};
+
+static const char * const level_colors[] = {
+#if defined(CONFIG_SYS_LOG_SHOW_COLOR)
+	"", "\x1B[0;31m", "\x1B[0;33m", "", "",
+#else
+	"", "", "", "", "",
+#endif
+};
+
+void sys_log_backend_register(struct sys_log_backend *backend)
+{
+	unsigned int key = irq_lock();
+
+	backend->next = backends;
+	backends = backend;
+
+	irq_unlock(key);
+}
+
+int sys_log_level_set(const char *domain, int level)
+{
+	struct sys_log_module *module;
+	int count = 0;
+
+	for (module = _sys_log_module_list_start;
+	     module < _sys_log_module_list_end; module++) {
+		if (strcmp(module->name, domain) == 0) {
+			module->level = level;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void _sys_log_put(struct sys_log_module *module, int level, const char *func,
+		  int nargs, const char *fmt, ...)
+{
+	uint32_t len = MSG_WORDS(nargs);
+	uint32_t start;
+	va_list ap;
+
+	if (nargs > MAX_ARGS) {
+		atomic_inc(&dropped);
+		return;
+	}
+
+	do {
+		start = atomic_get(&head);
+		if (start + len - (uint32_t)atomic_get(&tail) > BUF_WORDS) {
+			atomic_inc(&dropped);
+			return;
+		}
+	} while (!atomic_cas(&head, start, start + len));
+
+	buf[(start + 1) & BUF_MASK] = (atomic_val_t)module;
+	buf[(start + 2) & BUF_MASK] = (atomic_val_t)func;
+	buf[(start + 3) & BUF_MASK] = (atomic_val_t)fmt;
+
+	va_start(ap, fmt);
+	for (int i = 0; i < nargs; i++) {
+		buf[(start + 4 + i) & BUF_MASK] = va_arg(ap, atomic_val_t);
+	}
+	va_end(ap);
+
+	/* publish the message */
+	atomic_set(&buf[start & BUF_MASK], HEADER(level, nargs));
+
+	if (!atomic_set(&wakeup_pending, 1)) {
+		k_sem_give(&sys_log_sem);
+	}
+}
+
+static void output_line(int level, const char *line, size_t len)
+{
+	struct sys_log_backend *backend;
+
+	for (backend = backends; backend; backend = backend->next) {
+		backend->put(backend, level, line, len);
+	}
+}
+
+static void output_msg(int level, struct sys_log_module *module,
+		       const char *func, const char *fmt,
+		       const atomic_val_t *args)
+{
+	static char line[CONFIG_SYS_LOG_LINE_SIZE];
+	int len;
+
+	/* [domain] [level] function: message */
+	len = snprintk(line, sizeof(line), "[%s]%s %s: %s", module->name,
+		       level_tags[level], func, level_colors[level]);
+	if (len < sizeof(line)) {
+		/* extra arguments are ignored by the format string */
+		len += snprintk(line + len, sizeof(line) - len, fmt,
+				args[0], args[1], args[2], args[3], args[4],
+				args[5], args[6], args[7], args[8], args[9],
+				args[10], args[11], args[12], args[13],
+				args[14]);
+	}
+	if (len < sizeof(line)) {
+		len += snprintk(line + len, sizeof(line) - len, "%s%s",
+				level_colors[level][0] ? "\x1B[0m" : "",
+				module->newline ? "\n" : "");
+	}
+
+	output_line(level, line, min(len, sizeof(line) - 1));
+}
+
+void sys_log_flush(void)
+{
+	uint32_t rd;
+
+	/* the log thread and a fatal error handler could both be flushing */
+	if (!atomic_cas(&flushing, 0, 1)) {
+		return;
+	}
+
+	rd = atomic_get(&tail);
+
+	for (;;) {
+		atomic_val_t args[MAX_ARGS] = { 0 };
+		atomic_val_t header = atomic_get(&buf[rd & BUF_MASK]);
+		struct sys_log_module *module;
+		atomic_val_t num_dropped;
+		const char *func, *fmt;
+		int nargs, level;
+
+		if (header == 0) {
+			break;
+		}
+
+		level = HEADER_LEVEL(header);
+		nargs = HEADER_NARGS(header);
+		module = (struct sys_log_module *)buf[(rd + 1) & BUF_MASK];
+		func = (const char *)buf[(rd + 2) & BUF_MASK];
+		fmt = (const char *)buf[(rd + 3) & BUF_MASK];
+		for (int i = 0; i < nargs; i++) {
+			args[i] = buf[(rd + 4 + i) & BUF_MASK];
+		}
+
+		/* the words must be null before they can be reserved again */
+		for (int i = 0; i < MSG_WORDS(nargs); i++) {
+			buf[(rd + i) & BUF_MASK] = 0;
+		}
+		rd += MSG_WORDS(nargs);
+		atomic_set(&tail, rd);
+
+		num_dropped = atomic_clear(&dropped);
+		if (num_dropped) {
+			char line[32];
+			int len = snprintk(line, sizeof(line),
+					   "--- %d messages dropped ---\n",
+					   num_dropped);
+
+			output_line(SYS_LOG_LEVEL_WARNING, line, len);
+		}
+
+		output_msg(level, module, func, fmt, args);
+	}
+
+	atomic_clear(&flushing);
+}
+
+static void sys_log_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_sem_take(&sys_log_sem, K_FOREVER);
+		atomic_clear(&wakeup_pending);
+		sys_log_flush();
+	}
+}
+
+K_THREAD_DEFINE(_sys_log_tid, CONFIG_SYS_LOG_THREAD_STACK_SIZE,
+		sys_log_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+#if defined(CONFIG_SYS_LOG_BACKEND_CONSOLE)
+static void console_put(const struct sys_log_backend *backend, int level,
+			const char *line, size_t len)
+{
+	extern int (*_char_out)(int);
+
+	ARG_UNUSED(backend);
+	ARG_UNUSED(level);
+
+	while (len--) {
+		_char_out(*line++);
+	}
+}
+
+static struct sys_log_backend console_backend = {
+	.put = console_put,
+};
+
+static int sys_log_backend_console_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sys_log_backend_register(&console_backend);
+
+	return 0;
+}
+
+SYS_INIT(sys_log_backend_console_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_SYS_LOG_BACKEND_CONSOLE */
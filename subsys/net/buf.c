@@ -54,10 +54,50 @@ static inline struct net_buf *pool_get_uninit(struct net_buf_pool *pool,
 
 	buf->pool = pool;
 	buf->size = pool->buf_size;
+	buf->index = pool->buf_count - uninit_count;
 
 	return buf;
 }
 
+/* The free stack links buffers by index + 1, in their first word */
+#define STACK_TOP(top) ((top) & 0xffff)
+#define STACK_TAG(top) ((uint32_t)(top) >> 16)
+#define STACK(tag, top) ((atomic_val_t)((((tag) & 0xffff) << 16) | (top)))
+
+/* The tag changes with each update of the stack, so that a thread
+ * preempted in the middle of a pop cannot succeed with the next buffer
+ * it read before: this buffer may be in use by now, even if the top
+ * buffer is back.
+ */
+static struct net_buf *stack_pop(struct net_buf_pool *pool)
+{
+	atomic_val_t top, next;
+	struct net_buf *buf;
+
+	do {
+		top = atomic_get(&pool->stack);
+		if (!STACK_TOP(top)) {
+			return NULL;
+		}
+
+		buf = UNINIT_BUF(pool, STACK_TOP(top) - 1);
+		next = STACK(STACK_TAG(top) + 1, buf->_unused);
+	} while (!atomic_cas(&pool->stack, top, next));
+
+	return buf;
+}
+
+static void stack_push(struct net_buf_pool *pool, struct net_buf *buf)
+{
+	atomic_val_t top;
+
+	do {
+		top = atomic_get(&pool->stack);
+		buf->_unused = STACK_TOP(top);
+	} while (!atomic_cas(&pool->stack, top,
+			     STACK(STACK_TAG(top) + 1, buf->index + 1)));
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_alloc_debug(struct net_buf_pool *pool, int32_t timeout,
 				    const char *func, int line)
@@ -72,6 +112,12 @@ struct net_buf *net_buf_alloc(struct net_buf_pool *pool, int32_t timeout)
 
 	NET_BUF_DBG("%s():%d: pool %p timeout %d", func, line, pool, timeout);
 
+	/* Once the pool is in use, most buffers are freed ones */
+	buf = stack_pop(pool);
+	if (buf) {
+		goto success;
+	}
+
 	/* We need to lock interrupts temporarily to prevent race conditions
 	 * when accessing pool->uninit_count.
 	 */
@@ -83,18 +129,6 @@ struct net_buf *net_buf_alloc(struct net_buf_pool *pool, int32_t timeout)
 	if (pool->uninit_count) {
 		uint16_t uninit_count;
 
-		/* If this is not the first access to the pool, we can
-		 * be opportunistic and try to fetch a previously used
-		 * buffer from the LIFO with K_NO_WAIT.
-		 */
-		if (pool->uninit_count < pool->buf_count) {
-			buf = k_lifo_get(&pool->free, K_NO_WAIT);
-			if (buf) {
-				irq_unlock(key);
-				goto success;
-			}
-		}
-
 		uninit_count = pool->uninit_count--;
 		irq_unlock(key);
 
@@ -102,22 +136,29 @@ struct net_buf *net_buf_alloc(struct net_buf_pool *pool, int32_t timeout)
 		goto success;
 	}
 
-	irq_unlock(key);
+	/* A buffer may have been freed since the first attempt. Any buffer
+	 * freed from now on is handed over through the LIFO, as interrupts
+	 * stay locked until this thread waits on it.
+	 */
+	buf = stack_pop(pool);
+	if (!buf) {
+		buf = k_lifo_get(&pool->free, K_NO_WAIT);
+	}
 
+	if (!buf && timeout != K_NO_WAIT) {
 #if defined(CONFIG_NET_BUF_LOG) && SYS_LOG_LEVEL >= SYS_LOG_LEVEL_WARNING
-	if (timeout == K_FOREVER) {
-		buf = k_lifo_get(&pool->free, K_NO_WAIT);
-		if (!buf) {
+		if (timeout == K_FOREVER) {
 			NET_BUF_WARN("%s():%d: Pool %p low on buffers.",
 				     func, line, pool);
-			buf = k_lifo_get(&pool->free, timeout);
 		}
-	} else {
+#endif
+		atomic_inc(&pool->waiters);
 		buf = k_lifo_get(&pool->free, timeout);
+		atomic_dec(&pool->waiters);
 	}
-#else
-	buf = k_lifo_get(&pool->free, timeout);
-#endif
+
+	irq_unlock(key);
+
 	if (!buf) {
 		NET_BUF_ERR("%s():%d: Failed to get free buffer", func, line);
 		return NULL;
@@ -229,6 +270,48 @@ void net_buf_unref(struct net_buf *buf)
 	}
 }
 
+void net_buf_destroy(struct net_buf *buf)
+{
+	struct net_buf_pool *pool = buf->pool;
+
+	stack_push(pool, buf);
+
+	/* Waiting threads only get buffers through the LIFO */
+	if (atomic_get(&pool->waiters)) {
+		buf = stack_pop(pool);
+		if (buf) {
+			k_lifo_put(&pool->free, buf);
+		}
+	}
+}
+
+int net_buf_pool_free_count(struct net_buf_pool *pool)
+{
+	struct net_buf *buf;
+	atomic_val_t top;
+	unsigned int key;
+	sys_snode_t *node;
+	int count;
+
+	key = irq_lock();
+
+	count = pool->uninit_count;
+
+	for (top = STACK_TOP(atomic_get(&pool->stack)); top;
+	     top = STACK_TOP(buf->_unused)) {
+		buf = UNINIT_BUF(pool, top - 1);
+		count++;
+	}
+
+	SYS_SLIST_FOR_EACH_NODE(&pool->free._queue.data_q, node) {
+		count++;
+	}
+
+	irq_unlock(key);
+
+	return count;
+}
+
 struct net_buf *net_buf_ref(struct net_buf *buf)
 {
 	NET_BUF_ASSERT(buf);
@@ -45,6 +45,23 @@ static inline uint8_t get_6co_cid(struct net_icmpv6_nd_opt_6co *opt)
 }
 
 static struct net_6lo_context ctx_6co[CONFIG_NET_MAX_6LO_CONTEXTS];
+
+/* Contexts matched by recently compressed flows, so that consecutive
+ * packets of a flow do not scan the context table again. The flows are
+ * dropped whenever the context table changes.
+ */
+#define NET_6LO_CTX_FLOWS 4
+
+struct net_6lo_ctx_flow {
+	struct net_if *iface;
+	struct net_6lo_context *src_ctx;
+	struct net_6lo_context *dst_ctx;
+	uint8_t src[8];
+	uint8_t dst[8];
+};
+
+static struct net_6lo_ctx_flow ctx_flows[NET_6LO_CTX_FLOWS];
+static uint8_t ctx_flow_next;
 #endif
 
 /* TODO: Unicast-Prefix based IPv6 Multicast(dst) address compression
@@ -116,8 +133,15 @@ void net_6lo_set_context(struct net_if *iface,
 			 struct net_icmpv6_nd_opt_6co *context)
 {
 	int unused = -1;
+	unsigned int key;
 	uint8_t i;
 
+	/* The flows cached against the old table are dropped along with
+	 * the change, a sender must not see one without the other.
+	 */
+	key = irq_lock();
+	memset(ctx_flows, 0, sizeof(ctx_flows));
+
 	/* If the context information already exists, update or remove
 	 * as per data.
 	 */
@@ -132,22 +156,25 @@ void net_6lo_set_context(struct net_if *iface,
 			/* Remove if lifetime is zero */
 			if (!context->lifetime) {
 				ctx_6co[i].is_used = false;
-				return;
+				goto out;
 			}
 
 			/* Update the context */
 			set_6lo_context(iface, i, context);
-			return;
+			goto out;
 		}
 	}
 
 	/* Cache the context information. */
 	if (unused != -1) {
 		set_6lo_context(iface, unused, context);
-		return;
+		goto out;
 	}
 
 	NET_DBG("Either no free slots in the table or exceeds limit");
+
+out:
+	irq_unlock(key);
 }
 
 /* Get the context by matching cid */
@@ -189,6 +216,54 @@ get_6lo_context_by_addr(struct net_if *iface, struct in6_addr *addr)
 	return NULL;
 }
 
+/* Get the compression contexts of a flow, from the flow cache if the
+ * flow was recently seen.
+ */
+static inline void get_6lo_context_by_flow(struct net_if *iface,
+					   struct net_ipv6_hdr *ipv6,
+					   struct net_6lo_context **src,
+					   struct net_6lo_context **dst)
+{
+	struct net_6lo_ctx_flow *flow;
+	unsigned int key;
+	uint8_t i;
+
+	key = irq_lock();
+
+	for (i = 0; i < NET_6LO_CTX_FLOWS; i++) {
+		flow = &ctx_flows[i];
+
+		if (flow->iface == iface &&
+		    !memcmp(flow->src, ipv6->src.s6_addr, 8) &&
+		    !memcmp(flow->dst, ipv6->dst.s6_addr, 8)) {
+			*src = flow->src_ctx;
+			*dst = flow->dst_ctx;
+			goto out;
+		}
+	}
+
+	/* If compress flag is unset means use only in uncompression. */
+	*src = get_6lo_context_by_addr(iface, &ipv6->src);
+	if (*src && !((*src)->compress)) {
+		*src = NULL;
+	}
+
+	*dst = get_6lo_context_by_addr(iface, &ipv6->dst);
+	if (*dst && !((*dst)->compress)) {
+		*dst = NULL;
+	}
+
+	flow = &ctx_flows[ctx_flow_next++ % NET_6LO_CTX_FLOWS];
+	flow->iface = iface;
+	flow->src_ctx = *src;
+	flow->dst_ctx = *dst;
+	memcpy(flow->src, ipv6->src.s6_addr, 8);
+	memcpy(flow->dst, ipv6->dst.s6_addr, 8);
+
+out:
+	irq_unlock(key);
+}
+
 #endif
 
 /* Helper routine to compress Traffic class and Flow label */
@@ -206,7 +281,7 @@ get_6lo_context_by_addr(struct net_if *iface, struct in6_addr *addr)
  * DSCP(6), ECN(2).
  */
 static inline uint8_t compress_tfl(struct net_ipv6_hdr *ipv6,
-				   struct net_buf *frag,
+				   uint8_t *iphc,
 				   uint8_t offset)
 {
 	uint8_t tcl;
@@ -257,7 +332,7 @@ static inline uint8_t compress_tfl(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Hop limit */
 static inline uint8_t compress_hoplimit(struct net_ipv6_hdr *ipv6,
-					struct net_buf *frag,
+					uint8_t *iphc,
 					uint8_t offset)
 {
 	/* Hop Limit */
@@ -281,7 +356,7 @@ static inline uint8_t compress_hoplimit(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Next header */
 static inline uint8_t compress_nh(struct net_ipv6_hdr *ipv6,
-				  struct net_buf *frag, uint8_t offset)
+				  uint8_t *iphc, uint8_t offset)
 {
 	/* Next header */
 	if (ipv6->nexthdr == IPPROTO_UDP) {
@@ -296,7 +371,7 @@ static inline uint8_t compress_nh(struct net_ipv6_hdr *ipv6,
 /* Helpers to compress Source Address */
 static inline uint8_t compress_sa(struct net_ipv6_hdr *ipv6,
 				  struct net_buf *buf,
-				  struct net_buf *frag,
+				  uint8_t *iphc,
 				  uint8_t offset)
 {
 	if (net_is_ipv6_addr_unspecified(&ipv6->src)) {
@@ -361,12 +436,12 @@ static inline uint8_t compress_sa(struct net_ipv6_hdr *ipv6,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline uint8_t compress_sa_ctx(struct net_ipv6_hdr *ipv6,
 				      struct net_buf *buf,
-				      struct net_buf *frag,
+				      uint8_t *iphc,
 				      uint8_t offset,
 				      struct net_6lo_context *src)
 {
 	if (!src) {
-		return compress_sa(ipv6, buf, frag, offset);
+		return compress_sa(ipv6, buf, iphc, offset);
 	}
 
 	IPHC[1] |= NET_6LO_IPHC_SAC_1;
@@ -402,7 +477,7 @@ static inline uint8_t compress_sa_ctx(struct net_ipv6_hdr *ipv6,
 /* Helpers to compress Destination Address */
 static inline uint8_t compress_da_mcast(struct net_ipv6_hdr *ipv6,
 					struct net_buf *buf,
-					struct net_buf *frag,
+					uint8_t *iphc,
 					uint8_t offset)
 {
 	IPHC[1] |= NET_6LO_IPHC_M_1;
@@ -453,12 +528,12 @@ static inline uint8_t compress_da_mcast(struct net_ipv6_hdr *ipv6,
 
 static inline uint8_t compress_da(struct net_ipv6_hdr *ipv6,
 				  struct net_buf *buf,
-				  struct net_buf *frag,
+				  uint8_t *iphc,
 				  uint8_t offset)
 {
 	/* If destination address is multicast */
 	if (net_is_ipv6_addr_mcast(&ipv6->dst)) {
-		return compress_da_mcast(ipv6, buf, frag, offset);
+		return compress_da_mcast(ipv6, buf, iphc, offset);
 	}
 
 	/* If address is link-local prefix and padded with zeros */
@@ -511,12 +586,12 @@ static inline uint8_t compress_da(struct net_ipv6_hdr *ipv6,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline uint8_t compress_da_ctx(struct net_ipv6_hdr *ipv6,
 				      struct net_buf *buf,
-				      struct net_buf *frag,
+				      uint8_t *iphc,
 				      uint8_t offset,
 				      struct net_6lo_context *dst)
 {
 	if (!dst) {
-		return compress_da(ipv6, buf, frag, offset);
+		return compress_da(ipv6, buf, iphc, offset);
 	}
 
 	IPHC[1] |= NET_6LO_IPHC_DAC_1;
@@ -554,7 +629,7 @@ static inline uint8_t compress_da_ctx(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Next header UDP */
 static inline uint8_t compress_nh_udp(struct net_udp_hdr *udp,
-				      struct net_buf *frag, uint8_t offset)
+				      uint8_t *iphc, uint8_t offset)
 {
 	uint8_t tmp;
 
@@ -639,21 +714,11 @@ static inline uint8_t compress_nh_udp(struct net_udp_hdr *udp,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline bool is_src_and_dst_addr_ctx_based(struct net_ipv6_hdr *ipv6,
 						 struct net_buf *buf,
-						 struct net_buf *frag,
+						 uint8_t *iphc,
 						 struct net_6lo_context **src,
 						 struct net_6lo_context **dst)
 {
-	/* If compress flag is unset means use only in uncompression. */
-
-	*src = get_6lo_context_by_addr(net_nbuf_iface(buf), &ipv6->src);
-	if (*src && !((*src)->compress)) {
-		*src = NULL;
-	}
-
-	*dst = get_6lo_context_by_addr(net_nbuf_iface(buf), &ipv6->dst);
-	if (*dst && !((*dst)->compress)) {
-		*dst = NULL;
-	}
+	get_6lo_context_by_flow(net_nbuf_iface(buf), ipv6, src, dst);
 
 	if (!*src && !*dst) {
 		return false;
@@ -694,9 +759,9 @@ static inline bool compress_IPHC_header(struct net_buf *buf,
 	struct net_6lo_context *dst = NULL;
 #endif
 	struct net_ipv6_hdr *ipv6 = NET_IPV6_BUF(buf);
+	uint8_t iphc[NET_IPV6UDPH_LEN];
 	uint8_t offset = 0;
 	struct net_udp_hdr *udp;
-	struct net_buf *frag;
 	uint8_t compressed;
 
 	if (buf->frags->len < NET_IPV6H_LEN) {
@@ -712,46 +777,42 @@ static inline bool compress_IPHC_header(struct net_buf *buf,
 		return false;
 	}
 
-	frag = net_nbuf_get_reserve_data(net_nbuf_ll_reserve(buf), K_FOREVER);
-
 	IPHC[offset++] = NET_6LO_DISPATCH_IPHC;
 	IPHC[offset++] = 0;
 
 #if defined(CONFIG_NET_6LO_CONTEXT)
-	if (is_src_and_dst_addr_ctx_based(ipv6, buf, frag, &src, &dst)) {
+	if (is_src_and_dst_addr_ctx_based(ipv6, buf, iphc, &src, &dst)) {
 		offset++;
 	}
 #endif
 
 	/* Compress Traffic class and Flow lablel */
-	offset = compress_tfl(ipv6, frag, offset);
+	offset = compress_tfl(ipv6, iphc, offset);
 
 	/* Hop limit */
-	offset = compress_hoplimit(ipv6, frag, offset);
+	offset = compress_hoplimit(ipv6, iphc, offset);
 
 	/* Next Header */
-	offset = compress_nh(ipv6, frag, offset);
+	offset = compress_nh(ipv6, iphc, offset);
 
 	/* Source Address Compression */
 #if defined(CONFIG_NET_6LO_CONTEXT)
-	offset = compress_sa_ctx(ipv6, buf, frag, offset, src);
+	offset = compress_sa_ctx(ipv6, buf, iphc, offset, src);
 #else
-	offset = compress_sa(ipv6, buf, frag, offset);
+	offset = compress_sa(ipv6, buf, iphc, offset);
 #endif
 	if (!offset) {
-		net_nbuf_unref(frag);
 		return false;
 	}
 
 	/* Destination Address Compression */
 #if defined(CONFIG_NET_6LO_CONTEXT)
-	offset = compress_da_ctx(ipv6, buf, frag, offset, dst);
+	offset = compress_da_ctx(ipv6, buf, iphc, offset, dst);
 #else
-	offset = compress_da(ipv6, buf, frag, offset);
+	offset = compress_da(ipv6, buf, iphc, offset);
 #endif
 
 	if (!offset) {
-		net_nbuf_unref(frag);
 		return false;
 	}
 
@@ -765,26 +826,20 @@ static inline bool compress_IPHC_header(struct net_buf *buf,
 	/* UDP header compression */
 	udp = NET_UDP_BUF(buf);
 	IPHC[offset] = NET_6LO_NHC_UDP_BARE;
-	offset = compress_nh_udp(udp, frag, offset);
+	offset = compress_nh_udp(udp, iphc, offset);
 
 	compressed += NET_UDPH_LEN;
 
 end:
-	net_buf_add(frag, offset);
-
-	/* Copy the rest of the data to compressed fragment */
-	memcpy(&IPHC[offset], buf->frags->data + compressed,
-	       buf->frags->len - compressed);
-	net_buf_add(frag, buf->frags->len - compressed);
-
-	/* Delete uncompressed(original) header fragment */
-	net_buf_frag_del(buf, buf->frags);
-
-	/* Insert compressed header fragment */
-	net_buf_frag_insert(buf, frag);
+	/* The compressed headers are never longer than the uncompressed
+	 * ones, so they replace them in place and the payload stays put.
+	 */
+	memcpy(net_buf_pull(buf->frags, compressed - offset), iphc, offset);
 
 	/* Compact the fragments, so that gaps will be filled */
-	net_nbuf_compact(buf);
+	if (buf->frags->frags) {
+		net_nbuf_compact(buf);
+	}
 
 	if (fragment) {
 		return fragment(buf, compressed - offset);
@@ -1400,6 +1455,13 @@ static inline bool compress_ipv6_header(struct net_buf *buf,
 {
 	struct net_buf *frag;
 
+	/* Prepend the dispatch in the headroom the link layer left */
+	if (net_buf_headroom(buf->frags) > net_nbuf_ll_reserve(buf)) {
+		*((uint8_t *)net_buf_push(buf->frags, 1)) =
+			NET_6LO_DISPATCH_IPV6;
+		goto done;
+	}
+
 	frag = net_nbuf_get_reserve_data(net_nbuf_ll_reserve(buf), K_FOREVER);
 
 	frag->data[0] = NET_6LO_DISPATCH_IPV6;
@@ -1410,6 +1472,8 @@ static inline bool compress_ipv6_header(struct net_buf *buf,
 	/* Compact the fragments, so that gaps will be filled */
 	net_nbuf_compact(buf);
 
+done:
+
 	if (fragment) {
 		return fragment(buf, -1);
 	}
@@ -84,7 +84,7 @@
 #define NET_6LO_NHC_UDP_8_BIT_PORT	0xF0
 #define NET_6LO_NHC_UDP_4_BIT_PORT	0xF0B
 
-#define IPHC ((frag)->data)
+#define IPHC (iphc)
 #define CIPHC ((buf->frags)->data)
 
 #define NET_6LO_FRAG1_HDR_LEN		4
@@ -70,40 +70,6 @@ static inline const char *proto2str(enum net_ip_protocol proto)
 }
 #endif /* CONFIG_NET_DEBUG_CONN */
 
-#if defined(CONFIG_NET_CONN_CACHE)
-
-/* Cache the connection so that we do not have to go
- * through the full list of connections when receiving
- * a network packet. The cache contains an index to
- * corresponding entry in conns array.
- *
- * Hash value is constructed like this:
- *
- *   bit      description
- *   0  - 3   bits from remote port
- *   4  - 7   bits from local port
- *   8  - 18  bits from remote address
- *   19 - 29  bits from local address
- *   30       family
- *   31       protocol
- */
-struct conn_hash {
-	uint32_t value;
-	int32_t idx;
-};
-
-struct conn_hash_neg {
-	uint32_t value;
-};
-
-/** Connection cache */
-static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
-
-/** Negative cache, we definitely do not have a connection
- * to these hosts.
- */
-static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
-
 #define TAKE_BIT(val, bit, max, used)				\
 	(((val & BIT(bit)) >> bit) << (max - used))
 
@@ -164,6 +130,163 @@ static inline uint16_t ipv4_to_hash(struct in_addr *addr)
 		TAKE_BIT(addr->s_addr[0], 0, 11, 11);
 }
 
+/*
+ * Connections are kept in hash tables, so that a received packet is only
+ * checked against the connections that could match it:
+ * - connected ones, with a remote port, a local port and a specific remote
+ *   address, hashed by all three
+ * - bound ones, with a local port, hashed by it
+ * - the others, in a single list
+ * Each list is sorted by position in conns, so that going through the
+ * lists of a packet in parallel visits the candidates in the same order as
+ * a scan of conns, and picks the same best match.
+ */
+#define CONN_HASH_SIZE BIT(CONFIG_NET_CONN_HASH_BITS)
+
+static sys_slist_t conn_connected[CONN_HASH_SIZE];
+static sys_slist_t conn_bound[CONN_HASH_SIZE];
+static sys_slist_t conn_others;
+
+#define CONN_LISTS 3
+
+static inline uint32_t conn_hash(uint32_t value)
+{
+	/* multiplicative hashing, keeping the upper bits */
+	return (value * 2654435761u) >> (32 - CONFIG_NET_CONN_HASH_BITS);
+}
+
+static inline uint32_t connected_hash(sa_family_t family, void *remote_addr,
+				      uint16_t remote_port,
+				      uint16_t local_port)
+{
+	uint32_t value = ports_to_hash(remote_port, local_port);
+
+#if defined(CONFIG_NET_IPV6)
+	if (family == AF_INET6) {
+		value |= ipv6_to_hash((struct in6_addr *)remote_addr) << 8;
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (family == AF_INET) {
+		value |= ipv4_to_hash((struct in_addr *)remote_addr) << 8;
+	}
+#endif
+
+	return conn_hash(value);
+}
+
+/* List of a connection, given its set ports and addresses */
+static sys_slist_t *conn_list(struct net_conn *conn)
+{
+	uint16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+	uint16_t local_port = net_sin(&conn->local_addr)->sin_port;
+
+	if (remote_port && local_port &&
+	    (conn->rank & NET_RANK_REMOTE_SPEC_ADDR)) {
+		void *addr = NULL;
+
+#if defined(CONFIG_NET_IPV6)
+		if (conn->remote_addr.family == AF_INET6) {
+			addr = &net_sin6(&conn->remote_addr)->sin6_addr;
+		}
+#endif
+#if defined(CONFIG_NET_IPV4)
+		if (conn->remote_addr.family == AF_INET) {
+			addr = &net_sin(&conn->remote_addr)->sin_addr;
+		}
+#endif
+
+		return &conn_connected[connected_hash(conn->remote_addr.family,
+						      addr, remote_port,
+						      local_port)];
+	}
+
+	if (local_port) {
+		return &conn_bound[conn_hash(ports_to_hash(0, local_port))];
+	}
+
+	return &conn_others;
+}
+
+/* Lists holding the connections that could match a packet */
+static void conn_lists_get(struct net_buf *buf, sys_slist_t **lists)
+{
+	uint16_t remote_port = NET_CONN_BUF(buf)->src_port;
+	uint16_t local_port = NET_CONN_BUF(buf)->dst_port;
+	void *addr = NULL;
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6) {
+		addr = &NET_IPV6_BUF(buf)->src;
+	}
+#endif
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET) {
+		addr = &NET_IPV4_BUF(buf)->src;
+	}
+#endif
+
+	lists[0] = &conn_connected[connected_hash(net_nbuf_family(buf), addr,
+						  remote_port, local_port)];
+	lists[1] = &conn_bound[conn_hash(ports_to_hash(0, local_port))];
+	lists[2] = &conn_others;
+}
+
+static void conn_list_add(struct net_conn *conn)
+{
+	sys_slist_t *list = conn_list(conn);
+	struct net_conn *prev = NULL, *next;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, next, node) {
+		if (next > conn) {
+			break;
+		}
+		prev = next;
+	}
+
+	sys_slist_insert(list, prev ? &prev->node : NULL, &conn->node);
+}
+
+static void conn_list_remove(struct net_conn *conn)
+{
+	sys_slist_find_and_remove(conn_list(conn), &conn->node);
+}
+
+#if defined(CONFIG_NET_CONN_CACHE)
+
+/* Cache the connection so that we do not have to go
+ * through the full list of connections when receiving
+ * a network packet. The cache contains an index to
+ * corresponding entry in conns array.
+ *
+ * Hash value is constructed like this:
+ *
+ *   bit      description
+ *   0  - 3   bits from remote port
+ *   4  - 7   bits from local port
+ *   8  - 18  bits from remote address
+ *   19 - 29  bits from local address
+ *   30       family
+ *   31       protocol
+ */
+struct conn_hash {
+	uint32_t value;
+	int32_t idx;
+};
+
+struct conn_hash_neg {
+	uint32_t value;
+};
+
+/** Connection cache */
+static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
+
+/** Negative cache, we definitely do not have a connection
+ * to these hosts.
+ */
+static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
+
 /* Return either the first free position in the cache (idx < 0) or
  * the existing cached position (idx >= 0)
  */
@@ -352,6 +475,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("[%zu] connection handler %p removed",
 		(conn - conns) / sizeof(*conn), conn);
 
+	conn_list_remove(conn);
 	conn->flags = 0;
 
 	return 0;
@@ -449,6 +573,10 @@ int net_conn_register(enum net_ip_protocol proto,
 			continue;
 		}
 
+		/* Ports of a previous connection must not be left over */
+		memset(&conns[i].remote_addr, 0, sizeof(struct sockaddr));
+		memset(&conns[i].local_addr, 0, sizeof(struct sockaddr));
+
 		if (remote_addr) {
 			if (remote_addr->family != AF_INET &&
 			    remote_addr->family != AF_INET6) {
@@ -545,6 +673,8 @@ int net_conn_register(enum net_ip_protocol proto,
 		conns[i].rank = rank;
 		conns[i].proto = proto;
 
+		conn_list_add(&conns[i]);
+
 		/* Cache needs to be cleared if new entries are added. */
 		cache_clear();
 
@@ -646,8 +776,46 @@ static inline void send_icmp_error(struct net_buf *buf)
 	}
 }
 
+static bool conn_match(enum net_ip_protocol proto, struct net_buf *buf,
+		       struct net_conn *conn)
+{
+	if (conn->proto != proto) {
+		return false;
+	}
+
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port !=
+		    NET_CONN_BUF(buf)->src_port) {
+			return false;
+		}
+	}
+
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port !=
+		    NET_CONN_BUF(buf)->dst_port) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!check_addr(buf, &conn->remote_addr, true)) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!check_addr(buf, &conn->local_addr, false)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_buf *buf)
 {
+	sys_slist_t *lists[CONN_LISTS];
+	struct net_conn *next[CONN_LISTS];
 	int i, best_match = -1;
 	int16_t best_rank = -1;
 
@@ -668,39 +836,35 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_buf *buf)
 		ntohs(NET_CONN_BUF(buf)->dst_port),
 		net_nbuf_family(buf));
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
-		}
+	conn_lists_get(buf, lists);
+	for (i = 0; i < CONN_LISTS; i++) {
+		next[i] = SYS_SLIST_PEEK_HEAD_CONTAINER(lists[i], next[i],
+							node);
+	}
 
-		if (conns[i].proto != proto) {
-			continue;
-		}
+	/* Go through the candidates in the order of conns */
+	for (;;) {
+		struct net_conn *conn = NULL;
 
-		if (net_sin(&conns[i].remote_addr)->sin_port) {
-			if (net_sin(&conns[i].remote_addr)->sin_port !=
-			    NET_CONN_BUF(buf)->src_port) {
-				continue;
+		for (i = 0; i < CONN_LISTS; i++) {
+			if (next[i] && (!conn || next[i] < conn)) {
+				conn = next[i];
 			}
 		}
 
-		if (net_sin(&conns[i].local_addr)->sin_port) {
-			if (net_sin(&conns[i].local_addr)->sin_port !=
-			    NET_CONN_BUF(buf)->dst_port) {
-				continue;
-			}
+		if (!conn) {
+			break;
 		}
 
-		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-			if (!check_addr(buf, &conns[i].remote_addr, true)) {
-				continue;
+		for (i = 0; i < CONN_LISTS; i++) {
+			if (next[i] == conn) {
+				next[i] = SYS_SLIST_PEEK_NEXT_CONTAINER(conn,
+									node);
 			}
 		}
 
-		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-			if (!check_addr(buf, &conns[i].local_addr, false)) {
-				continue;
-			}
+		if (!conn_match(proto, buf, conn)) {
+			continue;
 		}
 
 		/* If we have an existing best_match, and that one
@@ -712,9 +876,9 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_buf *buf)
 			continue;
 		}
 
-		if (best_rank < conns[i].rank) {
-			best_rank = conns[i].rank;
-			best_match = i;
+		if (best_rank < conn->rank) {
+			best_rank = conn->rank;
+			best_match = conn - conns;
 		}
 	}
 
@@ -78,6 +78,7 @@ struct dhcp_msg {
 #define DHCPV4_OPTIONS_SERVER_ID	54
 #define DHCPV4_OPTIONS_REQ_LIST		55
 #define DHCPV4_OPTIONS_RENEWAL		58
+#define DHCPV4_OPTIONS_RAPID_COMMIT	80
 #define DHCPV4_OPTIONS_END		255
 
 /* TODO:
@@ -92,17 +93,22 @@ struct dhcp_msg {
 #define DHCPV4_MAX_NUMBER_OF_ATTEMPTS	3
 
 /* Initial message retry timeout (s).  This timeout increases
- * exponentially on each retransmit.
+ * exponentially on each retransmit, up to the maximum.
  * RFC2131 4.1
  */
-#define DHCPV4_INITIAL_RETRY_TIMEOUT 4
+#define DHCPV4_INITIAL_RETRY_TIMEOUT CONFIG_NET_DHCPV4_INITIAL_RETRY_TIMEOUT
+#define DHCPV4_MAX_RETRY_TIMEOUT 64
 
 /* Initial minimum and maximum delay in INIT state before sending the
  * initial DISCOVER message.
  * RFC2131 4.1.1
  */
 #define DHCPV4_INITIAL_DELAY_MIN 1
-#define DHCPV4_INITIAL_DELAY_MAX 10
+#define DHCPV4_INITIAL_DELAY_MAX CONFIG_NET_DHCPV4_INITIAL_DELAY_MAX
+
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+static const struct net_dhcpv4_lease_storage *lease_storage;
+#endif
 
 static uint8_t magic_cookie[4] = { 0x63, 0x82, 0x53, 0x63 }; /* RFC 1497 [17] */
 
@@ -119,6 +125,7 @@ net_dhcpv4_state_name(enum net_dhcpv4_state state)
 {
 	static const char * const name[] = {
 		"init",
+		"init-reboot",
 		"discover",
 		"request",
 		"renewal",
@@ -153,6 +160,19 @@ static inline uint32_t get_dhcpv4_renewal_time(struct net_if *iface)
 		iface->dhcpv4.lease_time / 2);
 }
 
+/* Timeout of the next message sent, doubled on each attempt */
+static uint32_t get_dhcpv4_retry_timeout(struct net_if *iface)
+{
+	uint32_t timeout = DHCPV4_INITIAL_RETRY_TIMEOUT;
+	uint8_t attempts = iface->dhcpv4.attempts;
+
+	while (attempts-- && timeout < DHCPV4_MAX_RETRY_TIMEOUT) {
+		timeout <<= 1;
+	}
+
+	return min(timeout, DHCPV4_MAX_RETRY_TIMEOUT);
+}
+
 static inline void unset_dhcpv4_on_iface(struct net_if *iface)
 {
 	if (!iface) {
@@ -202,6 +222,16 @@ static inline bool add_req_options(struct net_buf *buf)
 	return net_nbuf_append(buf, sizeof(data), data, K_FOREVER);
 }
 
+#if defined(CONFIG_NET_DHCPV4_RAPID_COMMIT)
+/* Ask for an ACK to the DISCOVER, RFC 4039 */
+static inline bool add_rapid_commit(struct net_buf *buf)
+{
+	uint8_t data[2] = { DHCPV4_OPTIONS_RAPID_COMMIT, 0 };
+
+	return net_nbuf_append(buf, sizeof(data), data, K_FOREVER);
+}
+#endif
+
 static inline bool add_server_id(struct net_buf *buf)
 {
 	struct net_if *iface = net_nbuf_iface(buf);
@@ -384,8 +414,10 @@ fail:
 	return NULL;
 }
 
-/* Prepare DHCPv4 Message request and send it to peer */
-static void send_request(struct net_if *iface, bool renewal)
+/* Prepare DHCPv4 Message request and send it to peer, the state being
+ * REQUEST, RENEWAL or INIT_REBOOT
+ */
+static void send_request(struct net_if *iface, enum net_dhcpv4_state state)
 {
 	struct net_buf *buf;
 	uint32_t timeout;
@@ -397,7 +429,8 @@ static void send_request(struct net_if *iface, bool renewal)
 		goto fail;
 	}
 
-	if (!add_server_id(buf) ||
+	/* No server is selected in INIT-REBOOT, RFC2131 4.3.2 */
+	if ((state != NET_DHCPV4_INIT_REBOOT && !add_server_id(buf)) ||
 	    !add_req_ipaddr(buf) ||
 	    !add_end(buf)) {
 		goto fail;
@@ -409,13 +442,9 @@ static void send_request(struct net_if *iface, bool renewal)
 		goto fail;
 	}
 
-	if (renewal) {
-		iface->dhcpv4.state = NET_DHCPV4_RENEWAL;
-	} else {
-		iface->dhcpv4.state = NET_DHCPV4_REQUEST;
-	}
+	iface->dhcpv4.state = state;
 
-	timeout = DHCPV4_INITIAL_RETRY_TIMEOUT << iface->dhcpv4.attempts;
+	timeout = get_dhcpv4_retry_timeout(iface);
 
 	NET_DBG("enter state=%s xid=0x%"PRIx32" timeout=%"PRIu32"s",
 		net_dhcpv4_state_name(iface->dhcpv4.state),
@@ -449,6 +478,9 @@ static void send_discover(struct net_if *iface)
 	}
 
 	if (!add_req_options(buf) ||
+#if defined(CONFIG_NET_DHCPV4_RAPID_COMMIT)
+	    !add_rapid_commit(buf) ||
+#endif
 	    !add_end(buf)) {
 		goto fail;
 	}
@@ -459,7 +491,7 @@ static void send_discover(struct net_if *iface)
 		goto fail;
 	}
 
-	timeout = DHCPV4_INITIAL_RETRY_TIMEOUT << iface->dhcpv4.attempts;
+	timeout = get_dhcpv4_retry_timeout(iface);
 
 	iface->dhcpv4.state = NET_DHCPV4_DISCOVER;
 
@@ -511,7 +543,17 @@ static void dhcpv4_timeout(struct k_work *work)
 			send_discover(iface);
 		} else {
 			/* Repeat requests until max number of attempts */
-			send_request(iface, false);
+			send_request(iface, NET_DHCPV4_REQUEST);
+		}
+		break;
+	case NET_DHCPV4_INIT_REBOOT:
+		/* The last lease could not be confirmed, get a new one */
+		if (iface->dhcpv4.attempts >= DHCPV4_MAX_NUMBER_OF_ATTEMPTS) {
+			NET_DBG("too many attempts, restart");
+			iface->dhcpv4.attempts = 0;
+			send_discover(iface);
+		} else {
+			send_request(iface, NET_DHCPV4_INIT_REBOOT);
 		}
 		break;
 	case NET_DHCPV4_RENEWAL:
@@ -529,7 +571,7 @@ static void dhcpv4_timeout(struct k_work *work)
 			send_discover(iface);
 		} else {
 			/* Repeat renewal request for max number of attempts */
-			send_request(iface, true);
+			send_request(iface, NET_DHCPV4_RENEWAL);
 		}
 		break;
 	default:
@@ -550,39 +592,34 @@ static void dhcpv4_t1_timeout(struct k_work *work)
 		return;
 	}
 
-	send_request(iface, true);
+	send_request(iface, NET_DHCPV4_RENEWAL);
 }
 
 /* Parse DHCPv4 options and retrieve relavant information
  * as per RFC 2132.
  */
-static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
-				      uint16_t offset, uint8_t *msg_type)
+static enum net_verdict parse_options(struct net_if *iface,
+				      struct net_nbuf_cursor *cursor,
+				      uint8_t *msg_type, bool *rapid_commit)
 {
-	struct net_buf *frag;
 	uint8_t cookie[4];
 	uint8_t length;
 	uint8_t type;
-	uint16_t pos;
 
-	frag = net_nbuf_read(buf, offset, &pos, sizeof(magic_cookie),
-			     (uint8_t *)cookie);
-	if (!frag || memcmp(magic_cookie, cookie, sizeof(magic_cookie))) {
+	if (!net_nbuf_cursor_read(cursor, cookie, sizeof(magic_cookie)) ||
+	    memcmp(magic_cookie, cookie, sizeof(magic_cookie))) {
 
 		NET_DBG("Incorrect magic cookie");
 		return NET_DROP;
 	}
 
-	while (frag) {
-		frag = net_nbuf_read_u8(frag, pos, &pos, &type);
-
+	while (net_nbuf_cursor_read_u8(cursor, &type)) {
 		if (type == DHCPV4_OPTIONS_END) {
 			NET_DBG("options_end");
 			return NET_OK;
 		}
 
-		frag = net_nbuf_read_u8(frag, pos, &pos, &length);
-		if (!frag) {
+		if (!net_nbuf_cursor_read_u8(cursor, &length)) {
 			NET_ERR("option parsing, bad length");
 			return NET_DROP;
 		}
@@ -596,9 +633,8 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read(frag, pos, &pos, length,
-					     netmask.s4_addr);
-			if (!frag && pos) {
+			if (!net_nbuf_cursor_read(cursor, netmask.s4_addr,
+						  length)) {
 				NET_ERR("options_subnet_mask, short packet");
 				return NET_DROP;
 			}
@@ -621,10 +657,8 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read(frag, pos, &pos, 4,
-					     router.s4_addr);
-			frag = net_nbuf_skip(frag, pos, &pos, length - 4);
-			if (!frag && pos) {
+			if (!net_nbuf_cursor_read(cursor, router.s4_addr, 4) ||
+			    !net_nbuf_cursor_skip(cursor, length - 4)) {
 				NET_ERR("options_router, short packet");
 				return NET_DROP;
 			}
@@ -640,8 +674,11 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read_be32(frag, pos, &pos,
-						  &iface->dhcpv4.lease_time);
+			if (!net_nbuf_cursor_read_be32(cursor,
+						&iface->dhcpv4.lease_time)) {
+				return NET_DROP;
+			}
+
 			NET_DBG("options_lease_time: %u",
 				iface->dhcpv4.lease_time);
 			if (!iface->dhcpv4.lease_time) {
@@ -655,8 +692,11 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read_be32(frag, pos, &pos,
-						  &iface->dhcpv4.renewal_time);
+			if (!net_nbuf_cursor_read_be32(cursor,
+						&iface->dhcpv4.renewal_time)) {
+				return NET_DROP;
+			}
+
 			NET_DBG("options_renewal: %u",
 				iface->dhcpv4.renewal_time);
 			if (!iface->dhcpv4.renewal_time) {
@@ -670,8 +710,12 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read(frag, pos, &pos, length,
-					     iface->dhcpv4.server_id.s4_addr);
+			if (!net_nbuf_cursor_read(cursor,
+					iface->dhcpv4.server_id.s4_addr,
+					length)) {
+				return NET_DROP;
+			}
+
 			NET_DBG("options_server_id: %s",
 				net_sprint_ipv4_addr(&iface->dhcpv4.server_id));
 			break;
@@ -681,16 +725,27 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 				return NET_DROP;
 			}
 
-			frag = net_nbuf_read_u8(frag, pos, &pos, msg_type);
+			if (!net_nbuf_cursor_read_u8(cursor, msg_type)) {
+				return NET_DROP;
+			}
+
+			break;
+		case DHCPV4_OPTIONS_RAPID_COMMIT:
+			if (length != 0) {
+				NET_DBG("options_rapid_commit, bad length");
+				return NET_DROP;
+			}
+
+			*rapid_commit = true;
 			break;
 		default:
 			NET_DBG("option unknown: %d", type);
-			frag = net_nbuf_skip(frag, pos, &pos, length);
-			break;
-		}
 
-		if (!frag && pos) {
-			return NET_DROP;
+			if (!net_nbuf_cursor_skip(cursor, length)) {
+				return NET_DROP;
+			}
+
+			break;
 		}
 	}
 
@@ -698,12 +753,54 @@ static enum net_verdict parse_options(struct net_if *iface, struct net_buf *buf,
 	return NET_DROP;
 }
 
-/* TODO: Handles only DHCPv4 OFFER and ACK messages */
-static inline void handle_dhcpv4_reply(struct net_if *iface, uint8_t msg_type)
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+static void store_lease(struct net_if *iface)
+{
+	struct net_dhcpv4_lease lease;
+
+	if (!lease_storage) {
+		return;
+	}
+
+	net_ipaddr_copy(&lease.addr, &iface->dhcpv4.requested_ip);
+	net_ipaddr_copy(&lease.server_id, &iface->dhcpv4.server_id);
+
+	if (lease_storage->store(iface, &lease) < 0) {
+		NET_DBG("Failed to store the lease");
+	}
+}
+#endif
+
+/* TODO: Handles only DHCPv4 OFFER, ACK and NAK messages */
+static inline void handle_dhcpv4_reply(struct net_if *iface, uint8_t msg_type,
+				       bool rapid_commit)
 {
 	NET_DBG("state=%s msg=%s",
 		net_dhcpv4_state_name(iface->dhcpv4.state),
 		net_dhcpv4_msg_type_name(msg_type));
+
+#if defined(CONFIG_NET_DHCPV4_RAPID_COMMIT)
+	/* The ACK to the DISCOVER takes the place of the OFFER, REQUEST
+	 * and ACK exchange, RFC 4039
+	 */
+	if (iface->dhcpv4.state == NET_DHCPV4_DISCOVER &&
+	    msg_type == DHCPV4_MSG_TYPE_ACK && rapid_commit) {
+		k_delayed_work_cancel(&iface->dhcpv4_timeout);
+		iface->dhcpv4.state = NET_DHCPV4_REQUEST;
+	}
+#else
+	ARG_UNUSED(rapid_commit);
+#endif
+
+	/* The last lease is not valid anymore, get a new one */
+	if (iface->dhcpv4.state == NET_DHCPV4_INIT_REBOOT &&
+	    msg_type == DHCPV4_MSG_TYPE_NAK) {
+		k_delayed_work_cancel(&iface->dhcpv4_timeout);
+
+		iface->dhcpv4.attempts = 0;
+		send_discover(iface);
+		return;
+	}
 	/* Check for previous state, reason behind this check is, if client
 	 * receives multiple OFFER messages, first one will be handled.
 	 * Rest of the replies are discarded.
@@ -718,9 +815,10 @@ static inline void handle_dhcpv4_reply(struct net_if *iface, uint8_t msg_type)
 		k_delayed_work_cancel(&iface->dhcpv4_timeout);
 
 		iface->dhcpv4.attempts = 0;
-		send_request(iface, false);
+		send_request(iface, NET_DHCPV4_REQUEST);
 
 	} else if (iface->dhcpv4.state == NET_DHCPV4_REQUEST ||
+		   iface->dhcpv4.state == NET_DHCPV4_INIT_REBOOT ||
 		   iface->dhcpv4.state == NET_DHCPV4_RENEWAL) {
 		uint32_t timeout;
 
@@ -735,6 +833,7 @@ static inline void handle_dhcpv4_reply(struct net_if *iface, uint8_t msg_type)
 
 		switch (iface->dhcpv4.state) {
 		case NET_DHCPV4_REQUEST:
+		case NET_DHCPV4_INIT_REBOOT:
 			NET_INFO("Received: %s",
 				 net_sprint_ipv4_addr(
 					 &iface->dhcpv4.requested_ip));
@@ -747,6 +846,9 @@ static inline void handle_dhcpv4_reply(struct net_if *iface, uint8_t msg_type)
 				return;
 			}
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+			store_lease(iface);
+#endif
 			break;
 		case NET_DHCPV4_RENEWAL:
 			/* TODO: If the renewal is success, update only
@@ -774,12 +876,13 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 					 struct net_buf *buf,
 					 void *user_data)
 {
+	struct net_nbuf_cursor cursor;
 	struct dhcp_msg *msg;
 	struct net_buf *frag;
 	struct net_if *iface;
+	bool rapid_commit = false;
 	uint8_t	msg_type;
 	uint8_t min;
-	uint16_t pos;
 
 	if (!conn) {
 		NET_DBG("Invalid connection");
@@ -836,20 +939,21 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 	       sizeof(msg->yiaddr));
 
 	/* SNAME, FILE are not used at the moment, skip it */
-	frag = net_nbuf_skip(frag, min, &pos, SIZE_OF_SNAME + SIZE_OF_FILE);
-	if (!frag && pos) {
+	if (!net_nbuf_cursor_init(&cursor, frag, min) ||
+	    !net_nbuf_cursor_skip(&cursor, SIZE_OF_SNAME + SIZE_OF_FILE)) {
 		NET_DBG("short packet while skipping sname");
 		goto drop;
 	}
 
-	if (parse_options(iface, frag, pos, &msg_type) == NET_DROP) {
+	if (parse_options(iface, &cursor, &msg_type,
+			  &rapid_commit) == NET_DROP) {
 		NET_DBG("Invalid Options");
 		goto drop;
 	}
 
 	net_nbuf_unref(buf);
 
-	handle_dhcpv4_reply(iface, msg_type);
+	handle_dhcpv4_reply(iface, msg_type, rapid_commit);
 
 	return NET_OK;
 
@@ -895,12 +999,39 @@ void net_dhcpv4_start(struct net_if *iface)
 		return;
 	}
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+	/* Request the last lease right away, RFC2131 4.4.2 */
+	if (lease_storage) {
+		struct net_dhcpv4_lease lease;
+
+		if (lease_storage->load(iface, &lease) == 0) {
+			net_ipaddr_copy(&iface->dhcpv4.requested_ip,
+					&lease.addr);
+			net_ipaddr_copy(&iface->dhcpv4.server_id,
+					&lease.server_id);
+			iface->dhcpv4.state = NET_DHCPV4_INIT_REBOOT;
+
+			NET_DBG("enter state=%s",
+				net_dhcpv4_state_name(iface->dhcpv4.state));
+
+			k_delayed_work_init(&iface->dhcpv4_timeout,
+					    dhcpv4_timeout);
+			k_delayed_work_submit(&iface->dhcpv4_timeout, 0);
+			return;
+		}
+	}
+#endif
+
 	/* RFC2131 4.1.1 requires we wait a random period between 1
 	 * and 10 seconds before sending the initial discover.
 	 */
+#if DHCPV4_INITIAL_DELAY_MAX > DHCPV4_INITIAL_DELAY_MIN
 	timeout = entropy %
 		(DHCPV4_INITIAL_DELAY_MAX - DHCPV4_INITIAL_DELAY_MIN) +
 		DHCPV4_INITIAL_DELAY_MIN;
+#else
+	timeout = DHCPV4_INITIAL_DELAY_MAX;
+#endif
 
 	NET_DBG("enter state=%s timeout=%"PRIu32"s",
 		net_dhcpv4_state_name(iface->dhcpv4.state), timeout);
@@ -908,3 +1039,11 @@ void net_dhcpv4_start(struct net_if *iface)
 	k_delayed_work_init(&iface->dhcpv4_timeout, dhcpv4_timeout);
 	k_delayed_work_submit(&iface->dhcpv4_timeout, timeout * MSEC_PER_SEC);
 }
+
+#if defined(CONFIG_NET_DHCPV4_LEASE_REUSE)
+void net_dhcpv4_lease_storage_register(
+	const struct net_dhcpv4_lease_storage *storage)
+{
+	lease_storage = storage;
+}
+#endif
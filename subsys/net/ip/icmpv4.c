@@ -20,6 +20,7 @@
 #include <net/net_if.h>
 #include "net_private.h"
 #include "icmpv4.h"
+#include "pmtu.h"
 #include "net_stats.h"
 
 static inline enum net_verdict handle_echo_request(struct net_buf *buf)
@@ -162,6 +163,50 @@ int net_icmpv4_send_echo_request(struct net_if *iface,
 	return -EIO;
 }
 
+#if defined(CONFIG_NET_PMTU)
+/* Smallest MTU an IPv4 path can have (RFC 791) */
+#define NET_ICMPV4_MIN_MTU 68
+
+/* The next hop MTU is in the second half of the unused field (RFC 1191),
+ * followed by the IPv4 header of the packet that did not fit in it.
+ */
+static inline enum net_verdict handle_frag_needed(struct net_buf *buf)
+{
+	struct net_nbuf_cursor cursor;
+	struct in_addr dst;
+	uint16_t mtu;
+
+	if (!net_nbuf_cursor_init(&cursor, buf->frags,
+				  net_nbuf_ip_hdr_len(buf) +
+				  net_nbuf_ext_len(buf) +
+				  sizeof(struct net_icmp_hdr) +
+				  sizeof(uint16_t)) ||
+	    !net_nbuf_cursor_read_be16(&cursor, &mtu) ||
+	    !net_nbuf_cursor_skip(&cursor,
+				  offsetof(struct net_ipv4_hdr, dst)) ||
+	    !net_nbuf_cursor_read(&cursor, &dst, sizeof(dst))) {
+		NET_DBG("Truncated Fragmentation Needed message");
+		net_stats_update_icmp_drop();
+		return NET_DROP;
+	}
+
+	NET_DBG("Fragmentation Needed for %s, MTU %u",
+		net_sprint_ipv4_addr(&dst), mtu);
+
+	/* Routers predating RFC 1191 leave the MTU to 0 */
+	if (mtu < NET_ICMPV4_MIN_MTU) {
+		net_stats_update_icmp_drop();
+		return NET_DROP;
+	}
+
+	net_pmtu_update(AF_INET, &dst, mtu);
+
+	net_nbuf_unref(buf);
+
+	return NET_OK;
+}
+#endif /* CONFIG_NET_PMTU */
+
 enum net_verdict net_icmpv4_input(struct net_buf *buf, uint16_t len,
 				  uint8_t type, uint8_t code)
 {
@@ -171,6 +216,14 @@ enum net_verdict net_icmpv4_input(struct net_buf *buf, uint16_t len,
 	switch (type) {
 	case NET_ICMPV4_ECHO_REQUEST:
 		return handle_echo_request(buf);
+#if defined(CONFIG_NET_PMTU)
+	case NET_ICMPV4_DST_UNREACH:
+		if (code == NET_ICMPV4_DST_UNREACH_FRAG) {
+			return handle_frag_needed(buf);
+		}
+
+		break;
+#endif
 	}
 
 	return NET_DROP;
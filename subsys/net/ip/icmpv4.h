@@ -24,6 +24,7 @@
 
 #define NET_ICMPV4_DST_UNREACH_NO_PROTO  2 /* Protocol not supported */
 #define NET_ICMPV4_DST_UNREACH_NO_PORT   3 /* Port unreachable */
+#define NET_ICMPV4_DST_UNREACH_FRAG      4 /* Fragmentation needed */
 
 struct net_icmpv4_echo_req {
 	uint16_t identifier;
@@ -22,6 +22,7 @@
 #include "net_private.h"
 #include "icmpv6.h"
 #include "ipv6.h"
+#include "pmtu.h"
 #include "net_stats.h"
 
 static sys_slist_t handlers;
@@ -359,6 +360,47 @@ enum net_verdict net_icmpv6_input(struct net_buf *buf, uint16_t len,
 	return NET_DROP;
 }
 
+#if defined(CONFIG_NET_PMTU)
+/* The message holds the MTU of the next hop, and as much of the packet
+ * that did not fit in it as possible, its IPv6 header in particular.
+ */
+static enum net_verdict handle_packet_too_big(struct net_buf *buf)
+{
+	struct net_nbuf_cursor cursor;
+	struct in6_addr dst;
+	uint32_t mtu;
+
+	if (!net_nbuf_cursor_init(&cursor, buf->frags,
+				  net_nbuf_ip_hdr_len(buf) +
+				  net_nbuf_ext_len(buf) +
+				  sizeof(struct net_icmp_hdr)) ||
+	    !net_nbuf_cursor_read_be32(&cursor, &mtu) ||
+	    !net_nbuf_cursor_skip(&cursor,
+				  offsetof(struct net_ipv6_hdr, dst)) ||
+	    !net_nbuf_cursor_read(&cursor, &dst, sizeof(dst))) {
+		NET_DBG("Truncated Packet Too Big message");
+		net_stats_update_icmp_drop();
+		return NET_DROP;
+	}
+
+	NET_DBG("Packet Too Big for %s, MTU %u", net_sprint_ipv6_addr(&dst),
+		mtu);
+
+	/* RFC 8201 ch 4: the path MTU does not go below the IPv6 minimum */
+	net_pmtu_update(AF_INET6, &dst, max(min(mtu, 0xffff), NET_IPV6_MTU));
+
+	net_nbuf_unref(buf);
+
+	return NET_OK;
+}
+
+static struct net_icmpv6_handler packet_too_big_handler = {
+	.type = NET_ICMPV6_PACKET_TOO_BIG,
+	.code = 0,
+	.handler = handle_packet_too_big,
+};
+#endif /* CONFIG_NET_PMTU */
+
 static struct net_icmpv6_handler echo_request_handler = {
 	.type = NET_ICMPV6_ECHO_REQUEST,
 	.code = 0,
@@ -368,4 +410,7 @@ static struct net_icmpv6_handler echo_request_handler = {
 void net_icmpv6_init(void)
 {
 	net_icmpv6_register_handler(&echo_request_handler);
+#if defined(CONFIG_NET_PMTU)
+	net_icmpv6_register_handler(&packet_too_big_handler);
+#endif
 }
@@ -30,6 +30,7 @@
 #include "6lo.h"
 #include "route.h"
 #include "rpl.h"
+#include "pmtu.h"
 #include "net_stats.h"
 
 #if defined(CONFIG_NET_IPV6_ND)
@@ -51,6 +52,14 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+#define NBR_INDEX_SIZE NET_NBR_INDEX_SIZE(CONFIG_NET_IPV6_MAX_NEIGHBORS)
+
+/* The neighbors, by hash of their IPv6 address */
+static struct net_nbr_index_slot nbr_index[NBR_INDEX_SIZE];
+
+/* Stamp of the last lookup, for the least recently used neighbor */
+static uint32_t nbr_lookup_stamp;
+
 static inline bool net_is_solicited(struct net_buf *buf)
 {
 	return NET_ICMPV6_NA_BUF(buf)->flags & NET_ICMPV6_NA_FLAG_SOLICITED;
@@ -119,7 +128,7 @@ void nbr_print(void)
 			net_ipv6_nbr_data(nbr)->is_router,
 			net_ipv6_nbr_data(nbr)->state,
 			net_ipv6_nbr_data(nbr)->link_metric,
-			net_ipv6_nbr_data(nbr)->pending,
+			net_ipv6_nbr_data(nbr)->pending[0],
 			nbr->iface, nbr->idx,
 			nbr->idx == NET_NBR_LLADDR_UNKNOWN ? "?" :
 			net_sprint_ll_addr(
@@ -132,13 +141,35 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+static inline uint32_t nbr_hash(struct in6_addr *addr)
+{
+	return net_nbr_index_hash(addr, sizeof(*addr));
+}
+
+static inline uint8_t nbr_entry(struct net_nbr *nbr)
+{
+	return ((uint8_t *)nbr - (uint8_t *)net_neighbor_pool) /
+		sizeof(net_neighbor_pool[0]);
+}
+
+static void nbr_index_add(struct net_nbr *nbr)
+{
+	net_ipv6_nbr_data(nbr)->last_used = nbr_lookup_stamp;
+
+	net_nbr_index_add(nbr_index, NBR_INDEX_SIZE,
+			  nbr_hash(&net_ipv6_nbr_data(nbr)->addr),
+			  nbr_entry(nbr));
+}
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
+	uint32_t hash = nbr_hash(addr);
+	int pos = -1, i;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+	while ((i = net_nbr_index_find(nbr_index, NBR_INDEX_SIZE,
+				       hash, &pos)) >= 0) {
 		struct net_nbr *nbr = get_nbr(i);
 
 		if (!nbr->ref) {
@@ -147,6 +178,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 
 		if (nbr->iface == iface &&
 		    net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+			net_ipv6_nbr_data(nbr)->last_used = ++nbr_lookup_stamp;
 			return nbr;
 		}
 	}
@@ -163,6 +195,21 @@ struct net_ipv6_nbr_data *net_ipv6_get_nbr_by_index(uint8_t idx)
 	return net_ipv6_nbr_data(nbr);
 }
 
+/* Each pending buffer holds the reference taken when it was queued and
+ * the one of its original allocation.
+ */
+static void nbr_drop_pending(struct net_ipv6_nbr_data *data)
+{
+	int i;
+
+	for (i = 0; i < NET_IPV6_ND_PENDING_COUNT && data->pending[i];
+	     i++) {
+		net_nbuf_unref(data->pending[i]);
+		net_nbuf_unref(data->pending[i]);
+		data->pending[i] = NULL;
+	}
+}
+
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 {
 	int ret;
@@ -172,10 +219,54 @@ static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 		NET_DBG("Cannot cancel NS work (%d)", ret);
 	}
 
-	if (data->pending) {
-		net_nbuf_unref(data->pending);
-		data->pending = NULL;
+	nbr_drop_pending(data);
+}
+
+/* Queues the buffer behind the ones waiting for the same neighbor,
+ * returns whether it was queued
+ */
+static bool nbr_add_pending(struct net_ipv6_nbr_data *data,
+			    struct net_buf *buf)
+{
+	int i;
+
+	for (i = 0; i < NET_IPV6_ND_PENDING_COUNT; i++) {
+		if (data->pending[i] == buf) {
+			return false;
+		}
+
+		if (!data->pending[i]) {
+			data->pending[i] = net_nbuf_ref(buf);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Sends the pending buffers in the order they were queued */
+static void nbr_send_pending(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+	int i;
+
+	for (i = 0; i < NET_IPV6_ND_PENDING_COUNT && data->pending[i];
+	     i++) {
+		struct net_buf *pending = data->pending[i];
+
+		NET_DBG("Sending pending %p to %s", pending,
+			net_sprint_ipv6_addr(&NET_IPV6_BUF(pending)->dst));
+
+		data->pending[i] = NULL;
+
+		if (net_send_data(pending) < 0) {
+			net_nbuf_unref(pending);
+		}
+
+		net_nbuf_unref(pending);
 	}
+
+	nbr_clear_ns_pending(data);
 }
 
 static inline void nbr_free(struct net_nbr *nbr)
@@ -189,6 +280,45 @@ static inline void nbr_free(struct net_nbr *nbr)
 	net_nbr_unref(nbr);
 }
 
+/* Get a free neighbor, or make room by removing the least recently used
+ * one that only the cache refers to and that is not a router.
+ */
+static struct net_nbr *nbr_get(void)
+{
+	struct net_nbr *nbr, *oldest = NULL;
+	int i;
+
+	nbr = net_nbr_get(&net_neighbor.table);
+	if (nbr) {
+		return nbr;
+	}
+
+	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+		nbr = get_nbr(i);
+
+		if (nbr->ref != 1 || net_ipv6_nbr_data(nbr)->is_router) {
+			continue;
+		}
+
+		if (!oldest ||
+		    (int32_t)(net_ipv6_nbr_data(nbr)->last_used -
+			      net_ipv6_nbr_data(oldest)->last_used) < 0) {
+			oldest = nbr;
+		}
+	}
+
+	if (!oldest) {
+		return NULL;
+	}
+
+	NET_DBG("Removing least recently used nbr %p IPv6 %s", oldest,
+		net_sprint_ipv6_addr(&net_ipv6_nbr_data(oldest)->addr));
+
+	nbr_free(oldest);
+
+	return net_nbr_get(&net_neighbor.table);
+}
+
 bool net_ipv6_nbr_rm(struct net_if *iface, struct in6_addr *addr)
 {
 	struct net_nbr *nbr;
@@ -209,7 +339,7 @@ struct net_nbr *net_ipv6_nbr_add(struct net_if *iface,
 				 bool is_router,
 				 enum net_nbr_state state)
 {
-	struct net_nbr *nbr = net_nbr_get(&net_neighbor.table);
+	struct net_nbr *nbr = nbr_get();
 
 	if (!nbr) {
 		return NULL;
@@ -224,6 +354,8 @@ struct net_nbr *net_ipv6_nbr_add(struct net_if *iface,
 	net_ipv6_nbr_data(nbr)->state = state;
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 
+	nbr_index_add(nbr);
+
 	NET_DBG("[%d] nbr %p state %d router %d IPv6 %s ll %s",
 		nbr->idx, nbr, state, is_router,
 		net_sprint_ipv6_addr(addr),
@@ -246,7 +378,7 @@ static struct net_nbr *nbr_new(struct net_if *iface,
 			       struct in6_addr *addr,
 			       enum net_nbr_state state)
 {
-	struct net_nbr *nbr = net_nbr_get(&net_neighbor.table);
+	struct net_nbr *nbr = nbr_get();
 
 	if (!nbr) {
 		return NULL;
@@ -257,7 +389,10 @@ static struct net_nbr *nbr_new(struct net_if *iface,
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
 	net_ipv6_nbr_data(nbr)->state = state;
-	net_ipv6_nbr_data(nbr)->pending = NULL;
+	memset(net_ipv6_nbr_data(nbr)->pending, 0,
+	       sizeof(net_ipv6_nbr_data(nbr)->pending));
+
+	nbr_index_add(nbr);
 
 	NET_DBG("nbr %p iface %p state %d IPv6 %s",
 		nbr, iface, state, net_sprint_ipv6_addr(addr));
@@ -269,6 +404,10 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
+	net_nbr_index_remove(nbr_index, NBR_INDEX_SIZE,
+			     nbr_hash(&net_ipv6_nbr_data(nbr)->addr),
+			     nbr_entry(nbr));
+
 	return;
 }
 
@@ -376,6 +515,9 @@ struct net_buf *net_ipv6_finalize_raw(struct net_buf *buf,
 {
 	/* Set the length of the IPv6 header */
 	size_t total_len;
+#if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_TCP)
+	bool chksum;
+#endif
 
 #if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_RPL_INSERT_HBH_OPTION)
 	if (next_header != IPPROTO_TCP && next_header != IPPROTO_ICMPV6) {
@@ -395,17 +537,29 @@ struct net_buf *net_ipv6_finalize_raw(struct net_buf *buf,
 	NET_IPV6_BUF(buf)->len[0] = total_len / 256;
 	NET_IPV6_BUF(buf)->len[1] = total_len - NET_IPV6_BUF(buf)->len[0] * 256;
 
+#if defined(CONFIG_NET_UDP) || defined(CONFIG_NET_TCP)
+	/* The interface inserts the UDP and TCP checksums in the zeroed
+	 * fields, when they follow the IPv6 header of an unfragmented packet.
+	 */
+	chksum = !net_if_tx_chksum_offloaded(net_nbuf_iface(buf)) ||
+		 net_nbuf_ext_len(buf) || net_ipv6_must_fragment(buf);
+#endif
+
 #if defined(CONFIG_NET_UDP)
 	if (next_header == IPPROTO_UDP) {
 		NET_UDP_BUF(buf)->chksum = 0;
-		NET_UDP_BUF(buf)->chksum = ~net_calc_chksum_udp(buf);
+		if (chksum && !net_udp_is_local(buf)) {
+			NET_UDP_BUF(buf)->chksum = ~net_calc_chksum_udp(buf);
+		}
 	} else
 #endif
 
 #if defined(CONFIG_NET_TCP)
 	if (next_header == IPPROTO_TCP) {
 		NET_TCP_BUF(buf)->chksum = 0;
-		NET_TCP_BUF(buf)->chksum = ~net_calc_chksum_tcp(buf);
+		if (chksum) {
+			NET_TCP_BUF(buf)->chksum = ~net_calc_chksum_tcp(buf);
+		}
 	} else
 #endif
 
@@ -494,23 +648,17 @@ static void ns_reply_timeout(struct k_work *work)
 		return;
 	}
 
-	if (!data->pending) {
+	if (!data->pending[0]) {
 		/* Silently return, this is not an error as the work
 		 * cannot be cancelled in certain cases.
 		 */
 		return;
 	}
 
-	NET_DBG("NS nbr %p pending %p timeout to %s", nbr, data->pending,
-		net_sprint_ipv6_addr(&NET_IPV6_BUF(data->pending)->dst));
-
-	/* To unref when pending variable was set */
-	net_nbuf_unref(data->pending);
+	NET_DBG("NS nbr %p pending %p timeout to %s", nbr, data->pending[0],
+		net_sprint_ipv6_addr(&NET_IPV6_BUF(data->pending[0])->dst));
 
-	/* To unref the original buf allocation */
-	net_nbuf_unref(data->pending);
-
-	data->pending = NULL;
+	nbr_drop_pending(data);
 
 	net_nbr_unref(nbr);
 }
@@ -1070,7 +1218,8 @@ static enum net_verdict handle_ns_input(struct net_buf *buf)
 			goto drop;
 		}
 
-		if (ifaddr->addr_state == NET_ADDR_TENTATIVE) {
+		if (ifaddr->addr_state == NET_ADDR_TENTATIVE ||
+		    ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
 			NET_DBG("DAD failed for %s iface %p",
 				net_sprint_ipv6_addr(&ifaddr->address.in6_addr),
 				net_nbuf_iface(buf));
@@ -1123,6 +1272,15 @@ static enum net_verdict handle_ns_input(struct net_buf *buf)
 	}
 
 send_na:
+#if defined(CONFIG_NET_IPV6_OPTIMISTIC_DAD)
+	/* The address might be a duplicate, do not override the entry of
+	 * its owner in the caches, RFC 4429 3.3
+	 */
+	if (ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
+		flags &= ~NET_ICMPV6_NA_FLAG_OVERRIDE;
+	}
+#endif
+
 	ret = net_ipv6_send_na(net_nbuf_iface(buf),
 			       &NET_IPV6_BUF(buf)->src,
 			       &NET_IPV6_BUF(buf)->dst,
@@ -1239,7 +1397,6 @@ static inline bool handle_na_neighbor(struct net_buf *buf,
 	bool lladdr_changed = false;
 	struct net_nbr *nbr;
 	struct net_linkaddr_storage *cached_lladdr;
-	struct net_buf *pending;
 
 	ARG_UNUSED(hdr);
 
@@ -1371,21 +1528,12 @@ static inline bool handle_na_neighbor(struct net_buf *buf,
 
 send_pending:
 	/* Next send any pending messages to the peer. */
-	pending = net_ipv6_nbr_data(nbr)->pending;
-
-	if (pending) {
-		NET_DBG("Sending pending %p to %s lladdr %s", pending,
-			net_sprint_ipv6_addr(&NET_IPV6_BUF(pending)->dst),
+	if (net_ipv6_nbr_data(nbr)->pending[0]) {
+		NET_DBG("Sending pending to lladdr %s",
 			net_sprint_ll_addr(cached_lladdr->addr,
 					   cached_lladdr->len));
 
-		if (net_send_data(pending) < 0) {
-			nbr_clear_ns_pending(net_ipv6_nbr_data(nbr));
-		} else {
-			net_ipv6_nbr_data(nbr)->pending = NULL;
-		}
-
-		net_nbuf_unref(pending);
+		nbr_send_pending(nbr);
 	}
 
 	return true;
@@ -1471,7 +1619,8 @@ static enum net_verdict handle_na_input(struct net_buf *buf)
 			net_sprint_ipv6_addr(&NET_ICMPV6_NA_BUF(buf)->tgt));
 
 #if defined(CONFIG_NET_IPV6_DAD)
-		if (ifaddr->addr_state == NET_ADDR_TENTATIVE) {
+		if (ifaddr->addr_state == NET_ADDR_TENTATIVE ||
+		    ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
 			dad_failed(net_nbuf_iface(buf),
 				   &NET_ICMPV6_NA_BUF(buf)->tgt);
 		}
@@ -1496,6 +1645,24 @@ drop:
 	return NET_DROP;
 }
 
+/* No link-layer address option is sent from an optimistic address, as it
+ * could override the caches of the neighbors for its owner, RFC 4429 3.3
+ */
+static inline bool is_optimistic_src(struct net_if *iface,
+				     struct in6_addr *src)
+{
+#if defined(CONFIG_NET_IPV6_OPTIMISTIC_DAD)
+	struct net_if_addr *ifaddr;
+
+	ifaddr = net_if_ipv6_addr_lookup_by_iface(iface, src);
+	if (ifaddr && ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
+		return true;
+	}
+#endif
+
+	return false;
+}
+
 int net_ipv6_send_ns(struct net_if *iface,
 		     struct net_buf *pending,
 		     struct in6_addr *src,
@@ -1567,11 +1734,16 @@ int net_ipv6_send_ns(struct net_if *iface,
 			goto drop;
 		}
 
-		set_llao(&net_nbuf_iface(buf)->link_addr,
-			 net_nbuf_icmp_data(buf) +
-			 sizeof(struct net_icmp_hdr) +
-			 sizeof(struct net_icmpv6_ns_hdr),
-			 llao_len, NET_ICMPV6_ND_OPT_SLLAO);
+		if (is_optimistic_src(iface, &NET_IPV6_BUF(buf)->src)) {
+			NET_IPV6_BUF(buf)->len[1] -= llao_len;
+			llao_len = 0;
+		} else {
+			set_llao(&net_nbuf_iface(buf)->link_addr,
+				 net_nbuf_icmp_data(buf) +
+				 sizeof(struct net_icmp_hdr) +
+				 sizeof(struct net_icmpv6_ns_hdr),
+				 llao_len, NET_ICMPV6_ND_OPT_SLLAO);
+		}
 
 		net_buf_add(frag,
 			    sizeof(struct net_ipv6_hdr) +
@@ -1599,16 +1771,28 @@ int net_ipv6_send_ns(struct net_if *iface,
 	}
 
 	if (pending) {
-		if (!net_ipv6_nbr_data(nbr)->pending) {
-			net_ipv6_nbr_data(nbr)->pending = net_nbuf_ref(pending);
-		} else {
+		if (net_ipv6_nbr_data(nbr)->pending[0]) {
+			/* The solicitation is already on its way, just
+			 * wait for the same advertisement.
+			 */
+			if (nbr_add_pending(net_ipv6_nbr_data(nbr), pending)) {
+				NET_DBG("Buffer %p queued behind pending %p",
+					pending,
+					net_ipv6_nbr_data(nbr)->pending[0]);
+				net_nbuf_unref(buf);
+				return 0;
+			}
+
 			NET_DBG("Buffer %p already pending for "
 				"operation. Discarding pending %p and buf %p",
-				net_ipv6_nbr_data(nbr)->pending, pending, buf);
+				net_ipv6_nbr_data(nbr)->pending[0], pending,
+				buf);
 			net_nbuf_unref(pending);
 			goto drop;
 		}
 
+		nbr_add_pending(net_ipv6_nbr_data(nbr), pending);
+
 		NET_DBG("Setting timeout %d for NS", NS_REPLY_TIMEOUT);
 
 		k_delayed_work_init(&net_ipv6_nbr_data(nbr)->send_ns,
@@ -1665,14 +1849,14 @@ int net_ipv6_send_rs(struct net_if *iface)
 						    &NET_IPV6_BUF(buf)->dst));
 
 	unspec_src = net_is_ipv6_addr_unspecified(&NET_IPV6_BUF(buf)->src);
-	if (!unspec_src) {
+	if (!unspec_src && !is_optimistic_src(iface, &NET_IPV6_BUF(buf)->src)) {
 		llao_len = get_llao_len(net_nbuf_iface(buf));
 	}
 
 	setup_headers(buf, sizeof(struct net_icmpv6_rs_hdr) + llao_len,
 		      NET_ICMPV6_RS);
 
-	if (!unspec_src) {
+	if (llao_len) {
 		set_llao(&net_nbuf_iface(buf)->link_addr,
 			 net_nbuf_icmp_data(buf) +
 			 sizeof(struct net_icmp_hdr) +
@@ -2192,17 +2376,8 @@ static enum net_verdict handle_ra_input(struct net_buf *buf)
 				       router_lifetime);
 	}
 
-	if (nbr && net_ipv6_nbr_data(nbr)->pending) {
-		NET_DBG("Sending pending buf %p to %s",
-			net_ipv6_nbr_data(nbr)->pending,
-			net_sprint_ipv6_addr(&NET_IPV6_BUF(
-					net_ipv6_nbr_data(nbr)->pending)->dst));
-
-		if (net_send_data(net_ipv6_nbr_data(nbr)->pending) < 0) {
-			net_nbuf_unref(net_ipv6_nbr_data(nbr)->pending);
-		}
-
-		nbr_clear_ns_pending(net_ipv6_nbr_data(nbr));
+	if (nbr && net_ipv6_nbr_data(nbr)->pending[0]) {
+		nbr_send_pending(nbr);
 	}
 
 	/* Cancel the RS timer on iface */
@@ -2219,6 +2394,436 @@ drop:
 }
 #endif /* CONFIG_NET_IPV6_ND */
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+/* Fragment offset field of the fragment header */
+#define NET_IPV6_FRAG_MORE	0x0001
+#define NET_IPV6_FRAG_OFFSET	0xfff8
+
+struct net_ipv6_frag {
+	struct net_buf *buf;
+
+	/** Offset of the fragment data in the packet */
+	uint16_t offset;
+
+	/** Length of the fragment data */
+	uint16_t len;
+
+	/** Length of the headers, up to the end of the fragment header */
+	uint16_t hdr_len;
+};
+
+/* A packet being reassembled, its fragments sorted by offset. The entry
+ * is free when it holds no fragment.
+ */
+struct net_ipv6_reassembly {
+	struct k_delayed_work timer;
+	uint32_t id;
+
+	/** Length of the packet data, 0 until the last fragment is received */
+	uint16_t total;
+
+	/** Offset of the next header field referring to the fragment header,
+	 * in the first fragment.
+	 */
+	uint16_t prev_hdr;
+
+	uint8_t count;
+	struct net_ipv6_frag frags[CONFIG_NET_IPV6_FRAGMENT_MAX_PKT];
+};
+
+static struct net_ipv6_reassembly
+reassembly[CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT];
+
+static uint32_t frag_id;
+
+static void reassembly_release(struct net_ipv6_reassembly *entry)
+{
+	int i;
+
+	k_delayed_work_cancel(&entry->timer);
+
+	for (i = 0; i < entry->count; i++) {
+		if (entry->frags[i].buf) {
+			net_nbuf_unref(entry->frags[i].buf);
+		}
+	}
+
+	entry->count = 0;
+}
+
+static void reassembly_timeout(struct k_work *work)
+{
+	struct net_ipv6_reassembly *entry =
+		CONTAINER_OF(work, struct net_ipv6_reassembly, timer);
+	struct net_buf *first = NULL;
+
+	NET_DBG("Reassembly of packet 0x%x timed out", entry->id);
+
+	/* RFC 8200 ch 4.5: the source is told about it only if the first
+	 * fragment was received. The error is sent once the entry is
+	 * released, as getting a buffer for it may block.
+	 */
+	if (entry->count && entry->frags[0].offset == 0) {
+		first = entry->frags[0].buf;
+		entry->frags[0].buf = NULL;
+	}
+
+	reassembly_release(entry);
+	net_stats_update_ipv6_drop();
+
+	if (first) {
+		net_icmpv6_send_error(first, NET_ICMPV6_TIME_EXCEEDED, 1, 0);
+		net_nbuf_unref(first);
+	}
+}
+
+static struct net_ipv6_reassembly *reassembly_get(struct net_buf *buf,
+						   uint32_t id)
+{
+	struct net_ipv6_reassembly *unused = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(reassembly); i++) {
+		struct net_ipv6_reassembly *entry = &reassembly[i];
+		struct net_ipv6_hdr *hdr;
+
+		if (!entry->count) {
+			if (!unused) {
+				unused = entry;
+			}
+
+			continue;
+		}
+
+		hdr = NET_IPV6_BUF(entry->frags[0].buf);
+
+		if (entry->id == id &&
+		    net_ipv6_addr_cmp(&hdr->src, &NET_IPV6_BUF(buf)->src) &&
+		    net_ipv6_addr_cmp(&hdr->dst, &NET_IPV6_BUF(buf)->dst)) {
+			return entry;
+		}
+	}
+
+	if (unused) {
+		unused->id = id;
+		unused->total = 0;
+
+		k_delayed_work_submit(&unused->timer,
+				K_SECONDS(CONFIG_NET_IPV6_FRAGMENT_TIMEOUT));
+	}
+
+	return unused;
+}
+
+/* Chain the data of the fragments after the headers of the first one,
+ * without copying it, and remove the fragment header.
+ */
+static struct net_buf *reassemble(struct net_ipv6_frag *frags, int count,
+				  uint16_t prev_hdr)
+{
+	struct net_buf *first = frags[0].buf;
+	struct net_buf *frag = first->frags;
+	uint16_t frag_hdr = frags[0].hdr_len - NET_IPV6_FRAGH_LEN;
+	size_t len;
+	int i;
+
+	frag->data[prev_hdr] = frag->data[frag_hdr];
+	memmove(frag->data + NET_IPV6_FRAGH_LEN, frag->data, frag_hdr);
+	net_buf_pull(frag, NET_IPV6_FRAGH_LEN);
+
+	for (i = 1; i < count; i++) {
+		struct net_buf *buf = frags[i].buf;
+
+		net_nbuf_pull(buf, frags[i].hdr_len);
+
+		net_buf_frag_add(first, buf->frags);
+		buf->frags = NULL;
+		net_nbuf_unref(buf);
+	}
+
+	len = net_buf_frags_len(first->frags) - sizeof(struct net_ipv6_hdr);
+
+	NET_IPV6_BUF(first)->len[0] = len / 256;
+	NET_IPV6_BUF(first)->len[1] = len - NET_IPV6_BUF(first)->len[0] * 256;
+
+	NET_DBG("Reassembled packet %p of %d fragments, %zu bytes", first,
+		count, len);
+
+	return first;
+}
+
+struct net_buf *net_ipv6_reassemble(struct net_buf *buf, uint16_t prev_hdr,
+				    uint16_t frag_hdr)
+{
+	struct net_ipv6_reassembly *entry;
+	struct net_nbuf_cursor cursor;
+	struct net_ipv6_frag frag;
+	uint16_t flags, expected;
+	uint32_t id;
+	int i;
+
+	if (!net_nbuf_cursor_init(&cursor, buf->frags,
+				  frag_hdr + sizeof(uint16_t)) ||
+	    !net_nbuf_cursor_read_be16(&cursor, &flags) ||
+	    !net_nbuf_cursor_read_be32(&cursor, &id)) {
+		NET_DBG("Truncated fragment header");
+		goto drop;
+	}
+
+	frag.buf = buf;
+	frag.offset = flags & NET_IPV6_FRAG_OFFSET;
+	frag.hdr_len = frag_hdr + NET_IPV6_FRAGH_LEN;
+	frag.len = net_buf_frags_len(buf->frags) - frag.hdr_len;
+
+	/* RFC 8200 ch 4.5: all fragments but the last are multiples of 8
+	 * bytes, and the packet cannot be longer than the payload length
+	 * field allows.
+	 */
+	if ((flags & NET_IPV6_FRAG_MORE) && (frag.len & 0x07)) {
+		net_icmpv6_send_error(buf, NET_ICMPV6_PARAM_PROBLEM,
+				      NET_ICMPV6_PARAM_PROB_HEADER,
+				      offsetof(struct net_ipv6_hdr, len));
+		goto drop;
+	}
+
+	if (frag_hdr - sizeof(struct net_ipv6_hdr) + frag.offset +
+	    frag.len > 0xffff) {
+		net_icmpv6_send_error(buf, NET_ICMPV6_PARAM_PROBLEM,
+				      NET_ICMPV6_PARAM_PROB_HEADER,
+				      frag_hdr + sizeof(uint16_t));
+		goto drop;
+	}
+
+	/* The headers of the first fragment are moved over the fragment
+	 * header in place.
+	 */
+	if (!frag.offset && buf->frags->len < frag.hdr_len) {
+		NET_DBG("Headers of the first fragment split between buffers");
+		goto drop;
+	}
+
+	/* An atomic fragment is processed on its own (RFC 6946) */
+	if (!frag.offset && !(flags & NET_IPV6_FRAG_MORE)) {
+		return reassemble(&frag, 1, prev_hdr);
+	}
+
+	entry = reassembly_get(buf, id);
+	if (!entry) {
+		NET_DBG("No free reassembly entry for packet 0x%x", id);
+		goto drop;
+	}
+
+	if (entry->count == CONFIG_NET_IPV6_FRAGMENT_MAX_PKT) {
+		NET_DBG("Too many fragments in packet 0x%x", id);
+		goto drop_entry;
+	}
+
+	for (i = entry->count; i > 0; i--) {
+		if (entry->frags[i - 1].offset < frag.offset) {
+			break;
+		}
+	}
+
+	/* Overlapping fragments get the whole packet dropped (RFC 5722) */
+	if ((i > 0 && entry->frags[i - 1].offset +
+	     entry->frags[i - 1].len > frag.offset) ||
+	    (i < entry->count &&
+	     frag.offset + frag.len > entry->frags[i].offset)) {
+		NET_DBG("Overlapping fragments in packet 0x%x", id);
+		goto drop_entry;
+	}
+
+	if (!(flags & NET_IPV6_FRAG_MORE)) {
+		if (entry->total || i < entry->count) {
+			goto drop_entry;
+		}
+
+		entry->total = frag.offset + frag.len;
+	} else if (entry->total && frag.offset + frag.len >= entry->total) {
+		goto drop_entry;
+	}
+
+	if (!frag.offset) {
+		entry->prev_hdr = prev_hdr;
+	}
+
+	memmove(&entry->frags[i + 1], &entry->frags[i],
+		(entry->count - i) * sizeof(entry->frags[0]));
+	entry->frags[i] = frag;
+	entry->count++;
+
+	if (!entry->total) {
+		return NULL;
+	}
+
+	for (i = 0, expected = 0; i < entry->count; i++) {
+		if (entry->frags[i].offset != expected) {
+			return NULL;
+		}
+
+		expected += entry->frags[i].len;
+	}
+
+	k_delayed_work_cancel(&entry->timer);
+	buf = reassemble(entry->frags, entry->count, entry->prev_hdr);
+	entry->count = 0;
+
+	return buf;
+
+drop_entry:
+	reassembly_release(entry);
+
+drop:
+	net_nbuf_unref(buf);
+	net_stats_update_ipv6_drop();
+
+	return NULL;
+}
+
+static inline uint16_t path_mtu(struct net_buf *buf)
+{
+	return net_pmtu_get_mtu(net_nbuf_iface(buf), AF_INET6,
+				&NET_IPV6_BUF(buf)->dst);
+}
+
+bool net_ipv6_must_fragment(struct net_buf *buf)
+{
+	return net_buf_frags_len(buf->frags) > path_mtu(buf);
+}
+
+/* A fragment gets a copy of the headers, its fragment header and the next
+ * len bytes of data at the cursor.
+ */
+static struct net_buf *fragment_get(struct net_buf *buf,
+				     struct net_nbuf_cursor *cursor,
+				     uint16_t unfrag_len,
+				     const uint8_t *frag_hdr, uint16_t len)
+{
+	struct net_buf *frag;
+	size_t total;
+
+	frag = net_nbuf_get_reserve_tx(0, K_FOREVER);
+
+	net_nbuf_set_iface(frag, net_nbuf_iface(buf));
+	net_nbuf_set_family(frag, AF_INET6);
+	net_nbuf_set_ll_reserve(frag, net_nbuf_ll_reserve(buf));
+	net_nbuf_set_ip_hdr_len(frag, sizeof(struct net_ipv6_hdr));
+	net_nbuf_set_ext_len(frag, unfrag_len - sizeof(struct net_ipv6_hdr) +
+			     NET_IPV6_FRAGH_LEN);
+	*net_nbuf_ll_src(frag) = *net_nbuf_ll_src(buf);
+	*net_nbuf_ll_dst(frag) = *net_nbuf_ll_dst(buf);
+
+	if (!net_nbuf_append(frag, unfrag_len, buf->frags->data, K_FOREVER) ||
+	    !net_nbuf_append(frag, NET_IPV6_FRAGH_LEN, frag_hdr, K_FOREVER)) {
+		goto fail;
+	}
+
+	while (len) {
+		uint16_t avail;
+		uint8_t *data = net_nbuf_cursor_data(cursor, &avail);
+
+		avail = min(avail, len);
+
+		if (!net_nbuf_append(frag, avail, data, K_FOREVER)) {
+			goto fail;
+		}
+
+		net_nbuf_cursor_skip(cursor, avail);
+		len -= avail;
+	}
+
+	total = net_buf_frags_len(frag->frags) - sizeof(struct net_ipv6_hdr);
+
+	NET_IPV6_BUF(frag)->len[0] = total / 256;
+	NET_IPV6_BUF(frag)->len[1] = total - NET_IPV6_BUF(frag)->len[0] * 256;
+
+	return frag;
+
+fail:
+	net_nbuf_unref(frag);
+
+	return NULL;
+}
+
+int net_ipv6_send_fragments(struct net_if *iface, struct net_buf *buf)
+{
+	uint16_t unfrag_len = sizeof(struct net_ipv6_hdr) +
+			      net_nbuf_ext_len(buf);
+	uint8_t frag_hdr[NET_IPV6_FRAGH_LEN];
+	struct net_nbuf_cursor cursor;
+	uint16_t offset, payload, fit, pos;
+	uint8_t *prev;
+
+	/* The headers repeated in every fragment, the extension headers
+	 * before the upper layer one, are in the first buffer.
+	 */
+	if (buf->frags->len < unfrag_len) {
+		NET_DBG("Headers of %p split between buffers", buf);
+		return -EINVAL;
+	}
+
+	prev = &NET_IPV6_BUF(buf)->nexthdr;
+	for (pos = sizeof(struct net_ipv6_hdr); pos < unfrag_len;
+	     pos += (prev[1] + 1) * 8) {
+		prev = buf->frags->data + pos;
+	}
+
+	frag_hdr[0] = *prev;
+	frag_hdr[1] = 0;
+	sys_put_be32(++frag_id, &frag_hdr[4]);
+
+	*prev = NET_IPV6_NEXTHDR_FRAG;
+
+	payload = net_buf_frags_len(buf->frags) - unfrag_len;
+	fit = (path_mtu(buf) - unfrag_len - NET_IPV6_FRAGH_LEN) &
+	      NET_IPV6_FRAG_OFFSET;
+
+	net_nbuf_cursor_init(&cursor, buf->frags, unfrag_len);
+
+	for (offset = 0; offset < payload; offset += fit) {
+		uint16_t len = min(fit, payload - offset);
+		struct net_buf *frag;
+
+		sys_put_be16(offset | (offset + len < payload ?
+				       NET_IPV6_FRAG_MORE : 0), &frag_hdr[2]);
+
+		frag = fragment_get(buf, &cursor, unfrag_len, frag_hdr, len);
+		if (!frag) {
+			return -ENOMEM;
+		}
+
+		/* The sender is told once the last fragment is sent */
+		if (offset + len == payload) {
+			net_nbuf_set_context(frag, net_nbuf_context(buf));
+			net_nbuf_set_token(frag, net_nbuf_token(buf));
+		}
+
+		NET_DBG("Sending fragment %p offset %u len %u of %p", frag,
+			offset, len, buf);
+
+		if (iface->l2->send(iface, frag) == NET_DROP) {
+			net_nbuf_unref(frag);
+			return -EIO;
+		}
+	}
+
+	net_nbuf_unref(buf);
+
+	return 0;
+}
+
+static void reassembly_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(reassembly); i++) {
+		k_delayed_work_init(&reassembly[i].timer, reassembly_timeout);
+	}
+
+	frag_id = sys_rand32_get();
+}
+#endif /* CONFIG_NET_IPV6_FRAGMENT */
+
 #if defined(CONFIG_NET_IPV6_ND)
 static struct net_icmpv6_handler ns_input_handler = {
 	.type = NET_ICMPV6_NS,
@@ -2246,4 +2851,8 @@ void net_ipv6_init(void)
 	net_icmpv6_register_handler(&na_input_handler);
 	net_icmpv6_register_handler(&ra_input_handler);
 #endif
+
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+	reassembly_init();
+#endif
 }
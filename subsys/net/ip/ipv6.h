@@ -28,6 +28,12 @@
 
 #define NET_IPV6_DEFAULT_PREFIX_LEN 64
 
+#if defined(CONFIG_NET_IPV6_ND_PENDING_COUNT)
+#define NET_IPV6_ND_PENDING_COUNT CONFIG_NET_IPV6_ND_PENDING_COUNT
+#else
+#define NET_IPV6_ND_PENDING_COUNT 1
+#endif
+
 #define NET_MAX_RS_COUNT 3
 
 /**
@@ -66,8 +72,8 @@ enum net_nbr_state {
  * @brief IPv6 neighbor information.
  */
 struct net_ipv6_nbr_data {
-	/** Any pending buffer waiting ND to finish. */
-	struct net_buf *pending;
+	/** Any pending buffers waiting ND to finish, in sending order. */
+	struct net_buf *pending[NET_IPV6_ND_PENDING_COUNT];
 
 	/** IPv6 address. */
 	struct in6_addr addr;
@@ -89,6 +95,9 @@ struct net_ipv6_nbr_data {
 
 	/** Is the neighbor a router */
 	bool is_router;
+
+	/** Stamp of its last lookup, to find the least recently used */
+	uint32_t last_used;
 };
 
 static inline struct net_ipv6_nbr_data *net_ipv6_nbr_data(struct net_nbr *nbr)
@@ -319,6 +328,48 @@ static inline void net_ipv6_nbr_set_reachable_timer(struct net_if *iface,
 }
 #endif
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+/**
+ * @brief Add a received fragment to the packet it belongs to.
+ *
+ * @details The fragment is kept until all the fragments of its packet are
+ * received, then their data is chained after the headers of the first one,
+ * without the fragment header. Invalid fragments are released.
+ *
+ * @param buf Network buffer of the fragment.
+ * @param prev_hdr Offset of the next header field referring to the
+ * fragment header.
+ * @param frag_hdr Offset of the fragment header.
+ *
+ * @return The reassembled packet if this fragment completed it, NULL
+ * otherwise. The fragment buffer is owned by the reassembly in any case.
+ */
+struct net_buf *net_ipv6_reassemble(struct net_buf *buf, uint16_t prev_hdr,
+				    uint16_t frag_hdr);
+
+/**
+ * @brief Tell whether a packet is too big to be sent as is.
+ *
+ * @param buf Network buffer of the packet.
+ *
+ * @return True if the packet must be sent with net_ipv6_send_fragments().
+ */
+bool net_ipv6_must_fragment(struct net_buf *buf);
+
+/**
+ * @brief Send a packet in fragments that fit in the MTU.
+ *
+ * @param iface Network interface to send the fragments to.
+ * @param buf Network buffer of the packet, released if all the fragments
+ * could be sent.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int net_ipv6_send_fragments(struct net_if *iface, struct net_buf *buf);
+#else
+#define net_ipv6_must_fragment(...) false
+#endif /* CONFIG_NET_IPV6_FRAGMENT */
+
 #if defined(CONFIG_NET_IPV6)
 void net_ipv6_init(void);
 #else
@@ -20,61 +20,146 @@
 #include <net/net_stats.h>
 #include <net/arp.h>
 #include "net_private.h"
+#include "nbr.h"
 
 struct arp_entry {
-	uint32_t time;	/* FIXME - implement timeout functionality */
+	uint32_t time;	/* Last use, FIXME - implement timeout functionality */
 	struct net_if *iface;
-	struct net_buf *pending;
+	/* Sent in this order when the ARP reply is received */
+	struct net_buf *pending[CONFIG_NET_ARP_PENDING_COUNT];
 	struct in_addr ip;
 	struct net_eth_addr eth;
 };
 
+#define ARP_INDEX_SIZE NET_NBR_INDEX_SIZE(CONFIG_NET_ARP_TABLE_SIZE)
+
 static struct arp_entry arp_table[CONFIG_NET_ARP_TABLE_SIZE];
 
+/* The entries in use, by hash of their IP address */
+static struct net_nbr_index_slot arp_index[ARP_INDEX_SIZE];
+
+static inline uint32_t arp_hash(struct in_addr *addr)
+{
+	return net_nbr_index_hash(addr, sizeof(*addr));
+}
+
+static struct arp_entry *arp_lookup(struct net_if *iface,
+				    struct in_addr *addr)
+{
+	uint32_t hash = arp_hash(addr);
+	int pos = -1, i;
+
+	while ((i = net_nbr_index_find(arp_index, ARP_INDEX_SIZE,
+				       hash, &pos)) >= 0) {
+		if (arp_table[i].iface == iface &&
+		    net_ipv4_addr_cmp(&arp_table[i].ip, addr)) {
+			return &arp_table[i];
+		}
+	}
+
+	return NULL;
+}
+
+static inline bool arp_is_pending(struct arp_entry *entry)
+{
+	return entry->pending[0] != NULL;
+}
+
+/* Queues the packet behind the ones waiting for the same reply, returns
+ * whether it was queued
+ */
+static bool arp_pending_add(struct net_if *iface, struct in_addr *addr,
+			    struct net_buf *buf)
+{
+	struct arp_entry *entry;
+	int i;
+
+	entry = arp_lookup(iface, addr);
+	if (!entry || !arp_is_pending(entry)) {
+		return false;
+	}
+
+	for (i = 0; i < CONFIG_NET_ARP_PENDING_COUNT; i++) {
+		if (entry->pending[i] == buf) {
+			return false;
+		}
+
+		if (!entry->pending[i]) {
+			entry->pending[i] = net_nbuf_ref(buf);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void arp_entry_set(struct arp_entry *entry, struct net_if *iface,
+			  struct in_addr *addr)
+{
+	uint8_t i = entry - arp_table;
+
+	if (entry->iface) {
+		net_nbr_index_remove(arp_index, ARP_INDEX_SIZE,
+				     arp_hash(&entry->ip), i);
+	}
+
+	entry->iface = iface;
+	entry->time = k_uptime_get_32();
+	net_ipaddr_copy(&entry->ip, addr);
+
+	net_nbr_index_add(arp_index, ARP_INDEX_SIZE, arp_hash(addr), i);
+}
+
 static inline struct arp_entry *find_entry(struct net_if *iface,
 					   struct in_addr *dst,
 					   struct arp_entry **free_entry,
 					   struct arp_entry **non_pending)
 {
+	struct arp_entry *entry;
 	int i;
 
 	NET_DBG("dst %s", net_sprint_ipv4_addr(dst));
 
+	entry = arp_lookup(iface, dst);
+	if (entry) {
+		/* Is there already pending operation for this
+		 * IP address.
+		 */
+		if (arp_is_pending(entry)) {
+			NET_DBG("ARP already pending to %s ll %s",
+				net_sprint_ipv4_addr(dst),
+				net_sprint_ll_addr((uint8_t *)&entry->eth.addr,
+						   sizeof(struct net_eth_addr)));
+			*free_entry = NULL;
+			*non_pending = NULL;
+			return NULL;
+		}
+
+		entry->time = k_uptime_get_32();
+
+		return entry;
+	}
+
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 
 		NET_DBG("[%d] iface %p dst %s ll %s pending %p", i, iface,
 			net_sprint_ipv4_addr(&arp_table[i].ip),
 			net_sprint_ll_addr((uint8_t *)&arp_table[i].eth.addr,
 					   sizeof(struct net_eth_addr)),
-			arp_table[i].pending);
-
-		if (arp_table[i].iface == iface &&
-		    net_ipv4_addr_cmp(&arp_table[i].ip, dst)) {
-			/* Is there already pending operation for this
-			 * IP address.
-			 */
-			if (arp_table[i].pending) {
-				NET_DBG("ARP already pending to %s ll %s",
-					net_sprint_ipv4_addr(dst),
-					net_sprint_ll_addr((uint8_t *)
-						&arp_table[i].eth.addr,
-						sizeof(struct net_eth_addr)));
-				*free_entry = NULL;
-				*non_pending = NULL;
-				return NULL;
-			}
+			arp_table[i].pending[0]);
 
-			return &arp_table[i];
+		if (arp_is_pending(&arp_table[i])) {
+			continue;
 		}
 
 		/* We return also the first free entry */
-		if (!*free_entry && !arp_table[i].pending &&
-		    !arp_table[i].iface) {
+		if (!*free_entry && !arp_table[i].iface) {
 			*free_entry = &arp_table[i];
 		}
 
-		/* And also first non pending entry */
-		if (!*non_pending && !arp_table[i].pending) {
+		/* And also the least recently used non pending entry */
+		if (!*non_pending ||
+		    (int32_t)(arp_table[i].time - (*non_pending)->time) < 0) {
 			*non_pending = &arp_table[i];
 		}
 	}
@@ -132,10 +217,8 @@ static inline struct net_buf *prepare_arp(struct net_if *iface,
 	 * request and we want to send it again.
 	 */
 	if (entry) {
-		entry->pending = net_nbuf_ref(pending);
-		entry->iface = net_nbuf_iface(buf);
-
-		net_ipaddr_copy(&entry->ip, next_addr);
+		entry->pending[0] = net_nbuf_ref(pending);
+		arp_entry_set(entry, net_nbuf_iface(buf), next_addr);
 
 		memcpy(&eth->src.addr,
 		       net_if_get_link_addr(entry->iface)->addr,
@@ -191,20 +274,22 @@ struct net_buf *net_arp_prepare(struct net_buf *buf)
 	struct net_linkaddr *ll;
 	struct net_eth_hdr *hdr;
 	struct in_addr *addr;
+	uint16_t reserve;
 
 	if (!buf || !buf->frags) {
 		return NULL;
 	}
 
-	if (net_nbuf_ll_reserve(buf) != sizeof(struct net_eth_hdr)) {
+	reserve = net_if_get_ll_reserve(net_nbuf_iface(buf), NULL);
+
+	if (net_nbuf_ll_reserve(buf) != reserve) {
 		/* Add the ethernet header if it is missing. */
 		struct net_buf *header;
 		struct net_linkaddr *ll;
 
-		net_nbuf_set_ll_reserve(buf, sizeof(struct net_eth_hdr));
+		net_nbuf_set_ll_reserve(buf, reserve);
 
-		header = net_nbuf_get_reserve_data(sizeof(struct net_eth_hdr),
-						   K_FOREVER);
+		header = net_nbuf_get_reserve_data(reserve, K_FOREVER);
 
 		hdr = (struct net_eth_hdr *)(header->data -
 					     net_nbuf_ll_reserve(buf));
@@ -247,14 +332,16 @@ struct net_buf *net_arp_prepare(struct net_buf *buf)
 			   addr, &free_entry, &non_pending);
 	if (!entry) {
 		if (!free_entry) {
-			/* So all the slots are occupied, use the first
-			 * that can be taken.
+			/* So all the slots are occupied, use the least
+			 * recently used that can be taken.
 			 */
 			if (!non_pending) {
 				/* We cannot send the packet, the ARP
 				 * cache is full or there is already a
 				 * pending query to this IP address,
-				 * so this packet must be discarded.
+				 * so this packet is queued behind the
+				 * pending ones, or discarded if there
+				 * is no room.
 				 */
 				struct net_buf *req;
 
@@ -262,7 +349,10 @@ struct net_buf *net_arp_prepare(struct net_buf *buf)
 						  addr, NULL, buf);
 				NET_DBG("Resending ARP %p", req);
 
-				net_nbuf_unref(buf);
+				if (!arp_pending_add(net_nbuf_iface(buf),
+						     addr, buf)) {
+					net_nbuf_unref(buf);
+				}
 
 				return req;
 			}
@@ -331,40 +421,31 @@ static inline void arp_update(struct net_if *iface,
 			      struct in_addr *src,
 			      struct net_eth_addr *hwaddr)
 {
+	struct arp_entry *entry;
 	int i;
 
 	NET_DBG("src %s", net_sprint_ipv4_addr(src));
 
-	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
-
-		NET_DBG("[%d] iface %p dst %s ll %s pending %p", i, iface,
-			net_sprint_ipv4_addr(&arp_table[i].ip),
-			net_sprint_ll_addr((uint8_t *)&arp_table[i].eth.addr,
-					   sizeof(struct net_eth_addr)),
-			arp_table[i].pending);
-
-		if (arp_table[i].iface == iface &&
-		    net_ipv4_addr_cmp(&arp_table[i].ip, src)) {
+	entry = arp_lookup(iface, src);
+	if (!entry || !arp_is_pending(entry)) {
+		return;
+	}
 
-			if (arp_table[i].pending) {
-				/* We only update the ARP cache if we were
-				 * initiating a request.
-				 */
-				memcpy(&arp_table[i].eth, hwaddr,
-				       sizeof(struct net_eth_addr));
+	/* We only update the ARP cache if we were
+	 * initiating a request.
+	 */
+	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
-				/* Set the dst in the pending packet */
-				net_nbuf_ll_dst(arp_table[i].pending)->len =
-					sizeof(struct net_eth_addr);
-				net_nbuf_ll_dst(arp_table[i].pending)->addr =
-					(uint8_t *)
-					&NET_ETH_BUF(arp_table[i].pending)->dst.addr;
+	for (i = 0; i < CONFIG_NET_ARP_PENDING_COUNT && entry->pending[i];
+	     i++) {
+		struct net_buf *pending = entry->pending[i];
 
-				send_pending(iface, &arp_table[i].pending);
-			}
+		/* Set the dst in the pending packet */
+		net_nbuf_ll_dst(pending)->len = sizeof(struct net_eth_addr);
+		net_nbuf_ll_dst(pending)->addr =
+			(uint8_t *)&NET_ETH_BUF(pending)->dst.addr;
 
-			return;
-		}
+		send_pending(iface, &entry->pending[i]);
 	}
 }
 
@@ -486,4 +567,5 @@ enum net_verdict net_arp_input(struct net_buf *buf)
 void net_arp_init(void)
 {
 	memset(&arp_table, 0, sizeof(arp_table));
+	memset(&arp_index, 0, sizeof(arp_index));
 }
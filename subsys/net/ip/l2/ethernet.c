@@ -31,6 +31,71 @@ const struct net_eth_addr *net_eth_broadcast_addr(void)
 	return &broadcast_eth_addr;
 }
 
+#if defined(CONFIG_NET_IPV6)
+/* IPv6 multicast maps to 33:33 and the last 32 bits of the group */
+static void ipv6_mcast_cb(struct net_if *iface, const struct in6_addr *addr,
+			  net_eth_mcast_cb_t cb, void *user_data)
+{
+	struct net_eth_addr mac = multicast_eth_addr;
+
+	memcpy(&mac.addr[2], &addr->s6_addr[12], 4);
+
+	cb(iface, &mac, user_data);
+}
+#endif
+
+void net_eth_mcast_foreach(struct net_if *iface, net_eth_mcast_cb_t cb,
+			   void *user_data)
+{
+	int i;
+
+#if defined(CONFIG_NET_IPV6)
+	struct in6_addr addr;
+
+	net_ipv6_addr_create_ll_allnodes_mcast(&addr);
+	ipv6_mcast_cb(iface, &addr, cb, user_data);
+
+	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
+		if (!iface->ipv6.unicast[i].is_used) {
+			continue;
+		}
+
+		net_ipv6_addr_create_solicited_node(
+			&iface->ipv6.unicast[i].address.in6_addr, &addr);
+		ipv6_mcast_cb(iface, &addr, cb, user_data);
+	}
+
+	for (i = 0; i < NET_IF_MAX_IPV6_MADDR; i++) {
+		if (!iface->ipv6.mcast[i].is_used) {
+			continue;
+		}
+
+		ipv6_mcast_cb(iface, &iface->ipv6.mcast[i].address.in6_addr,
+			      cb, user_data);
+	}
+#endif /* CONFIG_NET_IPV6 */
+
+#if defined(CONFIG_NET_IPV4)
+	/* IPv4 multicast maps to 01:00:5e and the last 23 bits */
+	for (i = 0; i < NET_IF_MAX_IPV4_MADDR; i++) {
+		struct net_eth_addr mac = { { 0x01, 0x00, 0x5e } };
+		struct in_addr *addr4;
+
+		if (!iface->ipv4.mcast[i].is_used) {
+			continue;
+		}
+
+		addr4 = &iface->ipv4.mcast[i].address.in_addr;
+
+		mac.addr[3] = addr4->s4_addr[1] & 0x7f;
+		mac.addr[4] = addr4->s4_addr[2];
+		mac.addr[5] = addr4->s4_addr[3];
+
+		cb(iface, &mac, user_data);
+	}
+#endif /* CONFIG_NET_IPV4 */
+}
+
 #if defined(CONFIG_NET_DEBUG_L2_ETHERNET)
 #define print_ll_addrs(buf, type, len)					   \
 	do {								   \
@@ -87,10 +152,33 @@ static enum net_verdict ethernet_recv(struct net_if *iface,
 				      struct net_buf *buf)
 {
 	struct net_eth_hdr *hdr = NET_ETH_BUF(buf);
+	uint8_t hdr_len = sizeof(struct net_eth_hdr);
+	uint16_t type = ntohs(hdr->type);
 	struct net_linkaddr *lladdr;
 	sa_family_t family;
 
-	switch (ntohs(hdr->type)) {
+#if defined(CONFIG_NET_L2_ETHERNET_PRIORITY_TAG)
+	if (type == NET_ETH_PTYPE_VLAN &&
+	    buf->frags->len >= sizeof(struct net_eth_vlan_hdr)) {
+		struct net_eth_vlan_hdr *vlan_hdr =
+			(struct net_eth_vlan_hdr *)hdr;
+		uint16_t tci = ntohs(vlan_hdr->tci);
+
+		/* Only priority tags, no VLAN is joined */
+		if (tci & NET_ETH_VLAN_VID_MASK) {
+			NET_DBG("Dropping frame of VLAN %u",
+				tci & NET_ETH_VLAN_VID_MASK);
+			return NET_DROP;
+		}
+
+		net_nbuf_set_priority(buf, tci >> NET_ETH_VLAN_PCP_SHIFT);
+
+		type = ntohs(vlan_hdr->type);
+		hdr_len = sizeof(struct net_eth_vlan_hdr);
+	}
+#endif /* CONFIG_NET_L2_ETHERNET_PRIORITY_TAG */
+
+	switch (type) {
 	case NET_ETH_PTYPE_IP:
 	case NET_ETH_PTYPE_ARP:
 		net_nbuf_set_family(buf, AF_INET);
@@ -101,7 +189,7 @@ static enum net_verdict ethernet_recv(struct net_if *iface,
 		family = AF_INET6;
 		break;
 	default:
-		NET_DBG("Unknown hdr type 0x%04x", hdr->type);
+		NET_DBG("Unknown hdr type 0x%04x", type);
 		return NET_DROP;
 	}
 
@@ -116,7 +204,7 @@ static enum net_verdict ethernet_recv(struct net_if *iface,
 	lladdr->len = sizeof(struct net_eth_addr);
 	lladdr->type = NET_LINK_ETHERNET;
 
-	print_ll_addrs(buf, ntohs(hdr->type), net_buf_frags_len(buf));
+	print_ll_addrs(buf, type, net_buf_frags_len(buf));
 
 	if (!net_eth_is_addr_broadcast((struct net_eth_addr *)lladdr->addr) &&
 	    !net_eth_is_addr_multicast((struct net_eth_addr *)lladdr->addr) &&
@@ -131,11 +219,11 @@ static enum net_verdict ethernet_recv(struct net_if *iface,
 		return NET_DROP;
 	}
 
-	net_nbuf_set_ll_reserve(buf, sizeof(struct net_eth_hdr));
+	net_nbuf_set_ll_reserve(buf, hdr_len);
 	net_buf_pull(buf->frags, net_nbuf_ll_reserve(buf));
 
 #ifdef CONFIG_NET_ARP
-	if (family == AF_INET && hdr->type == htons(NET_ETH_PTYPE_ARP)) {
+	if (family == AF_INET && type == NET_ETH_PTYPE_ARP) {
 		NET_DBG("ARP packet from %s received",
 			net_sprint_ll_addr((uint8_t *)hdr->src.addr,
 					   sizeof(struct net_eth_addr)));
@@ -180,6 +268,38 @@ static inline bool check_if_dst_is_broadcast_or_mcast(struct net_if *iface,
 	return false;
 }
 
+#if defined(CONFIG_NET_L2_ETHERNET_PRIORITY_TAG)
+/* The headers are written untagged by the IP and ARP code, in the room
+ * left for the tagged ones. The ARP requests and replies are built with
+ * a plain header and are sent untagged.
+ */
+static void ethernet_tag(struct net_buf *buf)
+{
+	uint16_t tci = net_nbuf_priority(buf) << NET_ETH_VLAN_PCP_SHIFT;
+	struct net_buf *frag;
+
+	if (net_nbuf_ll_reserve(buf) != sizeof(struct net_eth_vlan_hdr)) {
+		return;
+	}
+
+	for (frag = buf->frags; frag; frag = frag->frags) {
+		struct net_eth_vlan_hdr *hdr;
+
+		if (net_buf_headroom(frag) < sizeof(struct net_eth_vlan_hdr)) {
+			continue;
+		}
+
+		hdr = (struct net_eth_vlan_hdr *)(frag->data -
+						  net_nbuf_ll_reserve(buf));
+		hdr->type = ((struct net_eth_hdr *)hdr)->type;
+		hdr->tpid = htons(NET_ETH_PTYPE_VLAN);
+		hdr->tci = htons(tci);
+	}
+}
+#else
+#define ethernet_tag(...)
+#endif /* CONFIG_NET_L2_ETHERNET_PRIORITY_TAG */
+
 static enum net_verdict ethernet_send(struct net_if *iface,
 				      struct net_buf *buf)
 {
@@ -297,6 +417,8 @@ setup_hdr:
 send:
 #endif /* CONFIG_NET_ARP */
 
+	ethernet_tag(buf);
+
 	net_if_queue_tx(iface, buf);
 
 	return NET_OK;
@@ -307,7 +429,11 @@ static inline uint16_t ethernet_reserve(struct net_if *iface, void *unused)
 	ARG_UNUSED(iface);
 	ARG_UNUSED(unused);
 
+#if defined(CONFIG_NET_L2_ETHERNET_PRIORITY_TAG)
+	return sizeof(struct net_eth_vlan_hdr);
+#else
 	return sizeof(struct net_eth_hdr);
+#endif
 }
 
 NET_L2_INIT(ETHERNET_L2, ethernet_recv, ethernet_send, ethernet_reserve, NULL);
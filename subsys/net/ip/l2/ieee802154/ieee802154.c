@@ -28,6 +28,7 @@
 
 #include "ieee802154_frame.h"
 #include "ieee802154_mgmt.h"
+#include "ieee802154_security.h"
 
 #if 0
 
@@ -247,6 +248,11 @@ static enum net_verdict ieee802154_recv(struct net_if *iface,
 
 	ieee802154_acknowledge(iface, &mpdu);
 
+	if (mpdu.mhr.fs->fc.security_enabled &&
+	    !ieee802154_decrypt_auth(iface, buf, &mpdu)) {
+		return NET_DROP;
+	}
+
 	net_nbuf_set_ll_reserve(buf, mpdu.payload - (void *)net_nbuf_ll(buf));
 	net_buf_pull(buf->frags, net_nbuf_ll_reserve(buf));
 
@@ -295,6 +301,10 @@ static enum net_verdict ieee802154_send(struct net_if *iface,
 			return NET_DROP;
 		}
 
+		if (!ieee802154_encrypt_auth(iface, frag, reserved_space)) {
+			return NET_DROP;
+		}
+
 		frag = frag->frags;
 	}
 
@@ -24,27 +24,52 @@
 #include "net_private.h"
 #include "6lo.h"
 #include "6lo_private.h"
+#include "ieee802154_frame.h"
+#include "ieee802154_security.h"
 
 #define FRAG_REASSEMBLY_TIMEOUT (MSEC_PER_SEC * \
 				 CONFIG_NET_L2_IEEE802154_REASSEMBLY_TIMEOUT)
 #define REASS_CACHE_SIZE CONFIG_NET_L2_IEEE802154_FRAGMENT_REASS_CACHE_SIZE
+#define REASS_MAX_FRAGS CONFIG_NET_L2_IEEE802154_FRAGMENT_REASS_MAX_FRAGS
+
+/* Datagram size is an 11 bit field, offsets are in units of 8 octets */
+#define REASS_MAX_SIZE 2048
+#define REASS_BITMAP_LEN (REASS_MAX_SIZE / 8 / 8)
 
 static uint16_t datagram_tag;
 
+/* Fragment held in a reassembly cache, in datagram offset order */
+struct frag_slot {
+	struct net_buf *frag;		/* Fragment data */
+	uint16_t offset;		/* Offset in the datagram */
+};
+
 /**
  *  Reasseble cache : Depends on cache size it used for reassemble
- *  IPv6 packets simultaneously.
+ *  IPv6 packets simultaneously. A datagram is identified by its link
+ *  layer source, tag and size, its fragments are kept in place until
+ *  all the offsets are received.
  */
 struct frag_cache {
-	struct k_delayed_work timer;	/* Reassemble timer */
-	struct net_buf *buf;		/* Reassemble buffer */
+	struct frag_slot slots[REASS_MAX_FRAGS];
+	uint8_t received[REASS_BITMAP_LEN];	/* Received 8 octet units */
+	uint8_t src[IEEE802154_EXT_ADDR_LENGTH];
+	uint32_t expiry;		/* Reassembly deadline */
 	uint16_t size;			/* Datagram size */
 	uint16_t tag;			/* Datagram tag */
+	uint16_t len;			/* Received data length */
+	uint8_t src_len;
+	uint8_t count;			/* Number of slots used */
+	uint8_t ll_reserve;		/* Link layer reserve of first frag */
 	bool used;
 };
 
 static struct frag_cache cache[REASS_CACHE_SIZE];
 
+/* A single timer expires the caches, in the order they were created */
+static struct k_delayed_work reass_timer;
+static bool reass_timer_ready;
+
 /**
  *  RFC 4944, section 5.3
  *  If an entire payload (e.g., IPv6) datagram fits within a single 802.15.4
@@ -141,6 +166,7 @@ static inline uint8_t calc_max_payload(struct net_buf *buf,
 	uint8_t max;
 
 	max = frag->size - net_nbuf_ll_reserve(buf);
+	max -= ieee802154_security_tag_len(net_nbuf_iface(buf));
 	max -= offset ? NET_6LO_FRAGN_HDR_LEN : NET_6LO_FRAG1_HDR_LEN;
 
 	return (max & 0xF8);
@@ -237,8 +263,12 @@ bool ieee802154_fragment(struct net_buf *buf, int hdr_diff)
 		return false;
 	}
 
-	/* If it is a single fragment do not add fragmentation header */
-	if (!buf->frags->frags) {
+	/* If it is a single fragment do not add fragmentation header, unless
+	 * it leaves no room for the MIC
+	 */
+	if (!buf->frags->frags &&
+	    net_buf_tailroom(buf->frags) >=
+	    ieee802154_security_tag_len(net_nbuf_iface(buf))) {
 		return true;
 	}
 
@@ -306,10 +336,13 @@ static inline uint16_t get_datagram_tag(uint8_t *ptr)
 	return (ptr[0] << 8) | ptr[1];
 }
 
-static inline void remove_frag_header(struct net_buf *frag, uint8_t hdr_len)
+static inline void remove_frag_header(struct net_buf *buf, uint8_t hdr_len)
 {
-	memmove(frag->data, frag->data + hdr_len, frag->len - hdr_len);
-	frag->len -= hdr_len;
+	/* The fragmentation header becomes part of the link layer reserve,
+	 * so it stays in front of the data without being moved.
+	 */
+	net_buf_pull(buf->frags, hdr_len);
+	net_nbuf_set_ll_reserve(buf, net_nbuf_ll_reserve(buf) + hdr_len);
 }
 
 static void update_protocol_header_lengths(struct net_buf *buf, uint16_t size)
@@ -324,65 +357,90 @@ static void update_protocol_header_lengths(struct net_buf *buf, uint16_t size)
 	}
 }
 
-static inline void clear_reass_cache(uint16_t size, uint16_t tag)
+static void clear_reass_cache(struct frag_cache *cache)
 {
 	uint8_t i;
 
-	for (i = 0; i < REASS_CACHE_SIZE; i++) {
-		if (!(cache[i].size == size && cache[i].tag == tag)) {
-			continue;
-		}
-
-		net_nbuf_unref(cache[i].buf);
-
-		cache[i].buf = NULL;
-		cache[i].size = 0;
-		cache[i].tag = 0;
-		cache[i].used = false;
-		k_delayed_work_cancel(&cache[i].timer);
+	for (i = 0; i < cache->count; i++) {
+		net_nbuf_unref(cache->slots[i].frag);
 	}
+
+	memset(cache, 0, sizeof(*cache));
 }
 
 /**
  *  If the reassembly not completed within reassembly timeout discard
- *  the whole packet.
+ *  the whole packet. The timer is then rearmed for the oldest cache
+ *  still in progress.
  */
 static void reass_timeout(struct k_work *work)
 {
-	struct frag_cache *cache = CONTAINER_OF(work, struct frag_cache, timer);
+	uint32_t now = k_uptime_get_32();
+	int32_t next = 0;
+	int32_t remaining;
+	uint8_t i;
+
+	ARG_UNUSED(work);
+
+	for (i = 0; i < REASS_CACHE_SIZE; i++) {
+		if (!cache[i].used) {
+			continue;
+		}
+
+		remaining = (int32_t)(cache[i].expiry - now);
+		if (remaining <= 0) {
+			NET_DBG("Reassembly of tag %u timed out",
+				cache[i].tag);
+			clear_reass_cache(&cache[i]);
+			continue;
+		}
 
-	if (cache->buf) {
-		net_nbuf_unref(cache->buf);
+		if (!next || remaining < next) {
+			next = remaining;
+		}
 	}
 
-	cache->buf = NULL;
-	cache->size = 0;
-	cache->tag = 0;
-	cache->used = false;
+	if (next) {
+		k_delayed_work_submit(&reass_timer, next);
+	}
 }
 
 /**
- *  Upon receiption of first fragment with respective of size and tag
- *  create a new cache. If number of unused cache are out then
+ *  Upon receiption of first fragment with respective of source, size
+ *  and tag create a new cache. If number of unused cache are out then
  *  discard the fragments.
  */
 static inline struct frag_cache *set_reass_cache(struct net_buf *buf,
 						 uint16_t size, uint16_t tag)
 {
+	struct net_linkaddr *src = net_nbuf_ll_src(buf);
 	int i;
 
+	if (!reass_timer_ready) {
+		k_delayed_work_init(&reass_timer, reass_timeout);
+		reass_timer_ready = true;
+	}
+
 	for (i = 0; i < REASS_CACHE_SIZE; i++) {
 		if (cache[i].used) {
 			continue;
 		}
 
-		cache[i].buf = buf;
 		cache[i].size = size;
 		cache[i].tag = tag;
 		cache[i].used = true;
+		cache[i].expiry = k_uptime_get_32() + FRAG_REASSEMBLY_TIMEOUT;
+
+		if (src->addr && src->len <= sizeof(cache[i].src)) {
+			memcpy(cache[i].src, src->addr, src->len);
+			cache[i].src_len = src->len;
+		}
+
+		if (!k_delayed_work_remaining_get(&reass_timer)) {
+			k_delayed_work_submit(&reass_timer,
+					      FRAG_REASSEMBLY_TIMEOUT);
+		}
 
-		k_delayed_work_init(&cache[i].timer, reass_timeout);
-		k_delayed_work_submit(&cache[i].timer, FRAG_REASSEMBLY_TIMEOUT);
 		return &cache[i];
 	}
 
@@ -390,47 +448,91 @@ static inline struct frag_cache *set_reass_cache(struct net_buf *buf,
 }
 
 /**
- *  Return cache if it matches with size and tag of stored caches,
+ *  Return cache if it matches with source, size and tag of stored caches,
  *  otherwise return NULL.
  */
-static inline struct frag_cache *get_reass_cache(uint16_t size, uint16_t tag)
+static inline struct frag_cache *get_reass_cache(struct net_buf *buf,
+						 uint16_t size, uint16_t tag)
 {
+	struct net_linkaddr *src = net_nbuf_ll_src(buf);
+	uint8_t src_len = src->addr ? src->len : 0;
 	uint8_t i;
 
 	for (i = 0; i < REASS_CACHE_SIZE; i++) {
-		if (cache[i].used) {
-			if (cache[i].size == size &&
-			    cache[i].tag == tag) {
-				return &cache[i];
-			}
+		if (!cache[i].used) {
+			continue;
+		}
+
+		if (cache[i].size == size && cache[i].tag == tag &&
+		    cache[i].src_len == src_len &&
+		    (!src_len || !memcmp(cache[i].src, src->addr, src_len))) {
+			return &cache[i];
 		}
 	}
 
 	return NULL;
 }
 
-/* Helper function to write fragment data to Rx buffer based on offset. */
-static inline bool copy_frag(struct net_buf *buf,
-			     struct net_buf *frag,
-			     uint16_t offset)
+/* Check the received bitmap for the 8 octet units of a fragment, and
+ * mark them if none was received yet.
+ */
+static bool mark_received(struct frag_cache *cache, uint16_t offset,
+			  uint16_t len)
 {
-	struct net_buf *input = frag;
-	struct net_buf *write;
-	uint16_t pos = offset;
-
-	write = buf->frags;
+	uint16_t first = offset >> 3;
+	uint16_t last = (offset + len + 7) >> 3;
+	uint16_t i;
 
-	while (input) {
-		write = net_nbuf_write(buf, write, pos, &pos, input->len,
-				       input->data, K_FOREVER);
-		if (!write && pos == 0xffff) {
+	for (i = first; i < last; i++) {
+		if (cache->received[i >> 3] & BIT(i & 7)) {
 			return false;
 		}
+	}
 
-		input = input->frags;
+	for (i = first; i < last; i++) {
+		cache->received[i >> 3] |= BIT(i & 7);
 	}
 
-	net_nbuf_unref(frag);
+	return true;
+}
+
+/* Keep the fragment data in place, at its slot in offset order. */
+static inline bool insert_frag(struct frag_cache *cache,
+			       struct net_buf *frag,
+			       uint16_t offset)
+{
+	uint16_t len = net_buf_frags_len(frag);
+	uint8_t i;
+
+	if (cache->count == REASS_MAX_FRAGS) {
+		NET_ERR("Too many fragments for tag %u", cache->tag);
+		return false;
+	}
+
+	/* All fragments but the last one are multiples of 8 octets */
+	if (!len || offset + len > cache->size ||
+	    ((offset + len) < cache->size && (len & 0x07))) {
+		NET_ERR("Invalid fragment offset %u len %u", offset, len);
+		return false;
+	}
+
+	if (!mark_received(cache, offset, len)) {
+		NET_ERR("Overlapping fragment offset %u", offset);
+		return false;
+	}
+
+	for (i = cache->count; i > 0; i--) {
+		if (cache->slots[i - 1].offset < offset) {
+			break;
+		}
+
+		cache->slots[i] = cache->slots[i - 1];
+	}
+
+	cache->slots[i].frag = frag;
+	cache->slots[i].offset = offset;
+	cache->count++;
+	cache->len += len;
 
 	return true;
 }
@@ -439,9 +541,9 @@ static inline bool copy_frag(struct net_buf *buf,
  *  Parse size and tag from the fragment, check if we have any cache
  *  related to it. If not create a new cache.
  *  Remove the fragmentation header and uncompress IPv6 and related headers.
- *  Cache Rx part of fragment along with data buf for the first fragment
- *  in the cache, remaining fragments just cache data fragment, unref
- *  RX buf. So in both the cases caller can assume buffer is consumed.
+ *  The data fragments are detached from the Rx buf and cached, the Rx buf
+ *  is unref'd, except for the last fragment which gets the reassembled
+ *  data. So in all the cases caller can assume buffer is consumed.
  */
 static inline enum net_verdict add_frag_to_cache(struct net_buf *buf,
 						 bool first)
@@ -452,6 +554,7 @@ static inline enum net_verdict add_frag_to_cache(struct net_buf *buf,
 	uint16_t tag;
 	uint16_t offset = 0;
 	uint8_t pos = 0;
+	uint8_t i;
 
 	/* Parse total size of packet */
 	size = get_datagram_size(buf->frags->data);
@@ -467,76 +570,67 @@ static inline enum net_verdict add_frag_to_cache(struct net_buf *buf,
 	}
 
 	/* Remove frag header and update data */
-	remove_frag_header(buf->frags, pos);
+	remove_frag_header(buf, pos);
+
+	cache = get_reass_cache(buf, size, tag);
 
 	/* Uncompress the IP headers */
 	if (first && !net_6lo_uncompress(buf)) {
 		NET_ERR("Could not uncompress first frag's 6lo hdr");
-		clear_reass_cache(size, tag);
+
+		if (cache) {
+			clear_reass_cache(cache);
+		}
 
 		return NET_DROP;
 	}
 
-	/* If there are no fragments in the cache means this frag
-	 * is the first one. So cache Rx buf otherwise not.
-	 * Write data fragment data to cached Rx based on offset parameter.
-	 * (Detach data fragment from incoming Rx and copy that data).
-	 */
-
-	frag = buf->frags;
-	buf->frags = NULL;
-
-	cache = get_reass_cache(size, tag);
 	if (!cache) {
 		cache = set_reass_cache(buf, size, tag);
 		if (!cache) {
 			NET_ERR("Could not get a cache entry");
 			return NET_DROP;
 		}
+	}
 
-		/* If write failed, then attach frag back to incoming buffer
-		 * and return NET_DROP, caller will take care of freeing it.
-		 */
-		if (!copy_frag(cache->buf, frag, offset)) {
-			buf->frags = frag;
-
-			/* Initialize to NULL to prevent duble free. It's only
-			 * needed here because this is the first fragment.
-			 */
-			cache->buf = NULL;
-
-			clear_reass_cache(size, tag);
-
-			NET_ERR("Copying frag failed");
+	/* Detach data fragment from incoming Rx and cache it in place. If
+	 * that fails, the caller frees it along with the Rx buf.
+	 */
+	frag = buf->frags;
 
-			return NET_DROP;
+	if (!insert_frag(cache, frag, offset)) {
+		if (!cache->count) {
+			clear_reass_cache(cache);
 		}
 
-		NET_DBG("buffer inserted into cache");
-
-		return NET_OK;
+		return NET_DROP;
 	}
 
-	/* Add data buffer to reassembly buffer */
-	if (!copy_frag(cache->buf, frag, offset)) {
-		buf->frags = frag;
-
-		clear_reass_cache(size, tag);
+	buf->frags = NULL;
 
-		return NET_DROP;
+	if (first) {
+		cache->ll_reserve = net_nbuf_ll_reserve(buf);
 	}
 
+	NET_DBG("fragment offset %u inserted into cache", offset);
+
 	/* Check if all the fragments are received or not */
-	if (net_buf_frags_len(cache->buf->frags) == size) {
-		/* Assign frags back to input buffer. */
-		buf->frags = cache->buf->frags;
-		cache->buf->frags = NULL;
+	if (cache->len == size) {
+		/* Chain the fragments back to the input buffer. */
+		for (i = 0; i < cache->count; i++) {
+			net_buf_frag_add(buf, cache->slots[i].frag);
+		}
+
+		cache->count = 0;
+
+		/* The link layer header is in front of the first fragment */
+		net_nbuf_set_ll_reserve(buf, cache->ll_reserve);
 
 		/* Lengths are elided in compression, so calculate it. */
-		update_protocol_header_lengths(buf, cache->size);
+		update_protocol_header_lengths(buf, size);
 
 		/* Once reassemble is done, cache is no longer needed. */
-		clear_reass_cache(size, tag);
+		clear_reass_cache(cache);
 
 		NET_DBG("All fragments received and reassembled");
 
@@ -27,6 +27,7 @@
 #include <nbr.h>
 
 #include "ieee802154_frame.h"
+#include "ieee802154_security.h"
 
 static inline struct ieee802154_fcf_seq *
 validate_fc_seq(uint8_t *buf, uint8_t **p_buf)
@@ -99,6 +100,32 @@ validate_addr(uint8_t *buf, uint8_t **p_buf,
 	return (struct ieee802154_address_field *)buf;
 }
 
+static inline struct ieee802154_aux_security_hdr *
+validate_aux_security_hdr(uint8_t *buf, uint8_t **p_buf)
+{
+	struct ieee802154_aux_security_hdr *ash =
+		(struct ieee802154_aux_security_hdr *)buf;
+
+	*p_buf = buf + IEEE802154_SECURITY_CF_LENGTH +
+		IEEE802154_SECURITY_FRAME_COUNTER_LENGTH;
+
+	switch (ash->control.key_id_mode) {
+	case IEEE802154_KEY_ID_MODE_IMPLICIT:
+		break;
+	case IEEE802154_KEY_ID_MODE_INDEX:
+		*p_buf += IEEE802154_KEY_ID_FIELD_INDEX_LENGTH;
+		break;
+	case IEEE802154_KEY_ID_MODE_SRC_4_INDEX:
+		*p_buf += IEEE802154_KEY_ID_FIELD_SRC_4_INDEX_LENGTH;
+		break;
+	case IEEE802154_KEY_ID_MODE_SRC_8_INDEX:
+		*p_buf += IEEE802154_KEY_ID_FIELD_SRC_8_INDEX_LENGTH;
+		break;
+	}
+
+	return ash;
+}
+
 static inline bool
 validate_beacon(struct ieee802154_mpdu *mpdu, uint8_t *buf, uint8_t length)
 {
@@ -329,6 +356,23 @@ bool ieee802154_validate_frame(uint8_t *buf, uint8_t length,
 					   mpdu->mhr.fs->fc.src_addr_mode,
 					   (mpdu->mhr.fs->fc.pan_id_comp));
 
+	if (mpdu->mhr.fs->fc.security_enabled) {
+		/* Only data frames are secured, 2003 security is unsupported */
+		if (mpdu->mhr.fs->fc.frame_type != IEEE802154_FRAME_TYPE_DATA ||
+		    mpdu->mhr.fs->fc.frame_version ==
+		    IEEE802154_VERSION_802154_2003) {
+			return false;
+		}
+
+		mpdu->mhr.aux_sec = validate_aux_security_hdr(p_buf, &p_buf);
+
+		if ((p_buf - buf) + IEEE802154_MFR_LENGTH > length) {
+			return false;
+		}
+	} else {
+		mpdu->mhr.aux_sec = NULL;
+	}
+
 	return validate_payload_and_mfr(mpdu, buf, p_buf, length);
 }
 
@@ -361,7 +405,7 @@ uint16_t ieee802154_compute_header_size(struct net_if *iface,
 		}
 	}
 
-	/* Todo: handle security aux header */
+	hdr_len += ieee802154_security_aux_hdr_len(iface);
 
 	NET_DBG("Computed size of %u", hdr_len);
 
@@ -450,6 +494,43 @@ void data_addr_to_fs_settings(struct net_if *iface,
 	}
 }
 
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+static inline bool
+generate_aux_security_hdr(struct ieee802154_security_ctx *sec_ctx,
+			  struct ieee802154_fcf_seq *fs, uint8_t **p_buf)
+{
+	struct ieee802154_aux_security_hdr *aux;
+
+	if (sec_ctx->level == IEEE802154_SECURITY_LEVEL_NONE) {
+		return true;
+	}
+
+	/* The frame counter is not to wrap around, see Section 7.2.1 */
+	if (sec_ctx->frame_counter == 0xffffffff) {
+		NET_ERR("Frame counter exhausted");
+		return false;
+	}
+
+	fs->fc.security_enabled = 1;
+
+	aux = (struct ieee802154_aux_security_hdr *)*p_buf;
+
+	aux->control.security_level = sec_ctx->level;
+	aux->control.key_id_mode = IEEE802154_KEY_ID_MODE_INDEX;
+	aux->control.reserved = 0;
+	aux->frame_counter = sys_cpu_to_le32(sec_ctx->frame_counter);
+	aux->key_index = sec_ctx->key_index;
+
+	sec_ctx->frame_counter++;
+
+	*p_buf += IEEE802154_SECURITY_AUX_HDR_LENGTH;
+
+	return true;
+}
+#else
+#define generate_aux_security_hdr(...) true
+#endif /* CONFIG_NET_L2_IEEE802154_SECURITY */
+
 static
 uint8_t *generate_addressing_fields(struct net_if *iface,
 				    struct ieee802154_fcf_seq *fs,
@@ -524,6 +605,10 @@ bool ieee802154_create_data_frame(struct net_if *iface,
 
 	p_buf = generate_addressing_fields(iface, fs, &params, p_buf);
 
+	if (!generate_aux_security_hdr(&ctx->sec_ctx, fs, &p_buf)) {
+		return false;
+	}
+
 	if ((p_buf - frag_start) != len) {
 		/* ll reserve was too small? We probably overwrote
 		 * payload bytes
@@ -532,8 +617,6 @@ bool ieee802154_create_data_frame(struct net_if *iface,
 		return false;
 	}
 
-	/* Todo: handle security aux header */
-
 	dbg_print_fs(fs);
 
 	return true;
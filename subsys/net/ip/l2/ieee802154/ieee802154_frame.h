@@ -40,6 +40,17 @@
 #define IEEE802154_BEACON_GTS_RX		1
 #define IEEE802154_BEACON_GTS_TX		0
 
+#define IEEE802154_SECURITY_CF_LENGTH		1
+#define IEEE802154_SECURITY_FRAME_COUNTER_LENGTH	4
+#define IEEE802154_KEY_ID_FIELD_INDEX_LENGTH	1
+#define IEEE802154_KEY_ID_FIELD_SRC_4_INDEX_LENGTH	5
+#define IEEE802154_KEY_ID_FIELD_SRC_8_INDEX_LENGTH	9
+/* Frames are sent with the key identifier mode 1 */
+#define IEEE802154_SECURITY_AUX_HDR_LENGTH		\
+	(IEEE802154_SECURITY_CF_LENGTH +		\
+	 IEEE802154_SECURITY_FRAME_COUNTER_LENGTH +	\
+	 IEEE802154_KEY_ID_FIELD_INDEX_LENGTH)
+
 /* See Section 5.2.1.1.1 */
 enum ieee802154_frame_type {
 	IEEE802154_FRAME_TYPE_BEACON		= 0x0,
@@ -130,11 +141,44 @@ struct ieee802154_address_field {
 	};
 } __packed;
 
+/* See Section 7.4.1.2 */
+enum ieee802154_key_id_mode {
+	IEEE802154_KEY_ID_MODE_IMPLICIT		= 0x0,
+	IEEE802154_KEY_ID_MODE_INDEX		= 0x1,
+	IEEE802154_KEY_ID_MODE_SRC_4_INDEX	= 0x2,
+	IEEE802154_KEY_ID_MODE_SRC_8_INDEX	= 0x3,
+};
+
+/* See Section 7.4.1 */
+struct ieee802154_security_control_field {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	uint8_t security_level	:3;
+	uint8_t key_id_mode	:2;
+	uint8_t reserved	:3;
+#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	uint8_t reserved	:3;
+	uint8_t key_id_mode	:2;
+	uint8_t security_level	:3;
+#endif
+} __packed;
+
+/*
+ * Auxiliary security header
+ * See Section 7.4, the key index being there with key identifier mode 1
+ * only, the others preceding it with a key source.
+ */
+struct ieee802154_aux_security_hdr {
+	struct ieee802154_security_control_field control;
+	uint32_t frame_counter;
+	uint8_t key_index;
+} __packed;
+
 /** MAC header */
 struct ieee802154_mhr {
 	struct ieee802154_fcf_seq *fs;
 	struct ieee802154_address_field *dst_addr;
 	struct ieee802154_address_field *src_addr;
+	struct ieee802154_aux_security_hdr *aux_sec;
 };
 
 struct ieee802154_mfr {
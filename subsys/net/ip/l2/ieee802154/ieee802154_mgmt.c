@@ -19,6 +19,7 @@
 
 #include "ieee802154_frame.h"
 #include "ieee802154_mgmt.h"
+#include "ieee802154_security.h"
 
 enum net_verdict ieee802154_handle_beacon(struct net_if *iface,
 					  struct ieee802154_mpdu *mpdu)
@@ -476,3 +477,35 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_IEEE802154_GET_EXT_ADDR,
 
 NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_IEEE802154_GET_SHORT_ADDR,
 				  ieee802154_get_parameters);
+
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+static int ieee802154_set_security_settings(uint32_t mgmt_request,
+					    struct net_if *iface,
+					    void *data, size_t len)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+
+	if (mgmt_request == NET_REQUEST_IEEE802154_SET_SECURITY_KEY) {
+		struct ieee802154_security_key *key = data;
+
+		if (len != sizeof(struct ieee802154_security_key) || !data) {
+			return -EINVAL;
+		}
+
+		return ieee802154_security_set_key(&ctx->sec_ctx,
+						   key->key_index, key->key);
+	}
+
+	if (len != sizeof(uint8_t) || !data) {
+		return -EINVAL;
+	}
+
+	return ieee802154_security_set_level(&ctx->sec_ctx, *((uint8_t *)data));
+}
+
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_IEEE802154_SET_SECURITY_KEY,
+				  ieee802154_set_security_settings);
+
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_IEEE802154_SET_SECURITY_LEVEL,
+				  ieee802154_set_security_settings);
+#endif /* CONFIG_NET_L2_IEEE802154_SECURITY */
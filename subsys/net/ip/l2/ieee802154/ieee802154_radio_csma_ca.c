@@ -31,13 +31,34 @@ static inline int csma_ca_tx_fragment(struct net_if *iface,
 	uint8_t retries = CONFIG_NET_L2_IEEE802154_RADIO_TX_RETRIES;
 	struct ieee802154_context *ctx = net_if_l2_data(iface);
 	const struct ieee802154_radio_api *radio = iface->dev->driver_api;
-	bool ack_required = prepare_for_ack(ctx, buf);
+	bool ack_required = prepare_for_ack(iface, ctx, buf);
 	uint8_t be = CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA_MIN_BE;
 	uint8_t nb = 0;
 	int ret = -EIO;
 
 	NET_DBG("frag %p", frag);
 
+	/* No need to busy wait on the channel: the radio checks it
+	 * right before sending and tx fails if it is busy.
+	 */
+	if (radio_has_caps(iface, IEEE802154_HW_CSMA)) {
+		while (retries) {
+			retries--;
+
+			ret = radio->tx(iface->dev, buf, frag);
+			if (ret) {
+				continue;
+			}
+
+			ret = wait_for_ack(ctx, ack_required);
+			if (!ret) {
+				break;
+			}
+		}
+
+		return ret;
+	}
+
 loop:
 	while (retries) {
 		retries--;
@@ -11,9 +11,27 @@ typedef int (ieee802154_radio_tx_frag_t)(struct net_if *iface,
 					 struct net_buf *buf,
 					 struct net_buf *frag);
 
-static inline bool prepare_for_ack(struct ieee802154_context *ctx,
+static inline bool radio_has_caps(struct net_if *iface,
+				  enum ieee802154_hw_caps caps)
+{
+	const struct ieee802154_radio_api *radio = iface->dev->driver_api;
+
+	if (!radio->get_capabilities) {
+		return false;
+	}
+
+	return (radio->get_capabilities(iface->dev) & caps) == caps;
+}
+
+static inline bool prepare_for_ack(struct net_if *iface,
+				   struct ieee802154_context *ctx,
 				   struct net_buf *buf)
 {
+	/* The radio does not return before the ACK, if it waits for it */
+	if (radio_has_caps(iface, IEEE802154_HW_TX_RX_ACK)) {
+		return false;
+	}
+
 	if (ieee802154_ack_required(buf)) {
 		ctx->ack_received = false;
 		k_sem_init(&ctx->ack_lock, 0, UINT_MAX);
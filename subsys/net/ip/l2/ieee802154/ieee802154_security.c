@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(CONFIG_NET_DEBUG_L2_IEEE802154)
+#define SYS_LOG_DOMAIN "net/ieee802154"
+#define NET_LOG_ENABLED 1
+#endif
+
+#include <net/net_core.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <misc/byteorder.h>
+#include <crypto/cipher.h>
+
+#include "ieee802154_frame.h"
+#include "ieee802154_security.h"
+
+/* CCM* nonce: source address, frame counter and security level, see
+ * Section 7.3.2
+ */
+#define NONCE_LENGTH	13
+
+#define SESSION_FLAGS	(CAP_RAW_KEY | CAP_INPLACE_OPS | CAP_SYNC_OPS)
+
+static void nonce_setup(uint8_t *nonce, const uint8_t *ext_addr,
+			uint32_t frame_counter, uint8_t level)
+{
+	/* Both in big endian */
+	memcpy(nonce, ext_addr, IEEE802154_EXT_ADDR_LENGTH);
+	sys_put_be32(frame_counter, nonce + IEEE802154_EXT_ADDR_LENGTH);
+	nonce[NONCE_LENGTH - 1] = level;
+}
+
+static struct ieee802154_security_key_entry *
+key_lookup(struct ieee802154_security_ctx *sec_ctx, uint8_t key_index)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sec_ctx->keys); i++) {
+		if (sec_ctx->keys[i].in_use &&
+		    sec_ctx->keys[i].index == key_index) {
+			return &sec_ctx->keys[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int key_begin_session(struct ieee802154_security_key_entry *entry,
+			     struct cipher_ctx *cipher, uint8_t level,
+			     enum cipher_op op)
+{
+	struct device *dev;
+
+	dev = device_get_binding(
+		CONFIG_NET_L2_IEEE802154_SECURITY_CRYPTO_DEV_NAME);
+	if (!dev) {
+		return -ENODEV;
+	}
+
+	if ((cipher_query_hwcaps(dev) & SESSION_FLAGS) != SESSION_FLAGS) {
+		return -ENOTSUP;
+	}
+
+	cipher->key.bit_stream = entry->key;
+	cipher->keylen = IEEE802154_SECURITY_KEY_LENGTH;
+	cipher->flags = SESSION_FLAGS;
+	cipher->mode_params.ccm_info.nonce_len = NONCE_LENGTH;
+	cipher->mode_params.ccm_info.tag_len =
+		ieee802154_security_level_tag_len(level);
+
+	return cipher_begin_session(dev, cipher, CRYPTO_CIPHER_ALGO_AES,
+				    CRYPTO_CIPHER_MODE_CCM, op);
+}
+
+static void key_free_sessions(struct ieee802154_security_key_entry *entry)
+{
+	if (!entry->ready) {
+		return;
+	}
+
+	cipher_free_session(entry->enc.device, &entry->enc);
+	cipher_free_session(entry->dec.device, &entry->dec);
+
+	entry->ready = 0;
+}
+
+/* The tag length being a session parameter, the sessions follow the
+ * security level. None are held while security is disabled.
+ */
+static int key_setup_sessions(struct ieee802154_security_key_entry *entry,
+			      uint8_t level)
+{
+	int ret;
+
+	key_free_sessions(entry);
+
+	if (level == IEEE802154_SECURITY_LEVEL_NONE) {
+		return 0;
+	}
+
+	ret = key_begin_session(entry, &entry->enc, level,
+				CRYPTO_CIPHER_OP_ENCRYPT);
+	if (ret) {
+		return ret;
+	}
+
+	ret = key_begin_session(entry, &entry->dec, level,
+				CRYPTO_CIPHER_OP_DECRYPT);
+	if (ret) {
+		cipher_free_session(entry->enc.device, &entry->enc);
+		return ret;
+	}
+
+	entry->ready = 1;
+
+	return 0;
+}
+
+static struct ieee802154_security_device *
+device_lookup(struct ieee802154_security_ctx *sec_ctx,
+	      const uint8_t *ext_addr, uint8_t key_index)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sec_ctx->devices); i++) {
+		struct ieee802154_security_device *device =
+			&sec_ctx->devices[i];
+
+		if (device->in_use && device->key_index == key_index &&
+		    !memcmp(device->ext_addr, ext_addr,
+			    IEEE802154_EXT_ADDR_LENGTH)) {
+			return device;
+		}
+	}
+
+	return NULL;
+}
+
+/* A free entry if any, the least recently added one otherwise */
+static struct ieee802154_security_device *
+device_add(struct ieee802154_security_ctx *sec_ctx,
+	   const uint8_t *ext_addr, uint8_t key_index)
+{
+	struct ieee802154_security_device *device;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sec_ctx->devices); i++) {
+		if (!sec_ctx->devices[i].in_use) {
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(sec_ctx->devices)) {
+		i = sec_ctx->next_device;
+		sec_ctx->next_device = (i + 1) % ARRAY_SIZE(sec_ctx->devices);
+	}
+
+	device = &sec_ctx->devices[i];
+
+	memcpy(device->ext_addr, ext_addr, IEEE802154_EXT_ADDR_LENGTH);
+	device->key_index = key_index;
+	device->in_use = 1;
+
+	return device;
+}
+
+int ieee802154_security_set_key(struct ieee802154_security_ctx *sec_ctx,
+				uint8_t key_index, const uint8_t *key)
+{
+	struct ieee802154_security_key_entry *entry;
+	int ret;
+	int i;
+
+	entry = key_lookup(sec_ctx, key_index);
+	if (!entry) {
+		for (i = 0; i < ARRAY_SIZE(sec_ctx->keys); i++) {
+			if (!sec_ctx->keys[i].in_use) {
+				entry = &sec_ctx->keys[i];
+				break;
+			}
+		}
+
+		if (!entry) {
+			return -ENOMEM;
+		}
+	}
+
+	key_free_sessions(entry);
+
+	memcpy(entry->key, key, IEEE802154_SECURITY_KEY_LENGTH);
+	entry->index = key_index;
+
+	ret = key_setup_sessions(entry, sec_ctx->level);
+	if (ret) {
+		entry->in_use = 0;
+		return ret;
+	}
+
+	entry->in_use = 1;
+
+	/* Frame counters received with a former key of that index */
+	for (i = 0; i < ARRAY_SIZE(sec_ctx->devices); i++) {
+		if (sec_ctx->devices[i].key_index == key_index) {
+			sec_ctx->devices[i].in_use = 0;
+		}
+	}
+
+	sec_ctx->key_index = key_index;
+
+	return 0;
+}
+
+int ieee802154_security_set_level(struct ieee802154_security_ctx *sec_ctx,
+				  uint8_t level)
+{
+	int ret;
+	int i;
+
+	if (level > IEEE802154_SECURITY_LEVEL_ENC_MIC_128) {
+		return -EINVAL;
+	}
+
+	/* CCM* without MIC, not provided by the crypto API */
+	if (level == IEEE802154_SECURITY_LEVEL_ENC) {
+		return -ENOTSUP;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sec_ctx->keys); i++) {
+		if (!sec_ctx->keys[i].in_use) {
+			continue;
+		}
+
+		ret = key_setup_sessions(&sec_ctx->keys[i], level);
+		if (ret) {
+			NET_ERR("Could not set up the key %u sessions",
+				sec_ctx->keys[i].index);
+			ieee802154_security_set_level(sec_ctx,
+					IEEE802154_SECURITY_LEVEL_NONE);
+			return ret;
+		}
+	}
+
+	sec_ctx->level = level;
+
+	return 0;
+}
+
+/* Sets up the CCM operation for a frame of hdr_len bytes followed by
+ * msg_len bytes of payload, the MIC coming right after. Without encryption
+ * the payload is authenticated along the header.
+ */
+static void aead_setup(struct cipher_aead_pkt *apkt, struct cipher_pkt *pkt,
+		       uint8_t level, uint8_t *frame, uint8_t hdr_len,
+		       uint8_t msg_len)
+{
+	uint8_t *payload = frame + hdr_len;
+
+	if (level < IEEE802154_SECURITY_LEVEL_ENC) {
+		hdr_len += msg_len;
+		payload += msg_len;
+		msg_len = 0;
+	}
+
+	pkt->in_buf = payload;
+	pkt->in_len = msg_len;
+	pkt->out_buf = payload;
+	pkt->out_buf_max = msg_len + ieee802154_security_level_tag_len(level);
+
+	apkt->pkt = pkt;
+	apkt->ad = frame;
+	apkt->ad_len = hdr_len;
+	apkt->tag = payload + msg_len;
+}
+
+bool ieee802154_encrypt_auth(struct net_if *iface, struct net_buf *frag,
+			     uint8_t hdr_len)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+	struct ieee802154_security_ctx *sec_ctx = &ctx->sec_ctx;
+	uint8_t tag_len = ieee802154_security_level_tag_len(sec_ctx->level);
+	struct ieee802154_security_key_entry *entry;
+	struct ieee802154_aux_security_hdr *aux;
+	uint8_t nonce[NONCE_LENGTH];
+	struct cipher_aead_pkt apkt;
+	struct cipher_pkt pkt;
+	uint8_t *tag;
+
+	if (sec_ctx->level == IEEE802154_SECURITY_LEVEL_NONE) {
+		return true;
+	}
+
+	entry = key_lookup(sec_ctx, sec_ctx->key_index);
+	if (!entry || !entry->ready) {
+		NET_ERR("No key to secure the frame");
+		return false;
+	}
+
+	if (net_buf_tailroom(frag) < tag_len) {
+		NET_ERR("No room for the MIC");
+		return false;
+	}
+
+	/* The auxiliary security header ends the MAC header */
+	aux = (struct ieee802154_aux_security_hdr *)
+		(frag->data - IEEE802154_SECURITY_AUX_HDR_LENGTH);
+
+	nonce_setup(nonce, iface->link_addr.addr,
+		    sys_le32_to_cpu(aux->frame_counter), sec_ctx->level);
+
+	aead_setup(&apkt, &pkt, sec_ctx->level, frag->data - hdr_len,
+		   hdr_len, frag->len);
+	tag = apkt.tag;
+
+	if (cipher_ccm_op(&entry->enc, &apkt, nonce)) {
+		NET_ERR("Could not secure the frame");
+		return false;
+	}
+
+	/* Only the MIC, if the driver did not put it after the payload */
+	if (apkt.tag != tag) {
+		memcpy(tag, apkt.tag, tag_len);
+	}
+
+	net_buf_add(frag, tag_len);
+
+	return true;
+}
+
+bool ieee802154_decrypt_auth(struct net_if *iface, struct net_buf *buf,
+			     struct ieee802154_mpdu *mpdu)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+	struct ieee802154_aux_security_hdr *aux = mpdu->mhr.aux_sec;
+	struct ieee802154_security_ctx *sec_ctx = &ctx->sec_ctx;
+	struct ieee802154_security_key_entry *entry;
+	struct ieee802154_security_device *device;
+	uint8_t ext_addr[IEEE802154_EXT_ADDR_LENGTH];
+	uint8_t *frame = net_nbuf_ll(buf);
+	uint8_t nonce[NONCE_LENGTH];
+	struct cipher_aead_pkt apkt;
+	uint32_t frame_counter;
+	struct cipher_pkt pkt;
+	uint8_t *src_addr;
+	uint8_t payload_len;
+	uint8_t hdr_len;
+	uint8_t tag_len;
+
+	if (sec_ctx->level == IEEE802154_SECURITY_LEVEL_NONE ||
+	    aux->control.security_level != sec_ctx->level ||
+	    aux->control.key_id_mode != IEEE802154_KEY_ID_MODE_INDEX) {
+		NET_DBG("Unexpected security level or key identifier mode");
+		return false;
+	}
+
+	/* The nonce is made of the extended source address */
+	if (mpdu->mhr.fs->fc.src_addr_mode != IEEE802154_ADDR_MODE_EXTENDED) {
+		return false;
+	}
+
+	entry = key_lookup(sec_ctx, aux->key_index);
+	if (!entry || !entry->ready) {
+		NET_DBG("Unknown key %u", aux->key_index);
+		return false;
+	}
+
+	hdr_len = (uint8_t *)mpdu->payload - frame;
+	payload_len = buf->frags->len - hdr_len;
+	tag_len = ieee802154_security_level_tag_len(sec_ctx->level);
+
+	if (payload_len < tag_len) {
+		return false;
+	}
+
+	if (mpdu->mhr.fs->fc.pan_id_comp) {
+		src_addr = mpdu->mhr.src_addr->comp.addr.ext_addr;
+	} else {
+		src_addr = mpdu->mhr.src_addr->plain.addr.ext_addr;
+	}
+
+	/* Replayed frames, see Section 7.2.3 */
+	frame_counter = sys_le32_to_cpu(aux->frame_counter);
+	device = device_lookup(sec_ctx, src_addr, aux->key_index);
+
+	if (frame_counter == 0xffffffff ||
+	    (device && frame_counter < device->frame_counter)) {
+		NET_DBG("Frame counter %u rejected", frame_counter);
+		return false;
+	}
+
+	sys_memcpy_swap(ext_addr, src_addr, IEEE802154_EXT_ADDR_LENGTH);
+	nonce_setup(nonce, ext_addr, frame_counter, sec_ctx->level);
+
+	aead_setup(&apkt, &pkt, sec_ctx->level, frame, hdr_len,
+		   payload_len - tag_len);
+
+	if (cipher_ccm_op(&entry->dec, &apkt, nonce)) {
+		NET_DBG("Frame authentication failed");
+		return false;
+	}
+
+	if (!device) {
+		device = device_add(sec_ctx, src_addr, aux->key_index);
+	}
+
+	device->frame_counter = frame_counter + 1;
+
+	buf->frags->len -= tag_len;
+
+	return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IEEE 802.15.4 frame security
+ *
+ * Data frames are secured with AES-CCM* through the crypto driver API,
+ * in place in the buffers, the MIC following the payload.
+ */
+
+#ifndef __IEEE802154_SECURITY_H__
+#define __IEEE802154_SECURITY_H__
+
+#include <net/net_if.h>
+#include <net/ieee802154.h>
+
+#include "ieee802154_frame.h"
+
+#ifdef CONFIG_NET_L2_IEEE802154_SECURITY
+
+/* MIC length of a security level, see Section 7.4.1.1 */
+static inline uint8_t ieee802154_security_level_tag_len(uint8_t level)
+{
+	level &= 0x3;
+
+	return level ? 2 << level : 0;
+}
+
+static inline uint8_t ieee802154_security_aux_hdr_len(struct net_if *iface)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+
+	if (ctx->sec_ctx.level == IEEE802154_SECURITY_LEVEL_NONE) {
+		return 0;
+	}
+
+	return IEEE802154_SECURITY_AUX_HDR_LENGTH;
+}
+
+/* Room needed after the payload of the frames sent */
+static inline uint8_t ieee802154_security_tag_len(struct net_if *iface)
+{
+	struct ieee802154_context *ctx;
+
+	if (!iface) {
+		return 0;
+	}
+
+	ctx = net_if_l2_data(iface);
+
+	return ieee802154_security_level_tag_len(ctx->sec_ctx.level);
+}
+
+int ieee802154_security_set_key(struct ieee802154_security_ctx *sec_ctx,
+				uint8_t key_index, const uint8_t *key);
+
+int ieee802154_security_set_level(struct ieee802154_security_ctx *sec_ctx,
+				  uint8_t level);
+
+/* Secures the frame of frag, its header of hdr_len bytes being in front
+ * of frag->data, and adds the MIC to frag.
+ */
+bool ieee802154_encrypt_auth(struct net_if *iface, struct net_buf *frag,
+			     uint8_t hdr_len);
+
+/* Decrypts and authenticates a received data frame, and removes its MIC */
+bool ieee802154_decrypt_auth(struct net_if *iface, struct net_buf *buf,
+			     struct ieee802154_mpdu *mpdu);
+
+#else
+
+#define ieee802154_security_aux_hdr_len(...) 0
+#define ieee802154_security_tag_len(...) 0
+#define ieee802154_encrypt_auth(...) true
+#define ieee802154_decrypt_auth(...) false
+
+#endif /* CONFIG_NET_L2_IEEE802154_SECURITY */
+
+#endif /* __IEEE802154_SECURITY_H__ */
@@ -21,6 +21,35 @@
 
 NET_NBR_LLADDR_INIT(net_neighbor_lladdr, CONFIG_NET_IPV6_MAX_NEIGHBORS);
 
+#define LLADDR_INDEX_SIZE NET_NBR_INDEX_SIZE(CONFIG_NET_IPV6_MAX_NEIGHBORS)
+
+/* The link layer addresses in use, by hash */
+static struct net_nbr_index_slot lladdr_index[LLADDR_INDEX_SIZE];
+
+static inline uint32_t lladdr_hash(const uint8_t *addr, uint8_t len)
+{
+	return net_nbr_index_hash(addr, len);
+}
+
+/* Index of a link layer address in use, <0 if there is none */
+static int lladdr_find(struct net_linkaddr *lladdr)
+{
+	uint32_t hash = lladdr_hash(lladdr->addr, lladdr->len);
+	int pos = -1, i;
+
+	while ((i = net_nbr_index_find(lladdr_index, LLADDR_INDEX_SIZE,
+				       hash, &pos)) >= 0) {
+		if (net_neighbor_lladdr[i].ref &&
+		    net_neighbor_lladdr[i].lladdr.len == lladdr->len &&
+		    !memcmp(net_neighbor_lladdr[i].lladdr.addr,
+			    lladdr->addr, lladdr->len)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 #if defined(CONFIG_NET_DEBUG_IPV6_NBR_CACHE)
 void net_nbr_unref_debug(struct net_nbr *nbr, const char *caller, int line)
 #define net_nbr_unref(nbr) net_nbr_unref_debug(nbr, __func__, __LINE__)
@@ -93,24 +122,23 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 		return -EALREADY;
 	}
 
+	i = lladdr_find(lladdr);
+	if (i >= 0) {
+		/* We found same lladdr in nbr cache so just
+		 * increase the ref count.
+		 */
+		net_neighbor_lladdr[i].ref++;
+
+		nbr->idx = i;
+		nbr->iface = iface;
+
+		return 0;
+	}
+
 	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		if (avail < 0 && !net_neighbor_lladdr[i].ref) {
+		if (!net_neighbor_lladdr[i].ref) {
 			avail = i;
-		}
-
-		if (net_neighbor_lladdr[i].ref &&
-		    !memcmp(lladdr->addr,
-			    net_neighbor_lladdr[i].lladdr.addr,
-			    lladdr->len)) {
-			/* We found same lladdr in nbr cache so just
-			 * increase the ref count.
-			 */
-			net_neighbor_lladdr[i].ref++;
-
-			nbr->idx = i;
-			nbr->iface = iface;
-
-			return 0;
+			break;
 		}
 	}
 
@@ -128,6 +156,9 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 			 lladdr->len);
 	net_neighbor_lladdr[avail].lladdr.len = lladdr->len;
 
+	net_nbr_index_add(lladdr_index, LLADDR_INDEX_SIZE,
+			  lladdr_hash(lladdr->addr, lladdr->len), avail);
+
 	nbr->iface = iface;
 
 	return 0;
@@ -147,6 +178,13 @@ int net_nbr_unlink(struct net_nbr *nbr, struct net_linkaddr *lladdr)
 	net_neighbor_lladdr[nbr->idx].ref--;
 
 	if (!net_neighbor_lladdr[nbr->idx].ref) {
+		struct net_linkaddr_storage *storage =
+			&net_neighbor_lladdr[nbr->idx].lladdr;
+
+		net_nbr_index_remove(lladdr_index, LLADDR_INDEX_SIZE,
+				     lladdr_hash(storage->addr, storage->len),
+				     nbr->idx);
+
 		memset(net_neighbor_lladdr[nbr->idx].lladdr.addr, 0,
 		       sizeof(net_neighbor_lladdr[nbr->idx].lladdr.addr));
 	}
@@ -161,15 +199,18 @@ struct net_nbr *net_nbr_lookup(struct net_nbr_table *table,
 			       struct net_if *iface,
 			       struct net_linkaddr *lladdr)
 {
-	int i;
+	int i, idx;
+
+	/* Only the neighbors linked to the address need to be checked */
+	idx = lladdr_find(lladdr);
+	if (idx < 0) {
+		return NULL;
+	}
 
 	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
 		struct net_nbr *nbr = get_nbr(table->nbr, i);
 
-		if (nbr->ref && nbr->iface == iface &&
-		    net_neighbor_lladdr[nbr->idx].ref &&
-		    !memcmp(net_neighbor_lladdr[nbr->idx].lladdr.addr,
-			    lladdr->addr, lladdr->len)) {
+		if (nbr->ref && nbr->iface == iface && nbr->idx == idx) {
 			return nbr;
 		}
 	}
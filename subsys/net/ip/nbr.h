@@ -111,6 +111,120 @@ struct net_nbr_table {
 		}							\
 	}
 
+/* Open-addressed hash index of the entries of a table, by the hash of a
+ * key. Slots are probed linearly from the one the hash points to. With
+ * twice as many slots as entries, the probe sequences stay short.
+ */
+struct net_nbr_index_slot {
+	/** Entry number + 1, 0 if the slot is free */
+	uint8_t entry;
+
+	/** Slot the entry hashes to */
+	uint16_t home;
+};
+
+#define NET_NBR_INDEX_SIZE(_count) (2 * (_count))
+
+/**
+ * @brief Hash a key for a neighbor index.
+ * @param key Key, typically an IP or link layer address
+ * @param len Length of the key
+ * @return Hash of the key
+ */
+static inline uint32_t net_nbr_index_hash(const void *key, size_t len)
+{
+	const uint8_t *data = key;
+	uint32_t hash = 2166136261u;
+
+	/* FNV-1a */
+	while (len--) {
+		hash = (hash ^ *data++) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Add an entry to a neighbor index.
+ * @param index Slots of the index
+ * @param size Number of slots, NET_NBR_INDEX_SIZE() of the entries
+ * @param hash Hash of the key of the entry
+ * @param entry Entry number
+ */
+static inline void net_nbr_index_add(struct net_nbr_index_slot *index,
+				     int size, uint32_t hash, uint8_t entry)
+{
+	int home = hash % size, pos = home;
+
+	while (index[pos].entry) {
+		pos = (pos + 1) % size;
+	}
+
+	index[pos].entry = entry + 1;
+	index[pos].home = home;
+}
+
+/**
+ * @brief Find the entries of a neighbor index with a given key hash.
+ * @param index Slots of the index
+ * @param size Number of slots
+ * @param hash Hash of the key
+ * @param pos Position of the search, to be set to -1 before the first call
+ * @return Number of the next entry with this hash, <0 if there are no more
+ */
+static inline int net_nbr_index_find(const struct net_nbr_index_slot *index,
+				     int size, uint32_t hash, int *pos)
+{
+	int home = hash % size;
+	int i = *pos < 0 ? home : (*pos + 1) % size;
+
+	for (; index[i].entry; i = (i + 1) % size) {
+		if (index[i].home == home) {
+			*pos = i;
+			return index[i].entry - 1;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Remove an entry from a neighbor index, if it is there.
+ * @param index Slots of the index
+ * @param size Number of slots
+ * @param hash Hash of the key the entry was added with
+ * @param entry Entry number
+ */
+static inline void net_nbr_index_remove(struct net_nbr_index_slot *index,
+					int size, uint32_t hash, uint8_t entry)
+{
+	int pos = -1, i, j;
+
+	do {
+		i = net_nbr_index_find(index, size, hash, &pos);
+	} while (i >= 0 && i != entry);
+
+	if (i < 0) {
+		return;
+	}
+
+	/* Move back the following entries that could no longer be
+	 * reached from their home slot.
+	 */
+	for (i = pos, j = (pos + 1) % size; index[j].entry;
+	     j = (j + 1) % size) {
+		int home = index[j].home;
+
+		if (i <= j ? (home <= i || home > j) :
+			     (home <= i && home > j)) {
+			index[i] = index[j];
+			i = j;
+		}
+	}
+
+	index[i].entry = 0;
+}
+
 /**
  *  @brief Get a pointer to the extra data of a neighbor entry.
  *
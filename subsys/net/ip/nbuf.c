@@ -36,6 +36,7 @@
 #define NBUF_DATA_COUNT	CONFIG_NET_NBUF_DATA_COUNT
 #define NBUF_DATA_LEN	CONFIG_NET_NBUF_DATA_SIZE
 #define NBUF_USER_DATA_LEN CONFIG_NET_NBUF_USER_DATA_SIZE
+#define NBUF_EXT_DATA_COUNT CONFIG_NET_NBUF_EXT_DATA_COUNT
 
 #if defined(CONFIG_NET_TCP)
 #define APP_PROTO_LEN NET_TCPH_LEN
@@ -83,6 +84,7 @@
 static inline void free_rx_bufs_func(struct net_buf *buf);
 static inline void free_tx_bufs_func(struct net_buf *buf);
 static inline void free_data_bufs_func(struct net_buf *buf);
+static void free_ext_data_bufs_func(struct net_buf *buf);
 
 NET_BUF_POOL_DEFINE(rx_buffers, NBUF_RX_COUNT, 0, sizeof(struct net_nbuf),
 		    free_rx_bufs_func);
@@ -93,6 +95,16 @@ NET_BUF_POOL_DEFINE(tx_buffers, NBUF_TX_COUNT, 0, sizeof(struct net_nbuf),
 NET_BUF_POOL_DEFINE(data_buffers, NBUF_DATA_COUNT, NBUF_DATA_LEN,
 		    NBUF_USER_DATA_LEN, free_data_bufs_func);
 
+/* The external data fragments only refer to the data of their owner */
+struct ext_data {
+	const void *data;
+	net_nbuf_ext_cb_t cb;
+	void *user_data;
+};
+
+NET_BUF_POOL_DEFINE(ext_data_buffers, NBUF_EXT_DATA_COUNT, 0,
+		    sizeof(struct ext_data), free_ext_data_bufs_func);
+
 /* We need to know the name of the pool in order to figure out
  * how much data it is consuming.
  */
@@ -237,14 +249,61 @@ static inline int get_frees(struct net_buf_pool *pool)
 #define NET_BUF_CHECK_IF_NOT_IN_USE(buf, ref)
 #endif /* CONFIG_NET_DEBUG_NET_BUF */
 
+static inline bool is_ext_data(struct net_buf *buf)
+{
+	return (buf->flags & NET_BUF_EXTERNAL_DATA);
+}
+
+/* Only data fragment pools, the global one or the ones of the contexts,
+ * have room for data.
+ */
+static inline bool is_data_pool(struct net_buf_pool *pool)
+{
+	return pool->buf_size != 0;
+}
+
+/* External data fragments are data fragments too */
 static inline bool is_from_data_pool(struct net_buf *buf)
 {
-	return (buf->pool == &data_buffers);
+	return (is_data_pool(buf->pool) || is_ext_data(buf));
+}
+
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+bool net_nbuf_rx_quota_get(struct net_if *iface, struct net_buf *buf)
+{
+	struct net_nbuf *nbuf = net_buf_user_data(buf);
+
+	/* Loopback packets are TX buffers, and are not counted */
+	if (buf->pool != &rx_buffers || nbuf->quota_iface) {
+		return true;
+	}
+
+	if (atomic_inc(&iface->rx_bufs) >= CONFIG_NET_NBUF_RX_IFACE_QUOTA) {
+		atomic_dec(&iface->rx_bufs);
+		return false;
+	}
+
+	nbuf->quota_iface = iface;
+
+	return true;
 }
 
+static inline void rx_quota_put(struct net_buf *buf)
+{
+	struct net_nbuf *nbuf = net_buf_user_data(buf);
+
+	if (nbuf->quota_iface) {
+		atomic_dec(&nbuf->quota_iface->rx_bufs);
+	}
+}
+#else
+#define rx_quota_put(...)
+#endif /* CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0 */
+
 static inline void free_rx_bufs_func(struct net_buf *buf)
 {
 	inc_free_rx_bufs(buf);
+	rx_quota_put(buf);
 
 	net_buf_destroy(buf);
 }
@@ -263,6 +322,17 @@ static inline void free_data_bufs_func(struct net_buf *buf)
 	net_buf_destroy(buf);
 }
 
+static void free_ext_data_bufs_func(struct net_buf *buf)
+{
+	struct ext_data ext = *(struct ext_data *)net_buf_user_data(buf);
+
+	net_buf_destroy(buf);
+
+	if (ext.cb) {
+		ext.cb(ext.data, ext.user_data);
+	}
+}
+
 #if defined(CONFIG_NET_DEBUG_NET_BUF)
 static inline const char *pool2str(struct net_buf_pool *pool)
 {
@@ -272,6 +342,8 @@ static inline const char *pool2str(struct net_buf_pool *pool)
 		return "TX";
 	} else if (pool == &data_buffers) {
 		return "DATA";
+	} else if (pool == &ext_data_buffers) {
+		return "EXT_DATA";
 	}
 
 	return "EXTERNAL";
@@ -337,7 +409,7 @@ static struct net_buf *net_nbuf_get_reserve(struct net_buf_pool *pool,
 		return NULL;
 	}
 
-	if (pool == &data_buffers) {
+	if (is_data_pool(pool)) {
 		/* The buf->data will point to the start of the L3
 		 * header (like IPv4 or IPv6 packet header).
 		 */
@@ -425,6 +497,14 @@ static struct net_buf *net_nbuf_get(struct net_buf_pool *pool,
 		return NULL;
 	}
 
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+	if (pool == &tx_buffers && context->tx_pool) {
+		pool = context->tx_pool;
+	} else if (pool == &data_buffers && context->data_pool) {
+		pool = context->data_pool;
+	}
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
 	iface = net_context_get_iface(context);
 
 	NET_ASSERT(iface);
@@ -444,7 +524,7 @@ static struct net_buf *net_nbuf_get(struct net_buf_pool *pool,
 		return buf;
 	}
 
-	if (pool != &data_buffers) {
+	if (!is_data_pool(pool)) {
 		net_nbuf_set_context(buf, context);
 		net_nbuf_set_ll_reserve(buf, reserve);
 		net_nbuf_set_iface(buf, iface);
@@ -452,6 +532,7 @@ static struct net_buf *net_nbuf_get(struct net_buf_pool *pool,
 		if (context) {
 			net_nbuf_set_family(buf,
 					    net_context_get_family(context));
+			net_nbuf_set_priority(buf, context->priority);
 		}
 	}
 
@@ -506,6 +587,29 @@ struct net_buf *net_nbuf_get_data(struct net_context *context, int32_t timeout)
 
 #endif /* CONFIG_NET_DEBUG_NET_BUF */
 
+/* The data appended to a buffer goes to the data pool of its context */
+static inline struct net_buf *get_data_frag(struct net_buf *buf,
+					    uint16_t reserve_head,
+					    int32_t timeout)
+{
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+	struct net_context *context = net_nbuf_context(buf);
+
+	if (context && context->data_pool) {
+#if defined(CONFIG_NET_DEBUG_NET_BUF)
+		return net_nbuf_get_reserve_debug(context->data_pool,
+						  reserve_head, timeout,
+						  __func__, __LINE__);
+#else
+		return net_nbuf_get_reserve(context->data_pool, reserve_head,
+					    timeout);
+#endif /* CONFIG_NET_DEBUG_NET_BUF */
+	}
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
+	return net_nbuf_get_reserve_data(reserve_head, timeout);
+}
+
 
 #if defined(CONFIG_NET_DEBUG_NET_BUF)
 void net_nbuf_unref_debug(struct net_buf *buf, const char *caller, int line)
@@ -559,6 +663,37 @@ done:
 }
 
 
+struct net_buf *net_nbuf_get_ext_data(const void *data, uint16_t len,
+				      net_nbuf_ext_cb_t cb, void *user_data,
+				      int32_t timeout)
+{
+	struct ext_data *ext;
+	struct net_buf *buf;
+
+	if (k_is_in_isr()) {
+		timeout = K_NO_WAIT;
+	}
+
+	buf = net_buf_alloc(&ext_data_buffers, timeout);
+	if (!buf) {
+		return NULL;
+	}
+
+	ext = net_buf_user_data(buf);
+	ext->data = data;
+	ext->cb = cb;
+	ext->user_data = user_data;
+
+	/* The stack only ever reads or pulls the data */
+	buf->flags |= NET_BUF_EXTERNAL_DATA;
+	buf->data = (uint8_t *)data;
+	buf->len = len;
+
+	NET_DBG("EXT_DATA buf %p data %p len %u", buf, data, len);
+
+	return buf;
+}
+
 #if defined(CONFIG_NET_DEBUG_NET_BUF)
 struct net_buf *net_nbuf_ref_debug(struct net_buf *buf, const char *caller,
 				   int line)
@@ -766,7 +901,11 @@ bool net_nbuf_compact(struct net_buf *buf)
 	prev = NULL;
 
 	while (buf) {
-		if (buf->frags) {
+		if (buf->frags && is_ext_data(buf->frags)) {
+			/* External data is left where it is, the next
+			 * fragments are compacted after it.
+			 */
+		} else if (buf->frags) {
 			/* Copy amount of data from next fragment to this
 			 * fragment.
 			 */
@@ -816,6 +955,42 @@ bool net_nbuf_compact(struct net_buf *buf)
 	return true;
 }
 
+int net_nbuf_coalesce(struct net_buf *buf, size_t budget)
+{
+	struct net_buf *prev, *frag;
+	int released = 0;
+
+	if (is_from_data_pool(buf)) {
+		NET_DBG("Buffer %p is a data fragment", buf);
+		return 0;
+	}
+
+	prev = buf->frags;
+	if (!prev) {
+		return 0;
+	}
+
+	for (frag = prev->frags; frag; frag = prev->frags) {
+		if (!frag->len) {
+			net_buf_frag_del(prev, frag);
+			released++;
+		} else if (frag->len <= budget &&
+			   frag->len <= net_buf_tailroom(prev) &&
+			   !is_ext_data(prev) && !is_ext_data(frag)) {
+			memcpy(net_buf_add(prev, frag->len), frag->data,
+			       frag->len);
+			budget -= frag->len;
+
+			net_buf_frag_del(prev, frag);
+			released++;
+		} else {
+			prev = frag;
+		}
+	}
+
+	return released;
+}
+
 struct net_buf *net_nbuf_pull(struct net_buf *buf, size_t amount)
 {
 	struct net_buf *first;
@@ -902,7 +1077,7 @@ static inline bool net_nbuf_append_bytes(struct net_buf *buf,
 			return true;
 		}
 
-		frag = net_nbuf_get_reserve_data(ll_reserve, timeout);
+		frag = get_data_frag(buf, ll_reserve, timeout);
 		if (!frag) {
 			return false;
 		}
@@ -932,8 +1107,7 @@ bool net_nbuf_append(struct net_buf *buf, uint16_t len, const uint8_t *data,
 	}
 
 	if (!buf->frags) {
-		frag = net_nbuf_get_reserve_data(net_nbuf_ll_reserve(buf),
-						 timeout);
+		frag = get_data_frag(buf, net_nbuf_ll_reserve(buf), timeout);
 		if (!frag) {
 			return false;
 		}
@@ -944,86 +1118,133 @@ bool net_nbuf_append(struct net_buf *buf, uint16_t len, const uint8_t *data,
 	return net_nbuf_append_bytes(buf, data, len, timeout);
 }
 
-/* Helper routine to retrieve single byte from fragment and move
- * offset. If required byte is last byte in framgent then return
- * next fragment and set offset = 0.
- */
-static inline struct net_buf *net_nbuf_read_byte(struct net_buf *buf,
-						 uint16_t offset,
-						 uint16_t *pos,
-						 uint8_t *data)
+/* Move a cursor out of the fragments it is at the end of */
+static inline void cursor_next(struct net_nbuf_cursor *cursor)
 {
-	if (data) {
-		*data = buf->data[offset];
+	while (cursor->frag && cursor->pos >= cursor->frag->len) {
+		cursor->pos -= cursor->frag->len;
+		cursor->frag = cursor->frag->frags;
+	}
+}
+
+bool net_nbuf_cursor_init(struct net_nbuf_cursor *cursor,
+			  struct net_buf *frag, uint16_t offset)
+{
+	if (!frag || !is_from_data_pool(frag)) {
+		NET_ERR("Invalid buffer or buffer is not a fragment");
+		cursor->frag = NULL;
+		cursor->pos = 0;
+		return false;
 	}
 
-	*pos = offset + 1;
+	cursor->frag = frag;
+	cursor->pos = offset;
 
-	if (*pos >= buf->len) {
-		*pos = 0;
+	cursor_next(cursor);
 
-		return buf->frags;
+	if (!cursor->frag && cursor->pos) {
+		NET_ERR("Invalid offset, failed to adjust");
+		cursor->pos = 0;
+		return false;
 	}
 
-	return buf;
+	return true;
 }
 
-/* Helper function to adjust offset in net_nbuf_read() call
- * if given offset is more than current fragment length.
- */
-static inline struct net_buf *adjust_offset(struct net_buf *buf,
-					    uint16_t offset, uint16_t *pos)
+bool net_nbuf_cursor_read(struct net_nbuf_cursor *cursor, void *data,
+			  uint16_t len)
 {
-	if (!buf || !is_from_data_pool(buf)) {
-		NET_ERR("Invalid buffer or buffer is not a fragment");
+	uint8_t *ptr = data;
+
+	while (len) {
+		uint16_t count;
+
+		if (!cursor->frag) {
+			return false;
+		}
+
+		count = min(len, cursor->frag->len - cursor->pos);
+
+		if (ptr) {
+			memcpy(ptr, cursor->frag->data + cursor->pos, count);
+			ptr += count;
+		}
+
+		cursor->pos += count;
+		len -= count;
+
+		cursor_next(cursor);
+	}
+
+	return true;
+}
+
+void *net_nbuf_cursor_pull(struct net_nbuf_cursor *cursor, uint16_t len,
+			   void *buf)
+{
+	uint8_t *data;
+
+	if (cursor->frag && cursor->frag->len - cursor->pos >= len) {
+		data = cursor->frag->data + cursor->pos;
+
+		cursor->pos += len;
+		cursor_next(cursor);
+
+		return data;
+	}
+
+	if (!net_nbuf_cursor_read(cursor, buf, len)) {
 		return NULL;
 	}
 
-	while (buf) {
-		if (offset == buf->len) {
-			*pos = 0;
+	return buf;
+}
 
-			return buf->frags;
-		} else if (offset < buf->len) {
-			*pos = offset;
+bool net_nbuf_cursor_read_be16(struct net_nbuf_cursor *cursor,
+			       uint16_t *value)
+{
+	uint8_t v16[2];
 
-			return buf;
-		}
+	if (!net_nbuf_cursor_read(cursor, v16, sizeof(v16))) {
+		return false;
+	}
 
-		offset -= buf->len;
-		buf = buf->frags;
+	*value = v16[0] << 8 | v16[1];
+
+	return true;
+}
+
+bool net_nbuf_cursor_read_be32(struct net_nbuf_cursor *cursor,
+			       uint32_t *value)
+{
+	uint8_t v32[4];
+
+	if (!net_nbuf_cursor_read(cursor, v32, sizeof(v32))) {
+		return false;
 	}
 
-	NET_ERR("Invalid offset, failed to adjust");
+	*value = v32[0] << 24 | v32[1] << 16 | v32[2] << 8 | v32[3];
 
-	return NULL;
+	return true;
 }
 
 struct net_buf *net_nbuf_read(struct net_buf *buf, uint16_t offset,
 			      uint16_t *pos, uint16_t len, uint8_t *data)
 {
-	uint16_t copy = 0;
+	struct net_nbuf_cursor cursor;
 
-	buf = adjust_offset(buf, offset, pos);
-	if (!buf) {
+	if (!net_nbuf_cursor_init(&cursor, buf, offset) || !cursor.frag) {
 		goto error;
 	}
 
-	while (len-- > 0 && buf) {
-		if (data) {
-			buf = net_nbuf_read_byte(buf, *pos, pos, data + copy++);
-		} else {
-			buf = net_nbuf_read_byte(buf, *pos, pos, NULL);
-		}
-
-		/* Error: Still reamining length to be read, but no data. */
-		if (!buf && len) {
-			NET_ERR("Not enough data to read");
-			goto error;
-		}
+	if (!net_nbuf_cursor_read(&cursor, data, len)) {
+		NET_ERR("Not enough data to read");
+		goto error;
 	}
 
-	return buf;
+	*pos = cursor.pos;
+
+	return cursor.frag;
 
 error:
 	*pos = 0xffff;
@@ -1189,6 +1410,11 @@ struct net_buf *net_nbuf_write(struct net_buf *buf, struct net_buf *frag,
 		uint16_t count = min(len, space);
 		int size_to_add;
 
+		if (is_ext_data(frag)) {
+			NET_ERR("Cannot write to external data");
+			goto error;
+		}
+
 		memcpy(frag->data + offset, data, count);
 
 		/* If we are overwriting on already available space then need
@@ -1364,15 +1590,16 @@ void net_nbuf_get_info(size_t *tx_size, size_t *rx_size, size_t *data_size,
 		*data_size = sizeof(data_buffers_pool);
 	}
 
-#if defined(CONFIG_NET_DEBUG_NET_BUF)
-	*tx = get_frees(&tx_buffers);
-	*rx = get_frees(&rx_buffers);
-	*data = get_frees(&data_buffers);
-#else
-	*tx = BIT(31);
-	*rx = BIT(31);
-	*data = BIT(31);
-#endif /* CONFIG_NET_DEBUG_NET_BUF */
+	*tx = net_buf_pool_free_count(&tx_buffers);
+	*rx = net_buf_pool_free_count(&rx_buffers);
+	*data = net_buf_pool_free_count(&data_buffers);
+}
+
+void net_nbuf_get_pool_info(struct net_buf_pool *pool, int *count,
+			    int *avail)
+{
+	*count = pool->buf_count;
+	*avail = net_buf_pool_free_count(pool);
 }
 
 #if defined(CONFIG_NET_DEBUG_NET_BUF)
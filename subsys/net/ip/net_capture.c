@@ -0,0 +1,480 @@
+/** @file
+ * @brief Network packet capture
+ *
+ * The packets are copied into a ring by the RX thread and by the callers
+ * of net_if_send_data(), and streamed out in the pcapng format by a thread
+ * of its own.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <misc/util.h>
+
+#include <net/net_core.h>
+#include <net/nbuf.h>
+#include <net/net_if.h>
+#include <net/net_capture.h>
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_UART)
+#include <uart.h>
+#endif
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_RTT)
+#include <rtt/SEGGER_RTT.h>
+#endif
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_UDP)
+#include <net/net_context.h>
+#endif
+
+#include "net_private.h"
+
+#define SNAPLEN CONFIG_NET_CAPTURE_SNAPLEN
+#define RING_SIZE CONFIG_NET_CAPTURE_RING_SIZE
+
+struct capture_rec {
+	/* Index of the record plus one once written, 0 while written */
+	atomic_t seq;
+	uint32_t time;
+	uint16_t orig_len;
+	uint16_t len;
+	uint8_t iface;
+	uint8_t dir;
+	uint8_t data[SNAPLEN];
+};
+
+/* The writers reserve a record by incrementing the head, so they do not
+ * wait for each other nor for the stream thread. A record overwritten
+ * before it was streamed out is counted as lost.
+ */
+static struct capture_rec ring[RING_SIZE];
+static atomic_t ring_head;
+static uint32_t ring_tail;
+static atomic_t lost;
+
+static struct net_capture_filter filter;
+static atomic_t capture_dir;
+static atomic_t restart;
+static atomic_t start_idx;
+
+K_SEM_DEFINE(net_capture_wakeup, 0, 1);
+
+/* pcapng blocks, see draft-tuexen-opsawg-pcapng */
+#define PCAPNG_SHB_TYPE 0x0a0d0d0a
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_EPB_TYPE 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1a2b3c4d
+#define PCAPNG_LINKTYPE_RAW 101
+#define PCAPNG_EPB_FLAGS 2
+
+struct pcapng_shb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t magic;
+	uint16_t major;
+	uint16_t minor;
+	uint32_t section_len[2];
+	uint32_t len_end;
+};
+
+struct pcapng_idb {
+	uint32_t type;
+	uint32_t len;
+	uint16_t linktype;
+	uint16_t reserved;
+	uint32_t snaplen;
+	uint32_t len_end;
+};
+
+struct pcapng_epb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t iface;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint32_t caplen;
+	uint32_t orig_len;
+};
+
+/* The direction flags option, and the end of the options */
+struct pcapng_epb_end {
+	uint16_t code;
+	uint16_t opt_len;
+	uint32_t flags;
+	uint32_t end_of_opt;
+	uint32_t len_end;
+};
+
+static uint32_t block[(sizeof(struct pcapng_epb) + SNAPLEN + 3 +
+		       sizeof(struct pcapng_epb_end)) / sizeof(uint32_t)];
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_UART)
+static struct device *stream_dev;
+
+static void stream_init(void)
+{
+	stream_dev =
+		device_get_binding(CONFIG_NET_CAPTURE_STREAM_UART_ON_DEV_NAME);
+	__ASSERT(stream_dev, "no capture stream UART");
+}
+
+static void stream_out(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	while (len--) {
+		uart_poll_out(stream_dev, *p++);
+	}
+}
+#endif /* CONFIG_NET_CAPTURE_STREAM_UART */
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_RTT)
+#define STREAM_RTT_CHANNEL 2
+
+static uint8_t stream_rtt_buf[1024];
+
+static void stream_init(void)
+{
+	/* skip whole blocks when full, for the stream to stay parseable */
+	SEGGER_RTT_ConfigUpBuffer(STREAM_RTT_CHANNEL, "pcapng",
+				  stream_rtt_buf, sizeof(stream_rtt_buf),
+				  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+}
+
+static void stream_out(const void *data, size_t len)
+{
+	SEGGER_RTT_Write(STREAM_RTT_CHANNEL, data, len);
+}
+#endif /* CONFIG_NET_CAPTURE_STREAM_RTT */
+
+#if defined(CONFIG_NET_CAPTURE_STREAM_UDP)
+static struct net_context *stream_context;
+static struct sockaddr stream_peer;
+
+static void stream_init(void)
+{
+	const char *peer = CONFIG_NET_CAPTURE_STREAM_UDP_PEER;
+	int ret = -EINVAL;
+
+#if defined(CONFIG_NET_IPV6)
+	if (!net_addr_pton(AF_INET6, peer,
+			   &net_sin6(&stream_peer)->sin6_addr)) {
+		net_sin6(&stream_peer)->sin6_port =
+			htons(CONFIG_NET_CAPTURE_STREAM_UDP_PORT);
+		stream_peer.family = AF_INET6;
+		ret = 0;
+	}
+#endif
+#if defined(CONFIG_NET_IPV4)
+	if (ret && !net_addr_pton(AF_INET, peer,
+				  &net_sin(&stream_peer)->sin_addr)) {
+		net_sin(&stream_peer)->sin_port =
+			htons(CONFIG_NET_CAPTURE_STREAM_UDP_PORT);
+		stream_peer.family = AF_INET;
+		ret = 0;
+	}
+#endif
+
+	if (!ret) {
+		ret = net_context_get(stream_peer.family, SOCK_DGRAM,
+				      IPPROTO_UDP, &stream_context);
+	}
+
+	__ASSERT(!ret, "no capture stream context");
+}
+
+static void stream_out(const void *data, size_t len)
+{
+	struct net_buf *buf;
+
+	if (!stream_context) {
+		return;
+	}
+
+	buf = net_nbuf_get_tx(stream_context, K_NO_WAIT);
+	if (!buf) {
+		return;
+	}
+
+	if (!net_nbuf_append(buf, len, data, K_NO_WAIT) ||
+	    net_context_sendto(buf, &stream_peer, sizeof(stream_peer), NULL,
+			       K_NO_WAIT, NULL, NULL) < 0) {
+		net_nbuf_unref(buf);
+	}
+}
+
+static inline bool is_stream_buf(struct net_buf *buf)
+{
+	return stream_context && net_nbuf_context(buf) == stream_context;
+}
+#else
+#define is_stream_buf(...) false
+#endif /* CONFIG_NET_CAPTURE_STREAM_UDP */
+
+static void iface_idb_cb(struct net_if *iface, void *user_data)
+{
+	struct pcapng_idb idb = {
+		.type = PCAPNG_IDB_TYPE,
+		.len = sizeof(idb),
+		.linktype = PCAPNG_LINKTYPE_RAW,
+		.snaplen = SNAPLEN,
+		.len_end = sizeof(idb),
+	};
+
+	ARG_UNUSED(iface);
+	ARG_UNUSED(user_data);
+
+	stream_out(&idb, sizeof(idb));
+}
+
+/* A new section, with an interface description for each interface, in
+ * the order of their index
+ */
+static void stream_section(void)
+{
+	struct pcapng_shb shb = {
+		.type = PCAPNG_SHB_TYPE,
+		.len = sizeof(shb),
+		.magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major = 1,
+		.minor = 0,
+		.section_len = { 0xffffffff, 0xffffffff },
+		.len_end = sizeof(shb),
+	};
+
+	stream_out(&shb, sizeof(shb));
+
+	net_if_foreach(iface_idb_cb, NULL);
+}
+
+static void stream_rec(struct capture_rec *rec)
+{
+	struct pcapng_epb *epb = (struct pcapng_epb *)block;
+	struct pcapng_epb_end *end;
+	uint64_t ts = (uint64_t)rec->time * USEC_PER_MSEC;
+	uint16_t padded = ROUND_UP(rec->len, sizeof(uint32_t));
+	uint8_t *data = (uint8_t *)(epb + 1);
+
+	epb->type = PCAPNG_EPB_TYPE;
+	epb->len = sizeof(*epb) + padded + sizeof(*end);
+	epb->iface = rec->iface;
+	epb->ts_high = ts >> 32;
+	epb->ts_low = ts;
+	epb->caplen = rec->len;
+	epb->orig_len = rec->orig_len;
+
+	memcpy(data, rec->data, rec->len);
+	memset(data + rec->len, 0, padded - rec->len);
+
+	end = (struct pcapng_epb_end *)(data + padded);
+	end->code = PCAPNG_EPB_FLAGS;
+	end->opt_len = sizeof(end->flags);
+	/* Inbound is 1 and outbound 2, as NET_CAPTURE_RX and _TX */
+	end->flags = rec->dir;
+	end->end_of_opt = 0;
+	end->len_end = epb->len;
+
+	stream_out(block, epb->len);
+}
+
+static void stream_ring(void)
+{
+	struct capture_rec rec;
+
+	while (ring_tail != (uint32_t)atomic_get(&ring_head)) {
+		uint32_t head = atomic_get(&ring_head);
+		struct capture_rec *slot;
+		uint32_t seq;
+
+		if (head - ring_tail > RING_SIZE) {
+			atomic_add(&lost, head - ring_tail - RING_SIZE);
+			ring_tail = head - RING_SIZE;
+		}
+
+		slot = &ring[ring_tail % RING_SIZE];
+		seq = atomic_get(&slot->seq);
+
+		/* Still being written, or not written yet: next time */
+		if (!seq || (int32_t)(seq - (ring_tail + 1)) < 0) {
+			break;
+		}
+
+		if (seq == ring_tail + 1) {
+			memcpy(&rec, slot, sizeof(rec));
+		}
+
+		/* Overwritten by a newer record, possibly while copied */
+		if (seq != ring_tail + 1 || atomic_get(&slot->seq) != seq) {
+			atomic_inc(&lost);
+			ring_tail++;
+			continue;
+		}
+
+		stream_rec(&rec);
+		ring_tail++;
+	}
+}
+
+static void capture_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	stream_init();
+
+	for (;;) {
+		if (atomic_get(&capture_dir)) {
+			k_sleep(CONFIG_NET_CAPTURE_PERIOD);
+		} else {
+			k_sem_take(&net_capture_wakeup, K_FOREVER);
+		}
+
+		if (atomic_clear(&restart)) {
+			ring_tail = atomic_get(&start_idx);
+			stream_section();
+		}
+
+		stream_ring();
+	}
+}
+
+K_THREAD_DEFINE(net_capture_tid, CONFIG_NET_CAPTURE_STACK_SIZE,
+		capture_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+static bool filter_match(struct net_if *iface, struct net_buf *buf)
+{
+	uint16_t len = buf->frags->len;
+	sa_family_t family;
+	uint8_t proto, hdr_len;
+	uint8_t *ports;
+
+	if (filter.iface && filter.iface != iface) {
+		return false;
+	}
+
+	if (!filter.family && !filter.proto && !filter.port) {
+		return true;
+	}
+
+	switch (len ? NET_IPV6_BUF(buf)->vtc & 0xf0 : 0) {
+	case 0x60:
+		if (len < sizeof(struct net_ipv6_hdr)) {
+			return false;
+		}
+
+		family = AF_INET6;
+		proto = NET_IPV6_BUF(buf)->nexthdr;
+		hdr_len = sizeof(struct net_ipv6_hdr);
+		break;
+	case 0x40:
+		if (len < sizeof(struct net_ipv4_hdr)) {
+			return false;
+		}
+
+		family = AF_INET;
+		proto = NET_IPV4_BUF(buf)->proto;
+		hdr_len = (NET_IPV4_BUF(buf)->vhl & 0x0f) * 4;
+		break;
+	default:
+		return false;
+	}
+
+	if ((filter.family && filter.family != family) ||
+	    (filter.proto && filter.proto != proto)) {
+		return false;
+	}
+
+	if (!filter.port) {
+		return true;
+	}
+
+	/* Both UDP and TCP headers start with the ports */
+	if ((proto != IPPROTO_UDP && proto != IPPROTO_TCP) ||
+	    len < hdr_len + 2 * sizeof(uint16_t)) {
+		return false;
+	}
+
+	ports = net_nbuf_ip_data(buf) + hdr_len;
+
+	return ((ports[0] << 8) | ports[1]) == filter.port ||
+		((ports[2] << 8) | ports[3]) == filter.port;
+}
+
+void net_capture_buf(struct net_if *iface, struct net_buf *buf, uint8_t dir)
+{
+	struct capture_rec *rec;
+	struct net_buf *frag;
+	uint32_t idx;
+	uint16_t len = 0;
+
+	if (!(atomic_get(&capture_dir) & dir) || !buf->frags ||
+	    is_stream_buf(buf) || !filter_match(iface, buf)) {
+		return;
+	}
+
+	idx = atomic_inc(&ring_head);
+	rec = &ring[idx % RING_SIZE];
+
+	atomic_set(&rec->seq, 0);
+
+	rec->time = k_uptime_get_32();
+	rec->orig_len = net_buf_frags_len(buf);
+	rec->iface = net_if_get_by_iface(iface);
+	rec->dir = dir;
+
+	for (frag = buf->frags; frag && len < SNAPLEN; frag = frag->frags) {
+		uint16_t copy = min(frag->len, SNAPLEN - len);
+
+		memcpy(rec->data + len, frag->data, copy);
+		len += copy;
+	}
+
+	rec->len = len;
+
+	atomic_set(&rec->seq, idx + 1);
+}
+
+void net_capture_start(const struct net_capture_filter *new_filter)
+{
+	atomic_set(&capture_dir, 0);
+
+	if (new_filter) {
+		filter = *new_filter;
+	} else {
+		memset(&filter, 0, sizeof(filter));
+	}
+
+	atomic_set(&start_idx, atomic_get(&ring_head));
+	atomic_set(&restart, 1);
+	atomic_set(&capture_dir, filter.dir ? filter.dir :
+		   NET_CAPTURE_RX | NET_CAPTURE_TX);
+
+	k_sem_give(&net_capture_wakeup);
+}
+
+void net_capture_stop(void)
+{
+	atomic_set(&capture_dir, 0);
+}
+
+bool net_capture_get(struct net_capture_filter *current, uint32_t *lost_recs)
+{
+	if (current) {
+		*current = filter;
+	}
+
+	if (lost_recs) {
+		*lost_recs = atomic_get(&lost);
+	}
+
+	return atomic_get(&capture_dir) != 0;
+}
@@ -167,6 +167,25 @@ static uint16_t find_available_port(struct net_context *context,
 	return net_sin(addr)->sin_port;
 }
 
+#if defined(CONFIG_NET_CONTEXT_HDR_CACHE)
+/* The cached headers are valid while this does not change. It starts
+ * at 1 so that a zeroed cache is never valid.
+ */
+static uint32_t hdr_cache_gen = 1;
+
+void net_context_hdr_cache_flush(void)
+{
+	hdr_cache_gen++;
+}
+
+static inline void hdr_cache_clear(struct net_context *context)
+{
+	context->hdr_cache.len = 0;
+}
+#else
+#define hdr_cache_clear(context)
+#endif /* CONFIG_NET_CONTEXT_HDR_CACHE */
+
 int net_context_get(sa_family_t family,
 		    enum net_sock_type type,
 		    enum net_ip_protocol ip_proto,
@@ -203,7 +222,7 @@ int net_context_get(sa_family_t family,
 	}
 #endif
 
-#if !defined(CONFIG_NET_TCP)
+#if !defined(CONFIG_NET_TCP) && !defined(CONFIG_NET_L2_OFFLOAD_IP)
 	if (type == SOCK_STREAM) {
 		NET_ASSERT_INFO(type != SOCK_STREAM,
 				"Stream context disabled");
@@ -259,7 +278,9 @@ int net_context_get(sa_family_t family,
 		}
 
 #if defined(CONFIG_NET_TCP)
-		if (ip_proto == IPPROTO_TCP) {
+		/* An offloaded IP stack has its own TCP */
+		if (ip_proto == IPPROTO_TCP &&
+		    !net_if_is_ip_offloaded(net_if_get_default())) {
 			contexts[i].tcp = net_tcp_alloc(&contexts[i]);
 			if (!contexts[i].tcp) {
 				NET_ASSERT_INFO(contexts[i].tcp,
@@ -270,6 +291,7 @@ int net_context_get(sa_family_t family,
 #endif /* CONFIG_NET_TCP */
 
 		contexts[i].flags = 0;
+		contexts[i].priority = 0;
 		atomic_set(&contexts[i].refcount, 1);
 
 		net_context_set_family(&contexts[i], family);
@@ -281,6 +303,7 @@ int net_context_get(sa_family_t family,
 
 		memset(&contexts[i].remote, 0, sizeof(struct sockaddr));
 		memset(&contexts[i].local, 0, sizeof(struct sockaddr_ptr));
+		hdr_cache_clear(&contexts[i]);
 
 #if defined(CONFIG_NET_IPV6)
 		if (family == AF_INET6) {
@@ -313,6 +336,11 @@ int net_context_get(sa_family_t family,
 		k_sem_give(&contexts[i].recv_data_wait);
 #endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
 
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+		contexts[i].tx_pool = NULL;
+		contexts[i].data_pool = NULL;
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
 		*context = &contexts[i];
 
 		ret = 0;
@@ -326,6 +354,10 @@ int net_context_get(sa_family_t family,
 	 * as it is not known at this point yet.
 	 */
 	if (!ret && net_if_is_ip_offloaded(net_if_get_default())) {
+		net_context_set_iface(*context, net_if_get_default());
+		(*context)->recv_user_data = NULL;
+		(*context)->offload_context = NULL;
+
 		ret = net_l2_offload_ip_get(net_if_get_default(),
 					    family,
 					    type,
@@ -349,20 +381,161 @@ static void queue_fin(struct net_context *ctx)
 	struct net_buf *buf = NULL;
 	int ret;
 
+	/* Data held back for coalescing goes before the FIN */
+	ctx->tcp->fin_queued = 1;
+	net_tcp_send_data(ctx);
+
 	ret = net_tcp_prepare_segment(ctx->tcp, NET_TCP_FIN, NULL, 0,
 				      NULL, &ctx->remote, &buf);
 	if (ret || !buf) {
 		return;
 	}
 
-	ctx->tcp->fin_queued = 1;
-
 	ret = net_tcp_send_buf(buf);
 	if (ret < 0) {
 		net_nbuf_unref(buf);
 	}
 }
 
+/* Time a connection being established stays in the SYN cache, long enough
+ * for the peer to retransmit its SYN once
+ */
+#define SYN_CACHE_TIMEOUT (3 * MSEC_PER_SEC)
+
+/* Connections being established, only given a context and a TCP once the
+ * handshake completes. An entry is free when it has no listener.
+ */
+struct syn_cache_entry {
+	struct net_context *listener;
+	struct net_if *iface;
+	struct sockaddr remote;
+	/* Our initial sequence number */
+	uint32_t iss;
+	/* Sequence number following the SYN of the peer */
+	uint32_t send_ack;
+	/* Uptime when the last SYN was received, in ms */
+	uint32_t timestamp;
+	bool sack_ok;
+};
+
+static struct syn_cache_entry syn_cache[CONFIG_NET_TCP_SYN_CACHE_SIZE];
+
+static bool syn_cache_match(struct syn_cache_entry *entry,
+			    struct net_context *listener,
+			    const struct sockaddr *remote)
+{
+	if (entry->listener != listener ||
+	    entry->remote.family != remote->family) {
+		return false;
+	}
+
+#if defined(CONFIG_NET_IPV6)
+	if (remote->family == AF_INET6) {
+		return net_sin6(&entry->remote)->sin6_port ==
+			net_sin6(remote)->sin6_port &&
+			net_ipv6_addr_cmp(&net_sin6(&entry->remote)->sin6_addr,
+					  &net_sin6(remote)->sin6_addr);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (remote->family == AF_INET) {
+		return net_sin(&entry->remote)->sin_port ==
+			net_sin(remote)->sin_port &&
+			net_ipv4_addr_cmp(&net_sin(&entry->remote)->sin_addr,
+					  &net_sin(remote)->sin_addr);
+	}
+#endif
+
+	return false;
+}
+
+static void syn_cache_expire(void)
+{
+	uint32_t now = k_uptime_get_32();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(syn_cache); i++) {
+		if (syn_cache[i].listener &&
+		    now - syn_cache[i].timestamp > SYN_CACHE_TIMEOUT) {
+			NET_DBG("Connection %p to listener %p expired",
+				&syn_cache[i], syn_cache[i].listener);
+			syn_cache[i].listener = NULL;
+		}
+	}
+}
+
+static struct syn_cache_entry *syn_cache_find(struct net_context *listener,
+					      const struct sockaddr *remote)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(syn_cache); i++) {
+		if (syn_cache_match(&syn_cache[i], listener, remote)) {
+			return &syn_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns NULL if the backlog of the listener or the cache is full */
+static struct syn_cache_entry *syn_cache_add(struct net_context *listener,
+					     const struct sockaddr *remote,
+					     struct net_if *iface)
+{
+	struct syn_cache_entry *entry = NULL;
+	int i, pending = 0;
+	unsigned int key;
+
+	key = irq_lock();
+
+	for (i = 0; i < ARRAY_SIZE(syn_cache); i++) {
+		if (syn_cache[i].listener == listener) {
+			pending++;
+		} else if (!syn_cache[i].listener && !entry) {
+			entry = &syn_cache[i];
+		}
+	}
+
+	if (pending >= listener->tcp->backlog) {
+		entry = NULL;
+	}
+
+	if (entry) {
+		entry->listener = listener;
+	}
+
+	irq_unlock(key);
+
+	if (entry) {
+		entry->iface = iface;
+		memcpy(&entry->remote, remote, sizeof(entry->remote));
+		entry->iss = sys_rand32_get();
+	}
+
+	return entry;
+}
+
+static inline void syn_cache_remove(struct syn_cache_entry *entry)
+{
+	entry->listener = NULL;
+}
+
+static void syn_cache_flush(struct net_context *listener)
+{
+	unsigned int key = irq_lock();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(syn_cache); i++) {
+		if (syn_cache[i].listener == listener) {
+			syn_cache[i].listener = NULL;
+		}
+	}
+
+	irq_unlock(key);
+}
+
 #endif /* CONFIG_NET_TCP */
 
 int net_context_ref(struct net_context *context)
@@ -384,6 +557,7 @@ int net_context_unref(struct net_context *context)
 
 #if defined(CONFIG_NET_TCP)
 	if (context->tcp) {
+		syn_cache_flush(context);
 		net_tcp_release(context->tcp);
 	}
 #endif /* CONFIG_NET_TCP */
@@ -409,10 +583,19 @@ int net_context_put(struct net_context *context)
 
 #if defined(CONFIG_NET_L2_OFFLOAD_IP)
 	if (net_if_is_ip_offloaded(net_context_get_iface(context))) {
+		int ret;
+
+		ret = net_l2_offload_ip_put(net_context_get_iface(context),
+					    context);
+
 		k_sem_take(&contexts_lock, K_FOREVER);
+		context->connect_cb = NULL;
+		context->recv_cb = NULL;
+		context->send_cb = NULL;
 		context->flags &= ~NET_CONTEXT_IN_USE;
-		return net_l2_offload_ip_put(
-			net_context_get_iface(context), context);
+		k_sem_give(&contexts_lock);
+
+		return ret;
 	}
 #endif /* CONFIG_NET_L2_OFFLOAD_IP */
 
@@ -443,6 +626,8 @@ int net_context_bind(struct net_context *context, const struct sockaddr *addr,
 	NET_ASSERT(addr);
 	NET_ASSERT(PART_OF_ARRAY(contexts, context));
 
+	hdr_cache_clear(context);
+
 #if defined(CONFIG_NET_IPV6)
 	if (addr->family == AF_INET6) {
 		struct net_if *iface = NULL;
@@ -615,8 +800,6 @@ static inline struct net_context *find_context(void *conn_handler)
 
 int net_context_listen(struct net_context *context, int backlog)
 {
-	ARG_UNUSED(backlog);
-
 	NET_ASSERT(PART_OF_ARRAY(contexts, context));
 
 	if (!net_context_is_used(context)) {
@@ -635,6 +818,9 @@ int net_context_listen(struct net_context *context, int backlog)
 		net_tcp_change_state(context->tcp, NET_TCP_LISTEN);
 		net_context_set_state(context, NET_CONTEXT_LISTENING);
 
+		context->tcp->backlog = max(1, min(backlog,
+					CONFIG_NET_TCP_SYN_CACHE_SIZE));
+
 		return 0;
 	}
 #endif
@@ -715,8 +901,34 @@ static inline int send_syn_ack(struct net_context *context,
 				    "SYN_ACK");
 }
 
+/* Sends the SYN-ACK of a connection of the SYN cache, with the sequence
+ * numbers of the connection lent to the TCP of the listening context
+ */
+static int send_syn_ack_cached(struct net_context *context,
+			       struct syn_cache_entry *entry,
+			       struct sockaddr_ptr *local,
+			       struct sockaddr *remote)
+{
+	struct net_tcp *tcp = context->tcp;
+	uint32_t recv_max_ack = tcp->recv_max_ack;
+	uint32_t send_seq = tcp->send_seq;
+	uint32_t send_ack = tcp->send_ack;
+	int ret;
+
+	tcp->send_seq = entry->iss;
+	tcp->send_ack = entry->send_ack;
+
+	ret = send_syn_ack(context, local, remote);
+
+	tcp->recv_max_ack = recv_max_ack;
+	tcp->send_seq = send_seq;
+	tcp->send_ack = send_ack;
+
+	return ret;
+}
+
 static inline int send_ack(struct net_context *context,
-			   struct sockaddr *remote)
+			   struct sockaddr *remote, bool force)
 {
 	struct net_buf *buf = NULL;
 	int ret;
@@ -724,7 +936,7 @@ static inline int send_ack(struct net_context *context,
 	/* Something (e.g. a data transmission under the user
 	 * callback) already sent the ACK, no need
 	 */
-	if (context->tcp->send_ack == context->tcp->sent_ack) {
+	if (!force && context->tcp->send_ack == context->tcp->sent_ack) {
 		return 0;
 	}
 
@@ -772,14 +984,259 @@ static int tcp_hdr_len(struct net_buf *buf)
 	return 4 * (hdr->offset >> 4);
 }
 
+/* Skip the first bytes of the application data, already received in an
+ * earlier segment.
+ */
+static void tcp_trim_appdata(struct net_buf *buf, uint16_t len)
+{
+	uint8_t *data = net_nbuf_appdata(buf);
+	struct net_buf *frag = buf->frags;
+
+	net_nbuf_set_appdatalen(buf, net_nbuf_appdatalen(buf) - len);
+
+	while (frag && (data < frag->data || data > frag->data + frag->len)) {
+		frag = frag->frags;
+	}
+
+	if (!frag) {
+		return;
+	}
+
+	while (frag->frags && len >= frag->data + frag->len - data) {
+		len -= frag->data + frag->len - data;
+		frag = frag->frags;
+		data = frag->data;
+	}
+
+	net_nbuf_set_appdata(buf, data + len);
+}
+
+/* Tell the peer when the receive window opens again, as it stops
+ * sending once the window is full.
+ */
+static void send_wnd_update(struct net_context *context, uint16_t old_wnd)
+{
+	uint16_t threshold = min(NET_TCP_BUF_MAX_LEN / 2,
+				 net_tcp_get_recv_mss(context->tcp));
+
+	if (old_wnd < threshold &&
+	    net_tcp_get_recv_wnd(context->tcp) >= threshold &&
+	    net_tcp_get_state(context->tcp) == NET_TCP_ESTABLISHED) {
+		send_ack(context, &context->remote, true);
+	}
+}
+
+/* Hand the received data to the application, in order and from one
+ * thread at a time, as the receive callback can be set up from another
+ * thread than the RX one.
+ */
+static void tcp_deliver_queued(struct net_context *context)
+{
+	struct net_tcp *tcp = context->tcp;
+	struct net_buf *buf;
+	sys_snode_t *node;
+	int key;
+
+	key = irq_lock();
+
+	if (tcp->recv_draining) {
+		irq_unlock(key);
+		return;
+	}
+
+	tcp->recv_draining = true;
+
+	while (context->recv_cb &&
+	       (node = sys_slist_get(&tcp->recv_queue))) {
+		buf = CONTAINER_OF(node, struct net_buf, sent_list);
+
+		/* Delivered data is consumed, unless the application says
+		 * otherwise with net_context_update_recv_wnd().
+		 */
+		tcp->recv_wnd += net_nbuf_appdatalen(buf);
+
+		irq_unlock(key);
+
+		context->recv_cb(context, buf, 0, tcp->recv_user_data);
+
+#if defined(CONFIG_NET_CONTEXT_SYNC_RECV)
+		k_sem_give(&context->recv_data_wait);
+#endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
+
+		key = irq_lock();
+	}
+
+	tcp->recv_draining = false;
+
+	irq_unlock(key);
+}
+
+/* Queue in order data for the application, if there is room for it or
+ * it can be delivered at once.
+ */
+static bool tcp_queue_recv(struct net_context *context, struct net_buf *buf,
+			   uint32_t seq)
+{
+	struct net_tcp *tcp = context->tcp;
+	uint16_t len;
+	int key;
+
+	set_appdata_values(buf, IPPROTO_TCP, net_buf_frags_len(buf));
+	if (seq != tcp->send_ack) {
+		tcp_trim_appdata(buf, tcp->send_ack - seq);
+	}
+
+	len = net_nbuf_appdatalen(buf);
+
+	key = irq_lock();
+
+	if (len > net_tcp_get_recv_wnd(tcp) &&
+	    !(context->recv_cb && sys_slist_is_empty(&tcp->recv_queue))) {
+		irq_unlock(key);
+		return false;
+	}
+
+	tcp->recv_wnd -= len;
+	sys_slist_append(&tcp->recv_queue, &buf->sent_list);
+
+	irq_unlock(key);
+
+	tcp->send_ack += len;
+
+	return true;
+}
+
+/* Keep a segment received after a lost one, to queue it once the missing
+ * data is there.
+ */
+static bool tcp_queue_ooo(struct net_tcp *tcp, struct net_buf *buf,
+			  uint32_t seq, uint16_t len)
+{
+	struct net_buf *entry, *prev = NULL;
+
+	if (tcp->ooo_count >= NET_TCP_MAX_OUT_OF_ORDER ||
+	    seq + len - tcp->send_ack > net_tcp_get_recv_wnd(tcp)) {
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_queue, entry, sent_list) {
+		uint32_t entry_seq = sys_get_be32(NET_TCP_BUF(entry)->seq);
+
+		if (entry_seq == seq && net_tcp_data_len(entry) >= len) {
+			return false;
+		}
+
+		if (net_tcp_seq_greater(entry_seq, seq)) {
+			break;
+		}
+
+		prev = entry;
+	}
+
+	/* Until it is queued for the application, for the SACK blocks */
+	net_nbuf_set_appdatalen(buf, len);
+
+	sys_slist_insert(&tcp->ooo_queue, prev ? &prev->sent_list : NULL,
+			 &buf->sent_list);
+	tcp->ooo_count++;
+
+	return true;
+}
+
+/* Get the first out of order segment once there is no gap before it */
+static struct net_buf *tcp_dequeue_ooo(struct net_tcp *tcp)
+{
+	struct net_buf *buf;
+	sys_snode_t *node;
+	uint32_t seq;
+
+	while ((node = sys_slist_peek_head(&tcp->ooo_queue))) {
+		buf = CONTAINER_OF(node, struct net_buf, sent_list);
+		seq = sys_get_be32(NET_TCP_BUF(buf)->seq);
+
+		if (net_tcp_seq_greater(seq, tcp->send_ack)) {
+			return NULL;
+		}
+
+		sys_slist_remove(&tcp->ooo_queue, NULL, node);
+		tcp->ooo_count--;
+
+		if (net_tcp_seq_greater(seq + net_tcp_data_len(buf),
+					tcp->send_ack)) {
+			return buf;
+		}
+
+		/* All of it was received in the meantime */
+		net_nbuf_unref(buf);
+	}
+
+	return NULL;
+}
+
+/* Header prediction: the ACK of sent data, or the next data of a one-way
+ * transfer that the application can take at once. Returns false if the
+ * segment needs the full processing.
+ */
+static bool tcp_fast_path(struct net_context *context, struct net_conn *conn,
+			  struct net_buf *buf, enum net_verdict *verdict)
+{
+	struct net_tcp *tcp = context->tcp;
+	uint16_t len;
+
+	if (!net_tcp_predicted(tcp, buf)) {
+		return false;
+	}
+
+	len = net_tcp_data_len(buf);
+
+	if (!len) {
+		if (!net_tcp_fast_ack(context, buf)) {
+			return false;
+		}
+
+		/* Segments without data are passed on as they are */
+		if (context->recv_cb && sys_slist_is_empty(&tcp->recv_queue)) {
+			set_appdata_values(buf, IPPROTO_TCP,
+					   net_buf_frags_len(buf));
+			*verdict = packet_received(conn, buf,
+						   tcp->recv_user_data);
+		} else {
+			*verdict = NET_DROP;
+		}
+
+		return true;
+	}
+
+	if (!sys_slist_is_empty(&tcp->sent_list) ||
+	    sys_get_be32(NET_TCP_BUF(buf)->ack) != tcp->send_seq ||
+	    !context->recv_cb || !sys_slist_is_empty(&tcp->recv_queue) ||
+	    len > net_tcp_get_recv_wnd(tcp)) {
+		return false;
+	}
+
+	net_context_set_iface(context, net_nbuf_iface(buf));
+	net_nbuf_set_context(buf, context);
+
+	tcp_queue_recv(context, buf, tcp->send_ack);
+	tcp_deliver_queued(context);
+
+	net_tcp_ack_data(tcp);
+
+	*verdict = NET_OK;
+
+	return true;
+}
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  */
 NET_CONN_CB(tcp_established)
 {
 	struct net_context *context = (struct net_context *)user_data;
-	enum net_verdict ret;
+	enum net_verdict ret = NET_OK;
 	uint8_t tcp_flags;
+	uint32_t seq;
+	uint16_t len;
 
 	NET_ASSERT(context && context->tcp);
 
@@ -791,24 +1248,74 @@ NET_CONN_CB(tcp_established)
 
 	net_tcp_print_recv_info("DATA", buf, NET_TCP_BUF(buf)->src_port);
 
+	if (tcp_fast_path(context, conn, buf, &ret)) {
+		return ret;
+	}
+
 	tcp_flags = NET_TCP_FLAGS(buf);
 	if (tcp_flags & NET_TCP_ACK) {
-		net_tcp_ack_received(context,
-				     sys_get_be32(NET_TCP_BUF(buf)->ack));
+		net_tcp_ack_received(context, buf);
+	}
+
+	seq = sys_get_be32(NET_TCP_BUF(buf)->seq);
+	len = net_tcp_data_len(buf);
+
+	if (net_tcp_seq_greater(seq, context->tcp->send_ack)) {
+		/* Data after a lost segment can be kept, control segments
+		 * are retransmitted anyway. The duplicate ACK tells the
+		 * peer what is missing.
+		 */
+		bool queued = len && !(tcp_flags & (NET_TCP_SYN |
+						    NET_TCP_FIN |
+						    NET_TCP_RST)) &&
+			tcp_queue_ooo(context->tcp, buf, seq, len);
+
+		send_ack(context, &conn->remote_addr, true);
+
+		return queued ? NET_OK : NET_DROP;
 	}
 
-	if (sys_get_be32(NET_TCP_BUF(buf)->seq) - context->tcp->send_ack) {
-		/* Don't try to reorder packets.  If it doesn't
-		 * match the next segment exactly, drop and wait for
-		 * retransmit
+	if (seq != context->tcp->send_ack &&
+	    !net_tcp_seq_greater(seq + len, context->tcp->send_ack)) {
+		/* Retransmission of what was already received, maybe
+		 * because our ACK was lost.
 		 */
+		send_ack(context, &conn->remote_addr, true);
+
 		return NET_DROP;
 	}
 
-	set_appdata_values(buf, IPPROTO_TCP, net_buf_frags_len(buf));
-	context->tcp->send_ack += net_nbuf_appdatalen(buf);
+	if (len) {
+		net_context_set_iface(context, net_nbuf_iface(buf));
+		net_nbuf_set_context(buf, context);
+
+		if (!tcp_queue_recv(context, buf, seq)) {
+			/* No room for the data, tell the current window */
+			send_ack(context, &conn->remote_addr, true);
+
+			return NET_DROP;
+		}
+
+		while ((buf = tcp_dequeue_ooo(context->tcp))) {
+			net_nbuf_set_context(buf, context);
+
+			if (!tcp_queue_recv(context, buf,
+					    sys_get_be32(NET_TCP_BUF(buf)->seq))) {
+				net_nbuf_unref(buf);
+				break;
+			}
+		}
+
+		tcp_deliver_queued(context);
+	} else if (context->recv_cb &&
+		   sys_slist_is_empty(&context->tcp->recv_queue)) {
+		/* Segments without data are passed on as they are */
+		set_appdata_values(buf, IPPROTO_TCP, net_buf_frags_len(buf));
 
-	ret = packet_received(conn, buf, context->tcp->recv_user_data);
+		ret = packet_received(conn, buf, context->tcp->recv_user_data);
+	} else {
+		ret = NET_DROP;
+	}
 
 	if (tcp_flags & NET_TCP_FIN) {
 		/* Sending an ACK in the CLOSE_WAIT state will transition to
@@ -825,7 +1332,11 @@ NET_CONN_CB(tcp_established)
 		}
 	}
 
-	send_ack(context, &conn->remote_addr);
+	if (len && !(tcp_flags & NET_TCP_FIN)) {
+		net_tcp_ack_data(context->tcp);
+	} else {
+		send_ack(context, &conn->remote_addr, false);
+	}
 
 	if (sys_slist_is_empty(&context->tcp->sent_list)
 	    && context->tcp->fin_rcvd
@@ -871,6 +1382,8 @@ NET_CONN_CB(tcp_synack_received)
 		context->tcp->send_ack =
 			sys_get_be32(NET_TCP_BUF(buf)->seq) + 1;
 		context->tcp->recv_max_ack = context->tcp->send_seq + 1;
+
+		net_tcp_syn_received(context->tcp, buf);
 	}
 	/*
 	 * If we receive SYN, we send SYN-ACK and go to SYN_RCVD state.
@@ -946,7 +1459,7 @@ NET_CONN_CB(tcp_synack_received)
 		net_tcp_change_state(context->tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(context, NET_CONTEXT_CONNECTED);
 
-		send_ack(context, raddr);
+		send_ack(context, raddr, false);
 
 		k_sem_give(&context->tcp->connect_wait);
 
@@ -984,6 +1497,8 @@ int net_context_connect(struct net_context *context,
 		return -ENOENT;
 	}
 
+	hdr_cache_clear(context);
+
 	if (addr->family != net_context_get_family(context)) {
 		NET_ASSERT_INFO(addr->family == \
 				net_context_get_family(context),
@@ -1149,20 +1664,6 @@ int net_context_connect(struct net_context *context,
 
 #if defined(CONFIG_NET_TCP)
 
-#define ACK_TIMEOUT MSEC_PER_SEC
-
-static void ack_timeout(struct k_work *work)
-{
-	/* This means that we did not receive ACK response in time. */
-	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, ack_timer);
-
-	NET_DBG("Did not receive ACK in %dms", ACK_TIMEOUT);
-
-	send_reset(tcp->context, &tcp->context->remote);
-
-	net_tcp_change_state(tcp, NET_TCP_LISTEN);
-}
-
 static void buf_get_sockaddr(sa_family_t family, struct net_buf *buf,
 			     struct sockaddr_ptr *addr)
 {
@@ -1190,30 +1691,23 @@ static void buf_get_sockaddr(sa_family_t family, struct net_buf *buf,
 }
 
 /* This callback is called when we are waiting connections and we receive
- * a packet. We need to check if we are receiving proper msg (SYN) here.
- * The ACK could also be received, in which case we have an established
- * connection.
+ * a packet. The connections being established are kept in the SYN cache:
+ * a SYN adds one and gets a SYN-ACK, and the ACK completing the handshake
+ * moves it to a new context, passed to the accept callback.
  */
 NET_CONN_CB(tcp_syn_rcvd)
 {
 	struct net_context *context = (struct net_context *)user_data;
+	struct syn_cache_entry *entry;
 	struct net_tcp *tcp;
 	struct sockaddr_ptr buf_src_addr;
+	struct sockaddr peer, *remote;
 
 	NET_ASSERT(context && context->tcp);
 
 	tcp = context->tcp;
 
-	switch (net_tcp_get_state(tcp)) {
-	case NET_TCP_LISTEN:
-		net_context_set_iface(context, net_nbuf_iface(buf));
-		break;
-	case NET_TCP_SYN_RCVD:
-		if (net_nbuf_iface(buf) != net_context_get_iface(context)) {
-			return NET_DROP;
-		}
-		break;
-	default:
+	if (net_tcp_get_state(tcp) != NET_TCP_LISTEN) {
 		NET_DBG("Context %p in wrong state %d",
 			context, tcp->state);
 		return NET_DROP;
@@ -1223,71 +1717,89 @@ NET_CONN_CB(tcp_syn_rcvd)
 
 	NET_ASSERT(net_nbuf_iface(buf));
 
+	remote = create_sockaddr(buf, &peer);
+	if (!remote) {
+		return NET_DROP;
+	}
+
+	syn_cache_expire();
+
+	entry = syn_cache_find(context, remote);
+	if (entry && entry->iface != net_nbuf_iface(buf)) {
+		return NET_DROP;
+	}
+
 	/*
-	 * If we receive SYN, we send SYN-ACK and go to SYN_RCVD state.
+	 * If we receive SYN, we send SYN-ACK, the connection staying in
+	 * the SYN cache until its ACK. A retransmitted SYN gets the same
+	 * SYN-ACK again.
 	 */
 	if (NET_TCP_FLAGS(buf) == NET_TCP_SYN) {
-		struct sockaddr peer, *remote;
-
 		net_tcp_print_recv_info("SYN", buf, NET_TCP_BUF(buf)->src_port);
 
-		net_tcp_change_state(tcp, NET_TCP_SYN_RCVD);
+		if (!entry) {
+			entry = syn_cache_add(context, remote,
+					      net_nbuf_iface(buf));
+			if (!entry) {
+				NET_DBG("Backlog of %p full, SYN dropped",
+					context);
+				return NET_DROP;
+			}
+		}
 
-		remote = create_sockaddr(buf, &peer);
+		entry->send_ack = sys_get_be32(NET_TCP_BUF(buf)->seq) + 1;
+		entry->timestamp = k_uptime_get_32();
 
-		/* FIXME: Is this the correct place to set tcp->send_ack? */
-		context->tcp->send_ack =
-			sys_get_be32(NET_TCP_BUF(buf)->seq) + 1;
-		context->tcp->recv_max_ack = context->tcp->send_seq + 1;
+		net_tcp_syn_received(tcp, buf);
+		entry->sack_ok = !!(tcp->flags & NET_TCP_SACK_OK);
 
-		buf_get_sockaddr(net_context_get_family(context),
-				 buf, &buf_src_addr);
-		send_syn_ack(context, &buf_src_addr, remote);
+		net_context_set_iface(context, net_nbuf_iface(buf));
 
-		/* We might be entering this section multiple times
-		 * if the SYN is sent more than once. So we need to cancel
-		 * any pending timers.
-		 */
-		k_delayed_work_cancel(&tcp->ack_timer);
-		k_delayed_work_init(&tcp->ack_timer, ack_timeout);
-		k_delayed_work_submit(&tcp->ack_timer, ACK_TIMEOUT);
+		buf_get_sockaddr(net_context_get_family(context),
+				 buf, &buf_src_addr);
+		send_syn_ack_cached(context, entry, &buf_src_addr, remote);
 
 		return NET_DROP;
 	}
 
 	/*
-	 * If we receive RST, we go back to LISTEN state.
+	 * If we receive RST, the connection is forgotten.
 	 */
 	if (NET_TCP_FLAGS(buf) == NET_TCP_RST) {
-		k_delayed_work_cancel(&tcp->ack_timer);
-
 		net_tcp_print_recv_info("RST", buf, NET_TCP_BUF(buf)->src_port);
 
-		net_tcp_change_state(tcp, NET_TCP_LISTEN);
+		if (entry) {
+			syn_cache_remove(entry);
+		}
 
 		return NET_DROP;
 	}
 
 	/*
-	 * If we receive ACK, we go to ESTABLISHED state.
+	 * If we receive ACK, the connection is established.
 	 */
 	if (NET_TCP_FLAGS(buf) == NET_TCP_ACK) {
 		struct net_context *new_context;
+		struct syn_cache_entry conn;
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
-		struct net_tcp *tmp_tcp;
+		struct net_tcp *new_tcp;
 		socklen_t addrlen;
 		int ret;
 
-		/* We can only receive ACK if we have already received SYN.
-		 * So if we are not in SYN_RCVD state, then it is an error.
+		/* We can only receive ACK if we have already received SYN,
+		 * and it must acknowledge our SYN-ACK
 		 */
-		if (net_tcp_get_state(tcp) != NET_TCP_SYN_RCVD) {
-			k_delayed_work_cancel(&tcp->ack_timer);
-			NET_DBG("Not in SYN_RCVD state, sending RST");
+		if (!entry ||
+		    sys_get_be32(NET_TCP_BUF(buf)->ack) != entry->iss + 1) {
+			NET_DBG("No connection being established, "
+				"sending RST");
 			goto reset;
 		}
 
+		conn = *entry;
+		syn_cache_remove(entry);
+
 		net_tcp_print_recv_info("ACK", buf, NET_TCP_BUF(buf)->src_port);
 
 		if (!context->tcp->accept_cb) {
@@ -1306,9 +1818,15 @@ NET_CONN_CB(tcp_syn_rcvd)
 			goto reset;
 		}
 
-		new_context->tcp->recv_max_ack = context->tcp->recv_max_ack;
-		new_context->tcp->send_seq = context->tcp->send_seq;
-		new_context->tcp->send_ack = context->tcp->send_ack;
+		new_tcp = new_context->tcp;
+		new_tcp->send_seq = conn.iss + 1;
+		new_tcp->recv_max_ack = new_tcp->send_seq;
+		new_tcp->send_ack = conn.send_ack;
+		new_tcp->sent_ack = conn.send_ack;
+		new_tcp->send_wnd = sys_get_be16(NET_TCP_BUF(buf)->wnd);
+		if (conn.sack_ok) {
+			new_tcp->flags |= NET_TCP_SACK_OK;
+		}
 
 #if defined(CONFIG_NET_IPV6)
 		if (net_context_get_family(context) == AF_INET6) {
@@ -1386,26 +1904,10 @@ NET_CONN_CB(tcp_syn_rcvd)
 			goto reset;
 		}
 
-		/* Swap the newly-created TCP states with the one that
-		 * was used to establish this connection. The new TCP
-		 * must be listening to accept other connections.
-		 */
-		tmp_tcp = new_context->tcp;
-		tmp_tcp->accept_cb = tcp->accept_cb;
-		tcp->accept_cb = NULL;
-		new_context->tcp = tcp;
-		context->tcp = tmp_tcp;
-
-		tcp->context = new_context;
-		tmp_tcp->context = context;
-
-		net_tcp_change_state(tmp_tcp, NET_TCP_LISTEN);
-
-		net_tcp_change_state(new_context->tcp, NET_TCP_ESTABLISHED);
+		net_tcp_change_state(new_tcp, NET_TCP_SYN_RCVD);
+		net_tcp_change_state(new_tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(new_context, NET_CONTEXT_CONNECTED);
 
-		k_delayed_work_cancel(&tcp->ack_timer);
-
 		context->tcp->accept_cb(new_context,
 					&new_context->remote,
 					addrlen,
@@ -1416,11 +1918,7 @@ NET_CONN_CB(tcp_syn_rcvd)
 	return NET_DROP;
 
 reset:
-	{
-		struct sockaddr peer;
-
-		send_reset(tcp->context, create_sockaddr(buf, &peer));
-	}
+	send_reset(context, remote);
 
 	return NET_DROP;
 }
@@ -1536,14 +2034,18 @@ static int send_data(struct net_context *context,
 {
 	context->send_cb = cb;
 	context->user_data = user_data;
-	net_nbuf_set_token(buf, token);
 
-	if (!timeout || net_context_get_ip_proto(context) == IPPROTO_UDP) {
+	if (net_context_get_ip_proto(context) == IPPROTO_UDP) {
+		net_nbuf_set_token(buf, token);
+
 		return net_send_data(buf);
 	}
 
 #if defined(CONFIG_NET_TCP)
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		/* The data was queued, maybe appended to an earlier write,
+		 * it goes out as the windows allow.
+		 */
 		int ret = net_tcp_send_data(context);
 
 		/* Just make the callback synchronously even if it didn't
@@ -1563,17 +2065,58 @@ static int send_data(struct net_context *context,
 	return -EPROTONOSUPPORT;
 }
 
+static int check_dst_addr(struct net_buf *buf,
+			  const struct sockaddr *dst_addr,
+			  socklen_t addrlen)
+{
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6) {
+		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
+
+		if (addrlen < sizeof(struct sockaddr_in6)) {
+			return -EINVAL;
+		}
+
+		if (net_is_ipv6_addr_unspecified(&addr6->sin6_addr)) {
+			return -EDESTADDRREQ;
+		}
+	} else
+#endif /* CONFIG_NET_IPV6 */
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET) {
+		struct sockaddr_in *addr4 = (struct sockaddr_in *)dst_addr;
+
+		if (addrlen < sizeof(struct sockaddr_in)) {
+			return -EINVAL;
+		}
+
+		if (!addr4->sin_addr.s_addr[0]) {
+			return -EDESTADDRREQ;
+		}
+	} else
+#endif /* CONFIG_NET_IPV4 */
+	{
+		NET_DBG("Invalid protocol family %d", net_nbuf_family(buf));
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 #if defined(CONFIG_NET_UDP)
+/* If src is NULL, the IPv6 source address is selected for this packet */
 static int create_udp_packet(struct net_context *context,
 			     struct net_buf *buf,
 			     const struct sockaddr *dst_addr,
+			     const struct in6_addr *src,
 			     struct net_buf **out_buf)
 {
 #if defined(CONFIG_NET_IPV6)
 	if (net_nbuf_family(buf) == AF_INET6) {
 		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
 
-		buf = net_ipv6_create(context, buf, NULL, &addr6->sin6_addr);
+		buf = net_ipv6_create(context, buf, src, &addr6->sin6_addr);
 		buf = net_udp_append(context, buf, ntohs(addr6->sin6_port));
 		buf = net_ipv6_finalize(context, buf);
 	} else
@@ -1613,6 +2156,19 @@ static int sendto(struct net_buf *buf,
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+	if (net_if_is_ip_offloaded(net_nbuf_iface(buf))) {
+		if (!dst_addr) {
+			return -EDESTADDRREQ;
+		}
+
+		return net_l2_offload_ip_sendto(
+			net_nbuf_iface(buf),
+			buf, dst_addr, addrlen,
+			cb, timeout, token, user_data);
+	}
+#endif /* CONFIG_NET_L2_OFFLOAD_IP */
+
 #if defined(CONFIG_NET_TCP)
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
 		if (net_context_get_state(context) != NET_CONTEXT_CONNECTED) {
@@ -1630,55 +2186,21 @@ static int sendto(struct net_buf *buf,
 		return -EDESTADDRREQ;
 	}
 
-#if defined(CONFIG_NET_L2_OFFLOAD_IP)
-	if (net_if_is_ip_offloaded(net_nbuf_iface(buf))) {
-		return net_l2_offload_ip_sendto(
-			net_nbuf_iface(buf),
-			buf, dst_addr, addrlen,
-			cb, timeout, token, user_data);
-	}
-#endif /* CONFIG_NET_L2_OFFLOAD_IP */
-
-#if defined(CONFIG_NET_IPV6)
-	if (net_nbuf_family(buf) == AF_INET6) {
-		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
-
-		if (addrlen < sizeof(struct sockaddr_in6)) {
-			return -EINVAL;
-		}
-
-		if (net_is_ipv6_addr_unspecified(&addr6->sin6_addr)) {
-			return -EDESTADDRREQ;
-		}
-	} else
-#endif /* CONFIG_NET_IPV6 */
-
-#if defined(CONFIG_NET_IPV4)
-	if (net_nbuf_family(buf) == AF_INET) {
-		struct sockaddr_in *addr4 = (struct sockaddr_in *)dst_addr;
-
-		if (addrlen < sizeof(struct sockaddr_in)) {
-			return -EINVAL;
-		}
-
-		if (!addr4->sin_addr.s_addr[0]) {
-			return -EDESTADDRREQ;
-		}
-	} else
-#endif /* CONFIG_NET_IPV4 */
-	{
-		NET_DBG("Invalid protocol family %d", net_nbuf_family(buf));
-		return -EINVAL;
+	ret = check_dst_addr(buf, dst_addr, addrlen);
+	if (ret < 0) {
+		return ret;
 	}
 
 #if defined(CONFIG_NET_UDP)
 	if (net_context_get_ip_proto(context) == IPPROTO_UDP) {
-		ret = create_udp_packet(context, buf, dst_addr, &buf);
+		ret = create_udp_packet(context, buf, dst_addr, NULL, &buf);
 	} else
 #endif /* CONFIG_NET_UDP */
 
 #if defined(CONFIG_NET_TCP)
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		/* The buffer is gone if coalesced with an earlier write */
+		net_nbuf_set_token(buf, token);
 		ret = net_tcp_queue_data(context, buf);
 	} else
 #endif /* CONFIG_NET_TCP */
@@ -1696,6 +2218,97 @@ static int sendto(struct net_buf *buf,
 	return send_data(context, buf, cb, timeout, token, user_data);
 }
 
+#if defined(CONFIG_NET_CONTEXT_HDR_CACHE)
+static void hdr_cache_store(struct net_context *context, struct net_buf *buf,
+			    uint32_t gen)
+{
+	uint8_t len = net_nbuf_ip_hdr_len(buf) + sizeof(struct net_udp_hdr);
+
+	/* Only the plain headers built by create_udp_packet() are kept */
+	if (net_nbuf_ext_len(buf) || buf->frags->len < len ||
+	    len > sizeof(context->hdr_cache.data)) {
+		return;
+	}
+
+	memcpy(context->hdr_cache.data, buf->frags->data, len);
+
+	context->hdr_cache.ip_hdr_len = net_nbuf_ip_hdr_len(buf);
+	context->hdr_cache.gen = gen;
+	context->hdr_cache.len = len;
+}
+
+static struct net_buf *create_udp_packet_cached(struct net_context *context,
+						struct net_buf *buf)
+{
+	struct net_buf *header;
+
+	header = net_nbuf_get_reserve_data(net_nbuf_ll_reserve(buf),
+					   K_FOREVER);
+
+	net_buf_frag_insert(buf, header);
+
+	memcpy(net_buf_add(header, context->hdr_cache.len),
+	       context->hdr_cache.data, context->hdr_cache.len);
+
+	net_nbuf_set_family(buf, net_context_get_family(context));
+	net_nbuf_set_ip_hdr_len(buf, context->hdr_cache.ip_hdr_len);
+
+	NET_UDP_BUF(buf)->len = htons(net_buf_frags_len(buf) -
+				      net_nbuf_ip_hdr_len(buf));
+
+	net_nbuf_set_appdata(buf, net_nbuf_udp_data(buf) +
+			     sizeof(struct net_udp_hdr));
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6) {
+		return net_ipv6_finalize(context, buf);
+	}
+#endif /* CONFIG_NET_IPV6 */
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET) {
+		return net_ipv4_finalize(context, buf);
+	}
+#endif /* CONFIG_NET_IPV4 */
+
+	return buf;
+}
+
+/* The headers of the first packet sent to the connected peer are kept,
+ * and copied in the next ones, until an address or route change.
+ */
+static int send_connected_udp(struct net_buf *buf,
+			      socklen_t addrlen,
+			      net_context_send_cb_t cb,
+			      int32_t timeout,
+			      void *token,
+			      void *user_data)
+{
+	struct net_context *context = net_nbuf_context(buf);
+	uint32_t gen = hdr_cache_gen;
+	int ret;
+
+	if (context->hdr_cache.len && context->hdr_cache.gen == gen) {
+		buf = create_udp_packet_cached(context, buf);
+	} else {
+		ret = check_dst_addr(buf, &context->remote, addrlen);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = create_udp_packet(context, buf, &context->remote, NULL,
+					&buf);
+		if (ret < 0) {
+			return ret;
+		}
+
+		hdr_cache_store(context, buf, gen);
+	}
+
+	return send_data(context, buf, cb, timeout, token, user_data);
+}
+#endif /* CONFIG_NET_CONTEXT_HDR_CACHE */
+
 int net_context_send(struct net_buf *buf,
 		     net_context_send_cb_t cb,
 		     int32_t timeout,
@@ -1736,6 +2349,13 @@ int net_context_send(struct net_buf *buf,
 		addrlen = 0;
 	}
 
+#if defined(CONFIG_NET_CONTEXT_HDR_CACHE)
+	if (net_context_get_ip_proto(context) == IPPROTO_UDP) {
+		return send_connected_udp(buf, addrlen, cb, timeout, token,
+					  user_data);
+	}
+#endif /* CONFIG_NET_CONTEXT_HDR_CACHE */
+
 	return sendto(buf, &context->remote, addrlen, cb, timeout, token,
 		      user_data);
 }
@@ -1762,6 +2382,127 @@ int net_context_sendto(struct net_buf *buf,
 	return sendto(buf, dst_addr, addrlen, cb, timeout, token, user_data);
 }
 
+#if defined(CONFIG_NET_UDP)
+#if defined(CONFIG_NET_IPV6)
+/* The source address of the datagrams of a batch, selected once */
+static const struct in6_addr *batch_src_addr(struct net_context *context,
+					     struct net_buf *buf,
+					     const struct sockaddr *dst_addr)
+{
+	const struct in6_addr *src;
+
+	if (net_nbuf_family(buf) != AF_INET6) {
+		return NULL;
+	}
+
+	src = net_sin6_ptr(&context->local)->sin6_addr;
+	if (net_is_ipv6_addr_unspecified(src) || net_is_ipv6_addr_mcast(src)) {
+		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
+
+		src = net_if_ipv6_select_src_addr(net_nbuf_iface(buf),
+						  &addr6->sin6_addr);
+	}
+
+	return src;
+}
+#else
+#define batch_src_addr(context, buf, dst_addr) NULL
+#endif /* CONFIG_NET_IPV6 */
+
+int net_context_sendto_batch(struct net_buf **bufs,
+			     int count,
+			     const struct sockaddr *dst_addr,
+			     socklen_t addrlen,
+			     net_context_send_cb_t cb,
+			     int32_t timeout,
+			     void *user_data)
+{
+#if defined(CONFIG_NET_IPV6)
+	struct net_linkaddr ll_dst = { 0 };
+#endif
+	struct net_context *context;
+	const struct in6_addr *src;
+	struct net_if *iface;
+	int i, ret;
+
+	if (count <= 0 || !dst_addr) {
+		return -EINVAL;
+	}
+
+	context = net_nbuf_context(bufs[0]);
+
+	NET_ASSERT(PART_OF_ARRAY(contexts, context));
+
+	if (!net_context_is_used(context)) {
+		return -ENOENT;
+	}
+
+	if (net_context_get_ip_proto(context) != IPPROTO_UDP) {
+		return -EPROTOTYPE;
+	}
+
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+	if (net_if_is_ip_offloaded(net_nbuf_iface(bufs[0]))) {
+		for (i = 0; i < count; i++) {
+			ret = sendto(bufs[i], dst_addr, addrlen, cb, timeout,
+				     net_nbuf_token(bufs[i]), user_data);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		return i ? i : ret;
+	}
+#endif /* CONFIG_NET_L2_OFFLOAD_IP */
+
+	ret = check_dst_addr(bufs[0], dst_addr, addrlen);
+	if (ret < 0) {
+		return ret;
+	}
+
+	src = batch_src_addr(context, bufs[0], dst_addr);
+	iface = net_nbuf_iface(bufs[0]);
+
+	for (i = 0; i < count; i++) {
+		struct net_buf *buf = bufs[i];
+		void *token = net_nbuf_token(buf);
+
+		ret = create_udp_packet(context, buf, dst_addr, src, &buf);
+		if (ret < 0) {
+			break;
+		}
+
+#if defined(CONFIG_NET_IPV6)
+		/* The next hop is resolved once, when preparing the first
+		 * datagram, the others go to the same link layer address.
+		 */
+		if (ll_dst.addr) {
+			net_nbuf_set_iface(buf, iface);
+			net_nbuf_ll_dst(buf)->addr = ll_dst.addr;
+			net_nbuf_ll_dst(buf)->len = ll_dst.len;
+		} else if (i == 0 && count > 1 &&
+			   net_nbuf_family(buf) == AF_INET6) {
+			buf = net_ipv6_prepare_for_send(buf);
+			if (!buf) {
+				/* Waiting for neighbor discovery, or dropped */
+				continue;
+			}
+
+			iface = net_nbuf_iface(buf);
+			ll_dst = *net_nbuf_ll_dst(buf);
+		}
+#endif /* CONFIG_NET_IPV6 */
+
+		ret = send_data(context, buf, cb, timeout, token, user_data);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	return i ? i : ret;
+}
+#endif /* CONFIG_NET_UDP */
+
 static void set_appdata_values(struct net_buf *buf,
 			       enum net_ip_protocol proto,
 			       size_t total_len)
@@ -1921,10 +2662,18 @@ int net_context_recv(struct net_context *context,
 
 #if defined(CONFIG_NET_L2_OFFLOAD_IP)
 	if (net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		return net_l2_offload_ip_recv(
-			net_context_get_iface(context),
-			context, cb, timeout, user_data);
-	}
+		int ret;
+
+		/* The driver hands the data with recv_data() below */
+		context->recv_cb = cb;
+		context->recv_user_data = user_data;
+
+		ret = net_l2_offload_ip_recv(net_context_get_iface(context),
+					     context, cb, timeout, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	} else
 #endif /* CONFIG_NET_L2_OFFLOAD_IP */
 
 #if defined(CONFIG_NET_UDP)
@@ -1938,6 +2687,8 @@ int net_context_recv(struct net_context *context,
 
 #if defined(CONFIG_NET_TCP)
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		uint16_t old_wnd;
+
 		NET_ASSERT(context->tcp);
 
 		if (context->tcp->flags & NET_TCP_IS_SHUTDOWN) {
@@ -1947,8 +2698,14 @@ int net_context_recv(struct net_context *context,
 			return -ENOTCONN;
 		}
 
+		old_wnd = net_tcp_get_recv_wnd(context->tcp);
+
 		context->recv_cb = cb;
 		context->tcp->recv_user_data = user_data;
+
+		/* Data received so far is queued */
+		tcp_deliver_queued(context);
+		send_wnd_update(context, old_wnd);
 	} else
 #endif /* CONFIG_NET_TCP */
 	{
@@ -1975,6 +2732,117 @@ int net_context_recv(struct net_context *context,
 	return 0;
 }
 
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+void net_l2_offload_ip_recv_data(struct net_context *context,
+				 struct net_buf *buf,
+				 int status)
+{
+	NET_ASSERT(PART_OF_ARRAY(contexts, context));
+
+	if (!context->recv_cb) {
+		net_nbuf_unref(buf);
+		return;
+	}
+
+	if (buf) {
+		net_nbuf_set_context(buf, context);
+		net_nbuf_set_iface(buf, net_context_get_iface(context));
+		net_nbuf_set_appdata(buf, buf->frags ? buf->frags->data : NULL);
+		net_nbuf_set_appdatalen(buf, net_buf_frags_len(buf->frags));
+	}
+
+	context->recv_cb(context, buf, status, context->recv_user_data);
+
+#if defined(CONFIG_NET_CONTEXT_SYNC_RECV)
+	k_sem_give(&context->recv_data_wait);
+#endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
+}
+#endif /* CONFIG_NET_L2_OFFLOAD_IP */
+
+int net_context_update_recv_wnd(struct net_context *context,
+				int32_t delta)
+{
+#if defined(CONFIG_NET_TCP)
+	uint16_t old_wnd;
+	int key;
+
+	NET_ASSERT(context);
+
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP ||
+	    !context->tcp) {
+		return -EPROTOTYPE;
+	}
+
+	key = irq_lock();
+
+	old_wnd = net_tcp_get_recv_wnd(context->tcp);
+	context->tcp->recv_wnd = min(context->tcp->recv_wnd + delta,
+				     NET_TCP_BUF_MAX_LEN);
+
+	irq_unlock(key);
+
+	send_wnd_update(context, old_wnd);
+
+	return 0;
+#else
+	ARG_UNUSED(context);
+	ARG_UNUSED(delta);
+
+	return -EPROTOTYPE;
+#endif /* CONFIG_NET_TCP */
+}
+
+int net_context_set_nodelay(struct net_context *context, bool nodelay)
+{
+#if defined(CONFIG_NET_TCP)
+	NET_ASSERT(context);
+
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP ||
+	    !context->tcp) {
+		return -EPROTOTYPE;
+	}
+
+	context->tcp->nodelay = nodelay;
+
+	/* Whatever was held back can go now */
+	if (nodelay) {
+		net_tcp_send_data(context);
+	}
+
+	return 0;
+#else
+	ARG_UNUSED(context);
+	ARG_UNUSED(nodelay);
+
+	return -EPROTOTYPE;
+#endif /* CONFIG_NET_TCP */
+}
+
+int net_context_set_priority(struct net_context *context, uint8_t priority)
+{
+	NET_ASSERT(context);
+
+	if (priority > 7) {
+		return -EINVAL;
+	}
+
+	context->priority = priority;
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+void net_context_setup_pools(struct net_context *context,
+			     struct net_buf_pool *tx_pool,
+			     struct net_buf_pool *data_pool)
+{
+	NET_ASSERT(context);
+
+	context->tx_pool = tx_pool;
+	context->data_pool = data_pool;
+}
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
 void net_context_foreach(net_context_cb_t cb, void *user_data)
 {
 	int i;
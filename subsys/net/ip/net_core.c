@@ -26,8 +26,11 @@
 #include <net/net_if.h>
 #include <net/net_mgmt.h>
 #include <net/arp.h>
+#include <net/ethernet.h>
 #include <net/nbuf.h>
 #include <net/net_core.h>
+#include <net/net_capture.h>
+#include <debug/tracing.h>
 
 #include "net_private.h"
 #include "net_shell.h"
@@ -54,11 +57,47 @@
 #define CONFIG_NET_RX_STACK_SIZE 1024
 #endif
 
-NET_STACK_DEFINE(RX, rx_stack, CONFIG_NET_RX_STACK_SIZE,
-		 CONFIG_NET_RX_STACK_SIZE + CONFIG_NET_RX_STACK_RPL);
+#if defined(CONFIG_NET_RX_QUEUES)
+#define NET_RX_QUEUES CONFIG_NET_RX_QUEUES
+#else
+#define NET_RX_QUEUES 1
+#endif
+
+#define RX_STACK_SIZE (CONFIG_NET_RX_STACK_SIZE + CONFIG_NET_RX_STACK_RPL)
+
+/* One stack for each RX queue, the first queue having the lowest priority.
+ */
+NET_STACK_DEFINE(RX, rx_stack, CONFIG_NET_RX_STACK_SIZE, RX_STACK_SIZE);
+#if NET_RX_QUEUES > 1
+NET_STACK_DEFINE(RX1, rx_stack_1, CONFIG_NET_RX_STACK_SIZE, RX_STACK_SIZE);
+#endif
+#if NET_RX_QUEUES > 2
+NET_STACK_DEFINE(RX2, rx_stack_2, CONFIG_NET_RX_STACK_SIZE, RX_STACK_SIZE);
+#endif
+#if NET_RX_QUEUES > 3
+NET_STACK_DEFINE(RX3, rx_stack_3, CONFIG_NET_RX_STACK_SIZE, RX_STACK_SIZE);
+#endif
 
-static struct k_fifo rx_queue;
-static k_tid_t rx_tid;
+struct net_rx_queue {
+	struct k_fifo fifo;
+	unsigned char *stack;
+};
+
+static struct net_rx_queue rx_queues[NET_RX_QUEUES] = {
+	{ .stack = rx_stack },
+#if NET_RX_QUEUES > 1
+	{ .stack = rx_stack_1 },
+#endif
+#if NET_RX_QUEUES > 2
+	{ .stack = rx_stack_2 },
+#endif
+#if NET_RX_QUEUES > 3
+	{ .stack = rx_stack_3 },
+#endif
+};
+
+/* Thread priority of the lowest priority queue */
+#define RX_PRIO_LOWEST K_PRIO_COOP(8 + NET_RX_QUEUES - 1)
 
 #if defined(CONFIG_NET_IPV6)
 static inline enum net_verdict process_icmpv6_pkt(struct net_buf *buf,
@@ -185,6 +224,25 @@ static inline struct net_buf *handle_ext_hdr_options(struct net_buf *buf,
 	return frag;
 }
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf);
+
+/* The fragment is consumed by the reassembly, the packet it completes goes
+ * through the IPv6 processing again.
+ */
+static enum net_verdict process_ipv6_fragment(struct net_buf *buf,
+					      uint16_t prev_hdr,
+					      uint16_t frag_hdr)
+{
+	buf = net_ipv6_reassemble(buf, prev_hdr, frag_hdr);
+	if (buf && process_ipv6_pkt(buf) == NET_DROP) {
+		net_nbuf_unref(buf);
+	}
+
+	return NET_OK;
+}
+#endif /* CONFIG_NET_IPV6_FRAGMENT */
+
 static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf)
 {
 	struct net_ipv6_hdr *hdr = NET_IPV6_BUF(buf);
@@ -193,7 +251,7 @@ static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf)
 	struct net_buf *frag;
 	uint8_t next, next_hdr, length;
 	uint8_t first_option;
-	uint16_t offset;
+	uint16_t offset, start, prev_hdr;
 
 	if (real_len != pkt_len) {
 		NET_DBG("IPv6 packet size %d buf len %d", pkt_len, real_len);
@@ -257,10 +315,12 @@ static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf)
 	next = hdr->nexthdr;
 	first_option = next;
 	offset = sizeof(struct net_ipv6_hdr);
+	prev_hdr = offsetof(struct net_ipv6_hdr, nexthdr);
 
 	while (frag) {
 		enum net_verdict verdict;
 
+		start = offset;
 		frag = net_nbuf_read_u8(frag, offset, &offset, &next_hdr);
 		frag = net_nbuf_read_u8(frag, offset, &offset, &length);
 		if (!frag) {
@@ -324,6 +384,11 @@ static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf)
 
 			break;
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+		case NET_IPV6_NEXTHDR_FRAG:
+			return process_ipv6_fragment(buf, prev_hdr, start);
+#endif
+
 		/* The next header after the extensions can be also
 		 * one of the main protocols.
 		 */
@@ -358,6 +423,7 @@ static inline enum net_verdict process_ipv6_pkt(struct net_buf *buf)
 		}
 
 		next = next_hdr;
+		prev_hdr = start;
 	}
 
 drop:
@@ -454,6 +520,27 @@ drop:
 }
 #endif /* CONFIG_NET_IPV4 */
 
+/* Merge the small fragments left by the link layer, reassembly in
+ * particular, before they are walked by the upper layers.
+ */
+static inline void coalesce_frags(struct net_buf *buf)
+{
+#if defined(CONFIG_NET_STATISTICS)
+	struct net_buf *frag;
+	int depth = 0;
+
+	for (frag = buf->frags; frag; frag = frag->frags) {
+		depth++;
+	}
+
+	net_stats_update_frags(depth,
+			       net_nbuf_coalesce(buf,
+					CONFIG_NET_NBUF_COALESCE_BUDGET));
+#else
+	net_nbuf_coalesce(buf, CONFIG_NET_NBUF_COALESCE_BUDGET);
+#endif /* CONFIG_NET_STATISTICS */
+}
+
 static inline enum net_verdict process_data(struct net_buf *buf,
 					    bool is_loopback)
 {
@@ -485,6 +572,10 @@ static inline enum net_verdict process_data(struct net_buf *buf,
 		}
 	}
 
+	net_capture_buf(net_nbuf_iface(buf), buf, NET_CAPTURE_RX);
+
+	coalesce_frags(buf);
+
 	/* IP version and header length. */
 	switch (NET_IPV6_BUF(buf)->vtc & 0xf0) {
 #if defined(CONFIG_NET_IPV6)
@@ -518,30 +609,38 @@ static void processing_data(struct net_buf *buf, bool is_loopback)
 	case NET_DROP:
 	default:
 		NET_DBG("Dropping buf %p", buf);
+
+		if (!is_loopback) {
+			net_stats_update_if_rx_drop(net_nbuf_iface(buf));
+		}
+
 		net_nbuf_unref(buf);
 		break;
 	}
 }
 
-static void net_rx_thread(void)
+static void net_rx_thread(struct net_rx_queue *queue)
 {
 	struct net_buf *buf;
 
-	NET_DBG("Starting RX thread (stack %zu bytes)", sizeof(rx_stack));
+	NET_DBG("Starting RX thread %d (stack %d bytes)",
+		(int)(queue - rx_queues), RX_STACK_SIZE);
 
 	/* Starting TX side. The ordering is important here and the TX
 	 * can only be started when RX side is ready to receive packets.
 	 */
-	net_if_init();
+	if (queue == &rx_queues[0]) {
+		net_if_init();
+	}
 
 	while (1) {
 #if defined(CONFIG_NET_STATISTICS) || defined(CONFIG_NET_DEBUG_CORE)
 		size_t pkt_len;
 #endif
 
-		buf = net_buf_get(&rx_queue, K_FOREVER);
+		buf = net_buf_get(&queue->fifo, K_FOREVER);
 
-		net_analyze_stack("RX thread", rx_stack, sizeof(rx_stack));
+		net_analyze_stack("RX thread", queue->stack, RX_STACK_SIZE);
 
 #if defined(CONFIG_NET_STATISTICS) || defined(CONFIG_NET_DEBUG_CORE)
 		pkt_len = net_buf_frags_len(buf);
@@ -561,12 +660,58 @@ static void net_rx_thread(void)
 
 static void init_rx_queue(void)
 {
-	k_fifo_init(&rx_queue);
+	int i;
+
+	for (i = 0; i < NET_RX_QUEUES; i++) {
+		k_fifo_init(&rx_queues[i].fifo);
+	}
+
+	for (i = 0; i < NET_RX_QUEUES; i++) {
+		k_thread_spawn(rx_queues[i].stack, RX_STACK_SIZE,
+			       (k_thread_entry_t)net_rx_thread,
+			       &rx_queues[i], NULL, NULL,
+			       RX_PRIO_LOWEST - i, 0, 0);
+	}
+}
+
+#if NET_RX_QUEUES > 1
+/* Priority of a received frame, from 0 (lowest) to 7: the VLAN priority,
+ * or the IP precedence, i.e. the class selector of the DSCP. As this is
+ * called before the L2 processing, only Ethernet headers are looked into.
+ */
+static uint8_t rx_priority(struct net_if *iface, struct net_buf *buf)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	uint8_t *hdr = buf->frags->data;
+
+	if (iface->l2 != &NET_L2_GET_NAME(ETHERNET) ||
+	    buf->frags->len < sizeof(struct net_eth_hdr) + 2) {
+		return 0;
+	}
+
+	switch (sys_get_be16(hdr + offsetof(struct net_eth_hdr, type))) {
+	case NET_ETH_PTYPE_VLAN:
+		return hdr[sizeof(struct net_eth_hdr)] >> 5;
+	case NET_ETH_PTYPE_IP:
+		/* Type of service */
+		return hdr[sizeof(struct net_eth_hdr) + 1] >> 5;
+	case NET_ETH_PTYPE_IPV6:
+		/* Traffic class, after the version */
+		return (hdr[sizeof(struct net_eth_hdr)] >> 1) & 0x07;
+	}
+#endif /* CONFIG_NET_L2_ETHERNET */
+
+	return 0;
+}
 
-	rx_tid = k_thread_spawn(rx_stack, sizeof(rx_stack),
-				(k_thread_entry_t)net_rx_thread,
-				NULL, NULL, NULL, K_PRIO_COOP(8), 0, 0);
+static inline struct net_rx_queue *rx_queue_get(struct net_if *iface,
+						 struct net_buf *buf)
+{
+	return &rx_queues[rx_priority(iface, buf) * NET_RX_QUEUES / 8];
 }
+#else
+#define rx_queue_get(...) (&rx_queues[0])
+#endif /* NET_RX_QUEUES > 1 */
 
 #if defined(CONFIG_NET_IP_ADDR_CHECK)
 /* Check if the IPv{4|6} addresses are proper. As this can be expensive,
@@ -649,10 +794,68 @@ static inline int check_ip_addr(struct net_buf *buf)
 #endif
 
 /* Called when data needs to be sent to network */
+#if defined(CONFIG_NET_UDP)
+bool net_udp_is_local(struct net_buf *buf)
+{
+	if (net_nbuf_ext_len(buf)) {
+		return false;
+	}
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6) {
+		return NET_IPV6_BUF(buf)->nexthdr == IPPROTO_UDP &&
+			net_is_my_ipv6_addr(&NET_IPV6_BUF(buf)->dst);
+	}
+#endif /* CONFIG_NET_IPV6 */
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET) {
+		return NET_IPV4_BUF(buf)->proto == IPPROTO_UDP &&
+			net_is_my_ipv4_addr(&NET_IPV4_BUF(buf)->dst);
+	}
+#endif /* CONFIG_NET_IPV4 */
+
+	return false;
+}
+
+/* The datagram is sent as far as the sender is concerned, and received
+ * as it is, its headers being already set.
+ */
+static void deliver_local_udp(struct net_buf *buf)
+{
+	struct net_context *context = net_nbuf_context(buf);
+
+	if (context && context->send_cb) {
+		context->send_cb(context, 0, net_nbuf_token(buf),
+				 context->user_data);
+	}
+
+	net_stats_update_udp_sent();
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6) {
+		net_stats_update_ipv6_recv();
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET) {
+		net_stats_update_ipv4_recv();
+	}
+#endif
+
+	if (net_conn_input(IPPROTO_UDP, buf) == NET_DROP) {
+		net_nbuf_unref(buf);
+	}
+}
+#endif /* CONFIG_NET_UDP */
+
 int net_send_data(struct net_buf *buf)
 {
 	int status;
 
+	sys_trace_net_send_data(buf);
+
 	if (!buf || !buf->frags) {
 		return -ENODATA;
 	}
@@ -683,6 +886,13 @@ int net_send_data(struct net_buf *buf)
 		return 0;
 	}
 
+#if defined(CONFIG_NET_UDP)
+	if (net_udp_is_local(buf)) {
+		deliver_local_udp(buf);
+		return 0;
+	}
+#endif
+
 	if (net_if_send_data(net_nbuf_iface(buf), buf) == NET_DROP) {
 		return -EIO;
 	}
@@ -693,16 +903,32 @@ int net_send_data(struct net_buf *buf)
 /* Called by driver when an IP packet has been received */
 int net_recv_data(struct net_if *iface, struct net_buf *buf)
 {
+	struct net_rx_queue *queue;
+
+	sys_trace_net_recv_data(iface, buf);
+
 	if (!buf->frags) {
 		return -ENODATA;
 	}
 
-	NET_DBG("fifo %p iface %p buf %p len %zu", &rx_queue, iface, buf,
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+	if (!net_nbuf_rx_quota_get(iface, buf)) {
+		NET_DBG("iface %p holds too many RX buffers", iface);
+		net_stats_update_if_rx_drop(iface);
+		return -ENOBUFS;
+	}
+#endif
+
+	net_stats_update_if_recv(iface, net_buf_frags_len(buf));
+
+	queue = rx_queue_get(iface, buf);
+
+	NET_DBG("fifo %p iface %p buf %p len %zu", &queue->fifo, iface, buf,
 		net_buf_frags_len(buf));
 
 	net_nbuf_set_iface(buf, iface);
 
-	net_buf_put(&rx_queue, buf);
+	net_buf_put(&queue->fifo, buf);
 
 	return 0;
 }
@@ -18,6 +18,7 @@
 #include <net/net_if.h>
 #include <net/arp.h>
 #include <net/net_mgmt.h>
+#include <net/net_capture.h>
 
 #include "net_private.h"
 #include "ipv6.h"
@@ -53,6 +54,15 @@ static sys_slist_t link_callbacks;
 #define debug_check_packet(...)
 #endif /* CONFIG_NET_DEBUG_IF */
 
+static void mcast_filter_update(struct net_if *iface)
+{
+	const struct net_if_api *api = iface->dev->driver_api;
+
+	if (api->mcast_filter) {
+		api->mcast_filter(iface);
+	}
+}
+
 static inline void net_context_send_cb(struct net_context *context,
 				       void *token, int status)
 {
@@ -67,65 +77,120 @@ static inline void net_context_send_cb(struct net_context *context,
 #endif
 }
 
-static void net_if_tx_thread(struct net_if *iface)
-{
-	const struct net_if_api *api = iface->dev->driver_api;
+#if defined(CONFIG_NET_IF_TX_BULK)
+#define NET_IF_TX_BULK CONFIG_NET_IF_TX_BULK
+#else
+#define NET_IF_TX_BULK 1
+#endif
 
-	NET_ASSERT(api && api->init && api->send);
+/* What is needed once a packet is sent, as it is gone by then */
+struct tx_info {
+	struct net_linkaddr *dst;
+	struct net_context *context;
+	void *token;
+	int status;
+#if defined(CONFIG_NET_STATISTICS)
+	size_t len;
+#endif
+};
 
-	NET_DBG("Starting TX thread (stack %zu bytes) for driver %p queue %p",
-		sizeof(iface->tx_stack), api, &iface->tx_queue);
+static void net_if_tx(struct net_if *iface, struct net_buf **bufs, int count)
+{
+	const struct net_if_api *api = iface->dev->driver_api;
+	struct tx_info info[NET_IF_TX_BULK];
+	int i, sent = 0;
 
-	api->init(iface);
-	/* Attempt to bring the interface up */
-	net_if_up(iface);
+	for (i = 0; i < count; i++) {
+		debug_check_packet(bufs[i]);
 
-	while (1) {
-		struct net_linkaddr *dst;
-		struct net_context *context;
-		void *context_token;
-		struct net_buf *buf;
-		int status;
+		info[i].dst = net_nbuf_ll_dst(bufs[i]);
+		info[i].context = net_nbuf_context(bufs[i]);
+		info[i].token = net_nbuf_token(bufs[i]);
 #if defined(CONFIG_NET_STATISTICS)
-		size_t pkt_len;
+		info[i].len = net_buf_frags_len(bufs[i]);
 #endif
-		/* Get next packet from application - wait if necessary */
-		buf = net_buf_get(&iface->tx_queue, K_FOREVER);
+	}
 
-		debug_check_packet(buf);
+	if (atomic_test_bit(iface->flags, NET_IF_UP)) {
+		if (count > 1 && api->send_bulk) {
+			sent = max(api->send_bulk(iface, bufs, count), 0);
+		}
 
-		dst = net_nbuf_ll_dst(buf);
-		context = net_nbuf_context(buf);
-		context_token = net_nbuf_token(buf);
+		for (i = 0; i < sent; i++) {
+			info[i].status = 0;
+		}
 
-		if (atomic_test_bit(iface->flags, NET_IF_UP)) {
-#if defined(CONFIG_NET_STATISTICS)
-			pkt_len = net_buf_frags_len(buf);
-#endif
-			status = api->send(iface, buf);
-		} else {
-			/* Drop packet if interface is not up */
-			NET_WARN("iface %p is down", iface);
-			status = -ENETDOWN;
+		for (i = sent; i < count; i++) {
+			info[i].status = api->send(iface, bufs[i]);
 		}
+	} else {
+		/* Drop packet if interface is not up */
+		NET_WARN("iface %p is down", iface);
 
-		if (status < 0) {
-			net_nbuf_unref(buf);
+		for (i = 0; i < count; i++) {
+			info[i].status = -ENETDOWN;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		if (info[i].status < 0) {
+			net_stats_update_if_tx_drop(iface);
+			net_nbuf_unref(bufs[i]);
 		} else {
-			net_stats_update_bytes_sent(pkt_len);
+			net_stats_update_bytes_sent(info[i].len);
+			net_stats_update_if_sent(iface, info[i].len);
 		}
 
-		if (context) {
+		if (info[i].context) {
 			NET_DBG("Calling context send cb %p token %p status %d",
-				context, context_token, status);
+				info[i].context, info[i].token,
+				info[i].status);
 
-			net_context_send_cb(context, context_token, status);
+			net_context_send_cb(info[i].context, info[i].token,
+					    info[i].status);
 		}
 
-		net_if_call_link_cb(iface, dst, status);
+		net_if_call_link_cb(iface, info[i].dst, info[i].status);
+	}
+}
+
+/* The thread of the lowest priority queue also sets the interface up,
+ * packets can only be queued after that.
+ */
+static void net_if_tx_thread(struct net_if *iface, void *queue_idx)
+{
+	const struct net_if_api *api = iface->dev->driver_api;
+	int idx = POINTER_TO_INT(queue_idx);
+	struct k_fifo *queue = &iface->tx_queue[idx];
+
+	NET_ASSERT(api && api->init && api->send);
+
+	NET_DBG("Starting TX thread (stack %zu bytes) for driver %p queue %p",
+		sizeof(iface->tx_stack[idx]), api, queue);
 
-		net_analyze_stack("TX thread", iface->tx_stack,
-				  sizeof(iface->tx_stack));
+	if (!idx) {
+		api->init(iface);
+		/* Attempt to bring the interface up */
+		net_if_up(iface);
+	}
+
+	while (1) {
+		struct net_buf *bufs[NET_IF_TX_BULK];
+		int count = 0;
+
+		/* Get next packet from application - wait if necessary */
+		bufs[count++] = net_buf_get(queue, K_FOREVER);
+
+		/* Along with the ones queued in the meantime */
+		while (count < NET_IF_TX_BULK &&
+		       (bufs[count] = net_buf_get(queue, K_NO_WAIT))) {
+			count++;
+		}
+
+		net_if_tx(iface, bufs, count);
+
+		net_analyze_stack("TX thread", iface->tx_stack[idx],
+				  sizeof(iface->tx_stack[idx]));
 		net_nbuf_print();
 
 		k_yield();
@@ -134,13 +199,26 @@ static void net_if_tx_thread(struct net_if *iface)
 
 static inline void init_tx_queue(struct net_if *iface)
 {
+	int i;
+
 	NET_DBG("On iface %p", iface);
 
-	k_fifo_init(&iface->tx_queue);
+	for (i = 0; i < NET_TX_QUEUES; i++) {
+		k_fifo_init(&iface->tx_queue[i]);
+	}
+
+	for (i = 0; i < NET_TX_QUEUES; i++) {
+		k_thread_spawn(iface->tx_stack[i], sizeof(iface->tx_stack[i]),
+			       (k_thread_entry_t)net_if_tx_thread,
+			       iface, INT_TO_POINTER(i), NULL,
+			       K_PRIO_COOP(7 - i), 0, 0);
+	}
+}
 
-	k_thread_spawn(iface->tx_stack, sizeof(iface->tx_stack),
-		       (k_thread_entry_t)net_if_tx_thread,
-		       iface, NULL, NULL, K_PRIO_COOP(7), 0, 0);
+void net_if_queue_tx(struct net_if *iface, struct net_buf *buf)
+{
+	net_buf_put(&iface->tx_queue[net_nbuf_priority(buf) *
+				     NET_TX_QUEUES / 8], buf);
 }
 
 enum net_verdict net_if_send_data(struct net_if *iface, struct net_buf *buf)
@@ -183,6 +261,16 @@ enum net_verdict net_if_send_data(struct net_if *iface, struct net_buf *buf)
 	}
 #endif
 
+	net_capture_buf(iface, buf, NET_CAPTURE_TX);
+
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+	if (net_nbuf_family(buf) == AF_INET6 && net_ipv6_must_fragment(buf)) {
+		status = net_ipv6_send_fragments(iface, buf);
+		verdict = status < 0 ? NET_DROP : NET_OK;
+		goto done;
+	}
+#endif
+
 	verdict = iface->l2->send(iface, buf);
 
 done:
@@ -203,6 +291,7 @@ done:
 	}
 
 	if (verdict == NET_DROP) {
+		net_stats_update_if_tx_drop(iface);
 		net_if_call_link_cb(iface, dst, status);
 	}
 
@@ -258,6 +347,7 @@ static void dad_timeout(struct k_work *work)
 		net_sprint_ipv6_addr(&ifaddr->address.in6_addr));
 
 	ifaddr->addr_state = NET_ADDR_PREFERRED;
+	net_context_hdr_cache_flush();
 
 	/* Because we do not know the interface at this point, we need to
 	 * lookup for it.
@@ -277,6 +367,14 @@ static void net_if_ipv6_start_dad(struct net_if *iface,
 	ifaddr->addr_state = NET_ADDR_TENTATIVE;
 	ifaddr->dad_count = 1;
 
+#if defined(CONFIG_NET_IPV6_OPTIMISTIC_DAD)
+	/* Not for manually configured addresses, RFC 4429 3.1 */
+	if (ifaddr->addr_type == NET_ADDR_AUTOCONF) {
+		ifaddr->addr_state = NET_ADDR_OPTIMISTIC;
+		net_context_hdr_cache_flush();
+	}
+#endif
+
 	NET_DBG("Interface %p ll addr %s tentative IPv6 addr %s", iface,
 		net_sprint_ll_addr(iface->link_addr.addr,
 				   iface->link_addr.len),
@@ -306,8 +404,9 @@ void net_if_start_dad(struct net_if *iface)
 #endif /* CONFIG_NET_IPV6_DAD */
 
 #if defined(CONFIG_NET_IPV6_ND)
-#define RS_TIMEOUT MSEC_PER_SEC
-#define RS_COUNT 3
+#define RS_TIMEOUT CONFIG_NET_IPV6_RS_TIMEOUT
+#define RS_MAX_TIMEOUT CONFIG_NET_IPV6_RS_MAX_TIMEOUT
+#define RS_COUNT CONFIG_NET_IPV6_RS_COUNT
 
 static void rs_timeout(struct k_work *work)
 {
@@ -323,13 +422,27 @@ static void rs_timeout(struct k_work *work)
 	}
 }
 
+/* Doubled on each retransmission, RFC 7559 */
+static int32_t rs_retry_timeout(struct net_if *iface)
+{
+	int32_t timeout = RS_TIMEOUT;
+	uint8_t count = iface->rs_count;
+
+	while (count-- && timeout < RS_MAX_TIMEOUT) {
+		timeout <<= 1;
+	}
+
+	return max(RS_TIMEOUT, min(timeout, RS_MAX_TIMEOUT));
+}
+
 void net_if_start_rs(struct net_if *iface)
 {
 	NET_DBG("Interface %p", iface);
 
 	if (!net_ipv6_start_rs(iface)) {
 		k_delayed_work_init(&iface->rs_timer, rs_timeout);
-		k_delayed_work_submit(&iface->rs_timer, RS_TIMEOUT);
+		k_delayed_work_submit(&iface->rs_timer,
+				      rs_retry_timeout(iface));
 	}
 }
 #endif /* CONFIG_NET_IPV6_ND */
@@ -374,6 +487,7 @@ static void ipv6_addr_expired(struct k_work *work)
 		net_sprint_ipv6_addr(&ifaddr->address.in6_addr));
 
 	ifaddr->addr_state = NET_ADDR_DEPRECATED;
+	net_context_hdr_cache_flush();
 }
 
 void net_if_ipv6_addr_update_lifetime(struct net_if_addr *ifaddr,
@@ -451,8 +565,12 @@ struct net_if_addr *net_if_ipv6_addr_add(struct net_if *iface,
 			net_sprint_ipv6_addr(addr),
 			net_addr_type2str(addr_type));
 
+		/* The solicited-node group of the address is received */
+		mcast_filter_update(iface);
+
 		net_if_ipv6_start_dad(iface, &iface->ipv6.unicast[i]);
 
+		net_context_hdr_cache_flush();
 		net_mgmt_event_notify(NET_EVENT_IPV6_ADDR_ADD, iface);
 
 		return &iface->ipv6.unicast[i];
@@ -483,6 +601,7 @@ bool net_if_ipv6_addr_rm(struct net_if *iface, struct in6_addr *addr)
 		k_delayed_work_cancel(&iface->ipv6.unicast[i].lifetime);
 
 		iface->ipv6.unicast[i].is_used = false;
+		mcast_filter_update(iface);
 
 		net_ipv6_addr_create_solicited_node(addr, &maddr);
 		net_if_ipv6_maddr_rm(iface, &maddr);
@@ -491,6 +610,7 @@ bool net_if_ipv6_addr_rm(struct net_if *iface, struct in6_addr *addr)
 			i, iface, net_sprint_ipv6_addr(addr),
 			net_addr_type2str(iface->ipv6.unicast[i].addr_type));
 
+		net_context_hdr_cache_flush();
 		net_mgmt_event_notify(NET_EVENT_IPV6_ADDR_DEL, iface);
 
 		return true;
@@ -499,6 +619,28 @@ bool net_if_ipv6_addr_rm(struct net_if *iface, struct in6_addr *addr)
 	return false;
 }
 
+static inline uint32_t mcast_hash_bit(const struct in6_addr *addr)
+{
+	/* The scope and the group ID bytes vary the most */
+	return BIT((addr->s6_addr[1] ^ addr->s6_addr[14] ^
+		    addr->s6_addr[15]) & 0x1f);
+}
+
+static void mcast_hash_update(struct net_if *iface)
+{
+	int i;
+
+	iface->ipv6.mcast_hash = 0;
+
+	for (i = 0; i < NET_IF_MAX_IPV6_MADDR; i++) {
+		if (!iface->ipv6.mcast[i].is_used) {
+			continue;
+		}
+
+		iface->ipv6.mcast_hash |=
+			mcast_hash_bit(&iface->ipv6.mcast[i].address.in6_addr);
+	}
+}
 struct net_if_mcast_addr *net_if_ipv6_maddr_add(struct net_if *iface,
 						const struct in6_addr *addr)
 {
@@ -519,6 +661,9 @@ struct net_if_mcast_addr *net_if_ipv6_maddr_add(struct net_if *iface,
 		iface->ipv6.mcast[i].address.family = AF_INET6;
 		memcpy(&iface->ipv6.mcast[i].address.in6_addr, addr, 16);
 
+		iface->ipv6.mcast_hash |= mcast_hash_bit(addr);
+		mcast_filter_update(iface);
+
 		NET_DBG("[%d] interface %p address %s added", i, iface,
 			net_sprint_ipv6_addr(addr));
 
@@ -547,6 +692,9 @@ bool net_if_ipv6_maddr_rm(struct net_if *iface, const struct in6_addr *addr)
 
 		iface->ipv6.mcast[i].is_used = false;
 
+		mcast_hash_update(iface);
+		mcast_filter_update(iface);
+
 		NET_DBG("[%d] interface %p address %s removed",
 			i, iface, net_sprint_ipv6_addr(addr));
 
@@ -561,6 +709,7 @@ bool net_if_ipv6_maddr_rm(struct net_if *iface, const struct in6_addr *addr)
 struct net_if_mcast_addr *net_if_ipv6_maddr_lookup(const struct in6_addr *maddr,
 						   struct net_if **ret)
 {
+	uint32_t bit = mcast_hash_bit(maddr);
 	struct net_if *iface;
 
 	for (iface = __net_if_start; iface != __net_if_end; iface++) {
@@ -570,15 +719,18 @@ struct net_if_mcast_addr *net_if_ipv6_maddr_lookup(const struct in6_addr *maddr,
 			continue;
 		}
 
+		if (!(iface->ipv6.mcast_hash & bit)) {
+			continue;
+		}
+
 		for (i = 0; i < NET_IF_MAX_IPV6_MADDR; i++) {
 			if (!iface->ipv6.mcast[i].is_used ||
 			    iface->ipv6.mcast[i].address.family != AF_INET6) {
 				continue;
 			}
 
-			if (net_is_ipv6_prefix(maddr->s6_addr,
-				iface->ipv6.mcast[i].address.in6_addr.s6_addr,
-					       128)) {
+			if (net_ipv6_addr_cmp(maddr,
+				&iface->ipv6.mcast[i].address.in6_addr)) {
 
 				if (ret) {
 					*ret = iface;
@@ -962,6 +1114,7 @@ static inline struct in6_addr *check_global_addr(struct net_if *iface)
 	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
 		if (!iface->ipv6.unicast[i].is_used ||
 		    (iface->ipv6.unicast[i].addr_state != NET_ADDR_TENTATIVE &&
+		     iface->ipv6.unicast[i].addr_state != NET_ADDR_OPTIMISTIC &&
 		     iface->ipv6.unicast[i].addr_state != NET_ADDR_PREFERRED) ||
 		    iface->ipv6.unicast[i].address.family != AF_INET6) {
 			continue;
@@ -1025,9 +1178,10 @@ static inline uint8_t get_length(struct in6_addr *src, struct in6_addr *dst)
 	return len;
 }
 
-static inline bool is_proper_ipv6_address(struct net_if_addr *addr)
+static inline bool is_proper_ipv6_address(struct net_if_addr *addr,
+					  enum net_addr_state state)
 {
-	if (addr->is_used && addr->addr_state == NET_ADDR_PREFERRED &&
+	if (addr->is_used && addr->addr_state == state &&
 	    addr->address.family == AF_INET6 &&
 	    !net_is_ipv6_ll_addr(&addr->address.in6_addr)) {
 		return true;
@@ -1038,13 +1192,14 @@ static inline bool is_proper_ipv6_address(struct net_if_addr *addr)
 
 static inline struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
 							  struct in6_addr *dst,
-							  uint8_t *best_so_far)
+							  uint8_t *best_so_far,
+						enum net_addr_state state)
 {
 	struct in6_addr *src = NULL;
 	uint8_t i, len;
 
 	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
-		if (!is_proper_ipv6_address(&iface->ipv6.unicast[i])) {
+		if (!is_proper_ipv6_address(&iface->ipv6.unicast[i], state)) {
 			continue;
 		}
 
@@ -1059,8 +1214,9 @@ static inline struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
 	return src;
 }
 
-const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
-						   struct in6_addr *dst)
+static struct in6_addr *select_src_addr(struct net_if *dst_iface,
+					struct in6_addr *dst,
+					enum net_addr_state state)
 {
 	struct in6_addr *src = NULL;
 	uint8_t best_match = 0;
@@ -1074,7 +1230,7 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 			struct in6_addr *addr;
 
 			addr = net_if_ipv6_get_best_match(iface, dst,
-							  &best_match);
+							  &best_match, state);
 			if (addr) {
 				src = addr;
 			}
@@ -1083,7 +1239,7 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		/* If caller has supplied interface, then use that */
 		if (dst_iface) {
 			src = net_if_ipv6_get_best_match(dst_iface, dst,
-							 &best_match);
+							 &best_match, state);
 		}
 
 	} else {
@@ -1092,7 +1248,7 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		     iface++) {
 			struct in6_addr *addr;
 
-			addr = net_if_ipv6_get_ll(iface, NET_ADDR_PREFERRED);
+			addr = net_if_ipv6_get_ll(iface, state);
 			if (addr) {
 				src = addr;
 				break;
@@ -1100,10 +1256,29 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		}
 
 		if (dst_iface) {
-			src = net_if_ipv6_get_ll(dst_iface, NET_ADDR_PREFERRED);
+			src = net_if_ipv6_get_ll(dst_iface, state);
 		}
 	}
 
+	return src;
+}
+
+const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
+						   struct in6_addr *dst)
+{
+	struct in6_addr *src;
+
+	src = select_src_addr(dst_iface, dst, NET_ADDR_PREFERRED);
+
+#if defined(CONFIG_NET_IPV6_OPTIMISTIC_DAD)
+	/* Optimistic addresses are only used when no preferred one fits,
+	 * RFC 4429 3.3
+	 */
+	if (!src) {
+		src = select_src_addr(dst_iface, dst, NET_ADDR_OPTIMISTIC);
+	}
+#endif
+
 	if (!src) {
 		return net_ipv6_unspecified_address();
 	}
@@ -1290,6 +1465,7 @@ struct net_if_addr *net_if_ipv4_addr_add(struct net_if *iface,
 			net_sprint_ipv4_addr(addr),
 			net_addr_type2str(addr_type));
 
+		net_context_hdr_cache_flush();
 		net_mgmt_event_notify(NET_EVENT_IPV4_ADDR_ADD, iface);
 
 		return &iface->ipv4.unicast[i];
@@ -1318,6 +1494,7 @@ bool net_if_ipv4_addr_rm(struct net_if *iface, struct in_addr *addr)
 		NET_DBG("[%d] interface %p address %s removed",
 			i, iface, net_sprint_ipv4_addr(addr));
 
+		net_context_hdr_cache_flush();
 		net_mgmt_event_notify(NET_EVENT_IPV4_ADDR_DEL, iface);
 
 		return true;
@@ -1401,6 +1578,13 @@ int net_if_up(struct net_if *iface)
 done:
 	atomic_set_bit(iface->flags, NET_IF_UP);
 
+	mcast_filter_update(iface);
+
+	/* The addresses of an offloaded IP stack are not ours to manage */
+	if (net_if_is_ip_offloaded(iface)) {
+		goto notify;
+	}
+
 #if defined(CONFIG_NET_IPV6_DAD)
 	NET_DBG("Starting DAD for iface %p", iface);
 	net_if_start_dad(iface);
@@ -1411,6 +1595,7 @@ done:
 	net_if_start_rs(iface);
 #endif
 
+notify:
 	net_mgmt_event_notify(NET_EVENT_IF_UP, iface);
 
 	return 0;
@@ -1448,6 +1633,10 @@ void net_if_init(void)
 	NET_DBG("");
 
 	for (iface = __net_if_start; iface != __net_if_end; iface++) {
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+		iface->offload_ip = !!iface->l2->offload_ip;
+#endif
+
 		init_tx_queue(iface);
 
 #if defined(CONFIG_NET_IPV4)
@@ -31,8 +31,54 @@ static sys_slist_t event_callbacks;
 static uint16_t in_event;
 static uint16_t out_event;
 
+static inline void mgmt_clean_event(struct mgmt_event_entry *mgmt_event)
+{
+	mgmt_event->event = 0;
+	mgmt_event->iface = NULL;
+}
+
+#if defined(CONFIG_NET_MGMT_EVENT_COALESCE)
+static inline bool mgmt_is_event_queued(uint32_t mgmt_event,
+					struct net_if *iface)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MGMT_EVENT_QUEUE_SIZE; i++) {
+		if (events[i].event == mgmt_event && events[i].iface == iface) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#else
+#define mgmt_is_event_queued(...) false
+#endif /* CONFIG_NET_MGMT_EVENT_COALESCE */
+
 static inline void mgmt_push_event(uint32_t mgmt_event, struct net_if *iface)
 {
+	unsigned int key;
+
+	key = irq_lock();
+
+	/* The same event not delivered yet tells nothing more */
+	if (mgmt_is_event_queued(mgmt_event, iface)) {
+		irq_unlock(key);
+
+		NET_DBG("Event 0x%08x coalesced", mgmt_event);
+		return;
+	}
+
+	/* The queue is full, the oldest event is dropped */
+	if (events[in_event].event) {
+		NET_DBG("Event 0x%08x dropped", events[in_event].event);
+
+		out_event = in_event + 1;
+		if (out_event == CONFIG_NET_MGMT_EVENT_QUEUE_SIZE) {
+			out_event = 0;
+		}
+	}
+
 	events[in_event].event = mgmt_event;
 	events[in_event].iface = iface;
 
@@ -42,41 +88,37 @@ static inline void mgmt_push_event(uint32_t mgmt_event, struct net_if *iface)
 		in_event = 0;
 	}
 
-	if (in_event == out_event) {
-		uint16_t o_idx = out_event + 1;
-
-		if (o_idx == CONFIG_NET_MGMT_EVENT_QUEUE_SIZE) {
-			o_idx = 0;
-		}
+	irq_unlock(key);
 
-		if (events[o_idx].event) {
-			out_event = o_idx;
-		}
-	}
+	k_sem_give(&network_event);
 }
 
-static inline struct mgmt_event_entry *mgmt_pop_event(void)
+/* The entry is copied out, and its slot freed for the next events while
+ * the callbacks run.
+ */
+static inline bool mgmt_pop_event(struct mgmt_event_entry *mgmt_event)
 {
-	uint16_t o_idx;
+	unsigned int key;
+
+	key = irq_lock();
 
 	if (!events[out_event].event) {
-		return NULL;
+		irq_unlock(key);
+		return false;
 	}
 
-	o_idx = out_event;
+	*mgmt_event = events[out_event];
+	mgmt_clean_event(&events[out_event]);
+
 	out_event++;
 
 	if (out_event == CONFIG_NET_MGMT_EVENT_QUEUE_SIZE) {
 		out_event = 0;
 	}
 
-	return &events[o_idx];
-}
+	irq_unlock(key);
 
-static inline void mgmt_clean_event(struct mgmt_event_entry *mgmt_event)
-{
-	mgmt_event->event = 0;
-	mgmt_event->iface = NULL;
+	return true;
 }
 
 static inline void mgmt_add_event_mask(uint32_t event_mask)
@@ -126,31 +168,18 @@ static inline void mgmt_run_callbacks(struct mgmt_event_entry *mgmt_event)
 
 static void mgmt_thread(void)
 {
-	struct mgmt_event_entry *mgmt_event;
+	struct mgmt_event_entry mgmt_event;
 
 	while (1) {
 		k_sem_take(&network_event, K_FOREVER);
 
 		NET_DBG("Handling events, forwarding it relevantly");
 
-		mgmt_event = mgmt_pop_event();
-		if (!mgmt_event) {
-			/* System is over-loaded?
-			 * At this point we have most probably notified
-			 * more events than we could handle
-			 */
-			NET_DBG("Some event got probably lost (%u)",
-				k_sem_count_get(&network_event));
-
-			k_sem_init(&network_event, 0, UINT_MAX);
-
-			continue;
+		/* All the events queued meanwhile are delivered at once */
+		while (mgmt_pop_event(&mgmt_event)) {
+			mgmt_run_callbacks(&mgmt_event);
 		}
 
-		mgmt_run_callbacks(mgmt_event);
-
-		mgmt_clean_event(mgmt_event);
-
 		k_yield();
 	}
 }
@@ -182,7 +211,6 @@ void net_mgmt_event_notify(uint32_t mgmt_event, struct net_if *iface)
 			NET_MGMT_GET_COMMAND(mgmt_event));
 
 		mgmt_push_event(mgmt_event, iface);
-		k_sem_give(&network_event);
 	}
 }
 
@@ -194,7 +222,7 @@ void net_mgmt_event_init(void)
 	in_event = 0;
 	out_event = 0;
 
-	k_sem_init(&network_event, 0, UINT_MAX);
+	k_sem_init(&network_event, 0, 1);
 
 	memset(events, 0,
 	       CONFIG_NET_MGMT_EVENT_QUEUE_SIZE *
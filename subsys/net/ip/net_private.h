@@ -20,6 +20,20 @@ extern void net_if_init(void);
 extern void net_context_init(void);
 extern void net_ipv6_init(void);
 
+#if defined(CONFIG_NET_CONTEXT_HDR_CACHE)
+/* Drop the cached headers of the contexts, after an address or a route
+ * change.
+ */
+extern void net_context_hdr_cache_flush(void);
+#else
+#define net_context_hdr_cache_flush()
+#endif
+
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+/* Count a received buffer in the quota of its interface, false if full */
+extern bool net_nbuf_rx_quota_get(struct net_if *iface, struct net_buf *buf);
+#endif
+
 extern char *net_byte_to_hex(uint8_t *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
@@ -29,6 +43,41 @@ extern uint16_t net_calc_chksum(struct net_buf *buf, uint8_t proto);
 extern uint16_t net_calc_chksum_ipv4(struct net_buf *buf);
 #endif /* CONFIG_NET_IPV4 */
 
+/**
+ * @brief Update a checksum for a change of some of the data it covers,
+ * without going through all of it again (RFC 1624).
+ *
+ * @param chksum Checksum field, as in the header
+ * @param old Data before the change, such as an address or a port
+ * @param new Data after the change
+ * @param len Length of the changed data, even
+ *
+ * @return New checksum field. Note that an UDP checksum of 0 has to be
+ * sent as 0xffff.
+ */
+extern uint16_t net_chksum_update(uint16_t chksum, const void *old,
+				  const void *new, size_t len);
+
+#if defined(CONFIG_NET_UDP)
+/* UDP datagrams to one of our own addresses are handed to the connection
+ * handlers by net_send_data(), without going through the link layer, and
+ * need no checksum.
+ */
+extern bool net_udp_is_local(struct net_buf *buf);
+#else
+#define net_udp_is_local(buf) false
+#endif /* CONFIG_NET_UDP */
+
+#if defined(CONFIG_NET_CAPTURE)
+/* Copy the start of a packet into the capture ring, if it is being
+ * captured. The packet is given from its IP header.
+ */
+extern void net_capture_buf(struct net_if *iface, struct net_buf *buf,
+			    uint8_t dir);
+#else
+#define net_capture_buf(...)
+#endif /* CONFIG_NET_CAPTURE */
+
 static inline uint16_t net_calc_chksum_icmpv6(struct net_buf *buf)
 {
 	return net_calc_chksum(buf, IPPROTO_ICMPV6);
@@ -15,6 +15,11 @@
 
 #include <net/net_if.h>
 #include <misc/printk.h>
+#include <stdlib.h>
+
+#if defined(CONFIG_NET_CAPTURE)
+#include <net/net_capture.h>
+#endif
 
 #include "route.h"
 #include "icmpv6.h"
@@ -71,6 +76,8 @@ static inline const char *addrstate2str(enum net_addr_state addr_state)
 		return "preferred";
 	case NET_ADDR_DEPRECATED:
 		return "deprecated";
+	case NET_ADDR_OPTIMISTIC:
+		return "optimistic";
 	}
 
 	return "<invalid state>";
@@ -82,6 +89,8 @@ static inline const char *dhcpv4state2str(enum net_dhcpv4_state state)
 	switch (state) {
 	case NET_DHCPV4_INIT:
 		return "init";
+	case NET_DHCPV4_INIT_REBOOT:
+		return "init-reboot";
 	case NET_DHCPV4_DISCOVER:
 		return "discover";
 	case NET_DHCPV4_REQUEST:
@@ -134,7 +143,9 @@ static void iface_cb(struct net_if *iface, void *user_data)
 	printk("Interface %p\n", iface);
 	printk("====================\n");
 
-	tx_stack(iface, iface->tx_stack, CONFIG_NET_TX_STACK_SIZE);
+	for (i = 0; i < NET_TX_QUEUES; i++) {
+		tx_stack(iface, iface->tx_stack[i], CONFIG_NET_TX_STACK_SIZE);
+	}
 
 	printk("Link addr : %s\n", net_sprint_ll_addr(iface->link_addr.addr,
 						      iface->link_addr.len));
@@ -414,6 +425,14 @@ static inline void net_shell_print_statistics(void)
 	       GET_STAT(udp.chkerr));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_TCP)
+	printk("TCP rexmit     %d\trto\t%d\tfast\t%d\tdupack\t%d\n",
+	       GET_STAT(tcp.rexmit),
+	       GET_STAT(tcp.rto),
+	       GET_STAT(tcp.fast_rexmit),
+	       GET_STAT(tcp.dup_ack));
+#endif
+
 #if defined(CONFIG_NET_RPL_STATS)
 	printk("RPL DIS recv   %d\tsent\t%d\tdrop\t%d\n",
 	       GET_STAT(rpl.dis.recv),
@@ -450,8 +469,31 @@ static inline void net_shell_print_statistics(void)
 
 	printk("Bytes received %u\n", GET_STAT(bytes.received));
 	printk("Bytes sent     %u\n", GET_STAT(bytes.sent));
+	printk("Frags 1        %d\t2\t%d\t3-4\t%d\t5-8\t%d\t9+\t%d\n",
+	       GET_STAT(frags.depth[0]), GET_STAT(frags.depth[1]),
+	       GET_STAT(frags.depth[2]), GET_STAT(frags.depth[3]),
+	       GET_STAT(frags.depth[4]));
+	printk("Frags max      %d\tcoalesced\t%d\n",
+	       GET_STAT(frags.max_depth), GET_STAT(frags.coalesced));
 	printk("Processing err %d\n", GET_STAT(processing_error));
 }
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+static void iface_stats_cb(struct net_if *iface, void *user_data)
+{
+	struct net_stats_if stats;
+
+	ARG_UNUSED(user_data);
+
+	net_stats_if_get(iface, &stats);
+
+	printk("Interface %p\n", iface);
+	printk("  recv %u (%u bytes)\tdrop\t%u\n",
+	       stats.rx_pkts, stats.rx_bytes, stats.rx_drop);
+	printk("  sent %u (%u bytes)\tdrop\t%u\n",
+	       stats.tx_pkts, stats.tx_bytes, stats.tx_drop);
+}
+#endif /* CONFIG_NET_STATISTICS_PER_INTERFACE */
 #endif /* CONFIG_NET_STATISTICS */
 
 static void context_cb(struct net_context *context, void *user_data)
@@ -529,6 +571,106 @@ static void tcp_cb(struct net_tcp *tcp, void *user_data)
 
 /* Put the actual shell commands after this */
 
+#if defined(CONFIG_NET_CAPTURE)
+static void capture_print(void)
+{
+	struct net_capture_filter filter;
+	uint32_t lost;
+
+	if (!net_capture_get(&filter, &lost)) {
+		printk("Not capturing, %u packets lost\n", lost);
+		return;
+	}
+
+	printk("Capturing%s%s%s%s", filter.dir == NET_CAPTURE_RX ? " rx" : "",
+	       filter.dir == NET_CAPTURE_TX ? " tx" : "",
+	       filter.family == AF_INET6 ? " ipv6" : "",
+	       filter.family == AF_INET ? " ipv4" : "");
+
+	if (filter.proto) {
+		printk(" proto %u", filter.proto);
+	}
+
+	if (filter.port) {
+		printk(" port %u", filter.port);
+	}
+
+	if (filter.iface) {
+		printk(" iface %u", net_if_get_by_iface(filter.iface));
+	}
+
+	printk(", %u packets lost\n", lost);
+}
+
+static bool capture_parse(struct net_capture_filter *filter,
+			  int argc, char *argv[])
+{
+	int i;
+
+	memset(filter, 0, sizeof(*filter));
+
+	for (i = 0; i < argc; i++) {
+		if (!strcmp(argv[i], "rx")) {
+			filter->dir = NET_CAPTURE_RX;
+		} else if (!strcmp(argv[i], "tx")) {
+			filter->dir = NET_CAPTURE_TX;
+		} else if (!strcmp(argv[i], "ipv6")) {
+			filter->family = AF_INET6;
+		} else if (!strcmp(argv[i], "ipv4")) {
+			filter->family = AF_INET;
+		} else if (!strcmp(argv[i], "udp")) {
+			filter->proto = IPPROTO_UDP;
+		} else if (!strcmp(argv[i], "tcp")) {
+			filter->proto = IPPROTO_TCP;
+		} else if (!strcmp(argv[i], "icmpv6")) {
+			filter->proto = IPPROTO_ICMPV6;
+		} else if (!strcmp(argv[i], "icmp")) {
+			filter->proto = IPPROTO_ICMP;
+		} else if (!strcmp(argv[i], "port") && i + 1 < argc) {
+			filter->port = atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "iface") && i + 1 < argc) {
+			filter->iface = net_if_get_by_index(atoi(argv[++i]));
+			if (!filter->iface) {
+				printk("Invalid interface index\n");
+				return false;
+			}
+		} else {
+			printk("Invalid capture filter %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif /* CONFIG_NET_CAPTURE */
+
+static int shell_cmd_capture(int argc, char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE)
+	struct net_capture_filter filter;
+	int arg = strcmp(argv[0], "capture") ? 2 : 1;
+
+	if (arg >= argc) {
+		capture_print();
+	} else if (!strcmp(argv[arg], "off")) {
+		net_capture_stop();
+	} else if (!strcmp(argv[arg], "on")) {
+		if (capture_parse(&filter, argc - arg - 1, &argv[arg + 1])) {
+			net_capture_start(&filter);
+		}
+	} else {
+		printk("Usage: net capture [on [<filter>] | off]\n");
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	printk("Packet capture not compiled in.\n");
+#endif
+
+	return 0;
+}
+
 static int shell_cmd_conn(int argc, char *argv[])
 {
 	int count = 0;
@@ -571,6 +713,38 @@ static int shell_cmd_iface(int argc, char *argv[])
 	return 0;
 }
 
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+static void iface_rx_quota_cb(struct net_if *iface, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	printk("\t[%p]\tRX %d of %d elements\n", iface,
+	       (int)atomic_get(&iface->rx_bufs),
+	       CONFIG_NET_NBUF_RX_IFACE_QUOTA);
+}
+#endif /* CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0 */
+
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+static void context_pool_cb(struct net_context *context, void *user_data)
+{
+	int count, avail;
+
+	ARG_UNUSED(user_data);
+
+	if (context->tx_pool) {
+		net_nbuf_get_pool_info(context->tx_pool, &count, &avail);
+		printk("\t[%p]\tTX\t%d elements, available %d\n",
+		       context, count, avail);
+	}
+
+	if (context->data_pool) {
+		net_nbuf_get_pool_info(context->data_pool, &count, &avail);
+		printk("\t[%p]\tDATA\t%d elements, available %d\n",
+		       context, count, avail);
+	}
+}
+#endif /* CONFIG_NET_CONTEXT_NBUF_POOL */
+
 static int shell_cmd_mem(int argc, char *argv[])
 {
 	size_t tx_size, rx_size, data_size;
@@ -606,6 +780,16 @@ static int shell_cmd_mem(int argc, char *argv[])
 	}
 	printk("\n");
 
+#if CONFIG_NET_NBUF_RX_IFACE_QUOTA > 0
+	printk("Interface RX buffer quotas:\n");
+	net_if_foreach(iface_rx_quota_cb, NULL);
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_NBUF_POOL)
+	printk("Context buffer pools:\n");
+	net_context_foreach(context_pool_cb, NULL);
+#endif
+
 	return 0;
 }
 
@@ -805,6 +989,9 @@ static int shell_cmd_stats(int argc, char *argv[])
 
 #if defined(CONFIG_NET_STATISTICS)
 	net_shell_print_statistics();
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	net_if_foreach(iface_stats_cb, NULL);
+#endif
 #else
 	printk("Network statistics not compiled in.\n");
 #endif
@@ -818,6 +1005,9 @@ static int shell_cmd_help(int argc, char *argv[])
 	ARG_UNUSED(argv);
 
 	/* Keep the commands in alphabetical order */
+	printk("net capture [on [<filter>] | off]\n\tStart or stop capturing "
+	       "packets, filtered by rx, tx, ipv6, ipv4, udp, tcp, icmpv6, "
+	       "icmp, port <port> and iface <index>\n");
 	printk("net conn\n\tPrint information about network connections\n");
 	printk("net iface\n\tPrint information about network interfaces\n");
 	printk("net mem\n\tPrint network buffer information\n");
@@ -831,6 +1021,7 @@ static int shell_cmd_help(int argc, char *argv[])
 
 static struct shell_cmd net_commands[] = {
 	/* Keep the commands in alphabetical order */
+	{ "capture", shell_cmd_capture, NULL },
 	{ "conn", shell_cmd_conn, NULL },
 	{ "help", shell_cmd_help, NULL },
 	{ "iface", shell_cmd_iface, NULL },
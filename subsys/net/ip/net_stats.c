@@ -80,6 +80,14 @@ void net_print_statistics(void)
 			 GET_STAT(udp.chkerr));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_TCP)
+		NET_INFO("TCP rexmit     %d\trto\t%d\tfast\t%d\tdupack\t%d",
+			 GET_STAT(tcp.rexmit),
+			 GET_STAT(tcp.rto),
+			 GET_STAT(tcp.fast_rexmit),
+			 GET_STAT(tcp.dup_ack));
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_RPL_STATS)
 		NET_INFO("RPL DIS recv   %d\tsent\t%d\tdrop\t%d",
 			 GET_STAT(rpl.dis.recv),
@@ -116,6 +124,12 @@ void net_print_statistics(void)
 
 		NET_INFO("Bytes received %u", GET_STAT(bytes.received));
 		NET_INFO("Bytes sent     %u", GET_STAT(bytes.sent));
+		NET_INFO("Frags 1        %d\t2\t%d\t3-4\t%d\t5-8\t%d\t9+\t%d",
+			 GET_STAT(frags.depth[0]), GET_STAT(frags.depth[1]),
+			 GET_STAT(frags.depth[2]), GET_STAT(frags.depth[3]),
+			 GET_STAT(frags.depth[4]));
+		NET_INFO("Frags max      %d\tcoalesced\t%d",
+			 GET_STAT(frags.max_depth), GET_STAT(frags.coalesced));
 		NET_INFO("Processing err %d", GET_STAT(processing_error));
 
 		new_print = curr + PRINT_STATISTICS_INTERVAL;
@@ -131,6 +145,18 @@ void net_print_statistics(void)
 
 #endif /* CONFIG_NET_STATISTICS_PERIODIC_OUTPUT */
 
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+void net_stats_if_get(struct net_if *iface, struct net_stats_if *stats)
+{
+	stats->rx_pkts = atomic_get(&iface->stats.rx_pkts);
+	stats->rx_bytes = atomic_get(&iface->stats.rx_bytes);
+	stats->rx_drop = atomic_get(&iface->stats.rx_drop);
+	stats->tx_pkts = atomic_get(&iface->stats.tx_pkts);
+	stats->tx_bytes = atomic_get(&iface->stats.tx_bytes);
+	stats->tx_drop = atomic_get(&iface->stats.tx_drop);
+}
+#endif /* CONFIG_NET_STATISTICS_PER_INTERFACE */
+
 #if defined(CONFIG_NET_STATISTICS_USER_API)
 
 static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
@@ -139,8 +165,6 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 	size_t len_chk = 0;
 	void *src = NULL;
 
-	ARG_UNUSED(iface);
-
 	switch (NET_MGMT_GET_COMMAND(mgmt_request)) {
 	case NET_REQUEST_STATS_CMD_GET_ALL:
 		len_chk = sizeof(struct net_stats);
@@ -199,6 +223,15 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_rpl);
 		src = &net_stats.rpl;
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	case NET_REQUEST_STATS_CMD_GET_IFACE:
+		if (!iface || len != sizeof(struct net_stats_if)) {
+			return -EINVAL;
+		}
+
+		net_stats_if_get(iface, data);
+		return 0;
 #endif
 	}
 
@@ -206,7 +239,7 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		return -EINVAL;
 	}
 
-	memcpy(src, data, len);
+	memcpy(data, src, len);
 
 	return 0;
 }
@@ -258,4 +291,9 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_RPL,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_IFACE,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
@@ -41,12 +41,32 @@ static inline void net_stats_update_bytes_sent(uint32_t bytes)
 {
 	net_stats.bytes.sent += bytes;
 }
+
+static inline void net_stats_update_frags(int depth, int coalesced)
+{
+	int bucket;
+
+	if (depth <= 2) {
+		bucket = depth - 1;
+	} else if (depth <= 4) {
+		bucket = 2;
+	} else if (depth <= 8) {
+		bucket = 3;
+	} else {
+		bucket = 4;
+	}
+
+	net_stats.frags.depth[bucket]++;
+	net_stats.frags.max_depth = max(net_stats.frags.max_depth, depth);
+	net_stats.frags.coalesced += coalesced;
+}
 #else
 #define net_stats_update_processing_error()
 #define net_stats_update_ip_errors_protoerr()
 #define net_stats_update_ip_errors_vhlerr()
 #define net_stats_update_bytes_recv(...)
 #define net_stats_update_bytes_sent(...)
+#define net_stats_update_frags(...)
 #endif /* CONFIG_NET_STATISTICS */
 
 #if defined(CONFIG_NET_STATISTICS_IPV6)
@@ -162,6 +182,34 @@ static inline void net_stats_update_udp_drop(void)
 #define net_stats_update_udp_drop()
 #endif /* CONFIG_NET_STATISTICS_UDP */
 
+#if defined(CONFIG_NET_STATISTICS_TCP)
+/* TCP stats */
+static inline void net_stats_update_tcp_rexmit(void)
+{
+	net_stats.tcp.rexmit++;
+}
+
+static inline void net_stats_update_tcp_rto(void)
+{
+	net_stats.tcp.rto++;
+}
+
+static inline void net_stats_update_tcp_fast_rexmit(void)
+{
+	net_stats.tcp.fast_rexmit++;
+}
+
+static inline void net_stats_update_tcp_dup_ack(void)
+{
+	net_stats.tcp.dup_ack++;
+}
+#else
+#define net_stats_update_tcp_rexmit()
+#define net_stats_update_tcp_rto()
+#define net_stats_update_tcp_fast_rexmit()
+#define net_stats_update_tcp_dup_ack()
+#endif /* CONFIG_NET_STATISTICS_TCP */
+
 #if defined(CONFIG_NET_STATISTICS_RPL)
 /* RPL stats */
 static inline void net_stats_update_rpl_resets(void)
@@ -262,6 +310,42 @@ static inline void net_stats_update_rpl_dao_ack_recv(void)
 #define net_stats_update_rpl_dao_ack_recv()
 #endif /* CONFIG_NET_STATISTICS_RPL */
 
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+/* Interface stats, updated from the RX thread and from the TX thread of
+ * each interface, with atomic operations instead of a lock.
+ */
+#include <net/net_if.h>
+
+static inline void net_stats_update_if_recv(struct net_if *iface,
+					    uint32_t bytes)
+{
+	atomic_inc(&iface->stats.rx_pkts);
+	atomic_add(&iface->stats.rx_bytes, bytes);
+}
+
+static inline void net_stats_update_if_sent(struct net_if *iface,
+					    uint32_t bytes)
+{
+	atomic_inc(&iface->stats.tx_pkts);
+	atomic_add(&iface->stats.tx_bytes, bytes);
+}
+
+static inline void net_stats_update_if_rx_drop(struct net_if *iface)
+{
+	atomic_inc(&iface->stats.rx_drop);
+}
+
+static inline void net_stats_update_if_tx_drop(struct net_if *iface)
+{
+	atomic_inc(&iface->stats.tx_drop);
+}
+#else
+#define net_stats_update_if_recv(...)
+#define net_stats_update_if_sent(...)
+#define net_stats_update_if_rx_drop(...)
+#define net_stats_update_if_tx_drop(...)
+#endif /* CONFIG_NET_STATISTICS_PER_INTERFACE */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT)
 /* A simple periodic statistic printer, used only in net core */
 void net_print_statistics(void);
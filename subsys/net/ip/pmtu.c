@@ -0,0 +1,123 @@
+/** @file
+ * @brief Path MTU cache
+ *
+ * The MTU learnt for a destination is kept for CONFIG_NET_PMTU_TIMEOUT
+ * minutes, per RFC 8201 and RFC 1191, after which the interface MTU is
+ * tried again. The least recently updated destination makes room for a
+ * new one.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(CONFIG_NET_DEBUG_PMTU)
+#define SYS_LOG_DOMAIN "net/pmtu"
+#define NET_LOG_ENABLED 1
+#endif
+
+#include <kernel.h>
+#include <string.h>
+
+#include <net/net_core.h>
+
+#include "net_private.h"
+#include "pmtu.h"
+
+#define PMTU_TIMEOUT K_MINUTES(CONFIG_NET_PMTU_TIMEOUT)
+
+struct net_pmtu_entry {
+	union {
+		struct in6_addr in6;
+		struct in_addr in;
+	} dst;
+
+	/** When the MTU was last lowered, in ms */
+	uint32_t updated;
+
+	/** Path MTU, 0 if the entry is unused */
+	uint16_t mtu;
+
+	sa_family_t family;
+};
+
+static struct net_pmtu_entry pmtu_cache[CONFIG_NET_PMTU_MAX_DESTINATIONS];
+
+static inline size_t addr_len(sa_family_t family)
+{
+	return family == AF_INET6 ? sizeof(struct in6_addr) :
+		sizeof(struct in_addr);
+}
+
+static struct net_pmtu_entry *pmtu_find(sa_family_t family, const void *dst)
+{
+	uint32_t now = k_uptime_get_32();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(pmtu_cache); i++) {
+		struct net_pmtu_entry *entry = &pmtu_cache[i];
+
+		if (!entry->mtu) {
+			continue;
+		}
+
+		if (now - entry->updated >= PMTU_TIMEOUT) {
+			NET_DBG("Path MTU %u of entry %d expired", entry->mtu,
+				i);
+			entry->mtu = 0;
+			continue;
+		}
+
+		if (entry->family == family &&
+		    !memcmp(&entry->dst, dst, addr_len(family))) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+uint16_t net_pmtu_get_mtu(struct net_if *iface, sa_family_t family,
+			  const void *dst)
+{
+	uint16_t mtu = net_pmtu_link_mtu(iface, family);
+	struct net_pmtu_entry *entry = pmtu_find(family, dst);
+
+	if (entry && entry->mtu < mtu) {
+		return entry->mtu;
+	}
+
+	return mtu;
+}
+
+void net_pmtu_update(sa_family_t family, const void *dst, uint16_t mtu)
+{
+	struct net_pmtu_entry *entry = pmtu_find(family, dst);
+	int i;
+
+	if (entry && entry->mtu <= mtu) {
+		return;
+	}
+
+	if (!entry) {
+		entry = &pmtu_cache[0];
+
+		for (i = 0; i < ARRAY_SIZE(pmtu_cache) && entry->mtu; i++) {
+			if (!pmtu_cache[i].mtu ||
+			    (int32_t)(pmtu_cache[i].updated -
+				      entry->updated) < 0) {
+				entry = &pmtu_cache[i];
+			}
+		}
+
+		entry->family = family;
+		memcpy(&entry->dst, dst, addr_len(family));
+	}
+
+	NET_DBG("Path MTU of entry %d now %u", (int)(entry - pmtu_cache), mtu);
+
+	entry->mtu = mtu;
+	entry->updated = k_uptime_get_32();
+}
@@ -0,0 +1,82 @@
+/** @file
+ * @brief Path MTU cache
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __PMTU_H
+#define __PMTU_H
+
+#include <stdint.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Links with a lower MTU carry IPv6 packets of this size by fragmenting
+ * them, as 6LoWPAN does.
+ */
+static inline uint16_t net_pmtu_link_mtu(struct net_if *iface,
+					 sa_family_t family)
+{
+	uint16_t mtu = net_if_get_mtu(iface);
+
+	if (family == AF_INET6 && mtu < NET_IPV6_MTU) {
+		return NET_IPV6_MTU;
+	}
+
+	return mtu;
+}
+
+#if defined(CONFIG_NET_PMTU)
+/**
+ * @brief Get the largest packet that can be sent to a destination.
+ *
+ * @param iface Network interface the packets are sent to.
+ * @param family Address family of the destination, AF_INET6 or AF_INET.
+ * @param dst Destination address, a struct in6_addr or a struct in_addr.
+ *
+ * @return The path MTU to the destination if one was learnt and is still
+ * valid, the MTU of the interface otherwise.
+ */
+uint16_t net_pmtu_get_mtu(struct net_if *iface, sa_family_t family,
+			  const void *dst);
+
+/**
+ * @brief Lower the path MTU to a destination.
+ *
+ * @details This is meant for the MTU reported by ICMPv6 Packet Too Big and
+ * ICMPv4 Fragmentation Needed messages. A higher MTU than the one known is
+ * ignored: the path MTU only increases again once it expires.
+ *
+ * @param family Address family of the destination, AF_INET6 or AF_INET.
+ * @param dst Destination address, a struct in6_addr or a struct in_addr.
+ * @param mtu New path MTU.
+ */
+void net_pmtu_update(sa_family_t family, const void *dst, uint16_t mtu);
+#else
+static inline uint16_t net_pmtu_get_mtu(struct net_if *iface,
+					sa_family_t family, const void *dst)
+{
+	ARG_UNUSED(dst);
+
+	return net_pmtu_link_mtu(iface, family);
+}
+
+#define net_pmtu_update(...)
+#endif /* CONFIG_NET_PMTU */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PMTU_H */
@@ -259,33 +259,234 @@ static inline void update_route_access(struct net_route_entry *route)
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+/*
+ * The routes are indexed by a path-compressed binary trie of their
+ * prefixes. Each node holds a prefix, the routes towards it, if any, and
+ * the two subtries of the longer prefixes, by the value of their next bit.
+ * Nodes without routes are only kept while they have two children, so
+ * there are at most two nodes per route.
+ */
+struct prefix_node {
+	struct in6_addr prefix;
+	struct prefix_node *parent;
+	struct prefix_node *child[2];
+	sys_slist_t routes;
+	uint8_t len;
+	bool in_use;
+};
+
+#define PREFIX_NODES (2 * CONFIG_NET_MAX_ROUTES)
+
+static struct prefix_node prefix_nodes[PREFIX_NODES];
+static struct prefix_node *prefix_root;
+
+static inline int prefix_bit(const struct in6_addr *addr, uint8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Number of leading bits in common, up to len, knowing the first start */
+static uint8_t prefix_common_len(const struct in6_addr *a,
+				 const struct in6_addr *b,
+				 uint8_t start, uint8_t len)
+{
+	uint8_t i;
+
+	for (i = start / 8; i * 8 < len; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			return min(len, i * 8 + __builtin_clz(diff) - 24);
+		}
+	}
+
+	return len;
+}
+
+static struct prefix_node *prefix_node_alloc(const struct in6_addr *prefix,
+					     uint8_t len)
 {
-	struct net_route_entry *route, *found = NULL;
-	uint8_t longest_match = 0;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	for (i = 0; i < PREFIX_NODES; i++) {
+		struct prefix_node *node = &prefix_nodes[i];
 
-		if (!nbr->ref) {
+		if (node->in_use) {
 			continue;
 		}
 
-		if (iface && nbr->iface != iface) {
-			continue;
+		memset(node, 0, sizeof(*node));
+		net_ipaddr_copy(&node->prefix, prefix);
+		node->len = len;
+		node->in_use = true;
+
+		return node;
+	}
+
+	/* Cannot happen, see above */
+	NET_ASSERT_INFO(0, "No free prefix node");
+
+	return NULL;
+}
+
+static void prefix_node_link(struct prefix_node *parent,
+			     struct prefix_node **link,
+			     struct prefix_node *node)
+{
+	*link = node;
+	if (node) {
+		node->parent = parent;
+	}
+}
+
+static struct prefix_node **prefix_node_link_get(struct prefix_node *node)
+{
+	struct prefix_node *parent = node->parent;
+
+	if (!parent) {
+		return &prefix_root;
+	}
+
+	return &parent->child[prefix_bit(&node->prefix, parent->len)];
+}
+
+static struct prefix_node *prefix_node_get(const struct in6_addr *prefix,
+					   uint8_t len)
+{
+	struct prefix_node **link = &prefix_root;
+	struct prefix_node *parent = NULL, *node, *branch, *new;
+	uint8_t common = 0;
+
+	while (*link) {
+		node = *link;
+		common = prefix_common_len(&node->prefix, prefix, common,
+					   min(node->len, len));
+
+		if (common < node->len) {
+			new = prefix_node_alloc(prefix, len);
+			if (common == len) {
+				/* The new prefix is a prefix of this node */
+				prefix_node_link(new,
+					&new->child[prefix_bit(&node->prefix,
+							       len)], node);
+				prefix_node_link(parent, link, new);
+				return new;
+			}
+
+			/* The prefixes diverge at bit common */
+			branch = prefix_node_alloc(prefix, common);
+			prefix_node_link(branch,
+				&branch->child[prefix_bit(&node->prefix,
+							  common)], node);
+			prefix_node_link(branch,
+				&branch->child[prefix_bit(prefix, common)],
+				new);
+			prefix_node_link(parent, link, branch);
+			return new;
 		}
 
-		route = net_route_data(nbr);
+		if (node->len == len) {
+			return node;
+		}
+
+		parent = node;
+		link = &node->child[prefix_bit(prefix, node->len)];
+	}
 
-		if (route->prefix_len >= longest_match &&
-		    net_is_ipv6_prefix((uint8_t *)dst,
-				       (uint8_t *)&route->addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
+	new = prefix_node_alloc(prefix, len);
+	prefix_node_link(parent, link, new);
+
+	return new;
+}
+
+static struct prefix_node *prefix_node_find(const struct in6_addr *prefix,
+					    uint8_t len)
+{
+	struct prefix_node *node = prefix_root;
+	uint8_t common = 0;
+
+	while (node && node->len <= len) {
+		common = prefix_common_len(&node->prefix, prefix, common,
+					   node->len);
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			return node;
+		}
+
+		node = node->child[prefix_bit(prefix, node->len)];
+	}
+
+	return NULL;
+}
+
+/* Remove the nodes left without routes nor two children */
+static void prefix_node_put(struct prefix_node *node)
+{
+	while (node && sys_slist_is_empty(&node->routes) &&
+	       !(node->child[0] && node->child[1])) {
+		struct prefix_node *parent = node->parent;
+
+		prefix_node_link(parent, prefix_node_link_get(node),
+				 node->child[0] ? node->child[0] :
+				 node->child[1]);
+		node->in_use = false;
+
+		node = parent;
+	}
+}
+
+static void prefix_add(struct net_route_entry *route)
+{
+	struct prefix_node *node;
+
+	node = prefix_node_get(&route->addr, route->prefix_len);
+	if (node) {
+		sys_slist_prepend(&node->routes, &route->prefix_node);
+	}
+}
+
+static void prefix_del(struct net_route_entry *route)
+{
+	struct prefix_node *node;
+
+	node = prefix_node_find(&route->addr, route->prefix_len);
+	if (node) {
+		sys_slist_find_and_remove(&node->routes, &route->prefix_node);
+		prefix_node_put(node);
+	}
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct prefix_node *node = prefix_root;
+	struct net_route_entry *route, *found = NULL;
+	uint8_t common = 0;
+
+	/* Go down the prefixes of dst, the last one with a route wins */
+	while (node) {
+		common = prefix_common_len(&node->prefix, dst, common,
+					   node->len);
+		if (common < node->len) {
+			break;
 		}
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route,
+					     prefix_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		node = node->child[prefix_bit(dst, node->len)];
 	}
 
 	if (found) {
@@ -398,6 +599,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route->iface = iface;
 
 	sys_slist_prepend(&routes, &route->node);
+	prefix_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -410,6 +612,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_info("Added", route, addr);
 
+	net_context_hdr_cache_flush();
+
 	/* TODO: Send notification that we added a route */
 
 	return route;
@@ -433,6 +637,10 @@ int net_route_del(struct net_route_entry *route)
 
 	net_route_info("Deleted", route, &route->addr);
 
+	net_context_hdr_cache_flush();
+
+	prefix_del(route);
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
 		if (!nexthop_route->nbr) {
 			continue;
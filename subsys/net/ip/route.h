@@ -50,6 +50,11 @@ struct net_route_entry {
 	 */
 	sys_snode_t node;
 
+	/** Node in the list of routes having the same prefix, in the
+	 * prefix trie used for the lookups.
+	 */
+	sys_snode_t prefix_node;
+
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
 
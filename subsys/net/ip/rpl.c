@@ -188,22 +188,48 @@ static inline uint32_t net_rpl_lifetime(struct net_rpl_instance *instance,
 	return (uint32_t)instance->lifetime_unit * (uint32_t)lifetime;
 }
 
+static void net_rpl_neighbor_data_remove(struct net_nbr *nbr);
+static void net_rpl_neighbor_table_clear(struct net_nbr_table *table);
+
+NET_NBR_POOL_INIT(net_rpl_neighbor_pool, CONFIG_NET_IPV6_MAX_NEIGHBORS,
+		  sizeof(struct net_rpl_parent),
+		  net_rpl_neighbor_data_remove, 0);
+
+NET_NBR_TABLE_INIT(NET_NBR_LOCAL, rpl_parents, net_rpl_neighbor_pool,
+		   net_rpl_neighbor_table_clear);
+
+#define PARENT_INDEX_SIZE NET_NBR_INDEX_SIZE(CONFIG_NET_IPV6_MAX_NEIGHBORS)
+
+/* The parents, by hash of their IPv6 address */
+static struct net_nbr_index_slot parent_index[PARENT_INDEX_SIZE];
+
+static inline uint32_t parent_hash(struct in6_addr *addr)
+{
+	return net_nbr_index_hash(addr, sizeof(*addr));
+}
+
+static inline uint8_t nbr_entry(struct net_nbr *nbr)
+{
+	return ((uint8_t *)nbr - (uint8_t *)net_rpl_neighbor_pool) /
+		sizeof(net_rpl_neighbor_pool[0]);
+}
+
 static void net_rpl_neighbor_data_remove(struct net_nbr *nbr)
 {
+	struct net_rpl_parent *parent = (struct net_rpl_parent *)nbr->data;
+
 	NET_DBG("Neighbor %p removed", nbr);
+
+	net_nbr_index_remove(parent_index, PARENT_INDEX_SIZE,
+			     parent_hash(&parent->addr), nbr_entry(nbr));
 }
 
 static void net_rpl_neighbor_table_clear(struct net_nbr_table *table)
 {
 	NET_DBG("Neighbor table %p cleared", table);
-}
 
-NET_NBR_POOL_INIT(net_rpl_neighbor_pool, CONFIG_NET_IPV6_MAX_NEIGHBORS,
-		  sizeof(struct net_rpl_parent),
-		  net_rpl_neighbor_data_remove, 0);
-
-NET_NBR_TABLE_INIT(NET_NBR_LOCAL, rpl_parents, net_rpl_neighbor_pool,
-		   net_rpl_neighbor_table_clear);
+	memset(parent_index, 0, sizeof(parent_index));
+}
 
 #if defined(CONFIG_NET_DEBUG_RPL)
 #define net_rpl_info(buf, req)						     \
@@ -258,30 +284,43 @@ static inline struct net_rpl_parent *nbr_data(struct net_nbr *nbr)
 
 struct net_nbr *net_rpl_get_nbr(struct net_rpl_parent *data)
 {
-	int i;
+	uint8_t *start = net_rpl_neighbor_pool[0].data;
+	struct net_nbr *nbr;
+	size_t offset;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	/* The parent data is stored in the pool, right after its nbr */
+	if ((uint8_t *)data < start) {
+		return NULL;
+	}
 
-		if (nbr->data == (uint8_t *)data) {
-			return nbr;
-		}
+	offset = (uint8_t *)data - start;
+	if (offset >= sizeof(net_rpl_neighbor_pool)) {
+		return NULL;
 	}
 
-	return NULL;
+	nbr = get_nbr(offset / sizeof(net_rpl_neighbor_pool[0]));
+	if (nbr->data != (uint8_t *)data) {
+		return NULL;
+	}
+
+	return nbr;
 }
 
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
+	uint32_t hash = parent_hash(addr);
+	int pos = -1, i;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+	ARG_UNUSED(table);
+
+	while ((i = net_nbr_index_find(parent_index, PARENT_INDEX_SIZE,
+				       hash, &pos)) >= 0) {
 		struct net_nbr *nbr = get_nbr(i);
 
 		if (nbr->ref && nbr->iface == iface &&
-		    net_ipv6_addr_cmp(&nbr_data(nbr)->dag->dag_id, addr)) {
+		    net_ipv6_addr_cmp(&nbr_data(nbr)->addr, addr)) {
 			return nbr;
 		}
 	}
@@ -318,6 +357,10 @@ static struct net_nbr *nbr_add(struct net_if *iface,
 		nbr->idx, nbr, net_sprint_ipv6_addr(addr),
 		net_sprint_ll_addr(lladdr->addr, lladdr->len));
 
+	net_ipaddr_copy(&nbr_data(nbr)->addr, addr);
+	net_nbr_index_add(parent_index, PARENT_INDEX_SIZE, parent_hash(addr),
+			  nbr_entry(nbr));
+
 	return nbr;
 }
 
@@ -2234,12 +2277,7 @@ static
 struct net_rpl_parent *find_parent_any_dag_any_instance(struct net_if *iface,
 							struct in6_addr *addr)
 {
-	struct net_nbr *nbr, *rpl_nbr;
-
-	nbr = net_ipv6_nbr_lookup(iface, addr);
-	if (!nbr) {
-		return NULL;
-	}
+	struct net_nbr *rpl_nbr;
 
 	rpl_nbr = nbr_lookup(&net_rpl_parents.table, iface, addr);
 	if (!rpl_nbr) {
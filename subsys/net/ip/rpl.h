@@ -240,6 +240,9 @@ struct net_rpl_parent {
 	/** Used DAG */
 	struct net_rpl_dag *dag;
 
+	/** IPv6 address the parent was added with */
+	struct in6_addr addr;
+
 	/** Used metric container */
 	struct net_rpl_metric_container mc;
 
@@ -30,9 +30,11 @@
 
 #include "connection.h"
 #include "net_private.h"
+#include "net_stats.h"
 
 #include "ipv6.h"
 #include "ipv4.h"
+#include "pmtu.h"
 #include "tcp.h"
 
 /*
@@ -42,7 +44,25 @@
 #define NET_MAX_TCP_CONTEXT CONFIG_NET_MAX_CONTEXTS
 static struct net_tcp tcp_context[NET_MAX_TCP_CONTEXT];
 
-#define INIT_RETRY_MS 200
+/* Retransmission timeout bounds (RFC 6298). The minimum is lowered from
+ * the 1 s of the RFC to the former fixed retry period, as most peers are
+ * on local links.
+ */
+#define INIT_RTO_MS 1000
+#define MIN_RTO_MS 200
+#define MAX_RTO_MS (60 * MSEC_PER_SEC)
+
+/* No window scaling is done */
+#define MAX_CWND 0xffff
+
+/* Segment size assumed when the MTU is not known */
+#define DEFAULT_MSS 536
+
+#if defined(CONFIG_NET_TCP_ACK_DELAY)
+#define ACK_DELAY_MS CONFIG_NET_TCP_ACK_DELAY
+#else
+#define ACK_DELAY_MS 0
+#endif
 
 /* 2MSL timeout, where "MSL" is arbitrarily 2 minutes in the RFC */
 #define TIME_WAIT_MS (2 * 2 * 60 * 1000)
@@ -105,24 +125,181 @@ static inline uint32_t init_isn(void)
 
 static inline uint32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((uint32_t)1 << tcp->retry_timeout_shift) * INIT_RETRY_MS;
+	/* The shift is capped well before the timeout could overflow */
+	return min(tcp->rto << min(tcp->retry_timeout_shift, 10), MAX_RTO_MS);
+}
+
+#if defined(CONFIG_NET_PMTU)
+/* Largest segment that fits in the path MTU to the peer */
+static uint32_t path_mss(const struct net_tcp *tcp)
+{
+	struct net_context *context = tcp->context;
+	struct net_if *iface = net_context_get_iface(context);
+
+	if (!iface) {
+		return DEFAULT_MSS;
+	}
+
+	if (net_context_get_family(context) == AF_INET6) {
+		return net_pmtu_get_mtu(iface, AF_INET6,
+					&net_sin6(&context->remote)->sin6_addr) -
+		       NET_IPV6TCPH_LEN;
+	}
+
+	return net_pmtu_get_mtu(iface, AF_INET,
+				&net_sin(&context->remote)->sin_addr) -
+	       NET_IPV4TCPH_LEN;
+}
+#endif /* CONFIG_NET_PMTU */
+
+/* No MSS option is parsed, so the peer is expected to take segments as
+ * large as the ones we accept, if they fit in the path MTU.
+ */
+static inline uint32_t send_mss(const struct net_tcp *tcp)
+{
+	uint16_t mss = net_tcp_get_recv_mss(tcp);
+
+#if defined(CONFIG_NET_PMTU)
+	return min(mss ? mss : DEFAULT_MSS, path_mss(tcp));
+#else
+	return mss ? mss : DEFAULT_MSS;
+#endif
+}
+
+static inline bool buf_sacked(struct net_buf *buf)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	return net_nbuf_sacked(buf);
+#else
+	return false;
+#endif
+}
+
+/* Data sent and not acknowledged, less what the peer has selectively
+ * acknowledged. The end of the data sent is stored in end.
+ */
+static uint32_t in_flight(struct net_tcp *tcp, uint32_t *end)
+{
+	struct net_buf *buf;
+	uint32_t flight = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, buf, sent_list) {
+		if (!net_nbuf_buf_sent(buf)) {
+			continue;
+		}
+
+		if (!buf_sacked(buf)) {
+			flight += net_nbuf_appdatalen(buf);
+		}
+
+		*end = sys_get_be32(NET_TCP_BUF(buf)->seq) +
+			net_nbuf_appdatalen(buf);
+	}
+
+	return flight;
+}
+
+/* Update the retransmission timeout with a round trip time measurement
+ * (RFC 6298), srtt and rttvar being scaled by 8 and 4.
+ */
+static void update_rto(struct net_tcp *tcp, uint32_t rtt)
+{
+	int32_t delta;
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		delta = (int32_t)rtt - (int32_t)(tcp->srtt >> 3);
+		tcp->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + max(tcp->rttvar, 1);
+	tcp->rto = min(max(tcp->rto, MIN_RTO_MS), MAX_RTO_MS);
+
+	NET_DBG("RTT %u ms, RTO %u ms", rtt, tcp->rto);
+}
+
+/* Send again the first segment the peer is missing */
+static void retransmit_first(struct net_tcp *tcp)
+{
+	struct net_buf *buf;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, buf, sent_list) {
+		if (!net_nbuf_buf_sent(buf)) {
+			return;
+		}
+
+		if (buf_sacked(buf)) {
+			continue;
+		}
+
+		/* Karn's rule: retransmissions cannot be timed */
+		tcp->rtt_timing = 0;
+
+		net_stats_update_tcp_rexmit();
+
+		if (net_tcp_send_buf(net_nbuf_ref(buf)) < 0) {
+			net_nbuf_unref(buf);
+		}
+
+		return;
+	}
 }
 
 static void tcp_retry_expired(struct k_timer *timer)
 {
 	struct net_tcp *tcp = CONTAINER_OF(timer, struct net_tcp, retry_timer);
+	uint32_t mss = send_mss(tcp);
+	uint32_t flight, end = tcp->recover;
 	struct net_buf *buf;
 
-	/* Double the retry period for exponential backoff and resent
-	 * the first (only the first!) unack'd packet.
-	 */
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
+		/* Double the retry period for exponential backoff */
 		tcp->retry_timeout_shift++;
 		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
 
-		buf = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_buf, sent_list);
-		net_tcp_send_buf(net_nbuf_ref(buf));
+		net_stats_update_tcp_rto();
+
+		flight = in_flight(tcp, &end);
+
+		/* The threshold is only lowered on the first timeout of a
+		 * loss, not as the same data times out again (RFC 5681).
+		 */
+		if (!(tcp->flags & NET_TCP_RETRYING)) {
+			tcp->ssthresh = max(flight / 2, 2 * mss);
+		}
+
+		if (!(tcp->flags & NET_TCP_RETRYING) ||
+		    net_tcp_seq_greater(end, tcp->recover)) {
+			tcp->recover = end;
+		}
+
+		/* Restart from one segment, everything in flight being
+		 * considered lost. The peer may have dropped what it
+		 * selectively acknowledged (RFC 2018), so all of it is sent
+		 * again as the ACKs come.
+		 */
+		tcp->cwnd = mss;
+		tcp->dup_acks = 0;
+		tcp->rtt_timing = 0;
+		tcp->flags &= ~NET_TCP_RECOVERY;
+		tcp->flags |= NET_TCP_RETRYING;
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, buf, sent_list) {
+			net_nbuf_set_buf_sent(buf, false);
+#if defined(CONFIG_NET_TCP_SACK)
+			net_nbuf_set_sacked(buf, false);
+#endif
+		}
+
+		net_tcp_send_data(tcp->context);
 	} else if (IS_ENABLED(CONFIG_NET_TCP_TIME_WAIT)) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			net_context_unref(tcp->context);
@@ -130,6 +307,31 @@ static void tcp_retry_expired(struct k_timer *timer)
 	}
 }
 
+static void send_pending_ack(struct net_tcp *tcp)
+{
+	struct net_buf *buf = NULL;
+
+	/* The ACK may have gone with data in the meantime */
+	if (!tcp->context || tcp->send_ack == tcp->sent_ack) {
+		return;
+	}
+
+	if (net_tcp_prepare_ack(tcp, &tcp->context->remote, &buf) || !buf) {
+		return;
+	}
+
+	if (net_tcp_send_buf(buf) < 0) {
+		net_nbuf_unref(buf);
+	}
+}
+
+static void delayed_ack_expired(struct k_work *work)
+{
+	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, delayed_ack);
+
+	send_pending_ack(tcp);
+}
+
 struct net_tcp *net_tcp_alloc(struct net_context *context)
 {
 	int i, key;
@@ -155,10 +357,14 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 
 	tcp_context[i].send_seq = init_isn();
 	tcp_context[i].recv_max_ack = tcp_context[i].send_seq + 1u;
+	tcp_context[i].recv_wnd = NET_TCP_BUF_MAX_LEN;
+	tcp_context[i].ssthresh = MAX_CWND;
+	tcp_context[i].rto = INIT_RTO_MS;
 
 	tcp_context[i].accept_cb = NULL;
 
 	k_timer_init(&tcp_context[i].retry_timer, tcp_retry_expired, NULL);
+	k_delayed_work_init(&tcp_context[i].delayed_ack, delayed_ack_expired);
 	k_sem_init(&tcp_context[i].connect_wait, 0, UINT_MAX);
 
 	return &tcp_context[i];
@@ -180,7 +386,20 @@ int net_tcp_release(struct net_tcp *tcp)
 		net_nbuf_unref(buf);
 	}
 
-	k_delayed_work_cancel(&tcp->ack_timer);
+	/* Received buffers are queued through the same list pointer */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->recv_queue, buf, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->recv_queue, NULL, &buf->sent_list);
+		net_nbuf_unref(buf);
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->ooo_queue, buf, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->ooo_queue, NULL, &buf->sent_list);
+		net_nbuf_unref(buf);
+	}
+
+	k_delayed_work_cancel(&tcp->delayed_ack);
 	k_timer_stop(&tcp->retry_timer);
 	k_sem_reset(&tcp->connect_wait);
 
@@ -196,8 +415,8 @@ int net_tcp_release(struct net_tcp *tcp)
 	return 0;
 }
 
-static inline int net_tcp_add_options(struct net_buf *header, size_t len,
-				      void *data)
+static inline uint8_t net_tcp_add_options(struct net_buf *header, size_t len,
+					  void *data)
 {
 	uint8_t optlen;
 
@@ -210,7 +429,11 @@ static inline int net_tcp_add_options(struct net_buf *header, size_t len,
 		optlen = len;
 	}
 
-	return 0;
+	/* Pad with end of option list */
+	memset(net_buf_add(header, optlen - len), NET_TCP_OPT_END,
+	       optlen - len);
+
+	return optlen;
 }
 
 static void finalize_segment(struct net_context *context, struct net_buf *buf)
@@ -287,7 +510,9 @@ static struct net_buf *prepare_segment(struct net_tcp *tcp,
 	tcphdr = (struct net_tcp_hdr *)net_buf_add(header, NET_TCPH_LEN);
 
 	if (segment->options && segment->optlen) {
-		net_tcp_add_options(header, segment->optlen, segment->options);
+		tcphdr->offset = (NET_TCPH_LEN +
+				  net_tcp_add_options(header, segment->optlen,
+						      segment->options)) << 2;
 	} else {
 		tcphdr->offset = NET_TCPH_LEN << 2;
 	}
@@ -312,28 +537,6 @@ static struct net_buf *prepare_segment(struct net_tcp *tcp,
 	return buf;
 }
 
-static inline uint32_t get_recv_wnd(struct net_tcp *tcp)
-{
-	ARG_UNUSED(tcp);
-
-	/* We don't queue received data inside the stack, we hand off
-	 * packets to synchronous callbacks (who can queue if they
-	 * want, but it's not our business).  So the available window
-	 * size is always the same.  There are two configurables to
-	 * check though.
-	 */
-	return min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
-}
-
-/* True if the (signed!) difference "seq1 - seq2" is positive and less
- * than 2^29.  That is, seq1 is "after" seq2.
- */
-static inline bool seq_greater(uint32_t seq1, uint32_t seq2)
-{
-	int d = (int)(seq1 - seq2);
-	return d > 0 && d < 0x20000000;
-}
-
 int net_tcp_prepare_segment(struct net_tcp *tcp, uint8_t flags,
 			    void *options, size_t optlen,
 			    const struct sockaddr_ptr *local,
@@ -343,6 +546,17 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, uint8_t flags,
 	uint32_t seq;
 	uint16_t wnd;
 	struct tcp_segment segment = { 0 };
+#if defined(CONFIG_NET_TCP_SACK)
+	static uint8_t sack_perm[] = { NET_TCP_OPT_NOP, NET_TCP_OPT_NOP,
+				       NET_TCP_OPT_SACK_PERM, 2 };
+
+	/* Offer SACK when connecting, and accept it if the peer did */
+	if ((flags & NET_TCP_SYN) && !optlen &&
+	    (!(flags & NET_TCP_ACK) || (tcp->flags & NET_TCP_SACK_OK))) {
+		options = sack_perm;
+		optlen = sizeof(sack_perm);
+	}
+#endif
 
 	if (!local) {
 		local = &tcp->context->local;
@@ -385,7 +599,7 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, uint8_t flags,
 		seq++;
 	}
 
-	wnd = get_recv_wnd(tcp);
+	wnd = net_tcp_get_recv_wnd(tcp);
 
 	segment.src_addr = (struct sockaddr_ptr *)local;
 	segment.dst_addr = remote;
@@ -400,7 +614,7 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, uint8_t flags,
 
 	tcp->send_seq = seq;
 
-	if (seq_greater(tcp->send_seq, tcp->recv_max_ack)) {
+	if (net_tcp_seq_greater(tcp->send_seq, tcp->recv_max_ack)) {
 		tcp->recv_max_ack = tcp->send_seq;
 	}
 
@@ -484,11 +698,58 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, uint8_t *options,
 	*optionlen += NET_TCP_MSS_SIZE;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* Tell the peer which data after a loss was received, from the out of
+ * order queue (RFC 2018).
+ */
+static uint8_t net_tcp_set_sack_opt(struct net_tcp *tcp, uint8_t *options)
+{
+	struct net_buf *buf;
+	uint32_t right = 0;
+	int blocks = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_queue, buf, sent_list) {
+		uint32_t seq = sys_get_be32(NET_TCP_BUF(buf)->seq);
+		uint32_t end = seq + net_nbuf_appdatalen(buf);
+
+		/* Contiguous segments make a single block */
+		if (blocks && !net_tcp_seq_greater(seq, right)) {
+			if (net_tcp_seq_greater(end, right)) {
+				right = end;
+				sys_put_be32(right, &options[8 * blocks]);
+			}
+
+			continue;
+		}
+
+		if (blocks == NET_TCP_SACK_MAX_BLOCKS) {
+			break;
+		}
+
+		right = end;
+		sys_put_be32(seq, &options[4 + 8 * blocks]);
+		sys_put_be32(end, &options[8 + 8 * blocks]);
+		blocks++;
+	}
+
+	if (!blocks) {
+		return 0;
+	}
+
+	options[0] = NET_TCP_OPT_NOP;
+	options[1] = NET_TCP_OPT_NOP;
+	options[2] = NET_TCP_OPT_SACK;
+	options[3] = 2 + 8 * blocks;
+
+	return 4 + 8 * blocks;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 			struct net_buf **buf)
 {
 	uint8_t options[NET_TCP_MAX_OPT_SIZE];
-	uint8_t optionlen;
+	uint8_t optionlen = 0;
 
 	switch (net_tcp_get_state(tcp)) {
 	case NET_TCP_SYN_RCVD:
@@ -515,8 +776,14 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		break;
 
 	default:
-		net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL, remote,
-					buf);
+#if defined(CONFIG_NET_TCP_SACK)
+		if (tcp->flags & NET_TCP_SACK_OK) {
+			optionlen = net_tcp_set_sack_opt(tcp, options);
+		}
+#endif
+
+		net_tcp_prepare_segment(tcp, NET_TCP_ACK, options, optionlen,
+					NULL, remote, buf);
 		break;
 	}
 
@@ -589,12 +856,55 @@ const char * const net_tcp_state_str(enum net_tcp_state state)
 	return "";
 }
 
+/* The last queued segment, if more data can still be appended to it:
+ * it was never sent.
+ */
+static struct net_buf *open_segment(struct net_tcp *tcp)
+{
+	sys_snode_t *tail = sys_slist_peek_tail(&tcp->sent_list);
+	struct net_buf *buf;
+	uint32_t end;
+
+	if (!tail) {
+		return NULL;
+	}
+
+	buf = CONTAINER_OF(tail, struct net_buf, sent_list);
+	end = sys_get_be32(NET_TCP_BUF(buf)->seq) + net_nbuf_appdatalen(buf);
+
+	if (net_nbuf_buf_sent(buf) ||
+	    ((tcp->flags & NET_TCP_RETRYING) &&
+	     !net_tcp_seq_greater(end, tcp->recover))) {
+		return NULL;
+	}
+
+	return buf;
+}
+
 int net_tcp_queue_data(struct net_context *context, struct net_buf *buf)
 {
 	struct net_conn *conn = (struct net_conn *)context->conn_handler;
 	size_t data_len = net_buf_frags_len(buf);
+	struct net_buf *tail;
 	int ret;
 
+	/* Coalesce small writes, up to a full segment */
+	tail = open_segment(context->tcp);
+	if (tail && net_nbuf_appdatalen(tail) + data_len <=
+	    send_mss(context->tcp)) {
+		net_buf_frag_add(tail, buf->frags);
+		buf->frags = NULL;
+		net_nbuf_unref(buf);
+
+		net_nbuf_set_appdatalen(tail, net_nbuf_appdatalen(tail) +
+					data_len);
+		context->tcp->send_seq += data_len;
+
+		finalize_segment(context, tail);
+
+		return 0;
+	}
+
 	/* Set PSH on all packets, our window is so small that there's
 	 * no point in the remote side trying to finesse things and
 	 * coalesce packets.
@@ -607,8 +917,11 @@ int net_tcp_queue_data(struct net_context *context, struct net_buf *buf)
 
 	context->tcp->send_seq += data_len;
 
+	/* The list takes over the caller's reference, each transmission
+	 * takes its own.
+	 */
+	net_nbuf_set_appdatalen(buf, data_len);
 	sys_slist_append(&context->tcp->sent_list, &buf->sent_list);
-	net_nbuf_ref(buf);
 
 	return 0;
 }
@@ -617,6 +930,12 @@ int net_tcp_send_buf(struct net_buf *buf)
 {
 	struct net_context *ctx = net_nbuf_context(buf);
 	struct net_tcp_hdr *tcphdr = NET_TCP_BUF(buf);
+	uint8_t old[6];
+
+	/* The ACK number, the data offset and the flags, which can change
+	 * after the checksum was computed.
+	 */
+	memcpy(old, tcphdr->ack, sizeof(old));
 
 	sys_put_be32(ctx->tcp->send_ack, tcphdr->ack);
 
@@ -629,6 +948,12 @@ int net_tcp_send_buf(struct net_buf *buf)
 		tcphdr->flags |= NET_TCP_ACK;
 	}
 
+	if (memcmp(old, tcphdr->ack, sizeof(old)) &&
+	    !net_if_tx_chksum_offloaded(net_nbuf_iface(buf))) {
+		tcphdr->chksum = net_chksum_update(tcphdr->chksum, old,
+						   tcphdr->ack, sizeof(old));
+	}
+
 	if (tcphdr->flags & NET_TCP_FIN) {
 		ctx->tcp->fin_sent = 1;
 	}
@@ -643,7 +968,6 @@ int net_tcp_send_buf(struct net_buf *buf)
 static void restart_timer(struct net_tcp *tcp)
 {
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
-		tcp->flags |= NET_TCP_RETRYING;
 		tcp->retry_timeout_shift = 0;
 		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
 	} else if (IS_ENABLED(CONFIG_NET_TCP_TIME_WAIT)) {
@@ -656,35 +980,282 @@ static void restart_timer(struct net_tcp *tcp)
 		}
 	} else {
 		k_timer_stop(&tcp->retry_timer);
-		tcp->flags &= ~NET_TCP_RETRYING;
 	}
 }
 
 int net_tcp_send_data(struct net_context *context)
 {
+	struct net_tcp *tcp = context->tcp;
+	uint32_t mss = send_mss(tcp);
+	uint32_t flight, wnd, end;
 	struct net_buf *buf;
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
-	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, buf, sent_list) {
-		if (!net_nbuf_buf_sent(buf)) {
-			net_tcp_send_buf(buf);
+	if (!tcp->cwnd) {
+		/* Initial window (RFC 3390) */
+		tcp->cwnd = min(4 * mss, max(2 * mss, 4380));
+	}
+
+	wnd = min(tcp->cwnd, tcp->send_wnd);
+	flight = in_flight(tcp, &end);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, buf, sent_list) {
+		uint16_t len = net_nbuf_appdatalen(buf);
+		uint32_t seq;
+
+		if (net_nbuf_buf_sent(buf)) {
+			continue;
+		}
+
+		/* Keep within the windows, but always have something in
+		 * flight: it is the peer's ACK that tells when its window
+		 * opens again.
+		 */
+		if (flight && flight + len > wnd) {
+			break;
+		}
+
+		/* Nagle's algorithm (RFC 896): while data is not
+		 * acknowledged, a small segment waits for more writes.
+		 */
+		if (flight && len < mss && !tcp->nodelay && !tcp->fin_queued &&
+		    buf == open_segment(tcp)) {
+			break;
+		}
+
+		seq = sys_get_be32(NET_TCP_BUF(buf)->seq);
+
+		if ((tcp->flags & NET_TCP_RETRYING) &&
+		    !net_tcp_seq_greater(seq + len, tcp->recover)) {
+			net_stats_update_tcp_rexmit();
+		} else if (!tcp->rtt_timing) {
+			tcp->rtt_timing = 1;
+			tcp->rtt_seq = seq + len;
+			tcp->rtt_start = k_uptime_get_32();
+		}
+
+		flight += len;
+
+		if (net_tcp_send_buf(net_nbuf_ref(buf)) < 0) {
+			net_nbuf_unref(buf);
 		}
 	}
 
+	if (flight && !k_timer_remaining_get(&tcp->retry_timer)) {
+		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
+	}
+
 	return 0;
 }
 
-void net_tcp_ack_received(struct net_context *ctx, uint32_t ack)
+void net_tcp_ack_data(struct net_tcp *tcp)
 {
-	struct net_tcp *tcp = ctx->tcp;
-	sys_slist_t *list = &ctx->tcp->sent_list;
-	sys_snode_t *head;
+	uint32_t pending = tcp->send_ack - tcp->sent_ack;
+
+	if (!pending) {
+		return;
+	}
+
+	/* Every second full segment is acknowledged at once, and so is
+	 * half the window, or the peer would stall on small windows.
+	 */
+	if (!ACK_DELAY_MS ||
+	    net_tcp_get_state(tcp) != NET_TCP_ESTABLISHED ||
+	    pending >= min(2 * send_mss(tcp), NET_TCP_BUF_MAX_LEN / 2)) {
+		k_delayed_work_cancel(&tcp->delayed_ack);
+		send_pending_ack(tcp);
+		return;
+	}
+
+	/* The first data waiting for the ACK sets the deadline */
+	if (!k_delayed_work_remaining_get(&tcp->delayed_ack)) {
+		k_delayed_work_submit(&tcp->delayed_ack, ACK_DELAY_MS);
+	}
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+/* Find an option in a received segment, its header being in the first
+ * fragment.
+ */
+static const uint8_t *find_option(struct net_buf *buf, uint8_t kind)
+{
+	struct net_tcp_hdr *tcphdr = NET_TCP_BUF(buf);
+	const uint8_t *opt = tcphdr->optdata;
+	const uint8_t *end = (uint8_t *)tcphdr + 4 * (tcphdr->offset >> 4);
+
+	if (end > buf->frags->data + buf->frags->len) {
+		return NULL;
+	}
+
+	while (opt < end && *opt != NET_TCP_OPT_END) {
+		if (*opt == NET_TCP_OPT_NOP) {
+			opt++;
+			continue;
+		}
+
+		if (end - opt < 2 || opt[1] < 2 || end - opt < opt[1]) {
+			return NULL;
+		}
+
+		if (*opt == kind) {
+			return opt;
+		}
+
+		opt += opt[1];
+	}
+
+	return NULL;
+}
+
+/* Mark the segments covered by the SACK blocks of a received ACK */
+static void mark_sacked(struct net_tcp *tcp, struct net_buf *ack_buf)
+{
+	const uint8_t *opt = find_option(ack_buf, NET_TCP_OPT_SACK);
 	struct net_buf *buf;
+	uint32_t left, right, seq;
+	int i;
+
+	if (!opt) {
+		return;
+	}
+
+	for (i = 2; i + 8 <= opt[1]; i += 8) {
+		left = sys_get_be32(&opt[i]);
+		right = sys_get_be32(&opt[i + 4]);
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, buf, sent_list) {
+			seq = sys_get_be32(NET_TCP_BUF(buf)->seq);
+
+			if (net_tcp_seq_greater(left, seq)) {
+				continue;
+			}
+
+			if (net_tcp_seq_greater(seq + net_nbuf_appdatalen(buf),
+						right)) {
+				break;
+			}
+
+			if (net_nbuf_buf_sent(buf)) {
+				net_nbuf_set_sacked(buf, true);
+			}
+		}
+	}
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+void net_tcp_syn_received(struct net_tcp *tcp, struct net_buf *buf)
+{
+	/* The window of a SYN is never scaled */
+	tcp->send_wnd = sys_get_be16(NET_TCP_BUF(buf)->wnd);
+
+#if defined(CONFIG_NET_TCP_SACK)
+	if (find_option(buf, NET_TCP_OPT_SACK_PERM)) {
+		tcp->flags |= NET_TCP_SACK_OK;
+	} else {
+		tcp->flags &= ~NET_TCP_SACK_OK;
+	}
+#endif
+}
+
+/* New data was acknowledged: grow the congestion window, or go on with
+ * fast recovery (RFC 5681 and RFC 6582).
+ */
+static void new_ack_received(struct net_tcp *tcp, uint32_t ack,
+			     uint32_t acked)
+{
+	uint32_t mss = send_mss(tcp);
+	uint32_t end;
+
+	tcp->dup_acks = 0;
+
+	if (tcp->rtt_timing && !net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		tcp->rtt_timing = 0;
+		update_rto(tcp, k_uptime_get_32() - tcp->rtt_start);
+	}
+
+	if (tcp->flags & NET_TCP_RECOVERY) {
+		if (net_tcp_seq_greater(tcp->recover, ack)) {
+			/* Partial ACK: the next hole is sent again at once,
+			 * and the window deflated by what left the network.
+			 */
+			retransmit_first(tcp);
+
+			tcp->cwnd = tcp->cwnd > acked ? tcp->cwnd - acked : 0;
+			if (acked >= mss) {
+				tcp->cwnd += mss;
+			}
+		} else {
+			tcp->flags &= ~NET_TCP_RECOVERY;
+			tcp->cwnd = min(tcp->ssthresh,
+					max(in_flight(tcp, &end), mss) + mss);
+		}
+	} else if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start */
+		tcp->cwnd += min(acked, mss);
+	} else {
+		/* Congestion avoidance, about a segment per round trip */
+		tcp->cwnd += max(mss * mss / tcp->cwnd, 1);
+	}
+
+	tcp->cwnd = min(tcp->cwnd, MAX_CWND);
+
+	if ((tcp->flags & NET_TCP_RETRYING) &&
+	    !net_tcp_seq_greater(tcp->recover, ack)) {
+		tcp->flags &= ~NET_TCP_RETRYING;
+	}
+
+	/* Restart the timer on a valid inbound ACK.  This
+	 * isn't quite the same behavior as per-packet retry
+	 * timers, but is close in practice (it starts retries
+	 * one timer period after the connection "got stuck")
+	 * and avoids the need to track per-packet timers or
+	 * sent times.
+	 */
+	restart_timer(tcp);
+}
+
+/* The same ACK came again: a segment was received after a lost one */
+static void dup_ack_received(struct net_tcp *tcp)
+{
+	uint32_t mss = send_mss(tcp);
+	uint32_t end = tcp->recover;
+
+	net_stats_update_tcp_dup_ack();
+
+	if (tcp->dup_acks < UINT8_MAX) {
+		tcp->dup_acks++;
+	}
+
+	if (tcp->flags & NET_TCP_RECOVERY) {
+		/* Each duplicate ACK means a segment left the network */
+		tcp->cwnd = min(tcp->cwnd + mss, MAX_CWND);
+		return;
+	}
+
+	/* Duplicates of what was retransmitted after a timeout do not
+	 * tell of a new loss.
+	 */
+	if (tcp->dup_acks != 3 || (tcp->flags & NET_TCP_RETRYING)) {
+		return;
+	}
+
+	tcp->ssthresh = max(in_flight(tcp, &end) / 2, 2 * mss);
+	tcp->recover = end;
+	tcp->cwnd = tcp->ssthresh + 3 * mss;
+	tcp->flags |= NET_TCP_RECOVERY;
+
+	net_stats_update_tcp_fast_rexmit();
+
+	retransmit_first(tcp);
+}
+
+/* Release the segments acknowledged, returns how much data they had */
+static uint32_t remove_acked(struct net_tcp *tcp, uint32_t ack)
+{
+	sys_slist_t *list = &tcp->sent_list;
 	struct net_tcp_hdr *tcphdr;
-	uint32_t seq;
-	bool valid_ack = false;
+	struct net_buf *buf;
+	sys_snode_t *head;
+	uint32_t seq, acked = 0;
 
 	while (!sys_slist_is_empty(list)) {
 		head = sys_slist_peek_head(list);
@@ -693,7 +1264,7 @@ void net_tcp_ack_received(struct net_context *ctx, uint32_t ack)
 
 		seq = sys_get_be32(tcphdr->seq) + net_nbuf_appdatalen(buf) - 1;
 
-		if (!seq_greater(ack, seq)) {
+		if (!net_tcp_seq_greater(ack, seq)) {
 			break;
 		}
 
@@ -707,36 +1278,74 @@ void net_tcp_ack_received(struct net_context *ctx, uint32_t ack)
 			}
 		}
 
+		acked += net_nbuf_appdatalen(buf);
+
 		sys_slist_remove(list, NULL, head);
 		net_nbuf_unref(buf);
-		valid_ack = true;
 	}
 
-	if (valid_ack) {
-		/* Restart the timer on a valid inbound ACK.  This
-		 * isn't quite the same behavior as per-packet retry
-		 * timers, but is close in practice (it starts retries
-		 * one timer period after the connection "got stuck")
-		 * and avoids the need to track per-packet timers or
-		 * sent times.
-		 */
-		restart_timer(ctx->tcp);
+	return acked;
+}
 
-		/* And, if we had been retrying, mark all packets
-		 * untransmitted and then resend them.  The stalled
-		 * pipe is uncorked again.
-		 */
-		if (ctx->tcp->flags & NET_TCP_RETRYING) {
-			struct net_buf *buf;
+bool net_tcp_fast_ack(struct net_context *ctx, struct net_buf *buf)
+{
+	struct net_tcp *tcp = ctx->tcp;
+	uint32_t ack = sys_get_be32(NET_TCP_BUF(buf)->ack);
+	uint32_t acked;
 
-			SYS_SLIST_FOR_EACH_CONTAINER(&ctx->tcp->sent_list, buf,
-						     sent_list) {
-				net_nbuf_set_buf_sent(buf, false);
-			}
+	acked = remove_acked(tcp, ack);
+	if (!acked) {
+		return false;
+	}
 
-			net_tcp_send_data(ctx);
-		}
+	new_ack_received(tcp, ack, acked);
+	net_tcp_send_data(ctx);
+
+	return true;
+}
+
+void net_tcp_ack_received(struct net_context *ctx, struct net_buf *ack_buf)
+{
+	struct net_tcp *tcp = ctx->tcp;
+	sys_slist_t *list = &ctx->tcp->sent_list;
+	uint32_t ack = sys_get_be32(NET_TCP_BUF(ack_buf)->ack);
+	uint16_t wnd = sys_get_be16(NET_TCP_BUF(ack_buf)->wnd);
+	sys_snode_t *head;
+	struct net_buf *buf;
+	uint32_t acked;
+	bool dup = false;
+
+	/* Only an ACK that carries nothing else and does not change the
+	 * window counts as a duplicate (RFC 5681).
+	 */
+	head = sys_slist_peek_head(list);
+	if (head) {
+		buf = CONTAINER_OF(head, struct net_buf, sent_list);
+
+		dup = net_nbuf_buf_sent(buf) &&
+			ack == sys_get_be32(NET_TCP_BUF(buf)->seq) &&
+			wnd == tcp->send_wnd &&
+			!net_tcp_data_len(ack_buf) &&
+			!(NET_TCP_FLAGS(ack_buf) & (NET_TCP_SYN | NET_TCP_FIN));
+	}
+
+	tcp->send_wnd = wnd;
+
+#if defined(CONFIG_NET_TCP_SACK)
+	if (tcp->flags & NET_TCP_SACK_OK) {
+		mark_sacked(tcp, ack_buf);
+	}
+#endif
+
+	acked = remove_acked(tcp, ack);
+	if (acked) {
+		new_ack_received(tcp, ack, acked);
+	} else if (dup) {
+		dup_ack_received(tcp);
 	}
+
+	/* Send what the windows now allow */
+	net_tcp_send_data(ctx);
 }
 
 void net_tcp_init(void)
@@ -749,7 +1358,8 @@ static void validate_state_transition(enum net_tcp_state current,
 {
 	static const uint16_t valid_transitions[] = {
 		[NET_TCP_CLOSED] = 1 << NET_TCP_LISTEN |
-			1 << NET_TCP_SYN_SENT,
+			1 << NET_TCP_SYN_SENT |
+			1 << NET_TCP_SYN_RCVD,
 		[NET_TCP_LISTEN] = 1 << NET_TCP_SYN_RCVD |
 			1 << NET_TCP_SYN_SENT,
 		[NET_TCP_SYN_RCVD] = 1 << NET_TCP_FIN_WAIT_1 |
@@ -44,6 +44,12 @@ extern "C" {
 /** MSS option has been set already */
 #define NET_TCP_RECV_MSS_SET BIT(5)
 
+/** The peer accepts selective acknowledgments */
+#define NET_TCP_SACK_OK BIT(6)
+
+/** In fast recovery, after a fast retransmit */
+#define NET_TCP_RECOVERY BIT(7)
+
 /*
  * TCP connection states
  */
@@ -72,13 +78,20 @@ enum net_tcp_state {
 
 #define NET_TCP_FLAGS(nbuf) (NET_TCP_BUF(nbuf)->flags & NET_TCP_CTL)
 
+/* SACK blocks sent in an ACK, there is no room for more */
+#define NET_TCP_SACK_MAX_BLOCKS 4
+
 /* TCP max window size */
 #define NET_TCP_MAX_WIN   (4 * 1024)
 
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
+#if defined(CONFIG_NET_TCP_SACK)
+#define NET_TCP_MAX_OPT_SIZE  (4 + 8 * NET_TCP_SACK_MAX_BLOCKS)
+#else
 #define NET_TCP_MAX_OPT_SIZE  8
+#endif
 
 #define NET_TCP_MSS_HEADER    0x02040000 /* MSS option */
 #define NET_TCP_WINDOW_HEADER 0x30300    /* Window scale option */
@@ -86,8 +99,26 @@ enum net_tcp_state {
 #define NET_TCP_MSS_SIZE      4          /* MSS option size */
 #define NET_TCP_WINDOW_SIZE   3          /* Window scale option size */
 
+/* TCP option kinds */
+#define NET_TCP_OPT_END       0
+#define NET_TCP_OPT_NOP       1
+#define NET_TCP_OPT_SACK_PERM 4
+#define NET_TCP_OPT_SACK      5
+
+
 /* Max received bytes to buffer internally */
+#if defined(CONFIG_NET_TCP_RECV_WND)
+#define NET_TCP_BUF_MAX_LEN CONFIG_NET_TCP_RECV_WND
+#else
 #define NET_TCP_BUF_MAX_LEN 1280
+#endif
+
+/* Max segments received out of order to queue, per connection */
+#if defined(CONFIG_NET_TCP_MAX_OUT_OF_ORDER)
+#define NET_TCP_MAX_OUT_OF_ORDER CONFIG_NET_TCP_MAX_OUT_OF_ORDER
+#else
+#define NET_TCP_MAX_OUT_OF_ORDER 0
+#endif
 
 /* Max segment lifetime, in seconds */
 #define NET_TCP_MAX_SEG_LIFETIME 60
@@ -101,15 +132,26 @@ struct net_tcp {
 	/** Cookie pointer passed to net_context_recv() */
 	void *recv_user_data;
 
-	/** ACK message timer */
-	struct k_delayed_work ack_timer;
-
 	/** Retransmit timer */
 	struct k_timer retry_timer;
 
+	/** Delayed ACK timer */
+	struct k_delayed_work delayed_ack;
+
 	/** List pointer used for TCP retransmit buffering */
 	sys_slist_t sent_list;
 
+	/** Received data not yet handed to the application */
+	sys_slist_t recv_queue;
+
+	/** Segments received out of order, sorted by sequence number */
+	sys_slist_t ooo_queue;
+
+	/** Free space in the receive buffer, can go below 0 when the
+	 * application holds more data than the window.
+	 */
+	int32_t recv_wnd;
+
 	/** Max acknowledgment. */
 	uint32_t recv_max_ack;
 
@@ -122,6 +164,33 @@ struct net_tcp {
 	/** Last ACK value sent */
 	uint32_t sent_ack;
 
+	/** Send window advertised by the peer */
+	uint32_t send_wnd;
+
+	/** Congestion window, in bytes */
+	uint32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	uint32_t ssthresh;
+
+	/** End of the data sent when the last loss was detected */
+	uint32_t recover;
+
+	/** Acknowledgment number ending the RTT measurement */
+	uint32_t rtt_seq;
+
+	/** Uptime when the RTT measurement started, in ms */
+	uint32_t rtt_start;
+
+	/** Smoothed round trip time, in 1/8 ms */
+	uint32_t srtt;
+
+	/** Round trip time variation, in 1/4 ms */
+	uint32_t rttvar;
+
+	/** Retransmission timeout, in ms */
+	uint32_t rto;
+
 	/** Current retransmit period */
 	uint32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -134,8 +203,24 @@ struct net_tcp {
 	uint32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	uint32_t fin_rcvd : 1;
+	/* The round trip time of a segment is being measured */
+	uint32_t rtt_timing : 1;
+	/* Small segments are sent at once, without Nagle's algorithm */
+	uint32_t nodelay : 1;
 	/** Remaining bits in this uint32_t */
-	uint32_t _padding : 12;
+	uint32_t _padding : 10;
+
+	/** Number of segments in ooo_queue */
+	uint8_t ooo_count;
+
+	/** Number of duplicate ACKs received in a row */
+	uint8_t dup_acks;
+
+	/** Max connections being established, when listening */
+	uint8_t backlog;
+
+	/** The receive queue is being handed to the application */
+	bool recv_draining;
 
 	/** Accept callback to be called when the connection has been
 	 * established.
@@ -155,6 +240,45 @@ static inline bool net_tcp_is_used(struct net_tcp *tcp)
 	return tcp->flags & NET_TCP_IN_USE;
 }
 
+/**
+ * @brief Get the receive window to advertise.
+ *
+ * @param tcp TCP context
+ *
+ * @return Free space in the receive buffer, in bytes
+ */
+static inline uint16_t net_tcp_get_recv_wnd(const struct net_tcp *tcp)
+{
+	if (tcp->recv_wnd < 0) {
+		return 0;
+	}
+
+	return min(tcp->recv_wnd, NET_TCP_MAX_WIN);
+}
+
+/* True if the (signed!) difference "seq1 - seq2" is positive and less
+ * than 2^29.  That is, seq1 is "after" seq2.
+ */
+static inline bool net_tcp_seq_greater(uint32_t seq1, uint32_t seq2)
+{
+	int d = (int)(seq1 - seq2);
+	return d > 0 && d < 0x20000000;
+}
+
+/**
+ * @brief Get the length of the data of a received TCP segment.
+ *
+ * @param buf Network buffer, with the TCP header in the first fragment
+ *
+ * @return Data length, without the headers
+ */
+static inline uint16_t net_tcp_data_len(struct net_buf *buf)
+{
+	/* "Offset": 4-bit field in high nibble, units of dwords */
+	return net_buf_frags_len(buf) - net_nbuf_ip_hdr_len(buf) -
+		net_nbuf_ext_len(buf) - 4 * (NET_TCP_BUF(buf)->offset >> 4);
+}
+
 /**
  * @brief Register a callback to be called when TCP packet
  * is received corresponding to received packet.
@@ -291,6 +415,9 @@ int net_tcp_send_data(struct net_context *context);
 /**
  * @brief Enqueue a single packet for transmission
  *
+ * The data is appended to the last queued segment if it has not been
+ * sent yet and there is room for it, in which case buf is released.
+ *
  * @param context TCP context
  * @param buf Packet
  *
@@ -309,10 +436,47 @@ int net_tcp_send_buf(struct net_buf *buf);
 /**
  * @brief Handle a received TCP ACK
  *
- * @param cts Context
- * @param seq Received ACK sequence number
+ * Acknowledged segments are released, the send window, congestion
+ * window and retransmission timeout are updated, and data is sent or
+ * retransmitted as the windows allow.
+ *
+ * @param ctx Context
+ * @param buf Received segment, with the ACK flag set
+ */
+void net_tcp_ack_received(struct net_context *ctx, struct net_buf *buf);
+
+/**
+ * @brief Handle the ACK of a predicted segment
+ *
+ * The fast path of net_tcp_ack_received(), for a segment that passed
+ * net_tcp_predicted(): it can be neither a duplicate ACK nor carry SACK
+ * blocks.
+ *
+ * @param ctx Context
+ * @param buf Received segment
+ *
+ * @return True if it acknowledged sent data, false if it has to go
+ * through net_tcp_ack_received().
  */
-void net_tcp_ack_received(struct net_context *ctx, uint32_t ack);
+bool net_tcp_fast_ack(struct net_context *ctx, struct net_buf *buf);
+
+/**
+ * @brief Acknowledge received data, maybe after a delay
+ *
+ * The ACK is delayed (RFC 1122), unless there is enough data to
+ * acknowledge, so that it can go with the data sent in reply.
+ *
+ * @param tcp TCP context
+ */
+void net_tcp_ack_data(struct net_tcp *tcp);
+
+/**
+ * @brief Handle the options and window of a received SYN segment
+ *
+ * @param tcp TCP context
+ * @param buf Received SYN segment
+ */
+void net_tcp_syn_received(struct net_tcp *tcp, struct net_buf *buf);
 
 /**
  * @brief Calculates and returns the MSS for a given TCP context
@@ -333,6 +497,33 @@ static inline enum net_tcp_state net_tcp_get_state(const struct net_tcp *tcp)
 	return (enum net_tcp_state)tcp->state;
 }
 
+/**
+ * @brief Check whether a segment is the one expected next
+ *
+ * Van Jacobson's header prediction: in an established connection, most
+ * segments are the next one in sequence, carry nothing but the ACK flag
+ * and no options, and leave the window as it was. They can skip most of
+ * the checks of the state machine.
+ *
+ * @param tcp TCP context
+ * @param buf Received segment
+ *
+ * @return True if the segment is the predicted one
+ */
+static inline bool net_tcp_predicted(const struct net_tcp *tcp,
+				     struct net_buf *buf)
+{
+	struct net_tcp_hdr *tcphdr = NET_TCP_BUF(buf);
+
+	return net_tcp_get_state(tcp) == NET_TCP_ESTABLISHED &&
+		(NET_TCP_FLAGS(buf) & ~NET_TCP_PSH) == NET_TCP_ACK &&
+		(tcphdr->offset >> 4) == NET_TCPH_LEN / 4 &&
+		sys_get_be32(tcphdr->seq) == tcp->send_ack &&
+		sys_get_be16(tcphdr->wnd) == tcp->send_wnd &&
+		!(tcp->flags & (NET_TCP_RETRYING | NET_TCP_RECOVERY)) &&
+		!tcp->ooo_count;
+}
+
 /**
  * @brief Sets the state for a TCP context
  *
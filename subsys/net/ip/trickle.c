@@ -23,6 +23,15 @@
 
 #define TICK_MAX ~0
 
+#define BATCH_WINDOW CONFIG_NET_TRICKLE_BATCH_WINDOW
+
+/* All the running Trickle instances share one timer. The events falling
+ * due within the batch window are handled in the same wakeup.
+ */
+static sys_slist_t trickles;
+static struct k_delayed_work trickle_timer;
+static bool trickle_timer_ready;
+
 static inline bool is_suppression_disabled(struct net_trickle *trickle)
 {
 	return trickle->k == NET_TRICKLE_INFINITE_REDUNDANCY;
@@ -39,6 +48,11 @@ static inline uint32_t get_end(struct net_trickle *trickle)
 	return trickle->Istart + trickle->I;
 }
 
+static inline bool is_due(struct net_trickle *trickle, uint32_t now)
+{
+	return (int32_t)(trickle->due - now) <= BATCH_WINDOW;
+}
+
 /* Returns a random time point t in [I/2 , I) */
 static uint32_t get_t(uint32_t I)
 {
@@ -49,20 +63,62 @@ static uint32_t get_t(uint32_t I)
 	return I + (sys_rand32_get() % I);
 }
 
-static void double_interval_timeout(struct k_work *work)
+/* Arm the shared timer for the earliest event */
+static void schedule(void)
 {
-	struct net_trickle *trickle = CONTAINER_OF(work,
-						   struct net_trickle,
-						   timer);
-	uint32_t rand_time;
+	uint32_t now = k_uptime_get_32();
+	struct net_trickle *trickle;
+	int32_t delay = -1;
+	unsigned int key;
 
-#if defined(CONFIG_NET_DEBUG_TRICKLE)
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&trickles, trickle, node) {
+		int32_t diff = (int32_t)(trickle->due - now);
+
+		if (diff < 0) {
+			diff = 0;
+		}
+
+		if (delay < 0 || diff < delay) {
+			delay = diff;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (delay < 0) {
+		k_delayed_work_cancel(&trickle_timer);
+		return;
+	}
+
+	k_delayed_work_submit(&trickle_timer, delay);
+}
+
+static void set_due(struct net_trickle *trickle, uint32_t due)
+{
+	unsigned int key;
+
+	key = irq_lock();
+
+	trickle->due = due;
+
+	sys_slist_find_and_remove(&trickles, &trickle->node);
+	sys_slist_append(&trickles, &trickle->node);
+
+	irq_unlock(key);
+
+	schedule();
+}
+
+static void double_interval(struct net_trickle *trickle, uint32_t now)
+{
 	uint32_t last_end = get_end(trickle);
-#endif
+	uint32_t rand_time;
 
 	trickle->c = 0;
 
-	NET_DBG("now %u (was at %u)", k_uptime_get_32(), last_end);
+	NET_DBG("now %u (was at %u)", now, last_end);
 
 	/* Check if we need to double the interval */
 	if (trickle->I <= (trickle->Imax_abs >> 1)) {
@@ -81,39 +137,30 @@ static void double_interval_timeout(struct k_work *work)
 
 	NET_DBG("doubling time %u", rand_time);
 
-	trickle->Istart = k_uptime_get_32() + rand_time;
+	/* The new interval starts where the previous one ended, unless
+	 * that was missed.
+	 */
+	if ((int32_t)(now - last_end) > 0) {
+		trickle->Istart = now;
+	} else {
+		trickle->Istart = last_end;
+	}
 
-	k_delayed_work_submit(&trickle->timer, rand_time);
+	trickle->due = trickle->Istart + rand_time;
+	trickle->fired = false;
 
 	NET_DBG("last end %u new end %u for %u I %u",
 		last_end, get_end(trickle), trickle->Istart, trickle->I);
 }
 
-static inline void reschedule(struct net_trickle *trickle)
+static void trickle_fire(struct net_trickle *trickle)
 {
-	uint32_t now = k_uptime_get_32();
-	uint32_t diff = get_end(trickle) - now;
-
-	NET_DBG("now %d end in %d", now, diff);
-
-	/* Did the clock wrap */
-	if (diff > (TICK_MAX >> 1)) {
-		diff = 0;
-		NET_DBG("Clock wrap");
-	}
-
-	k_delayed_work_init(&trickle->timer, double_interval_timeout);
-	k_delayed_work_submit(&trickle->timer, diff);
-}
-
-static void trickle_timeout(struct k_work *work)
-{
-	struct net_trickle *trickle = CONTAINER_OF(work,
-						   struct net_trickle,
-						   timer);
-
 	NET_DBG("Trickle timeout at %d", k_uptime_get_32());
 
+	/* The next event is the end of the interval */
+	trickle->fired = true;
+	trickle->due = get_end(trickle);
+
 	if (trickle->cb) {
 		NET_DBG("TX ok %d c(%u) < k(%u)",
 			is_tx_allowed(trickle), trickle->c, trickle->k);
@@ -121,10 +168,48 @@ static void trickle_timeout(struct k_work *work)
 		trickle->cb(trickle, is_tx_allowed(trickle),
 			    trickle->user_data);
 	}
+}
+
+/* Get an instance with an event due in the batch window */
+static struct net_trickle *get_due(uint32_t now)
+{
+	struct net_trickle *trickle, *found = NULL;
+	unsigned int key;
+
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&trickles, trickle, node) {
+		if (is_due(trickle, now)) {
+			found = trickle;
+			break;
+		}
+	}
+
+	irq_unlock(key);
 
-	if (net_trickle_is_running(trickle)) {
-		reschedule(trickle);
+	return found;
+}
+
+static void trickle_timeout(struct k_work *work)
+{
+	uint32_t now = k_uptime_get_32();
+	struct net_trickle *trickle;
+
+	ARG_UNUSED(work);
+
+	/* Each event moves its instance to a later time. The callbacks
+	 * can stop or restart instances, so they are looked up one at a
+	 * time.
+	 */
+	while ((trickle = get_due(now))) {
+		if (trickle->fired) {
+			double_interval(trickle, now);
+		} else {
+			trickle_fire(trickle);
+		}
 	}
+
+	schedule();
 }
 
 static void setup_new_interval(struct net_trickle *trickle)
@@ -136,8 +221,9 @@ static void setup_new_interval(struct net_trickle *trickle)
 	t = get_t(trickle->I);
 
 	trickle->Istart = k_uptime_get_32();
+	trickle->fired = false;
 
-	k_delayed_work_submit(&trickle->timer, t);
+	set_due(trickle, trickle->Istart + t);
 
 	NET_DBG("new interval at %d ends %d t %d I %d",
 		trickle->Istart,
@@ -156,6 +242,14 @@ int net_trickle_create(struct net_trickle *trickle,
 {
 	NET_ASSERT(trickle && Imax > 0 && k > 0 && !CHECK_IMIN(Imin));
 
+	if (!trickle_timer_ready) {
+		k_delayed_work_init(&trickle_timer, trickle_timeout);
+		trickle_timer_ready = true;
+	}
+
+	/* The instance could be running already */
+	net_trickle_stop(trickle);
+
 	memset(trickle, 0, sizeof(struct net_trickle));
 
 	trickle->Imin = Imin;
@@ -167,8 +261,6 @@ int net_trickle_create(struct net_trickle *trickle,
 		trickle->Imin, trickle->Imax, trickle->k,
 		trickle->Imax_abs);
 
-	k_delayed_work_init(&trickle->timer, trickle_timeout);
-
 	return 0;
 }
 
@@ -196,9 +288,13 @@ int net_trickle_start(struct net_trickle *trickle,
 
 int net_trickle_stop(struct net_trickle *trickle)
 {
+	unsigned int key;
+
 	NET_ASSERT(trickle);
 
-	k_delayed_work_cancel(&trickle->timer);
+	key = irq_lock();
+	sys_slist_find_and_remove(&trickles, &trickle->node);
+	irq_unlock(key);
 
 	trickle->I = 0;
 
@@ -355,31 +355,55 @@ int net_addr_pton(sa_family_t family, const char *src,
 	return 0;
 }
 
-static uint16_t calc_chksum(uint16_t sum, const uint8_t *ptr, uint16_t len)
+static inline uint32_t chksum_fold(uint32_t sum)
 {
-	uint16_t tmp;
-	const uint8_t *end;
+	sum = (sum >> 16) + (sum & 0xffff);
 
-	end = ptr + len - 1;
+	return (sum >> 16) + (sum & 0xffff);
+}
 
-	while (ptr < end) {
-		tmp = (ptr[0] << 8) + ptr[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+static __hot_text uint16_t calc_chksum(uint16_t sum, const uint8_t *ptr,
+				       uint16_t len)
+{
+	uint64_t acc = 0;
+	uint32_t tmp;
+
+	/* The one's complement sum does not depend on the byte order
+	 * (RFC 1071), so 32-bit words are added as loaded. The carries
+	 * are kept in the upper half of the accumulator, which makes the
+	 * additions add-with-carry chains on 32-bit CPUs.
+	 */
+	while (len >= 16) {
+		acc += UNALIGNED_GET((const uint32_t *)ptr);
+		acc += UNALIGNED_GET((const uint32_t *)(ptr + 4));
+		acc += UNALIGNED_GET((const uint32_t *)(ptr + 8));
+		acc += UNALIGNED_GET((const uint32_t *)(ptr + 12));
+		ptr += 16;
+		len -= 16;
+	}
+
+	while (len >= 4) {
+		acc += UNALIGNED_GET((const uint32_t *)ptr);
+		ptr += 4;
+		len -= 4;
+	}
+
+	/* 2^16 is 1 in one's complement arithmetic */
+	tmp = (acc & 0xffff) + ((acc >> 16) & 0xffff) +
+	      ((acc >> 32) & 0xffff) + (acc >> 48);
+	tmp = ntohs(chksum_fold(tmp));
+
+	if (len >= 2) {
+		tmp += (ptr[0] << 8) + ptr[1];
 		ptr += 2;
+		len -= 2;
 	}
 
-	if (ptr == end) {
-		tmp = ptr[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len) {
+		tmp += ptr[0] << 8;
 	}
 
-	return sum;
+	return chksum_fold(tmp + sum);
 }
 
 static inline uint16_t calc_chksum_buf(uint16_t sum, struct net_buf *buf,
@@ -481,3 +505,20 @@ uint16_t net_calc_chksum_ipv4(struct net_buf *buf)
 	return sum;
 }
 #endif /* CONFIG_NET_IPV4 */
+
+uint16_t net_chksum_update(uint16_t chksum, const void *old, const void *new,
+			   size_t len)
+{
+	const uint16_t *old_words = old, *new_words = new;
+	uint32_t sum = (uint16_t)~chksum;
+
+	NET_ASSERT(!(len & 1));
+
+	/* HC' = ~(~HC + ~m + m') from RFC 1624 */
+	for (; len; len -= 2, old_words++, new_words++) {
+		sum += (uint16_t)~UNALIGNED_GET(old_words);
+		sum = chksum_fold(sum + UNALIGNED_GET(new_words));
+	}
+
+	return ~chksum_fold(sum);
+}
@@ -10,6 +10,7 @@
 #include <drivers/rand32.h>
 #include <net/buf.h>
 #include <net/nbuf.h>
+#include <net/offload_ip.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
@@ -51,26 +52,189 @@ NET_BUF_POOL_DEFINE(dns_msg_pool, DNS_RESOLVER_BUF_CTR,
 NET_BUF_POOL_DEFINE(dns_qname_pool, DNS_RESOLVER_BUF_CTR, DNS_MAX_NAME_LEN,
 		    0, NULL);
 
+#if CONFIG_DNS_RESOLVER_CACHE_ENTRIES > 0
+#define DNS_CACHE_ADDRESSES	CONFIG_DNS_RESOLVER_CACHE_ADDRESSES
+
+/* An entry without items is a negative one: the name is known not to
+ * have any address of that type.
+ */
+struct dns_cache_entry {
+	int64_t expiry;
+	uint8_t addresses[DNS_CACHE_ADDRESSES * DNS_IPV6_LEN];
+	char name[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN];
+	uint16_t query_type;
+	uint8_t items;
+	bool used;
+};
+
+static struct dns_cache_entry dns_cache[CONFIG_DNS_RESOLVER_CACHE_ENTRIES];
+static K_MUTEX_DEFINE(dns_cache_lock);
+#endif
+
 int dns_init(struct dns_context *ctx)
 {
 	k_sem_init(&ctx->rx_sem, 0, UINT_MAX);
+	ctx->rx_buf = NULL;
+	ctx->servers = 1;
 
 	return 0;
 }
 
 static
 int dns_write(struct dns_context *ctx, struct net_buf *dns_data,
-	      uint16_t dns_id, struct net_buf *dns_qname);
+	      uint16_t dns_id, struct net_buf *dns_qname,
+	      struct sockaddr *dns_server);
 
 static
 int dns_read(struct dns_context *ctx, struct net_buf *dns_data, uint16_t dns_id,
-	     struct net_buf *cname);
+	     struct net_buf *cname, uint32_t *ttl);
 
 /* net_context_recv callback */
 static
 void cb_recv(struct net_context *net_ctx, struct net_buf *buf, int status,
 	     void *data);
 
+static inline int address_size(struct dns_context *ctx)
+{
+	return ctx->query_type == DNS_QUERY_TYPE_A ? DNS_IPV4_LEN :
+						     DNS_IPV6_LEN;
+}
+
+#if CONFIG_DNS_RESOLVER_CACHE_ENTRIES > 0
+static struct dns_cache_entry *dns_cache_find(struct dns_context *ctx)
+{
+	int64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (!entry->used || entry->query_type != ctx->query_type ||
+		    strcmp(entry->name, ctx->name)) {
+			continue;
+		}
+
+		if (entry->expiry <= now) {
+			entry->used = false;
+			return NULL;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+/* Returns -ENOENT if the name is not cached */
+static int dns_cache_lookup(struct dns_context *ctx)
+{
+	struct dns_cache_entry *entry;
+	int rc = -ENOENT;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_find(ctx);
+	if (!entry) {
+		goto out;
+	}
+
+	if (!entry->items) {
+		rc = -EINVAL;
+		goto out;
+	}
+
+	ctx->items = min(entry->items, ctx->elements);
+	memcpy(ctx->address.ipv4, entry->addresses,
+	       ctx->items * address_size(ctx));
+	rc = 0;
+
+out:
+	k_mutex_unlock(&dns_cache_lock);
+
+	return rc;
+}
+
+/* Caches the addresses in ctx for ttl seconds, or an entry without any
+ * address if there are none.
+ */
+static void dns_cache_store(struct dns_context *ctx, uint32_t ttl)
+{
+	struct dns_cache_entry *entry;
+	int i;
+
+	if (!ttl || strlen(ctx->name) >= CONFIG_DNS_RESOLVER_CACHE_NAME_LEN) {
+		return;
+	}
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_find(ctx);
+
+	/* Take a free entry, or else the one expiring first */
+	for (i = 0; !entry && i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		if (!dns_cache[i].used) {
+			entry = &dns_cache[i];
+		}
+	}
+
+	for (i = 0; !entry && i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		if (!i || dns_cache[i].expiry < entry->expiry) {
+			entry = &dns_cache[i];
+		}
+	}
+
+	entry->expiry = k_uptime_get() + (int64_t)ttl * MSEC_PER_SEC;
+	entry->query_type = ctx->query_type;
+	entry->items = min(ctx->items, DNS_CACHE_ADDRESSES);
+	memcpy(entry->addresses, ctx->address.ipv4,
+	       entry->items * address_size(ctx));
+	strcpy(entry->name, ctx->name);
+	entry->used = true;
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+#else
+static inline int dns_cache_lookup(struct dns_context *ctx)
+{
+	return -ENOENT;
+}
+
+static inline void dns_cache_store(struct dns_context *ctx, uint32_t ttl)
+{
+}
+#endif
+
+#if defined(CONFIG_NET_L2_OFFLOAD_IP)
+/* Returns -ENOTSUP if the name is to be resolved with DNS queries */
+static int dns_resolve_offloaded(struct dns_context *ctx)
+{
+	struct net_if *iface = net_context_get_iface(ctx->net_ctx);
+	int rc;
+
+	if (!net_if_is_ip_offloaded(iface)) {
+		return -ENOTSUP;
+	}
+
+	rc = net_l2_offload_ip_dns_resolve(iface, ctx->name,
+					   ctx->query_type == DNS_QUERY_TYPE_A ?
+					   AF_INET : AF_INET6,
+					   ctx->address.ipv4, ctx->elements,
+					   ctx->timeout);
+	if (rc < 0) {
+		return rc;
+	}
+
+	ctx->items = rc;
+
+	return ctx->items > 0 ? 0 : -EINVAL;
+}
+#else
+static inline int dns_resolve_offloaded(struct dns_context *ctx)
+{
+	return -ENOTSUP;
+}
+#endif
+
 /*
  * Note about the DNS transaction identifier:
  * The transaction identifier is randomized according to:
@@ -82,9 +246,27 @@ int dns_resolve(struct dns_context *ctx)
 {
 	struct net_buf *dns_data = NULL;
 	struct net_buf *dns_qname = NULL;
+	/* smallest TTL of the answers */
+	uint32_t ttl = UINT32_MAX;
 	uint16_t dns_id;
 	int rc;
 	int i;
+	int j;
+
+	if (ctx->elements <= 0) {
+		return -EINVAL;
+	}
+
+	rc = dns_cache_lookup(ctx);
+	if (rc != -ENOENT) {
+		return rc;
+	}
+
+	/* The offloaded IP stack may resolve names itself */
+	rc = dns_resolve_offloaded(ctx);
+	if (rc != -ENOTSUP) {
+		return rc;
+	}
 
 	k_sem_reset(&ctx->rx_sem);
 
@@ -113,12 +295,23 @@ int dns_resolve(struct dns_context *ctx)
 
 	i = 0;
 	do {
-		rc = dns_write(ctx, dns_data, dns_id, dns_qname);
-		if (rc != 0) {
-			goto exit_resolve;
+		/* All the servers are queried at once, the first answer
+		 * is used.
+		 */
+		for (j = 0; j < max(ctx->servers, 1); j++) {
+			rc = dns_write(ctx, dns_data, dns_id, dns_qname,
+				       &ctx->dns_server[j]);
+			if (rc != 0) {
+				goto exit_resolve;
+			}
+		}
+
+		rc = dns_read(ctx, dns_data, dns_id, dns_qname, &ttl);
+		if (rc == -ENOENT) {
+			/* The name has no address */
+			break;
 		}
 
-		rc = dns_read(ctx, dns_data, dns_id, dns_qname);
 		if (rc != 0) {
 			goto exit_resolve;
 		}
@@ -130,8 +323,11 @@ int dns_resolve(struct dns_context *ctx)
 	} while (++i < DNS_RESOLVER_QUERIES);
 
 	if (ctx->items > 0) {
+		dns_cache_store(ctx, ttl);
 		rc = 0;
 	} else {
+		ctx->items = 0;
+		dns_cache_store(ctx, CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL);
 		rc = -EINVAL;
 	}
 
@@ -143,12 +339,17 @@ exit_resolve:
 	/* uninstall the callback */
 	net_context_recv(ctx->net_ctx, NULL, 0, NULL);
 
+	/* drop any late answer */
+	net_nbuf_unref(ctx->rx_buf);
+	ctx->rx_buf = NULL;
+
 	return rc;
 }
 
 static
 int dns_write(struct dns_context *ctx, struct net_buf *dns_data,
-	      uint16_t dns_id, struct net_buf *dns_qname)
+	      uint16_t dns_id, struct net_buf *dns_qname,
+	      struct sockaddr *dns_server)
 {
 	struct net_buf *tx;
 	int server_addr_len;
@@ -174,14 +375,14 @@ int dns_write(struct dns_context *ctx, struct net_buf *dns_data,
 		goto exit_write;
 	}
 
-	if (ctx->dns_server->family == AF_INET) {
+	if (dns_server->family == AF_INET) {
 		server_addr_len = sizeof(struct sockaddr_in);
 	} else {
 		server_addr_len = sizeof(struct sockaddr_in6);
 	}
 
 	/* tx and dns_data buffers will be dereferenced after this call */
-	rc = net_context_sendto(tx, ctx->dns_server, server_addr_len, NULL,
+	rc = net_context_sendto(tx, dns_server, server_addr_len, NULL,
 				ctx->timeout, NULL, NULL);
 	if (rc != 0) {
 		rc = -EIO;
@@ -199,6 +400,7 @@ void cb_recv(struct net_context *net_ctx, struct net_buf *buf, int status,
 	     void *data)
 {
 	struct dns_context *ctx = (struct dns_context *)data;
+	unsigned int key;
 
 	ARG_UNUSED(net_ctx);
 
@@ -206,22 +408,61 @@ void cb_recv(struct net_context *net_ctx, struct net_buf *buf, int status,
 		return;
 	}
 
+	/* Only one answer is kept until it is read, the other servers
+	 * are only waited for if it is not usable.
+	 */
+	key = irq_lock();
+
+	if (ctx->rx_buf) {
+		irq_unlock(key);
+		net_nbuf_unref(buf);
+		return;
+	}
+
 	ctx->rx_buf = buf;
+
+	irq_unlock(key);
+
 	k_sem_give(&ctx->rx_sem);
 }
 
+static struct net_buf *dns_wait_answer(struct dns_context *ctx,
+				       int32_t timeout)
+{
+	struct net_buf *buf;
+	unsigned int key;
+
+	/* Block until timeout or data is received, see the 'cb_recv'
+	 * routine.
+	 */
+	k_sem_take(&ctx->rx_sem, timeout);
+
+	key = irq_lock();
+
+	buf = ctx->rx_buf;
+	ctx->rx_buf = NULL;
+
+	irq_unlock(key);
+
+	return buf;
+}
+
+/* Returns -EAGAIN if buf is not an answer to the dns_id query, and -ENOENT
+ * if it is one saying that the name has no address.
+ */
 static
-int dns_read(struct dns_context *ctx, struct net_buf *dns_data, uint16_t dns_id,
-	     struct net_buf *cname)
+int dns_parse(struct dns_context *ctx, struct net_buf *dns_data,
+	      struct net_buf *buf, uint16_t dns_id, struct net_buf *cname,
+	      uint32_t *ttl)
 {
 	/* helper struct to track the dns msg received from the server */
 	struct dns_msg_t dns_msg;
 	uint8_t *addresses;
-	/* RR ttl, so far it is not passed to caller */
-	uint32_t ttl;
+	/* RR ttl */
+	uint32_t rr_ttl;
 	uint8_t *src;
 	uint8_t *dst;
-	int address_size;
+	int address_len;
 	/* index that points to the current answer being analyzed */
 	int answer_ptr;
 	int data_len;
@@ -234,39 +475,33 @@ int dns_read(struct dns_context *ctx, struct net_buf *dns_data, uint16_t dns_id,
 	 */
 	addresses = (uint8_t *)ctx->address.ipv4;
 
-	if (ctx->elements <= 0) {
-		rc = -EINVAL;
+	data_len = min(net_nbuf_appdatalen(buf), DNS_RESOLVER_MAX_BUF_SIZE);
+	offset = net_buf_frags_len(buf) - data_len;
+
+	rc = net_nbuf_linear_copy(dns_data, buf, offset, data_len);
+	if (rc != 0) {
+		rc = -ENOMEM;
 		goto exit_error;
 	}
 
-	ctx->rx_buf = NULL;
-
-	/* Block until timeout or data is received, see the 'cb_recv' routine */
-	k_sem_take(&ctx->rx_sem, ctx->timeout);
+	dns_msg.msg = dns_data->data;
+	dns_msg.msg_size = data_len;
 
-	/* If data is received, rx_buf is set inside 'cb_recv'. Otherwise,
-	 * k_sem_take will expire while ctx->rx_buf is still NULL
-	 */
-	if (!ctx->rx_buf) {
-		rc = -EIO;
+	if (data_len < DNS_MSG_HEADER_SIZE ||
+	    dns_unpack_header_id(dns_msg.msg) != dns_id ||
+	    dns_header_qr(dns_msg.msg) != DNS_RESPONSE) {
+		rc = -EAGAIN;
 		goto exit_error;
 	}
 
-	data_len = min(net_nbuf_appdatalen(ctx->rx_buf),
-		       DNS_RESOLVER_MAX_BUF_SIZE);
-	offset = net_buf_frags_len(ctx->rx_buf) - data_len;
-
-	rc = net_nbuf_linear_copy(dns_data, ctx->rx_buf, offset, data_len);
-	if (rc != 0) {
-		rc = -ENOMEM;
+	rc = dns_header_rcode(dns_msg.msg);
+	if (rc == DNS_HEADER_NAMEERROR ||
+	    (rc == DNS_HEADER_NOERROR &&
+	     dns_header_ancount(dns_msg.msg) == 0)) {
+		rc = -ENOENT;
 		goto exit_error;
 	}
 
-	k_sem_give(&ctx->rx_sem);
-
-	dns_msg.msg = dns_data->data;
-	dns_msg.msg_size = data_len;
-
 	rc = dns_unpack_response_header(&dns_msg, dns_id);
 	if (rc != 0) {
 		rc = -EINVAL;
@@ -284,34 +519,33 @@ int dns_read(struct dns_context *ctx, struct net_buf *dns_data, uint16_t dns_id,
 		goto exit_error;
 	}
 
-	if (ctx->query_type == DNS_QUERY_TYPE_A) {
-		address_size = DNS_IPV4_LEN;
-	} else {
-		address_size = DNS_IPV6_LEN;
-	}
+	address_len = address_size(ctx);
 
 	/* while loop to traverse the response */
 	answer_ptr = DNS_QUERY_POS;
 	ctx->items = 0;
 	i = 0;
 	while (i < dns_header_ancount(dns_msg.msg)) {
-		rc = dns_unpack_answer(&dns_msg, answer_ptr, &ttl);
+		rc = dns_unpack_answer(&dns_msg, answer_ptr, &rr_ttl);
 		if (rc != 0) {
 			rc = -EINVAL;
 			goto exit_error;
 		}
 
+		/* The answer expires with its first record */
+		*ttl = min(*ttl, rr_ttl);
+
 		switch (dns_msg.response_type) {
 		case DNS_RESPONSE_IP:
-			if (dns_msg.response_length < address_size) {
+			if (dns_msg.response_length < address_len) {
 				/* it seems this is a malformed message */
 				rc = -EINVAL;
 				goto exit_error;
 			}
 
 			src = dns_msg.msg + dns_msg.response_position;
-			dst = addresses + ctx->items * address_size;
-			memcpy(dst, src, address_size);
+			dst = addresses + ctx->items * address_len;
+			memcpy(dst, src, address_len);
 
 			ctx->items += 1;
 			if (ctx->items >= ctx->elements) {
@@ -362,7 +596,93 @@ exit_ok:
 	rc = 0;
 
 exit_error:
-	net_nbuf_unref(ctx->rx_buf);
+	net_nbuf_unref(buf);
 
 	return rc;
 }
+
+static
+int dns_read(struct dns_context *ctx, struct net_buf *dns_data, uint16_t dns_id,
+	     struct net_buf *cname, uint32_t *ttl)
+{
+	uint32_t start = k_uptime_get_32();
+	int32_t timeout = ctx->timeout;
+	struct net_buf *buf;
+	int answers = 0;
+	int rc;
+
+	while (1) {
+		buf = dns_wait_answer(ctx, timeout);
+		if (!buf) {
+			return -EIO;
+		}
+
+		rc = dns_parse(ctx, dns_data, buf, dns_id, cname, ttl);
+
+		/* An error from one server is only final when all the
+		 * others have answered too.
+		 */
+		if (rc != -EAGAIN &&
+		    (rc == 0 || rc == -ENOENT ||
+		     ++answers >= max(ctx->servers, 1))) {
+			return rc;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout = ctx->timeout - (k_uptime_get_32() - start);
+			if (timeout <= 0) {
+				return -EIO;
+			}
+		}
+	}
+}
+
+#if defined(CONFIG_DNS_RESOLVER_ASYNC)
+static K_FIFO_DEFINE(dns_queue);
+
+static void dns_thread(void *p1, void *p2, void *p3)
+{
+	struct dns_context *ctx;
+	int rc;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		ctx = k_fifo_get(&dns_queue, K_FOREVER);
+
+		rc = dns_resolve(ctx);
+		ctx->cb(ctx, rc, ctx->user_data);
+	}
+}
+
+K_THREAD_DEFINE(dns_resolver, CONFIG_DNS_RESOLVER_ASYNC_STACK_SIZE,
+		dns_thread, NULL, NULL, NULL,
+		K_PRIO_COOP(CONFIG_DNS_RESOLVER_ASYNC_THREAD_PRIO), 0,
+		K_NO_WAIT);
+
+int dns_resolve_async(struct dns_context *ctx, dns_resolve_cb_t cb,
+		      void *user_data)
+{
+	int rc;
+
+	if (!cb || ctx->elements <= 0) {
+		return -EINVAL;
+	}
+
+	/* Cached names are answered right away */
+	rc = dns_cache_lookup(ctx);
+	if (rc != -ENOENT) {
+		cb(ctx, rc, user_data);
+		return 0;
+	}
+
+	ctx->cb = cb;
+	ctx->user_data = user_data;
+
+	k_fifo_put(&dns_queue, ctx);
+
+	return 0;
+}
+#endif
@@ -765,6 +765,45 @@ int parser_header_state(struct http_parser *parser, char ch, char c)
 	return 0;
 }
 
+/* Any byte below 0x20 or equal to 0x7f in a word, see "Determine if a word
+ * has a byte less than n" in Sean Eron Anderson's Bit Twiddling Hacks.
+ */
+#define WORD_ONES 0x01010101U
+#define WORD_HIGHS 0x80808080U
+
+static inline int word_has_ctl(uint32_t w)
+{
+	uint32_t del = w ^ (WORD_ONES * 0x7f);
+
+	return ((w - WORD_ONES * 0x20) & ~w & WORD_HIGHS) ||
+	       ((del - WORD_ONES) & ~del & WORD_HIGHS);
+}
+
+/* Returns the first CR, LF or control character other than tab between
+ * p and end, or end. Aligned words without any control character are
+ * skipped at once.
+ */
+static const char *header_value_scan(const char *p, const char *end)
+{
+	for (; p < end; p++) {
+		unsigned char ch;
+
+		if (!((uintptr_t)p & (sizeof(uint32_t) - 1)) &&
+		    end - p >= sizeof(uint32_t) &&
+		    !word_has_ctl(*(const uint32_t *)p)) {
+			p += sizeof(uint32_t) - 1;
+			continue;
+		}
+
+		ch = *p;
+		if ((ch < 32 && ch != '\t') || ch == 127) {
+			return p;
+		}
+	}
+
+	return end;
+}
+
 static
 int header_states(struct http_parser *parser, const char *data, size_t len,
 		  const char **ptr, enum state *p_state,
@@ -777,24 +816,11 @@ int header_states(struct http_parser *parser, const char *data, size_t len,
 	switch (h_state) {
 	case h_general: {
 		size_t limit = data + len - p;
-		const char *p_cr;
-		const char *p_lf;
 
 		limit = MIN(limit, HTTP_MAX_HEADER_SIZE);
-		p_cr = (const char *)memchr(p, CR, limit);
-		p_lf = (const char *)memchr(p, LF, limit);
-		if (p_cr != NULL) {
-			if (p_lf != NULL && p_cr >= p_lf) {
-				p = p_lf;
-			} else {
-				p = p_cr;
-			}
-		} else if (UNLIKELY(p_lf != NULL)) {
-			p = p_lf;
-		} else {
-			p = data + len;
-		}
-		--p;
+
+		/* Resume at the next CR, LF or invalid character */
+		p = header_value_scan(p + 1, p + limit) - 1;
 
 		break;
 	}
@@ -23,6 +23,8 @@ NET_BUF_POOL_DEFINE(mqtt_msg_pool, MQTT_BUF_CTR, MSG_SIZE, 0, NULL);
 
 #define MQTT_PUBLISHER_MIN_MSG_SIZE	2
 
+static void mqtt_inflight_clear(struct mqtt_ctx *ctx);
+
 int mqtt_tx_connect(struct mqtt_ctx *ctx, struct mqtt_connect_msg *msg)
 {
 	struct net_buf *data = NULL;
@@ -102,6 +104,8 @@ int mqtt_tx_disconnect(struct mqtt_ctx *ctx)
 	ctx->connected = 0;
 	tx = NULL;
 
+	mqtt_inflight_clear(ctx);
+
 	if (ctx->disconnect) {
 		ctx->disconnect(ctx);
 	}
@@ -200,32 +204,63 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, uint16_t id)
 	return mqtt_tx_pub_msgs(ctx, id, MQTT_PUBREL);
 }
 
-int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
+static void mqtt_publish_sent(const void *data, void *user_data)
+{
+	struct mqtt_ctx *ctx = user_data;
+
+	ctx->publish_sent(ctx, data);
+}
+
+/* The header is packed right into the first data fragment, then the
+ * payload is appended to it, or referred to if ctx->publish_sent is set.
+ */
+static
+int mqtt_send_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
 {
 	struct net_buf *data = NULL;
 	struct net_buf *tx = NULL;
 	int rc;
 
-	data = net_buf_alloc(&mqtt_msg_pool, ctx->net_timeout);
+	tx = net_nbuf_get_tx(ctx->net_ctx, ctx->net_timeout);
+	if (tx == NULL) {
+		rc = -ENOMEM;
+		goto exit_publish;
+	}
+
+	data = net_nbuf_get_data(ctx->net_ctx, ctx->net_timeout);
 	if (data == NULL) {
 		rc = -ENOMEM;
 		goto exit_publish;
 	}
 
-	rc = mqtt_pack_publish(data->data, &data->len, data->size, msg);
+	net_buf_frag_add(tx, data);
+	data = NULL;
+
+	rc = mqtt_pack_publish_header(net_buf_tail(tx->frags), &tx->frags->len,
+				      net_buf_tailroom(tx->frags), msg);
 	if (rc != 0) {
 		rc = -EINVAL;
 		goto exit_publish;
 	}
 
-	tx = net_nbuf_get_tx(ctx->net_ctx, ctx->net_timeout);
-	if (tx == NULL) {
-		rc = -ENOMEM;
-		goto exit_publish;
-	}
+	if (msg->msg_len > 0 && ctx->publish_sent) {
+		data = net_nbuf_get_ext_data(msg->msg, msg->msg_len,
+					     mqtt_publish_sent, ctx,
+					     ctx->net_timeout);
+		if (data == NULL) {
+			rc = -ENOMEM;
+			goto exit_publish;
+		}
 
-	net_buf_frag_add(tx, data);
-	data = NULL;
+		net_buf_frag_add(tx, data);
+		data = NULL;
+	} else if (msg->msg_len > 0) {
+		if (!net_nbuf_append(tx, msg->msg_len, msg->msg,
+				     ctx->net_timeout)) {
+			rc = -ENOMEM;
+			goto exit_publish;
+		}
+	}
 
 	rc = net_context_send(tx, NULL, ctx->net_timeout, NULL, NULL);
 	if (rc < 0) {
@@ -242,6 +277,239 @@ exit_publish:
 	return rc;
 }
 
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+#define MQTT_WINDOW		CONFIG_MQTT_INFLIGHT_WINDOW
+#define MQTT_RETRANSMIT_TIMEOUT	CONFIG_MQTT_RETRANSMIT_TIMEOUT
+
+/* All the contexts with messages in flight share one retransmission timer */
+static sys_slist_t mqtt_ctxs;
+static struct k_delayed_work mqtt_timer;
+static bool mqtt_timer_ready;
+
+/* Arm the timer for the earliest retransmission */
+static void mqtt_timer_schedule(void)
+{
+	uint32_t now = k_uptime_get_32();
+	struct mqtt_ctx *ctx;
+	int32_t delay = -1;
+	unsigned int key;
+	int i;
+
+	if (!mqtt_timer_ready) {
+		return;
+	}
+
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&mqtt_ctxs, ctx, node) {
+		for (i = 0; i < MQTT_WINDOW; i++) {
+			int32_t diff;
+
+			if (ctx->inflight[i].state == MQTT_INVALID) {
+				continue;
+			}
+
+			diff = max((int32_t)(ctx->inflight[i].deadline - now), 0);
+			if (delay < 0 || diff < delay) {
+				delay = diff;
+			}
+		}
+	}
+
+	irq_unlock(key);
+
+	if (delay < 0) {
+		k_delayed_work_cancel(&mqtt_timer);
+		return;
+	}
+
+	k_delayed_work_submit(&mqtt_timer, delay);
+}
+
+/* Get a message due for retransmission, and set its next deadline */
+static struct mqtt_ctx *mqtt_inflight_get_due(uint32_t now,
+					      struct mqtt_inflight *due)
+{
+	struct mqtt_ctx *ctx;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&mqtt_ctxs, ctx, node) {
+		for (i = 0; i < MQTT_WINDOW; i++) {
+			struct mqtt_inflight *inflight = &ctx->inflight[i];
+
+			if (inflight->state == MQTT_INVALID ||
+			    (int32_t)(inflight->deadline - now) > 0) {
+				continue;
+			}
+
+			inflight->deadline = now + MQTT_RETRANSMIT_TIMEOUT;
+			*due = *inflight;
+
+			irq_unlock(key);
+
+			return ctx;
+		}
+	}
+
+	irq_unlock(key);
+
+	return NULL;
+}
+
+static void mqtt_retransmit(struct k_work *work)
+{
+	uint32_t now = k_uptime_get_32();
+	struct mqtt_inflight due;
+	struct mqtt_ctx *ctx;
+
+	ARG_UNUSED(work);
+
+	while ((ctx = mqtt_inflight_get_due(now, &due))) {
+		if (due.state == MQTT_PUBLISH) {
+			mqtt_send_publish(ctx, &due.msg);
+		} else {
+			mqtt_tx_pubrel(ctx, due.msg.pkt_id);
+		}
+	}
+
+	mqtt_timer_schedule();
+}
+
+static int mqtt_inflight_add(struct mqtt_ctx *ctx,
+			     struct mqtt_publish_msg *msg)
+{
+	struct mqtt_inflight *inflight = NULL;
+	unsigned int key;
+	int i;
+
+	if (!mqtt_timer_ready) {
+		k_delayed_work_init(&mqtt_timer, mqtt_retransmit);
+		mqtt_timer_ready = true;
+	}
+
+	key = irq_lock();
+
+	for (i = 0; i < MQTT_WINDOW; i++) {
+		if (ctx->inflight[i].state == MQTT_INVALID) {
+			if (!inflight) {
+				inflight = &ctx->inflight[i];
+			}
+		} else if (ctx->inflight[i].msg.pkt_id == msg->pkt_id) {
+			/* The packet identifier is still in use */
+			irq_unlock(key);
+			return -EINVAL;
+		}
+	}
+
+	if (!inflight) {
+		irq_unlock(key);
+		return -EAGAIN;
+	}
+
+	inflight->msg = *msg;
+	inflight->msg.dup = 1;
+	inflight->deadline = k_uptime_get_32() + MQTT_RETRANSMIT_TIMEOUT;
+	inflight->state = MQTT_PUBLISH;
+
+	sys_slist_find_and_remove(&mqtt_ctxs, &ctx->node);
+	sys_slist_append(&mqtt_ctxs, &ctx->node);
+
+	irq_unlock(key);
+
+	mqtt_timer_schedule();
+
+	return 0;
+}
+
+/* Moves the message pkt_id on, once acknowledged by a msg of type */
+static void mqtt_inflight_ack(struct mqtt_ctx *ctx, uint16_t pkt_id,
+			      enum mqtt_packet type)
+{
+	uint8_t state = type == MQTT_PUBCOMP ? MQTT_PUBREL : MQTT_PUBLISH;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < MQTT_WINDOW; i++) {
+		struct mqtt_inflight *inflight = &ctx->inflight[i];
+
+		if (inflight->state != state ||
+		    inflight->msg.pkt_id != pkt_id) {
+			continue;
+		}
+
+		if (type == MQTT_PUBREC) {
+			inflight->state = MQTT_PUBREL;
+			inflight->deadline = k_uptime_get_32() +
+					     MQTT_RETRANSMIT_TIMEOUT;
+		} else {
+			inflight->state = MQTT_INVALID;
+		}
+
+		break;
+	}
+
+	irq_unlock(key);
+
+	mqtt_timer_schedule();
+}
+
+static void mqtt_inflight_clear(struct mqtt_ctx *ctx)
+{
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < MQTT_WINDOW; i++) {
+		ctx->inflight[i].state = MQTT_INVALID;
+	}
+
+	sys_slist_find_and_remove(&mqtt_ctxs, &ctx->node);
+
+	irq_unlock(key);
+}
+#else
+static inline int mqtt_inflight_add(struct mqtt_ctx *ctx,
+				    struct mqtt_publish_msg *msg)
+{
+	return 0;
+}
+
+static inline void mqtt_inflight_ack(struct mqtt_ctx *ctx, uint16_t pkt_id,
+				     enum mqtt_packet type)
+{
+}
+
+static inline void mqtt_inflight_clear(struct mqtt_ctx *ctx)
+{
+}
+#endif
+
+int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
+{
+	int rc;
+
+	if (msg->qos > MQTT_QoS0) {
+		rc = mqtt_inflight_add(ctx, msg);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	rc = mqtt_send_publish(ctx, msg);
+	if (rc != 0 && msg->qos > MQTT_QoS0) {
+		/* The application sends it again */
+		mqtt_inflight_ack(ctx, msg->pkt_id, MQTT_PUBACK);
+	}
+
+	return rc;
+}
+
 int mqtt_tx_pingreq(struct mqtt_ctx *ctx)
 {
 	struct net_buf *tx = NULL;
@@ -491,6 +759,10 @@ int mqtt_rx_pub_msgs(struct mqtt_ctx *ctx, struct net_buf *rx,
 		return -EINVAL;
 	}
 
+	if (type != MQTT_PUBREL) {
+		mqtt_inflight_ack(ctx, pkt_id, type);
+	}
+
 	if (!response)  {
 		return 0;
 	}
@@ -629,7 +901,40 @@ int mqtt_rx_publish(struct mqtt_ctx *ctx, struct net_buf *rx)
 }
 
 /**
- * Linearizes an IP fragmented buffer
+ * Returns the fragment of rx holding the whole message, trimmed to it
+ *
+ * @param [in] rx RX IP stack buffer
+ * @param [in] data_len Message length, the message ends the buffer
+ *
+ * @retval Referenced fragment, the caller must unref it
+ * @retval NULL if the message spans several fragments
+ */
+static
+struct net_buf *mqtt_msg_frag(struct net_buf *rx, uint16_t data_len)
+{
+	uint16_t offset = net_buf_frags_len(rx) - data_len;
+	struct net_buf *frag = rx->frags;
+
+	while (frag && offset >= frag->len) {
+		offset -= frag->len;
+		frag = frag->frags;
+	}
+
+	if (!frag || offset + data_len != frag->len) {
+		return NULL;
+	}
+
+	/* rx is released once parsed, so it can be modified */
+	net_buf_pull(frag, offset);
+
+	return net_buf_ref(frag);
+}
+
+/**
+ * Gets the MQTT message of an IP fragmented buffer as a single buffer
+ *
+ * @details The message is parsed in place when a single fragment holds it,
+ * otherwise it is copied.
  *
  * @param [in] ctx MQTT context structure
  * @param [in] rx RX IP stack buffer
@@ -648,12 +953,20 @@ struct net_buf *mqtt_linearize_buffer(struct mqtt_ctx *ctx, struct net_buf *rx,
 	uint16_t offset;
 	int rc;
 
+	data_len = net_nbuf_appdatalen(rx);
+	if (data_len < min_size) {
+		return NULL;
+	}
+
+	data = mqtt_msg_frag(rx, data_len);
+	if (data) {
+		return data;
+	}
+
 	/* CONFIG_MQTT_MSG_MAX_SIZE is defined via Kconfig. So here it's
-	 * determined if the input buffer could fit our data buffer or if
-	 * it has the expected size.
+	 * determined if the input buffer could fit our data buffer.
 	 */
-	data_len = net_nbuf_appdatalen(rx);
-	if (data_len < min_size || data_len > CONFIG_MQTT_MSG_MAX_SIZE) {
+	if (data_len > CONFIG_MQTT_MSG_MAX_SIZE) {
 		return NULL;
 	}
 
@@ -835,8 +835,8 @@ int mqtt_unpack_suback(uint8_t *buf, uint16_t length, uint16_t *pkt_id,
 	return 0;
 }
 
-int mqtt_pack_publish(uint8_t *buf, uint16_t *length, uint16_t size,
-		      struct mqtt_publish_msg *msg)
+int mqtt_pack_publish_header(uint8_t *buf, uint16_t *length, uint16_t size,
+			     struct mqtt_publish_msg *msg)
 {
 	uint16_t offset;
 	uint16_t rlen_size;
@@ -859,10 +859,11 @@ int mqtt_pack_publish(uint8_t *buf, uint16_t *length, uint16_t size,
 		return -EINVAL;
 	}
 
-	/* full packet size is:
+	/* header size is:
 	 * 1 byte for the packet type field size + rem len size + payload
+	 * without the msg
 	 */
-	if (PACKET_TYPE_SIZE + rlen_size + payload > size) {
+	if (PACKET_TYPE_SIZE + rlen_size + payload - msg->msg_len > size) {
 		return -ENOMEM;
 	}
 
@@ -887,14 +888,31 @@ int mqtt_pack_publish(uint8_t *buf, uint16_t *length, uint16_t size,
 		offset += PACKET_ID_SIZE;
 	}
 
-	memcpy(buf + offset, msg->msg, msg->msg_len);
-	offset += msg->msg_len;
-
 	*length = offset;
 
 	return 0;
 }
 
+int mqtt_pack_publish(uint8_t *buf, uint16_t *length, uint16_t size,
+		      struct mqtt_publish_msg *msg)
+{
+	int rc;
+
+	rc = mqtt_pack_publish_header(buf, length, size, msg);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (*length + msg->msg_len > size) {
+		return -ENOMEM;
+	}
+
+	memcpy(buf + *length, msg->msg, msg->msg_len);
+	*length += msg->msg_len;
+
+	return 0;
+}
+
 int mqtt_unpack_publish(uint8_t *buf, uint16_t length,
 			struct mqtt_publish_msg *msg)
 {
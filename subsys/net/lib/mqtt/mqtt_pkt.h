@@ -220,6 +220,22 @@ int mqtt_unpack_suback(uint8_t *buf, uint16_t length, uint16_t *pkt_id,
 		       uint8_t *items, uint8_t elements,
 		       enum mqtt_qos granted_qos[]);
 
+/**
+ * Packs the MQTT PUBLISH message up to its payload: the fixed header, the
+ * topic and the packet identifier
+ *
+ * @param [out] buf Buffer where the resultant header is stored
+ * @param [out] length Number of bytes required to codify the header
+ * @param [in] size Buffer size
+ * @param [in] msg MQTT PUBLISH message
+ *
+ * @retval 0 on success
+ * @retval -EINVAL
+ * @retval -ENOMEM
+ */
+int mqtt_pack_publish_header(uint8_t *buf, uint16_t *length, uint16_t size,
+			     struct mqtt_publish_msg *msg);
+
 /**
  * Packs the MQTT PUBLISH message
  *
@@ -0,0 +1,681 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <kernel.h>
+#include <misc/util.h>
+#include <net/buf.h>
+#include <net/nbuf.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+
+#define NUM_SOCKETS CONFIG_NET_MAX_CONTEXTS
+
+/* Largest write queued at once on a stream, the default TCP MSS. Smaller
+ * writes are coalesced into full segments by TCP.
+ */
+#define STREAM_SEND_MAX 536
+
+struct zsock {
+	/* Used by the fifo of the listening socket, until accepted */
+	void *fifo_reserved;
+	struct net_context *ctx;
+	/* Received buffers, or the sockets of the established connections
+	 * for a listening socket.
+	 */
+	struct k_fifo recv_q;
+	/* Buffer partly read from a stream */
+	struct net_buf *rx;
+	/* Raised at the end of the stream */
+	struct k_poll_signal eof;
+	int32_t rcvtimeo;
+	bool listening;
+	bool in_use;
+};
+
+static struct zsock sockets[NUM_SOCKETS];
+
+#define SET_ERRNO(err) do { errno = (err); return -1; } while (0)
+
+static struct zsock *zsock_alloc(void)
+{
+	struct zsock *sock = NULL;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < NUM_SOCKETS; i++) {
+		if (!sockets[i].in_use) {
+			sock = &sockets[i];
+			sock->in_use = true;
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (!sock) {
+		return NULL;
+	}
+
+	sock->ctx = NULL;
+	sock->rx = NULL;
+	sock->rcvtimeo = K_FOREVER;
+	sock->listening = false;
+	k_fifo_init(&sock->recv_q);
+	k_poll_signal_init(&sock->eof);
+
+	return sock;
+}
+
+static void zsock_free(struct zsock *sock)
+{
+	struct net_buf *buf;
+	struct zsock *conn;
+
+	if (sock->listening) {
+		while ((conn = k_fifo_get(&sock->recv_q, K_NO_WAIT))) {
+			zsock_free(conn);
+		}
+	} else {
+		while ((buf = net_buf_get(&sock->recv_q, K_NO_WAIT))) {
+			net_nbuf_unref(buf);
+		}
+	}
+
+	if (sock->rx) {
+		net_nbuf_unref(sock->rx);
+	}
+
+	if (sock->ctx) {
+		net_context_put(sock->ctx);
+	}
+
+	sock->in_use = false;
+}
+
+static struct zsock *get_sock(int fd)
+{
+	if (fd < 0 || fd >= NUM_SOCKETS || !sockets[fd].in_use) {
+		return NULL;
+	}
+
+	return &sockets[fd];
+}
+
+static inline bool is_stream(struct zsock *sock)
+{
+	return net_context_get_type(sock->ctx) == SOCK_STREAM;
+}
+
+/* Called in the RX thread, the data is only queued */
+static void zsock_received(struct net_context *ctx, struct net_buf *buf,
+			   int status, void *user_data)
+{
+	struct zsock *sock = user_data;
+
+	if (!buf) {
+		/* End of the stream, or error */
+		k_poll_signal(&sock->eof, status);
+		return;
+	}
+
+	/* The data is not consumed until the application reads it */
+	if (is_stream(sock)) {
+		net_context_update_recv_wnd(ctx,
+					    -(int32_t)net_nbuf_appdatalen(buf));
+	}
+
+	net_buf_put(&sock->recv_q, buf);
+}
+
+static void zsock_accepted(struct net_context *ctx, struct sockaddr *addr,
+			   socklen_t addrlen, int status, void *user_data)
+{
+	struct zsock *listener = user_data;
+	struct zsock *sock;
+
+	if (status) {
+		return;
+	}
+
+	sock = zsock_alloc();
+	if (!sock) {
+		net_context_put(ctx);
+		return;
+	}
+
+	sock->ctx = ctx;
+
+	if (net_context_recv(ctx, zsock_received, K_NO_WAIT, sock) < 0) {
+		zsock_free(sock);
+		return;
+	}
+
+	k_fifo_put(&listener->recv_q, sock);
+}
+
+int zsock_socket(int family, int type, int proto)
+{
+	struct net_context *ctx;
+	struct zsock *sock;
+	int ret;
+
+	if (!proto) {
+		proto = type == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP;
+	}
+
+	sock = zsock_alloc();
+	if (!sock) {
+		SET_ERRNO(ENFILE);
+	}
+
+	ret = net_context_get(family, type, proto, &ctx);
+	if (ret < 0) {
+		zsock_free(sock);
+		SET_ERRNO(-ret);
+	}
+
+	sock->ctx = ctx;
+
+	return sock - sockets;
+}
+
+int zsock_close(int fd)
+{
+	struct zsock *sock = get_sock(fd);
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	zsock_free(sock);
+
+	return 0;
+}
+
+int zsock_bind(int fd, const struct sockaddr *addr, socklen_t addrlen)
+{
+	struct zsock *sock = get_sock(fd);
+	int ret;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	ret = net_context_bind(sock->ctx, addr, addrlen);
+	if (ret < 0) {
+		SET_ERRNO(-ret);
+	}
+
+	/* Datagrams can come from anybody, from now on */
+	if (!is_stream(sock)) {
+		ret = net_context_recv(sock->ctx, zsock_received, K_NO_WAIT,
+				       sock);
+		if (ret < 0) {
+			SET_ERRNO(-ret);
+		}
+	}
+
+	return 0;
+}
+
+int zsock_connect(int fd, const struct sockaddr *addr, socklen_t addrlen)
+{
+	struct zsock *sock = get_sock(fd);
+	int ret;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	ret = net_context_connect(sock->ctx, addr, addrlen, NULL,
+				  CONFIG_NET_SOCKETS_CONNECT_TIMEOUT, NULL);
+	if (ret < 0) {
+		SET_ERRNO(-ret);
+	}
+
+	ret = net_context_recv(sock->ctx, zsock_received, K_NO_WAIT, sock);
+	if (ret < 0) {
+		SET_ERRNO(-ret);
+	}
+
+	return 0;
+}
+
+int zsock_listen(int fd, int backlog)
+{
+	struct zsock *sock = get_sock(fd);
+	int ret;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	ret = net_context_listen(sock->ctx, backlog);
+	if (ret < 0) {
+		SET_ERRNO(-ret);
+	}
+
+	sock->listening = true;
+
+	ret = net_context_accept(sock->ctx, zsock_accepted, K_NO_WAIT, sock);
+	if (ret < 0) {
+		sock->listening = false;
+		SET_ERRNO(-ret);
+	}
+
+	return 0;
+}
+
+static void get_peer(struct net_context *ctx, struct sockaddr *addr,
+		     socklen_t *addrlen)
+{
+	socklen_t len;
+
+	if (!addr || !addrlen) {
+		return;
+	}
+
+	len = min(*addrlen, sizeof(ctx->remote));
+	memcpy(addr, &ctx->remote, len);
+
+	*addrlen = net_context_get_family(ctx) == AF_INET6 ?
+		sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+}
+
+int zsock_accept(int fd, struct sockaddr *addr, socklen_t *addrlen)
+{
+	struct zsock *sock = get_sock(fd);
+	struct zsock *conn;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	if (!sock->listening) {
+		SET_ERRNO(EINVAL);
+	}
+
+	conn = k_fifo_get(&sock->recv_q, sock->rcvtimeo);
+	if (!conn) {
+		SET_ERRNO(EAGAIN);
+	}
+
+	get_peer(conn->ctx, addr, addrlen);
+
+	return conn - sockets;
+}
+
+ssize_t zsock_sendto(int fd, const void *data, size_t len, int flags,
+		     const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct zsock *sock = get_sock(fd);
+	int32_t timeout = K_FOREVER;
+	struct net_buf *buf;
+	int ret;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	if (flags & ZSOCK_MSG_DONTWAIT) {
+		timeout = K_NO_WAIT;
+	}
+
+	if (is_stream(sock)) {
+		len = min(len, STREAM_SEND_MAX);
+	}
+
+	buf = net_nbuf_get_tx(sock->ctx, timeout);
+	if (!buf) {
+		SET_ERRNO(EAGAIN);
+	}
+
+	if (!net_nbuf_append(buf, len, data, timeout)) {
+		net_nbuf_unref(buf);
+		SET_ERRNO(EAGAIN);
+	}
+
+	if (dest_addr && !is_stream(sock)) {
+		ret = net_context_sendto(buf, dest_addr, addrlen, NULL,
+					 timeout, NULL, NULL);
+	} else {
+		ret = net_context_send(buf, NULL, timeout, NULL, NULL);
+	}
+
+	if (ret < 0) {
+		net_nbuf_unref(buf);
+		SET_ERRNO(-ret);
+	}
+
+	return len;
+}
+
+ssize_t zsock_send(int fd, const void *data, size_t len, int flags)
+{
+	return zsock_sendto(fd, data, len, flags, NULL, 0);
+}
+
+/* Copy up to len bytes from the fragments of buf, removing them, and
+ * return their number.
+ */
+static size_t rx_consume(struct net_buf *buf, uint8_t *data, size_t len)
+{
+	size_t copied = 0;
+
+	while (buf->frags && copied < len) {
+		struct net_buf *frag = buf->frags;
+		size_t n = min(frag->len, len - copied);
+
+		if (data) {
+			memcpy(data + copied, frag->data, n);
+		}
+
+		net_buf_pull(frag, n);
+		copied += n;
+
+		if (!frag->len) {
+			net_buf_frag_del(buf, frag);
+		}
+	}
+
+	return copied;
+}
+
+static void get_source(struct net_buf *buf, struct sockaddr *addr,
+		       socklen_t *addrlen)
+{
+	if (!addr || !addrlen) {
+		return;
+	}
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_nbuf_family(buf) == AF_INET6 &&
+	    *addrlen >= sizeof(struct sockaddr_in6)) {
+		struct sockaddr_in6 *addr6 = net_sin6(addr);
+
+		addr6->sin6_family = AF_INET6;
+		net_ipaddr_copy(&addr6->sin6_addr, &NET_IPV6_BUF(buf)->src);
+		addr6->sin6_port = NET_UDP_BUF(buf)->src_port;
+		*addrlen = sizeof(struct sockaddr_in6);
+		return;
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_nbuf_family(buf) == AF_INET &&
+	    *addrlen >= sizeof(struct sockaddr_in)) {
+		struct sockaddr_in *addr4 = net_sin(addr);
+
+		addr4->sin_family = AF_INET;
+		net_ipaddr_copy(&addr4->sin_addr, &NET_IPV4_BUF(buf)->src);
+		addr4->sin_port = NET_UDP_BUF(buf)->src_port;
+		*addrlen = sizeof(struct sockaddr_in);
+		return;
+	}
+#endif
+
+	*addrlen = 0;
+}
+
+/* Get the next received buffer, with the application data only. NULL is
+ * returned with errno 0 at the end of the stream.
+ */
+static struct net_buf *rx_get(struct zsock *sock, int flags,
+			      struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct k_poll_event events[2];
+	int32_t timeout = sock->rcvtimeo;
+	struct net_buf *buf;
+	size_t hdr_len;
+
+	if (sock->rx) {
+		buf = sock->rx;
+		sock->rx = NULL;
+		return buf;
+	}
+
+	if (flags & ZSOCK_MSG_DONTWAIT) {
+		timeout = K_NO_WAIT;
+	}
+
+	k_poll_event_init(&events[0], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &sock->recv_q);
+	k_poll_event_init(&events[1], K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &sock->eof);
+
+	/* Buffers received before the end of the stream are read first */
+	while (!(buf = net_buf_get(&sock->recv_q, K_NO_WAIT))) {
+		if (sock->eof.signaled) {
+			errno = sock->eof.result < 0 ? -sock->eof.result : 0;
+			return NULL;
+		}
+
+		if (k_poll(events, ARRAY_SIZE(events), timeout)) {
+			errno = EAGAIN;
+			return NULL;
+		}
+
+		events[0].state = K_POLL_STATE_NOT_READY;
+		events[1].state = K_POLL_STATE_NOT_READY;
+	}
+
+	if (is_stream(sock)) {
+		get_peer(sock->ctx, src_addr, addrlen);
+	} else {
+		get_source(buf, src_addr, addrlen);
+	}
+
+	hdr_len = net_buf_frags_len(buf->frags) - net_nbuf_appdatalen(buf);
+	rx_consume(buf, NULL, hdr_len);
+
+	return buf;
+}
+
+static void rx_done(struct zsock *sock, size_t len)
+{
+	if (is_stream(sock) && len) {
+		net_context_update_recv_wnd(sock->ctx, len);
+	}
+}
+
+ssize_t zsock_recvfrom(int fd, void *data, size_t max_len, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct zsock *sock = get_sock(fd);
+	struct net_buf *buf;
+	size_t len;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	buf = rx_get(sock, flags, src_addr, addrlen);
+	if (!buf) {
+		return errno ? -1 : 0;
+	}
+
+	len = rx_consume(buf, data, max_len);
+
+	if (is_stream(sock) && buf->frags) {
+		sock->rx = buf;
+	} else {
+		net_nbuf_unref(buf);
+	}
+
+	rx_done(sock, len);
+
+	return len;
+}
+
+ssize_t zsock_recv(int fd, void *data, size_t max_len, int flags)
+{
+	return zsock_recvfrom(fd, data, max_len, flags, NULL, NULL);
+}
+
+int zsock_recv_nbuf(int fd, struct net_buf **buf, int flags)
+{
+	struct zsock *sock = get_sock(fd);
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	*buf = rx_get(sock, flags, NULL, NULL);
+	if (!*buf) {
+		return errno ? -1 : 0;
+	}
+
+	rx_done(sock, net_buf_frags_len((*buf)->frags));
+
+	return 0;
+}
+
+int zsock_recv_nbufs(int fd, struct net_buf **bufs, struct sockaddr *src_addrs,
+		     int max, int flags)
+{
+	struct zsock *sock = get_sock(fd);
+	int count;
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	if (max <= 0) {
+		SET_ERRNO(EINVAL);
+	}
+
+	/* Only the first buffer is waited for, the others are the ones
+	 * queued already.
+	 */
+	for (count = 0; count < max; count++) {
+		socklen_t addrlen = sizeof(struct sockaddr);
+		struct net_buf *buf;
+
+		buf = rx_get(sock, count ? ZSOCK_MSG_DONTWAIT : flags,
+			     src_addrs ? &src_addrs[count] : NULL, &addrlen);
+		if (!buf) {
+			break;
+		}
+
+		rx_done(sock, net_buf_frags_len(buf->frags));
+		bufs[count] = buf;
+	}
+
+	if (!count && errno) {
+		return -1;
+	}
+
+	return count;
+}
+
+int zsock_setsockopt(int fd, int level, int optname,
+		     const void *optval, socklen_t optlen)
+{
+	struct zsock *sock = get_sock(fd);
+
+	if (!sock) {
+		SET_ERRNO(EBADF);
+	}
+
+	if (level != ZSOCK_SOL_SOCKET || optname != ZSOCK_SO_RCVTIMEO) {
+		SET_ERRNO(ENOPROTOOPT);
+	}
+
+	if (optlen != sizeof(int32_t)) {
+		SET_ERRNO(EINVAL);
+	}
+
+	sock->rcvtimeo = *(const int32_t *)optval;
+
+	return 0;
+}
+
+static bool is_readable(struct zsock *sock)
+{
+	return sock->rx || !k_fifo_is_empty(&sock->recv_q) ||
+	       sock->eof.signaled;
+}
+
+/* Set the returned events, and return whether the socket is ready */
+static bool poll_check(struct zsock_pollfd *pfd)
+{
+	struct zsock *sock = get_sock(pfd->fd);
+
+	pfd->revents = 0;
+
+	if (!sock) {
+		pfd->revents = ZSOCK_POLLNVAL;
+		return true;
+	}
+
+	if ((pfd->events & ZSOCK_POLLIN) && is_readable(sock)) {
+		pfd->revents |= ZSOCK_POLLIN;
+	}
+
+	if (pfd->events & ZSOCK_POLLOUT) {
+		pfd->revents |= ZSOCK_POLLOUT;
+	}
+
+	if (sock->eof.signaled) {
+		pfd->revents |= sock->eof.result < 0 ?
+			ZSOCK_POLLERR : ZSOCK_POLLHUP;
+	}
+
+	return pfd->revents != 0;
+}
+
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	struct k_poll_event events[2 * CONFIG_NET_SOCKETS_POLL_MAX];
+	int num_events = 0;
+	int ready = 0;
+	int i;
+
+	if (nfds > CONFIG_NET_SOCKETS_POLL_MAX) {
+		SET_ERRNO(ENOMEM);
+	}
+
+	for (i = 0; i < nfds; i++) {
+		struct zsock *sock;
+
+		if (poll_check(&fds[i])) {
+			ready++;
+			continue;
+		}
+
+		sock = get_sock(fds[i].fd);
+		if (!(fds[i].events & ZSOCK_POLLIN)) {
+			continue;
+		}
+
+		k_poll_event_init(&events[num_events++],
+				  K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sock->recv_q);
+		k_poll_event_init(&events[num_events++], K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &sock->eof);
+	}
+
+	if (ready || !num_events || timeout == K_NO_WAIT) {
+		return ready;
+	}
+
+	if (k_poll(events, num_events, timeout)) {
+		return 0;
+	}
+
+	for (i = 0; i < nfds; i++) {
+		if (poll_check(&fds[i])) {
+			ready++;
+		}
+	}
+
+	return ready;
+}
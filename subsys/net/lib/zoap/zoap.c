@@ -151,9 +151,15 @@ static int coap_parse_options(struct zoap_packet *pkt, unsigned int offset)
 		.buflen = frag->len - offset,
 		.buf = &appdata[offset] };
 
+	pkt->indexed = true;
+
 	while (true) {
-		int r = coap_parse_option(pkt, &context, NULL, NULL);
+		struct zoap_option_index *option;
+		uint8_t *value;
+		uint16_t len;
+		int r;
 
+		r = coap_parse_option(pkt, &context, &value, &len);
 		if (r < 0) {
 			return -EINVAL;
 		}
@@ -161,6 +167,16 @@ static int coap_parse_options(struct zoap_packet *pkt, unsigned int offset)
 		if (r == 0) {
 			break;
 		}
+
+		if (pkt->options_count == CONFIG_ZOAP_PACKET_OPTIONS) {
+			pkt->indexed = false;
+			continue;
+		}
+
+		option = &pkt->options[pkt->options_count++];
+		option->code = context.delta;
+		option->offset = value - appdata;
+		option->len = len;
 	}
 	return context.used;
 }
@@ -208,8 +224,11 @@ int zoap_packet_parse(struct zoap_packet *pkt, struct net_buf *buf)
 		return -EINVAL;
 	}
 
-	memset(pkt, 0, sizeof(*pkt));
 	pkt->buf = buf;
+	pkt->start = NULL;
+	pkt->total_size = 0;
+	pkt->options_count = 0;
+	pkt->indexed = false;
 
 	hdrlen = coap_get_header_len(pkt);
 	if (hdrlen < 0) {
@@ -218,6 +237,7 @@ int zoap_packet_parse(struct zoap_packet *pkt, struct net_buf *buf)
 
 	optlen = coap_parse_options(pkt, hdrlen);
 	if (optlen < 0) {
+		pkt->indexed = false;
 		return -EINVAL;
 	}
 
@@ -493,19 +513,65 @@ void zoap_pending_clear(struct zoap_pending *pending)
 	pending->buf = NULL;
 }
 
-static bool uri_path_eq(const struct zoap_packet *pkt,
-			const char * const *path)
+/* FNV-1a, over the length and the bytes of each segment */
+#define PATH_HASH_INIT 2166136261U
+
+static uint32_t path_hash_add(uint32_t hash, const uint8_t *segment,
+			      size_t len)
 {
-	struct zoap_option options[16];
-	uint16_t count = 16;
-	int i, r;
+	size_t i;
 
-	r = zoap_find_options(pkt, ZOAP_OPTION_URI_PATH, options, count);
-	if (r < 0) {
-		return false;
+	hash = (hash ^ (len & 0xff)) * 16777619U;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ segment[i]) * 16777619U;
 	}
 
-	count = r;
+	return hash;
+}
+
+/* 0 is kept to tell a resource hash is not computed yet */
+static uint32_t path_hash_end(uint32_t hash)
+{
+	return hash ? hash : 1;
+}
+
+static uint32_t resource_path_hash(struct zoap_resource *resource)
+{
+	uint32_t hash = PATH_HASH_INIT;
+	int i;
+
+	if (resource->path_hash) {
+		return resource->path_hash;
+	}
+
+	for (i = 0; resource->path[i]; i++) {
+		hash = path_hash_add(hash, (const uint8_t *)resource->path[i],
+				     strlen(resource->path[i]));
+	}
+
+	resource->path_hash = path_hash_end(hash);
+
+	return resource->path_hash;
+}
+
+static uint32_t options_path_hash(const struct zoap_option *options,
+				  uint16_t count)
+{
+	uint32_t hash = PATH_HASH_INIT;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		hash = path_hash_add(hash, options[i].value, options[i].len);
+	}
+
+	return path_hash_end(hash);
+}
+
+static bool uri_path_eq(const struct zoap_option *options, uint16_t count,
+			const char * const *path)
+{
+	int i;
 
 	for (i = 0; i < count && path[i]; i++) {
 		size_t len;
@@ -552,18 +618,33 @@ int zoap_handle_request(struct zoap_packet *pkt,
 			struct zoap_resource *resources,
 			const struct sockaddr *from)
 {
+	struct zoap_option options[16];
 	struct zoap_resource *resource;
+	uint32_t hash;
+	int count;
 
 	if (!is_request(pkt)) {
 		return 0;
 	}
 
+	/* The request path is only looked up once, then compared through
+	 * its hash first.
+	 */
+	count = zoap_find_options(pkt, ZOAP_OPTION_URI_PATH, options,
+				  ARRAY_SIZE(options));
+	if (count < 0) {
+		return -ENOENT;
+	}
+
+	hash = options_path_hash(options, count);
+
 	for (resource = resources; resource && resource->path; resource++) {
 		zoap_method_t method;
 		uint8_t code;
 
 		/* FIXME: deal with hierarchical resources */
-		if (!uri_path_eq(pkt, resource->path)) {
+		if (resource_path_hash(resource) != hash ||
+		    !uri_path_eq(options, count, resource->path)) {
 			continue;
 		}
 
@@ -703,6 +784,81 @@ int zoap_resource_notify(struct zoap_resource *resource)
 	return 0;
 }
 
+int zoap_notification_init(struct zoap_packet *pkt, struct net_buf *buf,
+			   struct zoap_resource *resource)
+{
+	int r;
+
+	r = zoap_packet_init(pkt, buf);
+	if (r < 0) {
+		return r;
+	}
+
+	zoap_header_set_version(pkt, COAP_VERSION);
+	zoap_header_set_type(pkt, ZOAP_TYPE_CON);
+	zoap_header_set_code(pkt, ZOAP_RESPONSE_CODE_CONTENT);
+
+	resource->age++;
+
+	return zoap_add_option_int(pkt, ZOAP_OPTION_OBSERVE, resource->age);
+}
+
+int zoap_resource_notify_shared(struct zoap_resource *resource,
+				struct zoap_packet *pkt,
+				zoap_notify_send_t send, void *user_data)
+{
+	struct zoap_notification notification;
+	struct net_buf *frag = pkt->buf->frags;
+	struct zoap_observer *o;
+
+	if (!send || coap_header_get_tkl(pkt)) {
+		return -EINVAL;
+	}
+
+	/* The message id and the token are given to each observer */
+	notification.ver_t = frag->data[0];
+	notification.code = frag->data[1];
+	notification.frag = frag;
+
+	net_buf_pull(frag, BASIC_HEADER_SIZE);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&resource->observers, o, list) {
+		send(resource, o, &notification, user_data);
+	}
+
+	return 0;
+}
+
+int zoap_notification_packet_init(struct zoap_packet *pkt,
+				  struct net_buf *buf,
+				  const struct zoap_notification *notification,
+				  const struct zoap_observer *observer,
+				  uint16_t id)
+{
+	struct net_buf *frag = buf->frags;
+	uint8_t *data;
+
+	if (!frag || frag->len ||
+	    net_buf_tailroom(frag) < BASIC_HEADER_SIZE + observer->tkl) {
+		return -ENOMEM;
+	}
+
+	data = net_buf_add(frag, BASIC_HEADER_SIZE + observer->tkl);
+
+	data[0] = notification->ver_t | observer->tkl;
+	data[1] = notification->code;
+	sys_put_be16(id, &data[2]);
+	memcpy(data + BASIC_HEADER_SIZE, observer->token, observer->tkl);
+
+	memset(pkt, 0, sizeof(*pkt));
+	pkt->buf = buf;
+	pkt->total_size = frag->len;
+
+	net_buf_frag_add(buf, net_buf_ref(notification->frag));
+
+	return 0;
+}
+
 bool zoap_request_is_observe(const struct zoap_packet *request)
 {
 	return get_observe_option(request) == 0;
@@ -905,6 +1061,7 @@ int zoap_add_option(struct zoap_packet *pkt, uint16_t code,
 	}
 
 	frag->len += r;
+	pkt->indexed = false;
 
 	return 0;
 }
@@ -935,6 +1092,32 @@ int zoap_add_option_int(struct zoap_packet *pkt, uint16_t code,
 	return zoap_add_option(pkt, code, data, len);
 }
 
+/* Options are sorted by code, so are they in the index */
+static int find_indexed_options(const struct zoap_packet *pkt, uint16_t code,
+				struct zoap_option *options, uint16_t veclen)
+{
+	uint8_t *data = pkt->buf->frags->data;
+	int i, count = 0;
+
+	for (i = 0; i < pkt->options_count && count < veclen; i++) {
+		const struct zoap_option_index *option = &pkt->options[i];
+
+		if (option->code > code) {
+			break;
+		}
+
+		if (option->code < code) {
+			continue;
+		}
+
+		options[count].value = data + option->offset;
+		options[count].len = option->len;
+		count++;
+	}
+
+	return count;
+}
+
 int zoap_find_options(const struct zoap_packet *pkt, uint16_t code,
 		      struct zoap_option *options, uint16_t veclen)
 {
@@ -944,6 +1127,10 @@ int zoap_find_options(const struct zoap_packet *pkt, uint16_t code,
 	int hdrlen, count = 0;
 	uint16_t len;
 
+	if (pkt->indexed) {
+		return find_indexed_options(pkt, code, options, veclen);
+	}
+
 	hdrlen = coap_get_header_len(pkt);
 	if (hdrlen < 0) {
 		return -EINVAL;
@@ -1101,6 +1288,7 @@ int zoap_header_set_token(struct zoap_packet *pkt, const uint8_t *token,
 	}
 
 	frag->len += tokenlen;
+	pkt->indexed = false;
 
 	appdata[0] |= tokenlen & 0xF;
 
@@ -67,6 +67,44 @@ static int shell_cmd_tasks(int argc, char *argv[])
 }
 #endif
 
+#if defined(CONFIG_OBJECT_TRACING) && defined(CONFIG_THREAD_MONITOR) && \
+	defined(CONFIG_THREAD_RUNTIME_STATS)
+static void print_runtime(const char *prefix, void *id,
+			  struct k_thread_runtime_stats *stats, uint64_t total)
+{
+	/* printk() has no 64-bit conversions: print thousands of cycles */
+	printk("%s%p:   %u kcycles (%u%%)\n", prefix, id,
+	       (uint32_t)(stats->execution_cycles / 1000),
+	       (uint32_t)(total ? stats->execution_cycles * 100 / total : 0));
+}
+
+static int shell_cmd_runtime(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	struct k_thread *thread_list = NULL;
+	struct k_thread_runtime_stats stats;
+	uint64_t total;
+
+	k_thread_runtime_stats_all_get(&stats);
+	total = stats.execution_cycles;
+
+	printk("runtime:\n");
+
+	thread_list   = (struct k_thread *)SYS_THREAD_MONITOR_HEAD;
+	while (thread_list != NULL) {
+		k_thread_runtime_stats_get(thread_list, &stats);
+		print_runtime((thread_list == k_current_get()) ? "*" : " ",
+			      thread_list, &stats, total);
+		thread_list = (struct k_thread *)SYS_THREAD_MONITOR_NEXT(thread_list);
+	}
+
+	k_isr_runtime_stats_get(&stats);
+	print_runtime(" isr ", NULL, &stats, total);
+
+	return 0;
+}
+#endif
 
 #if defined(CONFIG_INIT_STACKS)
 static int shell_cmd_stack(int argc, char *argv[])
@@ -83,6 +121,10 @@ struct shell_cmd kernel_commands[] = {
 #if defined(CONFIG_OBJECT_TRACING) && defined(CONFIG_THREAD_MONITOR)
 	{ "tasks", shell_cmd_tasks, "show running tasks" },
 #endif
+#if defined(CONFIG_OBJECT_TRACING) && defined(CONFIG_THREAD_MONITOR) && \
+	defined(CONFIG_THREAD_RUNTIME_STATS)
+	{ "runtime", shell_cmd_runtime, "show run time of tasks" },
+#endif
 #if defined(CONFIG_INIT_STACKS)
 	{ "stacks", shell_cmd_stack, "show system stacks" },
 #endif
@@ -55,6 +55,47 @@ static struct k_fifo cmds_queue;
 static shell_cmd_function_t app_cmd_handler;
 static shell_prompt_function_t app_prompt_handler;
 
+#if CONFIG_CONSOLE_SHELL_HASH_SIZE > 0
+/* Index of the modules and of their commands, by hash of their names */
+struct shell_hash_entry {
+	/* -1 if the slot is free */
+	int16_t module;
+	/* -1 for the module name itself */
+	int16_t cmd;
+};
+
+static struct shell_hash_entry shell_hash[CONFIG_CONSOLE_SHELL_HASH_SIZE];
+/* Set if not everything fit, the tables are then gone through instead */
+static bool shell_hash_full;
+#endif
+
+#ifdef CONFIG_CONSOLE_SHELL_WORKQUEUE
+static char __stack work_q_stack[CONFIG_CONSOLE_SHELL_WORKQUEUE_STACKSIZE];
+static struct k_work_q shell_work_q;
+
+/* Command line run by the work queue, one per input line buffer */
+struct shell_job {
+	struct k_work work;
+	struct console_input *cmd;
+};
+
+static struct shell_job jobs[MAX_CMD_QUEUED];
+#endif
+
+#if CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE > 0
+/* Output of the commands, written by the console driver from a thread
+ * of its own for the commands not to wait for it.
+ */
+static char out_buf[CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE];
+static size_t out_head;
+static size_t out_len;
+static int (*out_console)(int);
+/* Thread running a command, the only one buffering its output */
+static k_tid_t out_thread;
+static struct k_sem out_sem;
+static char __stack out_stack[CONFIG_CONSOLE_SHELL_OUTPUT_STACKSIZE];
+#endif
+
 static const char *get_prompt(void)
 {
 	if (app_prompt_handler) {
@@ -125,10 +166,112 @@ static size_t line2argv(char *str, char *argv[], size_t size)
 	return argc;
 }
 
+#if CONFIG_CONSOLE_SHELL_HASH_SIZE > 0
+static uint32_t hash_str(const char *str, int seed)
+{
+	uint32_t hash = 5381 + seed;
+	int i;
+
+	/* Module names only count up to MODULE_NAME_MAX_LEN characters */
+	for (i = 0; str[i] && i < MODULE_NAME_MAX_LEN; i++) {
+		hash = hash * 33 + (uint8_t)str[i];
+	}
+
+	return hash % CONFIG_CONSOLE_SHELL_HASH_SIZE;
+}
+
+static void hash_add(int module, int cmd)
+{
+	const struct shell_module *shell_module = &__shell_cmd_start[module];
+	const char *name;
+	uint32_t i, slot;
+
+	name = (cmd < 0) ? shell_module->module_name :
+			   shell_module->commands[cmd].cmd_name;
+	slot = hash_str(name, (cmd < 0) ? 0 : module + 1);
+
+	/* The first one added is found first, as with the tables */
+	for (i = 0; i < ARRAY_SIZE(shell_hash); i++) {
+		if (shell_hash[slot].module < 0) {
+			shell_hash[slot].module = module;
+			shell_hash[slot].cmd = cmd;
+			return;
+		}
+
+		slot = (slot + 1) % ARRAY_SIZE(shell_hash);
+	}
+
+	shell_hash_full = true;
+}
+
+static void hash_init(void)
+{
+	int module, cmd;
+
+	for (cmd = 0; cmd < ARRAY_SIZE(shell_hash); cmd++) {
+		shell_hash[cmd].module = -1;
+	}
+
+	for (module = 0; module < NUM_OF_SHELL_ENTITIES; module++) {
+		hash_add(module, -1);
+
+		for (cmd = 0; __shell_cmd_start[module].commands[cmd].cmd_name;
+		     cmd++) {
+			hash_add(module, cmd);
+		}
+	}
+}
+
+/* Module names are hashed with a seed of 0, commands with the one of
+ * their module, for a module lookup to only compare module names.
+ */
+static int hash_find(int module, const char *name)
+{
+	const struct shell_hash_entry *entry;
+	const struct shell_module *shell_module;
+	const struct shell_cmd *cmd;
+	uint32_t i, slot;
+
+	slot = hash_str(name, (module < 0) ? 0 : module + 1);
+
+	for (i = 0; i < ARRAY_SIZE(shell_hash); i++) {
+		entry = &shell_hash[slot];
+		if (entry->module < 0) {
+			break;
+		}
+
+		shell_module = &__shell_cmd_start[entry->module];
+
+		if (module < 0) {
+			if (entry->cmd < 0 &&
+			    !strncmp(name, shell_module->module_name,
+				     MODULE_NAME_MAX_LEN)) {
+				return entry->module;
+			}
+		} else if (entry->module == module && entry->cmd >= 0) {
+			cmd = &shell_module->commands[entry->cmd];
+			if (!strcmp(name, cmd->cmd_name)) {
+				return entry->cmd;
+			}
+		}
+
+		slot = (slot + 1) % ARRAY_SIZE(shell_hash);
+	}
+
+	return -1;
+}
+#endif /* CONFIG_CONSOLE_SHELL_HASH_SIZE > 0 */
+
 static int get_destination_module(const char *module_str)
 {
 	int i;
 
+#if CONFIG_CONSOLE_SHELL_HASH_SIZE > 0
+	if (!shell_hash_full) {
+		return hash_find(-1, module_str);
+	}
+#endif
+
 	for (i = 0; i < NUM_OF_SHELL_ENTITIES; i++) {
 		if (!strncmp(module_str,
 			     __shell_cmd_start[i].module_name,
@@ -140,6 +283,27 @@ static int get_destination_module(const char *module_str)
 	return -1;
 }
 
+static const struct shell_cmd *get_command(int module, const char *name)
+{
+	const struct shell_module *shell_module = &__shell_cmd_start[module];
+	int i;
+
+#if CONFIG_CONSOLE_SHELL_HASH_SIZE > 0
+	if (!shell_hash_full) {
+		i = hash_find(module, name);
+		return (i < 0) ? NULL : &shell_module->commands[i];
+	}
+#endif
+
+	for (i = 0; shell_module->commands[i].cmd_name; i++) {
+		if (!strcmp(name, shell_module->commands[i].cmd_name)) {
+			return &shell_module->commands[i];
+		}
+	}
+
+	return NULL;
+}
+
 /* For a specific command: argv[0] = module name, argv[1] = command name
  * If a default module was selected: argv[0] = command name
  */
@@ -175,23 +339,17 @@ static int show_cmd_help(char *argv[])
 {
 	const char *command = NULL;
 	int module = -1;
-	const struct shell_module *shell_module;
-	int i;
+	const struct shell_cmd *cmd;
 
 	command = get_command_and_module(argv, &module);
 	if ((module == -1) || (command == NULL)) {
 		return 0;
 	}
 
-	shell_module = &__shell_cmd_start[module];
-	for (i = 0; shell_module->commands[i].cmd_name; i++) {
-		if (!strcmp(command, shell_module->commands[i].cmd_name)) {
-			printk("%s %s\n",
-			       shell_module->commands[i].cmd_name,
-			       shell_module->commands[i].help ?
-			       shell_module->commands[i].help : "");
-			return 0;
-		}
+	cmd = get_command(module, command);
+	if (cmd) {
+		printk("%s %s\n", cmd->cmd_name, cmd->help ? cmd->help : "");
+		return 0;
 	}
 
 	printk("Unrecognized command: %s\n", argv[0]);
@@ -283,9 +441,8 @@ static shell_cmd_function_t get_cb(int argc, char *argv[])
 {
 	const char *first_string = argv[0];
 	int module = -1;
-	const struct shell_module *shell_module;
+	const struct shell_cmd *cmd;
 	const char *command;
-	int i;
 
 	if (!first_string || first_string[0] == '\0') {
 		printk("Illegal parameter\n");
@@ -310,14 +467,9 @@ static shell_cmd_function_t get_cb(int argc, char *argv[])
 		return NULL;
 	}
 
-	shell_module = &__shell_cmd_start[module];
-	for (i = 0; shell_module->commands[i].cmd_name; i++) {
-		if (!strcmp(command, shell_module->commands[i].cmd_name)) {
-			return shell_module->commands[i].cb;
-		}
-	}
+	cmd = get_command(module, command);
 
-	return NULL;
+	return cmd ? cmd->cb : NULL;
 }
 
 static inline void print_cmd_unknown(char *argv)
@@ -326,46 +478,173 @@ static inline void print_cmd_unknown(char *argv)
 	printk("Type 'help' for list of available commands\n");
 }
 
-static void shell(void *p1, void *p2, void *p3)
+#if CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE > 0
+extern void __printk_hook_install(int (*fn)(int));
+extern void *__printk_get_hook(void);
+
+/* Called with interrupts locked */
+static void out_pop(void)
+{
+	char c = out_buf[out_head];
+
+	out_head = (out_head + 1) % sizeof(out_buf);
+	out_len--;
+
+	out_console(c);
+}
+
+/* Interrupts are let in between characters, the console driver can
+ * be slow to take them.
+ */
+static void out_flush(void)
+{
+	unsigned int key;
+
+	key = irq_lock();
+
+	while (out_len) {
+		out_pop();
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+}
+
+static int out_char(int c)
+{
+	unsigned int key;
+
+	if (k_is_in_isr() || k_current_get() != out_thread) {
+		/* What the commands printed goes out first */
+		out_flush();
+		return out_console(c);
+	}
+
+	key = irq_lock();
+
+	/* Held up by the console once the buffer is full */
+	if (out_len == sizeof(out_buf)) {
+		out_pop();
+	}
+
+	out_buf[(out_head + out_len) % sizeof(out_buf)] = c;
+	out_len++;
+
+	irq_unlock(key);
+
+	k_sem_give(&out_sem);
+
+	return c;
+}
+
+static void out_drain(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&out_sem, K_FOREVER);
+		out_flush();
+	}
+}
+
+static void out_init(void)
+{
+	k_sem_init(&out_sem, 0, 1);
+
+	k_thread_spawn(out_stack, sizeof(out_stack), out_drain, NULL, NULL,
+		       NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	out_console = __printk_get_hook();
+	__printk_hook_install(out_char);
+}
+#endif /* CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE > 0 */
+
+static void shell_exec(struct console_input *cmd)
 {
 	char *argv[ARGC_MAX + 1];
+	shell_cmd_function_t cb;
 	size_t argc;
 
+#if CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE > 0
+	out_thread = k_current_get();
+#endif
+
+	argc = line2argv(cmd->line, argv, ARRAY_SIZE(argv));
+	if (!argc) {
+		goto done;
+	}
+
+	cb = get_cb(argc, argv);
+	if (!cb) {
+		if (app_cmd_handler != NULL) {
+			cb = app_cmd_handler;
+		} else {
+			print_cmd_unknown(argv[0]);
+			goto done;
+		}
+	}
+
+	/* Execute callback with arguments */
+	if (cb(argc, argv) < 0) {
+		show_cmd_help(argv);
+	}
+
+done:
+	k_fifo_put(&avail_queue, cmd);
+}
+
+#ifdef CONFIG_CONSOLE_SHELL_WORKQUEUE
+static void shell_job_run(struct k_work *work)
+{
+	struct shell_job *job = CONTAINER_OF(work, struct shell_job, work);
+
+	shell_exec(job->cmd);
+
+	printk("%s", get_prompt());
+}
+
+static void work_q_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(jobs); i++) {
+		k_work_init(&jobs[i].work, shell_job_run);
+	}
+
+	k_work_q_start(&shell_work_q, work_q_stack, sizeof(work_q_stack),
+		       CONFIG_CONSOLE_SHELL_WORKQUEUE_PRIORITY);
+}
+#endif
+
+static void shell(void *p1, void *p2, void *p3)
+{
 	ARG_UNUSED(p1);
 	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
+#ifdef CONFIG_CONSOLE_SHELL_WORKQUEUE
+	printk("%s", get_prompt());
+#endif
+
 	while (1) {
 		struct console_input *cmd;
-		shell_cmd_function_t cb;
 
+#ifndef CONFIG_CONSOLE_SHELL_WORKQUEUE
 		printk("%s", get_prompt());
+#endif
 
 		cmd = k_fifo_get(&cmds_queue, K_FOREVER);
 
-		argc = line2argv(cmd->line, argv, ARRAY_SIZE(argv));
-		if (!argc) {
-			k_fifo_put(&avail_queue, cmd);
-			continue;
-		}
-
-		cb = get_cb(argc, argv);
-		if (!cb) {
-			if (app_cmd_handler != NULL) {
-				cb = app_cmd_handler;
-			} else {
-				print_cmd_unknown(argv[0]);
-				k_fifo_put(&avail_queue, cmd);
-				continue;
-			}
-		}
-
-		/* Execute callback with arguments */
-		if (cb(argc, argv) < 0) {
-			show_cmd_help(argv);
-		}
-
-		k_fifo_put(&avail_queue, cmd);
+#ifdef CONFIG_CONSOLE_SHELL_WORKQUEUE
+		/* Run in order, the next lines are taken in the meantime */
+		jobs[cmd - buf].cmd = cmd;
+		k_work_submit_to_queue(&shell_work_q, &jobs[cmd - buf].work);
+#else
+		shell_exec(cmd);
+#endif
 	}
 }
 
@@ -522,6 +801,18 @@ void shell_init(const char *str)
 
 	prompt = str ? str : "";
 
+#if CONFIG_CONSOLE_SHELL_HASH_SIZE > 0
+	hash_init();
+#endif
+
+#ifdef CONFIG_CONSOLE_SHELL_WORKQUEUE
+	work_q_init();
+#endif
+
+#if CONFIG_CONSOLE_SHELL_OUTPUT_BUF_SIZE > 0
+	out_init();
+#endif
+
 	k_thread_spawn(stack, STACKSIZE, shell, NULL, NULL, NULL,
 		       K_PRIO_COOP(7), 0, K_NO_WAIT);
 
@@ -64,7 +64,10 @@ static struct uart_driver_api cdc_acm_driver_api;
 #define CDC_ACM_DEFAUL_BAUDRATE {sys_cpu_to_le32(115200), 0, 0, 8}
 
 /* Size of the internal buffer used for storing received data */
-#define CDC_ACM_BUFFER_SIZE (2 * CDC_BULK_EP_MPS)
+#define CDC_ACM_BUFFER_SIZE CONFIG_CDC_ACM_RX_BUF_SIZE
+
+/* Size of the internal buffer used for storing data to send */
+#define CDC_ACM_TX_BUFFER_SIZE CONFIG_CDC_ACM_TX_BUF_SIZE
 
 /* Misc. macros */
 #define LOW_BYTE(x)  ((x) & 0xFF)
@@ -88,6 +91,11 @@ struct cdc_acm_dev_data_t {
 	uint8_t rx_buf[CDC_ACM_BUFFER_SIZE];/* Internal Rx buffer */
 	uint32_t rx_buf_head;             /* Head of the internal Rx buffer */
 	uint32_t rx_buf_tail;             /* Tail of the internal Rx buffer */
+	uint8_t tx_buf[CDC_ACM_TX_BUFFER_SIZE];/* Internal Tx buffer */
+	uint32_t tx_buf_head;             /* Head of the internal Tx buffer */
+	uint32_t tx_buf_tail;             /* Tail of the internal Tx buffer */
+	uint8_t tx_busy;                  /* IN transfer in progress */
+	uint8_t tx_zlp;                   /* Last IN packet was a full one */
 	/* Interface data buffer */
 	uint8_t interface_data[CDC_CLASS_REQ_MAX_DATA_SIZE];
 	/* CDC ACM line coding properties. LE order */
@@ -295,6 +303,78 @@ int cdc_acm_class_handle_req(struct usb_setup_packet *pSetup,
 	return 0;
 }
 
+/**
+ * @brief Start an IN transfer of the buffered data
+ *
+ * Sends as much of the Tx buffer as the endpoint takes in one transfer of
+ * max packet size packets. Once the buffer is drained, a transfer that
+ * ended with a full packet is terminated by a zero length packet. To be
+ * called with interrupts locked.
+ *
+ * @param dev_data CDC ACM device data.
+ *
+ * @return N/A.
+ */
+static void cdc_acm_tx_start(struct cdc_acm_dev_data_t * const dev_data)
+{
+	uint32_t len, written = 0;
+
+	if (dev_data->tx_busy) {
+		return;
+	}
+
+	if (dev_data->tx_buf_head == dev_data->tx_buf_tail) {
+		if (dev_data->tx_zlp &&
+		    !usb_write(CDC_ENDP_IN, NULL, 0, NULL)) {
+			dev_data->tx_zlp = 0;
+			dev_data->tx_busy = 1;
+		}
+
+		return;
+	}
+
+	/* Contiguous data only, the rest goes with the next transfer */
+	if (dev_data->tx_buf_head > dev_data->tx_buf_tail) {
+		len = dev_data->tx_buf_head - dev_data->tx_buf_tail;
+	} else {
+		len = CDC_ACM_TX_BUFFER_SIZE - dev_data->tx_buf_tail;
+	}
+
+	/* Short packets are kept for the end of the data */
+	if (len > CDC_BULK_EP_MPS) {
+		len -= len % CDC_BULK_EP_MPS;
+	}
+
+	if (usb_write(CDC_ENDP_IN, &dev_data->tx_buf[dev_data->tx_buf_tail],
+		      len, &written) || !written) {
+		return;
+	}
+
+	dev_data->tx_buf_tail = (dev_data->tx_buf_tail + written) %
+				CDC_ACM_TX_BUFFER_SIZE;
+	dev_data->tx_zlp = !(written % CDC_BULK_EP_MPS);
+	dev_data->tx_busy = 1;
+}
+
+/**
+ * @brief Drop the buffered data, when the host is gone
+ *
+ * @param dev_data CDC ACM device data.
+ *
+ * @return N/A.
+ */
+static void cdc_acm_tx_reset(struct cdc_acm_dev_data_t * const dev_data)
+{
+	unsigned int key = irq_lock();
+
+	dev_data->tx_buf_head = 0;
+	dev_data->tx_buf_tail = 0;
+	dev_data->tx_busy = 0;
+	dev_data->tx_zlp = 0;
+
+	irq_unlock(key);
+}
+
 /**
  * @brief EP Bulk IN handler, used to send data to the Host
  *
@@ -307,9 +387,17 @@ static void cdc_acm_bulk_in(uint8_t ep, enum usb_dc_ep_cb_status_code ep_status)
 {
 	struct cdc_acm_dev_data_t * const dev_data = DEV_DATA(cdc_acm_dev);
 
+	unsigned int key;
+
 	ARG_UNUSED(ep_status);
 	ARG_UNUSED(ep);
 
+	/* The next transfer is started right away */
+	key = irq_lock();
+	dev_data->tx_busy = 0;
+	cdc_acm_tx_start(dev_data);
+	irq_unlock(key);
+
 	dev_data->tx_ready = 1;
 	k_sem_give(&poll_wait_sem);
 	/* Call callback only if tx irq ena */
@@ -411,6 +499,7 @@ static void cdc_acm_dev_status_cb(enum usb_dc_status_code status)
 		break;
 	case USB_DC_RESET:
 		SYS_LOG_DBG("USB device reset detected");
+		cdc_acm_tx_reset(dev_data);
 		break;
 	case USB_DC_CONNECTED:
 		SYS_LOG_DBG("USB device connected");
@@ -420,6 +509,7 @@ static void cdc_acm_dev_status_cb(enum usb_dc_status_code status)
 		break;
 	case USB_DC_DISCONNECTED:
 		SYS_LOG_DBG("USB device disconnected");
+		cdc_acm_tx_reset(dev_data);
 		break;
 	case USB_DC_SUSPEND:
 		SYS_LOG_DBG("USB device supended");
@@ -521,6 +611,9 @@ static int cdc_acm_init(struct device *dev)
 /**
  * @brief Fill FIFO with data
  *
+ * The data is copied to the Tx buffer, any amount of it being taken as
+ * long as there is room, and sent to the host in the background.
+ *
  * @param dev     CDC ACM device struct.
  * @param tx_data Data to transmit.
  * @param len     Number of bytes to send.
@@ -531,14 +624,38 @@ static int cdc_acm_fifo_fill(struct device *dev,
 			     const uint8_t *tx_data, int len)
 {
 	struct cdc_acm_dev_data_t * const dev_data = DEV_DATA(dev);
-	uint32_t bytes_written = 0;
+	uint32_t space, chunk, head;
+	unsigned int key;
+	int bytes_written = 0;
 
 	if (dev_data->usb_status != USB_DC_CONFIGURED) {
 		return 0;
 	}
 
 	dev_data->tx_ready = 0;
-	usb_write(CDC_ENDP_IN, tx_data, len, &bytes_written);
+
+	key = irq_lock();
+
+	head = dev_data->tx_buf_head;
+	space = (CDC_ACM_TX_BUFFER_SIZE + dev_data->tx_buf_tail - head - 1) %
+		CDC_ACM_TX_BUFFER_SIZE;
+
+	while (bytes_written < len && space) {
+		chunk = min(len - bytes_written, space);
+		chunk = min(chunk, CDC_ACM_TX_BUFFER_SIZE - head);
+
+		memcpy(&dev_data->tx_buf[head], tx_data + bytes_written,
+		       chunk);
+
+		head = (head + chunk) % CDC_ACM_TX_BUFFER_SIZE;
+		space -= chunk;
+		bytes_written += chunk;
+	}
+
+	dev_data->tx_buf_head = head;
+	cdc_acm_tx_start(dev_data);
+
+	irq_unlock(key);
 
 	return bytes_written;
 }
@@ -863,15 +980,19 @@ static int cdc_acm_poll_in(struct device *dev, unsigned char *c)
  * @brief Output a character in polled mode.
  *
  * The UART poll method for USB UART is simulated by waiting till
- * we get the next BULK In upcall from the USB device controller or 100 ms.
+ * we get the next BULK In upcall from the USB device controller or 100 ms
+ * when the Tx buffer is full.
  *
  * @return the same character which is sent
  */
 static unsigned char cdc_acm_poll_out(struct device *dev,
 				      unsigned char c)
 {
-	cdc_acm_fifo_fill(dev, &c, 1);
-	k_sem_take(&poll_wait_sem, K_MSEC(100));
+	while (!cdc_acm_fifo_fill(dev, &c, 1)) {
+		if (k_sem_take(&poll_wait_sem, K_MSEC(100))) {
+			break;
+		}
+	}
 
 	return c;
 }
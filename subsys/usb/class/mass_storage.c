@@ -56,12 +56,44 @@
 #define DISK_THREAD_STACK_SZ	512
 #define DISK_THREAD_PRIO	-5
 
-static volatile int thread_op;
+/* Size of each of the disk buffers */
+#define BUF_SIZE	(CONFIG_MASS_STORAGE_BUF_BLOCKS * BLOCK_SIZE)
+
 static char __stack mass_thread_stack[DISK_THREAD_STACK_SZ];
 static struct k_sem disk_wait_sem;
-static volatile uint32_t defered_wr_sz;
 
-static uint8_t page[BLOCK_SIZE];
+/*
+ * Disk buffers, one of them going over USB while the disk thread reads the
+ * next blocks to it or writes the previous ones from it.
+ */
+static uint8_t page[2][BUF_SIZE];
+
+/* Reading: buffer sent by bulk IN, offset in it, and bytes read to them */
+static uint8_t rd_cur;
+static uint32_t rd_off;
+static uint32_t rd_len[2];
+/* Disk thread: buffer to read to, disk address and bytes left to read */
+static uint8_t rd_fill;
+static uint32_t rd_addr;
+static uint32_t rd_left;
+/* Bulk IN waits for the buffer being read */
+static bool rd_wait;
+/* Tells reads of a previous command apart */
+static uint32_t rd_seq;
+
+/* Writing: buffer filled by bulk OUT and offset in it */
+static uint8_t wr_cur;
+static uint32_t wr_off;
+static uint32_t wr_addr;
+/* Bytes and first block to write from the buffers */
+static uint32_t wr_len[2];
+static uint32_t wr_blk[2];
+/* Disk thread: buffer to write from */
+static uint8_t wr_flush;
+/* Bulk OUT is NAKed until a buffer is free, CSW sent once all written */
+static bool wr_nak;
+static bool wr_csw;
+static bool wr_err;
 
 /* Initialized during mass_storage_init() */
 static uint32_t memory_size;
@@ -206,6 +238,11 @@ static void msd_init(void)
 	memset(page, 0, sizeof(page));
 	addr = 0;
 	length = 0;
+	rd_left = 0;
+	rd_len[0] = rd_len[1] = 0;
+	wr_len[0] = wr_len[1] = 0;
+	wr_nak = false;
+	wr_csw = false;
 }
 
 static void sendCSW(void)
@@ -382,8 +419,26 @@ static bool readCapacity(void)
 	return true;
 }
 
-static void thread_memory_read_done(void)
+/* Starts reading the blocks of a READ command ahead of bulk IN */
+static void memoryReadStart(void)
+{
+	unsigned int key = irq_lock();
+
+	rd_seq++;
+	rd_cur = 0;
+	rd_off = 0;
+	rd_len[0] = rd_len[1] = 0;
+	rd_fill = 0;
+	rd_addr = addr;
+	rd_left = (addr < memory_size) ? min(length, memory_size - addr) : 0;
+	rd_wait = false;
+
+	irq_unlock(key);
+}
+
+static void memoryRead(void)
 {
+	unsigned int key;
 	uint32_t n;
 
 	n = (length > MAX_PACKET) ? MAX_PACKET : length;
@@ -392,42 +447,41 @@ static void thread_memory_read_done(void)
 		stage = ERROR;
 	}
 
-	if (usb_write(EPBULK_IN, &page[addr % BLOCK_SIZE], n, NULL) != 0) {
-		SYS_LOG_ERR("usb write failure");
-	}
-	addr += n;
-	length -= n;
-
-	csw.DataResidue -= n;
-
-	if (!length || (stage != PROCESS_CBW)) {
-		csw.Status = (stage == PROCESS_CBW) ? CSW_PASSED : CSW_FAILED;
-		stage = (stage == PROCESS_CBW) ? SEND_CSW : stage;
-	}
-}
+	if (n) {
+		key = irq_lock();
 
+		/* Sent from the disk thread once the blocks are read */
+		if (!rd_len[rd_cur]) {
+			rd_wait = true;
+			irq_unlock(key);
+			SYS_LOG_DBG("Signal thread for %d", (addr/BLOCK_SIZE));
+			k_sem_give(&disk_wait_sem);
+			return;
+		}
 
-static void memoryRead(void)
-{
-	uint32_t n;
+		n = min(n, rd_len[rd_cur] - rd_off);
 
-	n = (length > MAX_PACKET) ? MAX_PACKET : length;
-	if ((addr + n) > memory_size) {
-		n = memory_size - addr;
-		stage = ERROR;
+		irq_unlock(key);
 	}
 
-	/* we read an entire block */
-	if (!(addr % BLOCK_SIZE)) {
-		thread_op = THREAD_OP_READ_QUEUED;
-		SYS_LOG_DBG("Signal thread for %d", (addr/BLOCK_SIZE));
-		k_sem_give(&disk_wait_sem);
-		return;
+	if (usb_write(EPBULK_IN, &page[rd_cur][rd_off], n, NULL) != 0) {
+		SYS_LOG_ERR("usb write failure");
 	}
-	usb_write(EPBULK_IN, &page[addr % BLOCK_SIZE], n, NULL);
 	addr += n;
 	length -= n;
 
+	/* Buffer sent, the disk thread reads the next blocks to it */
+	rd_off += n;
+	if (n && rd_off == rd_len[rd_cur]) {
+		key = irq_lock();
+		rd_len[rd_cur] = 0;
+		irq_unlock(key);
+
+		rd_cur ^= 1;
+		rd_off = 0;
+		k_sem_give(&disk_wait_sem);
+	}
+
 	csw.DataResidue -= n;
 
 	if (!length || (stage != PROCESS_CBW)) {
@@ -547,6 +601,7 @@ static void CBWDecode(uint8_t *buf, uint16_t size)
 			if (infoTransfer()) {
 				if ((cbw.Flags & 0x80)) {
 					stage = PROCESS_CBW;
+					memoryReadStart();
 					memoryRead();
 				} else {
 					usb_ep_set_stall(EPBULK_OUT);
@@ -562,6 +617,11 @@ static void CBWDecode(uint8_t *buf, uint16_t size)
 			if (infoTransfer()) {
 				if (!(cbw.Flags & 0x80)) {
 					stage = PROCESS_CBW;
+					wr_cur = 0;
+					wr_off = 0;
+					wr_addr = addr;
+					wr_flush = 0;
+					wr_err = false;
 				} else {
 					usb_ep_set_stall(EPBULK_IN);
 					SYS_LOG_DBG("BI-STALL");
@@ -617,14 +677,14 @@ static void memoryVerify(uint8_t *buf, uint16_t size)
 	/* beginning of a new block -> load a whole block in RAM */
 	if (!(addr % BLOCK_SIZE)) {
 		SYS_LOG_DBG("Disk READ sector %d", addr/BLOCK_SIZE);
-		if (disk_access_read(page, addr/BLOCK_SIZE, 1)) {
+		if (disk_access_read(page[0], addr/BLOCK_SIZE, 1)) {
 			SYS_LOG_ERR("---- Disk Read Error %d", addr/BLOCK_SIZE);
 		}
 	}
 
 	/* info are in RAM -> no need to re-read memory */
 	for (n = 0; n < size; n++) {
-		if (page[addr%BLOCK_SIZE + n] != buf[n]) {
+		if (page[0][addr%BLOCK_SIZE + n] != buf[n]) {
 			SYS_LOG_DBG("Mismatch sector %d offset %d",
 					addr/BLOCK_SIZE, n);
 			memOK = false;
@@ -645,6 +705,10 @@ static void memoryVerify(uint8_t *buf, uint16_t size)
 
 static void memoryWrite(uint8_t *buf, uint16_t size)
 {
+	unsigned int key;
+	uint32_t len;
+	bool last;
+
 	if ((addr + size) > memory_size) {
 		size = memory_size - addr;
 		stage = ERROR;
@@ -652,28 +716,50 @@ static void memoryWrite(uint8_t *buf, uint16_t size)
 		SYS_LOG_WRN("BO - STall > MemSz");
 	}
 
-	/* we fill an array in RAM of 1 block before writing it in memory */
-	for (int i = 0; i < size; i++) {
-		page[addr % BLOCK_SIZE + i] = buf[i];
-	}
-
-	/* if the array is filled, write it in memory */
-	if (!((addr + size) % BLOCK_SIZE)) {
-		if (!(disk_access_status() & DISK_STATUS_WR_PROTECT)) {
-			SYS_LOG_DBG("Disk WRITE Qd %d", (addr/BLOCK_SIZE));
-			thread_op = THREAD_OP_WRITE_QUEUED;  /* write_queued */
-			defered_wr_sz = size;
-			k_sem_give(&disk_wait_sem);
-			return;
-		}
-	}
+	/* we fill a buffer in RAM of several blocks before writing it */
+	memcpy(&page[wr_cur][wr_off], buf, size);
+	wr_off += size;
 
 	addr += size;
 	length -= size;
 	csw.DataResidue -= size;
 
-	if ((!length) || (stage != PROCESS_CBW)) {
+	last = (!length) || (stage != PROCESS_CBW);
+	if (last) {
 		csw.Status = (stage == ERROR) ? CSW_FAILED : CSW_PASSED;
+	}
+
+	/* Whole blocks only, a partial one is only left on errors */
+	len = (wr_off == BUF_SIZE || last) ?
+	      wr_off - (wr_off % BLOCK_SIZE) : 0;
+
+	key = irq_lock();
+
+	/* if the buffer is filled, the disk thread writes it in memory */
+	if (len) {
+		SYS_LOG_DBG("Disk WRITE Qd %d", (wr_addr/BLOCK_SIZE));
+		wr_len[wr_cur] = len;
+		wr_blk[wr_cur] = wr_addr / BLOCK_SIZE;
+		wr_addr += len;
+		wr_cur ^= 1;
+		wr_off = 0;
+		k_sem_give(&disk_wait_sem);
+
+		/* The host is held off until the next buffer is written */
+		if (wr_len[wr_cur]) {
+			wr_nak = true;
+		}
+	}
+
+	/* The status is only given once the data is written */
+	if (last && (wr_len[0] || wr_len[1])) {
+		wr_csw = true;
+		last = false;
+	}
+
+	irq_unlock(key);
+
+	if (last) {
 		sendCSW();
 	}
 }
@@ -724,7 +810,7 @@ static void mass_storage_bulk_out(uint8_t ep,
 		break;
 	}
 
-	if (thread_op != THREAD_OP_WRITE_QUEUED) {
+	if (!wr_nak) {
 		usb_ep_read_continue(ep);
 	} else {
 		SYS_LOG_DBG("> BO not clearing NAKs yet");
@@ -732,23 +818,107 @@ static void mass_storage_bulk_out(uint8_t ep,
 
 }
 
-static void thread_memory_write_done(void)
+/* Reads the blocks of the READ command to the free buffers */
+static void thread_memory_read(void)
 {
-	uint32_t size = defered_wr_sz;
+	unsigned int key;
+	uint32_t n, blk, seq;
+	uint8_t fill;
+	bool wait;
+	int ret;
 
-	addr += size;
-	length -= size;
-	csw.DataResidue -= size;
+	while (1) {
+		key = irq_lock();
 
+		fill = rd_fill;
+		if (!rd_left || rd_len[fill]) {
+			irq_unlock(key);
+			return;
+		}
 
-	if ((!length) || (stage != PROCESS_CBW)) {
-		csw.Status = (stage == ERROR) ? CSW_FAILED : CSW_PASSED;
-		sendCSW();
+		n = min(rd_left, BUF_SIZE);
+		blk = rd_addr / BLOCK_SIZE;
+		seq = rd_seq;
+
+		irq_unlock(key);
+
+		ret = disk_access_read(page[fill], blk, n / BLOCK_SIZE);
+		if (ret) {
+			SYS_LOG_ERR("!! Disk Read Error %d !", blk);
+		}
+
+		key = irq_lock();
+
+		/* Dropped if the command is over */
+		if (seq != rd_seq) {
+			irq_unlock(key);
+			continue;
+		}
+
+		rd_len[fill] = n;
+		rd_fill ^= 1;
+		rd_addr += n;
+		rd_left -= n;
+		wait = rd_wait;
+		rd_wait = false;
+
+		irq_unlock(key);
+
+		if (wait) {
+			memoryRead();
+		}
 	}
+}
 
-	thread_op = THREAD_OP_WRITE_DONE;
+/* Writes the buffers filled by the WRITE command */
+static void thread_memory_write(void)
+{
+	unsigned int key;
+	uint8_t flush;
+	bool nak, done;
 
-	usb_ep_read_continue(EPBULK_OUT);
+	while (1) {
+		key = irq_lock();
+		flush = wr_flush;
+		irq_unlock(key);
+
+		if (!wr_len[flush]) {
+			return;
+		}
+
+		if (!(disk_access_status() & DISK_STATUS_WR_PROTECT) &&
+		    disk_access_write(page[flush], wr_blk[flush],
+				      wr_len[flush] / BLOCK_SIZE)) {
+			SYS_LOG_ERR("!!!!! Disk Write Error %d !!!!!",
+				    wr_blk[flush]);
+			wr_err = true;
+		}
+
+		key = irq_lock();
+
+		wr_len[flush] = 0;
+		wr_flush ^= 1;
+		nak = wr_nak;
+		wr_nak = false;
+		done = wr_csw && !wr_len[wr_flush];
+		if (done) {
+			wr_csw = false;
+		}
+
+		irq_unlock(key);
+
+		if (done) {
+			if (wr_err) {
+				csw.Status = CSW_FAILED;
+			}
+
+			sendCSW();
+		}
+
+		if (nak) {
+			usb_ep_read_continue(EPBULK_OUT);
+		}
+	}
 }
 
 /**
@@ -877,27 +1047,9 @@ static void mass_thread_main(int arg1, int unused)
 
 	while (1) {
 		k_sem_take(&disk_wait_sem, K_FOREVER);
-		SYS_LOG_DBG("sem %d", thread_op);
-
-		switch (thread_op) {
-		case THREAD_OP_READ_QUEUED:
-			if (disk_access_read(page, (addr/BLOCK_SIZE), 1)) {
-				SYS_LOG_ERR("!! Disk Read Error %d !",
-						addr/BLOCK_SIZE);
-			}
 
-			thread_memory_read_done();
-			break;
-		case THREAD_OP_WRITE_QUEUED:
-			if (disk_access_write(page, (addr/BLOCK_SIZE), 1)) {
-				SYS_LOG_ERR("!!!!! Disk Write Error %d !!!!!",
-					    addr/BLOCK_SIZE);
-			}
-			thread_memory_write_done();
-			break;
-		default:
-			SYS_LOG_ERR("XXXXXX thread_op  %d ! XXXXX", thread_op);
-		}
+		thread_memory_read();
+		thread_memory_write();
 	}
 }
 
@@ -821,6 +821,27 @@ int usb_deconfig(void)
 	return 0;
 }
 
+#ifdef CONFIG_USB_TRANSFER_QUEUE
+/* Transfers queued on an endpoint */
+static struct usb_transfer_ep {
+	/** Endpoint address */
+	uint8_t ep;
+	/** Max packet size, 0 if the entry is unused */
+	uint16_t mps;
+	/** Transfers queued after the one in progress */
+	struct k_fifo queue;
+	/** Transfer in progress */
+	struct net_buf *buf;
+	/** Bytes of the IN transfer sent, and written to the FIFO */
+	uint32_t sent;
+	uint32_t written;
+	/** Data being written to the FIFO */
+	bool busy;
+	/** Data received and left in the FIFO, for lack of a buffer */
+	bool rx_pending;
+} usb_transfer_eps[CONFIG_USB_TRANSFER_QUEUE_EPS];
+#endif /* CONFIG_USB_TRANSFER_QUEUE */
+
 int usb_enable(struct usb_cfg_data *config)
 {
 	int ret;
@@ -893,6 +914,9 @@ int usb_enable(struct usb_cfg_data *config)
 int usb_disable(void)
 {
 	int ret;
+#ifdef CONFIG_USB_TRANSFER_QUEUE
+	int i;
+#endif
 
 	if (true != usb_dev.enabled) {
 		/*Already disabled*/
@@ -908,6 +932,14 @@ int usb_disable(void)
 
 	usb_dev.enabled = false;
 
+#ifdef CONFIG_USB_TRANSFER_QUEUE
+	for (i = 0; i < ARRAY_SIZE(usb_transfer_eps); i++) {
+		if (usb_transfer_eps[i].mps) {
+			usb_transfer_cancel(usb_transfer_eps[i].ep);
+		}
+	}
+#endif
+
 	return 0;
 }
 
@@ -943,3 +975,269 @@ int usb_ep_read_continue(uint8_t ep)
 {
 	return usb_dc_ep_read_continue(ep);
 }
+
+#ifdef CONFIG_USB_TRANSFER_QUEUE
+/*
+ * @brief get the max packet size of an endpoint from the descriptors
+ *
+ * @param [in] ep Endpoint address
+ *
+ * @return max packet size, 0 if the endpoint is not described
+ */
+static uint16_t usb_get_ep_mps(uint8_t ep)
+{
+	uint8_t *p = (uint8_t *)usb_dev.descriptors;
+
+	while (p && p[DESC_bLength] != 0) {
+		if (p[DESC_bDescriptorType] == DESC_ENDPOINT &&
+		    p[ENDP_DESC_bEndpointAddress] == ep) {
+			return p[ENDP_DESC_wMaxPacketSize] |
+			       (p[ENDP_DESC_wMaxPacketSize + 1] << 8);
+		}
+
+		p += p[DESC_bLength];
+	}
+
+	return 0;
+}
+
+static struct usb_transfer_ep *usb_transfer_ep_get(uint8_t ep, bool alloc)
+{
+	struct usb_transfer_ep *free_ep = NULL;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < ARRAY_SIZE(usb_transfer_eps); i++) {
+		if (!usb_transfer_eps[i].mps) {
+			if (!free_ep) {
+				free_ep = &usb_transfer_eps[i];
+			}
+
+			continue;
+		}
+
+		if (usb_transfer_eps[i].ep == ep) {
+			irq_unlock(key);
+			return &usb_transfer_eps[i];
+		}
+	}
+
+	if (alloc && free_ep) {
+		free_ep->mps = usb_get_ep_mps(ep);
+		if (free_ep->mps) {
+			free_ep->ep = ep;
+			k_fifo_init(&free_ep->queue);
+			irq_unlock(key);
+			return free_ep;
+		}
+	}
+
+	irq_unlock(key);
+
+	return NULL;
+}
+
+static void usb_transfer_complete(uint8_t ep, struct net_buf *buf, int status)
+{
+	usb_transfer_callback cb;
+
+	cb = *(usb_transfer_callback *)net_buf_user_data(buf);
+	if (cb) {
+		cb(ep, buf, status);
+	} else {
+		net_buf_unref(buf);
+	}
+}
+
+/* Writes the next data of the IN transfers to the FIFO */
+static void usb_transfer_in_next(struct usb_transfer_ep *t)
+{
+	struct net_buf *buf;
+	unsigned int key;
+	uint32_t written;
+	int ret;
+
+	while (1) {
+		key = irq_lock();
+
+		if (t->busy) {
+			irq_unlock(key);
+			return;
+		}
+
+		if (!t->buf) {
+			t->buf = net_buf_get(&t->queue, K_NO_WAIT);
+			if (!t->buf) {
+				irq_unlock(key);
+				return;
+			}
+
+			t->sent = 0;
+		}
+
+		written = 0;
+		ret = usb_write(t->ep, t->buf->data + t->sent,
+				t->buf->len - t->sent, &written);
+		if (!ret) {
+			t->written = written;
+			t->busy = true;
+			irq_unlock(key);
+			return;
+		}
+
+		buf = t->buf;
+		t->buf = NULL;
+
+		irq_unlock(key);
+
+		SYS_LOG_ERR("EP 0x%x write failed (%d)", t->ep, ret);
+		usb_transfer_complete(t->ep, buf, ret);
+	}
+}
+
+/* Reads the data received to the OUT transfer in progress */
+static void usb_transfer_out_next(struct usb_transfer_ep *t)
+{
+	struct net_buf *buf = NULL;
+	unsigned int key;
+	uint32_t read = 0;
+	int ret;
+
+	key = irq_lock();
+
+	if (!t->rx_pending) {
+		irq_unlock(key);
+		return;
+	}
+
+	/* The endpoint NAKs the host until a buffer is queued */
+	if (!t->buf) {
+		t->buf = net_buf_get(&t->queue, K_NO_WAIT);
+		if (!t->buf) {
+			irq_unlock(key);
+			return;
+		}
+	}
+
+	t->rx_pending = false;
+
+	ret = usb_ep_read_wait(t->ep, net_buf_tail(t->buf),
+			       net_buf_tailroom(t->buf), &read);
+	if (!ret) {
+		net_buf_add(t->buf, read);
+	}
+
+	/* A short packet ends the transfer */
+	if (ret || read < t->mps || net_buf_tailroom(t->buf) < t->mps) {
+		buf = t->buf;
+		t->buf = NULL;
+	}
+
+	irq_unlock(key);
+
+	usb_ep_read_continue(t->ep);
+
+	if (buf) {
+		usb_transfer_complete(t->ep, buf, ret);
+	}
+}
+
+void usb_transfer_ep_callback(uint8_t ep,
+			      enum usb_dc_ep_cb_status_code cb_status)
+{
+	struct usb_transfer_ep *t = usb_transfer_ep_get(ep, false);
+	struct net_buf *buf = NULL;
+
+	if (!t) {
+		SYS_LOG_WRN("EP 0x%x has no transfer queued", ep);
+		return;
+	}
+
+	if (cb_status == USB_DC_EP_DATA_OUT) {
+		t->rx_pending = true;
+		usb_transfer_out_next(t);
+		return;
+	}
+
+	/* Called from the endpoint interrupt, nothing else writes it */
+	t->busy = false;
+	t->sent += t->written;
+
+	if (t->buf && t->sent >= t->buf->len) {
+		buf = t->buf;
+		t->buf = NULL;
+	}
+
+	/* The next data is written before the callback is run */
+	usb_transfer_in_next(t);
+
+	if (buf) {
+		usb_transfer_complete(ep, buf, 0);
+	}
+}
+
+int usb_transfer_queue(uint8_t ep, struct net_buf *buf,
+		       usb_transfer_callback cb)
+{
+	struct usb_transfer_ep *t;
+
+	if (buf->pool->user_data_size < sizeof(cb)) {
+		return -EINVAL;
+	}
+
+	t = usb_transfer_ep_get(ep, true);
+	if (!t) {
+		return -ENOMEM;
+	}
+
+	if ((ep & USB_EP_DIR_MASK) == USB_EP_DIR_OUT &&
+	    net_buf_tailroom(buf) < t->mps) {
+		return -EINVAL;
+	}
+
+	*(usb_transfer_callback *)net_buf_user_data(buf) = cb;
+	net_buf_put(&t->queue, buf);
+
+	if ((ep & USB_EP_DIR_MASK) == USB_EP_DIR_IN) {
+		usb_transfer_in_next(t);
+	} else {
+		usb_transfer_out_next(t);
+	}
+
+	return 0;
+}
+
+void usb_transfer_cancel(uint8_t ep)
+{
+	struct usb_transfer_ep *t = usb_transfer_ep_get(ep, false);
+	struct net_buf *buf;
+	unsigned int key;
+
+	if (!t) {
+		return;
+	}
+
+	key = irq_lock();
+
+	buf = t->buf;
+	t->buf = NULL;
+	t->busy = false;
+
+	irq_unlock(key);
+
+	/* Data already in the FIFO is not sent */
+	if ((ep & USB_EP_DIR_MASK) == USB_EP_DIR_IN) {
+		usb_dc_ep_flush(ep);
+	}
+
+	if (buf) {
+		usb_transfer_complete(ep, buf, -ECANCELED);
+	}
+
+	while ((buf = net_buf_get(&t->queue, K_NO_WAIT))) {
+		usb_transfer_complete(ep, buf, -ECANCELED);
+	}
+}
+#endif /* CONFIG_USB_TRANSFER_QUEUE */
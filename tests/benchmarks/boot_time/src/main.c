@@ -14,10 +14,22 @@
  *  2. From __start to main()
  *  3. From __start to task
  *  4. From __start to idle
+ *
+ * Built with CONFIG_BOOT_TIME_PROFILE, the time taken by each init function
+ * and kernel init phase is printed as well, from the slowest.
+ *
+ * Built with SLOW_DEVICES=y, devices with a slow initialization are added,
+ * so that the time saved by CONFIG_DEVICE_INIT_ASYNC shows in 2. to 4.
  */
 
 #include <zephyr.h>
 #include <tc_util.h>
+#ifdef CONFIG_BOOT_TIME_PROFILE
+#include <misc/boot_profile.h>
+#endif
+#ifdef SLOW_DEVICES_ENABLED
+#include "slow_devices.h"
+#endif
 
 /* externs */
 extern uint64_t __start_tsc;    /* timestamp when kernel begins executing */
@@ -58,6 +70,11 @@ void main(void)
 	/* Only print lower 32bit of time result */
 	TC_PRINT("Boot Result: Clock Frequency: %d MHz\n",
 		 freq);
+#ifdef SLOW_DEVICES_ENABLED
+	TC_PRINT("Slow devices  : %d x %d ms, %s init\n",
+		 SLOW_DEVICES, SLOW_DEVICE_INIT_MS,
+		 IS_ENABLED(CONFIG_DEVICE_INIT_ASYNC) ? "async" : "sync");
+#endif
 	TC_PRINT("__start       : %d cycles, %d us\n",
 		 (uint32_t)(__start_tsc & 0xFFFFFFFFULL),
 		 (uint32_t) (_start_us  & 0xFFFFFFFFULL));
@@ -71,6 +88,10 @@ void main(void)
 		 (uint32_t)(s_idle_tsc & 0xFFFFFFFFULL),
 		 (uint32_t)  (idle_us  & 0xFFFFFFFFULL));
 
+#ifdef CONFIG_BOOT_TIME_PROFILE
+	boot_profile_report();
+#endif
+
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	/* for sanity regression test utility. */
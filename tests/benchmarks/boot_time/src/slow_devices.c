@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Devices with a slow initialization
+ *
+ * Stand-ins for drivers that wait on their hardware at init, such as an
+ * ethernet PHY autonegotiating its link or a flash being probed for its ID.
+ * With CONFIG_DEVICE_INIT_ASYNC enabled they get initialized concurrently.
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include "slow_devices.h"
+
+static const int slow_api;
+
+static int slow_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_sleep(SLOW_DEVICE_INIT_MS);
+
+	return 0;
+}
+
+#define SLOW_DEVICE(n) \
+	DEVICE_AND_API_INIT(slow_##n, "SLOW_" #n, slow_init, NULL, NULL, \
+			    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, \
+			    &slow_api); \
+	DEVICE_INIT_ASYNC(slow_##n, 0)
+
+SLOW_DEVICE(0);
+SLOW_DEVICE(1);
+SLOW_DEVICE(2);
+SLOW_DEVICE(3);
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _SLOW_DEVICES_H_
+#define _SLOW_DEVICES_H_
+
+#define SLOW_DEVICES 4
+#define SLOW_DEVICE_INIT_MS 20
+
+#endif /* _SLOW_DEVICES_H_ */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the latency of regular and direct ISRs
+ *
+ * Two unused interrupt lines are triggered from software: one is serviced
+ * by a regular ISR, going through the common interrupt wrapper, and the
+ * other by a direct ISR, installed in the vector table. Both ISRs report
+ * the time elapsed since their interrupt was triggered to the interrupt
+ * latency benchmark.
+ */
+
+#include <zephyr.h>
+#include <irq.h>
+#include <tc_util.h>
+#include <arch/arm/cortex_m/cmsis.h>
+
+#define NUM_SAMPLES 100
+
+#define WRAPPED_IRQ (CONFIG_NUM_IRQS - 1)
+#define DIRECT_IRQ (CONFIG_NUM_IRQS - 2)
+
+extern void int_latency_init(void);
+extern void int_latency_show(void);
+extern void _int_latency_isr_record(uint32_t trigger_time, int direct);
+
+static volatile uint32_t trigger_time;
+static volatile int handled;
+
+static void trigger_irq(int irq)
+{
+	trigger_time = k_cycle_get_32();
+#if defined(CONFIG_SOC_TI_LM3S6965_QEMU)
+	/* QEMU does not simulate the STIR register: this is a workaround */
+	NVIC_SetPendingIRQ(irq);
+#else
+	NVIC->STIR = irq;
+#endif
+	/* make sure the interrupt is taken before going on */
+	__DSB();
+	__ISB();
+}
+
+static void wrapped_isr(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	_int_latency_isr_record(trigger_time, 0);
+	handled++;
+}
+
+ISR_DIRECT_DECLARE(direct_isr)
+{
+	_int_latency_isr_record(trigger_time, 1);
+	handled++;
+
+	/* no kernel object touched: no need to check for rescheduling */
+	return 0;
+}
+
+static int measure(int irq)
+{
+	for (int i = 0; i < NUM_SAMPLES; i++) {
+		int expected = handled + 1;
+
+		trigger_irq(irq);
+		if (handled != expected) {
+			TC_ERROR("interrupt %d not handled\n", irq);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status;
+
+	TC_START("Interrupt Latency Measurement");
+
+	IRQ_CONNECT(WRAPPED_IRQ, 0, wrapped_isr, NULL, 0);
+	IRQ_DIRECT_CONNECT(DIRECT_IRQ, 0, direct_isr, 0);
+	irq_enable(WRAPPED_IRQ);
+	irq_enable(DIRECT_IRQ);
+
+	int_latency_init();
+
+	status = measure(WRAPPED_IRQ);
+	if (status == TC_PASS) {
+		status = measure(DIRECT_IRQ);
+	}
+
+	int_latency_show();
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the latency and jitter of the kernel hot paths
+ *
+ * The following are measured a number of times each:
+ * - ISR entry: from triggering an interrupt up to its ISR
+ * - ISR to thread wakeup: from an ISR giving a semaphore up to the thread
+ *   waiting for it
+ * - timer jitter: deviation of the intervals between the expiries of a
+ *   periodic k_timer from its period
+ * - context switch: from a thread yielding up to the next thread
+ * - k_poll() wakeup: from giving a semaphore up to the thread polling it
+ *
+ * Times are taken from the CPU cycle counter when there is one: the TSC on
+ * x86 and the DWT cycle counter on ARMv7-M. Its rate is calibrated against
+ * the system clock. The minimum, average and maximum of each measurement
+ * are shown, along with a histogram of the samples.
+ */
+
+#include <zephyr.h>
+#include <irq_offload.h>
+#include <tc_util.h>
+#include <string.h>
+#if defined(CONFIG_ARMV7_M)
+#include <arch/arm/cortex_m/cmsis.h>
+#endif
+
+#define NUM_SAMPLES 256
+#define NUM_BUCKETS 10
+#define BAR_WIDTH 40
+
+#define STACK_SIZE 512
+#define WAITER_PRIO K_PRIO_COOP(0)
+#define YIELDER_PRIO K_PRIO_PREEMPT(0)
+
+#define TIMER_PERIOD 10 /* ms */
+#define CALIBRATION_TIME 100 /* ms */
+
+static char __stack thread_stack[STACK_SIZE];
+
+static uint32_t samples[NUM_SAMPLES];
+static volatile int num_samples;
+
+static volatile uint32_t stamp;
+
+static K_SEM_DEFINE(sem, 0, 1);
+
+/* cycle counter */
+
+static const char *counter_name = "system clock";
+static uint32_t counter_rate;
+static int use_cpu_counter;
+
+static inline uint32_t cpu_counter_read(void)
+{
+#if defined(CONFIG_X86)
+	return _do_read_cpu_timestamp32();
+#elif defined(CONFIG_ARMV7_M)
+	return DWT->CYCCNT;
+#else
+	return 0;
+#endif
+}
+
+static inline uint32_t cycles(void)
+{
+	return use_cpu_counter ? cpu_counter_read() : k_cycle_get_32();
+}
+
+static void counter_init(void)
+{
+	uint32_t sys_start, start, cpu_cycles;
+
+#if defined(CONFIG_ARMV7_M)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+	/* start on a tick boundary */
+	k_sleep(1);
+
+	sys_start = k_cycle_get_32();
+	start = cpu_counter_read();
+	k_busy_wait(CALIBRATION_TIME * USEC_PER_MSEC);
+	cpu_cycles = cpu_counter_read() - start;
+
+	/* some emulators do not implement the counter */
+	if (cpu_cycles == 0) {
+		counter_rate = sys_clock_hw_cycles_per_sec;
+		return;
+	}
+
+	use_cpu_counter = 1;
+#if defined(CONFIG_X86)
+	counter_name = "TSC";
+#else
+	counter_name = "DWT";
+#endif
+	counter_rate = (uint64_t)cpu_cycles * sys_clock_hw_cycles_per_sec /
+		       (k_cycle_get_32() - sys_start);
+}
+
+static uint32_t cycles_to_ns(uint32_t c)
+{
+	return (uint64_t)c * NSEC_PER_SEC / counter_rate;
+}
+
+/* statistics */
+
+static void show_bar(uint32_t count, uint32_t max_count)
+{
+	char bar[BAR_WIDTH + 1];
+	int len = max_count ? count * BAR_WIDTH / max_count : 0;
+
+	if (count && !len) {
+		len = 1;
+	}
+	memset(bar, '#', len);
+	bar[len] = '\0';
+
+	TC_PRINT(" |%s\n", bar);
+}
+
+static void show_stats(const char *name)
+{
+	uint32_t buckets[NUM_BUCKETS] = { 0 };
+	uint32_t low = UINT32_MAX, high = 0, max_count = 0;
+	uint64_t sum = 0;
+	uint32_t width;
+
+	for (int i = 0; i < num_samples; i++) {
+		low = min(low, samples[i]);
+		high = max(high, samples[i]);
+		sum += samples[i];
+	}
+
+	TC_PRINT("%s (%d samples)\n", name, num_samples);
+	if (num_samples == 0) {
+		return;
+	}
+
+	TC_PRINT(" min %u ns, avg %u ns, max %u ns\n", cycles_to_ns(low),
+		 cycles_to_ns(sum / num_samples), cycles_to_ns(high));
+
+	width = (high - low) / NUM_BUCKETS + 1;
+	for (int i = 0; i < num_samples; i++) {
+		int bucket = (samples[i] - low) / width;
+
+		buckets[bucket]++;
+		max_count = max(max_count, buckets[bucket]);
+	}
+
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		uint32_t start = low + i * width;
+
+		if (start > high) {
+			break;
+		}
+		TC_PRINT(" %9u - %9u ns: %5u", cycles_to_ns(start),
+			 cycles_to_ns(start + width - 1), buckets[i]);
+		show_bar(buckets[i], max_count);
+	}
+}
+
+/* ISR entry */
+
+static void entry_isr(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	samples[num_samples++] = cycles() - stamp;
+}
+
+static void measure_isr_entry(void)
+{
+	num_samples = 0;
+	for (int i = 0; i < NUM_SAMPLES; i++) {
+		stamp = cycles();
+		irq_offload(entry_isr, NULL);
+	}
+}
+
+/* ISR to thread wakeup, and k_poll() wakeup */
+
+static void give_isr(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	stamp = cycles();
+	k_sem_give(&sem);
+}
+
+static void sem_waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		k_sem_take(&sem, K_FOREVER);
+		samples[num_samples++] = cycles() - stamp;
+	}
+}
+
+static void poll_waiter(void *p1, void *p2, void *p3)
+{
+	struct k_poll_event event;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &sem);
+
+	for (;;) {
+		k_poll(&event, 1, K_FOREVER);
+		samples[num_samples++] = cycles() - stamp;
+
+		event.state = K_POLL_STATE_NOT_READY;
+		k_sem_take(&sem, K_NO_WAIT);
+	}
+}
+
+static void measure_wakeup(k_thread_entry_t waiter, int from_isr)
+{
+	k_tid_t tid;
+
+	tid = k_thread_spawn(thread_stack, STACK_SIZE, waiter, NULL, NULL,
+			     NULL, WAITER_PRIO, 0, K_NO_WAIT);
+
+	/* the waiter preempts this thread as soon as it is woken up */
+	num_samples = 0;
+	for (int i = 0; i < NUM_SAMPLES; i++) {
+		if (from_isr) {
+			irq_offload(give_isr, NULL);
+		} else {
+			stamp = cycles();
+			k_sem_give(&sem);
+		}
+	}
+
+	k_thread_abort(tid);
+}
+
+/* timer jitter */
+
+static uint32_t timer_period;
+static int timer_started;
+
+static void timer_expiry(struct k_timer *timer)
+{
+	uint32_t now = cycles();
+	uint32_t interval = now - stamp;
+
+	stamp = now;
+
+	/* the first expiry only starts the measurement */
+	if (!timer_started) {
+		timer_started = 1;
+		return;
+	}
+
+	samples[num_samples++] = interval > timer_period ?
+				 interval - timer_period :
+				 timer_period - interval;
+
+	if (num_samples == NUM_SAMPLES) {
+		k_timer_stop(timer);
+		k_sem_give(&sem);
+	}
+}
+
+static void measure_timer_jitter(void)
+{
+	struct k_timer timer;
+
+	timer_period = counter_rate / MSEC_PER_SEC * TIMER_PERIOD;
+
+	k_timer_init(&timer, timer_expiry, NULL);
+	timer_started = 0;
+	num_samples = 0;
+	k_timer_start(&timer, TIMER_PERIOD, TIMER_PERIOD);
+	k_sem_take(&sem, K_FOREVER);
+}
+
+/* context switch */
+
+static void yielder(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* the first switch in goes through the thread entry */
+	k_yield();
+
+	for (;;) {
+		uint32_t now = cycles();
+
+		if (num_samples < NUM_SAMPLES) {
+			samples[num_samples++] = now - stamp;
+		}
+		k_yield();
+	}
+}
+
+static void measure_context_switch(void)
+{
+	k_tid_t tid;
+
+	tid = k_thread_spawn(thread_stack, STACK_SIZE, yielder, NULL, NULL,
+			     NULL, YIELDER_PRIO, 0, K_NO_WAIT);
+
+	k_yield();
+	num_samples = 0;
+
+	/* the yielder records a sample each time this thread yields */
+	while (num_samples < NUM_SAMPLES) {
+		stamp = cycles();
+		k_yield();
+	}
+
+	k_thread_abort(tid);
+}
+
+void main(void)
+{
+	TC_START("Kernel Latency Measurement");
+
+	counter_init();
+	TC_PRINT("Cycle counter: %s at %u Hz\n", counter_name, counter_rate);
+
+	measure_isr_entry();
+	show_stats("Interrupt trigger to ISR entry");
+
+	measure_wakeup(sem_waiter, 1);
+	show_stats("ISR semaphore give to thread wakeup");
+
+	measure_timer_jitter();
+	show_stats("k_timer expiry deviation from period");
+
+	measure_context_switch();
+	show_stats("k_yield() to next thread");
+
+	measure_wakeup(poll_waiter, 0);
+	show_stats("Semaphore give to k_poll() wakeup");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the memory copy routines of the minimal libc
+ *
+ * memcpy(), memmove() and memset() are run a number of times on buffers of
+ * several sizes, sharing the same alignment or not, and the average time of
+ * one call is shown. The results are to be compared between a build using
+ * the generic C routines and a build using the architecture-optimized ones.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+
+#define NUM_LOOPS 100
+#define MAX_SIZE 1024
+
+/* room for the misalignment and for overlapping memmove() */
+static uint8_t __aligned(4) src_buf[MAX_SIZE + 8];
+static uint8_t __aligned(4) dst_buf[MAX_SIZE + 8];
+
+static const size_t sizes[] = { 16, 64, 256, 1024 };
+
+enum memop {
+	OP_MEMCPY,
+	OP_MEMMOVE_FWD,
+	OP_MEMMOVE_BWD,
+	OP_MEMSET,
+};
+
+static const char * const op_names[] = {
+	[OP_MEMCPY] = "memcpy ",
+	[OP_MEMMOVE_FWD] = "memmove",
+	[OP_MEMMOVE_BWD] = "memmove",
+	[OP_MEMSET] = "memset ",
+};
+
+static const char * const op_details[] = {
+	[OP_MEMCPY] = "",
+	[OP_MEMMOVE_FWD] = " (forward)",
+	[OP_MEMMOVE_BWD] = " (backward)",
+	[OP_MEMSET] = "",
+};
+
+static void run_op(enum memop op, size_t size, int misalign)
+{
+	switch (op) {
+	case OP_MEMCPY:
+		memcpy(dst_buf + misalign, src_buf, size);
+		break;
+	case OP_MEMMOVE_FWD:
+		memmove(src_buf, src_buf + 4 + misalign, size);
+		break;
+	case OP_MEMMOVE_BWD:
+		memmove(src_buf + 4 + misalign, src_buf, size);
+		break;
+	case OP_MEMSET:
+		memset(dst_buf + misalign, 0x5a, size);
+		break;
+	}
+}
+
+static void measure(enum memop op, size_t size, int misalign)
+{
+	uint32_t start, cycles;
+
+	/* warm up the caches, if any */
+	run_op(op, size, misalign);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_LOOPS; i++) {
+		run_op(op, size, misalign);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT(" %s %s %4u bytes: %6u tcs = %7u nsec%s\n", op_names[op],
+		 misalign ? "misaligned" : "aligned   ", size,
+		 cycles / NUM_LOOPS,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(cycles, NUM_LOOPS),
+		 op_details[op]);
+}
+
+void main(void)
+{
+	TC_START("Memory Copy Routines Measurement");
+
+#ifdef CONFIG_MINIMAL_LIBC_OPTIMIZED_MEMOPS
+	TC_PRINT(" using architecture-optimized routines\n");
+#else
+	TC_PRINT(" using generic C routines\n");
+#endif
+
+	for (int i = 0; i < sizeof(src_buf); i++) {
+		src_buf[i] = i;
+	}
+
+	for (enum memop op = OP_MEMCPY; op <= OP_MEMSET; op++) {
+		for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+			measure(op, sizes[i], 0);
+			measure(op, sizes[i], 1);
+		}
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the throughput of snprintf() and snprintk()
+ *
+ * A few typical log lines are formatted a number of times into a buffer,
+ * and the average time taken to format one of them is shown.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <misc/printk.h>
+#include <tc_util.h>
+
+#define NUM_LOOPS 100
+#define BUF_SIZE 128
+
+static char buf[BUF_SIZE];
+
+enum line {
+	LINE_LITERAL,
+	LINE_DECIMAL,
+	LINE_HEX,
+	LINE_MIXED,
+	LINE_COUNT,
+};
+
+static int format_line(int use_printk, enum line line, uint32_t val)
+{
+	int (*fmt)(char *str, size_t size, const char *format, ...) =
+		use_printk ? snprintk : snprintf;
+
+	switch (line) {
+	case LINE_LITERAL:
+		return fmt(buf, sizeof(buf),
+			   "lit: connection established, waiting for data");
+	case LINE_DECIMAL:
+		return fmt(buf, sizeof(buf), "dec: %u %u %d %u",
+			   val, val / 7, -(int)val, val % 1000);
+	case LINE_HEX:
+		return fmt(buf, sizeof(buf), "hex: %x %08x %p",
+			   val, val >> 4, (void *)val);
+	default:
+		return fmt(buf, sizeof(buf), "mix: <%s> seq %u len %d at %08x",
+			   "net_pkt", val, 1280, val);
+	}
+}
+
+static void measure(int use_printk, enum line line)
+{
+	uint32_t start, cycles, nsec;
+	int len = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_LOOPS; i++) {
+		len += format_line(use_printk, line, 4000000000u - i);
+	}
+	cycles = k_cycle_get_32() - start;
+	nsec = SYS_CLOCK_HW_CYCLES_TO_NS_AVG(cycles, NUM_LOOPS);
+
+	TC_PRINT(" %s \"%s\"\n   %u tcs = %u nsec, %u chars/ms\n",
+		 use_printk ? "snprintk" : "snprintf", buf,
+		 cycles / NUM_LOOPS, nsec,
+		 nsec ? (len / NUM_LOOPS) * 1000000 / nsec : 0);
+}
+
+void main(void)
+{
+	TC_START("String Formatting Throughput Measurement");
+
+	for (int use_printk = 0; use_printk < 2; use_printk++) {
+		for (enum line line = LINE_LITERAL; line < LINE_COUNT;
+		     line++) {
+			measure(use_printk, line);
+		}
+	}
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -12,25 +12,19 @@
 struct k_fifo fifo1;
 struct k_fifo fifo2;
 
-static struct k_fifo sync_fifo; /* for synchronization */
+/* Elements of the benchmark thread, two being queued at once by batches */
+static int element[2][2];
+static int seq;
 
+/* Elements of the helper, static as they are received after it ends */
+static int echo[2][2];
 
 /**
  *
- * @brief Initialize FIFOs for the test
+ * @brief FIFO helper thread
  *
- * @return N/A
- */
-void fifo_test_init(void)
-{
-	k_fifo_init(&fifo1);
-	k_fifo_init(&fifo2);
-}
-
-
-/**
- *
- * @brief Fifo test thread
+ * Echoes the value of each element received, alternating between two
+ * elements as a batch queues two of them.
  *
  * @param par1   Ignored parameter.
  * @param par2   Number of test loops.
@@ -40,222 +34,114 @@ void fifo_test_init(void)
 void fifo_thread1(void *par1, void *par2, void *par3)
 {
 	int i;
-	int element[2];
 	int *pelement;
 	int num_loops = (int) par2;
 
 	ARG_UNUSED(par1);
 	ARG_UNUSED(par3);
+
 	for (i = 0; i < num_loops; i++) {
-		pelement = (int *)k_fifo_get(&fifo1,
-						      K_FOREVER);
-		if (pelement[1] != i) {
-			break;
-		}
-		element[1] = i;
-		k_fifo_put(&fifo2, element);
+		pelement = (int *)k_fifo_get(&fifo1, K_FOREVER);
+		echo[i & 1][1] = pelement[1];
+		k_fifo_put(&fifo2, echo[i & 1]);
 	}
-	/* wait till it is safe to end: */
-	k_fifo_get(&sync_fifo, K_FOREVER);
-}
 
+	helper_done();
+}
 
 /**
  *
- * @brief Fifo test thread
+ * @brief Initialize FIFOs and start the helper for the test
  *
- * @param par1   Address of the counter.
- * @param par2   Number of test cycles.
+ * @param num_loops   Number of elements echoed by the helper.
  *
  * @return N/A
  */
-void fifo_thread2(void *par1, void *par2, void *par3)
+static void fifo_start(int num_loops)
 {
-	int i;
-	int element[2];
-	int *pelement;
-	int *pcounter = (int *) par1;
-	int num_loops = (int) par2;
-
-	ARG_UNUSED(par3);
+	k_fifo_init(&fifo1);
+	k_fifo_init(&fifo2);
+	seq = 0;
+	helper_start(fifo_thread1, num_loops);
+}
 
-	for (i = 0; i < num_loops; i++) {
-		element[1] = i;
-		k_fifo_put(&fifo1, element);
-		pelement = (int *)k_fifo_get(&fifo2,
-						      K_FOREVER);
-		if (pelement[1] != i) {
-			break;
-		}
-		(*pcounter)++;
-	}
-	/* wait till it is safe to end: */
-	k_fifo_get(&sync_fifo, K_FOREVER);
+void fifo_test_init(void)
+{
+	fifo_start(HELPER_LOOPS);
 }
 
+void fifo_batch_init(void)
+{
+	fifo_start(2 * HELPER_LOOPS);
+}
 
 /**
  *
- * @brief Fifo test thread
+ * @brief FIFO round trip
  *
- * @param par1   Address of the counter.
- * @param par2   Number of test cycles.
+ * k_fifo_put, k_fifo_get(K_FOREVER)
  *
  * @return N/A
  */
-void fifo_thread3(void *par1, void *par2, void *par3)
+static void fifo_wait_iteration(void)
 {
-	int i;
-	int element[2];
 	int *pelement;
-	int *pcounter = (int *)par1;
-	int num_loops = (int) par2;
-
-	ARG_UNUSED(par3);
 
-	for (i = 0; i < num_loops; i++) {
-		element[1] = i;
-		k_fifo_put(&fifo1, element);
-		while ((pelement = k_fifo_get(&fifo2,
-							K_NO_WAIT)) == NULL) {
-			k_yield();
-		}
-		if (pelement[1] != i) {
-			break;
-		}
-		(*pcounter)++;
-	}
-	/* wait till it is safe to end: */
-	k_fifo_get(&sync_fifo, K_FOREVER);
+	element[0][1] = seq;
+	k_fifo_put(&fifo1, element[0]);
+	pelement = (int *)k_fifo_get(&fifo2, K_FOREVER);
+	assert_equal(pelement[1], seq, "wrong element received");
+	seq++;
 }
 
-
 /**
  *
- * @brief The main test entry
+ * @brief FIFO round trip, polling
+ *
+ * k_fifo_put, k_fifo_get(K_NO_WAIT), k_yield
  *
- * @return 1 if success and 0 on failure
+ * @return N/A
  */
-int fifo_test(void)
+static void fifo_yield_iteration(void)
 {
-	uint32_t t;
-	int i = 0;
-	int return_value = 0;
-	int element[2];
-	int j;
-
-	k_fifo_init(&sync_fifo);
-
-	/* test get wait & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put");
-	printf(sz_test_start_fmt);
-
-	fifo_test_init();
-
-	t = BENCH_START();
-
-	k_thread_spawn(thread_stack1, STACK_SIZE, fifo_thread1,
-			 NULL, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	k_thread_spawn(thread_stack2, STACK_SIZE, fifo_thread2,
-			 (void *) &i, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-
-	t = TIME_STAMP_DELTA_GET(t);
-
-	return_value += check_result(i, t);
-
-	/* threads have done their job, they can stop now safely: */
-	for (j = 0; j < 2; j++) {
-		k_fifo_put(&sync_fifo, (void *) element);
-	}
-
-	/* test get/yield & put thread functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_get(TICKS_NONE)"
-			"\n\tk_fifo_put"
-			"\n\tk_yield");
-	printf(sz_test_start_fmt);
-
-	fifo_test_init();
-
-	t = BENCH_START();
-
-	i = 0;
-	k_thread_spawn(thread_stack1, STACK_SIZE, fifo_thread1,
-			 NULL, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	k_thread_spawn(thread_stack2, STACK_SIZE, fifo_thread3,
-			 (void *) &i, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-
-	t = TIME_STAMP_DELTA_GET(t);
-
-	return_value += check_result(i, t);
-
-	/* threads have done their job, they can stop now safely: */
-	for (j = 0; j < 2; j++) {
-		k_fifo_put(&sync_fifo, (void *) element);
-	}
-
-	/* test get wait & put functions between co-op and premptive threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"FIFO #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_fifo_init"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put"
-			"\n\tk_fifo_get(K_FOREVER)"
-			"\n\tk_fifo_put");
-	printf(sz_test_start_fmt);
-
-	fifo_test_init();
-
-	t = BENCH_START();
-
-	k_thread_spawn(thread_stack1, STACK_SIZE, fifo_thread1,
-			 NULL, (void *) (NUMBER_OF_LOOPS / 2), NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	k_thread_spawn(thread_stack2, STACK_SIZE, fifo_thread1,
-			 NULL, (void *) (NUMBER_OF_LOOPS / 2), NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	for (i = 0; i < NUMBER_OF_LOOPS / 2; i++) {
-		int element[2];
-		int *pelement;
-
-		element[1] = i;
-		k_fifo_put(&fifo1, element);
-		element[1] = i;
-		k_fifo_put(&fifo1, element);
+	int *pelement;
 
-		pelement = (int *)k_fifo_get(&fifo2,
-						     K_FOREVER);
-		if (pelement[1] != i) {
-			break;
-		}
-		pelement = (int *)k_fifo_get(&fifo2,
-						     K_FOREVER);
-		if (pelement[1] != i) {
-			break;
-		}
+	element[0][1] = seq;
+	k_fifo_put(&fifo1, element[0]);
+	while ((pelement = k_fifo_get(&fifo2, K_NO_WAIT)) == NULL) {
+		k_yield();
 	}
-	t = TIME_STAMP_DELTA_GET(t);
+	assert_equal(pelement[1], seq, "wrong element received");
+	seq++;
+}
 
-	return_value += check_result(i * 2, t);
+/**
+ *
+ * @brief FIFO round trip of two elements, first put, first got
+ *
+ * k_fifo_put, k_fifo_put, k_fifo_get(K_FOREVER), k_fifo_get(K_FOREVER)
+ *
+ * @return N/A
+ */
+static void fifo_batch_iteration(void)
+{
+	int *pelement;
 
-	/* threads have done their job, they can stop now safely: */
-	for (j = 0; j < 2; j++) {
-		k_fifo_put(&sync_fifo, (void *) element);
-	}
+	element[0][1] = 2 * seq;
+	k_fifo_put(&fifo1, element[0]);
+	element[1][1] = 2 * seq + 1;
+	k_fifo_put(&fifo1, element[1]);
 
-	return return_value;
+	pelement = (int *)k_fifo_get(&fifo2, K_FOREVER);
+	assert_equal(pelement[1], 2 * seq, "wrong element received");
+	pelement = (int *)k_fifo_get(&fifo2, K_FOREVER);
+	assert_equal(pelement[1], 2 * seq + 1, "wrong element received");
+	seq++;
 }
+
+ZTEST_BENCHMARK_DEFINE(fifo_wait, fifo_wait_iteration, fifo_test_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
+ZTEST_BENCHMARK_DEFINE(fifo_yield, fifo_yield_iteration, fifo_test_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
+ZTEST_BENCHMARK_DEFINE(fifo_batch, fifo_batch_iteration, fifo_batch_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
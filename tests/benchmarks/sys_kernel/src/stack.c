@@ -14,23 +14,11 @@ struct k_stack  stack_2;
 uint32_t stack1[2];
 uint32_t stack2[2];
 
-/**
- *
- * @brief Initialize stacks for the test
- *
- * @return N/A
- *
- */
-void stack_test_init(void)
-{
-	k_stack_init(&stack_1, stack1, 2);
-	k_stack_init(&stack_2, stack2, 2);
-}
-
+static uint32_t seq;
 
 /**
  *
- * @brief Stack test thread
+ * @brief Stack helper thread
  *
  * @param par1   Ignored parameter.
  * @param par2   Number of test loops.
@@ -40,203 +28,115 @@ void stack_test_init(void)
  */
 void stack_thread1(void *par1, void *par2, void *par3)
 {
-	int num_loops = ((int) par2 / 2);
 	int i;
 	uint32_t data;
+	int num_loops = (int) par2;
 
 	ARG_UNUSED(par1);
 	ARG_UNUSED(par3);
 
 	for (i = 0; i < num_loops; i++) {
 		k_stack_pop(&stack_1, &data, K_FOREVER);
-		if (data != 2 * i) {
-			break;
-		}
-		data = 2 * i;
-		k_stack_push(&stack_2, data);
-		k_stack_pop(&stack_1, &data, K_FOREVER);
-		if (data != 2 * i + 1) {
-			break;
-		}
-		data = 2 * i + 1;
 		k_stack_push(&stack_2, data);
 	}
-}
 
+	helper_done();
+}
 
 /**
  *
- * @brief Stack test thread
+ * @brief Initialize stacks and start the helper for the test
  *
- * @param par1   Address of the counter.
- * @param par2   Number of test cycles.
+ * @param num_loops   Number of values echoed by the helper.
  *
  * @return N/A
  *
  */
-void stack_thread2(void *par1, void *par2, void *par3)
+static void stack_start(int num_loops)
 {
-	int i;
-	uint32_t data;
-	int *pcounter = (int *)par1;
-	int num_loops = (int) par2;
-
-	ARG_UNUSED(par3);
+	k_stack_init(&stack_1, stack1, 2);
+	k_stack_init(&stack_2, stack2, 2);
+	seq = 0;
+	helper_start(stack_thread1, num_loops);
+}
 
-	for (i = 0; i < num_loops; i++) {
-		data = i;
-		k_stack_push(&stack_1, data);
-		k_stack_pop(&stack_2, &data, K_FOREVER);
-		if (data != i) {
-			break;
-		}
-		(*pcounter)++;
-	}
+void stack_test_init(void)
+{
+	stack_start(HELPER_LOOPS);
 }
 
+void stack_batch_init(void)
+{
+	stack_start(2 * HELPER_LOOPS);
+}
 
 /**
  *
- * @brief Stack test thread
+ * @brief Stack round trip
  *
- * @param par1   Address of the counter.
- * @param par2   Number of test cycles.
+ * k_stack_push, k_stack_pop(K_FOREVER)
  *
  * @return N/A
  *
  */
-void stack_thread3(void *par1, void *par2, void *par3)
+static void stack_wait_iteration(void)
 {
-	int i;
 	uint32_t data;
-	int *pcounter = (int *)par1;
-	int num_loops = (int) par2;
 
-	ARG_UNUSED(par3);
-
-	for (i = 0; i < num_loops; i++) {
-		data = i;
-		k_stack_push(&stack_1, data);
-		data = 0xffffffff;
-
-		while (k_stack_pop(&stack_2, &data,
-					     K_NO_WAIT) != 0) {
-			k_yield();
-		}
-		if (data != i) {
-			break;
-		}
-		(*pcounter)++;
-	}
+	k_stack_push(&stack_1, seq);
+	k_stack_pop(&stack_2, &data, K_FOREVER);
+	assert_equal(data, seq, "wrong value received");
+	seq++;
 }
 
-
 /**
  *
- * @brief The main test entry
+ * @brief Stack round trip, polling
+ *
+ * k_stack_push, k_stack_pop(K_NO_WAIT), k_yield
  *
- * @return 1 if success and 0 on failure
+ * @return N/A
  *
  */
-int stack_test(void)
+static void stack_yield_iteration(void)
 {
-	uint32_t t;
-	int i = 0;
-	int return_value = 0;
-
-	/* test get wait & put stack functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #1");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(TICKS_UNLIMITED)"
-			"\n\tk_stack_push");
-	printf(sz_test_start_fmt);
-
-	stack_test_init();
-
-	t = BENCH_START();
-
-	k_thread_spawn(thread_stack1, STACK_SIZE, stack_thread1,
-			 0, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	k_thread_spawn(thread_stack2, STACK_SIZE, stack_thread2,
-			 (void *) &i, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-
-	t = TIME_STAMP_DELTA_GET(t);
-
-	return_value += check_result(i, t);
-
-	/* test get/yield & put stack functions between co-op threads */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #2");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(TICKS_UNLIMITED)"
-			"\n\tk_stack_pop"
-			"\n\tk_stack_push"
-			"\n\tk_yield");
-	printf(sz_test_start_fmt);
-
-	stack_test_init();
-
-	t = BENCH_START();
-
-	i = 0;
-	k_thread_spawn(thread_stack1, STACK_SIZE, stack_thread1,
-			 0, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-	k_thread_spawn(thread_stack2, STACK_SIZE, stack_thread3,
-			 (void *) &i, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-
-	t = TIME_STAMP_DELTA_GET(t);
-
-	return_value += check_result(i, t);
-
-	/* test get wait & put stack functions across co-op and premptive
-	 * threads
-	 */
-	fprintf(output_file, sz_test_case_fmt,
-			"Stack #3");
-	fprintf(output_file, sz_description,
-			"\n\tk_stack_init"
-			"\n\tk_stack_pop(TICKS_UNLIMITED)"
-			"\n\tk_stack_push"
-			"\n\tk_stack_pop(TICKS_UNLIMITED)"
-			"\n\tk_stack_push");
-	printf(sz_test_start_fmt);
-
-	stack_test_init();
-
-	t = BENCH_START();
-
-	k_thread_spawn(thread_stack1, STACK_SIZE, stack_thread1,
-			 0, (void *) NUMBER_OF_LOOPS, NULL,
-			 K_PRIO_COOP(3), 0, K_NO_WAIT);
-
-	for (i = 0; i < NUMBER_OF_LOOPS / 2; i++) {
-		uint32_t data;
-
-		data = 2 * i;
-		k_stack_push(&stack_1, data);
-		data = 2 * i + 1;
-		k_stack_push(&stack_1, data);
-
-		k_stack_pop(&stack_2, &data, K_FOREVER);
-		if (data != 2 * i + 1) {
-			break;
-		}
-		k_stack_pop(&stack_2, &data, K_FOREVER);
-		if (data != 2 * i) {
-			break;
-		}
+	uint32_t data;
+
+	k_stack_push(&stack_1, seq);
+	while (k_stack_pop(&stack_2, &data, K_NO_WAIT) != 0) {
+		k_yield();
 	}
+	assert_equal(data, seq, "wrong value received");
+	seq++;
+}
 
-	t = TIME_STAMP_DELTA_GET(t);
+/**
+ *
+ * @brief Stack round trip of two values, each one reversed twice
+ *
+ * k_stack_push, k_stack_push, k_stack_pop(K_FOREVER),
+ * k_stack_pop(K_FOREVER)
+ *
+ * @return N/A
+ *
+ */
+static void stack_batch_iteration(void)
+{
+	uint32_t data;
 
-	return_value += check_result(i * 2, t);
+	k_stack_push(&stack_1, 2 * seq);
+	k_stack_push(&stack_1, 2 * seq + 1);
 
-	return return_value;
+	k_stack_pop(&stack_2, &data, K_FOREVER);
+	assert_equal(data, 2 * seq, "wrong value received");
+	k_stack_pop(&stack_2, &data, K_FOREVER);
+	assert_equal(data, 2 * seq + 1, "wrong value received");
+	seq++;
 }
+
+ZTEST_BENCHMARK_DEFINE(stack_wait, stack_wait_iteration, stack_test_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
+ZTEST_BENCHMARK_DEFINE(stack_yield, stack_yield_iteration, stack_test_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
+ZTEST_BENCHMARK_DEFINE(stack_batch, stack_batch_iteration, stack_batch_init,
+		       helper_wait, WARMUP_LOOPS, NUMBER_OF_LOOPS);
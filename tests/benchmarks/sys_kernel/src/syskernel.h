@@ -9,53 +9,33 @@
 #ifndef SYSKERNEK_H
 #define SYSKERNEK_H
 
-#include <timestamp.h>
-
-#include <stdio.h>
-#include <toolchain.h>
+#include <zephyr.h>
+#include <ztest.h>
 
 #define STACK_SIZE 2048
-#define NUMBER_OF_LOOPS 5000
-
-extern char thread_stack1[STACK_SIZE];
-extern char thread_stack2[STACK_SIZE];
-
-extern FILE *output_file;
-
-extern const char sz_success[];
-extern const char sz_partial[];
-extern const char sz_fail[];
-
-#define sz_module_title_fmt	"\nMODULE: %s"
-#define sz_module_result_fmt	"\n\nPROJECT EXECUTION %s\n"
-#define sz_module_end_fmt	"\nEND MODULE"
+#define WARMUP_LOOPS 100
+#define NUMBER_OF_LOOPS CONFIG_ZTEST_BENCHMARK_SAMPLES
 
-#define sz_date_fmt		"\nBUILD_DATE: %s %s"
-#define sz_kernel_ver_fmt	"\nKERNEL VERSION: 0x%x"
-#define sz_description		"\nTEST COVERAGE: %s"
+/* Round trips of a benchmark, each one echoed by the helper thread */
+#define HELPER_LOOPS (WARMUP_LOOPS + NUMBER_OF_LOOPS)
 
-#define sz_test_case_fmt	"\n\nTEST CASE: %s"
-#define sz_test_start_fmt	"\nStarting test. Please wait..."
-#define sz_case_result_fmt	"\nTEST RESULT: %s"
-#define sz_case_details_fmt	"\nDETAILS: %s"
-#define sz_case_end_fmt		"\nEND TEST CASE"
-#define sz_case_timing_fmt	"%u nSec"
+void helper_start(k_thread_entry_t entry, int num_loops);
+void helper_done(void);
+void helper_wait(void);
 
-int check_result(int i, uint32_t ticks);
+void sema_wait(void);
+void sema_yield(void);
 
-int sema_test(void);
-int lifo_test(void);
-int fifo_test(void);
-int stack_test(void);
-void begin_test(void);
+void lifo_wait(void);
+void lifo_yield(void);
+void lifo_batch(void);
 
-static inline uint32_t BENCH_START(void)
-{
-	uint32_t et;
+void fifo_wait(void);
+void fifo_yield(void);
+void fifo_batch(void);
 
-	begin_test();
-	et = TIME_STAMP_DELTA_GET(0);
-	return et;
-}
+void stack_wait(void);
+void stack_yield(void);
+void stack_batch(void);
 
 #endif /* SYSKERNEK_H */
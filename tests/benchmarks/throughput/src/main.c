@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the throughput of the allocators and IPC objects
+ *
+ * Each benchmark is run by 1, 2 and then 4 threads of the same priority,
+ * time sliced so that they contend for the same object. Every thread runs
+ * a number of bursts, each operating on several blocks or messages of
+ * mixed sizes:
+ * - k_mem_pool, k_mem_slab and k_malloc: allocate the blocks, then free them
+ * - k_msgq and k_pipe: put the messages, then get as many back
+ * - k_mbox: put the messages synchronously, to as many receiving threads
+ *
+ * The number of operations per second and the number of cycles per
+ * operation are shown, then repeated as comma-separated values, after a
+ * "BENCH" prefix, to make them easy to collect and track.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+
+#define MAX_THREADS 4
+#define BURST 4
+#define NUM_BURSTS 256
+#define MAX_SIZE 256
+
+/* the workers only start once main() waits for them */
+#define WORKER_PRIO K_PRIO_PREEMPT(1)
+#define STACK_SIZE 512
+
+static const size_t sizes[] = { 16, 48, 100, 256, 32 };
+
+#define SIZE(thread, burst, i) \
+	sizes[((thread) + (burst) + (i)) % ARRAY_SIZE(sizes)]
+
+/* blocks or messages of all threads, a literal for the pool assembly */
+#define NUM_BLOCKS 16
+
+BUILD_ASSERT(NUM_BLOCKS == MAX_THREADS * BURST);
+
+K_MEM_POOL_DEFINE(pool, 16, MAX_SIZE, NUM_BLOCKS, 4);
+K_MEM_SLAB_DEFINE(slab, MAX_SIZE, NUM_BLOCKS, 4);
+K_MSGQ_DEFINE(msgq, 16, NUM_BLOCKS, 4);
+K_PIPE_DEFINE(pipe, NUM_BLOCKS * MAX_SIZE, 4);
+K_MBOX_DEFINE(mbox);
+
+static K_SEM_DEFINE(done, 0, 2 * MAX_THREADS);
+
+/* mailbox benchmarks have as many receivers as senders */
+static char __stack stacks[2 * MAX_THREADS][STACK_SIZE];
+static k_tid_t tids[2 * MAX_THREADS];
+
+static uint8_t __aligned(4) buffers[2 * MAX_THREADS][BURST][MAX_SIZE];
+
+static int failures;
+
+static void mem_pool_burst(int thread, int burst)
+{
+	struct k_mem_block blocks[BURST];
+
+	for (int i = 0; i < BURST; i++) {
+		if (k_mem_pool_alloc(&pool, &blocks[i], SIZE(thread, burst, i),
+				     K_NO_WAIT)) {
+			failures++;
+			return;
+		}
+	}
+	for (int i = 0; i < BURST; i++) {
+		k_mem_pool_free(&blocks[i]);
+	}
+}
+
+static void mem_slab_burst(int thread, int burst)
+{
+	void *blocks[BURST];
+
+	ARG_UNUSED(burst);
+
+	for (int i = 0; i < BURST; i++) {
+		if (k_mem_slab_alloc(&slab, &blocks[i], K_NO_WAIT)) {
+			failures++;
+			return;
+		}
+	}
+	for (int i = 0; i < BURST; i++) {
+		k_mem_slab_free(&slab, &blocks[i]);
+	}
+}
+
+static void malloc_burst(int thread, int burst)
+{
+	void *blocks[BURST];
+
+	for (int i = 0; i < BURST; i++) {
+		blocks[i] = k_malloc(SIZE(thread, burst, i));
+		if (!blocks[i]) {
+			failures++;
+			return;
+		}
+	}
+	for (int i = 0; i < BURST; i++) {
+		k_free(blocks[i]);
+	}
+}
+
+static void msgq_burst(int thread, int burst)
+{
+	ARG_UNUSED(burst);
+
+	/* the queue has room for the messages of all threads */
+	for (int i = 0; i < BURST; i++) {
+		if (k_msgq_put(&msgq, buffers[thread][i], K_NO_WAIT)) {
+			failures++;
+			return;
+		}
+	}
+	for (int i = 0; i < BURST; i++) {
+		k_msgq_get(&msgq, buffers[thread][i], K_NO_WAIT);
+	}
+}
+
+static void pipe_burst(int thread, int burst)
+{
+	size_t bytes;
+
+	/*
+	 * Threads get back as many bytes as they put, maybe put by others:
+	 * there are always enough bytes in the pipe.
+	 */
+	for (int i = 0; i < BURST; i++) {
+		size_t size = SIZE(thread, burst, i);
+
+		if (k_pipe_put(&pipe, buffers[thread][i], size, &bytes, size,
+			       K_NO_WAIT)) {
+			failures++;
+			return;
+		}
+	}
+	for (int i = 0; i < BURST; i++) {
+		size_t size = SIZE(thread, burst, i);
+
+		k_pipe_get(&pipe, buffers[thread][i], size, &bytes, size,
+			   K_NO_WAIT);
+	}
+}
+
+static void mbox_burst(int thread, int burst)
+{
+	struct k_mbox_msg msg;
+
+	for (int i = 0; i < BURST; i++) {
+		msg.size = SIZE(thread, burst, i);
+		msg.info = 0;
+		msg.tx_data = buffers[thread][i];
+		msg.tx_block.data = NULL;
+		msg.tx_target_thread = K_ANY;
+		if (k_mbox_put(&mbox, &msg, K_FOREVER)) {
+			failures++;
+		}
+	}
+}
+
+/*
+ * Receivers are the workers after the senders: they get the messages of
+ * the same number of bursts.
+ */
+static void mbox_receive_burst(int thread, int burst)
+{
+	struct k_mbox_msg msg;
+
+	ARG_UNUSED(burst);
+
+	for (int i = 0; i < BURST; i++) {
+		msg.size = MAX_SIZE;
+		msg.rx_source_thread = K_ANY;
+		if (k_mbox_get(&mbox, &msg, buffers[thread][i], K_FOREVER)) {
+			failures++;
+		}
+	}
+}
+
+typedef void (*burst_t)(int thread, int burst);
+
+struct bench {
+	const char *name;
+	burst_t burst;
+	burst_t receive_burst;
+};
+
+static const struct bench benches[] = {
+	{ "k_mem_pool", mem_pool_burst },
+	{ "k_mem_slab", mem_slab_burst },
+	{ "k_malloc", malloc_burst },
+	{ "k_msgq", msgq_burst },
+	{ "k_pipe", pipe_burst },
+	{ "k_mbox", mbox_burst, mbox_receive_burst },
+};
+
+struct result {
+	uint32_t ops;
+	uint32_t cycles;
+};
+
+static struct result results[ARRAY_SIZE(benches)][MAX_THREADS + 1];
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	burst_t burst = p1;
+	int thread = (int)p2;
+
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < NUM_BURSTS; i++) {
+		burst(thread, i);
+	}
+
+	k_sem_give(&done);
+
+	/* wait to be aborted */
+	k_thread_suspend(k_current_get());
+}
+
+static void spawn(int thread, burst_t burst)
+{
+	tids[thread] = k_thread_spawn(stacks[thread], STACK_SIZE, worker,
+				      burst, (void *)thread, NULL,
+				      WORKER_PRIO, 0, K_NO_WAIT);
+}
+
+static void run(const struct bench *bench, int num_threads,
+		struct result *result)
+{
+	int num_workers = 0;
+	uint32_t start;
+
+	for (int i = 0; i < num_threads; i++) {
+		spawn(num_workers++, bench->burst);
+	}
+	if (bench->receive_burst) {
+		for (int i = 0; i < num_threads; i++) {
+			spawn(num_workers++, bench->receive_burst);
+		}
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < num_workers; i++) {
+		k_sem_take(&done, K_FOREVER);
+	}
+	result->cycles = k_cycle_get_32() - start;
+	result->ops = num_threads * NUM_BURSTS * BURST;
+
+	for (int i = 0; i < num_workers; i++) {
+		k_thread_abort(tids[i]);
+	}
+}
+
+static uint32_t ops_per_sec(const struct result *result)
+{
+	return (uint64_t)result->ops * sys_clock_hw_cycles_per_sec /
+	       result->cycles;
+}
+
+void main(void)
+{
+	int status = TC_PASS;
+
+	TC_START("Allocator and IPC Throughput Measurement");
+
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		for (int n = 1; n <= MAX_THREADS; n *= 2) {
+			struct result *result = &results[i][n];
+
+			run(&benches[i], n, result);
+			TC_PRINT("%-10s %d thread(s): %8u ops/s, %6u cycles/op\n",
+				 benches[i].name, n, ops_per_sec(result),
+				 result->cycles / result->ops);
+		}
+	}
+
+	if (failures) {
+		TC_ERROR("%d operations failed\n", failures);
+		status = TC_FAIL;
+	}
+
+	TC_PRINT("BENCH,name,threads,ops,cycles,ops_per_sec,cycles_per_op\n");
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		for (int n = 1; n <= MAX_THREADS; n *= 2) {
+			struct result *result = &results[i][n];
+
+			TC_PRINT("BENCH,%s,%d,%u,%u,%u,%u\n", benches[i].name,
+				 n, result->ops, result->cycles,
+				 ops_per_sec(result),
+				 result->cycles / result->ops);
+		}
+	}
+
+	TC_END_RESULT(status);
+	TC_END_REPORT(status);
+}
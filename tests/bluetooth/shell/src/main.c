@@ -774,6 +774,159 @@ static int cmd_gatt_exchange_mtu(int argc, char *argv[])
 	return 0;
 }
 
+static int cmd_conn_update(int argc, char *argv[])
+{
+	struct bt_le_conn_param param;
+	int err;
+
+	if (!default_conn) {
+		printk("Not connected\n");
+		return 0;
+	}
+
+	if (argc < 5) {
+		return -EINVAL;
+	}
+
+	param.interval_min = strtoul(argv[1], NULL, 16);
+	param.interval_max = strtoul(argv[2], NULL, 16);
+	param.latency = strtoul(argv[3], NULL, 16);
+	param.timeout = strtoul(argv[4], NULL, 16);
+
+	err = bt_conn_le_param_update(default_conn, &param);
+	if (err) {
+		printk("conn update failed (err %d).\n", err);
+	} else {
+		printk("conn update initiated.\n");
+	}
+
+	return 0;
+}
+
+/* While the benchmark is on the data received is counted instead of being
+ * printed. The CPU load is derived from the loops an idle thread of the
+ * lowest priority gets to do, against the loops it does with nothing else
+ * to run.
+ */
+#define BENCH_IDLE_STACK_SIZE	256
+#define BENCH_CALIBRATE_MS	100
+#define BENCH_IDLE_PRIO		K_LOWEST_APPLICATION_THREAD_PRIO
+
+static char __noinit __stack bench_idle_stack[BENCH_IDLE_STACK_SIZE];
+static k_tid_t bench_idle_tid;
+static volatile uint32_t bench_idle_loops;
+static uint32_t bench_idle_loops_per_ms;
+
+static struct {
+	bool on;
+	uint32_t start;
+	uint32_t idle_start;
+	uint32_t rx_bytes;
+	uint32_t rx_count;
+	uint32_t tx_bytes;
+	uint32_t tx_count;
+} bench;
+
+static void bench_idle(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		bench_idle_loops++;
+	}
+}
+
+static void bench_rx(uint16_t len)
+{
+	bench.rx_bytes += len;
+	bench.rx_count++;
+}
+
+static void bench_tx(uint16_t len)
+{
+	bench.tx_bytes += len;
+	bench.tx_count++;
+}
+
+static void bench_print(const char *dir, uint32_t bytes, uint32_t count,
+			uint32_t ms)
+{
+	/* Bits per millisecond are kbps */
+	printk("%s: %u bytes in %u packets, %u kbps\n", dir, bytes, count,
+	       ms ? bytes * 8 / ms : 0);
+}
+
+static void bench_start(void)
+{
+	uint32_t loops;
+
+	if (!bench_idle_tid) {
+		bench_idle_tid = k_thread_spawn(bench_idle_stack,
+						sizeof(bench_idle_stack),
+						bench_idle, NULL, NULL, NULL,
+						BENCH_IDLE_PRIO, 0, K_NO_WAIT);
+	} else {
+		k_thread_resume(bench_idle_tid);
+	}
+
+	/* The idle loops with nothing else to run */
+	loops = bench_idle_loops;
+	k_sleep(BENCH_CALIBRATE_MS);
+	bench_idle_loops_per_ms = (bench_idle_loops - loops) /
+				  BENCH_CALIBRATE_MS;
+
+	memset(&bench, 0, sizeof(bench));
+	bench.idle_start = bench_idle_loops;
+	bench.start = k_uptime_get_32();
+	bench.on = true;
+}
+
+static void bench_stop(void)
+{
+	uint32_t ms, idle, load = 100;
+
+	ms = k_uptime_get_32() - bench.start;
+	idle = bench_idle_loops - bench.idle_start;
+
+	bench.on = false;
+	k_thread_suspend(bench_idle_tid);
+
+	if (ms && bench_idle_loops_per_ms) {
+		idle = idle / ms * 100 / bench_idle_loops_per_ms;
+		load = idle < 100 ? 100 - idle : 0;
+	}
+
+	printk("Bench %u ms, CPU load %u%%\n", ms, load);
+	bench_print("RX", bench.rx_bytes, bench.rx_count, ms);
+	bench_print("TX", bench.tx_bytes, bench.tx_count, ms);
+}
+
+static int cmd_bench(int argc, char *argv[])
+{
+	if (argc < 2) {
+		return -EINVAL;
+	}
+
+	if (!strcmp(argv[1], "on")) {
+		if (bench.on) {
+			printk("Bench already on\n");
+			return 0;
+		}
+
+		bench_start();
+		printk("Bench on\n");
+	} else if (!strcmp(argv[1], "off")) {
+		if (!bench.on) {
+			printk("Bench not on\n");
+			return 0;
+		}
+
+		bench_stop();
+	} else {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static const struct bt_data ad_discov[] = {
 	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
 };
@@ -1224,6 +1377,11 @@ static uint8_t notify_func(struct bt_conn *conn,
 		return BT_GATT_ITER_STOP;
 	}
 
+	if (bench.on) {
+		bench_rx(length);
+		return BT_GATT_ITER_CONTINUE;
+	}
+
 	printk("Notification: data %p length %u\n", data, length);
 
 	return BT_GATT_ITER_CONTINUE;
@@ -1396,15 +1554,238 @@ static struct bt_gatt_attr vnd_attrs[] = {
 				&vnd_long_value2),
 };
 
+static struct bt_uuid_128 bench_uuid = BT_UUID_INIT_128(
+	0xf4, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+static struct bt_uuid_128 bench_data_uuid = BT_UUID_INIT_128(
+	0xf5, 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12);
+
+static struct bt_gatt_ccc_cfg bench_ccc_cfg[CONFIG_BLUETOOTH_MAX_PAIRED] = {};
+
+static void bench_ccc_cfg_changed(const struct bt_gatt_attr *attr,
+				  uint16_t value)
+{
+}
+
+static ssize_t write_bench(struct bt_conn *conn,
+			   const struct bt_gatt_attr *attr, const void *buf,
+			   uint16_t len, uint16_t offset, uint8_t flags)
+{
+	if (bench.on) {
+		bench_rx(len);
+	}
+
+	return len;
+}
+
+/* Service the data of the benchmark is written to and notified from */
+static struct bt_gatt_attr bench_attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(&bench_uuid),
+
+	BT_GATT_CHARACTERISTIC(&bench_data_uuid.uuid,
+			       BT_GATT_CHRC_WRITE_WITHOUT_RESP |
+			       BT_GATT_CHRC_NOTIFY),
+	BT_GATT_DESCRIPTOR(&bench_data_uuid.uuid, BT_GATT_PERM_WRITE,
+			   NULL, write_bench, NULL),
+	BT_GATT_CCC(bench_ccc_cfg, bench_ccc_cfg_changed),
+};
+
 static int cmd_gatt_register_test_svc(int argc, char *argv[])
 {
 	bt_gatt_register(vnd_attrs, ARRAY_SIZE(vnd_attrs));
+	bt_gatt_register(bench_attrs, ARRAY_SIZE(bench_attrs));
 
 	printk("Registering test vendor service\n");
 
 	return 0;
 }
 
+static uint16_t bench_len(int argc, char *argv[], int arg)
+{
+	uint16_t len = bt_gatt_get_mtu(default_conn) - 3;
+
+	if (argc > arg) {
+		len = min(strtoul(argv[arg], NULL, 10), len);
+	}
+
+	return min(len, sizeof(gatt_write_buf));
+}
+
+static int cmd_bench_write(int argc, char *argv[])
+{
+	uint32_t count, sent = 0, start;
+	uint16_t handle, len;
+	int err = 0;
+
+	if (!default_conn) {
+		printk("Not connected\n");
+		return 0;
+	}
+
+	if (argc < 3) {
+		return -EINVAL;
+	}
+
+	handle = strtoul(argv[1], NULL, 16);
+	count = strtoul(argv[2], NULL, 10);
+	len = bench_len(argc, argv, 3);
+
+	start = k_uptime_get_32();
+
+	for (; sent < count; sent++) {
+		err = bt_gatt_write_without_response(default_conn, handle,
+						     gatt_write_buf, len,
+						     false);
+		if (err) {
+			break;
+		}
+
+		bench_tx(len);
+	}
+
+	printk("Wrote %u x %u bytes in %u ms (err %d)\n", sent, len,
+	       k_uptime_get_32() - start, err);
+
+	return 0;
+}
+
+static int cmd_bench_notify(int argc, char *argv[])
+{
+	uint32_t count, sent = 0, start;
+	uint16_t len;
+	int err = 0;
+
+	if (!default_conn) {
+		printk("Not connected\n");
+		return 0;
+	}
+
+	if (argc < 2) {
+		return -EINVAL;
+	}
+
+	count = strtoul(argv[1], NULL, 10);
+	len = bench_len(argc, argv, 2);
+
+	start = k_uptime_get_32();
+
+	for (; sent < count; sent++) {
+		err = bt_gatt_notify(default_conn, &bench_attrs[2],
+				     gatt_write_buf, len);
+		if (err) {
+			break;
+		}
+
+		bench_tx(len);
+	}
+
+	printk("Notified %u x %u bytes in %u ms (err %d)\n", sent, len,
+	       k_uptime_get_32() - start, err);
+
+	return 0;
+}
+
+/* Round trips of reads issued one after the other */
+static struct {
+	struct bt_gatt_read_params params;
+	uint32_t left;
+	uint32_t sent;
+	uint32_t count;
+	uint32_t total;
+	uint32_t min;
+	uint32_t max;
+} bench_read;
+
+static void bench_read_done(uint8_t err)
+{
+	printk("Read %u times (err %u)", bench_read.count, err);
+
+	if (bench_read.count) {
+		printk(", round trip %u ms, min %u ms, max %u ms",
+		       bench_read.total / bench_read.count, bench_read.min,
+		       bench_read.max);
+	}
+
+	printk("\n");
+
+	bench_read.params.func = NULL;
+}
+
+static uint8_t bench_read_func(struct bt_conn *conn, uint8_t err,
+			       struct bt_gatt_read_params *params,
+			       const void *data, uint16_t length)
+{
+	uint32_t ms = k_uptime_get_32() - bench_read.sent;
+
+	if (err || !data) {
+		bench_read_done(err);
+		return BT_GATT_ITER_STOP;
+	}
+
+	bench_read.count++;
+	bench_read.total += ms;
+	bench_read.min = min(bench_read.min, ms);
+	bench_read.max = max(bench_read.max, ms);
+
+	bench_rx(length);
+
+	if (!--bench_read.left) {
+		bench_read_done(0);
+		return BT_GATT_ITER_STOP;
+	}
+
+	/* Only the first part of the value is read each time */
+	bench_read.sent = k_uptime_get_32();
+	if (bt_gatt_read(conn, params) < 0) {
+		bench_read_done(BT_ATT_ERR_UNLIKELY);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+static int cmd_bench_read(int argc, char *argv[])
+{
+	int err;
+
+	if (!default_conn) {
+		printk("Not connected\n");
+		return 0;
+	}
+
+	if (bench_read.params.func) {
+		printk("Read ongoing\n");
+		return 0;
+	}
+
+	if (argc < 3) {
+		return -EINVAL;
+	}
+
+	memset(&bench_read, 0, sizeof(bench_read));
+	bench_read.params.func = bench_read_func;
+	bench_read.params.handle_count = 1;
+	bench_read.params.single.handle = strtoul(argv[1], NULL, 16);
+	bench_read.left = strtoul(argv[2], NULL, 10);
+	bench_read.min = UINT32_MAX;
+
+	if (!bench_read.left) {
+		return -EINVAL;
+	}
+
+	bench_read.sent = k_uptime_get_32();
+
+	err = bt_gatt_read(default_conn, &bench_read.params);
+	if (err) {
+		bench_read.params.func = NULL;
+		printk("Read failed (err %d)\n", err);
+	} else {
+		printk("Read pending\n");
+	}
+
+	return 0;
+}
+
 static bool hrs_simulate;
 
 static int cmd_hrs_simulate(int argc, char *argv[])
@@ -1943,6 +2324,11 @@ static void hexdump(const uint8_t *data, size_t len)
 
 static void l2cap_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 {
+	if (bench.on) {
+		bench_rx(buf->len);
+		return;
+	}
+
 	printk("Incoming data channel %p len %u\n", chan, buf->len);
 
 	if (buf->len) {
@@ -2066,16 +2452,18 @@ static int cmd_l2cap_disconnect(int argc, char *argv[])
 static int cmd_l2cap_send(int argc, char *argv[])
 {
 	static uint8_t buf_data[DATA_MTU] = { [0 ... (DATA_MTU - 1)] = 0xff };
-	int ret, len, count = 1;
+	int ret, len, count = 1, sent = 0;
 	struct net_buf *buf;
+	uint32_t start;
 
 	if (argc > 1) {
 		count = strtoul(argv[1], NULL, 10);
 	}
 
 	len = min(l2cap_chan.tx.mtu, DATA_MTU - BT_L2CAP_CHAN_SEND_RESERVE);
+	start = k_uptime_get_32();
 
-	while (count--) {
+	for (; sent < count; sent++) {
 		buf = net_buf_alloc(&data_pool, K_FOREVER);
 		net_buf_reserve(buf, BT_L2CAP_CHAN_SEND_RESERVE);
 
@@ -2086,8 +2474,13 @@ static int cmd_l2cap_send(int argc, char *argv[])
 			net_buf_unref(buf);
 			break;
 		}
+
+		bench_tx(len);
 	}
 
+	printk("Sent %d x %d bytes in %u ms\n", sent, len,
+	       k_uptime_get_32() - start);
+
 	return 0;
 }
 #endif
@@ -2451,6 +2844,8 @@ static const struct shell_cmd commands[] = {
 	{ "auth-pincode", cmd_auth_pincode, "<pincode>" },
 #endif /* CONFIG_BLUETOOTH_BREDR */
 #endif /* CONFIG_BLUETOOTH_SMP || CONFIG_BLUETOOTH_BREDR) */
+	{ "conn-update", cmd_conn_update,
+	  "<min interval> <max interval> <latency> <timeout>" },
 	{ "gatt-exchange-mtu", cmd_gatt_exchange_mtu, HELP_NONE },
 	{ "gatt-discover-primary", cmd_gatt_discover,
 	  "<UUID> [start handle] [end handle]" },
@@ -2476,6 +2871,10 @@ static const struct shell_cmd commands[] = {
 	  "register pre-predefined test service" },
 	{ "hrs-simulate", cmd_hrs_simulate,
 	  "register and simulate Heart Rate Service <value: on, off>" },
+	{ "bench", cmd_bench, "<value: on, off>" },
+	{ "bench-write", cmd_bench_write, "<handle> <count> [length]" },
+	{ "bench-notify", cmd_bench_notify, "<count> [length]" },
+	{ "bench-read", cmd_bench_read, "<handle> <count>" },
 #if defined(CONFIG_BLUETOOTH_L2CAP_DYNAMIC_CHANNEL)
 	{ "l2cap-register", cmd_l2cap_register, "<psm> [sec_level]" },
 	{ "l2cap-connect", cmd_l2cap_connect, "<psm>" },
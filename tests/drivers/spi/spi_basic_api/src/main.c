@@ -41,12 +41,14 @@
 void test_spi_cpol(void);
 void test_spi_cpha(void);
 void test_spi_cpol_cpha(void);
+void test_spi_async(void);
 
 void test_main(void)
 {
 	ztest_test_suite(spi_test,
 			 ztest_unit_test(test_spi_cpol),
 			 ztest_unit_test(test_spi_cpha),
-			 ztest_unit_test(test_spi_cpol_cpha));
+			 ztest_unit_test(test_spi_cpol_cpha),
+			 ztest_unit_test(test_spi_async));
 	ztest_run_test_suite(spi_test);
 }
@@ -103,3 +103,78 @@ void test_spi_cpol_cpha(void)
 	assert_true(test_spi(SPI_WORD(8) | SPI_MODE_CPOL | SPI_MODE_CPHA)
 					== TC_PASS, NULL);
 }
+
+static K_SEM_DEFINE(async_sem, 0, 2);
+static int async_status[2];
+
+static void async_done(struct device *dev, struct spi_transaction *trans,
+		       int status)
+{
+	async_status[POINTER_TO_INT(trans->user_data)] = status;
+	k_sem_give(&async_sem);
+}
+
+static int test_spi_async_transactions(uint32_t mode)
+{
+	struct device *spi_dev = device_get_binding(SPI_DEV_NAME);
+	static unsigned char cmd[] = "Command";
+	static unsigned char data[] = "and data";
+	static unsigned char rcmd[sizeof(cmd)];
+	static unsigned char rdata[sizeof(data)];
+	const struct spi_transfer xfers[] = {
+		{ cmd, sizeof(cmd), rcmd, sizeof(rcmd) },
+		{ data, sizeof(data), rdata, sizeof(rdata) },
+	};
+	struct spi_transaction trans[2] = {
+		{ .transfers = xfers, .count = 2, .callback = async_done,
+		  .user_data = INT_TO_POINTER(0) },
+		{ .transfers = xfers, .count = 1, .callback = async_done,
+		  .user_data = INT_TO_POINTER(1) },
+	};
+	int err;
+
+	if (!spi_dev) {
+		TC_PRINT("Cannot get SPI device\n");
+		return TC_FAIL;
+	}
+
+	spi_conf.config = mode | SPI_MODE_LOOP;
+	if (spi_configure(spi_dev, &spi_conf)) {
+		TC_PRINT("SPI config failed\n");
+		return TC_FAIL;
+	}
+
+	/* Both are queued at once, the second one waiting for the first */
+	err = spi_transceive_async(spi_dev, &trans[0]);
+	if (err == -ENOTSUP) {
+		TC_PRINT("No asynchronous support\n");
+		return TC_PASS;
+	}
+
+	if (err || spi_transceive_async(spi_dev, &trans[1])) {
+		TC_PRINT("SPI async transceive failed\n");
+		return TC_FAIL;
+	}
+
+	k_sem_take(&async_sem, K_FOREVER);
+	k_sem_take(&async_sem, K_FOREVER);
+
+	if (async_status[0] || async_status[1]) {
+		TC_PRINT("SPI async transaction failed\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("SPI transceived: %s %s\n", rcmd, rdata);
+
+	if (strcmp(cmd, rcmd) || strcmp(data, rdata)) {
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+void test_spi_async(void)
+{
+	TC_PRINT("Test asynchronous transactions\n");
+	assert_true(test_spi_async_transactions(SPI_WORD(8)) == TC_PASS, NULL);
+}
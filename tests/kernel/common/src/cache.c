@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <cache.h>
+#include <string.h>
+
+#define BUF_SIZE 100
+
+static K_DMA_BUFFER_DEFINE(dma_buf, BUF_SIZE);
+
+void cache_dma_buffer_test(void)
+{
+	/* the buffer spans whole cache lines */
+	assert_equal((uint32_t)dma_buf % DMA_BUFFER_ALIGN, 0, NULL);
+	assert_equal(sizeof(dma_buf) % DMA_BUFFER_ALIGN, 0, NULL);
+	assert_true(sizeof(dma_buf) >= BUF_SIZE, NULL);
+	assert_true(sizeof(dma_buf) < BUF_SIZE + DMA_BUFFER_ALIGN, NULL);
+
+	/* maintaining the cache leaves the data as written */
+	memset(dma_buf, 0x5a, sizeof(dma_buf));
+	sys_cache_data_range_flush(dma_buf, sizeof(dma_buf));
+	sys_cache_data_range_invalidate(dma_buf, sizeof(dma_buf));
+	for (int i = 0; i < sizeof(dma_buf); i++) {
+		assert_equal(dma_buf[i], 0x5a, NULL);
+	}
+
+	/* as well as empty ranges */
+	sys_cache_data_range_flush(dma_buf, 0);
+	sys_cache_data_range_invalidate(dma_buf, 0);
+}
@@ -14,12 +14,15 @@ extern void atomic_test(void);
 extern void bitfield_test(void);
 extern void intmath_test(void);
 extern void printk_test(void);
+extern void printk_deferred_test(void);
 extern void ring_buffer_test(void);
+extern void byte_ring_buffer_test(void);
 extern void slist_test(void);
 extern void dlist_test(void);
 extern void rand32_test(void);
 extern void rand32_test(void);
 extern void timeout_order_test(void);
+extern void cache_dma_buffer_test(void);
 
 void test_main(void)
 {
@@ -29,13 +32,18 @@ void test_main(void)
 			 ztest_unit_test(atomic_test),
 #ifdef CONFIG_PRINTK
 			 ztest_unit_test(printk_test),
+#endif
+#ifdef CONFIG_PRINTK_DEFERRED
+			 ztest_unit_test(printk_deferred_test),
 #endif
 			 ztest_unit_test(ring_buffer_test),
+			 ztest_unit_test(byte_ring_buffer_test),
 			 ztest_unit_test(slist_test),
 			 ztest_unit_test(dlist_test),
 			 ztest_unit_test(rand32_test),
 			 ztest_unit_test(intmath_test),
-			 ztest_unit_test(timeout_order_test)
+			 ztest_unit_test(timeout_order_test),
+			 ztest_unit_test(cache_dma_buffer_test)
 			 );
 
 	ztest_run_test_suite(common_test);
@@ -59,6 +59,9 @@ void printk_test(void)
 {
 	int count;
 
+	/* output pending messages before capturing the console */
+	printk_flush();
+
 	_old_char_out = _char_out;
 	_char_out = ram_console_out;
 
@@ -71,6 +74,7 @@ void printk_test(void)
 	printk("%d %02d %04d %08d\n", -42, -42, -42, -42);
 	printk("%u %2u %4u %8u\n", 42, 42, 42, 42);
 	printk("%u %02u %04u %08u\n", 42, 42, 42, 42);
+	printk_flush();
 
 	ram_console[pos] = '\0';
 	assert_true((strcmp(ram_console, expected) == 0), "printk failed");
@@ -101,3 +105,29 @@ void printk_test(void)
 	ram_console[count] = '\0';
 	assert_true((strcmp(ram_console, expected) == 0), "snprintk failed");
 }
+
+#ifdef CONFIG_PRINTK_DEFERRED
+void printk_deferred_test(void)
+{
+	printk_flush();
+
+	if (_char_out != ram_console_out) {
+		_old_char_out = _char_out;
+		_char_out = ram_console_out;
+	}
+
+	memset(ram_console, 0, sizeof(ram_console));
+	pos = 0;
+
+	printk("%d %s 0x%x\n", -42, "deferred", hex);
+	printk("no arguments\n");
+
+	/* nothing is output until the messages are flushed */
+	assert_equal(pos, 0, "printk not deferred");
+
+	printk_flush();
+	assert_true((strcmp(ram_console,
+			    "-42 deferred 0xcafebabe\nno arguments\n") == 0),
+		    "deferred printk failed");
+}
+#endif
@@ -67,3 +67,64 @@ void ring_buffer_test(void)
 			       &getsize);
 	assert_true((ret == -EAGAIN), "Got data out of an empty buffer");
 }
+
+SYS_BYTE_RING_BUF_DECLARE_POW2(byte_ring_buf, 4);
+
+void byte_ring_buffer_test(void)
+{
+	uint8_t getdata[sizeof(data)];
+	uint8_t *claim;
+	uint32_t ret;
+	int i;
+
+	assert_true(sys_byte_ring_buf_is_empty(&byte_ring_buf), NULL);
+	assert_equal(sys_byte_ring_buf_space_get(&byte_ring_buf), 16, NULL);
+
+	/* move the indexes so that the data wraps around the end */
+	ret = sys_byte_ring_buf_put(&byte_ring_buf, (uint8_t *)data, 10);
+	assert_equal(ret, 10, "Couldn't store bytes");
+	ret = sys_byte_ring_buf_get(&byte_ring_buf, getdata, 10);
+	assert_equal(ret, 10, "Couldn't retrieve bytes");
+	assert_true(memcmp(getdata, data, 10) == 0, "data corrupted");
+
+	/* the buffer can be filled completely, across the end */
+	ret = sys_byte_ring_buf_put(&byte_ring_buf, (uint8_t *)data,
+				    sizeof(data));
+	assert_equal(ret, 16, "Couldn't fill the buffer");
+	assert_equal(sys_byte_ring_buf_space_get(&byte_ring_buf), 0, NULL);
+	ret = sys_byte_ring_buf_put_claim(&byte_ring_buf, &claim, 1);
+	assert_equal(ret, 0, "Claimed space in a full buffer");
+	assert_equal(sys_byte_ring_buf_put_finish(&byte_ring_buf, 1), -EINVAL,
+		     "Committed bytes to a full buffer");
+
+	/* claims stop at the end of the buffer */
+	ret = sys_byte_ring_buf_get_claim(&byte_ring_buf, &claim, 16);
+	assert_equal(ret, 6, "Claim went past the end of the buffer");
+	assert_true(memcmp(claim, data, 6) == 0, "data corrupted");
+	assert_equal(sys_byte_ring_buf_get_finish(&byte_ring_buf, 6), 0, NULL);
+
+	ret = sys_byte_ring_buf_get_claim(&byte_ring_buf, &claim, 16);
+	assert_equal(ret, 10, "Couldn't claim the rest of the data");
+	assert_true(memcmp(claim, data + 6, 10) == 0, "data corrupted");
+	assert_equal(sys_byte_ring_buf_get_finish(&byte_ring_buf, 11), -EINVAL,
+		     "Freed more bytes than stored");
+	assert_equal(sys_byte_ring_buf_get_finish(&byte_ring_buf, 10), 0, NULL);
+	assert_true(sys_byte_ring_buf_is_empty(&byte_ring_buf), NULL);
+
+	/* bytes written in place are read in order */
+	ret = sys_byte_ring_buf_put_claim(&byte_ring_buf, &claim, 4);
+	assert_equal(ret, 4, "Couldn't claim space");
+	for (i = 0; i < 4; i++) {
+		claim[i] = i;
+	}
+	assert_equal(sys_byte_ring_buf_is_empty(&byte_ring_buf), 1,
+		     "Bytes visible before being committed");
+	assert_equal(sys_byte_ring_buf_put_finish(&byte_ring_buf, 4), 0, NULL);
+	assert_equal(sys_byte_ring_buf_get(&byte_ring_buf, getdata, 8), 4, NULL);
+	for (i = 0; i < 4; i++) {
+		assert_equal(getdata[i], i, "data corrupted");
+	}
+
+	ret = sys_byte_ring_buf_get(&byte_ring_buf, getdata, sizeof(getdata));
+	assert_equal(ret, 0, "Got data out of an empty buffer");
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_device
+ * @{
+ * @defgroup t_device_binding test_device_binding
+ * @brief TestPurpose: verify device lookup by name
+ * - API coverage
+ *   -# device_get_binding
+ *   -# device_get_binding_cached
+ * @}
+ */
+
+#include <ztest.h>
+#include <device.h>
+
+#define DUMMY_NAME_0 "dummy_0"
+#define DUMMY_NAME_1 "dummy_1"
+#define DUMMY_NAME_2 "dummy_2"
+#define DUMMY_NAME_NO_API "dummy_no_api"
+
+static const int dummy_api;
+
+static int dummy_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+DEVICE_AND_API_INIT(dummy_0, DUMMY_NAME_0, dummy_init, NULL, NULL,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &dummy_api);
+DEVICE_AND_API_INIT(dummy_1, DUMMY_NAME_1, dummy_init, NULL, NULL,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &dummy_api);
+DEVICE_AND_API_INIT(dummy_2, DUMMY_NAME_2, dummy_init, NULL, NULL,
+		    APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &dummy_api);
+DEVICE_AND_API_INIT(dummy_no_api, DUMMY_NAME_NO_API, dummy_init, NULL, NULL,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, NULL);
+
+void test_device_get_binding(void)
+{
+	const char *names[] = { DUMMY_NAME_0, DUMMY_NAME_1, DUMMY_NAME_2 };
+	struct device *dev;
+	struct device *prev = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(names); i++) {
+		/**TESTPOINT: devices are found by name*/
+		dev = device_get_binding(names[i]);
+		assert_not_null(dev, NULL);
+		assert_equal(strcmp(dev->config->name, names[i]), 0, NULL);
+		assert_true(dev != prev, NULL);
+		prev = dev;
+	}
+
+	/**TESTPOINT: unknown names and devices without API are not found*/
+	assert_is_null(device_get_binding("dummy"), NULL);
+	assert_is_null(device_get_binding("dummy_3"), NULL);
+	assert_is_null(device_get_binding(""), NULL);
+	assert_is_null(device_get_binding(DUMMY_NAME_NO_API), NULL);
+}
+
+void test_device_get_binding_cached(void)
+{
+	static struct device *cache;
+	struct device *dev = device_get_binding(DUMMY_NAME_1);
+	struct device *missing = NULL;
+
+	/**TESTPOINT: the first successful lookup fills the cache*/
+	assert_is_null(cache, NULL);
+	assert_equal_ptr(device_get_binding_cached(&cache, DUMMY_NAME_1), dev,
+			 NULL);
+	assert_equal_ptr(cache, dev, NULL);
+
+	/**TESTPOINT: the cached device is returned as is afterwards*/
+	assert_equal_ptr(device_get_binding_cached(&cache, DUMMY_NAME_1), dev,
+			 NULL);
+
+	/**TESTPOINT: failed lookups are not cached*/
+	assert_is_null(device_get_binding_cached(&missing, "dummy_3"), NULL);
+	assert_is_null(missing, NULL);
+}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+extern void test_device_async_concurrent(void);
+extern void test_device_async_deps(void);
+extern void test_device_async_deferred(void);
+#endif
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_device,
+			 ztest_unit_test(test_device_get_binding),
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+			 ztest_unit_test(test_device_async_concurrent),
+			 ztest_unit_test(test_device_async_deps),
+			 ztest_unit_test(test_device_async_deferred),
+#endif
+			 ztest_unit_test(test_device_get_binding_cached));
+	ztest_run_test_suite(test_device);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_device
+ * @{
+ * @defgroup t_device_async test_device_async
+ * @brief TestPurpose: verify asynchronous device initialization
+ * - API coverage
+ *   -# DEVICE_INIT_ASYNC
+ * @}
+ */
+
+#include <ztest.h>
+#include <device.h>
+
+#define SLOW_INIT_MS 50
+
+static const int async_api;
+
+static int64_t slow_start[2], slow_end[2];
+static int dep_init_ok;
+static int app_init_ok;
+static int deferred_inits;
+
+static int slow_init(struct device *dev)
+{
+	int i = (dev->config->name[5] == '0') ? 0 : 1;
+
+	slow_start[i] = k_uptime_get();
+	k_sleep(SLOW_INIT_MS);
+	slow_end[i] = k_uptime_get();
+
+	return 0;
+}
+
+static int dep_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	dep_init_ok = slow_end[0] != 0;
+
+	return 0;
+}
+
+static int app_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	app_init_ok = slow_end[0] != 0 && slow_end[1] != 0;
+
+	return 0;
+}
+
+static int deferred_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	deferred_inits++;
+
+	return 0;
+}
+
+DEVICE_AND_API_INIT(async_dep, "async_dep", dep_init, NULL, NULL,
+		    POST_KERNEL, 10, &async_api);
+DEVICE_INIT_ASYNC(async_dep, 0, "slow_0");
+
+DEVICE_AND_API_INIT(slow_0, "slow_0", slow_init, NULL, NULL,
+		    POST_KERNEL, 20, &async_api);
+DEVICE_INIT_ASYNC(slow_0, 0);
+
+DEVICE_AND_API_INIT(slow_1, "slow_1", slow_init, NULL, NULL,
+		    POST_KERNEL, 20, &async_api);
+DEVICE_INIT_ASYNC(slow_1, 0);
+
+DEVICE_AND_API_INIT(async_app, "async_app", app_init, NULL, NULL,
+		    APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &async_api);
+
+DEVICE_AND_API_INIT(async_deferred, "async_deferred", deferred_init, NULL,
+		    NULL, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &async_api);
+DEVICE_INIT_ASYNC(async_deferred, DEVICE_INIT_DEFERRED);
+
+void test_device_async_concurrent(void)
+{
+	/**TESTPOINT: devices of a level are initialized concurrently*/
+	assert_true(slow_start[1] < slow_end[0], NULL);
+	assert_true(slow_start[0] < slow_end[1], NULL);
+
+	/**TESTPOINT: a level is complete before the next one starts*/
+	assert_true(app_init_ok, NULL);
+}
+
+void test_device_async_deps(void)
+{
+	/**TESTPOINT: dependencies are initialized first, whatever the order*/
+	assert_true(dep_init_ok, NULL);
+	assert_not_null(device_get_binding("async_dep"), NULL);
+}
+
+void test_device_async_deferred(void)
+{
+	/**TESTPOINT: deferred devices are initialized on first lookup*/
+	assert_equal(deferred_inits, 0, NULL);
+	assert_not_null(device_get_binding("async_deferred"), NULL);
+	assert_equal(deferred_inits, 1, NULL);
+	assert_not_null(device_get_binding("async_deferred"), NULL);
+	assert_equal(deferred_inits, 1, NULL);
+}
@@ -245,6 +245,136 @@ void memcmp_test(void)
 	assert_true((ret != 0), "memcmp 5");
 }
 
+/**
+ *
+ * @brief Test memory copy functions on all alignments and sizes
+ *
+ */
+
+#define MEMOPS_BUFSIZE 96
+
+static unsigned char __aligned(4) memops_src[MEMOPS_BUFSIZE];
+static unsigned char __aligned(4) memops_dst[MEMOPS_BUFSIZE];
+static unsigned char __aligned(4) memops_ref[MEMOPS_BUFSIZE];
+
+static void memops_fill(void)
+{
+	for (int i = 0; i < MEMOPS_BUFSIZE; i++) {
+		memops_src[i] = i + 1;
+		memops_dst[i] = 0xff - i;
+		memops_ref[i] = 0xff - i;
+	}
+}
+
+void memops_test(void)
+{
+	const size_t max_len = MEMOPS_BUFSIZE - 8;
+
+	for (int d_off = 0; d_off < 4; d_off++) {
+		for (int s_off = 0; s_off < 4; s_off++) {
+			for (size_t len = 0; len <= max_len; len++) {
+				memops_fill();
+				for (size_t i = 0; i < len; i++) {
+					memops_ref[d_off + i] =
+						memops_src[s_off + i];
+				}
+				memcpy(memops_dst + d_off, memops_src + s_off,
+				       len);
+				assert_true(memcmp(memops_dst, memops_ref,
+						   MEMOPS_BUFSIZE) == 0,
+					    "memcpy");
+			}
+		}
+	}
+
+	for (int d_off = 0; d_off < 8; d_off++) {
+		for (int s_off = 0; s_off < 8; s_off++) {
+			for (size_t len = 0; len <= max_len; len++) {
+				memops_fill();
+				memcpy(memops_ref, memops_src, MEMOPS_BUFSIZE);
+				for (size_t i = 0; i < len; i++) {
+					memops_dst[i] = memops_src[s_off + i];
+				}
+				for (size_t i = 0; i < len; i++) {
+					memops_ref[d_off + i] = memops_dst[i];
+				}
+				memmove(memops_src + d_off, memops_src + s_off,
+					len);
+				assert_true(memcmp(memops_src, memops_ref,
+						   MEMOPS_BUFSIZE) == 0,
+					    "memmove");
+			}
+		}
+	}
+
+	for (int d_off = 0; d_off < 4; d_off++) {
+		for (size_t len = 0; len <= max_len; len++) {
+			memops_fill();
+			for (size_t i = 0; i < len; i++) {
+				memops_ref[d_off + i] = 0x5a;
+			}
+			memset(memops_dst + d_off, 0x5a, len);
+			assert_true(memcmp(memops_dst, memops_ref,
+					   MEMOPS_BUFSIZE) == 0, "memset");
+		}
+	}
+}
+
+/**
+ *
+ * @brief Test string scanning functions on all alignments and lengths
+ *
+ */
+
+void strscan_test(void)
+{
+	static char __aligned(4) s1[MEMOPS_BUFSIZE];
+	static char __aligned(4) s2[MEMOPS_BUFSIZE];
+	const size_t max_len = MEMOPS_BUFSIZE - 16;
+
+	for (int off = 0; off < 8; off++) {
+		for (size_t len = 0; len <= max_len; len++) {
+			char *p1 = s1 + off;
+			char *p2 = s2 + (off ^ 4);
+
+			/* unique bytes, some with the high bit set */
+			for (size_t i = 0; i < len; i++) {
+				p1[i] = (i & 1) ? 0x80 | i : 'A' + i / 2;
+				p2[i] = p1[i];
+			}
+			p1[len] = '\0';
+			p2[len] = '\0';
+			p1[len + 1] = 'z';
+
+			assert_equal(strlen(p1), len, "strlen");
+			assert_equal_ptr(strchr(p1, '\0'), p1 + len, "strchr");
+			assert_is_null(strchr(p1, 'z'), "strchr");
+			assert_is_null(memchr(p1, 'z', len), "memchr");
+			assert_equal_ptr(memchr(p1, 'z', len + 2), p1 + len + 1,
+					 "memchr");
+			assert_equal(strcmp(p1, p2), 0, "strcmp");
+			assert_equal(strcmp(p1, p1), 0, "strcmp");
+			assert_equal(memcmp(p1, p2, len), 0, "memcmp");
+
+			if (len == 0) {
+				continue;
+			}
+
+			assert_equal_ptr(strchr(p1, p1[len - 1]), p1 + len - 1,
+					 "strchr");
+			assert_equal_ptr(memchr(p1, p1[len - 1], len),
+					 p1 + len - 1, "memchr");
+			assert_equal_ptr(strstr(p1, p1 + len - 1), p1 + len - 1,
+					 "strstr");
+
+			p2[len - 1]++;
+			assert_true(strcmp(p1, p2) < 0, "strcmp");
+			assert_true(memcmp(p1, p2, len) < 0, "memcmp");
+			assert_equal(memcmp(p1, p2, len - 1), 0, "memcmp");
+		}
+	}
+}
+
 /**
  *
  * @brief Test string operations library
@@ -271,7 +401,9 @@ void test_main(void)
 			 ztest_unit_test(stdbool_test),
 			 ztest_unit_test(stddef_test),
 			 ztest_unit_test(stdint_test),
-			 ztest_unit_test(string_test));
+			 ztest_unit_test(string_test),
+			 ztest_unit_test(strscan_test),
+			 ztest_unit_test(memops_test));
 
 	ztest_run_test_suite(test_libs);
 }
@@ -13,6 +13,7 @@ extern void test_mbox_async_put_get_buffer(void);
 extern void test_mbox_async_put_get_block(void);
 extern void test_mbox_target_source_thread_buffer(void);
 extern void test_mbox_target_source_thread_block(void);
+extern void test_mbox_async_put_get_ptr(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -25,6 +26,7 @@ void test_main(void *p1, void *p2, void *p3)
 		ztest_unit_test(test_mbox_async_put_get_buffer),
 		ztest_unit_test(test_mbox_async_put_get_block),
 		ztest_unit_test(test_mbox_target_source_thread_buffer),
-		ztest_unit_test(test_mbox_target_source_thread_block));
+		ztest_unit_test(test_mbox_target_source_thread_block),
+		ztest_unit_test(test_mbox_async_put_get_ptr));
 	ztest_run_test_suite(test_mbox_api);
 }
@@ -17,6 +17,8 @@
  *   -# k_mbox_get
  *   -# k_mbox_data_get
  *   -# k_mbox_data_block_get
+ *   -# k_mbox_data_ptr_get
+ *   -# k_mbox_data_release
  * @}
  */
 
@@ -47,6 +49,7 @@ static enum mmsg_type {
 	ASYNC_PUT_GET_BLOCK,
 	TARGET_SOURCE_THREAD_BUFFER,
 	TARGET_SOURCE_THREAD_BLOCK,
+	ASYNC_PUT_GET_PTR,
 	MAX_INFO_TYPE
 } info_type;
 
@@ -56,7 +59,8 @@ static char data[MAX_INFO_TYPE][MAIL_LEN] = {
 	"async send/recv msg using a buffer",
 	"async send/recv msg using a memory block",
 	"specify target/source thread, using a buffer",
-	"specify target/source thread, using a memory block"
+	"specify target/source thread, using a memory block",
+	"async send/recv msg data in place"
 };
 
 static void tmbox_put(struct k_mbox *pmbox)
@@ -119,6 +123,16 @@ static void tmbox_put(struct k_mbox *pmbox)
 		k_sem_take(&sync_sema, K_FOREVER);
 		k_mem_pool_free(&mmsg.tx_block);
 		break;
+	case ASYNC_PUT_GET_PTR:
+		/**TESTPOINT: mbox async put buffer accessed in place*/
+		mmsg.info = ASYNC_PUT_GET_PTR;
+		mmsg.size = sizeof(data[info_type]);
+		mmsg.tx_data = data[info_type];
+		mmsg.tx_target_thread = K_ANY;
+		k_mbox_async_put(pmbox, &mmsg, &sync_sema);
+		/*wait for msg data being released*/
+		k_sem_take(&sync_sema, K_FOREVER);
+		break;
 	default:
 		break;
 	}
@@ -194,6 +208,21 @@ static void tmbox_get(struct k_mbox *pmbox)
 			== 0, NULL);
 		k_mem_pool_free(&rxblock);
 		break;
+	case ASYNC_PUT_GET_PTR:
+		/**TESTPOINT: mbox get msg data in place*/
+		mmsg.size = sizeof(rxdata);
+		mmsg.rx_source_thread = K_ANY;
+		assert_true(k_mbox_get(pmbox, &mmsg, NULL, K_FOREVER) == 0,
+			NULL);
+		assert_equal(mmsg.info, ASYNC_PUT_GET_PTR, NULL);
+		/*verify the data is the sender's, not a copy*/
+		assert_equal_ptr(k_mbox_data_ptr_get(&mmsg), data[info_type],
+			NULL);
+		assert_true(memcmp(k_mbox_data_ptr_get(&mmsg), data[info_type],
+			MAIL_LEN) == 0, NULL);
+		/*the sender waits for the data to be released*/
+		k_mbox_data_release(&mmsg);
+		break;
 	default:
 		break;
 	}
@@ -274,3 +303,9 @@ void test_mbox_target_source_thread_block(void)
 	info_type = TARGET_SOURCE_THREAD_BLOCK;
 	tmbox(&mbox);
 }
+
+void test_mbox_async_put_get_ptr(void)
+{
+	info_type = ASYNC_PUT_GET_PTR;
+	tmbox(&mbox);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mheap
+ * @{
+ * @defgroup t_mheap_magazine test_mheap_magazine
+ * @brief TestPurpose: verify per-thread heap magazines.
+ * @details
+ * - API coverage
+ *   -# k_malloc
+ *   -# k_free
+ * @}
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE 512
+#define BLK_SIZE_SMALL 32
+#define BLK_NUM 8
+
+static char __noinit __stack tstack[STACK_SIZE];
+static void *isr_block;
+
+/*test cases*/
+void test_mheap_magazine_reuse(void)
+{
+	void *block, *again;
+
+	/**
+	 * TESTPOINT: a block freed by a thread is handed back to the same
+	 * thread by its next allocation of the same size class
+	 */
+	block = k_malloc(BLK_SIZE_SMALL);
+	assert_not_null(block, NULL);
+	k_free(block);
+
+	again = k_malloc(BLK_SIZE_SMALL - 1);
+	assert_equal_ptr(block, again, NULL);
+	k_free(again);
+}
+
+static void tisr_alloc(void *data)
+{
+	ARG_UNUSED(data);
+
+	isr_block = k_malloc(BLK_SIZE_SMALL);
+}
+
+void test_mheap_magazine_isr(void)
+{
+	/** TESTPOINT: ISRs still allocate from the heap memory pool */
+	irq_offload(tisr_alloc, NULL);
+	assert_not_null(isr_block, NULL);
+	k_free(isr_block);
+}
+
+static void tmagazine_fill(void *p1, void *p2, void *p3)
+{
+	void *block[BLK_NUM];
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		block[i] = k_malloc(BLK_SIZE_SMALL);
+	}
+
+	/* leave the blocks in the magazine of this thread */
+	for (int i = 0; i < BLK_NUM; i++) {
+		k_free(block[i]);
+	}
+}
+
+void test_mheap_magazine_thread_exit(void)
+{
+	void *block;
+
+	k_thread_spawn(tstack, STACK_SIZE, tmagazine_fill, NULL, NULL, NULL,
+		       K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(100);
+
+	/**
+	 * TESTPOINT: the blocks cached by a thread that exited go back to the
+	 * heap memory pool
+	 */
+	block = k_malloc(CONFIG_HEAP_MEM_POOL_SIZE - sizeof(struct k_mem_block));
+	assert_not_null(block, NULL);
+	k_free(block);
+}
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_mheap_magazine,
+		ztest_unit_test(test_mheap_magazine_reuse),
+		ztest_unit_test(test_mheap_magazine_isr),
+		ztest_unit_test(test_mheap_magazine_thread_exit));
+	ztest_run_test_suite(test_mheap_magazine);
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+extern void test_mpool_tlsf_max_blocks(void);
+extern void test_mpool_tlsf_merge(void);
+extern void test_mpool_tlsf_odd_sizes(void);
+extern void test_mpool_tlsf_alloc_timeout(void);
+extern void test_mpool_tlsf_heap(void);
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_mpool_tlsf,
+		ztest_unit_test(test_mpool_tlsf_max_blocks),
+		ztest_unit_test(test_mpool_tlsf_merge),
+		ztest_unit_test(test_mpool_tlsf_odd_sizes),
+		ztest_unit_test(test_mpool_tlsf_alloc_timeout),
+		ztest_unit_test(test_mpool_tlsf_heap));
+	ztest_run_test_suite(test_mpool_tlsf);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mpool
+ * @{
+ * @defgroup t_mpool_tlsf test_mpool_tlsf
+ * @brief TestPurpose: verify two-level segregated fit memory pools.
+ * @details
+ * - API coverage
+ *   -# K_MEM_POOL_DEFINE
+ *   -# k_mem_pool_alloc
+ *   -# k_mem_pool_free
+ *   -# k_malloc
+ *   -# k_free
+ * @}
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define TIMEOUT 100
+#define BLK_SIZE_MIN 8
+#define BLK_SIZE_MAX 256
+#define BLK_NUM_MAX 4
+#define BLK_ALIGN 4
+#define BLK_NUM_ODD 32
+
+K_MEM_POOL_DEFINE(tlsf_pool, BLK_SIZE_MIN, BLK_SIZE_MAX, BLK_NUM_MAX,
+		  BLK_ALIGN);
+
+/*test cases*/
+void test_mpool_tlsf_max_blocks(void)
+{
+	struct k_mem_block block[BLK_NUM_MAX], block_fail;
+
+	/**
+	 * TESTPOINT: the pool holds n_max blocks of max_size bytes
+	 */
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		assert_equal(k_mem_pool_alloc(&tlsf_pool, &block[i],
+					      BLK_SIZE_MAX, K_NO_WAIT), 0,
+			     NULL);
+		assert_not_null(block[i].data, NULL);
+	}
+
+	assert_equal(k_mem_pool_alloc(&tlsf_pool, &block_fail, BLK_SIZE_MIN,
+				      K_NO_WAIT), -ENOMEM, NULL);
+
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		k_mem_pool_free(&block[i]);
+	}
+}
+
+void test_mpool_tlsf_merge(void)
+{
+	struct k_mem_block block[BLK_NUM_MAX], block_all;
+	size_t all = BLK_NUM_MAX * (BLK_SIZE_MAX + _TLSF_BLOCK_OVERHEAD) -
+		     _TLSF_BLOCK_OVERHEAD;
+
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		assert_equal(k_mem_pool_alloc(&tlsf_pool, &block[i],
+					      BLK_SIZE_MAX, K_NO_WAIT), 0,
+			     NULL);
+	}
+
+	/**
+	 * TESTPOINT: freed blocks are merged with their free neighbours
+	 * right away, in any order, without defragmenting
+	 */
+	k_mem_pool_free(&block[0]);
+	k_mem_pool_free(&block[2]);
+	k_mem_pool_free(&block[1]);
+	k_mem_pool_free(&block[3]);
+
+	assert_equal(k_mem_pool_alloc(&tlsf_pool, &block_all, all,
+				      K_NO_WAIT), 0, NULL);
+	k_mem_pool_free(&block_all);
+}
+
+void test_mpool_tlsf_odd_sizes(void)
+{
+	struct k_mem_block block[BLK_NUM_ODD], block_all;
+	size_t all = BLK_NUM_MAX * (BLK_SIZE_MAX + _TLSF_BLOCK_OVERHEAD) -
+		     _TLSF_BLOCK_OVERHEAD;
+	int num;
+
+	/**
+	 * TESTPOINT: blocks of any size can be allocated, they are aligned
+	 * and do not overlap
+	 */
+	for (num = 0; num < BLK_NUM_ODD; num++) {
+		if (k_mem_pool_alloc(&tlsf_pool, &block[num], 3 * num + 1,
+				     K_NO_WAIT) != 0) {
+			break;
+		}
+		assert_false((uint32_t)block[num].data % 4, NULL);
+		memset(block[num].data, num, 3 * num + 1);
+	}
+	assert_true(num > BLK_NUM_MAX, NULL);
+
+	/* free every other block first, then the rest */
+	for (int i = 0; i < num; i += 2) {
+		k_mem_pool_free(&block[i]);
+	}
+
+	for (int i = 1; i < num; i += 2) {
+		uint8_t *data = block[i].data;
+
+		for (int j = 0; j < 3 * i + 1; j++) {
+			assert_equal(data[j], i, NULL);
+		}
+		k_mem_pool_free(&block[i]);
+	}
+
+	assert_equal(k_mem_pool_alloc(&tlsf_pool, &block_all, all,
+				      K_NO_WAIT), 0, NULL);
+	k_mem_pool_free(&block_all);
+}
+
+void test_mpool_tlsf_alloc_timeout(void)
+{
+	struct k_mem_block block[BLK_NUM_MAX], block_fail;
+
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		assert_equal(k_mem_pool_alloc(&tlsf_pool, &block[i],
+					      BLK_SIZE_MAX, K_NO_WAIT), 0,
+			     NULL);
+	}
+
+	/** TESTPOINT: @retval -EAGAIN Waiting period timed out*/
+	assert_equal(k_mem_pool_alloc(&tlsf_pool, &block_fail, BLK_SIZE_MIN,
+				      TIMEOUT), -EAGAIN, NULL);
+
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		k_mem_pool_free(&block[i]);
+	}
+}
+
+void test_mpool_tlsf_heap(void)
+{
+	void *block[BLK_NUM_MAX];
+
+	/** TESTPOINT: k_malloc() is served by the heap TLSF pool */
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		block[i] = k_malloc(BLK_SIZE_MAX / (i + 1) + i);
+		assert_not_null(block[i], NULL);
+		assert_false((uint32_t)block[i] % 4, NULL);
+	}
+
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		k_free(block[i]);
+	}
+
+	block[0] = k_malloc(CONFIG_HEAP_MEM_POOL_SIZE -
+			    sizeof(struct k_mem_block));
+	assert_not_null(block[0], NULL);
+	k_free(block[0]);
+}
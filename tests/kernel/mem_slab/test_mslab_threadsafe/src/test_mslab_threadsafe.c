@@ -74,6 +74,12 @@ void test_mslab_threadsafe(void)
 		k_sem_take(&sync_sema, K_FOREVER);
 	}
 
+	/* TESTPOINT: every block allocated was returned to its slab*/
+	for (int i = 0; i < SLAB_NUM; i++) {
+		assert_equal(k_mem_slab_num_used_get(slabs[i]), 0, NULL);
+		assert_equal(k_mem_slab_num_free_get(slabs[i]), BLK_NUM, NULL);
+	}
+
 	/* test case tear down*/
 	for (int i = 0; i < THREAD_NUM; i++) {
 		k_thread_abort(tid[i]);
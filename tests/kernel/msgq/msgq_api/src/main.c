@@ -17,6 +17,8 @@ extern void test_msgq_isr(void);
 extern void test_msgq_put_fail(void);
 extern void test_msgq_get_fail(void);
 extern void test_msgq_purge_when_put(void);
+extern void test_msgq_claim(void);
+extern void test_msgq_claim_pend(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -26,6 +28,8 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_msgq_isr),
 			 ztest_unit_test(test_msgq_put_fail),
 			 ztest_unit_test(test_msgq_get_fail),
-			 ztest_unit_test(test_msgq_purge_when_put));
+			 ztest_unit_test(test_msgq_purge_when_put),
+			 ztest_unit_test(test_msgq_claim),
+			 ztest_unit_test(test_msgq_claim_pend));
 	ztest_run_test_suite(test_msgq_api);
 }
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_msgq_api
+ * @{
+ * @defgroup t_msgq_claim test_msgq_claim
+ * @brief TestPurpose: verify zero-copy message claims
+ * - API coverage
+ *   -# k_msgq_alloc_claim
+ *   -# k_msgq_commit
+ *   -# k_msgq_peek_claim
+ *   -# k_msgq_release
+ * @}
+ */
+
+#include "test_msgq.h"
+
+static char __noinit __stack tstack[STACK_SIZE];
+static char __aligned(4) tbuffer[MSG_SIZE * MSGQ_LEN];
+static uint32_t data[MSGQ_LEN] = { MSG0, MSG1 };
+static struct k_msgq msgq;
+static struct k_sem end_sema;
+
+static void tThread_peek_claim(void *p1, void *p2, void *p3)
+{
+	void *msg;
+
+	/**TESTPOINT: claim a message sent later*/
+	assert_equal(k_msgq_peek_claim(&msgq, &msg, K_FOREVER), 0, NULL);
+	assert_equal(*(uint32_t *)msg, MSG0, NULL);
+	k_msgq_release(&msgq);
+
+	k_sem_give(&end_sema);
+}
+
+static void tThread_alloc_claim(void *p1, void *p2, void *p3)
+{
+	void *msg;
+
+	/**TESTPOINT: claim a slot freed later*/
+	assert_equal(k_msgq_alloc_claim(&msgq, &msg, K_FOREVER), 0, NULL);
+	*(uint32_t *)msg = MSG1;
+	k_msgq_commit(&msgq);
+
+	k_sem_give(&end_sema);
+}
+
+/*test cases*/
+void test_msgq_claim(void)
+{
+	uint32_t rx_data;
+	void *msg, *msg2;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+
+	/**TESTPOINT: a claimed message is only received once committed*/
+	assert_equal(k_msgq_alloc_claim(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	assert_equal(k_msgq_alloc_claim(&msgq, &msg2, K_NO_WAIT), -EBUSY,
+		     NULL);
+	*(uint32_t *)msg = MSG0;
+	assert_equal(k_msgq_put(&msgq, &data[1], K_NO_WAIT), 0, NULL);
+	assert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	assert_equal(k_msgq_num_free_get(&msgq), 0, NULL);
+	assert_equal(k_msgq_get(&msgq, &rx_data, K_NO_WAIT), -ENOMSG, NULL);
+	k_msgq_commit(&msgq);
+	assert_equal(k_msgq_num_used_get(&msgq), MSGQ_LEN, NULL);
+
+	/**TESTPOINT: messages are received in order, in place*/
+	assert_equal(k_msgq_peek_claim(&msgq, &msg2, K_NO_WAIT), 0, NULL);
+	assert_equal_ptr(msg2, msg, NULL);
+	assert_equal(*(uint32_t *)msg2, MSG0, NULL);
+	assert_equal(k_msgq_peek_claim(&msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	assert_equal(k_msgq_get(&msgq, &rx_data, K_NO_WAIT), 0, NULL);
+	assert_equal(rx_data, MSG1, NULL);
+
+	/**TESTPOINT: slots are held until the claimed message is released*/
+	assert_equal(k_msgq_num_free_get(&msgq), 0, NULL);
+	assert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), -ENOMSG, NULL);
+	k_msgq_release(&msgq);
+	assert_equal(k_msgq_num_free_get(&msgq), MSGQ_LEN, NULL);
+}
+
+void test_msgq_claim_pend(void)
+{
+	uint32_t rx_data;
+	void *msg;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+	k_sem_init(&end_sema, 0, 1);
+
+	/* consumer waiting on an empty queue */
+	k_tid_t tid = k_thread_spawn(tstack, STACK_SIZE,
+				     tThread_peek_claim, NULL, NULL, NULL,
+				     K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	assert_equal(k_msgq_alloc_claim(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	*(uint32_t *)msg = MSG0;
+	k_msgq_commit(&msgq);
+	assert_equal(k_sem_take(&end_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(tid);
+
+	/* producer waiting on a full queue */
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		assert_equal(k_msgq_put(&msgq, &data[0], K_NO_WAIT), 0, NULL);
+	}
+	tid = k_thread_spawn(tstack, STACK_SIZE,
+			     tThread_alloc_claim, NULL, NULL, NULL,
+			     K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		assert_equal(k_msgq_get(&msgq, &rx_data, K_NO_WAIT), 0, NULL);
+		assert_equal(rx_data, MSG0, NULL);
+	}
+	assert_equal(k_sem_take(&end_sema, TIMEOUT), 0, NULL);
+	assert_equal(k_msgq_get(&msgq, &rx_data, K_NO_WAIT), 0, NULL);
+	assert_equal(rx_data, MSG1, NULL);
+	k_thread_abort(tid);
+}
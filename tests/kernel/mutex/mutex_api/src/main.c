@@ -18,6 +18,9 @@ extern void test_mutex_reent_lock_forever(void);
 extern void test_mutex_reent_lock_no_wait(void);
 extern void test_mutex_reent_lock_timeout_fail(void);
 extern void test_mutex_reent_lock_timeout_pass(void);
+#ifdef CONFIG_MUTEX_PI_CHAIN
+extern void test_mutex_pi_chain(void);
+#endif
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -27,6 +30,9 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_mutex_reent_lock_forever),
 			 ztest_unit_test(test_mutex_reent_lock_no_wait),
 			 ztest_unit_test(test_mutex_reent_lock_timeout_fail),
+#ifdef CONFIG_MUTEX_PI_CHAIN
+			 ztest_unit_test(test_mutex_pi_chain),
+#endif
 			 ztest_unit_test(test_mutex_reent_lock_timeout_pass)
 			 );
 	ztest_run_test_suite(test_mutex_api);
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mutex_api
+ * @{
+ * @defgroup t_mutex_pi_chain test_mutex_pi_chain
+ * @brief TestPurpose: verify the priority inheritance is carried along a
+ *                     chain of owners, and undone on timeout and unlock
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 512
+#define PRIO_LOW K_PRIO_PREEMPT(10)
+#define PRIO_MID K_PRIO_PREEMPT(8)
+#define PRIO_HIGH K_PRIO_PREEMPT(6)
+#define HIGH_TIMEOUT 200
+
+static char __noinit __stack low_stack[STACK_SIZE];
+static char __noinit __stack mid_stack[STACK_SIZE];
+static char __noinit __stack high_stack[STACK_SIZE];
+
+static struct k_mutex m1, m2;
+static struct k_sem release_low;
+
+static void low_entry(void *p1, void *p2, void *p3)
+{
+	k_mutex_lock(&m1, K_FOREVER);
+	k_sem_take(&release_low, K_FOREVER);
+	k_mutex_unlock(&m1);
+}
+
+static void mid_entry(void *p1, void *p2, void *p3)
+{
+	k_mutex_lock(&m2, K_FOREVER);
+	k_mutex_lock(&m1, K_FOREVER);
+	k_mutex_unlock(&m1);
+	k_mutex_unlock(&m2);
+}
+
+static void high_entry(void *p1, void *p2, void *p3)
+{
+	/* times out, low being held until then */
+	assert_true(k_mutex_lock(&m2, HIGH_TIMEOUT) != 0, NULL);
+}
+
+void test_mutex_pi_chain(void)
+{
+	k_tid_t low, mid, high;
+
+	k_mutex_init(&m1);
+	k_mutex_init(&m2);
+	k_sem_init(&release_low, 0, 1);
+
+	/* low owns m1, mid owns m2 and pends on m1 */
+	low = k_thread_spawn(low_stack, STACK_SIZE, low_entry, NULL, NULL,
+			     NULL, PRIO_LOW, 0, 0);
+	k_sleep(10);
+	mid = k_thread_spawn(mid_stack, STACK_SIZE, mid_entry, NULL, NULL,
+			     NULL, PRIO_MID, 0, 0);
+	k_sleep(10);
+	assert_equal(k_thread_priority_get(low), PRIO_MID, NULL);
+
+	/**TESTPOINT: high pending on m2 boosts mid, and low through mid */
+	high = k_thread_spawn(high_stack, STACK_SIZE, high_entry, NULL, NULL,
+			      NULL, PRIO_HIGH, 0, 0);
+	k_sleep(10);
+	assert_equal(k_thread_priority_get(mid), PRIO_HIGH, NULL);
+	assert_equal(k_thread_priority_get(low), PRIO_HIGH, NULL);
+
+	/**TESTPOINT: the boost is undone along the chain on timeout */
+	k_sleep(HIGH_TIMEOUT);
+	assert_equal(k_thread_priority_get(mid), PRIO_MID, NULL);
+	assert_equal(k_thread_priority_get(low), PRIO_MID, NULL);
+
+	/**TESTPOINT: the boost is undone on unlock */
+	k_sem_give(&release_low);
+	k_sleep(10);
+	assert_equal(k_thread_priority_get(low), PRIO_LOW, NULL);
+	assert_equal(k_thread_priority_get(mid), PRIO_MID, NULL);
+
+	k_thread_abort(low);
+	k_thread_abort(mid);
+	k_thread_abort(high);
+}
@@ -18,6 +18,9 @@ extern void test_pipe_get_fail(void);
 extern void test_pipe_block_put(void);
 extern void test_pipe_block_put_sema(void);
 extern void test_pipe_get_put(void);
+#ifdef CONFIG_PIPE_DMA
+extern void test_pipe_dma(void);
+#endif
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -28,6 +31,9 @@ void test_main(void *p1, void *p2, void *p3)
 		ztest_unit_test(test_pipe_get_fail),
 		ztest_unit_test(test_pipe_block_put),
 		ztest_unit_test(test_pipe_block_put_sema),
+#ifdef CONFIG_PIPE_DMA
+		ztest_unit_test(test_pipe_dma),
+#endif
 		ztest_unit_test(test_pipe_get_put));
 	ztest_run_test_suite(test_pipe_api);
 }
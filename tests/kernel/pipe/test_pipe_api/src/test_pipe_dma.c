@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_pipe_api
+ * @{
+ * @defgroup t_pipe_dma test_pipe_dma
+ * @brief TestPurpose: verify pipe transfers offloaded to DMA
+ * - API coverage
+ *   -# k_pipe_dma_set
+ * @}
+ */
+
+#include <ztest.h>
+#include <dma.h>
+
+#define STACK_SIZE 512
+#define PIPE_LEN 16
+#define DMA_MIN_XFER 8
+#define DMA_CHANNEL 1
+
+static unsigned char __aligned(4) data[] = "abcd1234$%^&PIPE";
+K_PIPE_DEFINE(dma_pipe, PIPE_LEN, 4);
+
+static char __noinit __stack tstack[STACK_SIZE];
+static struct k_sem end_sema;
+
+/* memory to memory DMA controller completing transfers from a timer */
+static struct dma_block_config fake_block;
+static uint32_t fake_channel;
+static void (*fake_callback)(struct device *dev, uint32_t channel,
+			     int error_code);
+static struct k_timer fake_timer;
+static int fake_xfers;
+
+static int fake_dma_config(struct device *dev, uint32_t channel,
+			   struct dma_config *config)
+{
+	if (config->channel_direction != MEMORY_TO_MEMORY) {
+		return -EINVAL;
+	}
+
+	fake_block = *config->head_block;
+	fake_channel = channel;
+	fake_callback = config->dma_callback;
+
+	return 0;
+}
+
+static int fake_dma_start(struct device *dev, uint32_t channel)
+{
+	k_timer_start(&fake_timer, 1, 0);
+
+	return 0;
+}
+
+static const struct dma_driver_api fake_dma_api = {
+	.config = fake_dma_config,
+	.start = fake_dma_start,
+};
+
+static int fake_dma_init(struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_AND_API_INIT(fake_dma, "FAKE_DMA", fake_dma_init, NULL, NULL,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &fake_dma_api);
+
+static void fake_dma_complete(struct k_timer *timer)
+{
+	memcpy((void *)fake_block.dest_address,
+	       (void *)fake_block.source_address, fake_block.block_size);
+	fake_xfers++;
+	fake_callback(DEVICE_GET(fake_dma), fake_channel, 0);
+}
+
+static void tpipe_get_entry(void *p1, void *p2, void *p3)
+{
+	unsigned char rx_data[PIPE_LEN];
+	size_t to_rd = (size_t)p1;
+	size_t rd_byte;
+
+	memset(rx_data, 0, sizeof(rx_data));
+	assert_false(k_pipe_get(&dma_pipe, rx_data, to_rd, &rd_byte, to_rd,
+				K_FOREVER), NULL);
+	assert_equal(rd_byte, to_rd, NULL);
+	assert_true(memcmp(rx_data, data, to_rd) == 0, NULL);
+
+	k_sem_give(&end_sema);
+}
+
+static void tpipe_handover(size_t size)
+{
+	size_t wt_byte;
+
+	k_tid_t tid = k_thread_spawn(tstack, STACK_SIZE,
+				     tpipe_get_entry, (void *)size, NULL, NULL,
+				     K_PRIO_PREEMPT(0), 0, 0);
+	/* let the reader wait on the pipe */
+	k_sleep(10);
+
+	assert_false(k_pipe_put(&dma_pipe, data, size, &wt_byte, size,
+				K_NO_WAIT), NULL);
+	assert_equal(wt_byte, size, NULL);
+	assert_equal(k_sem_take(&end_sema, 100), 0, NULL);
+	k_thread_abort(tid);
+}
+
+/*test cases*/
+void test_pipe_dma(void)
+{
+	k_sem_init(&end_sema, 0, 1);
+	k_timer_init(&fake_timer, fake_dma_complete, NULL);
+	k_pipe_dma_set(&dma_pipe, DEVICE_GET(fake_dma), DMA_CHANNEL,
+		       DMA_MIN_XFER);
+
+	/**TESTPOINT: large transfers to a waiting reader go through DMA*/
+	tpipe_handover(PIPE_LEN);
+	assert_equal(fake_xfers, 1, NULL);
+	assert_equal(fake_channel, DMA_CHANNEL, NULL);
+
+	/**TESTPOINT: small transfers are copied by the CPU*/
+	tpipe_handover(DMA_MIN_XFER - 1);
+	assert_equal(fake_xfers, 1, NULL);
+
+	k_pipe_dma_set(&dma_pipe, NULL, 0, 0);
+}
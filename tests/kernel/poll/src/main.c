@@ -15,6 +15,8 @@
 extern void test_poll_no_wait(void);
 extern void test_poll_wait(void);
 extern void test_poll_eaddrinuse(void);
+extern void test_poll_set(void);
+extern void test_task_executor(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -23,6 +25,8 @@ void test_main(void *p1, void *p2, void *p3)
 			 , ztest_unit_test(test_poll_no_wait)
 			 , ztest_unit_test(test_poll_wait)
 			 , ztest_unit_test(test_poll_eaddrinuse)
+			 , ztest_unit_test(test_poll_set)
+			 , ztest_unit_test(test_task_executor)
 	);
 	ztest_run_test_suite(test_poll_api);
 }
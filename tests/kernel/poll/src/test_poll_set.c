@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_poll_api
+ * @{
+ * @defgroup t_poll_api_set test_poll_api_set
+ * @brief TestPurpose: verify persistent poll sets
+ * - API coverage
+ *   -# k_poll_set_init k_poll_set_add k_poll_set_remove
+ *   -# k_poll_set_wait
+ * @}
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_FIFOS 8
+#define STACK_SIZE 512
+#define TIMEOUT 100
+
+static struct k_poll_set set;
+static struct k_fifo fifos[NUM_FIFOS];
+static struct k_poll_event fifo_events[NUM_FIFOS];
+static struct k_poll_signal signal;
+static struct k_poll_event signal_event;
+static struct k_poll_event *ready[NUM_FIFOS + 1];
+
+static void *msgs[NUM_FIFOS][2];
+
+static char __noinit __stack tstack[STACK_SIZE];
+
+static void signaler_entry(void *p1, void *p2, void *p3)
+{
+	k_sleep(TIMEOUT / 2);
+	k_poll_signal(&signal, 0);
+}
+
+void test_poll_set(void)
+{
+	struct k_poll_event dup_event;
+	int i;
+
+	k_poll_set_init(&set);
+	k_poll_signal_init(&signal);
+
+	for (i = 0; i < NUM_FIFOS; i++) {
+		k_fifo_init(&fifos[i]);
+		k_poll_event_init(&fifo_events[i],
+				  K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &fifos[i]);
+		fifo_events[i].tag = i;
+		assert_equal(k_poll_set_add(&set, &fifo_events[i]), 0, "");
+	}
+
+	k_poll_event_init(&signal_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &signal);
+	assert_equal(k_poll_set_add(&set, &signal_event), 0, "");
+
+	/* an object can only have one poller */
+	k_poll_event_init(&dup_event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &fifos[0]);
+	assert_equal(k_poll_set_add(&set, &dup_event), -EADDRINUSE, "");
+
+	/* nothing ready */
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 0),
+		     -EAGAIN, "");
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), TIMEOUT),
+		     -EAGAIN, "");
+
+	/* events are reported once, in the order they were signaled */
+	k_fifo_put(&fifos[5], &msgs[5][0]);
+	k_fifo_put(&fifos[2], &msgs[2][0]);
+	k_fifo_put(&fifos[5], &msgs[5][1]);
+
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 0), 2,
+		     "");
+	assert_equal(ready[0], &fifo_events[5], "");
+	assert_equal(ready[1], &fifo_events[2], "");
+	assert_equal(ready[0]->state, K_POLL_STATE_FIFO_DATA_AVAILABLE, "");
+
+	for (i = 0; i < 2; i++) {
+		ready[i]->state = K_POLL_STATE_NOT_READY;
+		while (k_fifo_get(ready[i]->fifo, K_NO_WAIT)) {
+		}
+	}
+
+	/* registrations persist across waits */
+	k_fifo_put(&fifos[2], &msgs[2][1]);
+	assert_equal(k_poll_set_wait(&set, ready, 1, 0), 1, "");
+	assert_equal(ready[0], &fifo_events[2], "");
+	assert_equal_ptr(k_fifo_get(&fifos[2], K_NO_WAIT), &msgs[2][1], "");
+	ready[0]->state = K_POLL_STATE_NOT_READY;
+
+	/* waiting thread is woken up by a signal */
+	k_thread_spawn(tstack, STACK_SIZE, signaler_entry, NULL, NULL, NULL,
+		       K_PRIO_PREEMPT(0), 0, 0);
+
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), K_FOREVER),
+		     1, "");
+	assert_equal(ready[0], &signal_event, "");
+	assert_equal(ready[0]->state, K_POLL_STATE_SIGNALED, "");
+	ready[0]->state = K_POLL_STATE_NOT_READY;
+	signal.signaled = 0;
+
+	/* removed events are dropped from the ready list and unregistered */
+	k_fifo_put(&fifos[7], &msgs[7][0]);
+	k_poll_set_remove(&set, &fifo_events[7]);
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 0),
+		     -EAGAIN, "");
+	assert_equal(k_poll_set_add(&set, &dup_event), -EADDRINUSE, "");
+	k_poll_set_remove(&set, &fifo_events[0]);
+	assert_equal(k_poll_set_add(&set, &dup_event), 0, "");
+
+	/* an event already available is ready as soon as it is added */
+	k_poll_event_init(&fifo_events[7], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &fifos[7]);
+	assert_equal(k_poll_set_add(&set, &fifo_events[7]), 0, "");
+	assert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 0), 1,
+		     "");
+	assert_equal(ready[0], &fifo_events[7], "");
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_poll_api
+ * @{
+ * @defgroup t_poll_api_task test_poll_api_task
+ * @brief TestPurpose: verify stackless tasks run by an executor
+ * - API coverage
+ *   -# k_task_executor_start k_task_spawn
+ *   -# K_TASK_YIELD K_TASK_FIFO_GET K_TASK_SEM_TAKE
+ * @}
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_ITEMS 4
+#define STACK_SIZE 512
+#define TIMEOUT 100
+
+struct item {
+	void *fifo_reserved;
+	int value;
+};
+
+struct flow {
+	struct k_task task;
+	int count;
+	struct item *item;
+};
+
+static struct k_task_executor executor;
+static struct flow producer, consumer, waiter;
+static struct item items[NUM_ITEMS];
+static struct k_fifo fifo;
+static struct k_sem go, done;
+
+static char __noinit __stack tstack[STACK_SIZE];
+
+static int producer_handler(struct k_task *task)
+{
+	struct flow *flow = CONTAINER_OF(task, struct flow, task);
+
+	K_TASK_BEGIN(task);
+	for (flow->count = 0; flow->count < NUM_ITEMS; flow->count++) {
+		items[flow->count].value = flow->count;
+		k_fifo_put(&fifo, &items[flow->count]);
+		K_TASK_YIELD(task);
+	}
+	K_TASK_END(task);
+}
+
+static int consumer_handler(struct k_task *task)
+{
+	struct flow *flow = CONTAINER_OF(task, struct flow, task);
+
+	K_TASK_BEGIN(task);
+	for (flow->count = 0; flow->count < NUM_ITEMS; flow->count++) {
+		K_TASK_FIFO_GET(task, &fifo, flow->item);
+		assert_equal(flow->item->value, flow->count, "");
+	}
+	k_sem_give(&done);
+	K_TASK_END(task);
+}
+
+static int waiter_handler(struct k_task *task)
+{
+	K_TASK_BEGIN(task);
+	K_TASK_SEM_TAKE(task, &go);
+	k_sem_give(&done);
+	K_TASK_END(task);
+}
+
+void test_task_executor(void)
+{
+	k_fifo_init(&fifo);
+	k_sem_init(&go, 0, 1);
+	k_sem_init(&done, 0, 2);
+
+	k_task_executor_start(&executor, tstack, STACK_SIZE,
+			      K_PRIO_PREEMPT(1));
+
+	/**TESTPOINT: the consumer waits for the items the producer yields */
+	k_task_spawn(&executor, &consumer.task, consumer_handler);
+	k_task_spawn(&executor, &producer.task, producer_handler);
+	assert_equal(k_sem_take(&done, TIMEOUT), 0, "");
+
+	/**TESTPOINT: a task waits for a semaphore given by a thread */
+	k_task_spawn(&executor, &waiter.task, waiter_handler);
+	k_sleep(TIMEOUT / 2);
+	assert_equal(k_sem_count_get(&done), 0, "");
+	k_sem_give(&go);
+	assert_equal(k_sem_take(&done, TIMEOUT), 0, "");
+}
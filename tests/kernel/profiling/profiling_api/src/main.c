@@ -9,6 +9,11 @@
 extern void test_call_stacks_analyze_main(void);
 extern void test_call_stacks_analyze_idle(void);
 extern void test_call_stacks_analyze_workq(void);
+extern void test_thread_stack_space_get(void);
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+extern void test_thread_runtime_stats(void);
+extern void test_isr_runtime_stats(void);
+#endif
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -16,6 +21,11 @@ void test_main(void *p1, void *p2, void *p3)
 	ztest_test_suite(test_profiling_api,
 		ztest_unit_test(test_call_stacks_analyze_main),
 		ztest_unit_test(test_call_stacks_analyze_idle),
-		ztest_unit_test(test_call_stacks_analyze_workq));
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+		ztest_unit_test(test_thread_runtime_stats),
+		ztest_unit_test(test_isr_runtime_stats),
+#endif
+		ztest_unit_test(test_call_stacks_analyze_workq),
+		ztest_unit_test(test_thread_stack_space_get));
 	ztest_run_test_suite(test_profiling_api);
 }
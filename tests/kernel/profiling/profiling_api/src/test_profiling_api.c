@@ -12,6 +12,7 @@
  * @details All TESTPOINTs extracted from kernel-doc comments in <kernel.h>
  * - API coverage
  *   - k_call_stacks_analyze
+ *   - k_thread_stack_space_get
  * @}
  */
 
@@ -74,5 +75,35 @@ void test_call_stacks_analyze_workq(void)
 	}
 }
 
+static void tstack_use(size_t size)
+{
+	volatile char buf[size];
+
+	for (size_t i = 0; i < size; i++) {
+		buf[i] = 0;
+	}
+}
+
+void test_thread_stack_space_get(void)
+{
+	size_t before, after;
+
+	/**TESTPOINT: invalid parameters are rejected*/
+	assert_equal(k_thread_stack_space_get(NULL, &before), -EINVAL, NULL);
+	assert_equal(k_thread_stack_space_get(k_current_get(), NULL), -EINVAL,
+		     NULL);
+
+	/**TESTPOINT: the unused space shrinks as the stack is used*/
+	assert_false(k_thread_stack_space_get(k_current_get(), &before), NULL);
+	assert_true(before > 256, NULL);
+	tstack_use(before - 128);
+	k_thread_stack_space_get(k_current_get(), &after);
+	assert_true(after <= 128, NULL);
+
+	/**TESTPOINT: the peak usage is kept once the stack is unwound*/
+	k_thread_stack_space_get(k_current_get(), &before);
+	assert_equal(before, after, NULL);
+}
+
 /*TODO: add test case to capture the usage of interrupt call stack*/
 
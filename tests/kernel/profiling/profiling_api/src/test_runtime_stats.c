@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_profiling
+ * @{
+ * @defgroup t_profiling_runtime test_runtime_stats
+ * @brief TestPurpose: verify thread run-time statistics.
+ * - API coverage
+ *   - k_thread_runtime_stats_get
+ *   - k_isr_runtime_stats_get
+ *   - k_thread_runtime_stats_all_get
+ * @}
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE 512
+#define BUSY_MS 20
+
+static char __noinit __stack tstack[STACK_SIZE];
+
+static void busy_wait(void *p1, void *p2, void *p3)
+{
+	int64_t end = k_uptime_get() + BUSY_MS;
+
+	while (k_uptime_get() < end) {
+		/* spin */
+	}
+}
+
+static void tisr_busy(void *p)
+{
+	uint32_t start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start < 1000) {
+		/* spin */
+	}
+}
+
+void test_thread_runtime_stats(void)
+{
+	struct k_thread_runtime_stats before, after, other, total;
+	k_tid_t tid;
+
+	/**TESTPOINT: invalid parameters are rejected*/
+	assert_equal(k_thread_runtime_stats_get(NULL, &before), -EINVAL, NULL);
+	assert_equal(k_thread_runtime_stats_get(k_current_get(), NULL),
+		     -EINVAL, NULL);
+
+	/**TESTPOINT: the current thread is charged while it runs*/
+	assert_false(k_thread_runtime_stats_get(k_current_get(), &before),
+		     NULL);
+	busy_wait(NULL, NULL, NULL);
+	k_thread_runtime_stats_get(k_current_get(), &after);
+	assert_true(after.execution_cycles > before.execution_cycles, NULL);
+
+	/**TESTPOINT: a thread is charged only for the time it ran*/
+	tid = k_thread_spawn(tstack, STACK_SIZE, busy_wait, NULL, NULL, NULL,
+			     K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(BUSY_MS * 2);
+	k_thread_runtime_stats_get(tid, &other);
+	k_thread_runtime_stats_get(k_current_get(), &before);
+	assert_true(other.execution_cycles > 0, NULL);
+	assert_true(before.execution_cycles - after.execution_cycles <
+		    other.execution_cycles, NULL);
+	k_thread_abort(tid);
+
+	/**TESTPOINT: the whole system accounts for more than any thread*/
+	assert_false(k_thread_runtime_stats_all_get(&total), NULL);
+	assert_true(total.execution_cycles >
+		    before.execution_cycles + other.execution_cycles, NULL);
+}
+
+void test_isr_runtime_stats(void)
+{
+	struct k_thread_runtime_stats before, after;
+
+	/**TESTPOINT: interrupt handlers are charged separately*/
+	assert_false(k_isr_runtime_stats_get(&before), NULL);
+	irq_offload(tisr_busy, NULL);
+	k_isr_runtime_stats_get(&after);
+	assert_true(after.execution_cycles - before.execution_cycles >= 1000,
+		    NULL);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_queue_api
+ * @{
+ * @defgroup t_queue_get_batch test_queue_get_batch
+ * @brief TestPurpose: verify zephyr queue batch dequeue
+ * - API coverage
+ *   -# k_queue_get_all
+ *   -# k_queue_get_batch
+ * @}
+ */
+
+#include "test_queue.h"
+
+#define STACK_SIZE 512
+#define LIST_LEN 4
+#define TIMEOUT 100
+
+static qdata_t data[LIST_LEN];
+static struct k_queue queue;
+static char __noinit __stack tstack[STACK_SIZE];
+
+static void tqueue_fill(void)
+{
+	for (int i = 0; i < LIST_LEN; i++) {
+		data[i].data = i;
+		k_queue_append(&queue, &data[i]);
+	}
+}
+
+static void tlist_check(sys_slist_t *list, int first, int count)
+{
+	qdata_t *node;
+	int i = first;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, node, snode) {
+		assert_equal(node->data, i, NULL);
+		i++;
+	}
+	assert_equal(i - first, count, NULL);
+}
+
+static void tputter_entry(void *p1, void *p2, void *p3)
+{
+	k_sleep(TIMEOUT / 2);
+	/* keep the getter from running until all the items are queued */
+	k_sched_lock();
+	tqueue_fill();
+	k_sched_unlock();
+}
+
+/*test cases*/
+void test_queue_get_batch(void)
+{
+	sys_slist_t list;
+
+	k_queue_init(&queue);
+
+	/**TESTPOINT: batch get on an empty queue*/
+	sys_slist_init(&list);
+	assert_equal(k_queue_get_all(&queue, &list, K_NO_WAIT), -EBUSY, NULL);
+	assert_equal(k_queue_get_batch(&queue, &list, 2, K_NO_WAIT), -EBUSY,
+		     NULL);
+	assert_equal(k_queue_get_all(&queue, &list, TIMEOUT), -EAGAIN, NULL);
+	assert_true(sys_slist_is_empty(&list), NULL);
+
+	/**TESTPOINT: batch get splits the queue in order*/
+	tqueue_fill();
+	assert_equal(k_queue_get_batch(&queue, &list, 3, K_NO_WAIT), 3, NULL);
+	tlist_check(&list, 0, 3);
+	sys_slist_init(&list);
+	assert_equal(k_queue_get_batch(&queue, &list, 3, K_NO_WAIT), 1, NULL);
+	tlist_check(&list, 3, 1);
+	assert_true(k_queue_is_empty(&queue), NULL);
+
+	/**TESTPOINT: get all detaches the whole queue*/
+	sys_slist_init(&list);
+	tqueue_fill();
+	assert_equal(k_queue_get_all(&queue, &list, K_NO_WAIT), 0, NULL);
+	tlist_check(&list, 0, LIST_LEN);
+	assert_true(k_queue_is_empty(&queue), NULL);
+
+	/**TESTPOINT: the queue keeps working once drained*/
+	k_queue_append(&queue, &data[0]);
+	assert_equal_ptr(k_queue_get(&queue, K_NO_WAIT), &data[0], NULL);
+}
+
+void test_queue_get_all_pend(void)
+{
+	sys_slist_t list;
+
+	k_queue_init(&queue);
+	sys_slist_init(&list);
+
+	k_thread_spawn(tstack, STACK_SIZE, tputter_entry, NULL, NULL, NULL,
+		       K_PRIO_PREEMPT(0), 0, 0);
+
+	/**TESTPOINT: a woken up getter takes what was queued meanwhile*/
+	assert_equal(k_queue_get_all(&queue, &list, K_FOREVER), 0, NULL);
+	tlist_check(&list, 0, LIST_LEN);
+	assert_true(k_queue_is_empty(&queue), NULL);
+}
@@ -17,6 +17,7 @@ extern void test_sema_thread2thread(void);
 extern void test_sema_thread2isr(void);
 extern void test_sema_reset(void);
 extern void test_sema_count_get(void);
+extern void test_sema_wait_order(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -25,6 +26,7 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_sema_thread2thread),
 			 ztest_unit_test(test_sema_thread2isr),
 			 ztest_unit_test(test_sema_reset),
-			 ztest_unit_test(test_sema_count_get));
+			 ztest_unit_test(test_sema_count_get),
+			 ztest_unit_test(test_sema_wait_order));
 	ztest_run_test_suite(test_sema_api);
 }
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_sema_api
+ * @{
+ * @defgroup t_sema_wait_order test_sema_wait_order
+ * @brief TestPurpose: verify the order in which waiters get a semaphore
+ * - API coverage
+ *   -# k_sem_take k_sem_give
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 512
+#define NUM_WAITER 6
+
+static char __noinit __stack tstack[NUM_WAITER][STACK_SIZE];
+static const int prios[NUM_WAITER] = { 3, 1, 2, 1, 3, 2 };
+static const int expected_order[NUM_WAITER] = { 1, 3, 2, 5, 0, 4 };
+static int order[NUM_WAITER];
+static int woken;
+static struct k_sem wait_sema;
+
+static void tWaiter_entry(void *p1, void *p2, void *p3)
+{
+	k_sem_take(&wait_sema, K_FOREVER);
+	order[woken++] = (int)p1;
+}
+
+/*test cases*/
+void test_sema_wait_order(void)
+{
+	int old_prio = k_thread_priority_get(k_current_get());
+	k_tid_t tid[NUM_WAITER];
+
+	k_sem_init(&wait_sema, 0, 1);
+	woken = 0;
+
+	/* spawn all waiters before letting them pend on the semaphore */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+	for (int i = 0; i < NUM_WAITER; i++) {
+		tid[i] = k_thread_spawn(tstack[i], STACK_SIZE,
+					tWaiter_entry, (void *)i, NULL, NULL,
+					K_PRIO_PREEMPT(prios[i]), 0, 0);
+	}
+	k_sleep(10);
+
+	/**TESTPOINT: higher priorities first, then first come first served*/
+	for (int i = 0; i < NUM_WAITER; i++) {
+		k_sem_give(&wait_sema);
+		k_sleep(10);
+		assert_equal(woken, i + 1, NULL);
+		assert_equal(order[i], expected_order[i], NULL);
+	}
+
+	for (int i = 0; i < NUM_WAITER; i++) {
+		k_thread_abort(tid[i]);
+	}
+
+	/* restore environment */
+	k_thread_priority_set(k_current_get(), old_prio);
+}
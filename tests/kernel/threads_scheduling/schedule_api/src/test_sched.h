@@ -32,5 +32,7 @@ void test_time_slicing_disable_preemptible(void);
 void test_lock_preemptible(void);
 void test_unlock_preemptible(void);
 void test_sched_is_preempt_thread(void);
+void test_deadline_order(void);
+void test_deadline_preempt(void);
 
 #endif /* __TEST_SCHED_H__ */
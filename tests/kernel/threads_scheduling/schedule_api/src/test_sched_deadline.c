@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_threads_scheduling
+ * @{
+ * @defgroup t_threads_deadline test_threads_deadline
+ * @brief TestPurpose: verify earliest-deadline-first scheduling within a
+ * priority
+ * - API coverage
+ *   -# k_thread_deadline_set
+ * @}
+ */
+
+#include "test_sched.h"
+
+#define NUM_THREAD 4
+#define SPAWN_PRIO 1
+
+static char __noinit __stack tstack[NUM_THREAD][STACK_SIZE];
+/* relative deadlines of the spawned threads, K_FOREVER meaning none */
+static const int32_t deadlines[NUM_THREAD] = { K_FOREVER, 300, 100, 200 };
+static const int expected_order[NUM_THREAD] = { 2, 3, 1, 0 };
+static int order[NUM_THREAD];
+static int executed;
+
+static void thread_entry(void *p1, void *p2, void *p3)
+{
+	order[executed++] = (int)p1;
+}
+
+/*test cases*/
+void test_deadline_order(void)
+{
+	int old_prio = k_thread_priority_get(k_current_get());
+	k_tid_t tid[NUM_THREAD];
+
+	/* keep the spawned threads ready but not running */
+	k_thread_priority_set(k_current_get(), -1);
+	executed = 0;
+
+	for (int i = 0; i < NUM_THREAD; i++) {
+		tid[i] = k_thread_spawn(tstack[i], STACK_SIZE,
+					thread_entry, (void *)i, NULL, NULL,
+					SPAWN_PRIO, 0, 0);
+		k_thread_deadline_set(tid[i], deadlines[i]);
+	}
+
+	k_sleep(100);
+
+	/**TESTPOINT: earliest deadlines run first, threads without last*/
+	assert_equal(executed, NUM_THREAD, NULL);
+	for (int i = 0; i < NUM_THREAD; i++) {
+		assert_equal(order[i], expected_order[i], NULL);
+		k_thread_abort(tid[i]);
+	}
+
+	/* restore environment */
+	k_thread_priority_set(k_current_get(), old_prio);
+}
+
+void test_deadline_preempt(void)
+{
+	int old_prio = k_thread_priority_get(k_current_get());
+	k_tid_t tid;
+
+	k_thread_priority_set(k_current_get(), SPAWN_PRIO);
+	k_thread_deadline_set(k_current_get(), 200);
+	executed = 0;
+
+	tid = k_thread_spawn(tstack[0], STACK_SIZE,
+			     thread_entry, NULL, NULL, NULL,
+			     SPAWN_PRIO, 0, 0);
+	/**TESTPOINT: a later deadline does not preempt*/
+	k_thread_deadline_set(tid, 300);
+	assert_equal(executed, 0, NULL);
+
+	/**TESTPOINT: an earlier deadline preempts the current thread*/
+	k_thread_deadline_set(tid, 100);
+	assert_equal(executed, 1, NULL);
+	k_thread_abort(tid);
+
+	/* restore environment */
+	k_thread_deadline_set(k_current_get(), K_FOREVER);
+	k_thread_priority_set(k_current_get(), old_prio);
+}
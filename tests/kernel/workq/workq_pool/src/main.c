@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_workq
+ * @{
+ * @defgroup t_workq_pool test_workq_pool
+ * @brief TestPurpose: verify multi-worker work queues
+ * - API coverage
+ *   -# k_work_q_pool_start
+ *   -# k_work_submit_to_queue
+ *   -# k_delayed_work_submit_to_queue
+ * @}
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 512
+#define NUM_OF_WORKERS 2
+#define NUM_OF_WORK 4
+
+static char __noinit __stack tstack[NUM_OF_WORKERS * STACK_SIZE];
+static struct k_work_q_worker workers[NUM_OF_WORKERS];
+static struct k_work_q workq;
+static struct k_work work[NUM_OF_WORK];
+static struct k_delayed_work delayed_work;
+static struct k_sem sync_sema;
+
+static int run_order[NUM_OF_WORK];
+static int run_count;
+static int running;
+
+static void work_sleepy(struct k_work *w)
+{
+	k_sleep(TIMEOUT);
+	k_sem_give(&sync_sema);
+}
+
+static void work_handler(struct k_work *w)
+{
+	k_sem_give(&sync_sema);
+}
+
+static void work_ordered(struct k_work *w)
+{
+	/**TESTPOINT: work items of a lane never run concurrently*/
+	running++;
+	assert_equal(running, 1, NULL);
+
+	if (w == &work[0]) {
+		k_sleep(TIMEOUT);
+	}
+
+	run_order[run_count++] = w - work;
+	running--;
+	k_sem_give(&sync_sema);
+}
+
+static void tisr_submit(void *data)
+{
+	k_work_submit_to_queue(&workq, (struct k_work *)data);
+}
+
+/*test cases*/
+void test_workq_pool_no_stall(void)
+{
+	k_sem_reset(&sync_sema);
+	k_work_init(&work[0], work_sleepy);
+	k_work_init(&work[1], work_handler);
+
+	/* both go to the shared queue */
+	irq_offload(tisr_submit, &work[0]);
+	irq_offload(tisr_submit, &work[1]);
+
+	/**TESTPOINT: a sleeping handler does not hold the other work item*/
+	assert_equal(k_sem_take(&sync_sema, TIMEOUT / 2), 0, NULL);
+	assert_equal(k_sem_count_get(&sync_sema), 0, NULL);
+	assert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+void test_workq_pool_ordering(void)
+{
+	k_sem_reset(&sync_sema);
+	run_count = 0;
+
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_work_init(&work[i], work_ordered);
+		k_work_submit_to_queue(&workq, &work[i]);
+	}
+
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		assert_equal(k_sem_take(&sync_sema, 2 * TIMEOUT), 0, NULL);
+	}
+
+	/**TESTPOINT: work items submitted by a thread keep their ordering*/
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		assert_equal(run_order[i], i, NULL);
+	}
+}
+
+void test_workq_pool_delayed_work(void)
+{
+	k_sem_reset(&sync_sema);
+	k_delayed_work_init(&delayed_work, work_handler);
+
+	/**TESTPOINT: delayed work on a multi-worker queue*/
+	assert_equal(k_delayed_work_submit_to_queue(&workq, &delayed_work,
+						    TIMEOUT), 0, NULL);
+	assert_equal(k_sem_take(&sync_sema, TIMEOUT / 2), -EAGAIN, NULL);
+	assert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	k_sem_init(&sync_sema, 0, NUM_OF_WORK);
+	k_work_q_pool_start(&workq, workers, NUM_OF_WORKERS, tstack,
+			    STACK_SIZE, K_PRIO_PREEMPT(0));
+
+	ztest_test_suite(test_workq_pool,
+		ztest_unit_test(test_workq_pool_no_stall),
+		ztest_unit_test(test_workq_pool_ordering),
+		ztest_unit_test(test_workq_pool_delayed_work));
+	ztest_run_test_suite(test_workq_pool);
+}
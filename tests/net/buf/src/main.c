@@ -68,6 +68,7 @@ NET_BUF_POOL_DEFINE(bufs_pool, 22, 74, sizeof(struct bt_data), buf_destroy);
 NET_BUF_POOL_DEFINE(no_data_pool, 1, 0, sizeof(struct bt_data), NULL);
 NET_BUF_POOL_DEFINE(frags_pool, 13, 128, 0, frag_destroy);
 NET_BUF_POOL_DEFINE(big_frags_pool, 1, 1280, 0, frag_destroy_big);
+NET_BUF_POOL_DEFINE(bench_pool, 4, 16, 0, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -402,6 +403,99 @@ static void net_buf_test_multi_frags(void)
 		     "Incorrect big frag destroy callback count");
 }
 
+#define BENCH_ROUNDS 1000
+
+static K_LIFO_DEFINE(bench_lifo);
+
+static void net_buf_test_alloc_cycles(void)
+{
+	struct net_buf *bufs[bench_pool.buf_count];
+	uint32_t start, lock_free, locked;
+	unsigned int key;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc(&bench_pool, K_NO_WAIT);
+		assert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	assert_equal(net_buf_pool_free_count(&bench_pool), 0,
+		     "Empty pool has free buffers");
+	assert_is_null(net_buf_alloc(&bench_pool, K_NO_WAIT),
+		       "Got a buffer from an empty pool");
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	assert_equal(net_buf_pool_free_count(&bench_pool), ARRAY_SIZE(bufs),
+		     "Incorrect free buffer count");
+
+	start = k_cycle_get_32();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		net_buf_unref(net_buf_alloc(&bench_pool, K_NO_WAIT));
+	}
+	lock_free = k_cycle_get_32() - start;
+
+	/* The same buffers through the LIFO, as allocated before */
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc(&bench_pool, K_NO_WAIT);
+		k_lifo_put(&bench_lifo, bufs[i]);
+	}
+
+	start = k_cycle_get_32();
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		struct net_buf *buf;
+
+		key = irq_lock();
+		buf = k_lifo_get(&bench_lifo, K_NO_WAIT);
+		irq_unlock(key);
+		k_lifo_put(&bench_lifo, buf);
+	}
+	locked = k_cycle_get_32() - start;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(k_lifo_get(&bench_lifo, K_NO_WAIT));
+	}
+
+	printk("alloc and unref: %u cycles, with the LIFO: %u cycles\n",
+	       lock_free / BENCH_ROUNDS, locked / BENCH_ROUNDS);
+}
+
+static void alloc_wait_thread(void *arg1, void *arg2, void *arg3)
+{
+	k_sleep(10);
+	net_buf_unref(arg1);
+}
+
+static void net_buf_test_alloc_wait(void)
+{
+	static char __stack alloc_wait_thread_stack[1024];
+	struct net_buf *bufs[bench_pool.buf_count];
+	struct net_buf *buf;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc(&bench_pool, K_NO_WAIT);
+		assert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	k_thread_spawn(alloc_wait_thread_stack,
+		       sizeof(alloc_wait_thread_stack), alloc_wait_thread,
+		       bufs[0], NULL, NULL, K_PRIO_COOP(7), 0, 0);
+
+	/* The buffer freed while waiting is handed over */
+	buf = net_buf_alloc(&bench_pool, TEST_TIMEOUT);
+	assert_equal(buf, bufs[0], "Freed buffer not handed over");
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	assert_equal(net_buf_pool_free_count(&bench_pool), ARRAY_SIZE(bufs),
+		     "Incorrect free buffer count");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_buf_test,
@@ -410,7 +504,9 @@ void test_main(void)
 			 ztest_unit_test(net_buf_test_3),
 			 ztest_unit_test(net_buf_test_4),
 			 ztest_unit_test(net_buf_test_big_buf),
-			 ztest_unit_test(net_buf_test_multi_frags)
+			 ztest_unit_test(net_buf_test_multi_frags),
+			 ztest_unit_test(net_buf_test_alloc_cycles),
+			 ztest_unit_test(net_buf_test_alloc_wait)
 			 );
 
 	ztest_run_test_suite(net_buf_test);
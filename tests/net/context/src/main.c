@@ -349,6 +349,20 @@ static bool net_ctx_listen_v4(void)
 	return true;
 }
 
+static bool net_ctx_nodelay_v4(void)
+{
+	int ret;
+
+	ret = net_context_set_nodelay(udp_v4_ctx, true);
+	if (ret != -EPROTOTYPE) {
+		TC_ERROR("Context nodelay IPv4 UDP test failed (%d vs %d)\n",
+		       ret, -EPROTOTYPE);
+		return false;
+	}
+
+	return true;
+}
+
 static void connect_cb(struct net_context *context, int status,
 		       void *user_data)
 {
@@ -522,6 +536,12 @@ static bool net_ctx_send_v6(void)
 	return true;
 }
 
+/* The second packet to the connected peer reuses the cached headers */
+static bool net_ctx_send_v6_again(void)
+{
+	return net_ctx_send_v6();
+}
+
 static bool net_ctx_send_v4(void)
 {
 	int ret, len;
@@ -623,6 +643,67 @@ static bool net_ctx_sendto_v4(void)
 	return true;
 }
 
+#define BATCH_COUNT 3
+
+static int batch_sent;
+
+static void batch_send_cb(struct net_context *context, int status,
+			  void *token, void *user_data)
+{
+	/* Each datagram is sent with its own token */
+	if (POINTER_TO_INT(token) < 1 ||
+	    POINTER_TO_INT(token) > BATCH_COUNT) {
+		TC_ERROR("Invalid token %d\n", POINTER_TO_INT(token));
+		cb_failure = true;
+		return;
+	}
+
+	batch_sent++;
+}
+
+static bool net_ctx_sendto_batch_v6(void)
+{
+	struct net_buf *bufs[BATCH_COUNT];
+	struct sockaddr_in6 addr = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(PEER_PORT),
+		.sin6_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				   0, 0, 0, 0, 0, 0, 0, 0x2 } } },
+	};
+	int i, ret, len;
+
+	len = strlen(test_data);
+
+	for (i = 0; i < BATCH_COUNT; i++) {
+		struct net_buf *frag;
+
+		bufs[i] = net_nbuf_get_tx(udp_v6_ctx, K_FOREVER);
+		frag = net_nbuf_get_data(udp_v6_ctx, K_FOREVER);
+
+		net_buf_frag_add(bufs[i], frag);
+
+		memcpy(net_buf_add(frag, len), test_data, len);
+
+		net_nbuf_set_appdatalen(bufs[i], len);
+		net_nbuf_set_token(bufs[i], INT_TO_POINTER(i + 1));
+	}
+
+	batch_sent = 0;
+
+	ret = net_context_sendto_batch(bufs, BATCH_COUNT,
+				       (struct sockaddr *)&addr,
+				       sizeof(struct sockaddr_in6),
+				       batch_send_cb, 0,
+				       INT_TO_POINTER(AF_INET6));
+	if (ret != BATCH_COUNT || cb_failure || batch_sent > BATCH_COUNT) {
+		TC_ERROR("Context sendto batch IPv6 UDP test failed (%d)\n",
+			 ret);
+		return false;
+	}
+
+	return true;
+}
+
 static void recv_cb(struct net_context *context,
 		    struct net_buf *buf,
 		    int status,
@@ -1189,14 +1270,17 @@ static const struct {
 	{ "net_context_bind mcast", net_ctx_bind_mcast_success },
 	{ "net_context_listen IPv6", net_ctx_listen_v6 },
 	{ "net_context_listen IPv4", net_ctx_listen_v4 },
+	{ "net_context_set_nodelay IPv4", net_ctx_nodelay_v4 },
 	{ "net_context_connect IPv6", net_ctx_connect_v6 },
 	{ "net_context_connect IPv4", net_ctx_connect_v4 },
 	{ "net_context_accept IPv6", net_ctx_accept_v6 },
 	{ "net_context_accept IPv4", net_ctx_accept_v4 },
 	{ "net_context_send IPv6", net_ctx_send_v6 },
+	{ "net_context_send IPv6 again", net_ctx_send_v6_again },
 	{ "net_context_send IPv4", net_ctx_send_v4 },
 	{ "net_context_sendto IPv6", net_ctx_sendto_v6 },
 	{ "net_context_sendto IPv4", net_ctx_sendto_v4 },
+	{ "net_context_sendto_batch IPv6", net_ctx_sendto_batch_v6 },
 	{ "net_context_recv IPv6", net_ctx_recv_v6 },
 	{ "net_context_recv IPv4", net_ctx_recv_v4 },
 	{ "net_context_recv IPv6 fail", net_ctx_recv_v6_fail },
@@ -136,6 +136,7 @@ struct net_fragment_data {
 	struct net_udp_hdr udp;
 	int len;
 	bool iphc;
+	bool reverse;
 } __packed;
 
 
@@ -414,11 +415,31 @@ static struct net_fragment_data test_data_8 = {
 	.iphc = false
 };
 
+static struct net_fragment_data test_data_9 = {
+	.ipv6.vtc = 0x60,
+	.ipv6.tcflow = 0x00,
+	.ipv6.flow = 0x00,
+	.ipv6.len = { 0x00, 0x00 },
+	.ipv6.nexthdr = IPPROTO_UDP,
+	.ipv6.hop_limit = 0xff,
+	.ipv6.src = src_sam00,
+	.ipv6.dst = dst_dam00,
+	.udp.src_port = htons(udp_src_port_4bit),
+	.udp.dst_port = htons(udp_dst_port_4bit),
+	.udp.len = 0x00,
+	.udp.chksum = 0x00,
+	.len = 500,
+	.iphc = true,
+	.reverse = true
+};
+
 static int test_fragment(struct net_fragment_data *data)
 {
 	struct net_buf *rxbuf = NULL;
 	int result = TC_FAIL;
 	struct net_buf *buf, *frag, *dfrag;
+	struct net_buf *frags[16];
+	int count, i;
 
 	buf = create_buf(data);
 	if (!buf) {
@@ -443,9 +464,20 @@ static int test_fragment(struct net_fragment_data *data)
 	net_hexdump_frags("after-compression", buf);
 #endif
 
+	/* Fragments are fed in order, or backwards for out of order
+	 * reassembly.
+	 */
 	frag = buf->frags;
+	count = 0;
+
+	while (frag && count < ARRAY_SIZE(frags)) {
+		frags[count++] = frag;
+		frag = frag->frags;
+	}
+
+	for (i = 0; i < count; i++) {
+		frag = frags[data->reverse ? count - 1 - i : i];
 
-	while (frag) {
 		rxbuf = net_nbuf_get_reserve_rx(0, K_FOREVER);
 		if (!rxbuf) {
 			goto end;
@@ -465,7 +497,6 @@ static int test_fragment(struct net_fragment_data *data)
 
 		switch (ieee802154_reassemble(rxbuf)) {
 		case NET_OK:
-			frag = frag->frags;
 			break;
 		case NET_CONTINUE:
 			goto compare;
@@ -509,6 +540,7 @@ static const struct {
 	{ "test_fragment_sam10_m1_dam10", &test_data_6},
 	{ "test_fragment_ipv6_dispatch_small", &test_data_7},
 	{ "test_fragment_ipv6_dispatch_big", &test_data_8},
+	{ "test_fragment_out_of_order", &test_data_9},
 };
 
 static void main_thread(void)
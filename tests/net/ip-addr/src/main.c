@@ -144,11 +144,19 @@ static int tester_send(struct net_if *iface, struct net_buf *buf)
 	return 0;
 }
 
+static int mcast_filter_calls;
+
+static void tester_mcast_filter(struct net_if *iface)
+{
+	mcast_filter_calls++;
+}
+
 struct net_test_context net_test_context_data;
 
 static struct net_if_api net_test_if_api = {
 	.init = net_test_iface_init,
 	.send = tester_send,
+	.mcast_filter = tester_mcast_filter,
 };
 
 #define _ETH_L2_LAYER DUMMY_L2
@@ -286,12 +294,33 @@ static bool run_tests(void)
 		return false;
 	}
 
+	mcast_filter_calls = 0;
+
 	ifmaddr1 = net_if_ipv6_maddr_add(net_if_get_default(), &mcast);
 	if (!ifmaddr1) {
 		printk("IPv6 multicast address add failed\n");
 		return false;
 	}
 
+	if (!mcast_filter_calls) {
+		printk("IPv6 multicast filter not updated\n");
+		return false;
+	}
+
+	if (net_if_ipv6_maddr_lookup(&mcast, NULL) != ifmaddr1) {
+		printk("IPv6 multicast address lookup failed\n");
+		return false;
+	}
+
+	mcast.s6_addr[15]++;
+
+	if (net_if_ipv6_maddr_lookup(&mcast, NULL)) {
+		printk("IPv6 multicast address lookup matched another group\n");
+		return false;
+	}
+
+	mcast.s6_addr[15]--;
+
 	ifmaddr1 = net_if_ipv6_maddr_add(net_if_get_default(), &addr6);
 	if (ifmaddr1) {
 		printk("IPv6 multicast address could be added failed\n");
@@ -22,6 +22,7 @@
 
 #include "icmpv6.h"
 #include "ipv6.h"
+#include "pmtu.h"
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
@@ -119,6 +120,37 @@ static const unsigned char ipv6_hbho[] = {
 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,              /* ...... */
 };
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+/* UDP packet in two fragments, the last one first */
+static const unsigned char ipv6_frag_last[] = {
+/* IPv6 header starts here */
+0x60, 0x00, 0x00, 0x00, 0x00, 0x10, 0x2c, 0x3f,
+0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+/* Fragment header starts here (offset 16, last fragment) */
+0x11, 0x00, 0x00, 0x10, 0x12, 0x34, 0x56, 0x78,
+/* Data */
+0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+};
+
+static const unsigned char ipv6_frag_first[] = {
+/* IPv6 header starts here */
+0x60, 0x00, 0x00, 0x00, 0x00, 0x18, 0x2c, 0x3f,
+0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+0x20, 0x01, 0x0D, 0xB8, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+/* Fragment header starts here (offset 0, more fragments) */
+0x11, 0x00, 0x00, 0x01, 0x12, 0x34, 0x56, 0x78,
+/* UDP header starts here */
+0xaa, 0xdc, 0xbf, 0xd7, 0x00, 0x18, 0x00, 0x00,
+/* Data */
+0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+};
+#endif /* CONFIG_NET_IPV6_FRAGMENT */
+
 static bool test_failed;
 static struct k_sem wait_data;
 
@@ -600,6 +632,102 @@ static bool net_test_hbho_message(void)
 	return true;
 }
 
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+static struct net_buf *prepare_fragment(const unsigned char *data,
+					size_t len)
+{
+	struct net_buf *buf, *frag;
+
+	buf = net_nbuf_get_reserve_rx(0, K_FOREVER);
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	net_buf_frag_add(buf, frag);
+
+	net_nbuf_set_iface(buf, net_if_get_default());
+	net_nbuf_set_family(buf, AF_INET6);
+
+	memcpy(net_buf_add(frag, len), data, len);
+
+	return buf;
+}
+
+static bool net_test_reassembly(void)
+{
+	struct net_buf *buf;
+	uint8_t data[24];
+	uint16_t pos;
+
+	buf = prepare_fragment(ipv6_frag_last, sizeof(ipv6_frag_last));
+	if (net_ipv6_reassemble(buf, offsetof(struct net_ipv6_hdr, nexthdr),
+				sizeof(struct net_ipv6_hdr))) {
+		TC_ERROR("Packet reassembled from the last fragment\n");
+		return false;
+	}
+
+	buf = prepare_fragment(ipv6_frag_first, sizeof(ipv6_frag_first));
+	buf = net_ipv6_reassemble(buf, offsetof(struct net_ipv6_hdr, nexthdr),
+				  sizeof(struct net_ipv6_hdr));
+	if (!buf) {
+		TC_ERROR("Packet not reassembled\n");
+		return false;
+	}
+
+	if (NET_IPV6_BUF(buf)->nexthdr != IPPROTO_UDP ||
+	    NET_IPV6_BUF(buf)->len[0] != 0 ||
+	    NET_IPV6_BUF(buf)->len[1] != sizeof(data) ||
+	    net_buf_frags_len(buf->frags) !=
+	    sizeof(struct net_ipv6_hdr) + sizeof(data)) {
+		TC_ERROR("Invalid reassembled IPv6 header\n");
+		return false;
+	}
+
+	net_nbuf_read(buf->frags, sizeof(struct net_ipv6_hdr), &pos,
+		      sizeof(data), data);
+	if (memcmp(data, ipv6_frag_first + sizeof(struct net_ipv6_hdr) +
+		   NET_IPV6_FRAGH_LEN, 16) ||
+	    memcmp(data + 16, ipv6_frag_last + sizeof(struct net_ipv6_hdr) +
+		   NET_IPV6_FRAGH_LEN, 8)) {
+		TC_ERROR("Invalid reassembled data\n");
+		return false;
+	}
+
+	net_nbuf_unref(buf);
+
+	return true;
+}
+#endif /* CONFIG_NET_IPV6_FRAGMENT */
+
+#if defined(CONFIG_NET_PMTU)
+static bool net_test_pmtu(void)
+{
+	struct net_if *iface = net_if_get_default();
+	uint16_t mtu = net_if_get_mtu(iface);
+	bool ok;
+
+	net_if_set_mtu(iface, 1500);
+
+	net_pmtu_update(AF_INET6, &peer_addr, 1400);
+	net_pmtu_update(AF_INET6, &peer_addr, 1450);
+
+	ok = net_pmtu_get_mtu(iface, AF_INET6, &peer_addr) == 1400 &&
+	     net_pmtu_get_mtu(iface, AF_INET6, &my_addr) == 1500;
+
+	net_if_set_mtu(iface, mtu);
+
+	if (!ok) {
+		TC_ERROR("Invalid path MTU\n");
+		return false;
+	}
+
+	/* Links below the IPv6 minimum MTU fragment packets themselves */
+	if (net_pmtu_get_mtu(iface, AF_INET6, &my_addr) != NET_IPV6_MTU) {
+		TC_ERROR("Invalid link MTU\n");
+		return false;
+	}
+
+	return true;
+}
+#endif /* CONFIG_NET_PMTU */
+
 static bool net_test_change_ll_addr(void)
 {
 	uint8_t new_mac[] = { 00, 01, 02, 03, 04, 05 };
@@ -689,6 +817,12 @@ static const struct {
 	{ "IPv6 send NS no options", net_test_send_ns_no_options },
 	{ "IPv6 handle RA message", net_test_ra_message },
 	{ "IPv6 parse Hop-By-Hop Option", net_test_hbho_message },
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+	{ "IPv6 fragment reassembly", net_test_reassembly },
+#endif
+#if defined(CONFIG_NET_PMTU)
+	{ "IPv6 path MTU", net_test_pmtu },
+#endif
 	{ "IPv6 change ll address", net_test_change_ll_addr },
 	{ "IPv6 prefix timeout", net_test_prefix_timeout },
 	/*{ "IPv6 prefix timeout overflow", net_test_prefix_timeout_overflow },*/
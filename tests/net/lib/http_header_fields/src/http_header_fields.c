@@ -653,6 +653,52 @@ int test_header_nread_value(void)
 	return TC_PASS;
 }
 
+static size_t header_value_len;
+
+static int on_header_value(struct http_parser *parser, const char *at,
+			   size_t length)
+{
+	header_value_len += length;
+
+	return 0;
+}
+
+static
+struct http_parser_settings settings_header_value = {
+	.on_header_value = on_header_value };
+
+int test_header_value_scan(void)
+{
+	static const char value[] = "a long value\twith a tab, \xe9 and "
+				    "more than a few words";
+	const char *names[] = { "A", "Bb", "Ccc", "Dddd" };
+	struct http_parser parser = { 0 };
+	char buf[128];
+	size_t parsed;
+	int i, len;
+
+	/* The value starts at all the word alignments */
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		len = snprintk(buf, sizeof(buf),
+			       "GET / HTTP/1.1\r\n%s: %s\r\n\r\n",
+			       names[i], value);
+
+		header_value_len = 0;
+		http_parser_init(&parser, HTTP_REQUEST);
+		parsed = http_parser_execute(&parser, &settings_header_value,
+					     buf, len);
+		if (parsed != len || HTTP_PARSER_ERRNO(&parser) != HPE_OK) {
+			return TC_FAIL;
+		}
+
+		if (header_value_len != sizeof(value) - 1) {
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
 int test_invalid_header_content(int req, const char *str)
 {
 	struct http_parser parser = { 0 };
@@ -694,6 +740,12 @@ int test_invalid_header_field_content_error(int req)
 		return TC_FAIL;
 	}
 
+	rc = test_invalid_header_content(req,
+					 "Foo: a long value with a \177 char");
+	if (rc != 0) {
+		return TC_FAIL;
+	}
+
 	return TC_PASS;
 }
 
@@ -863,6 +915,12 @@ void main(void)
 		goto exit_test;
 	}
 
+	rc = test_header_value_scan();
+	TC_PRINT("[%s] test_header_value_scan\n", RC_STR(rc));
+	if (rc != TC_PASS) {
+		goto exit_test;
+	}
+
 	/* header field tests */
 	rc = test_double_content_length_error(HTTP_REQUEST);
 	TC_PRINT("[%s] test_double_content_length_error HTTP_REQUEST\n",
@@ -867,8 +867,20 @@ static int eval_msg_publish(struct mqtt_test *mqtt_test)
 		return TC_FAIL;
 	}
 
-	return eval_buffers(buf, buf_len,
-			    mqtt_test->expected, mqtt_test->expected_len);
+	rc = eval_buffers(buf, buf_len,
+			  mqtt_test->expected, mqtt_test->expected_len);
+	if (rc != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	/* The header is the message without its payload */
+	rc = mqtt_pack_publish_header(buf, &buf_len, sizeof(buf), msg);
+	if (rc != 0) {
+		return TC_FAIL;
+	}
+
+	return eval_buffers(buf, buf_len, mqtt_test->expected,
+			    mqtt_test->expected_len - msg->msg_len);
 }
 
 static int eval_msg_subscribe(struct mqtt_test *mqtt_test)
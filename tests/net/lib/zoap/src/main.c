@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <misc/byteorder.h>
 #include <misc/printk.h>
 
 #include <kernel.h>
@@ -463,6 +464,99 @@ done:
 	return result;
 }
 
+static int test_parse_options(void)
+{
+	/* 3 path segments and a content format, then 14 path segments:
+	 * more than the packet can index.
+	 */
+	uint8_t pdu[] = { 0x40, 0x01, 0x12, 0x34,
+			  0xb1, 'a', 0x02, 'b', 'c', 0x01, 'd',
+			  0x11, 0x2a };
+	uint8_t long_pdu[] = { 0x40, 0x01, 0x12, 0x34,
+			       0xb1, 'a', 0x01, 'b', 0x01, 'c', 0x01, 'd',
+			       0x01, 'e', 0x01, 'f', 0x01, 'g', 0x01, 'h',
+			       0x01, 'i', 0x01, 'j', 0x01, 'k', 0x01, 'l',
+			       0x01, 'm', 0x01, 'n' };
+	struct zoap_packet pkt;
+	struct net_buf *buf, *frag;
+	struct zoap_option options[16];
+	int result = TC_FAIL;
+	int r, count;
+
+	buf = net_buf_alloc(&zoap_nbuf_pool, K_NO_WAIT);
+	if (!buf) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	frag = net_buf_alloc(&zoap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	net_buf_frag_add(buf, frag);
+
+	memcpy(frag->data, pdu, sizeof(pdu));
+	frag->len = sizeof(pdu);
+
+	r = zoap_packet_parse(&pkt, buf);
+	if (r) {
+		TC_PRINT("Could not parse packet\n");
+		goto done;
+	}
+
+	count = zoap_find_options(&pkt, ZOAP_OPTION_URI_PATH, options, 16);
+	if (count != 3) {
+		TC_PRINT("Unexpected number of path options\n");
+		goto done;
+	}
+
+	if (options[1].len != 2 || memcmp(options[1].value, "bc", 2) ||
+	    options[2].len != 1 || ((uint8_t *)options[2].value)[0] != 'd') {
+		TC_PRINT("Path options don't match the reference\n");
+		goto done;
+	}
+
+	count = zoap_find_options(&pkt, ZOAP_OPTION_CONTENT_FORMAT,
+				  options, 16);
+	if (count != 1 || zoap_option_value_to_int(&options[0]) != 42) {
+		TC_PRINT("Content format doesn't match the reference\n");
+		goto done;
+	}
+
+	/* Only the first one is wanted */
+	count = zoap_find_options(&pkt, ZOAP_OPTION_URI_PATH, options, 1);
+	if (count != 1 || ((uint8_t *)options[0].value)[0] != 'a') {
+		TC_PRINT("Unexpected first path option\n");
+		goto done;
+	}
+
+	memcpy(frag->data, long_pdu, sizeof(long_pdu));
+	frag->len = sizeof(long_pdu);
+
+	r = zoap_packet_parse(&pkt, buf);
+	if (r) {
+		TC_PRINT("Could not parse packet\n");
+		goto done;
+	}
+
+	count = zoap_find_options(&pkt, ZOAP_OPTION_URI_PATH, options, 16);
+	if (count != 14 || ((uint8_t *)options[13].value)[0] != 'n') {
+		TC_PRINT("Path options of the long packet don't match\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	net_buf_unref(buf);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static int test_retransmit_second_round(void)
 {
 	struct zoap_packet pkt, resp;
@@ -789,6 +883,153 @@ static int resource_reply_cb(const struct zoap_packet *response,
 	return 0;
 }
 
+static int notifications_sent;
+
+static int server_notify_send(struct zoap_resource *resource,
+			      struct zoap_observer *observer,
+			      const struct zoap_notification *notification,
+			      void *user_data)
+{
+	uint8_t expected_pdu[] = { 0x40, 0x45, 0x00, 0x00,
+				   0x00, 0x00, 0x00, 0x00, /* token */
+				   0x61, 0x03, /* observe */
+				   0xff, 'c', 'o', 'u', 'n', 't', 'e', 'r' };
+	uint8_t pdu[sizeof(expected_pdu)];
+	struct zoap_packet pkt;
+	struct net_buf *buf, *frag;
+	uint16_t id = notifications_sent + 1;
+	int result = -EINVAL;
+	int r;
+
+	buf = net_buf_alloc(&zoap_nbuf_pool, K_NO_WAIT);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	frag = net_buf_alloc(&zoap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		net_buf_unref(buf);
+		return -ENOMEM;
+	}
+
+	net_buf_frag_add(buf, frag);
+
+	r = zoap_notification_packet_init(&pkt, buf, notification, observer,
+					  id);
+	if (r) {
+		TC_PRINT("Could not build the notification\n");
+		goto done;
+	}
+
+	expected_pdu[0] |= observer->tkl;
+	sys_put_be16(id, &expected_pdu[2]);
+	memcpy(&expected_pdu[4], observer->token, observer->tkl);
+	memmove(&expected_pdu[4 + observer->tkl], &expected_pdu[8],
+		sizeof(expected_pdu) - 8);
+
+	if (frag->frags != notification->frag ||
+	    net_buf_frags_len(buf->frags) !=
+	    sizeof(expected_pdu) - 4 + observer->tkl) {
+		TC_PRINT("The notification doesn't share the payload\n");
+		goto done;
+	}
+
+	memcpy(pdu, frag->data, frag->len);
+	memcpy(pdu + frag->len, frag->frags->data, frag->frags->len);
+
+	if (memcmp(pdu, expected_pdu, net_buf_frags_len(buf->frags))) {
+		TC_PRINT("Notification doesn't match the reference\n");
+		goto done;
+	}
+
+	if (zoap_header_get_id(&pkt) != id) {
+		TC_PRINT("Unexpected notification id\n");
+		goto done;
+	}
+
+	notifications_sent++;
+	result = 0;
+
+done:
+	net_buf_unref(buf);
+
+	return result;
+}
+
+static int test_notify_shared(void)
+{
+	static const char * const path[] = { "counter", NULL };
+	struct zoap_resource resource = { .path = path };
+	struct zoap_observer observers_shared[2] = {
+		{ .token = { 0x01 }, .tkl = 1 },
+		{ .token = { 0x0a, 0x0b, 0x0c, 0x0d }, .tkl = 4 },
+	};
+	struct zoap_packet pkt;
+	struct net_buf *buf, *frag;
+	uint8_t *payload;
+	uint16_t len;
+	int result = TC_FAIL;
+	int r;
+
+	zoap_register_observer(&resource, &observers_shared[0]);
+	zoap_register_observer(&resource, &observers_shared[1]);
+
+	buf = net_buf_alloc(&zoap_nbuf_pool, K_NO_WAIT);
+	if (!buf) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	frag = net_buf_alloc(&zoap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	net_buf_frag_add(buf, frag);
+
+	r = zoap_notification_init(&pkt, buf, &resource);
+	if (r) {
+		TC_PRINT("Could not initialize the notification\n");
+		goto done;
+	}
+
+	payload = zoap_packet_get_payload(&pkt, &len);
+	if (!payload) {
+		TC_PRINT("Could not get payload\n");
+		goto done;
+	}
+
+	memcpy(payload, "counter", 7);
+
+	r = zoap_packet_set_used(&pkt, 7);
+	if (r) {
+		TC_PRINT("Could not set used payload size\n");
+		goto done;
+	}
+
+	r = zoap_resource_notify_shared(&resource, &pkt, server_notify_send,
+					NULL);
+	if (r) {
+		TC_PRINT("Could not notify the observers\n");
+		goto done;
+	}
+
+	if (notifications_sent != 2) {
+		TC_PRINT("Not all the observers were notified\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	net_buf_unref(buf);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static int test_observer_client(void)
 {
 	struct zoap_packet req, rsp;
@@ -1059,8 +1300,10 @@ static const struct {
 	{ "No size for options test", test_build_no_size_for_options, },
 	{ "Parse emtpy PDU test", test_parse_empty_pdu, },
 	{ "Parse simple PDU test", test_parse_simple_pdu, },
+	{ "Parse options test", test_parse_options, },
 	{ "Test retransmission", test_retransmit_second_round, },
 	{ "Test observer server", test_observer_server, },
+	{ "Test shared notification", test_notify_shared, },
 	{ "Test observer client", test_observer_client, },
 	{ "Test block sized transfer", test_block_size, },
 };
@@ -141,7 +141,9 @@ static inline int test_sending_event(uint32_t times, bool receiver)
 			ret = TC_FAIL;
 		}
 
-		if (rx_calls != times) {
+		/* The events are thrown before the receiver runs */
+		if (rx_calls != (IS_ENABLED(CONFIG_NET_MGMT_EVENT_COALESCE) ?
+				 1 : times)) {
 			ret = TC_FAIL;
 		}
 
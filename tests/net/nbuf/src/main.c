@@ -1186,6 +1186,289 @@ static int test_fragment_compact(void)
 	return 0;
 }
 
+static const void *ext_data_released;
+static void *ext_user_data_released;
+
+static void ext_data_cb(const void *data, void *user_data)
+{
+	ext_data_released = data;
+	ext_user_data_released = user_data;
+}
+
+static int test_ext_data(void)
+{
+	struct net_buf *buf, *frag, *ext;
+	uint8_t data[sizeof(example_data) + 3];
+	uint16_t pos;
+
+	buf = net_nbuf_get_reserve_tx(0, K_FOREVER);
+
+	net_nbuf_append(buf, 3, (uint8_t *)"hdr", K_FOREVER);
+
+	ext = net_nbuf_get_ext_data(example_data, sizeof(example_data),
+				    ext_data_cb, &ext_data_released,
+				    K_FOREVER);
+	if (!ext) {
+		printk("Cannot get external data fragment\n");
+		return -1;
+	}
+
+	net_buf_frag_add(buf, ext);
+
+	if (net_buf_tailroom(ext) || net_buf_headroom(ext)) {
+		printk("External data must have no tailroom nor headroom\n");
+		return -1;
+	}
+
+	/* Appended data goes after the external data, in a new fragment */
+	net_nbuf_append(buf, 3, (uint8_t *)"end", K_FOREVER);
+
+	if (calc_fragments(buf) != 4) {
+		printk("Data appended in the external data fragment\n");
+		return -1;
+	}
+
+	net_nbuf_compact(buf);
+
+	if (buf->frags->frags != ext || ext->data != (uint8_t *)example_data ||
+	    ext->len != sizeof(example_data)) {
+		printk("External data fragment was compacted\n");
+		return -1;
+	}
+
+	frag = net_nbuf_read(buf->frags, 0, &pos, sizeof(data), data);
+	if (!frag || memcmp(data, "hdr", 3) ||
+	    memcmp(data + 3, example_data, sizeof(example_data))) {
+		printk("External data read failed\n");
+		return -1;
+	}
+
+	frag = net_nbuf_write(buf, ext, 1, &pos, 3, (uint8_t *)"xyz",
+			      K_FOREVER);
+	if (frag || pos != 0xffff) {
+		printk("External data was written to\n");
+		return -1;
+	}
+
+	net_nbuf_unref(buf);
+
+	if (ext_data_released != example_data ||
+	    ext_user_data_released != &ext_data_released) {
+		printk("External data release callback not called\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int test_nbuf_cursor(void)
+{
+	struct net_nbuf_cursor cursor;
+	struct net_buf *buf, *frag;
+	uint8_t copy[6], *data;
+	uint16_t value16, len;
+	uint32_t value32;
+	int i;
+
+	buf = net_nbuf_get_reserve_rx(0, K_FOREVER);
+
+	/* "01234" "" "56789" "ab" */
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	memcpy(net_buf_add(frag, 5), "01234", 5);
+	net_buf_frag_add(buf, frag);
+
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	net_buf_frag_add(buf, frag);
+
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	memcpy(net_buf_add(frag, 5), "56789", 5);
+	net_buf_frag_add(buf, frag);
+
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	memcpy(net_buf_add(frag, 2), "ab", 2);
+	net_buf_frag_add(buf, frag);
+
+	if (!net_nbuf_cursor_init(&cursor, buf->frags, 3)) {
+		printk("Cannot place the cursor\n");
+		return -1;
+	}
+
+	data = net_nbuf_cursor_data(&cursor, &len);
+	if (len != 2 || memcmp(data, "34", 2)) {
+		printk("Invalid contiguous data at the cursor\n");
+		return -1;
+	}
+
+	/* Data spanning fragments is copied, over the empty one */
+	data = net_nbuf_cursor_pull(&cursor, 4, copy);
+	if (data != copy || memcmp(copy, "3456", 4)) {
+		printk("Invalid data pulled across fragments\n");
+		return -1;
+	}
+
+	/* Contiguous data is used in place */
+	data = net_nbuf_cursor_pull(&cursor, 2, copy);
+	if (data != buf->frags->frags->frags->data + 2 ||
+	    memcmp(data, "78", 2)) {
+		printk("Contiguous data was not pulled in place\n");
+		return -1;
+	}
+
+	if (!net_nbuf_cursor_read_be16(&cursor, &value16) ||
+	    value16 != ('9' << 8 | 'a')) {
+		printk("Invalid 16 bit value across fragments\n");
+		return -1;
+	}
+
+	if (!net_nbuf_cursor_skip(&cursor, 1) || cursor.frag) {
+		printk("Cursor not at the end of the data\n");
+		return -1;
+	}
+
+	if (net_nbuf_cursor_read_u8(&cursor, copy)) {
+		printk("Read past the end of the data\n");
+		return -1;
+	}
+
+	if (!net_nbuf_cursor_init(&cursor, buf->frags, 0) ||
+	    !net_nbuf_cursor_read_be32(&cursor, &value32) ||
+	    value32 != ('0' << 24 | '1' << 16 | '2' << 8 | '3')) {
+		printk("Invalid 32 bit value\n");
+		return -1;
+	}
+
+	if (net_nbuf_cursor_skip(&cursor, 9)) {
+		printk("Skipped past the end of the data\n");
+		return -1;
+	}
+
+	if (net_nbuf_cursor_init(&cursor, buf->frags, 13)) {
+		printk("Cursor placed past the end of the data\n");
+		return -1;
+	}
+
+	/* The offset based API goes through the cursor */
+	for (i = 0; i < 12; i++) {
+		uint16_t pos;
+
+		frag = net_nbuf_read(buf->frags, i, &pos, 1, copy);
+		if ((!frag && (i != 11 || pos)) ||
+		    copy[0] != "0123456789ab"[i]) {
+			printk("Invalid byte read at %d\n", i);
+			return -1;
+		}
+	}
+
+	net_nbuf_unref(buf);
+
+	return 0;
+}
+
+static int test_nbuf_coalesce(void)
+{
+	static const char *parts[] = { "0123456789", "", "ab", "cdefgh", "" };
+	struct net_buf *buf, *frag;
+	int i;
+
+	buf = net_nbuf_get_reserve_rx(0, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(parts); i++) {
+		frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+		memcpy(net_buf_add(frag, strlen(parts[i])), parts[i],
+		       strlen(parts[i]));
+		net_buf_frag_add(buf, frag);
+	}
+
+	/* Only "ab" fits in the budget, empty fragments are always dropped */
+	i = net_nbuf_coalesce(buf, 4);
+	if (i != 3) {
+		printk("Invalid number of fragments released, %d\n", i);
+		return -1;
+	}
+
+	frag = buf->frags;
+	if (frag->len != 12 || memcmp(frag->data, "0123456789ab", 12)) {
+		printk("Invalid data in the first fragment\n");
+		return -1;
+	}
+
+	frag = frag->frags;
+	if (!frag || frag->len != 6 || memcmp(frag->data, "cdefgh", 6) ||
+	    frag->frags) {
+		printk("Invalid fragments after coalescing\n");
+		return -1;
+	}
+
+	/* Nothing is copied without a budget */
+	if (net_nbuf_coalesce(buf, 0) != 0) {
+		printk("Fragments released without a budget\n");
+		return -1;
+	}
+
+	if (net_nbuf_coalesce(buf, 6) != 1 || buf->frags->frags ||
+	    buf->frags->len != 18 ||
+	    memcmp(buf->frags->data, "0123456789abcdefgh", 18)) {
+		printk("Fragments not coalesced\n");
+		return -1;
+	}
+
+	net_nbuf_unref(buf);
+
+	return 0;
+}
+
+NET_NBUF_DATA_POOL_DEFINE(context_data_pool, 2);
+
+static int test_context_pools(void)
+{
+	static struct net_context context;
+	uint8_t data[CONFIG_NET_NBUF_DATA_SIZE * 2] = { 0 };
+	int tx, rx, free_data, count, avail;
+	struct net_buf *buf;
+
+	net_context_setup_pools(&context, NULL, &context_data_pool);
+
+	buf = net_nbuf_get_reserve_tx(0, K_FOREVER);
+	net_nbuf_set_context(buf, &context);
+
+	net_nbuf_get_info(NULL, NULL, NULL, &tx, &rx, &free_data);
+
+	if (!net_nbuf_append(buf, sizeof(data), data, K_FOREVER)) {
+		printk("Cannot append to the context pool\n");
+		return -1;
+	}
+
+	net_nbuf_get_pool_info(&context_data_pool, &count, &avail);
+	if (count != 2 || avail != 0) {
+		printk("Context pool has %d of %d available, expected 0\n",
+		       avail, count);
+		return -1;
+	}
+
+	net_nbuf_get_info(NULL, NULL, NULL, &tx, &rx, &count);
+	if (count != free_data) {
+		printk("Global data pool used, %d available instead of %d\n",
+		       count, free_data);
+		return -1;
+	}
+
+	/* The context cannot take more than its own fragments */
+	if (net_nbuf_append(buf, 1, data, K_NO_WAIT)) {
+		printk("Appended beyond the context pool\n");
+		return -1;
+	}
+
+	net_nbuf_unref(buf);
+
+	net_nbuf_get_pool_info(&context_data_pool, &count, &avail);
+	if (avail != 2) {
+		printk("Context pool fragments not released\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 void main(void)
 {
 	if (test_ipv6_multi_frags() < 0) {
@@ -1212,6 +1495,22 @@ void main(void)
 		goto fail;
 	}
 
+	if (test_ext_data() < 0) {
+		goto fail;
+	}
+
+	if (test_nbuf_cursor() < 0) {
+		goto fail;
+	}
+
+	if (test_nbuf_coalesce() < 0) {
+		goto fail;
+	}
+
+	if (test_context_pools() < 0) {
+		goto fail;
+	}
+
 	printk("nbuf tests passed\n");
 
 	TC_END_REPORT(TC_PASS);
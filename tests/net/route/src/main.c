@@ -590,6 +590,55 @@ static bool route_lookup_fail(void)
 	return true;
 }
 
+static bool route_lookup_prefix(void)
+{
+	struct net_route_entry *prefix_entry, *found;
+
+	/* generic_addr/64 covers all the test addresses but ll_addr */
+	prefix_entry = net_route_add(my_iface, &generic_addr, 64, &peer_addr);
+	if (!prefix_entry) {
+		TC_ERROR("Prefix route add failed\n");
+		return false;
+	}
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	if (found != entry) {
+		TC_ERROR("Longest prefix not found for dest address\n");
+		return false;
+	}
+
+	found = net_route_lookup(my_iface, &my_addr);
+	if (found != prefix_entry) {
+		TC_ERROR("Prefix not found for my address\n");
+		return false;
+	}
+
+	found = net_route_lookup(my_iface, &ll_addr);
+	if (found) {
+		TC_ERROR("Prefix found for link local address\n");
+		return false;
+	}
+
+	if (net_route_del(prefix_entry) < 0) {
+		TC_ERROR("Prefix route del failed\n");
+		return false;
+	}
+
+	found = net_route_lookup(my_iface, &my_addr);
+	if (found) {
+		TC_ERROR("Deleted prefix route found\n");
+		return false;
+	}
+
+	found = net_route_lookup(my_iface, &dest_addr);
+	if (found != entry) {
+		TC_ERROR("Route lost after prefix route del\n");
+		return false;
+	}
+
+	return true;
+}
+
 static bool route_del_nexthop(void)
 {
 	struct in6_addr *nexthop = &peer_addr;
@@ -666,6 +715,7 @@ static const struct {
 	{ "Get nexthop", route_get_nexthop },
 	{ "Lookup route ok", route_lookup_ok },
 	{ "Lookup route fail", route_lookup_fail },
+	{ "Lookup longest prefix", route_lookup_prefix },
 	{ "Del route", route_del },
 	{ "Add route again", route_add },
 	{ "Del route by nexthop", route_del_nexthop },
@@ -1065,6 +1065,159 @@ static bool test_v4_seq_check(void)
 	return true;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+static bool test_v4_sack_permitted(void)
+{
+	static const uint8_t sack_perm[] = { NET_TCP_OPT_NOP, NET_TCP_OPT_NOP,
+					     NET_TCP_OPT_SACK_PERM, 2 };
+	struct net_tcp *tcp = v4_ctx->tcp;
+	uint8_t flags = NET_TCP_SYN;
+	struct net_buf *buf = NULL;
+	int ret;
+
+	ret = net_tcp_prepare_segment(tcp, flags, NULL, 0, NULL,
+				      (struct sockaddr *)&peer_v4_addr, &buf);
+	if (ret) {
+		printk("Prepare segment failed (%d)\n", ret);
+		return false;
+	}
+
+	net_hexdump_frags("TCPv4", buf);
+
+	if ((NET_TCP_BUF(buf)->offset >> 4) !=
+	    (NET_TCPH_LEN + sizeof(sack_perm)) / 4) {
+		printk("Header length does not match (%d)\n",
+		       NET_TCP_BUF(buf)->offset >> 4);
+		return false;
+	}
+
+	if (memcmp(NET_TCP_BUF(buf)->optdata, sack_perm, sizeof(sack_perm))) {
+		printk("SACK permitted option not set\n");
+		return false;
+	}
+
+	net_nbuf_unref(buf);
+
+	return true;
+}
+#endif
+
+#define PREDICTION_ROUNDS 16
+#define PREDICTION_DATA_LEN 100
+
+/* Queue a segment as if it was sent, and get the peer's ACK of it */
+static struct net_buf *prepare_sent_and_ack(struct net_tcp *tcp)
+{
+	struct net_buf *sent = NULL, *ack = NULL;
+	int ret;
+
+	ret = net_tcp_prepare_segment(tcp, NET_TCP_PSH | NET_TCP_ACK, NULL, 0,
+				      NULL, (struct sockaddr *)&peer_v4_addr,
+				      &sent);
+	if (ret) {
+		printk("Prepare segment failed (%d)\n", ret);
+		return NULL;
+	}
+
+	net_nbuf_set_appdatalen(sent, PREDICTION_DATA_LEN);
+	net_nbuf_set_buf_sent(sent, true);
+	sys_slist_append(&tcp->sent_list, &sent->sent_list);
+	tcp->send_seq += PREDICTION_DATA_LEN;
+
+	ret = net_tcp_prepare_segment(tcp, NET_TCP_ACK, NULL, 0, NULL,
+				      (struct sockaddr *)&peer_v4_addr, &ack);
+	if (ret) {
+		printk("Prepare ACK failed (%d)\n", ret);
+		return NULL;
+	}
+
+	sys_put_be32(tcp->send_ack, NET_TCP_BUF(ack)->seq);
+	sys_put_be32(tcp->send_seq, NET_TCP_BUF(ack)->ack);
+	sys_put_be16(tcp->send_wnd, NET_TCP_BUF(ack)->wnd);
+
+	return ack;
+}
+
+static bool test_v4_header_prediction(void)
+{
+	struct net_tcp *tcp = v4_ctx->tcp;
+	enum net_tcp_state state = net_tcp_get_state(tcp);
+	uint32_t slow = 0, fast = 0, start;
+	struct net_buf *ack;
+	bool ok = true;
+	int i;
+
+	net_tcp_set_state(tcp, NET_TCP_ESTABLISHED);
+	tcp->send_wnd = NET_TCP_BUF_MAX_LEN;
+
+	for (i = 0; i < PREDICTION_ROUNDS && ok; i++) {
+		ack = prepare_sent_and_ack(tcp);
+		if (!ack) {
+			ok = false;
+			break;
+		}
+
+		start = k_cycle_get_32();
+		net_tcp_ack_received(v4_ctx, ack);
+		slow += k_cycle_get_32() - start;
+
+		net_nbuf_unref(ack);
+
+		ack = prepare_sent_and_ack(tcp);
+		if (!ack) {
+			ok = false;
+			break;
+		}
+
+		start = k_cycle_get_32();
+		if (!net_tcp_predicted(tcp, ack) ||
+		    !net_tcp_fast_ack(v4_ctx, ack)) {
+			printk("ACK of sent data not predicted\n");
+			ok = false;
+		}
+		fast += k_cycle_get_32() - start;
+
+		if (!sys_slist_is_empty(&tcp->sent_list)) {
+			printk("Acknowledged segment not released\n");
+			ok = false;
+		}
+
+		/* Anything else than the next in sequence, a bare ACK and
+		 * the same window takes the full path.
+		 */
+		NET_TCP_BUF(ack)->flags |= NET_TCP_FIN;
+		if (net_tcp_predicted(tcp, ack)) {
+			printk("FIN segment predicted\n");
+			ok = false;
+		}
+		NET_TCP_BUF(ack)->flags &= ~NET_TCP_FIN;
+
+		sys_put_be16(tcp->send_wnd / 2, NET_TCP_BUF(ack)->wnd);
+		if (net_tcp_predicted(tcp, ack)) {
+			printk("Window update predicted\n");
+			ok = false;
+		}
+
+		sys_put_be32(tcp->send_ack + 1, NET_TCP_BUF(ack)->seq);
+		if (net_tcp_predicted(tcp, ack)) {
+			printk("Out of sequence segment predicted\n");
+			ok = false;
+		}
+
+		net_nbuf_unref(ack);
+	}
+
+	net_tcp_set_state(tcp, state);
+
+	if (ok) {
+		TC_PRINT("ACK processing: %u cycles, %u with header "
+			 "prediction\n", slow / PREDICTION_ROUNDS,
+			 fast / PREDICTION_ROUNDS);
+	}
+
+	return ok;
+}
+
 #if 0
 static void connect_v6_cb(struct net_context *context, void *user_data)
 {
@@ -1457,6 +1610,10 @@ static const struct {
 	{ "test IPv4 TCP fin packet creation", test_create_v4_fin_packet },
 	{ "test IPv6 TCP seq check", test_v6_seq_check },
 	{ "test IPv4 TCP seq check", test_v4_seq_check },
+#if defined(CONFIG_NET_TCP_SACK)
+	{ "test IPv4 TCP SACK permitted option", test_v4_sack_permitted },
+#endif
+	{ "test IPv4 TCP header prediction", test_v4_header_prediction },
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
 #if 0
@@ -326,6 +326,57 @@ static bool send_ipv4_udp_msg(struct net_if *iface,
 	return !fail;
 }
 
+/* A datagram to our own address is handed to the connection handlers
+ * directly, without going through the driver.
+ */
+static bool send_ipv6_udp_local(struct net_if *iface,
+				struct in6_addr *addr,
+				uint16_t src_port,
+				uint16_t dst_port,
+				struct ud *ud)
+{
+	struct net_buf *buf;
+	struct net_buf *frag;
+	int ret;
+
+	buf = net_nbuf_get_reserve_tx(0, K_FOREVER);
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	net_buf_frag_add(buf, frag);
+
+	net_nbuf_set_iface(buf, iface);
+	net_nbuf_set_family(buf, AF_INET6);
+	net_nbuf_set_ll_reserve(buf, net_buf_headroom(frag));
+
+	setup_ipv6_udp(buf, addr, addr, src_port, dst_port);
+
+	send_status = -EINVAL;
+	returned_ud = NULL;
+
+	ret = net_send_data(buf);
+	if (ret < 0) {
+		printk("Cannot send buf %p, ret %d\n", buf, ret);
+		return false;
+	}
+
+	if (k_sem_take(&recv_lock, K_NO_WAIT)) {
+		printk("Local packet not delivered\n");
+		return false;
+	}
+
+	if (!send_status) {
+		printk("Local packet sent to the driver\n");
+		return false;
+	}
+
+	if (ud != returned_ud) {
+		printk("IPv6 local wrong user data %p returned, expected %p\n",
+		       returned_ud, ud);
+		return false;
+	}
+
+	return !fail;
+}
+
 static void set_port(sa_family_t family, struct sockaddr *raddr,
 		     struct sockaddr *laddr, uint16_t rport,
 		     uint16_t lport)
@@ -549,6 +600,11 @@ static bool run_tests(void)
 	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 12345, 42421);
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 12345, 42421);
 
+	if (!send_ipv6_udp_local(iface, &in6addr_my, 12345, 42421, ud)) {
+		printk("%d: UDP local delivery test fail\n", __LINE__);
+		return false;
+	}
+
 	/* Remote addr same as local addr, these two will never match */
 	REGISTER(AF_INET6, &my_addr6, NULL, 1234, 4242);
 	REGISTER(AF_INET, &my_addr4, NULL, 1234, 4242);
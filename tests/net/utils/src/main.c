@@ -147,6 +147,8 @@ static const unsigned char pkt5[98] = {
 0x36, 0x37                                      /* 67 */
 };
 
+static struct in_addr new_src = { { { 192, 0, 2, 1 } } };
+
 static bool run_tests(void)
 {
 	struct net_buf *frag, *buf;
@@ -362,6 +364,23 @@ static bool run_tests(void)
 		       chksum, orig_chksum);
 		return false;
 	}
+
+	/* The IPv4 header checksum is updated for a new source address */
+	NET_IPV4_BUF(buf)->chksum = 0;
+	NET_IPV4_BUF(buf)->chksum = ~net_calc_chksum_ipv4(buf);
+
+	chksum = net_chksum_update(NET_IPV4_BUF(buf)->chksum,
+				   &NET_IPV4_BUF(buf)->src, &new_src,
+				   sizeof(new_src));
+	net_ipaddr_copy(&NET_IPV4_BUF(buf)->src, &new_src);
+
+	NET_IPV4_BUF(buf)->chksum = 0;
+	orig_chksum = ~net_calc_chksum_ipv4(buf);
+	if (chksum != orig_chksum) {
+		printk("Invalid updated chksum 0x%x in pkt5, should be 0x%x\n",
+		       chksum, orig_chksum);
+		return false;
+	}
 	net_nbuf_unref(buf);
 
 	return true;
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_kernel_event_logger
+ * @{
+ * @defgroup t_kernel_event_logger_compact test_kernel_event_logger_compact
+ * @brief TestPurpose: verify compact kernel event recording
+ * - API coverage
+ *   -# sys_k_event_logger_put
+ *   -# sys_k_event_logger_put_timed
+ *   -# sys_k_event_logger_get
+ *   -# sys_k_event_logger_get_wait_timeout
+ * @}
+ */
+
+#include <ztest.h>
+#include <logging/kernel_event_logger.h>
+
+#define USER_EVENT_ID 0x0008
+#define USER_EVENT_MASK (1 << (USER_EVENT_ID - 1))
+#define CONTEXT_SWITCH_MASK \
+	(1 << (KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID - 1))
+
+/* make the next event too far from the previous one for a single word */
+static void wait_past_stamp_range(void)
+{
+	uint32_t start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start <=
+	       KERNEL_EVENT_LOGGER_COMPACT_STAMP_MASK) {
+	}
+}
+
+static void drain(void)
+{
+	uint16_t event_id;
+	uint8_t dropped;
+	uint32_t data[8];
+	uint8_t size;
+
+	do {
+		size = ARRAY_SIZE(data);
+	} while (sys_k_event_logger_get(&event_id, &dropped, data, &size));
+}
+
+void test_kernel_event_logger_timed(void)
+{
+	uint32_t data[4];
+	uint32_t before, after;
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size;
+
+	sys_k_event_logger_set_mask(0);
+	drain();
+
+	for (int i = 0; i < 3; i++) {
+		wait_past_stamp_range();
+
+		before = k_cycle_get_32();
+		sys_k_event_logger_put_timed(USER_EVENT_ID);
+		after = k_cycle_get_32();
+
+		size = ARRAY_SIZE(data);
+		assert_equal(sys_k_event_logger_get(&event_id, &dropped, data,
+						    &size), 1, NULL);
+
+		/**TESTPOINT: timestamps are recovered in full*/
+		assert_equal(event_id, USER_EVENT_ID, NULL);
+		assert_true(data[0] - before <= after - before, NULL);
+	}
+
+	/* close enough to be recorded in a single word */
+	before = k_cycle_get_32();
+	for (int i = 0; i < 8; i++) {
+		sys_k_event_logger_put_timed(USER_EVENT_ID);
+	}
+	after = k_cycle_get_32();
+
+	for (int i = 0; i < 8; i++) {
+		size = ARRAY_SIZE(data);
+		assert_equal(sys_k_event_logger_get(&event_id, &dropped, data,
+						    &size), 1, NULL);
+		assert_true(data[0] - before <= after - before, NULL);
+		before = data[0];
+	}
+
+	/**TESTPOINT: nothing is left once all events are retrieved*/
+	assert_equal(sys_k_event_logger_get_wait_timeout(&event_id, &dropped,
+							 data, &size, 1),
+		     0, NULL);
+}
+
+void test_kernel_event_logger_raw(void)
+{
+	uint32_t in[3] = { 0xdeadbeef, 0, 42 };
+	uint32_t data[4];
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size;
+
+	sys_k_event_logger_set_mask(0);
+	drain();
+
+	sys_k_event_logger_put(USER_EVENT_ID, in, ARRAY_SIZE(in));
+
+	/**TESTPOINT: too small buffers are reported and keep the event*/
+	size = 2;
+	assert_equal(sys_k_event_logger_get(&event_id, &dropped, data, &size),
+		     -EMSGSIZE, NULL);
+	assert_equal(size, ARRAY_SIZE(in), NULL);
+
+	/**TESTPOINT: data of user events is retrieved as is*/
+	size = ARRAY_SIZE(data);
+	assert_equal(sys_k_event_logger_get(&event_id, &dropped, data, &size),
+		     ARRAY_SIZE(in), NULL);
+	assert_equal(event_id, USER_EVENT_ID, NULL);
+	assert_equal(dropped, 0, NULL);
+	assert_equal(memcmp(data, in, sizeof(in)), 0, NULL);
+}
+
+void test_kernel_event_logger_context_switch(void)
+{
+	uint32_t data[4];
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size;
+	int found = 0;
+
+	drain();
+
+	sys_k_event_logger_set_mask(CONTEXT_SWITCH_MASK);
+	k_sleep(1);
+	k_sleep(1);
+	sys_k_event_logger_set_mask(0);
+
+	for (;;) {
+		size = ARRAY_SIZE(data);
+		if (!sys_k_event_logger_get(&event_id, &dropped, data, &size)) {
+			break;
+		}
+
+		assert_equal(event_id,
+			     KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID, NULL);
+		assert_equal(size, ARRAY_SIZE(data), NULL);
+		if ((struct k_thread *)data[1] == k_current_get()) {
+			found++;
+		}
+	}
+
+	/**TESTPOINT: compact thread IDs are decoded to thread pointers*/
+	assert_equal(found, 2, NULL);
+}
+
+void test_kernel_event_logger_dropped(void)
+{
+	uint32_t data[4];
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size;
+	int count = 0;
+
+	sys_k_event_logger_set_mask(0);
+	drain();
+
+	/* each event takes a single word, but the first one is synced */
+	wait_past_stamp_range();
+	for (int i = 0; i < CONFIG_KERNEL_EVENT_LOGGER_BUFFER_SIZE + 8; i++) {
+		sys_k_event_logger_put_timed(USER_EVENT_ID);
+	}
+
+	size = ARRAY_SIZE(data);
+	while (sys_k_event_logger_get(&event_id, &dropped, data, &size)) {
+		/**TESTPOINT: events not fitting in the buffer are dropped*/
+		if (count == 0) {
+			assert_equal(dropped, 10, NULL);
+		} else {
+			assert_equal(dropped, 0, NULL);
+		}
+		count++;
+		size = ARRAY_SIZE(data);
+	}
+
+	assert_equal(count, CONFIG_KERNEL_EVENT_LOGGER_BUFFER_SIZE - 2, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_kernel_event_logger,
+			 ztest_unit_test(test_kernel_event_logger_timed),
+			 ztest_unit_test(test_kernel_event_logger_raw),
+			 ztest_unit_test(test_kernel_event_logger_context_switch),
+			 ztest_unit_test(test_kernel_event_logger_dropped));
+	ztest_run_test_suite(test_kernel_event_logger);
+}
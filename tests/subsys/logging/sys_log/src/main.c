@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_sys_log
+ * @{
+ * @defgroup t_sys_log_deferred test_sys_log_deferred
+ * @brief TestPurpose: verify deferred logging
+ * - API coverage
+ *   -# SYS_LOG_ERR/WRN/INF/DBG
+ *   -# sys_log_backend_register
+ *   -# sys_log_level_set
+ *   -# sys_log_flush
+ * @}
+ */
+
+#define SYS_LOG_DOMAIN "test"
+#define SYS_LOG_LEVEL SYS_LOG_LEVEL_DEBUG
+#include <logging/sys_log.h>
+#include <ztest.h>
+
+#define LINE_SIZE 80
+
+static char last_line[LINE_SIZE];
+static int lines;
+
+static void capture_put(const struct sys_log_backend *backend, int level,
+			const char *line, size_t len)
+{
+	ARG_UNUSED(backend);
+	ARG_UNUSED(level);
+
+	strncpy(last_line, line, sizeof(last_line) - 1);
+	lines++;
+}
+
+static struct sys_log_backend capture_backend = {
+	.put = capture_put,
+};
+
+void test_sys_log_deferred(void)
+{
+	int count;
+
+	sys_log_backend_register(&capture_backend);
+	sys_log_flush();
+	count = lines;
+
+	SYS_LOG_INF("value %d %s", 42, "str");
+
+	/**TESTPOINT: messages are not output in the caller's context*/
+	assert_equal(lines, count, NULL);
+
+	/**TESTPOINT: messages are formatted as a whole line*/
+	sys_log_flush();
+	assert_equal(lines, count + 1, NULL);
+	assert_equal(strcmp(last_line,
+			    "[test] [INF] test_sys_log_deferred: value 42 str\n"),
+		     0, NULL);
+}
+
+void test_sys_log_level_set(void)
+{
+	int count;
+
+	sys_log_flush();
+	count = lines;
+
+	/**TESTPOINT: the level of a domain can be lowered at runtime*/
+	assert_true(sys_log_level_set("test", SYS_LOG_LEVEL_WARNING) > 0, NULL);
+	SYS_LOG_INF("filtered out");
+	SYS_LOG_DBG("filtered out");
+	SYS_LOG_WRN("not filtered out");
+	sys_log_flush();
+	assert_equal(lines, count + 1, NULL);
+	assert_equal(strcmp(last_line,
+			    "[test] [WRN] test_sys_log_level_set: "
+			    "not filtered out\n"), 0, NULL);
+
+	/**TESTPOINT: unknown domains are reported*/
+	assert_equal(sys_log_level_set("unknown", SYS_LOG_LEVEL_OFF), 0, NULL);
+
+	sys_log_level_set("test", SYS_LOG_LEVEL_DEBUG);
+}
+
+void test_sys_log_dropped(void)
+{
+	/* messages without arguments take four words */
+	const int capacity = CONFIG_SYS_LOG_DEFERRED_BUF_WORDS / 4;
+	int count;
+
+	sys_log_flush();
+	count = lines;
+
+	for (int i = 0; i < capacity + 4; i++) {
+		SYS_LOG_DBG("message");
+	}
+
+	/**TESTPOINT: messages not fitting in the buffer are dropped*/
+	sys_log_flush();
+	assert_equal(lines, count + capacity + 1, NULL);
+	assert_equal(strcmp(last_line,
+			    "[test] [DBG] test_sys_log_dropped: message\n"),
+		     0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_sys_log,
+			 ztest_unit_test(test_sys_log_deferred),
+			 ztest_unit_test(test_sys_log_level_set),
+			 ztest_unit_test(test_sys_log_dropped));
+	ztest_run_test_suite(test_sys_log);
+}
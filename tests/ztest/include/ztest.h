@@ -42,6 +42,9 @@
 #include <ztest_assert.h>
 #include <ztest_mock.h>
 #include <ztest_test.h>
+#ifdef CONFIG_ZTEST_BENCHMARK
+#include <ztest_benchmark.h>
+#endif
 #include <tc_util.h>
 
 #endif /* __ZTEST_H__ */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Ztest benchmark support
+ *
+ * This module times a function over a number of iterations with the
+ * hardware cycle counter, and reports the statistics of the samples on
+ * the console as one line of JSON, collected by scripts/sanitycheck.
+ */
+
+#ifndef __ZTEST_BENCHMARK_H__
+#define __ZTEST_BENCHMARK_H__
+
+/**
+ * @defgroup ztest_benchmark Ztest benchmark support
+ * @ingroup ztest
+ *
+ * @{
+ */
+
+/** Prefix of the result lines, followed by a JSON object */
+#define ZTEST_BENCHMARK_TAG "ZTEST_BENCHMARK"
+
+struct ztest_benchmark {
+	const char *name;
+	/** Called once, before the warmup iterations */
+	void (*setup)(void);
+	/** Timed iteration */
+	void (*bench)(void);
+	/** Called once, after the last iteration */
+	void (*teardown)(void);
+	/** Iterations run before timing, not sampled */
+	uint32_t warmup;
+	/** Iterations timed, up to CONFIG_ZTEST_BENCHMARK_SAMPLES */
+	uint32_t iterations;
+};
+
+/** Statistics of the samples, in nanoseconds */
+struct ztest_benchmark_stats {
+	uint32_t min;
+	uint32_t median;
+	uint32_t p99;
+	uint32_t max;
+	uint32_t mean;
+};
+
+/**
+ * @brief Run a benchmark and report its statistics
+ *
+ * The cost of reading the cycle counter is measured beforehand and
+ * subtracted from every sample.
+ *
+ * @param bench Benchmark to run.
+ * @param stats Statistics of the run, or NULL.
+ *
+ * @return 0 on success, -EINVAL if the number of iterations is 0 or more
+ * than CONFIG_ZTEST_BENCHMARK_SAMPLES.
+ */
+int ztest_benchmark_run(const struct ztest_benchmark *bench,
+			struct ztest_benchmark_stats *stats);
+
+void _ztest_benchmark_test(const struct ztest_benchmark *bench);
+
+/**
+ * @brief Define a unit test running a benchmark
+ *
+ * The test, added to a suite with ztest_unit_test(name), fails if the
+ * benchmark cannot run. The timed function fails it as any test would,
+ * with the assertions of ztest.
+ *
+ * @param name Name of the test function defined.
+ * @param fn Timed function.
+ * @param setup Function called before the warmup.
+ * @param teardown Function called after the last iteration.
+ * @param warmup Number of iterations not timed.
+ * @param iterations Number of iterations timed.
+ */
+#define ZTEST_BENCHMARK_DEFINE(name, fn, setup, teardown, warmup, iterations) \
+	static const struct ztest_benchmark _ztest_benchmark_##name = { \
+		STRINGIFY(name), setup, fn, teardown, warmup, iterations \
+	}; \
+	void name(void) \
+	{ \
+		_ztest_benchmark_test(&_ztest_benchmark_##name); \
+	}
+
+/**
+ * @}
+ */
+
+#endif /* __ZTEST_BENCHMARK_H__ */
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <errno.h>
+
+static uint32_t samples[CONFIG_ZTEST_BENCHMARK_SAMPLES];
+
+/* Cycles taken by reading the counter, the lowest of a few reads so an
+ * interrupt does not inflate it
+ */
+static uint32_t timing_overhead(void)
+{
+	uint32_t overhead = UINT32_MAX;
+	uint32_t start, delta;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		start = k_cycle_get_32();
+		delta = k_cycle_get_32() - start;
+		if (delta < overhead) {
+			overhead = delta;
+		}
+	}
+
+	return overhead;
+}
+
+/* Shell sort, the samples are too many for an insertion sort and the
+ * minimal libc has no qsort()
+ */
+static void sort_samples(uint32_t n)
+{
+	uint32_t gap, i, j, v;
+
+	for (gap = n / 2; gap > 0; gap /= 2) {
+		for (i = gap; i < n; i++) {
+			v = samples[i];
+			for (j = i; j >= gap && samples[j - gap] > v;
+			     j -= gap) {
+				samples[j] = samples[j - gap];
+			}
+			samples[j] = v;
+		}
+	}
+}
+
+int ztest_benchmark_run(const struct ztest_benchmark *bench,
+			struct ztest_benchmark_stats *stats)
+{
+	struct ztest_benchmark_stats s;
+	uint32_t overhead, start, i;
+	uint64_t sum = 0;
+
+	if (!bench->iterations ||
+	    bench->iterations > CONFIG_ZTEST_BENCHMARK_SAMPLES) {
+		return -EINVAL;
+	}
+
+	overhead = timing_overhead();
+
+	if (bench->setup) {
+		bench->setup();
+	}
+
+	for (i = 0; i < bench->warmup; i++) {
+		bench->bench();
+	}
+
+	for (i = 0; i < bench->iterations; i++) {
+		start = k_cycle_get_32();
+		bench->bench();
+		samples[i] = k_cycle_get_32() - start;
+	}
+
+	if (bench->teardown) {
+		bench->teardown();
+	}
+
+	for (i = 0; i < bench->iterations; i++) {
+		samples[i] = samples[i] > overhead ? samples[i] - overhead : 0;
+		sum += samples[i];
+	}
+
+	sort_samples(bench->iterations);
+
+	s.min = SYS_CLOCK_HW_CYCLES_TO_NS(samples[0]);
+	s.median = SYS_CLOCK_HW_CYCLES_TO_NS(samples[bench->iterations / 2]);
+	s.p99 = SYS_CLOCK_HW_CYCLES_TO_NS(
+		samples[(bench->iterations * 99) / 100]);
+	s.max = SYS_CLOCK_HW_CYCLES_TO_NS(samples[bench->iterations - 1]);
+	s.mean = SYS_CLOCK_HW_CYCLES_TO_NS_AVG(sum, bench->iterations);
+
+	PRINT(ZTEST_BENCHMARK_TAG " {\"name\": \"%s\", \"iterations\": %u, "
+	      "\"warmup\": %u, \"min_ns\": %u, \"median_ns\": %u, "
+	      "\"p99_ns\": %u, \"max_ns\": %u, \"mean_ns\": %u}\n",
+	      bench->name, bench->iterations, bench->warmup, s.min, s.median,
+	      s.p99, s.max, s.mean);
+
+	if (stats) {
+		*stats = s;
+	}
+
+	return 0;
+}
+
+void _ztest_benchmark_test(const struct ztest_benchmark *bench)
+{
+	assert_equal(ztest_benchmark_run(bench, NULL), 0,
+		     "invalid number of iterations");
+}